@@ -11,16 +11,24 @@
 #include "archival/archival_policy.h"
 
 #include "archival/logger.h"
+#include "resource_mgmt/io_priority.h"
 #include "storage/disk_log_impl.h"
 #include "storage/fs_utils.h"
 #include "storage/segment.h"
+#include "storage/segment_appender_utils.h"
 #include "storage/segment_set.h"
 #include "storage/version.h"
+#include "units.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/iostream.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/util/log.hh>
 
+#include <algorithm>
+#include <deque>
+
 namespace archival {
 
 using namespace std::chrono_literals;
@@ -28,15 +36,198 @@ using namespace std::chrono_literals;
 std::ostream& operator<<(std::ostream& s, const upload_candidate& c) {
     s << "{ exposed_name: " << c.exposed_name
       << ", starting_offset: " << c.starting_offset
-      << ", segment_file_name: " << c.source->reader().filename() << " }";
+      << ", segment_file_name: " << c.source->reader().filename()
+      << ", coalesced_segments: " << c.coalesced.size() << " }";
     return s;
 }
 
+namespace {
+
+/// Buffer size of the disk reads of the uploads, the reads are sequential
+/// and cover whole multipart parts (or segments)
+constexpr size_t upload_read_buffer_size = 1_MiB;
+/// Max number of buffers the disk reads of the uploads read ahead
+constexpr uint32_t max_upload_read_ahead = 4;
+
+/// Large sequential DMA read of the range of the segment file
+ss::input_stream<char>
+make_disk_stream(storage::segment& s, size_t start, size_t end) {
+    auto buffers = (end - start + upload_read_buffer_size - 1)
+                   / upload_read_buffer_size;
+    auto read_ahead = static_cast<uint32_t>(
+      std::clamp<size_t>(buffers, 1, max_upload_read_ahead));
+    return s.reader().data_stream(
+      start, end, archival_priority(), read_ahead, upload_read_buffer_size);
+}
+
+/// \brief Reads the range of the segment file from the batch cache
+///
+/// A segment that was just closed usually has most of its batches in the
+/// batch cache. The batches are serialized in the same format as the
+/// segment file, the positions of the batches in the file follow from
+/// their sizes. The range is read from disk starting from the first batch
+/// that is not cached.
+class cached_segment_data_source final : public ss::data_source_impl {
+public:
+    cached_segment_data_source(
+      ss::lw_shared_ptr<storage::segment> segment, size_t start, size_t end)
+      : _segment(std::move(segment))
+      , _start(start)
+      , _end(end)
+      , _next_offset(_segment->offsets().base_offset) {}
+
+    ss::future<ss::temporary_buffer<char>> get() final {
+        while (_ready.empty() && !_disk && _pos < _end) {
+            read_cached_batch();
+        }
+        if (!_ready.empty()) {
+            auto buf = std::move(_ready.front());
+            _ready.pop_front();
+            co_return buf;
+        }
+        if (_disk) {
+            co_return co_await _disk->read();
+        }
+        co_return ss::temporary_buffer<char>();
+    }
+
+    ss::future<> close() final {
+        if (_disk) {
+            co_await _disk->close();
+            _disk = std::nullopt;
+        }
+    }
+
+private:
+    void read_cached_batch() {
+        std::optional<model::record_batch> batch;
+        if (auto cache = _segment->cache(); cache) {
+            batch = cache->get().get(_next_offset);
+        }
+        if (!batch || batch->base_offset() != _next_offset) {
+            _disk = make_disk_stream(*_segment, std::max(_pos, _start), _end);
+            return;
+        }
+        const size_t batch_pos = _pos;
+        _pos += batch->header().size_bytes;
+        _next_offset = batch->last_offset() + model::offset(1);
+        if (_pos <= _start) {
+            return;
+        }
+        auto buf = storage::disk_header_to_iobuf(batch->header());
+        buf.append(std::move(*batch).release_data());
+        // the batches at the ends of the range are trimmed
+        auto skip = _start > batch_pos ? _start - batch_pos : 0;
+        auto len = std::min(_pos, _end) - batch_pos - skip;
+        auto range = buf.share(skip, len);
+        for (auto& frag : range) {
+            _ready.push_back(frag.share());
+        }
+    }
+
+    ss::lw_shared_ptr<storage::segment> _segment;
+    size_t _start;
+    size_t _end;
+    size_t _pos{0};
+    model::offset _next_offset;
+    std::deque<ss::temporary_buffer<char>> _ready;
+    std::optional<ss::input_stream<char>> _disk;
+};
+
+ss::input_stream<char> make_segment_stream(
+  ss::lw_shared_ptr<storage::segment> segment, size_t start, size_t end) {
+    return ss::input_stream<char>(
+      ss::data_source(std::make_unique<cached_segment_data_source>(
+        std::move(segment), start, end)));
+}
+
+/// Reads the ranges of the segment files one after another
+class concat_segment_data_source final : public ss::data_source_impl {
+public:
+    struct range {
+        ss::lw_shared_ptr<storage::segment> segment;
+        size_t start;
+        size_t end;
+    };
+
+    explicit concat_segment_data_source(std::vector<range> ranges)
+      : _ranges(std::move(ranges)) {}
+
+    ss::future<ss::temporary_buffer<char>> get() final {
+        while (_current < _ranges.size()) {
+            if (!_stream) {
+                const auto& r = _ranges[_current];
+                _stream = make_segment_stream(r.segment, r.start, r.end);
+            }
+            auto buf = co_await _stream->read();
+            if (!buf.empty()) {
+                co_return buf;
+            }
+            co_await _stream->close();
+            _stream = std::nullopt;
+            ++_current;
+        }
+        co_return ss::temporary_buffer<char>();
+    }
+
+    ss::future<> close() final {
+        if (_stream) {
+            co_await _stream->close();
+            _stream = std::nullopt;
+        }
+    }
+
+private:
+    std::vector<range> _ranges;
+    size_t _current{0};
+    std::optional<ss::input_stream<char>> _stream;
+};
+
+} // namespace
+
+ss::input_stream<char> make_upload_stream(
+  const upload_candidate& candidate, uint64_t offset, uint64_t length) {
+    if (candidate.coalesced.empty()) {
+        return make_segment_stream(
+          candidate.source,
+          candidate.file_offset + offset,
+          candidate.file_offset + offset + length);
+    }
+    // the ranges of the files that overlap [offset, offset + length) of
+    // the object
+    std::vector<concat_segment_data_source::range> ranges;
+    auto add_file = [&ranges, offset, end = offset + length](
+                      const ss::lw_shared_ptr<storage::segment>& s,
+                      size_t file_offset,
+                      size_t object_pos) {
+        auto size = s->reader().file_size() - file_offset;
+        auto first = std::max<uint64_t>(offset, object_pos);
+        auto last = std::min<uint64_t>(end, object_pos + size);
+        if (first < last) {
+            ranges.push_back(
+              {.segment = s,
+               .start = file_offset + first - object_pos,
+               .end = file_offset + last - object_pos});
+        }
+        return object_pos + size;
+    };
+    auto pos = add_file(candidate.source, candidate.file_offset, 0);
+    for (const auto& s : candidate.coalesced) {
+        pos = add_file(s, 0, pos);
+    }
+    return ss::input_stream<char>(ss::data_source(
+      std::make_unique<concat_segment_data_source>(std::move(ranges))));
+}
+
 archival_policy::archival_policy(
-  model::ntp ntp, service_probe& svc_probe, ntp_level_probe& ntp_probe)
+  model::ntp ntp,
+  service_probe& svc_probe,
+  ntp_level_probe& ntp_probe,
+  size_t coalesce_target_size)
   : _ntp(std::move(ntp))
   , _svc_probe(svc_probe)
-  , _ntp_probe(ntp_probe) {}
+  , _ntp_probe(ntp_probe)
+  , _coalesce_target_size(coalesce_target_size) {}
 
 archival_policy::lookup_result archival_policy::find_segment(
   model::offset last_offset,
@@ -71,8 +262,8 @@ archival_policy::lookup_result archival_policy::find_segment(
 
     const auto& ntp_conf = plog->config();
     auto it = set.lower_bound(last_offset);
-    if (it == set.end() || (*it)->is_compacted_segment()) {
-        // Skip forward if we hit a gap or compacted segment
+    if (it == set.end()) {
+        // Skip forward if we hit a gap
         for (auto i = set.begin(); i != set.end(); i++) {
             const auto& sg = *i;
             if (last_offset < sg->offsets().base_offset) {
@@ -122,6 +313,32 @@ archival_policy::lookup_result archival_policy::find_segment(
     return {.segment = *it, .ntp_conf = &ntp_conf};
 }
 
+uint64_t archival_policy::get_upload_backlog(
+  model::offset last_offset,
+  model::offset high_watermark,
+  storage::log_manager& lm) {
+    std::optional<storage::log> log = lm.get(_ntp);
+    if (!log) {
+        return 0;
+    }
+    auto plog = dynamic_cast<storage::disk_log_impl*>(log->get_impl());
+    if (plog == nullptr) {
+        return 0;
+    }
+    uint64_t backlog = 0;
+    for (const auto& sg : plog->segments()) {
+        const auto& offsets = sg->offsets();
+        if (
+          offsets.dirty_offset < last_offset
+          || offsets.dirty_offset > high_watermark || sg->has_appender()) {
+            continue;
+        }
+        backlog += sg->size_bytes();
+    }
+    _ntp_probe.upload_backlog(backlog);
+    return backlog;
+}
+
 /// \brief Initializes upload_candidate structure taking into account
 ///        possible segment overlaps at 'off'
 ///
@@ -198,15 +415,162 @@ static upload_candidate create_upload_candidate(
       .content_length = clen};
 }
 
-upload_candidate archival_policy::get_next_candidate(
+void archival_policy::coalesce(
+  upload_candidate& candidate,
+  model::offset high_watermark,
+  storage::log_manager& lm) {
+    if (
+      _coalesce_target_size == 0 || candidate.source->is_compacted_segment()) {
+        return;
+    }
+    std::optional<storage::log> log = lm.get(_ntp);
+    if (!log) {
+        return;
+    }
+    auto plog = dynamic_cast<storage::disk_log_impl*>(log->get_impl());
+    if (plog == nullptr) {
+        return;
+    }
+    const auto& set = plog->segments();
+    const auto term = candidate.source->offsets().term;
+    while (candidate.content_length < _coalesce_target_size) {
+        auto next_offset = candidate.last_source()->offsets().dirty_offset
+                           + model::offset(1);
+        auto it = set.lower_bound(next_offset);
+        if (it == set.end()) {
+            break;
+        }
+        const auto& next = *it;
+        // An uploaded object is a valid segment of a single term, the
+        // segments it's made of must not overlap
+        if (
+          next->has_appender() || next->is_compacted_segment()
+          || next->offsets().base_offset < next_offset
+          || next->offsets().term != term
+          || next->offsets().dirty_offset > high_watermark
+          || candidate.content_length + next->reader().file_size()
+               > _coalesce_target_size) {
+            break;
+        }
+        candidate.content_length += next->reader().file_size();
+        candidate.coalesced.push_back(next);
+    }
+    if (!candidate.coalesced.empty()) {
+        vlog(
+          archival_log.debug,
+          "Upload policy for {}, coalescing {} segments after {}, object "
+          "size: {}",
+          _ntp,
+          candidate.coalesced.size(),
+          candidate.exposed_name,
+          candidate.content_length);
+    }
+}
+
+ss::future<upload_candidate> archival_policy::get_next_candidate(
   model::offset last_offset,
   model::offset high_watermark,
   storage::log_manager& lm) {
     auto [segment, ntp_conf] = find_segment(last_offset, high_watermark, lm);
     if (segment.get() == nullptr || ntp_conf == nullptr) {
-        return {};
+        co_return upload_candidate{};
+    }
+    // the index of a cold segment might be unloaded to save memory
+    co_await segment->index().ensure_materialized();
+    auto candidate = create_upload_candidate(last_offset, segment, ntp_conf);
+    coalesce(candidate, high_watermark, lm);
+    for (const auto& s : candidate.coalesced) {
+        co_await s->index().ensure_materialized();
+    }
+    co_return candidate;
+}
+
+/// Find the manifest entries that the compacted segment with the offset
+/// range [base, dirty] replaces, return nullopt if the ranges don't match or
+/// the entries are already replaced
+static std::optional<std::vector<segment_name>> find_replaced_segments(
+  const cloud_storage::manifest& manifest,
+  model::offset base,
+  model::offset dirty,
+  model::term_id term) {
+    std::vector<segment_name> names;
+    bool starts = false;
+    bool ends = false;
+    bool stale = false;
+    for (const auto& [name, meta] : manifest) {
+        if (meta.committed_offset < base || meta.base_offset > dirty) {
+            continue;
+        }
+        if (meta.base_offset < base || meta.committed_offset > dirty) {
+            // the entry crosses the boundary of the segment
+            return std::nullopt;
+        }
+        auto parsed = storage::segment_path::parse_segment_filename(name());
+        if (!parsed || parsed->term != term) {
+            return std::nullopt;
+        }
+        starts = starts || meta.base_offset == base;
+        ends = ends || meta.committed_offset == dirty;
+        stale = stale || !meta.is_compacted;
+        names.push_back(name);
+    }
+    if (!starts || !ends || (!stale && names.size() < 2)) {
+        return std::nullopt;
+    }
+    return names;
+}
+
+ss::future<compacted_upload_candidate>
+archival_policy::get_next_compacted_candidate(
+  const cloud_storage::manifest& manifest, storage::log_manager& lm) {
+    std::optional<storage::log> log = lm.get(_ntp);
+    if (!log || manifest.size() == 0) {
+        co_return compacted_upload_candidate{};
+    }
+    auto plog = dynamic_cast<storage::disk_log_impl*>(log->get_impl());
+    if (plog == nullptr) {
+        co_return compacted_upload_candidate{};
+    }
+    for (const auto& segment : plog->segments()) {
+        const auto& offsets = segment->offsets();
+        if (offsets.dirty_offset > manifest.get_last_offset()) {
+            // not uploaded yet
+            break;
+        }
+        if (
+          segment->has_appender() || !segment->finished_self_compaction()
+          || segment->reader().file_size() == 0) {
+            continue;
+        }
+        auto replaced = find_replaced_segments(
+          manifest, offsets.base_offset, offsets.dirty_offset, offsets.term);
+        if (!replaced) {
+            continue;
+        }
+        auto name = std::find_if(
+          replaced->begin(), replaced->end(), [&](const segment_name& n) {
+              return manifest.get(n)->base_offset == offsets.base_offset;
+          });
+        vlog(
+          archival_log.debug,
+          "Upload policy for {}, compacted segment {} replaces {} uploaded "
+          "segments",
+          _ntp,
+          segment->reader().filename(),
+          replaced->size());
+        // the segment set can change during the materialization
+        auto source = segment;
+        co_await source->index().ensure_materialized();
+        co_return compacted_upload_candidate{
+          .candidate = {
+            .source = source,
+            .exposed_name = *name,
+            .starting_offset = offsets.base_offset,
+            .file_offset = 0,
+            .content_length = source->reader().file_size()},
+          .replaced = std::move(*replaced)};
     }
-    return create_upload_candidate(last_offset, segment, ntp_conf);
+    co_return compacted_upload_candidate{};
 }
 
 } // namespace archival
@@ -12,6 +12,7 @@
 
 #include "archival/probe.h"
 #include "archival/types.h"
+#include "cloud_storage/manifest.h"
 #include "model/fundamental.h"
 #include "storage/log_manager.h"
 #include "storage/ntp_config.h"
@@ -24,11 +25,37 @@ struct upload_candidate {
     segment_name exposed_name;
     model::offset starting_offset;
     size_t file_offset;
+    /// Size of the object, includes the coalesced segments
     size_t content_length;
+    /// Closed segments of the same term that follow the source. They are
+    /// uploaded in full, after the uploaded part of the source, into the
+    /// same object.
+    std::vector<ss::lw_shared_ptr<storage::segment>> coalesced;
+
+    /// Last segment uploaded by the candidate
+    const ss::lw_shared_ptr<storage::segment>& last_source() const {
+        return coalesced.empty() ? source : coalesced.back();
+    }
 };
 
 std::ostream& operator<<(std::ostream& s, const upload_candidate& c);
 
+/// Compacted segment that replaces the uploaded segments of its range
+struct compacted_upload_candidate {
+    upload_candidate candidate;
+    /// Names of the manifest entries replaced by the candidate
+    std::vector<segment_name> replaced;
+};
+
+/// \brief Create a stream that reads a range of the uploaded object
+///
+/// The object is the uploaded part of the source segment followed by the
+/// coalesced segments.
+/// \param offset is a position of the range in the object
+/// \param length is a length of the range
+ss::input_stream<char> make_upload_stream(
+  const upload_candidate& candidate, uint64_t offset, uint64_t length);
+
 /// Archival policy is responsible for extracting segments from
 /// log_manager in right order.
 ///
@@ -36,8 +63,13 @@ std::ostream& operator<<(std::ostream& s, const upload_candidate& c);
 /// but uses ntp as a key to extract the data when needed.
 class archival_policy {
 public:
+    /// \param coalesce_target_size is a max size of the object the small
+    ///        consecutive segments are coalesced into (0 disables it)
     explicit archival_policy(
-      model::ntp ntp, service_probe& svc_probe, ntp_level_probe& ntp_probe);
+      model::ntp ntp,
+      service_probe& svc_probe,
+      ntp_level_probe& ntp_probe,
+      size_t coalesce_target_size = 0);
 
     /// \brief regurn next upload candidate
     ///
@@ -47,9 +79,37 @@ public:
     /// \return initializd struct on success, empty struct on failure
     /// \note returned upload candidate can have offset which is smaller than
     ///       last_offset because index is sparse and don't have all possible
-    ///       offsets. If index is not materialized we will upload log starting
-    ///       from the begining.
-    upload_candidate get_next_candidate(
+    ///       offsets. If index can't be materialized we will upload log
+    ///       starting from the begining.
+    ss::future<upload_candidate> get_next_candidate(
+      model::offset last_offset,
+      model::offset high_watermark,
+      storage::log_manager& lm);
+
+    /// \brief Find the compacted segment that should replace the uploaded
+    /// segments of its range
+    ///
+    /// The segments of compacted topics are uploaded as soon as they are
+    /// sealed, the local compaction rewrites them later. The segment that
+    /// finished self compaction (or the result of the adjacent segments
+    /// compaction) replaces the uploaded segments if its offset range
+    /// matches the range of one or more manifest entries and at least one
+    /// of them is not compacted or there are several of them.
+    /// \param manifest is a manifest of the partition
+    /// \param lm is a log manager
+    /// \return candidate or empty candidate if nothing needs re-upload
+    ss::future<compacted_upload_candidate> get_next_compacted_candidate(
+      const cloud_storage::manifest& manifest, storage::log_manager& lm);
+
+    /// \brief Estimate the number of bytes that are not uploaded yet
+    ///
+    /// Only sealed segments below the high watermark are taken into
+    /// account since other segments can't be uploaded at the moment.
+    /// \param last_offset is a last uploaded offset
+    /// \param high_watermark is current high_watermark offset for the partition
+    /// \param lm is a log manager
+    /// \return number of bytes in the segments eligible for upload
+    uint64_t get_upload_backlog(
       model::offset last_offset,
       model::offset high_watermark,
       storage::log_manager& lm);
@@ -65,9 +125,17 @@ private:
       model::offset high_watermark,
       storage::log_manager& lm);
 
+    /// Add the closed segments that follow the candidate to it while the
+    /// object stays below the coalesce target size
+    void coalesce(
+      upload_candidate& candidate,
+      model::offset high_watermark,
+      storage::log_manager& lm);
+
     model::ntp _ntp;
     service_probe& _svc_probe;
     ntp_level_probe& _ntp_probe;
+    size_t _coalesce_target_size;
 };
 
 } // namespace archival
\ No newline at end of file
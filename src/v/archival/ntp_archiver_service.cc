@@ -11,17 +11,24 @@
 #include "archival/ntp_archiver_service.h"
 
 #include "archival/logger.h"
+#include "bytes/iobuf_parser.h"
 #include "cloud_storage/remote.h"
 #include "cloud_storage/types.h"
+#include "model/adl_serde.h"
 #include "model/metadata.h"
+#include "reflection/adl.h"
+#include "resource_mgmt/io_priority.h"
 #include "s3/client.h"
 #include "s3/error.h"
 #include "storage/disk_log_impl.h"
 #include "storage/fs_utils.h"
+#include "storage/index_state.h"
+#include "storage/log_manager.h"
 #include "utils/gate_guard.h"
 
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/file.hh>
+#include <seastar/core/fstream.hh>
 #include <seastar/core/loop.hh>
 #include <seastar/core/lowres_clock.hh>
 #include <seastar/core/semaphore.hh>
@@ -37,19 +44,49 @@
 
 namespace archival {
 
+/// Time the objects removed from the manifest are kept in S3 after the
+/// manifest without them is uploaded, the readers that use the previous
+/// version of the manifest (e.g. read replicas) can still read them
+static constexpr auto removed_segment_delete_delay = 5min;
+
+/// Name of the local copy of the manifest in the partition directory
+static constexpr std::string_view manifest_cache_filename
+  = "archival_manifest.snapshot";
+static constexpr int8_t manifest_cache_version = 0;
+
 std::ostream& operator<<(std::ostream& o, const configuration& cfg) {
     fmt::print(
       o,
       "{{bucket_name: {}, interval: {}, client_config: {}, connection_limit: "
       "{}, initial_backoff: {}, segment_upload_timeout: {}, "
-      "manifest_upload_timeout: {}}}",
+      "manifest_upload_timeout: {}, cache_directory: {}, cache_size: {}, "
+      "multipart_part_size: {}, multipart_concurrency: {}, "
+      "upload_bandwidth: {}, binary_manifest: {}, "
+      "spillover_manifest_segments: {}, coalesce_upload_target_size: {}, "
+      "coalesce_upload_max_delay: {}, hedge_percentile: {}, "
+      "hedge_budget_percent: {}, retention_enabled: {}, "
+      "delete_objects_rate: {}, read_prefetch_depth: {}}}",
       cfg.bucket_name,
       cfg.interval.count(),
       cfg.client_config,
       cfg.connection_limit,
       cfg.initial_backoff.count(),
       cfg.segment_upload_timeout.count(),
-      cfg.manifest_upload_timeout.count());
+      cfg.manifest_upload_timeout.count(),
+      cfg.cache_directory,
+      cfg.cache_size,
+      cfg.multipart_upload.part_size,
+      cfg.multipart_upload.max_concurrency,
+      cfg.upload_bandwidth,
+      cfg.binary_manifest,
+      cfg.spillover_manifest_segments,
+      cfg.coalesce_upload_target_size,
+      cfg.coalesce_upload_max_delay.count(),
+      cfg.hedged_download.percentile,
+      cfg.hedged_download.budget_percent,
+      cfg.retention_enabled,
+      cfg.delete_objects_rate,
+      cfg.read_prefetch_depth);
     return o;
 }
 
@@ -57,25 +94,48 @@ ntp_archiver::ntp_archiver(
   const storage::ntp_config& ntp,
   const configuration& conf,
   cloud_storage::remote& remote,
-  service_probe& svc_probe)
+  service_probe& svc_probe,
+  cloud_storage::cache* cache,
+  upload_throttle* throttle,
+  upload_throttle* delete_throttle)
   : _svc_probe(svc_probe)
   , _probe(conf.ntp_metrics_disabled, ntp.ntp())
   , _ntp(ntp.ntp())
   , _rev(ntp.get_revision())
   , _remote(remote)
-  , _policy(_ntp, _svc_probe, std::ref(_probe))
+  , _policy(
+      _ntp, _svc_probe, std::ref(_probe), conf.coalesce_upload_target_size)
   , _bucket(conf.bucket_name)
   , _manifest(_ntp, _rev)
+  , _remote_partition(ss::make_lw_shared<cloud_storage::remote_partition>(
+      _manifest,
+      _remote,
+      _bucket,
+      conf.segment_upload_timeout,
+      conf.initial_backoff,
+      cache,
+      conf.read_prefetch_depth))
+  , _throttle(throttle)
+  , _delete_throttle(delete_throttle)
   , _gate()
   , _initial_backoff(conf.initial_backoff)
   , _segment_upload_timeout(conf.segment_upload_timeout)
-  , _manifest_upload_timeout(conf.manifest_upload_timeout) {
+  , _manifest_upload_timeout(conf.manifest_upload_timeout)
+  , _binary_manifest(conf.binary_manifest)
+  , _spillover_manifest_segments(conf.spillover_manifest_segments)
+  , _coalesce_target_size(conf.coalesce_upload_target_size)
+  , _coalesce_max_delay(conf.coalesce_upload_max_delay)
+  , _retention_enabled(conf.retention_enabled)
+  , _manifest_cache(
+      std::filesystem::path(ntp.work_directory()),
+      ss::sstring(manifest_cache_filename),
+      archival_priority()) {
     vlog(archival_log.trace, "Create ntp_archiver {}", _ntp.path());
 }
 
 ss::future<> ntp_archiver::stop() {
     _as.request_abort();
-    return _gate.close();
+    return _remote_partition->stop().then([this] { return _gate.close(); });
 }
 
 const model::ntp& ntp_archiver::get_ntp() const { return _ntp; }
@@ -90,12 +150,182 @@ const cloud_storage::manifest& ntp_archiver::get_remote_manifest() const {
     return _manifest;
 }
 
+ss::lw_shared_ptr<cloud_storage::remote_partition>
+ntp_archiver::get_remote_partition() const {
+    return _remote_partition;
+}
+
+bool ntp_archiver::is_manifest_synced() const { return _manifest_synced; }
+
+ss::future<> ntp_archiver::restore_cached_manifest(model::term_id term) {
+    gate_guard guard{_gate};
+    _term = term;
+    auto reader = co_await _manifest_cache.open_snapshot();
+    if (!reader) {
+        co_return;
+    }
+    std::optional<model::term_id> upload_term;
+    std::exception_ptr ex;
+    try {
+        upload_term = co_await read_cached_manifest(*reader);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await reader->close();
+    co_await _manifest_cache.remove_partial_snapshots();
+    if (ex) {
+        vlog(
+          archival_log.warn,
+          "Unable to read cached manifest {} of {}, it will be downloaded - "
+          "{}",
+          _manifest_cache.snapshot_path(),
+          _ntp,
+          ex);
+        co_return;
+    }
+    if (!upload_term) {
+        co_return;
+    }
+    // Only the leader uploads the manifest, if it was uploaded in the
+    // current term nobody else could change it since
+    _manifest_synced = term != model::term_id{} && *upload_term == term;
+    vlog(
+      archival_log.info,
+      "Restored cached manifest of {} with {} segments, uploaded in term {}, "
+      "synced: {}",
+      _ntp,
+      _manifest.size(),
+      *upload_term,
+      _manifest_synced);
+}
+
+ss::future<std::optional<model::term_id>>
+ntp_archiver::read_cached_manifest(storage::snapshot_reader& reader) {
+    iobuf_parser meta(co_await reader.read_metadata());
+    auto version = reflection::adl<int8_t>{}.from(meta);
+    if (version != manifest_cache_version) {
+        vlog(
+          archival_log.warn,
+          "Ignoring cached manifest of {} with unsupported version {}",
+          _ntp,
+          version);
+        co_return std::nullopt;
+    }
+    auto upload_term = reflection::adl<model::term_id>{}.from(meta);
+    auto etag = reflection::adl<ss::sstring>{}.from(meta);
+    auto sizes = reflection::adl<std::vector<uint64_t>>{}.from(meta);
+    if (sizes.empty()) {
+        co_return std::nullopt;
+    }
+    cloud_storage::manifest m;
+    m.update_binary(co_await read_iobuf_exactly(reader.input(), sizes[0]));
+    if (m.get_spillover().size() != sizes.size() - 1) {
+        co_return std::nullopt;
+    }
+    for (size_t i = 1; i < sizes.size(); i++) {
+        m.update_spillover(
+          co_await read_iobuf_exactly(reader.input(), sizes[i]));
+    }
+    // the partition could be recreated with the same name
+    if (m.get_ntp() != _ntp || m.get_revision_id() != _rev) {
+        vlog(
+          archival_log.debug,
+          "Ignoring cached manifest of {} revision {}, current revision {}",
+          m.get_ntp(),
+          m.get_revision_id(),
+          _rev);
+        co_return std::nullopt;
+    }
+    _manifest = std::move(m);
+    _manifest_etag = std::move(etag);
+    co_return upload_term;
+}
+
+ss::future<> ntp_archiver::write_cached_manifest(model::term_id upload_term) {
+    std::vector<uint64_t> sizes;
+    iobuf data;
+    auto append = [&sizes, &data](iobuf buf) {
+        sizes.push_back(buf.size_bytes());
+        data.append(std::move(buf));
+    };
+    append(_manifest.serialize_binary());
+    for (const auto& sp : _manifest.get_spillover()) {
+        append(_manifest.serialize_spillover(sp));
+    }
+    iobuf meta;
+    reflection::serialize(
+      meta, manifest_cache_version, upload_term, _manifest_etag, sizes);
+
+    std::exception_ptr ex;
+    try {
+        auto writer = co_await _manifest_cache.start_snapshot();
+        try {
+            co_await writer.write_metadata(std::move(meta));
+            co_await write_iobuf_to_output_stream(
+              std::move(data), writer.output());
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await writer.close();
+        if (!ex) {
+            co_await _manifest_cache.finish_snapshot(writer);
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        vlog(
+          archival_log.warn,
+          "Unable to write cached manifest {} of {} - {}",
+          _manifest_cache.snapshot_path(),
+          _ntp,
+          ex);
+    }
+}
+
 ss::future<cloud_storage::download_result>
 ntp_archiver::download_manifest(retry_chain_node& parent) {
     gate_guard guard{_gate};
     retry_chain_node fib(_manifest_upload_timeout, _initial_backoff, &parent);
     vlog(archival_log.debug, "{} Downloading manifest for {}", fib(), _ntp);
-    co_return co_await _remote.download_manifest(_bucket, _manifest, fib);
+    auto etag = _manifest_etag;
+    auto res = cloud_storage::download_result::notfound;
+    if (_binary_manifest) {
+        res = co_await _remote.download_binary_manifest(
+          _bucket, _manifest, fib, &_manifest_etag);
+        if (res == cloud_storage::download_result::notfound) {
+            // The partition could be archived before the binary format was
+            // enabled, fall back to json
+            vlog(
+              archival_log.debug,
+              "{} Binary manifest for {} not found, trying json",
+              fib(),
+              _ntp);
+        }
+    }
+    if (res == cloud_storage::download_result::notfound) {
+        res = co_await _remote.download_manifest(
+          _bucket, _manifest, fib, &_manifest_etag);
+    }
+    switch (res) {
+    case cloud_storage::download_result::success:
+        _manifest_synced = true;
+        if (_manifest_etag.empty() || _manifest_etag != etag) {
+            // the manifest was changed by somebody else
+            co_await write_cached_manifest(model::term_id{});
+        }
+        break;
+    case cloud_storage::download_result::notfound:
+        // the cached manifest belongs to the objects that no longer exist
+        _manifest = cloud_storage::manifest(_ntp, _rev);
+        _manifest_etag = "";
+        _manifest_synced = true;
+        break;
+    case cloud_storage::download_result::failed:
+    case cloud_storage::download_result::timedout:
+        break;
+    }
+    co_return res;
 }
 
 ss::future<cloud_storage::upload_result>
@@ -103,11 +333,64 @@ ntp_archiver::upload_manifest(retry_chain_node& parent) {
     gate_guard guard{_gate};
     retry_chain_node fib(_manifest_upload_timeout, _initial_backoff, &parent);
     vlog(archival_log.debug, "{} Uploading manifest for {}", fib(), _ntp);
-    co_return co_await _remote.upload_manifest(_bucket, _manifest, fib);
+    cloud_storage::upload_result res;
+    if (!_binary_manifest) {
+        res = co_await _remote.upload_manifest(
+          _bucket, _manifest, fib, &_manifest_etag);
+    } else {
+        if (auto sp = _manifest.get_spillover_candidate(
+              _spillover_manifest_segments);
+            sp.has_value()) {
+            vlog(
+              archival_log.debug,
+              "{} Moving {} segments of {} to spillover manifest, offsets "
+              "{}-{}",
+              fib(),
+              sp->num_segments,
+              _ntp,
+              sp->base_offset,
+              sp->committed_offset);
+            auto spres = co_await _remote.upload_spillover_manifest(
+              _bucket, _manifest, *sp, fib);
+            if (spres == cloud_storage::upload_result::success) {
+                _manifest.add_spillover(*sp);
+            }
+        }
+        res = co_await _remote.upload_binary_manifest(
+          _bucket, _manifest, fib, &_manifest_etag);
+    }
+    if (res == cloud_storage::upload_result::success) {
+        co_await write_cached_manifest(_term);
+        // the replaced objects are no longer referenced by the manifest
+        for (auto& s : _removed) {
+            if (!s.since) {
+                s.since = ss::lowres_clock::now();
+            }
+        }
+    }
+    co_return res;
+}
+
+uint64_t ntp_archiver::estimate_backlog_size(
+  storage::log_manager& lm, model::offset high_watermark) {
+    auto last_uploaded_offset = _manifest.size() ? _manifest.get_last_offset()
+                                                     + model::offset(1)
+                                                 : model::offset(0);
+    return _policy.get_upload_backlog(last_uploaded_offset, high_watermark, lm);
+}
+
+cloud_storage::manifest ntp_archiver::make_upload_manifest(
+  const segment_name& name,
+  const cloud_storage::manifest::segment_meta& meta) const {
+    cloud_storage::manifest m(_ntp, _rev);
+    m.add(name, meta);
+    return m;
 }
 
 ss::future<cloud_storage::upload_result> ntp_archiver::upload_segment(
-  upload_candidate candidate, retry_chain_node& parent) {
+  upload_candidate candidate,
+  cloud_storage::manifest::segment_meta meta,
+  retry_chain_node& parent) {
     gate_guard guard{_gate};
     retry_chain_node fib(_segment_upload_timeout, _initial_backoff, &parent);
     vlog(
@@ -119,18 +402,117 @@ ss::future<cloud_storage::upload_result> ntp_archiver::upload_segment(
       candidate.starting_offset,
       candidate.content_length);
 
-    auto reset_func = [candidate] {
-        auto stream = candidate.source->reader().data_stream(
-          candidate.file_offset, ss::default_priority_class());
-        return stream;
+    if (_throttle) {
+        co_await _throttle->throttle(candidate.content_length, _as);
+    }
+
+    auto reset_func = [candidate](uint64_t offset, uint64_t length) {
+        return make_upload_stream(candidate, offset, length);
     };
+    auto paths = make_upload_manifest(candidate.exposed_name, meta);
     co_return co_await _remote.upload_segment(
       _bucket,
       candidate.exposed_name,
       candidate.content_length,
       reset_func,
-      _manifest,
+      paths,
+      fib);
+}
+
+/// Add the entries of the index of an uploaded segment to the index of
+/// the uploaded object
+///
+/// The uploaded part of the segment starts at 'file_offset' and might not
+/// include the beginning of the local segment, it's placed at 'object_pos'
+/// in the object. Entries that point outside of the uploaded part are
+/// dropped, positions and offsets of the remaining entries are made
+/// relative to the start of the object.
+static void append_index(
+  storage::index_state& dst,
+  const storage::index_state& src,
+  size_t file_offset,
+  size_t size,
+  size_t object_pos) {
+    for (size_t i = 0; i < src.relative_offset_index.size(); i++) {
+        auto [rel_offset, rel_time, pos] = src.get_entry(i);
+        auto offset = src.base_offset + model::offset(rel_offset);
+        if (
+          pos < file_offset || pos >= file_offset + size
+          || offset < dst.base_offset) {
+            continue;
+        }
+        dst.add_entry(
+          static_cast<uint32_t>(offset() - dst.base_offset()),
+          rel_time,
+          pos - file_offset + object_pos);
+    }
+}
+
+ss::future<bool> ntp_archiver::upload_segment_index(
+  upload_candidate candidate,
+  cloud_storage::manifest::segment_meta meta,
+  retry_chain_node& parent) {
+    gate_guard guard{_gate};
+    retry_chain_node fib(_segment_upload_timeout, _initial_backoff, &parent);
+    // The object is the uploaded part of the source followed by the
+    // coalesced segments, its index is made of their indexes
+    size_t source_size = candidate.content_length;
+    for (const auto& s : candidate.coalesced) {
+        source_size -= s->reader().file_size();
+    }
+    storage::index_state rebased;
+    rebased.base_offset = candidate.starting_offset;
+    size_t object_pos = 0;
+    for (size_t i = 0; i <= candidate.coalesced.size(); i++) {
+        const auto& segment = i == 0 ? candidate.source
+                                     : candidate.coalesced[i - 1];
+        auto file_offset = i == 0 ? candidate.file_offset : 0;
+        auto size = i == 0 ? source_size : segment->reader().file_size();
+        const auto& path = segment->index().filename();
+        iobuf buf;
+        try {
+            auto f = co_await ss::open_file_dma(path, ss::open_flags::ro);
+            auto is = ss::make_file_input_stream(f);
+            auto os = make_iobuf_ref_output_stream(buf);
+            co_await ss::copy(is, os).finally([&is] { return is.close(); });
+        } catch (...) {
+            vlog(
+              archival_log.warn,
+              "{} Can't read index {} of the segment {}: {}",
+              fib(),
+              path,
+              candidate.exposed_name,
+              std::current_exception());
+            co_return false;
+        }
+        auto state = storage::index_state::hydrate_from_buffer(
+          std::move(buf));
+        if (!state || state->empty()) {
+            vlog(
+              archival_log.debug,
+              "{} Index {} of the segment {} is not available",
+              fib(),
+              path,
+              candidate.exposed_name);
+            co_return false;
+        }
+        if (i == 0) {
+            rebased.bitflags = state->bitflags;
+            rebased.base_timestamp = state->base_timestamp;
+        }
+        rebased.max_offset = state->max_offset;
+        rebased.max_timestamp = std::max(
+          rebased.max_timestamp, state->max_timestamp);
+        append_index(rebased, *state, file_offset, size, object_pos);
+        object_pos += size;
+    }
+    auto res = co_await _remote.upload_segment_index(
+      _bucket,
+      candidate.exposed_name,
+      rebased.checksum_and_serialize(),
+      make_upload_manifest(candidate.exposed_name, meta),
       fib);
+    co_return res == cloud_storage::upload_result::success;
 }
 
 ss::future<ntp_archiver::batch_result> ntp_archiver::upload_next_candidates(
@@ -145,6 +527,11 @@ ss::future<ntp_archiver::batch_result> ntp_archiver::upload_next_candidates(
       parent(),
       _ntp);
     ntp_archiver::batch_result total{};
+    if (!_manifest_synced) {
+        co_return total;
+    }
+    co_await apply_retention(lm, parent);
+    co_await delete_removed_segments(parent);
     // We have to increment last offset to guarantee progress.
     // The manifest's last offset contains dirty_offset of the
     // latest uploaded segment but '_policy' requires offset that
@@ -157,6 +544,7 @@ ss::future<ntp_archiver::batch_result> ntp_archiver::upload_next_candidates(
     std::vector<cloud_storage::manifest::segment_meta> meta;
     std::vector<ss::sstring> names;
     std::vector<model::offset> deltas;
+    std::vector<upload_candidate> candidates;
     for (size_t i = 0; i < _concurrency; i++) {
         vlog(
           archival_log.debug,
@@ -164,7 +552,7 @@ ss::future<ntp_archiver::batch_result> ntp_archiver::upload_next_candidates(
           parent(),
           _ntp,
           last_uploaded_offset);
-        auto upload = _policy.get_next_candidate(
+        auto upload = co_await _policy.get_next_candidate(
           last_uploaded_offset, high_watermark, lm);
         if (upload.source.get() == nullptr) {
             vlog(
@@ -174,6 +562,22 @@ ss::future<ntp_archiver::batch_result> ntp_archiver::upload_next_candidates(
               _ntp);
             break;
         }
+        if (
+          _coalesce_target_size != 0
+          && upload.content_length < _coalesce_target_size
+          && ss::lowres_clock::now() - _last_upload_time
+               < _coalesce_max_delay) {
+            // Wait for more segments to coalesce them into one object
+            vlog(
+              archival_log.debug,
+              "{} Uploading next candidates for {}, deferring small upload "
+              "{} of size {}",
+              parent(),
+              _ntp,
+              upload,
+              upload.content_length);
+            break;
+        }
         if (_manifest.contains(upload.exposed_name)) {
             // If the manifest already contains the name we have the following
             // cases
@@ -198,7 +602,7 @@ ss::future<ntp_archiver::batch_result> ntp_archiver::upload_next_candidates(
             //   - Same as previoius. We need to log error and continue with the
             //   largest offset.
             const auto& meta = _manifest.get(upload.exposed_name);
-            auto dirty_offset = upload.source->offsets().dirty_offset;
+            auto dirty_offset = upload.last_source()->offsets().dirty_offset;
             if (meta->committed_offset < dirty_offset) {
                 vlog(
                   archival_log.info,
@@ -224,36 +628,50 @@ ss::future<ntp_archiver::batch_result> ntp_archiver::upload_next_candidates(
                 continue;
             }
         }
-        auto offset = upload.source->offsets().dirty_offset;
+        auto offset = upload.last_source()->offsets().dirty_offset;
         auto base = upload.source->offsets().base_offset;
         last_uploaded_offset = offset + model::offset(1);
         deltas.push_back(offset - base);
-        flist.emplace_back(upload_segment(upload, parent));
         cloud_storage::manifest::segment_meta m{
-          .is_compacted = upload.source->is_compacted_segment(),
+          // segments of compacted topics are uploaded before the local
+          // compaction, they are replaced later by the compacted ones
+          .is_compacted = upload.source->finished_self_compaction(),
           .size_bytes = upload.content_length,
           .base_offset = upload.starting_offset,
           .committed_offset = offset,
+          .base_timestamp = upload.source->index().base_timestamp(),
+          .max_timestamp = upload.last_source()->index().max_timestamp(),
         };
+        flist.emplace_back(upload_segment(upload, m, parent));
         meta.emplace_back(m);
         names.emplace_back(upload.exposed_name);
+        candidates.push_back(upload);
     }
     if (flist.empty()) {
         vlog(
           archival_log.debug,
-          "{} Uploading next candidates for {}, no uploads started ...skip",
+          "{} Uploading next candidates for {}, no uploads started",
           parent(),
           _ntp);
-        co_return total;
+        // The new data is uploaded first, the replacement of the segments
+        // rewritten by the local compaction can wait
+        co_return co_await upload_next_compacted_candidate(lm, parent);
     }
     auto results = co_await ss::when_all_succeed(begin(flist), end(flist));
     total.num_succeded = std::count(
       begin(results), end(results), cloud_storage::upload_result::success);
     total.num_failed = flist.size() - total.num_succeded;
+    std::vector<ss::future<bool>> ilist;
     for (size_t i = 0; i < results.size(); i++) {
         if (results[i] != cloud_storage::upload_result::success) {
             break;
         }
+        ilist.emplace_back(
+          upload_segment_index(candidates[i], meta[i], parent));
+    }
+    auto indexed = co_await ss::when_all_succeed(begin(ilist), end(ilist));
+    for (size_t i = 0; i < indexed.size(); i++) {
+        meta[i].has_index = indexed[i];
         _probe.uploaded(deltas[i]);
         _manifest.add(segment_name(names[i]), meta[i]);
     }
@@ -276,4 +694,165 @@ ss::future<ntp_archiver::batch_result> ntp_archiver::upload_next_candidates(
     co_return total;
 }
 
+ss::future<ntp_archiver::batch_result>
+ntp_archiver::upload_next_compacted_candidate(
+  storage::log_manager& lm, retry_chain_node& parent) {
+    batch_result total{};
+    auto [candidate, replaced] = co_await _policy.get_next_compacted_candidate(
+      _manifest, lm);
+    if (candidate.source.get() == nullptr) {
+        co_return total;
+    }
+    cloud_storage::manifest::segment_meta meta{
+      .is_compacted = true,
+      .size_bytes = candidate.content_length,
+      .base_offset = candidate.starting_offset,
+      .committed_offset = candidate.source->offsets().dirty_offset,
+      .base_timestamp = candidate.source->index().base_timestamp(),
+      .max_timestamp = candidate.source->index().max_timestamp(),
+    };
+    vlog(
+      archival_log.info,
+      "{} Replacing {} uploaded segments of {} with compacted segment {}, "
+      "offsets {}-{}",
+      parent(),
+      replaced.size(),
+      _ntp,
+      candidate,
+      meta.base_offset,
+      meta.committed_offset);
+    auto res = co_await upload_segment(candidate, meta, parent);
+    if (res != cloud_storage::upload_result::success) {
+        total.num_failed = 1;
+        co_return total;
+    }
+    meta.has_index = co_await upload_segment_index(candidate, meta, parent);
+    for (const auto& name : replaced) {
+        // the path depends on the manifest entry
+        _removed.push_back(
+          {.path = _manifest.get_remote_segment_path(name)});
+        _manifest.delete_permanently(name);
+    }
+    _manifest.add(candidate.exposed_name, meta);
+    total.num_succeded = 1;
+    auto mres = co_await upload_manifest(parent);
+    if (mres != cloud_storage::upload_result::success) {
+        vlog(
+          archival_log.debug,
+          "{} Manifest upload for {} failed",
+          parent(),
+          _ntp);
+    }
+    co_return total;
+}
+
+/// Max number of segments removed from the manifest by one update, every
+/// segment is deleted with its index
+static constexpr size_t max_removed_segments_per_batch
+  = s3::client::max_delete_objects_keys / 2;
+
+/// Retention limits of the topic, same as the limits of the local log
+static std::pair<std::optional<size_t>, std::optional<model::timestamp>>
+get_retention_limits(
+  const storage::log_config& defaults, const storage::ntp_config& cfg) {
+    std::optional<size_t> max_bytes = defaults.retention_bytes;
+    std::optional<model::timestamp> eviction_time = model::timestamp(
+      model::timestamp::now().value() - defaults.delete_retention.count());
+    if (!cfg.has_overrides()) {
+        return {max_bytes, eviction_time};
+    }
+    const auto& overrides = cfg.get_overrides();
+    if (overrides.retention_bytes.is_disabled()) {
+        max_bytes = std::nullopt;
+    }
+    if (overrides.retention_bytes.has_value()) {
+        max_bytes = overrides.retention_bytes.value();
+    }
+    if (overrides.retention_time.is_disabled()) {
+        eviction_time = std::nullopt;
+    }
+    if (overrides.retention_time.has_value()) {
+        eviction_time = model::timestamp(
+          model::timestamp::now().value()
+          - overrides.retention_time.value().count());
+    }
+    return {max_bytes, eviction_time};
+}
+
+ss::future<> ntp_archiver::apply_retention(
+  storage::log_manager& lm, retry_chain_node& parent) {
+    if (!_retention_enabled) {
+        co_return;
+    }
+    auto log = lm.get(_ntp);
+    if (!log || !log->config().is_collectable()) {
+        co_return;
+    }
+    auto [max_bytes, eviction_time] = get_retention_limits(
+      lm.config(), log->config());
+    auto expired = _manifest.get_expired_segments(
+      max_bytes, eviction_time, max_removed_segments_per_batch);
+    if (expired.empty()) {
+        co_return;
+    }
+    vlog(
+      archival_log.info,
+      "{} Removing {} expired segments of {} starting from {}",
+      parent(),
+      expired.size(),
+      _ntp,
+      expired.front());
+    for (const auto& name : expired) {
+        // the path depends on the manifest entry
+        _removed.push_back({.path = _manifest.get_remote_segment_path(name)});
+        _manifest.delete_permanently(name);
+    }
+    auto res = co_await upload_manifest(parent);
+    if (res != cloud_storage::upload_result::success) {
+        vlog(
+          archival_log.debug,
+          "{} Manifest upload for {} failed",
+          parent(),
+          _ntp);
+    }
+}
+
+ss::future<>
+ntp_archiver::delete_removed_segments(retry_chain_node& parent) {
+    auto now = ss::lowres_clock::now();
+    while (!_removed.empty()) {
+        // the readers of the old manifest can still fetch the objects
+        std::vector<cloud_storage::remote_segment_path> batch;
+        for (const auto& r : _removed) {
+            if (
+              !r.since || now - *r.since < removed_segment_delete_delay
+              || batch.size() == max_removed_segments_per_batch) {
+                break;
+            }
+            batch.push_back(r.path);
+        }
+        if (batch.empty()) {
+            break;
+        }
+        if (_delete_throttle) {
+            co_await _delete_throttle->throttle(batch.size() * 2, _as);
+        }
+        retry_chain_node fib(
+          _segment_upload_timeout, _initial_backoff, &parent);
+        auto res = co_await _remote.delete_segments(_bucket, batch, fib);
+        if (res != cloud_storage::upload_result::success) {
+            vlog(
+              archival_log.warn,
+              "{} Can't delete {} removed segments of {}, will retry",
+              fib(),
+              batch.size(),
+              _ntp);
+            break;
+        }
+        _removed.erase(
+          _removed.begin(),
+          _removed.begin() + static_cast<ptrdiff_t>(batch.size()));
+    }
+}
+
 } // namespace archival
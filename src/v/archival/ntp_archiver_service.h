@@ -12,14 +12,18 @@
 #include "archival/archival_policy.h"
 #include "archival/probe.h"
 #include "archival/types.h"
+#include "archival/upload_throttle.h"
+#include "cloud_storage/cache_service.h"
 #include "cloud_storage/manifest.h"
 #include "cloud_storage/remote.h"
+#include "cloud_storage/remote_partition.h"
 #include "cloud_storage/types.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
 #include "s3/client.h"
 #include "storage/fwd.h"
 #include "storage/segment.h"
+#include "storage/snapshot.h"
 #include "utils/retry_chain_node.h"
 
 #include <seastar/core/abort_source.hh>
@@ -27,6 +31,8 @@
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <deque>
+#include <filesystem>
 #include <functional>
 #include <map>
 
@@ -54,6 +60,36 @@ struct configuration {
     service_metrics_disabled svc_metrics_disabled;
     /// Flag that indicates that ntp-archiver level metrics are disabled
     per_ntp_metrics_disabled ntp_metrics_disabled;
+    /// Directory of the segment cache, every shard uses its own
+    /// subdirectory
+    std::filesystem::path cache_directory;
+    /// Size of the segment cache of the shard, 0 disables the cache
+    uint64_t cache_size{0};
+    /// Multipart upload settings
+    cloud_storage::multipart_upload_config multipart_upload;
+    /// Upload bandwidth limit of the shard (bytes/sec), 0 means no limit
+    uint64_t upload_bandwidth{0};
+    /// Use binary manifest format instead of json
+    bool binary_manifest{false};
+    /// Max number of segments in the binary manifest, older segments are
+    /// moved to the spillover manifests (0 disables spillover)
+    size_t spillover_manifest_segments{0};
+    /// Max size of the object the small consecutive segments are uploaded
+    /// as, 0 uploads every segment as its own object
+    size_t coalesce_upload_target_size{0};
+    /// Max time a small upload is deferred to coalesce it with the next
+    /// segments
+    ss::lowres_clock::duration coalesce_upload_max_delay{0};
+    /// Hedged download settings
+    cloud_storage::hedged_download_config hedged_download;
+    /// Apply the retention settings of the topic to the uploaded data
+    bool retention_enabled{false};
+    /// Max number of objects deleted by the shard per second, 0 means no
+    /// limit
+    uint64_t delete_objects_rate{0};
+    /// Max number of segments fetched ahead of a sequential remote reader,
+    /// 0 disables the prefetch
+    size_t read_prefetch_depth{0};
 };
 
 std::ostream& operator<<(std::ostream& o, const configuration& cfg);
@@ -78,11 +114,18 @@ public:
     /// \param conf is an S3 client configuration
     /// \param remote is an object used to send/recv data
     /// \param svc_probe is a service level probe (optional)
+    /// \param cache is a segment cache used by remote reads (optional)
+    /// \param throttle is a shard wide upload bandwidth limit (optional)
+    /// \param delete_throttle is a shard wide limit of the deleted objects
+    ///        per second (optional)
     ntp_archiver(
       const storage::ntp_config& ntp,
       const configuration& conf,
       cloud_storage::remote& remote,
-      service_probe& svc_probe);
+      service_probe& svc_probe,
+      cloud_storage::cache* cache = nullptr,
+      upload_throttle* throttle = nullptr,
+      upload_throttle* delete_throttle = nullptr);
 
     /// Stop archiver.
     ///
@@ -99,8 +142,23 @@ public:
     /// Get timestamp
     const ss::lowres_clock::time_point get_last_upload_time() const;
 
+    /// \brief Load the manifest from the local cache
+    ///
+    /// The cached manifest is used as is if it was uploaded by the leader
+    /// of the current term, otherwise it's only used to make the next
+    /// 'download_manifest' call conditional. Errors are logged and
+    /// ignored, the manifest is downloaded from S3 in this case.
+    /// \param term is the current term of the partition
+    ss::future<> restore_cached_manifest(model::term_id term);
+
+    /// Return true if the manifest is known to match the one in S3, the
+    /// uploads are not started until it is
+    bool is_manifest_synced() const;
+
     /// Download manifest from pre-defined S3 locatnewion
     ///
+    /// The download is skipped by S3 if the manifest didn't change since
+    /// it was cached.
     /// \return future that returns true if the manifest was found in S3
     ss::future<cloud_storage::download_result>
     download_manifest(retry_chain_node& parent);
@@ -111,6 +169,19 @@ public:
 
     const cloud_storage::manifest& get_remote_manifest() const;
 
+    /// Get read-only S3 view of the partition that can be used to serve
+    /// reads below the local start offset
+    ss::lw_shared_ptr<cloud_storage::remote_partition>
+    get_remote_partition() const;
+
+    /// \brief Estimate the size of the data that is not uploaded yet
+    ///
+    /// \param lm is a log manager instance
+    /// \param high_watermark is a high watermark offset of the partition
+    /// \return number of bytes in the sealed segments that can be uploaded
+    uint64_t estimate_backlog_size(
+      storage::log_manager& lm, model::offset high_watermark);
+
     struct batch_result {
         size_t num_succeded;
         size_t num_failed;
@@ -133,9 +204,71 @@ public:
 private:
     /// Upload individual segment to S3.
     ///
+    /// \param meta is a manifest entry the segment is added with, it
+    ///        defines the path of the object
     /// \return true on success and false otherwise
-    ss::future<cloud_storage::upload_result>
-    upload_segment(upload_candidate candidate, retry_chain_node& fib);
+    ss::future<cloud_storage::upload_result> upload_segment(
+      upload_candidate candidate,
+      cloud_storage::manifest::segment_meta meta,
+      retry_chain_node& fib);
+
+    /// Upload the index of the uploaded segment to S3.
+    ///
+    /// The local index is rebased to match the uploaded part of the
+    /// segment. The upload is best effort, remote readers fall back to
+    /// the full scan of the segment if the index is not available.
+    /// \return true if the index was uploaded
+    ss::future<bool> upload_segment_index(
+      upload_candidate candidate,
+      cloud_storage::manifest::segment_meta meta,
+      retry_chain_node& fib);
+
+    /// Manifest that contains only the uploaded segment, it's used to get
+    /// the path of the object before the segment is added to '_manifest'
+    cloud_storage::manifest make_upload_manifest(
+      const segment_name& name,
+      const cloud_storage::manifest::segment_meta& meta) const;
+
+    /// \brief Replace the uploaded segments rewritten by the local
+    /// compaction with the compacted segment
+    ///
+    /// The replaced objects are deleted from S3 some time after the
+    /// manifest without them is uploaded.
+    ss::future<batch_result> upload_next_compacted_candidate(
+      storage::log_manager& lm, retry_chain_node& parent);
+
+    /// \brief Remove the segments that violate the retention limits of the
+    /// topic from the manifest
+    ///
+    /// The objects are deleted from S3 some time after the manifest without
+    /// them is uploaded.
+    ss::future<>
+    apply_retention(storage::log_manager& lm, retry_chain_node& parent);
+
+    /// Delete the removed objects that are no longer referenced by the
+    /// uploaded manifest for long enough. The objects are deleted in
+    /// batches.
+    ss::future<> delete_removed_segments(retry_chain_node& parent);
+
+    /// Store the manifest in the local cache, errors are logged and ignored
+    ///
+    /// \param upload_term is the term the manifest was uploaded in or an
+    ///        invalid term if it was downloaded
+    ss::future<> write_cached_manifest(model::term_id upload_term);
+
+    /// Read the cached manifest, return the term it was uploaded in or
+    /// nullopt if the cache can't be used
+    ss::future<std::optional<model::term_id>>
+    read_cached_manifest(storage::snapshot_reader& reader);
+
+    /// Object removed from the manifest (replaced by the compacted segment
+    /// or expired)
+    struct removed_segment {
+        cloud_storage::remote_segment_path path;
+        /// Time when the manifest without the object was uploaded (missing
+        /// if it's not uploaded yet)
+        std::optional<ss::lowres_clock::time_point> since;
+    };
 
     service_probe& _svc_probe;
     ntp_level_probe _probe;
@@ -147,6 +280,9 @@ private:
     /// Remote manifest contains representation of the data stored in S3 (it
     /// gets uploaded to the remote location)
     cloud_storage::manifest _manifest;
+    ss::lw_shared_ptr<cloud_storage::remote_partition> _remote_partition;
+    upload_throttle* _throttle;
+    upload_throttle* _delete_throttle;
     ss::gate _gate;
     ss::abort_source _as;
     ss::semaphore _mutex{1};
@@ -156,6 +292,20 @@ private:
     ss::lowres_clock::duration _initial_backoff;
     ss::lowres_clock::duration _segment_upload_timeout;
     ss::lowres_clock::duration _manifest_upload_timeout;
+    bool _binary_manifest;
+    size_t _spillover_manifest_segments;
+    size_t _coalesce_target_size;
+    ss::lowres_clock::duration _coalesce_max_delay;
+    bool _retention_enabled;
+    /// Removed objects waiting for deletion, ordered by 'since'
+    std::deque<removed_segment> _removed;
+    /// Local copy of the last downloaded or uploaded manifest
+    storage::snapshot_manager _manifest_cache;
+    /// ETag of the manifest object in S3 (empty if unknown)
+    ss::sstring _manifest_etag;
+    /// Term of the partition the archiver was started in
+    model::term_id _term;
+    bool _manifest_synced{false};
 };
 
 } // namespace archival
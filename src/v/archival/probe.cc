@@ -21,7 +21,8 @@ ntp_level_probe::ntp_level_probe(
   per_ntp_metrics_disabled disabled, const model::ntp& ntp)
   : _uploaded()
   , _missing()
-  , _pending() {
+  , _pending()
+  , _pending_bytes() {
     if (disabled) {
         return;
     }
@@ -54,6 +55,11 @@ ntp_level_probe::ntp_level_probe(
           [this] { return _pending; },
           sm::description("Pending offsets"),
           labels),
+        sm::make_gauge(
+          "pending_bytes",
+          [this] { return _pending_bytes; },
+          sm::description("Size of the sealed segments yet to be uploaded"),
+          labels),
       });
 }
 
@@ -150,6 +156,57 @@ service_probe::service_probe(service_metrics_disabled disabled)
           [this] { return get_download_backoffs(); },
           sm::description("Number of times backoff  was applied during "
                           "log-segment downloads")),
+        sm::make_counter(
+          "hedged_downloads",
+          [this] { return get_hedged_downloads(); },
+          sm::description(
+            "Number of duplicate requests sent for the slow downloads")),
+        sm::make_counter(
+          "deleted_objects",
+          [this] { return get_deleted_objects(); },
+          sm::description("Number of objects removed from the bucket")),
+        sm::make_counter(
+          "segment_prefetches",
+          [this] { return get_segment_prefetches(); },
+          sm::description(
+            "Number of segments downloaded ahead of the sequential readers")),
+        sm::make_counter(
+          "prefetch_hits",
+          [this] { return get_prefetch_hits(); },
+          sm::description("Number of reads of the prefetched segments")),
+        sm::make_histogram(
+          "upload_latency_us",
+          [this] { return get_upload_latency().seastar_histogram_logform(); },
+          sm::description("Time it took to upload a log-segment, including "
+                          "the retries")),
+        sm::make_histogram(
+          "upload_throughput",
+          [this] {
+              return get_upload_throughput().seastar_histogram_logform();
+          },
+          sm::description("Throughput of the log-segment uploads in bytes "
+                          "per second")),
+        sm::make_histogram(
+          "download_latency_us",
+          [this] {
+              return get_download_latency().seastar_histogram_logform();
+          },
+          sm::description("Time it took to download an object, including "
+                          "the retries")),
+        sm::make_histogram(
+          "download_throughput",
+          [this] {
+              return get_download_throughput().seastar_histogram_logform();
+          },
+          sm::description(
+            "Throughput of the downloads in bytes per second")),
+        sm::make_histogram(
+          "prefetch_depth",
+          [this] {
+              return get_prefetch_depth().seastar_histogram_logform();
+          },
+          sm::description("Number of segments or ranges fetched ahead of "
+                          "the sequential readers")),
       });
 }
 
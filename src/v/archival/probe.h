@@ -41,6 +41,9 @@ public:
     /// Register the offset the ought to be uploaded
     void upload_lag(model::offset offset_delta) { _pending = offset_delta; }
 
+    /// Register the number of bytes that ought to be uploaded
+    void upload_backlog(uint64_t bytes) { _pending_bytes = bytes; }
+
 private:
     /// Uploaded offsets
     int64_t _uploaded;
@@ -48,6 +51,8 @@ private:
     int64_t _missing;
     /// Width of the offset range yet to be uploaded
     int64_t _pending;
+    /// Size of the sealed segments yet to be uploaded
+    uint64_t _pending_bytes;
 
     ss::metrics::metric_groups _metrics;
 };
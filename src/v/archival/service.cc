@@ -41,7 +41,7 @@
 #include <seastar/core/smp.hh>
 #include <seastar/core/when_all.hh>
 
-#include <boost/iterator/counting_iterator.hpp>
+#include <boost/range/irange.hpp>
 
 #include <algorithm>
 #include <exception>
@@ -160,6 +160,38 @@ scheduler_service_impl::get_archival_service_config() {
         static_cast<bool>(disable_metrics)),
       .ntp_metrics_disabled = per_ntp_metrics_disabled(
         static_cast<bool>(disable_metrics)),
+      .cache_directory = config::shard_local_cfg().data_directory().path
+                         / "cloud_storage_cache",
+      .cache_size = config::shard_local_cfg().cloud_storage_cache_size()
+                    / ss::smp::count,
+      .multipart_upload = cloud_storage::multipart_upload_config{
+        .part_size = config::shard_local_cfg()
+                       .cloud_storage_multipart_upload_part_size(),
+        .max_concurrency = config::shard_local_cfg()
+                             .cloud_storage_multipart_upload_concurrency(),
+      },
+      .upload_bandwidth
+      = config::shard_local_cfg().cloud_storage_upload_bandwidth_per_shard(),
+      .binary_manifest
+      = config::shard_local_cfg().cloud_storage_binary_manifest(),
+      .spillover_manifest_segments
+      = config::shard_local_cfg().cloud_storage_spillover_manifest_segments(),
+      .coalesce_upload_target_size
+      = config::shard_local_cfg().cloud_storage_coalesce_upload_size(),
+      .coalesce_upload_max_delay
+      = config::shard_local_cfg().cloud_storage_coalesce_upload_delay_ms(),
+      .hedged_download = cloud_storage::hedged_download_config{
+        .percentile = config::shard_local_cfg()
+                        .cloud_storage_hedge_download_percentile(),
+        .budget_percent = config::shard_local_cfg()
+                            .cloud_storage_hedge_download_budget_percent(),
+      },
+      .retention_enabled
+      = config::shard_local_cfg().cloud_storage_enable_retention(),
+      .delete_objects_rate
+      = config::shard_local_cfg().cloud_storage_delete_objects_per_shard(),
+      .read_prefetch_depth
+      = config::shard_local_cfg().cloud_storage_read_prefetch_depth(),
     };
     vlog(archival_log.debug, "Archival configuration generated: {}", cfg);
     co_return cfg;
@@ -178,7 +210,21 @@ scheduler_service_impl::scheduler_service_impl(
   , _stop_limit(conf.connection_limit())
   , _rtcnode(_as)
   , _probe(conf.svc_metrics_disabled)
-  , _remote(conf.connection_limit, conf.client_config, _probe)
+  , _remote(
+      conf.connection_limit,
+      conf.client_config,
+      _probe,
+      conf.multipart_upload,
+      conf.hedged_download)
+  , _recovery(
+      _remote,
+      conf.bucket_name,
+      conf.connection_limit,
+      conf.segment_upload_timeout,
+      conf.initial_backoff)
+  , _cache(make_cache(conf))
+  , _throttle(conf.upload_bandwidth)
+  , _delete_throttle(conf.delete_objects_rate)
   , _topic_manifest_upload_timeout(conf.manifest_upload_timeout)
   , _initial_backoff(conf.initial_backoff) {}
 
@@ -192,6 +238,7 @@ scheduler_service_impl::scheduler_service_impl(
 void scheduler_service_impl::rearm_timer() {
     (void)ss::with_gate(_gate, [this] {
         return reconcile_archivers()
+          .then([this] { return reconcile_read_replicas(); })
           .finally([this] {
               if (_gate.is_closed()) {
                   return;
@@ -207,32 +254,54 @@ void scheduler_service_impl::rearm_timer() {
           });
     });
 }
+std::unique_ptr<cloud_storage::cache>
+scheduler_service_impl::make_cache(const configuration& conf) {
+    if (conf.cache_size == 0) {
+        return nullptr;
+    }
+    return std::make_unique<cloud_storage::cache>(
+      conf.cache_directory / std::to_string(ss::this_shard_id()),
+      conf.cache_size,
+      cloud_storage::cache_metrics_disabled(
+        static_cast<bool>(conf.svc_metrics_disabled)));
+}
+
 ss::future<> scheduler_service_impl::start() {
+    if (_cache) {
+        co_await _cache->start();
+    }
     _timer.set_callback([this] { rearm_timer(); });
     _timer.rearm(_jitter());
     (void)run_uploads();
-    return ss::now();
 }
 
 ss::future<> scheduler_service_impl::stop() {
     vlog(archival_log.info, "{} Scheduler service stop", _rtcnode());
     _timer.cancel();
     _as.request_abort(); // interrupt possible sleep
-    return _remote.stop().then([this] {
-        std::vector<ss::future<>> outstanding;
-        for (auto& it : _queue) {
-            auto fut = ss::with_semaphore(
-              _stop_limit, 1, [it] { return it.second.archiver->stop(); });
-            outstanding.emplace_back(std::move(fut));
-        }
-        return ss::do_with(
-          std::move(outstanding),
-          [this](std::vector<ss::future<>>& outstanding) {
-              return ss::when_all_succeed(
-                       outstanding.begin(), outstanding.end())
-                .finally([this] { return _gate.close(); });
-          });
-    });
+    return _remote.stop()
+      .then([this] { return _recovery.stop(); })
+      .then([this] {
+          std::vector<ss::future<>> outstanding;
+          for (auto& it : _queue) {
+              auto fut = ss::with_semaphore(
+                _stop_limit, 1, [it] { return it.second.archiver->stop(); });
+              outstanding.emplace_back(std::move(fut));
+          }
+          for (auto& [_, replica] : _read_replicas) {
+              outstanding.emplace_back(replica->stop());
+          }
+          return ss::do_with(
+            std::move(outstanding),
+            [this](std::vector<ss::future<>>& outstanding) {
+                return ss::when_all_succeed(
+                         outstanding.begin(), outstanding.end())
+                  .finally([this] { return _gate.close(); })
+                  .finally([this] {
+                      return _cache ? _cache->stop() : ss::now();
+                  });
+            });
+      });
 }
 
 ss::lw_shared_ptr<ntp_archiver> scheduler_service_impl::get_upload_candidate() {
@@ -292,34 +361,41 @@ ss::future<> scheduler_service_impl::upload_topic_manifest(
     }
 }
 
-ss::future<ss::stop_iteration> scheduler_service_impl::add_ntp_archiver(
+ss::future<> scheduler_service_impl::add_ntp_archiver(
   ss::lw_shared_ptr<ntp_archiver> archiver) {
     if (_gate.is_closed()) {
-        return ss::make_ready_future<ss::stop_iteration>(
-          ss::stop_iteration::yes);
+        return ss::now();
+    }
+    auto p = _partition_manager.local().get(archiver->get_ntp());
+    auto term = p ? p->term() : model::term_id{};
+    return archiver->restore_cached_manifest(term).then([this, archiver] {
+        _queue.insert(archiver);
+        _probe.start_archiving_ntp();
+    });
+}
+
+ss::future<bool> scheduler_service_impl::sync_manifest(
+  ss::lw_shared_ptr<ntp_archiver> archiver) {
+    if (archiver->is_manifest_synced()) {
+        return ss::make_ready_future<bool>(true);
     }
     return archiver->download_manifest(_rtcnode).then(
-      [this, archiver](cloud_storage::download_result result)
-        -> ss::future<ss::stop_iteration> {
+      [this, archiver](cloud_storage::download_result result) {
           auto ntp = archiver->get_ntp();
           switch (result) {
           case cloud_storage::download_result::success:
-              _queue.insert(archiver);
               vlog(
                 archival_log.info,
                 "{} Found manifest for partition {}",
                 _rtcnode(),
-                archiver->get_ntp());
-              _probe.start_archiving_ntp();
-              return ss::make_ready_future<ss::stop_iteration>(
-                ss::stop_iteration::yes);
+                ntp);
+              return true;
           case cloud_storage::download_result::notfound:
-              _queue.insert(archiver);
               vlog(
                 archival_log.info,
                 "{} Start archiving new partition {}",
                 _rtcnode(),
-                archiver->get_ntp());
+                ntp);
               // Start topic manifest upload
               // asynchronously
               if (ntp.tp.partition == 0) {
@@ -329,18 +405,18 @@ ss::future<ss::stop_iteration> scheduler_service_impl::add_ntp_archiver(
                     model::topic_namespace(ntp.ns, ntp.tp.topic),
                     archiver->get_revision_id());
               }
-              _probe.start_archiving_ntp();
-              return ss::make_ready_future<ss::stop_iteration>(
-                ss::stop_iteration::yes);
+              return true;
           case cloud_storage::download_result::failed:
           case cloud_storage::download_result::timedout:
               vlog(
-                archival_log.warn, "{} Manifest download failed", _rtcnode());
-              return ss::make_exception_future<ss::stop_iteration>(
-                ss::timed_out_error());
+                archival_log.warn,
+                "{} Manifest download failed for {}, retrying on the next "
+                "upload round",
+                _rtcnode(),
+                ntp);
+              return false;
           }
-          return ss::make_ready_future<ss::stop_iteration>(
-            ss::stop_iteration::yes);
+          return false;
       });
 }
 
@@ -359,10 +435,14 @@ scheduler_service_impl::create_archivers(std::vector<model::ntp> to_create) {
                           return ss::now();
                       }
                       auto svc = ss::make_lw_shared<ntp_archiver>(
-                        log->config(), _conf, _remote, _probe);
-                      return ss::repeat([this, svc = std::move(svc)] {
-                          return add_ntp_archiver(svc);
-                      });
+                        log->config(),
+                        _conf,
+                        _remote,
+                        _probe,
+                        _cache.get(),
+                        &_throttle,
+                        &_delete_throttle);
+                      return add_ntp_archiver(std::move(svc));
                   });
             });
       });
@@ -397,6 +477,20 @@ scheduler_service_impl::remove_archivers(std::vector<model::ntp> to_remove) {
       .finally([g = std::move(g)] {});
 }
 
+ss::lw_shared_ptr<cloud_storage::remote_partition>
+scheduler_service_impl::get_remote_partition(const model::ntp& ntp) const {
+    auto archiver = _queue[ntp];
+    if (!archiver) {
+        return nullptr;
+    }
+    return archiver->get_remote_partition();
+}
+
+ss::future<bool>
+scheduler_service_impl::download_log(const storage::ntp_config& ntp_cfg) {
+    return _recovery.download_log(ntp_cfg);
+}
+
 std::optional<model::offset>
 scheduler_service_impl::get_high_watermark(const model::ntp& ntp) const {
     cluster::partition_manager& pm = _partition_manager.local();
@@ -429,7 +523,8 @@ ss::future<> scheduler_service_impl::reconcile_archivers() {
       [this, &pm](const model::ntp& ntp) {
           auto p = pm.get(ntp);
           return ntp.ns != model::redpanda_ns && !_queue.contains(ntp) && p
-                 && p->is_leader();
+                 && p->is_leader()
+                 && !p->get_ntp_config().is_read_replica();
       });
     // epxect to_create & to_remove be empty most of the time
     if (unlikely(!to_remove.empty() || !to_create.empty())) {
@@ -457,6 +552,111 @@ ss::future<> scheduler_service_impl::reconcile_archivers() {
     }
 }
 
+ss::future<> scheduler_service_impl::reconcile_read_replicas() {
+    gate_guard g(_gate);
+    cluster::partition_manager& pm = _partition_manager.local();
+    // the read replica follows the leadership of the local partition, the
+    // leader serves the fetches
+    std::vector<ss::lw_shared_ptr<cloud_storage::read_replica>> to_stop;
+    absl::erase_if(_read_replicas, [&pm, &to_stop](const auto& kv) {
+        auto p = pm.get(kv.first);
+        if (p && p->is_leader()) {
+            return false;
+        }
+        to_stop.push_back(kv.second);
+        return true;
+    });
+    for (const auto& [ntp, p] : pm.partitions()) {
+        const auto& cfg = p->get_ntp_config();
+        if (
+          !cfg.is_read_replica() || !p->is_leader()
+          || _read_replicas.contains(ntp)) {
+            continue;
+        }
+        vlog(
+          archival_log.info,
+          "{} Start serving read replica {} from bucket {}",
+          _rtcnode(),
+          ntp,
+          *cfg.get_read_replica_bucket());
+        _read_replicas.emplace(
+          ntp,
+          ss::make_lw_shared<cloud_storage::read_replica>(
+            ntp,
+            _remote,
+            s3::bucket_name(*cfg.get_read_replica_bucket()),
+            _conf.segment_upload_timeout,
+            _conf.initial_backoff,
+            _cache.get(),
+            _conf.read_prefetch_depth));
+    }
+    co_await ss::parallel_for_each(
+      to_stop, [](ss::lw_shared_ptr<cloud_storage::read_replica>& replica) {
+          return replica->stop();
+      });
+
+    // the manifests are polled to pick up the segments uploaded by the
+    // source cluster since the previous round
+    std::vector<ss::lw_shared_ptr<cloud_storage::read_replica>> replicas;
+    replicas.reserve(_read_replicas.size());
+    for (const auto& [_, replica] : _read_replicas) {
+        replicas.push_back(replica);
+    }
+    co_await ss::parallel_for_each(
+      replicas,
+      [this](ss::lw_shared_ptr<cloud_storage::read_replica>& replica) {
+          return replica->sync(_rtcnode).then(
+            [this, replica](cloud_storage::download_result res) {
+                if (
+                  res != cloud_storage::download_result::success
+                  && res != cloud_storage::download_result::notfound) {
+                    vlog(
+                      archival_log.warn,
+                      "{} Failed to sync read replica {} from bucket {}",
+                      _rtcnode(),
+                      replica->get_ntp(),
+                      replica->get_bucket());
+                }
+            });
+      });
+}
+
+ss::lw_shared_ptr<cloud_storage::remote_partition>
+scheduler_service_impl::get_read_replica(const model::ntp& ntp) const {
+    auto it = _read_replicas.find(ntp);
+    if (it == _read_replicas.end() || !it->second->is_synced()) {
+        return nullptr;
+    }
+    return it->second->get_remote_partition();
+}
+
+std::vector<ss::lw_shared_ptr<ntp_archiver>>
+scheduler_service_impl::get_upload_candidates() {
+    storage::log_manager& lm = _storage_api.local().log_mgr();
+    std::vector<std::pair<uint64_t, ss::lw_shared_ptr<ntp_archiver>>> backlog;
+    for (auto& [ntp, item] : _queue) {
+        auto hwm = get_high_watermark(ntp);
+        if (!hwm) {
+            continue;
+        }
+        auto size = item.archiver->estimate_backlog_size(lm, *hwm);
+        if (size == 0) {
+            continue;
+        }
+        backlog.emplace_back(size, item.archiver);
+    }
+    std::stable_sort(
+      backlog.begin(), backlog.end(), [](const auto& lhs, const auto& rhs) {
+          return lhs.first > rhs.first;
+      });
+    std::vector<ss::lw_shared_ptr<ntp_archiver>> result;
+    result.reserve(backlog.size());
+    for (auto& [_, archiver] : backlog) {
+        result.push_back(std::move(archiver));
+    }
+    return result;
+}
+
 ss::future<> scheduler_service_impl::run_uploads() {
     gate_guard g(_gate);
     try {
@@ -464,34 +664,46 @@ ss::future<> scheduler_service_impl::run_uploads() {
         static constexpr ss::lowres_clock::duration max_backoff = 10s;
         ss::lowres_clock::duration backoff = initial_backoff;
         while (!_gate.is_closed()) {
-            int quota = _queue.size();
-            std::vector<ss::future<ntp_archiver::batch_result>> flist;
-
-            std::transform(
-              boost::make_counting_iterator(0),
-              boost::make_counting_iterator(quota),
-              std::back_inserter(flist),
-              [this](int) {
-                  using result_t = ntp_archiver::batch_result;
-                  auto archiver = _queue.get_upload_candidate();
-                  storage::api& api = _storage_api.local();
-                  storage::log_manager& lm = api.log_mgr();
-                  vlog(
-                    archival_log.debug,
-                    "{} Checking {} for S3 upload candidates",
-                    _rtcnode(),
-                    archiver->get_ntp());
-                  auto hwm = get_high_watermark(archiver->get_ntp());
-                  if (hwm) {
-                      return archiver->upload_next_candidates(
-                        lm, *hwm, _rtcnode);
-                  }
-                  return ss::make_ready_future<result_t>(result_t{});
+            // Archivers are started in the order of their backlog size. The
+            // number of archivers that upload at the same time is limited
+            // so the ones that lag behind get the connections first.
+            auto candidates = get_upload_candidates();
+            ss::semaphore limit(_conf.connection_limit());
+            std::vector<ntp_archiver::batch_result> results(
+              candidates.size());
+            co_await ss::parallel_for_each(
+              boost::irange<size_t>(0, candidates.size()),
+              [this, &candidates, &results, &limit](size_t i) {
+                  return ss::with_semaphore(
+                    limit, 1, [this, &candidates, &results, i] {
+                        auto archiver = candidates[i];
+                        auto hwm = get_high_watermark(archiver->get_ntp());
+                        if (!hwm) {
+                            return ss::now();
+                        }
+                        vlog(
+                          archival_log.debug,
+                          "{} Checking {} for S3 upload candidates",
+                          _rtcnode(),
+                          archiver->get_ntp());
+                        // The manifest is fetched lazily, the number of
+                        // the concurrent downloads is bounded by the limit
+                        return sync_manifest(archiver).then(
+                          [this, archiver, &results, i, hwm](bool synced) {
+                              if (!synced) {
+                                  return ss::now();
+                              }
+                              auto& lm = _storage_api.local().log_mgr();
+                              return archiver
+                                ->upload_next_candidates(lm, *hwm, _rtcnode)
+                                .then(
+                                  [&results, i](ntp_archiver::batch_result r) {
+                                      results[i] = r;
+                                  });
+                          });
+                    });
               });
 
-            auto results = co_await ss::when_all_succeed(
-              flist.begin(), flist.end());
-
             auto total = std::accumulate(
               results.begin(),
               results.end(),
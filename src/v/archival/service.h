@@ -10,7 +10,11 @@
 
 #pragma once
 #include "archival/ntp_archiver_service.h"
+#include "cloud_storage/cache_service.h"
 #include "cloud_storage/manifest.h"
+#include "cloud_storage/partition_recovery_manager.h"
+#include "cloud_storage/read_replica.h"
+#include "cloud_storage/remote_partition.h"
 #include "cluster/partition_manager.h"
 #include "model/fundamental.h"
 #include "s3/client.h"
@@ -134,6 +138,12 @@ public:
     /// Get next upload or delete candidate
     ss::lw_shared_ptr<ntp_archiver> get_upload_candidate();
 
+    /// \brief Get archivers that have data to upload
+    ///
+    /// The archivers are ordered by the size of the upload backlog, the
+    /// ones that lag behind the most go first.
+    std::vector<ss::lw_shared_ptr<ntp_archiver>> get_upload_candidates();
+
     /// Run next round of uploads
     ss::future<> run_uploads();
 
@@ -145,21 +155,54 @@ public:
     /// appers in partition_manager or got removed from it.
     ss::future<> reconcile_archivers();
 
+    /// \brief Sync read replicas with the content of the partition_manager
+    ///
+    /// The leaders of the read replica partitions get a read replica, the
+    /// manifests of all read replicas of the shard are polled.
+    ss::future<> reconcile_read_replicas();
+
     /// Return range with all available ntps
     bool contains(const model::ntp& ntp) const { return _queue.contains(ntp); }
 
+    /// \brief Get S3 view of the partition
+    ///
+    /// \return remote partition or nullptr if the ntp is not archived
+    ///         by this shard
+    ss::lw_shared_ptr<cloud_storage::remote_partition>
+    get_remote_partition(const model::ntp& ntp) const;
+
+    /// \brief Restore the log of a new partition from S3
+    ///
+    /// \return true if the log was downloaded into the work directory
+    /// \see cloud_storage::partition_recovery_manager::download_log
+    ss::future<bool> download_log(const storage::ntp_config& ntp_cfg);
+
+    /// \brief Get S3 view of the read replica partition
+    ///
+    /// \return remote partition or nullptr if the ntp is not a read replica
+    ///         led by this shard or its manifest wasn't downloaded yet
+    ss::lw_shared_ptr<cloud_storage::remote_partition>
+    get_read_replica(const model::ntp& ntp) const;
+
 private:
     /// Remove archivers from the workingset
     ss::future<> remove_archivers(std::vector<model::ntp> to_remove);
     ss::future<> create_archivers(std::vector<model::ntp> to_create);
     ss::future<> upload_topic_manifest(
       model::topic_namespace topic_ns, model::revision_id rev);
-    /// Adds archiver to the reconciliation loop after fetching its manifest.
-    ss::future<ss::stop_iteration>
-    add_ntp_archiver(ss::lw_shared_ptr<ntp_archiver> archiver);
+    /// Adds archiver to the reconciliation loop, the manifest is restored
+    /// from the local cache and synced with S3 before the first upload.
+    ss::future<> add_ntp_archiver(ss::lw_shared_ptr<ntp_archiver> archiver);
+    /// \brief Fetch the manifest of the archiver if it's not synced yet
+    ///
+    /// \return true if the archiver can start uploading
+    ss::future<bool> sync_manifest(ss::lw_shared_ptr<ntp_archiver> archiver);
     /// Returns high watermark for the partition
     std::optional<model::offset>
     get_high_watermark(const model::ntp& ntp) const;
+    /// Create segment cache of the shard or nullptr if it's disabled
+    static std::unique_ptr<cloud_storage::cache>
+    make_cache(const configuration& conf);
 
     configuration _conf;
     ss::sharded<cluster::partition_manager>& _partition_manager;
@@ -171,10 +214,18 @@ private:
     ss::abort_source _as;
     ss::semaphore _stop_limit;
     ntp_upload_queue _queue;
+    absl::node_hash_map<
+      model::ntp,
+      ss::lw_shared_ptr<cloud_storage::read_replica>>
+      _read_replicas;
     simple_time_jitter<ss::lowres_clock> _backoff{100ms};
     retry_chain_node _rtcnode;
     service_probe _probe;
     cloud_storage::remote _remote;
+    cloud_storage::partition_recovery_manager _recovery;
+    std::unique_ptr<cloud_storage::cache> _cache;
+    upload_throttle _throttle;
+    upload_throttle _delete_throttle;
     ss::lowres_clock::duration _topic_manifest_upload_timeout;
     ss::lowres_clock::duration _initial_backoff;
 };
@@ -206,6 +257,15 @@ public:
 
     /// Generate configuration
     using internal::scheduler_service_impl::get_archival_service_config;
+
+    /// Get S3 view of the partition
+    using internal::scheduler_service_impl::get_remote_partition;
+
+    /// Restore the log of a new partition
+    using internal::scheduler_service_impl::download_log;
+
+    /// Get S3 view of the read replica partition
+    using internal::scheduler_service_impl::get_read_replica;
 };
 
 } // namespace archival
@@ -17,6 +17,7 @@
 #include "model/metadata.h"
 #include "storage/disk_log_impl.h"
 #include "test_utils/fixture.h"
+#include "units.h"
 #include "utils/retry_chain_node.h"
 #include "utils/unresolved_address.h"
 
@@ -210,7 +211,12 @@ FIXTURE_TEST(test_upload_manifest, s3_imposter_fixture) { // NOLINT
 
 // NOLINTNEXTLINE
 FIXTURE_TEST(test_upload_segments, archiver_fixture) {
-    set_expectations_and_listen(default_expectations);
+    set_expectations_and_listen({
+      s3_imposter_fixture::expectation{
+        .url = manifest_url, .body = std::nullopt},
+      s3_imposter_fixture::expectation{.url = segment1_url, .body = "segment1"},
+      s3_imposter_fixture::expectation{.url = segment2_url, .body = "segment2"},
+    });
     auto conf = get_configuration();
     service_probe probe(service_metrics_disabled::yes);
     cloud_storage::remote remote(
@@ -227,23 +233,41 @@ FIXTURE_TEST(test_upload_segments, archiver_fixture) {
     init_storage_api_local(segments);
 
     retry_chain_node fib;
+    // nothing is uploaded until the manifest is synced with S3
     auto res = archiver
                  .upload_next_candidates(
                    get_local_storage_api().log_mgr(), high_watermark, fib)
                  .get0();
+    BOOST_REQUIRE_EQUAL(res.num_succeded, 0);
+    BOOST_REQUIRE(!archiver.is_manifest_synced());
+
+    auto dl = archiver.download_manifest(fib).get0();
+    BOOST_REQUIRE(dl == cloud_storage::download_result::notfound);
+    BOOST_REQUIRE(archiver.is_manifest_synced());
+
+    res = archiver
+            .upload_next_candidates(
+              get_local_storage_api().log_mgr(), high_watermark, fib)
+            .get0();
     BOOST_REQUIRE_EQUAL(res.num_succeded, 2);
     BOOST_REQUIRE_EQUAL(res.num_failed, 0);
 
     for (auto [url, req] : get_targets()) {
         vlog(test_log.error, "{}", url);
     }
-    BOOST_REQUIRE_EQUAL(get_requests().size(), 3);
-    BOOST_REQUIRE(get_targets().count(manifest_url)); // NOLINT
+    // manifest GET and PUT, two segments
+    BOOST_REQUIRE_EQUAL(get_data_requests().size(), 4);
+    BOOST_REQUIRE_EQUAL(get_targets().count(manifest_url), 2); // NOLINT
     {
-        auto it = get_targets().find(manifest_url);
-        const auto& [url, req] = *it;
-        verify_manifest_content(req.content);
-        BOOST_REQUIRE(req._method == "PUT"); // NOLINT
+        auto [begin, end] = get_targets().equal_range(manifest_url);
+        for (auto it = begin; it != end; it++) {
+            const auto& [url, req] = *it;
+            if (req._method == "PUT") {
+                verify_manifest_content(req.content);
+            } else {
+                BOOST_REQUIRE(req._method == "GET"); // NOLINT
+            }
+        }
     }
     BOOST_REQUIRE(get_targets().count(segment1_url)); // NOLINT
     {
@@ -284,16 +308,19 @@ FIXTURE_TEST(test_archiver_policy, archiver_fixture) {
 
     log_segment_set(lm);
     // Starting offset is lower than offset1
-    auto upload1 = policy.get_next_candidate(
-      model::offset(0), high_watermark, lm);
+    auto upload1
+      = policy.get_next_candidate(model::offset(0), high_watermark, lm).get();
     log_upload_candidate(upload1);
     BOOST_REQUIRE(upload1.source.get() != nullptr);
     BOOST_REQUIRE(upload1.starting_offset == offset1);
 
-    auto upload2 = policy.get_next_candidate(
-      upload1.source->offsets().dirty_offset + model::offset(1),
-      high_watermark,
-      lm);
+    auto upload2 = policy
+                     .get_next_candidate(
+                       upload1.source->offsets().dirty_offset
+                         + model::offset(1),
+                       high_watermark,
+                       lm)
+                     .get();
     log_upload_candidate(upload2);
     BOOST_REQUIRE(upload2.source.get() != nullptr);
     BOOST_REQUIRE(upload2.starting_offset() == offset2);
@@ -301,10 +328,13 @@ FIXTURE_TEST(test_archiver_policy, archiver_fixture) {
     BOOST_REQUIRE(upload2.source != upload1.source);
     BOOST_REQUIRE(upload2.source->offsets().base_offset == offset2);
 
-    auto upload3 = policy.get_next_candidate(
-      upload2.source->offsets().dirty_offset + model::offset(1),
-      high_watermark,
-      lm);
+    auto upload3 = policy
+                     .get_next_candidate(
+                       upload2.source->offsets().dirty_offset
+                         + model::offset(1),
+                       high_watermark,
+                       lm)
+                     .get();
     log_upload_candidate(upload3);
     BOOST_REQUIRE(upload3.source.get() != nullptr);
     BOOST_REQUIRE(upload3.starting_offset() == offset3);
@@ -312,17 +342,96 @@ FIXTURE_TEST(test_archiver_policy, archiver_fixture) {
     BOOST_REQUIRE(upload3.source != upload2.source);
     BOOST_REQUIRE(upload3.source->offsets().base_offset == offset3);
 
-    auto upload4 = policy.get_next_candidate(
-      upload3.source->offsets().dirty_offset + model::offset(1),
-      high_watermark,
-      lm);
+    auto upload4 = policy
+                     .get_next_candidate(
+                       upload3.source->offsets().dirty_offset
+                         + model::offset(1),
+                       high_watermark,
+                       lm)
+                     .get();
     BOOST_REQUIRE(upload4.source.get() == nullptr);
 
-    auto upload5 = policy.get_next_candidate(
-      high_watermark + model::offset(1), high_watermark, lm);
+    auto upload5 = policy
+                     .get_next_candidate(
+                       high_watermark + model::offset(1),
+                       high_watermark,
+                       lm)
+                     .get();
     BOOST_REQUIRE(upload5.source.get() == nullptr);
 }
 
+static ss::sstring read_stream(ss::input_stream<char> is) {
+    ss::sstring result;
+    while (true) {
+        auto buf = is.read().get0();
+        if (buf.empty()) {
+            break;
+        }
+        result.append(buf.get(), buf.size());
+    }
+    is.close().get();
+    return result;
+}
+
+// NOLINTNEXTLINE
+FIXTURE_TEST(test_archiver_policy_coalesce, archiver_fixture) {
+    model::offset high_watermark{9999};
+    std::vector<segment_desc> segments = {
+      {manifest_ntp, model::offset(1000), model::term_id(1)},
+      {manifest_ntp, model::offset(2000), model::term_id(1)},
+      {manifest_ntp, model::offset(3000), model::term_id(2)},
+      {manifest_ntp, model::offset(4000), model::term_id(2)},
+      {manifest_ntp, model::offset(10000), model::term_id(2)},
+    };
+    init_storage_api_local(segments);
+    auto& lm = get_local_storage_api().log_mgr();
+    ntp_level_probe ntp_probe(per_ntp_metrics_disabled::yes, manifest_ntp);
+    service_probe svc_probe(service_metrics_disabled::yes);
+    archival::archival_policy policy(
+      manifest_ntp, svc_probe, ntp_probe, 1_GiB);
+
+    log_segment_set(lm);
+    // The segments of the first term are coalesced
+    auto upload1
+      = policy.get_next_candidate(model::offset(0), high_watermark, lm).get();
+    log_upload_candidate(upload1);
+    BOOST_REQUIRE(upload1.source.get() != nullptr);
+    BOOST_REQUIRE(upload1.starting_offset == model::offset(1000));
+    BOOST_REQUIRE_EQUAL(upload1.coalesced.size(), 1);
+    const auto& last1 = upload1.last_source();
+    BOOST_REQUIRE(last1->offsets().base_offset == model::offset(2000));
+    BOOST_REQUIRE_EQUAL(
+      upload1.content_length,
+      upload1.source->reader().file_size() + last1->reader().file_size());
+
+    // The object is the concatenation of the segments
+    auto object = read_stream(
+      make_upload_stream(upload1, 0, upload1.content_length));
+    auto first = read_stream(upload1.source->reader().data_stream(
+      0, upload1.source->reader().file_size(), ss::default_priority_class()));
+    auto second = read_stream(last1->reader().data_stream(
+      0, last1->reader().file_size(), ss::default_priority_class()));
+    BOOST_REQUIRE(object == first + second);
+    // A range of the object that spans both segments
+    auto range = read_stream(
+      make_upload_stream(upload1, first.size() - 10, 20));
+    BOOST_REQUIRE(range == object.substr(first.size() - 10, 20));
+
+    // The segment above the high watermark is not coalesced
+    auto upload2 = policy
+                     .get_next_candidate(
+                       last1->offsets().dirty_offset + model::offset(1),
+                       high_watermark,
+                       lm)
+                     .get();
+    log_upload_candidate(upload2);
+    BOOST_REQUIRE(upload2.source.get() != nullptr);
+    BOOST_REQUIRE(upload2.starting_offset == model::offset(3000));
+    BOOST_REQUIRE_EQUAL(upload2.coalesced.size(), 1);
+    BOOST_REQUIRE(
+      upload2.last_source()->offsets().base_offset == model::offset(4000));
+}
+
 // NOLINTNEXTLINE
 FIXTURE_TEST(test_upload_segments_leadership_transfer, archiver_fixture) {
     // This test simulates leadership transfer. In this situation the
@@ -388,7 +497,7 @@ FIXTURE_TEST(test_upload_segments_leadership_transfer, archiver_fixture) {
     for (auto req : get_requests()) {
         vlog(test_log.error, "{}", req._url);
     }
-    BOOST_REQUIRE_EQUAL(get_requests().size(), 4);
+    BOOST_REQUIRE_EQUAL(get_data_requests().size(), 4);
     {
         auto [begin, end] = get_targets().equal_range(manifest_url);
         size_t len = std::distance(begin, end);
@@ -458,16 +567,19 @@ FIXTURE_TEST(test_upload_segments_with_overlap, archiver_fixture) {
     log_segment_set(lm);
     model::offset high_watermark{9999};
     // Starting offset is lower than offset1
-    auto upload1 = policy.get_next_candidate(
-      model::offset(0), high_watermark, lm);
+    auto upload1
+      = policy.get_next_candidate(model::offset(0), high_watermark, lm).get();
     log_upload_candidate(upload1);
     BOOST_REQUIRE(upload1.source.get() != nullptr);
     BOOST_REQUIRE(upload1.starting_offset == offset1);
 
-    auto upload2 = policy.get_next_candidate(
-      upload1.source->offsets().dirty_offset + model::offset(1),
-      high_watermark,
-      lm);
+    auto upload2 = policy
+                     .get_next_candidate(
+                       upload1.source->offsets().dirty_offset
+                         + model::offset(1),
+                       high_watermark,
+                       lm)
+                     .get();
     log_upload_candidate(upload2);
     BOOST_REQUIRE(upload2.source.get() != nullptr);
     BOOST_REQUIRE(upload2.starting_offset == offset2);
@@ -475,10 +587,13 @@ FIXTURE_TEST(test_upload_segments_with_overlap, archiver_fixture) {
     BOOST_REQUIRE(upload2.source != upload1.source);
     BOOST_REQUIRE(upload2.source->offsets().base_offset == offset2);
 
-    auto upload3 = policy.get_next_candidate(
-      upload2.source->offsets().dirty_offset + model::offset(1),
-      high_watermark,
-      lm);
+    auto upload3 = policy
+                     .get_next_candidate(
+                       upload2.source->offsets().dirty_offset
+                         + model::offset(1),
+                       high_watermark,
+                       lm)
+                     .get();
     log_upload_candidate(upload3);
     BOOST_REQUIRE(upload3.source.get() != nullptr);
     BOOST_REQUIRE(upload3.starting_offset == offset3);
@@ -486,9 +601,12 @@ FIXTURE_TEST(test_upload_segments_with_overlap, archiver_fixture) {
     BOOST_REQUIRE(upload3.source != upload2.source);
     BOOST_REQUIRE(upload3.source->offsets().base_offset == offset3);
 
-    auto upload4 = policy.get_next_candidate(
-      upload3.source->offsets().dirty_offset + model::offset(1),
-      high_watermark,
-      lm);
+    auto upload4 = policy
+                     .get_next_candidate(
+                       upload3.source->offsets().dirty_offset
+                         + model::offset(1),
+                       high_watermark,
+                       lm)
+                     .get();
     BOOST_REQUIRE(upload4.source.get() == nullptr);
 }
@@ -108,6 +108,19 @@ s3_imposter_fixture::get_requests() const {
     return _requests;
 }
 
+std::vector<ss::httpd::request>
+s3_imposter_fixture::get_data_requests() const {
+    std::vector<ss::httpd::request> res;
+    std::copy_if(
+      _requests.begin(),
+      _requests.end(),
+      std::back_inserter(res),
+      [](const ss::httpd::request& r) {
+          return !boost::ends_with(r._url, ".index");
+      });
+    return res;
+}
+
 const std::multimap<ss::sstring, ss::httpd::request>&
 s3_imposter_fixture::get_targets() const {
     return _targets;
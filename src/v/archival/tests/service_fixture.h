@@ -71,6 +71,10 @@ public:
     /// Access all http requests ordered by time
     const std::vector<ss::httpd::request>& get_requests() const;
 
+    /// Access all http requests ordered by time except the requests that
+    /// target segment indices
+    std::vector<ss::httpd::request> get_data_requests() const;
+
     /// Access all http requests ordered by target url
     const std::multimap<ss::sstring, ss::httpd::request>& get_targets() const;
 
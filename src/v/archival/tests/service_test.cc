@@ -171,9 +171,9 @@ FIXTURE_TEST(test_segment_upload, archiver_fixture) {
     // 2 partition manifests, 1 topic manifest, 2 segments
     const size_t num_requests_expected = 5;
     tests::cooperative_spin_wait_with_timeout(10s, [this] {
-        return get_requests().size() == num_requests_expected;
+        return get_data_requests().size() == num_requests_expected;
     }).get();
-    BOOST_REQUIRE(get_requests().size() == num_requests_expected);
+    BOOST_REQUIRE(get_data_requests().size() == num_requests_expected);
 
     auto manifest_req = get_targets().equal_range(manifest_url);
     BOOST_REQUIRE(manifest_req.first != manifest_req.second);
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "archival/upload_throttle.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+using archival::upload_throttle;
+
+SEASTAR_THREAD_TEST_CASE(test_upload_throttle_disabled) {
+    upload_throttle throttle(0);
+    BOOST_REQUIRE(!throttle.is_enabled());
+    auto now = upload_throttle::clock_t::now();
+    BOOST_REQUIRE(
+      throttle.reserve(1000000, now) == upload_throttle::clock_t::duration{});
+}
+
+SEASTAR_THREAD_TEST_CASE(test_upload_throttle_debt) {
+    upload_throttle throttle(1000);
+    auto now = upload_throttle::clock_t::now();
+    // the bucket starts full
+    BOOST_REQUIRE(
+      throttle.reserve(1000, now) == upload_throttle::clock_t::duration{});
+    // no tokens left, the caller has to wait for 2 seconds
+    auto delay = throttle.reserve(2000, now);
+    BOOST_REQUIRE(delay >= 1900ms && delay <= 2100ms);
+    // the next caller waits until the previous debt is repaid
+    delay = throttle.reserve(1000, now + 1s);
+    BOOST_REQUIRE(delay >= 1900ms && delay <= 2100ms);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_upload_throttle_refill) {
+    upload_throttle throttle(1000);
+    auto now = upload_throttle::clock_t::now();
+    BOOST_REQUIRE(
+      throttle.reserve(1000, now) == upload_throttle::clock_t::duration{});
+    // the bucket is refilled but can't hold more than one second of tokens
+    now += 10s;
+    BOOST_REQUIRE(
+      throttle.reserve(1000, now) == upload_throttle::clock_t::duration{});
+    auto delay = throttle.reserve(500, now);
+    BOOST_REQUIRE(delay >= 400ms && delay <= 600ms);
+}
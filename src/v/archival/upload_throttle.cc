@@ -0,0 +1,58 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "archival/upload_throttle.h"
+
+#include <seastar/core/sleep.hh>
+
+#include <algorithm>
+#include <chrono>
+
+namespace archival {
+
+upload_throttle::upload_throttle(uint64_t bytes_per_second) noexcept
+  : _rate(bytes_per_second)
+  , _tokens(static_cast<double>(bytes_per_second))
+  , _last_refill(clock_t::now()) {}
+
+void upload_throttle::refill(clock_t::time_point now) {
+    if (now <= _last_refill) {
+        return;
+    }
+    std::chrono::duration<double> elapsed = now - _last_refill;
+    _tokens = std::min(
+      _tokens + elapsed.count() * static_cast<double>(_rate),
+      static_cast<double>(_rate));
+    _last_refill = now;
+}
+
+upload_throttle::clock_t::duration
+upload_throttle::reserve(uint64_t bytes, clock_t::time_point now) {
+    if (!is_enabled()) {
+        return clock_t::duration::zero();
+    }
+    refill(now);
+    _tokens -= static_cast<double>(bytes);
+    if (_tokens >= 0) {
+        return clock_t::duration::zero();
+    }
+    std::chrono::duration<double> delay(-_tokens / static_cast<double>(_rate));
+    return std::chrono::duration_cast<clock_t::duration>(delay);
+}
+
+ss::future<> upload_throttle::throttle(uint64_t bytes, ss::abort_source& as) {
+    auto delay = reserve(bytes, clock_t::now());
+    if (delay == clock_t::duration::zero()) {
+        return ss::now();
+    }
+    return ss::sleep_abortable<clock_t>(delay, as);
+}
+
+} // namespace archival
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#pragma once
+
+#include "seastarx.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/lowres_clock.hh>
+
+#include <cstdint>
+
+namespace archival {
+
+/// \brief Shard local limit of the upload bandwidth
+///
+/// Token bucket that is refilled at the configured rate. It's also used to
+/// limit the rate of the deletions, one token per object. The bucket can
+/// hold up to one second worth of tokens. The caller that takes more
+/// tokens than available goes into debt and waits until the debt is
+/// repaid, so concurrent uploads are paced in the order of arrival.
+class upload_throttle {
+public:
+    using clock_t = ss::lowres_clock;
+
+    /// C-tor
+    ///
+    /// \param bytes_per_second is a bandwidth limit, 0 disables the limit
+    explicit upload_throttle(uint64_t bytes_per_second) noexcept;
+
+    /// Take 'bytes' from the bucket
+    ///
+    /// \return the time the caller has to wait before sending the data
+    clock_t::duration reserve(uint64_t bytes, clock_t::time_point now);
+
+    /// Take 'bytes' from the bucket and wait until they can be sent
+    ss::future<> throttle(uint64_t bytes, ss::abort_source& as);
+
+    bool is_enabled() const { return _rate != 0; }
+
+private:
+    void refill(clock_t::time_point now);
+
+    uint64_t _rate;
+    double _tokens;
+    clock_t::time_point _last_refill;
+};
+
+} // namespace archival
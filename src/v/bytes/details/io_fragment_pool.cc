@@ -0,0 +1,162 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/details/io_fragment_pool.h"
+
+#include "bytes/details/io_allocation_size.h"
+
+#include <seastar/core/memory.hh>
+#include <seastar/core/smp.hh>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <optional>
+
+namespace details {
+
+namespace {
+/// index of the size in the alloc_table
+std::optional<size_t> size_class(size_t size) {
+    const auto& table = io_allocation_size::alloc_table;
+    auto it = std::lower_bound(table.begin(), table.end(), size);
+    if (it == table.end() || *it != size) {
+        return std::nullopt;
+    }
+    return std::distance(table.begin(), it);
+}
+
+class pool {
+public:
+    explicit pool(size_t max_bytes)
+      : _max_bytes(max_bytes)
+      , _reclaimer(
+          [this](ss::memory::reclaimer::request r) { return reclaim(r); },
+          ss::memory::reclaimer_scope::sync) {}
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
+    ~pool() { release(_stats.cached_bytes); }
+
+    char* get(size_t cls) {
+        auto& head = _free[cls];
+        if (!head) {
+            ++_stats.misses;
+            return nullptr;
+        }
+        ++_stats.hits;
+        auto* n = head;
+        head = n->next;
+        _stats.cached_bytes -= io_allocation_size::alloc_table[cls];
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<char*>(n);
+    }
+
+    /// \brief keeps the buffer unless the pool is full
+    bool put(char* buf, size_t cls) {
+        const size_t size = io_allocation_size::alloc_table[cls];
+        if (_stats.cached_bytes + size > _max_bytes) {
+            return false;
+        }
+        auto* n = new (buf) node{.next = _free[cls]};
+        _free[cls] = n;
+        _stats.cached_bytes += size;
+        return true;
+    }
+
+    const io_fragment_pool::stats& get_stats() const { return _stats; }
+
+private:
+    // the header of a cached buffer
+    struct node {
+        node* next;
+    };
+
+    /// \brief frees the cached buffers, largest first
+    size_t release(size_t bytes) {
+        size_t released = 0;
+        for (size_t cls = _free.size(); cls-- > 0 && released < bytes;) {
+            const size_t size = io_allocation_size::alloc_table[cls];
+            while (_free[cls] && released < bytes) {
+                auto* n = _free[cls];
+                _free[cls] = n->next;
+                std::free(n); // NOLINT(cppcoreguidelines-no-malloc)
+                _stats.cached_bytes -= size;
+                released += size;
+            }
+        }
+        return released;
+    }
+
+    ss::memory::reclaiming_result reclaim(ss::memory::reclaimer::request r) {
+        using result = ss::memory::reclaiming_result;
+        const size_t released = release(r.bytes_to_reclaim);
+        _stats.reclaimed_bytes += released;
+        return released != 0 ? result::reclaimed_something
+                             : result::reclaimed_nothing;
+    }
+
+    size_t _max_bytes;
+    std::array<node*, io_allocation_size::alloc_table.size()> _free{};
+    io_fragment_pool::stats _stats;
+    ss::memory::reclaimer _reclaimer;
+};
+
+thread_local std::unique_ptr<pool> shard_pool;
+
+/// returns the buffer to the pool of the shard it was allocated on
+void recycle(char* buf, size_t cls, ss::shard_id owner) {
+    if (
+      !shard_pool || ss::this_shard_id() != owner
+      || !shard_pool->put(buf, cls)) {
+        std::free(buf); // NOLINT(cppcoreguidelines-no-malloc)
+    }
+}
+} // namespace
+
+void io_fragment_pool::enable(size_t max_bytes) {
+    shard_pool = std::make_unique<pool>(max_bytes);
+}
+
+void io_fragment_pool::disable() { shard_pool.reset(); }
+
+ss::temporary_buffer<char> io_fragment_pool::allocate(size_t size) {
+    if (!shard_pool) {
+        return ss::temporary_buffer<char>(size);
+    }
+    auto cls = size_class(size);
+    if (!cls) {
+        return ss::temporary_buffer<char>(size);
+    }
+    char* buf = shard_pool->get(*cls);
+    if (!buf) {
+        // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+        buf = static_cast<char*>(std::malloc(size));
+        if (!buf) {
+            throw std::bad_alloc{};
+        }
+    }
+    ss::deleter d;
+    try {
+        d = ss::make_deleter([buf, c = *cls, owner = ss::this_shard_id()] {
+            recycle(buf, c, owner);
+        });
+    } catch (...) {
+        recycle(buf, *cls, ss::this_shard_id());
+        throw;
+    }
+    return ss::temporary_buffer<char>(buf, size, std::move(d));
+}
+
+io_fragment_pool::stats io_fragment_pool::get_stats() {
+    return shard_pool ? shard_pool->get_stats() : stats{};
+}
+
+} // namespace details
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+
+#include <seastar/core/temporary_buffer.hh>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace details {
+
+/**
+ * Per shard cache of the buffers of the iobuf fragments.
+ *
+ * The fragments grow along io_allocation_size::alloc_table, the buffers of
+ * the freed fragments are kept on a free list per size of the table and
+ * handed to the next fragments of the same size instead of going through
+ * the allocator. The free lists are linked through the cached buffers, the
+ * pool doesn't allocate.
+ *
+ * - the pool is disabled until enable() is called on the shard, the
+ *   buffers are then allocated directly
+ * - at most max_bytes of buffers are cached, the others are freed
+ * - the cached buffers are released to the seastar memory reclaimer, before
+ *   the allocations that would otherwise fail
+ * - buffers freed on another shard are freed, not cached
+ */
+class io_fragment_pool {
+public:
+    struct stats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t reclaimed_bytes{0};
+        size_t cached_bytes{0};
+    };
+
+    /// \brief starts caching up to max_bytes of buffers on the shard
+    static void enable(size_t max_bytes);
+    /// \brief frees the cached buffers of the shard and stops caching
+    static void disable();
+
+    /// \brief buffer for a fragment of the size. sizes that aren't in the
+    /// alloc_table bypass the pool
+    static ss::temporary_buffer<char> allocate(size_t size);
+
+    static stats get_stats();
+};
+
+} // namespace details
@@ -20,6 +20,7 @@
 #include <seastar/core/future-util.hh>
 
 #include <algorithm>
+#include <cstring>
 
 /*
  * It is common for an io_iterator_consumer to be initialized with the begin and
@@ -62,6 +63,10 @@ public:
         }
     }
     void skip(size_t n) {
+        if (likely(n < segment_bytes_left())) {
+            advance_in_segment(n);
+            return;
+        }
         size_t c = consume(n, [](const char*, size_t /*max*/) {
             return ss::stop_iteration::no;
         });
@@ -90,6 +95,11 @@ public:
         constexpr size_t sz = sizeof(T);
         T obj;
         char* dst = reinterpret_cast<char*>(&obj); // NOLINT
+        if (likely(sz < segment_bytes_left())) {
+            std::memcpy(dst, _frag_index, sz);
+            advance_in_segment(sz);
+            return obj;
+        }
         consume_to(sz, dst);
         return obj;
     }
@@ -162,9 +172,17 @@ public:
 
         return i;
     }
+    /// \brief the next n bytes, when they are in the current fragment,
+    /// nullptr otherwise
+    const char* peek_contiguous(size_t n) const {
+        return n <= segment_bytes_left() ? _frag_index : nullptr;
+    }
+
     size_t bytes_consumed() const { return _bytes_consumed; }
     // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     size_t segment_bytes_left() const { return _frag_index_end - _frag_index; }
+    /// the segment_bytes_left() bytes of the current fragment
+    const char* segment_data() const { return _frag_index; }
     bool is_finished() const { return _frag == _frag_end; }
 
     /// starts a new iterator byte-for-byte starting at *this* index
@@ -177,6 +195,13 @@ public:
     }
 
 private:
+    /// the fragment keeps bytes past the n, no need to check for its end
+    void advance_in_segment(size_t n) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        _frag_index += n;
+        _bytes_consumed += n;
+    }
+
     io_const_iterator _frag;
     io_const_iterator _frag_end;
     const char* _frag_index = nullptr;
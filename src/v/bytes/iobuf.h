@@ -13,6 +13,7 @@
 #include "bytes/details/io_allocation_size.h"
 #include "bytes/details/io_byte_iterator.h"
 #include "bytes/details/io_fragment.h"
+#include "bytes/details/io_fragment_pool.h"
 #include "bytes/details/io_iterator_consumer.h"
 #include "bytes/details/io_placeholder.h"
 #include "bytes/details/out_of_range.h"
@@ -236,7 +237,8 @@ inline void iobuf::create_new_fragment(size_t sz) {
     oncore_debug_verify(_verify_shard);
     auto chunk_max = std::max(sz, last_allocation_size());
     auto asz = details::io_allocation_size::next_allocation_size(chunk_max);
-    auto f = new fragment(ss::temporary_buffer<char>(asz), fragment::empty{});
+    auto f = new fragment(
+      details::io_fragment_pool::allocate(asz), fragment::empty{});
     append_take_ownership(f);
 }
 inline iobuf::placeholder iobuf::reserve(size_t sz) {
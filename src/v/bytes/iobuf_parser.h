@@ -19,7 +19,9 @@
 
 #include <seastar/core/sstring.hh>
 
+#include <algorithm>
 #include <memory>
+#include <type_traits>
 
 /**
  * iobuf parser interface suitable for an iobuf passed by const-ref. also
@@ -46,6 +48,13 @@ public:
     size_t bytes_consumed() const { return _in.bytes_consumed(); }
 
     std::pair<int64_t, uint8_t> read_varlong() {
+        // decoded in place unless the varint may span fragments
+        if (likely(_in.segment_bytes_left() >= vint::max_length)) {
+            auto [val, length_size] = vint::deserialize(
+              _in.segment_data(), _in.segment_bytes_left());
+            _in.skip(length_size);
+            return {val, length_size};
+        }
         auto [val, length_size] = vint::deserialize(_in);
         _in.skip(length_size);
         return {val, length_size};
@@ -66,6 +75,12 @@ public:
 
     bool read_bool() { return bool(consume_type<int8_t>()); }
 
+    /// \brief copies the next n bytes to the output
+    template<typename Output>
+    void consume_to(size_t n, Output out) {
+        _in.consume_to(n, out);
+    }
+
     template<typename T>
     T consume_type() {
         return _in.consume_type<T>();
@@ -76,8 +91,48 @@ public:
         return _in.consume_be_type<T>();
     }
 
+    /// \brief copies n values of T, in host order, to the output
+    template<typename T>
+    void consume_types(T* out, size_t n) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        _in.consume_to(n * sizeof(T), reinterpret_cast<char*>(out));
+    }
+
+    /// \brief reads n big endian integers, with a single copy
+    template<typename T>
+    void consume_be_types(T* out, size_t n) {
+        static_assert(std::is_integral_v<T>);
+        consume_types(out, n);
+        if constexpr (sizeof(T) > 1) {
+            std::for_each(
+              out, out + n, [](T& v) { v = ss::be_to_cpu(v); }); // NOLINT
+        }
+    }
+
+    /// \brief the next n bytes without copying them, when they are in one
+    /// fragment. nullptr when they span fragments, the caller then falls
+    /// back to a copy
+    const char* peek_contiguous(size_t n) const {
+        return n <= bytes_left() ? _in.peek_contiguous(n) : nullptr;
+    }
+
+    /// \brief like peek_contiguous() and consumes the bytes when they are
+    /// in one fragment. they stay valid as long as the iobuf
+    const char* consume_contiguous(size_t n) {
+        const char* p = peek_contiguous(n);
+        if (p) {
+            _in.skip(n);
+        }
+        return p;
+    }
+
     void skip(size_t n) { _in.skip(n); }
 
+    /// \brief the current position, it can be copied to read the next bytes
+    /// again without consuming them. valid as long as the iobuf
+    const iobuf::iterator_consumer& position() const { return _in; }
+
     // clang-format off
     template<typename Consumer>
     CONCEPT(requires requires(Consumer c, const char* src, size_t max) {
@@ -0,0 +1,44 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/details/io_fragment_pool.h"
+#include "bytes/iobuf.h"
+#include "random/generators.h"
+#include "units.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+/// fills and frees iobufs the way a batch flows through produce and fetch,
+/// the fragments grow to the largest sizes of the alloc_table
+static size_t churn() {
+    static const auto data = random_generators::gen_alphanum_string(1_MiB);
+    size_t total = 0;
+    for (int i = 0; i < 16; ++i) {
+        iobuf buf;
+        buf.append(data.data(), data.size());
+        total += buf.size_bytes();
+        perf_tests::do_not_optimize(buf);
+    }
+    return total;
+}
+
+PERF_TEST(iobuf_fragments, allocator) {
+    details::io_fragment_pool::disable();
+    perf_tests::start_measuring_time();
+    perf_tests::do_not_optimize(churn());
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(iobuf_fragments, pool) {
+    details::io_fragment_pool::enable(4_MiB);
+    perf_tests::start_measuring_time();
+    perf_tests::do_not_optimize(churn());
+    perf_tests::stop_measuring_time();
+    details::io_fragment_pool::disable();
+}
@@ -9,10 +9,13 @@
 
 #include "bytes/bytes.h"
 #include "bytes/details/io_allocation_size.h"
+#include "bytes/details/io_fragment_pool.h"
 #include "bytes/iobuf.h"
 #include "bytes/iobuf_istreambuf.h"
+#include "bytes/iobuf_parser.h"
 #include "bytes/iobuf_ostreambuf.h"
 #include "bytes/tests/utils.h"
+#include "units.h"
 
 #include <seastar/core/temporary_buffer.hh>
 #include <seastar/testing/thread_test_case.hh>
@@ -22,6 +25,10 @@
 #include <boost/test/unit_test.hpp>
 #include <fmt/format.h>
 
+#include <cstring>
+#include <string>
+#include <vector>
+
 SEASTAR_THREAD_TEST_CASE(test_appended_data_is_retained) {
     iobuf buf;
     append_sequence(buf, 5);
@@ -632,3 +639,107 @@ SEASTAR_THREAD_TEST_CASE(iobuf_string_view_cmp) {
         BOOST_REQUIRE_EQUAL(buf, std::string_view(str));
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(fragment_pool_reuses_buffers) {
+    using pool = details::io_fragment_pool;
+    pool::enable(1_MiB);
+    const auto data = random_generators::gen_alphanum_string(512_KiB);
+    {
+        iobuf buf;
+        buf.append(data.data(), data.size());
+        BOOST_REQUIRE_EQUAL(pool::get_stats().hits, 0);
+    }
+    // the freed fragments are cached, up to the limit
+    const auto cached = pool::get_stats().cached_bytes;
+    BOOST_REQUIRE_GT(cached, 0);
+    BOOST_REQUIRE_LE(cached, 1_MiB);
+    {
+        iobuf buf;
+        buf.append(data.data(), data.size());
+        BOOST_REQUIRE_GT(pool::get_stats().hits, 0);
+        BOOST_REQUIRE_EQUAL(buf.size_bytes(), data.size());
+        auto in = iobuf::iterator_consumer(buf.cbegin(), buf.cend());
+        ss::sstring copy(ss::sstring::initialized_later{}, data.size());
+        in.consume_to(copy.size(), copy.data());
+        BOOST_REQUIRE_EQUAL(copy, data);
+    }
+    pool::disable();
+    BOOST_REQUIRE_EQUAL(pool::get_stats().cached_bytes, 0);
+}
+
+namespace {
+/// one fragment per part, prepend doesn't coalesce
+iobuf fragmented(const std::vector<std::string_view>& parts) {
+    iobuf buf;
+    for (auto it = parts.rbegin(); it != parts.rend(); ++it) {
+        buf.prepend(ss::temporary_buffer<char>(it->data(), it->size()));
+    }
+    return buf;
+}
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(iobuf_parser_contiguous) {
+    auto buf = fragmented({"abcd", "efgh"});
+    BOOST_REQUIRE_EQUAL(std::distance(buf.begin(), buf.end()), 2);
+    iobuf_parser p(std::move(buf));
+
+    const char* c = p.peek_contiguous(3);
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(std::string_view(c, 3), "abc");
+    BOOST_REQUIRE_EQUAL(p.bytes_consumed(), 0);
+
+    c = p.consume_contiguous(4);
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(std::string_view(c, 4), "abcd");
+    BOOST_REQUIRE_EQUAL(p.bytes_consumed(), 4);
+
+    // spans the end of the parser
+    BOOST_REQUIRE(!p.consume_contiguous(5));
+    BOOST_REQUIRE_EQUAL(p.bytes_consumed(), 4);
+    c = p.consume_contiguous(4);
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(std::string_view(c, 4), "efgh");
+    BOOST_REQUIRE_EQUAL(p.bytes_left(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(iobuf_parser_contiguous_spanning_fragments) {
+    iobuf_parser p(fragmented({"abcd", "efgh"}));
+    p.skip(2);
+    BOOST_REQUIRE(!p.peek_contiguous(3));
+    BOOST_REQUIRE(!p.consume_contiguous(3));
+    BOOST_REQUIRE_EQUAL(p.bytes_consumed(), 2);
+    BOOST_REQUIRE_EQUAL(p.read_string(3), "cde");
+}
+
+SEASTAR_THREAD_TEST_CASE(iobuf_parser_skip_and_types_across_fragments) {
+    iobuf_parser p(fragmented({"ab", "cdef", "g", "hijklmno"}));
+    // within the fragment, then up to its end and across the next ones
+    p.skip(1);
+    p.skip(1);
+    p.skip(5);
+    BOOST_REQUIRE_EQUAL(p.bytes_consumed(), 7);
+    BOOST_REQUIRE_EQUAL(p.consume_type<char>(), 'h');
+    const auto v = p.consume_type<uint32_t>();
+    BOOST_REQUIRE_EQUAL(std::memcmp(&v, "ijkl", sizeof(v)), 0);
+    BOOST_REQUIRE_EQUAL(p.read_string(3), "mno");
+}
+
+SEASTAR_THREAD_TEST_CASE(iobuf_parser_consume_be_types) {
+    const std::vector<int32_t> in{0, 1, -1, 1 << 20, -(1 << 30)};
+    std::string raw;
+    for (auto v : in) {
+        v = ss::cpu_to_be(v);
+        raw.append(reinterpret_cast<const char*>(&v), sizeof(v)); // NOLINT
+    }
+    // fragments of 3 bytes, the integers straddle them
+    std::vector<std::string_view> parts;
+    for (size_t i = 0; i < raw.size(); i += 3) {
+        parts.push_back(std::string_view(raw).substr(i, 3));
+    }
+    iobuf_parser p(fragmented(parts));
+    std::vector<int32_t> out(in.size());
+    p.consume_be_types(out.data(), out.size());
+    BOOST_REQUIRE_EQUAL(p.bytes_left(), 0);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(
+      out.begin(), out.end(), in.begin(), in.end());
+}
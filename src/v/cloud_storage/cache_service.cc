@@ -0,0 +1,235 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/cache_service.h"
+
+#include "cloud_storage/logger.h"
+#include "utils/directory_walker.h"
+#include "utils/gate_guard.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/future-util.hh>
+#include <seastar/core/seastar.hh>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <exception>
+
+namespace cloud_storage {
+
+static constexpr std::string_view tmp_extension = ".part";
+
+cache::cache(
+  std::filesystem::path dir,
+  uint64_t max_bytes,
+  cache_metrics_disabled disabled)
+  : _dir(std::move(dir))
+  , _max_bytes(max_bytes)
+  , _probe(disabled) {}
+
+ss::future<> cache::start() {
+    co_await ss::recursive_touch_directory(_dir.string());
+    std::vector<ss::sstring> partial;
+    std::vector<ss::sstring> complete;
+    co_await directory_walker::walk(
+      ss::sstring(_dir.string()),
+      [&partial, &complete](ss::directory_entry de) {
+          if (!de.type || *de.type != ss::directory_entry_type::regular) {
+              return ss::now();
+          }
+          if (boost::algorithm::ends_with(de.name, tmp_extension)) {
+              partial.push_back(de.name);
+          } else {
+              complete.push_back(de.name);
+          }
+          return ss::now();
+      });
+    for (const auto& name : partial) {
+        vlog(cst_log.debug, "Removing partially written object {}", name);
+        co_await ss::remove_file((_dir / name.c_str()).string());
+    }
+    for (const auto& name : complete) {
+        auto size = co_await ss::file_size((_dir / name.c_str()).string());
+        track(name, size);
+    }
+    // The budget could be reduced since the last run
+    co_await evict(0);
+    vlog(
+      cst_log.info,
+      "Segment cache started in {}, {} objects, {} bytes, budget {} bytes",
+      _dir,
+      _entries.size(),
+      _current_size,
+      _max_bytes);
+}
+
+ss::future<> cache::stop() { return _gate.close(); }
+
+ss::sstring cache::to_file_name(const std::filesystem::path& key) {
+    // Escape the separators to keep the directory flat, the escaping is
+    // reversible so different keys never map to the same file
+    ss::sstring name;
+    for (auto c : key.string()) {
+        switch (c) {
+        case '%':
+            name.append("%25", 3);
+            break;
+        case '/':
+            name.append("%2F", 3);
+            break;
+        default:
+            name.append(&c, 1);
+        }
+    }
+    return name;
+}
+
+bool cache::contains(const std::filesystem::path& key) const {
+    return _entries.contains(to_file_name(key));
+}
+
+void cache::track(const ss::sstring& name, uint64_t size) {
+    auto [it, _] = _entries.emplace(name, entry{.name = name, .size = size});
+    _lru.push_back(it->second);
+    _current_size += size;
+    _probe.put(size);
+}
+
+ss::future<std::optional<cache::item>>
+cache::get(const std::filesystem::path& key) {
+    gate_guard guard{_gate};
+    auto name = to_file_name(key);
+    auto it = _entries.find(name);
+    if (it == _entries.end()) {
+        _probe.cache_miss();
+        co_return std::nullopt;
+    }
+    auto size = it->second.size;
+    it->second._hook.unlink();
+    _lru.push_back(it->second);
+    std::optional<item> result;
+    try {
+        auto f = co_await ss::open_file_dma(
+          (_dir / name.c_str()).string(), ss::open_flags::ro);
+        result = item{.body = std::move(f), .size = size};
+    } catch (...) {
+        vlog(
+          cst_log.warn,
+          "Can't open cached object {}: {}",
+          name,
+          std::current_exception());
+    }
+    if (!result) {
+        // The file is gone, forget about it
+        if (auto e = _entries.find(name); e != _entries.end()) {
+            _current_size -= e->second.size;
+            _probe.evict(e->second.size);
+            _entries.erase(e);
+        }
+        _probe.cache_miss();
+        co_return std::nullopt;
+    }
+    _probe.cache_hit();
+    co_return result;
+}
+
+ss::future<uint64_t>
+cache::put(const std::filesystem::path& key, ss::input_stream<char>& data) {
+    gate_guard guard{_gate};
+    auto name = to_file_name(key);
+    auto path = (_dir / name.c_str()).string();
+    auto tmp_path = path + std::string(tmp_extension);
+    std::exception_ptr err;
+    try {
+        auto flags = ss::open_flags::wo | ss::open_flags::create
+                     | ss::open_flags::truncate;
+        auto f = co_await ss::open_file_dma(tmp_path, flags);
+        auto out = co_await ss::make_file_output_stream(std::move(f));
+        co_await ss::copy(data, out).finally([&out] { return out.close(); });
+    } catch (...) {
+        err = std::current_exception();
+    }
+    if (err) {
+        vlog(cst_log.debug, "Failed to write cached object {}: {}", name, err);
+        co_await ss::remove_file(tmp_path).handle_exception(
+          [](std::exception_ptr) {});
+        std::rethrow_exception(err);
+    }
+    auto size = co_await ss::file_size(tmp_path);
+    if (auto it = _entries.find(name); it != _entries.end()) {
+        // The object is replaced by the newer version
+        _current_size -= it->second.size;
+        _probe.evict(it->second.size);
+        _entries.erase(it);
+    }
+    co_await evict(size);
+    co_await ss::rename_file(tmp_path, path);
+    track(name, size);
+    vlog(
+      cst_log.debug,
+      "Object {} ({} bytes) added to the cache, cache size {} bytes",
+      name,
+      size,
+      _current_size);
+    co_return size;
+}
+
+ss::future<> cache::evict(uint64_t required) {
+    std::vector<ss::sstring> victims;
+    while (!_lru.empty() && _current_size + required > _max_bytes) {
+        auto& e = _lru.front();
+        victims.push_back(e.name);
+        _current_size -= e.size;
+        _probe.evict(e.size);
+        _entries.erase(victims.back());
+    }
+    for (const auto& name : victims) {
+        if (_entries.contains(name)) {
+            // The object was added back while we were removing other files
+            continue;
+        }
+        vlog(cst_log.debug, "Evicting object {} from the cache", name);
+        try {
+            co_await ss::remove_file((_dir / name.c_str()).string());
+        } catch (...) {
+            vlog(
+              cst_log.warn,
+              "Failed to remove cached object {}: {}",
+              name,
+              std::current_exception());
+        }
+    }
+}
+
+ss::future<> cache::hydrate(const std::filesystem::path& key, hydrate_fn fn) {
+    gate_guard guard{_gate};
+    auto name = to_file_name(key);
+    if (auto it = _hydrations.find(name); it != _hydrations.end()) {
+        _probe.coalesced_hydration();
+        co_await it->second.get_future();
+        co_return;
+    }
+    ss::shared_future<> hydration(ss::futurize_invoke(fn));
+    _hydrations.emplace(name, hydration);
+    std::exception_ptr err;
+    try {
+        co_await hydration.get_future();
+    } catch (...) {
+        err = std::current_exception();
+    }
+    _hydrations.erase(name);
+    if (err) {
+        std::rethrow_exception(err);
+    }
+}
+
+} // namespace cloud_storage
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#pragma once
+
+#include "cloud_storage/probe.h"
+#include "cloud_storage/types.h"
+#include "seastarx.h"
+#include "utils/intrusive_list_helpers.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/node_hash_map.h>
+
+#include <filesystem>
+#include <optional>
+
+namespace cloud_storage {
+
+/// \brief Shard local on-disk cache of the downloaded objects
+///
+/// The cache stores objects in a flat directory, the file name is derived
+/// from the object key (the path of the object in the bucket). The total
+/// size of the cached objects is limited by the budget. When the new object
+/// doesn't fit, the least recently used objects are evicted.
+///
+/// The content of the directory is indexed on start so the objects
+/// downloaded before the restart can be reused. Partially written objects
+/// are removed.
+class cache {
+public:
+    /// Cached object
+    struct item {
+        /// Opened file, should be closed by the caller
+        ss::file body;
+        /// Size of the object
+        uint64_t size;
+    };
+
+    using hydrate_fn = ss::noncopyable_function<ss::future<>()>;
+
+    /// C-tor
+    ///
+    /// \param dir is a cache directory, it shouldn't be shared with other
+    ///        shards
+    /// \param max_bytes is a size budget of the cache
+    /// \param disabled disables metrics
+    cache(
+      std::filesystem::path dir,
+      uint64_t max_bytes,
+      cache_metrics_disabled disabled);
+
+    /// Create the cache directory and index its content
+    ss::future<> start();
+
+    /// Wait until all outstanding operations are completed
+    ss::future<> stop();
+
+    /// \brief Get cached object
+    ///
+    /// The object becomes the most recently used one.
+    /// \return opened file or nullopt if the object is not cached
+    ss::future<std::optional<item>> get(const std::filesystem::path& key);
+
+    /// \brief Add object to the cache
+    ///
+    /// The stream is consumed completely. The data is written to a
+    /// temporary file which is renamed when the write is completed so
+    /// readers never observe partially written objects. Least recently used
+    /// objects are evicted if the budget is exceeded.
+    /// \return size of the object
+    ss::future<uint64_t>
+    put(const std::filesystem::path& key, ss::input_stream<char>& data);
+
+    /// \brief Populate the cache using 'fn'
+    ///
+    /// If the hydration of the same key is already in progress the method
+    /// waits for it instead of invoking 'fn' so concurrent readers of the
+    /// object trigger only one download. The 'fn' is expected to call 'put'.
+    ss::future<> hydrate(const std::filesystem::path& key, hydrate_fn fn);
+
+    /// Return true if the object is in the cache
+    bool contains(const std::filesystem::path& key) const;
+
+    /// Return total size of the cached objects
+    uint64_t size_bytes() const { return _current_size; }
+
+    /// Return size budget of the cache
+    uint64_t max_bytes() const { return _max_bytes; }
+
+    const cache_probe& get_probe() const { return _probe; }
+
+private:
+    struct entry {
+        ss::sstring name;
+        uint64_t size;
+        intrusive_list_hook _hook;
+    };
+
+    /// Convert object key to the file name inside the cache directory
+    static ss::sstring to_file_name(const std::filesystem::path& key);
+
+    /// Add file to the index as the most recently used one
+    void track(const ss::sstring& name, uint64_t size);
+
+    /// Remove least recently used objects to free 'required' bytes
+    ss::future<> evict(uint64_t required);
+
+    std::filesystem::path _dir;
+    uint64_t _max_bytes;
+    uint64_t _current_size{0};
+    absl::node_hash_map<ss::sstring, entry> _entries;
+    /// Objects ordered from least recently used to most recently used
+    intrusive_list<entry, &entry::_hook> _lru;
+    absl::flat_hash_map<ss::sstring, ss::shared_future<>> _hydrations;
+    ss::gate _gate;
+    cache_probe _probe;
+};
+
+} // namespace cloud_storage
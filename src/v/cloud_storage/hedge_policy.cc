@@ -0,0 +1,74 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/hedge_policy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cloud_storage {
+
+/// The percentile is recomputed after this number of new samples
+static constexpr size_t update_interval = 16;
+/// The budget counters are halved when the number of requests reaches this
+/// value, so the budget follows the recent request rate
+static constexpr double budget_window = 10000;
+
+hedge_policy::hedge_policy(hedged_download_config conf)
+  : _conf(conf) {}
+
+std::optional<hedge_policy::duration> hedge_policy::hedge_delay() const {
+    if (_conf.budget_percent <= 0) {
+        return std::nullopt;
+    }
+    return _delay;
+}
+
+void hedge_policy::register_request() {
+    _requests += 1;
+    if (_requests >= budget_window) {
+        _requests /= 2;
+        _hedges /= 2;
+    }
+}
+
+bool hedge_policy::try_hedge() {
+    if (_hedges + 1 > _requests * _conf.budget_percent / 100.0) {
+        return false;
+    }
+    _hedges += 1;
+    return true;
+}
+
+void hedge_policy::record_latency(duration d) {
+    _samples[_next_sample] = d;
+    _next_sample = (_next_sample + 1) % max_samples;
+    _num_samples = std::min(_num_samples + 1, max_samples);
+    if (++_samples_since_update >= update_interval) {
+        update_delay();
+    }
+}
+
+void hedge_policy::update_delay() {
+    _samples_since_update = 0;
+    if (_num_samples < min_samples) {
+        return;
+    }
+    std::vector<duration> sorted(
+      _samples.begin(), _samples.begin() + _num_samples);
+    auto ix = static_cast<size_t>(
+      std::ceil(_conf.percentile * static_cast<double>(_num_samples)));
+    ix = std::clamp<size_t>(ix, 1, _num_samples) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + ix, sorted.end());
+    _delay = std::max(sorted[ix], _conf.min_delay);
+}
+
+} // namespace cloud_storage
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#pragma once
+
+#include "cloud_storage/types.h"
+
+#include <array>
+#include <chrono>
+#include <optional>
+
+namespace cloud_storage {
+
+/// \brief Decides when a download is hedged with a duplicate request
+///
+/// The policy tracks the time to first byte of the recent downloads. A
+/// download that doesn't receive the response within the configured
+/// percentile of that time is duplicated, the first response wins. The
+/// number of duplicates is capped by a budget that is a percentage of the
+/// number of downloads, so the cost of the hedging stays bounded when the
+/// whole endpoint slows down. The policy is shard local.
+class hedge_policy {
+public:
+    using duration = std::chrono::milliseconds;
+
+    /// Number of the latency samples the percentile is computed from
+    static constexpr size_t max_samples = 256;
+    /// Min number of samples required to hedge the downloads
+    static constexpr size_t min_samples = 32;
+
+    explicit hedge_policy(hedged_download_config conf = {});
+
+    /// Return the time after which the download should be hedged or
+    /// nullopt if the downloads are not hedged (disabled or not enough
+    /// samples yet)
+    std::optional<duration> hedge_delay() const;
+
+    /// Register the download, it increases the budget of the duplicates
+    void register_request();
+
+    /// Take a duplicate request from the budget, return false if the
+    /// budget is exhausted
+    bool try_hedge();
+
+    /// Register the time to first byte of the download
+    void record_latency(duration d);
+
+private:
+    void update_delay();
+
+    hedged_download_config _conf;
+    std::array<duration, max_samples> _samples{};
+    size_t _num_samples{0};
+    size_t _next_sample{0};
+    size_t _samples_since_update{0};
+    std::optional<duration> _delay;
+    double _requests{0};
+    double _hedges{0};
+};
+
+} // namespace cloud_storage
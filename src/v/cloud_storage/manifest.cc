@@ -12,12 +12,15 @@
 
 #include "bytes/iobuf.h"
 #include "bytes/iobuf_istreambuf.h"
+#include "bytes/iobuf_parser.h"
 #include "bytes/iobuf_ostreambuf.h"
 #include "cluster/types.h"
 #include "hashing/xx.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
 #include "model/timestamp.h"
+#include "serde/envelope.h"
+#include "serde/serde.h"
 #include "ssx/sformat.h"
 #include "storage/ntp_config.h"
 
@@ -76,13 +79,46 @@ remote_manifest_path manifest::get_manifest_path() const {
     return generate_partition_manifest_path(_ntp, _rev);
 }
 
+remote_manifest_path manifest::get_binary_manifest_path() const {
+    auto path = generate_partition_manifest_path(_ntp, _rev);
+    return remote_manifest_path(path().parent_path() / "manifest.bin");
+}
+
+remote_manifest_path
+manifest::get_spillover_manifest_path(const spillover_meta& meta) const {
+    auto path = generate_partition_manifest_path(_ntp, _rev);
+    return remote_manifest_path(
+      path().parent_path()
+      / fmt::format(
+        "manifest.{}.{}.bin", meta.base_offset(), meta.committed_offset()));
+}
+
 remote_segment_path
 manifest::get_remote_segment_path(const segment_name& name) const {
+    if (auto it = _segments.find(name); it != _segments.end()) {
+        return get_remote_segment_path(name, it->second);
+    }
+    auto path = ssx::sformat("{}_{}/{}", _ntp.path(), _rev(), name());
+    uint32_t hash = xxhash_32(path.data(), path.size());
+    return remote_segment_path(fmt::format("{:08x}/{}", hash, path));
+}
+
+remote_segment_path manifest::get_remote_segment_path(
+  const segment_name& name, const segment_meta& meta) const {
     auto path = ssx::sformat("{}_{}/{}", _ntp.path(), _rev(), name());
+    if (meta.is_compacted) {
+        path = ssx::sformat("{}.{}", path, meta.committed_offset());
+    }
     uint32_t hash = xxhash_32(path.data(), path.size());
     return remote_segment_path(fmt::format("{:08x}/{}", hash, path));
 }
 
+remote_segment_path
+manifest::get_remote_segment_index_path(const segment_name& name) const {
+    auto path = get_remote_segment_path(name);
+    return remote_segment_path(path().string() + ".index");
+}
+
 const model::ntp& manifest::get_ntp() const { return _ntp; }
 
 const model::offset manifest::get_last_offset() const { return _last_offset; }
@@ -175,6 +211,17 @@ void manifest::update(const rapidjson::Document& m) {
               .base_offset = model::offset(boffs),
               .committed_offset = model::offset(coffs),
             };
+            if (it->value.HasMember("base_timestamp")) {
+                meta.base_timestamp = model::timestamp(
+                  it->value["base_timestamp"].GetInt64());
+            }
+            if (it->value.HasMember("max_timestamp")) {
+                meta.max_timestamp = model::timestamp(
+                  it->value["max_timestamp"].GetInt64());
+            }
+            if (it->value.HasMember("has_index")) {
+                meta.has_index = it->value["has_index"].GetBool();
+            }
             tmp.insert(std::make_pair(name, meta));
         }
     }
@@ -223,6 +270,18 @@ void manifest::serialize(std::ostream& out) const {
             w.Int64(meta.committed_offset());
             w.Key("base_offset");
             w.Int64(meta.base_offset());
+            if (meta.base_timestamp != model::timestamp::missing()) {
+                w.Key("base_timestamp");
+                w.Int64(meta.base_timestamp());
+            }
+            if (meta.max_timestamp != model::timestamp::missing()) {
+                w.Key("max_timestamp");
+                w.Int64(meta.max_timestamp());
+            }
+            if (meta.has_index) {
+                w.Key("has_index");
+                w.Bool(meta.has_index);
+            }
             w.EndObject();
         }
         w.EndObject();
@@ -233,12 +292,270 @@ void manifest::serialize(std::ostream& out) const {
 bool manifest::delete_permanently(const segment_name& name) {
     auto it = _segments.find(name);
     if (it != _segments.end()) {
+        // The spillover manifest can't be changed, the remaining segments
+        // of the range are moved back to the binary manifest
+        auto sp = std::find_if(
+          _spillover.begin(),
+          _spillover.end(),
+          [&it](const spillover_meta& m) {
+              return it->second.base_offset >= m.base_offset
+                     && it->second.base_offset <= m.committed_offset;
+          });
+        if (sp != _spillover.end()) {
+            _spillover.erase(sp);
+        }
         _segments.erase(it);
         return true;
     }
     return false;
 }
 
+std::vector<segment_name> manifest::get_expired_segments(
+  std::optional<size_t> max_bytes,
+  std::optional<model::timestamp> eviction_time,
+  size_t max_segments) const {
+    std::vector<const segment_map::value_type*> sorted;
+    sorted.reserve(_segments.size());
+    size_t total_size = 0;
+    for (const auto& s : _segments) {
+        sorted.push_back(&s);
+        total_size += s.second.size_bytes;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto* l, const auto* r) {
+        return l->second.base_offset < r->second.base_offset;
+    });
+    std::vector<segment_name> result;
+    for (size_t i = 0; i + 1 < sorted.size(); i++) {
+        if (result.size() >= max_segments) {
+            break;
+        }
+        const auto& [name, meta] = *sorted[i];
+        // same as local retention, the segment is removed if the rest of
+        // the log is still above the limit
+        bool size_expired = max_bytes
+                            && total_size - meta.size_bytes >= *max_bytes;
+        bool time_expired = eviction_time
+                            && meta.max_timestamp != model::timestamp::missing()
+                            && meta.max_timestamp <= *eviction_time;
+        if (!size_expired && !time_expired) {
+            break;
+        }
+        total_size -= meta.size_bytes;
+        result.push_back(name);
+    }
+    return result;
+}
+
+namespace {
+
+/// Binary representation of the segment_meta
+struct segment_meta_serde
+  : serde::envelope<segment_meta_serde, serde::version<0>> {
+    segment_name name;
+    bool is_compacted;
+    uint64_t size_bytes;
+    model::offset base_offset;
+    model::offset committed_offset;
+    int64_t base_timestamp;
+    int64_t max_timestamp;
+    bool has_index;
+};
+
+struct spillover_meta_serde
+  : serde::envelope<spillover_meta_serde, serde::version<0>> {
+    model::offset base_offset;
+    model::offset committed_offset;
+    uint64_t num_segments;
+};
+
+/// Binary representation of the manifest, also used by spillover
+/// manifests (the 'spillover' list is empty in this case)
+struct manifest_serde : serde::envelope<manifest_serde, serde::version<0>> {
+    model::ns ns;
+    model::topic topic;
+    model::partition_id partition;
+    model::revision_id revision;
+    model::offset last_offset;
+    std::vector<spillover_meta_serde> spillover;
+    std::vector<segment_meta_serde> segments;
+};
+
+segment_meta_serde
+to_serde(const segment_name& name, const manifest::segment_meta& meta) {
+    segment_meta_serde s;
+    s.name = name;
+    s.is_compacted = meta.is_compacted;
+    s.size_bytes = meta.size_bytes;
+    s.base_offset = meta.base_offset;
+    s.committed_offset = meta.committed_offset;
+    s.base_timestamp = meta.base_timestamp.value();
+    s.max_timestamp = meta.max_timestamp.value();
+    s.has_index = meta.has_index;
+    return s;
+}
+
+manifest_serde make_manifest_serde(
+  const model::ntp& ntp, model::revision_id rev, model::offset last_offset) {
+    manifest_serde m;
+    m.ns = ntp.ns;
+    m.topic = ntp.tp.topic;
+    m.partition = ntp.tp.partition;
+    m.revision = rev;
+    m.last_offset = last_offset;
+    return m;
+}
+
+manifest::segment_meta from_serde(const segment_meta_serde& s) {
+    return {
+      .is_compacted = s.is_compacted,
+      .size_bytes = s.size_bytes,
+      .base_offset = s.base_offset,
+      .committed_offset = s.committed_offset,
+      .base_timestamp = model::timestamp(s.base_timestamp),
+      .max_timestamp = model::timestamp(s.max_timestamp),
+      .has_index = s.has_index,
+    };
+}
+
+} // namespace
+
+const manifest::spillover_meta*
+manifest::find_spillover(model::offset o) const {
+    auto it = std::upper_bound(
+      _spillover.begin(),
+      _spillover.end(),
+      o,
+      [](model::offset v, const spillover_meta& m) {
+          return v < m.base_offset;
+      });
+    if (it == _spillover.begin()) {
+        return nullptr;
+    }
+    --it;
+    return o <= it->committed_offset ? &*it : nullptr;
+}
+
+iobuf manifest::serialize_binary() const {
+    auto m = make_manifest_serde(_ntp, _rev, _last_offset);
+    for (const auto& sp : _spillover) {
+        spillover_meta_serde s;
+        s.base_offset = sp.base_offset;
+        s.committed_offset = sp.committed_offset;
+        s.num_segments = sp.num_segments;
+        m.spillover.push_back(s);
+    }
+    for (const auto& [name, meta] : _segments) {
+        if (find_spillover(meta.base_offset) == nullptr) {
+            m.segments.push_back(to_serde(name, meta));
+        }
+    }
+    iobuf buf;
+    serde::write(buf, std::move(m));
+    return buf;
+}
+
+void manifest::update_binary(iobuf buf) {
+    iobuf_parser parser(std::move(buf));
+    auto m = serde::read<manifest_serde>(parser);
+    _ntp = model::ntp(m.ns, m.topic, m.partition);
+    _rev = m.revision;
+    _last_offset = m.last_offset;
+    _segments.clear();
+    _spillover.clear();
+    for (const auto& sp : m.spillover) {
+        _spillover.push_back(spillover_meta{
+          .base_offset = sp.base_offset,
+          .committed_offset = sp.committed_offset,
+          .num_segments = sp.num_segments});
+    }
+    for (const auto& s : m.segments) {
+        _segments.insert(std::make_pair(s.name, from_serde(s)));
+    }
+}
+
+iobuf manifest::serialize_spillover(const spillover_meta& meta) const {
+    auto m = make_manifest_serde(_ntp, _rev, meta.committed_offset);
+    for (const auto& [name, s] : _segments) {
+        if (
+          s.base_offset >= meta.base_offset
+          && s.base_offset <= meta.committed_offset) {
+            m.segments.push_back(to_serde(name, s));
+        }
+    }
+    iobuf buf;
+    serde::write(buf, std::move(m));
+    return buf;
+}
+
+void manifest::update_spillover(iobuf buf) {
+    iobuf_parser parser(std::move(buf));
+    auto m = serde::read<manifest_serde>(parser);
+    for (const auto& s : m.segments) {
+        _segments.insert(std::make_pair(s.name, from_serde(s)));
+    }
+}
+
+std::optional<manifest::spillover_meta>
+manifest::get_spillover_candidate(size_t max_segments) const {
+    size_t num_spilled = 0;
+    for (const auto& sp : _spillover) {
+        num_spilled += sp.num_segments;
+    }
+    if (max_segments == 0 || _segments.size() - num_spilled <= max_segments) {
+        return std::nullopt;
+    }
+    std::vector<const segment_meta*> head;
+    for (const auto& [_, meta] : _segments) {
+        if (find_spillover(meta.base_offset) == nullptr) {
+            head.push_back(&meta);
+        }
+    }
+    if (head.size() <= max_segments) {
+        return std::nullopt;
+    }
+    std::sort(head.begin(), head.end(), [](const auto* lhs, const auto* rhs) {
+        return lhs->base_offset < rhs->base_offset;
+    });
+    // Move the oldest segments to the spillover leaving half of the budget
+    // for the new uploads. The range can't overlap with existing ranges.
+    auto count = head.size() - max_segments / 2;
+    auto next = std::upper_bound(
+      _spillover.begin(),
+      _spillover.end(),
+      head.front()->base_offset,
+      [](model::offset v, const spillover_meta& m) {
+          return v < m.base_offset;
+      });
+    spillover_meta result{
+      .base_offset = head.front()->base_offset,
+      .committed_offset = head.front()->committed_offset,
+      .num_segments = 0};
+    for (size_t i = 0; i < count; i++) {
+        if (
+          next != _spillover.end()
+          && head[i]->committed_offset >= next->base_offset) {
+            break;
+        }
+        result.committed_offset = head[i]->committed_offset;
+        result.num_segments++;
+    }
+    if (result.num_segments == 0) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+void manifest::add_spillover(const spillover_meta& meta) {
+    auto it = std::upper_bound(
+      _spillover.begin(),
+      _spillover.end(),
+      meta.base_offset,
+      [](model::offset v, const spillover_meta& m) {
+          return v < m.base_offset;
+      });
+    _spillover.insert(it, meta);
+}
+
 topic_manifest::topic_manifest(
   const cluster::topic_configuration& cfg, model::revision_id rev)
   : _topic_config(cfg)
@@ -16,6 +16,7 @@
 #include "json/json.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
+#include "model/timestamp.h"
 #include "s3/client.h"
 #include "seastarx.h"
 #include "tristate.h"
@@ -27,6 +28,7 @@
 
 #include <compare>
 #include <iterator>
+#include <optional>
 
 namespace cloud_storage {
 
@@ -70,9 +72,23 @@ public:
         size_t size_bytes;
         model::offset base_offset;
         model::offset committed_offset;
+        /// Timestamp of the first batch (missing if unknown)
+        model::timestamp base_timestamp{};
+        /// Max timestamp of the segment (missing if unknown)
+        model::timestamp max_timestamp{};
+        /// True if the segment index was uploaded next to the segment
+        bool has_index{false};
 
         auto operator<=>(const segment_meta&) const = default;
     };
+    /// Range of segments moved to the immutable spillover manifest
+    struct spillover_meta {
+        model::offset base_offset;
+        model::offset committed_offset;
+        size_t num_segments;
+
+        auto operator<=>(const spillover_meta&) const = default;
+    };
     using key = segment_name;
     using value = segment_meta;
     using segment_map = absl::btree_map<key, value>;
@@ -87,9 +103,29 @@ public:
     /// Manifest object name in S3
     remote_manifest_path get_manifest_path() const override;
 
+    /// Binary manifest object name in S3
+    remote_manifest_path get_binary_manifest_path() const;
+
+    /// Spillover manifest object name in S3
+    remote_manifest_path
+    get_spillover_manifest_path(const spillover_meta& meta) const;
+
     /// Segment file name in S3
     remote_segment_path get_remote_segment_path(const segment_name& name) const;
 
+    /// \brief Segment file name in S3
+    ///
+    /// The compacted replacement of the uploaded segments has the same name
+    /// as the first replaced segment, the committed offset is added to the
+    /// path so the replaced object is not overwritten while it's read.
+    remote_segment_path get_remote_segment_path(
+      const segment_name& name, const segment_meta& meta) const;
+
+    /// Get path of the segment index in S3, the index is stored next to
+    /// the segment
+    remote_segment_path
+    get_remote_segment_index_path(const segment_name& name) const;
+
     /// Get NTP
     const model::ntp& get_ntp() const;
 
@@ -136,6 +172,43 @@ public:
     /// \param out output stream that should be used to output the json
     void serialize(std::ostream& out) const;
 
+    /// \brief Serialize the manifest using compact binary format
+    ///
+    /// Segments that were moved to the spillover manifests are not
+    /// serialized, the result contains only the references to the
+    /// spillover manifests. The size of the result is proportional to the
+    /// number of segments uploaded since the last spillover.
+    iobuf serialize_binary() const;
+
+    /// \brief Update manifest from the binary representation
+    ///
+    /// The content of the manifest is replaced. The segments of the
+    /// spillover manifests are not available until 'update_spillover' is
+    /// called for every element of 'get_spillover'.
+    void update_binary(iobuf buf);
+
+    /// Serialize segments that belong to the spillover range
+    iobuf serialize_spillover(const spillover_meta& meta) const;
+
+    /// Add segments from the serialized spillover manifest
+    void update_spillover(iobuf buf);
+
+    /// \brief Find the range of segments that can be moved to spillover
+    ///
+    /// \param max_segments is a max number of segments that the binary
+    ///        manifest is allowed to contain
+    /// \return range of oldest segments or nullopt if the manifest is small
+    std::optional<spillover_meta>
+    get_spillover_candidate(size_t max_segments) const;
+
+    /// Register spillover manifest after it was uploaded
+    void add_spillover(const spillover_meta& meta);
+
+    /// Get all spillover manifests ordered by offset
+    const std::vector<spillover_meta>& get_spillover() const {
+        return _spillover;
+    }
+
     /// Compare two manifests for equality
     bool operator==(const manifest& other) const = default;
 
@@ -145,6 +218,20 @@ public:
     /// \return true on success, false on failure (no such segment)
     bool delete_permanently(const segment_name& name);
 
+    /// \brief Find the oldest segments that violate the retention limits
+    ///
+    /// The newest segment is never returned, it keeps track of the last
+    /// uploaded offset.
+    /// \param max_bytes is a max total size of the segments
+    /// \param eviction_time is a timestamp, the segments with the data
+    ///        older than that are expired
+    /// \param max_segments is a max number of returned segments
+    /// \return names of the expired segments ordered by offset
+    std::vector<segment_name> get_expired_segments(
+      std::optional<size_t> max_bytes,
+      std::optional<model::timestamp> eviction_time,
+      size_t max_segments) const;
+
     manifest_type get_manifest_type() const override {
         return manifest_type::partition;
     };
@@ -154,10 +241,14 @@ private:
     /// from manifest.json file
     void update(const rapidjson::Document& m);
 
+    /// Return spillover range that contains the offset or nullptr
+    const spillover_meta* find_spillover(model::offset o) const;
+
     model::ntp _ntp;
     model::revision_id _rev;
     segment_map _segments;
     model::offset _last_offset;
+    std::vector<spillover_meta> _spillover;
 };
 
 class topic_manifest final : public base_manifest {
@@ -188,6 +279,9 @@ public:
     /// Return all possible manifest locations
     std::vector<remote_manifest_path> get_partition_manifests() const;
 
+    /// Revision of the topic that uploaded the partitions
+    model::revision_id get_revision_id() const { return _rev; }
+
     manifest_type get_manifest_type() const override {
         return manifest_type::partition;
     };
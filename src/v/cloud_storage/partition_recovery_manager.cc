@@ -0,0 +1,251 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/partition_recovery_manager.h"
+
+#include "cloud_storage/logger.h"
+#include "cluster/types.h"
+#include "utils/directory_walker.h"
+#include "utils/gate_guard.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/file.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/seastar.hh>
+
+#include <algorithm>
+#include <exception>
+
+namespace cloud_storage {
+
+/// The partition is restored into '<work-dir>.restore' first, a download
+/// that was interrupted never leaves a partial log in the work directory
+static constexpr std::string_view staging_extension = ".restore";
+
+partition_recovery_manager::partition_recovery_manager(
+  remote& api,
+  s3::bucket_name bucket,
+  s3_connection_limit limit,
+  ss::lowres_clock::duration timeout,
+  ss::lowres_clock::duration backoff)
+  : _remote(api)
+  , _bucket(std::move(bucket))
+  , _timeout(timeout)
+  , _backoff(backoff)
+  , _download_limit(std::max<size_t>(limit(), 1))
+  , _rtcnode(_as) {}
+
+ss::future<> partition_recovery_manager::stop() {
+    _as.request_abort();
+    _download_limit.broken();
+    return _gate.close();
+}
+
+std::vector<partition_recovery_manager::segment>
+partition_recovery_manager::select_segments(const manifest& m) {
+    std::vector<segment> all(m.begin(), m.end());
+    std::sort(all.begin(), all.end(), [](const segment& a, const segment& b) {
+        return a.second.base_offset < b.second.base_offset;
+    });
+    std::vector<segment> result;
+    for (auto& s : all) {
+        if (!result.empty()) {
+            auto last = result.back().second.committed_offset;
+            if (s.second.base_offset <= last) {
+                continue;
+            }
+            if (s.second.base_offset > last + model::offset(1)) {
+                // The offsets between the segments were never uploaded or
+                // were removed
+                result.clear();
+            }
+        }
+        result.push_back(std::move(s));
+    }
+    return result;
+}
+
+ss::future<std::optional<model::revision_id>>
+partition_recovery_manager::find_revision(
+  const model::ntp& ntp, retry_chain_node& parent) {
+    // The path of the topic manifest depends only on the topic name
+    topic_manifest tm(
+      cluster::topic_configuration(ntp.ns, ntp.tp.topic, 0, 0),
+      model::revision_id(0));
+    auto res = co_await _remote.download_manifest(_bucket, tm, parent);
+    if (res == download_result::notfound) {
+        co_return std::nullopt;
+    }
+    if (res != download_result::success) {
+        throw std::runtime_error(fmt::format(
+          "failed to download the topic manifest of {}, result {}",
+          ntp,
+          static_cast<int32_t>(res)));
+    }
+    co_return tm.get_revision_id();
+}
+
+ss::future<download_result> partition_recovery_manager::download_manifest(
+  manifest& m, retry_chain_node& parent) {
+    auto res = co_await _remote.download_binary_manifest(_bucket, m, parent);
+    if (res != download_result::notfound) {
+        co_return res;
+    }
+    // The partition could be archived before the binary format was
+    // enabled, fall back to json
+    co_return co_await _remote.download_manifest(_bucket, m, parent);
+}
+
+/// Consumer that writes the downloaded object to the file, it truncates
+/// the file when the download is retried
+static remote::try_consume_stream
+write_to_file(const std::filesystem::path& path) {
+    return [path](ss::input_stream<char> is) -> ss::future<uint64_t> {
+        auto flags = ss::open_flags::wo | ss::open_flags::create
+                     | ss::open_flags::truncate;
+        auto f = co_await ss::open_file_dma(path.string(), flags);
+        auto out = co_await ss::make_file_output_stream(f);
+        co_await ss::copy(is, out).finally([&out] { return out.close(); });
+        // the stream closes the file, it's reopened to flush the content
+        auto rf = co_await ss::open_file_dma(path.string(), ss::open_flags::ro);
+        co_await rf.flush().finally([&rf] { return rf.close(); });
+        co_return co_await ss::file_size(path.string());
+    };
+}
+
+ss::future<> partition_recovery_manager::download_segment(
+  const manifest& m,
+  const segment& s,
+  const std::filesystem::path& dir,
+  retry_chain_node& parent) {
+    auto units = co_await ss::get_units(_download_limit, 1);
+    retry_chain_node fib(_timeout, _backoff, &parent);
+    const auto& [name, meta] = s;
+    // The segments are uploaded with the name of the local file
+    auto path = dir / name().c_str();
+    vlog(
+      cst_log.debug,
+      "{} Restoring segment {} of {}, offsets {}-{}, size {}",
+      fib(),
+      name,
+      m.get_ntp(),
+      meta.base_offset,
+      meta.committed_offset,
+      meta.size_bytes);
+    auto res = co_await _remote.download_segment(
+      _bucket, name, m, write_to_file(path), fib);
+    if (res != download_result::success) {
+        throw std::runtime_error(fmt::format(
+          "failed to download segment {} of {}, result {}",
+          name,
+          m.get_ntp(),
+          static_cast<int32_t>(res)));
+    }
+    if (!meta.has_index) {
+        // The index is rebuilt when the segment is opened
+        co_return;
+    }
+    auto index_path = path;
+    index_path.replace_extension("base_index");
+    res = co_await _remote.download_segment_index(
+      _bucket, name, m, write_to_file(index_path), fib);
+    if (res != download_result::success) {
+        vlog(
+          cst_log.info,
+          "{} Index of the segment {} of {} is not available, it will be "
+          "rebuilt",
+          fib(),
+          name,
+          m.get_ntp());
+        co_await ss::remove_file(index_path.string())
+          .handle_exception([](std::exception_ptr) {});
+    }
+}
+
+/// Remove the directory left by a restore that was interrupted, it only
+/// contains files
+static ss::future<> remove_staging_directory(const std::filesystem::path& dir) {
+    if (!co_await ss::file_exists(dir.string())) {
+        co_return;
+    }
+    co_await directory_walker::walk(
+      dir.string(), [&dir](ss::directory_entry de) {
+          return ss::remove_file((dir / de.name.c_str()).string());
+      });
+    co_await ss::remove_file(dir.string());
+}
+
+ss::future<bool>
+partition_recovery_manager::download_log(const storage::ntp_config& ntp_cfg) {
+    gate_guard guard{_gate};
+    const auto& ntp = ntp_cfg.ntp();
+    std::filesystem::path work_dir(ntp_cfg.work_directory());
+    if (co_await ss::file_exists(work_dir.string())) {
+        co_return false;
+    }
+    retry_chain_node fib(_timeout, _backoff, &_rtcnode);
+    auto rev = co_await find_revision(ntp, fib);
+    if (!rev) {
+        vlog(cst_log.info, "{} Topic of {} is not archived", fib(), ntp);
+        co_return false;
+    }
+    manifest m(ntp, *rev);
+    auto res = co_await download_manifest(m, fib);
+    if (res == download_result::notfound) {
+        vlog(cst_log.info, "{} Partition {} is not archived", fib(), ntp);
+        co_return false;
+    }
+    if (res != download_result::success) {
+        throw std::runtime_error(fmt::format(
+          "failed to download the manifest of {}, result {}",
+          ntp,
+          static_cast<int32_t>(res)));
+    }
+    auto segments = select_segments(m);
+    if (segments.empty()) {
+        co_return false;
+    }
+
+    auto staging = work_dir;
+    staging += staging_extension;
+    co_await remove_staging_directory(staging);
+    co_await ss::recursive_touch_directory(staging.string());
+    vlog(
+      cst_log.info,
+      "{} Restoring {} segments of {} from revision {}, offsets {}-{}",
+      fib(),
+      segments.size(),
+      ntp,
+      *rev,
+      segments.front().second.base_offset,
+      segments.back().second.committed_offset);
+
+    // The segments are downloaded by different connections of the pool, a
+    // failed download fails the whole restore
+    co_await ss::parallel_for_each(
+      segments, [this, &m, &staging](const segment& s) {
+          return download_segment(m, s, staging, _rtcnode);
+      });
+
+    co_await ss::sync_directory(staging.string());
+    co_await ss::rename_file(staging.string(), work_dir.string());
+    co_await ss::sync_directory(work_dir.parent_path().string());
+    vlog(
+      cst_log.info,
+      "{} Restored {} up to offset {}",
+      fib(),
+      ntp,
+      segments.back().second.committed_offset);
+    co_return true;
+}
+
+} // namespace cloud_storage
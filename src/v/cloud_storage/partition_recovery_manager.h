@@ -0,0 +1,108 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#pragma once
+
+#include "cloud_storage/manifest.h"
+#include "cloud_storage/remote.h"
+#include "cloud_storage/types.h"
+#include "model/fundamental.h"
+#include "s3/client.h"
+#include "storage/ntp_config.h"
+#include "utils/retry_chain_node.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/semaphore.hh>
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace cloud_storage {
+
+/// \brief Restores the logs of new partitions from S3
+///
+/// The log of a partition is rebuilt from the segments uploaded by the
+/// archiver of an earlier incarnation of its topic, i.e. after the cluster
+/// was lost or to create a topic from an existing bucket. The revision of
+/// that incarnation is read from the topic manifest, the segments from the
+/// partition manifest. The segments and their indexes are downloaded in
+/// parallel into a staging directory which becomes the work directory of
+/// the log once all of them are downloaded: the log is opened with the
+/// restored segments and nothing is replayed through the produce path.
+///
+/// The downloads of all partitions of the shard share the connection
+/// limit of the remote, the partitions of a topic are restored as fast as
+/// the client pool allows.
+class partition_recovery_manager {
+public:
+    using segment = std::pair<segment_name, manifest::segment_meta>;
+
+    /// C-tor
+    ///
+    /// \param api is a remote endpoint used to download the data
+    /// \param bucket is a bucket that contains the uploaded topics
+    /// \param limit is a max number of concurrent downloads of the shard
+    /// \param timeout is a manifest or segment download timeout
+    /// \param backoff is an initial backoff interval for the downloads
+    partition_recovery_manager(
+      remote& api,
+      s3::bucket_name bucket,
+      s3_connection_limit limit,
+      ss::lowres_clock::duration timeout,
+      ss::lowres_clock::duration backoff);
+
+    /// Stop the manager, wait for the outstanding downloads to complete
+    ss::future<> stop();
+
+    /// \brief Download the log of the partition into its work directory
+    ///
+    /// The work directory of the log must not exist yet, a log that was
+    /// already created (or restored) is never overwritten.
+    /// \return true if the log was restored, false if the work directory
+    ///         exists or nothing was uploaded for the partition
+    ss::future<bool> download_log(const storage::ntp_config& ntp_cfg);
+
+    /// \brief Select the segments of the manifest to restore
+    ///
+    /// The segments are ordered by offset. A segment that overlaps the
+    /// previous ones, i.e. a reuploaded part of a segment, is skipped.
+    /// The log has to be contiguous, only the segments after the last gap
+    /// are restored.
+    static std::vector<segment> select_segments(const manifest& m);
+
+private:
+    /// Find the revision of the topic that uploaded the partitions
+    ss::future<std::optional<model::revision_id>>
+    find_revision(const model::ntp& ntp, retry_chain_node& parent);
+
+    ss::future<download_result>
+    download_manifest(manifest& m, retry_chain_node& parent);
+
+    /// Download the segment and its index into the staging directory
+    ss::future<> download_segment(
+      const manifest& m,
+      const segment& s,
+      const std::filesystem::path& dir,
+      retry_chain_node& parent);
+
+    remote& _remote;
+    s3::bucket_name _bucket;
+    ss::lowres_clock::duration _timeout;
+    ss::lowres_clock::duration _backoff;
+    ss::semaphore _download_limit;
+    ss::gate _gate;
+    ss::abort_source _as;
+    retry_chain_node _rtcnode;
+};
+
+} // namespace cloud_storage
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/probe.h"
+
+#include "prometheus/prometheus_sanitize.h"
+
+#include <seastar/core/metrics.hh>
+
+namespace cloud_storage {
+
+cache_probe::cache_probe(cache_metrics_disabled disabled) {
+    if (disabled) {
+        return;
+    }
+    namespace sm = ss::metrics;
+
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("cloud_storage_cache"),
+      {
+        sm::make_counter(
+          "hits",
+          [this] { return _cnt_hits; },
+          sm::description("Number of reads served from the segment cache")),
+        sm::make_counter(
+          "misses",
+          [this] { return _cnt_misses; },
+          sm::description("Number of reads that required a segment download")),
+        sm::make_counter(
+          "puts",
+          [this] { return _cnt_puts; },
+          sm::description("Number of segments added to the cache")),
+        sm::make_counter(
+          "evictions",
+          [this] { return _cnt_evictions; },
+          sm::description("Number of segments evicted from the cache")),
+        sm::make_counter(
+          "coalesced_hydrations",
+          [this] { return _cnt_coalesced; },
+          sm::description(
+            "Number of reads that waited for an in-flight download")),
+        sm::make_gauge(
+          "size_bytes",
+          [this] { return _size_bytes; },
+          sm::description("Size of the cached segments")),
+        sm::make_gauge(
+          "objects",
+          [this] { return _num_objects; },
+          sm::description("Number of cached segments")),
+      });
+}
+
+} // namespace cloud_storage
@@ -11,11 +11,15 @@
 #pragma once
 
 #include "archival/types.h"
+#include "cloud_storage/types.h"
 #include "model/fundamental.h"
 #include "seastarx.h"
+#include "utils/hdr_hist.h"
 
 #include <seastar/core/metrics_registration.hh>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 
 namespace cloud_storage {
@@ -127,7 +131,75 @@ public:
     /// Get backoff during log-segment download
     uint64_t get_download_backoffs() const { return _cnt_download_backoff; }
 
+    /// Register duplicate request of a slow download
+    void hedged_download() { _cnt_hedged_downloads++; }
+
+    /// Get duplicate requests of the slow downloads
+    uint64_t get_hedged_downloads() const { return _cnt_hedged_downloads; }
+
+    /// Register objects removed from the bucket
+    void objects_deleted(size_t n) { _cnt_deleted_objects += n; }
+
+    /// Get number of objects removed from the bucket
+    uint64_t get_deleted_objects() const { return _cnt_deleted_objects; }
+
+    /// Register segment downloaded ahead of a sequential reader
+    void segment_prefetch() { _cnt_segment_prefetches++; }
+
+    /// Get number of segments downloaded ahead of the readers
+    uint64_t get_segment_prefetches() const {
+        return _cnt_segment_prefetches;
+    }
+
+    /// Register read of the segment that was prefetched
+    void prefetch_hit() { _cnt_prefetch_hits++; }
+
+    /// Get number of reads of the prefetched segments
+    uint64_t get_prefetch_hits() const { return _cnt_prefetch_hits; }
+
+    /// Register the read-ahead depth of a sequential reader
+    void prefetch_depth(size_t depth) { _prefetch_depth.record(depth); }
+
+    /// Get read-ahead depth of the sequential readers
+    const hdr_hist& get_prefetch_depth() const { return _prefetch_depth; }
+
+    /// Register the time it took to upload the log-segment, including the
+    /// retries
+    void segment_upload_time(size_t bytes, std::chrono::microseconds t) {
+        _upload_latency.record(t.count());
+        _upload_throughput.record(bytes_per_second(bytes, t));
+    }
+
+    /// Register the time it took to download the object, including the
+    /// retries
+    void download_time(size_t bytes, std::chrono::microseconds t) {
+        _download_latency.record(t.count());
+        _download_throughput.record(bytes_per_second(bytes, t));
+    }
+
+    /// Get latency of the log-segment uploads (microseconds)
+    const hdr_hist& get_upload_latency() const { return _upload_latency; }
+
+    /// Get throughput of the log-segment uploads (bytes per second)
+    const hdr_hist& get_upload_throughput() const {
+        return _upload_throughput;
+    }
+
+    /// Get latency of the downloads (microseconds)
+    const hdr_hist& get_download_latency() const { return _download_latency; }
+
+    /// Get throughput of the downloads (bytes per second)
+    const hdr_hist& get_download_throughput() const {
+        return _download_throughput;
+    }
+
 private:
+    static uint64_t
+    bytes_per_second(size_t bytes, std::chrono::microseconds t) {
+        constexpr uint64_t us_per_sec = 1000000;
+        return bytes * us_per_sec / std::max<uint64_t>(t.count(), 1);
+    }
+
     /// Number of topic manifest uploads
     uint64_t _cnt_topic_manifest_uploads;
     /// Number of manifest (re)uploads
@@ -156,6 +228,91 @@ private:
     uint64_t _cnt_upload_backoff;
     /// Number of times backoff  was applied during log-segment downloads
     uint64_t _cnt_download_backoff;
+    /// Number of duplicate requests sent for the slow downloads
+    uint64_t _cnt_hedged_downloads;
+    /// Number of objects removed from the bucket
+    uint64_t _cnt_deleted_objects;
+    /// Number of segments downloaded ahead of the sequential readers
+    uint64_t _cnt_segment_prefetches{0};
+    /// Number of reads of the prefetched segments
+    uint64_t _cnt_prefetch_hits{0};
+    /// Latency and throughput of the log-segment uploads
+    hdr_hist _upload_latency;
+    hdr_hist _upload_throughput;
+    /// Latency and throughput of the downloads
+    hdr_hist _download_latency;
+    hdr_hist _download_throughput;
+    /// Read-ahead depth of the sequential readers
+    hdr_hist _prefetch_depth;
+
+    ss::metrics::metric_groups _metrics;
+};
+
+/// Segment cache probe
+class cache_probe {
+public:
+    explicit cache_probe(cache_metrics_disabled disabled);
+
+    /// Register cache hit
+    void cache_hit() { _cnt_hits++; }
+
+    /// Get cache hits
+    uint64_t get_cache_hits() const { return _cnt_hits; }
+
+    /// Register cache miss
+    void cache_miss() { _cnt_misses++; }
+
+    /// Get cache misses
+    uint64_t get_cache_misses() const { return _cnt_misses; }
+
+    /// Register new object in the cache
+    void put(size_t n) {
+        _cnt_puts++;
+        _size_bytes += n;
+        _num_objects++;
+    }
+
+    /// Get number of objects added to the cache
+    uint64_t get_puts() const { return _cnt_puts; }
+
+    /// Register eviction of an object from the cache
+    void evict(size_t n) {
+        _cnt_evictions++;
+        _size_bytes -= n;
+        _num_objects--;
+    }
+
+    /// Get number of evicted objects
+    uint64_t get_evictions() const { return _cnt_evictions; }
+
+    /// Register the hydration which was coalesced with the download
+    /// started by another reader
+    void coalesced_hydration() { _cnt_coalesced++; }
+
+    /// Get number of coalesced hydrations
+    uint64_t get_coalesced_hydrations() const { return _cnt_coalesced; }
+
+    /// Get current size of the cache
+    uint64_t get_size_bytes() const { return _size_bytes; }
+
+    /// Get current number of objects in the cache
+    uint64_t get_num_objects() const { return _num_objects; }
+
+private:
+    /// Number of reads served from the cache
+    uint64_t _cnt_hits{0};
+    /// Number of reads that required a download
+    uint64_t _cnt_misses{0};
+    /// Number of objects added to the cache
+    uint64_t _cnt_puts{0};
+    /// Number of evicted objects
+    uint64_t _cnt_evictions{0};
+    /// Number of reads that waited for a download started by another reader
+    uint64_t _cnt_coalesced{0};
+    /// Size of all objects in the cache
+    uint64_t _size_bytes{0};
+    /// Number of objects in the cache
+    uint64_t _num_objects{0};
 
     ss::metrics::metric_groups _metrics;
 };
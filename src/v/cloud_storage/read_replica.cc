@@ -0,0 +1,91 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/read_replica.h"
+
+#include "cloud_storage/logger.h"
+#include "cluster/types.h"
+#include "utils/gate_guard.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+
+namespace cloud_storage {
+
+read_replica::read_replica(
+  model::ntp ntp,
+  remote& api,
+  s3::bucket_name bucket,
+  ss::lowres_clock::duration timeout,
+  ss::lowres_clock::duration backoff,
+  cache* c,
+  size_t prefetch_depth)
+  : _ntp(std::move(ntp))
+  , _remote(api)
+  , _bucket(std::move(bucket))
+  , _timeout(timeout)
+  , _backoff(backoff)
+  , _manifest(_ntp, model::revision_id(0))
+  , _partition(ss::make_lw_shared<remote_partition>(
+      _manifest, _remote, _bucket, timeout, backoff, c, prefetch_depth)) {}
+
+ss::future<> read_replica::stop() {
+    return _partition->stop().then([this] { return _gate.close(); });
+}
+
+ss::future<download_result>
+read_replica::find_revision(retry_chain_node& fib) {
+    // The path of the topic manifest depends only on the topic name
+    topic_manifest tm(
+      cluster::topic_configuration(_ntp.ns, _ntp.tp.topic, 0, 0),
+      model::revision_id(0));
+    auto res = co_await _remote.download_manifest(_bucket, tm, fib);
+    if (res == download_result::success) {
+        _rev = tm.get_revision_id();
+    }
+    co_return res;
+}
+
+ss::future<download_result> read_replica::sync(retry_chain_node& parent) {
+    gate_guard guard{_gate};
+    retry_chain_node fib(_timeout, _backoff, &parent);
+    if (!_rev) {
+        auto res = co_await find_revision(fib);
+        if (res != download_result::success) {
+            co_return res;
+        }
+    }
+    manifest m(_ntp, *_rev);
+    auto res = co_await _remote.download_binary_manifest(_bucket, m, fib);
+    if (res == download_result::notfound) {
+        // The source cluster could upload the json manifest only
+        res = co_await _remote.download_manifest(_bucket, m, fib);
+    }
+    if (res == download_result::notfound) {
+        // Nothing is uploaded yet or the source topic was recreated, the
+        // topic manifest is read again by the next sync
+        vlog(
+          cst_log.debug,
+          "{} Manifest of {} revision {} not found in {}",
+          fib(),
+          _ntp,
+          *_rev,
+          _bucket);
+        _rev = std::nullopt;
+        co_return res;
+    }
+    if (res == download_result::success) {
+        _manifest = std::move(m);
+        _synced = true;
+    }
+    co_return res;
+}
+
+} // namespace cloud_storage
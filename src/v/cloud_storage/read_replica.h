@@ -0,0 +1,107 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#pragma once
+
+#include "cloud_storage/cache_service.h"
+#include "cloud_storage/manifest.h"
+#include "cloud_storage/remote.h"
+#include "cloud_storage/remote_partition.h"
+#include "cloud_storage/types.h"
+#include "model/fundamental.h"
+#include "s3/client.h"
+#include "utils/retry_chain_node.h"
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include <optional>
+
+namespace cloud_storage {
+
+/// \brief S3 view of a partition archived by another cluster
+///
+/// The partition of a read replica topic has no data in its local log, all
+/// reads are served by the remote partition from the bucket of the cluster
+/// that produces the topic. The topic has the same name in both clusters.
+/// The revision of the source topic is read from its topic manifest, the
+/// segments from its partition manifest. The partition manifest is polled
+/// by 'sync' to pick up the segments uploaded since the previous call, it
+/// is replaced only after a successful download so the readers never see a
+/// partial manifest.
+///
+/// \note The offsets are the log offsets of the source cluster.
+class read_replica {
+public:
+    /// C-tor
+    ///
+    /// \param ntp is an ntp of the partition in both clusters
+    /// \param api is a remote endpoint used to download the data
+    /// \param bucket is a bucket of the source cluster
+    /// \param timeout is a manifest or segment download timeout
+    /// \param backoff is an initial backoff interval for the downloads
+    /// \param c is an optional segment cache used by the reads
+    /// \param prefetch_depth is a max number of segments fetched ahead of
+    ///        a sequential reader
+    read_replica(
+      model::ntp ntp,
+      remote& api,
+      s3::bucket_name bucket,
+      ss::lowres_clock::duration timeout,
+      ss::lowres_clock::duration backoff,
+      cache* c = nullptr,
+      size_t prefetch_depth = 0);
+
+    // the remote partition references the manifest
+    read_replica(const read_replica&) = delete;
+    read_replica& operator=(const read_replica&) = delete;
+    read_replica(read_replica&&) = delete;
+    read_replica& operator=(read_replica&&) = delete;
+    ~read_replica() = default;
+
+    /// Stop the replica, wait for the outstanding sync and reads
+    ss::future<> stop();
+
+    const model::ntp& get_ntp() const { return _ntp; }
+
+    const s3::bucket_name& get_bucket() const { return _bucket; }
+
+    /// \brief Download the latest partition manifest of the source topic
+    ///
+    /// The topic manifest is downloaded first if the revision of the
+    /// source topic is not known yet, or if the partition manifest of the
+    /// known revision is gone, i.e. the source topic was recreated.
+    ss::future<download_result> sync(retry_chain_node& parent);
+
+    /// Return true if the manifest was downloaded at least once
+    bool is_synced() const { return _synced; }
+
+    /// Get the view used to serve the reads
+    ss::lw_shared_ptr<remote_partition> get_remote_partition() const {
+        return _partition;
+    }
+
+private:
+    ss::future<download_result> find_revision(retry_chain_node& fib);
+
+    model::ntp _ntp;
+    remote& _remote;
+    s3::bucket_name _bucket;
+    ss::lowres_clock::duration _timeout;
+    ss::lowres_clock::duration _backoff;
+    std::optional<model::revision_id> _rev;
+    manifest _manifest;
+    ss::lw_shared_ptr<remote_partition> _partition;
+    bool _synced{false};
+    ss::gate _gate;
+};
+
+} // namespace cloud_storage
@@ -17,12 +17,17 @@
 #include "utils/intrusive_list_helpers.h"
 #include "utils/string_switch.h"
 
+#include <seastar/core/condition-variable.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/core/lowres_clock.hh>
+#include <seastar/core/semaphore.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/core/timed_out_error.hh>
 #include <seastar/core/weak_ptr.hh>
 
 #include <boost/beast/http/error.hpp>
+#include <boost/range/irange.hpp>
 
 #include <exception>
 #include <variant>
@@ -42,6 +47,12 @@ enum class error_outcome {
     notfound
 };
 
+static std::chrono::microseconds
+elapsed_us(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
 /// @brief Analyze exception
 /// @return error outcome - retry, fail (with exception), or notfound (can only
 /// be used with download)
@@ -144,8 +155,12 @@ static error_outcome categorize_error(
 remote::remote(
   s3_connection_limit limit,
   const s3::configuration& conf,
-  service_probe& probe)
+  service_probe& probe,
+  multipart_upload_config multipart,
+  hedged_download_config hedge)
   : _pool(limit(), conf)
+  , _multipart(multipart)
+  , _hedge(hedge)
   , _probe(probe) {}
 
 ss::future<> remote::start() { return ss::now(); }
@@ -156,10 +171,36 @@ ss::future<> remote::stop() {
     co_await _gate.close();
 }
 
+/// Return ETag of the object from the GET response (empty if missing)
+static ss::sstring get_etag(const http::client::response_stream_ref& resp) {
+    const auto& headers = resp->get_headers();
+    auto it = headers.find(boost::beast::http::field::etag);
+    if (it == headers.end()) {
+        return "";
+    }
+    return ss::sstring(it->value().data(), it->value().size());
+}
+
+/// Return true if the GET response says the object is the same as the
+/// cached copy
+static bool is_not_modified(const http::client::response_stream_ref& resp) {
+    return resp->get_headers().result()
+           == boost::beast::http::status::not_modified;
+}
+
+/// Return the If-None-Match value for the cached copy of the object
+static std::optional<ss::sstring> if_none_match(const ss::sstring* etag) {
+    if (etag == nullptr || etag->empty()) {
+        return std::nullopt;
+    }
+    return *etag;
+}
+
 ss::future<download_result> remote::download_manifest(
   const s3::bucket_name& bucket,
   base_manifest& manifest,
-  retry_chain_node& parent) {
+  retry_chain_node& parent,
+  ss::sstring* etag) {
     gate_guard guard{_gate};
     retry_chain_node fib(&parent);
     auto key = manifest.get_manifest_path();
@@ -171,9 +212,21 @@ ss::future<download_result> remote::download_manifest(
         std::exception_ptr eptr = nullptr;
         try {
             auto resp = co_await client->get_object(
-              bucket, path, fib.get_timeout());
+              bucket,
+              path,
+              fib.get_timeout(),
+              std::nullopt,
+              if_none_match(etag));
+            if (is_not_modified(resp)) {
+                vlog(cst_log.debug, "{} Manifest {} not modified", fib(), path);
+                co_await resp->as_input_stream().close();
+                co_return download_result::success;
+            }
             vlog(cst_log.debug, "{} Receive OK response from {}", fib(), path);
             co_await manifest.update(resp->as_input_stream());
+            if (etag) {
+                *etag = get_etag(resp);
+            }
             switch (manifest.get_manifest_type()) {
             case manifest_type::partition:
                 _probe.partition_manifest_upload();
@@ -229,7 +282,8 @@ ss::future<download_result> remote::download_manifest(
 ss::future<upload_result> remote::upload_manifest(
   const s3::bucket_name& bucket,
   const base_manifest& manifest,
-  retry_chain_node& parent) {
+  retry_chain_node& parent,
+  ss::sstring* etag) {
     gate_guard guard{_gate};
     retry_chain_node fib(&parent);
     auto key = manifest.get_manifest_path();
@@ -247,8 +301,11 @@ ss::future<upload_result> remote::upload_manifest(
         std::exception_ptr eptr = nullptr;
         try {
             auto [is, size] = manifest.serialize();
-            co_await client->put_object(
+            auto uploaded = co_await client->put_object(
               bucket, path, size, std::move(is), tags, fib.get_timeout());
+            if (etag) {
+                *etag = std::move(uploaded);
+            }
             vlog(
               cst_log.debug,
               "{} Successfuly uploaded manifest to {}",
@@ -311,6 +368,7 @@ ss::future<upload_result> remote::upload_segment(
     retry_chain_node fib(&parent);
     auto s3path = manifest.get_remote_segment_path(exposed_name);
     std::vector<s3::object_tag> tags = {{"rp-type", "segment"}};
+    auto start = std::chrono::steady_clock::now();
     auto permit = fib.retry();
     vlog(
       cst_log.debug,
@@ -340,6 +398,7 @@ ss::future<upload_result> remote::upload_segment(
               tags,
               fib.get_timeout());
             _probe.successful_upload(content_length);
+            _probe.segment_upload_time(content_length, elapsed_us(start));
             co_return upload_result::success;
         } catch (...) {
             eptr = std::current_exception();
@@ -378,28 +437,578 @@ ss::future<upload_result> remote::upload_segment(
     co_return upload_result::timedout;
 }
 
+ss::future<upload_result> remote::upload_with_retries(
+  const s3::bucket_name& bucket,
+  const s3::object_key& path,
+  client_func func,
+  retry_chain_node& parent) {
+    retry_chain_node fib(&parent);
+    auto permit = fib.retry();
+    while (!_gate.is_closed() && permit.is_allowed) {
+        std::exception_ptr eptr = nullptr;
+        auto [client, deleter] = co_await _pool.acquire();
+        try {
+            co_await func(*client);
+            co_return upload_result::success;
+        } catch (...) {
+            eptr = std::current_exception();
+        }
+        auto outcome = categorize_error(eptr, fib, bucket, path);
+        switch (outcome) {
+        case error_outcome::retry_slowdown:
+            co_await client->shutdown();
+            [[fallthrough]];
+        case error_outcome::retry:
+            vlog(
+              cst_log.debug,
+              "{} Uploading {} to {}, {}ms backoff required",
+              fib(),
+              path,
+              bucket,
+              permit.delay.count());
+            _probe.upload_backoff();
+            // Release the connection so other requests could use it during
+            // the backoff
+            deleter = ss::deleter();
+            co_await ss::sleep_abortable(permit.delay, _as);
+            permit = fib.retry();
+            break;
+        case error_outcome::notfound:
+            // not expected during upload
+        case error_outcome::fail:
+            co_return upload_result::failed;
+        }
+    }
+    co_return upload_result::timedout;
+}
+
+ss::future<upload_result> remote::upload_segment(
+  const s3::bucket_name& bucket,
+  const segment_name& exposed_name,
+  uint64_t content_length,
+  const reset_input_stream_range& reset_str,
+  manifest& manifest,
+  retry_chain_node& parent) {
+    const auto part_size = _multipart.part_size;
+    if (part_size == 0 || content_length <= part_size) {
+        co_return co_await upload_segment(
+          bucket,
+          exposed_name,
+          content_length,
+          [&reset_str, content_length] {
+              return reset_str(0, content_length);
+          },
+          manifest,
+          parent);
+    }
+    gate_guard guard{_gate};
+    auto start = std::chrono::steady_clock::now();
+    retry_chain_node fib(&parent);
+    auto s3path = manifest.get_remote_segment_path(exposed_name);
+    auto path = s3::object_key(s3path().string());
+    std::vector<s3::object_tag> tags = {{"rp-type", "segment"}};
+    const size_t num_parts = (content_length + part_size - 1) / part_size;
+    vlog(
+      cst_log.debug,
+      "{} Uploading segment for {}, path {}, length {}, using multipart "
+      "upload with {} parts",
+      fib(),
+      manifest.get_ntp(),
+      s3path,
+      content_length,
+      num_parts);
+
+    s3::multipart_upload_id upload_id;
+    auto res = co_await upload_with_retries(
+      bucket,
+      path,
+      [&](s3::client& client) {
+          return client
+            .create_multipart_upload(bucket, path, tags, fib.get_timeout())
+            .then([&upload_id](s3::multipart_upload_id id) {
+                upload_id = std::move(id);
+            });
+      },
+      fib);
+    if (res != upload_result::success) {
+        _probe.failed_upload(content_length);
+        co_return res;
+    }
+
+    std::vector<s3::client::upload_part_result> parts(num_parts);
+    ss::semaphore limit(std::max<size_t>(_multipart.max_concurrency, 1));
+    co_await ss::parallel_for_each(
+      boost::irange<size_t>(0, num_parts), [&](size_t ix) {
+          return ss::with_semaphore(limit, 1, [&, ix] {
+              if (res != upload_result::success) {
+                  // One of the parts failed, the upload will be aborted
+                  return ss::now();
+              }
+              uint64_t pos = ix * part_size;
+              uint64_t len = std::min<uint64_t>(
+                part_size, content_length - pos);
+              return upload_with_retries(
+                       bucket,
+                       path,
+                       [&, ix, pos, len](s3::client& client) {
+                           return client
+                             .upload_part(
+                               bucket,
+                               path,
+                               upload_id,
+                               ix + 1,
+                               len,
+                               reset_str(pos, len),
+                               fib.get_timeout())
+                             .then([&parts, ix](
+                                     s3::client::upload_part_result r) {
+                                 parts[ix] = std::move(r);
+                             });
+                       },
+                       fib)
+                .then([&res](upload_result r) {
+                    if (r != upload_result::success) {
+                        res = r;
+                    }
+                });
+          });
+      });
+
+    if (res == upload_result::success) {
+        res = co_await upload_with_retries(
+          bucket,
+          path,
+          [&](s3::client& client) {
+              return client.complete_multipart_upload(
+                bucket, path, upload_id, parts, fib.get_timeout());
+          },
+          fib);
+    }
+    if (res == upload_result::success) {
+        vlog(
+          cst_log.debug,
+          "{} Multipart upload of {} completed, {} parts",
+          fib(),
+          path,
+          num_parts);
+        _probe.successful_upload(content_length);
+        _probe.segment_upload_time(content_length, elapsed_us(start));
+        co_return res;
+    }
+
+    vlog(
+      cst_log.warn,
+      "{} Multipart upload of segment {} to {} failed, aborting",
+      fib(),
+      path,
+      bucket);
+    _probe.failed_upload(content_length);
+    auto abort_res = co_await upload_with_retries(
+      bucket,
+      path,
+      [&](s3::client& client) {
+          return client.abort_multipart_upload(
+            bucket, path, upload_id, fib.get_timeout());
+      },
+      fib);
+    if (abort_res != upload_result::success) {
+        vlog(
+          cst_log.warn,
+          "{} Can't abort multipart upload {} of {}, uploaded parts will "
+          "remain in the bucket until removed by the lifecycle policy",
+          fib(),
+          upload_id,
+          path);
+    }
+    co_return res;
+}
+
 ss::future<download_result> remote::download_segment(
   const s3::bucket_name& bucket,
   const segment_name& name,
-  manifest& manifest,
+  const manifest& manifest,
+  const try_consume_stream& cons_str,
+  retry_chain_node& parent,
+  std::optional<s3::byte_range> range) {
+    auto s3path = manifest.get_remote_segment_path(name);
+    return download_object(
+      bucket, s3::object_key(s3path().string()), cons_str, parent, range);
+}
+
+ss::future<download_result> remote::download_segment_index(
+  const s3::bucket_name& bucket,
+  const segment_name& name,
+  const manifest& manifest,
   const try_consume_stream& cons_str,
+  retry_chain_node& parent) {
+    auto s3path = manifest.get_remote_segment_index_path(name);
+    return download_object(
+      bucket, s3::object_key(s3path().string()), cons_str, parent);
+}
+
+ss::future<upload_result> remote::upload_segment_index(
+  const s3::bucket_name& bucket,
+  const segment_name& exposed_name,
+  iobuf index,
+  const manifest& manifest,
+  retry_chain_node& parent) {
+    auto s3path = manifest.get_remote_segment_index_path(exposed_name);
+    return upload_object(
+      bucket,
+      s3::object_key(s3path().string()),
+      std::move(index),
+      {{"rp-type", "segment-index"}},
+      parent);
+}
+
+ss::future<upload_result> remote::delete_segments(
+  const s3::bucket_name& bucket,
+  const std::vector<remote_segment_path>& paths,
   retry_chain_node& parent) {
     gate_guard guard{_gate};
     retry_chain_node fib(&parent);
-    auto s3path = manifest.get_remote_segment_path(name);
-    auto path = s3::object_key(s3path().string());
-    auto [client, deleter] = co_await _pool.acquire();
+    vlog(cst_log.debug, "{} Deleting {} segments", fib(), paths.size());
+    // S3 doesn't fail the deletion of the missing object, the index might
+    // not exist
+    std::vector<s3::object_key> keys;
+    keys.reserve(paths.size() * 2);
+    for (const auto& path : paths) {
+        keys.emplace_back(path().string());
+        keys.emplace_back(path().string() + ".index");
+    }
+    for (size_t i = 0; i < keys.size();
+         i += s3::client::max_delete_objects_keys) {
+        auto last = std::min(
+          keys.size(), i + s3::client::max_delete_objects_keys);
+        std::vector<s3::object_key> batch(
+          keys.begin() + static_cast<ptrdiff_t>(i),
+          keys.begin() + static_cast<ptrdiff_t>(last));
+        s3::client::delete_objects_result result;
+        auto res = co_await upload_with_retries(
+          bucket,
+          batch.front(),
+          [&bucket, &batch, &fib, &result](s3::client& client) {
+              return client.delete_objects(bucket, batch, fib.get_timeout())
+                .then([&result](s3::client::delete_objects_result r) {
+                    result = std::move(r);
+                });
+          },
+          fib);
+        if (res != upload_result::success) {
+            co_return res;
+        }
+        for (const auto& e : result.errors) {
+            vlog(
+              cst_log.warn,
+              "{} Can't delete {} from {}: {} {}",
+              fib(),
+              e.key,
+              bucket,
+              e.code,
+              e.message);
+        }
+        _probe.objects_deleted(batch.size() - result.errors.size());
+        if (!result.errors.empty()) {
+            // the deletion is idempotent, the caller retries the whole batch
+            co_return upload_result::failed;
+        }
+    }
+    co_return upload_result::success;
+}
+
+ss::future<upload_result> remote::upload_binary_manifest(
+  const s3::bucket_name& bucket,
+  const manifest& manifest,
+  retry_chain_node& parent,
+  ss::sstring* etag) {
+    auto key = manifest.get_binary_manifest_path();
+    auto res = co_await upload_object(
+      bucket,
+      s3::object_key(key().string()),
+      manifest.serialize_binary(),
+      {{"rp-type", "partition-manifest"}},
+      parent,
+      etag);
+    if (res == upload_result::success) {
+        _probe.partition_manifest_upload();
+    } else {
+        _probe.failed_manifest_upload();
+    }
+    co_return res;
+}
+
+ss::future<upload_result> remote::upload_spillover_manifest(
+  const s3::bucket_name& bucket,
+  const manifest& manifest,
+  const manifest::spillover_meta& meta,
+  retry_chain_node& parent) {
+    auto key = manifest.get_spillover_manifest_path(meta);
+    return upload_object(
+      bucket,
+      s3::object_key(key().string()),
+      manifest.serialize_spillover(meta),
+      {{"rp-type", "partition-manifest"}},
+      parent);
+}
+
+ss::future<download_result> remote::download_binary_manifest(
+  const s3::bucket_name& bucket,
+  manifest& manifest,
+  retry_chain_node& parent,
+  ss::sstring* etag) {
+    gate_guard guard{_gate};
+    iobuf data;
+    bool modified = false;
+    auto consume_str =
+      [&data, &modified](ss::input_stream<char> is) -> ss::future<uint64_t> {
+        modified = true;
+        data.clear();
+        auto os = make_iobuf_ref_output_stream(data);
+        co_await ss::copy(is, os);
+        co_return data.size_bytes();
+    };
+    auto key = manifest.get_binary_manifest_path();
+    ss::sstring new_etag = etag ? *etag : "";
+    auto res = co_await download_object(
+      bucket,
+      s3::object_key(key().string()),
+      consume_str,
+      parent,
+      std::nullopt,
+      &new_etag);
+    if (res != download_result::success || !modified) {
+        co_return res;
+    }
+    cloud_storage::manifest result;
+    result.update_binary(std::move(data));
+    for (const auto& sp : result.get_spillover()) {
+        auto sp_key = result.get_spillover_manifest_path(sp);
+        res = co_await download_object(
+          bucket, s3::object_key(sp_key().string()), consume_str, parent);
+        if (res != download_result::success) {
+            vlog(
+              cst_log.warn,
+              "{} Spillover manifest {} is not available",
+              parent(),
+              sp_key);
+            // The binary manifest references the missing object, this
+            // is not the same as if the manifest doesn't exist
+            co_return res == download_result::notfound
+              ? download_result::failed
+              : res;
+        }
+        result.update_spillover(std::move(data));
+    }
+    manifest = std::move(result);
+    if (etag) {
+        *etag = std::move(new_etag);
+    }
+    co_return download_result::success;
+}
+
+ss::future<upload_result> remote::upload_object(
+  const s3::bucket_name& bucket,
+  const s3::object_key& path,
+  iobuf payload,
+  std::vector<s3::object_tag> tags,
+  retry_chain_node& parent,
+  ss::sstring* etag) {
+    gate_guard guard{_gate};
+    retry_chain_node fib(&parent);
+    vlog(
+      cst_log.debug,
+      "{} Uploading object {} to {}, length {}",
+      fib(),
+      path,
+      bucket,
+      payload.size_bytes());
+    auto res = co_await upload_with_retries(
+      bucket,
+      path,
+      [&](s3::client& client) {
+          auto size = payload.size_bytes();
+          return client
+            .put_object(
+              bucket,
+              path,
+              size,
+              make_iobuf_input_stream(payload.copy()),
+              tags,
+              fib.get_timeout())
+            .then([etag](ss::sstring uploaded) {
+                if (etag) {
+                    *etag = std::move(uploaded);
+                }
+            });
+      },
+      fib);
+    if (res != upload_result::success) {
+        vlog(
+          cst_log.warn,
+          "{} Uploading object {} to {} failed",
+          fib(),
+          path,
+          bucket);
+    }
+    co_return res;
+}
+
+/// State of the concurrent GET requests of the same object
+struct get_race {
+    /// Index of the request that received the response first
+    std::optional<size_t> winner;
+    http::client::response_stream_ref response;
+    /// Error of the first failed request
+    std::exception_ptr error;
+    /// Number of requests in flight
+    size_t pending{0};
+    ss::condition_variable cvar;
+
+    bool finished() const { return winner || pending == 0; }
+};
+
+/// Send one of the racing GET requests, the arguments are copied since
+/// the request can outlive the caller
+static ss::future<> race_get_object(
+  ss::lw_shared_ptr<get_race> race,
+  size_t index,
+  s3::client_pool::http_client_ptr client,
+  s3::bucket_name bucket,
+  s3::object_key path,
+  ss::lowres_clock::duration timeout,
+  std::optional<s3::byte_range> range,
+  std::optional<ss::sstring> if_none_match) {
+    try {
+        auto resp = co_await client->get_object(
+          bucket, path, timeout, range, std::move(if_none_match));
+        if (!race->winner) {
+            race->winner = index;
+            race->response = std::move(resp);
+        }
+    } catch (...) {
+        if (!race->error) {
+            race->error = std::current_exception();
+        }
+    }
+    race->pending--;
+    race->cvar.broadcast();
+}
+
+ss::future<http::client::response_stream_ref> remote::hedged_get_object(
+  s3::client_pool::client_lease& lease,
+  const s3::bucket_name& bucket,
+  const s3::object_key& path,
+  ss::lowres_clock::duration timeout,
+  std::optional<s3::byte_range> range,
+  std::optional<ss::sstring> if_none_match,
+  retry_chain_node& fib) {
+    auto delay = _hedge.hedge_delay();
+    _hedge.register_request();
+    auto start = ss::lowres_clock::now();
+    auto elapsed = [start] {
+        return std::chrono::duration_cast<hedge_policy::duration>(
+          ss::lowres_clock::now() - start);
+    };
+    if (!delay) {
+        auto resp = co_await lease.client->get_object(
+          bucket, path, timeout, range, std::move(if_none_match));
+        _hedge.record_latency(elapsed());
+        co_return resp;
+    }
+
+    auto race = ss::make_lw_shared<get_race>();
+    race->pending = 1;
+    auto primary = race_get_object(
+      race, 0, lease.client, bucket, path, timeout, range, if_none_match);
+    try {
+        co_await race->cvar.wait(*delay, [&race] { return race->finished(); });
+    } catch (const ss::condition_variable_timed_out&) {
+    }
+    std::optional<s3::client_pool::client_lease> hedge;
+    std::optional<ss::future<>> secondary;
+    // the hedge never waits for a client, the request would be delayed
+    // by the other downloads
+    if (!race->finished() && _pool.size() > 0 && _hedge.try_hedge()) {
+        vlog(
+          cst_log.debug,
+          "{} No response from {} after {}ms, sending duplicate request",
+          fib(),
+          path,
+          delay->count());
+        _probe.hedged_download();
+        hedge = co_await _pool.acquire();
+        race->pending++;
+        secondary = race_get_object(
+          race, 1, hedge->client, bucket, path, timeout, range, if_none_match);
+    }
+    co_await race->cvar.wait([&race] { return race->finished(); });
+
+    if (race->winner) {
+        _hedge.record_latency(elapsed());
+        if (secondary && *race->winner == 1) {
+            std::swap(lease, *hedge);
+            std::swap(primary, *secondary);
+        }
+    }
+    // cancel the losing request, if any, the winner is already complete
+    if (secondary) {
+        co_await hedge->client->shutdown();
+        co_await std::move(*secondary);
+    }
+    co_await std::move(primary);
+    if (!race->winner) {
+        std::rethrow_exception(race->error);
+    }
+    co_return std::move(race->response);
+}
+
+ss::future<download_result> remote::download_object(
+  const s3::bucket_name& bucket,
+  const s3::object_key& path,
+  const try_consume_stream& cons_str,
+  retry_chain_node& parent,
+  std::optional<s3::byte_range> range,
+  ss::sstring* etag) {
+    gate_guard guard{_gate};
+    retry_chain_node fib(&parent);
+    auto start = std::chrono::steady_clock::now();
+    auto lease = co_await _pool.acquire();
     auto permit = fib.retry();
-    vlog(cst_log.debug, "{} Download segment {}", fib(), path);
+    if (range) {
+        vlog(
+          cst_log.debug,
+          "{} Download object {}, range {}-{}",
+          fib(),
+          path,
+          range->first,
+          range->last);
+    } else {
+        vlog(cst_log.debug, "{} Download object {}", fib(), path);
+    }
     while (!_gate.is_closed() && permit.is_allowed) {
         std::exception_ptr eptr = nullptr;
         try {
-            auto resp = co_await client->get_object(
-              bucket, path, fib.get_timeout());
+            auto resp = co_await hedged_get_object(
+              lease,
+              bucket,
+              path,
+              fib.get_timeout(),
+              range,
+              if_none_match(etag),
+              fib);
+            if (is_not_modified(resp)) {
+                vlog(cst_log.debug, "{} Object {} not modified", fib(), path);
+                co_await resp->as_input_stream().close();
+                co_return download_result::success;
+            }
+            if (etag) {
+                *etag = get_etag(resp);
+            }
             vlog(cst_log.debug, "{} Receive OK response from {}", fib(), path);
             uint64_t content_length = co_await cons_str(
               resp->as_input_stream());
             _probe.successful_download(content_length);
+            _probe.download_time(content_length, elapsed_us(start));
             co_return download_result::success;
         } catch (...) {
             eptr = std::current_exception();
@@ -407,7 +1016,7 @@ ss::future<download_result> remote::download_segment(
         auto outcome = categorize_error(eptr, fib, bucket, path);
         switch (outcome) {
         case error_outcome::retry_slowdown:
-            co_await client->shutdown();
+            co_await lease.client->shutdown();
             [[fallthrough]];
         case error_outcome::retry:
             vlog(
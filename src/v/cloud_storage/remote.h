@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "cloud_storage/hedge_policy.h"
 #include "cloud_storage/manifest.h"
 #include "cloud_storage/probe.h"
 #include "cloud_storage/types.h"
@@ -35,6 +36,12 @@ public:
     /// to re-upload and will return all data that needs to be uploaded
     using reset_input_stream = std::function<ss::input_stream<char>()>;
 
+    /// Functor that returns fresh input_stream object that returns 'length'
+    /// bytes of the uploaded data starting from 'offset'. Used to upload
+    /// individual parts of the object.
+    using reset_input_stream_range
+      = std::function<ss::input_stream<char>(uint64_t offset, uint64_t length)>;
+
     /// Functor that attempts to consume the input stream. If the connection
     /// is broken during the download the functor is responsible for he cleanup.
     /// The functor should be reenterable since it can be called many times.
@@ -47,10 +54,14 @@ public:
     ///
     /// \param limit is a number of simultaneous connections
     /// \param conf is an S3 configuration
+    /// \param multipart controls multipart uploads of the segments
+    /// \param hedge controls duplicate requests of the slow downloads
     explicit remote(
       s3_connection_limit limit,
       const s3::configuration& conf,
-      service_probe& probe);
+      service_probe& probe,
+      multipart_upload_config multipart = {},
+      hedged_download_config hedge = {});
 
     /// \brief Start the remote
     ss::future<> start();
@@ -60,27 +71,37 @@ public:
     /// Wait until all background operations complete
     ss::future<> stop();
 
+    /// Probe used to register the uploads and downloads
+    service_probe& get_probe() { return _probe; }
+
     /// \brief Download manifest from pre-defined S3 location
     ///
     /// Method downloads the manifest and handles backpressure and
     /// errors. It retries multiple times until timeout excedes.
     /// \param bucket is a bucket name
     /// \param manifest is a manifest to download
+    /// \param etag is an optional ETag of the manifest version 'manifest'
+    ///        contains, the manifest is left intact if S3 has the same
+    ///        version. It's updated with the ETag of the downloaded version.
     /// \return future that returns success code
     ss::future<download_result> download_manifest(
       const s3::bucket_name& bucket,
       base_manifest& manifest,
-      retry_chain_node& parent);
+      retry_chain_node& parent,
+      ss::sstring* etag = nullptr);
 
     /// \brief Upload manifest to the pre-defined S3 location
     ///
     /// \param bucket is a bucket name
     /// \param manifest is a manifest to upload
+    /// \param etag is an optional output parameter, the ETag of the
+    ///        uploaded object
     /// \return future that returns success code
     ss::future<upload_result> upload_manifest(
       const s3::bucket_name& bucket,
       const base_manifest& manifest,
-      retry_chain_node& parent);
+      retry_chain_node& parent,
+      ss::sstring* etag = nullptr);
 
     /// \brief Upload segment to S3
     ///
@@ -98,6 +119,25 @@ public:
       manifest& manifest,
       retry_chain_node& parent);
 
+    /// \brief Upload segment to S3 using multipart upload if it's large
+    ///
+    /// Segments that are larger than the configured part size are split
+    /// into parts which are uploaded concurrently using separate
+    /// connections. Every part is retried independently so the error
+    /// doesn't restart the upload from the beginning. Smaller segments are
+    /// uploaded using a single request.
+    /// \param reset_str is a functor that returns an input_stream that
+    ///                  returns the requested range of segment's data
+    /// \param exposed_name is a segment's name in S3
+    /// \param manifest is a manifest that should have the segment metadata
+    ss::future<upload_result> upload_segment(
+      const s3::bucket_name& bucket,
+      const segment_name& exposed_name,
+      uint64_t content_length,
+      const reset_input_stream_range& reset_str,
+      manifest& manifest,
+      retry_chain_node& parent);
+
     /// \brief Download segment from S3
     ///
     /// The method downloads the segment while tolerating some errors. It can
@@ -106,15 +146,139 @@ public:
     /// segment's data
     /// \param name is a segment's name in S3
     /// \param manifest is a manifest that should have the segment metadata
+    /// \param range is an optional range of bytes to download, the stream
+    ///        passed to 'cons_str' contains only these bytes
     ss::future<download_result> download_segment(
       const s3::bucket_name& bucket,
       const segment_name& name,
-      manifest& manifest,
+      const manifest& manifest,
+      const try_consume_stream& cons_str,
+      retry_chain_node& parent,
+      std::optional<s3::byte_range> range = std::nullopt);
+
+    /// \brief Upload serialized segment index to S3
+    ///
+    /// The index is stored next to the segment (see
+    /// 'manifest::get_remote_segment_index_path').
+    /// \param exposed_name is a name of the segment the index belongs to
+    /// \param index is a serialized 'storage::index_state'
+    ss::future<upload_result> upload_segment_index(
+      const s3::bucket_name& bucket,
+      const segment_name& exposed_name,
+      iobuf index,
+      const manifest& manifest,
+      retry_chain_node& parent);
+
+    /// \brief Download segment index from S3
+    ///
+    /// \param cons_str is a functor that consumes the serialized index
+    /// \param name is a name of the segment the index belongs to
+    ss::future<download_result> download_segment_index(
+      const s3::bucket_name& bucket,
+      const segment_name& name,
+      const manifest& manifest,
       const try_consume_stream& cons_str,
       retry_chain_node& parent);
 
+    /// \brief Delete the segments and their indexes from S3
+    ///
+    /// Used to remove the objects that are no longer referenced by the
+    /// manifest. The paths are computed before the segments are removed
+    /// from the manifest. The objects are deleted using multi-object
+    /// delete requests.
+    /// \param paths are the paths of the segment objects
+    ss::future<upload_result> delete_segments(
+      const s3::bucket_name& bucket,
+      const std::vector<remote_segment_path>& paths,
+      retry_chain_node& parent);
+
+    /// \brief Upload manifest in binary format
+    ///
+    /// Only the segments which are not in spillover manifests are uploaded.
+    ss::future<upload_result> upload_binary_manifest(
+      const s3::bucket_name& bucket,
+      const manifest& manifest,
+      retry_chain_node& parent,
+      ss::sstring* etag = nullptr);
+
+    /// \brief Upload immutable spillover manifest
+    ///
+    /// The spillover manifest should be uploaded before its range is added
+    /// to the binary manifest using 'manifest::add_spillover'.
+    ss::future<upload_result> upload_spillover_manifest(
+      const s3::bucket_name& bucket,
+      const manifest& manifest,
+      const manifest::spillover_meta& meta,
+      retry_chain_node& parent);
+
+    /// \brief Download manifest in binary format
+    ///
+    /// The binary manifest and all spillover manifests referenced by it
+    /// are downloaded. The content of the 'manifest' is replaced only if
+    /// all objects are downloaded successfully. The 'etag' parameter
+    /// has the same meaning as in 'download_manifest', the spillover
+    /// manifests are immutable and are not downloaded if the binary
+    /// manifest is not modified.
+    ss::future<download_result> download_binary_manifest(
+      const s3::bucket_name& bucket,
+      manifest& manifest,
+      retry_chain_node& parent,
+      ss::sstring* etag = nullptr);
+
 private:
+    using client_func = std::function<ss::future<>(s3::client&)>;
+
+    /// Upload the object using leased client, retry on transient errors
+    ///
+    /// \param etag is an optional output parameter, the ETag of the object
+    ss::future<upload_result> upload_object(
+      const s3::bucket_name& bucket,
+      const s3::object_key& path,
+      iobuf payload,
+      std::vector<s3::object_tag> tags,
+      retry_chain_node& parent,
+      ss::sstring* etag = nullptr);
+
+    /// Download the object using leased client, retry on transient errors
+    ///
+    /// \param etag is an optional in/out ETag, if it's not empty and the
+    ///        object has the same ETag the 'cons_str' is not invoked
+    ss::future<download_result> download_object(
+      const s3::bucket_name& bucket,
+      const s3::object_key& path,
+      const try_consume_stream& cons_str,
+      retry_chain_node& parent,
+      std::optional<s3::byte_range> range = std::nullopt,
+      ss::sstring* etag = nullptr);
+
+    /// \brief Send GET request, duplicate it if the response is slow
+    ///
+    /// If the response doesn't arrive within the delay of the hedge policy
+    /// the same request is sent using another client (if one is available
+    /// without waiting). The first successful response wins, the client of
+    /// the other request is shut down. The lease is replaced with the lease
+    /// of the winning client.
+    ss::future<http::client::response_stream_ref> hedged_get_object(
+      s3::client_pool::client_lease& lease,
+      const s3::bucket_name& bucket,
+      const s3::object_key& path,
+      ss::lowres_clock::duration timeout,
+      std::optional<s3::byte_range> range,
+      std::optional<ss::sstring> if_none_match,
+      retry_chain_node& fib);
+
+    /// Invoke the request using leased client, retry on transient errors
+    ///
+    /// The client is returned to the pool before the backoff.
+    ss::future<upload_result> upload_with_retries(
+      const s3::bucket_name& bucket,
+      const s3::object_key& path,
+      client_func func,
+      retry_chain_node& parent);
+
     s3::client_pool _pool;
+    multipart_upload_config _multipart;
+    hedge_policy _hedge;
     ss::gate _gate;
     ss::abort_source _as;
     service_probe& _probe;
@@ -0,0 +1,727 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/remote_partition.h"
+
+#include "bytes/iobuf.h"
+#include "cloud_storage/logger.h"
+#include "cloud_storage/types.h"
+#include "model/record.h"
+#include "model/timeout_clock.h"
+#include "s3/client.h"
+#include "storage/fs_utils.h"
+#include "storage/index_state.h"
+#include "storage/parser.h"
+#include "units.h"
+#include "utils/gate_guard.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/iostream.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <exception>
+
+namespace cloud_storage {
+
+/// Size of the range requested by the remote reader
+static constexpr uint64_t remote_read_chunk_size = 4_MiB;
+/// Max number of the sequential readers tracked by the partition
+static constexpr size_t max_sequential_streams = 16;
+/// Max number of the prefetched segments tracked to report the hits
+static constexpr size_t max_tracked_prefetches = 64;
+/// Weight of the new sample in the throughput averages
+static constexpr double rate_smoothing = 0.2;
+
+static double update_rate(double avg, double sample) {
+    return avg == 0 ? sample
+                    : avg * (1 - rate_smoothing) + sample * rate_smoothing;
+}
+
+/// Bytes per second, the time is rounded up to a millisecond so the
+/// instant operations don't produce infinite rates
+static double bytes_per_second(size_t bytes, ss::lowres_clock::duration d) {
+    auto ms = std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(d).count(), 1);
+    return static_cast<double>(bytes) * 1000 / static_cast<double>(ms);
+}
+
+/// Batch consumer that accepts batches from the downloaded segment
+/// using the same rules as storage::skipping_consumer
+class remote_batch_consumer final : public storage::batch_consumer {
+public:
+    remote_batch_consumer(
+      storage::log_reader_config& config,
+      model::term_id term,
+      model::record_batch_reader::data_t& out) noexcept
+      : _config(config)
+      , _term(term)
+      , _out(out) {}
+
+    consume_result
+    accept_batch_start(const model::record_batch_header& header) const final {
+        if (header.base_offset() > _config.max_offset) {
+            return consume_result::stop_parser;
+        }
+        if (
+          (_config.strict_max_bytes || _config.bytes_consumed)
+          && (_config.bytes_consumed + header.size_bytes) > _config.max_bytes) {
+            _config.over_budget = true;
+            return consume_result::stop_parser;
+        }
+        if (header.last_offset() < _config.start_offset) {
+            return consume_result::skip_batch;
+        }
+        if (_config.type_filter && _config.type_filter != header.type) {
+            _config.start_offset = header.last_offset() + model::offset(1);
+            return consume_result::skip_batch;
+        }
+        if (_config.first_timestamp > header.first_timestamp) {
+            _config.start_offset = header.last_offset() + model::offset(1);
+            return consume_result::skip_batch;
+        }
+        return consume_result::accept_batch;
+    }
+
+    void consume_batch_start(
+      model::record_batch_header header,
+      size_t /*physical_base_offset*/,
+      size_t /*size_on_disk*/) final {
+        _header = header;
+        _header.ctx.term = _term;
+    }
+
+    void skip_batch_start(
+      model::record_batch_header,
+      size_t /*physical_base_offset*/,
+      size_t /*size_on_disk*/) final {}
+
+    void consume_records(iobuf&& records) final {
+        _records = std::move(records);
+    }
+
+    stop_parser consume_batch_end() final {
+        auto last = _header.last_offset();
+        _config.start_offset = last + model::offset(1);
+        _config.bytes_consumed += _header.size_bytes;
+        _out.emplace_back(
+          _header, std::move(_records), model::record_batch::tag_ctor_ng{});
+        _header = {};
+        if (
+          last >= _config.max_offset
+          || _config.bytes_consumed >= _config.max_bytes) {
+            return stop_parser::yes;
+        }
+        return stop_parser::no;
+    }
+
+    void print(std::ostream& o) const final {
+        o << "cloud_storage::remote_batch_consumer";
+    }
+
+private:
+    storage::log_reader_config& _config;
+    model::term_id _term;
+    model::record_batch_reader::data_t& _out;
+    model::record_batch_header _header;
+    iobuf _records;
+};
+
+/// Data source that downloads the remote segment in chunks using ranged
+/// GET requests. The next chunks are requested while the current one is
+/// consumed so the parser doesn't wait for the network. If the reader stops
+/// early (e.g. because of the 'max_bytes' limit) the rest of the segment is
+/// never downloaded.
+class remote_segment_source final : public ss::data_source_impl {
+public:
+    /// \param read_ahead is a max number of chunks requested ahead
+    /// \param budget is a number of bytes the reader can consume, the
+    ///        chunks past it are not requested ahead
+    remote_segment_source(
+      remote_partition& part,
+      remote_partition::segment_lookup_result segment,
+      uint64_t start,
+      size_t read_ahead,
+      uint64_t budget,
+      retry_chain_node& fib)
+      : _partition(part)
+      , _segment(std::move(segment))
+      , _start(start)
+      , _next_pos(start)
+      , _read_ahead(std::max<size_t>(read_ahead, 1))
+      , _budget(budget)
+      , _fib(fib) {
+        prefetch();
+    }
+
+    ss::future<ss::temporary_buffer<char>> get() final {
+        if (_current.empty()) {
+            if (_next.empty()) {
+                co_return ss::temporary_buffer<char>();
+            }
+            auto f = std::move(_next.front());
+            _next.pop_front();
+            _current = co_await std::move(f);
+            prefetch();
+            if (_current.empty()) {
+                co_return ss::temporary_buffer<char>();
+            }
+        }
+        auto buf = _current.begin()->share();
+        _current.pop_front();
+        co_return buf;
+    }
+
+    ss::future<> close() final {
+        // Wait for the read-ahead requests, their results are not needed
+        while (!_next.empty()) {
+            auto f = std::move(_next.front());
+            _next.pop_front();
+            co_await std::move(f).discard_result().handle_exception(
+              [](std::exception_ptr) {});
+        }
+    }
+
+private:
+    void prefetch() {
+        const auto size = _segment.meta.size_bytes;
+        while (_next_pos < size && _next.size() < _read_ahead) {
+            if (!_next.empty() && _next_pos - _start >= _budget) {
+                // The reader stops before it gets to the chunk
+                break;
+            }
+            s3::byte_range range{
+              .first = _next_pos,
+              .last = std::min(_next_pos + remote_read_chunk_size, size) - 1,
+            };
+            _next_pos = range.last + 1;
+            _next.push_back(_partition.download_segment(_segment, _fib, range));
+        }
+    }
+
+    remote_partition& _partition;
+    remote_partition::segment_lookup_result _segment;
+    uint64_t _start;
+    uint64_t _next_pos;
+    size_t _read_ahead;
+    uint64_t _budget;
+    retry_chain_node& _fib;
+    iobuf _current;
+    std::deque<ss::future<iobuf>> _next;
+};
+
+/// Reader that iterates over remote segments one at a time
+class remote_partition_reader final : public model::record_batch_reader::impl {
+public:
+    using data_t = model::record_batch_reader::data_t;
+    using storage_t = model::record_batch_reader::storage_t;
+
+    remote_partition_reader(
+      ss::lw_shared_ptr<remote_partition> part,
+      storage::log_reader_config config) noexcept
+      : _partition(std::move(part))
+      , _config(std::move(config)) {}
+
+    bool is_end_of_stream() const final { return _done; }
+
+    ss::future<storage_t>
+    do_load_slice(model::timeout_clock::time_point deadline) final {
+        data_t batches;
+        while (batches.empty() && !_done) {
+            if (
+              _config.start_offset > _config.max_offset || _config.over_budget
+              || _config.bytes_consumed >= _config.max_bytes
+              || model::timeout_clock::now() >= deadline) {
+                _done = true;
+                break;
+            }
+            if (_partition->_gate.is_closed()) {
+                // The manifest can't be accessed after stop
+                _done = true;
+                break;
+            }
+            auto segment = _partition->find_segment(_config.start_offset);
+            if (!segment) {
+                _done = true;
+                break;
+            }
+            if (segment->meta.base_offset > _config.start_offset) {
+                // Gap in the uploaded log, continue from the next segment
+                _config.start_offset = segment->meta.base_offset;
+            }
+            bool consumed = false;
+            try {
+                consumed = co_await _partition->read_segment(
+                  *segment, _config, batches);
+            } catch (...) {
+                // The error is reported to the client as an empty read, the
+                // consumer will retry the fetch
+                vlog(
+                  cst_log.warn,
+                  "Remote read from {} at offset {} failed: {}",
+                  _partition->get_ntp(),
+                  _config.start_offset,
+                  std::current_exception());
+                _done = true;
+                break;
+            }
+            if (consumed) {
+                // Move to the next segment even if the tail of the current one
+                // was filtered out
+                _config.start_offset = std::max(
+                  _config.start_offset,
+                  segment->meta.committed_offset + model::offset(1));
+            } else {
+                _done = true;
+            }
+        }
+        co_return std::move(batches);
+    }
+
+    void print(std::ostream& o) final {
+        fmt::print(
+          o,
+          "cloud_storage::remote_partition_reader for {}, start offset {}",
+          _partition->get_ntp(),
+          _config.start_offset);
+    }
+
+private:
+    ss::lw_shared_ptr<remote_partition> _partition;
+    storage::log_reader_config _config;
+    bool _done{false};
+};
+
+remote_partition::remote_partition(
+  const manifest& m,
+  remote& api,
+  s3::bucket_name bucket,
+  ss::lowres_clock::duration timeout,
+  ss::lowres_clock::duration backoff,
+  cache* c,
+  size_t prefetch_depth)
+  : _manifest(m)
+  , _ntp(m.get_ntp())
+  , _api(api)
+  , _bucket(std::move(bucket))
+  , _timeout(timeout)
+  , _backoff(backoff)
+  , _cache(c)
+  , _max_prefetch_depth(prefetch_depth)
+  , _rtcnode(_as) {}
+
+ss::future<> remote_partition::stop() {
+    _as.request_abort();
+    return _gate.close();
+}
+
+const model::ntp& remote_partition::get_ntp() const { return _ntp; }
+
+std::optional<model::offset> remote_partition::first_uploaded_offset() const {
+    if (_gate.is_closed() || _manifest.size() == 0) {
+        return std::nullopt;
+    }
+    auto it = std::min_element(
+      _manifest.begin(), _manifest.end(), [](const auto& lhs, const auto& rhs) {
+          return lhs.second.base_offset < rhs.second.base_offset;
+      });
+    return it->second.base_offset;
+}
+
+std::optional<model::offset> remote_partition::last_uploaded_offset() const {
+    if (_gate.is_closed() || _manifest.size() == 0) {
+        return std::nullopt;
+    }
+    return _manifest.get_last_offset();
+}
+
+bool remote_partition::is_data_available(model::offset o) const {
+    auto first = first_uploaded_offset();
+    auto last = last_uploaded_offset();
+    return first && last && *first <= o && o <= *last;
+}
+
+std::optional<remote_partition::segment_lookup_result>
+remote_partition::find_segment(model::offset o) const {
+    // The manifest is ordered by segment name which doesn't match the
+    // offset order so we have to scan it. The number of segments is
+    // expected to be small relative to the cost of the download.
+    std::optional<segment_lookup_result> result;
+    for (const auto& [name, meta] : _manifest) {
+        if (meta.committed_offset < o) {
+            continue;
+        }
+        if (meta.base_offset <= o) {
+            return segment_lookup_result{.name = name, .meta = meta};
+        }
+        if (!result || meta.base_offset < result->meta.base_offset) {
+            result = segment_lookup_result{.name = name, .meta = meta};
+        }
+    }
+    return result;
+}
+
+ss::future<iobuf> remote_partition::download_segment(
+  const segment_lookup_result& segment,
+  retry_chain_node& fib,
+  std::optional<s3::byte_range> range) {
+    iobuf data;
+    auto consume_str =
+      [&data](ss::input_stream<char> is) -> ss::future<uint64_t> {
+        data.clear();
+        auto os = make_iobuf_ref_output_stream(data);
+        co_await ss::copy(is, os);
+        co_return data.size_bytes();
+    };
+    auto start = ss::lowres_clock::now();
+    auto res = co_await _api.download_segment(
+      _bucket, segment.name, _manifest, consume_str, fib, range);
+    if (res != download_result::success) {
+        throw_download_error(segment, res, fib);
+    }
+    record_download(data.size_bytes(), ss::lowres_clock::now() - start);
+    co_return data;
+}
+
+ss::future<uint64_t> remote_partition::find_start_position(
+  const segment_lookup_result& segment,
+  const storage::log_reader_config& config,
+  retry_chain_node& fib) {
+    if (
+      !segment.meta.has_index
+      || config.start_offset <= segment.meta.base_offset) {
+        co_return 0;
+    }
+    iobuf data;
+    auto consume_str =
+      [&data](ss::input_stream<char> is) -> ss::future<uint64_t> {
+        data.clear();
+        auto os = make_iobuf_ref_output_stream(data);
+        co_await ss::copy(is, os);
+        co_return data.size_bytes();
+    };
+    auto res = co_await _api.download_segment_index(
+      _bucket, segment.name, _manifest, consume_str, fib);
+    if (res != download_result::success) {
+        // The index is an optimization, the segment can be scanned from
+        // the beginning
+        vlog(
+          cst_log.debug,
+          "{} Can't download index of the segment {}, result {}",
+          fib(),
+          segment.name,
+          static_cast<int32_t>(res));
+        co_return 0;
+    }
+    auto ix = storage::index_state::hydrate_from_buffer(std::move(data));
+    if (!ix || ix->base_offset != segment.meta.base_offset) {
+        vlog(
+          cst_log.warn,
+          "{} Index of the segment {} is invalid",
+          fib(),
+          segment.name);
+        co_return 0;
+    }
+    // Entries are ordered by offset, pick the last one that doesn't skip
+    // the batches requested by the reader
+    uint64_t pos = 0;
+    for (size_t i = 0; i < ix->relative_offset_index.size(); i++) {
+        auto o = ix->base_offset
+                 + model::offset(ix->relative_offset_index[i]);
+        auto ts = model::timestamp(
+          ix->base_timestamp() + ix->relative_time_index[i]);
+        if (
+          o > config.start_offset
+          || (config.first_timestamp && ts >= *config.first_timestamp)) {
+            break;
+        }
+        pos = ix->position_index[i];
+    }
+    vlog(
+      cst_log.debug,
+      "{} Start reading remote segment {} from position {}",
+      fib(),
+      segment.name,
+      pos);
+    co_return pos;
+}
+
+ss::future<std::optional<cache::item>> remote_partition::hydrate_segment(
+  const segment_lookup_result& segment, retry_chain_node& fib) {
+    auto key = _manifest.get_remote_segment_path(segment.name);
+    auto item = co_await _cache->get(key());
+    if (_prefetched.erase(ss::sstring(key().string())) && item) {
+        _api.get_probe().prefetch_hit();
+    }
+    if (item) {
+        co_return item;
+    }
+    co_await download_to_cache(segment, fib);
+    // The object might be evicted right after the hydration if the cache
+    // is too small, the caller falls back to the in-memory download
+    co_return co_await _cache->get(key());
+}
+
+ss::future<> remote_partition::download_to_cache(
+  const segment_lookup_result& segment, retry_chain_node& fib) {
+    auto key = _manifest.get_remote_segment_path(segment.name);
+    co_await _cache->hydrate(key(), [this, &segment, &fib, key] {
+        auto consume_str =
+          [this, key](ss::input_stream<char> is) -> ss::future<uint64_t> {
+            co_return co_await _cache->put(key(), is);
+        };
+        auto start = ss::lowres_clock::now();
+        return _api
+          .download_segment(_bucket, segment.name, _manifest, consume_str, fib)
+          .then([this, &segment, &fib, start](download_result res) {
+              if (res != download_result::success) {
+                  throw_download_error(segment, res, fib);
+              }
+              record_download(
+                segment.meta.size_bytes, ss::lowres_clock::now() - start);
+          });
+    });
+}
+
+void remote_partition::record_download(
+  size_t bytes, ss::lowres_clock::duration elapsed) {
+    _download_rate = update_rate(
+      _download_rate, bytes_per_second(bytes, elapsed));
+}
+
+remote_partition::sequential_stream*
+remote_partition::find_stream(model::offset start) {
+    auto it = std::find_if(
+      _streams.begin(), _streams.end(), [start](const sequential_stream& s) {
+          return s.next_offset == start;
+      });
+    return it == _streams.end() ? nullptr : &*it;
+}
+
+void remote_partition::update_stream(
+  model::offset start,
+  model::offset next_offset,
+  size_t bytes,
+  ss::lowres_clock::time_point started) {
+    auto now = ss::lowres_clock::now();
+    auto* stream = find_stream(start);
+    if (stream == nullptr) {
+        // The read might be the first one of a sequential reader
+        if (_streams.size() < max_sequential_streams) {
+            stream = &_streams.emplace_back();
+        } else {
+            stream = &*std::min_element(
+              _streams.begin(),
+              _streams.end(),
+              [](const sequential_stream& a, const sequential_stream& b) {
+                  return a.last_read < b.last_read;
+              });
+            *stream = sequential_stream{};
+        }
+        stream->next_offset = next_offset;
+        stream->last_read = now;
+        return;
+    }
+    // The time the reader spent between the reads is what it needs to
+    // process the data, the data should be fetched at the same pace
+    stream->read_rate = update_rate(
+      stream->read_rate, bytes_per_second(bytes, started - stream->last_read));
+    stream->next_offset = next_offset;
+    stream->last_read = now;
+    // Every segment fetched ahead is downloaded at '_download_rate', the
+    // reader needs as many concurrent downloads as the ratio of the rates
+    stream->depth = 1;
+    if (_download_rate > 0) {
+        auto ratio = std::ceil(stream->read_rate / _download_rate);
+        stream->depth = std::clamp<size_t>(
+          static_cast<size_t>(std::min<double>(ratio, _max_prefetch_depth)),
+          1,
+          _max_prefetch_depth);
+    }
+    _api.get_probe().prefetch_depth(stream->depth);
+}
+
+void remote_partition::prefetch_segments(
+  const segment_lookup_result& segment, size_t depth) {
+    auto next = segment;
+    for (size_t i = 0; i < depth && !_gate.is_closed(); i++) {
+        auto s = find_segment(
+          next.meta.committed_offset + model::offset(1));
+        if (!s) {
+            return;
+        }
+        next = std::move(*s);
+        auto key = _manifest.get_remote_segment_path(next.name);
+        auto name = ss::sstring(key().string());
+        if (_prefetching.contains(name) || _cache->contains(key())) {
+            continue;
+        }
+        _prefetching.insert(name);
+        _api.get_probe().segment_prefetch();
+        (void)ss::with_gate(
+          _gate, [this, next] { return prefetch_segment(next); });
+    }
+}
+
+ss::future<> remote_partition::prefetch_segment(segment_lookup_result segment) {
+    auto name = ss::sstring(
+      _manifest.get_remote_segment_path(segment.name)().string());
+    retry_chain_node fib(_timeout, _backoff, &_rtcnode);
+    vlog(
+      cst_log.debug,
+      "{} Prefetching remote segment {} of {}",
+      fib(),
+      segment.name,
+      get_ntp());
+    try {
+        co_await download_to_cache(segment, fib);
+        if (_prefetched.size() < max_tracked_prefetches) {
+            _prefetched.insert(name);
+        }
+    } catch (...) {
+        vlog(
+          cst_log.debug,
+          "{} Prefetch of remote segment {} failed: {}",
+          fib(),
+          segment.name,
+          std::current_exception());
+    }
+    _prefetching.erase(name);
+}
+
+void remote_partition::throw_download_error(
+  const segment_lookup_result& segment,
+  download_result res,
+  retry_chain_node& fib) const {
+    vlog(
+      cst_log.warn,
+      "{} Failed to download remote segment {} of {}, result {}",
+      fib(),
+      segment.name,
+      get_ntp(),
+      static_cast<int32_t>(res));
+    throw std::runtime_error(fmt::format(
+      "failed to download remote segment {} of {}", segment.name, get_ntp()));
+}
+
+ss::future<bool> remote_partition::read_segment(
+  const segment_lookup_result& segment,
+  storage::log_reader_config& config,
+  data_t& out) {
+    gate_guard guard{_gate};
+    retry_chain_node fib(_timeout, _backoff, &_rtcnode);
+    vlog(
+      cst_log.debug,
+      "{} Reading remote segment {} of {} starting from offset {}",
+      fib(),
+      segment.name,
+      get_ntp(),
+      config.start_offset);
+
+    auto started = ss::lowres_clock::now();
+    auto start_offset = config.start_offset;
+    auto start_bytes = config.bytes_consumed;
+    size_t read_ahead = 1;
+    if (_max_prefetch_depth > 0) {
+        if (auto s = find_stream(start_offset); s != nullptr) {
+            read_ahead = s->depth;
+            if (_cache) {
+                prefetch_segments(segment, read_ahead);
+            }
+        }
+    }
+
+    std::optional<cache::item> cached;
+    if (_cache) {
+        cached = co_await hydrate_segment(segment, fib);
+    }
+    std::optional<ss::input_stream<char>> stream;
+    if (cached) {
+        stream = ss::make_file_input_stream(cached->body, 0, cached->size);
+    } else if (segment.meta.size_bytes > 0) {
+        auto start = co_await find_start_position(segment, config, fib);
+        auto budget = config.max_bytes > config.bytes_consumed
+                        ? config.max_bytes - config.bytes_consumed
+                        : 0;
+        stream = ss::input_stream<char>(
+          ss::data_source(std::make_unique<remote_segment_source>(
+            *this, segment, start, read_ahead, budget, fib)));
+    } else {
+        // The size is unknown, download the whole object
+        stream = make_iobuf_input_stream(
+          co_await download_segment(segment, fib));
+    }
+
+    model::term_id term{};
+    if (auto parsed = storage::segment_path::parse_segment_filename(
+          segment.name());
+        parsed) {
+        term = parsed->term;
+    }
+
+    auto num_batches = out.size();
+    storage::continuous_batch_parser parser(
+      std::make_unique<remote_batch_consumer>(config, term, out),
+      std::move(*stream));
+    auto parsed = co_await parser.consume().finally([&parser, &cached] {
+        return parser.close().then([&cached] {
+            return cached ? cached->body.close() : ss::now();
+        });
+    });
+    if (!parsed) {
+        vlog(
+          cst_log.error,
+          "{} Can't parse remote segment {} of {}, error {}",
+          fib(),
+          segment.name,
+          get_ntp(),
+          parsed.error().message());
+        throw std::runtime_error(fmt::format(
+          "failed to parse remote segment {} of {}: {}",
+          segment.name,
+          get_ntp(),
+          parsed.error().message()));
+    }
+    vlog(
+      cst_log.debug,
+      "{} Read {} batches from remote segment {}",
+      fib(),
+      out.size() - num_batches,
+      segment.name);
+    bool consumed = config.start_offset <= config.max_offset
+                    && !config.over_budget
+                    && config.bytes_consumed < config.max_bytes;
+    if (_max_prefetch_depth > 0) {
+        auto next_offset = config.start_offset;
+        if (consumed) {
+            // The reader moves to the next segment
+            next_offset = std::max(
+              next_offset, segment.meta.committed_offset + model::offset(1));
+        }
+        update_stream(
+          start_offset,
+          next_offset,
+          config.bytes_consumed - start_bytes,
+          started);
+    }
+    co_return consumed;
+}
+
+ss::future<model::record_batch_reader>
+remote_partition::make_reader(storage::log_reader_config config) {
+    return ss::make_ready_future<model::record_batch_reader>(
+      model::make_record_batch_reader<remote_partition_reader>(
+        shared_from_this(), std::move(config)));
+}
+
+} // namespace cloud_storage
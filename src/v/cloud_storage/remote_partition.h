@@ -0,0 +1,233 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#pragma once
+
+#include "bytes/iobuf.h"
+#include "cloud_storage/cache_service.h"
+#include "cloud_storage/manifest.h"
+#include "cloud_storage/remote.h"
+#include "cloud_storage/types.h"
+#include "model/fundamental.h"
+#include "model/record_batch_reader.h"
+#include "s3/client.h"
+#include "storage/types.h"
+#include "utils/retry_chain_node.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include <absl/container/flat_hash_set.h>
+
+#include <optional>
+#include <vector>
+
+namespace cloud_storage {
+
+/// \brief Read-only view of the part of the partition's log which is stored
+///        in S3
+///
+/// The remote partition uses the manifest to locate the segment that
+/// contains requested offset and the 'remote' to download it. The manifest
+/// is owned by the archiver and is updated after every successful upload so
+/// the view always reflects the latest uploaded state. The segments might be
+/// already removed from the local storage by retention.
+///
+/// Readers that continue from the offset where the previous reader stopped
+/// (the fetches of a consumer that replays the history) are detected. The
+/// segments that follow the one they read are downloaded to the cache in
+/// background, or more ranges of the segment are requested ahead if the
+/// cache is disabled. The number of segments fetched ahead follows the
+/// ratio of the consumer throughput and the download throughput.
+///
+/// \note Offsets used by this class are log (raft) offsets. Translation to
+///       kafka offsets is a responsibility of the caller.
+class remote_partition
+  : public ss::enable_lw_shared_from_this<remote_partition> {
+public:
+    /// C-tor
+    ///
+    /// \param m is a manifest of the partition, it should outlive the
+    ///        object or at least the call to 'stop'
+    /// \param api is a remote endpoint used to download the data
+    /// \param bucket is a bucket that contains the segments
+    /// \param timeout is a segment download timeout
+    /// \param backoff is an initial backoff interval for the downloads
+    /// \param c is an optional segment cache, if it's not set the segments
+    ///        are downloaded to memory on every read
+    /// \param prefetch_depth is a max number of segments (or ranges if the
+    ///        cache is not set) fetched ahead of a sequential reader, 0
+    ///        disables the prefetch
+    remote_partition(
+      const manifest& m,
+      remote& api,
+      s3::bucket_name bucket,
+      ss::lowres_clock::duration timeout,
+      ss::lowres_clock::duration backoff,
+      cache* c = nullptr,
+      size_t prefetch_depth = 0);
+
+    /// Stop the partition, wait for all outstanding reads to complete
+    ///
+    /// \note after this call the manifest is no longer accessed and
+    ///       all methods behave as if the partition has no uploaded data
+    ss::future<> stop();
+
+    const model::ntp& get_ntp() const;
+
+    /// Return first offset available in S3 or nullopt if the partition
+    /// has no uploaded segments
+    std::optional<model::offset> first_uploaded_offset() const;
+
+    /// Return last offset available in S3 or nullopt if the partition
+    /// has no uploaded segments
+    std::optional<model::offset> last_uploaded_offset() const;
+
+    /// Return true if the offset is in the range of uploaded offsets
+    bool is_data_available(model::offset o) const;
+
+    /// \brief Create a reader that fetches data from S3
+    ///
+    /// The reader transparently moves from one remote segment to the next
+    /// one until it reaches 'max_offset' of the config or runs out of the
+    /// 'max_bytes' budget. Unlike the local log reader it never reads past
+    /// the last uploaded offset.
+    ss::future<model::record_batch_reader>
+    make_reader(storage::log_reader_config config);
+
+private:
+    friend class remote_partition_reader;
+    friend class remote_segment_source;
+
+    using data_t = model::record_batch_reader::data_t;
+
+    struct segment_lookup_result {
+        segment_name name;
+        manifest::segment_meta meta;
+    };
+
+    /// Find the uploaded segment that contains the offset or the first
+    /// segment after it if the offset falls into the gap
+    std::optional<segment_lookup_result> find_segment(model::offset o) const;
+
+    /// Download the segment (or the range of bytes of the segment) to memory
+    ss::future<iobuf> download_segment(
+      const segment_lookup_result& segment,
+      retry_chain_node& fib,
+      std::optional<s3::byte_range> range = std::nullopt);
+
+    /// Get the segment from the cache, download it to the cache on miss
+    ///
+    /// \return opened cache file or nullopt if the segment can't be cached
+    ss::future<std::optional<cache::item>> hydrate_segment(
+      const segment_lookup_result& segment, retry_chain_node& fib);
+
+    /// Download the segment to the cache, concurrent downloads of the same
+    /// segment are coalesced
+    ss::future<> download_to_cache(
+      const segment_lookup_result& segment, retry_chain_node& fib);
+
+    /// Reader that starts where the previous one stopped
+    struct sequential_stream {
+        /// Offset the next read of the stream is expected to start from
+        model::offset next_offset;
+        /// Time the last read of the stream completed
+        ss::lowres_clock::time_point last_read;
+        /// Throughput of the reader in bytes per second
+        double read_rate{0};
+        /// Number of segments or ranges fetched ahead of the reader
+        size_t depth{1};
+    };
+
+    /// Find the sequential stream that expects the read to start from the
+    /// offset
+    ///
+    /// \return the stream or nullptr if the read is not sequential
+    sequential_stream* find_stream(model::offset start);
+
+    /// \brief Register the completed read
+    ///
+    /// The stream is created if the read is not sequential, otherwise the
+    /// throughput of the reader and the prefetch depth are updated.
+    /// \param start is the offset the read started from
+    /// \param next_offset is the offset the next read of the reader is
+    ///        expected to start from
+    /// \param bytes is a number of bytes the read returned
+    /// \param started is the time the read started
+    void update_stream(
+      model::offset start,
+      model::offset next_offset,
+      size_t bytes,
+      ss::lowres_clock::time_point started);
+
+    /// Start the download of the segments that follow 'segment' to the
+    /// cache in background
+    void prefetch_segments(const segment_lookup_result& segment, size_t depth);
+
+    /// Download the segment ahead of the reader, errors are logged and
+    /// ignored
+    ss::future<> prefetch_segment(segment_lookup_result segment);
+
+    /// Record the throughput of the segment download
+    void record_download(size_t bytes, ss::lowres_clock::duration elapsed);
+
+    /// \brief Find the position inside the segment to start reading from
+    ///
+    /// Uses the uploaded segment index to skip the batches that precede
+    /// the start offset (or the first timestamp) of the reader.
+    /// \return file position or 0 if the segment has no index
+    ss::future<uint64_t> find_start_position(
+      const segment_lookup_result& segment,
+      const storage::log_reader_config& config,
+      retry_chain_node& fib);
+
+    [[noreturn]] void throw_download_error(
+      const segment_lookup_result& segment,
+      download_result res,
+      retry_chain_node& fib) const;
+
+    /// Read the segment and append all batches that match the config
+    /// to the 'out' buffer. The config is updated to reflect the progress.
+    /// The segment is read from the cache if it's enabled, otherwise it's
+    /// streamed from S3 using ranged requests with read-ahead starting from
+    /// the position found using the segment index.
+    ///
+    /// \return true if the segment was consumed completely, false if the
+    ///         parser was stopped by the limits of the config
+    ss::future<bool> read_segment(
+      const segment_lookup_result& segment,
+      storage::log_reader_config& config,
+      data_t& out);
+
+    const manifest& _manifest;
+    model::ntp _ntp;
+    remote& _api;
+    s3::bucket_name _bucket;
+    ss::lowres_clock::duration _timeout;
+    ss::lowres_clock::duration _backoff;
+    cache* _cache;
+    size_t _max_prefetch_depth;
+    /// Recently seen readers, the least recently used one is replaced by
+    /// the new reader
+    std::vector<sequential_stream> _streams;
+    /// Download throughput in bytes per second
+    double _download_rate{0};
+    /// Segments that are being prefetched
+    absl::flat_hash_set<ss::sstring> _prefetching;
+    /// Prefetched segments that weren't read yet
+    absl::flat_hash_set<ss::sstring> _prefetched;
+    ss::gate _gate;
+    ss::abort_source _as;
+    retry_chain_node _rtcnode;
+};
+
+} // namespace cloud_storage
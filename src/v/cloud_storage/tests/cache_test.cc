@@ -0,0 +1,152 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "bytes/iobuf.h"
+#include "bytes/iobuf_parser.h"
+#include "cloud_storage/cache_service.h"
+#include "random/generators.h"
+#include "seastarx.h"
+#include "ssx/sformat.h"
+
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/defer.hh>
+
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+
+using namespace cloud_storage;
+
+static std::filesystem::path make_cache_dir() {
+    auto name = ssx::sformat(
+      "cache_test_{}", random_generators::gen_alphanum_string(8));
+    return std::filesystem::path(name.c_str());
+}
+
+static void put(cache& c, const std::filesystem::path& key, size_t size) {
+    iobuf buf;
+    auto payload = random_generators::gen_alphanum_string(size);
+    buf.append(payload.data(), payload.size());
+    auto is = make_iobuf_input_stream(std::move(buf));
+    c.put(key, is).get();
+}
+
+static ss::sstring read(cache::item item) {
+    auto is = ss::make_file_input_stream(item.body, 0, item.size);
+    iobuf buf;
+    auto os = make_iobuf_ref_output_stream(buf);
+    ss::copy(is, os).get();
+    is.close().get();
+    item.body.close().get();
+    iobuf_parser p(std::move(buf));
+    return p.read_string(p.bytes_left());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_put_get) {
+    auto dir = make_cache_dir();
+    auto cleanup = ss::defer([dir] { std::filesystem::remove_all(dir); });
+    cache c(dir, 1000, cache_metrics_disabled::yes);
+    c.start().get();
+    std::filesystem::path key = "prefix/kafka/topic/0_1/0-1-v1.log";
+    BOOST_REQUIRE(!c.get(key).get().has_value());
+    put(c, key, 100);
+    BOOST_REQUIRE(c.contains(key));
+    BOOST_REQUIRE_EQUAL(c.size_bytes(), 100);
+    auto item = c.get(key).get();
+    BOOST_REQUIRE(item.has_value());
+    BOOST_REQUIRE_EQUAL(item->size, 100);
+    BOOST_REQUIRE_EQUAL(read(std::move(*item)).size(), 100);
+    BOOST_REQUIRE_EQUAL(c.get_probe().get_cache_hits(), 1);
+    BOOST_REQUIRE_EQUAL(c.get_probe().get_cache_misses(), 1);
+    c.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_lru_eviction) {
+    auto dir = make_cache_dir();
+    auto cleanup = ss::defer([dir] { std::filesystem::remove_all(dir); });
+    cache c(dir, 300, cache_metrics_disabled::yes);
+    c.start().get();
+    put(c, "a", 100);
+    put(c, "b", 100);
+    put(c, "c", 100);
+    // make 'a' the most recently used object
+    auto item = c.get("a").get();
+    BOOST_REQUIRE(item.has_value());
+    item->body.close().get();
+    put(c, "d", 100);
+    BOOST_REQUIRE(c.contains("a"));
+    BOOST_REQUIRE(!c.contains("b"));
+    BOOST_REQUIRE(c.contains("c"));
+    BOOST_REQUIRE(c.contains("d"));
+    BOOST_REQUIRE_EQUAL(c.size_bytes(), 300);
+    BOOST_REQUIRE_EQUAL(c.get_probe().get_evictions(), 1);
+    BOOST_REQUIRE(!ss::file_exists((dir / "b").string()).get());
+    c.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_reindex_on_start) {
+    auto dir = make_cache_dir();
+    auto cleanup = ss::defer([dir] { std::filesystem::remove_all(dir); });
+    {
+        cache c(dir, 1000, cache_metrics_disabled::yes);
+        c.start().get();
+        put(c, "x/y", 100);
+        put(c, "x/z", 200);
+        c.stop().get();
+    }
+    // leftover from the interrupted write
+    ss::open_file_dma(
+      (dir / "partial.part").string(),
+      ss::open_flags::wo | ss::open_flags::create)
+      .then([](ss::file f) { return f.close(); })
+      .get();
+    cache c(dir, 1000, cache_metrics_disabled::yes);
+    c.start().get();
+    BOOST_REQUIRE(c.contains("x/y"));
+    BOOST_REQUIRE(c.contains("x/z"));
+    BOOST_REQUIRE_EQUAL(c.size_bytes(), 300);
+    BOOST_REQUIRE(!ss::file_exists((dir / "partial.part").string()).get());
+    c.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_hydration_coalescing) {
+    auto dir = make_cache_dir();
+    auto cleanup = ss::defer([dir] { std::filesystem::remove_all(dir); });
+    cache c(dir, 1000, cache_metrics_disabled::yes);
+    c.start().get();
+    int num_downloads = 0;
+    ss::promise<> download_started;
+    ss::promise<> download_done;
+    auto fn = [&] {
+        num_downloads++;
+        download_started.set_value();
+        return download_done.get_future().then([&c] {
+            iobuf buf;
+            buf.append("data", 4);
+            return ss::do_with(
+              make_iobuf_input_stream(std::move(buf)),
+              [&c](ss::input_stream<char>& is) {
+                  return c.put("key", is).discard_result();
+              });
+        });
+    };
+    auto first = c.hydrate("key", fn);
+    download_started.get_future().get();
+    auto second = c.hydrate("key", fn);
+    download_done.set_value();
+    first.get();
+    second.get();
+    BOOST_REQUIRE_EQUAL(num_downloads, 1);
+    BOOST_REQUIRE_EQUAL(c.get_probe().get_coalesced_hydrations(), 1);
+    BOOST_REQUIRE(c.contains("key"));
+    c.stop().get();
+}
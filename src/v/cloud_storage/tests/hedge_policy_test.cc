@@ -0,0 +1,60 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/hedge_policy.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+using namespace cloud_storage;
+
+static void record_latencies(hedge_policy& p, size_t n) {
+    // 10ms..160ms, uniformly
+    for (size_t i = 0; i < n; i++) {
+        p.record_latency(hedge_policy::duration(((i % 16) + 1) * 10));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_hedge_policy_disabled) {
+    hedge_policy p(hedged_download_config{.budget_percent = 0});
+    record_latencies(p, hedge_policy::max_samples);
+    BOOST_REQUIRE(!p.hedge_delay());
+}
+
+BOOST_AUTO_TEST_CASE(test_hedge_policy_percentile) {
+    hedge_policy p(hedged_download_config{
+      .percentile = 0.9, .budget_percent = 5, .min_delay = 1ms});
+    record_latencies(p, 16);
+    BOOST_REQUIRE(!p.hedge_delay());
+    record_latencies(p, hedge_policy::max_samples - 16);
+    BOOST_REQUIRE(p.hedge_delay() == 150ms);
+}
+
+BOOST_AUTO_TEST_CASE(test_hedge_policy_min_delay) {
+    hedge_policy p(hedged_download_config{
+      .percentile = 0.5, .budget_percent = 5, .min_delay = 100ms});
+    record_latencies(p, hedge_policy::max_samples);
+    BOOST_REQUIRE(p.hedge_delay() == 100ms);
+}
+
+BOOST_AUTO_TEST_CASE(test_hedge_policy_budget) {
+    hedge_policy p(hedged_download_config{.budget_percent = 10});
+    size_t hedges = 0;
+    for (int i = 0; i < 1000; i++) {
+        p.register_request();
+        if (p.try_hedge()) {
+            hedges++;
+        }
+    }
+    BOOST_REQUIRE_EQUAL(hedges, 100);
+    BOOST_REQUIRE(!p.try_hedge());
+}
@@ -13,6 +13,7 @@
 #include "cloud_storage/manifest.h"
 #include "model/metadata.h"
 #include "seastarx.h"
+#include "ssx/sformat.h"
 
 #include <seastar/core/future.hh>
 #include <seastar/core/iostream.hh>
@@ -22,6 +23,7 @@
 #include <seastar/testing/thread_test_case.hh>
 #include <seastar/util/defer.hh>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/test/tools/old/interface.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -83,6 +85,31 @@ SEASTAR_THREAD_TEST_CASE(test_segment_path) {
     BOOST_REQUIRE_EQUAL(path, "2bea9275/test-ns/test-topic/42_0/22-11-v1.log");
 }
 
+SEASTAR_THREAD_TEST_CASE(test_compacted_segment_path) {
+    manifest m(manifest_ntp, model::revision_id(0));
+    auto name = segment_name("22-11-v1.log");
+    manifest::segment_meta meta{
+      .is_compacted = false,
+      .size_bytes = 1024,
+      .base_offset = model::offset(22),
+      .committed_offset = model::offset(41)};
+    m.add(name, meta);
+    auto path = m.get_remote_segment_path(name);
+    BOOST_REQUIRE_EQUAL(path, m.get_remote_segment_path(name, meta));
+    BOOST_REQUIRE(
+      boost::algorithm::ends_with(path().string(), "/42_0/22-11-v1.log"));
+
+    // the compacted replacement doesn't overwrite the replaced object
+    meta.is_compacted = true;
+    auto compacted = m.get_remote_segment_path(name, meta);
+    BOOST_REQUIRE(compacted != path);
+    BOOST_REQUIRE(boost::algorithm::ends_with(
+      compacted().string(), "/42_0/22-11-v1.log.41"));
+    m.delete_permanently(name);
+    m.add(name, meta);
+    BOOST_REQUIRE_EQUAL(m.get_remote_segment_path(name), compacted);
+}
+
 SEASTAR_THREAD_TEST_CASE(test_empty_manifest_update) {
     manifest m;
     m.update(make_manifest_stream(empty_manifest_json)).get0();
@@ -147,6 +174,42 @@ SEASTAR_THREAD_TEST_CASE(test_manifest_serialization) {
     BOOST_REQUIRE(m == restored);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_manifest_serialization_with_index) {
+    manifest m(manifest_ntp, model::revision_id(0));
+    m.add(
+      segment_name("10-1-v1.log"),
+      {
+        .is_compacted = false,
+        .size_bytes = 1024,
+        .base_offset = model::offset(10),
+        .committed_offset = model::offset(19),
+        .base_timestamp = model::timestamp(1000),
+        .max_timestamp = model::timestamp(2000),
+        .has_index = true,
+      });
+    auto [is, size] = m.serialize();
+    iobuf buf;
+    auto os = make_iobuf_ref_output_stream(buf);
+    ss::copy(is, os).get();
+
+    auto rstr = make_iobuf_input_stream(std::move(buf));
+    manifest restored;
+    restored.update(std::move(rstr)).get0();
+
+    BOOST_REQUIRE(m == restored);
+    auto meta = restored.get(segment_name("10-1-v1.log"));
+    BOOST_REQUIRE(meta != nullptr);
+    BOOST_REQUIRE(meta->has_index);
+    BOOST_REQUIRE_EQUAL(meta->base_timestamp, model::timestamp(1000));
+    BOOST_REQUIRE_EQUAL(meta->max_timestamp, model::timestamp(2000));
+    auto segment_path = restored.get_remote_segment_path(
+      segment_name("10-1-v1.log"));
+    auto index_path = restored.get_remote_segment_index_path(
+      segment_name("10-1-v1.log"));
+    BOOST_REQUIRE_EQUAL(
+      index_path().string(), segment_path().string() + ".index");
+}
+
 SEASTAR_THREAD_TEST_CASE(test_manifest_difference) {
     manifest a(manifest_ntp, model::revision_id(0));
     a.add(segment_name("0-0-1.log"), {});
@@ -169,3 +232,90 @@ SEASTAR_THREAD_TEST_CASE(test_manifest_difference) {
         BOOST_REQUIRE(c.size() == 0);
     }
 }
+
+static manifest make_manifest_with_segments(size_t num_segments) {
+    manifest m(manifest_ntp, model::revision_id(0));
+    for (size_t i = 0; i < num_segments; i++) {
+        auto base = model::offset(static_cast<int64_t>(i * 10));
+        m.add(
+          segment_name(ssx::sformat("{}-1-v1.log", base())),
+          {
+            .is_compacted = false,
+            .size_bytes = 1024,
+            .base_offset = base,
+            .committed_offset = base + model::offset(9),
+            .base_timestamp = model::timestamp(base()),
+            .max_timestamp = model::timestamp(base() + 9),
+            .has_index = i % 2 == 0,
+          });
+    }
+    return m;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_binary_manifest_serialization) {
+    auto m = make_manifest_with_segments(10);
+    manifest restored;
+    restored.update_binary(m.serialize_binary());
+    BOOST_REQUIRE(m == restored);
+    BOOST_REQUIRE_EQUAL(
+      restored.get_binary_manifest_path(),
+      "20000000/meta/test-ns/test-topic/42_0/manifest.bin");
+}
+
+SEASTAR_THREAD_TEST_CASE(test_binary_manifest_spillover) {
+    auto m = make_manifest_with_segments(10);
+    BOOST_REQUIRE(!m.get_spillover_candidate(10).has_value());
+    auto sp = m.get_spillover_candidate(4);
+    BOOST_REQUIRE(sp.has_value());
+    // half of the budget is left for the new segments
+    BOOST_REQUIRE_EQUAL(sp->num_segments, 8);
+    BOOST_REQUIRE_EQUAL(sp->base_offset, model::offset(0));
+    BOOST_REQUIRE_EQUAL(sp->committed_offset, model::offset(79));
+    auto spillover = m.serialize_spillover(*sp);
+    m.add_spillover(*sp);
+    BOOST_REQUIRE(!m.get_spillover_candidate(4).has_value());
+
+    auto head = m.serialize_binary();
+    manifest restored;
+    restored.update_binary(head.copy());
+    BOOST_REQUIRE_EQUAL(restored.size(), 2);
+    BOOST_REQUIRE_EQUAL(restored.get_spillover().size(), 1);
+    restored.update_spillover(std::move(spillover));
+    BOOST_REQUIRE(m == restored);
+
+    // the head doesn't contain spilled segments
+    auto full = make_manifest_with_segments(10).serialize_binary();
+    BOOST_REQUIRE(head.size_bytes() < full.size_bytes());
+
+    // deletion of the spilled segment moves the range back to the head
+    BOOST_REQUIRE(m.delete_permanently(segment_name("0-1-v1.log")));
+    BOOST_REQUIRE(m.get_spillover().empty());
+    manifest after_delete;
+    after_delete.update_binary(m.serialize_binary());
+    BOOST_REQUIRE_EQUAL(after_delete.size(), 9);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_manifest_expired_segments) {
+    // 10 segments of 1024 bytes, timestamps 0-9, 10-19, ...
+    auto m = make_manifest_with_segments(10);
+    BOOST_REQUIRE(
+      m.get_expired_segments(std::nullopt, std::nullopt, 100).empty());
+
+    // size based, the rest of the log stays above the limit
+    auto by_size = m.get_expired_segments(4096, std::nullopt, 100);
+    BOOST_REQUIRE_EQUAL(by_size.size(), 6);
+    BOOST_REQUIRE_EQUAL(by_size.front(), segment_name("0-1-v1.log"));
+    BOOST_REQUIRE_EQUAL(by_size.back(), segment_name("50-1-v1.log"));
+
+    // time based, only the segments with all data older than the limit
+    auto by_time = m.get_expired_segments(
+      std::nullopt, model::timestamp(25), 100);
+    BOOST_REQUIRE_EQUAL(by_time.size(), 2);
+    BOOST_REQUIRE_EQUAL(by_time.back(), segment_name("10-1-v1.log"));
+
+    // the number of segments is capped and the last one is never expired
+    BOOST_REQUIRE_EQUAL(
+      m.get_expired_segments(std::nullopt, model::timestamp(1000), 3).size(),
+      3);
+    BOOST_REQUIRE_EQUAL(m.get_expired_segments(0, std::nullopt, 100).size(), 9);
+}
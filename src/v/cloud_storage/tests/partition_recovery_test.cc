@@ -0,0 +1,80 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/manifest.h"
+#include "cloud_storage/partition_recovery_manager.h"
+#include "model/metadata.h"
+#include "seastarx.h"
+#include "ssx/sformat.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace cloud_storage;
+
+static const model::ntp manifest_ntp(
+  model::ns("test-ns"), model::topic("test-topic"), model::partition_id(42));
+
+static void add_segment(manifest& m, int64_t base, int64_t last) {
+    m.add(
+      segment_name(ssx::sformat("{}-1-v1.log", base)),
+      manifest::segment_meta{
+        .is_compacted = false,
+        .size_bytes = 1024,
+        .base_offset = model::offset(base),
+        .committed_offset = model::offset(last)});
+}
+
+static std::vector<model::offset>
+base_offsets(const std::vector<partition_recovery_manager::segment>& s) {
+    std::vector<model::offset> ret;
+    for (const auto& [name, meta] : s) {
+        ret.push_back(meta.base_offset);
+    }
+    return ret;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_select_segments_ordered_by_offset) {
+    manifest m(manifest_ntp, model::revision_id(1));
+    // the names are ordered as strings in the manifest
+    add_segment(m, 0, 99);
+    add_segment(m, 100, 999);
+    add_segment(m, 1000, 1099);
+    auto segments = partition_recovery_manager::select_segments(m);
+    std::vector<model::offset> expected{
+      model::offset(0), model::offset(100), model::offset(1000)};
+    BOOST_REQUIRE(base_offsets(segments) == expected);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_select_segments_skips_overlaps) {
+    manifest m(manifest_ntp, model::revision_id(1));
+    add_segment(m, 0, 99);
+    add_segment(m, 50, 99);
+    add_segment(m, 100, 199);
+    auto segments = partition_recovery_manager::select_segments(m);
+    std::vector<model::offset> expected{model::offset(0), model::offset(100)};
+    BOOST_REQUIRE(base_offsets(segments) == expected);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_select_segments_after_gap) {
+    manifest m(manifest_ntp, model::revision_id(1));
+    add_segment(m, 0, 99);
+    add_segment(m, 200, 299);
+    add_segment(m, 300, 399);
+    auto segments = partition_recovery_manager::select_segments(m);
+    std::vector<model::offset> expected{model::offset(200), model::offset(300)};
+    BOOST_REQUIRE(base_offsets(segments) == expected);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_select_segments_empty_manifest) {
+    manifest m(manifest_ntp, model::revision_id(1));
+    BOOST_REQUIRE(partition_recovery_manager::select_segments(m).empty());
+}
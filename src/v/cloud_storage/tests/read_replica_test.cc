@@ -0,0 +1,104 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "cloud_storage/manifest.h"
+#include "cloud_storage/read_replica.h"
+#include "cloud_storage/remote.h"
+#include "cloud_storage/tests/s3_imposter.h"
+#include "cloud_storage/types.h"
+#include "cluster/types.h"
+#include "seastarx.h"
+#include "test_utils/fixture.h"
+
+#include <seastar/util/defer.hh>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <sstream>
+
+using namespace std::chrono_literals;
+using namespace cloud_storage;
+
+static const auto test_ntp = model::ntp( // NOLINT
+  model::ns("test-ns"),
+  model::topic("test-topic"),
+  model::partition_id(0));
+static const auto source_revision = model::revision_id(17); // NOLINT
+
+template<class Manifest>
+static s3_imposter_fixture::expectation make_expectation(const Manifest& m) {
+    std::stringstream body;
+    m.serialize(body);
+    return s3_imposter_fixture::expectation{
+      .url = "/" + ss::sstring(m.get_manifest_path()().string()),
+      .body = ss::sstring(body.str())};
+}
+
+FIXTURE_TEST(test_read_replica_sync, s3_imposter_fixture) { // NOLINT
+    topic_manifest tm(
+      cluster::topic_configuration(test_ntp.ns, test_ntp.tp.topic, 1, 1),
+      source_revision);
+    manifest m(test_ntp, source_revision);
+    m.add(
+      segment_name("0-1-v1.log"),
+      manifest::segment_meta{
+        .is_compacted = false,
+        .size_bytes = 100,
+        .base_offset = model::offset(0),
+        .committed_offset = model::offset(9)});
+    m.add(
+      segment_name("10-1-v1.log"),
+      manifest::segment_meta{
+        .is_compacted = false,
+        .size_bytes = 100,
+        .base_offset = model::offset(10),
+        .committed_offset = model::offset(19)});
+    set_expectations_and_listen({make_expectation(tm), make_expectation(m)});
+
+    service_probe probe;
+    remote api(s3_connection_limit(10), get_configuration(), probe);
+    read_replica replica(
+      test_ntp, api, s3::bucket_name("source-bucket"), 1s, 20ms);
+    auto action = ss::defer([&api, &replica] {
+        replica.stop().get();
+        api.stop().get();
+    });
+
+    BOOST_REQUIRE(!replica.is_synced());
+    BOOST_REQUIRE(!replica.get_remote_partition()->first_uploaded_offset());
+
+    retry_chain_node fib(1s, 20ms);
+    auto res = replica.sync(fib).get0();
+    BOOST_REQUIRE(res == download_result::success);
+    BOOST_REQUIRE(replica.is_synced());
+    auto part = replica.get_remote_partition();
+    BOOST_REQUIRE(part->first_uploaded_offset() == model::offset(0));
+    BOOST_REQUIRE(part->last_uploaded_offset() == model::offset(19));
+}
+
+FIXTURE_TEST(test_read_replica_not_archived, s3_imposter_fixture) { // NOLINT
+    set_expectations_and_listen({});
+
+    service_probe probe;
+    remote api(s3_connection_limit(10), get_configuration(), probe);
+    read_replica replica(
+      test_ntp, api, s3::bucket_name("source-bucket"), 1s, 20ms);
+    auto action = ss::defer([&api, &replica] {
+        replica.stop().get();
+        api.stop().get();
+    });
+
+    retry_chain_node fib(1s, 20ms);
+    auto res = replica.sync(fib).get0();
+    BOOST_REQUIRE(res == download_result::notfound);
+    BOOST_REQUIRE(!replica.is_synced());
+    BOOST_REQUIRE(!replica.get_remote_partition()->last_uploaded_offset());
+}
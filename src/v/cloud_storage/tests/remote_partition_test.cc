@@ -0,0 +1,217 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "bytes/iobuf.h"
+#include "bytes/iobuf_parser.h"
+#include "cloud_storage/cache_service.h"
+#include "cloud_storage/remote.h"
+#include "cloud_storage/remote_partition.h"
+#include "cloud_storage/tests/s3_imposter.h"
+#include "cloud_storage/types.h"
+#include "model/metadata.h"
+#include "model/record_batch_reader.h"
+#include "random/generators.h"
+#include "s3/client.h"
+#include "seastarx.h"
+#include "ssx/sformat.h"
+#include "storage/segment_appender_utils.h"
+#include "storage/tests/utils/random_batch.h"
+#include "storage/types.h"
+#include "test_utils/async.h"
+#include "test_utils/fixture.h"
+#include "units.h"
+
+#include <seastar/core/io_priority_class.hh>
+#include <seastar/util/defer.hh>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <filesystem>
+
+using namespace std::chrono_literals;
+using namespace cloud_storage;
+
+static const auto test_ntp = model::ntp( // NOLINT
+  model::ns("test-ns"),
+  model::topic("test-topic"),
+  model::partition_id(42));
+static const auto test_revision = model::revision_id(0); // NOLINT
+
+/// Serialize batches using the same format as the log segment
+static ss::sstring
+make_segment_payload(const ss::circular_buffer<model::record_batch>& batches) {
+    iobuf segment;
+    for (const auto& b : batches) {
+        segment.append(storage::disk_header_to_iobuf(b.header()));
+        segment.append(b.data().copy());
+    }
+    iobuf_parser p(std::move(segment));
+    return p.read_string(p.bytes_left());
+}
+
+struct remote_segment_spec {
+    segment_name name;
+    ss::circular_buffer<model::record_batch> batches;
+};
+
+static std::vector<s3_imposter_fixture::expectation> make_expectations(
+  manifest& m, const std::vector<remote_segment_spec>& segments) {
+    std::vector<s3_imposter_fixture::expectation> result;
+    for (const auto& s : segments) {
+        auto payload = make_segment_payload(s.batches);
+        m.add(
+          s.name,
+          manifest::segment_meta{
+            .is_compacted = false,
+            .size_bytes = payload.size(),
+            .base_offset = s.batches.front().base_offset(),
+            .committed_offset = s.batches.back().last_offset(),
+          });
+        auto path = m.get_remote_segment_path(s.name);
+        result.push_back(s3_imposter_fixture::expectation{
+          .url = "/" + ss::sstring(path().string()), .body = payload});
+    }
+    return result;
+}
+
+static std::vector<model::offset> read_offsets(
+  remote_partition& part, model::offset start, model::offset max) {
+    storage::log_reader_config cfg(start, max, ss::default_priority_class());
+    auto reader = part.make_reader(cfg).get0();
+    auto batches = model::consume_reader_to_memory(
+                     std::move(reader), model::no_timeout)
+                     .get0();
+    std::vector<model::offset> result;
+    for (const auto& b : batches) {
+        result.push_back(b.base_offset());
+    }
+    return result;
+}
+
+FIXTURE_TEST(test_remote_partition_read_all, s3_imposter_fixture) { // NOLINT
+    manifest m(test_ntp, test_revision);
+    std::vector<remote_segment_spec> segments;
+    segments.push_back(
+      {.name = segment_name("0-1-v1.log"),
+       .batches = storage::test::make_random_batches(
+         model::offset(0), 10, false)});
+    auto next = segments.back().batches.back().last_offset() + model::offset(1);
+    segments.push_back(
+      {.name = segment_name(ssx::sformat("{}-1-v1.log", next())),
+       .batches = storage::test::make_random_batches(next, 10, false)});
+    set_expectations_and_listen(make_expectations(m, segments));
+
+    service_probe probe;
+    remote api(s3_connection_limit(10), get_configuration(), probe);
+    auto part = ss::make_lw_shared<remote_partition>(
+      m, api, s3::bucket_name("bucket"), 1s, 20ms);
+    auto action = ss::defer([&api, &part] {
+        part->stop().get();
+        api.stop().get();
+    });
+
+    BOOST_REQUIRE(part->first_uploaded_offset() == model::offset(0));
+    BOOST_REQUIRE(
+      part->last_uploaded_offset()
+      == segments.back().batches.back().last_offset());
+
+    auto offsets = read_offsets(*part, model::offset(0), model::offset::max());
+    std::vector<model::offset> expected;
+    for (const auto& s : segments) {
+        for (const auto& b : s.batches) {
+            expected.push_back(b.base_offset());
+        }
+    }
+    BOOST_REQUIRE(offsets == expected);
+}
+
+FIXTURE_TEST(test_remote_partition_read_range, s3_imposter_fixture) { // NOLINT
+    manifest m(test_ntp, test_revision);
+    std::vector<remote_segment_spec> segments;
+    segments.push_back(
+      {.name = segment_name("0-1-v1.log"),
+       .batches = storage::test::make_random_batches(
+         model::offset(0), 10, false)});
+    set_expectations_and_listen(make_expectations(m, segments));
+
+    service_probe probe;
+    remote api(s3_connection_limit(10), get_configuration(), probe);
+    auto part = ss::make_lw_shared<remote_partition>(
+      m, api, s3::bucket_name("bucket"), 1s, 20ms);
+    auto action = ss::defer([&api, &part] {
+        part->stop().get();
+        api.stop().get();
+    });
+
+    const auto& batches = segments.front().batches;
+    auto start = batches[3].base_offset();
+    auto max = batches[6].base_offset();
+    auto offsets = read_offsets(*part, start, max);
+    std::vector<model::offset> expected;
+    for (size_t i = 3; i <= 6; i++) {
+        expected.push_back(batches[i].base_offset());
+    }
+    BOOST_REQUIRE(offsets == expected);
+    BOOST_REQUIRE(!part->is_data_available(
+      batches.back().last_offset() + model::offset(1)));
+}
+
+FIXTURE_TEST(test_remote_partition_prefetch, s3_imposter_fixture) { // NOLINT
+    manifest m(test_ntp, test_revision);
+    std::vector<remote_segment_spec> segments;
+    auto next = model::offset(0);
+    for (int i = 0; i < 3; i++) {
+        segments.push_back(
+          {.name = segment_name(ssx::sformat("{}-1-v1.log", next())),
+           .batches = storage::test::make_random_batches(next, 10, false)});
+        next = segments.back().batches.back().last_offset() + model::offset(1);
+    }
+    set_expectations_and_listen(make_expectations(m, segments));
+
+    auto dir = std::filesystem::path(ssx::sformat(
+      "remote_partition_test_{}", random_generators::gen_alphanum_string(8)));
+    cache c(dir, 100_MiB, cache_metrics_disabled::yes);
+    c.start().get();
+    service_probe probe;
+    remote api(s3_connection_limit(10), get_configuration(), probe);
+    auto part = ss::make_lw_shared<remote_partition>(
+      m, api, s3::bucket_name("bucket"), 1s, 20ms, &c, 2);
+    auto action = ss::defer([&api, &part, &c, dir] {
+        part->stop().get();
+        api.stop().get();
+        c.stop().get();
+        std::filesystem::remove_all(dir);
+    });
+
+    // The first read is not sequential, nothing is prefetched
+    const auto& first = segments[0].batches;
+    read_offsets(
+      *part, first.front().base_offset(), first.back().last_offset());
+    BOOST_REQUIRE_EQUAL(probe.get_segment_prefetches(), 0);
+
+    // The second read continues from the end of the first one, the third
+    // segment is downloaded ahead of the reader
+    const auto& second = segments[1].batches;
+    auto offsets = read_offsets(
+      *part, second.front().base_offset(), second.back().last_offset());
+    BOOST_REQUIRE_EQUAL(offsets.size(), second.size());
+    BOOST_REQUIRE_EQUAL(probe.get_segment_prefetches(), 1);
+    auto key = m.get_remote_segment_path(segments[2].name);
+    tests::cooperative_spin_wait_with_timeout(
+      5s, [&c, &key] { return c.contains(key()); })
+      .get();
+
+    const auto& third = segments[2].batches;
+    offsets = read_offsets(
+      *part, third.front().base_offset(), third.back().last_offset());
+    BOOST_REQUIRE_EQUAL(offsets.size(), third.size());
+    BOOST_REQUIRE_EQUAL(probe.get_prefetch_hits(), 1);
+}
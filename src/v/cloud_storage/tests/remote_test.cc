@@ -197,6 +197,41 @@ FIXTURE_TEST(test_download_segment, s3_imposter_fixture) { // NOLINT
     BOOST_REQUIRE(actual == manifest_payload);
 }
 
+FIXTURE_TEST(test_download_segment_range, s3_imposter_fixture) { // NOLINT
+    set_expectations_and_listen(default_expectations);
+    auto conf = get_configuration();
+    auto bucket = s3::bucket_name("bucket");
+    service_probe probe;
+    remote remote(s3_connection_limit(10), conf, probe);
+    auto m = load_manifest_from_str(manifest_payload);
+    auto name = segment_name("1-2-v1.log");
+    auto action = ss::defer([&remote] { remote.stop().get(); });
+
+    iobuf downloaded;
+    auto try_consume =
+      [&downloaded](ss::input_stream<char> is) -> ss::future<uint64_t> {
+        downloaded.clear();
+        auto rds = make_iobuf_ref_output_stream(downloaded);
+        co_await ss::copy(is, rds);
+        co_return downloaded.size_bytes();
+    };
+    retry_chain_node fib(100ms, 20ms);
+    auto dnl_res = remote
+                     .download_segment(
+                       bucket,
+                       name,
+                       m,
+                       try_consume,
+                       fib,
+                       s3::byte_range{.first = 2, .last = 5})
+                     .get();
+
+    BOOST_REQUIRE(dnl_res == download_result::success);
+    iobuf_parser p(std::move(downloaded));
+    auto actual = p.read_string(p.bytes_left());
+    BOOST_REQUIRE_EQUAL(actual, "gmen");
+}
+
 FIXTURE_TEST(test_download_segment_timeout, s3_imposter_fixture) { // NOLINT
     auto conf = get_configuration();
     auto bucket = s3::bucket_name("bucket");
@@ -28,6 +28,8 @@
 #include <boost/test/tools/old/interface.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <cstdio>
+
 using namespace std::chrono_literals;
 
 inline ss::logger fixt_log("fixture"); // NOLINT
@@ -112,6 +114,18 @@ void s3_imposter_fixture::set_routes(
                     repl.set_status(reply::status_type::not_found);
                     return error_payload;
                 }
+                auto range = request.get_header("Range");
+                if (!range.empty()) {
+                    // Only 'bytes=<first>-<last>' form is supported
+                    uint64_t first = 0;
+                    uint64_t last = 0;
+                    auto n = std::sscanf(
+                      range.c_str(), "bytes=%lu-%lu", &first, &last);
+                    BOOST_REQUIRE_EQUAL(n, 2);
+                    const auto& body = *it->second.body;
+                    repl.set_status(reply::status_type::partial_content);
+                    return body.substr(first, last - first + 1);
+                }
                 return *it->second.body;
             } else if (request._method == "PUT") {
                 expectations[request._url] = {
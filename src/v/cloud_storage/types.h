@@ -14,6 +14,9 @@
 #include "seastarx.h"
 #include "utils/named_type.h"
 
+#include <seastar/util/bool_class.hh>
+
+#include <chrono>
 #include <filesystem>
 
 namespace cloud_storage {
@@ -34,6 +37,30 @@ using local_segment_path
 /// Number of simultaneous connections to S3
 using s3_connection_limit
   = named_type<size_t, struct archival_s3_connection_limit_t>;
+/// Flag that indicates that the segment cache metrics are disabled
+using cache_metrics_disabled
+  = ss::bool_class<struct cache_metrics_disabled_tag>;
+
+/// Multipart upload settings
+struct multipart_upload_config {
+    /// Size of the part, objects that are larger than one part are
+    /// uploaded using multipart upload (0 disables multipart uploads)
+    size_t part_size{0};
+    /// Max number of parts of one object that are uploaded concurrently
+    size_t max_concurrency{1};
+};
+
+/// Hedged download settings
+struct hedged_download_config {
+    /// Percentile of the time to first byte of the downloads after which a
+    /// duplicate request is sent
+    double percentile{0.95};
+    /// Max number of duplicate requests in percents of all downloads
+    /// (0 disables the hedged downloads)
+    double budget_percent{0};
+    /// Lower bound of the time after which a duplicate request is sent
+    std::chrono::milliseconds min_delay{10};
+};
 
 enum class download_result : int32_t {
     success,
@@ -24,6 +24,13 @@
 
 namespace cluster {
 
+static std::optional<std::chrono::microseconds> cork_delay() {
+    if (auto d = config::shard_local_cfg().rpc_cork_delay_us(); d) {
+        return std::chrono::microseconds(*d);
+    }
+    return std::nullopt;
+}
+
 /**
  * Broker patch should included all nodes which properties changed as additions
  * (connections may require update after addresses changed, etc) and nodes that
@@ -127,7 +134,8 @@ ss::future<> maybe_create_tcp_client(
                     .server_addr = std::move(rpc_address),
                     .credentials = cert,
                     .disable_metrics = rpc::metrics_disabled(
-                      config::shard_local_cfg().disable_metrics)},
+                      config::shard_local_cfg().disable_metrics),
+                    .cork_delay = cork_delay()},
                   rpc::make_exponential_backoff_policy<rpc::clock_type>(
                     std::chrono::seconds(1), std::chrono::seconds(15)));
             });
@@ -171,7 +171,9 @@ using make_commands_list = commands_type_list<Commands...>;
 /// serialized as a record key. Key is independent from command type so it can
 /// leverage the log compactions (i.e only last command for given key is enough
 /// to determine its state). Command value contains command type information.
-/// Record data contains first the command type and then value.
+/// Record data contains first the command type and then value. The base offset
+/// is only set for the commands rebuilding the state from a snapshot, the
+/// offsets of replicated commands are assigned by raft.
 ///
 ///                  +--------------+-------+
 ///                  | command_type | value |
@@ -179,11 +181,13 @@ using make_commands_list = commands_type_list<Commands...>;
 ///
 template<typename Cmd>
 CONCEPT(requires ControllerCommand<Cmd>)
-ss::future<model::record_batch> serialize_cmd(Cmd cmd) {
+ss::future<model::record_batch>
+serialize_cmd(Cmd cmd, model::offset base_offset = model::offset(0)) {
     return ss::do_with(
       iobuf{},
       iobuf{},
-      [cmd = std::move(cmd)](iobuf& key_buf, iobuf& value_buf) mutable {
+      [cmd = std::move(cmd),
+       base_offset](iobuf& key_buf, iobuf& value_buf) mutable {
           auto value_f
             = reflection::async_adl<command_type>{}
                 .to(value_buf, Cmd::type)
@@ -195,8 +199,8 @@ ss::future<model::record_batch> serialize_cmd(Cmd cmd) {
             key_buf, std::move(cmd.key));
           return ss::when_all_succeed(std::move(key_f), std::move(value_f))
             .discard_result()
-            .then([&key_buf, &value_buf]() mutable {
-                simple_batch_builder builder(Cmd::batch_type, model::offset(0));
+            .then([&key_buf, &value_buf, base_offset]() mutable {
+                simple_batch_builder builder(Cmd::batch_type, base_offset);
                 builder.add_raw_kv(std::move(key_buf), std::move(value_buf));
                 return std::move(builder).build();
             });
@@ -14,12 +14,16 @@
 #include "cluster/controller_backend.h"
 #include "cluster/controller_service.h"
 #include "cluster/fwd.h"
+#include "cluster/leader_balancer.h"
 #include "cluster/logger.h"
 #include "cluster/members_backend.h"
 #include "cluster/members_frontend.h"
 #include "cluster/members_manager.h"
 #include "cluster/members_table.h"
 #include "cluster/metadata_dissemination_service.h"
+#include "cluster/partition_balancer.h"
+#include "cluster/shard_balancer.h"
+#include "cluster/health_monitor.h"
 #include "cluster/partition_leaders_table.h"
 #include "cluster/partition_manager.h"
 #include "cluster/raft0_utils.h"
@@ -94,7 +98,8 @@ ss::future<> controller::start() {
             raft::persistent_last_applied::yes,
             std::ref(_tp_updates_dispatcher),
             std::ref(_security_manager),
-            std::ref(_members_manager));
+            std::ref(_members_manager),
+            std::ref(_backend));
       })
       .then([this] {
           return _members_frontend.start(
@@ -180,6 +185,56 @@ ss::future<> controller::start() {
       .then([this] {
           return _members_backend.invoke_on(
             members_manager::shard, &members_backend::start);
+      })
+      .then([this] {
+          return _leader_balancer.start_single(
+            std::ref(_tp_state),
+            std::ref(_partition_leaders),
+            std::ref(_members_table),
+            std::ref(_connections),
+            std::ref(_shard_table),
+            std::ref(_partition_manager),
+            _raft0,
+            std::ref(_as));
+      })
+      .then([this] {
+          return _leader_balancer.invoke_on(
+            leader_balancer::shard, &leader_balancer::start);
+      })
+      .then([this] {
+          return _partition_balancer.start_single(
+            std::ref(_tp_state),
+            std::ref(_tp_frontend),
+            std::ref(_partition_allocator),
+            _raft0,
+            std::ref(_as));
+      })
+      .then([this] {
+          return _partition_balancer.invoke_on(
+            partition_balancer::shard, &partition_balancer::start);
+      })
+      .then([this] {
+          return _shard_balancer.start_single(
+            std::ref(_tp_state),
+            std::ref(_tp_frontend),
+            std::ref(_partition_manager),
+            std::ref(_as));
+      })
+      .then([this] {
+          return _shard_balancer.invoke_on(
+            shard_balancer::shard, &shard_balancer::start);
+      })
+      .then([this] {
+          return _health_monitor.start_single(
+            std::ref(_partition_manager),
+            std::ref(_partition_leaders),
+            std::ref(_connections),
+            std::ref(_partition_allocator),
+            std::ref(_as));
+      })
+      .then([this] {
+          return _health_monitor.invoke_on(
+            health_monitor::shard, &health_monitor::start);
       });
 }
 
@@ -199,7 +254,11 @@ ss::future<> controller::stop() {
     }
 
     return f.then([this] {
-        return _members_backend.stop()
+        return _health_monitor.stop()
+          .then([this] { return _shard_balancer.stop(); })
+          .then([this] { return _partition_balancer.stop(); })
+          .then([this] { return _leader_balancer.stop(); })
+          .then([this] { return _members_backend.stop(); })
           .then([this] { return _api.stop(); })
           .then([this] { return _backend.stop(); })
           .then([this] { return _tp_frontend.stop(); })
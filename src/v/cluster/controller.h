@@ -61,6 +61,26 @@ public:
         return _members_frontend;
     }
 
+    ss::sharded<leader_balancer>& get_leader_balancer() {
+        return _leader_balancer;
+    }
+
+    ss::sharded<partition_balancer>& get_partition_balancer() {
+        return _partition_balancer;
+    }
+
+    ss::sharded<shard_balancer>& get_shard_balancer() {
+        return _shard_balancer;
+    }
+
+    ss::sharded<health_monitor>& get_health_monitor() {
+        return _health_monitor;
+    }
+
+    ss::sharded<members_backend>& get_members_backend() {
+        return _members_backend;
+    }
+
     ss::future<> wire_up();
 
     ss::future<> start();
@@ -74,15 +94,19 @@ private:
     ss::sharded<topic_table> _tp_state;                    // instance per core
     ss::sharded<members_table> _members_table;             // instance per core
     ss::sharded<partition_leaders_table>
-      _partition_leaders;                            // instance per core
-    ss::sharded<members_manager> _members_manager;   // single instance
-    ss::sharded<topics_frontend> _tp_frontend;       // instance per core
-    ss::sharded<controller_backend> _backend;        // instance per core
-    ss::sharded<controller_stm> _stm;                // single instance
-    ss::sharded<controller_service> _service;        // instance per core
-    ss::sharded<controller_api> _api;                // instance per core
-    ss::sharded<members_frontend> _members_frontend; // instance per core
-    ss::sharded<members_backend> _members_backend;   // single instance
+      _partition_leaders;                                // instance per core
+    ss::sharded<members_manager> _members_manager;       // single instance
+    ss::sharded<topics_frontend> _tp_frontend;           // instance per core
+    ss::sharded<controller_backend> _backend;            // instance per core
+    ss::sharded<controller_stm> _stm;                    // single instance
+    ss::sharded<controller_service> _service;            // instance per core
+    ss::sharded<controller_api> _api;                    // instance per core
+    ss::sharded<members_frontend> _members_frontend;     // instance per core
+    ss::sharded<members_backend> _members_backend;       // single instance
+    ss::sharded<leader_balancer> _leader_balancer;       // single instance
+    ss::sharded<partition_balancer> _partition_balancer; // single instance
+    ss::sharded<shard_balancer> _shard_balancer;         // single instance
+    ss::sharded<health_monitor> _health_monitor;         // single instance
     ss::sharded<rpc::connection_cache>& _connections;
     ss::sharded<partition_manager>& _partition_manager;
     ss::sharded<shard_table>& _shard_table;
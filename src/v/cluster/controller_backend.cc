@@ -151,7 +151,10 @@ controller_backend::controller_backend(
   , _data_directory(config::shard_local_cfg().data_directory().as_sstring())
   , _housekeeping_timer_interval(
       config::shard_local_cfg().controller_backend_housekeeping_interval_ms())
-  , _as(as) {}
+  , _as(as)
+  , _reconciliation_units(
+      config::shard_local_cfg()
+        .controller_backend_reconciliation_concurrency()) {}
 
 ss::future<> controller_backend::stop() {
     _housekeeping_timer.cancel();
@@ -183,7 +186,10 @@ ss::future<> controller_backend::do_bootstrap() {
       _topic_deltas.begin(),
       _topic_deltas.end(),
       [this](underlying_t::value_type& ntp_deltas) {
-          return bootstrap_ntp(ntp_deltas.first, ntp_deltas.second);
+          return ss::with_semaphore(
+            _reconciliation_units, 1, [this, &ntp_deltas] {
+                return bootstrap_ntp(ntp_deltas.first, ntp_deltas.second);
+            });
       });
 }
 
@@ -297,6 +303,9 @@ ss::future<> controller_backend::fetch_deltas() {
       .then([this](deltas_t deltas) {
           return ss::with_semaphore(
             _topics_sem, 1, [this, deltas = std::move(deltas)]() mutable {
+                if (!deltas.empty()) {
+                    _last_fetched_delta = deltas.back().offset;
+                }
                 for (auto& d : deltas) {
                     auto ntp = d.ntp;
                     _topic_deltas[ntp].push_back(std::move(d));
@@ -305,6 +314,27 @@ ss::future<> controller_backend::fetch_deltas() {
       });
 }
 
+model::offset controller_backend::reconciled_offset() const {
+    auto& topics = _topics.local();
+    auto first_pending = topics.first_pending_delta_offset().value_or(
+      model::offset::max());
+    // the deltas handed over by the topic table are on their way to
+    // _topic_deltas, none of them is reconciled
+    if (topics.last_delivered_delta_offset() > _last_fetched_delta) {
+        first_pending = std::min(
+          first_pending, _last_fetched_delta + model::offset(1));
+    }
+    for (const auto& [_, deltas] : _topic_deltas) {
+        if (!deltas.empty()) {
+            first_pending = std::min(first_pending, deltas.front().offset);
+        }
+    }
+    if (first_pending == model::offset::max()) {
+        return first_pending;
+    }
+    return first_pending - model::offset(1);
+}
+
 void controller_backend::start_topics_reconciliation_loop() {
     (void)ss::with_gate(_gate, [this] {
         return ss::do_until(
@@ -375,12 +405,15 @@ ss::future<> controller_backend::reconcile_topics() {
         if (_topic_deltas.empty()) {
             return ss::now();
         }
-        // reconcile NTPs in parallel
+        // reconcile NTPs in parallel, with bounded concurrency
         return ss::parallel_for_each(
                  _topic_deltas.begin(),
                  _topic_deltas.end(),
                  [this](underlying_t::value_type& ntp_deltas) {
-                     return reconcile_ntp(ntp_deltas.second);
+                     return ss::with_semaphore(
+                       _reconciliation_units, 1, [this, &ntp_deltas] {
+                           return reconcile_ntp(ntp_deltas.second);
+                       });
                  })
           .then([this] {
               // cleanup empty NTP keys
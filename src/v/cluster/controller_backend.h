@@ -51,6 +51,11 @@ public:
 
     std::vector<topic_table::delta> list_ntp_deltas(const model::ntp&) const;
 
+    /// Offset up to which all the deltas of the topic table were reconciled
+    /// on the shard, model::offset::max() when nothing is left to reconcile.
+    /// Deltas that failed are retried and keep the offset behind them.
+    model::offset reconciled_offset() const;
+
 private:
     struct cross_shard_move_request {
         cross_shard_move_request(model::revision_id, raft::group_configuration);
@@ -136,8 +141,13 @@ private:
     std::chrono::milliseconds _housekeeping_timer_interval;
     ss::sharded<ss::abort_source>& _as;
     underlying_t _topic_deltas;
+    // offset of the last delta moved from the topic table to _topic_deltas
+    model::offset _last_fetched_delta;
     ss::timer<> _housekeeping_timer;
     ss::semaphore _topics_sem{1};
+    // bounds the number of ntps reconciled concurrently, the deltas of a
+    // single ntp are applied one after another
+    ss::semaphore _reconciliation_units;
     ss::gate _gate;
     /**
      * This map is populated by backend instance on shard that given NTP is
@@ -0,0 +1,230 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/controller_stm.h"
+
+#include "bytes/iobuf_parser.h"
+#include "cluster/logger.h"
+#include "config/configuration.h"
+#include "model/adl_serde.h"
+#include "reflection/adl.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+
+namespace cluster {
+
+controller_stm::controller_stm(
+  ss::logger& logger,
+  raft::consensus* c,
+  raft::persistent_last_applied persist,
+  topic_updates_dispatcher& topics,
+  security_manager& security,
+  members_manager& members,
+  ss::sharded<controller_backend>& backend)
+  : raft::mux_state_machine<
+    topic_updates_dispatcher,
+    security_manager,
+    members_manager>(logger, c, persist, topics, security, members)
+  , _topics(topics)
+  , _security(security)
+  , _members(members)
+  , _backend(backend)
+  , _snapshot_mgr(
+      std::filesystem::path(c->log_config().work_directory()),
+      "controller.snapshot",
+      ss::default_priority_class()) {}
+
+ss::future<> controller_stm::start() {
+    co_await hydrate_snapshot();
+    co_await raft::mux_state_machine<
+      topic_updates_dispatcher,
+      security_manager,
+      members_manager>::start();
+}
+
+ss::future<> controller_stm::hydrate_snapshot() {
+    auto reader = co_await _snapshot_mgr.open_snapshot();
+    if (!reader) {
+        co_return;
+    }
+    std::optional<snapshot> snap;
+    std::exception_ptr ex;
+    try {
+        snap = co_await read_snapshot(*reader);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await reader->close();
+    co_await _snapshot_mgr.remove_partial_snapshots();
+    if (ex) {
+        // nothing was applied yet, the state is rebuilt from the whole log
+        vlog(
+          clusterlog.warn,
+          "Unable to read controller snapshot {}, replaying the controller "
+          "log - {}",
+          _snapshot_mgr.snapshot_path(),
+          ex);
+        co_return;
+    }
+    if (!snap) {
+        co_return;
+    }
+    vlog(
+      clusterlog.info,
+      "Restoring controller state from snapshot at offset {} with {} commands",
+      snap->offset,
+      snap->batches.size());
+    for (auto& b : snap->batches) {
+        auto offset = b.base_offset();
+        auto ec = co_await apply_to_state(std::move(b));
+        if (ec) {
+            vlog(
+              clusterlog.warn,
+              "Error applying controller snapshot command at offset {} - {}",
+              offset,
+              ec.message());
+        }
+    }
+    _topics.restore_highest_group(snap->highest_group);
+    // the log is replayed from the entry following the snapshot
+    set_applied(snap->offset);
+}
+
+ss::future<std::optional<controller_stm::snapshot>>
+controller_stm::read_snapshot(storage::snapshot_reader& reader) {
+    iobuf_parser meta(co_await reader.read_metadata());
+    auto version = reflection::adl<int8_t>{}.from(meta);
+    if (version != snapshot_version) {
+        vlog(
+          clusterlog.warn,
+          "Ignoring controller snapshot with unsupported version {}",
+          version);
+        co_return std::nullopt;
+    }
+    auto offset = reflection::adl<model::offset>{}.from(meta);
+    auto highest_group = reflection::adl<raft::group_id>{}.from(meta);
+    auto size = reflection::adl<uint64_t>{}.from(meta);
+    // the snapshot is ahead of the log, it was left by a previous incarnation
+    // of the node
+    if (offset > bootstrap_last_applied()) {
+        vlog(
+          clusterlog.warn,
+          "Ignoring controller snapshot at offset {}, last applied offset: {}",
+          offset,
+          bootstrap_last_applied());
+        co_return std::nullopt;
+    }
+    iobuf_parser data(co_await read_iobuf_exactly(reader.input(), size));
+    co_return snapshot{
+      .offset = offset,
+      .highest_group = highest_group,
+      .batches = reflection::adl<std::vector<model::record_batch>>{}.from(data),
+    };
+}
+
+ss::future<> controller_stm::on_applied(model::offset offset) {
+    ++_applied_since_snapshot;
+    if (
+      !config::shard_local_cfg().enable_controller_snapshots()
+      || _writing_snapshot
+      || _applied_since_snapshot
+           < config::shard_local_cfg().controller_snapshot_max_entries()) {
+        return ss::now();
+    }
+    // an error must not fail the apply, the batch would be applied again
+    return take_snapshot(offset).handle_exception(
+      [offset](const std::exception_ptr& e) {
+          vlog(
+            clusterlog.warn,
+            "Unable to take controller snapshot at offset {} - {}",
+            offset,
+            e);
+      });
+}
+
+ss::future<> controller_stm::take_snapshot(model::offset offset) {
+    // the backend is stopped before the state machine
+    if (!_backend.local_is_initialized()) {
+        co_return;
+    }
+    auto reconciled = co_await _backend.map_reduce0(
+      [](const controller_backend& b) { return b.reconciled_offset(); },
+      model::offset::max(),
+      [](model::offset a, model::offset b) { return std::min(a, b); });
+    _topics.forget_deleted_topics(reconciled);
+
+    // the state is collected before the next batch is applied, the commands of
+    // all the states are consistent with the offset
+    std::vector<model::record_batch> batches = co_await _topics
+                                                 .snapshot_commands();
+    auto highest_group = _topics.highest_group();
+    auto security = co_await _security.snapshot_commands(offset);
+    auto members = co_await _members.snapshot_commands();
+    std::move(security.begin(), security.end(), std::back_inserter(batches));
+    std::move(members.begin(), members.end(), std::back_inserter(batches));
+    std::stable_sort(
+      batches.begin(),
+      batches.end(),
+      [](const model::record_batch& a, const model::record_batch& b) {
+          return a.base_offset() < b.base_offset();
+      });
+
+    iobuf data;
+    reflection::adl<std::vector<model::record_batch>>{}.to(
+      data, std::move(batches));
+    _applied_since_snapshot = 0;
+    _writing_snapshot = true;
+    // the snapshot is written in the background, the state machine keeps
+    // applying batches
+    (void)ss::with_gate(
+      _gate, [this, offset, highest_group, data = std::move(data)]() mutable {
+          return write_snapshot(offset, highest_group, std::move(data))
+            .handle_exception([offset](const std::exception_ptr& e) {
+                vlog(
+                  clusterlog.warn,
+                  "Unable to write controller snapshot at offset {} - {}",
+                  offset,
+                  e);
+            })
+            .finally([this] { _writing_snapshot = false; });
+      });
+}
+
+ss::future<> controller_stm::write_snapshot(
+  model::offset offset, raft::group_id highest_group, iobuf data) {
+    iobuf meta;
+    reflection::serialize(
+      meta,
+      snapshot_version,
+      offset,
+      highest_group,
+      uint64_t(data.size_bytes()));
+
+    auto writer = co_await _snapshot_mgr.start_snapshot();
+    std::exception_ptr ex;
+    try {
+        co_await writer.write_metadata(std::move(meta));
+        co_await write_iobuf_to_output_stream(std::move(data), writer.output());
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await writer.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_await _snapshot_mgr.finish_snapshot(writer);
+    vlog(clusterlog.debug, "Controller snapshot written at offset {}", offset);
+}
+
+} // namespace cluster
@@ -11,18 +11,78 @@
 
 #pragma once
 
+#include "cluster/controller_backend.h"
 #include "cluster/members_manager.h"
 #include "cluster/security_manager.h"
 #include "cluster/topic_updates_dispatcher.h"
 #include "raft/mux_state_machine.h"
+#include "storage/snapshot.h"
 
 namespace cluster {
 
-// single instance
-using controller_stm = raft::mux_state_machine<
-  topic_updates_dispatcher,
-  security_manager,
-  members_manager>;
+/**
+ * Controller state machine, single instance.
+ *
+ * Without snapshots every broker start replays the whole controller log to
+ * rebuild the topics, the members and the security state. When snapshots are
+ * enabled the state machine periodically persists the commands that rebuild
+ * the current state of the controller: one create command per topic with
+ * the partition moves that followed it, the users, the ACLs and the
+ * decommissioned nodes. The commands keep their original offsets so the
+ * topic revisions and the partition deltas the controller backend creates
+ * partitions from are the same as if the whole log was replayed.
+ *
+ * On start the snapshot is applied first and only the tail of the log
+ * following the snapshot is replayed. The log itself is not truncated, the
+ * snapshot is local to the node.
+ *
+ * Topics deleted before the snapshot are part of it until the controller
+ * backend removed their partitions on every shard, otherwise a node
+ * restarted before that would never remove them.
+ */
+class controller_stm final
+  : public raft::mux_state_machine<
+      topic_updates_dispatcher,
+      security_manager,
+      members_manager> {
+public:
+    static constexpr int8_t snapshot_version = 1;
+
+    controller_stm(
+      ss::logger&,
+      raft::consensus*,
+      raft::persistent_last_applied,
+      topic_updates_dispatcher&,
+      security_manager&,
+      members_manager&,
+      ss::sharded<controller_backend>&);
+
+    ss::future<> start();
+
+private:
+    struct snapshot {
+        // last offset included in the snapshot
+        model::offset offset;
+        raft::group_id highest_group;
+        std::vector<model::record_batch> batches;
+    };
+
+    ss::future<> on_applied(model::offset) final;
+
+    ss::future<> hydrate_snapshot();
+    ss::future<std::optional<snapshot>>
+    read_snapshot(storage::snapshot_reader&);
+    ss::future<> take_snapshot(model::offset);
+    ss::future<> write_snapshot(model::offset, raft::group_id, iobuf);
+
+    topic_updates_dispatcher& _topics;
+    security_manager& _security;
+    members_manager& _members;
+    ss::sharded<controller_backend>& _backend;
+    storage::snapshot_manager _snapshot_mgr;
+    size_t _applied_since_snapshot{0};
+    bool _writing_snapshot{false};
+};
 
 static constexpr ss::shard_id controller_stm_shard = 0;
 
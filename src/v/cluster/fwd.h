@@ -34,5 +34,9 @@ class security_frontend;
 class controller_api;
 class members_frontend;
 class members_backend;
+class leader_balancer;
+class partition_balancer;
+class shard_balancer;
+class health_monitor;
 
 } // namespace cluster
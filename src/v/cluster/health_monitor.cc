@@ -0,0 +1,286 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/health_monitor.h"
+
+#include "cluster/controller_service.h"
+#include "cluster/errc.h"
+#include "cluster/logger.h"
+#include "cluster/partition_leaders_table.h"
+#include "cluster/partition_manager.h"
+#include "config/configuration.h"
+#include "model/namespace.h"
+#include "model/timeout_clock.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/reactor.hh>
+
+#include <sys/statvfs.h>
+
+namespace cluster {
+
+health_monitor::health_monitor(
+  ss::sharded<partition_manager>& partition_manager,
+  ss::sharded<partition_leaders_table>& leaders,
+  ss::sharded<rpc::connection_cache>& connections,
+  ss::sharded<partition_allocator>& allocator,
+  ss::sharded<ss::abort_source>& as)
+  : _partition_manager(partition_manager)
+  , _leaders(leaders)
+  , _connections(connections)
+  , _allocator(allocator)
+  , _as(as)
+  , _self(config::shard_local_cfg().node_id()) {
+    _timer.set_callback([this] {
+        (void)ss::with_gate(_gate, [this] { return tick(); });
+    });
+}
+
+void health_monitor::start() {
+    setup_metrics();
+    arm(config::shard_local_cfg().health_monitor_tick_interval_ms());
+}
+
+ss::future<> health_monitor::stop() {
+    _timer.cancel();
+    return _gate.close();
+}
+
+void health_monitor::arm(clock_type::duration d) {
+    if (_gate.is_closed() || _as.local().abort_requested()) {
+        return;
+    }
+    _timer.arm(d);
+}
+
+bool health_monitor::is_active() const {
+    return _leaders.local().get_leader(model::controller_ntp) == _self;
+}
+
+ss::future<> health_monitor::tick() {
+    try {
+        auto report = co_await collect_report();
+        co_await send_report(std::move(report));
+    } catch (...) {
+        _report_errors++;
+        vlog(
+          clusterlog.info,
+          "unable to report the node health: {}",
+          std::current_exception());
+    }
+    expire_reports();
+    arm(config::shard_local_cfg().health_monitor_tick_interval_ms());
+}
+
+ss::future<node_health_report> health_monitor::collect_report() {
+    auto shard_reports = co_await _partition_manager.map(
+      [](partition_manager& pm) {
+          absl::flat_hash_map<
+            model::topic_namespace_view,
+            topic_health_report,
+            model::topic_namespace_hash,
+            model::topic_namespace_eq>
+            topics;
+          shard_report ret;
+          for (const auto& [ntp, p] : pm.partitions()) {
+              auto load = p->probe().load();
+              ret.bytes += load.bytes;
+              auto [it, _] = topics.try_emplace(
+                model::topic_namespace_view(ntp), topic_health_report{});
+              auto& t = it->second;
+              auto size = p->size_bytes();
+              t.size_bytes += size;
+              t.replicas++;
+              if (!p->is_leader()) {
+                  continue;
+              }
+              auto followers = p->raft()->get_follower_metrics();
+              t.leaders.push_back(partition_health_report{
+                .id = ntp.tp.partition,
+                .under_replicated = std::any_of(
+                  followers.cbegin(),
+                  followers.cend(),
+                  [](const raft::follower_metrics& fm) {
+                      return fm.under_replicated;
+                  }),
+                .size_bytes = size,
+                .bytes_rate = load.bytes,
+              });
+          }
+          ret.topics.reserve(topics.size());
+          for (auto& [tp_ns, t] : topics) {
+              t.tp_ns = model::topic_namespace(tp_ns);
+              ret.topics.push_back(std::move(t));
+          }
+          return ret;
+      });
+
+    auto data_dir = config::shard_local_cfg().data_directory().as_sstring();
+    auto st = co_await ss::engine().statvfs(data_dir);
+
+    node_health_report report{
+      .id = _self,
+      .disk_total_bytes = uint64_t(st.f_blocks) * st.f_frsize,
+      .disk_free_bytes = uint64_t(st.f_bavail) * st.f_frsize,
+    };
+
+    auto now = clock_type::now();
+    double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+                       now - _last_report_at)
+                       .count();
+    bool has_rates = _last_report_at != clock_type::time_point{}
+                     && seconds > 0;
+    auto rate = [seconds](uint64_t current, uint64_t last) -> uint64_t {
+        // the counters restart when a partition is moved or recreated
+        return current >= last ? uint64_t((current - last) / seconds) : 0;
+    };
+
+    absl::flat_hash_map<model::ntp, uint64_t> last_bytes;
+    absl::flat_hash_map<
+      model::topic_namespace,
+      size_t,
+      model::topic_namespace_hash,
+      model::topic_namespace_eq>
+      topic_idx;
+    uint64_t node_bytes = 0;
+    for (auto& sr : shard_reports) {
+        node_bytes += sr.bytes;
+        for (auto& t : sr.topics) {
+            for (auto& p : t.leaders) {
+                auto ntp = model::ntp(t.tp_ns.ns, t.tp_ns.tp, p.id);
+                auto current = p.bytes_rate;
+                auto it = _last_bytes.find(ntp);
+                p.bytes_rate = has_rates && it != _last_bytes.end()
+                                 ? rate(current, it->second)
+                                 : 0;
+                last_bytes.emplace(std::move(ntp), current);
+            }
+            // the partitions of a topic are spread over the shards
+            auto [it, inserted] = topic_idx.try_emplace(
+              t.tp_ns, report.topics.size());
+            if (inserted) {
+                report.topics.push_back(std::move(t));
+                continue;
+            }
+            auto& merged = report.topics[it->second];
+            merged.size_bytes += t.size_bytes;
+            merged.replicas += t.replicas;
+            std::move(
+              t.leaders.begin(),
+              t.leaders.end(),
+              std::back_inserter(merged.leaders));
+        }
+    }
+    report.bytes_rate = has_rates ? rate(node_bytes, _last_node_bytes) : 0;
+
+    _last_bytes = std::move(last_bytes);
+    _last_node_bytes = node_bytes;
+    _last_report_at = now;
+    co_return report;
+}
+
+ss::future<> health_monitor::send_report(node_health_report report) {
+    auto leader = _leaders.local().get_leader(model::controller_ntp);
+    if (!leader) {
+        vlog(clusterlog.debug, "no controller leader to report the health to");
+        co_return;
+    }
+    if (leader == _self) {
+        update_report(std::move(report));
+        co_return;
+    }
+    const std::chrono::duration timeout
+      = config::shard_local_cfg().health_monitor_tick_interval_ms();
+    auto res = co_await _connections.local()
+                 .with_node_client<controller_client_protocol>(
+                   _self,
+                   ss::this_shard_id(),
+                   *leader,
+                   timeout,
+                   [report = std::move(report),
+                    timeout](controller_client_protocol cp) mutable {
+                       return cp.report_health(
+                         report_health_request{.report = std::move(report)},
+                         rpc::client_opts(
+                           model::timeout_clock::now() + timeout));
+                   });
+    if (res.has_error()) {
+        _report_errors++;
+        vlog(
+          clusterlog.debug,
+          "unable to report the node health to {}: {}",
+          *leader,
+          res.error().message());
+    } else if (res.value().data.error != errc::success) {
+        _report_errors++;
+        vlog(
+          clusterlog.debug,
+          "controller leader {} rejected the health report: {}",
+          *leader,
+          make_error_code(res.value().data.error).message());
+    }
+}
+
+void health_monitor::update_report(node_health_report report) {
+    if (!is_active()) {
+        return;
+    }
+    _allocator.local().update_node_usage(
+      report.id,
+      allocation_node::usage{
+        .disk_used_bytes = report.disk_total_bytes - report.disk_free_bytes,
+        .disk_total_bytes = report.disk_total_bytes,
+        .bytes_rate = report.bytes_rate,
+      });
+    auto id = report.id;
+    _reports[id] = node_health{
+      .report = std::move(report),
+      .updated_at = clock_type::now(),
+    };
+}
+
+void health_monitor::expire_reports() {
+    if (!is_active()) {
+        // the next controller leader caches the reports
+        _reports.clear();
+        return;
+    }
+    auto expired_at
+      = clock_type::now()
+        - config::shard_local_cfg().health_monitor_max_report_age_ms();
+    absl::erase_if(_reports, [expired_at](const auto& p) {
+        return p.second.updated_at < expired_at;
+    });
+}
+
+void health_monitor::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("cluster:health_monitor"),
+      {
+        sm::make_gauge(
+          "reporting_nodes",
+          [this] { return _reports.size(); },
+          sm::description("Number of nodes with a health report cached by "
+                          "the controller leader")),
+        sm::make_derive(
+          "report_errors",
+          [this] { return _report_errors; },
+          sm::description("Number of health reports of this node that "
+                          "failed to reach the controller leader")),
+      });
+}
+
+} // namespace cluster
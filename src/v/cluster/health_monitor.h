@@ -0,0 +1,119 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "cluster/fwd.h"
+#include "cluster/scheduling/partition_allocator.h"
+#include "cluster/types.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "rpc/connection_cache.h"
+#include "seastarx.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <vector>
+
+namespace cluster {
+
+/**
+ * Aggregates the health and the resource usage of the nodes of the cluster.
+ *
+ * Every node periodically collects a compact report of its partitions: the
+ * disk usage, the size and the number of replicas of each topic, and for the
+ * partitions it leads their size, throughput and whether they are under
+ * replicated. The followers don't report their replicas, the report of a node
+ * grows with the partitions it leads and the topics it hosts. The report is
+ * sent to the controller leader with the report_health rpc.
+ *
+ * The controller leader caches the last report of each node, drops the
+ * reports that are older than the max report age and feeds the disk usage
+ * and the throughput of the nodes to the partition allocator. The cached view
+ * is served by the admin API and can be read by the balancers.
+ */
+class health_monitor {
+public:
+    static constexpr ss::shard_id shard = partition_allocator::shard;
+
+    using clock_type = ss::lowres_clock;
+
+    struct node_health {
+        node_health_report report;
+        clock_type::time_point updated_at;
+    };
+
+    health_monitor(
+      ss::sharded<partition_manager>&,
+      ss::sharded<partition_leaders_table>&,
+      ss::sharded<rpc::connection_cache>&,
+      ss::sharded<partition_allocator>&,
+      ss::sharded<ss::abort_source>&);
+
+    void start();
+    ss::future<> stop();
+
+    /// true if this node is the controller leader and caches the reports
+    bool is_active() const;
+
+    /// \brief caches the report of a node, called on the controller leader
+    void update_report(node_health_report);
+
+    /// the last report of each node, empty unless this node is active
+    const absl::flat_hash_map<model::node_id, node_health>& reports() const {
+        return _reports;
+    }
+
+private:
+    // cumulative bytes served by the partitions of a shard, the leader
+    // partitions report their counters in bytes_rate until the rates are
+    // computed on the monitor shard
+    struct shard_report {
+        uint64_t bytes{0};
+        std::vector<topic_health_report> topics;
+    };
+
+    void arm(clock_type::duration);
+    void setup_metrics();
+    ss::future<> tick();
+    ss::future<node_health_report> collect_report();
+    ss::future<> send_report(node_health_report);
+    void expire_reports();
+
+    ss::sharded<partition_manager>& _partition_manager;
+    ss::sharded<partition_leaders_table>& _leaders;
+    ss::sharded<rpc::connection_cache>& _connections;
+    ss::sharded<partition_allocator>& _allocator;
+    ss::sharded<ss::abort_source>& _as;
+    model::node_id _self;
+
+    // the byte counters at the previous report, per leader partition and
+    // for the whole node
+    absl::flat_hash_map<model::ntp, uint64_t> _last_bytes;
+    uint64_t _last_node_bytes{0};
+    clock_type::time_point _last_report_at;
+
+    absl::flat_hash_map<model::node_id, node_health> _reports;
+    ss::timer<clock_type> _timer;
+    ss::gate _gate;
+
+    uint64_t _report_errors{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace cluster
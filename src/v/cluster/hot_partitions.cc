@@ -0,0 +1,95 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/hot_partitions.h"
+
+#include <cmath>
+
+namespace cluster {
+
+namespace {
+constexpr auto decay_interval = std::chrono::seconds(1);
+
+double seconds(hot_partitions::clock_type::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+/// In steady state a rate r accumulates to r / (1 - per second decay)
+double per_second_decay() {
+    return std::exp2(-1.0 / seconds(hot_partitions::half_life));
+}
+} // namespace
+
+hot_partitions& hot_partitions::local() {
+    static thread_local hot_partitions tracker;
+    return tracker;
+}
+
+void hot_partitions::maybe_decay(clock_type::time_point now) {
+    const auto elapsed = now - _last_decay;
+    if (elapsed < decay_interval) {
+        return;
+    }
+    const auto factor = std::exp2(
+      -seconds(elapsed) / seconds(hot_partitions::half_life));
+    for (auto& t : _trackers) {
+        t.decay(factor);
+    }
+    _last_decay = now;
+}
+
+void hot_partitions::record_produce(const model::ntp& ntp, uint64_t bytes) {
+    maybe_decay(clock_type::now());
+    get(metric::bytes_in).add(ntp, static_cast<double>(bytes));
+    get(metric::requests).add(ntp, 1);
+}
+
+void hot_partitions::record_fetch(const model::ntp& ntp, uint64_t bytes) {
+    maybe_decay(clock_type::now());
+    get(metric::bytes_out).add(ntp, static_cast<double>(bytes));
+    get(metric::requests).add(ntp, 1);
+}
+
+std::vector<hot_partitions::sample> hot_partitions::top(metric m, size_t n) {
+    maybe_decay(clock_type::now());
+    const auto scale = 1.0 - per_second_decay();
+    std::vector<sample> ret;
+    for (auto& e : get(m).top(n)) {
+        ret.push_back(sample{
+          .ntp = std::move(e.key),
+          .rate = e.count * scale,
+          .error = e.error * scale});
+    }
+    return ret;
+}
+
+std::string_view to_string_view(hot_partitions::metric m) {
+    switch (m) {
+    case hot_partitions::metric::bytes_in:
+        return "bytes_in";
+    case hot_partitions::metric::bytes_out:
+        return "bytes_out";
+    case hot_partitions::metric::requests:
+        return "requests";
+    }
+    return "unknown";
+}
+
+std::optional<hot_partitions::metric>
+hot_partition_metric_from_string(std::string_view name) {
+    for (size_t i = 0; i < hot_partitions::metrics_count; ++i) {
+        auto m = static_cast<hot_partitions::metric>(i);
+        if (to_string_view(m) == name) {
+            return m;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace cluster
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/fundamental.h"
+#include "seastarx.h"
+#include "utils/space_saving.h"
+
+#include <seastar/core/lowres_clock.hh>
+
+#include <array>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace cluster {
+
+/**
+ * Partitions of the shard with the highest recent produce and fetch rates.
+ *
+ * Each metric is tracked by a space-saving top-k over counts decayed by
+ * half every `half_life`, so the rates follow the last few seconds of
+ * traffic. Recording a request updates a small hash map, the decay is
+ * applied lazily at most once a second.
+ */
+class hot_partitions {
+public:
+    using clock_type = ss::lowres_clock;
+
+    enum class metric : uint8_t { bytes_in = 0, bytes_out, requests };
+    static constexpr size_t metrics_count = 3;
+
+    /// Number of partitions tracked per metric
+    static constexpr size_t capacity = 64;
+    static constexpr std::chrono::seconds half_life{5};
+
+    struct sample {
+        model::ntp ntp;
+        /// per second
+        double rate;
+        /// the rate overestimates the real rate by at most the error
+        double error;
+    };
+
+    static hot_partitions& local();
+
+    void record_produce(const model::ntp&, uint64_t bytes);
+    void record_fetch(const model::ntp&, uint64_t bytes);
+
+    /// The n partitions with the highest rates, highest first
+    std::vector<sample> top(metric, size_t n);
+
+private:
+    using tracker = space_saving<model::ntp>;
+
+    tracker& get(metric m) { return _trackers[static_cast<size_t>(m)]; }
+    void maybe_decay(clock_type::time_point now);
+
+    std::array<tracker, metrics_count> _trackers{
+      tracker(capacity), tracker(capacity), tracker(capacity)};
+    clock_type::time_point _last_decay{clock_type::now()};
+};
+
+std::string_view to_string_view(hot_partitions::metric);
+std::optional<hot_partitions::metric>
+hot_partition_metric_from_string(std::string_view);
+
+} // namespace cluster
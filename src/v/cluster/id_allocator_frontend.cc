@@ -58,11 +58,75 @@ id_allocator_frontend::id_allocator_frontend(
   , _metadata_dissemination_retries(
       config::shard_local_cfg().metadata_dissemination_retries.value())
   , _metadata_dissemination_retry_delay_ms(
-      config::shard_local_cfg().metadata_dissemination_retry_delay_ms.value()) {
-}
+      config::shard_local_cfg().metadata_dissemination_retry_delay_ms.value())
+  , _lease_size(config::shard_local_cfg().id_allocator_shard_lease_size()) {}
+
+ss::future<> id_allocator_frontend::stop() { return _gate.close(); }
 
 ss::future<allocate_id_reply>
 id_allocator_frontend::allocate_id(model::timeout_clock::duration timeout) {
+    if (_lease_size <= 1) {
+        auto r = co_await allocate_id_range(1, timeout);
+        co_return allocate_id_reply{r.id, r.ec};
+    }
+
+    while (_lease.remaining == 0) {
+        if (_next_lease) {
+            _lease = *_next_lease;
+            _next_lease.reset();
+            continue;
+        }
+        auto ec = co_await refill_lease(timeout);
+        if (ec != errc::success && _lease.remaining == 0 && !_next_lease) {
+            co_return allocate_id_reply{0, ec};
+        }
+    }
+
+    auto id = _lease.next++;
+    _lease.remaining--;
+    if (_lease.remaining < _lease_size / 2 && !_next_lease && !_refill) {
+        // fetch the next range ahead, a failure is retried by the first
+        // caller finding the lease exhausted
+        (void)refill_lease(timeout).discard_result();
+    }
+    co_return allocate_id_reply{id, errc::success};
+}
+
+ss::future<errc>
+id_allocator_frontend::refill_lease(model::timeout_clock::duration timeout) {
+    if (_refill) {
+        return _refill->get_shared_future();
+    }
+    if (_gate.is_closed()) {
+        return ss::make_ready_future<errc>(errc::shutting_down);
+    }
+    _refill.emplace();
+    auto f = _refill->get_shared_future();
+    (void)ss::with_gate(
+      _gate, [this, timeout] { return do_refill_lease(timeout); })
+      .handle_exception([](std::exception_ptr e) {
+          vlog(clusterlog.warn, "can't lease a range of ids: {}", e);
+          return errc::timeout;
+      })
+      .then([this](errc ec) {
+          auto refill = std::move(*_refill);
+          _refill.reset();
+          refill.set_value(ec);
+      });
+    return f;
+}
+
+ss::future<errc>
+id_allocator_frontend::do_refill_lease(model::timeout_clock::duration timeout) {
+    auto r = co_await allocate_id_range(_lease_size, timeout);
+    if (r.ec == errc::success) {
+        _next_lease = id_lease{.next = r.id, .remaining = r.count};
+    }
+    co_return r.ec;
+}
+
+ss::future<allocate_id_range_reply> id_allocator_frontend::allocate_id_range(
+  int64_t count, model::timeout_clock::duration timeout) {
     auto nt = model::topic_namespace(
       model::kafka_internal_namespace, model::id_allocator_topic);
 
@@ -74,12 +138,12 @@ id_allocator_frontend::allocate_id(model::timeout_clock::duration timeout) {
 
     if (!has_topic) {
         vlog(clusterlog.warn, "can't meta cache entry for {}", nt);
-        co_return allocate_id_reply{0, errc::topic_not_exists};
+        co_return allocate_id_range_reply{0, 0, errc::topic_not_exists};
     }
 
     auto _self = _controller->self();
 
-    auto r = allocate_id_reply{0, errc::no_leader_controller};
+    auto r = allocate_id_range_reply{0, 0, errc::no_leader_controller};
 
     auto retries = _metadata_dissemination_retries;
     auto delay_ms = _metadata_dissemination_retry_delay_ms;
@@ -97,7 +161,7 @@ id_allocator_frontend::allocate_id(model::timeout_clock::duration timeout) {
         auto leader = leader_opt.value();
 
         if (leader == _self) {
-            r = co_await do_allocate_id(timeout);
+            r = co_await do_allocate_id(timeout, count);
         } else {
             vlog(
               clusterlog.trace,
@@ -105,7 +169,7 @@ id_allocator_frontend::allocate_id(model::timeout_clock::duration timeout) {
               leader,
               _self);
 
-            r = co_await dispatch_allocate_id_to_leader(leader, timeout);
+            r = co_await dispatch_allocate_id_to_leader(leader, timeout, count);
         }
 
         if (likely(r.ec != errc::replication_error)) {
@@ -122,10 +186,41 @@ id_allocator_frontend::allocate_id(model::timeout_clock::duration timeout) {
     co_return r;
 }
 
-ss::future<allocate_id_reply>
+ss::future<allocate_id_range_reply>
 id_allocator_frontend::dispatch_allocate_id_to_leader(
-  model::node_id leader, model::timeout_clock::duration timeout) {
-    return _connection_cache.local()
+  model::node_id leader, model::timeout_clock::duration timeout, int64_t count) {
+    if (count > 1) {
+        auto r = co_await _connection_cache.local()
+                   .with_node_client<cluster::id_allocator_client_protocol>(
+                     _controller->self(),
+                     ss::this_shard_id(),
+                     leader,
+                     timeout,
+                     [timeout, count](id_allocator_client_protocol cp) {
+                         return cp.allocate_id_range(
+                           allocate_id_range_request{timeout, count},
+                           rpc::client_opts(
+                             model::timeout_clock::now() + timeout));
+                     })
+                   .then(&rpc::get_ctx_data<allocate_id_range_reply>);
+        if (r.has_value()) {
+            co_return r.value();
+        }
+        if (r.error() != rpc::errc::method_not_found) {
+            vlog(
+              clusterlog.warn,
+              "got error {} on remote allocate_id_range",
+              r.error());
+            co_return allocate_id_range_reply{0, 0, errc::timeout};
+        }
+        // the leader doesn't support ranges yet, lease a single id
+        vlog(
+          clusterlog.debug,
+          "{} doesn't support allocate_id_range, falling back to allocate_id",
+          leader);
+    }
+
+    auto r = co_await _connection_cache.local()
       .with_node_client<cluster::id_allocator_client_protocol>(
         _controller->self(),
         ss::this_shard_id(),
@@ -136,21 +231,17 @@ id_allocator_frontend::dispatch_allocate_id_to_leader(
               allocate_id_request{timeout},
               rpc::client_opts(model::timeout_clock::now() + timeout));
         })
-      .then(&rpc::get_ctx_data<allocate_id_reply>)
-      .then([](result<allocate_id_reply> r) {
-          if (r.has_error()) {
-              vlog(
-                clusterlog.warn,
-                "got error {} on remote allocate_id",
-                r.error());
-              return allocate_id_reply{0, errc::timeout};
-          }
-          return r.value();
-      });
+      .then(&rpc::get_ctx_data<allocate_id_reply>);
+    if (r.has_error()) {
+        vlog(clusterlog.warn, "got error {} on remote allocate_id", r.error());
+        co_return allocate_id_range_reply{0, 0, errc::timeout};
+    }
+    co_return allocate_id_range_reply{
+      r.value().id, r.value().ec == errc::success ? 1 : 0, r.value().ec};
 }
 
-ss::future<allocate_id_reply>
-id_allocator_frontend::do_allocate_id(model::timeout_clock::duration timeout) {
+ss::future<allocate_id_range_reply> id_allocator_frontend::do_allocate_id(
+  model::timeout_clock::duration timeout, int64_t count) {
     auto shard = _shard_table.local().shard_for(model::id_allocator_ntp);
 
     if (unlikely(!shard)) {
@@ -167,24 +258,25 @@ id_allocator_frontend::do_allocate_id(model::timeout_clock::duration timeout) {
               clusterlog.warn,
               "can't find a shard for {}",
               model::id_allocator_ntp);
-            co_return allocate_id_reply{0, errc::no_leader_controller};
+            co_return allocate_id_range_reply{
+              0, 0, errc::no_leader_controller};
         }
     }
-    co_return co_await do_allocate_id(*shard, timeout);
+    co_return co_await do_allocate_id(*shard, timeout, count);
 }
 
-ss::future<allocate_id_reply> id_allocator_frontend::do_allocate_id(
-  ss::shard_id shard, model::timeout_clock::duration timeout) {
+ss::future<allocate_id_range_reply> id_allocator_frontend::do_allocate_id(
+  ss::shard_id shard, model::timeout_clock::duration timeout, int64_t count) {
     return _partition_manager.invoke_on(
-      shard, _ssg, [timeout](cluster::partition_manager& mgr) mutable {
+      shard, _ssg, [timeout, count](cluster::partition_manager& mgr) mutable {
           auto partition = mgr.get(model::id_allocator_ntp);
           if (!partition) {
               vlog(
                 clusterlog.warn,
                 "can't get partition by {} ntp",
                 model::id_allocator_ntp);
-              return ss::make_ready_future<allocate_id_reply>(
-                allocate_id_reply{0, errc::topic_not_exists});
+              return ss::make_ready_future<allocate_id_range_reply>(
+                allocate_id_range_reply{0, 0, errc::topic_not_exists});
           }
           auto& stm = partition->id_allocator_stm();
           if (!stm) {
@@ -192,21 +284,22 @@ ss::future<allocate_id_reply> id_allocator_frontend::do_allocate_id(
                 clusterlog.warn,
                 "can't get id allocator stm of the {}' partition",
                 model::id_allocator_ntp);
-              return ss::make_ready_future<allocate_id_reply>(
-                allocate_id_reply{0, errc::topic_not_exists});
+              return ss::make_ready_future<allocate_id_range_reply>(
+                allocate_id_range_reply{0, 0, errc::topic_not_exists});
           }
           return stm
-            ->allocate_id_and_wait(model::timeout_clock::now() + timeout)
-            .then([](id_allocator_stm::stm_allocation_result r) {
+            ->allocate_id_and_wait(model::timeout_clock::now() + timeout, count)
+            .then([count](id_allocator_stm::stm_allocation_result r) {
                 if (r.raft_status != raft::errc::success) {
                     vlog(
                       clusterlog.warn,
                       "allocate id stm call failed with {}",
                       r.raft_status);
-                    return allocate_id_reply{r.id, errc::replication_error};
+                    return allocate_id_range_reply{
+                      r.id, 0, errc::replication_error};
                 }
 
-                return allocate_id_reply{r.id, errc::success};
+                return allocate_id_range_reply{r.id, count, errc::success};
             });
       });
 }
@@ -13,8 +13,11 @@
 #include "cluster/types.h"
 #include "rpc/connection_cache.h"
 
+#include <seastar/core/gate.hh>
+#include <seastar/core/shared_future.hh>
 #include <seastar/core/sharded.hh>
 
+#include <optional>
 #include <vector>
 
 namespace cluster {
@@ -34,6 +37,12 @@ class id_allocator;
 //
 // when the service recieves a call it triggers id_allocator_frontend
 // which in its own turn pass the request to the id_allocator_stm
+//
+// to avoid a round trip to the leader per id each shard leases a
+// range of id_allocator_shard_lease_size ids and serves allocate_id
+// from it, the next range is requested in background once half of
+// the lease is used. ids of an unused lease are lost on restart, the
+// ids are unique but not dense nor monotonic across the shards
 class id_allocator_frontend {
 public:
     id_allocator_frontend(
@@ -48,7 +57,14 @@ public:
     ss::future<allocate_id_reply>
     allocate_id(model::timeout_clock::duration timeout);
 
+    ss::future<> stop();
+
 private:
+    struct id_lease {
+        int64_t next{0};
+        int64_t remaining{0};
+    };
+
     ss::smp_service_group _ssg;
     ss::sharded<cluster::partition_manager>& _partition_manager;
     ss::sharded<cluster::shard_table>& _shard_table;
@@ -58,15 +74,29 @@ private:
     std::unique_ptr<cluster::controller>& _controller;
     int16_t _metadata_dissemination_retries{1};
     std::chrono::milliseconds _metadata_dissemination_retry_delay_ms;
+    int64_t _lease_size;
 
-    ss::future<allocate_id_reply> dispatch_allocate_id_to_leader(
-      model::node_id, model::timeout_clock::duration);
+    id_lease _lease;
+    // range fetched ahead, used once _lease is exhausted
+    std::optional<id_lease> _next_lease;
+    // set while a range is being fetched
+    std::optional<ss::shared_promise<errc>> _refill;
+    ss::gate _gate;
 
-    ss::future<allocate_id_reply>
-      do_allocate_id(model::timeout_clock::duration);
+    ss::future<errc> refill_lease(model::timeout_clock::duration);
+    ss::future<errc> do_refill_lease(model::timeout_clock::duration);
 
-    ss::future<allocate_id_reply>
-      do_allocate_id(ss::shard_id, model::timeout_clock::duration);
+    ss::future<allocate_id_range_reply>
+      allocate_id_range(int64_t, model::timeout_clock::duration);
+
+    ss::future<allocate_id_range_reply> dispatch_allocate_id_to_leader(
+      model::node_id, model::timeout_clock::duration, int64_t);
+
+    ss::future<allocate_id_range_reply>
+      do_allocate_id(model::timeout_clock::duration, int64_t);
+
+    ss::future<allocate_id_range_reply>
+      do_allocate_id(ss::shard_id, model::timeout_clock::duration, int64_t);
 
     ss::future<bool> try_create_id_allocator_topic();
 
@@ -89,8 +89,9 @@ public:
 
     ss::future<> start() final;
 
-    ss::future<stm_allocation_result>
-    allocate_id_and_wait(model::timeout_clock::time_point timeout);
+    /// Allocates `count` consecutive ids, the result is the first of them
+    ss::future<stm_allocation_result> allocate_id_and_wait(
+      model::timeout_clock::time_point timeout, int64_t count = 1);
 
 private:
     struct sequence_id {
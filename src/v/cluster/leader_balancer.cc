@@ -0,0 +1,300 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/leader_balancer.h"
+
+#include "cluster/errc.h"
+#include "cluster/logger.h"
+#include "cluster/members_table.h"
+#include "cluster/partition_leaders_table.h"
+#include "cluster/partition_manager.h"
+#include "cluster/shard_table.h"
+#include "cluster/topic_table.h"
+#include "config/configuration.h"
+#include "model/timeout_clock.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "raft/consensus.h"
+#include "raft/errc.h"
+#include "raft/raftgen_service.h"
+#include "rpc/types.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
+
+#include <fmt/ostream.h>
+
+namespace cluster {
+
+std::ostream&
+operator<<(std::ostream& o, const leader_balancer::transfer& t) {
+    fmt::print(
+      o,
+      "{{group: {}, ntp: {}, from: {}, to: {}}}",
+      t.group,
+      t.ntp,
+      t.from,
+      t.to);
+    return o;
+}
+
+leader_balancer::leader_balancer(
+  ss::sharded<topic_table>& topics,
+  ss::sharded<partition_leaders_table>& leaders,
+  ss::sharded<members_table>& members,
+  ss::sharded<rpc::connection_cache>& connections,
+  ss::sharded<shard_table>& shard_table,
+  ss::sharded<partition_manager>& partition_manager,
+  consensus_ptr raft0,
+  ss::sharded<ss::abort_source>& as)
+  : _topics(topics)
+  , _leaders(leaders)
+  , _members(members)
+  , _connections(connections)
+  , _shard_table(shard_table)
+  , _partition_manager(partition_manager)
+  , _raft0(std::move(raft0))
+  , _as(as) {
+    _timer.set_callback([this] {
+        (void)ss::with_gate(_gate, [this] { return tick(); });
+    });
+}
+
+void leader_balancer::start() {
+    setup_metrics();
+    arm(config::shard_local_cfg().leader_balancer_idle_timeout());
+}
+
+ss::future<> leader_balancer::stop() {
+    _timer.cancel();
+    return _gate.close();
+}
+
+void leader_balancer::resume() {
+    if (!_paused) {
+        return;
+    }
+    _paused = false;
+    // do not wait for the whole idle timeout after being resumed
+    if (!_gate.is_closed() && _timer.armed()) {
+        _timer.rearm(clock_type::now() + active_interval);
+    }
+}
+
+leader_balancer::status leader_balancer::get_status() const {
+    return status{
+      .enabled = config::shard_local_cfg().enable_leader_balancer(),
+      .paused = _paused,
+      .active = _raft0->is_leader(),
+      .transfers = _transfers,
+      .transfer_errors = _transfer_errors,
+    };
+}
+
+void leader_balancer::arm(clock_type::duration d) {
+    if (_gate.is_closed() || _as.local().abort_requested()) {
+        return;
+    }
+    _timer.arm(d);
+}
+
+ss::future<> leader_balancer::tick() {
+    clock_type::duration next
+      = config::shard_local_cfg().leader_balancer_idle_timeout();
+    // only the controller leader balances the cluster, the leadership of the
+    // controller itself is not moved.
+    if (
+      config::shard_local_cfg().enable_leader_balancer() && !_paused
+      && _raft0->is_leader()) {
+        auto moved = _transfers + _transfer_errors;
+        try {
+            co_await balance();
+        } catch (...) {
+            vlog(
+              clusterlog.info,
+              "leader balancer iteration failed: {}",
+              std::current_exception());
+        }
+        if (_transfers + _transfer_errors != moved) {
+            next = active_interval;
+        }
+    }
+    arm(next);
+}
+
+ss::future<> leader_balancer::balance() {
+    auto now = clock_type::now();
+    absl::erase_if(_muted, [now](const auto& p) { return p.second <= now; });
+
+    auto groups = collect_groups();
+    auto plan = plan_transfers(
+      groups,
+      config::shard_local_cfg().leader_balancer_transfers_per_tick(),
+      [this](raft::group_id g) { return is_muted(g); },
+      [this](const model::broker_shard& bs) { return is_target(bs); });
+
+    if (plan.empty()) {
+        vlog(clusterlog.trace, "leader balancer: leadership is balanced");
+        co_return;
+    }
+
+    auto mute_until
+      = now + config::shard_local_cfg().leader_balancer_mute_timeout();
+    for (const auto& t : plan) {
+        // a group that failed to move is muted as well, the target is likely
+        // to be down or not caught up
+        _muted[t.group] = mute_until;
+    }
+
+    co_await ss::parallel_for_each(
+      plan, [this](const transfer& t) { return do_transfer(t); });
+}
+
+std::vector<leader_balancer::group_replicas>
+leader_balancer::collect_groups() const {
+    std::vector<group_replicas> ret;
+    for (const auto& [tp_ns, md] : _topics.local().topics_map()) {
+        for (const auto& p : md.configuration.assignments) {
+            auto leader = _leaders.local().get_leader(tp_ns, p.id);
+            if (!leader) {
+                continue;
+            }
+            auto it = std::find_if(
+              p.replicas.cbegin(),
+              p.replicas.cend(),
+              [&leader](const model::broker_shard& bs) {
+                  return bs.node_id == *leader;
+              });
+            // the leaders table might not reflect the assignment yet
+            if (it == p.replicas.cend()) {
+                continue;
+            }
+            ret.push_back(group_replicas{
+              .group = p.group,
+              .ntp = model::ntp(tp_ns.ns, tp_ns.tp, p.id),
+              .leader = *it,
+              .replicas = p.replicas,
+            });
+        }
+    }
+    return ret;
+}
+
+bool leader_balancer::is_muted(raft::group_id g) const {
+    return _muted.contains(g);
+}
+
+bool leader_balancer::is_target(const model::broker_shard& bs) const {
+    auto broker = _members.local().get_broker(bs.node_id);
+    return broker
+           && (*broker)->get_membership_state()
+                == model::membership_state::active;
+}
+
+ss::future<> leader_balancer::do_transfer(const transfer& t) {
+    vlog(clusterlog.info, "leader balancer: moving leadership {}", t);
+    std::error_code ec;
+    try {
+        if (t.from.node_id == _raft0->self().id()) {
+            ec = co_await transfer_local(t);
+        } else {
+            ec = co_await transfer_remote(t);
+        }
+    } catch (...) {
+        vlog(
+          clusterlog.info,
+          "leader balancer: error moving leadership {} - {}",
+          t,
+          std::current_exception());
+        _transfer_errors++;
+        co_return;
+    }
+    if (ec) {
+        vlog(
+          clusterlog.info,
+          "leader balancer: error moving leadership {} - {}",
+          t,
+          ec.message());
+        _transfer_errors++;
+        co_return;
+    }
+    _transfers++;
+}
+
+ss::future<std::error_code>
+leader_balancer::transfer_local(const transfer& t) {
+    auto shard = _shard_table.local().shard_for(t.ntp);
+    if (!shard) {
+        return ss::make_ready_future<std::error_code>(
+          errc::partition_not_exists);
+    }
+    return _partition_manager.invoke_on(
+      *shard,
+      [ntp = t.ntp, target = t.to.node_id](partition_manager& pm) {
+          auto p = pm.get(ntp);
+          if (!p) {
+              return ss::make_ready_future<std::error_code>(
+                errc::partition_not_exists);
+          }
+          return p->transfer_leadership(target);
+      });
+}
+
+ss::future<std::error_code>
+leader_balancer::transfer_remote(const transfer& t) {
+    auto res = co_await _connections.local()
+                 .with_node_client<raft::raftgen_client_protocol>(
+                   _raft0->self().id(),
+                   ss::this_shard_id(),
+                   t.from.node_id,
+                   transfer_timeout,
+                   [req = raft::transfer_leadership_request{
+                      .group = t.group, .target = t.to.node_id}](
+                     raft::raftgen_client_protocol client) mutable {
+                       return client
+                         .transfer_leadership(
+                           std::move(req),
+                           rpc::client_opts(
+                             model::timeout_clock::now() + transfer_timeout))
+                         .then(&rpc::get_ctx_data<
+                               raft::transfer_leadership_reply>);
+                   });
+    if (res.has_error()) {
+        co_return res.error();
+    }
+    co_return raft::make_error_code(res.value().result);
+}
+
+void leader_balancer::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("cluster:leader_balancer"),
+      {
+        sm::make_derive(
+          "leader_transfers",
+          [this] { return _transfers; },
+          sm::description("Number of leadership transfers done by the leader "
+                          "balancer")),
+        sm::make_derive(
+          "leader_transfer_errors",
+          [this] { return _transfer_errors; },
+          sm::description("Number of leadership transfers requested by the "
+                          "leader balancer that failed")),
+        sm::make_gauge(
+          "paused",
+          [this] { return _paused ? 1 : 0; },
+          sm::description("Set to 1 when the leader balancer is paused")),
+      });
+}
+
+} // namespace cluster
@@ -0,0 +1,253 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "cluster/controller_stm.h"
+#include "cluster/fwd.h"
+#include "cluster/types.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "raft/types.h"
+#include "rpc/connection_cache.h"
+#include "seastarx.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace cluster {
+
+/**
+ * Evens out the number of raft group leaders across the shards of the
+ * cluster.
+ *
+ * When nodes restart the leadership of their groups moves to the nodes that
+ * stayed up and is never moved back. The balancer runs on the controller
+ * leader, periodically counts the leaders of every shard (using the
+ * partition assignments and the partition leaders table) and moves the
+ * leadership of groups from the most loaded shards to the least loaded
+ * replicas. The number of transfers of single iteration is bounded and a
+ * group that was moved is muted for a while so that the balancer never
+ * flaps the leadership of the same group.
+ *
+ * Transfers are requested from the current leader of the group with the
+ * transfer_leadership raft RPC, the leader catches up the target and
+ * hands over the leadership with timeout_now.
+ */
+class leader_balancer {
+public:
+    static constexpr ss::shard_id shard = controller_stm_shard;
+
+    using clock_type = ss::lowres_clock;
+
+    /// A single leadership transfer planned by the balancer
+    struct transfer {
+        raft::group_id group;
+        model::ntp ntp;
+        model::broker_shard from;
+        model::broker_shard to;
+
+        friend std::ostream& operator<<(std::ostream&, const transfer&);
+    };
+
+    /// Leaders and replicas of a group, the input of the balancing plan
+    struct group_replicas {
+        raft::group_id group;
+        model::ntp ntp;
+        model::broker_shard leader;
+        std::vector<model::broker_shard> replicas;
+    };
+
+    struct status {
+        bool enabled;
+        bool paused;
+        bool active;
+        uint64_t transfers;
+        uint64_t transfer_errors;
+    };
+
+    leader_balancer(
+      ss::sharded<topic_table>&,
+      ss::sharded<partition_leaders_table>&,
+      ss::sharded<members_table>&,
+      ss::sharded<rpc::connection_cache>&,
+      ss::sharded<shard_table>&,
+      ss::sharded<partition_manager>&,
+      consensus_ptr,
+      ss::sharded<ss::abort_source>&);
+
+    void start();
+    ss::future<> stop();
+
+    /// Stop issuing the transfers until resume() is called, the state is not
+    /// replicated, only the balancer of this node is paused
+    void pause() { _paused = true; }
+    void resume();
+
+    status get_status() const;
+
+    /**
+     * Plan at most `max_transfers` transfers that decrease the difference
+     * between the number of leaders of the most and the least loaded shards.
+     * Every group is moved at most once per plan and groups for which
+     * `is_muted` returns true are never moved. Shards for which `is_target`
+     * returns false do not receive leaders.
+     */
+    template<typename MutedPredicate, typename TargetPredicate>
+    static std::vector<transfer> plan_transfers(
+      const std::vector<group_replicas>&,
+      size_t max_transfers,
+      MutedPredicate&& is_muted,
+      TargetPredicate&& is_target);
+
+private:
+    void arm(clock_type::duration);
+    void setup_metrics();
+    ss::future<> tick();
+    ss::future<> balance();
+    std::vector<group_replicas> collect_groups() const;
+    ss::future<> do_transfer(const transfer&);
+    ss::future<std::error_code> transfer_local(const transfer&);
+    ss::future<std::error_code> transfer_remote(const transfer&);
+
+    bool is_muted(raft::group_id) const;
+    bool is_target(const model::broker_shard&) const;
+
+    /// Delay of the next iteration after the transfers, gives the new
+    /// leaders time to be elected and disseminated before counting again
+    static constexpr std::chrono::seconds active_interval{5};
+    // upper bound of the time the leader takes to catch up the target
+    static constexpr std::chrono::seconds transfer_timeout{10};
+
+    ss::sharded<topic_table>& _topics;
+    ss::sharded<partition_leaders_table>& _leaders;
+    ss::sharded<members_table>& _members;
+    ss::sharded<rpc::connection_cache>& _connections;
+    ss::sharded<shard_table>& _shard_table;
+    ss::sharded<partition_manager>& _partition_manager;
+    consensus_ptr _raft0;
+    ss::sharded<ss::abort_source>& _as;
+
+    bool _paused{false};
+    absl::flat_hash_map<raft::group_id, clock_type::time_point> _muted;
+    ss::timer<clock_type> _timer;
+    ss::gate _gate;
+
+    uint64_t _transfers{0};
+    uint64_t _transfer_errors{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+template<typename MutedPredicate, typename TargetPredicate>
+std::vector<leader_balancer::transfer> leader_balancer::plan_transfers(
+  const std::vector<group_replicas>& groups,
+  size_t max_transfers,
+  MutedPredicate&& is_muted,
+  TargetPredicate&& is_target) {
+    struct shard_state {
+        // number of leaders
+        uint32_t leaders{0};
+        // groups that are led by the shard and can still be moved
+        std::vector<const group_replicas*> movable;
+    };
+    absl::flat_hash_map<
+      model::broker_shard,
+      shard_state,
+      std::hash<model::broker_shard>>
+      shards;
+
+    for (const auto& g : groups) {
+        // shards without leaders are the best targets, make sure to track
+        // every replica
+        for (const auto& r : g.replicas) {
+            shards.try_emplace(r);
+        }
+        auto& leader = shards[g.leader];
+        leader.leaders++;
+        if (!is_muted(g.group)) {
+            leader.movable.push_back(&g);
+        }
+    }
+
+    std::vector<transfer> ret;
+    while (ret.size() < max_transfers) {
+        // the most loaded shard that still has groups to give away
+        auto from = shards.end();
+        for (auto it = shards.begin(); it != shards.end(); ++it) {
+            if (it->second.movable.empty()) {
+                continue;
+            }
+            if (
+              from == shards.end()
+              || it->second.leaders > from->second.leaders) {
+                from = it;
+            }
+        }
+        if (from == shards.end()) {
+            break;
+        }
+
+        // pick the group which has the least loaded replica
+        std::optional<size_t> best_group;
+        std::optional<model::broker_shard> best_target;
+        uint32_t best_leaders = 0;
+        auto& movable = from->second.movable;
+        for (size_t i = 0; i < movable.size(); ++i) {
+            for (const auto& r : movable[i]->replicas) {
+                if (r == from->first || !is_target(r)) {
+                    continue;
+                }
+                // every replica is already tracked
+                auto leaders = shards.at(r).leaders;
+                if (!best_target || leaders < best_leaders) {
+                    best_group = i;
+                    best_target = r;
+                    best_leaders = leaders;
+                }
+            }
+        }
+
+        // moving a leader only helps when the difference is larger than one
+        if (!best_target || from->second.leaders <= best_leaders + 1) {
+            // nothing can be moved away from this shard
+            movable.clear();
+            continue;
+        }
+
+        const auto* g = movable[*best_group];
+        ret.push_back(transfer{
+          .group = g->group,
+          .ntp = g->ntp,
+          .from = from->first,
+          .to = *best_target,
+        });
+        from->second.leaders--;
+        std::swap(movable[*best_group], movable.back());
+        movable.pop_back();
+        // the group is not added to the movable set of the target, every
+        // group is moved at most once per plan
+        shards.at(*best_target).leaders++;
+    }
+    return ret;
+}
+
+} // namespace cluster
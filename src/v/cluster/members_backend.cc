@@ -18,9 +18,11 @@
 #include <seastar/core/loop.hh>
 #include <seastar/util/later.hh>
 
+#include <absl/container/flat_hash_map.h>
 #include <absl/container/node_hash_set.h>
 #include <fmt/ostream.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <exception>
 #include <optional>
@@ -136,6 +138,19 @@ bool is_in_replica_set(
       });
 }
 
+size_t members_backend::remaining_replicas(
+  const partition_assignment& assignment) const {
+    return std::count_if(
+      assignment.replicas.cbegin(),
+      assignment.replicas.cend(),
+      [this](const model::broker_shard& bs) {
+          auto node = _members.local().get_broker(bs.node_id);
+          return node
+                 && node.value()->get_membership_state()
+                      != model::membership_state::draining;
+      });
+}
+
 void members_backend::calculate_reallocations(update_meta& meta) {
     switch (meta.update.type) {
     case members_manager::node_update_type::decommissioned:
@@ -148,18 +163,27 @@ void members_backend::calculate_reallocations(update_meta& meta) {
                       model::ntp(tp_ns.ns, tp_ns.tp, pas.id),
                       pas.replicas.size());
                     reallocation.replicas_to_remove.emplace(meta.update.id);
+                    reallocation.remaining_replicas = remaining_replicas(pas);
                     meta.partition_reallocations.push_back(
                       std::move(reallocation));
                 }
             }
         }
-        return;
+        break;
     case members_manager::node_update_type::added:
         calculate_reallocations_after_node_added(meta);
-        return;
+        break;
     default:
         return;
     }
+    // the partitions left with the fewest replicas are moved first
+    std::stable_sort(
+      meta.partition_reallocations.begin(),
+      meta.partition_reallocations.end(),
+      [](const partition_reallocation& lhs, const partition_reallocation& rhs) {
+          return lhs.remaining_replicas < rhs.remaining_replicas;
+      });
+    meta.started_at = clock_type::now();
 }
 /**
  * Simple helper class represeting how many replicas have to be moved from the
@@ -264,6 +288,7 @@ void members_backend::calculate_reallocations_after_node_added(
                       model::ntp(tp_ns.ns, tp_ns.tp, p.id), p.replicas.size());
 
                     reallocation.replicas_to_remove.emplace(to_move.id);
+                    reallocation.remaining_replicas = remaining_replicas(p);
                     meta.partition_reallocations.push_back(
                       std::move(reallocation));
                     to_move.left_to_move--;
@@ -305,11 +330,7 @@ ss::future<> members_backend::reconcile() {
     }
 
     // execute reallocations
-    co_await ss::parallel_for_each(
-      meta.partition_reallocations,
-      [this](partition_reallocation& reallocation) {
-          return reallocate_replica_set(reallocation);
-      });
+    co_await reallocate_partitions(meta);
 
     // remove those decommissioned nodes which doesn't have any pending
     // reallocations
@@ -333,6 +354,150 @@ ss::future<> members_backend::reconcile() {
     }
 }
 
+size_t members_backend::max_concurrent_moves() const {
+    size_t max_moves
+      = config::shard_local_cfg().members_backend_max_concurrent_moves();
+    // a move is recovered at most at the learner recovery rate of the
+    // partition leader, the number of moves bounds the recovery bandwidth
+    auto bandwidth
+      = config::shard_local_cfg().members_backend_recovery_bandwidth();
+    auto rate = config::shard_local_cfg().raft_learner_recovery_rate();
+    if (bandwidth && rate > 0) {
+        max_moves = std::min(max_moves, std::max<size_t>(1, *bandwidth / rate));
+    }
+    return max_moves;
+}
+
+ss::future<> members_backend::reallocate_partitions(update_meta& meta) {
+    // check if the requested moves are finished
+    co_await ss::parallel_for_each(
+      meta.partition_reallocations, [this](partition_reallocation& r) {
+          if (r.state != reallocation_state::requested) {
+              return ss::now();
+          }
+          return reallocate_replica_set(r);
+      });
+
+    // partitions moved by the operator or by the partition balancer count
+    // against the limit as well, they compete for the recovery bandwidth
+    const size_t max_moves = max_concurrent_moves();
+    const size_t in_progress = _topics.local().updates_in_progress();
+    if (in_progress >= max_moves) {
+        vlog(
+          clusterlog.trace,
+          "{} partition moves in progress, not scheduling more",
+          in_progress);
+        co_return;
+    }
+    const size_t max_per_node
+      = config::shard_local_cfg().members_backend_max_moves_per_node();
+
+    absl::flat_hash_map<model::node_id, size_t> per_node;
+    for (const auto& r : meta.partition_reallocations) {
+        if (r.state == reallocation_state::requested) {
+            for (auto id : r.targets) {
+                per_node[id]++;
+            }
+        }
+    }
+    auto is_busy = [&per_node, max_per_node](const partition_reallocation& r) {
+        return std::any_of(
+          r.targets.begin(),
+          r.targets.end(),
+          [&per_node, max_per_node](model::node_id id) {
+              auto it = per_node.find(id);
+              return it != per_node.end() && it->second >= max_per_node;
+          });
+    };
+
+    // in the priority order
+    std::vector<partition_reallocation*> to_start;
+    for (auto& r : meta.partition_reallocations) {
+        if (to_start.size() >= max_moves - in_progress) {
+            break;
+        }
+        if (
+          r.state != reallocation_state::initial
+          && r.state != reallocation_state::reassigned) {
+            continue;
+        }
+        if (r.state == reallocation_state::initial) {
+            auto current = _topics.local().get_partition_assignment(r.ntp);
+            // topic was deleted, we are done with reallocation
+            if (!current) {
+                r.state = reallocation_state::finished;
+                continue;
+            }
+            reassign_replicas(*current, r);
+            if (!r.new_assignment) {
+                continue;
+            }
+            if (is_busy(r)) {
+                // release the allocation, the partition may be placed on a
+                // different node the next time
+                r.new_assignment.reset();
+                r.targets.clear();
+                continue;
+            }
+            r.state = reallocation_state::reassigned;
+        } else if (is_busy(r)) {
+            continue;
+        }
+        for (auto id : r.targets) {
+            per_node[id]++;
+        }
+        to_start.push_back(&r);
+    }
+
+    co_await ss::parallel_for_each(to_start, [this](partition_reallocation* r) {
+        return reallocate_replica_set(*r);
+    });
+}
+
+members_backend::status members_backend::get_status() const {
+    status ret{.active = _raft0->is_leader()};
+    const auto now = clock_type::now();
+    for (const auto& meta : _updates) {
+        if (meta.finished) {
+            continue;
+        }
+        update_status st{
+          .id = meta.update.id,
+          .type = meta.update.type,
+          .partitions_total = meta.partition_reallocations.size(),
+          .elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - meta.started_at),
+        };
+        for (const auto& r : meta.partition_reallocations) {
+            if (r.state == reallocation_state::finished) {
+                st.partitions_finished++;
+                continue;
+            }
+            partition_status p{.ntp = r.ntp, .state = r.state};
+            if (r.new_assignment) {
+                p.replicas
+                  = r.new_assignment->get_assignments().front().replicas;
+            }
+            if (r.state == reallocation_state::requested) {
+                st.partitions_moving++;
+                if (r.requested_at) {
+                    p.moving_for
+                      = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        now - *r.requested_at);
+                }
+            }
+            st.partitions.push_back(std::move(p));
+        }
+        if (st.partitions_finished > 0) {
+            auto left = st.partitions_total - st.partitions_finished;
+            st.eta = std::chrono::milliseconds(
+              st.elapsed.count() * left / st.partitions_finished);
+        }
+        ret.updates.push_back(std::move(st));
+    }
+    return ret;
+}
+
 ss::future<>
 members_backend::try_to_finish_update(members_backend::update_meta& meta) {
     // broker was removed, finish
@@ -381,6 +546,11 @@ void members_backend::reassign_replicas(
       reallocation.ntp,
       current_assignment);
 
+    absl::node_hash_set<model::node_id> current_nodes;
+    for (const auto& bs : current_assignment.replicas) {
+        current_nodes.emplace(bs.node_id);
+    }
+
     // remove nodes that are going to be reassigned from current assignment.
     std::erase_if(
       current_assignment.replicas,
@@ -392,6 +562,13 @@ void members_backend::reassign_replicas(
       reallocation.constraints, current_assignment);
     if (res.has_value()) {
         reallocation.new_assignment = std::move(res.value());
+        reallocation.targets.clear();
+        for (const auto& bs :
+             reallocation.new_assignment->get_assignments().front().replicas) {
+            if (!current_nodes.contains(bs.node_id)) {
+                reallocation.targets.push_back(bs.node_id);
+            }
+        }
         vlog(
           clusterlog.debug,
           "new assignment for {} - {}",
@@ -449,6 +626,7 @@ ss::future<> members_backend::reallocate_replica_set(
         }
         // success, update state and move on
         meta.state = reallocation_state::requested;
+        meta.requested_at = clock_type::now();
         [[fallthrough]];
     }
     case reallocation_state::requested: {
@@ -489,6 +667,21 @@ void members_backend::handle_recommissioned(
     });
 }
 
+std::ostream&
+operator<<(std::ostream& o, members_backend::reallocation_state state) {
+    switch (state) {
+    case members_backend::reallocation_state::initial:
+        return o << "initial";
+    case members_backend::reallocation_state::reassigned:
+        return o << "reassigned";
+    case members_backend::reallocation_state::requested:
+        return o << "requested";
+    case members_backend::reallocation_state::finished:
+        return o << "finished";
+    }
+    return o << "unknown";
+}
+
 void members_backend::handle_reallocation_finished(model::node_id id) {
     // remove all pending added node updates for this node
     std::erase_if(_updates, [id](update_meta& meta) {
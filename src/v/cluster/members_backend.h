@@ -10,14 +10,30 @@
 #include "raft/consensus.h"
 
 #include <seastar/core/condition-variable.hh>
+#include <seastar/core/lowres_clock.hh>
 
 #include <absl/container/node_hash_set.h>
 
 #include <chrono>
+#include <optional>
+#include <vector>
 namespace cluster {
 
+/**
+ * Moves the replicas away from decommissioned nodes and onto added nodes.
+ *
+ * The moves are scheduled with bounded concurrency: the number of partitions
+ * being moved in the cluster (by the backend or not) and the number of moves
+ * recovering to each node are limited. A move is recovered at most at the
+ * raft learner recovery rate of the partition leader, the recovery bandwidth
+ * budget of the cluster is enforced by limiting the number of moves. The
+ * partitions with the fewest replicas left outside of the decommissioned
+ * nodes are moved first.
+ */
 class members_backend {
 public:
+    using clock_type = ss::lowres_clock;
+
     enum class reallocation_state { initial, reassigned, requested, finished };
     struct partition_reallocation {
         explicit partition_reallocation(
@@ -30,6 +46,12 @@ public:
         absl::node_hash_set<model::node_id> replicas_to_remove;
         std::optional<allocation_units> new_assignment;
         reallocation_state state = reallocation_state::initial;
+        // replicas that are not on decommissioned nodes, the partitions with
+        // the fewest are the most at risk and are moved first
+        size_t remaining_replicas{0};
+        // nodes receiving a new replica of the partition
+        std::vector<model::node_id> targets;
+        std::optional<clock_type::time_point> requested_at;
     };
     /**
      * struct describing partition reallocation
@@ -41,6 +63,34 @@ public:
         members_manager::node_update update;
         std::vector<partition_reallocation> partition_reallocations;
         bool finished = false;
+        clock_type::time_point started_at = clock_type::now();
+    };
+
+    struct partition_status {
+        model::ntp ntp;
+        reallocation_state state;
+        // set once the target replica set is known
+        std::vector<model::broker_shard> replicas;
+        std::optional<std::chrono::milliseconds> moving_for;
+    };
+
+    struct update_status {
+        model::node_id id;
+        members_manager::node_update_type type;
+        size_t partitions_total{0};
+        size_t partitions_finished{0};
+        size_t partitions_moving{0};
+        std::chrono::milliseconds elapsed{0};
+        // extrapolated from the rate of finished moves, unknown until the
+        // first move is finished
+        std::optional<std::chrono::milliseconds> eta;
+        // partitions that are not yet moved
+        std::vector<partition_status> partitions;
+    };
+
+    struct status {
+        bool active;
+        std::vector<update_status> updates;
     };
 
     members_backend(
@@ -57,10 +107,15 @@ public:
     void start();
     ss::future<> stop();
 
+    status get_status() const;
+
 private:
     void start_reconciliation_loop();
     ss::future<> reconcile();
     ss::future<> reallocate_replica_set(partition_reallocation&);
+    ss::future<> reallocate_partitions(update_meta&);
+    size_t max_concurrent_moves() const;
+    size_t remaining_replicas(const partition_assignment&) const;
 
     ss::future<> try_to_finish_update(update_meta&);
     void calculate_reallocations(update_meta&);
@@ -90,4 +145,6 @@ private:
     ss::condition_variable _new_updates;
 };
 
+std::ostream& operator<<(std::ostream&, members_backend::reallocation_state);
+
 } // namespace cluster
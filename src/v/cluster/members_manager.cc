@@ -163,7 +163,8 @@ ss::future<> members_manager::handle_raft0_cfg_update(
             cfg.for_each_broker([&allocator](const model::broker& n) {
                 if (!allocator.contains_node(n.id())) {
                     allocator.register_node(std::make_unique<allocation_node>(
-                      allocation_node(n.id(), n.properties().cores, {})));
+                      allocation_node(
+                        n.id(), n.properties().cores, {}, n.rack())));
                 }
             });
         })
@@ -201,17 +202,20 @@ ss::future<> members_manager::handle_raft0_cfg_update(
 ss::future<std::error_code>
 members_manager::apply_update(model::record_batch b) {
     // handle node managements command
+    auto offset = b.base_offset();
     auto cmd = co_await cluster::deserialize(std::move(b), accepted_commands);
 
     co_return co_await ss::visit(
       cmd,
-      [this](decommission_node_cmd cmd) mutable {
+      [this, offset](decommission_node_cmd cmd) mutable {
           auto id = cmd.key;
           return dispatch_updates_to_cores(cmd).then(
-            [this, id](std::error_code error) {
+            [this, id, offset](std::error_code error) {
                 auto f = ss::now();
                 if (!error) {
                     _allocator.local().decommission_node(id);
+                    _decommissioned[id] = decommission_state{
+                      .decommissioned = offset};
                     f = _update_queue.push_eventually(node_update{
                       .id = id, .type = node_update_type::decommissioned});
                 }
@@ -225,16 +229,21 @@ members_manager::apply_update(model::record_batch b) {
                 auto f = ss::now();
                 if (!error) {
                     _allocator.local().recommission_node(id);
+                    _decommissioned.erase(id);
                     f = _update_queue.push_eventually(node_update{
                       .id = id, .type = node_update_type::recommissioned});
                 }
                 return f.then([error] { return error; });
             });
       },
-      [this](finish_reallocations_cmd cmd) mutable {
+      [this, offset](finish_reallocations_cmd cmd) mutable {
           // we do not have to dispatch this command to members table since this
           // command is only used by a backend to signal successfully finished
           // node reallocations
+          if (auto it = _decommissioned.find(cmd.key);
+              it != _decommissioned.end()) {
+              it->second.reallocations_finished = offset;
+          }
           return _update_queue
             .push_eventually(node_update{
               .id = cmd.key, .type = node_update_type::reallocation_finished})
@@ -242,6 +251,23 @@ members_manager::apply_update(model::record_batch b) {
       });
 }
 
+ss::future<std::vector<model::record_batch>>
+members_manager::snapshot_commands() const {
+    std::vector<std::pair<model::node_id, decommission_state>> nodes(
+      _decommissioned.begin(), _decommissioned.end());
+
+    std::vector<model::record_batch> ret;
+    for (auto& [id, state] : nodes) {
+        ret.push_back(co_await serialize_cmd(
+          decommission_node_cmd(id, 0), state.decommissioned));
+        if (state.reallocations_finished) {
+            ret.push_back(co_await serialize_cmd(
+              finish_reallocations_cmd(id, 0), *state.reallocations_finished));
+        }
+    }
+    co_return ret;
+}
+
 ss::future<std::vector<members_manager::node_update>>
 members_manager::get_node_updates() {
     if (_update_queue.empty()) {
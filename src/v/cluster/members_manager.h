@@ -24,6 +24,10 @@
 #include "rpc/connection_cache.h"
 #include "storage/fwd.h"
 
+#include <absl/container/flat_hash_map.h>
+
+#include <optional>
+
 namespace cluster {
 
 // Members manager class is responsible for updating information about
@@ -81,7 +85,17 @@ public:
      */
     ss::future<std::vector<node_update>> get_node_updates();
 
+    /// Returns the commands that rebuild the state of the decommissioned
+    /// nodes. Node membership is part of the raft0 configuration and doesn't
+    /// need the commands.
+    ss::future<std::vector<model::record_batch>> snapshot_commands() const;
+
 private:
+    struct decommission_state {
+        model::offset decommissioned;
+        std::optional<model::offset> reallocations_finished;
+    };
+
     using seed_iterator = std::vector<config::seed_server>::const_iterator;
     // Cluster join
     void join_raft0();
@@ -128,6 +142,7 @@ private:
     ss::gate _gate;
     ss::queue<node_update> _update_queue;
     ss::abort_source::subscription _queue_abort_subscription;
+    absl::flat_hash_map<model::node_id, decommission_state> _decommissioned;
 };
 
 std::ostream&
@@ -76,6 +76,19 @@ std::vector<model::topic_metadata> metadata_cache::all_topics_metadata() const {
     return all_md;
 }
 
+metadata_cache::topics_summary metadata_cache::summarize_topics() const {
+    topics_summary ret;
+    for (const auto& [tp_ns, md] : _topics_state.local().topics_map()) {
+        ret.topics++;
+        ret.name_bytes += tp_ns.tp().size();
+        ret.partitions += md.configuration.assignments.size();
+        for (const auto& p_as : md.configuration.assignments) {
+            ret.replicas += p_as.replicas.size();
+        }
+    }
+    return ret;
+}
+
 std::optional<broker_ptr> metadata_cache::get_broker(model::node_id nid) const {
     return _members_table.local().get_broker(nid);
 }
@@ -100,11 +113,38 @@ ss::future<model::node_id> metadata_cache::get_leader(
     return _leaders.local().wait_for_leader(ntp, tout, as);
 }
 
+std::optional<model::term_id> metadata_cache::get_leader_term(
+  model::topic_namespace_view tp_ns, model::partition_id pid) const {
+    return _leaders.local().get_leader_term(tp_ns, pid);
+}
+
 /// If present returns a leader of raft0 group
 std::optional<model::node_id> metadata_cache::get_controller_leader_id() {
     return _leaders.local().get_leader(model::controller_ntp);
 }
 
+metadata_cache::topic_change_notification_id
+metadata_cache::register_topic_change_notification(topic_change_cb_t cb) {
+    auto shared_cb = ss::make_lw_shared<topic_change_cb_t>(std::move(cb));
+    auto topics = _topics_state.local().register_delta_notification(
+      [shared_cb](const std::vector<topic_table::delta>& deltas) {
+          for (const auto& d : deltas) {
+              (*shared_cb)(d.tp_ns());
+          }
+      });
+    auto leaders = _leaders.local().register_leadership_change_notification(
+      [shared_cb](const model::ntp& ntp, std::optional<model::node_id>) {
+          (*shared_cb)(model::topic_namespace_view(ntp));
+      });
+    return topic_change_notification_id{.topics = topics, .leaders = leaders};
+}
+
+void metadata_cache::unregister_topic_change_notification(
+  topic_change_notification_id id) {
+    _topics_state.local().unregister_delta_notification(id.topics);
+    _leaders.local().unregister_leadership_change_notification(id.leaders);
+}
+
 /**
  * hard coded defaults
  */
@@ -19,6 +19,7 @@
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 #include <absl/container/flat_hash_map.h>
 
@@ -80,6 +81,16 @@ public:
     /// Returns metadata of all topics.
     std::vector<model::topic_metadata> all_topics_metadata() const;
 
+    struct topics_summary {
+        size_t topics{0};
+        size_t name_bytes{0};
+        size_t partitions{0};
+        size_t replicas{0};
+    };
+    /// Returns the number of topics, partitions and replicas of all topics,
+    /// without copying their metadata.
+    topics_summary summarize_topics() const;
+
     /// Returns all brokers, returns copy as the content of broker can change
     std::vector<broker_ptr> all_brokers() const;
 
@@ -111,9 +122,28 @@ public:
       ss::lowres_clock::time_point,
       std::optional<std::reference_wrapper<ss::abort_source>> = std::nullopt);
 
+    /// Returns the term of the current leader of a partition, known once the
+    /// partition has a leader
+    std::optional<model::term_id>
+      get_leader_term(model::topic_namespace_view, model::partition_id) const;
+
     /// If present returns a leader of raft0 group
     std::optional<model::node_id> get_controller_leader_id();
 
+    /// Callback invoked on this shard when the partitions, the replicas or
+    /// the leaders of a topic change
+    using topic_change_cb_t
+      = ss::noncopyable_function<void(model::topic_namespace_view)>;
+
+    struct topic_change_notification_id {
+        notification_id_type topics;
+        notification_id_type leaders;
+    };
+
+    topic_change_notification_id
+      register_topic_change_notification(topic_change_cb_t);
+    void unregister_topic_change_notification(topic_change_notification_id);
+
     model::compression get_default_compression() const;
     model::cleanup_policy_bitflags get_default_cleanup_policy_bitflags() const;
     model::compaction_strategy get_default_compaction_strategy() const;
@@ -77,4 +77,43 @@ ss::future<get_leadership_reply> metadata_dissemination_handler::get_leadership(
       });
 }
 
+static get_leadership_delta_reply make_get_leadership_delta_reply(
+  const partition_leaders_table& leaders, get_leadership_delta_request req) {
+    get_leadership_delta_reply reply{
+      .incarnation = leaders.incarnation(),
+      .version = leaders.version(),
+    };
+    // versions of a different incarnation can't be compared, send everything
+    auto since = req.version;
+    if (req.incarnation != leaders.incarnation()) {
+        reply.full = true;
+        since = 0;
+    }
+    leaders.for_each_leader_since(
+      since,
+      [&reply](
+        model::topic_namespace_view tp_ns,
+        model::partition_id pid,
+        std::optional<model::node_id> leader,
+        model::term_id term) mutable {
+          reply.leaders.emplace_back(ntp_leader{
+            .ntp = model::ntp(tp_ns.ns, tp_ns.tp, pid),
+            .term = term,
+            .leader_id = leader});
+      });
+    return reply;
+}
+
+ss::future<get_leadership_delta_reply>
+metadata_dissemination_handler::get_leadership_delta(
+  get_leadership_delta_request&& req, rpc::streaming_context&) {
+    return ss::with_scheduling_group(get_scheduling_group(), [this, req] {
+        // every shard has its own copy of the table and its own versions,
+        // the requester keeps track of the versions of shard 0
+        return _leaders.invoke_on(0, [req](partition_leaders_table& leaders) {
+            return make_get_leadership_delta_reply(leaders, req);
+        });
+    });
+}
+
 } // namespace cluster
@@ -30,6 +30,11 @@ namespace cluster {
 /// 2. get_leadership - send to any node that already belong to cluster
 ///                     after controller recovery to get the up to date
 ///                     leadership metadata
+///
+/// 3. get_leadership_delta - like get_leadership but only returns the
+///                           leadership changed since the version that the
+///                           requester already has, used to periodically
+///                           catch up with the updates that were missed
 
 class metadata_dissemination_handler
   : public metadata_dissemination_rpc_service {
@@ -45,6 +50,9 @@ public:
     ss::future<get_leadership_reply>
     get_leadership(get_leadership_request&&, rpc::streaming_context&) final;
 
+    ss::future<get_leadership_delta_reply> get_leadership_delta(
+      get_leadership_delta_request&&, rpc::streaming_context&) final;
+
 private:
     ss::future<update_leadership_reply>
     do_update_leadership(update_leadership_request&&);
@@ -10,6 +10,7 @@
 #include "cluster/metadata_dissemination_service.h"
 
 #include "cluster/cluster_utils.h"
+#include "cluster/errc.h"
 #include "cluster/logger.h"
 #include "cluster/members_table.h"
 #include "cluster/metadata_cache.h"
@@ -25,6 +26,7 @@
 #include "model/metadata.h"
 #include "model/namespace.h"
 #include "model/timeout_clock.h"
+#include "random/generators.h"
 #include "rpc/connection_cache.h"
 #include "rpc/types.h"
 #include "utils/retry.h"
@@ -33,6 +35,7 @@
 #include "vlog.h"
 
 #include <seastar/core/abort_source.hh>
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/sleep.hh>
@@ -60,11 +63,18 @@ metadata_dissemination_service::metadata_dissemination_service(
   , _self(make_self_broker(config::shard_local_cfg()))
   , _dissemination_interval(
       config::shard_local_cfg().metadata_dissemination_interval_ms)
+  , _resync_interval(
+      config::shard_local_cfg().metadata_dissemination_resync_interval_ms)
   , _rpc_tls_config(config::shard_local_cfg().rpc_server_tls()) {
     _dispatch_timer.set_callback([this] {
         (void)ss::with_gate(
           _bg, [this] { return dispatch_disseminate_leadership(); });
     });
+    _resync_timer.set_callback([this] {
+        (void)ss::with_gate(_bg, [this] {
+            return resync_leadership().finally([this] { arm_resync_timer(); });
+        });
+    });
     _dispatch_timer.arm(_dissemination_interval);
 
     for (auto& seed : config::shard_local_cfg().seed_servers()) {
@@ -104,6 +114,7 @@ ss::future<> metadata_dissemination_service::start() {
     if (ss::this_shard_id() != 0) {
         return ss::make_ready_future<>();
     }
+    arm_resync_timer();
     // poll either seed servers or configuration
     auto all_brokers = _members_table.local().all_brokers();
     // use hash set to deduplicate ids
@@ -198,8 +209,17 @@ ss::future<> metadata_dissemination_service::update_metadata_with_retries(
 
 ss::future<> metadata_dissemination_service::do_request_metadata_update(
   request_retry_meta& meta) {
-    return dispatch_get_metadata_update(*meta.next)
-      .then([this, &meta](result<get_leadership_reply> r) {
+    return dispatch_get_metadata_update(*meta.next, {})
+      .then([this, address = *meta.next](
+              result<get_leadership_delta_reply> r) {
+          if (r) {
+              return ss::make_ready_future<result<get_leadership_delta_reply>>(
+                std::move(r));
+          }
+          // nodes running an older version only serve the full set
+          return dispatch_get_full_metadata_update(address);
+      })
+      .then([this, &meta](result<get_leadership_delta_reply> r) {
           return process_get_update_reply(std::move(r), meta);
       })
       .handle_exception([](const std::exception_ptr& e) {
@@ -223,7 +243,7 @@ ss::future<> metadata_dissemination_service::do_request_metadata_update(
 }
 
 ss::future<> metadata_dissemination_service::process_get_update_reply(
-  result<get_leadership_reply> reply_result, request_retry_meta& meta) {
+  result<get_leadership_delta_reply> reply_result, request_retry_meta& meta) {
     if (!reply_result) {
         vlog(
           clusterlog.debug,
@@ -231,35 +251,142 @@ ss::future<> metadata_dissemination_service::process_get_update_reply(
           *meta.next);
         return ss::make_ready_future<>();
     }
+    // catch up with the same node later on, unless it only served the full
+    // set in which case a source is going to be picked when resyncing
+    if (reply_result.value().incarnation != 0) {
+        _resync_source = resync_source{
+          .address = *meta.next,
+          .incarnation = reply_result.value().incarnation,
+          .version = reply_result.value().version,
+        };
+    }
     // Update all NTP leaders
-    return _leaders
-      .invoke_on_all([reply = std::move(reply_result.value())](
-                       partition_leaders_table& leaders) mutable {
+    return apply_leadership_reply(std::move(reply_result.value()))
+      .then([&meta] { meta.success = true; });
+}
+
+ss::future<> metadata_dissemination_service::apply_leadership_reply(
+  get_leadership_delta_reply reply) {
+    return _leaders.invoke_on_all(
+      [reply = std::move(reply)](partition_leaders_table& leaders) mutable {
           for (auto& l : reply.leaders) {
               leaders.update_partition_leader(l.ntp, l.term, l.leader_id);
           }
-      })
-      .then([&meta] { meta.success = true; });
+      });
 }
 
-ss::future<result<get_leadership_reply>>
+ss::future<result<get_leadership_delta_reply>>
 metadata_dissemination_service::dispatch_get_metadata_update(
-  unresolved_address address) {
-    vlog(clusterlog.debug, "Requesting metadata update from node {}", address);
+  unresolved_address address, get_leadership_delta_request req) {
+    vlog(
+      clusterlog.debug,
+      "Requesting metadata update from node {} since version {}:{}",
+      address,
+      req.incarnation,
+      req.version);
     return do_with_client_one_shot<metadata_dissemination_rpc_client_protocol>(
       address,
       _rpc_tls_config,
       _dissemination_interval,
-      [this](metadata_dissemination_rpc_client_protocol c) {
+      [this, req](metadata_dissemination_rpc_client_protocol c) {
           return c
-            .get_leadership(
-              get_leadership_request{},
+            .get_leadership_delta(
+              req,
               rpc::client_opts(
                 rpc::clock_type::now() + _dissemination_interval))
-            .then(&rpc::get_ctx_data<get_leadership_reply>);
+            .then(&rpc::get_ctx_data<get_leadership_delta_reply>);
+      });
+}
+
+ss::future<result<get_leadership_delta_reply>>
+metadata_dissemination_service::dispatch_get_full_metadata_update(
+  unresolved_address address) {
+    vlog(clusterlog.debug, "Requesting metadata update from node {}", address);
+    return do_with_client_one_shot<metadata_dissemination_rpc_client_protocol>(
+             address,
+             _rpc_tls_config,
+             _dissemination_interval,
+             [this](metadata_dissemination_rpc_client_protocol c) {
+                 return c
+                   .get_leadership(
+                     get_leadership_request{},
+                     rpc::client_opts(
+                       rpc::clock_type::now() + _dissemination_interval))
+                   .then(&rpc::get_ctx_data<get_leadership_reply>);
+             })
+      .then([](result<get_leadership_reply> r)
+              -> result<get_leadership_delta_reply> {
+          if (!r) {
+              return r.error();
+          }
+          return get_leadership_delta_reply{
+            .full = true, .leaders = std::move(r.value().leaders)};
       });
 }
 
+void metadata_dissemination_service::arm_resync_timer() {
+    if (_bg.is_closed()) {
+        return;
+    }
+    _resync_timer.arm(_resync_interval);
+}
+
+std::optional<metadata_dissemination_service::resync_source>
+metadata_dissemination_service::pick_resync_source() const {
+    std::vector<unresolved_address> addresses;
+    for (auto& b : _members_table.local().all_brokers()) {
+        if (b->id() != _self.id()) {
+            addresses.push_back(b->rpc_address());
+        }
+    }
+    if (addresses.empty()) {
+        return std::nullopt;
+    }
+    auto idx = random_generators::get_int<size_t>(0, addresses.size() - 1);
+    // incarnation 0, the first reply contains all the partitions
+    return resync_source{.address = addresses[idx]};
+}
+
+ss::future<> metadata_dissemination_service::resync_leadership() {
+    if (!_resync_source) {
+        _resync_source = pick_resync_source();
+        if (!_resync_source) {
+            co_return;
+        }
+    }
+    auto source = *_resync_source;
+    result<get_leadership_delta_reply> reply = errc::timeout;
+    try {
+        reply = co_await dispatch_get_metadata_update(
+          source.address,
+          get_leadership_delta_request{
+            .incarnation = source.incarnation, .version = source.version});
+    } catch (...) {
+        vlog(
+          clusterlog.debug,
+          "Unable to resync leadership metadata with node {} - {}",
+          source.address,
+          std::current_exception());
+    }
+    if (!reply) {
+        // try another node next time
+        _resync_source.reset();
+        co_return;
+    }
+    vlog(
+      clusterlog.trace,
+      "Received {} leadership updates from node {}, full: {}",
+      reply.value().leaders.size(),
+      source.address,
+      reply.value().full);
+    _resync_source = resync_source{
+      .address = source.address,
+      .incarnation = reply.value().incarnation,
+      .version = reply.value().version,
+    };
+    co_await apply_leadership_reply(std::move(reply.value()));
+}
+
 void metadata_dissemination_service::collect_pending_updates() {
     auto brokers = _members_table.local().all_broker_ids();
     for (auto& ntp_leader : _requests) {
@@ -283,10 +410,13 @@ void metadata_dissemination_service::collect_pending_updates() {
             return n == _self.id();
         });
         for (auto& id : non_overlapping) {
-            if (!_pending_updates.contains(id)) {
-                _pending_updates.emplace(id, update_retry_meta{ntp_leaders{}});
+            auto& updates = _pending_updates[id].updates;
+            // only the latest update of a partition is sent
+            auto [it, inserted] = updates.try_emplace(
+              ntp_leader.ntp, ntp_leader);
+            if (!inserted && it->second.term <= ntp_leader.term) {
+                it->second = ntp_leader;
             }
-            _pending_updates[id].updates.push_back(ntp_leader);
         }
     }
     _requests.clear();
@@ -334,9 +464,14 @@ ss::future<> metadata_dissemination_service::dispatch_one_update(
               "Sending {} metadata updates to {}",
               meta.updates.size(),
               target_id);
+            update_leadership_request req;
+            req.leaders.reserve(meta.updates.size());
+            for (auto& [_, l] : meta.updates) {
+                req.leaders.push_back(l);
+            }
             return proto
               .update_leadership(
-                update_leadership_request{meta.updates},
+                std::move(req),
                 rpc::client_opts(
                   _dissemination_interval + rpc::clock_type::now()))
               .then(&rpc::get_ctx_data<update_leadership_reply>);
@@ -362,6 +497,7 @@ ss::future<> metadata_dissemination_service::stop() {
       _notification_handle);
     _as.request_abort();
     _dispatch_timer.cancel();
+    _resync_timer.cancel();
     return _bg.close();
 }
 
@@ -24,7 +24,9 @@
 #include "utils/unresolved_address.h"
 
 #include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
 
 #include <absl/container/flat_hash_map.h>
 
@@ -40,6 +42,14 @@ namespace cluster {
 /// responsible for querying one of the cluster nodes for current leadership
 /// metadata when node has started.
 ///
+/// Pending updates are compacted by ntp, only the update with the highest
+/// term is sent. After the initial query the node periodically asks the same
+/// node for the leadership changed since the version of its leadership table
+/// it received last, updates that were lost (e.g. when the node was not
+/// reachable) are caught up without transferring the whole leadership set.
+/// The full set is only sent again when the versions can't be compared, i.e.
+/// the queried node restarted.
+///
 /// Used acronymes:
 /// RG<num> - raft group with <num> id
 ///
@@ -92,9 +102,16 @@ private:
     // When update was delivered successfully the finished flag is set to true
     // and object is removed from pending updates map
     struct update_retry_meta {
-        ntp_leaders updates;
+        absl::flat_hash_map<model::ntp, ntp_leader> updates;
         bool finished = false;
     };
+    // Node queried for the leadership changes and the version of its table
+    // that was received last
+    struct resync_source {
+        unresolved_address address;
+        uint64_t incarnation{0};
+        uint64_t version{0};
+    };
     // Used to track the process of requesting update when redpanda starts
     // when update using a node from ids will fail we will try the next one
     struct request_retry_meta {
@@ -118,11 +135,19 @@ private:
     void cleanup_finished_updates();
     ss::future<> dispatch_disseminate_leadership();
     ss::future<> dispatch_one_update(model::node_id, update_retry_meta&);
-    ss::future<result<get_leadership_reply>>
-      dispatch_get_metadata_update(unresolved_address);
+    ss::future<result<get_leadership_delta_reply>>
+      dispatch_get_metadata_update(
+        unresolved_address, get_leadership_delta_request);
+    ss::future<result<get_leadership_delta_reply>>
+      dispatch_get_full_metadata_update(unresolved_address);
     ss::future<> do_request_metadata_update(request_retry_meta&);
-    ss::future<>
-    process_get_update_reply(result<get_leadership_reply>, request_retry_meta&);
+    ss::future<> process_get_update_reply(
+      result<get_leadership_delta_reply>, request_retry_meta&);
+    ss::future<> apply_leadership_reply(get_leadership_delta_reply);
+
+    void arm_resync_timer();
+    ss::future<> resync_leadership();
+    std::optional<resync_source> pick_resync_source() const;
 
     ss::future<> update_metadata_with_retries(std::vector<unresolved_address>);
 
@@ -134,12 +159,16 @@ private:
     ss::sharded<rpc::connection_cache>& _clients;
     model::broker _self;
     std::chrono::milliseconds _dissemination_interval;
+    std::chrono::milliseconds _resync_interval;
     config::tls_config _rpc_tls_config;
     std::vector<ntp_leader> _requests;
     std::vector<unresolved_address> _seed_servers;
     broker_updates_t _pending_updates;
     mutex _lock;
     ss::timer<> _dispatch_timer;
+    // only used on shard 0
+    std::optional<resync_source> _resync_source;
+    ss::timer<> _resync_timer;
     ss::abort_source _as;
     ss::gate _bg;
     cluster::notification_id_type _notification_handle;
@@ -37,6 +37,22 @@ struct get_leadership_reply {
     ntp_leaders leaders;
 };
 
+/// Asks for the leadership updates applied by the node after the given
+/// version of its leadership table. Incarnation 0 asks for the full set.
+struct get_leadership_delta_request {
+    uint64_t incarnation{0};
+    uint64_t version{0};
+};
+
+struct get_leadership_delta_reply {
+    uint64_t incarnation{0};
+    uint64_t version{0};
+    // the requested version couldn't be served, e.g. the node restarted,
+    // leaders contain all the partitions
+    bool full{false};
+    ntp_leaders leaders;
+};
+
 inline std::ostream& operator<<(std::ostream& o, const ntp_leader& l) {
     o << "{ " << l.ntp << ", term: " << l.term
       << ", leader_id: " << (l.leader_id ? l.leader_id.value()() : -1) << " }";
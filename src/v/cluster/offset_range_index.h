@@ -0,0 +1,103 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/fundamental.h"
+
+#include <absl/container/btree_map.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace cluster {
+
+/**
+ * Set of inclusive offset ranges (e.g. aborted transactions) indexed for
+ * overlap queries.
+ *
+ * Ranges are ordered by their last offset and the index tracks the longest
+ * range, so the ranges overlapping [from, to] are all between the first one
+ * that ends at or after `from` and the first one that ends after
+ * `to + longest`. A query costs O(log n + k) where k is the number of ranges
+ * ending in that window.
+ *
+ * Range must have `model::offset first` and `model::offset last` members.
+ */
+template<typename Range>
+class offset_range_index {
+public:
+    void add(Range r) {
+        _max_span = std::max(_max_span, span(r));
+        auto last = r.last;
+        _ranges.emplace(last, std::move(r));
+    }
+
+    /// Ranges that have at least one offset in [from, to], ordered by their
+    /// last offsets
+    std::vector<Range>
+    overlapping(model::offset from, model::offset to) const {
+        std::vector<Range> ret;
+        if (from > to) {
+            return ret;
+        }
+        // the last offset of a range that starts at or before `to`
+        const auto limit = to() > max_offset() - _max_span
+                             ? model::offset(max_offset())
+                             : model::offset(to() + _max_span);
+        for (auto it = _ranges.lower_bound(from);
+             it != _ranges.end() && it->first <= limit;
+             ++it) {
+            if (it->second.first <= to) {
+                ret.push_back(it->second);
+            }
+        }
+        return ret;
+    }
+
+    /// Drop the ranges that end before the offset
+    void prune(model::offset start) {
+        auto end = _ranges.lower_bound(start);
+        if (end == _ranges.begin()) {
+            return;
+        }
+        _ranges.erase(_ranges.begin(), end);
+        _max_span = 0;
+        for (const auto& [_, r] : _ranges) {
+            _max_span = std::max(_max_span, span(r));
+        }
+    }
+
+    template<typename Func>
+    void for_each(Func&& f) const {
+        for (const auto& [_, r] : _ranges) {
+            f(r);
+        }
+    }
+
+    size_t size() const { return _ranges.size(); }
+    bool empty() const { return _ranges.empty(); }
+
+private:
+    static constexpr model::offset::type max_offset() {
+        return std::numeric_limits<model::offset::type>::max();
+    }
+    static model::offset::type span(const Range& r) {
+        return r.last() - r.first();
+    }
+
+    absl::btree_multimap<model::offset, Range> _ranges;
+    // the longest distance between the first and the last offsets of a range
+    model::offset::type _max_span{0};
+};
+
+} // namespace cluster
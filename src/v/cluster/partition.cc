@@ -23,7 +23,8 @@ static bool is_id_allocator_topic(model::ntp ntp) {
 }
 
 static bool is_tx_manager_topic(const model::ntp& ntp) {
-    return ntp == model::tx_manager_ntp;
+    return ntp.ns == model::tx_manager_nt.ns
+           && ntp.tp.topic == model::tx_manager_nt.tp;
 }
 
 partition::partition(
@@ -165,6 +166,13 @@ partition::timequery(model::timestamp t, ss::io_priority_class p) {
     return _raft->timequery(cfg);
 }
 
+ss::future<std::optional<storage::key_query_result>>
+partition::key_query(bytes key, ss::io_priority_class p) {
+    storage::key_query_config cfg(
+      std::move(key), _raft->committed_offset(), p);
+    return _raft->log().key_query(std::move(cfg));
+}
+
 ss::future<> partition::update_configuration(topic_properties properties) {
     return _raft->log().update_configuration(
       properties.get_ntp_cfg_overrides());
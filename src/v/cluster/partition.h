@@ -26,6 +26,8 @@
 #include "raft/types.h"
 #include "storage/types.h"
 
+#include <algorithm>
+
 namespace cluster {
 class partition_manager;
 
@@ -114,19 +116,52 @@ public:
         return raft::details::next_offset(_raft->last_visible_index());
     }
 
+    /**
+     * High watermark of a follower replica. Followers learn the visible
+     * offset from the leader, they only serve the batches that they know are
+     * committed since the others may still be truncated.
+     */
+    model::offset follower_high_watermark() const {
+        return raft::details::next_offset(
+          std::min(_raft->last_visible_index(), _raft->committed_offset()));
+    }
+
     model::term_id term() { return _raft->term(); }
 
     model::offset dirty_offset() const {
         return _raft->log().offsets().dirty_offset;
     }
 
+    /// \brief the latest term of the log up to the given one and the offset
+    /// following it, see storage::log::term_end
+    std::optional<storage::term_end_result> term_end(model::term_id t) const {
+        return _raft->log().term_end(t);
+    }
+
     const model::ntp& ntp() const { return _raft->ntp(); }
 
     ss::future<std::optional<storage::timequery_result>>
       timequery(model::timestamp, ss::io_priority_class);
 
+    /// \brief the latest committed record of the key
+    ss::future<std::optional<storage::key_query_result>>
+      key_query(bytes, ss::io_priority_class);
+
     bool is_leader() const { return _raft->is_leader(); }
 
+    std::optional<model::node_id> get_leader_id() const {
+        return _raft->get_leader_id();
+    }
+
+    /// \brief true if a follower is behind the leader, known on the leader
+    bool is_under_replicated() const {
+        auto followers = _raft->get_follower_metrics();
+        return std::any_of(
+          followers.begin(),
+          followers.end(),
+          [](const raft::follower_metrics& f) { return f.under_replicated; });
+    }
+
     ss::future<std::error_code>
     transfer_leadership(std::optional<model::node_id> target) {
         return _raft->transfer_leadership(target);
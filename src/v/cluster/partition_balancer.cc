@@ -0,0 +1,325 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/partition_balancer.h"
+
+#include "cluster/logger.h"
+#include "cluster/scheduling/constraints.h"
+#include "cluster/topic_table.h"
+#include "cluster/topics_frontend.h"
+#include "config/configuration.h"
+#include "model/namespace.h"
+#include "model/timeout_clock.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "raft/consensus.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
+
+#include <algorithm>
+
+namespace cluster {
+
+partition_balancer::partition_balancer(
+  ss::sharded<topic_table>& topics,
+  ss::sharded<topics_frontend>& topics_frontend,
+  ss::sharded<partition_allocator>& allocator,
+  consensus_ptr raft0,
+  ss::sharded<ss::abort_source>& as)
+  : _topics(topics)
+  , _topics_frontend(topics_frontend)
+  , _allocator(allocator)
+  , _raft0(std::move(raft0))
+  , _as(as) {
+    _timer.set_callback([this] {
+        (void)ss::with_gate(_gate, [this] { return tick(); });
+    });
+}
+
+void partition_balancer::start() {
+    setup_metrics();
+    arm(config::shard_local_cfg().partition_balancer_tick_interval_ms());
+}
+
+ss::future<> partition_balancer::stop() {
+    _timer.cancel();
+    return _gate.close();
+}
+
+partition_balancer::status partition_balancer::get_status() const {
+    return status{
+      .enabled = config::shard_local_cfg().enable_partition_balancer(),
+      .active = _raft0->is_leader(),
+      .moves = _moves,
+      .move_errors = _move_errors,
+    };
+}
+
+void partition_balancer::arm(clock_type::duration d) {
+    if (_gate.is_closed() || _as.local().abort_requested()) {
+        return;
+    }
+    _timer.arm(d);
+}
+
+ss::future<> partition_balancer::tick() {
+    // only the controller leader moves the partitions
+    if (
+      config::shard_local_cfg().enable_partition_balancer()
+      && _raft0->is_leader()) {
+        try {
+            co_await balance();
+        } catch (...) {
+            vlog(
+              clusterlog.info,
+              "partition balancer iteration failed: {}",
+              std::current_exception());
+        }
+    }
+    arm(config::shard_local_cfg().partition_balancer_tick_interval_ms());
+}
+
+std::optional<model::node_id> partition_balancer::pick_source(
+  const std::vector<node_load>& loads, double max_skew) {
+    struct extremes {
+        const node_load* max{nullptr};
+        double max_value{0};
+        double min_value{0};
+        size_t count{0};
+
+        double skew() const {
+            if (count < 2 || max_value <= 0) {
+                return 0;
+            }
+            return (max_value - min_value) / max_value;
+        }
+    };
+    auto find_extremes = [&loads](auto&& value) {
+        extremes e;
+        for (const auto& l : loads) {
+            std::optional<double> v = value(l);
+            if (!v) {
+                continue;
+            }
+            if (e.count == 0 || *v > e.max_value) {
+                e.max = &l;
+                e.max_value = *v;
+            }
+            if (e.count == 0 || *v < e.min_value) {
+                e.min_value = *v;
+            }
+            ++e.count;
+        }
+        return e;
+    };
+
+    std::optional<model::node_id> ret;
+    double highest_skew = max_skew;
+    auto consider = [&ret, &highest_skew](const extremes& e) {
+        if (e.skew() > highest_skew) {
+            highest_skew = e.skew();
+            ret = e.max->id;
+        }
+    };
+
+    auto partitions = find_extremes(
+      [](const node_load& l) { return std::optional<double>(l.partitions); });
+    // nodes one replica apart would only swap their places
+    if (
+      partitions.count >= 2
+      && partitions.max_value - partitions.max->partition_unit
+           > partitions.min_value) {
+        consider(partitions);
+    }
+    consider(find_extremes([](const node_load& l) { return l.disk; }));
+    consider(find_extremes([](const node_load& l) { return l.throughput; }));
+    return ret;
+}
+
+std::vector<partition_balancer::node_load>
+partition_balancer::collect_loads() const {
+    std::vector<node_load> ret;
+    for (const auto& [id, n] : _allocator.local().state().allocation_nodes()) {
+        // the replicas of decommissioned nodes are moved by members_backend
+        if (n->is_decommissioned() || n->max_capacity()() == 0) {
+            continue;
+        }
+        double capacity = n->max_capacity()();
+        node_load load{
+          .id = id,
+          .partitions = n->allocated_partitions()() / capacity,
+          .partition_unit = 1.0 / capacity,
+        };
+        if (const auto& u = n->get_usage(); u) {
+            if (u->disk_total_bytes > 0) {
+                load.disk = double(u->disk_used_bytes) / u->disk_total_bytes;
+            }
+            load.throughput = double(u->bytes_rate);
+        }
+        ret.push_back(load);
+    }
+    return ret;
+}
+
+std::optional<allocation_units> partition_balancer::reallocate(
+  const partition_assignment& current, model::node_id source) {
+    auto remaining = current;
+    std::erase_if(remaining.replicas, [source](const model::broker_shard& bs) {
+        return bs.node_id == source;
+    });
+    partition_constraints constraints(current.id, current.replicas.size());
+    // the new replica is placed on a node that doesn't hold the partition,
+    // the source node included
+    constraints.constraints.hard_constraints.push_back(
+      ss::make_lw_shared<hard_constraint_evaluator>(
+        distinct_from(current.replicas)));
+
+    auto res = _allocator.local().reallocate_partition(
+      std::move(constraints), remaining);
+    if (!res) {
+        vlog(
+          clusterlog.debug,
+          "partition balancer: unable to reallocate partition {} away from "
+          "node {} - {}",
+          current,
+          source,
+          res.error().message());
+        return std::nullopt;
+    }
+    return std::move(res.value());
+}
+
+ss::future<> partition_balancer::balance() {
+    auto now = clock_type::now();
+    absl::erase_if(_muted, [now](const auto& p) { return p.second <= now; });
+
+    // partitions moved by the operator or by members_backend count against
+    // the limit as well, they compete for the same recovery bandwidth
+    const size_t max_moves
+      = config::shard_local_cfg().partition_balancer_max_concurrent_moves();
+    const size_t in_progress = _topics.local().updates_in_progress();
+    if (in_progress >= max_moves) {
+        vlog(
+          clusterlog.trace,
+          "partition balancer: {} partition moves in progress",
+          in_progress);
+        co_return;
+    }
+
+    auto source = pick_source(
+      collect_loads(), config::shard_local_cfg().partition_balancer_max_skew());
+    if (!source) {
+        vlog(clusterlog.trace, "partition balancer: partitions are balanced");
+        co_return;
+    }
+
+    std::vector<std::pair<model::ntp, allocation_units>> moves;
+    for (const auto& [tp_ns, md] : _topics.local().topics_map()) {
+        if (moves.size() >= max_moves - in_progress) {
+            break;
+        }
+        // do not move internal partitions
+        if (
+          tp_ns.ns == model::kafka_internal_namespace
+          || tp_ns.ns == model::redpanda_ns) {
+            continue;
+        }
+        for (const auto& p : md.configuration.assignments) {
+            if (moves.size() >= max_moves - in_progress) {
+                break;
+            }
+            auto on_source = std::any_of(
+              p.replicas.cbegin(),
+              p.replicas.cend(),
+              [&source](const model::broker_shard& bs) {
+                  return bs.node_id == *source;
+              });
+            if (!on_source) {
+                continue;
+            }
+            model::ntp ntp(tp_ns.ns, tp_ns.tp, p.id);
+            if (
+              _muted.contains(ntp)
+              || _topics.local().is_update_in_progress(ntp)) {
+                continue;
+            }
+            if (auto units = reallocate(p, *source); units) {
+                moves.emplace_back(std::move(ntp), std::move(*units));
+            }
+        }
+    }
+
+    auto mute_until = now + mute_timeout;
+    for (const auto& m : moves) {
+        _muted[m.first] = mute_until;
+    }
+
+    co_await ss::parallel_for_each(moves, [this](auto& m) {
+        return do_move(m.first, std::move(m.second));
+    });
+}
+
+ss::future<>
+partition_balancer::do_move(model::ntp ntp, allocation_units units) {
+    // the units are held until the move is applied to the allocator state
+    auto replicas = units.get_assignments().front().replicas;
+    vlog(
+      clusterlog.info,
+      "partition balancer: moving partition {} replicas to {}",
+      ntp,
+      replicas);
+    std::error_code ec;
+    try {
+        ec = co_await _topics_frontend.local().move_partition_replicas(
+          ntp, replicas, model::timeout_clock::now() + move_timeout);
+    } catch (...) {
+        vlog(
+          clusterlog.info,
+          "partition balancer: error moving partition {} - {}",
+          ntp,
+          std::current_exception());
+        _move_errors++;
+        co_return;
+    }
+    if (ec) {
+        vlog(
+          clusterlog.info,
+          "partition balancer: error moving partition {} - {}",
+          ntp,
+          ec.message());
+        _move_errors++;
+        co_return;
+    }
+    _moves++;
+}
+
+void partition_balancer::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("cluster:partition_balancer"),
+      {
+        sm::make_derive(
+          "partition_moves",
+          [this] { return _moves; },
+          sm::description("Number of partition moves requested by the "
+                          "partition balancer")),
+        sm::make_derive(
+          "partition_move_errors",
+          [this] { return _move_errors; },
+          sm::description("Number of partition moves requested by the "
+                          "partition balancer that failed")),
+      });
+}
+
+} // namespace cluster
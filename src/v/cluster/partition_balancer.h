@@ -0,0 +1,131 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "cluster/fwd.h"
+#include "cluster/scheduling/partition_allocator.h"
+#include "cluster/types.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "seastarx.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace cluster {
+
+/**
+ * Moves partition replicas away from the most loaded nodes of the cluster.
+ *
+ * Replicas are placed once, when the partition is created, the load of the
+ * nodes drifts apart afterwards and the nodes added to the cluster stay
+ * empty. The balancer runs on the controller leader and periodically
+ * compares the nodes by their partition allocations, their disk fill and
+ * their throughput. When the relative skew of any of them crosses the
+ * threshold, replicas of the most loaded node are reallocated with the
+ * partition allocator, that places them on the least loaded nodes, and
+ * moved with the move_partition_replicas command executed by the
+ * controller_backend.
+ *
+ * The number of partitions being moved in the cluster, by the balancer or
+ * not, is bounded. The recovery of the moved replicas is throttled by the
+ * raft learner recovery rate.
+ */
+class partition_balancer {
+public:
+    static constexpr ss::shard_id shard = partition_allocator::shard;
+
+    using clock_type = ss::lowres_clock;
+
+    /// Load of a node, the input of the balancing plan
+    struct node_load {
+        model::node_id id;
+        // allocated partitions relative to the node capacity
+        double partitions;
+        // fill of the node capacity added by a single replica
+        double partition_unit;
+        // not set until the node reports its usage
+        std::optional<double> disk;
+        std::optional<double> throughput;
+    };
+
+    struct status {
+        bool enabled;
+        bool active;
+        uint64_t moves;
+        uint64_t move_errors;
+    };
+
+    partition_balancer(
+      ss::sharded<topic_table>&,
+      ss::sharded<topics_frontend>&,
+      ss::sharded<partition_allocator>&,
+      consensus_ptr,
+      ss::sharded<ss::abort_source>&);
+
+    void start();
+    ss::future<> stop();
+
+    status get_status() const;
+
+    /**
+     * Returns the node that replicas have to be moved from: the most loaded
+     * node by the measure with the highest relative skew, (max - min) / max,
+     * if the skew is greater than `max_skew`. The disk and throughput are
+     * only compared between the nodes that reported them. Partitions are not
+     * moved if moving a single replica would not decrease the skew.
+     */
+    static std::optional<model::node_id>
+    pick_source(const std::vector<node_load>&, double max_skew);
+
+private:
+    void arm(clock_type::duration);
+    void setup_metrics();
+    ss::future<> tick();
+    ss::future<> balance();
+    std::vector<node_load> collect_loads() const;
+    std::optional<allocation_units>
+    reallocate(const partition_assignment&, model::node_id source);
+    ss::future<> do_move(model::ntp, allocation_units);
+
+    /// Time after which a partition that was moved (or failed to move) can
+    /// be moved again, the reported usage has to catch up with the move
+    static constexpr std::chrono::minutes mute_timeout{10};
+    // upper bound of the time the move command takes to be applied
+    static constexpr std::chrono::seconds move_timeout{10};
+
+    ss::sharded<topic_table>& _topics;
+    ss::sharded<topics_frontend>& _topics_frontend;
+    ss::sharded<partition_allocator>& _allocator;
+    consensus_ptr _raft0;
+    ss::sharded<ss::abort_source>& _as;
+
+    absl::flat_hash_map<model::ntp, clock_type::time_point> _muted;
+    ss::timer<clock_type> _timer;
+    ss::gate _gate;
+
+    uint64_t _moves{0};
+    uint64_t _move_errors{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace cluster
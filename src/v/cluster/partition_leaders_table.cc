@@ -11,14 +11,20 @@
 
 #include "model/fundamental.h"
 #include "model/metadata.h"
+#include "random/generators.h"
 #include "utils/expiring_promise.h"
 
 #include <seastar/core/future-util.hh>
 
+#include <limits>
 #include <optional>
 
 namespace cluster {
 
+partition_leaders_table::partition_leaders_table()
+  : _incarnation(random_generators::get_int<uint64_t>(
+    1, std::numeric_limits<uint64_t>::max())) {}
+
 ss::future<> partition_leaders_table::stop() {
     while (!_leader_promises.empty()) {
         auto it = _leader_promises.begin();
@@ -40,6 +46,15 @@ std::optional<model::node_id> partition_leaders_table::get_leader(
     return std::nullopt;
 }
 
+std::optional<model::term_id> partition_leaders_table::get_leader_term(
+  model::topic_namespace_view tp_ns, model::partition_id pid) const {
+    if (auto it = _leaders.find(leader_key_view{tp_ns, pid});
+        it != _leaders.end()) {
+        return it->second.update_term;
+    }
+    return std::nullopt;
+}
+
 std::optional<model::node_id>
 partition_leaders_table::get_leader(const model::ntp& ntp) const {
     return get_leader(model::topic_namespace_view(ntp), ntp.tp.partition);
@@ -52,12 +67,14 @@ void partition_leaders_table::update_partition_leader(
     auto key = leader_key_view{
       model::topic_namespace_view(ntp), ntp.tp.partition};
     auto it = _leaders.find(key);
+    bool changed = false;
     if (it == _leaders.end()) {
         auto [new_it, _] = _leaders.emplace(
           leader_key{
             model::topic_namespace(ntp.ns, ntp.tp.topic), ntp.tp.partition},
           leader_meta{leader_id, term});
         it = new_it;
+        changed = true;
     }
 
     if (it->second.update_term > term) {
@@ -65,9 +82,17 @@ void partition_leaders_table::update_partition_leader(
         return;
     }
     // existing partition
+    changed = changed || it->second.id != leader_id;
+    if (changed || it->second.update_term != term) {
+        it->second.version = ++_version;
+    }
     it->second.id = leader_id;
     it->second.update_term = term;
 
+    if (changed) {
+        notify_leadership_change(ntp, leader_id);
+    }
+
     // notify waiters if update is setting the leader
     if (!leader_id) {
         return;
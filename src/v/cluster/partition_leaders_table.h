@@ -11,14 +11,19 @@
 
 #pragma once
 
+#include "cluster/types.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
 #include "utils/concepts-enabled.h"
 #include "utils/expiring_promise.h"
 
+#include <seastar/util/noncopyable_function.hh>
+
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/node_hash_map.h>
 
+#include <vector>
+
 namespace cluster {
 
 /// Partition leaders contains information about currently elected partition
@@ -28,7 +33,7 @@ namespace cluster {
 /// received by cluster::metadata_dissemination_service.
 class partition_leaders_table {
 public:
-    partition_leaders_table() = default;
+    partition_leaders_table();
 
     ss::future<> stop();
 
@@ -37,6 +42,10 @@ public:
     std::optional<model::node_id>
       get_leader(model::topic_namespace_view, model::partition_id) const;
 
+    /// The term of the last leadership update of a partition
+    std::optional<model::term_id>
+      get_leader_term(model::topic_namespace_view, model::partition_id) const;
+
     ss::future<model::node_id> wait_for_leader(
       const model::ntp&,
       ss::lowres_clock::time_point,
@@ -59,14 +68,55 @@ public:
         }
     }
 
+    /// Like for_each_leader but only visits the partitions which leadership
+    /// was updated after the given version of the table
+    template<typename Func>
+    void for_each_leader_since(uint64_t version, Func&& f) const {
+        for (auto& [k, v] : _leaders) {
+            if (v.version > version) {
+                f(k.tp_ns, k.pid, v.id, v.update_term);
+            }
+        }
+    }
+
+    /// Identifies this instance of the table, versions are only comparable
+    /// between the same incarnation. Never 0.
+    uint64_t incarnation() const { return _incarnation; }
+
+    /// Version of the last update that changed the leader or the term of a
+    /// partition
+    uint64_t version() const { return _version; }
+
     void remove_leader(const model::ntp& ntp) {
-        _leaders.erase(
+        auto erased = _leaders.erase(
           leader_key_view{model::topic_namespace_view(ntp), ntp.tp.partition});
+        if (erased > 0) {
+            notify_leadership_change(ntp, std::nullopt);
+        }
     }
 
     void update_partition_leader(
       const model::ntp&, model::term_id, std::optional<model::node_id>);
 
+    /// Callback invoked when the leader of a partition changes, updates that
+    /// only bump the term of the same leader are not reported
+    using leadership_change_cb_t = ss::noncopyable_function<void(
+      const model::ntp&, std::optional<model::node_id>)>;
+
+    cluster::notification_id_type
+    register_leadership_change_notification(leadership_change_cb_t cb) {
+        auto id = _notification_id++;
+        _notifications.emplace_back(id, std::move(cb));
+        return id;
+    }
+
+    void unregister_leadership_change_notification(
+      cluster::notification_id_type id) {
+        std::erase_if(_notifications, [id](const notification& n) {
+            return n.first == id;
+        });
+    }
+
 private:
     // optimized to reduce number of ntp copies
     struct leader_key {
@@ -127,10 +177,14 @@ private:
     struct leader_meta {
         std::optional<model::node_id> id;
         model::term_id update_term;
+        // version of the table when the entry was last changed
+        uint64_t version{0};
     };
 
     absl::flat_hash_map<leader_key, leader_meta, leader_key_hash, leader_key_eq>
       _leaders;
+    uint64_t _incarnation;
+    uint64_t _version{0};
 
     // per-ntp notifications for leadership election. note that the
     // namespace is currently ignored pending an update to the metadata
@@ -141,6 +195,18 @@ private:
       absl::node_hash_map<int32_t, expiring_promise<model::node_id>>>;
 
     promises_t _leader_promises;
+
+    void notify_leadership_change(
+      const model::ntp& ntp, std::optional<model::node_id> leader) {
+        for (auto& [_, cb] : _notifications) {
+            cb(ntp, leader);
+        }
+    }
+
+    using notification
+      = std::pair<cluster::notification_id_type, leadership_change_cb_t>;
+    cluster::notification_id_type _notification_id{0};
+    std::vector<notification> _notifications;
 };
 
 } // namespace cluster
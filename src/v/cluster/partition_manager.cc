@@ -19,6 +19,7 @@
 #include "resource_mgmt/io_priority.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/smp.hh>
@@ -39,20 +40,33 @@ ss::future<consensus_ptr> partition_manager::manage(
   storage::ntp_config ntp_cfg,
   raft::group_id group,
   std::vector<model::broker> initial_nodes) {
-    return _storage.log_mgr()
-      .manage(std::move(ntp_cfg))
-      .then([this, group, nodes = std::move(initial_nodes)](
-              storage::log&& log) mutable {
-          return _raft_manager.local()
-            .create_group(group, std::move(nodes), log)
-            .then([this, log, group](ss::lw_shared_ptr<raft::consensus> c) {
-                auto p = ss::make_lw_shared<partition>(c, _tx_gateway_frontend);
-                _ntp_table.emplace(log.config().ntp(), p);
-                _raft_table.emplace(group, p);
-                _manage_watchers.notify(p->ntp(), p);
-                return p->start().then([c] { return c; });
-            });
-      });
+    // the replicas added to an existing group are recovered by raft, only
+    // the groups created with their initial replicas are restored
+    bool restored = false;
+    if (
+      _log_recovery && ntp_cfg.is_recovery_enabled()
+      && !initial_nodes.empty()) {
+        restored = co_await _log_recovery(ntp_cfg);
+    }
+    auto log = co_await _storage.log_mgr().manage(std::move(ntp_cfg));
+    if (restored && log.offsets().dirty_offset >= model::offset(0)) {
+        vlog(
+          clusterlog.info,
+          "Bootstrapping raft group {} of the restored log {} at {}",
+          group,
+          log.config().ntp(),
+          log.offsets().dirty_offset);
+        co_await _raft_manager.local().bootstrap_restored_group(
+          group, initial_nodes, log);
+    }
+    auto c = co_await _raft_manager.local().create_group(
+      group, std::move(initial_nodes), log);
+    auto p = ss::make_lw_shared<partition>(c, _tx_gateway_frontend);
+    _ntp_table.emplace(log.config().ntp(), p);
+    _raft_table.emplace(group, p);
+    _manage_watchers.notify(p->ntp(), p);
+    co_await p->start();
+    co_return c;
 }
 
 ss::future<> partition_manager::stop() {
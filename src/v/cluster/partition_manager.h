@@ -36,6 +36,12 @@ public:
     using manage_cb_t
       = ss::noncopyable_function<void(ss::lw_shared_ptr<partition>)>;
 
+    /// Restores the log of a new partition in its work directory before the
+    /// log is opened, i.e. from the cloud storage. Returns true if the log
+    /// was restored.
+    using log_recovery_t
+      = ss::noncopyable_function<ss::future<bool>(const storage::ntp_config&)>;
+
     inline ss::lw_shared_ptr<partition> get(const model::ntp& ntp) const {
         if (auto it = _ntp_table.find(ntp); it != _ntp_table.end()) {
             return it->second;
@@ -59,6 +65,13 @@ public:
         return nullptr;
     }
 
+    /**
+     * The partitions of the topics with recovery enabled are restored with
+     * the log recovery when they are created with their initial replicas,
+     * their raft group is bootstrapped at the last restored offset.
+     */
+    void set_log_recovery(log_recovery_t f) { _log_recovery = std::move(f); }
+
     ss::future<> start() { return ss::now(); }
     ss::future<> stop();
     ss::future<consensus_ptr>
@@ -71,6 +84,11 @@ public:
         return _storage.log_mgr().get(ntp);
     }
 
+    /// \brief size of the logs of the shard per data directory and topic
+    const storage::disk_usage& disk_usage() {
+        return _storage.log_mgr().usage();
+    }
+
     /*
      * register for notification of new partitions within the specific topic
      * being managed. this will invoke the callback for existing partitions
@@ -118,6 +136,7 @@ private:
     ss::sharded<raft::group_manager>& _raft_manager;
 
     ntp_callbacks<manage_cb_t> _manage_watchers;
+    log_recovery_t _log_recovery;
     // XXX use intrusive containers here
     ntp_table_container _ntp_table;
     absl::flat_hash_map<raft::group_id, ss::lw_shared_ptr<partition>>
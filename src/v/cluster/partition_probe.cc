@@ -9,10 +9,12 @@
 
 #include "cluster/partition_probe.h"
 
+#include "cluster/hot_partitions.h"
 #include "cluster/partition.h"
 #include "config/configuration.h"
 #include "model/metadata.h"
 #include "prometheus/prometheus_sanitize.h"
+#include "utils/aggregate_metrics.h"
 
 #include <seastar/core/metrics.hh>
 
@@ -22,6 +24,18 @@ replicated_partition_probe::replicated_partition_probe(
   const partition& p) noexcept
   : _partition(p) {}
 
+void replicated_partition_probe::add_bytes_produced(uint64_t bytes) {
+    _load.bytes += bytes;
+    ++_load.requests;
+    hot_partitions::local().record_produce(_partition.ntp(), bytes);
+}
+
+void replicated_partition_probe::add_bytes_fetched(uint64_t bytes) {
+    _load.bytes += bytes;
+    ++_load.requests;
+    hot_partitions::local().record_fetch(_partition.ntp(), bytes);
+}
+
 void replicated_partition_probe::setup_metrics(const model::ntp& ntp) {
     namespace sm = ss::metrics;
 
@@ -38,78 +52,82 @@ void replicated_partition_probe::setup_metrics(const model::ntp& ntp) {
       topic_label(ntp.tp.topic()),
       partition_label(ntp.tp.partition()),
     };
+    auto group = prometheus_sanitize::metrics_name("cluster:partition");
+
+    using type = metric_spec::type;
+    std::vector<metric_spec> metrics = {
+      {.name = "leader",
+       .kind = type::gauge,
+       .description = "Flag indicating if this partition instance is a leader",
+       .value = [this] { return _partition.is_leader() ? 1 : 0; }},
+      {.name = "last_stable_offset",
+       .kind = type::gauge,
+       .description = "Last stable offset",
+       .value = [this] { return _partition.last_stable_offset()(); }},
+      {.name = "committed_offset",
+       .kind = type::gauge,
+       .description = "Partition commited offset. i.e. safely persisted on "
+                      "majority of replicas",
+       .value = [this] { return _partition.committed_offset()(); }},
+      {.name = "end_offset",
+       .kind = type::gauge,
+       .description = "Last offset stored by current partition on this node",
+       .value = [this] { return _partition.dirty_offset()(); }},
+      {.name = "high_watermark",
+       .kind = type::gauge,
+       .description = "Partion high watermark i.e. highest consumable offset",
+       .value = [this] { return _partition.high_watermark()(); }},
+      {.name = "under_replicated_replicas",
+       .kind = type::gauge,
+       .description = "Number of under replicated replicas",
+       .value =
+         [this] {
+             auto followers = _partition._raft->get_follower_metrics();
+             return std::count_if(
+               followers.cbegin(),
+               followers.cend(),
+               [](const raft::follower_metrics& fm) {
+                   return fm.under_replicated;
+               });
+         }},
+      {.name = "records_produced",
+       .kind = type::counter,
+       .description = "Total number of records produced",
+       .value = [this] { return _records_produced; }},
+      {.name = "records_fetched",
+       .kind = type::counter,
+       .description = "Total number of records fetched",
+       .value = [this] { return _records_fetched; }},
+    };
 
-    _metrics.add_group(
-      prometheus_sanitize::metrics_name("cluster:partition"),
-      {
-        sm::make_gauge(
-          "leader",
-          [this] { return _partition.is_leader() ? 1 : 0; },
-          sm::description(
-            "Flag indicating if this partition instance is a leader"),
-          labels),
-        sm::make_gauge(
-          "last_stable_offset",
-          [this] { return _partition.last_stable_offset(); },
-          sm::description("Last stable offset"),
-          labels),
-        sm::make_gauge(
-          "committed_offset",
-          [this] { return _partition.committed_offset(); },
-          sm::description("Partition commited offset. i.e. safely persisted on "
-                          "majority of replicas"),
-          labels),
-        sm::make_gauge(
-          "end_offset",
-          [this] { return _partition.dirty_offset(); },
-          sm::description(
-            "Last offset stored by current partition on this node"),
-          labels),
-        sm::make_gauge(
-          "high_watermark",
-          [this] { return _partition.high_watermark(); },
-          sm::description(
-            "Partion high watermark i.e. highest consumable offset"),
-          labels),
-        sm::make_gauge(
-          "leader_id",
-          [this] {
-              return _partition._raft->get_leader_id().value_or(
-                model::node_id(-1));
-          },
-          sm::description("Id of current partition leader"),
-          labels),
-        sm::make_gauge(
-          "under_replicated_replicas",
-          [this] {
-              auto metrics = _partition._raft->get_follower_metrics();
-              return std::count_if(
-                metrics.cbegin(),
-                metrics.cend(),
-                [](const raft::follower_metrics& fm) {
-                    return fm.under_replicated;
-                });
-          },
-          sm::description("Number of under replicated replicas"),
-          labels),
-        sm::make_derive(
-          "records_produced",
-          [this] { return _records_produced; },
-          sm::description("Total number of records produced"),
-          labels),
-        sm::make_derive(
-          "records_fetched",
-          [this] { return _records_fetched; },
-          sm::description("Total number of records fetched"),
-          labels),
-      });
+    if (config::shard_local_cfg().aggregate_partition_metrics(ntp.tp.topic)) {
+        // the leader id is not summed, the leader gauge sums to the number
+        // of the partitions of the topic led by the shard
+        _aggregate = aggregate_metrics::local().add(
+          group, {labels[0], labels[1]}, std::move(metrics));
+        return;
+    }
+
+    auto defs = make_metric_definitions(metrics, labels);
+    defs.push_back(sm::make_gauge(
+      "leader_id",
+      [this] {
+          return _partition._raft->get_leader_id().value_or(model::node_id(-1));
+      },
+      sm::description("Id of current partition leader"),
+      labels));
+    _metrics.add_group(group, std::move(defs));
 }
+
 partition_probe make_materialized_partition_probe() {
     // TODO: implement partition probe for materialized partitions
     class impl : public partition_probe::impl {
         void setup_metrics(const model::ntp&) final {}
         void add_records_fetched(uint64_t) final {}
         void add_records_produced(uint64_t) final {}
+        void add_bytes_produced(uint64_t) final {}
+        void add_bytes_fetched(uint64_t) final {}
+        partition_load load() const final { return {}; }
     };
     return partition_probe(std::make_unique<impl>());
 }
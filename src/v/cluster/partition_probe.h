@@ -11,6 +11,7 @@
 
 #pragma once
 #include "model/fundamental.h"
+#include "utils/aggregate_metrics.h"
 
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/shared_ptr.hh>
@@ -21,11 +22,22 @@ namespace cluster {
 
 class partition;
 
+/// Work done for a partition on the node since it was created, sampled by
+/// the shard_balancer
+struct partition_load {
+    uint64_t bytes{0};
+    uint64_t requests{0};
+};
+
 class partition_probe {
 public:
     struct impl {
         virtual void add_records_produced(uint64_t) = 0;
         virtual void add_records_fetched(uint64_t) = 0;
+        /// a produce or fetch request of the given size
+        virtual void add_bytes_produced(uint64_t) = 0;
+        virtual void add_bytes_fetched(uint64_t) = 0;
+        virtual partition_load load() const = 0;
         virtual void setup_metrics(const model::ntp&) = 0;
         virtual ~impl() noexcept = default;
     };
@@ -45,6 +57,16 @@ public:
         return _impl->add_records_fetched(num_records);
     }
 
+    void add_bytes_produced(uint64_t bytes) {
+        return _impl->add_bytes_produced(bytes);
+    }
+
+    void add_bytes_fetched(uint64_t bytes) {
+        return _impl->add_bytes_fetched(bytes);
+    }
+
+    partition_load load() const { return _impl->load(); }
+
 private:
     std::unique_ptr<impl> _impl;
 };
@@ -56,12 +78,17 @@ public:
 
     void add_records_fetched(uint64_t cnt) final { _records_fetched += cnt; }
     void add_records_produced(uint64_t cnt) final { _records_produced += cnt; }
+    void add_bytes_produced(uint64_t bytes) final;
+    void add_bytes_fetched(uint64_t bytes) final;
+    partition_load load() const final { return _load; }
 
 private:
     const partition& _partition;
     uint64_t _records_produced{0};
     uint64_t _records_fetched{0};
+    partition_load _load;
     ss::metrics::metric_groups _metrics;
+    aggregate_metrics::registration _aggregate;
 };
 
 partition_probe make_materialized_partition_probe();
@@ -76,6 +76,9 @@ public:
 
     ss::future<> make_snapshot() final;
     ss::future<> ensure_snapshot_exists(model::offset) final;
+    model::offset last_snapshot_offset() const final {
+        return _last_snapshot_offset;
+    }
 
     /*
      * Usually start() acts as a barrier and we don't call any methods on the
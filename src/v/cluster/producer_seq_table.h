@@ -0,0 +1,85 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/record.h"
+#include "model/timestamp.h"
+
+#include <absl/container/btree_set.h>
+#include <absl/container/flat_hash_map.h>
+
+#include <utility>
+
+namespace cluster {
+
+/**
+ * Last sequence numbers of the idempotent producers of a partition, indexed
+ * by the time of their last write.
+ *
+ * The fixed size entries are kept in an open addressing table by producer
+ * identity. The age index orders them by their last write, so expiring the
+ * producers that stopped writing costs O(k log n) for the k expired entries
+ * instead of a scan of the whole table.
+ *
+ * Entry must have `model::producer_identity pid` and
+ * `model::timestamp::type last_write_timestamp` members.
+ */
+template<typename Entry>
+class producer_seq_table {
+public:
+    const Entry* find(model::producer_identity pid) const {
+        auto it = _entries.find(pid);
+        return it == _entries.end() ? nullptr : &it->second;
+    }
+
+    /// Inserts the entry of a producer or replaces its previous entry
+    void upsert(Entry e) {
+        auto [it, inserted] = _entries.try_emplace(e.pid, e);
+        if (!inserted) {
+            _by_age.erase(age_key(it->second));
+            it->second = e;
+        }
+        _by_age.insert(age_key(e));
+    }
+
+    /// Drop the entries last written before the cutoff
+    void expire(model::timestamp::type cutoff) {
+        auto it = _by_age.begin();
+        for (; it != _by_age.end() && it->first < cutoff; ++it) {
+            _entries.erase(it->second);
+        }
+        _by_age.erase(_by_age.begin(), it);
+    }
+
+    template<typename Func>
+    void for_each(Func&& f) const {
+        for (const auto& [_, e] : _entries) {
+            f(e);
+        }
+    }
+
+    size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+private:
+    using age_key_t
+      = std::pair<model::timestamp::type, model::producer_identity>;
+
+    static age_key_t age_key(const Entry& e) {
+        return {e.last_write_timestamp, e.pid};
+    }
+
+    absl::flat_hash_map<model::producer_identity, Entry> _entries;
+    absl::btree_set<age_key_t> _by_age;
+};
+
+} // namespace cluster
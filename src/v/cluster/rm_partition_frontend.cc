@@ -16,6 +16,9 @@
 #include "errc.h"
 
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+
+#include <absl/container/flat_hash_map.h>
 
 #include <algorithm>
 
@@ -503,4 +506,138 @@ ss::future<abort_tx_reply> rm_partition_frontend::do_abort_tx(
       });
 }
 
+ss::future<std::vector<tx_errc>> rm_partition_frontend::write_tx_markers(
+  std::vector<model::ntp> ntps,
+  model::producer_identity pid,
+  model::tx_seq tx_seq,
+  bool commit,
+  model::timeout_clock::duration timeout) {
+    std::vector<tx_errc> ret(ntps.size(), tx_errc::none);
+    // indexes of the ntps grouped by their leaders
+    absl::flat_hash_map<model::node_id, std::vector<size_t>> by_leader;
+    for (size_t i = 0; i < ntps.size(); ++i) {
+        const auto& ntp = ntps[i];
+        auto nt = model::topic_namespace(ntp.ns, ntp.tp.topic);
+        if (!_metadata_cache.local().contains(nt, ntp.tp.partition)) {
+            ret[i] = tx_errc::partition_not_exists;
+            continue;
+        }
+        auto leader = _leaders.local().get_leader(ntp);
+        if (!leader) {
+            vlog(clusterlog.warn, "can't find a leader for {}", ntp);
+            ret[i] = tx_errc::leader_not_found;
+            continue;
+        }
+        by_leader[*leader].push_back(i);
+    }
+
+    auto _self = _controller->self();
+    co_await ss::parallel_for_each(
+      by_leader,
+      [this, _self, &ntps, &ret, pid, tx_seq, commit, timeout](
+        const auto& entry) {
+          auto leader = entry.first;
+          const auto& idxs = entry.second;
+          std::vector<model::ntp> leader_ntps;
+          leader_ntps.reserve(idxs.size());
+          for (auto i : idxs) {
+              leader_ntps.push_back(ntps[i]);
+          }
+          auto f = ss::make_ready_future<std::vector<tx_errc>>();
+          if (leader == _self) {
+              f = do_write_tx_markers(
+                std::move(leader_ntps), pid, tx_seq, commit, timeout);
+          } else {
+              vlog(
+                clusterlog.trace,
+                "dispatching {} tx markers to {} from {}",
+                idxs.size(),
+                leader,
+                _self);
+              f = dispatch_write_tx_markers(
+                leader, std::move(leader_ntps), pid, tx_seq, commit, timeout);
+          }
+          return f.then([&ret, &idxs](std::vector<tx_errc> ecs) {
+              for (size_t j = 0; j < idxs.size(); ++j) {
+                  ret[idxs[j]] = j < ecs.size() ? ecs[j] : tx_errc::timeout;
+              }
+          });
+      });
+    co_return ret;
+}
+
+ss::future<std::vector<tx_errc>>
+rm_partition_frontend::dispatch_write_tx_markers(
+  model::node_id leader,
+  std::vector<model::ntp> ntps,
+  model::producer_identity pid,
+  model::tx_seq tx_seq,
+  bool commit,
+  model::timeout_clock::duration timeout) {
+    auto r = co_await _connection_cache.local()
+               .with_node_client<cluster::tx_gateway_client_protocol>(
+                 _controller->self(),
+                 ss::this_shard_id(),
+                 leader,
+                 timeout,
+                 [ntps, pid, tx_seq, commit, timeout](
+                   tx_gateway_client_protocol cp) {
+                     return cp.write_tx_markers(
+                       write_tx_markers_request{
+                         .ntps = ntps,
+                         .pid = pid,
+                         .tx_seq = tx_seq,
+                         .commit = commit,
+                         .timeout = timeout},
+                       rpc::client_opts(model::timeout_clock::now() + timeout));
+                 })
+               .then(&rpc::get_ctx_data<write_tx_markers_reply>);
+    if (r.has_value()) {
+        co_return std::move(r.value().ecs);
+    }
+    if (r.error() != rpc::errc::method_not_found) {
+        vlog(
+          clusterlog.warn,
+          "got error {} on remote write tx markers",
+          r.error());
+        co_return std::vector<tx_errc>(ntps.size(), tx_errc::timeout);
+    }
+
+    // the leader doesn't support batched markers, a request per partition
+    std::vector<ss::future<tx_errc>> fs;
+    fs.reserve(ntps.size());
+    for (auto& ntp : ntps) {
+        if (commit) {
+            fs.push_back(
+              dispatch_commit_tx(leader, std::move(ntp), pid, tx_seq, timeout)
+                .then([](commit_tx_reply r) { return r.ec; }));
+        } else {
+            fs.push_back(
+              dispatch_abort_tx(leader, std::move(ntp), pid, tx_seq, timeout)
+                .then([](abort_tx_reply r) { return r.ec; }));
+        }
+    }
+    co_return co_await ss::when_all_succeed(fs.begin(), fs.end());
+}
+
+ss::future<std::vector<tx_errc>> rm_partition_frontend::do_write_tx_markers(
+  std::vector<model::ntp> ntps,
+  model::producer_identity pid,
+  model::tx_seq tx_seq,
+  bool commit,
+  model::timeout_clock::duration timeout) {
+    std::vector<ss::future<tx_errc>> fs;
+    fs.reserve(ntps.size());
+    for (auto& ntp : ntps) {
+        if (commit) {
+            fs.push_back(do_commit_tx(std::move(ntp), pid, tx_seq, timeout)
+                           .then([](commit_tx_reply r) { return r.ec; }));
+        } else {
+            fs.push_back(do_abort_tx(std::move(ntp), pid, tx_seq, timeout)
+                           .then([](abort_tx_reply r) { return r.ec; }));
+        }
+    }
+    return ss::when_all_succeed(fs.begin(), fs.end());
+}
+
 } // namespace cluster
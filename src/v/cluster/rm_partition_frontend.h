@@ -57,6 +57,18 @@ public:
       model::producer_identity,
       model::tx_seq,
       model::timeout_clock::duration);
+    /**
+     * Commits (commit = true) or aborts the transaction on each of the
+     * partitions. The markers of the partitions led by the same node are
+     * sent with a single request instead of a request per partition.
+     * Returns the outcome of each partition in the order of the ntps.
+     */
+    ss::future<std::vector<tx_errc>> write_tx_markers(
+      std::vector<model::ntp>,
+      model::producer_identity,
+      model::tx_seq,
+      bool commit,
+      model::timeout_clock::duration);
 
 private:
     ss::smp_service_group _ssg;
@@ -120,6 +132,19 @@ private:
       model::producer_identity,
       model::tx_seq,
       model::timeout_clock::duration);
+    ss::future<std::vector<tx_errc>> dispatch_write_tx_markers(
+      model::node_id,
+      std::vector<model::ntp>,
+      model::producer_identity,
+      model::tx_seq,
+      bool commit,
+      model::timeout_clock::duration);
+    ss::future<std::vector<tx_errc>> do_write_tx_markers(
+      std::vector<model::ntp>,
+      model::producer_identity,
+      model::tx_seq,
+      bool commit,
+      model::timeout_clock::duration);
 
     friend tx_gateway;
 };
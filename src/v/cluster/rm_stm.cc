@@ -102,9 +102,8 @@ static rm_stm::prepare_marker parse_prepare_batch(model::record_batch&& b) {
       b.record_count() == 1,
       "model::record_batch_type::tx_prepare batch must contain a single "
       "record");
-    auto r = b.copy_records();
-    auto& record = *r.begin();
-    auto val_buf = record.release_value();
+    auto record = b.first_record_view();
+    auto val_buf = record.copy_value();
 
     iobuf_parser val_reader(std::move(val_buf));
     auto version = reflection::adl<int8_t>{}.from(val_reader);
@@ -117,7 +116,7 @@ static rm_stm::prepare_marker parse_prepare_batch(model::record_batch&& b) {
       reflection::adl<int32_t>{}.from(val_reader));
     auto tx_seq = model::tx_seq(reflection::adl<int64_t>{}.from(val_reader));
 
-    auto key_buf = record.release_key();
+    auto key_buf = record.copy_key();
     iobuf_parser key_reader(std::move(key_buf));
     auto batch_type = reflection::adl<model::record_batch_type>{}.from(
       key_reader);
@@ -153,9 +152,8 @@ static model::control_record_type parse_control_batch(model::record_batch& b) {
     vassert(
       b.record_count() == 1, "control batch must contain a single record");
 
-    auto r = b.copy_records();
-    auto& record = *r.begin();
-    auto key = record.release_key();
+    auto record = b.first_record_view();
+    auto key = record.copy_key();
     kafka::request_reader key_reader(std::move(key));
     auto version = model::control_record_version(key_reader.read_int16());
     vassert(
@@ -169,7 +167,6 @@ rm_stm::rm_stm(
   raft::consensus* c,
   ss::sharded<cluster::tx_gateway_frontend>& tx_gateway_frontend)
   : persisted_stm("rm", logger, c)
-  , _oldest_session(model::timestamp::now())
   , _sync_timeout(config::shard_local_cfg().rm_sync_timeout_ms.value())
   , _tx_timeout_delay(config::shard_local_cfg().tx_timeout_delay_ms.value())
   , _recovery_policy(
@@ -604,28 +601,17 @@ ss::future<> rm_stm::stop() {
 
 bool rm_stm::check_seq(model::batch_identity bid) {
     auto pid_seq = _log_state.seq_table.find(bid.pid);
-    auto last_write_timestamp = model::timestamp::now().value();
-    if (pid_seq == _log_state.seq_table.end()) {
+    if (pid_seq == nullptr) {
         if (bid.first_seq != 0) {
             return false;
         }
-        seq_entry entry{
-          .pid = bid.pid,
-          .seq = bid.last_seq,
-          .last_write_timestamp = last_write_timestamp};
-        _oldest_session = std::min(
-          _oldest_session, model::timestamp(entry.last_write_timestamp));
-        _log_state.seq_table.emplace(entry.pid, entry);
-    } else {
-        if (!is_sequence(pid_seq->second.seq, bid.first_seq)) {
-            return false;
-        }
-        pid_seq->second.seq = bid.last_seq;
-        pid_seq->second.last_write_timestamp = last_write_timestamp;
-        _oldest_session = std::min(
-          _oldest_session,
-          model::timestamp(pid_seq->second.last_write_timestamp));
+    } else if (!is_sequence(pid_seq->seq, bid.first_seq)) {
+        return false;
     }
+    _log_state.seq_table.upsert(seq_entry{
+      .pid = bid.pid,
+      .seq = bid.last_seq,
+      .last_write_timestamp = model::timestamp::now().value()});
     return true;
 }
 
@@ -752,38 +738,13 @@ model::offset rm_stm::last_stable_offset() {
 
 ss::future<std::vector<rm_stm::tx_range>>
 rm_stm::aborted_transactions(model::offset from, model::offset to) {
-    std::vector<rm_stm::tx_range> result;
-    for (auto& range : _log_state.aborted) {
-        if (range.last < from) {
-            continue;
-        }
-        if (range.first > to) {
-            continue;
-        }
-        result.push_back(range);
-    }
-    co_return result;
+    return ss::make_ready_future<std::vector<rm_stm::tx_range>>(
+      _log_state.aborted.overlapping(from, to));
 }
 
 void rm_stm::compact_snapshot() {
-    auto cutoff_timestamp = model::timestamp::now().value()
-                            - _transactional_id_expiration.count();
-    if (cutoff_timestamp <= _oldest_session.value()) {
-        return;
-    }
-    auto next_oldest_session = model::timestamp::now();
-    for (auto it = _log_state.seq_table.cbegin();
-         it != _log_state.seq_table.cend();) {
-        if (it->second.last_write_timestamp < cutoff_timestamp) {
-            _log_state.seq_table.erase(it++);
-        } else {
-            next_oldest_session = std::min(
-              next_oldest_session,
-              model::timestamp(it->second.last_write_timestamp));
-            ++it;
-        }
-    }
-    _oldest_session = next_oldest_session;
+    _log_state.seq_table.expire(
+      model::timestamp::now().value() - _transactional_id_expiration.count());
 }
 
 ss::future<bool> rm_stm::sync(model::timeout_clock::duration timeout) {
@@ -977,9 +938,8 @@ void rm_stm::apply_fence(model::record_batch&& b) {
     vassert(
       b.record_count() == 1,
       "model::record_batch_type::tx_fence batch must contain a single record");
-    auto r = b.copy_records();
-    auto& record = *r.begin();
-    auto val_buf = record.release_value();
+    auto record = b.first_record_view();
+    auto val_buf = record.copy_value();
 
     iobuf_parser val_reader(std::move(val_buf));
     auto version = reflection::adl<int8_t>{}.from(val_reader);
@@ -989,7 +949,7 @@ void rm_stm::apply_fence(model::record_batch&& b) {
       version,
       rm_stm::fence_control_record_version);
 
-    auto key_buf = record.release_key();
+    auto key_buf = record.copy_key();
     iobuf_parser key_reader(std::move(key_buf));
     auto batch_type = reflection::adl<model::record_batch_type>{}.from(
       key_reader);
@@ -1055,7 +1015,7 @@ void rm_stm::apply_control(
         auto offset_it = _log_state.ongoing_map.find(pid);
         if (offset_it != _log_state.ongoing_map.end()) {
             // make a list
-            _log_state.aborted.push_back(offset_it->second);
+            _log_state.aborted.add(offset_it->second);
             _log_state.ongoing_set.erase(offset_it->second.first);
             _log_state.ongoing_map.erase(pid);
         }
@@ -1076,18 +1036,11 @@ void rm_stm::apply_control(
 void rm_stm::apply_data(model::batch_identity bid, model::offset last_offset) {
     if (bid.has_idempotent()) {
         auto pid_seq = _log_state.seq_table.find(bid.pid);
-        if (pid_seq == _log_state.seq_table.end()) {
-            seq_entry entry{
+        if (pid_seq == nullptr || pid_seq->seq < bid.last_seq) {
+            _log_state.seq_table.upsert(seq_entry{
               .pid = bid.pid,
               .seq = bid.last_seq,
-              .last_write_timestamp = bid.max_timestamp.value()};
-            _log_state.seq_table.emplace(bid.pid, entry);
-            _oldest_session = std::min(
-              _oldest_session, model::timestamp(entry.last_write_timestamp));
-        } else if (pid_seq->second.seq < bid.last_seq) {
-            pid_seq->second.seq = bid.last_seq;
-            pid_seq->second.last_write_timestamp = bid.max_timestamp.value();
-            _oldest_session = std::min(_oldest_session, bid.max_timestamp);
+              .last_write_timestamp = bid.max_timestamp.value()});
         }
     }
 
@@ -1144,14 +1097,13 @@ void rm_stm::load_snapshot(stm_snapshot_header hdr, iobuf&& tx_ss_buf) {
     for (auto& entry : data.prepared) {
         _log_state.prepared.emplace(entry.pid, entry);
     }
-    _log_state.aborted.insert(
-      _log_state.aborted.end(),
-      std::make_move_iterator(data.aborted.begin()),
-      std::make_move_iterator(data.aborted.end()));
+    for (auto& entry : data.aborted) {
+        _log_state.aborted.add(entry);
+    }
     for (auto& entry : data.seqs) {
-        auto [seq_it, _] = _log_state.seq_table.try_emplace(entry.pid, entry);
-        if (seq_it->second.seq < entry.seq) {
-            seq_it->second = entry;
+        auto seq = _log_state.seq_table.find(entry.pid);
+        if (seq == nullptr || seq->seq < entry.seq) {
+            _log_state.seq_table.upsert(entry);
         }
     }
 
@@ -1172,12 +1124,18 @@ stm_snapshot rm_stm::take_snapshot() {
     for (auto& entry : _log_state.prepared) {
         tx_ss.prepared.push_back(entry.second);
     }
-    for (auto& entry : _log_state.aborted) {
-        tx_ss.aborted.push_back(entry);
-    }
-    for (auto& entry : _log_state.seq_table) {
-        tx_ss.seqs.push_back(entry.second);
-    }
+    // fetches can't read below the start of the log unless the reads are
+    // served from the cloud storage, there is no point in keeping the aborted
+    // transactions that end before it
+    if (!config::shard_local_cfg().cloud_storage_enable_remote_read()) {
+        _log_state.aborted.prune(_c->start_offset());
+    }
+    tx_ss.aborted.reserve(_log_state.aborted.size());
+    _log_state.aborted.for_each(
+      [&tx_ss](const tx_range& entry) { tx_ss.aborted.push_back(entry); });
+    tx_ss.seqs.reserve(_log_state.seq_table.size());
+    _log_state.seq_table.for_each(
+      [&tx_ss](const seq_entry& entry) { tx_ss.seqs.push_back(entry); });
     tx_ss.offset = _insync_offset;
 
     iobuf tx_ss_buf;
@@ -11,7 +11,9 @@
 
 #pragma once
 
+#include "cluster/offset_range_index.h"
 #include "cluster/persisted_stm.h"
+#include "cluster/producer_seq_table.h"
 #include "cluster/tx_utils.h"
 #include "cluster/types.h"
 #include "config/configuration.h"
@@ -194,13 +196,14 @@ private:
         // a heap of the first offsets of the ongoing transactions
         absl::btree_set<model::offset> ongoing_set;
         absl::flat_hash_map<model::producer_identity, prepare_marker> prepared;
-        std::vector<tx_range> aborted;
+        // aborted transactions indexed for the read_committed fetches
+        offset_range_index<tx_range> aborted;
         // the only piece of data which we update on replay and before
         // replicating the command. we use the highest seq number to resolve
         // conflicts. if the replication fails we reject a command but clients
         // by spec should be ready for thier commands being rejected so it's
         // ok by design to have false rejects
-        absl::flat_hash_map<model::producer_identity, seq_entry> seq_table;
+        producer_seq_table<seq_entry> seq_table;
     };
 
     struct expiration_info {
@@ -261,7 +264,6 @@ private:
     log_state _log_state;
     mem_state _mem_state;
     ss::timer<clock_type> auto_abort_timer;
-    model::timestamp _oldest_session;
     std::chrono::milliseconds _sync_timeout;
     std::chrono::milliseconds _tx_timeout_delay;
     model::violation_recovery_policy _recovery_policy;
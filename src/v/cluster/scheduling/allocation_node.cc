@@ -15,11 +15,13 @@ namespace cluster {
 allocation_node::allocation_node(
   model::node_id id,
   uint32_t cpus,
-  absl::node_hash_map<ss::sstring, ss::sstring> labels)
+  absl::node_hash_map<ss::sstring, ss::sstring> labels,
+  std::optional<ss::sstring> rack)
   : _id(id)
   , _weights(cpus)
   , _max_capacity((cpus * max_allocations_per_core) - core0_extra_weight)
-  , _machine_labels(std::move(labels)) {
+  , _machine_labels(std::move(labels))
+  , _rack(std::move(rack)) {
     // add extra weights to core 0
     _weights[0] = core0_extra_weight;
 }
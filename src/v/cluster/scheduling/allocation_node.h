@@ -17,6 +17,8 @@
 
 #include <absl/container/node_hash_map.h>
 
+#include <optional>
+
 namespace cluster {
 
 class allocation_state;
@@ -32,8 +34,20 @@ public:
     // TODO make configurable
     static constexpr const allocation_capacity max_allocations_per_core{7000};
 
+    /// Resource usage reported by the node, used to weigh the placement of
+    /// new partitions by the load of the nodes
+    struct usage {
+        uint64_t disk_used_bytes{0};
+        uint64_t disk_total_bytes{0};
+        // produce and fetch bytes per second of all the node partitions
+        uint64_t bytes_rate{0};
+    };
+
     allocation_node(
-      model::node_id, uint32_t, absl::node_hash_map<ss::sstring, ss::sstring>);
+      model::node_id,
+      uint32_t,
+      absl::node_hash_map<ss::sstring, ss::sstring>,
+      std::optional<ss::sstring> rack = std::nullopt);
 
     allocation_node(allocation_node&& o) noexcept = default;
     allocation_node& operator=(allocation_node&&) = delete;
@@ -65,6 +79,11 @@ public:
     allocation_capacity max_capacity() const { return _max_capacity; }
     ss::shard_id allocate();
 
+    const std::optional<ss::sstring>& rack() const { return _rack; }
+    /// not set until the node reports its usage
+    const std::optional<usage>& get_usage() const { return _usage; }
+    void set_usage(usage u) { _usage = u; }
+
 private:
     friend allocation_state;
 
@@ -80,6 +99,8 @@ private:
     /// generated by `rpk` usually in /etc/redpanda/machine_labels.json
     absl::node_hash_map<ss::sstring, ss::sstring> _machine_labels;
     bool _decommissioned = false;
+    std::optional<ss::sstring> _rack;
+    std::optional<usage> _usage;
 
     friend std::ostream& operator<<(std::ostream&, const allocation_node&);
 };
@@ -96,6 +96,14 @@ void allocation_state::recommission_node(model::node_id id) {
     it->second->recommission();
 }
 
+void allocation_state::update_node_usage(
+  model::node_id id, allocation_node::usage u) {
+    auto it = _nodes.find(id);
+    if (it != _nodes.end()) {
+        it->second->set_usage(u);
+    }
+}
+
 bool allocation_state::is_empty(model::node_id id) const {
     auto it = _nodes.find(id);
     if (it == _nodes.end()) {
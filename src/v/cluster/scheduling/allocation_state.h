@@ -14,6 +14,8 @@
 #include "cluster/scheduling/allocation_node.h"
 #include "model/metadata.h"
 
+#include <algorithm>
+
 namespace cluster {
 /**
  * Partition allocator state
@@ -34,6 +36,8 @@ public:
     bool contains_node(model::node_id n) const { return _nodes.contains(n); }
     const underlying_t& allocation_nodes() const { return _nodes; }
     int16_t available_nodes() const;
+    /// Ignored if the node isn't registered
+    void update_node_usage(model::node_id, allocation_node::usage);
 
     // Operations on state
     void deallocate(const model::broker_shard&);
@@ -46,6 +50,9 @@ public:
     // Raft group id
     raft::group_id next_group_id();
     raft::group_id last_group_id() const { return _highest_group; }
+    void update_highest_group(raft::group_id group) {
+        _highest_group = std::max(_highest_group, group);
+    }
 
 private:
     raft::group_id _highest_group{0};
@@ -11,10 +11,13 @@
 #include "cluster/scheduling/constraints.h"
 
 #include "cluster/scheduling/allocation_node.h"
+#include "cluster/scheduling/allocation_state.h"
 #include "model/metadata.h"
 
 #include <fmt/ostream.h>
 
+#include <algorithm>
+
 namespace cluster {
 
 hard_constraint_evaluator not_fully_allocated() {
@@ -113,4 +116,111 @@ soft_constraint_evaluator least_allocated() {
     return soft_constraint_evaluator(std::make_unique<impl>());
 }
 
+// score of the nodes that didn't report their usage yet
+static constexpr uint64_t neutral_score = soft_constraint_evaluator::max_score
+                                          / 2;
+
+soft_constraint_evaluator least_disk_filled() {
+    class impl : public soft_constraint_evaluator::impl {
+    public:
+        uint64_t score(const allocation_node& node) const final {
+            const auto& usage = node.get_usage();
+            if (!usage || usage->disk_total_bytes == 0) {
+                return neutral_score;
+            }
+            auto used = std::min(
+              usage->disk_used_bytes, usage->disk_total_bytes);
+            return static_cast<uint64_t>(
+              static_cast<double>(soft_constraint_evaluator::max_score)
+              * static_cast<double>(usage->disk_total_bytes - used)
+              / static_cast<double>(usage->disk_total_bytes));
+        }
+
+        void print(std::ostream& o) const final {
+            fmt::print(o, "least disk filled node");
+        }
+    };
+
+    return soft_constraint_evaluator(std::make_unique<impl>());
+}
+
+soft_constraint_evaluator least_throughput(const allocation_state& state) {
+    class impl : public soft_constraint_evaluator::impl {
+    public:
+        explicit impl(uint64_t max_rate)
+          : _max_rate(max_rate) {}
+
+        uint64_t score(const allocation_node& node) const final {
+            const auto& usage = node.get_usage();
+            if (!usage) {
+                return neutral_score;
+            }
+            if (_max_rate == 0) {
+                return soft_constraint_evaluator::max_score;
+            }
+            // relative to the busiest node, the rates are only comparable
+            // between the nodes of the same cluster
+            auto rate = std::min(usage->bytes_rate, _max_rate);
+            return static_cast<uint64_t>(
+              static_cast<double>(soft_constraint_evaluator::max_score)
+              * static_cast<double>(_max_rate - rate)
+              / static_cast<double>(_max_rate));
+        }
+
+        void print(std::ostream& o) const final {
+            fmt::print(o, "least throughput node, max rate: {}", _max_rate);
+        }
+
+    private:
+        uint64_t _max_rate;
+    };
+
+    uint64_t max_rate = 0;
+    for (const auto& [_, node] : state.allocation_nodes()) {
+        if (node->get_usage()) {
+            max_rate = std::max(max_rate, node->get_usage()->bytes_rate);
+        }
+    }
+    return soft_constraint_evaluator(std::make_unique<impl>(max_rate));
+}
+
+soft_constraint_evaluator distinct_rack(
+  const std::vector<model::broker_shard>& replicas,
+  const allocation_state& state) {
+    class impl : public soft_constraint_evaluator::impl {
+    public:
+        impl(
+          const std::vector<model::broker_shard>& replicas,
+          const allocation_state& state)
+          : _replicas(replicas)
+          , _state(state) {}
+
+        uint64_t score(const allocation_node& node) const final {
+            if (!node.rack()) {
+                return neutral_score;
+            }
+            const auto& nodes = _state.allocation_nodes();
+            auto same_rack = std::any_of(
+              _replicas.begin(),
+              _replicas.end(),
+              [&node, &nodes](const model::broker_shard& bs) {
+                  auto it = nodes.find(bs.node_id);
+                  return it != nodes.end() && it->second->rack() == node.rack();
+              });
+            return same_rack ? 0 : soft_constraint_evaluator::max_score;
+        }
+
+        void print(std::ostream& o) const final {
+            fmt::print(o, "rack distinct from: {}", _replicas);
+        }
+
+    private:
+        const std::vector<model::broker_shard>& _replicas;
+        const allocation_state& _state;
+    };
+
+    return soft_constraint_evaluator(
+      std::make_unique<impl>(replicas, state));
+}
+
 } // namespace cluster
@@ -25,4 +25,14 @@ distinct_from(const std::vector<model::broker_shard>&);
 
 soft_constraint_evaluator least_allocated();
 
+/// prefers the nodes with the most free disk space
+soft_constraint_evaluator least_disk_filled();
+
+/// prefers the nodes serving the lowest produce and fetch byte rates
+soft_constraint_evaluator least_throughput(const allocation_state&);
+
+/// prefers the nodes in a rack none of the replicas is in yet
+soft_constraint_evaluator
+distinct_rack(const std::vector<model::broker_shard>&, const allocation_state&);
+
 } // namespace cluster
@@ -28,7 +28,7 @@ partition_allocator::partition_allocator()
   : _state(std::make_unique<allocation_state>())
   , _allocation_strategy(simple_allocation_strategy()) {}
 
-allocation_constraints default_constraints() {
+allocation_constraints default_constraints(const allocation_state& state) {
     allocation_constraints req;
     req.hard_constraints.push_back(
       ss::make_lw_shared<hard_constraint_evaluator>(not_fully_allocated()));
@@ -36,6 +36,11 @@ allocation_constraints default_constraints() {
       ss::make_lw_shared<hard_constraint_evaluator>(not_decommissioned()));
     req.soft_constraints.push_back(
       ss::make_lw_shared<soft_constraint_evaluator>(least_allocated()));
+    // the load of the nodes, neutral until the nodes report their usage
+    req.soft_constraints.push_back(
+      ss::make_lw_shared<soft_constraint_evaluator>(least_disk_filled()));
+    req.soft_constraints.push_back(
+      ss::make_lw_shared<soft_constraint_evaluator>(least_throughput(state)));
     return req;
 }
 
@@ -55,11 +60,15 @@ partition_allocator::allocate_partition(partition_constraints p_constraints) {
       *_state, p_constraints.replication_factor);
 
     for (auto r = 0; r < p_constraints.replication_factor; ++r) {
-        auto effective_constraits = default_constraints();
+        auto effective_constraits = default_constraints(*_state);
         effective_constraits.hard_constraints.push_back(
           ss::make_lw_shared<hard_constraint_evaluator>(
             distinct_from(replicas.get())));
-        effective_constraits.add(std::move(p_constraints.constraints));
+        effective_constraits.soft_constraints.push_back(
+          ss::make_lw_shared<soft_constraint_evaluator>(
+            distinct_rack(replicas.get(), *_state)));
+        // copied, the constraints apply to every replica
+        effective_constraits.add(p_constraints.constraints);
 
         auto replica = _allocation_strategy.allocate_replica(
           effective_constraits, *_state);
@@ -117,6 +126,9 @@ partition_allocator::do_reallocate_partition(
     p_constraints.constraints.hard_constraints.push_back(
       ss::make_lw_shared<hard_constraint_evaluator>(
         distinct_from(not_changed_replicas)));
+    p_constraints.constraints.soft_constraints.push_back(
+      ss::make_lw_shared<soft_constraint_evaluator>(
+        distinct_rack(not_changed_replicas, *_state)));
     p_constraints.replication_factor -= not_changed_replicas.size();
     auto result = allocate_partition(std::move(p_constraints));
     if (!result) {
@@ -161,7 +173,7 @@ result<allocation_units> partition_allocator::reassign_decommissioned_replicas(
                || it->second->is_decommissioned();
     });
 
-    auto req = default_constraints();
+    auto req = default_constraints(*_state);
     req.hard_constraints.push_back(
       ss::make_lw_shared<hard_constraint_evaluator>(
         distinct_from(current_replicas)));
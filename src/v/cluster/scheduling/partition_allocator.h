@@ -33,6 +33,11 @@ public:
     }
     void decommission_node(model::node_id id) { _state->decommission_node(id); }
     void recommission_node(model::node_id id) { _state->recommission_node(id); }
+    /// Disk usage and byte rates of a node, weighed when placing new
+    /// replicas. Nodes that never reported their usage are scored neutrally
+    void update_node_usage(model::node_id id, allocation_node::usage u) {
+        _state->update_node_usage(id, u);
+    }
 
     bool is_empty(model::node_id id) const { return _state->is_empty(id); }
     bool contains_node(model::node_id n) const {
@@ -142,4 +142,28 @@ ss::future<std::error_code> security_manager::dispatch_updates_to_cores(
       });
 }
 
+ss::future<std::vector<model::record_batch>>
+security_manager::snapshot_commands(model::offset offset) const {
+    std::vector<create_user_cmd> users;
+    for (const auto& [user, credential] : _credentials.local()) {
+        users.emplace_back(
+          user, std::get<security::scram_credential>(credential));
+    }
+    auto bindings = _authorizer.local().acls(
+      security::acl_binding_filter::any());
+
+    std::vector<model::record_batch> ret;
+    ret.reserve(users.size() + 1);
+    for (auto& cmd : users) {
+        ret.push_back(co_await serialize_cmd(std::move(cmd), offset));
+    }
+    if (!bindings.empty()) {
+        ret.push_back(co_await serialize_cmd(
+          create_acls_cmd(
+            create_acls_cmd_data{.bindings = std::move(bindings)}, 0),
+          offset));
+    }
+    co_return ret;
+}
+
 } // namespace cluster
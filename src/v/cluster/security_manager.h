@@ -17,6 +17,8 @@
 
 #include <seastar/core/sharded.hh>
 
+#include <vector>
+
 namespace cluster {
 
 class security_manager final {
@@ -41,6 +43,11 @@ public:
                     == model::record_batch_type::acl_management_cmd;
     }
 
+    /// Returns the commands that rebuild the users and the ACLs, all of them
+    /// at the given offset
+    ss::future<std::vector<model::record_batch>>
+      snapshot_commands(model::offset) const;
+
 private:
     template<typename Cmd, typename T>
     ss::future<std::error_code> dispatch_updates_to_cores(Cmd, ss::sharded<T>&);
@@ -12,6 +12,7 @@
 #include "cluster/controller_api.h"
 #include "cluster/errc.h"
 #include "cluster/fwd.h"
+#include "cluster/health_monitor.h"
 #include "cluster/members_frontend.h"
 #include "cluster/members_manager.h"
 #include "cluster/metadata_cache.h"
@@ -34,14 +35,16 @@ service::service(
   ss::sharded<metadata_cache>& cache,
   ss::sharded<security_frontend>& sf,
   ss::sharded<controller_api>& api,
-  ss::sharded<members_frontend>& members_frontend)
+  ss::sharded<members_frontend>& members_frontend,
+  ss::sharded<health_monitor>& health_monitor)
   : controller_service(sg, ssg)
   , _topics_frontend(tf)
   , _members_manager(mm)
   , _md_cache(cache)
   , _security_frontend(sf)
   , _api(api)
-  , _members_frontend(members_frontend) {}
+  , _members_frontend(members_frontend)
+  , _health_monitor(health_monitor) {}
 
 ss::future<join_reply>
 service::join(join_request&& req, rpc::streaming_context&) {
@@ -259,4 +262,22 @@ service::do_finish_reallocation(finish_reallocation_request req) {
 
     co_return finish_reallocation_reply{.error = errc::success};
 }
+
+ss::future<report_health_reply>
+service::report_health(report_health_request&& req, rpc::streaming_context&) {
+    return ss::with_scheduling_group(
+      get_scheduling_group(), [this, req = std::move(req)]() mutable {
+          return _health_monitor.invoke_on(
+            health_monitor::shard,
+            get_smp_service_group(),
+            [report = std::move(req.report)](health_monitor& hm) mutable {
+                if (!hm.is_active()) {
+                    return report_health_reply{
+                      .error = errc::not_leader_controller};
+                }
+                hm.update_report(std::move(report));
+                return report_health_reply{.error = errc::success};
+            });
+      });
+}
 } // namespace cluster
@@ -0,0 +1,266 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/shard_balancer.h"
+
+#include "cluster/logger.h"
+#include "cluster/partition_manager.h"
+#include "cluster/topic_table.h"
+#include "cluster/topics_frontend.h"
+#include "config/configuration.h"
+#include "model/namespace.h"
+#include "model/timeout_clock.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+
+#include <algorithm>
+#include <cmath>
+
+namespace cluster {
+
+shard_balancer::shard_balancer(
+  ss::sharded<topic_table>& topics,
+  ss::sharded<topics_frontend>& topics_frontend,
+  ss::sharded<partition_manager>& partition_manager,
+  ss::sharded<ss::abort_source>& as)
+  : _topics(topics)
+  , _topics_frontend(topics_frontend)
+  , _partition_manager(partition_manager)
+  , _as(as)
+  , _self(config::shard_local_cfg().node_id()) {
+    _timer.set_callback([this] {
+        (void)ss::with_gate(_gate, [this] { return tick(); });
+    });
+}
+
+void shard_balancer::start() {
+    setup_metrics();
+    arm(config::shard_local_cfg().shard_balancer_tick_interval_ms());
+}
+
+ss::future<> shard_balancer::stop() {
+    _timer.cancel();
+    return _gate.close();
+}
+
+void shard_balancer::arm(clock_type::duration d) {
+    if (_gate.is_closed() || _as.local().abort_requested()) {
+        return;
+    }
+    _timer.arm(d);
+}
+
+ss::future<> shard_balancer::tick() {
+    if (
+      config::shard_local_cfg().enable_shard_balancer()
+      && ss::smp::count > 1) {
+        try {
+            co_await balance();
+        } catch (...) {
+            vlog(
+              clusterlog.info,
+              "shard balancer iteration failed: {}",
+              std::current_exception());
+        }
+    } else {
+        // the rates are computed between consecutive iterations
+        _last_sample.clear();
+    }
+    arm(config::shard_local_cfg().shard_balancer_tick_interval_ms());
+}
+
+std::optional<shard_balancer::move> shard_balancer::pick_move(
+  const std::vector<shard_load>& loads, double max_skew, double min_load) {
+    if (loads.size() < 2) {
+        return std::nullopt;
+    }
+    auto [min_it, max_it] = std::minmax_element(
+      loads.begin(), loads.end(), [](const shard_load& a, const shard_load& b) {
+          return a.load < b.load;
+      });
+    if (max_it->load < min_load || max_it->load <= 0) {
+        return std::nullopt;
+    }
+    auto diff = max_it->load - min_it->load;
+    if (diff / max_it->load <= max_skew) {
+        return std::nullopt;
+    }
+    // moving a partition as loaded as the difference would only swap the
+    // cores, the best one halves the difference
+    const std::pair<model::ntp, double>* best = nullptr;
+    for (const auto& p : max_it->partitions) {
+        if (p.second <= 0 || p.second >= diff) {
+            continue;
+        }
+        auto distance = std::abs(p.second - diff / 2);
+        if (!best || distance < std::abs(best->second - diff / 2)) {
+            best = &p;
+        }
+    }
+    if (!best) {
+        return std::nullopt;
+    }
+    return move{
+      .ntp = best->first,
+      .source = max_it->shard,
+      .target = min_it->shard,
+    };
+}
+
+std::vector<shard_balancer::shard_load> shard_balancer::loads(
+  const samples_t& samples, clock_type::duration elapsed) const {
+    double seconds
+      = std::chrono::duration_cast<std::chrono::duration<double>>(elapsed)
+          .count();
+    std::vector<shard_load> ret;
+    ret.reserve(samples.size());
+    for (ss::shard_id s = 0; s < samples.size(); ++s) {
+        shard_load sl{.shard = s};
+        sl.partitions.reserve(samples[s].size());
+        for (const auto& [ntp, current] : samples[s]) {
+            // the rate of a partition created or moved since the previous
+            // iteration isn't known yet
+            auto it = _last_sample.find(ntp);
+            if (
+              it == _last_sample.end() || current.bytes < it->second.bytes
+              || current.requests < it->second.requests) {
+                continue;
+            }
+            auto bytes = current.bytes - it->second.bytes;
+            auto requests = current.requests - it->second.requests;
+            auto load = (bytes + requests * request_weight) / seconds;
+            sl.load += load;
+            sl.partitions.emplace_back(ntp, load);
+        }
+        ret.push_back(std::move(sl));
+    }
+    return ret;
+}
+
+ss::future<> shard_balancer::balance() {
+    auto now = clock_type::now();
+    absl::erase_if(_muted, [now](const auto& p) { return p.second <= now; });
+
+    auto samples = co_await _partition_manager.map([](partition_manager& pm) {
+        std::vector<std::pair<model::ntp, partition_load>> ret;
+        ret.reserve(pm.partitions().size());
+        for (const auto& [ntp, p] : pm.partitions()) {
+            ret.emplace_back(ntp, p->probe().load());
+        }
+        return ret;
+    });
+
+    auto elapsed = now - _last_sample_at;
+    std::vector<shard_load> shard_loads;
+    if (!_last_sample.empty() && elapsed > clock_type::duration::zero()) {
+        shard_loads = loads(samples, elapsed);
+    }
+    _last_sample.clear();
+    for (auto& shard_samples : samples) {
+        for (auto& [ntp, load] : shard_samples) {
+            _last_sample.emplace(std::move(ntp), load);
+        }
+    }
+    _last_sample_at = now;
+
+    // the partitions that can't be moved are not candidates, their load
+    // still counts
+    for (auto& sl : shard_loads) {
+        std::erase_if(sl.partitions, [this](const auto& p) {
+            const auto& ntp = p.first;
+            return ntp.ns == model::redpanda_ns
+                   || ntp.ns == model::kafka_internal_namespace
+                   || _muted.contains(ntp)
+                   || _topics.local().is_update_in_progress(ntp);
+        });
+    }
+
+    auto m = pick_move(
+      shard_loads,
+      config::shard_local_cfg().shard_balancer_max_skew(),
+      double(config::shard_local_cfg().shard_balancer_min_load_bytes()));
+    if (!m) {
+        vlog(clusterlog.trace, "shard balancer: cores are balanced");
+        co_return;
+    }
+    _muted[m->ntp] = now + mute_timeout;
+    co_await do_move(std::move(*m));
+}
+
+ss::future<> shard_balancer::do_move(move m) {
+    auto assignment = _topics.local().get_partition_assignment(m.ntp);
+    if (!assignment) {
+        co_return;
+    }
+    auto replicas = assignment->replicas;
+    auto it = std::find_if(
+      replicas.begin(), replicas.end(), [this](const model::broker_shard& bs) {
+          return bs.node_id == _self;
+      });
+    if (it == replicas.end() || it->shard != m.source) {
+        // the partition was moved in the meantime
+        co_return;
+    }
+    it->shard = m.target;
+    vlog(
+      clusterlog.info,
+      "shard balancer: moving partition {} from core {} to core {}",
+      m.ntp,
+      m.source,
+      m.target);
+    std::error_code ec;
+    try {
+        ec = co_await _topics_frontend.local().move_partition_replicas(
+          m.ntp, replicas, model::timeout_clock::now() + move_timeout);
+    } catch (...) {
+        vlog(
+          clusterlog.info,
+          "shard balancer: error moving partition {} - {}",
+          m.ntp,
+          std::current_exception());
+        _move_errors++;
+        co_return;
+    }
+    if (ec) {
+        vlog(
+          clusterlog.info,
+          "shard balancer: error moving partition {} - {}",
+          m.ntp,
+          ec.message());
+        _move_errors++;
+        co_return;
+    }
+    _moves++;
+}
+
+void shard_balancer::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("cluster:shard_balancer"),
+      {
+        sm::make_derive(
+          "partition_moves",
+          [this] { return _moves; },
+          sm::description("Number of partition moves between the cores of "
+                          "the node requested by the shard balancer")),
+        sm::make_derive(
+          "partition_move_errors",
+          [this] { return _move_errors; },
+          sm::description("Number of partition moves requested by the "
+                          "shard balancer that failed")),
+      });
+}
+
+} // namespace cluster
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "cluster/fwd.h"
+#include "cluster/partition_probe.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "seastarx.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace cluster {
+
+/**
+ * Moves partitions between the cores of the node.
+ *
+ * The core of a partition is chosen when the replica is allocated, the hot
+ * partitions that end up on the same core saturate it while the other cores
+ * of the node are idle. The balancer runs on every node and periodically
+ * samples the bytes and the requests served by the partitions of each core.
+ * When the relative skew between the most and the least loaded cores crosses
+ * the threshold a single partition of the most loaded core is moved to the
+ * least loaded one with the move_partition_replicas command, the
+ * controller_backend moves it across the cores of the node.
+ *
+ * A partition is only moved if it decreases the skew, its load being less
+ * than the difference between the two cores. A moved partition isn't moved
+ * again until the mute timeout elapses.
+ */
+class shard_balancer {
+public:
+    static constexpr ss::shard_id shard = 0;
+
+    using clock_type = ss::lowres_clock;
+
+    /// Weight of a request in bytes, a request costs the same cpu as
+    /// serving that many bytes
+    static constexpr double request_weight = 4096;
+
+    /// Load of a core in bytes per second, the input of the balancing plan
+    struct shard_load {
+        ss::shard_id shard;
+        double load{0};
+        std::vector<std::pair<model::ntp, double>> partitions;
+    };
+
+    struct move {
+        model::ntp ntp;
+        ss::shard_id source;
+        ss::shard_id target;
+    };
+
+    shard_balancer(
+      ss::sharded<topic_table>&,
+      ss::sharded<topics_frontend>&,
+      ss::sharded<partition_manager>&,
+      ss::sharded<ss::abort_source>&);
+
+    void start();
+    ss::future<> stop();
+
+    /**
+     * Returns the partition to move from the most to the least loaded core,
+     * if the relative skew of their loads, (max - min) / max, is greater
+     * than `max_skew` and the most loaded core serves at least `min_load`.
+     * The partition with the load closest to half of the difference is
+     * picked. Partitions that would not decrease the skew are not moved.
+     */
+    static std::optional<move>
+    pick_move(const std::vector<shard_load>&, double max_skew, double min_load);
+
+private:
+    // the load of the partitions of each core, indexed by the core
+    using samples_t
+      = std::vector<std::vector<std::pair<model::ntp, partition_load>>>;
+
+    void arm(clock_type::duration);
+    void setup_metrics();
+    ss::future<> tick();
+    ss::future<> balance();
+    std::vector<shard_load> loads(const samples_t&, clock_type::duration) const;
+    ss::future<> do_move(move);
+
+    /// Time after which a partition that was moved (or failed to move) can
+    /// be moved again, its load on the target core has to be sampled
+    static constexpr std::chrono::minutes mute_timeout{10};
+    // upper bound of the time the move command takes to be applied
+    static constexpr std::chrono::seconds move_timeout{10};
+
+    ss::sharded<topic_table>& _topics;
+    ss::sharded<topics_frontend>& _topics_frontend;
+    ss::sharded<partition_manager>& _partition_manager;
+    ss::sharded<ss::abort_source>& _as;
+    model::node_id _self;
+
+    // the load of the partitions at the previous iteration
+    absl::flat_hash_map<model::ntp, partition_load> _last_sample;
+    clock_type::time_point _last_sample_at;
+    absl::flat_hash_map<model::ntp, clock_type::time_point> _muted;
+    ss::timer<clock_type> _timer;
+    ss::gate _gate;
+
+    uint64_t _moves{0};
+    uint64_t _move_errors{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace cluster
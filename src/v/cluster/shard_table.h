@@ -12,11 +12,13 @@
 #pragma once
 
 #include "model/fundamental.h"
+#include "model/ntp_interner.h"
 #include "raft/types.h"
 #include "seastarx.h"
 
 #include <seastar/core/reactor.hh> // shard_id
 
+#include <absl/container/flat_hash_map.h>
 #include <absl/container/node_hash_map.h>
 
 namespace cluster {
@@ -29,6 +31,16 @@ class shard_table final {
     };
 
 public:
+    shard_table() = default;
+    shard_table(const shard_table&) = delete;
+    shard_table& operator=(const shard_table&) = delete;
+    ~shard_table() noexcept {
+        auto& interner = model::ntp_interner::local();
+        for (const auto& [id, _] : _ntp_idx) {
+            interner.release(id.topic);
+        }
+    }
+
     bool contains(const raft::group_id& group) {
         return _group_idx.find(group) != _group_idx.end();
     }
@@ -40,15 +52,30 @@ public:
      * \brief Lookup the owning shard for an ntp.
      */
     std::optional<ss::shard_id> shard_for(const model::ntp& ntp) {
-        if (auto it = _ntp_idx.find(ntp); it != _ntp_idx.end()) {
+        if (auto id = model::ntp_interner::local().find(ntp); id) {
+            return shard_for(*id);
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * \brief Lookup the owning shard for an interned ntp, without hashing
+     * the topic.
+     */
+    std::optional<ss::shard_id> shard_for(model::ntp_id id) {
+        if (auto it = _ntp_idx.find(id); it != _ntp_idx.end()) {
             return it->second.shard;
         }
         return std::nullopt;
     }
 
     bool insert(model::ntp ntp, ss::shard_id i, model::revision_id rev) {
-        auto [_, success] = _ntp_idx.insert(
-          {std::move(ntp), shard_revision{i, rev}});
+        auto& interner = model::ntp_interner::local();
+        auto id = interner.intern(ntp);
+        auto [_, success] = _ntp_idx.insert({id, shard_revision{i, rev}});
+        if (!success) {
+            interner.release(id.topic);
+        }
         return success;
     }
 
@@ -62,35 +89,49 @@ public:
       raft::group_id g,
       ss::shard_id shard,
       model::revision_id rev) {
-        if (auto it = _ntp_idx.find(ntp); it != _ntp_idx.end()) {
+        auto& interner = model::ntp_interner::local();
+        auto id = interner.find(ntp);
+        auto it = id ? _ntp_idx.find(*id) : _ntp_idx.end();
+        if (it != _ntp_idx.end()) {
             if (it->second.revision > rev) {
                 return;
             }
         }
-        if (auto it = _group_idx.find(g); it != _group_idx.end()) {
-            if (it->second.revision > rev) {
+        if (auto g_it = _group_idx.find(g); g_it != _group_idx.end()) {
+            if (g_it->second.revision > rev) {
                 return;
             }
         }
 
-        _ntp_idx.insert_or_assign(ntp, shard_revision{shard, rev});
+        if (it != _ntp_idx.end()) {
+            it->second = shard_revision{shard, rev};
+        } else {
+            // the entry holds a reference to the id of its topic
+            _ntp_idx.emplace(interner.intern(ntp), shard_revision{shard, rev});
+        }
         _group_idx.insert_or_assign(g, shard_revision{shard, rev});
     }
 
     void
     erase(const model::ntp& ntp, raft::group_id g, model::revision_id rev) {
-        if (auto it = _ntp_idx.find(ntp); it != _ntp_idx.end()) {
+        auto& interner = model::ntp_interner::local();
+        auto id = interner.find(ntp);
+        auto it = id ? _ntp_idx.find(*id) : _ntp_idx.end();
+        if (it != _ntp_idx.end()) {
             if (it->second.revision > rev) {
                 return;
             }
         }
-        if (auto it = _group_idx.find(g); it != _group_idx.end()) {
-            if (it->second.revision > rev) {
+        if (auto g_it = _group_idx.find(g); g_it != _group_idx.end()) {
+            if (g_it->second.revision > rev) {
                 return;
             }
         }
 
-        _ntp_idx.erase(ntp);
+        if (it != _ntp_idx.end()) {
+            _ntp_idx.erase(it);
+            interner.release(id->topic);
+        }
         _group_idx.erase(g);
     }
 
@@ -110,8 +151,8 @@ private:
      * cluster::shard_table state isn't corrupted.
      */
 
-    // kafka index
-    absl::node_hash_map<model::ntp, shard_revision> _ntp_idx;
+    // kafka index, keyed by the interned ntps
+    absl::flat_hash_map<model::ntp_id, shard_revision> _ntp_idx;
     // raft index
     absl::node_hash_map<raft::group_id, shard_revision> _group_idx;
 };
@@ -15,6 +15,8 @@
 #include <seastar/core/sharded.hh>
 #include <seastar/testing/perf_tests.hh>
 
+#include <fmt/format.h>
+
 #include <vector>
 
 PERF_TEST_F(partition_allocator_fixture, allocation_3) {
@@ -65,3 +67,35 @@ PERF_TEST_F(partition_allocator_fixture, recovery) {
       replicas, raft::group_id(replicas.size() / 3));
     perf_tests::stop_measuring_time();
 }
+
+PERF_TEST_F(partition_allocator_fixture, allocation_100k) {
+    register_node(0, 24);
+    register_node(1, 24);
+    register_node(2, 24);
+    register_node(3, 24);
+    register_node(4, 24);
+    auto req = make_allocation_request(100'000, 3);
+
+    perf_tests::start_measuring_time();
+    auto vals = allocator.allocate(std::move(req));
+    perf_tests::do_not_optimize(vals);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST_F(partition_allocator_fixture, allocation_100k_racks_and_load) {
+    for (int i = 0; i < 6; ++i) {
+        register_node(i, 24, fmt::format("rack-{}", i % 3));
+        allocator.update_node_usage(
+          model::node_id(i),
+          cluster::allocation_node::usage{
+            .disk_used_bytes = uint64_t(i + 1) << 30U,
+            .disk_total_bytes = uint64_t(100) << 30U,
+            .bytes_rate = uint64_t(i + 1) << 20U});
+    }
+    auto req = make_allocation_request(100'000, 3);
+
+    perf_tests::start_measuring_time();
+    auto vals = allocator.allocate(std::move(req));
+    perf_tests::do_not_optimize(vals);
+    perf_tests::stop_measuring_time();
+}
@@ -0,0 +1,398 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf_parser.h"
+#include "cluster/controller_stm.h"
+#include "cluster/members_frontend.h"
+#include "cluster/members_table.h"
+#include "cluster/security_frontend.h"
+#include "cluster/tests/cluster_test_fixture.h"
+#include "cluster/topics_frontend.h"
+#include "model/namespace.h"
+#include "reflection/adl.h"
+#include "security/acl.h"
+#include "security/credential_store.h"
+#include "security/scram_algorithm.h"
+#include "storage/snapshot.h"
+#include "test_utils/fixture.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+
+#include <algorithm>
+#include <filesystem>
+
+using namespace std::chrono_literals; // NOLINT
+
+namespace {
+
+model::topic_namespace make_tp_ns(ss::sstring topic) {
+    return model::topic_namespace(
+      model::kafka_namespace, model::topic(std::move(topic)));
+}
+
+model::ntp make_ntp(ss::sstring topic, int partition) {
+    return model::ntp(
+      model::kafka_namespace,
+      model::topic(std::move(topic)),
+      model::partition_id(partition));
+}
+
+/*
+ * The part of the controller state a snapshot rebuilds, as strings so that
+ * a mismatch is printed
+ */
+struct controller_state {
+    std::vector<ss::sstring> topics;
+    std::vector<ss::sstring> users;
+    std::vector<ss::sstring> acls;
+    std::vector<model::node_id> decommissioned;
+
+    bool operator==(const controller_state&) const = default;
+
+    friend std::ostream&
+    operator<<(std::ostream& o, const controller_state& s) {
+        fmt::print(
+          o,
+          "{{topics: {}, users: {}, acls: {}, decommissioned: {}}}",
+          s.topics,
+          s.users,
+          s.acls,
+          s.decommissioned);
+        return o;
+    }
+};
+
+} // namespace
+
+class controller_snapshot_fixture : public cluster_test_fixture {
+public:
+    controller_snapshot_fixture() {
+        set_configuration("enable_controller_snapshots", true);
+        set_configuration("controller_snapshot_max_entries", size_t(1));
+    }
+
+    ~controller_snapshot_fixture() {
+        for (auto id : _nodes) {
+            remove_node_application(id);
+        }
+        set_configuration("enable_controller_snapshots", false);
+        set_configuration("controller_snapshot_max_entries", size_t(10'000));
+    }
+
+    cluster::controller* start_node(model::node_id id) {
+        auto app = create_node_application(id);
+        // the configuration is shared, it holds the data directory of the
+        // node started last
+        _data_dirs[id] = config::shard_local_cfg().data_directory().path;
+        if (std::find(_nodes.begin(), _nodes.end(), id) == _nodes.end()) {
+            _nodes.push_back(id);
+        }
+        return app->controller.get();
+    }
+
+    cluster::controller* restart_node(model::node_id id) {
+        remove_node_application(id);
+        return start_node(id);
+    }
+
+    void stop_node(model::node_id id) { remove_node_application(id); }
+
+    cluster::controller* controller(model::node_id id) {
+        return get_node_application(id)->controller.get();
+    }
+
+    std::filesystem::path snapshot_path(model::node_id id) {
+        for (auto& e :
+             std::filesystem::recursive_directory_iterator(_data_dirs[id])) {
+            if (e.path().filename() == "controller.snapshot") {
+                return e.path();
+            }
+        }
+        return {};
+    }
+
+    // offset of the last controller command included in the snapshot
+    std::optional<model::offset> snapshot_offset(model::node_id id) {
+        auto path = snapshot_path(id);
+        if (path.empty()) {
+            return std::nullopt;
+        }
+        storage::snapshot_manager mgr(
+          path.parent_path(),
+          path.filename().string(),
+          ss::default_priority_class());
+        auto reader = mgr.open_snapshot().get0();
+        if (!reader) {
+            return std::nullopt;
+        }
+        iobuf_parser meta(reader->read_metadata().get0());
+        reader->close().get();
+        auto version = reflection::adl<int8_t>{}.from(meta);
+        BOOST_REQUIRE_EQUAL(version, cluster::controller_stm::snapshot_version);
+        return reflection::adl<model::offset>{}.from(meta);
+    }
+
+    model::offset controller_committed_offset(model::node_id id) {
+        return get_partition_manager(id)
+          .local()
+          .get(model::controller_ntp)
+          ->committed_offset();
+    }
+
+    /*
+     * Waits for a snapshot of everything the controller of the node applied
+     * so far. A snapshot isn't taken while the previous one is written,
+     * users are created until one is.
+     */
+    void wait_for_snapshot(model::node_id id) {
+        auto target = controller_committed_offset(id);
+        auto deadline = model::timeout_clock::now() + 30s;
+        for (int marker = 0;; ++marker) {
+            auto offset = snapshot_offset(id);
+            if (offset && *offset >= target) {
+                return;
+            }
+            BOOST_REQUIRE(model::timeout_clock::now() < deadline);
+            create_user(id, ssx::sformat("marker-{}", marker)).get();
+            ss::sleep(100ms).get();
+        }
+    }
+
+    ss::future<> create_user(model::node_id id, ss::sstring name) {
+        auto credential = security::scram_sha256::make_credentials(
+          "password", security::scram_sha256::min_iterations);
+        return controller(id)
+          ->get_security_frontend()
+          .local()
+          .create_user(
+            security::credential_user(std::move(name)),
+            std::move(credential),
+            model::timeout_clock::now() + 10s)
+          .discard_result();
+    }
+
+    void create_topic(model::node_id id, ss::sstring topic, int p, int r) {
+        auto tp_ns = make_tp_ns(std::move(topic));
+        auto res = controller(id)
+                     ->get_topics_frontend()
+                     .local()
+                     .create_topics(
+                       {cluster::topic_configuration(tp_ns.ns, tp_ns.tp, p, r)},
+                       model::timeout_clock::now() + 10s)
+                     .get0();
+        BOOST_REQUIRE_EQUAL(res.size(), 1);
+        BOOST_REQUIRE_EQUAL(res[0].ec, cluster::errc::success);
+        wait_for_metadata(controller(id)->get_topics_state().local(), res);
+    }
+
+    void delete_topic(model::node_id id, ss::sstring topic) {
+        auto res = controller(id)
+                     ->get_topics_frontend()
+                     .local()
+                     .delete_topics(
+                       {make_tp_ns(std::move(topic))},
+                       model::timeout_clock::now() + 10s)
+                     .get0();
+        BOOST_REQUIRE_EQUAL(res.size(), 1);
+        BOOST_REQUIRE_EQUAL(res[0].ec, cluster::errc::success);
+    }
+
+    // moves the replica of the partition to the given node and waits for the
+    // move to finish
+    void move_partition(model::node_id id, model::ntp ntp, model::node_id to) {
+        std::vector<model::broker_shard> replicas{
+          model::broker_shard{.node_id = to, .shard = ss::smp::count - 1}};
+        auto ec = controller(id)
+                    ->get_topics_frontend()
+                    .local()
+                    .move_partition_replicas(
+                      ntp, replicas, model::timeout_clock::now() + 10s)
+                    .get0();
+        BOOST_REQUIRE(!ec);
+        tests::cooperative_spin_wait_with_timeout(30s, [this, id, ntp] {
+            return !controller(id)
+                      ->get_topics_state()
+                      .local()
+                      .is_update_in_progress(ntp);
+        }).get();
+    }
+
+    void create_acl(model::node_id id, ss::sstring user, ss::sstring topic) {
+        security::acl_binding binding(
+          security::resource_pattern(
+            security::resource_type::topic,
+            std::move(topic),
+            security::pattern_type::literal),
+          security::acl_entry(
+            security::acl_principal(
+              security::principal_type::user, std::move(user)),
+            security::acl_host::wildcard_host(),
+            security::acl_operation::read,
+            security::acl_permission::allow));
+        auto res = controller(id)
+                     ->get_security_frontend()
+                     .local()
+                     .create_acls({std::move(binding)}, 10s)
+                     .get0();
+        BOOST_REQUIRE_EQUAL(res.size(), 1);
+        BOOST_REQUIRE_EQUAL(res[0], cluster::errc::success);
+    }
+
+    controller_state state(model::node_id id) {
+        auto c = controller(id);
+        controller_state s;
+        for (const auto& [tp_ns, md] :
+             c->get_topics_state().local().topics_map()) {
+            s.topics.push_back(ssx::sformat(
+              "{} revision: {} cfg: {} assignments: {}",
+              tp_ns,
+              md.revision,
+              md.configuration.cfg,
+              md.configuration.assignments));
+        }
+        for (const auto& [user, _] : c->get_credential_store().local()) {
+            s.users.push_back(user());
+        }
+        for (const auto& binding : c->get_authorizer().local().acls(
+               security::acl_binding_filter::any())) {
+            s.acls.push_back(ssx::sformat("{}", binding));
+        }
+        s.decommissioned = c->get_members_table().local().get_decommissioned();
+        std::sort(s.topics.begin(), s.topics.end());
+        std::sort(s.users.begin(), s.users.end());
+        std::sort(s.acls.begin(), s.acls.end());
+        std::sort(s.decommissioned.begin(), s.decommissioned.end());
+        return s;
+    }
+
+    void wait_for_state(model::node_id id, const controller_state& expected) {
+        try {
+            tests::cooperative_spin_wait_with_timeout(
+              30s, [this, id, &expected] { return state(id) == expected; })
+              .get();
+        } catch (...) {
+            BOOST_FAIL(fmt::format(
+              "controller state: {}, expected: {}", state(id), expected));
+        }
+    }
+
+    // the partitions of the topic were removed from the node
+    bool topic_removed(model::node_id id, const ss::sstring& topic) {
+        auto dir = _data_dirs[id] / model::kafka_namespace().c_str()
+                   / topic.c_str();
+        return !std::filesystem::exists(dir) || std::filesystem::is_empty(dir);
+    }
+
+private:
+    std::vector<model::node_id> _nodes;
+    absl::flat_hash_map<model::node_id, std::filesystem::path> _data_dirs;
+};
+
+FIXTURE_TEST(
+  controller_snapshot_and_tail_match_full_replay, controller_snapshot_fixture) {
+    const model::node_id n0(0);
+    const model::node_id n1(1);
+    start_node(n0);
+    wait_for_controller_leadership(n0).get();
+    start_node(n1);
+    wait_for_all_members(10s).get();
+
+    // state included in the snapshot
+    create_topic(n0, "tp-1", 3, 1);
+    create_topic(n0, "tp-2", 1, 2);
+    create_topic(n0, "tp-deleted", 2, 1);
+    move_partition(n0, make_ntp("tp-1", 0), n0);
+    move_partition(n0, make_ntp("tp-1", 1), n1);
+    delete_topic(n0, "tp-deleted");
+    create_user(n0, "alice").get();
+    create_acl(n0, "alice", "tp-1");
+    // tp-2 has a replica on every node, the decommissioning never finishes
+    auto ec = controller(n0)
+                ->get_members_frontend()
+                .local()
+                .decommission_node(n1)
+                .get0();
+    BOOST_REQUIRE(!ec);
+    tests::cooperative_spin_wait_with_timeout(30s, [this, n0, n1] {
+        auto ids
+          = controller(n0)->get_members_table().local().get_decommissioned();
+        return std::find(ids.begin(), ids.end(), n1) != ids.end();
+    }).get();
+    wait_for_snapshot(n0);
+
+    // the tail of the log replayed after the snapshot
+    set_configuration("controller_snapshot_max_entries", size_t(1'000'000));
+    create_topic(n0, "tp-3", 2, 1);
+    move_partition(n0, make_ntp("tp-3", 0), n0);
+    delete_topic(n0, "tp-1");
+    create_user(n0, "bob").get();
+    create_acl(n0, "bob", "tp-3");
+
+    // the state of the node applied every command of the log
+    auto expected = state(n0);
+    BOOST_REQUIRE(!expected.topics.empty());
+    BOOST_REQUIRE(!expected.decommissioned.empty());
+
+    restart_node(n0);
+    wait_for_state(n0, expected);
+    tests::cooperative_spin_wait_with_timeout(30s, [this, n0] {
+        return topic_removed(n0, "tp-deleted") && topic_removed(n0, "tp-1");
+    }).get();
+}
+
+FIXTURE_TEST(
+  controller_snapshot_deletion_not_reconciled, controller_snapshot_fixture) {
+    const model::node_id n0(0);
+    start_node(n0);
+    wait_for_controller_leadership(n0).get();
+
+    create_topic(n0, "tp-1", 1, 1);
+    create_topic(n0, "tp-deleted", 4, 1);
+    delete_topic(n0, "tp-deleted");
+    // the snapshot may be taken before the backend removed the partitions,
+    // the node restarted right after it still removes them
+    wait_for_snapshot(n0);
+    auto expected = state(n0);
+
+    restart_node(n0);
+    wait_for_state(n0, expected);
+    tests::cooperative_spin_wait_with_timeout(
+      30s, [this, n0] { return topic_removed(n0, "tp-deleted"); })
+      .get();
+}
+
+FIXTURE_TEST(
+  controller_snapshot_ignored_when_unreadable, controller_snapshot_fixture) {
+    const model::node_id n0(0);
+    start_node(n0);
+    wait_for_controller_leadership(n0).get();
+
+    create_topic(n0, "tp-1", 2, 1);
+    create_user(n0, "alice").get();
+    create_acl(n0, "alice", "tp-1");
+    wait_for_snapshot(n0);
+    set_configuration("controller_snapshot_max_entries", size_t(1'000'000));
+    auto expected = state(n0);
+    auto path = snapshot_path(n0);
+
+    // the state is rebuilt from the whole log
+    stop_node(n0);
+    auto f = ss::open_file_dma(
+               path.string(), ss::open_flags::wo | ss::open_flags::truncate)
+               .get0();
+    auto out = ss::make_file_output_stream(std::move(f)).get0();
+    out.write(ss::sstring(128, 'x')).get();
+    out.flush().get();
+    out.close().get();
+
+    start_node(n0);
+    wait_for_state(n0, expected);
+}
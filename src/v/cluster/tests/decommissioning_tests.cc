@@ -1,12 +1,20 @@
 
+#include "cluster/members_backend.h"
 #include "cluster/tests/rebalancing_tests_fixture.h"
+#include "cluster/topic_table.h"
+#include "config/configuration.h"
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sstring.hh>
 
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/sleep.hh>
+
 #include <absl/container/flat_hash_map.h>
 #include <boost/test/tools/old/interface.hpp>
 
+#include <algorithm>
+
 FIXTURE_TEST(test_single_node_decomissioning, rebalancing_tests_fixture) {
     start_cluster(3);
     create_topic(create_topic_cfg("test-1", 3, 1));
@@ -28,6 +36,111 @@ FIXTURE_TEST(test_single_node_decomissioning, rebalancing_tests_fixture) {
     wait_for_node_decommissioned(0).get0();
 }
 
+/*
+ * Decommissions a node of a cluster where every partition has a replica on
+ * it and samples the moves in progress while the replicas are moved to the
+ * added node.
+ */
+class throttled_decommissioning_fixture : public rebalancing_tests_fixture {
+public:
+    throttled_decommissioning_fixture() {
+        // frequent reconciliation rounds so that the moves are scheduled in
+        // many small steps
+        set_configuration(
+          "members_backend_retry_ms", std::chrono::milliseconds(500));
+    }
+
+    ~throttled_decommissioning_fixture() {
+        set_configuration(
+          "members_backend_retry_ms", std::chrono::milliseconds(5000));
+        set_configuration("members_backend_max_concurrent_moves", size_t(50));
+        set_configuration("members_backend_max_moves_per_node", size_t(8));
+        set_configuration(
+          "members_backend_recovery_bandwidth", std::optional<size_t>());
+    }
+
+    /// Returns the largest number of partition moves observed at once
+    size_t decommission_and_sample_moves() {
+        start_cluster(3);
+        create_topic(create_topic_cfg("test-1", 12, 3));
+        populate_all_topics_with_data();
+
+        auto res = (*get_leader_node_application())
+                     ->controller->get_members_frontend()
+                     .local()
+                     .decommission_node(model::node_id(0))
+                     .get0();
+        BOOST_REQUIRE(!res);
+        add_node(10);
+
+        size_t max_moves = 0;
+        auto deadline = ss::lowres_clock::now() + 90s;
+        while (!is_decommissioned(model::node_id(0))) {
+            BOOST_REQUIRE(ss::lowres_clock::now() < deadline);
+            // every node applies the same moves, the partitions moved by the
+            // backend are the only ones in progress
+            max_moves = std::max(
+              max_moves,
+              node_application(1)
+                ->controller->get_topics_state()
+                .local()
+                .updates_in_progress());
+            if (auto leader = get_leader_node_application(); leader) {
+                auto st = (*leader)
+                            ->controller->get_members_backend()
+                            .local()
+                            .get_status();
+                for (const auto& u : st.updates) {
+                    max_moves = std::max(max_moves, u.partitions_moving);
+                }
+            }
+            ss::sleep(20ms).get();
+        }
+        return max_moves;
+    }
+
+private:
+    bool is_decommissioned(model::node_id id) {
+        auto ids = node_application(1)
+                     ->controller->get_members_table()
+                     .local()
+                     .all_broker_ids();
+        return std::find(ids.begin(), ids.end(), id) == ids.end();
+    }
+};
+
+FIXTURE_TEST(
+  test_decommissioning_max_concurrent_moves,
+  throttled_decommissioning_fixture) {
+    set_configuration("members_backend_max_concurrent_moves", size_t(2));
+
+    auto max_moves = decommission_and_sample_moves();
+    BOOST_REQUIRE_GT(max_moves, 0);
+    BOOST_REQUIRE_LE(max_moves, 2);
+}
+
+FIXTURE_TEST(
+  test_decommissioning_max_moves_per_node,
+  throttled_decommissioning_fixture) {
+    // all the replicas are moved to the added node
+    set_configuration("members_backend_max_moves_per_node", size_t(1));
+
+    auto max_moves = decommission_and_sample_moves();
+    BOOST_REQUIRE_EQUAL(max_moves, 1);
+}
+
+FIXTURE_TEST(
+  test_decommissioning_recovery_bandwidth, throttled_decommissioning_fixture) {
+    // the budget of two moves recovering at the learner recovery rate
+    auto rate = config::shard_local_cfg().raft_learner_recovery_rate();
+    set_configuration(
+      "members_backend_recovery_bandwidth", std::optional<size_t>(2 * rate));
+
+    auto max_moves = decommission_and_sample_moves();
+    BOOST_REQUIRE_GT(max_moves, 0);
+    BOOST_REQUIRE_LE(max_moves, 2);
+}
+
 // TODO: enable when after we investigate issues on aarch_64
 #if 0
 FIXTURE_TEST(test_two_nodes_decomissioning, rebalancing_tests_fixture) {
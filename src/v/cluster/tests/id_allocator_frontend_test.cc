@@ -0,0 +1,238 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/id_allocator_frontend.h"
+#include "cluster/partition_leaders_table.h"
+#include "cluster/partition_manager.h"
+#include "cluster/shard_table.h"
+#include "cluster/tests/cluster_test_fixture.h"
+#include "model/namespace.h"
+#include "test_utils/fixture.h"
+
+#include <seastar/core/loop.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/sleep.hh>
+
+#include <boost/range/irange.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace std::chrono_literals; // NOLINT
+
+class id_allocator_frontend_fixture : public cluster_test_fixture {
+public:
+    static constexpr int16_t lease_size = 10;
+
+    struct allocation {
+        std::vector<int64_t> ids;
+        size_t failures{0};
+    };
+
+    id_allocator_frontend_fixture() {
+        set_configuration("id_allocator_shard_lease_size", lease_size);
+    }
+
+    ~id_allocator_frontend_fixture() {
+        for (auto id : _nodes) {
+            remove_node_application(id);
+        }
+        set_configuration("id_allocator_shard_lease_size", int16_t(100));
+        set_configuration("id_allocator_replication", int16_t(1));
+        set_configuration("metadata_dissemination_retries", int16_t(30));
+    }
+
+    void start_nodes(int count) {
+        for (int i = 0; i < count; ++i) {
+            create_node_application(model::node_id(i));
+            _nodes.emplace_back(i);
+        }
+        wait_for_all_members(10s).get();
+    }
+
+    void stop_node(model::node_id id) {
+        remove_node_application(id);
+        _nodes.erase(std::find(_nodes.begin(), _nodes.end(), id));
+    }
+
+    /// Allocates ids from all the shards of the node at once, every shard
+    /// serves the given number of concurrent callers
+    allocation allocate_ids(model::node_id id, int per_shard) {
+        return get_node_application(id)
+          ->id_allocator_frontend
+          .map_reduce0(
+            [per_shard](cluster::id_allocator_frontend& f) {
+                return ss::do_with(
+                  allocation{}, [&f, per_shard](allocation& ret) {
+                      return ss::parallel_for_each(
+                               boost::irange(0, per_shard),
+                               [&f, &ret](int) {
+                                   return f.allocate_id(5s).then(
+                                     [&ret](cluster::allocate_id_reply r) {
+                                         if (r.ec == cluster::errc::success) {
+                                             ret.ids.push_back(r.id);
+                                         } else {
+                                             ret.failures++;
+                                         }
+                                     });
+                               })
+                        .then([&ret] { return std::move(ret); });
+                  });
+            },
+            allocation{},
+            [](allocation acc, allocation a) {
+                acc.ids.insert(acc.ids.end(), a.ids.begin(), a.ids.end());
+                acc.failures += a.failures;
+                return acc;
+            })
+          .get0();
+    }
+
+    /// Allocates ids one by one from the current shard of the node until the
+    /// first failure
+    allocation allocate_until_failure(model::node_id id, int max) {
+        allocation ret;
+        auto& frontend = get_node_application(id)->id_allocator_frontend;
+        for (int i = 0; i < max; ++i) {
+            auto r = frontend.local().allocate_id(1s).get0();
+            if (r.ec != cluster::errc::success) {
+                ret.failures++;
+                break;
+            }
+            ret.ids.push_back(r.id);
+        }
+        return ret;
+    }
+
+    std::optional<model::node_id> id_allocator_leader(model::node_id id) {
+        return get_node_application(id)
+          ->controller->get_partition_leaders()
+          .local()
+          .get_leader(model::id_allocator_ntp);
+    }
+
+    void transfer_id_allocator_leadership(model::node_id target) {
+        auto deadline = ss::lowres_clock::now() + 10s;
+        while (id_allocator_leader(target) != target) {
+            BOOST_REQUIRE(ss::lowres_clock::now() < deadline);
+            auto leader = id_allocator_leader(target);
+            std::optional<ss::shard_id> shard;
+            if (leader) {
+                shard = get_shard_table(*leader).shard_for(
+                  model::id_allocator_ntp);
+            }
+            if (shard) {
+                get_partition_manager(*leader)
+                  .invoke_on(
+                    *shard,
+                    [target](cluster::partition_manager& pm) {
+                        auto p = pm.get(model::id_allocator_ntp);
+                        if (!p) {
+                            return ss::make_ready_future<std::error_code>(
+                              make_error_code(
+                                cluster::errc::partition_not_exists));
+                        }
+                        return p->transfer_leadership(target);
+                    })
+                  .discard_result()
+                  .get();
+            }
+            ss::sleep(100ms).get();
+        }
+    }
+
+    static void require_unique(std::vector<int64_t> ids) {
+        std::sort(ids.begin(), ids.end());
+        BOOST_REQUIRE(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+    }
+
+private:
+    std::vector<model::node_id> _nodes;
+};
+
+FIXTURE_TEST(
+  test_ids_unique_across_shards_and_refills, id_allocator_frontend_fixture) {
+    start_nodes(1);
+
+    // every shard exhausts several leases with concurrent callers waiting on
+    // the same refill
+    auto first = allocate_ids(model::node_id(0), 5 * lease_size);
+    BOOST_REQUIRE_EQUAL(first.failures, 0);
+    BOOST_REQUIRE_EQUAL(first.ids.size(), 5 * lease_size * ss::smp::count);
+
+    auto second = allocate_ids(model::node_id(0), 3 * lease_size);
+    BOOST_REQUIRE_EQUAL(second.failures, 0);
+
+    auto ids = first.ids;
+    ids.insert(ids.end(), second.ids.begin(), second.ids.end());
+    require_unique(std::move(ids));
+}
+
+FIXTURE_TEST(test_ids_unique_without_lease, id_allocator_frontend_fixture) {
+    set_configuration("id_allocator_shard_lease_size", int16_t(1));
+    start_nodes(1);
+
+    auto r = allocate_ids(model::node_id(0), 20);
+    BOOST_REQUIRE_EQUAL(r.failures, 0);
+    BOOST_REQUIRE_EQUAL(r.ids.size(), 20 * ss::smp::count);
+    require_unique(std::move(r.ids));
+}
+
+FIXTURE_TEST(
+  test_ids_unique_across_leader_change, id_allocator_frontend_fixture) {
+    set_configuration("id_allocator_replication", int16_t(3));
+    start_nodes(3);
+
+    std::vector<int64_t> ids;
+    auto allocate_from_all_nodes = [this, &ids] {
+        for (auto id : boost::irange(0, 3)) {
+            auto r = allocate_ids(model::node_id(id), 2 * lease_size);
+            BOOST_REQUIRE_EQUAL(r.failures, 0);
+            ids.insert(ids.end(), r.ids.begin(), r.ids.end());
+        }
+    };
+
+    allocate_from_all_nodes();
+    auto leader = id_allocator_leader(model::node_id(0));
+    BOOST_REQUIRE(leader.has_value());
+
+    // the leases refilled after the leader change come from the new leader
+    for (auto id : boost::irange(0, 3)) {
+        if (model::node_id(id) == *leader) {
+            continue;
+        }
+        transfer_id_allocator_leadership(model::node_id(id));
+        allocate_from_all_nodes();
+    }
+
+    require_unique(std::move(ids));
+}
+
+FIXTURE_TEST(
+  test_exhausted_lease_fails_without_leader, id_allocator_frontend_fixture) {
+    set_configuration("id_allocator_replication", int16_t(3));
+    set_configuration("metadata_dissemination_retries", int16_t(3));
+    start_nodes(3);
+
+    auto before = allocate_until_failure(model::node_id(0), lease_size / 2);
+    BOOST_REQUIRE_EQUAL(before.failures, 0);
+
+    // without a quorum the id allocator has no leader, the node keeps
+    // serving the ids it already leased and fails once they are used
+    stop_node(model::node_id(1));
+    stop_node(model::node_id(2));
+
+    auto after = allocate_until_failure(model::node_id(0), 10 * lease_size);
+    BOOST_REQUIRE_EQUAL(after.failures, 1);
+    BOOST_REQUIRE_LE(after.ids.size(), 2 * lease_size);
+
+    auto ids = before.ids;
+    ids.insert(ids.end(), after.ids.begin(), after.ids.end());
+    require_unique(std::move(ids));
+}
@@ -25,6 +25,7 @@
 
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/util/defer.hh>
 #include <seastar/util/log.hh>
@@ -32,7 +33,9 @@
 #include <boost/range/irange.hpp>
 #include <boost/test/tools/old/interface.hpp>
 
+#include <algorithm>
 #include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -102,3 +105,41 @@ FIXTURE_TEST(stm_restart_test, mux_state_machine_fixture) {
     }
     stm2.stop().get0();
 }
+
+FIXTURE_TEST(stm_concurrent_ranges_test, mux_state_machine_fixture) {
+    start_raft();
+
+    config::configuration cfg;
+    cfg.id_allocator_batch_size.set_value(int16_t(5));
+    cfg.id_allocator_log_capacity.set_value(int16_t(2));
+
+    cluster::id_allocator_stm stm(idstmlog, _raft.get(), cfg);
+
+    stm.start().get0();
+    auto stop = ss::defer([&stm] { stm.stop().get0(); });
+
+    wait_for_leader();
+
+    // ranges of several sizes requested concurrently, some of them are
+    // served from the cached range and some need a new one
+    std::vector<int64_t> counts;
+    for (int i = 0; i < 50; i++) {
+        counts.push_back(1 + i % 7);
+    }
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    ss::parallel_for_each(counts, [&stm, &ranges](int64_t count) {
+        return stm
+          .allocate_id_and_wait(model::timeout_clock::now() + 5s, count)
+          .then([&ranges, count](
+                  cluster::id_allocator_stm::stm_allocation_result r) {
+              BOOST_REQUIRE_EQUAL(raft::errc::success, r.raft_status);
+              ranges.emplace_back(r.id, r.id + count);
+          });
+    }).get0();
+
+    BOOST_REQUIRE_EQUAL(ranges.size(), counts.size());
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1; i < ranges.size(); i++) {
+        BOOST_REQUIRE_LE(ranges[i - 1].second, ranges[i].first);
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#define BOOST_TEST_MODULE cluster
+#include "cluster/leader_balancer.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <vector>
+
+using cluster::leader_balancer;
+
+static model::broker_shard bs(int node, uint32_t shard = 0) {
+    return model::broker_shard{.node_id = model::node_id(node), .shard = shard};
+}
+
+/// groups replicated on the first shard of nodes 0, 1 and 2
+static std::vector<leader_balancer::group_replicas>
+make_groups(int count, model::broker_shard leader) {
+    std::vector<leader_balancer::group_replicas> ret;
+    for (int i = 0; i < count; ++i) {
+        ret.push_back(leader_balancer::group_replicas{
+          .group = raft::group_id(i),
+          .ntp = model::ntp(
+            model::ns("kafka"), model::topic("tp"), model::partition_id(i)),
+          .leader = leader,
+          .replicas = {bs(0), bs(1), bs(2)},
+        });
+    }
+    return ret;
+}
+
+static auto never = [](raft::group_id) { return false; };
+static auto always = [](const model::broker_shard&) { return true; };
+
+BOOST_AUTO_TEST_CASE(test_moves_leaders_away_from_loaded_shard) {
+    auto groups = make_groups(6, bs(0));
+    auto plan = leader_balancer::plan_transfers(groups, 10, never, always);
+
+    // 6 leaders on node 0 end up evenly spread across 3 nodes
+    BOOST_REQUIRE_EQUAL(plan.size(), 4);
+    std::array<int, 3> leaders{6, 0, 0};
+    for (const auto& t : plan) {
+        BOOST_REQUIRE_EQUAL(t.from, bs(0));
+        leaders[t.from.node_id()]--;
+        leaders[t.to.node_id()]++;
+    }
+    BOOST_REQUIRE_EQUAL(leaders[0], 2);
+    BOOST_REQUIRE_EQUAL(leaders[1], 2);
+    BOOST_REQUIRE_EQUAL(leaders[2], 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_transfers_are_bounded) {
+    auto groups = make_groups(6, bs(0));
+    auto plan = leader_balancer::plan_transfers(groups, 2, never, always);
+    BOOST_REQUIRE_EQUAL(plan.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_balanced_groups_are_not_moved) {
+    auto groups = make_groups(3, bs(0));
+    groups[1].leader = bs(1);
+    groups[2].leader = bs(2);
+    auto plan = leader_balancer::plan_transfers(groups, 10, never, always);
+    BOOST_REQUIRE(plan.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_muted_groups_and_excluded_targets) {
+    auto groups = make_groups(6, bs(0));
+    auto plan = leader_balancer::plan_transfers(
+      groups,
+      10,
+      [](raft::group_id g) { return g() < 3; },
+      [](const model::broker_shard& s) { return s.node_id() != 2; });
+
+    for (const auto& t : plan) {
+        BOOST_REQUIRE_GE(t.group(), 3);
+        BOOST_REQUIRE_EQUAL(t.to, bs(1));
+    }
+    // 6 leaders split between node 0 and node 1
+    BOOST_REQUIRE_EQUAL(plan.size(), 3);
+}
@@ -0,0 +1,108 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#define BOOST_TEST_MODULE cluster
+#include "cluster/offset_range_index.h"
+#include "model/fundamental.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+struct range {
+    model::offset first;
+    model::offset last;
+};
+
+using index_t = cluster::offset_range_index<range>;
+
+static range make_range(int64_t first, int64_t last) {
+    return range{.first = model::offset(first), .last = model::offset(last)};
+}
+
+static std::vector<range>
+naive_overlapping(const std::vector<range>& ranges, int64_t from, int64_t to) {
+    std::vector<range> ret;
+    for (const auto& r : ranges) {
+        if (r.last() >= from && r.first() <= to) {
+            ret.push_back(r);
+        }
+    }
+    return ret;
+}
+
+static void require_same(std::vector<range> a, std::vector<range> b) {
+    auto cmp = [](const range& l, const range& r) {
+        return std::tie(l.last, l.first) < std::tie(r.last, r.first);
+    };
+    std::sort(a.begin(), a.end(), cmp);
+    std::sort(b.begin(), b.end(), cmp);
+    BOOST_REQUIRE_EQUAL(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(a[i].first, b[i].first);
+        BOOST_REQUIRE_EQUAL(a[i].last, b[i].last);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_overlapping_ranges) {
+    index_t idx;
+    idx.add(make_range(0, 10));
+    idx.add(make_range(5, 6));
+    idx.add(make_range(20, 100));
+    idx.add(make_range(30, 40));
+
+    require_same(
+      idx.overlapping(model::offset(7), model::offset(25)),
+      {make_range(0, 10), make_range(20, 100)});
+    // range that spans the whole query
+    require_same(
+      idx.overlapping(model::offset(50), model::offset(60)),
+      {make_range(20, 100)});
+    require_same(idx.overlapping(model::offset(101), model::offset(200)), {});
+    require_same(
+      idx.overlapping(model::offset(6), model::offset(6)),
+      {make_range(0, 10), make_range(5, 6)});
+}
+
+BOOST_AUTO_TEST_CASE(test_prune) {
+    index_t idx;
+    idx.add(make_range(0, 1000));
+    idx.add(make_range(1001, 1002));
+    idx.add(make_range(1003, 1004));
+    idx.prune(model::offset(1002));
+    BOOST_REQUIRE_EQUAL(idx.size(), 2);
+    require_same(
+      idx.overlapping(model::offset(0), model::offset(2000)),
+      {make_range(1001, 1002), make_range(1003, 1004)});
+}
+
+BOOST_AUTO_TEST_CASE(test_matches_linear_scan) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int64_t> start(0, 10000);
+    std::uniform_int_distribution<int64_t> length(0, 300);
+
+    index_t idx;
+    std::vector<range> ranges;
+    for (int i = 0; i < 1000; ++i) {
+        auto s = start(gen);
+        auto r = make_range(s, s + length(gen));
+        idx.add(r);
+        ranges.push_back(r);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        auto from = start(gen);
+        auto to = from + length(gen);
+        require_same(
+          idx.overlapping(model::offset(from), model::offset(to)),
+          naive_overlapping(ranges, from, to));
+    }
+}
@@ -19,11 +19,15 @@
 #include "random/generators.h"
 
 struct partition_allocator_fixture {
-    void register_node(int id, int core_count) {
+    void register_node(
+      int id,
+      int core_count,
+      std::optional<ss::sstring> rack = std::nullopt) {
         allocator.register_node(std::make_unique<cluster::allocation_node>(
           model::node_id(id),
           core_count,
-          absl::node_hash_map<ss::sstring, ss::sstring>{}));
+          absl::node_hash_map<ss::sstring, ss::sstring>{},
+          std::move(rack)));
     }
 
     void saturate_all_machines() {
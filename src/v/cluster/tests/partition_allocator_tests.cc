@@ -13,9 +13,11 @@
 #include "random/fast_prng.h"
 #include "random/generators.h"
 #include "test_utils/fixture.h"
+#include "units.h"
 
 #include <seastar/core/sharded.hh>
 
+#include <absl/container/node_hash_set.h>
 #include <boost/test/tools/old/interface.hpp>
 
 void validate_replica_set_diversity(
@@ -435,3 +437,54 @@ FIXTURE_TEST(allocator_exception_safety_test, partition_allocator_fixture) {
         BOOST_REQUIRE_EQUAL(capacity, max_capacity());
     }
 }
+
+FIXTURE_TEST(rack_aware_allocation, partition_allocator_fixture) {
+    register_node(0, 4, "rack-a");
+    register_node(1, 4, "rack-a");
+    register_node(2, 4, "rack-b");
+    register_node(3, 4, "rack-b");
+    register_node(4, 4, "rack-c");
+    register_node(5, 4, "rack-c");
+
+    auto units = allocator.allocate(make_allocation_request(30, 3)).value();
+    validate_replica_set_diversity(units.get_assignments());
+    const auto& nodes = allocator.state().allocation_nodes();
+    for (const auto& as : units.get_assignments()) {
+        absl::node_hash_set<ss::sstring> racks;
+        for (const auto& bs : as.replicas) {
+            racks.insert(*nodes.find(bs.node_id)->second->rack());
+        }
+        BOOST_REQUIRE_EQUAL(racks.size(), 3);
+    }
+}
+
+FIXTURE_TEST(load_aware_allocation, partition_allocator_fixture) {
+    register_node(0, 4);
+    register_node(1, 4);
+    register_node(2, 4);
+    register_node(3, 4);
+    // node 0 is almost full and serves most of the traffic
+    allocator.update_node_usage(
+      model::node_id(0),
+      cluster::allocation_node::usage{
+        .disk_used_bytes = 90_GiB,
+        .disk_total_bytes = 100_GiB,
+        .bytes_rate = 100_MiB});
+    for (int i = 1; i < 4; ++i) {
+        allocator.update_node_usage(
+          model::node_id(i),
+          cluster::allocation_node::usage{
+            .disk_used_bytes = 10_GiB,
+            .disk_total_bytes = 100_GiB,
+            .bytes_rate = 1_MiB});
+    }
+
+    auto units = allocator.allocate(make_allocation_request(30, 1)).value();
+    for (const auto& as : units.get_assignments()) {
+        BOOST_REQUIRE_NE(as.replicas.front().node_id, model::node_id(0));
+    }
+
+    // the load is a preference, node 0 is used when every node is needed
+    auto all = allocator.allocate(make_allocation_request(1, 4)).value();
+    BOOST_REQUIRE_EQUAL(all.get_assignments().front().replicas.size(), 4);
+}
@@ -0,0 +1,89 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#define BOOST_TEST_MODULE cluster
+#include "cluster/partition_balancer.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <optional>
+#include <vector>
+
+using cluster::partition_balancer;
+
+static constexpr double max_skew = 0.2;
+
+/// node with the capacity of 100 replicas
+static partition_balancer::node_load node(
+  int id,
+  int partitions,
+  std::optional<double> disk = std::nullopt,
+  std::optional<double> throughput = std::nullopt) {
+    return partition_balancer::node_load{
+      .id = model::node_id(id),
+      .partitions = partitions / 100.0,
+      .partition_unit = 1 / 100.0,
+      .disk = disk,
+      .throughput = throughput,
+    };
+}
+
+BOOST_AUTO_TEST_CASE(balanced_cluster) {
+    BOOST_REQUIRE(!partition_balancer::pick_source({}, max_skew));
+    BOOST_REQUIRE(!partition_balancer::pick_source({node(0, 50)}, max_skew));
+    BOOST_REQUIRE(!partition_balancer::pick_source(
+      {node(0, 50, 0.5, 100), node(1, 45, 0.45, 90), node(2, 48, 0.42, 95)},
+      max_skew));
+}
+
+BOOST_AUTO_TEST_CASE(empty_node_added) {
+    auto source = partition_balancer::pick_source(
+      {node(0, 30), node(1, 31), node(2, 30), node(3, 0)}, max_skew);
+    BOOST_REQUIRE(source);
+    BOOST_REQUIRE_EQUAL(*source, model::node_id(1));
+}
+
+BOOST_AUTO_TEST_CASE(single_replica_difference) {
+    // moving the replica would only swap the nodes
+    BOOST_REQUIRE(
+      !partition_balancer::pick_source({node(0, 1), node(1, 0)}, max_skew));
+    BOOST_REQUIRE(
+      partition_balancer::pick_source({node(0, 2), node(1, 0)}, max_skew));
+}
+
+BOOST_AUTO_TEST_CASE(disk_skew) {
+    auto source = partition_balancer::pick_source(
+      {node(0, 50, 0.3), node(1, 50, 0.9), node(2, 50, 0.4)}, max_skew);
+    BOOST_REQUIRE(source);
+    BOOST_REQUIRE_EQUAL(*source, model::node_id(1));
+}
+
+BOOST_AUTO_TEST_CASE(throughput_skew) {
+    auto source = partition_balancer::pick_source(
+      {node(0, 50, 0.5, 1000), node(1, 50, 0.5, 100), node(2, 50, 0.5, 150)},
+      max_skew);
+    BOOST_REQUIRE(source);
+    BOOST_REQUIRE_EQUAL(*source, model::node_id(0));
+}
+
+BOOST_AUTO_TEST_CASE(highest_skew_wins) {
+    // partitions skew is 0.4, disk skew is 0.75
+    auto source = partition_balancer::pick_source(
+      {node(0, 50, 0.2), node(1, 30, 0.8)}, max_skew);
+    BOOST_REQUIRE(source);
+    BOOST_REQUIRE_EQUAL(*source, model::node_id(1));
+}
+
+BOOST_AUTO_TEST_CASE(unreported_usage_is_ignored) {
+    // the node without the usage is not considered empty
+    BOOST_REQUIRE(!partition_balancer::pick_source(
+      {node(0, 50, 0.8), node(1, 50, 0.7), node(2, 50)}, max_skew));
+}
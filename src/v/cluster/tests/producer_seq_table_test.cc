@@ -0,0 +1,86 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#define BOOST_TEST_MODULE cluster
+#include "cluster/producer_seq_table.h"
+#include "model/record.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+struct entry {
+    model::producer_identity pid;
+    int32_t seq;
+    model::timestamp::type last_write_timestamp;
+};
+
+using table_t = cluster::producer_seq_table<entry>;
+
+static model::producer_identity pid(int64_t id) {
+    return model::producer_identity{.id = id, .epoch = 0};
+}
+
+BOOST_AUTO_TEST_CASE(upsert_replaces_entry) {
+    table_t table;
+    BOOST_REQUIRE(table.empty());
+    BOOST_REQUIRE(table.find(pid(1)) == nullptr);
+
+    table.upsert(entry{pid(1), 5, 100});
+    table.upsert(entry{pid(1), 7, 200});
+    BOOST_REQUIRE_EQUAL(table.size(), 1);
+    BOOST_REQUIRE(table.find(pid(1)) != nullptr);
+    BOOST_REQUIRE_EQUAL(table.find(pid(1))->seq, 7);
+    BOOST_REQUIRE_EQUAL(table.find(pid(1))->last_write_timestamp, 200);
+
+    // the previous write of the producer is no longer in the age index
+    table.expire(150);
+    BOOST_REQUIRE_EQUAL(table.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(expire_drops_older_entries) {
+    table_t table;
+    for (int64_t i = 0; i < 10; ++i) {
+        table.upsert(entry{pid(i), 0, i * 10});
+    }
+    // producers with the same last write
+    table.upsert(entry{pid(10), 0, 50});
+
+    table.expire(50);
+    BOOST_REQUIRE_EQUAL(table.size(), 6);
+    for (int64_t i = 0; i < 5; ++i) {
+        BOOST_REQUIRE(table.find(pid(i)) == nullptr);
+    }
+    BOOST_REQUIRE(table.find(pid(5)) != nullptr);
+    BOOST_REQUIRE(table.find(pid(10)) != nullptr);
+
+    // a write refreshes the age of a producer
+    table.upsert(entry{pid(5), 1, 1000});
+    table.expire(91);
+    BOOST_REQUIRE_EQUAL(table.size(), 1);
+    BOOST_REQUIRE_EQUAL(table.find(pid(5))->seq, 1);
+
+    table.expire(2000);
+    BOOST_REQUIRE(table.empty());
+}
+
+BOOST_AUTO_TEST_CASE(for_each_visits_all_entries) {
+    table_t table;
+    for (int64_t i = 0; i < 100; ++i) {
+        table.upsert(entry{pid(i), int32_t(i), 1000 - i});
+    }
+    std::vector<int64_t> ids;
+    table.for_each([&ids](const entry& e) { ids.push_back(e.pid.id); });
+    std::sort(ids.begin(), ids.end());
+    BOOST_REQUIRE_EQUAL(ids.size(), 100);
+    for (int64_t i = 0; i < 100; ++i) {
+        BOOST_REQUIRE_EQUAL(ids[i], i);
+    }
+}
@@ -50,6 +50,62 @@ SEASTAR_THREAD_TEST_CASE(topic_config_rt_test) {
       model::compaction_strategy::offset, d.properties.compaction_strategy);
     BOOST_CHECK(10h == d.properties.retention_duration.value());
     BOOST_REQUIRE_EQUAL(tristate<size_t>{}, d.properties.retention_bytes);
+    BOOST_REQUIRE(!d.properties.storage_engine);
+}
+
+SEASTAR_THREAD_TEST_CASE(versioned_topic_config_rt_test) {
+    cluster::topic_configuration cfg(
+      model::ns("test"), model::topic{"a_topic"}, 3, 1);
+    cfg.properties.retention_bytes = tristate<size_t>(64_MiB);
+    cfg.properties.storage_engine = model::storage_engine::memory;
+
+    auto d = serialize_roundtrip_rpc(std::move(cfg));
+
+    BOOST_REQUIRE_EQUAL(model::ns("test"), d.tp_ns.ns);
+    BOOST_REQUIRE_EQUAL(model::topic("a_topic"), d.tp_ns.tp);
+    BOOST_REQUIRE_EQUAL(3, d.partition_count);
+    BOOST_REQUIRE_EQUAL(64_MiB, d.properties.retention_bytes.value());
+    BOOST_REQUIRE_EQUAL(
+      model::storage_engine::memory, d.properties.storage_engine);
+}
+
+SEASTAR_THREAD_TEST_CASE(topic_config_flush_policy_rt_test) {
+    cluster::topic_configuration cfg(
+      model::ns("test"), model::topic{"a_topic"}, 3, 1);
+    cfg.properties.flush_ms = 100ms;
+    cfg.properties.flush_bytes = 1_MiB;
+
+    auto d = serialize_roundtrip_rpc(std::move(cfg));
+
+    BOOST_REQUIRE_EQUAL(model::topic("a_topic"), d.tp_ns.tp);
+    BOOST_REQUIRE(!d.properties.storage_engine);
+    BOOST_CHECK(100ms == d.properties.flush_ms.value());
+    BOOST_REQUIRE_EQUAL(1_MiB, d.properties.flush_bytes.value());
+}
+
+SEASTAR_THREAD_TEST_CASE(topic_config_recovery_rt_test) {
+    cluster::topic_configuration cfg(
+      model::ns("test"), model::topic{"a_topic"}, 3, 1);
+    cfg.properties.recovery = true;
+
+    auto d = serialize_roundtrip_rpc(std::move(cfg));
+
+    BOOST_REQUIRE_EQUAL(model::topic("a_topic"), d.tp_ns.tp);
+    BOOST_REQUIRE(!d.properties.flush_ms);
+    BOOST_REQUIRE(d.properties.recovery.value());
+}
+
+SEASTAR_THREAD_TEST_CASE(topic_config_read_replica_rt_test) {
+    cluster::topic_configuration cfg(
+      model::ns("test"), model::topic{"a_topic"}, 3, 1);
+    cfg.properties.read_replica_bucket = "source-bucket";
+
+    auto d = serialize_roundtrip_rpc(std::move(cfg));
+
+    BOOST_REQUIRE_EQUAL(model::topic("a_topic"), d.tp_ns.tp);
+    BOOST_REQUIRE(!d.properties.recovery);
+    BOOST_REQUIRE_EQUAL(
+      d.properties.read_replica_bucket.value(), "source-bucket");
 }
 
 SEASTAR_THREAD_TEST_CASE(broker_metadata_rt_test) {
@@ -191,3 +247,40 @@ SEASTAR_THREAD_TEST_CASE(config_update_req_resp_test) {
     auto reply_res = serialize_roundtrip_rpc(std::move(reply));
     BOOST_REQUIRE_EQUAL(reply_res.success, true);
 }
+
+SEASTAR_THREAD_TEST_CASE(report_health_request_rt_test) {
+    cluster::node_health_report report{
+      .id = model::node_id(3),
+      .disk_total_bytes = 1000,
+      .disk_free_bytes = 400,
+      .bytes_rate = 50,
+    };
+    report.topics.push_back(cluster::topic_health_report{
+      .tp_ns = model::topic_namespace(model::ns("kafka"), model::topic("tp")),
+      .size_bytes = 600,
+      .replicas = 2,
+      .leaders = {cluster::partition_health_report{
+        .id = model::partition_id(1),
+        .under_replicated = true,
+        .size_bytes = 300,
+        .bytes_rate = 50,
+      }},
+    });
+
+    auto res = serialize_roundtrip_rpc(
+      cluster::report_health_request{.report = report});
+    BOOST_REQUIRE_EQUAL(res.report.id, report.id);
+    BOOST_REQUIRE_EQUAL(res.report.disk_total_bytes, 1000);
+    BOOST_REQUIRE_EQUAL(res.report.disk_free_bytes, 400);
+    BOOST_REQUIRE_EQUAL(res.report.bytes_rate, 50);
+    BOOST_REQUIRE_EQUAL(res.report.topics.size(), 1);
+    const auto& t = res.report.topics[0];
+    BOOST_REQUIRE_EQUAL(t.tp_ns, report.topics[0].tp_ns);
+    BOOST_REQUIRE_EQUAL(t.size_bytes, 600);
+    BOOST_REQUIRE_EQUAL(t.replicas, 2);
+    BOOST_REQUIRE_EQUAL(t.leaders.size(), 1);
+    BOOST_REQUIRE_EQUAL(t.leaders[0].id, model::partition_id(1));
+    BOOST_REQUIRE(t.leaders[0].under_replicated);
+    BOOST_REQUIRE_EQUAL(t.leaders[0].size_bytes, 300);
+    BOOST_REQUIRE_EQUAL(t.leaders[0].bytes_rate, 50);
+}
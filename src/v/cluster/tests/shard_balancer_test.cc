@@ -0,0 +1,72 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#define BOOST_TEST_MODULE cluster
+#include "cluster/shard_balancer.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using cluster::shard_balancer;
+
+static constexpr double max_skew = 0.3;
+static constexpr double min_load = 100;
+
+static model::ntp ntp(int p) {
+    return model::ntp(
+      model::ns("kafka"), model::topic("tapioca"), model::partition_id(p));
+}
+
+/// core with partitions of the given loads, partition ids start at `first`
+static shard_balancer::shard_load
+core(ss::shard_id s, int first, std::vector<double> partitions) {
+    shard_balancer::shard_load ret{.shard = s};
+    for (auto load : partitions) {
+        ret.load += load;
+        ret.partitions.emplace_back(ntp(first++), load);
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(balanced_cores) {
+    BOOST_REQUIRE(!shard_balancer::pick_move({}, max_skew, min_load));
+    BOOST_REQUIRE(
+      !shard_balancer::pick_move({core(0, 0, {500})}, max_skew, min_load));
+    BOOST_REQUIRE(!shard_balancer::pick_move(
+      {core(0, 0, {300, 200}), core(1, 2, {400}), core(2, 3, {100, 350})},
+      max_skew,
+      min_load));
+}
+
+BOOST_AUTO_TEST_CASE(idle_node) {
+    // below the minimal load the skew doesn't matter
+    BOOST_REQUIRE(!shard_balancer::pick_move(
+      {core(0, 0, {40, 40}), core(1, 2, {})}, max_skew, min_load));
+}
+
+BOOST_AUTO_TEST_CASE(hot_core) {
+    auto m = shard_balancer::pick_move(
+      {core(0, 0, {100}), core(1, 1, {600, 300, 50}), core(2, 4, {200})},
+      max_skew,
+      min_load);
+    BOOST_REQUIRE(m);
+    BOOST_REQUIRE_EQUAL(m->source, 1);
+    BOOST_REQUIRE_EQUAL(m->target, 0);
+    // the partition closest to half of the difference of 850
+    BOOST_REQUIRE_EQUAL(m->ntp, ntp(2));
+}
+
+BOOST_AUTO_TEST_CASE(single_hot_partition) {
+    // moving the partition would only swap the cores
+    BOOST_REQUIRE(!shard_balancer::pick_move(
+      {core(0, 0, {1000}), core(1, 1, {10})}, max_skew, min_load));
+}
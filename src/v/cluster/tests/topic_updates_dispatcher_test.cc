@@ -12,10 +12,12 @@
 #include "cluster/topic_updates_dispatcher.h"
 #include "model/metadata.h"
 
+#include <seastar/core/memory.hh>
 #include <seastar/testing/thread_test_case.hh>
 
 #include <bits/stdint-uintn.h>
 
+#include <algorithm>
 #include <cstdint>
 using namespace std::chrono_literals;
 
@@ -166,3 +168,61 @@ FIXTURE_TEST(
       current_cluster_capacity(allocator.local().state().allocation_nodes()),
       max_cluster_capacity() - (1 * 3 + 12 * 3 + 8 * 1));
 }
+
+FIXTURE_TEST(
+  test_topic_table_allocated_on_owning_shard,
+  topic_table_updates_dispatcher_fixture) {
+    static constexpr size_t partitions = 1000;
+    static constexpr size_t replication_factor = 3;
+    auto cmd = make_create_topic_cmd(
+      "test_tp_1", partitions, replication_factor);
+    auto expected = cmd.value.assignments;
+    auto tp_ns = make_tp_ns("test_tp_1");
+
+    auto allocated_memory = [this](ss::shard_id shard) {
+        return table
+          .invoke_on(
+            shard,
+            [](cluster::topic_table&) {
+                return ss::memory::stats().allocated_memory();
+            })
+          .get0();
+    };
+
+    std::vector<size_t> before;
+    for (ss::shard_id shard = 0; shard < ss::smp::count; ++shard) {
+        before.push_back(allocated_memory(shard));
+    }
+    auto res = dispatcher.apply_update(serialize_cmd(std::move(cmd)).get0())
+                 .get0();
+    BOOST_REQUIRE_EQUAL(res, cluster::errc::success);
+
+    for (ss::shard_id shard = 0; shard < ss::smp::count; ++shard) {
+        [[maybe_unused]] auto after = allocated_memory(shard);
+        auto md = table
+                    .invoke_on(
+                      shard,
+                      [&tp_ns](cluster::topic_table& t) {
+                          return t.get_topic_metadata(tp_ns);
+                      })
+                    .get0();
+        BOOST_REQUIRE(md.has_value());
+        BOOST_REQUIRE_EQUAL(md->partitions.size(), expected.size());
+        for (auto& p_md : md->partitions) {
+            auto it = std::find_if(
+              expected.begin(), expected.end(), [&p_md](const auto& pas) {
+                  return pas.id == p_md.id;
+              });
+            BOOST_REQUIRE(it != expected.end());
+            BOOST_REQUIRE(it->replicas == p_md.replicas);
+        }
+#ifndef SEASTAR_DEFAULT_ALLOCATOR
+        // every shard allocates its own copy of the replica sets, the tables
+        // of the other shards must not hold the controller shard memory
+        BOOST_REQUIRE_GE(
+          after,
+          before[shard]
+            + partitions * replication_factor * sizeof(model::broker_shard));
+#endif
+    }
+}
@@ -0,0 +1,118 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/partition_manager.h"
+#include "cluster/shard_table.h"
+#include "cluster/tests/cluster_test_fixture.h"
+#include "cluster/tm_stm.h"
+#include "cluster/tx_gateway_frontend.h"
+#include "hashing/jump_consistent_hash.h"
+#include "hashing/xx.h"
+#include "model/namespace.h"
+#include "test_utils/fixture.h"
+
+#include <absl/container/flat_hash_set.h>
+
+using namespace std::chrono_literals; // NOLINT
+
+class tx_coordinator_mapping_fixture : public cluster_test_fixture {
+public:
+    static constexpr int16_t coordinator_partitions = 4;
+
+    tx_coordinator_mapping_fixture() {
+        set_configuration(
+          "transaction_coordinator_partitions", coordinator_partitions);
+    }
+
+    ~tx_coordinator_mapping_fixture() {
+        remove_node_application(node);
+        set_configuration("transaction_coordinator_partitions", int16_t(1));
+    }
+
+    cluster::tx_gateway_frontend& frontend() {
+        return get_node_application(node)->tx_gateway_frontend.local();
+    }
+
+    /// The coordinator partition of a transaction, the same mapping as the
+    /// one of the consumer groups
+    static model::partition_id
+    expected_partition(const kafka::transactional_id& tx_id, size_t count) {
+        incremental_xxhash64 inc;
+        inc.update(tx_id);
+        return model::partition_id(static_cast<model::partition_id::type>(
+          jump_consistent_hash(inc.digest(), count)));
+    }
+
+    bool has_tx(model::partition_id p, const kafka::transactional_id& tx_id) {
+        model::ntp ntp(model::tx_manager_nt.ns, model::tx_manager_nt.tp, p);
+        auto shard = get_shard_table(node).shard_for(ntp);
+        BOOST_REQUIRE(shard.has_value());
+        return get_partition_manager(node)
+          .invoke_on(
+            *shard,
+            [ntp, tx_id](cluster::partition_manager& pm) {
+                auto partition = pm.get(ntp);
+                return partition && partition->tm_stm()
+                       && partition->tm_stm()->get_tx(tx_id).has_value();
+            })
+          .get0();
+    }
+
+    void require_mapped(const kafka::transactional_id& tx_id) {
+        auto expected = expected_partition(tx_id, coordinator_partitions);
+        for (int p = 0; p < coordinator_partitions; ++p) {
+            BOOST_TEST_INFO(tx_id << " in partition " << p);
+            BOOST_REQUIRE_EQUAL(
+              has_tx(model::partition_id(p), tx_id),
+              model::partition_id(p) == expected);
+        }
+    }
+
+    const model::node_id node{0};
+};
+
+FIXTURE_TEST(
+  test_tx_mapped_to_coordinator_partitions, tx_coordinator_mapping_fixture) {
+    create_node_application(node);
+    wait_for_controller_leadership(node).get();
+
+    // the coordinator topic is created by the first lookup
+    auto broker = frontend()
+                    .get_tx_broker(kafka::transactional_id("tx-0"))
+                    .get0();
+    BOOST_REQUIRE(broker == node);
+    auto md = get_local_cache(node).get_topic_metadata(model::tx_manager_nt);
+    BOOST_REQUIRE(md.has_value());
+    BOOST_REQUIRE_EQUAL(md->partitions.size(), coordinator_partitions);
+
+    std::vector<kafka::transactional_id> tx_ids;
+    absl::flat_hash_set<model::partition_id> used;
+    for (int i = 0; i < 32; ++i) {
+        kafka::transactional_id tx_id(ssx::sformat("tx-{}", i));
+        BOOST_REQUIRE(frontend().get_tx_broker(tx_id).get0() == node);
+
+        auto reply = frontend().init_tm_tx(tx_id, 10s, 5s).get0();
+        BOOST_REQUIRE(reply.ec == cluster::tx_errc::none);
+        require_mapped(tx_id);
+
+        used.insert(expected_partition(tx_id, coordinator_partitions));
+        tx_ids.push_back(std::move(tx_id));
+    }
+    // the transactions are spread between the coordinators
+    BOOST_REQUIRE_GT(used.size(), 1);
+
+    // the mapping follows the partitions of the existing topic, a new
+    // configuration doesn't move the transactions
+    set_configuration("transaction_coordinator_partitions", int16_t(16));
+    for (const auto& tx_id : tx_ids) {
+        auto reply = frontend().init_tm_tx(tx_id, 10s, 5s).get0();
+        BOOST_REQUIRE(reply.ec == cluster::tx_errc::none);
+        require_mapped(tx_id);
+    }
+}
@@ -321,9 +321,8 @@ ss::future<> tm_stm::apply(model::record_batch b) {
     vassert(
       b.record_count() == 1,
       "model::record_batch_type::tm_update batch must contain a single record");
-    auto r = b.copy_records();
-    auto& record = *r.begin();
-    auto val_buf = record.release_value();
+    auto record = b.first_record_view();
+    auto val_buf = record.copy_value();
 
     iobuf_parser val_reader(std::move(val_buf));
     auto version = reflection::adl<int8_t>{}.from(val_reader);
@@ -334,7 +333,7 @@ ss::future<> tm_stm::apply(model::record_batch b) {
       tm_transaction::version);
     auto tx = reflection::adl<tm_transaction>{}.from(val_reader);
 
-    auto key_buf = record.release_key();
+    auto key_buf = record.copy_key();
     iobuf_parser key_reader(std::move(key_buf));
     auto batch_type = reflection::adl<model::record_batch_type>{}.from(
       key_reader);
@@ -102,6 +102,8 @@ public:
 
     explicit tm_stm(ss::logger&, raft::consensus*);
 
+    const model::ntp& ntp() const { return _c->ntp(); }
+
     std::optional<tm_transaction> get_tx(kafka::transactional_id);
     checked<tm_transaction, tm_stm::op_status>
       mark_tx_ongoing(kafka::transactional_id);
@@ -14,6 +14,7 @@
 #include "cluster/types.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
+#include "model/ntp_interner.h"
 
 #include <seastar/core/coroutine.hh>
 
@@ -49,6 +50,8 @@ topic_table::apply(create_topic_cmd cmd, model::offset offset) {
           std::move(ntp), pas, offset, delta::op_type::add);
     }
 
+    // the topic keeps its id until it is deleted
+    model::ntp_interner::local().intern(cmd.key);
     _topics.insert(
       {cmd.key,
        topic_metadata{
@@ -66,6 +69,15 @@ ss::future<> topic_table::stop() {
     return ss::now();
 }
 
+topic_table::~topic_table() noexcept {
+    auto& interner = model::ntp_interner::local();
+    for (const auto& [tp_ns, _] : _topics) {
+        if (auto id = interner.find(tp_ns); id) {
+            interner.release(*id);
+        }
+    }
+}
+
 ss::future<std::error_code>
 topic_table::apply(delete_topic_cmd cmd, model::offset offset) {
     if (auto tp = _topics.find(cmd.value); tp != _topics.end()) {
@@ -74,6 +86,9 @@ topic_table::apply(delete_topic_cmd cmd, model::offset offset) {
             _pending_deltas.emplace_back(
               std::move(ntp), std::move(p), offset, delta::op_type::del);
         }
+        if (auto id = model::ntp_interner::local().find(tp->first); id) {
+            model::ntp_interner::local().release(*id);
+        }
         _topics.erase(tp);
         notify_waiters();
         return ss::make_ready_future<std::error_code>(errc::success);
@@ -238,13 +253,31 @@ topic_table::apply(update_topic_properties_cmd cmd, model::offset o) {
 }
 
 void topic_table::notify_waiters() {
+    // notifications are delivered every delta once, as soon as it is applied,
+    // even if nobody waits for the changes
+    if (_pending_deltas.size() > _notified_deltas) {
+        if (_notified_deltas == 0) {
+            for (auto& cb : _notifications) {
+                cb.second(_pending_deltas);
+            }
+        } else {
+            std::vector<delta> fresh(
+              std::next(_pending_deltas.begin(), _notified_deltas),
+              _pending_deltas.end());
+            for (auto& cb : _notifications) {
+                cb.second(fresh);
+            }
+        }
+        _notified_deltas = _pending_deltas.size();
+    }
     if (_waiters.empty()) {
         return;
     }
     std::vector<delta> changes;
     changes.swap(_pending_deltas);
-    for (auto& cb : _notifications) {
-        cb.second(changes);
+    _notified_deltas = 0;
+    if (!changes.empty()) {
+        _last_delivered_delta = changes.back().offset;
     }
     std::vector<std::unique_ptr<waiter>> active_waiters;
     active_waiters.swap(_waiters);
@@ -259,6 +292,8 @@ topic_table::wait_for_changes(ss::abort_source& as) {
     if (!_pending_deltas.empty()) {
         ret_t ret;
         ret.swap(_pending_deltas);
+        _notified_deltas = 0;
+        _last_delivered_delta = ret.back().offset;
         return ss::make_ready_future<ret_t>(std::move(ret));
     }
     auto w = std::make_unique<waiter>(_waiter_id++);
@@ -85,6 +85,8 @@ public:
     ss::future<std::error_code>
       apply(update_topic_properties_cmd, model::offset);
     ss::future<> stop();
+    /// releases the ids of the topics, see model::ntp_interner
+    ~topic_table() noexcept;
 
     /// Delta API
 
@@ -92,6 +94,19 @@ public:
 
     bool has_pending_changes() const { return !_pending_deltas.empty(); }
 
+    /// Offset of the first delta not passed to the waiters yet
+    std::optional<model::offset> first_pending_delta_offset() const {
+        if (_pending_deltas.empty()) {
+            return std::nullopt;
+        }
+        return _pending_deltas.front().offset;
+    }
+
+    /// Offset of the last delta passed to the waiters
+    model::offset last_delivered_delta_offset() const {
+        return _last_delivered_delta;
+    }
+
     /// Query API
 
     /// Returns list of all topics that exists in the cluster.
@@ -133,6 +148,14 @@ public:
 
     const underlying_t& topics_map() const { return _topics; }
 
+    /// Returns true if the replicas of the partition are being moved
+    bool is_update_in_progress(const model::ntp& ntp) const {
+        return _update_in_progress.contains(ntp);
+    }
+
+    /// Number of partitions which replicas are being moved
+    size_t updates_in_progress() const { return _update_in_progress.size(); }
+
 private:
     struct waiter {
         explicit waiter(uint64_t id)
@@ -154,6 +177,9 @@ private:
     absl::flat_hash_set<model::ntp> _update_in_progress;
 
     std::vector<delta> _pending_deltas;
+    // number of the pending deltas already passed to the notifications
+    size_t _notified_deltas{0};
+    model::offset _last_delivered_delta;
     std::vector<std::unique_ptr<waiter>> _waiters;
     cluster::notification_id_type _notification_id{0};
     std::vector<std::pair<cluster::notification_id_type, delta_cb_t>>
@@ -13,6 +13,10 @@
 #include "model/metadata.h"
 #include "raft/types.h"
 
+#include <seastar/core/coroutine.hh>
+
+#include <absl/container/node_hash_map.h>
+
 #include <iterator>
 #include <system_error>
 #include <vector>
@@ -35,13 +39,26 @@ topic_updates_dispatcher::apply_update(model::record_batch b) {
                 // delete case - we need state copy to
                 auto tp_md = _topic_table.local().get_topic_metadata(
                   del_cmd.value);
+                std::optional<snapshot_topic> snap;
+                const auto& topics = _topic_table.local().topics_map();
+                if (auto it = topics.find(del_cmd.value); it != topics.end()) {
+                    snap = make_snapshot_topic(it->first, it->second);
+                }
                 return dispatch_updates_to_cores(del_cmd, base_offset)
-                  .then([this, tp_md](std::error_code ec) {
+                  .then([this, tp_md, snap = std::move(snap), base_offset](
+                          std::error_code ec) mutable {
                       if (ec == errc::success) {
                           vassert(
-                            tp_md.has_value(),
+                            tp_md.has_value() && snap.has_value(),
                             "Topic had to exist before successful delete");
                           deallocate_topic(*tp_md);
+                          absl::erase_if(
+                            _moved_partitions, [&tp_md](const auto& p) {
+                                return p.first.ns == tp_md->tp_ns.ns
+                                       && p.first.tp.topic == tp_md->tp_ns.tp;
+                            });
+                          _deleted_topics.push_back(deleted_topic{
+                            .topic = std::move(*snap), .deleted = base_offset});
                       }
                       return ec;
                   });
@@ -59,7 +76,7 @@ topic_updates_dispatcher::apply_update(model::record_batch b) {
                 auto tp_md = _topic_table.local().get_topic_metadata(
                   model::topic_namespace_view(cmd.key));
                 return dispatch_updates_to_cores(cmd, base_offset)
-                  .then([this, tp_md, cmd](std::error_code ec) {
+                  .then([this, tp_md, cmd, base_offset](std::error_code ec) {
                       if (!ec) {
                           vassert(
                             tp_md.has_value(),
@@ -77,12 +94,31 @@ topic_updates_dispatcher::apply_update(model::record_batch b) {
                             "Reassigned partition must exist");
 
                           reallocate_partition(it->replicas, cmd.value);
+
+                          auto& history = _moved_partitions[cmd.key];
+                          if (history.moves.empty()) {
+                              history.initial_replicas = it->replicas;
+                          }
+                          history.moves.push_back(partition_move{
+                            .offset = base_offset,
+                            .finished = false,
+                            .replicas = cmd.value});
                       }
                       return ec;
                   });
             },
             [this, base_offset](finish_moving_partition_replicas_cmd cmd) {
-                return dispatch_updates_to_cores(std::move(cmd), base_offset);
+                return dispatch_updates_to_cores(cmd, base_offset)
+                  .then([this, cmd, base_offset](std::error_code ec) {
+                      auto it = _moved_partitions.find(cmd.key);
+                      if (!ec && it != _moved_partitions.end()) {
+                          it->second.moves.push_back(partition_move{
+                            .offset = base_offset,
+                            .finished = true,
+                            .replicas = cmd.value});
+                      }
+                      return ec;
+                  });
             },
             [this, base_offset](update_topic_properties_cmd cmd) {
                 return dispatch_updates_to_cores(std::move(cmd), base_offset);
@@ -93,13 +129,17 @@ topic_updates_dispatcher::apply_update(model::record_batch b) {
 template<typename Cmd>
 ss::future<std::error_code> do_apply(
   ss::shard_id shard,
-  Cmd cmd,
+  const Cmd& cmd,
   ss::sharded<topic_table>& table,
   model::offset o) {
-    return table.invoke_on(
-      shard, [cmd = std::move(cmd), o](topic_table& local_table) mutable {
-          return local_table.apply(std::move(cmd), o);
-      });
+    return table.invoke_on(shard, [&cmd, o](topic_table& local_table) {
+        // the command is copied on the destination shard, the topic table
+        // keeps it for the whole lifetime of the topic and it must be
+        // allocated from the memory of the shard that owns the table.
+        // Moving a copy made here would make the tables of all the shards
+        // hold the memory of the controller shard.
+        return local_table.apply(Cmd(cmd), o);
+    });
 }
 
 template<typename Cmd>
@@ -107,11 +147,11 @@ ss::future<std::error_code>
 topic_updates_dispatcher::dispatch_updates_to_cores(Cmd cmd, model::offset o) {
     using ret_t = std::vector<std::error_code>;
     return ss::do_with(
-      ret_t{}, [this, cmd = std::move(cmd), o](ret_t& ret) mutable {
+      ret_t{}, std::move(cmd), [this, o](ret_t& ret, const Cmd& cmd) {
           ret.reserve(ss::smp::count);
           return ss::parallel_for_each(
                    boost::irange(0, (int)ss::smp::count),
-                   [this, &ret, cmd = std::move(cmd), o](int shard) mutable {
+                   [this, &ret, &cmd, o](int shard) {
                        return do_apply(shard, cmd, _topic_table, o)
                          .then([&ret](std::error_code r) { ret.push_back(r); });
                    })
@@ -161,4 +201,85 @@ void topic_updates_dispatcher::update_allocations(const create_topic_cmd& cmd) {
       std::move(shards), max_group_id);
 }
 
+topic_updates_dispatcher::snapshot_topic
+topic_updates_dispatcher::make_snapshot_topic(
+  const model::topic_namespace& tp_ns,
+  const topic_table::topic_metadata& md) const {
+    topic_configuration_assignment cfg(
+      md.configuration.cfg, md.configuration.assignments);
+    std::vector<std::pair<model::ntp, partition_move>> moves;
+    for (auto& p_as : cfg.assignments) {
+        auto it = _moved_partitions.find(
+          model::ntp(tp_ns.ns, tp_ns.tp, p_as.id));
+        if (it == _moved_partitions.end()) {
+            continue;
+        }
+        p_as.replicas = it->second.initial_replicas;
+        for (const auto& m : it->second.moves) {
+            moves.emplace_back(it->first, m);
+        }
+    }
+    return snapshot_topic{
+      .created = model::offset(md.revision()),
+      .create = create_topic_cmd(tp_ns, std::move(cfg)),
+      .moves = std::move(moves)};
+}
+
+ss::future<std::vector<model::record_batch>>
+topic_updates_dispatcher::snapshot_commands() const {
+    // the commands are built before they are serialized, the table must not
+    // be iterated across scheduling points
+    std::vector<snapshot_topic> topics;
+    std::vector<std::pair<model::offset, delete_topic_cmd>> deletes;
+    topics.reserve(
+      _topic_table.local().topics_map().size() + _deleted_topics.size());
+    deletes.reserve(_deleted_topics.size());
+    for (const auto& [tp_ns, md] : _topic_table.local().topics_map()) {
+        topics.push_back(make_snapshot_topic(tp_ns, md));
+    }
+    for (const auto& d : _deleted_topics) {
+        topics.push_back(d.topic);
+        const auto& tp_ns = d.topic.create.key;
+        deletes.emplace_back(d.deleted, delete_topic_cmd(tp_ns, tp_ns));
+    }
+
+    std::vector<model::record_batch> ret;
+    ret.reserve(topics.size() + deletes.size());
+    for (auto& t : topics) {
+        ret.push_back(co_await serialize_cmd(std::move(t.create), t.created));
+        for (auto& [ntp, m] : t.moves) {
+            if (m.finished) {
+                ret.push_back(co_await serialize_cmd(
+                  finish_moving_partition_replicas_cmd(
+                    std::move(ntp), std::move(m.replicas)),
+                  m.offset));
+            } else {
+                ret.push_back(co_await serialize_cmd(
+                  move_partition_replicas_cmd(
+                    std::move(ntp), std::move(m.replicas)),
+                  m.offset));
+            }
+        }
+    }
+    for (auto& [offset, cmd] : deletes) {
+        ret.push_back(co_await serialize_cmd(std::move(cmd), offset));
+    }
+    co_return ret;
+}
+
+void topic_updates_dispatcher::forget_deleted_topics(
+  model::offset reconciled) {
+    std::erase_if(_deleted_topics, [reconciled](const deleted_topic& d) {
+        return d.deleted <= reconciled;
+    });
+}
+
+raft::group_id topic_updates_dispatcher::highest_group() const {
+    return _partition_allocator.local().state().last_group_id();
+}
+
+void topic_updates_dispatcher::restore_highest_group(raft::group_id group) {
+    _partition_allocator.local().state().update_highest_group(group);
+}
+
 } // namespace cluster
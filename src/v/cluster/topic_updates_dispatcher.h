@@ -17,6 +17,10 @@
 
 #include <seastar/core/sharded.hh>
 
+#include <absl/container/node_hash_map.h>
+
+#include <vector>
+
 namespace cluster {
 
 // The topic updates dispatcher is resposible for receiving update_apply upcalls
@@ -65,7 +69,50 @@ public:
                == model::record_batch_type::topic_management_cmd;
     }
 
+    /**
+     * Returns the commands that rebuild the current topics state when applied
+     * in order of their offsets. Topics are created with their initial
+     * assignments at their revision and the moves of their partitions follow,
+     * this way the partition deltas, and the revisions the controller backend
+     * creates local partitions with, are the same as the ones of the full log.
+     * The topics which deletion may not be reconciled yet are created, moved
+     * and deleted again, so that the backend removes their partitions.
+     */
+    ss::future<std::vector<model::record_batch>> snapshot_commands() const;
+
+    /// Drops the deleted topics which deletion was reconciled on every shard,
+    /// i.e. deleted at or before the given offset
+    void forget_deleted_topics(model::offset reconciled);
+
+    /// The topics forgotten once deleted don't restore the raft groups they
+    /// were allocated, the highest group is snapshotted on its own
+    raft::group_id highest_group() const;
+    void restore_highest_group(raft::group_id);
+
 private:
+    struct partition_move {
+        model::offset offset;
+        // finish_moving_partition_replicas_cmd
+        bool finished;
+        std::vector<model::broker_shard> replicas;
+    };
+    struct partition_moves {
+        std::vector<model::broker_shard> initial_replicas;
+        std::vector<partition_move> moves;
+    };
+    struct snapshot_topic {
+        model::offset created;
+        create_topic_cmd create;
+        std::vector<std::pair<model::ntp, partition_move>> moves;
+    };
+    struct deleted_topic {
+        snapshot_topic topic;
+        model::offset deleted;
+    };
+
+    snapshot_topic make_snapshot_topic(
+      const model::topic_namespace&, const topic_table::topic_metadata&) const;
+
     template<typename Cmd>
     ss::future<std::error_code> dispatch_updates_to_cores(Cmd, model::offset);
 
@@ -77,6 +124,11 @@ private:
 
     ss::sharded<partition_allocator>& _partition_allocator;
     ss::sharded<topic_table>& _topic_table;
+    // the topic table only keeps the current assignments, the history of the
+    // partitions that were moved is needed to snapshot them
+    absl::node_hash_map<model::ntp, partition_moves> _moved_partitions;
+    // deleted topics, in order of deletion, until their deletion is reconciled
+    std::vector<deleted_topic> _deleted_topics;
 };
 
 } // namespace cluster
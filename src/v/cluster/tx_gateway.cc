@@ -73,6 +73,20 @@ tx_gateway::abort_tx(abort_tx_request&& request, rpc::streaming_context&) {
       request.ntp, request.pid, request.tx_seq, request.timeout);
 }
 
+ss::future<write_tx_markers_reply> tx_gateway::write_tx_markers(
+  write_tx_markers_request&& request, rpc::streaming_context&) {
+    return _rm_partition_frontend.local()
+      .do_write_tx_markers(
+        std::move(request.ntps),
+        request.pid,
+        request.tx_seq,
+        request.commit,
+        request.timeout)
+      .then([](std::vector<tx_errc> ecs) {
+          return write_tx_markers_reply{.ecs = std::move(ecs)};
+      });
+}
+
 ss::future<begin_group_tx_reply> tx_gateway::begin_group_tx(
   begin_group_tx_request&& request, rpc::streaming_context&) {
     return _rm_group_proxy->begin_group_tx_locally(std::move(request));
@@ -16,6 +16,8 @@
 #include "cluster/rm_partition_frontend.h"
 #include "cluster/shard_table.h"
 #include "errc.h"
+#include "hashing/jump_consistent_hash.h"
+#include "hashing/xx.h"
 #include "types.h"
 
 #include <seastar/core/coroutine.hh>
@@ -34,6 +36,15 @@ static ss::future<bool> sleep_abortable(std::chrono::milliseconds dur) {
     }
 }
 
+static std::vector<model::ntp> partitions_of(const tm_transaction& tx) {
+    std::vector<model::ntp> ntps;
+    ntps.reserve(tx.partitions.size());
+    for (const auto& rm : tx.partitions) {
+        ntps.push_back(rm.ntp);
+    }
+    return ntps;
+}
+
 static add_paritions_tx_reply make_add_partitions_error_response(
   add_paritions_tx_request request, tx_errc ec) {
     add_paritions_tx_reply response;
@@ -82,31 +93,51 @@ tx_gateway_frontend::tx_gateway_frontend(
 
 ss::future<> tx_gateway_frontend::stop() { return _gate.close(); }
 
-ss::future<std::optional<model::node_id>> tx_gateway_frontend::get_tx_broker() {
+model::ntp tx_gateway_frontend::tx_ntp(model::partition_id tm) {
+    return model::ntp(model::tx_manager_nt.ns, model::tx_manager_nt.tp, tm);
+}
+
+std::optional<model::ntp>
+tx_gateway_frontend::ntp_for_tx_id(const kafka::transactional_id& tx_id) {
+    // the mapping depends on the number of partitions the topic was created
+    // with, changing the configuration afterwards doesn't move the
+    // transactions between the coordinators
+    auto md = _metadata_cache.local().get_topic_metadata(model::tx_manager_nt);
+    if (!md || md->partitions.empty()) {
+        return std::nullopt;
+    }
+    incremental_xxhash64 inc;
+    inc.update(tx_id);
+    auto p = static_cast<model::partition_id::type>(
+      jump_consistent_hash(inc.digest(), md->partitions.size()));
+    return tx_ntp(model::partition_id(p));
+}
+
+ss::future<std::optional<model::node_id>>
+tx_gateway_frontend::get_tx_broker(kafka::transactional_id tx_id) {
     auto has_topic = ss::make_ready_future<bool>(true);
 
     if (!_metadata_cache.local().contains(
-          model::tx_manager_nt, model::tx_manager_ntp.tp.partition)) {
+          model::tx_manager_nt, model::partition_id(0))) {
         has_topic = try_create_tx_topic();
     }
 
     auto timeout = ss::lowres_clock::now()
                    + config::shard_local_cfg().wait_for_leader_timeout_ms();
 
-    return has_topic.then([this, timeout](bool does_topic_exist) {
+    return has_topic.then([this, tx_id, timeout](bool does_topic_exist) {
         if (!does_topic_exist) {
             return ss::make_ready_future<std::optional<model::node_id>>(
               std::nullopt);
         }
 
-        auto md = _metadata_cache.local().get_topic_metadata(
-          model::tx_manager_nt);
-        if (!md) {
+        auto tm_ntp = ntp_for_tx_id(tx_id);
+        if (!tm_ntp) {
             return ss::make_ready_future<std::optional<model::node_id>>(
               std::nullopt);
         }
         return _metadata_cache.local()
-          .get_leader(model::tx_manager_ntp, timeout)
+          .get_leader(*tm_ntp, timeout)
           .then([](model::node_id leader) {
               return std::optional<model::node_id>(leader);
           })
@@ -126,26 +157,28 @@ ss::future<try_abort_reply> tx_gateway_frontend::try_abort(
   model::producer_identity pid,
   model::tx_seq tx_seq,
   model::timeout_clock::duration timeout) {
-    if (!_metadata_cache.local().contains(
-          model::tx_manager_nt, model::tx_manager_ntp.tp.partition)) {
+    if (!_metadata_cache.local().contains(model::tx_manager_nt, tm)) {
         vlog(
-          clusterlog.warn, "can't find {}/0 partition", model::tx_manager_nt);
+          clusterlog.warn,
+          "can't find {}/{} partition",
+          model::tx_manager_nt,
+          tm);
         co_return try_abort_reply{.ec = tx_errc::partition_not_exists};
     }
 
-    auto leader_opt = _leaders.local().get_leader(model::tx_manager_ntp);
+    auto tm_ntp = tx_ntp(tm);
+    auto leader_opt = _leaders.local().get_leader(tm_ntp);
 
     auto retries = _metadata_dissemination_retries;
     auto delay_ms = _metadata_dissemination_retry_delay_ms;
     auto aborted = false;
     while (!aborted && !leader_opt && 0 < retries--) {
         aborted = !co_await sleep_abortable(delay_ms);
-        leader_opt = _leaders.local().get_leader(model::tx_manager_ntp);
+        leader_opt = _leaders.local().get_leader(tm_ntp);
     }
 
     if (!leader_opt) {
-        vlog(
-          clusterlog.warn, "can't find a leader for {}", model::tx_manager_ntp);
+        vlog(clusterlog.warn, "can't find a leader for {}", tm_ntp);
         co_return try_abort_reply{.ec = tx_errc::leader_not_found};
     }
 
@@ -167,19 +200,19 @@ ss::future<try_abort_reply> tx_gateway_frontend::try_abort_locally(
   model::producer_identity pid,
   model::tx_seq tx_seq,
   model::timeout_clock::duration timeout) {
-    auto shard = _shard_table.local().shard_for(model::tx_manager_ntp);
+    auto tm_ntp = tx_ntp(tm);
+    auto shard = _shard_table.local().shard_for(tm_ntp);
 
     auto retries = _metadata_dissemination_retries;
     auto delay_ms = _metadata_dissemination_retry_delay_ms;
     auto aborted = false;
     while (!aborted && !shard && 0 < retries--) {
         aborted = !co_await sleep_abortable(delay_ms);
-        shard = _shard_table.local().shard_for(model::tx_manager_ntp);
+        shard = _shard_table.local().shard_for(tm_ntp);
     }
 
     if (!shard) {
-        vlog(
-          clusterlog.warn, "can't find a shard for {}", model::tx_manager_ntp);
+        vlog(clusterlog.warn, "can't find a shard for {}", tm_ntp);
         co_return try_abort_reply{.ec = tx_errc::shard_not_found};
     }
 
@@ -220,19 +253,17 @@ ss::future<try_abort_reply> tx_gateway_frontend::dispatch_try_abort(
 
 ss::future<try_abort_reply> tx_gateway_frontend::do_try_abort(
   ss::shard_id shard,
-  model::partition_id,
+  model::partition_id tm,
   model::producer_identity pid,
   model::tx_seq tx_seq,
   model::timeout_clock::duration timeout) {
     return container().invoke_on(
-      shard, _ssg, [pid, tx_seq, timeout](tx_gateway_frontend& self) {
-          auto partition = self._partition_manager.local().get(
-            model::tx_manager_ntp);
+      shard,
+      _ssg,
+      [tm_ntp = tx_ntp(tm), pid, tx_seq, timeout](tx_gateway_frontend& self) {
+          auto partition = self._partition_manager.local().get(tm_ntp);
           if (!partition) {
-              vlog(
-                clusterlog.warn,
-                "can't get partition by {} ntp",
-                model::tx_manager_ntp);
+              vlog(clusterlog.warn, "can't get partition by {} ntp", tm_ntp);
               return ss::make_ready_future<try_abort_reply>(
                 try_abort_reply{.ec = tx_errc::partition_not_found});
           }
@@ -243,7 +274,7 @@ ss::future<try_abort_reply> tx_gateway_frontend::do_try_abort(
               vlog(
                 clusterlog.warn,
                 "can't get tm stm of the {}' partition",
-                model::tx_manager_ntp);
+                tm_ntp);
               return ss::make_ready_future<try_abort_reply>(
                 try_abort_reply{.ec = tx_errc::stm_not_found});
           }
@@ -354,27 +385,26 @@ ss::future<cluster::init_tm_tx_reply> tx_gateway_frontend::init_tm_tx(
   kafka::transactional_id tx_id,
   std::chrono::milliseconds transaction_timeout_ms,
   model::timeout_clock::duration timeout) {
-    if (!_metadata_cache.local().contains(
-          model::tx_manager_nt, model::tx_manager_ntp.tp.partition)) {
-        vlog(
-          clusterlog.warn, "can't find {}/0 partition", model::tx_manager_nt);
+    auto tm_ntp_opt = ntp_for_tx_id(tx_id);
+    if (!tm_ntp_opt) {
+        vlog(clusterlog.warn, "can't find {} partitions", model::tx_manager_nt);
         co_return cluster::init_tm_tx_reply{
           .ec = tx_errc::partition_not_exists};
     }
+    auto tm_ntp = *tm_ntp_opt;
 
-    auto leader_opt = _leaders.local().get_leader(model::tx_manager_ntp);
+    auto leader_opt = _leaders.local().get_leader(tm_ntp);
 
     auto retries = _metadata_dissemination_retries;
     auto delay_ms = _metadata_dissemination_retry_delay_ms;
     auto aborted = false;
     while (!aborted && !leader_opt && 0 < retries--) {
         aborted = !co_await sleep_abortable(delay_ms);
-        leader_opt = _leaders.local().get_leader(model::tx_manager_ntp);
+        leader_opt = _leaders.local().get_leader(tm_ntp);
     }
 
     if (!leader_opt) {
-        vlog(
-          clusterlog.warn, "can't find a leader for {}", model::tx_manager_ntp);
+        vlog(clusterlog.warn, "can't find a leader for {}", tm_ntp);
         co_return cluster::init_tm_tx_reply{.ec = tx_errc::leader_not_found};
     }
 
@@ -397,24 +427,31 @@ ss::future<cluster::init_tm_tx_reply> tx_gateway_frontend::init_tm_tx_locally(
   kafka::transactional_id tx_id,
   std::chrono::milliseconds transaction_timeout_ms,
   model::timeout_clock::duration timeout) {
-    auto shard = _shard_table.local().shard_for(model::tx_manager_ntp);
+    auto tm_ntp_opt = ntp_for_tx_id(tx_id);
+    if (!tm_ntp_opt) {
+        vlog(clusterlog.warn, "can't find {} partitions", model::tx_manager_nt);
+        co_return cluster::init_tm_tx_reply{
+          .ec = tx_errc::partition_not_exists};
+    }
+    auto tm_ntp = *tm_ntp_opt;
+
+    auto shard = _shard_table.local().shard_for(tm_ntp);
 
     auto retries = _metadata_dissemination_retries;
     auto delay_ms = _metadata_dissemination_retry_delay_ms;
     auto aborted = false;
     while (!aborted && !shard && 0 < retries--) {
         aborted = !co_await sleep_abortable(delay_ms);
-        shard = _shard_table.local().shard_for(model::tx_manager_ntp);
+        shard = _shard_table.local().shard_for(tm_ntp);
     }
 
     if (!shard) {
-        vlog(
-          clusterlog.warn, "can't find a shard for {}", model::tx_manager_ntp);
+        vlog(clusterlog.warn, "can't find a shard for {}", tm_ntp);
         co_return cluster::init_tm_tx_reply{.ec = tx_errc::shard_not_found};
     }
 
     co_return co_await do_init_tm_tx(
-      *shard, tx_id, transaction_timeout_ms, timeout);
+      *shard, tm_ntp, tx_id, transaction_timeout_ms, timeout);
 }
 
 ss::future<init_tm_tx_reply> tx_gateway_frontend::dispatch_init_tm_tx(
@@ -453,20 +490,18 @@ ss::future<init_tm_tx_reply> tx_gateway_frontend::dispatch_init_tm_tx(
 
 ss::future<init_tm_tx_reply> tx_gateway_frontend::do_init_tm_tx(
   ss::shard_id shard,
+  model::ntp tm_ntp,
   kafka::transactional_id tx_id,
   std::chrono::milliseconds transaction_timeout_ms,
   model::timeout_clock::duration timeout) {
     return container().invoke_on(
       shard,
       _ssg,
-      [tx_id, transaction_timeout_ms, timeout](tx_gateway_frontend& self) {
-          auto partition = self._partition_manager.local().get(
-            model::tx_manager_ntp);
+      [tm_ntp, tx_id, transaction_timeout_ms, timeout](
+        tx_gateway_frontend& self) {
+          auto partition = self._partition_manager.local().get(tm_ntp);
           if (!partition) {
-              vlog(
-                clusterlog.warn,
-                "can't get partition by {} ntp",
-                model::tx_manager_ntp);
+              vlog(clusterlog.warn, "can't get partition by {} ntp", tm_ntp);
               return ss::make_ready_future<init_tm_tx_reply>(
                 init_tm_tx_reply{.ec = tx_errc::partition_not_found});
           }
@@ -477,7 +512,7 @@ ss::future<init_tm_tx_reply> tx_gateway_frontend::do_init_tm_tx(
               vlog(
                 clusterlog.warn,
                 "can't get tm stm of the {}' partition",
-                model::tx_manager_ntp);
+                tm_ntp);
               return ss::make_ready_future<init_tm_tx_reply>(
                 init_tm_tx_reply{.ec = tx_errc::stm_not_found});
           }
@@ -586,25 +621,29 @@ ss::future<cluster::init_tm_tx_reply> tx_gateway_frontend::do_init_tm_tx(
 
 ss::future<add_paritions_tx_reply> tx_gateway_frontend::add_partition_to_tx(
   add_paritions_tx_request request, model::timeout_clock::duration timeout) {
-    auto shard = _shard_table.local().shard_for(model::tx_manager_ntp);
+    auto tm_ntp_opt = ntp_for_tx_id(request.transactional_id);
+    if (!tm_ntp_opt) {
+        vlog(clusterlog.warn, "can't find {} partitions", model::tx_manager_nt);
+        return ss::make_ready_future<add_paritions_tx_reply>(
+          make_add_partitions_error_response(
+            request, tx_errc::unknown_server_error));
+    }
+    auto tm_ntp = *tm_ntp_opt;
+
+    auto shard = _shard_table.local().shard_for(tm_ntp);
 
     if (shard == std::nullopt) {
-        vlog(
-          clusterlog.warn, "can't find a shard for {}", model::tx_manager_ntp);
+        vlog(clusterlog.warn, "can't find a shard for {}", tm_ntp);
         return ss::make_ready_future<add_paritions_tx_reply>(
           make_add_partitions_error_response(
             request, tx_errc::unknown_server_error));
     }
 
     return container().invoke_on(
-      *shard, _ssg, [request, timeout](tx_gateway_frontend& self) {
-          auto partition = self._partition_manager.local().get(
-            model::tx_manager_ntp);
+      *shard, _ssg, [tm_ntp, request, timeout](tx_gateway_frontend& self) {
+          auto partition = self._partition_manager.local().get(tm_ntp);
           if (!partition) {
-              vlog(
-                clusterlog.warn,
-                "can't get partition by {} ntp",
-                model::tx_manager_ntp);
+              vlog(clusterlog.warn, "can't get partition by {} ntp", tm_ntp);
               return ss::make_ready_future<add_paritions_tx_reply>(
                 make_add_partitions_error_response(
                   request, tx_errc::unknown_server_error));
@@ -616,7 +655,7 @@ ss::future<add_paritions_tx_reply> tx_gateway_frontend::add_partition_to_tx(
               vlog(
                 clusterlog.warn,
                 "can't get tm stm of the {}' partition",
-                model::tx_manager_ntp);
+                tm_ntp);
               return ss::make_ready_future<add_paritions_tx_reply>(
                 make_add_partitions_error_response(
                   request, tx_errc::unknown_server_error));
@@ -732,24 +771,27 @@ ss::future<add_paritions_tx_reply> tx_gateway_frontend::do_add_partition_to_tx(
 
 ss::future<add_offsets_tx_reply> tx_gateway_frontend::add_offsets_to_tx(
   add_offsets_tx_request request, model::timeout_clock::duration timeout) {
-    auto shard = _shard_table.local().shard_for(model::tx_manager_ntp);
+    auto tm_ntp_opt = ntp_for_tx_id(request.transactional_id);
+    if (!tm_ntp_opt) {
+        vlog(clusterlog.warn, "can't find {} partitions", model::tx_manager_nt);
+        return ss::make_ready_future<add_offsets_tx_reply>(
+          add_offsets_tx_reply{.error_code = tx_errc::unknown_server_error});
+    }
+    auto tm_ntp = *tm_ntp_opt;
+
+    auto shard = _shard_table.local().shard_for(tm_ntp);
 
     if (shard == std::nullopt) {
-        vlog(
-          clusterlog.warn, "can't find a shard for {}", model::tx_manager_ntp);
+        vlog(clusterlog.warn, "can't find a shard for {}", tm_ntp);
         return ss::make_ready_future<add_offsets_tx_reply>(
           add_offsets_tx_reply{.error_code = tx_errc::unknown_server_error});
     }
 
     return container().invoke_on(
-      *shard, _ssg, [request, timeout](tx_gateway_frontend& self) {
-          auto partition = self._partition_manager.local().get(
-            model::tx_manager_ntp);
+      *shard, _ssg, [tm_ntp, request, timeout](tx_gateway_frontend& self) {
+          auto partition = self._partition_manager.local().get(tm_ntp);
           if (!partition) {
-              vlog(
-                clusterlog.warn,
-                "can't get partition by {} ntp",
-                model::tx_manager_ntp);
+              vlog(clusterlog.warn, "can't get partition by {} ntp", tm_ntp);
               return ss::make_ready_future<add_offsets_tx_reply>(
                 add_offsets_tx_reply{
                   .error_code = tx_errc::unknown_server_error});
@@ -761,7 +803,7 @@ ss::future<add_offsets_tx_reply> tx_gateway_frontend::add_offsets_to_tx(
               vlog(
                 clusterlog.warn,
                 "can't get tm stm of the {}' partition",
-                model::tx_manager_ntp);
+                tm_ntp);
               return ss::make_ready_future<add_offsets_tx_reply>(
                 add_offsets_tx_reply{
                   .error_code = tx_errc::unknown_server_error});
@@ -807,11 +849,18 @@ ss::future<add_offsets_tx_reply> tx_gateway_frontend::do_add_offsets_to_tx(
 
 ss::future<end_tx_reply> tx_gateway_frontend::end_txn(
   end_tx_request request, model::timeout_clock::duration timeout) {
-    auto shard = _shard_table.local().shard_for(model::tx_manager_ntp);
+    auto tm_ntp_opt = ntp_for_tx_id(request.transactional_id);
+    if (!tm_ntp_opt) {
+        vlog(clusterlog.warn, "can't find {} partitions", model::tx_manager_nt);
+        return ss::make_ready_future<end_tx_reply>(
+          end_tx_reply{.error_code = tx_errc::unknown_server_error});
+    }
+    auto tm_ntp = *tm_ntp_opt;
+
+    auto shard = _shard_table.local().shard_for(tm_ntp);
 
     if (shard == std::nullopt) {
-        vlog(
-          clusterlog.warn, "can't find a shard for {}", model::tx_manager_ntp);
+        vlog(clusterlog.warn, "can't find a shard for {}", tm_ntp);
         return ss::make_ready_future<end_tx_reply>(
           end_tx_reply{.error_code = tx_errc::unknown_server_error});
     }
@@ -819,14 +868,11 @@ ss::future<end_tx_reply> tx_gateway_frontend::end_txn(
     return container().invoke_on(
       *shard,
       _ssg,
-      [request = std::move(request), timeout](tx_gateway_frontend& self) {
-          auto partition = self._partition_manager.local().get(
-            model::tx_manager_ntp);
+      [tm_ntp, request = std::move(request), timeout](
+        tx_gateway_frontend& self) {
+          auto partition = self._partition_manager.local().get(tm_ntp);
           if (!partition) {
-              vlog(
-                clusterlog.warn,
-                "can't get partition by {} ntp",
-                model::tx_manager_ntp);
+              vlog(clusterlog.warn, "can't get partition by {} ntp", tm_ntp);
               return ss::make_ready_future<end_tx_reply>(
                 end_tx_reply{.error_code = tx_errc::unknown_server_error});
           }
@@ -837,7 +883,7 @@ ss::future<end_tx_reply> tx_gateway_frontend::end_txn(
               vlog(
                 clusterlog.warn,
                 "can't get tm stm of the {}' partition",
-                model::tx_manager_ntp);
+                tm_ntp);
               return ss::make_ready_future<end_tx_reply>(
                 end_tx_reply{.error_code = tx_errc::unknown_server_error});
           }
@@ -969,21 +1015,18 @@ tx_gateway_frontend::do_abort_tm_tx(
     }
     outcome->set_value(tx_errc::none);
 
-    std::vector<ss::future<abort_tx_reply>> pfs;
-    for (auto rm : tx.partitions) {
-        pfs.push_back(_rm_partition_frontend.local().abort_tx(
-          rm.ntp, tx.pid, tx.tx_seq, timeout));
-    }
+    auto pfs = _rm_partition_frontend.local().write_tx_markers(
+      partitions_of(tx), tx.pid, tx.tx_seq, false, timeout);
     std::vector<ss::future<abort_group_tx_reply>> gfs;
     for (auto group : tx.groups) {
         gfs.push_back(
           _rm_group_proxy->abort_group_tx(group.group_id, tx.pid, timeout));
     }
-    auto prs = co_await when_all_succeed(pfs.begin(), pfs.end());
+    auto prs = co_await std::move(pfs);
     auto grs = co_await when_all_succeed(gfs.begin(), gfs.end());
     bool ok = true;
-    for (const auto& r : prs) {
-        ok = ok && (r.ec == tx_errc::none);
+    for (auto ec : prs) {
+        ok = ok && (ec == tx_errc::none);
     }
     for (const auto& r : grs) {
         ok = ok && (r.ec == tx_errc::none);
@@ -1012,7 +1055,7 @@ tx_gateway_frontend::do_commit_tm_tx(
         pfs.push_back(_rm_partition_frontend.local().prepare_tx(
           rm.ntp,
           rm.etag,
-          model::tx_manager_ntp.tp.partition,
+          stm->ntp().tp.partition,
           tx.pid,
           tx.tx_seq,
           timeout));
@@ -1074,19 +1117,16 @@ tx_gateway_frontend::do_commit_tm_tx(
         gfs.push_back(_rm_group_proxy->commit_group_tx(
           group.group_id, tx.pid, tx.tx_seq, timeout));
     }
-    std::vector<ss::future<commit_tx_reply>> cfs;
-    for (auto rm : tx.partitions) {
-        cfs.push_back(_rm_partition_frontend.local().commit_tx(
-          rm.ntp, tx.pid, tx.tx_seq, timeout));
-    }
+    auto cfs = _rm_partition_frontend.local().write_tx_markers(
+      partitions_of(tx), tx.pid, tx.tx_seq, true, timeout);
     ok = true;
     auto grs = co_await when_all_succeed(gfs.begin(), gfs.end());
     for (const auto& r : grs) {
         ok = ok && (r.ec == tx_errc::none);
     }
-    auto crs = co_await when_all_succeed(cfs.begin(), cfs.end());
-    for (const auto& r : crs) {
-        ok = ok && (r.ec == tx_errc::none);
+    auto crs = co_await std::move(cfs);
+    for (auto ec : crs) {
+        ok = ok && (ec == tx_errc::none);
     }
     if (!ok) {
         co_return tx_errc::unknown_server_error;
@@ -1101,20 +1141,17 @@ ss::future<tx_errc> tx_gateway_frontend::recommit_tm_tx(
         gfs.push_back(_rm_group_proxy->commit_group_tx(
           group.group_id, tx.pid, tx.tx_seq, timeout));
     }
-    std::vector<ss::future<commit_tx_reply>> cfs;
-    for (auto rm : tx.partitions) {
-        cfs.push_back(_rm_partition_frontend.local().commit_tx(
-          rm.ntp, tx.pid, tx.tx_seq, timeout));
-    }
+    auto cfs = _rm_partition_frontend.local().write_tx_markers(
+      partitions_of(tx), tx.pid, tx.tx_seq, true, timeout);
 
     auto ok = true;
     auto grs = co_await when_all_succeed(gfs.begin(), gfs.end());
     for (const auto& r : grs) {
         ok = ok && (r.ec == tx_errc::none);
     }
-    auto crs = co_await when_all_succeed(cfs.begin(), cfs.end());
-    for (const auto& r : crs) {
-        ok = ok && (r.ec == tx_errc::none);
+    auto crs = co_await std::move(cfs);
+    for (auto ec : crs) {
+        ok = ok && (ec == tx_errc::none);
     }
     if (!ok) {
         co_return tx_errc::unknown_server_error;
@@ -1124,21 +1161,18 @@ ss::future<tx_errc> tx_gateway_frontend::recommit_tm_tx(
 
 ss::future<tx_errc> tx_gateway_frontend::reabort_tm_tx(
   tm_transaction tx, model::timeout_clock::duration timeout) {
-    std::vector<ss::future<abort_tx_reply>> pfs;
-    for (auto rm : tx.partitions) {
-        pfs.push_back(_rm_partition_frontend.local().abort_tx(
-          rm.ntp, tx.pid, tx.tx_seq, timeout));
-    }
+    auto pfs = _rm_partition_frontend.local().write_tx_markers(
+      partitions_of(tx), tx.pid, tx.tx_seq, false, timeout);
     std::vector<ss::future<abort_group_tx_reply>> gfs;
     for (auto group : tx.groups) {
         gfs.push_back(
           _rm_group_proxy->abort_group_tx(group.group_id, tx.pid, timeout));
     }
-    auto prs = co_await when_all_succeed(pfs.begin(), pfs.end());
+    auto prs = co_await std::move(pfs);
     auto grs = co_await when_all_succeed(gfs.begin(), gfs.end());
     auto ok = true;
-    for (const auto& r : prs) {
-        ok = ok && (r.ec == tx_errc::none);
+    for (auto ec : prs) {
+        ok = ok && (ec == tx_errc::none);
     }
     for (const auto& r : grs) {
         ok = ok && (r.ec == tx_errc::none);
@@ -1245,7 +1279,7 @@ ss::future<bool> tx_gateway_frontend::try_create_tx_topic() {
     cluster::topic_configuration topic{
       model::kafka_internal_namespace,
       model::tx_manager_topic,
-      1,
+      config::shard_local_cfg().transaction_coordinator_partitions(),
       config::shard_local_cfg().transaction_coordinator_replication()};
 
     topic.properties.cleanup_policy_bitflags
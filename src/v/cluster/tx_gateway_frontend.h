@@ -40,7 +40,9 @@ public:
       rm_group_proxy*,
       ss::sharded<cluster::rm_partition_frontend>&);
 
-    ss::future<std::optional<model::node_id>> get_tx_broker();
+    /// Returns the leader of the coordinator partition of the transaction
+    ss::future<std::optional<model::node_id>>
+      get_tx_broker(kafka::transactional_id);
     ss::future<try_abort_reply> try_abort(
       model::partition_id,
       model::producer_identity,
@@ -85,6 +87,11 @@ private:
 
     ss::future<bool> try_create_tx_topic();
 
+    static model::ntp tx_ntp(model::partition_id);
+    // the transactions are spread between the partitions of the coordinator
+    // topic by the hash of their transactional id, like consumer groups
+    std::optional<model::ntp> ntp_for_tx_id(const kafka::transactional_id&);
+
     ss::future<checked<tm_transaction, tx_errc>> get_ongoing_tx(
       ss::shared_ptr<tm_stm>,
       model::producer_identity,
@@ -117,6 +124,7 @@ private:
       model::timeout_clock::duration);
     ss::future<cluster::init_tm_tx_reply> do_init_tm_tx(
       ss::shard_id,
+      model::ntp,
       kafka::transactional_id,
       std::chrono::milliseconds,
       model::timeout_clock::duration);
@@ -37,7 +37,9 @@ bool topic_properties::has_overrides() const {
     return cleanup_policy_bitflags || compaction_strategy || segment_size
            || retention_bytes.has_value() || retention_bytes.is_disabled()
            || retention_duration.has_value()
-           || retention_duration.is_disabled();
+           || retention_duration.is_disabled() || storage_engine
+           || compression || flush_ms || flush_bytes || recovery
+           || read_replica_bucket;
 }
 
 storage::ntp_config::default_overrides
@@ -48,6 +50,12 @@ topic_properties::get_ntp_cfg_overrides() const {
     ret.retention_bytes = retention_bytes;
     ret.retention_time = retention_duration;
     ret.segment_size = segment_size;
+    ret.storage_engine = storage_engine;
+    ret.compression = compression;
+    ret.flush_ms = flush_ms;
+    ret.flush_bytes = flush_bytes;
+    ret.recovery = recovery.value_or(false);
+    ret.read_replica_bucket = read_replica_bucket;
     return ret;
 }
 
@@ -74,7 +82,13 @@ storage::ntp_config topic_configuration::make_ntp_config(
             .retention_time = properties.retention_duration,
             // we disable cache for internal topics as they are read only once
             // during bootstrap.
-            .cache_enabled = storage::with_cache(!is_internal())});
+            .cache_enabled = storage::with_cache(!is_internal()),
+            .storage_engine = properties.storage_engine,
+            .compression = properties.compression,
+            .flush_ms = properties.flush_ms,
+            .flush_bytes = properties.flush_bytes,
+            .recovery = properties.recovery.value_or(false),
+            .read_replica_bucket = properties.read_replica_bucket});
     }
     return storage::ntp_config(
       model::ntp(tp_ns.ns, tp_ns.tp, p_id),
@@ -155,14 +169,20 @@ std::ostream& operator<<(std::ostream& o, const topic_properties& properties) {
       o,
       "{{ compression: {}, cleanup_policy_bitflags: {}, compaction_strategy: "
       "{}, retention_bytes: {}, retention_duration_ms: {}, segment_size: {}, "
-      "timestamp_type: {} }}",
+      "timestamp_type: {}, storage_engine: {}, flush_ms: {}, flush_bytes: {}, "
+      "recovery: {}, read_replica_bucket: {} }}",
       properties.compression,
       properties.cleanup_policy_bitflags,
       properties.compaction_strategy,
       properties.retention_bytes,
       properties.retention_duration,
       properties.segment_size,
-      properties.timestamp_type);
+      properties.timestamp_type,
+      properties.storage_engine,
+      properties.flush_ms,
+      properties.flush_bytes,
+      properties.recovery,
+      properties.read_replica_bucket);
 
     return o;
 }
@@ -262,6 +282,16 @@ operator<<(std::ostream& o, const ntp_reconciliation_state& state) {
 namespace reflection {
 void adl<cluster::topic_configuration>::to(
   iobuf& out, cluster::topic_configuration&& t) {
+    // the topics without the later properties keep the first format, the
+    // nodes of the previous versions read them
+    const bool versioned = t.properties.storage_engine.has_value()
+                           || t.properties.flush_ms.has_value()
+                           || t.properties.flush_bytes.has_value()
+                           || t.properties.recovery.has_value()
+                           || t.properties.read_replica_bucket.has_value();
+    if (versioned) {
+        reflection::serialize(out, cluster::topic_configuration::version);
+    }
     reflection::serialize(
       out,
       t.tp_ns,
@@ -274,10 +304,28 @@ void adl<cluster::topic_configuration>::to(
       t.properties.segment_size,
       t.properties.retention_bytes,
       t.properties.retention_duration);
+    if (versioned) {
+        reflection::serialize(
+          out,
+          t.properties.storage_engine,
+          t.properties.flush_ms,
+          t.properties.flush_bytes,
+          t.properties.recovery,
+          t.properties.read_replica_bucket);
+    }
 }
 
 cluster::topic_configuration
 adl<cluster::topic_configuration>::from(iobuf_parser& in) {
+    int8_t version = 0;
+    if (const char* p = in.peek_contiguous(1); p && int8_t(*p) < 0) {
+        version = adl<int8_t>{}.from(in);
+        vassert(
+          version >= cluster::topic_configuration::version,
+          "Unexpected topic configuration version {} (expected at least {})",
+          version,
+          cluster::topic_configuration::version);
+    }
     auto ns = model::ns(adl<ss::sstring>{}.from(in));
     auto topic = model::topic(adl<ss::sstring>{}.from(in));
     auto partition_count = adl<int32_t>{}.from(in);
@@ -298,6 +346,22 @@ adl<cluster::topic_configuration>::from(iobuf_parser& in) {
     cfg.properties.retention_bytes = adl<tristate<size_t>>{}.from(in);
     cfg.properties.retention_duration
       = adl<tristate<std::chrono::milliseconds>>{}.from(in);
+    if (version < 0) {
+        cfg.properties.storage_engine
+          = adl<std::optional<model::storage_engine>>{}.from(in);
+    }
+    if (version <= -2) {
+        cfg.properties.flush_ms
+          = adl<std::optional<std::chrono::milliseconds>>{}.from(in);
+        cfg.properties.flush_bytes = adl<std::optional<size_t>>{}.from(in);
+    }
+    if (version <= -3) {
+        cfg.properties.recovery = adl<std::optional<bool>>{}.from(in);
+    }
+    if (version <= -4) {
+        cfg.properties.read_replica_bucket
+          = adl<std::optional<ss::sstring>>{}.from(in);
+    }
 
     return cfg;
 }
@@ -40,6 +40,18 @@ struct allocate_id_reply {
     errc ec;
 };
 
+struct allocate_id_range_request {
+    model::timeout_clock::duration timeout;
+    int64_t count;
+};
+
+/// The ids [id, id + count) are allocated
+struct allocate_id_range_reply {
+    int64_t id;
+    int64_t count;
+    errc ec;
+};
+
 enum class tx_errc {
     none = 0,
     leader_not_found,
@@ -218,6 +230,18 @@ struct abort_tx_request {
 struct abort_tx_reply {
     tx_errc ec;
 };
+/// Commits (or aborts) the transaction on the partitions led by a node
+struct write_tx_markers_request {
+    std::vector<model::ntp> ntps;
+    model::producer_identity pid;
+    model::tx_seq tx_seq;
+    bool commit;
+    model::timeout_clock::duration timeout;
+};
+struct write_tx_markers_reply {
+    // in the order of the request ntps
+    std::vector<tx_errc> ecs;
+};
 struct begin_group_tx_request {
     model::ntp ntp;
     kafka::group_id group_id;
@@ -312,6 +336,18 @@ struct topic_properties {
     std::optional<size_t> segment_size;
     tristate<size_t> retention_bytes;
     tristate<std::chrono::milliseconds> retention_duration;
+    // set when the topic is created, the partitions can't change of engine
+    std::optional<model::storage_engine> storage_engine;
+    // flush policy of the writes acknowledged by the leader alone, set when
+    // the topic is created
+    std::optional<std::chrono::milliseconds> flush_ms;
+    std::optional<size_t> flush_bytes;
+    // the partitions of the topic are restored from the cloud storage when
+    // they are created, set when the topic is created
+    std::optional<bool> recovery;
+    // the topic is a read replica of a topic archived by another cluster
+    // into this bucket, its partitions are served from the bucket
+    std::optional<ss::sstring> read_replica_bucket;
 
     bool is_compacted() const;
     bool has_overrides() const;
@@ -366,6 +402,11 @@ struct topic_configuration {
       int32_t partition_count,
       int16_t replication_factor);
 
+    /// \brief written first by the configurations of the topics serialized
+    /// with the properties added after the first format. It is negative,
+    /// where the first format starts with the length of the namespace
+    static constexpr int8_t version = -4;
+
     storage::ntp_config make_ntp_config(
       const ss::sstring&, model::partition_id, model::revision_id) const;
 
@@ -616,6 +657,41 @@ struct finish_reallocation_reply {
     errc error;
 };
 
+/// Health of a partition led by the reporting node, the followers don't
+/// report their replicas to keep the report small
+struct partition_health_report {
+    model::partition_id id;
+    bool under_replicated{false};
+    uint64_t size_bytes{0};
+    // produce and fetch bytes per second served by the leader
+    uint64_t bytes_rate{0};
+};
+
+struct topic_health_report {
+    model::topic_namespace tp_ns;
+    // size and number of all the replicas of the topic on the node
+    uint64_t size_bytes{0};
+    uint32_t replicas{0};
+    std::vector<partition_health_report> leaders;
+};
+
+struct node_health_report {
+    model::node_id id;
+    uint64_t disk_total_bytes{0};
+    uint64_t disk_free_bytes{0};
+    // produce and fetch bytes per second of all the partitions of the node
+    uint64_t bytes_rate{0};
+    std::vector<topic_health_report> topics;
+};
+
+struct report_health_request {
+    node_health_report report;
+};
+
+struct report_health_reply {
+    errc error;
+};
+
 } // namespace cluster
 namespace std {
 template<>
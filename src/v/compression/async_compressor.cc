@@ -0,0 +1,151 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "compression/async_compressor.h"
+
+#include "compression/stream_zstd.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/thread.hh>
+
+#include <memory>
+
+namespace compression {
+
+namespace {
+struct offload_state {
+    offload_state(ss::scheduling_group sg, size_t threshold)
+      : sg(sg)
+      , threshold(threshold) {}
+
+    void setup_metrics();
+
+    ss::scheduling_group sg;
+    size_t threshold;
+    // the payloads are offloaded one at a time, the others wait their turn
+    ss::semaphore jobs{1};
+    ss::gate gate;
+    uint64_t inline_payloads{0};
+    uint64_t offloaded_payloads{0};
+    hdr_hist inline_latency;
+    // time spent waiting for the turn included
+    hdr_hist offloaded_latency;
+    ss::metrics::metric_groups metrics;
+};
+
+void offload_state::setup_metrics() {
+    namespace sm = ss::metrics;
+    metrics.add_group(
+      prometheus_sanitize::metrics_name("compression"),
+      {
+        sm::make_derive(
+          "inline_payloads",
+          [this] { return inline_payloads; },
+          sm::description("Number of payloads (de)compressed inline")),
+        sm::make_derive(
+          "offloaded_payloads",
+          [this] { return offloaded_payloads; },
+          sm::description("Number of payloads (de)compressed in the "
+                          "background scheduling group")),
+        sm::make_gauge(
+          "offloaded_payloads_waiting",
+          [this] { return jobs.waiters(); },
+          sm::description("Number of payloads waiting to be (de)compressed "
+                          "in the background scheduling group")),
+        sm::make_histogram(
+          "inline_latency",
+          [this] { return inline_latency.seastar_histogram_logform(); },
+          sm::description("Latency of the payloads (de)compressed inline")),
+        sm::make_histogram(
+          "offloaded_latency",
+          [this] { return offloaded_latency.seastar_histogram_logform(); },
+          sm::description("Latency of the payloads (de)compressed in the "
+                          "background scheduling group")),
+      });
+}
+
+thread_local std::unique_ptr<offload_state> state;
+
+iobuf compress_preemptible(const iobuf& io, type t) {
+    if (t == type::zstd) {
+        return stream_zstd::compress_preemptible(io);
+    }
+    return compressor::compress(io, t);
+}
+
+iobuf uncompress_preemptible(const iobuf& io, type t) {
+    if (t == type::zstd && !io.empty()) {
+        return stream_zstd::uncompress_preemptible(io);
+    }
+    return compressor::uncompress(io, t);
+}
+
+template<typename Inline, typename Offloaded>
+ss::future<iobuf>
+dispatch(const iobuf& io, Inline inline_fn, Offloaded offloaded_fn) {
+    if (!state) {
+        return ss::futurize_invoke(inline_fn);
+    }
+    auto& st = *state;
+    if (io.size_bytes() < st.threshold) {
+        ++st.inline_payloads;
+        auto m = st.inline_latency.auto_measure();
+        return ss::futurize_invoke(inline_fn);
+    }
+    ++st.offloaded_payloads;
+    return ss::with_gate(
+      st.gate, [&st, offloaded_fn = std::move(offloaded_fn)]() mutable {
+          auto m = st.offloaded_latency.auto_measure();
+          return ss::with_semaphore(
+                   st.jobs,
+                   1,
+                   [&st, offloaded_fn = std::move(offloaded_fn)]() mutable {
+                       ss::thread_attributes attr;
+                       attr.sched_group = st.sg;
+                       return ss::async(attr, std::move(offloaded_fn));
+                   })
+            .finally([m = std::move(m)] {});
+      });
+}
+} // namespace
+
+void async_compressor::start(
+  ss::scheduling_group sg, size_t threshold, bool disable_metrics) {
+    state = std::make_unique<offload_state>(sg, threshold);
+    if (!disable_metrics) {
+        state->setup_metrics();
+    }
+}
+
+ss::future<> async_compressor::stop() {
+    if (!state) {
+        return ss::now();
+    }
+    return state->gate.close().then([] { state.reset(); });
+}
+
+ss::future<iobuf> async_compressor::compress(const iobuf& io, type t) {
+    return dispatch(
+      io,
+      [&io, t] { return compressor::compress(io, t); },
+      [&io, t] { return compress_preemptible(io, t); });
+}
+
+ss::future<iobuf> async_compressor::uncompress(const iobuf& io, type t) {
+    return dispatch(
+      io,
+      [&io, t] { return compressor::uncompress(io, t); },
+      [&io, t] { return uncompress_preemptible(io, t); });
+}
+
+} // namespace compression
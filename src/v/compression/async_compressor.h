@@ -0,0 +1,46 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "bytes/iobuf.h"
+#include "compression/compression.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/scheduling.hh>
+
+namespace compression {
+
+/**
+ * Compresses and decompresses payloads off the latency sensitive path of
+ * the shard.
+ *
+ * Payloads smaller than the threshold are processed inline, like with the
+ * compressor. The larger ones are processed one at a time in the background
+ * scheduling group; zstd streams yield to the other tasks of the shard as
+ * they go, the other codecs run their payload at once.
+ *
+ * The payload must be kept alive until the returned future resolves. Until
+ * the shard's compressor is started all the payloads are processed inline.
+ */
+struct async_compressor {
+    /// \brief starts offloading the payloads of at least threshold bytes of
+    /// the current shard to the scheduling group
+    static void
+    start(ss::scheduling_group, size_t threshold, bool disable_metrics);
+    /// \brief waits for the offloaded payloads of the current shard
+    static ss::future<> stop();
+
+    static ss::future<iobuf> compress(const iobuf&, type);
+    static ss::future<iobuf> uncompress(const iobuf&, type);
+};
+
+} // namespace compression
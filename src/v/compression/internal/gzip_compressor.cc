@@ -9,8 +9,8 @@
 
 #include "compression/internal/gzip_compressor.h"
 
-#include "bytes/bytes.h"
-#include "vassert.h"
+#include "likely.h"
+#include "units.h"
 
 #include <seastar/core/temporary_buffer.hh>
 
@@ -39,17 +39,11 @@ inline z_stream default_zstream() {
     return zs;
 }
 
+/// deflate stream initialized once and reset between the compressions,
+/// setting up the stream allocates the zlib state and window
 class gzip_compression_codec {
 public:
-    gzip_compression_codec() noexcept = default;
-    gzip_compression_codec(const gzip_compression_codec&) = delete;
-    gzip_compression_codec& operator=(const gzip_compression_codec&) = delete;
-    gzip_compression_codec(gzip_compression_codec&&) noexcept = delete;
-    gzip_compression_codec&
-    operator=(gzip_compression_codec&&) noexcept = delete;
-
-    void reset() {
-        vassert(!_init, "Double initialized gzip decompression codec");
+    gzip_compression_codec() {
         _stream = default_zstream();
         throw_if_zstream_error(
           "gzip compress deflateInit2 error: {}",
@@ -60,163 +54,142 @@ public:
             15 + 16,
             8 /*512 byte*/,
             Z_DEFAULT_STRATEGY));
-        _init = true;
     }
-    z_stream& stream() { return _stream; }
-    ~gzip_compression_codec() {
-        if (_init) {
-            _init = false;
-            deflateEnd(&_stream);
-        }
+    gzip_compression_codec(const gzip_compression_codec&) = delete;
+    gzip_compression_codec& operator=(const gzip_compression_codec&) = delete;
+    gzip_compression_codec(gzip_compression_codec&&) noexcept = delete;
+    gzip_compression_codec&
+    operator=(gzip_compression_codec&&) noexcept = delete;
+    ~gzip_compression_codec() { deflateEnd(&_stream); }
+
+    z_stream& reset() {
+        throw_if_zstream_error(
+          "gzip deflateReset error: {}", deflateReset(&_stream));
+        return _stream;
     }
 
 private:
-    bool _init{false};
     z_stream _stream;
 };
+
+/// inflate stream initialized once and reset between the decompressions
 class gzip_decompression_codec {
 public:
-    gzip_decompression_codec(const char* src, size_t src_size) noexcept
-      : _input(src)
-      , _input_size(src_size) {}
+    gzip_decompression_codec() {
+        _stream = default_zstream();
+        throw_if_zstream_error(
+          "gzip error with inflateInit2:{}", inflateInit2(&_stream, 15 + 32));
+    }
     gzip_decompression_codec(const gzip_decompression_codec&) = delete;
     gzip_decompression_codec& operator=(const gzip_decompression_codec&)
       = delete;
     gzip_decompression_codec(gzip_decompression_codec&&) noexcept = delete;
     gzip_decompression_codec&
     operator=(gzip_decompression_codec&&) noexcept = delete;
+    ~gzip_decompression_codec() { inflateEnd(&_stream); }
 
-    void reset() {
-        vassert(!_init, "Double initialized gzip decompression codec");
-        _stream = default_zstream();
-        // zlib is not const-correct
-        // NOLINTNEXTLINE
-        _stream.next_in = (unsigned char*)_input;
-        _stream.avail_in = _input_size;
-        throw_if_zstream_error(
-          "gzip error with inflateInit2:{}", inflateInit2(&_stream, 15 + 32));
-        // marking init must happen before gzip header
-        _init = true;
-
-        // last
+    z_stream& reset() {
         throw_if_zstream_error(
-          "gzip inflateGetHeader error:{}", inflateGetHeader(&_stream, &_hdr));
-    }
-
-    void inflate_to(char* output, size_t out_size);
-
-    ~gzip_decompression_codec() {
-        if (_init) {
-            _init = false;
-            inflateEnd(&_stream);
-        }
+          "gzip inflateReset error: {}", inflateReset(&_stream));
+        return _stream;
     }
 
-    z_stream& stream() { return _stream; }
-    gz_header& header() { return _hdr; }
-
 private:
-    bool _init{false};
-    const char* _input;
-    size_t _input_size;
-    gz_header _hdr; // needed for gzip
     z_stream _stream;
 };
 
-iobuf gzip_compressor::compress(const iobuf& b) {
-    ss::temporary_buffer<char> obuf;
-    {
-        gzip_compression_codec def;
-        def.reset();
-        z_stream& strm = def.stream();
-        /* Calculate maximum compressed size and
-         * allocate an output buffer accordingly, being
-         * prefixed with the Message header. */
-        const size_t output_size = deflateBound(&strm, b.size_bytes());
-        obuf = ss::temporary_buffer<char>(output_size);
+// the (de)compression runs to completion without yielding, a single codec
+// of each kind per shard is reused by all the calls
+static gzip_compression_codec& compression_codec() {
+    static thread_local gzip_compression_codec codec;
+    return codec;
+}
 
-        // NOLINTNEXTLINE
-        strm.next_out = (unsigned char*)obuf.get_write();
-        strm.avail_out = output_size;
+static gzip_decompression_codec& decompression_codec() {
+    static thread_local gzip_decompression_codec codec;
+    return codec;
+}
 
-        /* Iterate through each segment and compress it. */
-        for (auto& io : b) {
-            // zlib is not const correct
-            // NOLINTNEXTLINE
-            strm.next_in = (unsigned char*)io.get();
-            strm.avail_in = io.size();
-            throw_if_zstream_error(
-              "gzip error compressing chunk: {}", deflate(&strm, Z_NO_FLUSH));
-        }
-        /* Finish the compression */
-        if (int ret = deflate(&strm, Z_FINISH); ret != Z_STREAM_END) {
-            throw_if_zstream_error("gzip error finishing compression: {}", ret);
-        }
-        obuf.trim(def.stream().total_out);
-        // trigger deflateEnd
-    }
-    iobuf ret;
-    ret.append(std::move(obuf));
-    return ret;
+// staging buffer of the output, copied to the fragments of the result
+static constexpr size_t staging_size = 64_KiB;
+static char* staging_buffer() {
+    static thread_local ss::temporary_buffer<char> buf(staging_size);
+    return buf.get_write();
 }
 
-void gzip_decompression_codec::inflate_to(char* output, size_t out_size) {
-    size_t consumed_bytes = 0;
-    int code = 0;
-    // NOLINTNEXTLINE
-    auto out = reinterpret_cast<unsigned char*>(output);
+/// deflates the input of the stream, the bytes produced are appended to out
+static int deflate_to(z_stream& strm, int flush, iobuf& out) {
+    char* staging = staging_buffer();
+    int code = Z_OK;
     do {
+        // zlib is not const correct
         // NOLINTNEXTLINE
-        _stream.next_out = out + consumed_bytes;
-        _stream.avail_out = out_size - consumed_bytes;
-        code = inflate(&_stream, Z_NO_FLUSH);
-        switch (code) {
-        case Z_STREAM_ERROR:
-        case Z_NEED_DICT:
-        case Z_DATA_ERROR:
-        case Z_MEM_ERROR:
-            throw_zstream_error("gzip uncmpress error:{}", code);
-        default: /*do nothing*/;
+        strm.next_out = reinterpret_cast<unsigned char*>(staging);
+        strm.avail_out = staging_size;
+        code = deflate(&strm, flush);
+        if (unlikely(code == Z_STREAM_ERROR)) {
+            throw_zstream_error("gzip error compressing chunk: {}", code);
         }
-        /* Advance output pointer (in pass 2). */
-        consumed_bytes = out_size - _stream.avail_out - consumed_bytes;
-    } while (_stream.avail_out == 0 && code != Z_STREAM_END);
+        out.append(staging, staging_size - strm.avail_out);
+    } while (strm.avail_out == 0);
+    return code;
 }
 
-static ss::temporary_buffer<char>
-buffer_for_input(const char* src, size_t src_size) {
-    auto codec = gzip_decompression_codec(src, src_size);
-    codec.reset();
-    std::array<char, 512> dummy_buf{};
-    // find gzip header
-    codec.inflate_to(dummy_buf.data(), dummy_buf.size());
-    return ss::temporary_buffer<char>(codec.stream().total_out);
-}
-
-static iobuf do_uncompress(const char* src, size_t src_size) {
-    ss::temporary_buffer<char> buf;
-    {
-        auto codec = gzip_decompression_codec(src, src_size);
-        codec.reset();
-        buf = buffer_for_input(src, src_size);
-        // main data decompression
-        codec.inflate_to(buf.get_write(), buf.size());
-    }
+iobuf gzip_compressor::compress(const iobuf& b) {
+    z_stream& strm = compression_codec().reset();
     iobuf ret;
-    ret.append(std::move(buf));
+    /* Iterate through each segment and compress it. */
+    for (auto& io : b) {
+        // zlib is not const correct
+        // NOLINTNEXTLINE
+        strm.next_in = (unsigned char*)io.get();
+        strm.avail_in = io.size();
+        deflate_to(strm, Z_NO_FLUSH, ret);
+    }
+    /* Finish the compression */
+    strm.next_in = Z_NULL;
+    strm.avail_in = 0;
+    if (int ret_code = deflate_to(strm, Z_FINISH, ret);
+        ret_code != Z_STREAM_END) {
+        throw_zstream_error("gzip error finishing compression: {}", ret_code);
+    }
     return ret;
 }
 
 iobuf gzip_compressor::uncompress(const iobuf& b) {
-    if (std::distance(b.begin(), b.end()) == 1) {
-        return do_uncompress(b.begin()->get(), b.size_bytes());
+    z_stream& strm = decompression_codec().reset();
+    char* staging = staging_buffer();
+    iobuf ret;
+    int code = Z_OK;
+    // the fragments are decompressed in place, the input is not linearized
+    for (auto& io : b) {
+        // NOLINTNEXTLINE
+        strm.next_in = (unsigned char*)io.get();
+        strm.avail_in = io.size();
+        do {
+            // NOLINTNEXTLINE
+            strm.next_out = reinterpret_cast<unsigned char*>(staging);
+            strm.avail_out = staging_size;
+            code = inflate(&strm, Z_NO_FLUSH);
+            switch (code) {
+            case Z_STREAM_ERROR:
+            case Z_NEED_DICT:
+            case Z_DATA_ERROR:
+            case Z_MEM_ERROR:
+                throw_zstream_error("gzip uncmpress error:{}", code);
+            default: /*do nothing*/;
+            }
+            ret.append(staging, staging_size - strm.avail_out);
+        } while (strm.avail_out == 0 && code != Z_STREAM_END);
+        if (code == Z_STREAM_END) {
+            break;
+        }
+    }
+    if (unlikely(code != Z_STREAM_END)) {
+        throw std::runtime_error(fmt::format(
+          "gzip uncompress error: truncated input of {} bytes",
+          b.size_bytes()));
     }
-    // linearize buffer
-    // TODO: use streaming interface instead
-    auto linearized = iobuf_to_bytes(b);
-    return do_uncompress(
-      // NOLINTNEXTLINE
-      reinterpret_cast<const char*>(linearized.data()),
-      linearized.size());
+    return ret;
 }
 } // namespace compression::internal
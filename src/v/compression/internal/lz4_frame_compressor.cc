@@ -9,12 +9,9 @@
 
 #include "compression/internal/lz4_frame_compressor.h"
 
-#include "bytes/bytes.h"
-#include "compression/logger.h"
+#include "likely.h"
 #include "static_deleter_fn.h"
 #include "units.h"
-#include "vassert.h"
-#include "vlog.h"
 
 #include <seastar/core/temporary_buffer.hh>
 
@@ -66,150 +63,129 @@ static lz4_decompression_ctx make_decompression_context() {
     return lz4_decompression_ctx(c);
 }
 
+// the (de)compression runs to completion without yielding, a single
+// context of each kind per shard is reused by all the calls
+static thread_local lz4_compression_ctx compression_ctx;
+static thread_local lz4_decompression_ctx decompression_ctx;
+// staging buffer of the output, copied to the fragments of the result
+static thread_local ss::temporary_buffer<char> staging;
+
+// input fed to the compressor at once, bounds the staging buffer size
+static constexpr size_t compress_step = 64_KiB;
+static constexpr size_t decompress_staging_size = 64_KiB;
+
+static LZ4F_cctx* compression_context() {
+    if (unlikely(!compression_ctx)) {
+        compression_ctx = make_compression_context();
+    }
+    return compression_ctx.get();
+}
+
+static LZ4F_dctx* decompression_context() {
+    if (unlikely(!decompression_ctx)) {
+        decompression_ctx = make_decompression_context();
+    }
+    return decompression_ctx.get();
+}
+
+static ss::temporary_buffer<char>& staging_buffer(size_t size) {
+    if (staging.size() < size) {
+        staging = ss::temporary_buffer<char>(size);
+    }
+    return staging;
+}
+
 iobuf lz4_frame_compressor::compress(const iobuf& b) {
-    auto ctx_ptr = make_compression_context();
-    LZ4F_compressionContext_t ctx = ctx_ptr.get();
+    // compressBegin resets the context of a previous, failed, frame
+    LZ4F_cctx* ctx = compression_context();
     /* Required by Kafka */
     LZ4F_preferences_t prefs;
     std::memset(&prefs, 0, sizeof(prefs));
     prefs.compressionLevel = 1; // default
     prefs.frameInfo = {
       .blockMode = LZ4F_blockIndependent, .contentSize = b.size_bytes()};
-    const size_t output_buffer_size = LZ4F_compressBound(b.size_bytes(), &prefs)
-                                      + lz4f_footer_size + lz4f_header_size;
-    check_lz4_error("lz4_compressbound erorr:{}", output_buffer_size);
-    ss::temporary_buffer<char> obuf(output_buffer_size);
+    const size_t bound = LZ4F_compressBound(compress_step, &prefs);
+    check_lz4_error("lz4_compressbound erorr:{}", bound);
+    auto& obuf = staging_buffer(bound + lz4f_footer_size + lz4f_header_size);
     char* out = obuf.get_write();
-    LZ4F_errorCode_t code = LZ4F_compressBegin(
-      ctx, out, output_buffer_size, &prefs);
+
+    iobuf ret;
+    LZ4F_errorCode_t code = LZ4F_compressBegin(ctx, out, obuf.size(), &prefs);
     check_lz4_error("lz4f_compressbegin error:{}", code);
+    ret.append(out, code);
 
-    // start after the bytes from compressBegin
-    size_t consumed_bytes = code;
+    // the fragments are compressed in place, the input is not linearized
     for (auto& frag : b) {
-        code = LZ4F_compressUpdate(
-          ctx,
-          // NOLINTNEXTLINE
-          out + consumed_bytes,
-          output_buffer_size - consumed_bytes,
-          frag.get(),
-          frag.size(),
-          nullptr);
-        check_lz4_error("lz4f_compressupdate error:{}", code);
-        consumed_bytes += code;
+        for (size_t pos = 0; pos < frag.size(); pos += compress_step) {
+            const size_t step = std::min(compress_step, frag.size() - pos);
+            code = LZ4F_compressUpdate(
+              ctx,
+              out,
+              obuf.size(),
+              // NOLINTNEXTLINE
+              frag.get() + pos,
+              step,
+              nullptr);
+            check_lz4_error("lz4f_compressupdate error:{}", code);
+            ret.append(out, code);
+        }
     }
-    code = LZ4F_compressEnd(
-      ctx,
-      // NOLINTNEXTLINE
-      out + consumed_bytes,
-      output_buffer_size - consumed_bytes,
-      nullptr);
+    code = LZ4F_compressEnd(ctx, out, obuf.size(), nullptr);
     check_lz4_error("lz4f_compressend:{}", code);
-    consumed_bytes += code;
-    obuf.trim(consumed_bytes);
-    iobuf ret;
-    ret.append(std::move(obuf));
+    ret.append(out, code);
     return ret;
 }
 
-inline static constexpr size_t
-compute_frame_uncompressed_size(size_t frame_size, size_t original) {
-    if (frame_size == 0 || frame_size > original * 255) {
-        return original * 4;
-    }
-    return frame_size;
-}
-
-static iobuf do_uncompressed(const char* src, const size_t src_size) {
-    auto ctx_ptr = make_decompression_context();
-    LZ4F_decompressionContext_t ctx = ctx_ptr.get();
-    LZ4F_frameInfo_t fi;
-    size_t in_sz = src_size;
-    LZ4F_errorCode_t code = LZ4F_getFrameInfo(ctx, &fi, src, &in_sz);
-    check_lz4_error("lz4f_getframeinfo error: {}", code);
-    size_t estimated_output_size = compute_frame_uncompressed_size(
-      fi.contentSize, src_size);
-    ss::temporary_buffer<char> obuf(estimated_output_size);
+static iobuf do_uncompress(LZ4F_dctx* ctx, const iobuf& b) {
+    auto& obuf = staging_buffer(decompress_staging_size);
     char* out = obuf.get_write();
-    /* Decompress input buffer t o output buffer until input is exhausted. */
-
-    size_t bytes_remaining = in_sz;
-    size_t consumed_bytes = 0;
-    while (bytes_remaining < src_size) {
-        size_t step_output_bytes = estimated_output_size - consumed_bytes;
-        size_t step_remaining_bytes = src_size - bytes_remaining;
-        code = LZ4F_decompress(
-          ctx,
-          // NOLINTNEXTLINE
-          out + consumed_bytes,
-          &step_output_bytes,
-          // NOLINTNEXTLINE
-          src + bytes_remaining,
-          &step_remaining_bytes,
-          nullptr);
-        check_lz4_error("lz4f_decompress error: {}", code);
-        vassert(
-          consumed_bytes + step_output_bytes <= estimated_output_size,
-          "Appended more bytes that allowed. Max:{}, consumed:{}",
-          estimated_output_size,
-          consumed_bytes + step_output_bytes);
-        vassert(
-          bytes_remaining <= src_size,
-          "Consumed more bytes than input. Max:{}, consumed:{}",
-          src_size,
-          bytes_remaining);
-        consumed_bytes += step_output_bytes;
-        bytes_remaining += step_remaining_bytes;
+    iobuf ret;
+    size_t consumed = 0;
+    // 0 once the end of the frame was decoded
+    size_t code = 1;
+    for (auto& frag : b) {
+        const char* src = frag.get();
+        size_t remaining = frag.size();
+        size_t out_size = 0;
+        // the decompressor may hold output the staging buffer had no room
+        // for, it is drained before moving to the next fragment
+        do {
+            size_t in_size = remaining;
+            out_size = obuf.size();
+            code = LZ4F_decompress(
+              ctx, out, &out_size, src, &in_size, nullptr);
+            check_lz4_error("lz4f_decompress error: {}", code);
+            ret.append(out, out_size);
+            // NOLINTNEXTLINE
+            src += in_size;
+            remaining -= in_size;
+            consumed += in_size;
+        } while (code != 0 && (remaining > 0 || out_size == obuf.size()));
         if (code == 0) {
             break;
         }
-        /* Need to grow output buffer, this shouldn't happen if
-         * contentSize was properly set. Happens all of the time with the
-         * console producer 2.3.1 and below*/
-        if (consumed_bytes == estimated_output_size) {
-            // TODO: add probes for re-growth
-            const size_t next_size = 1_KiB /*slack*/
-                                     + ((estimated_output_size * 3) + 1) / 2;
-            vlog(
-              complog.trace,
-              "Consumed bytes:{} has reached preallocated size. Growing to "
-              "size:{}",
-              consumed_bytes,
-              next_size);
-            ss::temporary_buffer<char> tmpo(next_size);
-            std::copy_n(obuf.get(), consumed_bytes, tmpo.get_write());
-            obuf = std::move(tmpo);
-            // update the pointer back to the original position
-            out = obuf.get_write();
-            estimated_output_size = next_size;
-        }
     }
 
-    if (unlikely(bytes_remaining < src_size)) {
+    if (unlikely(code != 0 || consumed < b.size_bytes())) {
         throw std::runtime_error(fmt::format(
           "lz4 error. could not consume all input bytes in decompression. "
-          "Input:{}, consumed:{}",
-          src_size,
-          bytes_remaining));
+          "Input:{}, consumed:{}, frame complete:{}",
+          b.size_bytes(),
+          consumed,
+          code == 0));
     }
-
-    obuf.trim(consumed_bytes);
-    iobuf ret;
-    ret.append(std::move(obuf));
     return ret;
 }
 
 iobuf lz4_frame_compressor::uncompress(const iobuf& b) {
-    if (std::distance(b.begin(), b.end()) == 1) {
-        return do_uncompressed(b.begin()->get(), b.size_bytes());
+    LZ4F_dctx* ctx = decompression_context();
+    try {
+        return do_uncompress(ctx, b);
+    } catch (...) {
+        // the context is only reset by itself at the end of a frame
+        LZ4F_resetDecompressionContext(ctx);
+        throw;
     }
-    // linearize buffer
-    // TODO: optimize iobuf
-    auto linearized = iobuf_to_bytes(b);
-    return do_uncompressed(
-      // NOLINTNEXTLINE
-      reinterpret_cast<const char*>(linearized.data()),
-      linearized.size());
 }
 
 } // namespace compression::internal
@@ -43,6 +43,17 @@ size_t find_max_size_in_frags(const iobuf& x) {
     return snappy::MaxCompressedLength(ret);
 }
 
+// the (de)compression runs to completion without yielding, the staging
+// buffer of the shard is reused by all the calls
+static thread_local ss::temporary_buffer<char> staging;
+
+static ss::temporary_buffer<char>& staging_buffer(size_t size) {
+    if (staging.size() < size) {
+        staging = ss::temporary_buffer<char>(size);
+    }
+    return staging;
+}
+
 template<typename T, typename = std::enable_if_t<std::is_integral_v<T>, T>>
 void append_be(iobuf& o, T t) {
     auto x = ss::cpu_to_be(t);
@@ -61,8 +72,7 @@ iobuf snappy_java_compressor::compress(const iobuf& x) {
       snappy_magic::java_magic.data(), snappy_magic::java_magic.size());
     append_le(ret, snappy_magic::default_version);
     append_le(ret, snappy_magic::min_compatible_version);
-    // staging buffer
-    ss::temporary_buffer<char> obuf(find_max_size_in_frags(x));
+    auto& obuf = staging_buffer(find_max_size_in_frags(x));
     for (const auto& f : x) {
         // do compression
         size_t omax = obuf.size();
@@ -98,30 +108,34 @@ iobuf snappy_java_compressor::uncompress(const iobuf& x) {
     iobuf ret;
     const size_t input_bytes = x.size_bytes();
     while (iter.bytes_consumed() != input_bytes) {
-        auto compressed_length = iter.consume_be_type<int32_t>();
-        auto chunk = ss::uninitialized_string<bytes>(compressed_length);
-        iter.consume_to(chunk.size(), chunk.data());
+        const auto compressed_length = iter.consume_be_type<int32_t>();
+        if (unlikely(
+              compressed_length < 0
+              || size_t(compressed_length)
+                   > input_bytes - iter.bytes_consumed())) {
+            throw std::runtime_error(fmt::format(
+              "snappy: invalid frame length: {}, remaining bytes: {}",
+              compressed_length,
+              input_bytes - iter.bytes_consumed()));
+        }
+        // snappy decompresses contiguous frames, they are staged
+        auto& chunk = staging_buffer(compressed_length);
+        iter.consume_to(compressed_length, chunk.get_write());
         size_t output_size = 0;
         if (unlikely(!::snappy::GetUncompressedLength(
-              // NOLINTNEXTLINE
-              reinterpret_cast<const char*>(chunk.data()),
-              chunk.size(),
-              &output_size))) {
+              chunk.get(), compressed_length, &output_size))) {
             throw std::runtime_error(fmt::format(
               "Could not find uncompressed size from input buffer of size: {}",
-              chunk.size()));
+              compressed_length));
         }
         auto ph = ret.reserve(output_size);
         char* output = ph.mutable_index();
         if (!::snappy::RawUncompress(
-              // NOLINTNEXTLINE
-              reinterpret_cast<const char*>(chunk.data()),
-              chunk.size(),
-              output)) {
+              chunk.get(), compressed_length, output)) {
             throw std::runtime_error(fmt_with_ctx(
               fmt::format,
               "snappy: Could not decompress frame: {}, from:{}",
-              chunk.size(),
+              compressed_length,
               x));
         }
     }
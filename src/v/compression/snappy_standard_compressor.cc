@@ -9,71 +9,91 @@
 
 #include "compression/snappy_standard_compressor.h"
 
-#include "bytes/bytes.h"
-#include "likely.h"
+#include "bytes/iobuf.h"
 
 #include <fmt/format.h>
 
+#include <snappy-sinksource.h>
 #include <snappy.h>
 
 namespace compression {
 
-inline iobuf do_compress(const char* src, size_t src_size) {
-    size_t max = snappy::MaxCompressedLength(src_size);
-    iobuf ret;
-    auto ph = ret.reserve(max);
-    char* output = ph.mutable_index();
-    snappy::RawCompress(src, src_size, output, &max);
-    ret.trim_back(ret.size_bytes() - max);
-    return ret;
-}
+namespace {
+/// reads the fragments of the iobuf in place
+class iobuf_source final : public snappy::Source {
+public:
+    explicit iobuf_source(const iobuf& b)
+      : _it(b.cbegin())
+      , _end(b.cend())
+      , _available(b.size_bytes()) {}
 
-iobuf snappy_standard_compressor::compress(const iobuf& b) {
-    if (std::distance(b.begin(), b.end()) == 1) {
-        return do_compress(b.begin()->get(), b.size_bytes());
+    size_t Available() const final { return _available; }
+
+    const char* Peek(size_t* len) final {
+        // snappy expects bytes as long as some are available
+        while (_it != _end && _pos == _it->size()) {
+            ++_it;
+            _pos = 0;
+        }
+        if (_it == _end) {
+            *len = 0;
+            return nullptr;
+        }
+        *len = _it->size() - _pos;
+        // NOLINTNEXTLINE
+        return _it->get() + _pos;
     }
-    // TODO: use snappy::Source interface instead
-    auto linearized = iobuf_to_bytes(b);
-    return do_compress(
-      // NOLINTNEXTLINE
-      reinterpret_cast<const char*>(linearized.data()),
-      linearized.size());
-}
 
-iobuf do_uncompressed(const char* src, size_t src_size) {
-    size_t output_size = 0;
-    if (unlikely(
-          !::snappy::GetUncompressedLength(src, src_size, &output_size))) {
-        throw std::runtime_error(fmt::format(
-          "Could not find uncompressed size from input buffer of size: {}",
-          src_size));
+    void Skip(size_t n) final {
+        _available -= n;
+        while (n > 0) {
+            const size_t left = _it->size() - _pos;
+            if (n < left) {
+                _pos += n;
+                return;
+            }
+            n -= left;
+            ++_it;
+            _pos = 0;
+        }
     }
+
+private:
+    iobuf::const_iterator _it;
+    iobuf::const_iterator _end;
+    size_t _pos{0};
+    size_t _available;
+};
+
+/// appends the output to the iobuf, in fragments of its growth policy
+class iobuf_sink final : public snappy::Sink {
+public:
+    explicit iobuf_sink(iobuf& out)
+      : _out(out) {}
+
+    void Append(const char* bytes, size_t n) final { _out.append(bytes, n); }
+
+private:
+    iobuf& _out;
+};
+} // namespace
+
+iobuf snappy_standard_compressor::compress(const iobuf& b) {
     iobuf ret;
-    if (output_size == 0) {
-        // empty frame
-        return ret;
-    }
-    auto ph = ret.reserve(output_size);
-    char* output = ph.mutable_index();
-    if (!::snappy::RawUncompress(src, src_size, output)) {
-        throw std::runtime_error(fmt::format(
-          "snappy: Could not decompress input size: {}, to output size:{}",
-          src_size,
-          output_size));
-    }
+    iobuf_source source(b);
+    iobuf_sink sink(ret);
+    snappy::Compress(&source, &sink);
     return ret;
 }
 
 iobuf snappy_standard_compressor::uncompress(const iobuf& b) {
-    if (std::distance(b.begin(), b.end()) == 1) {
-        return do_uncompressed(b.begin()->get(), b.size_bytes());
+    iobuf ret;
+    iobuf_source source(b);
+    iobuf_sink sink(ret);
+    if (!::snappy::Uncompress(&source, &sink)) {
+        throw std::runtime_error(fmt::format(
+          "snappy: Could not decompress input size: {}", b.size_bytes()));
     }
-    // linearize buffer
-    // TODO: use snappy::Sink interface instead
-    auto linearized = iobuf_to_bytes(b);
-    return do_uncompressed(
-      // NOLINTNEXTLINE
-      reinterpret_cast<const char*>(linearized.data()),
-      linearized.size());
+    return ret;
 }
 } // namespace compression
@@ -17,6 +17,7 @@
 #include "vlog.h"
 
 #include <seastar/core/aligned_buffer.hh>
+#include <seastar/core/thread.hh>
 
 #include <fmt/format.h>
 
@@ -39,6 +40,9 @@ static void throw_if_error(size_t rc) {
 static thread_local size_t dctx_workspace_size = 0;
 static thread_local std::unique_ptr<char[], ss::free_deleter> dctx_workspace;
 static thread_local ss::temporary_buffer<char> d_buffer;
+// compression context and output staging buffer
+static thread_local stream_zstd::zstd_compress_ctx cctx;
+static thread_local ss::temporary_buffer<char> c_buffer;
 
 void stream_zstd::init_workspace(size_t size) {
     if (!dctx_workspace) {
@@ -53,17 +57,15 @@ void stream_zstd::init_workspace(size_t size) {
     }
 }
 
-void stream_zstd::reset_compressor() {
-    _compress.reset(ZSTD_createCCtx());
-    if (!_compress) {
-        throw std::bad_alloc{};
-    }
-}
-stream_zstd::zstd_compress_ctx& stream_zstd::compressor() {
-    if (!_compress) {
-        reset_compressor();
+ZSTD_CCtx* stream_zstd::compressor() {
+    if (unlikely(!cctx)) {
+        cctx.reset(ZSTD_createCCtx());
+        if (!cctx) {
+            throw std::bad_alloc{};
+        }
+        c_buffer = ss::temporary_buffer<char>(64_KiB);
     }
-    return _compress;
+    return cctx.get();
 }
 
 ZSTD_DCtx* stream_zstd::decompressor() {
@@ -81,29 +83,75 @@ ZSTD_DCtx* stream_zstd::decompressor() {
     return ctx;
 }
 
-iobuf stream_zstd::do_compress(const iobuf& x) {
-    reset_compressor();
-    ZSTD_CCtx* ctx = compressor().get();
+/// \brief compresses the payload with the context, maybe_yield is invoked
+/// between the steps of the stream
+template<typename Yield>
+static iobuf compress_with(
+  ZSTD_CCtx* ctx,
+  ss::temporary_buffer<char>& obuf,
+  const iobuf& x,
+  const ZSTD_CDict* cdict,
+  Yield&& maybe_yield) {
+    // drops the session of a previous compression that failed, keeps the
+    // parameters and the allocated workspace
+    throw_if_error(ZSTD_CCtx_reset(ctx, ZSTD_reset_session_only));
+    // the dictionary is a parameter, null drops the one of the last stream
+    throw_if_error(ZSTD_CCtx_refCDict(ctx, cdict));
     // NOTE: always enable content size. **decompression** depends on this
     throw_if_error(ZSTD_CCtx_setPledgedSrcSize(ctx, x.size_bytes()));
-    // zstd requires linearized memory
-    ss::temporary_buffer<char> obuf(ZSTD_compressBound(x.size_bytes()));
+    // the output is staged and copied to the fragments of the result
     ZSTD_outBuffer out = {
       .dst = obuf.get_write(), .size = obuf.size(), .pos = 0};
+    iobuf ret;
+    auto drain = [&ret, &obuf, &out] {
+        ret.append(obuf.get(), out.pos);
+        out.pos = 0;
+    };
 
     for (auto& frag : x) {
         ZSTD_inBuffer in = {.src = frag.get(), .size = frag.size(), .pos = 0};
-        auto mode = ZSTD_e_flush;
-        throw_if_error(ZSTD_compressStream2(ctx, &out, &in, mode));
+        while (in.pos != in.size) {
+            throw_if_error(
+              ZSTD_compressStream2(ctx, &out, &in, ZSTD_e_continue));
+            if (out.pos == out.size) {
+                drain();
+                maybe_yield();
+            }
+        }
+        maybe_yield();
     }
     // Must happen outside of loop to encode empty-buffer sizes
-    ZSTD_endStream(ctx, &out);
-    iobuf ret;
-    obuf.trim(out.pos);
-    ret.append(std::move(obuf));
+    ZSTD_inBuffer end = {.src = nullptr, .size = 0, .pos = 0};
+    size_t remaining = 0;
+    do {
+        remaining = ZSTD_compressStream2(ctx, &out, &end, ZSTD_e_end);
+        throw_if_error(remaining);
+        drain();
+        maybe_yield();
+    } while (remaining != 0);
     return ret;
 }
 
+iobuf stream_zstd::do_compress(const iobuf& x) {
+    return compress_with(compressor(), c_buffer, x, nullptr, [] {});
+}
+
+iobuf stream_zstd::compress(const iobuf& x, const zstd_dictionary& dict) {
+    return compress_with(compressor(), c_buffer, x, dict.cdict(), [] {});
+}
+
+iobuf stream_zstd::compress_preemptible(const iobuf& x) {
+    // the stream yields in the middle of the frame, the context of the
+    // shard is left to the streams that don't
+    zstd_compress_ctx ctx(ZSTD_createCCtx());
+    if (!ctx) {
+        throw std::bad_alloc{};
+    }
+    ss::temporary_buffer<char> obuf(64_KiB);
+    return compress_with(
+      ctx.get(), obuf, x, nullptr, [] { ss::thread::maybe_yield(); });
+}
+
 size_t find_zstd_size(const iobuf& x) {
     auto consumer = iobuf::iterator_consumer(x.cbegin(), x.cend());
     // defined in zstd.h ONLY under static allocation - sigh
@@ -149,31 +197,89 @@ size_t decompression_step(const iobuf& x) {
     return std::min(64_KiB, ret);
 }
 
-iobuf stream_zstd::do_uncompress(const iobuf& x) {
-    if (unlikely(x.empty())) {
-        throw std::runtime_error(
-          "Asked to stream_zstd::uncompress empty buffer");
+/// \brief decompresses the payload with the context, maybe_yield is invoked
+/// between the steps of the stream
+template<typename Yield>
+static iobuf uncompress_with(
+  ZSTD_DCtx* dctx,
+  ss::temporary_buffer<char>& obuf,
+  const iobuf& x,
+  const ZSTD_DDict* ddict,
+  Yield&& maybe_yield) {
+    if (ddict) {
+        throw_if_error(ZSTD_DCtx_refDDict(dctx, ddict));
     }
-    ZSTD_DCtx* dctx = decompressor();
     iobuf ret;
-    ss::temporary_buffer<char>& obuf = d_buffer;
     ZSTD_outBuffer out = {
       .dst = obuf.get_write(), .size = obuf.size(), .pos = 0};
+    auto drain = [&ret, &obuf, &out] {
+        ret.append(obuf.get(), out.pos);
+        out.pos = 0;
+    };
+    // 0 once the frame is fully decoded and flushed
+    size_t remaining = 0;
     for (auto& ibuf : x) {
         ZSTD_inBuffer in = {.src = ibuf.get(), .size = ibuf.size(), .pos = 0};
         while (in.pos != in.size) {
-            auto err = ZSTD_decompressStream(dctx, &out, &in);
-            if (in.pos != in.size && out.pos == out.size) {
-                ret.append(obuf.get(), obuf.size());
-                out.size = obuf.size();
-                out.pos = 0;
-            } else {
-                throw_if_error(err);
+            remaining = ZSTD_decompressStream(dctx, &out, &in);
+            throw_if_error(remaining);
+            if (out.pos == out.size) {
+                drain();
+                maybe_yield();
             }
         }
+        maybe_yield();
+    }
+    // the decoder may hold output it had no room for
+    while (remaining != 0) {
+        ZSTD_inBuffer in = {.src = nullptr, .size = 0, .pos = 0};
+        remaining = ZSTD_decompressStream(dctx, &out, &in);
+        throw_if_error(remaining);
+        if (out.pos == 0) {
+            break;
+        }
+        drain();
+        maybe_yield();
+    }
+    drain();
+    if (unlikely(remaining != 0)) {
+        throw std::runtime_error(fmt::format(
+          "zstd error: truncated frame of {} bytes", x.size_bytes()));
     }
-    ret.append(obuf.get(), out.pos);
     return ret;
 }
 
+iobuf stream_zstd::do_uncompress(const iobuf& x) {
+    if (unlikely(x.empty())) {
+        throw std::runtime_error(
+          "Asked to stream_zstd::uncompress empty buffer");
+    }
+    return uncompress_with(decompressor(), d_buffer, x, nullptr, [] {});
+}
+
+iobuf stream_zstd::uncompress(const iobuf& x, const zstd_dictionary& dict) {
+    if (unlikely(x.empty())) {
+        throw std::runtime_error(
+          "Asked to stream_zstd::uncompress empty buffer");
+    }
+    return uncompress_with(
+      decompressor(), d_buffer, x, dict.ddict(), [] {});
+}
+
+iobuf stream_zstd::uncompress_preemptible(const iobuf& x) {
+    if (unlikely(x.empty())) {
+        throw std::runtime_error(
+          "Asked to stream_zstd::uncompress empty buffer");
+    }
+    // the workspace of the shard is static, the stream that yields in the
+    // middle of the frame allocates its own context
+    zstd_decompress_ctx dctx(ZSTD_createDCtx());
+    if (!dctx) {
+        throw std::bad_alloc{};
+    }
+    ss::temporary_buffer<char> obuf(64_KiB);
+    return uncompress_with(
+      dctx.get(), obuf, x, nullptr, [] { ss::thread::maybe_yield(); });
+}
+
 } // namespace compression
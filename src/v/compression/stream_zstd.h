@@ -11,6 +11,7 @@
 
 #pragma once
 #include "bytes/iobuf.h"
+#include "compression/zstd_dictionary.h"
 #include "static_deleter_fn.h"
 
 #include <memory>
@@ -23,23 +24,33 @@ public:
       ZSTD_CCtx,
       // wrap ZSTD C API
       static_sized_deleter_fn<ZSTD_CCtx, &ZSTD_freeCCtx>>;
+    using zstd_decompress_ctx = std::unique_ptr<
+      ZSTD_DCtx,
+      static_sized_deleter_fn<ZSTD_DCtx, &ZSTD_freeDCtx>>;
 
     iobuf compress(const iobuf& b) { return do_compress(b); }
     iobuf uncompress(const iobuf& b) { return do_uncompress(b); }
     iobuf compress(iobuf&& b) { return do_compress(b); }
     iobuf uncompress(iobuf&& b) { return do_uncompress(b); }
 
+    /// \brief the frame can only be decompressed with the same dictionary
+    iobuf compress(const iobuf&, const zstd_dictionary&);
+    iobuf uncompress(const iobuf&, const zstd_dictionary&);
+
     static void init_workspace(size_t);
 
+    /// \brief must run in a seastar thread, yields to the other tasks of
+    /// the shard as it goes. the streams allocate their own contexts
+    static iobuf compress_preemptible(const iobuf&);
+    static iobuf uncompress_preemptible(const iobuf&);
+
 private:
     iobuf do_compress(const iobuf&);
     iobuf do_uncompress(const iobuf&);
 
-    void reset_compressor();
-    zstd_compress_ctx& compressor();
-    ZSTD_DCtx* decompressor();
-
-    zstd_compress_ctx _compress{nullptr};
+    /// the contexts of the shard, reused by all the streams
+    static ZSTD_CCtx* compressor();
+    static ZSTD_DCtx* decompressor();
 };
 
 } // namespace compression
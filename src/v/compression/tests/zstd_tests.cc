@@ -7,12 +7,14 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 
+#include "compression/async_compressor.h"
 #include "compression/internal/gzip_compressor.h"
 #include "compression/internal/lz4_frame_compressor.h"
 #include "compression/internal/snappy_java_compressor.h"
 #include "compression/internal/zstd_compressor.h"
 #include "compression/snappy_standard_compressor.h"
 #include "compression/stream_zstd.h"
+#include "compression/zstd_dictionary.h"
 #include "random/generators.h"
 #include "units.h"
 #include "vassert.h"
@@ -85,3 +87,132 @@ SEASTAR_THREAD_TEST_CASE(gzip_test) {
     using fn = compression::internal::gzip_compressor;
     roundtrip_compression(fn::compress, fn::uncompress);
 }
+
+/// copy of the buffer in fragments of 1000 bytes, the codecs cross the
+/// fragment boundaries
+static iobuf fragmented_copy(const iobuf& b) {
+    const auto data = iobuf_to_bytes(b);
+    iobuf ret;
+    for (size_t pos = 0; pos < data.size(); pos += 1000) {
+        const auto len = std::min<size_t>(1000, data.size() - pos);
+        iobuf frag;
+        frag.append(ss::temporary_buffer<char>(
+          // NOLINTNEXTLINE
+          reinterpret_cast<const char*>(data.data()) + pos,
+          len));
+        ret.append_fragments(std::move(frag));
+    }
+    return ret;
+}
+
+static iobuf gen_fragmented() {
+    iobuf data;
+    const auto str = random_generators::gen_alphanum_string(1_MiB);
+    data.append(str.data(), str.size());
+    return fragmented_copy(data);
+}
+
+template<typename CompressFunc, typename DecompressFunc>
+inline void
+fragmented_roundtrip(CompressFunc&& comp_fn, DecompressFunc&& decomp_fn) {
+    const auto buf = gen_fragmented();
+    // the second round reuses the contexts of the first one
+    for (int i = 0; i < 2; ++i) {
+        auto cbuf = comp_fn(buf);
+        BOOST_CHECK_EQUAL(decomp_fn(cbuf), buf);
+        // the compressed input is fragmented as well
+        BOOST_CHECK_EQUAL(decomp_fn(fragmented_copy(cbuf)), buf);
+    }
+    // a failed decompression doesn't break the next one
+    auto cbuf = comp_fn(buf);
+    auto truncated = cbuf.share(0, cbuf.size_bytes() / 2);
+    BOOST_CHECK_THROW(decomp_fn(truncated), std::exception);
+    BOOST_CHECK_EQUAL(decomp_fn(cbuf), buf);
+}
+
+SEASTAR_THREAD_TEST_CASE(fragmented_roundtrip_test) {
+    using namespace compression::internal;
+    fragmented_roundtrip(
+      lz4_frame_compressor::compress, lz4_frame_compressor::uncompress);
+    fragmented_roundtrip(
+      gzip_compressor::compress, gzip_compressor::uncompress);
+    fragmented_roundtrip(
+      zstd_compressor::compress, zstd_compressor::uncompress);
+    fragmented_roundtrip(
+      compression::snappy_standard_compressor::compress,
+      compression::snappy_standard_compressor::uncompress);
+}
+
+SEASTAR_THREAD_TEST_CASE(async_compressor_offload_test) {
+    using compression::async_compressor;
+    using compression::type;
+    async_compressor::start(ss::default_scheduling_group(), 64_KiB, true);
+    const auto large = gen_fragmented();
+    const auto small = gen(4_KiB);
+    for (auto t : {type::zstd, type::lz4, type::gzip, type::snappy}) {
+        // the small payload doesn't wait for the offloaded one
+        auto large_f = async_compressor::compress(large, t);
+        auto small_f = async_compressor::compress(small, t);
+        BOOST_CHECK(small_f.available());
+        auto cs = small_f.get0();
+        auto cl = large_f.get0();
+        BOOST_CHECK_EQUAL(async_compressor::uncompress(cl, t).get0(), large);
+        BOOST_CHECK_EQUAL(async_compressor::uncompress(cs, t).get0(), small);
+        // the preemptible streams are compatible with the inline ones
+        BOOST_CHECK_EQUAL(compression::compressor::uncompress(cl, t), large);
+        BOOST_CHECK_EQUAL(
+          async_compressor::uncompress(
+            compression::compressor::compress(large, t), t)
+            .get0(),
+          large);
+    }
+    auto cl = async_compressor::compress(large, type::zstd).get0();
+    auto truncated = cl.share(0, cl.size_bytes() / 2);
+    BOOST_CHECK_THROW(
+      async_compressor::uncompress(truncated, type::zstd).get(),
+      std::exception);
+    async_compressor::stop().get();
+}
+
+/// small json record, the keys are shared by all the records
+static iobuf json_record(size_t i) {
+    const auto str = fmt::format(
+      R"({{"id":{},"user":"{}","event":"page_view","status":"active",)"
+      R"("region":"us-east-1","tags":["a","b"],"payload":"{}"}})",
+      i,
+      random_generators::gen_alphanum_string(8),
+      random_generators::gen_alphanum_string(64));
+    iobuf ret;
+    ret.append(str.data(), str.size());
+    return ret;
+}
+
+SEASTAR_THREAD_TEST_CASE(zstd_dictionary_test) {
+    std::vector<iobuf> samples;
+    for (size_t i = 0; i < 2000; ++i) {
+        samples.push_back(json_record(i));
+    }
+    auto dict = compression::zstd_dictionary::train(samples, 4_KiB);
+    BOOST_REQUIRE_NE(dict.id(), 0);
+    BOOST_REQUIRE_LE(dict.raw().size(), 4_KiB);
+
+    compression::stream_zstd fn;
+    const auto record = json_record(5000);
+    const auto plain = fn.compress(record);
+    const auto primed = fn.compress(record, dict);
+    BOOST_REQUIRE_LT(primed.size_bytes(), plain.size_bytes());
+    BOOST_REQUIRE_EQUAL(
+      compression::zstd_dictionary::frame_dictionary_id(primed), dict.id());
+    BOOST_REQUIRE_EQUAL(
+      compression::zstd_dictionary::frame_dictionary_id(plain), 0);
+    BOOST_REQUIRE_EQUAL(fn.uncompress(primed, dict), record);
+    // the frame can't be decoded without its dictionary
+    BOOST_REQUIRE_THROW(fn.uncompress(primed), std::exception);
+    // the streams that follow don't use the dictionary
+    BOOST_REQUIRE_EQUAL(fn.uncompress(fn.compress(record)), record);
+
+    // a dictionary loaded from the persisted bytes is the same
+    compression::zstd_dictionary loaded(dict.raw());
+    BOOST_REQUIRE_EQUAL(loaded.id(), dict.id());
+    BOOST_REQUIRE_EQUAL(fn.uncompress(primed, loaded), record);
+}
@@ -0,0 +1,70 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "compression/zstd_dictionary.h"
+
+#include "units.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <zdict.h>
+
+namespace compression {
+
+zstd_dictionary zstd_dictionary::train(
+  const std::vector<iobuf>& samples, size_t max_size) {
+    // the trainer reads the samples back to back
+    size_t total = 0;
+    for (const auto& s : samples) {
+        total += s.size_bytes();
+    }
+    bytes buffer(bytes::initialized_later{}, total);
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    size_t pos = 0;
+    for (const auto& s : samples) {
+        iobuf::iterator_consumer(s.cbegin(), s.cend())
+          .consume_to(s.size_bytes(), buffer.data() + pos);
+        pos += s.size_bytes();
+        sizes.push_back(s.size_bytes());
+    }
+
+    bytes dict(bytes::initialized_later{}, max_size);
+    const size_t rc = ZDICT_trainFromBuffer(
+      dict.data(), dict.size(), buffer.data(), sizes.data(), sizes.size());
+    if (ZDICT_isError(rc)) {
+        throw std::runtime_error(fmt::format(
+          "Cannot train zstd dictionary from {} samples of {} bytes: {}",
+          samples.size(),
+          total,
+          ZDICT_getErrorName(rc)));
+    }
+    dict.resize(rc);
+    return zstd_dictionary(std::move(dict));
+}
+
+zstd_dictionary::zstd_dictionary(bytes raw, int level)
+  : _raw(std::move(raw))
+  , _id(ZDICT_getDictID(_raw.data(), _raw.size()))
+  , _cdict(ZSTD_createCDict(_raw.data(), _raw.size(), level))
+  , _ddict(ZSTD_createDDict(_raw.data(), _raw.size())) {
+    if (!_cdict || !_ddict) {
+        throw std::bad_alloc{};
+    }
+}
+
+uint32_t zstd_dictionary::frame_dictionary_id(const iobuf& x) {
+    std::array<char, ZSTD_FRAMEHEADERSIZE_MAX> hdr{};
+    const size_t len = std::min(hdr.size(), x.size_bytes());
+    iobuf::iterator_consumer(x.cbegin(), x.cend()).consume_to(len, hdr.data());
+    return ZSTD_getDictID_fromFrame(hdr.data(), len);
+}
+
+} // namespace compression
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "bytes/bytes.h"
+#include "bytes/iobuf.h"
+#include "static_deleter_fn.h"
+#include "units.h"
+
+#include <memory>
+#include <vector>
+#include <zstd.h>
+
+namespace compression {
+
+/**
+ * zstd dictionary trained from sample payloads.
+ *
+ * Small payloads of the same shape, like json records, have little in
+ * common within one batch and compress poorly. The dictionary primes the
+ * stream with what they have in common across batches.
+ *
+ * The frames compressed with a dictionary carry its id and can only be
+ * decompressed with the same dictionary, the raw bytes are what has to be
+ * persisted next to the payloads. The dictionary is immutable and can be
+ * shared by the streams of the shard.
+ */
+class zstd_dictionary {
+public:
+    /// \brief trains a dictionary of at most max_size bytes. CPU bound, in
+    /// the order of a second per MiB of samples
+    ///
+    /// throws if the samples are too few or too similar to train on
+    static zstd_dictionary
+    train(const std::vector<iobuf>& samples, size_t max_size = 64_KiB);
+
+    /// \brief loads a dictionary persisted with raw()
+    explicit zstd_dictionary(bytes raw, int level = ZSTD_CLEVEL_DEFAULT);
+
+    /// \brief the id stored in the frames compressed with the dictionary
+    uint32_t id() const { return _id; }
+    const bytes& raw() const { return _raw; }
+
+    const ZSTD_CDict* cdict() const { return _cdict.get(); }
+    const ZSTD_DDict* ddict() const { return _ddict.get(); }
+
+    /// \brief id of the dictionary the zstd frame was compressed with, 0
+    /// when none was used
+    static uint32_t frame_dictionary_id(const iobuf&);
+
+private:
+    bytes _raw;
+    uint32_t _id{0};
+    std::unique_ptr<
+      ZSTD_CDict,
+      static_sized_deleter_fn<ZSTD_CDict, &ZSTD_freeCDict>>
+      _cdict;
+    std::unique_ptr<
+      ZSTD_DDict,
+      static_sized_deleter_fn<ZSTD_DDict, &ZSTD_freeDDict>>
+      _ddict;
+};
+
+} // namespace compression
@@ -22,6 +22,13 @@ configuration::configuration()
     "data_directory",
     "Place where redpanda will keep the data",
     required::yes)
+  , additional_data_directories(
+      *this,
+      "additional_data_directories",
+      "Directories on other disks where new partitions are placed along with "
+      "data_directory, on the one with the least data",
+      required::no,
+      {})
   , developer_mode(
       *this,
       "developer_mode",
@@ -29,6 +36,24 @@ configuration::configuration()
       "production use",
       required::no,
       false)
+  , disk_benchmark(
+      *this,
+      "disk_benchmark",
+      "Measure the write bandwidth, the flush latency and the read IOPS of "
+      "the data directories at startup and derive the write behind, "
+      "fallocation step, read ahead and background controller target from "
+      "them. The profile is saved in the data directory, remove the "
+      "disk_profile file to measure it again",
+      required::no,
+      false)
+  , io_fault_injection_enabled(
+      *this,
+      "io_fault_injection_enabled",
+      "Allow the admin API to inject latency and bandwidth faults in the "
+      "segment writes, the RPC sends and the object store requests, for the "
+      "performance tests. Not recommended for production use",
+      required::no,
+      false)
   , log_segment_size(
       *this,
       "log_segment_size",
@@ -61,6 +86,22 @@ configuration::configuration()
       required::no,
       tls_config(),
       tls_config::validate)
+  , rpc_client_connections_per_peer(
+      *this,
+      "rpc_client_connections_per_peer",
+      "Number of connections each shard opens to the peers it owns, the "
+      "heartbeats, the replication and the recovery of raft groups are sent "
+      "over separate connections when there are more than one",
+      required::no,
+      3)
+  , rpc_cork_delay_us(
+      *this,
+      "rpc_cork_delay_us",
+      "When set, the internal RPC writes of an idle connection are delayed by "
+      "up to this many microseconds and coalesced with the writes issued in "
+      "the meantime into a single socket write",
+      required::no,
+      std::nullopt)
   , enable_coproc(
       *this, "enable_coproc", "Enable coprocessing mode", required::no, false)
   , coproc_supervisor_server(
@@ -116,6 +157,44 @@ configuration::configuration()
       "raft heartbeat RPC timeout",
       required::no,
       3s)
+  , raft_enable_heartbeat_aggregation(
+      *this,
+      "raft_enable_heartbeat_aggregation",
+      "Send the raft heartbeats of all of the cores to a node in a single "
+      "request per heartbeat interval instead of one request per core",
+      required::no,
+      true)
+  , raft_enable_quiescence(
+      *this,
+      "raft_enable_quiescence",
+      "Stop sending heartbeats of idle raft groups and only track the "
+      "liveness of their leaders and followers. Must be enabled only when all "
+      "the nodes of the cluster support it",
+      required::no,
+      false)
+  , raft_quiesce_delay_ms(
+      *this,
+      "raft_quiesce_delay_ms",
+      "Time after which a raft group without appends whose followers are up "
+      "to date is quiesced",
+      required::no,
+      10s)
+  , raft_enable_leader_leases(
+      *this,
+      "raft_enable_leader_leases",
+      "Serve linearizable reads on the leader without a round of heartbeats "
+      "while the majority acknowledged its requests within the election "
+      "timeout. Restarted nodes grant no votes for an election timeout. Must "
+      "be enabled only when all the nodes of the cluster support it",
+      required::no,
+      false)
+  , raft_leader_lease_clock_drift_ms(
+      *this,
+      "raft_leader_lease_clock_drift_ms",
+      "Margin the leader lease is shortened by to cover the clock drift "
+      "between the leader and the followers",
+      required::no,
+      200ms)
   , seed_servers(
       *this,
       "seed_servers",
@@ -192,6 +271,76 @@ configuration::configuration()
       "Target quota byte rate (bytes per second) - 2GB default",
       required::no,
       2_GiB)
+  , target_quota_request_rate(
+      *this,
+      "target_quota_request_rate",
+      "Target quota request rate (requests per second) of a client id, not "
+      "limited by default",
+      required::no,
+      std::nullopt)
+  , target_quota_cpu_rate(
+      *this,
+      "target_quota_cpu_rate",
+      "Target quota of the cpu time spent handling the requests of a client "
+      "id, in microseconds per second of all the cores, not limited by "
+      "default",
+      required::no,
+      std::nullopt)
+  , quota_manager_balance_interval_ms(
+      *this,
+      "quota_manager_balance_interval_ms",
+      "Interval of the exchange of the client rates between the shards, "
+      "quotas are enforced per node",
+      required::no,
+      500ms)
+  , enable_kafka_connection_balancer(
+      *this,
+      "enable_kafka_connection_balancer",
+      "Close kafka connections of the shards having more connections than the "
+      "others, the clients reconnect to the least loaded shards",
+      required::no,
+      false)
+  , kafka_connection_balance_interval_ms(
+      *this,
+      "kafka_connection_balance_interval_ms",
+      "Interval of the comparison of the kafka connection counts of the shards",
+      required::no,
+      10s)
+  , kafka_connection_balance_tolerance(
+      *this,
+      "kafka_connection_balance_tolerance",
+      "Number of kafka connections a shard can have above the mean before "
+      "some are moved to other shards",
+      required::no,
+      2)
+  , kafka_slow_request_log_size(
+      *this,
+      "kafka_slow_request_log_size",
+      "Number of the slowest kafka requests of each window kept per shard "
+      "for the admin API, 0 disables it",
+      required::no,
+      10)
+  , kafka_slow_request_log_window_ms(
+      *this,
+      "kafka_slow_request_log_window_ms",
+      "Window of the slowest kafka requests kept per shard, the requests of "
+      "the current and of the previous window are reported",
+      required::no,
+      1min)
+  , scheduling_probe_interval_ms(
+      *this,
+      "scheduling_probe_interval_ms",
+      "Interval of the measure of the queueing delay of the scheduling "
+      "groups, 0 disables it",
+      required::no,
+      100ms)
+  , memory_balance_interval_ms(
+      *this,
+      "memory_balance_interval_ms",
+      "Interval of the moves of memory between the kafka, internal rpc and "
+      "segment appender chunks budgets of the shard, 0 disables it",
+      required::no,
+      0ms)
   , cluster_id(
       *this, "cluster_id", "Cluster identifier", required::no, std::nullopt)
   , rack(*this, "rack", "Rack identifier", required::no, std::nullopt)
@@ -207,6 +356,20 @@ configuration::configuration()
       "Disable registering metrics",
       required::no,
       false)
+  , aggregate_metrics(
+      *this,
+      "aggregate_metrics",
+      "Export the per-partition metrics summed per topic, the number of the "
+      "series no longer grows with the number of partitions",
+      required::no,
+      false)
+  , metrics_partition_allowlist(
+      *this,
+      "metrics_partition_allowlist",
+      "Topics that keep the per-partition metrics when aggregate_metrics is "
+      "enabled",
+      required::no,
+      {})
   , group_min_session_timeout_ms(
       *this,
       "group_min_session_timeout_ms",
@@ -243,6 +406,13 @@ configuration::configuration()
       "Interaval for metadata dissemination batching",
       required::no,
       3'000ms)
+  , metadata_dissemination_resync_interval_ms(
+      *this,
+      "metadata_dissemination_resync_interval_ms",
+      "Interval of fetching the leadership changes missed by the metadata "
+      "dissemination from another node",
+      required::no,
+      30'000ms)
   , metadata_dissemination_retry_delay_ms(
       *this,
       "metadata_dissemination_retry_delay_ms",
@@ -309,6 +479,14 @@ configuration::configuration()
       "alter configuration requst",
       required::no,
       5s)
+  , log_housekeeping_concurrency(
+      *this,
+      "log_housekeeping_concurrency",
+      "Number of logs of a shard garbage collected and compacted "
+      "concurrently, the dirtiest first, the compaction_key_map_memory is "
+      "split between them",
+      required::no,
+      2)
   , log_cleanup_policy(
       *this,
       "log_cleanup_policy",
@@ -348,6 +526,13 @@ configuration::configuration()
       false)
   , enable_transactions(
       *this, "enable_transactions", "Enable transactions", required::no, false)
+  , enable_follower_fetching(
+      *this,
+      "enable_follower_fetching",
+      "Serve fetch requests on the follower replicas and redirect the "
+      "consumers that set a rack id to a replica in the same rack",
+      required::no,
+      false)
   , delete_retention_ms(
       *this,
       "delete_retention_ms",
@@ -366,6 +551,28 @@ configuration::configuration()
       "max bytes per partition on disk before triggering a compaction",
       required::no,
       std::nullopt)
+  , memory_log_retention_bytes(
+      *this,
+      "memory_log_retention_bytes",
+      "Max bytes kept in memory per partition of the topics with the memory "
+      "storage engine and no retention.bytes, the oldest batches are evicted "
+      "past it",
+      required::no,
+      128_MiB)
+  , log_recompression_min_age_ms(
+      *this,
+      "log_recompression_min_age_ms",
+      "Age of the newest batch of a sealed segment past which the segment is "
+      "rewritten with the compression.type of its topic, 0 disables it",
+      required::no,
+      0ms)
+  , log_housekeeping_budget_ms(
+      *this,
+      "log_housekeeping_budget_ms",
+      "Time a housekeeping round spends on the due logs, the most urgent "
+      "first, before the others are left to the next round, 0 is unbounded",
+      required::no,
+      5s)
   , group_topic_partitions(
       *this,
       "group_topic_partitions",
@@ -384,6 +591,14 @@ configuration::configuration()
       "Replication factor for a transaction coordinator topic",
       required::no,
       1)
+  , transaction_coordinator_partitions(
+      *this,
+      "transaction_coordinator_partitions",
+      "Number of partitions of a transaction coordinator topic, the "
+      "transactions are spread between them by their transactional id. Only "
+      "used when the topic is created.",
+      required::no,
+      1)
   , id_allocator_replication(
       *this,
       "id_allocator_replication",
@@ -420,6 +635,13 @@ configuration::configuration()
       "Disable batch cache in log manager",
       required::no,
       false)
+  , batch_cache_protected_ratio(
+      *this,
+      "batch_cache_protected_ratio",
+      "Fraction of the batch cache reserved for batches that were read more "
+      "than once, 0 turns the cache into a plain LRU",
+      required::no,
+      0.8)
   , raft_election_timeout_ms(
       *this,
       "election_timeout_ms",
@@ -432,6 +654,14 @@ configuration::configuration()
       "Kafka group recovery timeout expressed in milliseconds",
       required::no,
       30'000ms)
+  , kafka_group_recovery_checkpoint_interval_ms(
+      *this,
+      "kafka_group_recovery_checkpoint_interval_ms",
+      "Interval of the local checkpoints of the consumer groups state, a new "
+      "group coordinator only replays the records appended since the last "
+      "checkpoint",
+      required::no,
+      5min)
   , replicate_append_timeout_ms(
       *this,
       "replicate_append_timeout_ms",
@@ -451,12 +681,98 @@ configuration::configuration()
       "Max size of requests cached for replication",
       required::no,
       1_MiB)
+  , raft_max_inflight_follower_append_requests(
+      *this,
+      "raft_max_inflight_follower_append_requests",
+      "Maximum number of append entries requests the leader keeps in flight "
+      "for a single follower while replicating",
+      required::no,
+      16)
+  , raft_max_inflight_snapshot_chunks(
+      *this,
+      "raft_max_inflight_snapshot_chunks",
+      "Maximum number of snapshot chunks the leader sends to a follower "
+      "without waiting for them to be acknowledged",
+      required::no,
+      4)
+  , raft_replicate_batcher_max_linger_ms(
+      *this,
+      "raft_replicate_batcher_max_linger_ms",
+      "Maximum time the raft replicate batcher holds writes to merge them "
+      "when they arrive faster than they are replicated, 0 disables lingering",
+      required::no,
+      1ms)
+  , raft_enable_partition_latency_histograms(
+      *this,
+      "raft_enable_partition_latency_histograms",
+      "Export the latency histograms of the replicate path stages for every "
+      "partition in addition to the shard wide ones",
+      required::no,
+      false)
   , raft_learner_recovery_rate(
       *this,
       "raft_learner_recovery_rate",
       "Raft learner recovery rate limit in bytes per sec",
       required::no,
       100_MiB)
+  , raft_learner_promotion_max_lag(
+      *this,
+      "raft_learner_promotion_max_lag",
+      "Number of offsets a learner may lag behind the leader commit index to "
+      "be promoted to a voter. Until then the learner recovers without "
+      "counting toward the quorum",
+      required::no,
+      0)
+  , raft_recovery_max_concurrent_reads(
+      *this,
+      "raft_recovery_max_concurrent_reads",
+      "Maximum number of follower recovery reads the node serves at the same "
+      "time, split evenly across the cores",
+      required::no,
+      64)
+  , raft_enable_recovery_delegation(
+      *this,
+      "raft_enable_recovery_delegation",
+      "Let the leader delegate the recovery of the committed entries of a "
+      "lagging follower to the up to date followers, spreading the recoveries "
+      "of the groups over their replicas",
+      required::no,
+      true)
+  , raft_recovery_delegation_max_bytes(
+      *this,
+      "raft_recovery_delegation_max_bytes",
+      "Maximum number of bytes a follower recovers on behalf of the leader "
+      "before handing the recovery back to it",
+      required::no,
+      32_MiB)
+  , raft_recovery_delegation_timeout_ms(
+      *this,
+      "raft_recovery_delegation_timeout_ms",
+      "Timeout of the recovery of a range of entries delegated to a follower",
+      required::no,
+      60s)
+  , raft_max_concurrent_elections(
+      *this,
+      "raft_max_concurrent_elections",
+      "Maximum number of raft groups of a core that run an election at the "
+      "same time. The other elections wait for their turn and are skipped if "
+      "a new leader is heard from in the meantime",
+      required::no,
+      64)
+  , raft_cross_rack_compression(
+      *this,
+      "raft_cross_rack_compression",
+      "Compress the append entries requests sent to the replicas in a "
+      "different rack",
+      required::no,
+      false)
+  , raft_cross_rack_compression_min_bytes(
+      *this,
+      "raft_cross_rack_compression_min_bytes",
+      "Minimum size of the uncompressed batches of an append entries request "
+      "sent to a replica in a different rack for the request to be compressed",
+      required::no,
+      32_KiB)
   , reclaim_min_size(
       *this,
       "reclaim_min_size",
@@ -543,6 +859,64 @@ configuration::configuration()
       "Maximum delay until buffered data is written",
       required::no,
       std::chrono::milliseconds(1s))
+  , segment_deletion_rate(
+      *this,
+      "segment_deletion_rate",
+      "Maximum bytes per second per shard of the segments removed by retention "
+      "and prefix truncation in the background, 0 disables the limit",
+      required::no,
+      1_GiB)
+  , segment_index_memory_limit(
+      *this,
+      "segment_index_memory_limit",
+      "Maximum memory used per shard by the offset indexes of the segments "
+      "that are not written to, least recently used indexes are unloaded",
+      required::no,
+      64_MiB)
+  , segment_recovery_concurrency(
+      *this,
+      "segment_recovery_concurrency",
+      "Maximum number of concurrent disk operations per shard when opening "
+      "and recovering the segments of the logs at startup",
+      required::no,
+      32)
+  , segment_read_ahead_memory(
+      *this,
+      "segment_read_ahead_memory",
+      "Maximum memory used per shard by the read-ahead buffers of the "
+      "segment readers, the readers opened past it read without read-ahead",
+      required::no,
+      64_MiB)
+  , segment_staging_threshold(
+      *this,
+      "segment_staging_threshold",
+      "Fraction of the maximum segment size written to the active segment "
+      "past which the files of the next segment are created in the "
+      "background, 0 creates them when the segment rolls",
+      required::no,
+      0.9)
+  , compaction_key_digests(
+      *this,
+      "compaction_key_digests",
+      "Index fixed size 128 bit digests of the record keys instead of the keys "
+      "in the compaction indexes of new segments",
+      required::no,
+      false)
+  , compaction_key_map_memory(
+      *this,
+      "compaction_key_map_memory",
+      "Maximum memory per shard of the map of the latest offsets of the keys "
+      "used to compact a window of closed segments, 0 disables window "
+      "compaction",
+      required::no,
+      32_MiB)
+  , compression_offload_threshold_bytes(
+      *this,
+      "compression_offload_threshold_bytes",
+      "Batches of at least this size are compressed and decompressed in the "
+      "background compression scheduling group, the smaller ones inline",
+      required::no,
+      1_MiB)
   , fetch_session_eviction_timeout_ms(
       *this,
       "fetch_session_eviction_timeout_ms",
@@ -552,6 +926,22 @@ configuration::configuration()
       "cache",
       required::no,
       60s)
+  , fetch_session_cache_max_memory(
+      *this,
+      "fetch_session_cache_max_memory",
+      "Maximum memory used by the fetch sessions of a shard, when it is "
+      "reached new sessions evict the idle and the smaller sessions or fall "
+      "back to sessionless fetches",
+      required::no,
+      10_MiB)
+  , list_offsets_cache_max_age_ms(
+      *this,
+      "list_offsets_cache_max_age_ms",
+      "Max age of the partition offsets cached by the fetches and the list "
+      "offsets of a shard with which its earliest and latest offset queries "
+      "are answered without looking the partition up, 0 disables the cache",
+      required::no,
+      0ms)
   , max_compacted_log_segment_size(
       *this,
       "max_compacted_log_segment_size",
@@ -573,18 +963,56 @@ configuration::configuration()
       "touching the log until the batch is exhausted.",
       required::no,
       1000)
+  , id_allocator_shard_lease_size(
+      *this,
+      "id_allocator_shard_lease_size",
+      "Number of ids each shard requests from the id allocator at once and "
+      "serves locally, the ids of an unused lease are lost on restart. With "
+      "a value of 1 or less every id is requested from the id allocator.",
+      required::no,
+      100)
   , enable_sasl(
       *this,
       "enable_sasl",
       "Enable SASL authentication for Kafka connections.",
       required::no,
       false)
+  , sasl_max_concurrent_handshakes(
+      *this,
+      "sasl_max_concurrent_handshakes",
+      "Maximum number of Kafka connections per shard between their SASL "
+      "handshake and the end of their authentication, the others wait for "
+      "their turn",
+      required::no,
+      64)
   , controller_backend_housekeeping_interval_ms(
       *this,
       "controller_backend_housekeeping_interval_ms",
       "Interval between iterations of controller backend housekeeping loop",
       required::no,
       1s)
+  , controller_backend_reconciliation_concurrency(
+      *this,
+      "controller_backend_reconciliation_concurrency",
+      "Maximum number of partitions a shard reconciles with the controller "
+      "state at the same time, the operations of a single partition are "
+      "always applied in order",
+      required::no,
+      256)
+  , enable_controller_snapshots(
+      *this,
+      "enable_controller_snapshots",
+      "Periodically snapshot the controller state, on startup only the "
+      "controller log entries following the snapshot are replayed",
+      required::no,
+      false)
+  , controller_snapshot_max_entries(
+      *this,
+      "controller_snapshot_max_entries",
+      "Number of controller log entries applied after which a new controller "
+      "snapshot is taken",
+      required::no,
+      10'000)
   , node_management_operation_timeout_ms(
       *this,
       "node_management_operation_timeout_ms",
@@ -632,12 +1060,171 @@ configuration::configuration()
       "target compaction backlog would be equal to ",
       required::no,
       std::nullopt)
+  , background_ctrl_target_ms(
+      *this,
+      "background_ctrl_target_ms",
+      "Target latency of the segment flushes, the shares of the background "
+      "work (compaction, learner recovery and archival) are reduced while the "
+      "latency is higher",
+      required::no,
+      5ms)
+  , background_ctrl_update_interval_ms(
+      *this,
+      "background_ctrl_update_interval_ms",
+      "Sampling interval of the background work controller",
+      required::no,
+      1s)
+  , background_ctrl_p_coeff(
+      *this,
+      "background_ctrl_p_coeff",
+      "proportional coefficient for background work PI controller",
+      required::no,
+      0.5)
+  , background_ctrl_i_coeff(
+      *this,
+      "background_ctrl_i_coeff",
+      "integral coefficient for background work PI controller",
+      required::no,
+      0.1)
+  , background_ctrl_min_shares(
+      *this,
+      "background_ctrl_min_shares",
+      "minimum number of IO and CPU shares of the learner recovery and "
+      "archival",
+      required::no,
+      10)
+  , background_ctrl_max_shares(
+      *this,
+      "background_ctrl_max_shares",
+      "maximum number of IO and CPU shares of the learner recovery and "
+      "archival",
+      required::no,
+      200)
   , members_backend_retry_ms(
       *this,
       "members_backend_retry_ms",
       "Time between members backend reconciliation loop retries ",
       required::no,
       5s)
+  , members_backend_max_concurrent_moves(
+      *this,
+      "members_backend_max_concurrent_moves",
+      "Maximum number of partitions being moved in the cluster at the same "
+      "time before the members backend schedules more moves of a node "
+      "decommission or addition",
+      required::no,
+      50)
+  , members_backend_max_moves_per_node(
+      *this,
+      "members_backend_max_moves_per_node",
+      "Maximum number of partition moves of a node decommission or addition "
+      "recovering to the same node at the same time",
+      required::no,
+      8)
+  , members_backend_recovery_bandwidth(
+      *this,
+      "members_backend_recovery_bandwidth",
+      "Recovery bandwidth budget of the cluster for the partition moves of a "
+      "node decommission or addition in bytes per sec, a move is recovered at "
+      "most at raft_learner_recovery_rate",
+      required::no,
+      std::nullopt)
+  , enable_leader_balancer(
+      *this,
+      "enable_leader_balancer",
+      "Enable automatic leadership rebalancing",
+      required::no,
+      true)
+  , leader_balancer_idle_timeout(
+      *this,
+      "leader_balancer_idle_timeout",
+      "Leadership rebalancing idle timeout",
+      required::no,
+      2min)
+  , leader_balancer_mute_timeout(
+      *this,
+      "leader_balancer_mute_timeout",
+      "Time after which a group that was moved (or failed to move) by the "
+      "leader balancer can be moved again",
+      required::no,
+      5min)
+  , leader_balancer_transfers_per_tick(
+      *this,
+      "leader_balancer_transfers_per_tick",
+      "Maximum number of leadership transfers issued by a single leader "
+      "balancer iteration",
+      required::no,
+      4)
+  , enable_partition_balancer(
+      *this,
+      "enable_partition_balancer",
+      "Enable automatic moves of partition replicas away from the nodes with "
+      "the most partitions, the fullest disks or the highest throughput",
+      required::no,
+      false)
+  , partition_balancer_tick_interval_ms(
+      *this,
+      "partition_balancer_tick_interval_ms",
+      "Time between the partition balancer iterations",
+      required::no,
+      30s)
+  , partition_balancer_max_skew(
+      *this,
+      "partition_balancer_max_skew",
+      "Relative difference, (max - min) / max, between the partition count, "
+      "disk fill or throughput of the nodes above which the partition "
+      "balancer moves replicas",
+      required::no,
+      0.2)
+  , partition_balancer_max_concurrent_moves(
+      *this,
+      "partition_balancer_max_concurrent_moves",
+      "Maximum number of partitions being moved in the cluster for the "
+      "partition balancer to request new moves",
+      required::no,
+      4)
+  , enable_shard_balancer(
+      *this,
+      "enable_shard_balancer",
+      "Enable automatic moves of partitions from the most to the least loaded "
+      "core of the node, by the bytes and requests they serve",
+      required::no,
+      false)
+  , shard_balancer_tick_interval_ms(
+      *this,
+      "shard_balancer_tick_interval_ms",
+      "Time between the shard balancer iterations, at most one partition of "
+      "the node is moved per iteration",
+      required::no,
+      1min)
+  , shard_balancer_max_skew(
+      *this,
+      "shard_balancer_max_skew",
+      "Relative difference, (max - min) / max, between the load of the cores "
+      "of the node above which the shard balancer moves a partition",
+      required::no,
+      0.3)
+  , shard_balancer_min_load_bytes(
+      *this,
+      "shard_balancer_min_load_bytes",
+      "Load, in bytes per second, of the most loaded core below which the "
+      "shard balancer doesn't move partitions",
+      required::no,
+      10_MiB)
+  , health_monitor_tick_interval_ms(
+      *this,
+      "health_monitor_tick_interval_ms",
+      "Time between the health reports each node sends to the controller "
+      "leader",
+      required::no,
+      10s)
+  , health_monitor_max_report_age_ms(
+      *this,
+      "health_monitor_max_report_age_ms",
+      "Age after which the controller leader drops the health report of a "
+      "node that stopped reporting",
+      required::no,
+      1min)
   , cloud_storage_enabled(
       *this,
       "cloud_storage_enabled",
@@ -723,6 +1310,105 @@ configuration::configuration()
       "Manifest upload timeout (ms)",
       required::no,
       10s)
+  , cloud_storage_enable_remote_read(
+      *this,
+      "cloud_storage_enable_remote_read",
+      "Serve fetch requests below the local start offset from the archived "
+      "segments",
+      required::no,
+      false)
+  , cloud_storage_cache_size(
+      *this,
+      "cloud_storage_cache_size",
+      "Max size of the local cache for downloaded archived segments, split "
+      "evenly between shards (0 disables the cache)",
+      required::no,
+      20_GiB)
+  , cloud_storage_multipart_upload_part_size(
+      *this,
+      "cloud_storage_multipart_upload_part_size",
+      "Segments larger than this are uploaded to S3 in parts of this size "
+      "(0 disables multipart uploads)",
+      required::no,
+      64_MiB)
+  , cloud_storage_multipart_upload_concurrency(
+      *this,
+      "cloud_storage_multipart_upload_concurrency",
+      "Max number of parts of one segment uploaded concurrently",
+      required::no,
+      4)
+  , cloud_storage_upload_bandwidth_per_shard(
+      *this,
+      "cloud_storage_upload_bandwidth_per_shard",
+      "Max upload bandwidth of the archival service on every shard in bytes "
+      "per second (0 disables the limit)",
+      required::no,
+      0)
+  , cloud_storage_binary_manifest(
+      *this,
+      "cloud_storage_binary_manifest",
+      "Upload partition manifests in compact binary format instead of json",
+      required::no,
+      false)
+  , cloud_storage_spillover_manifest_segments(
+      *this,
+      "cloud_storage_spillover_manifest_segments",
+      "Max number of segments in the binary partition manifest, older "
+      "segments are moved to immutable spillover manifests (0 disables "
+      "spillover)",
+      required::no,
+      1000)
+  , cloud_storage_coalesce_upload_size(
+      *this,
+      "cloud_storage_coalesce_upload_size",
+      "Consecutive small segments of the same term are uploaded as a single "
+      "object of up to this size (0 uploads every segment as its own object)",
+      required::no,
+      0)
+  , cloud_storage_coalesce_upload_delay_ms(
+      *this,
+      "cloud_storage_coalesce_upload_delay_ms",
+      "Max time the upload of the segments smaller than "
+      "cloud_storage_coalesce_upload_size is deferred to coalesce them with "
+      "the next segments",
+      required::no,
+      10min)
+  , cloud_storage_hedge_download_percentile(
+      *this,
+      "cloud_storage_hedge_download_percentile",
+      "Percentile of the time to first byte of the recent downloads from "
+      "S3 after which a duplicate request is sent (0.95 is p95)",
+      required::no,
+      0.95)
+  , cloud_storage_hedge_download_budget_percent(
+      *this,
+      "cloud_storage_hedge_download_budget_percent",
+      "Max number of duplicate requests sent for the slow downloads from S3 "
+      "in percents of all downloads (0 disables the duplicate requests)",
+      required::no,
+      5.0)
+  , cloud_storage_enable_retention(
+      *this,
+      "cloud_storage_enable_retention",
+      "Apply the retention settings of the topic to the data uploaded to S3, "
+      "the expired objects are removed from the bucket",
+      required::no,
+      false)
+  , cloud_storage_delete_objects_per_shard(
+      *this,
+      "cloud_storage_delete_objects_per_shard",
+      "Max number of objects the archival service deletes from S3 on every "
+      "shard per second (0 disables the limit)",
+      required::no,
+      1000)
+  , cloud_storage_read_prefetch_depth(
+      *this,
+      "cloud_storage_read_prefetch_depth",
+      "Max number of segments downloaded to the cache ahead of a sequential "
+      "remote reader, the depth follows the throughput of the reader (0 "
+      "disables the prefetch)",
+      required::no,
+      0)
   , superusers(
       *this, "superusers", "List of superuser usernames", required::no, {})
   , kafka_qdc_latency_alpha(
@@ -791,6 +1477,21 @@ configuration::configuration()
       "Size of the zstd decompression workspace",
       required::no,
       8_MiB)
+  , iobuf_fragment_pool_bytes(
+      *this,
+      "iobuf_fragment_pool_bytes",
+      "Maximum memory per shard of the freed iobuf fragments cached for the "
+      "next fragments of the same size, 0 disables the cache",
+      required::no,
+      0)
+  , event_trace_buffer_events(
+      *this,
+      "event_trace_buffer_events",
+      "Number of the last hot path events, like the produce, replicate and "
+      "segment append stages, each shard keeps for the admin API trace "
+      "dumps, 0 disables the tracing",
+      required::no,
+      0)
   , _advertised_kafka_api(
       *this,
       "advertised_kafka_api",
@@ -28,6 +28,7 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
 #include <cctype>
 #include <chrono>
 
@@ -41,13 +42,18 @@ namespace config {
 struct configuration final : public config_store {
     // WAL
     property<data_directory_path> data_directory;
+    one_or_many_property<ss::sstring> additional_data_directories;
     property<bool> developer_mode;
+    property<bool> disk_benchmark;
+    property<bool> io_fault_injection_enabled;
     property<uint64_t> log_segment_size;
     property<uint64_t> compacted_log_segment_size;
     property<std::chrono::milliseconds> readers_cache_eviction_timeout_ms;
     // Network
     property<unresolved_address> rpc_server;
     property<tls_config> rpc_server_tls;
+    property<int16_t> rpc_client_connections_per_peer;
+    property<std::optional<uint32_t>> rpc_cork_delay_us;
     // Coproc
     property<bool> enable_coproc;
     property<unresolved_address> coproc_supervisor_server;
@@ -61,6 +67,11 @@ struct configuration final : public config_store {
     property<int32_t> seed_server_meta_topic_partitions;
     property<std::chrono::milliseconds> raft_heartbeat_interval_ms;
     property<std::chrono::milliseconds> raft_heartbeat_timeout_ms;
+    property<bool> raft_enable_heartbeat_aggregation;
+    property<bool> raft_enable_quiescence;
+    property<std::chrono::milliseconds> raft_quiesce_delay_ms;
+    property<bool> raft_enable_leader_leases;
+    property<std::chrono::milliseconds> raft_leader_lease_clock_drift_ms;
     property<std::vector<seed_server>> seed_servers;
     property<int16_t> min_version;
     property<int16_t> max_version;
@@ -76,15 +87,28 @@ struct configuration final : public config_store {
     property<std::chrono::milliseconds> default_window_sec;
     property<std::chrono::milliseconds> quota_manager_gc_sec;
     property<uint32_t> target_quota_byte_rate;
+    property<std::optional<uint32_t>> target_quota_request_rate;
+    property<std::optional<uint32_t>> target_quota_cpu_rate;
+    property<std::chrono::milliseconds> quota_manager_balance_interval_ms;
+    property<bool> enable_kafka_connection_balancer;
+    property<std::chrono::milliseconds> kafka_connection_balance_interval_ms;
+    property<uint32_t> kafka_connection_balance_tolerance;
+    property<size_t> kafka_slow_request_log_size;
+    property<std::chrono::milliseconds> kafka_slow_request_log_window_ms;
+    property<std::chrono::milliseconds> scheduling_probe_interval_ms;
+    property<std::chrono::milliseconds> memory_balance_interval_ms;
     property<std::optional<ss::sstring>> cluster_id;
     property<std::optional<ss::sstring>> rack;
     property<std::optional<ss::sstring>> dashboard_dir;
     property<bool> disable_metrics;
+    property<bool> aggregate_metrics;
+    one_or_many_property<ss::sstring> metrics_partition_allowlist;
     property<std::chrono::milliseconds> group_min_session_timeout_ms;
     property<std::chrono::milliseconds> group_max_session_timeout_ms;
     property<std::chrono::milliseconds> group_initial_rebalance_delay;
     property<std::chrono::milliseconds> group_new_member_join_timeout;
     property<std::chrono::milliseconds> metadata_dissemination_interval_ms;
+    property<std::chrono::milliseconds> metadata_dissemination_resync_interval_ms;
     property<std::chrono::milliseconds> metadata_dissemination_retry_delay_ms;
     property<int16_t> metadata_dissemination_retries;
     property<model::violation_recovery_policy> stm_snapshot_recovery_policy;
@@ -103,14 +127,20 @@ struct configuration final : public config_store {
     property<std::chrono::milliseconds> transactional_id_expiration_ms;
     property<bool> enable_idempotence;
     property<bool> enable_transactions;
+    property<bool> enable_follower_fetching;
     // same as log.retention.ms in kafka
     property<std::chrono::milliseconds> delete_retention_ms;
     property<std::chrono::milliseconds> log_compaction_interval_ms;
     // same as retention.size in kafka - TODO: size not implemented
     property<std::optional<size_t>> retention_bytes;
+    property<size_t> memory_log_retention_bytes;
+    property<std::chrono::milliseconds> log_recompression_min_age_ms;
+    property<std::chrono::milliseconds> log_housekeeping_budget_ms;
+    property<size_t> log_housekeeping_concurrency;
     property<int32_t> group_topic_partitions;
     property<int16_t> default_topic_replication;
     property<int16_t> transaction_coordinator_replication;
+    property<int16_t> transaction_coordinator_partitions;
     property<int16_t> id_allocator_replication;
     property<model::cleanup_policy_bitflags>
       transaction_coordinator_cleanup_policy;
@@ -118,12 +148,27 @@ struct configuration final : public config_store {
     property<std::chrono::milliseconds> wait_for_leader_timeout_ms;
     property<int32_t> default_topic_partitions;
     property<bool> disable_batch_cache;
+    property<double> batch_cache_protected_ratio;
     property<std::chrono::milliseconds> raft_election_timeout_ms;
     property<std::chrono::milliseconds> kafka_group_recovery_timeout_ms;
+    property<std::chrono::milliseconds>
+      kafka_group_recovery_checkpoint_interval_ms;
     property<std::chrono::milliseconds> replicate_append_timeout_ms;
     property<std::chrono::milliseconds> recovery_append_timeout_ms;
     property<size_t> raft_replicate_batch_window_size;
+    property<size_t> raft_max_inflight_follower_append_requests;
+    property<size_t> raft_max_inflight_snapshot_chunks;
+    property<std::chrono::milliseconds> raft_replicate_batcher_max_linger_ms;
+    property<bool> raft_enable_partition_latency_histograms;
     property<size_t> raft_learner_recovery_rate;
+    property<size_t> raft_learner_promotion_max_lag;
+    property<size_t> raft_recovery_max_concurrent_reads;
+    property<bool> raft_enable_recovery_delegation;
+    property<size_t> raft_recovery_delegation_max_bytes;
+    property<std::chrono::milliseconds> raft_recovery_delegation_timeout_ms;
+    property<size_t> raft_max_concurrent_elections;
+    property<bool> raft_cross_rack_compression;
+    property<size_t> raft_cross_rack_compression_min_bytes;
 
     property<size_t> reclaim_min_size;
     property<size_t> reclaim_max_size;
@@ -141,13 +186,28 @@ struct configuration final : public config_store {
       raft_transfer_leader_recovery_timeout_ms;
     property<bool> release_cache_on_segment_roll;
     property<std::chrono::milliseconds> segment_appender_flush_timeout_ms;
+    property<size_t> segment_deletion_rate;
+    property<size_t> segment_index_memory_limit;
+    property<size_t> segment_recovery_concurrency;
+    property<size_t> segment_read_ahead_memory;
+    property<double> segment_staging_threshold;
+    property<bool> compaction_key_digests;
+    property<size_t> compaction_key_map_memory;
+    property<size_t> compression_offload_threshold_bytes;
     property<std::chrono::milliseconds> fetch_session_eviction_timeout_ms;
+    property<size_t> fetch_session_cache_max_memory;
+    property<std::chrono::milliseconds> list_offsets_cache_max_age_ms;
     property<size_t> max_compacted_log_segment_size;
     property<int16_t> id_allocator_log_capacity;
     property<int16_t> id_allocator_batch_size;
+    property<int16_t> id_allocator_shard_lease_size;
     property<bool> enable_sasl;
+    property<size_t> sasl_max_concurrent_handshakes;
     property<std::chrono::milliseconds>
       controller_backend_housekeeping_interval_ms;
+    property<size_t> controller_backend_reconciliation_concurrency;
+    property<bool> enable_controller_snapshots;
+    property<size_t> controller_snapshot_max_entries;
     property<std::chrono::milliseconds> node_management_operation_timeout_ms;
     // Compaction controller
     property<std::chrono::milliseconds> compaction_ctrl_update_interval_ms;
@@ -157,7 +217,30 @@ struct configuration final : public config_store {
     property<int16_t> compaction_ctrl_min_shares;
     property<int16_t> compaction_ctrl_max_shares;
     property<std::optional<size_t>> compaction_ctrl_backlog_size;
+    property<std::chrono::milliseconds> background_ctrl_target_ms;
+    property<std::chrono::milliseconds> background_ctrl_update_interval_ms;
+    property<double> background_ctrl_p_coeff;
+    property<double> background_ctrl_i_coeff;
+    property<int16_t> background_ctrl_min_shares;
+    property<int16_t> background_ctrl_max_shares;
     property<std::chrono::milliseconds> members_backend_retry_ms;
+    property<size_t> members_backend_max_concurrent_moves;
+    property<size_t> members_backend_max_moves_per_node;
+    property<std::optional<size_t>> members_backend_recovery_bandwidth;
+    property<bool> enable_leader_balancer;
+    property<std::chrono::milliseconds> leader_balancer_idle_timeout;
+    property<std::chrono::milliseconds> leader_balancer_mute_timeout;
+    property<size_t> leader_balancer_transfers_per_tick;
+    property<bool> enable_partition_balancer;
+    property<std::chrono::milliseconds> partition_balancer_tick_interval_ms;
+    property<double> partition_balancer_max_skew;
+    property<size_t> partition_balancer_max_concurrent_moves;
+    property<bool> enable_shard_balancer;
+    property<std::chrono::milliseconds> shard_balancer_tick_interval_ms;
+    property<double> shard_balancer_max_skew;
+    property<size_t> shard_balancer_min_load_bytes;
+    property<std::chrono::milliseconds> health_monitor_tick_interval_ms;
+    property<std::chrono::milliseconds> health_monitor_max_report_age_ms;
 
     // Archival storage
     property<bool> cloud_storage_enabled;
@@ -175,6 +258,20 @@ struct configuration final : public config_store {
     property<std::chrono::milliseconds> cloud_storage_segment_upload_timeout_ms;
     property<std::chrono::milliseconds>
       cloud_storage_manifest_upload_timeout_ms;
+    property<bool> cloud_storage_enable_remote_read;
+    property<size_t> cloud_storage_cache_size;
+    property<size_t> cloud_storage_multipart_upload_part_size;
+    property<size_t> cloud_storage_multipart_upload_concurrency;
+    property<size_t> cloud_storage_upload_bandwidth_per_shard;
+    property<bool> cloud_storage_binary_manifest;
+    property<size_t> cloud_storage_spillover_manifest_segments;
+    property<size_t> cloud_storage_coalesce_upload_size;
+    property<std::chrono::milliseconds> cloud_storage_coalesce_upload_delay_ms;
+    property<double> cloud_storage_hedge_download_percentile;
+    property<double> cloud_storage_hedge_download_budget_percent;
+    property<bool> cloud_storage_enable_retention;
+    property<size_t> cloud_storage_delete_objects_per_shard;
+    property<size_t> cloud_storage_read_prefetch_depth;
 
     one_or_many_property<ss::sstring> superusers;
 
@@ -192,6 +289,8 @@ struct configuration final : public config_store {
     property<size_t> kafka_qdc_max_depth;
     property<std::chrono::milliseconds> kafka_qdc_depth_update_ms;
     property<size_t> zstd_decompress_workspace_bytes;
+    property<size_t> iobuf_fragment_pool_bytes;
+    property<size_t> event_trace_buffer_events;
 
     configuration();
 
@@ -208,6 +307,17 @@ struct configuration final : public config_store {
         return _advertised_rpc_api().value_or(rpc_server());
     }
 
+    /// Return true if the per-partition metrics of the topic are exported
+    /// summed per topic
+    bool aggregate_partition_metrics(const model::topic& topic) const {
+        if (!aggregate_metrics()) {
+            return false;
+        }
+        const auto& allowlist = metrics_partition_allowlist();
+        return std::find(allowlist.begin(), allowlist.end(), topic())
+               == allowlist.end();
+    }
+
     // build pidfile path: `<data_directory>/pid.lock`
     std::filesystem::path pidfile_path() const {
         return data_directory().path / "pid.lock";
@@ -432,6 +542,10 @@ struct convert<config::tls_config> {
             node["truststore_file"] = *rhs.get_truststore_file();
         }
 
+        if (rhs.get_priority_string()) {
+            node["priority_string"] = *rhs.get_priority_string();
+        }
+
         return node;
     }
 
@@ -465,7 +579,8 @@ struct convert<config::tls_config> {
               key_cert,
               to_absolute(read_optional(node, "truststore_file")),
               node["require_client_auth"]
-                && node["require_client_auth"].as<bool>());
+                && node["require_client_auth"].as<bool>(),
+              read_optional(node, "priority_string"));
         }
         return true;
     }
@@ -12,6 +12,7 @@
 #pragma once
 #include "config/base_property.h"
 #include "config/rjson_serialization.h"
+#include "utils/intrusive_list_helpers.h"
 #include "utils/to_string.h"
 
 #include <seastar/util/noncopyable_function.hh>
@@ -21,6 +22,47 @@
 
 namespace config {
 
+template<class T>
+class property;
+
+/**
+ * Shard local handle following the value of a property.
+ *
+ * The properties are set at startup, a property set at runtime changes the
+ * value seen by its bindings and calls their watchers. The users that copy a
+ * value into their own state at construction hold a binding and apply the
+ * new values in its watcher. The property must outlive its bindings, the
+ * watchers must not destroy a binding of the same property.
+ */
+template<class T>
+class binding {
+public:
+    binding(binding&& o) noexcept
+      : _parent(o._parent)
+      , _on_change(std::move(o._on_change)) {
+        _hook.swap_nodes(o._hook);
+    }
+    binding& operator=(binding&&) = delete;
+    binding(const binding&) = delete;
+    binding& operator=(const binding&) = delete;
+    ~binding() noexcept = default;
+
+    const T& operator()() const;
+
+    /// \brief called on the shard of the binding after the value changed
+    void watch(ss::noncopyable_function<void()> f) {
+        _on_change = std::move(f);
+    }
+
+private:
+    friend class property<T>;
+    explicit binding(property<T>& parent);
+
+    property<T>* _parent;
+    ss::noncopyable_function<void()> _on_change;
+    intrusive_list_hook _hook;
+};
+
 template<class T>
 class property : public base_property {
 public:
@@ -53,6 +95,8 @@ public:
 
     operator T() const { return value(); } // NOLINT
 
+    binding<T> bind() { return binding<T>(*this); }
+
     void print(std::ostream& o) const override { o << name() << ":" << _value; }
 
     // serialize the value. the key is taken from the property name at the
@@ -63,34 +107,56 @@ public:
     }
 
     std::optional<validation_error> validate() const override {
-        if (auto err = _validator(_value); err) {
-            return std::make_optional<validation_error>(name().data(), *err);
-        }
-        return std::nullopt;
+        return validate(_value);
+    }
+
+    std::optional<validation_error> validate(YAML::Node n) const override {
+        return validate(decode(n));
     }
 
     void set_value(std::any v) override {
-        _value = std::any_cast<T>(std::move(v));
+        update(std::any_cast<T>(std::move(v)));
     }
 
-    void set_value(YAML::Node n) override { _value = std::move(n.as<T>()); }
+    void set_value(YAML::Node n) override { update(decode(n)); }
 
     property<T>& operator()(T v) {
-        _value = std::move(v);
+        update(std::move(v));
         return *this;
     }
 
     base_property& operator=(const base_property& pr) override {
-        _value = dynamic_cast<const property<T>&>(pr)._value;
+        update(dynamic_cast<const property<T>&>(pr)._value);
         return *this;
     }
 
 protected:
+    virtual T decode(const YAML::Node& n) const { return n.as<T>(); }
+
     T _value;
     const T _default;
 
 private:
+    friend class binding<T>;
+
+    std::optional<validation_error> validate(const T& v) const {
+        if (auto err = _validator(v); err) {
+            return std::make_optional<validation_error>(name().data(), *err);
+        }
+        return std::nullopt;
+    }
+
+    void update(T v) {
+        _value = std::move(v);
+        for (auto& b : _bindings) {
+            if (b._on_change) {
+                b._on_change();
+            }
+        }
+    }
+
     validator _validator;
+    intrusive_list<binding<T>, &binding<T>::_hook> _bindings;
     constexpr static auto noop_validator = [](const auto&) {
         return std::nullopt;
     };
@@ -106,7 +172,8 @@ class one_or_many_property : public property<std::vector<T>> {
 public:
     using property<std::vector<T>>::property;
 
-    void set_value(YAML::Node n) override {
+protected:
+    std::vector<T> decode(const YAML::Node& n) const override {
         std::vector<T> value;
         if (n.IsSequence()) {
             for (auto elem : n) {
@@ -115,8 +182,19 @@ public:
         } else {
             value.push_back(std::move(n.as<T>()));
         }
-        this->_value = std::move(value);
+        return value;
     }
 };
 
+template<class T>
+binding<T>::binding(property<T>& parent)
+  : _parent(&parent) {
+    parent._bindings.push_back(*this);
+}
+
+template<class T>
+const T& binding<T>::operator()() const {
+    return _parent->value();
+}
+
 }; // namespace config
@@ -63,6 +63,11 @@ void rjson_serialize(
         w.String((*(v.get_truststore_file())).c_str());
     }
 
+    if (v.get_priority_string()) {
+        w.Key("priority_string");
+        w.String(v.get_priority_string()->c_str());
+    }
+
     w.EndObject();
 }
 
@@ -115,6 +120,11 @@ void rjson_serialize(
         w.String((*(v.config.get_truststore_file())).c_str());
     }
 
+    if (v.config.get_priority_string()) {
+        w.Key("priority_string");
+        w.String(v.config.get_priority_string()->c_str());
+    }
+
     w.EndObject();
 }
 
@@ -142,6 +142,38 @@ SEASTAR_THREAD_TEST_CASE(update_property_value) {
     BOOST_TEST(cfg.required_string() == "new_string_value");
 };
 
+SEASTAR_THREAD_TEST_CASE(binding_follows_property_value) {
+    auto cfg = test_config();
+    cfg.read_yaml(minimal_valid_configuration());
+
+    auto bound = cfg.optional_int.bind();
+    int seen = 0;
+    bound.watch([&seen, &bound] { seen = bound(); });
+    BOOST_TEST(bound() == 100);
+
+    cfg.get("optional_int").set_value(YAML::Load("42"));
+    BOOST_TEST(bound() == 42);
+    BOOST_TEST(seen == 42);
+
+    // a moved binding keeps following the property
+    auto moved = std::move(bound);
+    moved.watch([&seen, &moved] { seen = moved(); });
+    cfg.optional_int(7);
+    BOOST_TEST(moved() == 7);
+    BOOST_TEST(seen == 7);
+};
+
+SEASTAR_THREAD_TEST_CASE(validate_value_without_setting_it) {
+    auto cfg = test_config();
+    cfg.read_yaml(minimal_valid_configuration());
+
+    BOOST_TEST(!cfg.get("optional_int").validate(YAML::Load("42")));
+    BOOST_TEST(cfg.optional_int() == 100);
+    BOOST_CHECK_THROW(
+      cfg.get("optional_int").validate(YAML::Load("not a number")),
+      YAML::Exception);
+};
+
 SEASTAR_THREAD_TEST_CASE(validate_valid_configuration) {
     auto cfg = test_config();
     cfg.read_yaml(valid_configuration());
@@ -90,3 +90,22 @@ SEASTAR_THREAD_TEST_CASE(test_decode_enabled_but_contains_empty_path) {
     BOOST_TEST(*full_cfg.get_truststore_file() == "");
     BOOST_TEST(!full_cfg.get_require_client_auth());
 }
+
+SEASTAR_THREAD_TEST_CASE(test_decode_priority_string) {
+    auto with_values = "tls_config:\n"
+                       "  enabled: true\n"
+                       "  cert_file: /fake/cret_file.crt\n"
+                       "  key_file: /fake/key_file.key\n"
+                       "  priority_string: "
+                       "\"SECURE128:-VERS-ALL:+VERS-TLS1.3\"\n";
+    auto cfg = read_from_yaml(with_values);
+    BOOST_TEST(cfg.is_enabled());
+    BOOST_TEST(
+      *cfg.get_priority_string() == "SECURE128:-VERS-ALL:+VERS-TLS1.3");
+
+    auto encoded = YAML::convert<config::tls_config>::encode(cfg);
+    BOOST_TEST(
+      encoded["priority_string"].as<std::string>()
+      == "SECURE128:-VERS-ALL:+VERS-TLS1.3");
+    BOOST_TEST(!read_from_yaml("tls_config:\n").get_priority_string());
+}
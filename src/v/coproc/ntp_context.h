@@ -13,6 +13,7 @@
 
 #include "config/configuration.h"
 #include "coproc/types.h"
+#include "model/record_batch_reader.h"
 #include "random/simple_time_jitter.h"
 #include "rpc/reconnect_transport.h"
 #include "storage/fwd.h"
@@ -25,6 +26,7 @@
 #include <absl/container/btree_map.h>
 #include <absl/container/node_hash_map.h>
 
+#include <algorithm>
 #include <chrono>
 #include <exception>
 
@@ -58,15 +60,52 @@ struct ntp_context {
 
     using offset_tracker = absl::btree_map<script_id, offset_pair>;
 
+    /// Decompressed batches of the last read of the input ntp. The scripts
+    /// reading within the range are served shares of the batches instead of
+    /// reading, and decompressing, them again
+    struct read_cache {
+        model::record_batch_reader::data_t batches;
+        std::size_t size_bytes{0};
+
+        bool contains(model::offset o) const {
+            return !batches.empty() && batches.front().base_offset() <= o
+                   && o <= batches.back().last_offset();
+        }
+    };
+
     explicit ntp_context(storage::log lg)
       : log(std::move(lg)) {}
 
     const model::ntp& ntp() const { return log.config().ntp(); }
 
+    /// \brief drops the cached batches that every interested script has
+    /// acked, the others may still be replayed from the last acked offset
+    void trim_cache() {
+        if (offsets.empty()) {
+            cache = read_cache{};
+            return;
+        }
+        model::offset min_acked = model::offset::max();
+        for (const auto& [_, o] : offsets) {
+            min_acked = std::min(min_acked, o.last_acked);
+        }
+        while (!cache.batches.empty()
+               && cache.batches.front().last_offset() <= min_acked) {
+            cache.size_bytes -= cache.batches.front().size_bytes();
+            cache.batches.pop_front();
+        }
+    }
+
     /// Reference to the storage layer for reading from the input ntp
     storage::log log;
     /// Interested scripts write their last read offset of the input ntp
     offset_tracker offsets;
+    /// Batches shared between the scripts reading the input ntp, between
+    /// the smallest last acked and the largest last read offsets
+    read_cache cache;
+    /// Serializes the reads of the input ntp, so that scripts waiting on a
+    /// read in progress are served from its cache
+    mutex read_mtx;
 };
 
 using ntp_context_cache
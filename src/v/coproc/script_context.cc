@@ -31,25 +31,6 @@
 
 namespace coproc {
 
-class high_offset_tracker {
-public:
-    struct batch_info {
-        model::offset last{};
-        std::size_t size{0};
-    };
-    ss::future<ss::stop_iteration> operator()(const model::record_batch& rb) {
-        _info.last = rb.last_offset();
-        _info.size += rb.size_bytes();
-        return ss::make_ready_future<ss::stop_iteration>(
-          ss::stop_iteration::no);
-    }
-
-    batch_info end_of_stream() { return _info; }
-
-private:
-    batch_info _info;
-};
-
 script_context::script_context(
   script_id id,
   shared_script_resources& resources,
@@ -87,36 +68,75 @@ ss::future<> script_context::do_execute() {
     /// while there is a current successful connection to the wasm engine.
     /// If both of those conditions aren't met, the loop breaks, hitting the
     /// sleep_abortable() call in the fiber started by 'start()'
+    ///
+    /// The writes of the replies of one iteration are in flight while the
+    /// next iteration reads, they are waited for before sending its request
     return ss::repeat([this] {
-        if (_abort_source.abort_requested()) {
-            return ss::make_ready_future<ss::stop_iteration>(
-              ss::stop_iteration::yes);
-        }
-        return _resources.transport.get_connected(model::no_timeout)
-          .then([this](result<rpc::transport*> transport) {
-              if (!transport) {
-                  /// Failed to connected to the wasm engine for whatever
-                  /// reason, exit to yield
-                  return ss::make_ready_future<ss::stop_iteration>(
-                    ss::stop_iteration::yes);
-              }
-              supervisor_client_protocol client(*transport.value());
-              return read().then(
-                [this, client = std::move(client)](
-                  std::vector<process_batch_request::data> requests) mutable {
-                    if (requests.empty()) {
-                        /// No data to read from all inputs, no need to
-                        /// incessently loop, can exit to yield
-                        return ss::make_ready_future<ss::stop_iteration>(
-                          ss::stop_iteration::yes);
-                    }
-                    /// Send request to wasm engine
-                    process_batch_request req{.reqs = std::move(requests)};
-                    return send_request(std::move(client), std::move(req))
-                      .then([] { return ss::stop_iteration::no; });
-                });
-          });
-    });
+               if (_abort_source.abort_requested()) {
+                   return ss::make_ready_future<ss::stop_iteration>(
+                     ss::stop_iteration::yes);
+               }
+               return _resources.transport.get_connected(model::no_timeout)
+                 .then([this](result<rpc::transport*> transport) {
+                     if (!transport) {
+                         /// Failed to connected to the wasm engine for
+                         /// whatever reason, exit to yield
+                         return ss::make_ready_future<ss::stop_iteration>(
+                           ss::stop_iteration::yes);
+                     }
+                     supervisor_client_protocol client(*transport.value());
+                     return read().then(
+                       [this, client = std::move(client)](
+                         std::vector<process_batch_request::data>
+                           requests) mutable {
+                           return wait_for_writes().then(
+                             [this,
+                              client = std::move(client),
+                              requests = std::move(requests)]() mutable {
+                                 return send_read(
+                                   std::move(client), std::move(requests));
+                             });
+                       });
+                 });
+           })
+      .finally([this] { return wait_for_writes(); });
+}
+
+ss::future<ss::stop_iteration> script_context::send_read(
+  supervisor_client_protocol client,
+  std::vector<process_batch_request::data> requests) {
+    if (std::exchange(_replay, false)) {
+        /// The previous iteration failed, what was read since is dropped
+        /// and read again from the last acked offsets
+        rewind();
+        return ss::make_ready_future<ss::stop_iteration>(
+          ss::stop_iteration::no);
+    }
+    if (requests.empty()) {
+        /// No data to read from all inputs, no need to
+        /// incessently loop, can exit to yield
+        return ss::make_ready_future<ss::stop_iteration>(
+          ss::stop_iteration::yes);
+    }
+    read_offsets sent;
+    for (const auto& r : requests) {
+        sent.emplace(r.ntp, _ntp_ctxs[r.ntp]->offsets[_id].last_read);
+    }
+    /// Send request to wasm engine
+    process_batch_request req{.reqs = std::move(requests)};
+    return send_request(std::move(client), std::move(req), std::move(sent))
+      .then([] { return ss::stop_iteration::no; });
+}
+
+ss::future<> script_context::wait_for_writes() {
+    return std::exchange(_pending_writes, ss::make_ready_future<>());
+}
+
+void script_context::rewind() {
+    for (auto& [_, ntp_ctx] : _ntp_ctxs) {
+        auto& offsets = ntp_ctx->offsets[_id];
+        offsets.last_read = offsets.last_acked;
+    }
 }
 
 ss::future<> script_context::shutdown() {
@@ -125,20 +145,25 @@ ss::future<> script_context::shutdown() {
 }
 
 ss::future<> script_context::send_request(
-  supervisor_client_protocol client, process_batch_request r) {
+  supervisor_client_protocol client,
+  process_batch_request r,
+  read_offsets sent) {
     using reply_t = result<rpc::client_context<process_batch_reply>>;
     return client
       .process_batch(
         std::move(r), rpc::client_opts(rpc::clock_type::now() + 5s))
-      .then([this](reply_t reply) {
+      .then([this, sent = std::move(sent)](reply_t reply) mutable {
           if (reply) {
-              return process_reply(std::move(reply.value().data));
+              /// Written in the background while the next iteration reads
+              _pending_writes = process_reply(
+                std::move(reply.value().data), std::move(sent));
+              return;
           }
           vlog(
             coproclog.warn,
             "Error upon attempting to perform RPC to wasm engine, code: {}",
             reply.error());
-          return ss::now();
+          _replay = true;
       });
 }
 
@@ -172,10 +197,12 @@ script_context::get_reader(const ss::lw_shared_ptr<ntp_context>& ntp_ctx) {
       _id,
       ntp_ctx->ntp());
     const ntp_context::offset_pair& cp_offsets = found->second;
-    const model::offset next_read
-      = (unlikely(cp_offsets.last_acked == model::offset{}))
-          ? model::offset(0)
-          : cp_offsets.last_acked + model::offset(1);
+    /// Past the writes in flight, if any
+    const model::offset last = std::max(
+      cp_offsets.last_read, cp_offsets.last_acked);
+    const model::offset next_read = (unlikely(last == model::offset{}))
+                                      ? model::offset(0)
+                                      : last + model::offset(1);
     if (next_read <= cp_offsets.last_acked) {
         vlog(
           coproclog.info,
@@ -212,67 +239,133 @@ std::optional<process_batch_request::data> script_context::mark_offset(
 
 ss::future<std::optional<process_batch_request::data>>
 script_context::read_ntp(ss::lw_shared_ptr<ntp_context> ntp_ctx) {
-    using read_result
-      = std::tuple<high_offset_tracker::batch_info, model::record_batch_reader>;
+    /// The scripts reading the ntp at the same time wait for the first read
+    /// and are served from its cache
+    return ntp_ctx->read_mtx.with([this, ntp_ctx] {
+        storage::log_reader_config cfg = get_reader(ntp_ctx);
+        const model::offset start = cfg.start_offset;
+        const storage::offset_stats os = ntp_ctx->log.offsets();
+        auto& cache = ntp_ctx->cache;
+        if (
+          cache.contains(start)
+          && cache.batches.back().last_offset() <= os.dirty_offset) {
+            return ss::make_ready_future<
+              std::optional<process_batch_request::data>>(
+              read_cached(ntp_ctx, start));
+        }
+        return fill_cache(ntp_ctx, cfg).then([this, ntp_ctx, start] {
+            return read_cached(ntp_ctx, start);
+        });
+    });
+}
+
+ss::future<> script_context::fill_cache(
+  ss::lw_shared_ptr<ntp_context> ntp_ctx, storage::log_reader_config cfg) {
     return ss::with_semaphore(
-      _resources.read_sem, max_batch_size(), [this, ntp_ctx]() {
-          storage::log_reader_config cfg = get_reader(ntp_ctx);
+      _resources.read_sem, max_batch_size(), [ntp_ctx, cfg]() {
           return ntp_ctx->log.make_reader(cfg)
             .then([](model::record_batch_reader rbr) {
                 return std::move(rbr).for_each_ref(
-                  coproc::reference_window_consumer(
-                    high_offset_tracker(),
-                    storage::internal::decompress_batch_consumer()),
+                  storage::internal::decompress_batch_consumer(),
                   model::no_timeout);
             })
-            .then([this, ntp_ctx](read_result t) {
-                auto& [info, rbr] = t;
-                return mark_offset(
-                  ntp_ctx, info.last, info.size, std::move(rbr));
+            .then([](model::record_batch_reader rbr) {
+                return model::consume_reader_to_memory(
+                  std::move(rbr), model::no_timeout);
+            })
+            .then([ntp_ctx](model::record_batch_reader::data_t batches) {
+                ntp_context::read_cache cache;
+                for (const auto& b : batches) {
+                    cache.size_bytes += b.size_bytes();
+                }
+                cache.batches = std::move(batches);
+                ntp_ctx->cache = std::move(cache);
             });
       });
 }
 
-ss::future<> script_context::process_reply(process_batch_reply reply) {
+std::optional<process_batch_request::data> script_context::read_cached(
+  ss::lw_shared_ptr<ntp_context> ntp_ctx, model::offset start) {
+    model::record_batch_reader::data_t batches;
+    std::size_t size = 0;
+    for (auto& b : ntp_ctx->cache.batches) {
+        if (b.last_offset() >= start) {
+            size += b.size_bytes();
+            batches.push_back(b.share());
+        }
+    }
+    if (batches.empty()) {
+        return std::nullopt;
+    }
+    const model::offset last = batches.back().last_offset();
+    auto data = mark_offset(
+      ntp_ctx,
+      last,
+      size,
+      model::make_memory_record_batch_reader(std::move(batches)));
+    ntp_ctx->trim_cache();
+    return data;
+}
+
+ss::future<> script_context::process_reply(
+  process_batch_reply reply, read_offsets sent) {
     if (reply.resps.empty()) {
         vlog(
           coproclog.error, "Wasm engine interpreted the request as erraneous");
+        _replay = true;
         return ss::now();
     }
-    return ss::do_with(std::move(reply), [this](process_batch_reply& reply) {
-        return ss::do_for_each(
-          reply.resps, [this](process_batch_reply::data& e) {
-              return process_one_reply(std::move(e));
+    /// The replies for the same materialized ntp are coalesced into one
+    /// write, the writes to different ntps run concurrently
+    absl::node_hash_map<model::ntp, std::vector<process_batch_reply::data>>
+      by_ntp;
+    for (auto& e : reply.resps) {
+        by_ntp[e.ntp].push_back(std::move(e));
+    }
+    return ss::do_with(
+      std::move(by_ntp),
+      std::move(sent),
+      [this](auto& by_ntp, const read_offsets& sent) {
+          return ss::parallel_for_each(by_ntp, [this, &sent](auto& p) {
+              return process_ntp_replies(p.first, std::move(p.second), sent);
           });
-    });
+      });
 }
 
-ss::future<> script_context::process_one_reply(process_batch_reply::data e) {
-    /// Ensure this 'script_context' instance is handling the correct reply
-    if (e.id != _id) {
-        /// TODO: Maybe in the future errors of these type should mean redpanda
-        /// kill -9's the wasm engine.
-        vlog(
-          coproclog.error,
-          "erranous reply from wasm engine, mismatched id observed, expected: "
-          "{} and observed {}",
-          _id,
-          e.id);
-        return ss::now();
-    }
-    if (!e.reader) {
-        return ss::make_exception_future<>(script_failed_exception(
-          e.id,
-          fmt::format(
-            "script id {} will auto deregister due to an internal syntax "
-            "error",
-            e.id)));
+ss::future<> script_context::process_ntp_replies(
+  const model::ntp& ntp,
+  std::vector<process_batch_reply::data> replies,
+  const read_offsets& sent) {
+    for (const auto& e : replies) {
+        /// Ensure this 'script_context' instance is handling the correct
+        /// reply
+        if (e.id != _id) {
+            /// TODO: Maybe in the future errors of these type should mean
+            /// redpanda kill -9's the wasm engine.
+            vlog(
+              coproclog.error,
+              "erranous reply from wasm engine, mismatched id observed, "
+              "expected: {} and observed {}",
+              _id,
+              e.id);
+            _replay = true;
+            return ss::now();
+        }
+        if (!e.reader) {
+            return ss::make_exception_future<>(script_failed_exception(
+              e.id,
+              fmt::format(
+                "script id {} will auto deregister due to an internal syntax "
+                "error",
+                e.id)));
+        }
     }
     /// Use the source topic portion of the materialized topic to perform a
     /// lookup for the relevent 'ntp_context'
-    auto materialized_ntp = model::materialized_ntp(e.ntp);
+    auto materialized_ntp = model::materialized_ntp(ntp);
     auto found = _ntp_ctxs.find(materialized_ntp.source_ntp());
-    if (found == _ntp_ctxs.end()) {
+    auto sent_offset = sent.find(materialized_ntp.source_ntp());
+    if (found == _ntp_ctxs.end() || sent_offset == sent.end()) {
         vlog(
           coproclog.warn,
           "script {} unknown source ntp: {}",
@@ -281,13 +374,19 @@ ss::future<> script_context::process_one_reply(process_batch_reply::data e) {
         return ss::now();
     }
     auto ntp_ctx = found->second;
-    return write_materialized(materialized_ntp, std::move(*e.reader))
-      .then([this, ntp_ctx](write_response wr) {
+    const model::offset acked = sent_offset->second;
+    return coalesce(std::move(replies))
+      .then([this, materialized_ntp](model::record_batch_reader reader) {
+          return write_materialized(materialized_ntp, std::move(reader));
+      })
+      .then([this, ntp_ctx, acked](write_response wr) {
           if (wr == write_response::crc_failure) {
               vlog(coproclog.warn, "record_batch failed to pass crc checks");
+              _replay = true;
               return;
           } else if (wr == write_response::term_too_old) {
               vlog(coproclog.debug, "older term record detected, retrying");
+              _replay = true;
               return;
           }
           auto ofound = ntp_ctx->offsets.find(_id);
@@ -296,8 +395,41 @@ ss::future<> script_context::process_one_reply(process_batch_reply::data e) {
             "Offset not found for script id {} for ntp owning context: {}",
             _id,
             ntp_ctx->ntp());
-          /// Reset the acked offset so that progress can be made
-          ofound->second.last_acked = ofound->second.last_read;
+          /// Reset the acked offset so that progress can be made, up to what
+          /// was sent, the next read may be past it already
+          ofound->second.last_acked = acked;
+          ntp_ctx->trim_cache();
+      });
+}
+
+ss::future<model::record_batch_reader>
+script_context::coalesce(std::vector<process_batch_reply::data> replies) {
+    if (replies.size() == 1) {
+        return ss::make_ready_future<model::record_batch_reader>(
+          std::move(*replies.front().reader));
+    }
+    return ss::do_with(
+      std::move(replies),
+      model::record_batch_reader::data_t{},
+      [](
+        std::vector<process_batch_reply::data>& replies,
+        model::record_batch_reader::data_t& batches) {
+          return ss::do_for_each(
+                   replies,
+                   [&batches](process_batch_reply::data& e) {
+                       return model::consume_reader_to_memory(
+                                std::move(*e.reader), model::no_timeout)
+                         .then([&batches](
+                                 model::record_batch_reader::data_t bs) {
+                             for (auto& b : bs) {
+                                 batches.push_back(std::move(b));
+                             }
+                         });
+                   })
+            .then([&batches] {
+                return model::make_memory_record_batch_reader(
+                  std::move(batches));
+            });
       });
 }
 
@@ -21,6 +21,8 @@
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <absl/container/flat_hash_map.h>
+
 namespace coproc {
 
 /**
@@ -71,10 +73,18 @@ public:
 private:
     enum class write_response { success, crc_failure, term_too_old };
 
+    /// Last read offset of the source ntps sent to the wasm engine
+    using read_offsets = absl::flat_hash_map<model::ntp, model::offset>;
+
     ss::future<> do_execute();
 
-    ss::future<>
-      send_request(supervisor_client_protocol, process_batch_request);
+    ss::future<ss::stop_iteration> send_read(
+      supervisor_client_protocol, std::vector<process_batch_request::data>);
+    ss::future<> wait_for_writes();
+    void rewind();
+
+    ss::future<> send_request(
+      supervisor_client_protocol, process_batch_request, read_offsets);
 
     storage::log_reader_config
     get_reader(const ss::lw_shared_ptr<ntp_context>&);
@@ -83,9 +93,18 @@ private:
 
     ss::future<std::optional<process_batch_request::data>>
       read_ntp(ss::lw_shared_ptr<ntp_context>);
-
-    ss::future<> process_reply(process_batch_reply);
-    ss::future<> process_one_reply(process_batch_reply::data);
+    ss::future<>
+      fill_cache(ss::lw_shared_ptr<ntp_context>, storage::log_reader_config);
+    std::optional<process_batch_request::data>
+      read_cached(ss::lw_shared_ptr<ntp_context>, model::offset);
+
+    ss::future<> process_reply(process_batch_reply, read_offsets);
+    ss::future<> process_ntp_replies(
+      const model::ntp&,
+      std::vector<process_batch_reply::data>,
+      const read_offsets&);
+    ss::future<model::record_batch_reader>
+      coalesce(std::vector<process_batch_reply::data>);
     ss::future<write_response> write_materialized(
       const model::materialized_ntp&, model::record_batch_reader);
     ss::future<std::variant<write_response, model::term_id>>
@@ -117,5 +136,13 @@ private:
 
     /// Uniquely identifying script id. Generated by coproc engine
     script_id _id;
+
+    /// Writes of the replies of the last request, waited for before sending
+    /// the next one
+    ss::future<> _pending_writes = ss::make_ready_future<>();
+
+    /// Set when the replies of a request couldn't be written, the reads
+    /// done since are replayed from the last acked offsets
+    bool _replay{false};
 };
 } // namespace coproc
@@ -0,0 +1,265 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "coproc/tests/fixtures/coproc_test_fixture.h"
+#include "coproc/tests/utils/coprocessor.h"
+#include "coproc/types.h"
+#include "model/compression.h"
+#include "model/fundamental.h"
+#include "model/timestamp.h"
+#include "storage/parser_utils.h"
+#include "storage/tests/utils/random_batch.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/future-util.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/when_all.hh>
+
+#include <boost/range/irange.hpp>
+#include <boost/test/tools/old/interface.hpp>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include <chrono>
+
+using copro_typeid = coproc::registry::type_identifier;
+
+/// Runs an input load through N scripts x M input partitions and reports
+/// the throughput and the end to end lag, from the push of a batch onto the
+/// input topic to it being readable from the materialized topic.
+///
+/// The lag is measured with the timestamps of the batches, stamped right
+/// before their push, so is in milliseconds and includes up to the 20ms
+/// poll interval of the drains.
+class coproc_throughput_fixture : public coproc_test_fixture {
+public:
+    struct scenario {
+        std::size_t scripts{1};
+        std::size_t partitions{1};
+        /// pushed onto each input partition
+        std::size_t batches{100};
+        /// the batches alternate between n and n + 1 records, the filter
+        /// transform keeps the even ones
+        int records_per_batch{10};
+        /// batches pushed at once
+        std::size_t batches_per_push{10};
+        model::compression codec{model::compression::none};
+        copro_typeid transform{copro_typeid::identity_coprocessor};
+    };
+
+    struct report {
+        std::size_t input_records{0};
+        std::size_t input_bytes{0};
+        std::size_t output_batches{0};
+        std::chrono::microseconds elapsed{0};
+        hdr_hist lag_us;
+    };
+
+    report run(const scenario& s) {
+        const model::topic input(fmt::format("bench_input_{}", _runs));
+        const model::topic output = model::to_materialized_topic(
+          input,
+          s.transform == copro_typeid::filter_coprocessor
+            ? filter_coprocessor::filter_topic
+            : identity_coprocessor::identity_topic);
+        if (_runs == 0) {
+            setup({{input, s.partitions}}).get();
+        } else {
+            add_topic(
+              model::topic_namespace(model::kafka_namespace, input),
+              s.partitions)
+              .get();
+        }
+        std::vector<deploy> deploys;
+        std::vector<uint64_t> ids;
+        for (std::size_t i = 0; i < s.scripts; ++i) {
+            const uint64_t id = _runs * 1000 + i;
+            ids.push_back(id);
+            deploys.push_back(
+              {.id = id,
+               .data{
+                 .tid = s.transform,
+                 .topics = {std::make_pair<>(input, tp_stored)}}});
+        }
+        enable_coprocessors(std::move(deploys)).get();
+        ++_runs;
+
+        report r;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < s.batches; ++i) {
+            kept += (s.records_per_batch + i % 2) % 2 == 0 ? 1 : 0;
+        }
+        const bool filter = s.transform == copro_typeid::filter_coprocessor;
+        const std::size_t expected = s.scripts * (filter ? kept : s.batches);
+        /// compressed upfront, only the timestamps are set when pushed
+        std::vector<model::record_batch_reader::data_t> inputs(s.partitions);
+        for (auto& batches : inputs) {
+            for (std::size_t i = 0; i < s.batches; ++i) {
+                auto b = storage::test::make_random_batch(
+                  model::offset(0),
+                  s.records_per_batch + static_cast<int>(i % 2),
+                  false);
+                r.input_records += b.record_count();
+                r.input_bytes += b.size_bytes();
+                batches.push_back(
+                  storage::internal::compress_batch(s.codec, std::move(b))
+                    .get0());
+            }
+        }
+
+        const auto start = ss::lowres_clock::now();
+        auto partitions = boost::irange<std::size_t>(0, s.partitions);
+        auto pushes = ss::parallel_for_each(
+          partitions, [this, &s, &inputs, input](std::size_t p) {
+              return push_partition(
+                model::ntp(
+                  model::kafka_namespace, input, model::partition_id(p)),
+                s.batches_per_push,
+                inputs[p]);
+          });
+        auto drains = ss::parallel_for_each(
+          partitions, [this, &r, output, expected](std::size_t p) {
+              return drain_partition(
+                model::ntp(
+                  model::kafka_namespace, output, model::partition_id(p)),
+                expected,
+                r);
+          });
+        ss::when_all_succeed(std::move(pushes), std::move(drains)).get();
+        r.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+          ss::lowres_clock::now() - start);
+        disable_coprocessors(std::move(ids)).get();
+
+        BOOST_CHECK_EQUAL(r.output_batches, expected * s.partitions);
+        print(s, r);
+        return r;
+    }
+
+private:
+    ss::future<> push_partition(
+      model::ntp ntp,
+      std::size_t batches_per_push,
+      model::record_batch_reader::data_t& input) {
+        return ss::do_until(
+          [&input] { return input.empty(); },
+          [this, ntp, batches_per_push, &input] {
+              model::record_batch_reader::data_t batches;
+              const auto now = model::timestamp::now();
+              while (!input.empty() && batches.size() < batches_per_push) {
+                  auto b = std::move(input.front());
+                  input.pop_front();
+                  b.header().first_timestamp = now;
+                  b.header().max_timestamp = now;
+                  storage::internal::reset_size_checksum_metadata(
+                    b.header(), b.data());
+                  batches.push_back(std::move(b));
+              }
+              return push(
+                       ntp,
+                       model::make_memory_record_batch_reader(
+                         std::move(batches)))
+                .discard_result();
+          });
+    }
+
+    ss::future<>
+    drain_partition(model::ntp ntp, std::size_t expected, report& r) {
+        return ss::do_with(
+          model::offset(0),
+          std::size_t(0),
+          [this, ntp, expected, &r](model::offset& next, std::size_t& read) {
+              return ss::do_until(
+                [&read, expected] { return read >= expected; },
+                [this, ntp, &next, &read, &r] {
+                    return drain(
+                             ntp,
+                             1,
+                             next,
+                             model::timeout_clock::now()
+                               + std::chrono::minutes(1))
+                      .then([&next, &read, &r](auto batches) {
+                          if (!batches || batches->empty()) {
+                              throw std::runtime_error(
+                                "Timed out draining the materialized topic");
+                          }
+                          const auto now = model::timestamp::now();
+                          for (const auto& b : *batches) {
+                              const auto lag_ms
+                                = now() - b.header().first_timestamp();
+                              r.lag_us.record(std::max<int64_t>(
+                                lag_ms * 1000, 1));
+                          }
+                          read += batches->size();
+                          r.output_batches += batches->size();
+                          next = ++batches->back().last_offset();
+                      });
+                });
+          });
+    }
+
+    static void print(const scenario& s, const report& r) {
+        const double secs = std::max<double>(
+          std::chrono::duration<double>(r.elapsed).count(), 1e-6);
+        fmt::print(
+          "coproc bench: transform:{} scripts:{} partitions:{} batches:{} "
+          "records/batch:{} codec:{} | records/s:{:.0f} MiB/s:{:.2f} "
+          "lag_ms p50:{} p90:{} p99:{} p999:{} max:{}\n",
+          s.transform == copro_typeid::filter_coprocessor ? "filter"
+                                                          : "identity",
+          s.scripts,
+          s.partitions,
+          s.batches,
+          s.records_per_batch,
+          s.codec,
+          r.input_records / secs,
+          r.input_bytes / secs / (1024 * 1024),
+          r.lag_us.get_value_at(50.0) / 1000,
+          r.lag_us.get_value_at(90.0) / 1000,
+          r.lag_us.get_value_at(99.0) / 1000,
+          r.lag_us.get_value_at(99.9) / 1000,
+          r.lag_us.get_value_at(100.0) / 1000);
+    }
+
+    uint64_t _runs{0};
+};
+
+FIXTURE_TEST(coproc_bench_scripts_by_partitions, coproc_throughput_fixture) {
+    for (std::size_t scripts : {1, 5, 10}) {
+        for (std::size_t partitions : {1, 4}) {
+            run({.scripts = scripts, .partitions = partitions});
+        }
+    }
+}
+
+FIXTURE_TEST(coproc_bench_batch_sizes, coproc_throughput_fixture) {
+    for (int records : {1, 10, 100, 1000}) {
+        run({.partitions = 2, .batches = 50, .records_per_batch = records});
+    }
+}
+
+FIXTURE_TEST(coproc_bench_compression, coproc_throughput_fixture) {
+    for (auto codec :
+         {model::compression::none,
+          model::compression::gzip,
+          model::compression::snappy,
+          model::compression::lz4,
+          model::compression::zstd}) {
+        run({.scripts = 2, .partitions = 2, .codec = codec});
+    }
+}
+
+FIXTURE_TEST(coproc_bench_filter, coproc_throughput_fixture) {
+    for (std::size_t scripts : {1, 5}) {
+        run(
+          {.scripts = scripts,
+           .partitions = 2,
+           .transform = copro_typeid::filter_coprocessor});
+    }
+}
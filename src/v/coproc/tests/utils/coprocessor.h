@@ -128,6 +128,33 @@ private:
     model::topic _identity_topic;
 };
 
+/// Keeps the batches with an even number of records, drops the others
+struct filter_coprocessor : public coprocessor {
+    filter_coprocessor(coproc::script_id sid, input_set input)
+      : coprocessor(sid, std::move(input)) {}
+
+    ss::future<coprocessor::result> apply(
+      const model::topic&,
+      ss::circular_buffer<model::record_batch>&& batches) override {
+        ss::circular_buffer<model::record_batch> kept;
+        for (auto& b : batches) {
+            if (b.record_count() % 2 == 0) {
+                kept.push_back(std::move(b));
+            }
+        }
+        coprocessor::result r;
+        r.emplace(filter_topic, std::move(kept));
+        return ss::make_ready_future<coprocessor::result>(std::move(r));
+    }
+
+    static absl::flat_hash_set<model::topic> output_topics() {
+        return {filter_topic};
+    };
+
+    static const inline model::topic filter_topic = model::topic(
+      "filter_topic");
+};
+
 struct throwing_coprocessor : public coprocessor {
     throwing_coprocessor(coproc::script_id sid, input_set input)
       : coprocessor(sid, std::move(input)) {}
@@ -206,7 +233,8 @@ enum class type_identifier {
     identity_coprocessor,
     unique_identity_coprocessor,
     throwing_coprocessor,
-    two_way_split_copro
+    two_way_split_copro,
+    filter_coprocessor
 };
 
 inline std::unique_ptr<coprocessor> make_coprocessor(
@@ -225,6 +253,8 @@ inline std::unique_ptr<coprocessor> make_coprocessor(
         return std::make_unique<throwing_coprocessor>(id, std::move(topics));
     case type_identifier::two_way_split_copro:
         return std::make_unique<two_way_split_copro>(id, std::move(topics));
+    case type_identifier::filter_coprocessor:
+        return std::make_unique<filter_coprocessor>(id, std::move(topics));
     default:
         return nullptr;
     };
@@ -72,6 +72,15 @@ honey_badger::points() const {
     return retval;
 }
 
+void honey_badger::set_io_fault(io_point p, io_fault f) {
+    vlog(log.info, "Setting io fault: {} - {}", to_string_view(p), f);
+    io(p).set(f);
+}
+void honey_badger::unset_io_fault(io_point p) {
+    vlog(log.info, "Unsetting io fault: {}", to_string_view(p));
+    io(p).unset();
+}
+
 honey_badger& shard_local_badger() {
     static thread_local honey_badger badger;
     return badger;
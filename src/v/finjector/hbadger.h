@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "finjector/io_probe.h"
 #include "seastarx.h"
 
 #include <seastar/core/shared_ptr.hh>
@@ -18,6 +19,8 @@
 
 #include <absl/container/node_hash_map.h>
 
+#include <array>
+
 namespace finjector {
 
 struct probe {
@@ -82,10 +85,21 @@ public:
     absl::node_hash_map<std::string_view, std::vector<std::string_view>>
     points() const;
 
+    /// Latency and bandwidth faults, available in all builds
+    io_probe& io(io_point p) { return _io_probes[static_cast<size_t>(p)]; }
+    void set_io_fault(io_point p, io_fault f);
+    void unset_io_fault(io_point p);
+
 private:
     absl::node_hash_map<std::string_view, probe*> _probes;
+    std::array<io_probe, io_points_count> _io_probes;
 };
 
 honey_badger& shard_local_badger();
 
+/// Inject the latency and bandwidth fault of the shard at the I/O point
+inline ss::future<> inject_io_fault(io_point p, size_t bytes) {
+    return shard_local_badger().io(p)(bytes);
+}
+
 } // namespace finjector
@@ -0,0 +1,77 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "finjector/io_probe.h"
+
+#include <seastar/core/sleep.hh>
+
+#include <fmt/ostream.h>
+
+#include <algorithm>
+
+namespace finjector {
+
+std::string_view to_string_view(io_point p) {
+    switch (p) {
+    case io_point::segment_write:
+        return "segment_write";
+    case io_point::rpc_send:
+        return "rpc_send";
+    case io_point::s3_request:
+        return "s3_request";
+    }
+    return "unknown";
+}
+
+std::optional<io_point> io_point_from_string(std::string_view name) {
+    for (size_t i = 0; i < io_points_count; ++i) {
+        auto p = static_cast<io_point>(i);
+        if (to_string_view(p) == name) {
+            return p;
+        }
+    }
+    return std::nullopt;
+}
+
+ss::future<> io_probe::inject(size_t bytes) {
+    using namespace std::chrono_literals;
+    const auto now = clock_type::now();
+    clock_type::duration wait{0};
+    if (_fault.bandwidth > 0) {
+        // the bytes pass the point after the ones ahead of them
+        auto transfer = std::chrono::duration_cast<clock_type::duration>(
+          std::chrono::microseconds(bytes * 1000000 / _fault.bandwidth));
+        _next_free = std::max(_next_free, now) + transfer;
+        wait = _next_free - now;
+    }
+    const auto roll = static_cast<double>(_prng()) / 4294967296.0;
+    if (roll < _fault.probability) {
+        wait += _fault.delay;
+        if (_fault.jitter > 0ms) {
+            wait += std::chrono::milliseconds(_prng() % _fault.jitter.count());
+        }
+    }
+    if (wait <= clock_type::duration{0}) {
+        return ss::now();
+    }
+    return ss::sleep(wait);
+}
+
+std::ostream& operator<<(std::ostream& o, const io_fault& f) {
+    fmt::print(
+      o,
+      "{{probability: {}, delay: {}ms, jitter: {}ms, bandwidth: {}}}",
+      f.probability,
+      f.delay.count(),
+      f.jitter.count(),
+      f.bandwidth);
+    return o;
+}
+
+} // namespace finjector
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "likely.h"
+#include "random/fast_prng.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/lowres_clock.hh>
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string_view>
+
+namespace finjector {
+
+/// The I/O paths the latency and bandwidth faults can be injected in
+enum class io_point : uint8_t {
+    /// dma writes of the segment appenders
+    segment_write = 0,
+    /// writes of the internal RPC clients to their sockets
+    rpc_send,
+    /// object store uploads and downloads
+    s3_request,
+};
+
+inline constexpr size_t io_points_count = 3;
+
+std::string_view to_string_view(io_point);
+std::optional<io_point> io_point_from_string(std::string_view);
+
+struct io_fault {
+    /// fraction of the operations that are delayed, in [0, 1]
+    double probability{1.0};
+    /// the delayed operations wait for delay + a uniform [0, jitter) extra
+    std::chrono::milliseconds delay{0};
+    std::chrono::milliseconds jitter{0};
+    /// bytes per second that pass the point, 0 is unlimited
+    uint64_t bandwidth{0};
+
+    bool is_set() const {
+        const bool delayed = delay.count() > 0 || jitter.count() > 0;
+        return bandwidth > 0 || (probability > 0 && delayed);
+    }
+
+    friend std::ostream& operator<<(std::ostream&, const io_fault&);
+};
+
+/**
+ * Latency and bandwidth fault injected in an I/O path, to reproduce slow
+ * devices and networks in performance tests. Unlike the failure probes it
+ * is available in the release builds; while no fault is set it costs a
+ * branch. The probes are shard local and owned by the honey badger.
+ */
+class io_probe {
+public:
+    using clock_type = ss::lowres_clock;
+
+    void set(io_fault f) {
+        _fault = f;
+        _armed = f.is_set();
+        _next_free = clock_type::now();
+    }
+    void unset() { set(io_fault{}); }
+    const io_fault& fault() const { return _fault; }
+
+    /// Delay the operation transferring the bytes according to the fault
+    ss::future<> operator()(size_t bytes) {
+        if (likely(!_armed)) {
+            return ss::now();
+        }
+        return inject(bytes);
+    }
+
+private:
+    ss::future<> inject(size_t bytes);
+
+    io_fault _fault;
+    bool _armed{false};
+    /// time at which the throttled bandwidth is available again
+    clock_type::time_point _next_free;
+    fast_prng _prng;
+};
+
+} // namespace finjector
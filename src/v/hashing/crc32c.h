@@ -12,10 +12,19 @@
 #pragma once
 #include <crc32c/crc32c.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 namespace crc {
 
+/// \brief CRC32C (Castagnoli) checksum
+///
+/// The underlying library detects SSE4.2 (x86) and CRC32 extension (ARMv8)
+/// at runtime and uses the hardware instructions with interleaved streams
+/// when they're available. Every call has a fixed dispatch overhead so the
+/// callers should prefer fewer calls with larger buffers.
 class crc32c {
 public:
     template<typename T, typename = std::enable_if_t<std::is_integral_v<T>, T>>
@@ -39,4 +48,61 @@ private:
     uint32_t _crc = 0;
 };
 
+namespace detail {
+
+// the reversed Castagnoli polynomial
+inline constexpr uint32_t crc32c_poly = 0x82f63b78;
+
+/// \brief a * b modulo the polynomial, in the reflected representation
+constexpr uint32_t crc32c_multmodp(uint32_t a, uint32_t b) noexcept {
+    uint32_t m = 1U << 31U;
+    uint32_t p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) {
+                break;
+            }
+        }
+        m >>= 1U;
+        b = (b & 1U) ? (b >> 1U) ^ crc32c_poly : b >> 1U;
+    }
+    return p;
+}
+
+/// x^(2^n) modulo the polynomial
+constexpr std::array<uint32_t, 32> crc32c_x2n_table() noexcept {
+    std::array<uint32_t, 32> table{};
+    uint32_t p = 1U << 30U; // x^1
+    table[0] = p;
+    for (size_t n = 1; n < table.size(); ++n) {
+        p = crc32c_multmodp(p, p);
+        table[n] = p;
+    }
+    return table;
+}
+
+inline constexpr auto crc32c_x2n = crc32c_x2n_table();
+
+} // namespace detail
+
+/// \brief the CRC32C of the concatenation of two buffers out of their
+/// checksums and of the size of the second one
+///
+/// It lets a buffer be checksummed as it is written and prefixed later on,
+/// e.g. the records of a batch before its header. The cost is logarithmic
+/// in the size of the second buffer.
+constexpr uint32_t
+crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2) noexcept {
+    // x^(8 * len2) modulo the polynomial
+    uint32_t p = 1U << 31U; // x^0
+    size_t k = 3;
+    for (size_t n = len2; n != 0; n >>= 1U, ++k) {
+        if (n & 1U) {
+            p = detail::crc32c_multmodp(detail::crc32c_x2n[k & 31U], p);
+        }
+    }
+    return detail::crc32c_multmodp(p, crc1) ^ crc2;
+}
+
 } // namespace crc
@@ -0,0 +1,46 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#define BOOST_TEST_MODULE crc32c
+#include "hashing/crc32c.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <string>
+
+static uint32_t checksum(const std::string& s) {
+    crc::crc32c crc;
+    crc.extend(s.data(), s.size());
+    return crc.value();
+}
+
+BOOST_AUTO_TEST_CASE(check_value) {
+    BOOST_CHECK_EQUAL(checksum("123456789"), 0xe3069283);
+}
+
+BOOST_AUTO_TEST_CASE(combine_same_as_concatenation) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (size_t a_len : {0, 1, 7, 100, 4096}) {
+        for (size_t b_len : {0, 1, 13, 1000, 70000}) {
+            std::string a(a_len, '\0');
+            std::string b(b_len, '\0');
+            for (auto& c : a) {
+                c = static_cast<char>(byte(rng));
+            }
+            for (auto& c : b) {
+                c = static_cast<char>(byte(rng));
+            }
+            BOOST_CHECK_EQUAL(
+              crc::crc32c_combine(checksum(a), checksum(b), b.size()),
+              checksum(a + b));
+        }
+    }
+}
@@ -7,17 +7,22 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 
+#include "bytes/iobuf.h"
+#include "bytes/utils.h"
 #include "hashing/crc32c.h"
 #include "hashing/fnv.h"
 #include "hashing/twang.h"
 #include "hashing/xx.h"
 #include "random/generators.h"
+#include "units.h"
 
 #include <seastar/core/reactor.hh>
 #include <seastar/testing/perf_tests.hh>
 
 #include <boost/crc.hpp>
 
+#include <array>
+
 static constexpr size_t step_bytes = 57;
 
 PERF_TEST(boost_crc16_fn, header_hash) {
@@ -72,3 +77,60 @@ PERF_TEST(xx64_twang_fn, header_hash) {
     perf_tests::do_not_optimize(o);
     perf_tests::stop_measuring_time();
 }
+
+PERF_TEST(crc32c_per_field, record_header) {
+    auto buffer = random_generators::gen_alphanum_string(step_bytes);
+    crc::crc32c crc;
+    perf_tests::start_measuring_time();
+    // the header has 8 fields of 2-8 bytes
+    static constexpr std::array<size_t, 8> fields = {2, 4, 8, 8, 8, 2, 4, 4};
+    size_t pos = 0;
+    for (auto sz : fields) {
+        crc.extend(buffer.data() + pos, sz);
+        pos += sz;
+    }
+    auto o = crc.value();
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(crc32c_packed, record_header) {
+    auto buffer = random_generators::gen_alphanum_string(step_bytes);
+    crc::crc32c crc;
+    perf_tests::start_measuring_time();
+    crc.extend(buffer.data(), 40);
+    auto o = crc.value();
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+
+static iobuf make_fragmented_iobuf(size_t fragment_size, size_t total) {
+    iobuf buf;
+    auto fragment = random_generators::gen_alphanum_string(fragment_size);
+    while (buf.size_bytes() < total) {
+        iobuf f;
+        f.append(fragment.data(), fragment.size());
+        buf.append_fragments(std::move(f));
+    }
+    return buf;
+}
+
+PERF_TEST(crc32c_iobuf_16KiB_fragments, record_batch) {
+    auto buf = make_fragmented_iobuf(16_KiB, 1_MiB);
+    crc::crc32c crc;
+    perf_tests::start_measuring_time();
+    crc_extend_iobuf(crc, buf);
+    auto o = crc.value();
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(crc32c_iobuf_512B_fragments, record_batch) {
+    auto buf = make_fragmented_iobuf(512, 1_MiB);
+    crc::crc32c crc;
+    perf_tests::start_measuring_time();
+    crc_extend_iobuf(crc, buf);
+    auto o = crc.value();
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
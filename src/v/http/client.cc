@@ -77,10 +77,17 @@ ss::future<client::request_response_t> client::make_request(
     auto target = header.target();
     auto req = ss::make_shared<request_stream>(this, std::move(header));
     auto res = ss::make_shared<response_stream>(this, verb);
-    if (is_valid()) {
+    // the connection can't be reused until the new response is received
+    const bool reusable = is_reusable();
+    _keep_alive = false;
+    if (is_valid() && reusable) {
+        _probe->register_connection_reuse();
         return ss::make_ready_future<request_response_t>(
           std::make_tuple(req, res));
     }
+    if (is_valid()) {
+        vlog(http_log.debug, "connection can't be reused, reconnecting");
+    }
     return get_connected(timeout)
       .then([req, res, target](reconnect_result_t r) {
           if (r == reconnect_result_t::timed_out) {
@@ -128,6 +135,7 @@ client::get_connected(ss::lowres_clock::duration timeout) {
             // this loop with the `stop` call.
             gate_guard gg(_connect_gate);
             co_await connect(current + interval);
+            _probe->register_connect();
             break;
         } catch (const std::system_error& err) {
             vlog(http_log.trace, "connection refused {}", err);
@@ -151,6 +159,16 @@ ss::future<> client::stop() {
 
 void client::fail_outstanding_futures() noexcept { shutdown(); }
 
+bool client::is_reusable() const {
+    return _keep_alive
+           && ss::lowres_clock::now() - _idle_since < _max_idle_time;
+}
+
+void client::on_response_done(bool keep_alive) {
+    _keep_alive = keep_alive;
+    _idle_since = ss::lowres_clock::now();
+}
+
 ss::future<ss::temporary_buffer<char>> client::receive() {
     return _in.read()
       .then([this](ss::temporary_buffer<char>&& tmpbuf) {
@@ -312,6 +330,12 @@ ss::future<iobuf> client::response_stream::recv_some() {
           }
           auto out = _parser.get().body().consume();
           _buffer.trim_front(noctets);
+          if (_parser.is_done()) {
+              // bytes past the end of the response mean that the stream is
+              // out of sync, the connection can't be reused
+              _client->on_response_done(
+                _parser.keep_alive() && _buffer.empty());
+          }
           if (!_buffer.empty()) {
               vlog(
                 http_log.trace,
@@ -61,6 +61,9 @@ using http_serializer
   = boost::beast::http::request_serializer<boost::beast::http::string_body>;
 
 constexpr ss::lowres_clock::duration default_connect_timeout = 5s;
+/// Kept alive connections idle for longer are reconnected before they are
+/// used, the servers close them on their side (S3 after about 20s)
+constexpr ss::lowres_clock::duration default_max_idle_time = 10s;
 
 enum class reconnect_result_t {
     connected,
@@ -99,6 +102,14 @@ public:
 
     void fail_outstanding_futures() noexcept override;
 
+    /// Set the time after which an idle connection is not reused
+    void set_max_idle_time(ss::lowres_clock::duration d) { _max_idle_time = d; }
+
+    /// Return true if the next request can be sent over the current
+    /// connection: the previous response was received in full, the server
+    /// didn't ask to close the connection and it wasn't idle for too long
+    bool is_reusable() const;
+
     // Response state machine
     class response_stream final
       : public ss::enable_shared_from_this<response_stream> {
@@ -234,7 +245,15 @@ private:
     /// Throw exception if _as is aborted
     void check() const;
 
+    /// Called when the whole response is received
+    void on_response_done(bool keep_alive);
+
     ss::gate _connect_gate;
+    ss::lowres_clock::duration _max_idle_time{default_max_idle_time};
+    /// Set when the last response completed and the connection can be
+    /// reused, reset as soon as the next request is made
+    bool _keep_alive{false};
+    ss::lowres_clock::time_point _idle_since;
     const ss::abort_source* _as;
     ss::shared_ptr<http::client_probe> _probe;
 };
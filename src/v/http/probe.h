@@ -95,6 +95,12 @@ public:
 
     void register_transport_error() { _transport_errors += 1; }
 
+    /// Register connection (or reconnection) to the server
+    void register_connect() { _connects += 1; }
+
+    /// Register request sent over the connection of a previous request
+    void register_connection_reuse() { _connection_reuses += 1; }
+
     /// Return total incomming traffic
     uint64_t get_inbound_bytes() const { return _in; }
 
@@ -104,6 +110,12 @@ public:
     /// Return total number of transport errors
     uint64_t get_transport_errors() const { return _transport_errors; }
 
+    /// Return total number of connections made
+    uint64_t get_connects() const { return _connects; }
+
+    /// Return total number of requests that reused a connection
+    uint64_t get_connection_reuses() const { return _connection_reuses; }
+
     /// Get total number of GET requests
     uint64_t get_total_get_requests() const { return _get_requests.total(); }
 
@@ -135,6 +147,10 @@ private:
     diff_counter _all_requests;
     /// Number of connection errors
     uint64_t _transport_errors;
+    /// Number of connections made
+    uint64_t _connects{0};
+    /// Number of requests sent over a kept alive connection
+    uint64_t _connection_reuses{0};
 };
 
 } // namespace http
\ No newline at end of file
@@ -313,6 +313,45 @@ SEASTAR_THREAD_TEST_CASE(test_http_GET_roundtrip) {
       });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_http_keep_alive) {
+    auto config = transport_configuration();
+    auto probe = ss::make_shared<http::client_probe>();
+    auto client = ss::make_shared<http::client>(config, nullptr, probe);
+    auto server = ss::make_shared<ss::httpd::http_server_control>();
+    server->start().get();
+    server->set_routes(set_routes).get();
+    server->listen(rpc::resolve_dns(config.server_addr).get()).get();
+
+    auto get = [&client, &config] {
+        http::client::request_header header;
+        header.method(boost::beast::http::verb::get);
+        header.target("/get");
+        header_set_host(header, config.server_addr);
+        auto [req, resp] = client->make_request(std::move(header)).get0();
+        req->send_some(iobuf()).get();
+        req->send_eof().get();
+        while (!resp->is_done()) {
+            resp->recv_some().get();
+        }
+    };
+
+    get();
+    BOOST_REQUIRE(client->is_reusable());
+    get();
+    BOOST_REQUIRE_EQUAL(probe->get_connects(), 1);
+    BOOST_REQUIRE_EQUAL(probe->get_connection_reuses(), 1);
+
+    // idle connections are reconnected
+    client->set_max_idle_time(0s);
+    BOOST_REQUIRE(!client->is_reusable());
+    get();
+    BOOST_REQUIRE_EQUAL(probe->get_connects(), 2);
+    BOOST_REQUIRE_EQUAL(probe->get_connection_reuses(), 1);
+
+    client->stop().get();
+    server->stop().get();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_http_PUT_roundtrip) {
     // Send data and recv empty response
     auto config = transport_configuration();
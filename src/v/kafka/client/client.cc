@@ -29,6 +29,7 @@
 #include "random/generators.h"
 #include "seastarx.h"
 #include "ssx/future-util.h"
+#include "storage/record_batch_builder.h"
 #include "utils/unresolved_address.h"
 
 #include <seastar/core/coroutine.hh>
@@ -47,7 +48,9 @@ namespace kafka::client {
 client::client(const YAML::Node& cfg)
   : _config{cfg}
   , _seeds{_config.brokers()}
-  , _topic_cache{}
+  , _topic_cache{
+      _config,
+      [this](model::node_id leader) { return _producer.in_flight(leader); }}
   , _brokers{_config}
   , _wait_or_start_update_metadata{[this](wait_or_start::tag tag) {
       return update_metadata(tag);
@@ -422,9 +425,13 @@ ss::future<kafka::fetch_response> client::consumer_fetch(
   const member_id& name,
   std::optional<std::chrono::milliseconds> timeout,
   std::optional<int32_t> max_bytes) {
-    const auto config_timout = _config.consumer_request_timeout.value();
+    // Long poll: wait for records up to the requested timeout, defaulting
+    // to consumer_request_timeout, bounded by consumer_request_max_wait
     const auto end = model::timeout_clock::now()
-                     + std::min(config_timout, timeout.value_or(config_timout));
+                     + std::min(
+                       _config.consumer_request_max_wait.value(),
+                       timeout.value_or(
+                         _config.consumer_request_timeout.value()));
     return gated_retry_with_mitigation([this, g_id, name, end, max_bytes]() {
         return get_consumer(g_id, name)
           .then([end, max_bytes](shared_consumer_t c) {
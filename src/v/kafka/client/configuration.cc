@@ -67,18 +67,38 @@ configuration::configuration()
       "Delay (in milliseconds) to wait before sending batch",
       config::required::no,
       100ms)
+  , produce_max_in_flight(
+      *this,
+      "produce_max_in_flight",
+      "Maximum number of batches in flight per partition, above 1 a retried "
+      "batch may be reordered",
+      config::required::no,
+      1)
   , consumer_request_timeout(
       *this,
       "consumer_request_timeout_ms",
       "Interval (in milliseconds) for consumer request timeout",
       config::required::no,
       100ms)
+  , consumer_request_max_wait(
+      *this,
+      "consumer_request_max_wait_ms",
+      "Maximum time (in milliseconds) a consumer fetch waits for records",
+      config::required::no,
+      30s)
   , consumer_request_max_bytes(
       *this,
       "consumer_request_max_bytes",
       "Max bytes to fetch per request",
       config::required::no,
       1_MiB)
+  , consumer_prefetch_max_bytes(
+      *this,
+      "consumer_prefetch_max_bytes",
+      "Max bytes of fetched records buffered per consumer, ahead of the "
+      "fetches. 0 disables the prefetch",
+      config::required::no,
+      4_MiB)
   , consumer_session_timeout(
       *this,
       "consumer_session_timeout_ms",
@@ -33,8 +33,11 @@ struct configuration final : public config::config_store {
     config::property<int32_t> produce_batch_record_count;
     config::property<int32_t> produce_batch_size_bytes;
     config::property<std::chrono::milliseconds> produce_batch_delay;
+    config::property<int32_t> produce_max_in_flight;
     config::property<std::chrono::milliseconds> consumer_request_timeout;
+    config::property<std::chrono::milliseconds> consumer_request_max_wait;
     config::property<int32_t> consumer_request_max_bytes;
+    config::property<size_t> consumer_prefetch_max_bytes;
     config::property<std::chrono::milliseconds> consumer_session_timeout;
     config::property<std::chrono::milliseconds> consumer_rebalance_timeout;
     config::property<std::chrono::milliseconds> consumer_heartbeat_interval;
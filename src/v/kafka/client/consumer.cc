@@ -34,6 +34,8 @@
 #include <seastar/core/loop.hh>
 #include <seastar/core/sleep.hh>
 
+#include <absl/container/flat_hash_set.h>
+
 #include <chrono>
 #include <exception>
 #include <iterator>
@@ -71,6 +73,24 @@ struct partition_comp {
     }
 };
 
+fetch_response make_fetch_response() {
+    return fetch_response{
+      .data = {
+        .throttle_time_ms{},
+        .error_code = error_code::none,
+        .session_id = kafka::invalid_fetch_session_id}};
+}
+
+size_t records_size(const fetch_response& res) {
+    size_t size = 0;
+    for (const auto& t : res.data.topics) {
+        for (const auto& p : t.partitions) {
+            size += p.records ? p.records->size_bytes() : 0;
+        }
+    }
+    return size;
+}
+
 fetch_response
 reduce_fetch_response(fetch_response result, fetch_response val) {
     result.data.throttle_time_ms += val.data.throttle_time_ms;
@@ -103,6 +123,7 @@ void consumer::start() {
 ss::future<> consumer::stop() {
     { auto t = std::move(_timer); }
     _as.request_abort();
+    _fetched.broken();
     return _coordinator->stop()
       .then([this]() { return _gate.close(); })
       .finally([me{shared_from_this()}] {});
@@ -331,23 +352,26 @@ consumer::offset_fetch(std::vector<offset_fetch_request_topic> topics) {
 ss::future<offset_commit_response>
 consumer::offset_commit(std::vector<offset_commit_request_topic> topics) {
     if (topics.empty()) { // commit all offsets
-        for (const auto& s : _fetch_sessions) {
-            auto res = s.second.make_offset_commit_request();
-            topics.insert(
-              topics.end(),
-              std::make_move_iterator(res.begin()),
-              std::make_move_iterator(res.end()));
-        }
-    } else { // set epoch for requests tps
-        for (auto& t : topics) {
-            for (auto& p : t.partitions) {
-                auto tp = model::topic_partition{t.name, p.partition_index};
-                auto leader = co_await _topic_cache.leader(tp);
-                auto broker = co_await _brokers.find(leader);
-                p.committed_leader_epoch = _fetch_sessions[broker].epoch();
+        // the positions of the records handed out, not of the prefetched
+        for (const auto& [t, po] : _positions) {
+            auto& topic = topics.emplace_back(
+              offset_commit_request_topic{.name = t, .partitions{}});
+            for (const auto& [p_id, o] : po) {
+                topic.partitions.push_back(offset_commit_request_partition{
+                  .partition_index = p_id,
+                  .committed_offset = o - model::offset(1)});
             }
         }
     }
+    // set epoch for requests tps
+    for (auto& t : topics) {
+        for (auto& p : t.partitions) {
+            auto tp = model::topic_partition{t.name, p.partition_index};
+            auto leader = co_await _topic_cache.leader(tp);
+            auto broker = co_await _brokers.find(leader);
+            p.committed_leader_epoch = _fetch_sessions[broker].epoch();
+        }
+    }
     auto req_builder = [me{shared_from_this()}, topics{std::move(topics)}]() {
         return offset_commit_request{.data{
           .group_id = me->_group_id,
@@ -362,28 +386,43 @@ consumer::offset_commit(std::vector<offset_commit_request_topic> topics) {
 ss::future<fetch_response>
 consumer::dispatch_fetch(broker_reqs_t::value_type br) {
     auto& [broker, req] = br;
+    auto& session = _fetch_sessions[broker];
+    session.sent(req);
     kclog.trace("Consumer: {}, fetch_req: {}", *this, req);
-    auto res = co_await broker->dispatch(std::move(req));
+    fetch_response res;
+    try {
+        res = co_await broker->dispatch(std::move(req));
+    } catch (...) {
+        // the broker may or may not have seen the request, start over
+        session.reset_session();
+        throw;
+    }
     kclog.trace("Consumer: {}, fetch_res: {}", *this, res);
 
     if (res.data.error_code != error_code::none) {
+        session.reset_session();
         throw broker_error(broker->id(), res.data.error_code);
     }
 
-    _fetch_sessions[broker].apply(res);
+    session.apply(res);
     co_return res;
 }
 
-ss::future<fetch_response> consumer::fetch(
+ss::future<consumer::broker_reqs_t> consumer::make_fetch_requests(
   std::chrono::milliseconds timeout, std::optional<int32_t> max_bytes) {
     // Split requests by broker
     broker_reqs_t broker_reqs;
+    absl::node_hash_map<
+      shared_broker_t,
+      absl::flat_hash_set<model::topic_partition>>
+      assigned;
     for (auto const& [t, ps] : _assignment) {
         for (const auto& p : ps) {
             auto tp = model::topic_partition{t, p};
             auto leader = co_await _topic_cache.leader(tp);
             auto broker = co_await _brokers.find(leader);
             auto& session = _fetch_sessions[broker];
+            assigned[broker].emplace(tp);
 
             auto& req = broker_reqs
                           .try_emplace(
@@ -402,6 +441,11 @@ ss::future<fetch_response> consumer::fetch(
                             }})
                           .first->second;
 
+            // The broker session already fetches the partition from its
+            // offset, an incremental fetch leaves it out
+            if (!session.needs_fetch(tp)) {
+                continue;
+            }
             if (req.data.topics.empty() || req.data.topics.back().name != t) {
                 req.data.topics.push_back(fetch_request::topic{.name{t}});
             }
@@ -415,16 +459,179 @@ ss::future<fetch_response> consumer::fetch(
         }
     }
 
-    co_return co_await ss::map_reduce(
-      std::make_move_iterator(broker_reqs.begin()),
-      std::make_move_iterator(broker_reqs.end()),
-      [this](broker_reqs_t::value_type br) {
-          return dispatch_fetch(std::move(br));
-      },
-      fetch_response{
-        .data
-        = {.throttle_time_ms{}, .error_code = error_code::none, .session_id = kafka::invalid_fetch_session_id}},
-      detail::reduce_fetch_response);
+    for (auto& [broker, req] : broker_reqs) {
+        req.data.forgotten = _fetch_sessions[broker].forgotten(
+          assigned[broker]);
+    }
+    co_return broker_reqs;
+}
+
+ss::future<fetch_response> consumer::fetch(
+  std::chrono::milliseconds timeout, std::optional<int32_t> max_bytes) {
+    if (_config.consumer_prefetch_max_bytes() == 0) {
+        auto broker_reqs = co_await make_fetch_requests(timeout, max_bytes);
+        auto res = co_await ss::map_reduce(
+          std::make_move_iterator(broker_reqs.begin()),
+          std::make_move_iterator(broker_reqs.end()),
+          [this](broker_reqs_t::value_type br) {
+              return dispatch_fetch(std::move(br));
+          },
+          detail::make_fetch_response(),
+          detail::reduce_fetch_response);
+        update_positions(res);
+        co_return res;
+    }
+
+    _prefetch_timeout = timeout;
+    _prefetch_max_bytes = max_bytes;
+    if (_prefetched.empty() && !_fetch_error) {
+        prefetch();
+        ++_fetch_waiters;
+        try {
+            co_await _fetched.wait(timeout, [this] {
+                return !_prefetched.empty() || _fetch_error;
+            });
+        } catch (const ss::condition_variable_timed_out&) {
+        }
+        --_fetch_waiters;
+    }
+    if (_prefetched.empty() && _fetch_error) {
+        std::rethrow_exception(std::exchange(_fetch_error, nullptr));
+    }
+    auto res = take_prefetched(max_bytes);
+    // keep the next fetch in flight while the response is consumed
+    prefetch();
+    co_return res;
+}
+
+void consumer::prefetch() {
+    if (
+      _prefetching
+      || _prefetched_bytes >= size_t(_config.consumer_prefetch_max_bytes())) {
+        return;
+    }
+    _prefetching = true;
+    (void)ss::try_with_gate(_gate, [this]() { return do_prefetch(); })
+      .handle_exception([this](std::exception_ptr e) {
+          vlog(kclog.debug, "Consumer: {}: prefetch failed: {}", *this, e);
+      })
+      .finally([this]() { _prefetching = false; });
+}
+
+ss::future<> consumer::do_prefetch() {
+    broker_reqs_t broker_reqs;
+    try {
+        broker_reqs = co_await make_fetch_requests(
+          _prefetch_timeout, _prefetch_max_bytes);
+    } catch (...) {
+        _fetch_error = std::current_exception();
+        _fetched.broadcast();
+        co_return;
+    }
+    for (auto& br : broker_reqs) {
+        // a single fetch in flight per broker, for the session epochs
+        if (!_fetching.emplace(br.first).second) {
+            continue;
+        }
+        (void)ss::try_with_gate(
+          _gate,
+          [this, br{std::move(br)}]() mutable {
+              return prefetch_broker(std::move(br));
+          })
+          .handle_exception([](std::exception_ptr e) {
+              vlog(kclog.trace, "prefetch stopped: {}", e);
+          });
+    }
+}
+
+ss::future<> consumer::prefetch_broker(broker_reqs_t::value_type br) {
+    auto broker = br.first;
+    try {
+        auto res = co_await dispatch_fetch(std::move(br));
+        const auto size = detail::records_size(res);
+        if (res.data.topics.size() != 0) {
+            _prefetched_bytes += size;
+            _prefetched.emplace_back(broker, std::move(res));
+        }
+    } catch (...) {
+        _fetch_error = std::current_exception();
+    }
+    _fetching.erase(broker);
+    _fetched.broadcast();
+    if (_fetch_waiters != 0 && !_fetch_error) {
+        // nothing for the waiting fetch yet, poll the broker again
+        prefetch();
+    }
+}
+
+fetch_response consumer::take_prefetched(std::optional<int32_t> max_bytes) {
+    const size_t limit = max_bytes.value_or(
+      _config.consumer_request_max_bytes());
+    auto res = detail::make_fetch_response();
+    size_t bytes = 0;
+    while (!_prefetched.empty() && bytes < limit) {
+        auto [broker, r] = std::move(_prefetched.front());
+        _prefetched.pop_front();
+        const auto size = detail::records_size(r);
+        _prefetched_bytes -= size;
+        bytes += size;
+        drop_unassigned(broker, r);
+        res = detail::reduce_fetch_response(std::move(res), std::move(r));
+    }
+    update_positions(res);
+    return res;
+}
+
+void consumer::drop_unassigned(
+  const shared_broker_t& broker, fetch_response& res) {
+    const auto is_assigned = [this](
+                               const model::topic& t, model::partition_id p) {
+        auto it = _assignment.find(t);
+        return it != _assignment.end()
+               && std::find(it->second.begin(), it->second.end(), p)
+                    != it->second.end();
+    };
+    for (auto& topic : res.data.topics) {
+        std::erase_if(topic.partitions, [&](const auto& p) {
+            if (is_assigned(topic.name, p.partition_index)) {
+                return false;
+            }
+            // the records weren't handed out, fetch them again from the
+            // position if the partition comes back
+            _fetch_sessions[broker].offset(
+              model::topic_partition_view(topic.name, p.partition_index),
+              position(topic.name, p.partition_index));
+            return true;
+        });
+    }
+    std::erase_if(
+      res.data.topics, [](const auto& t) { return t.partitions.empty(); });
+}
+
+model::offset
+consumer::position(const model::topic& t, model::partition_id p) const {
+    auto topic_it = _positions.find(t);
+    if (topic_it == _positions.end()) {
+        return model::offset{0};
+    }
+    auto part_it = topic_it->second.find(p);
+    return part_it == topic_it->second.end() ? model::offset{0}
+                                             : part_it->second;
+}
+
+void consumer::update_positions(fetch_response& res) {
+    for (auto& part : res) {
+        if (part.partition_response->error_code != error_code::none) {
+            continue;
+        }
+        auto& record_set = part.partition_response->records;
+        if (!record_set || record_set->empty()) {
+            continue;
+        }
+        _positions[part.partition->name]
+                  [part.partition_response->partition_index]
+          = ++record_set->last_offset();
+    }
 }
 
 ss::future<shared_consumer_t> make_consumer(
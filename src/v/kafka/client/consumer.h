@@ -23,8 +23,11 @@
 #include "kafka/protocol/offset_fetch.h"
 #include "kafka/types.h"
 
+#include <seastar/core/circular_buffer.hh>
+#include <seastar/core/condition-variable.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <absl/container/flat_hash_set.h>
 #include <absl/container/node_hash_map.h>
 #include <absl/hash/hash.h>
 
@@ -92,6 +95,22 @@ private:
     ss::future<describe_groups_response> describe_group();
 
     ss::future<fetch_response> dispatch_fetch(broker_reqs_t::value_type br);
+    ss::future<broker_reqs_t> make_fetch_requests(
+      std::chrono::milliseconds timeout, std::optional<int32_t> max_bytes);
+
+    /// \brief keeps a fetch in flight per broker of the assignment, in the
+    /// background, while less than consumer_prefetch_max_bytes are buffered
+    void prefetch();
+    ss::future<> do_prefetch();
+    ss::future<> prefetch_broker(broker_reqs_t::value_type br);
+    /// \brief the buffered responses, up to max_bytes of records
+    fetch_response take_prefetched(std::optional<int32_t> max_bytes);
+    /// \brief drops the partitions that were unassigned since the fetch
+    void drop_unassigned(const shared_broker_t& broker, fetch_response& res);
+
+    /// \brief the offset after the last record handed out
+    model::offset position(const model::topic& t, model::partition_id p) const;
+    void update_positions(fetch_response& res);
 
     template<typename RequestFactory>
     ss::future<
@@ -130,6 +149,21 @@ private:
     std::unique_ptr<assignment_plan> _plan{};
     assignment_t _assignment{};
     absl::node_hash_map<shared_broker_t, fetch_session> _fetch_sessions;
+    absl::node_hash_map<
+      model::topic,
+      absl::node_hash_map<model::partition_id, model::offset>>
+      _positions;
+
+    ss::circular_buffer<std::pair<shared_broker_t, fetch_response>>
+      _prefetched;
+    size_t _prefetched_bytes{0};
+    absl::flat_hash_set<shared_broker_t> _fetching;
+    bool _prefetching{false};
+    std::exception_ptr _fetch_error;
+    ss::condition_variable _fetched;
+    size_t _fetch_waiters{0};
+    std::chrono::milliseconds _prefetch_timeout{0};
+    std::optional<int32_t> _prefetch_max_bytes;
 
     friend std::ostream& operator<<(std::ostream& os, const consumer& c) {
         fmt::print(
@@ -30,13 +30,23 @@ model::offset fetch_session::offset(model::topic_partition_view tpv) const {
     return part_it->second;
 }
 
+void fetch_session::offset(
+  model::topic_partition_view tpv, model::offset offset) {
+    _offsets[tpv.topic][tpv.partition] = offset;
+}
+
 bool fetch_session::apply(fetch_response& res) {
     if (_id == invalid_fetch_session_id) {
         _id = fetch_session_id{res.data.session_id};
     }
     vassert(res.data.session_id == _id, "session mismatch: {}", *this);
 
-    ++_epoch;
+    if (_id == invalid_fetch_session_id) {
+        // sessionless, the next fetch is a full fetch again
+        _session_offsets.clear();
+    } else {
+        ++_epoch;
+    }
     for (auto& part : res) {
         if (part.partition_response->error_code != error_code::none) {
             continue;
@@ -56,6 +66,68 @@ bool fetch_session::apply(fetch_response& res) {
     return true;
 }
 
+bool fetch_session::needs_fetch(model::topic_partition_view tpv) const {
+    if (!is_incremental()) {
+        return true;
+    }
+    auto topic_it = _session_offsets.find(tpv.topic);
+    if (topic_it == _session_offsets.end()) {
+        return true;
+    }
+    auto part_it = topic_it->second.find(tpv.partition);
+    return part_it == topic_it->second.end() || part_it->second != offset(tpv);
+}
+
+std::vector<forgotten_topic> fetch_session::forgotten(
+  const absl::flat_hash_set<model::topic_partition>& assigned) const {
+    std::vector<forgotten_topic> res;
+    if (!is_incremental()) {
+        return res;
+    }
+    for (const auto& [t, po] : _session_offsets) {
+        for (const auto& [p_id, o] : po) {
+            if (assigned.contains(model::topic_partition(t, p_id))) {
+                continue;
+            }
+            if (res.empty() || res.back().name != t) {
+                res.push_back(forgotten_topic{.name = t});
+            }
+            res.back().forgotten_partition_indexes.push_back(p_id());
+        }
+    }
+    return res;
+}
+
+void fetch_session::sent(const fetch_request& req) {
+    if (req.is_full_fetch_request()) {
+        _session_offsets.clear();
+    }
+    for (const auto& t : req.data.topics) {
+        auto& po = _session_offsets[t.name];
+        for (const auto& p : t.fetch_partitions) {
+            po[p.partition_index] = p.fetch_offset;
+        }
+    }
+    for (const auto& ft : req.data.forgotten) {
+        auto topic_it = _session_offsets.find(ft.name);
+        if (topic_it == _session_offsets.end()) {
+            continue;
+        }
+        for (auto p_id : ft.forgotten_partition_indexes) {
+            topic_it->second.erase(model::partition_id(p_id));
+        }
+        if (topic_it->second.empty()) {
+            _session_offsets.erase(topic_it);
+        }
+    }
+}
+
+void fetch_session::reset_session() {
+    _id = invalid_fetch_session_id;
+    _epoch = initial_fetch_session_epoch;
+    _session_offsets.clear();
+}
+
 std::vector<offset_commit_request_topic>
 fetch_session::make_offset_commit_request() const {
     std::vector<offset_commit_request_topic> res;
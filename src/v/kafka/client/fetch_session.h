@@ -11,15 +11,18 @@
 
 #pragma once
 
+#include "kafka/protocol/schemata/fetch_request.h"
 #include "kafka/protocol/schemata/offset_commit_request.h"
 #include "kafka/types.h"
 #include "model/fundamental.h"
 
+#include <absl/container/flat_hash_set.h>
 #include <absl/container/node_hash_map.h>
 
 #include <iosfwd>
 
 namespace kafka {
+struct fetch_request;
 struct fetch_response;
 }
 
@@ -40,7 +43,27 @@ public:
     void id(kafka::fetch_session_id id) { _id = id; }
     kafka::fetch_session_epoch epoch() const { return _epoch; }
     model::offset offset(model::topic_partition_view tpv) const;
+    /// \brief rewinds the fetch offset, the broker session fetches the
+    /// partition from it again with the next fetch request
+    void offset(model::topic_partition_view tpv, model::offset offset);
     bool apply(fetch_response& res);
+
+    /// \brief the broker holds a session, the fetches can be incremental
+    bool is_incremental() const { return _id != invalid_fetch_session_id; }
+    /// \brief the broker session doesn't fetch the partition from its
+    /// offset, it has to be part of the next fetch request
+    bool needs_fetch(model::topic_partition_view tpv) const;
+    /// \brief the partitions of the broker session that aren't in assigned,
+    /// to forget in the next fetch request
+    std::vector<forgotten_topic> forgotten(
+      const absl::flat_hash_set<model::topic_partition>& assigned) const;
+    /// \brief tracks the partitions the broker session fetches, from the
+    /// partitions and the forgotten topics of a request
+    void sent(const fetch_request& req);
+    /// \brief drops the broker session, the next fetch is a full fetch. the
+    /// offsets are kept
+    void reset_session();
+
     std::vector<kafka::offset_commit_request_topic>
     make_offset_commit_request() const;
 
@@ -53,6 +76,11 @@ private:
       model::topic,
       absl::node_hash_map<model::partition_id, model::offset>>
       _offsets;
+    /// the fetch offsets of the broker session, as last sent
+    absl::node_hash_map<
+      model::topic,
+      absl::node_hash_map<model::partition_id, model::offset>>
+      _session_offsets;
 };
 
 } // namespace kafka::client
@@ -13,7 +13,10 @@
 
 #include "hashing/murmur.h"
 
+#include <seastar/core/lowres_clock.hh>
+
 #include <functional>
+#include <limits>
 #include <optional>
 #include <tuple>
 #include <type_traits>
@@ -59,6 +62,81 @@ private:
     model::partition_id _next;
 };
 
+class sticky_partitioner final : public partitioner_impl {
+public:
+    using clock_type = ss::lowres_clock;
+
+    sticky_partitioner(
+      model::partition_id initial,
+      sticky_partitioner_config cfg,
+      partition_load load)
+      : partitioner_impl{}
+      , _next(initial)
+      , _cfg(cfg)
+      , _load(std::move(load)) {}
+
+    std::optional<model::partition_id>
+    operator()(const record_essence& rec, size_t partition_count) override {
+        const auto now = clock_type::now();
+        if (
+          !_current || *_current >= model::partition_id(partition_count)
+          || _records >= _cfg.batch_record_count
+          || _bytes >= _cfg.batch_size_bytes
+          || now - _since >= _cfg.linger) {
+            _current = next(partition_count);
+            _since = now;
+            _records = 0;
+            _bytes = 0;
+        }
+        _records += 1;
+        _bytes += record_size(rec);
+        return _current;
+    }
+
+private:
+    static size_t record_size(const record_essence& rec) {
+        size_t size = (rec.key ? rec.key->size_bytes() : 0)
+                      + (rec.value ? rec.value->size_bytes() : 0);
+        for (const auto& h : rec.headers) {
+            size += h.key().size_bytes() + h.value().size_bytes();
+        }
+        return size;
+    }
+
+    /// The least loaded partition other than the current one, the ties go
+    /// to the next partition in round-robin order
+    model::partition_id next(size_t partition_count) {
+        const auto start = _next++ % partition_count;
+        auto best = model::partition_id(start);
+        if (!_load) {
+            return best;
+        }
+        auto best_load = std::numeric_limits<size_t>::max();
+        for (size_t i = 0; i < partition_count; ++i) {
+            auto p = model::partition_id((start + i) % partition_count);
+            if (p == _current && partition_count > 1) {
+                continue;
+            }
+            if (auto load = _load(p); load < best_load) {
+                best = p;
+                best_load = load;
+                if (load == 0) {
+                    break;
+                }
+            }
+        }
+        return best;
+    }
+
+    model::partition_id _next;
+    sticky_partitioner_config _cfg;
+    partition_load _load;
+    std::optional<model::partition_id> _current;
+    clock_type::time_point _since;
+    size_t _records{0};
+    size_t _bytes{0};
+};
+
 // Try each partitioner in the list until one succeeds.
 template<typename... Impls>
 class composed_partitioner final : public partitioner_impl {
@@ -108,4 +186,25 @@ partitioner default_partitioner(model::partition_id initial) {
       detail::roundrobin_partitioner{initial})};
 }
 
+partitioner sticky_partitioner(
+  model::partition_id initial,
+  sticky_partitioner_config cfg,
+  partition_load load) {
+    return partitioner{std::make_unique<detail::sticky_partitioner>(
+      initial, cfg, std::move(load))};
+}
+
+partitioner default_sticky_partitioner(
+  model::partition_id initial,
+  sticky_partitioner_config cfg,
+  partition_load load) {
+    return partitioner{std::make_unique<detail::composed_partitioner<
+      detail::identity_partitioner,
+      detail::murmur2_key_partitioner,
+      detail::sticky_partitioner>>(
+      detail::identity_partitioner{},
+      detail::murmur2_key_partitioner{},
+      detail::sticky_partitioner{initial, cfg, std::move(load)})};
+}
+
 } // namespace kafka::client
@@ -14,6 +14,10 @@
 #include "kafka/client/types.h"
 #include "model/fundamental.h"
 
+#include <seastar/util/noncopyable_function.hh>
+
+#include <chrono>
+
 namespace kafka::client {
 
 class partitioner_impl {
@@ -62,4 +66,31 @@ partitioner roundrobin_partitioner(model::partition_id initial);
 /// returns partition_id based on round-robin.
 partitioner default_partitioner(model::partition_id initial);
 
+/// \brief When the sticky partitioner moves on to the next partition
+struct sticky_partitioner_config {
+    size_t batch_record_count;
+    size_t batch_size_bytes;
+    std::chrono::milliseconds linger;
+};
+
+/// \brief The load of a partition, e.g. the requests in flight to its leader
+using partition_load = ss::noncopyable_function<size_t(model::partition_id)>;
+
+/// \brief Returns the same partition_id until the records sent to it fill a
+/// batch or the batch lingers out, then moves on to the least loaded
+/// partition, starting from \ref initial in round-robin fashion. Sticking
+/// to a partition makes larger batches of the keyless records (KIP-480)
+partitioner sticky_partitioner(
+  model::partition_id initial,
+  sticky_partitioner_config cfg,
+  partition_load load = nullptr);
+
+/// \brief Returns the partition_id if one exists in the record, or,
+/// returns the murmer2 hash of the key if there is one, or,
+/// returns the partition_id of the sticky partitioner.
+partitioner default_sticky_partitioner(
+  model::partition_id initial,
+  sticky_partitioner_config cfg,
+  partition_load load = nullptr);
+
 } // namespace kafka::client
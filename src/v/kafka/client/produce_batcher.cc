@@ -0,0 +1,126 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/client/produce_batcher.h"
+
+#include "bytes/iobuf_parser.h"
+#include "compression/compression.h"
+#include "storage/parser_utils.h"
+#include "storage/record_batch_builder.h"
+#include "units.h"
+#include "utils/vint.h"
+
+#include <seastar/core/smp.hh>
+
+#include <algorithm>
+#include <array>
+
+namespace kafka::client {
+
+namespace {
+
+/// payloads from this size are shared from the client batch, smaller ones
+/// are copied rather than adding a fragment per record
+constexpr size_t share_threshold = 1_KiB;
+
+/// \brief appends the records of the batch, rebased on the deltas
+void append_records(
+  iobuf& out,
+  model::record_batch batch,
+  int32_t offset_delta_base,
+  int64_t timestamp_delta_base) {
+    iobuf data = batch.compressed()
+                   ? compression::compressor::uncompress(
+                     batch.data(), batch.header().attrs.compression())
+                   : std::move(batch).release_data();
+    iobuf_parser in(std::move(data));
+    for (int32_t i = 0; i < batch.record_count(); ++i) {
+        const auto size = in.read_varlong().first;
+        const auto start = in.bytes_consumed();
+        auto attrs = in.consume_type<model::record_attributes::type>();
+        auto ts_delta = in.read_varlong().first;
+        auto offset_delta = in.read_varlong().first;
+        const size_t rest = size - (in.bytes_consumed() - start);
+
+        ts_delta += timestamp_delta_base;
+        offset_delta += offset_delta_base;
+        const int64_t new_size = sizeof(attrs) + vint::vint_size(ts_delta)
+                                 + vint::vint_size(offset_delta) + rest;
+
+        std::array<uint8_t, sizeof(attrs) + 3 * vint::max_length> hdr{};
+        size_t hdr_len = vint::serialize(new_size, hdr.data());
+        hdr[hdr_len++] = static_cast<uint8_t>(attrs);
+        hdr_len += vint::serialize(ts_delta, hdr.data() + hdr_len);
+        hdr_len += vint::serialize(offset_delta, hdr.data() + hdr_len);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        out.append(reinterpret_cast<const char*>(hdr.data()), hdr_len);
+
+        if (rest >= share_threshold) {
+            out.append(in.share(rest));
+        } else {
+            in.consume(rest, [&out](const char* src, size_t n) {
+                out.append(src, n);
+                return ss::stop_iteration::no;
+            });
+        }
+    }
+}
+
+} // namespace
+
+model::record_batch
+produce_batcher::concat_batches(std::vector<model::record_batch> batches) {
+    if (batches.empty()) {
+        return storage::record_batch_builder(
+                 model::record_batch_type::raft_data, model::offset(0))
+          .build();
+    }
+    if (batches.size() == 1) {
+        return std::move(batches.front());
+    }
+
+    const auto& first = batches.front().header();
+    model::record_batch_header header{
+      .size_bytes = 0,
+      .base_offset = model::offset(0),
+      .type = first.type,
+      .crc = 0, // crc computed later
+      .attrs = model::record_batch_attributes{},
+      .last_offset_delta = 0,
+      .first_timestamp = first.first_timestamp,
+      .max_timestamp = first.max_timestamp,
+      .producer_id = -1,
+      .producer_epoch = -1,
+      .base_sequence = -1,
+      .record_count = 0,
+      .ctx = model::record_batch_header::context(
+        model::term_id(0), ss::this_shard_id())};
+
+    iobuf records;
+    int32_t offset_delta = 0;
+    for (auto& b : batches) {
+        const auto& hdr = b.header();
+        const int32_t next_offset_delta = offset_delta + hdr.last_offset_delta
+                                          + 1;
+        header.record_count += hdr.record_count;
+        header.max_timestamp = std::max(
+          header.max_timestamp, hdr.max_timestamp);
+        const int64_t timestamp_delta = hdr.first_timestamp()
+                                        - header.first_timestamp();
+        append_records(records, std::move(b), offset_delta, timestamp_delta);
+        offset_delta = next_offset_delta;
+    }
+    header.last_offset_delta = offset_delta - 1;
+
+    storage::internal::reset_size_checksum_metadata(header, records);
+    return model::record_batch(
+      header, std::move(records), model::record_batch::tag_ctor_ng{});
+}
+
+} // namespace kafka::client
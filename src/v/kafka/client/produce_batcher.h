@@ -15,15 +15,16 @@
 #include "kafka/types.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
+#include "model/record.h"
 #include "raft/types.h"
 #include "seastarx.h"
-#include "storage/parser_utils.h"
-#include "storage/record_batch_builder.h"
 
 #include <seastar/core/circular_buffer.hh>
 
 #include <absl/container/flat_hash_map.h>
 
+#include <vector>
+
 namespace kafka::client {
 
 template<typename ContainerT>
@@ -46,11 +47,15 @@ typename ContainerT::value_type consume_front(ContainerT& c) {
 /// |   c_ctx0(2)   | c_ctx1(1) |       c_ctx2(3)      | client ctx(rec_count)
 /// |           b_bat0          |        b_bat1        | broker request batches
 /// |          b_ctx0(3)        |       b_ctx1(3)      | broker ctx(rec_count)
+///
+/// The client batches are kept encoded until consumed: a single batch is
+/// sent as is, several are concatenated by rewriting the header of each
+/// record, the keys, values and headers are not decoded.
 class produce_batcher {
 public:
     using partition_response = produce_response::partition;
     explicit produce_batcher()
-      : _builder{make_builder()}
+      : _batches{}
       , _client_reqs{}
       , _broker_reqs{} {}
 
@@ -72,17 +77,13 @@ public:
     };
 
     ss::future<partition_response> produce(model::record_batch&& batch) {
-        batch.for_each_record([this](model::record rec) {
-            _builder.add_raw_kw(
-              rec.release_key(), rec.release_value(), std::move(rec.headers()));
-        });
-
         _client_reqs.emplace_back(batch.record_count());
+        _batches.push_back(std::move(batch));
         return _client_reqs.back().promise.get_future();
     }
 
     model::record_batch consume() {
-        auto batch = std::exchange(_builder, make_builder()).build();
+        auto batch = concat_batches(std::exchange(_batches, {}));
         _broker_reqs.emplace_back(batch.record_count());
         return batch;
     }
@@ -111,12 +112,13 @@ public:
         }
     }
 
-private:
-    storage::record_batch_builder make_builder() {
-        return {model::record_batch_type::raft_data, model::offset(0)};
-    }
+    /// \brief a single batch of the records of the batches, in order. the
+    /// compressed batches are decompressed
+    static model::record_batch
+    concat_batches(std::vector<model::record_batch> batches);
 
-    storage::record_batch_builder _builder;
+private:
+    std::vector<model::record_batch> _batches;
     // TODO(Ben): Maybe these should be a queue for backpressure
     ss::circular_buffer<client_context> _client_reqs;
     ss::circular_buffer<broker_context> _broker_reqs;
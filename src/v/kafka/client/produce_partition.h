@@ -16,15 +16,21 @@
 #include "kafka/client/produce_batcher.h"
 #include "model/fundamental.h"
 
+#include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/timer.hh>
 #include <seastar/util/noncopyable_function.hh>
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
+
 namespace kafka::client {
 
 /// \brief Batch multiple client requests, flush them based on size or time.
+///
+/// Up to produce_max_in_flight batches are sent at once, their responses are
+/// handled in the order the batches were sent.
 class produce_partition {
 public:
     using response = produce_batcher::partition_response;
@@ -47,28 +53,43 @@ public:
     void handle_response(response&& res) {
         vassert(_in_flight, "handle_response requires a batch in flight");
         _batcher.handle_response(std::move(res));
-        _in_flight = false;
+        --_in_flight;
         try_consume(false);
     }
 
+    /// \brief handles the response once the responses of the batches sent
+    /// before it are handled. the future must not fail
+    void handle_response(ss::future<response> res) {
+        _responses = _responses.then([this, res{std::move(res)}]() mutable {
+            return std::move(res).then(
+              [this](response r) { handle_response(std::move(r)); });
+        });
+    }
+
     ss::future<> stop() {
         try_consume(true);
         _timer.cancel();
-        return ss::now();
+        return std::exchange(_responses, ss::now());
     }
 
 private:
     model::record_batch do_consume() {
-        vassert(!_in_flight, "do_consume should not run concurrently");
+        vassert(
+          _in_flight < max_in_flight(),
+          "do_consume exceeds the batches in flight");
 
-        _in_flight = true;
+        ++_in_flight;
         _record_count = 0;
         _size_bytes = 0;
         return _batcher.consume();
     }
 
+    size_t max_in_flight() const {
+        return std::max(_config.produce_max_in_flight(), 1);
+    }
+
     bool try_consume(bool timed_out) {
-        if (_in_flight || _record_count == 0) {
+        if (_in_flight >= max_in_flight() || _record_count == 0) {
             return false;
         }
 
@@ -94,7 +115,8 @@ private:
     consumer _consumer;
     int32_t _record_count{};
     int32_t _size_bytes{};
-    bool _in_flight{};
+    size_t _in_flight{};
+    ss::future<> _responses{ss::now()};
 };
 
 } // namespace kafka::client
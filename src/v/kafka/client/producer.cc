@@ -74,11 +74,20 @@ producer::produce(model::topic_partition tp, model::record_batch&& batch) {
 ss::future<produce_response::partition>
 producer::do_send(model::topic_partition tp, model::record_batch&& batch) {
     return _topic_cache.leader(tp)
-      .then([this](model::node_id leader) { return _brokers.find(leader); })
-      .then([tp{std::move(tp)},
-             batch{std::move(batch)}](shared_broker_t broker) mutable {
-          return broker->dispatch(
-            make_produce_request(std::move(tp), std::move(batch)));
+      .then([this, tp{std::move(tp)}, batch{std::move(batch)}](
+              model::node_id leader) mutable {
+          ++_in_flight[leader];
+          return _brokers.find(leader)
+            .then([tp{std::move(tp)},
+                   batch{std::move(batch)}](shared_broker_t broker) mutable {
+                return broker->dispatch(
+                  make_produce_request(std::move(tp), std::move(batch)));
+            })
+            .finally([this, leader] {
+                if (auto it = _in_flight.find(leader); --it->second == 0) {
+                    _in_flight.erase(it);
+                }
+            });
       })
       .then([](produce_response res) mutable {
           auto topic = std::move(res.data.responses[0]);
@@ -94,7 +103,7 @@ producer::do_send(model::topic_partition tp, model::record_batch&& batch) {
       });
 }
 
-ss::future<>
+ss::future<produce_response::partition>
 producer::send(model::topic_partition tp, model::record_batch&& batch) {
     auto record_count = batch.record_count();
     vlog(
@@ -124,14 +133,14 @@ producer::send(model::topic_partition tp, model::record_batch&& batch) {
       .handle_exception([p_id](std::exception_ptr ex) {
           return make_produce_response(p_id, std::move(ex));
       })
-      .then([this, tp, record_count](produce_response::partition res) mutable {
+      .then([tp, record_count](produce_response::partition res) mutable {
           vlog(
             kclog.debug,
             "sent record_batch: {}, {{record_count: {}}}, {}",
             tp,
             record_count,
             res.error_code);
-          get_context(std::move(tp))->handle_response(std::move(res));
+          return res;
       });
 }
 
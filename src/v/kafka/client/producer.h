@@ -17,8 +17,13 @@
 #include "model/fundamental.h"
 #include "ssx/future-util.h"
 
+#include <seastar/core/do_with.hh>
+#include <seastar/core/loop.hh>
+
 #include <absl/container/flat_hash_map.h>
 
+#include <vector>
+
 namespace kafka::client {
 
 class brokers;
@@ -45,21 +50,40 @@ public:
     ss::future<produce_response::partition>
     produce(model::topic_partition tp, model::record_batch&& batch);
 
+    /// \brief The produce requests in flight to the broker
+    size_t in_flight(model::node_id leader) const {
+        auto it = _in_flight.find(leader);
+        return it == _in_flight.end() ? 0 : it->second;
+    }
+
     ss::future<> stop() {
-        return ssx::parallel_transform(
-          std::move(_partitions),
-          [](partitions_t::value_type p) { return p.second->stop(); });
+        // the partitions flush on stop, they stay registered until their
+        // responses are handled
+        std::vector<shared_produce_partition> partitions;
+        partitions.reserve(_partitions.size());
+        for (auto& [tp, p] : _partitions) {
+            partitions.push_back(p);
+        }
+        return ss::do_with(
+          std::move(partitions),
+          [this](std::vector<shared_produce_partition>& partitions) {
+              return ss::parallel_for_each(
+                       partitions,
+                       [](shared_produce_partition& p) { return p->stop(); })
+                .then([this]() { _partitions.clear(); });
+          });
     }
 
 private:
-    ss::future<> send(model::topic_partition tp, model::record_batch&& batch);
+    ss::future<produce_response::partition>
+    send(model::topic_partition tp, model::record_batch&& batch);
 
     ss::future<produce_response::partition>
     do_send(model::topic_partition tp, model::record_batch&& batch);
 
     auto make_consumer(model::topic_partition tp) {
         return [this, tp](model::record_batch&& batch) {
-            (void)send(tp, std::move(batch));
+            get_context(tp)->handle_response(send(tp, std::move(batch)));
         };
     }
 
@@ -80,6 +104,7 @@ private:
     error_handler _error_handler;
     topic_cache& _topic_cache;
     brokers& _brokers;
+    absl::flat_hash_map<model::node_id, size_t> _in_flight;
 };
 
 } // namespace kafka::client
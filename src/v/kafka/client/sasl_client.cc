@@ -152,9 +152,9 @@ static ss::future<> do_authenticate_scram(
     security::client_final_message client_final(
       bytes("n,,"), server_first.nonce());
 
-    auto salted_password = ScramAlgo::hi(
+    auto salted_password = co_await ScramAlgo::hi_async(
       bytes(password.cbegin(), password.cend()),
-      server_first.salt(),
+      bytes(server_first.salt()),
       server_first.iterations());
 
     client_final.set_proof(ScramAlgo::client_proof(
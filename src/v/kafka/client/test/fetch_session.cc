@@ -156,3 +156,83 @@ SEASTAR_THREAD_TEST_CASE(test_fetch_session_make_offset_commit_request_all) {
     BOOST_REQUIRE_EQUAL(partition.committed_leader_epoch, ctx.expected_epoch);
     BOOST_REQUIRE_EQUAL(partition.committed_offset, ctx.expected_offset - 1);
 }
+
+kafka::fetch_request
+make_fetch_request(const kc::fetch_session& s, model::topic_partition tp) {
+    kafka::fetch_request req{
+      .data = {
+        .session_id = s.id(),
+        .session_epoch = s.epoch(),
+      }};
+    if (s.needs_fetch(tp)) {
+        req.data.topics.push_back(kafka::fetch_request::topic{.name{tp.topic}});
+        req.data.topics.back().fetch_partitions.push_back(
+          kafka::fetch_request::partition{
+            .partition_index = tp.partition, .fetch_offset = s.offset(tp)});
+    }
+    return req;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_fetch_session_incremental) {
+    context ctx;
+    kc::fetch_session s;
+
+    // No session, the partition is always fetched
+    BOOST_REQUIRE(!s.is_incremental());
+    BOOST_REQUIRE(s.needs_fetch(ctx.tp));
+
+    // Full fetch, the records move the offset past the session's
+    auto req = make_fetch_request(s, ctx.tp);
+    BOOST_REQUIRE_EQUAL(req.data.topics.size(), 1);
+    s.sent(req);
+    BOOST_REQUIRE(ctx.apply_fetch_response(s, 8));
+    BOOST_REQUIRE(s.is_incremental());
+    BOOST_REQUIRE(s.needs_fetch(ctx.tp));
+
+    // Incremental fetch without records, the session is up to date
+    req = make_fetch_request(s, ctx.tp);
+    BOOST_REQUIRE_EQUAL(req.data.topics.size(), 1);
+    s.sent(req);
+    BOOST_REQUIRE(ctx.apply_fetch_response(s, 0));
+    BOOST_REQUIRE(!s.needs_fetch(ctx.tp));
+    req = make_fetch_request(s, ctx.tp);
+    BOOST_REQUIRE(req.data.topics.empty());
+
+    // Unassigned partitions are forgotten
+    BOOST_REQUIRE(s.forgotten({ctx.tp}).empty());
+    auto forgotten = s.forgotten({});
+    BOOST_REQUIRE_EQUAL(forgotten.size(), 1);
+    BOOST_REQUIRE_EQUAL(forgotten[0].name, ctx.tp.topic);
+    BOOST_REQUIRE_EQUAL(forgotten[0].forgotten_partition_indexes.size(), 1);
+    BOOST_REQUIRE_EQUAL(
+      forgotten[0].forgotten_partition_indexes[0], ctx.tp.partition());
+    req.data.forgotten = std::move(forgotten);
+    s.sent(req);
+    BOOST_REQUIRE(s.needs_fetch(ctx.tp));
+
+    // Resetting the session keeps the offsets
+    s.reset_session();
+    BOOST_REQUIRE(!s.is_incremental());
+    BOOST_REQUIRE_EQUAL(s.id(), kafka::invalid_fetch_session_id);
+    BOOST_REQUIRE_EQUAL(s.epoch(), kafka::initial_fetch_session_epoch);
+    BOOST_REQUIRE_EQUAL(s.offset(ctx.tp), ctx.expected_offset);
+    BOOST_REQUIRE(s.needs_fetch(ctx.tp));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_fetch_session_rewind_offset) {
+    context ctx;
+    kc::fetch_session s;
+
+    auto req = make_fetch_request(s, ctx.tp);
+    s.sent(req);
+    BOOST_REQUIRE(ctx.apply_fetch_response(s, 8));
+    req = make_fetch_request(s, ctx.tp);
+    s.sent(req);
+    BOOST_REQUIRE(ctx.apply_fetch_response(s, 0));
+    BOOST_REQUIRE(!s.needs_fetch(ctx.tp));
+
+    // The records weren't consumed, the session fetches them again
+    s.offset(ctx.tp, model::offset{2});
+    BOOST_REQUIRE_EQUAL(s.offset(ctx.tp), model::offset{2});
+    BOOST_REQUIRE(s.needs_fetch(ctx.tp));
+}
@@ -76,3 +76,61 @@ BOOST_AUTO_TEST_CASE(test_default_partitioner) {
     BOOST_REQUIRE_EQUAL(*partitioner(match_key, 6), murmur2(a_key(), 6));
     BOOST_REQUIRE_EQUAL(*partitioner(match_none, 6), initial_partition);
 }
+
+static const auto no_linger = std::chrono::hours(1);
+
+BOOST_AUTO_TEST_CASE(test_sticky_partitioner_record_count) {
+    auto partitioner{kc::sticky_partitioner(
+      initial_partition,
+      {.batch_record_count = 3,
+       .batch_size_bytes = 1000,
+       .linger = no_linger})};
+    for (int i = 0; i < 3; ++i) {
+        BOOST_REQUIRE_EQUAL(*partitioner(match_none, 6), initial_partition);
+    }
+    for (int i = 0; i < 3; ++i) {
+        BOOST_REQUIRE_EQUAL(
+          *partitioner(match_none, 6), (initial_partition + 1) % 6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_sticky_partitioner_size_bytes) {
+    // the key is 7 bytes, two records fill a batch
+    auto partitioner{kc::sticky_partitioner(
+      initial_partition,
+      {.batch_record_count = 1000,
+       .batch_size_bytes = 10,
+       .linger = no_linger})};
+    BOOST_REQUIRE_EQUAL(*partitioner(match_key, 6), initial_partition);
+    BOOST_REQUIRE_EQUAL(*partitioner(match_key, 6), initial_partition);
+    BOOST_REQUIRE_EQUAL(
+      *partitioner(match_key, 6), (initial_partition + 1) % 6);
+}
+
+BOOST_AUTO_TEST_CASE(test_sticky_partitioner_least_loaded) {
+    const auto idle = model::partition_id{2};
+    auto partitioner{kc::sticky_partitioner(
+      initial_partition,
+      {.batch_record_count = 1,
+       .batch_size_bytes = 1000,
+       .linger = no_linger},
+      [idle](model::partition_id p) -> size_t { return p == idle ? 0 : 1; })};
+    BOOST_REQUIRE_EQUAL(*partitioner(match_none, 6), idle);
+    // moves on from the idle partition, to the next one in round-robin order
+    BOOST_REQUIRE_EQUAL(*partitioner(match_none, 6), model::partition_id{0});
+    BOOST_REQUIRE_EQUAL(*partitioner(match_none, 6), idle);
+}
+
+BOOST_AUTO_TEST_CASE(test_default_sticky_partitioner) {
+    auto partitioner{kc::default_sticky_partitioner(
+      initial_partition,
+      {.batch_record_count = 2,
+       .batch_size_bytes = 1000,
+       .linger = no_linger})};
+    BOOST_REQUIRE_EQUAL(*partitioner(match_partition, 6), a_partition);
+    BOOST_REQUIRE_EQUAL(*partitioner(match_key, 6), murmur2(a_key(), 6));
+    BOOST_REQUIRE_EQUAL(*partitioner(match_none, 6), initial_partition);
+    BOOST_REQUIRE_EQUAL(*partitioner(match_none, 6), initial_partition);
+    BOOST_REQUIRE_EQUAL(
+      *partitioner(match_none, 6), (initial_partition + 1) % 6);
+}
@@ -15,7 +15,9 @@
 #include "kafka/protocol/produce.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
+#include "model/record_utils.h"
 #include "reflection/adl.h"
+#include "storage/parser_utils.h"
 #include "storage/record_batch_builder.h"
 
 #include <seastar/core/when_all.hh>
@@ -168,3 +170,48 @@ SEASTAR_THREAD_TEST_CASE(test_partition_producer_error) {
 
     BOOST_REQUIRE(ctx.consume() == 0);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_partition_producer_concat) {
+    produce_batcher_context ctx;
+
+    auto single = make_batch(model::offset(0), 2);
+    auto single_crc = single.header().crc;
+    ctx.batcher.produce(std::move(single));
+    // a single batch is sent as is
+    auto batch = ctx.batcher.consume();
+    BOOST_REQUIRE_EQUAL(batch.header().crc, single_crc);
+
+    std::vector<model::record> expected;
+    for (int i = 0; i < 3; ++i) {
+        auto b = make_batch(model::offset(i * 3), 3);
+        if (i == 1) {
+            b = storage::internal::compress_batch(
+                  model::compression::lz4, std::move(b))
+                  .get0();
+        }
+        auto copy = b.copy();
+        if (copy.compressed()) {
+            copy = storage::internal::decompress_batch(std::move(copy)).get0();
+        }
+        copy.for_each_record(
+          [&expected](model::record r) { expected.push_back(std::move(r)); });
+        ctx.batcher.produce(std::move(b));
+    }
+    batch = ctx.batcher.consume();
+    BOOST_REQUIRE(!batch.compressed());
+    BOOST_REQUIRE_EQUAL(batch.record_count(), 9);
+    BOOST_REQUIRE_EQUAL(batch.header().last_offset_delta, 8);
+    BOOST_REQUIRE_EQUAL(
+      batch.header().crc,
+      model::crc_record_batch(batch.header(), batch.data()));
+
+    int32_t offset_delta = 0;
+    batch.for_each_record([&](model::record r) {
+        const auto& e = expected[offset_delta];
+        BOOST_REQUIRE_EQUAL(r.offset_delta(), offset_delta);
+        BOOST_REQUIRE_EQUAL(r.key(), e.key());
+        BOOST_REQUIRE_EQUAL(r.value(), e.value());
+        ++offset_delta;
+    });
+    BOOST_REQUIRE_EQUAL(offset_delta, 9);
+}
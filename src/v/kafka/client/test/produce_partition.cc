@@ -17,6 +17,8 @@
 #include "model/fundamental.h"
 #include "model/record.h"
 
+#include <seastar/core/future.hh>
+#include <seastar/core/later.hh>
 #include <seastar/testing/thread_test_case.hh>
 
 #include <boost/test/tools/old/interface.hpp>
@@ -65,3 +67,52 @@ SEASTAR_THREAD_TEST_CASE(test_produce_partition_record_count) {
     auto c_res2 = c_res2_fut.get0();
     BOOST_REQUIRE_EQUAL(c_res2.base_offset, model::offset{3});
 }
+
+SEASTAR_THREAD_TEST_CASE(test_produce_partition_in_flight) {
+    std::vector<model::record_batch> consumed_batches;
+    auto consumer = [&consumed_batches](model::record_batch&& batch) {
+        consumed_batches.push_back(std::move(batch));
+    };
+
+    auto cfg = kc::configuration{};
+    cfg.produce_batch_size_bytes.set_value(1024);
+    cfg.produce_batch_record_count.set_value(1);
+    // configuration under test
+    cfg.produce_max_in_flight.set_value(2);
+
+    kc::produce_partition producer(cfg, consumer);
+
+    auto c_res0_fut = producer.produce(make_batch(model::offset(0), 1));
+    auto c_res1_fut = producer.produce(make_batch(model::offset(1), 1));
+    auto c_res2_fut = producer.produce(make_batch(model::offset(2), 1));
+    // two batches in flight, the third waits
+    BOOST_REQUIRE_EQUAL(consumed_batches.size(), 2);
+
+    // the second response completes first, it's handled after the first
+    ss::promise<kafka::produce_response::partition> res0;
+    ss::promise<kafka::produce_response::partition> res1;
+    producer.handle_response(res0.get_future());
+    producer.handle_response(res1.get_future());
+    res1.set_value(kafka::produce_response::partition{
+      .partition_index{model::partition_id{42}},
+      .error_code = kafka::error_code::none,
+      .base_offset{model::offset{1}}});
+    ss::yield().get();
+    BOOST_REQUIRE(!c_res0_fut.available());
+    BOOST_REQUIRE(!c_res1_fut.available());
+
+    res0.set_value(kafka::produce_response::partition{
+      .partition_index{model::partition_id{42}},
+      .error_code = kafka::error_code::none,
+      .base_offset{model::offset{0}}});
+    BOOST_REQUIRE_EQUAL(c_res0_fut.get0().base_offset, model::offset{0});
+    BOOST_REQUIRE_EQUAL(c_res1_fut.get0().base_offset, model::offset{1});
+    BOOST_REQUIRE_EQUAL(consumed_batches.size(), 3);
+
+    producer.handle_response(kafka::produce_response::partition{
+      .partition_index{model::partition_id{42}},
+      .error_code = kafka::error_code::none,
+      .base_offset{model::offset{2}}});
+    BOOST_REQUIRE_EQUAL(c_res2_fut.get0().base_offset, model::offset{2});
+    producer.stop().get();
+}
@@ -16,8 +16,14 @@
 
 #include <seastar/core/future.hh>
 
+#include <algorithm>
+
 namespace kafka::client {
 
+topic_cache::topic_cache(const configuration& config, leader_load load)
+  : _config(config)
+  , _leader_load(std::move(load)) {}
+
 ss::future<>
 topic_cache::apply(std::vector<metadata_response::topic>&& topics) {
     topics_t cache;
@@ -27,7 +33,17 @@ topic_cache::apply(std::vector<metadata_response::topic>&& topics) {
           random_generators::get_int<model::partition_id::type>(
             t.partitions.size())};
         topic_data topic_data{
-          .partitioner_func = default_partitioner(initial_partition_id)};
+          .partitioner_func = default_sticky_partitioner(
+            initial_partition_id,
+            sticky_partitioner_config{
+              .batch_record_count = static_cast<size_t>(
+                std::max(_config.produce_batch_record_count(), 1)),
+              .batch_size_bytes = static_cast<size_t>(
+                std::max(_config.produce_batch_size_bytes(), 1)),
+              .linger = _config.produce_batch_delay()},
+            [this, topic = t.name](model::partition_id p) {
+                return load(topic, p);
+            })};
         auto& cache_t
           = cache.emplace(t.name, std::move(topic_data)).first->second;
         cache_t.partitions.reserve(t.partitions.size());
@@ -55,6 +71,16 @@ topic_cache::leader(model::topic_partition tp) const {
       partition_error(std::move(tp), error_code::unknown_topic_or_partition));
 }
 
+size_t topic_cache::load(const model::topic& t, model::partition_id p) const {
+    if (auto topic_it = _topics.find(t); topic_it != _topics.end()) {
+        const auto& parts = topic_it->second.partitions;
+        if (auto part_it = parts.find(p); part_it != parts.end()) {
+            return _leader_load(part_it->second.leader);
+        }
+    }
+    return 0;
+}
+
 ss::future<model::partition_id>
 topic_cache::partition_for(model::topic_view tv, const record_essence& rec) {
     if (auto topic_it = _topics.find(tv); topic_it != _topics.end()) {
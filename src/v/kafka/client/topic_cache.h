@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "kafka/client/configuration.h"
 #include "kafka/client/partitioners.h"
 #include "kafka/client/types.h"
 #include "kafka/protocol/metadata.h"
@@ -38,9 +39,15 @@ class topic_cache {
     using topics_t = absl::node_hash_map<model::topic, topic_data>;
 
 public:
-    topic_cache() = default;
+    /// \brief The requests in flight to the broker
+    using leader_load = ss::noncopyable_function<size_t(model::node_id)>;
+
+    /// \brief The keyless records stick to a partition for a batch of
+    /// the configured size, then move on to the partition whose leader is
+    /// the least loaded.
+    topic_cache(const configuration& config, leader_load load);
     topic_cache(const topic_cache&) = delete;
-    topic_cache(topic_cache&&) = default;
+    topic_cache(topic_cache&&) = delete;
     topic_cache& operator=(topic_cache const&) = delete;
     topic_cache& operator=(topic_cache&&) = delete;
     ~topic_cache() noexcept = default;
@@ -56,6 +63,10 @@ public:
     partition_for(model::topic_view tv, const record_essence& rec);
 
 private:
+    size_t load(const model::topic& t, model::partition_id p) const;
+
+    const configuration& _config;
+    leader_load _leader_load;
     /// \brief Cache of topic information.
     topics_t _topics;
 };
@@ -23,6 +23,12 @@ namespace kafka {
  * A record batch reader consumer that serializes a stream of batches to the
  * Kafka on-wire format. The primary use case for this is the fetch api which
  * returns a set of batches read from a redpanda log back to a kafka client.
+ *
+ * Batch headers and small batches are written to the arena. Payloads of
+ * large batches (usually shares of the batch cache or of the buffers read
+ * from the segment file) are linked into the result without copying. The
+ * arena is linked into the result using shared slices so appending the
+ * large payloads doesn't affect the allocation size of the headers.
  */
 class kafka_batch_serializer {
 public:
@@ -34,7 +40,7 @@ public:
     };
 
     kafka_batch_serializer() noexcept
-      : _wr(_buf) {}
+      : _wr(_arena) {}
 
     kafka_batch_serializer(const kafka_batch_serializer& o) = delete;
     kafka_batch_serializer& operator=(const kafka_batch_serializer& o) = delete;
@@ -42,7 +48,12 @@ public:
 
     kafka_batch_serializer(kafka_batch_serializer&& o) noexcept
       : _buf(std::move(o._buf))
-      , _wr(_buf) {}
+      , _arena(std::move(o._arena))
+      , _wr(_arena)
+      , _flushed(o._flushed)
+      , _base_offset(o._base_offset)
+      , _last_offset(o._last_offset)
+      , record_count_(o.record_count_) {}
 
     ss::future<ss::stop_iteration> operator()(model::record_batch&& batch) {
         if (unlikely(record_count_ == 0)) {
@@ -56,8 +67,16 @@ public:
     }
 
     result end_of_stream() {
+        iobuf data;
+        if (_buf.empty()) {
+            // no payloads were shared, the arena is the result
+            data = std::move(_arena);
+        } else {
+            flush_arena();
+            data = std::move(_buf);
+        }
         return result{
-          .data = std::move(_buf),
+          .data = std::move(data),
           .record_count = record_count_,
           .base_offset = _base_offset,
           .last_offset = _last_offset,
@@ -66,12 +85,30 @@ public:
 
 private:
     void write_batch(model::record_batch&& batch) {
-        writer_serialize_batch(_wr, std::move(batch));
+        if (batch.data().size_bytes() < zero_copy_min_bytes) {
+            writer_serialize_batch(_wr, std::move(batch));
+            return;
+        }
+        writer_serialize_batch_header(_wr, batch);
+        flush_arena();
+        _buf.append_fragments(std::move(batch).release_data());
+    }
+
+    /// Link the part of the arena that wasn't linked yet into the result
+    void flush_arena() {
+        auto len = _arena.size_bytes() - _flushed;
+        if (len == 0) {
+            return;
+        }
+        _buf.append_fragments(_arena.share(_flushed, len));
+        _flushed += len;
     }
 
 private:
     iobuf _buf;
+    iobuf _arena;
     response_writer _wr;
+    size_t _flushed{0};
     model::offset _base_offset;
     model::offset _last_offset;
     uint32_t record_count_ = 0;
@@ -17,6 +17,7 @@
 #include "kafka/server/request_context.h"
 #include "likely.h"
 #include "model/record.h"
+#include "model/record_utils.h"
 #include "raft/types.h"
 #include "storage/parser_utils.h"
 #include "vassert.h"
@@ -170,13 +171,14 @@ iobuf kafka_batch_adapter::adapt(iobuf&& kbatch) {
       header, std::move(records), model::record_batch::tag_ctor_ng{});
 
     /**
-     * Perform some type of validation on the uncompressed input. In this case
-     * we make sure that the records can be materialized but we avoid
-     * re-encoding them using the lazy-record optimization.
+     * Perform some type of validation on the uncompressed input. The records
+     * are appended as sent by the client, so we only check their framing:
+     * nothing is materialized nor copied out of the request buffer.
      */
     if (!new_batch.compressed()) {
         try {
-            new_batch.for_each_record([](model::record r) { (void)r; });
+            model::validate_records_framing(
+              new_batch.data(), new_batch.record_count());
         } catch (const std::exception& e) {
             vlog(klog.error, "Parsing uncompressed records: {}", e.what());
             return remainder;
@@ -0,0 +1,113 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/protocol/metadata.h"
+
+#include "kafka/protocol/response_writer.h"
+#include "vassert.h"
+
+namespace kafka {
+
+/*
+ * The encoders below write the same bytes as the generated encoder of
+ * metadata_response_data (see schemata/metadata_response.json), they have to
+ * be kept in sync when the supported versions change. Flexible versions
+ * (v9+) are not supported by the generator either.
+ */
+static constexpr api_version max_hand_encoded_version = api_version(8);
+
+static void write_topic(
+  response_writer& writer,
+  const metadata_response::topic& t,
+  api_version version) {
+    writer.write(t.error_code);
+    writer.write(t.name);
+    if (version >= api_version(1)) {
+        writer.write(t.is_internal);
+    }
+    writer.write_array(
+      t.partitions,
+      [version](
+        const metadata_response::partition& p, response_writer& writer) {
+          writer.write(p.error_code);
+          writer.write(p.partition_index);
+          writer.write(p.leader_id);
+          if (version >= api_version(7)) {
+              writer.write(p.leader_epoch);
+          }
+          writer.write_array(
+            p.replica_nodes, [](model::node_id n, response_writer& writer) {
+                writer.write(n);
+            });
+          writer.write_array(
+            p.isr_nodes, [](model::node_id n, response_writer& writer) {
+                writer.write(n);
+            });
+          if (version >= api_version(5)) {
+              writer.write_array(
+                p.offline_replicas,
+                [](model::node_id n, response_writer& writer) {
+                    writer.write(n);
+                });
+          }
+      });
+    if (version >= api_version(8)) {
+        writer.write(t.topic_authorized_operations);
+    }
+}
+
+iobuf metadata_response::encode_topic(const topic& t, api_version version) {
+    vassert(
+      version <= max_hand_encoded_version,
+      "unsupported metadata response version {}",
+      version);
+    iobuf buf;
+    response_writer writer(buf);
+    write_topic(writer, t, version);
+    return buf;
+}
+
+void metadata_response::encode_with_encoded_topics(
+  response_writer& writer, api_version version) {
+    vassert(
+      version <= max_hand_encoded_version,
+      "unsupported metadata response version {}",
+      version);
+    if (version >= api_version(3)) {
+        writer.write(data.throttle_time_ms);
+    }
+    writer.write_array(
+      data.brokers, [version](const broker& b, response_writer& writer) {
+          writer.write(b.node_id);
+          writer.write(b.host);
+          writer.write(b.port);
+          if (version >= api_version(1)) {
+              writer.write(b.rack);
+          }
+      });
+    if (version >= api_version(2)) {
+        writer.write(data.cluster_id);
+    }
+    if (version >= api_version(1)) {
+        writer.write(data.controller_id);
+    }
+    writer.write(int32_t(data.topics.size() + encoded_topics.size()));
+    for (const auto& t : data.topics) {
+        write_topic(writer, t, version);
+    }
+    for (auto& t : encoded_topics) {
+        writer.write_direct(std::move(t));
+    }
+    encoded_topics.clear();
+    if (version >= api_version(8)) {
+        writer.write(data.cluster_authorized_operations);
+    }
+}
+
+} // namespace kafka
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "bytes/iobuf.h"
 #include "kafka/protocol/schemata/metadata_request.h"
 #include "kafka/protocol/schemata/metadata_response.h"
 #include "model/metadata.h"
@@ -19,6 +20,7 @@
 #include <seastar/core/future.hh>
 
 #include <chrono>
+#include <vector>
 
 namespace kafka {
 
@@ -70,13 +72,28 @@ struct metadata_response {
 
     metadata_response_data data;
 
+    /// Topics that are already encoded (e.g. shared from the metadata
+    /// response cache), written to the response after `data.topics`
+    std::vector<iobuf> encoded_topics;
+
     void encode(response_writer& writer, api_version version) {
-        data.encode(writer, version);
+        if (encoded_topics.empty()) {
+            data.encode(writer, version);
+            return;
+        }
+        encode_with_encoded_topics(writer, version);
     }
 
+    /// Encodes a single topic exactly like it is encoded as an element of the
+    /// topics array of the response
+    static iobuf encode_topic(const topic&, api_version);
+
     void decode(iobuf buf, api_version version) {
         data.decode(std::move(buf), version);
     }
+
+private:
+    void encode_with_encoded_topics(response_writer&, api_version);
 };
 
 inline std::ostream& operator<<(std::ostream& os, const metadata_response& r) {
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/iobuf.h"
+#include "kafka/protocol/errors.h"
+#include "kafka/protocol/schemata/offset_for_leader_epoch_request.h"
+#include "kafka/protocol/schemata/offset_for_leader_epoch_response.h"
+#include "kafka/types.h"
+#include "model/fundamental.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+
+namespace kafka {
+
+struct offset_for_leader_epoch_response;
+
+struct offset_for_leader_epoch_api final {
+    using response_type = offset_for_leader_epoch_response;
+
+    static constexpr const char* name = "offset for leader epoch";
+    static constexpr api_key key = api_key(23);
+};
+
+struct offset_for_leader_epoch_request final {
+    using api_type = offset_for_leader_epoch_api;
+
+    offset_for_leader_epoch_request_data data;
+
+    void encode(response_writer& writer, api_version version) {
+        data.encode(writer, version);
+    }
+
+    void decode(request_reader& reader, api_version version) {
+        data.decode(reader, version);
+    }
+};
+
+inline std::ostream&
+operator<<(std::ostream& os, const offset_for_leader_epoch_request& r) {
+    return os << r.data;
+}
+
+struct offset_for_leader_epoch_response final {
+    using api_type = offset_for_leader_epoch_api;
+
+    offset_for_leader_epoch_response_data data;
+
+    void encode(response_writer& writer, api_version version) {
+        data.encode(writer, version);
+    }
+
+    void decode(iobuf buf, api_version version) {
+        data.decode(std::move(buf), version);
+    }
+};
+
+inline std::ostream&
+operator<<(std::ostream& os, const offset_for_leader_epoch_response& r) {
+    return os << r.data;
+}
+
+} // namespace kafka
@@ -0,0 +1,256 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/iobuf.h"
+#include "kafka/types.h"
+#include "likely.h"
+#include "seastarx.h"
+#include "utils/concepts-enabled.h"
+#include "utils/utf8.h"
+
+#include <seastar/core/sstring.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace kafka {
+
+/**
+ * Reader decoding a request in place, used by the generated view types.
+ *
+ * Unlike request_reader it doesn't allocate: strings are returned as views
+ * into the fragments of the request buffer and arrays are decoded lazily by
+ * array_view. The only exception are strings spanning two fragments of the
+ * buffer, those are copied to the spill storage of the request_view.
+ *
+ * The reader is cheap to copy, array views keep a copy positioned at the
+ * beginning of the array.
+ */
+class view_reader {
+public:
+    // list, the addresses of the spilled strings have to be stable
+    using spill_t = std::list<ss::sstring>;
+
+    view_reader(iobuf& buf, spill_t& spill) noexcept
+      : _buf(&buf)
+      , _spill(&spill)
+      , _in(buf.cbegin(), buf.cend()) {}
+
+    size_t bytes_consumed() const { return _in.bytes_consumed(); }
+    bool read_bool() { return bool(_in.consume_type<int8_t>()); }
+    int8_t read_int8() { return _in.consume_type<int8_t>(); }
+    int16_t read_int16() { return _in.consume_be_type<int16_t>(); }
+    int32_t read_int32() { return _in.consume_be_type<int32_t>(); }
+    int64_t read_int64() { return _in.consume_be_type<int64_t>(); }
+
+    std::string_view read_string() { return do_read_string(read_int16()); }
+
+    std::optional<std::string_view> read_nullable_string() {
+        auto n = read_int16();
+        if (n < 0) {
+            return std::nullopt;
+        }
+        return do_read_string(n);
+    }
+
+    /// Shares the fragments of the request buffer, the data isn't copied
+    std::optional<iobuf> read_fragmented_nullable_bytes() {
+        auto len = read_int32();
+        if (len < 0) {
+            return std::nullopt;
+        }
+        auto ret = _buf->share(_in.bytes_consumed(), len);
+        _in.skip(len);
+        return ret;
+    }
+
+private:
+    std::string_view do_read_string(int16_t n) {
+        if (unlikely(n < 0)) {
+            throw std::out_of_range("Asked to read a negative byte string");
+        }
+        std::string_view ret;
+        if (likely(_in.segment_bytes_left() >= static_cast<size_t>(n))) {
+            _in.consume(n, [&ret](const char* src, size_t len) {
+                ret = std::string_view(src, len);
+                return ss::stop_iteration::no;
+            });
+        } else {
+            auto& str = _spill->emplace_back(ss::uninitialized_string(n));
+            _in.consume_to(str.size(), str.begin());
+            ret = str;
+        }
+        validate_utf8(ret);
+        return ret;
+    }
+
+    iobuf* _buf;
+    spill_t* _spill;
+    iobuf::iterator_consumer _in;
+};
+
+/// Element parser of an array of generated view structs
+template<typename T>
+struct view_struct_parser {
+    T operator()(view_reader& reader, api_version version) const {
+        T ret;
+        ret.decode(reader, version);
+        return ret;
+    }
+};
+
+/// Element parser of an array of scalars, `Read` is a view_reader method
+template<typename T, auto Read>
+struct view_scalar_parser {
+    T operator()(view_reader& reader, api_version) const {
+        return T((reader.*Read)());
+    }
+};
+
+/**
+ * Array of a request decoded lazily.
+ *
+ * Constructing the view only skips the elements, every iteration decodes them
+ * again from the request buffer. The view must not outlive the request_view
+ * it belongs to.
+ */
+template<typename T, typename Parser = view_struct_parser<T>>
+class array_view {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator() = default;
+        iterator(view_reader reader, int32_t left, api_version version)
+          : _reader(reader)
+          , _left(left)
+          , _version(version) {
+            next();
+        }
+
+        reference operator*() const { return *_current; }
+        pointer operator->() const { return &*_current; }
+
+        iterator& operator++() {
+            next();
+            return *this;
+        }
+        void operator++(int) { next(); }
+
+        bool operator==(const iterator& o) const {
+            return _left == o._left
+                   && _current.has_value() == o._current.has_value();
+        }
+        bool operator!=(const iterator& o) const { return !(*this == o); }
+
+    private:
+        void next() {
+            if (_left <= 0) {
+                _current.reset();
+                return;
+            }
+            --_left;
+            _current = Parser{}(*_reader, _version);
+        }
+
+        std::optional<view_reader> _reader;
+        int32_t _left{0};
+        api_version _version{0};
+        std::optional<T> _current;
+    };
+
+    array_view() = default;
+
+    static array_view read(view_reader& reader, api_version version) {
+        return array_view(reader, reader.read_int32(), version);
+    }
+
+    static std::optional<array_view>
+    read_nullable(view_reader& reader, api_version version) {
+        auto len = reader.read_int32();
+        if (len < 0) {
+            return std::nullopt;
+        }
+        return array_view(reader, len, version);
+    }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    iterator begin() const {
+        if (!_start) {
+            return iterator();
+        }
+        return iterator(*_start, _size, _version);
+    }
+    iterator end() const { return iterator(); }
+
+private:
+    array_view(view_reader& reader, int32_t len, api_version version)
+      : _start(reader)
+      , _size(std::max(0, len))
+      , _version(version) {
+        // leave the reader after the array
+        Parser parser;
+        for (int32_t i = 0; i < _size; ++i) {
+            (void)parser(reader, version);
+        }
+    }
+
+    std::optional<view_reader> _start;
+    int32_t _size{0};
+    api_version _version{0};
+};
+
+/**
+ * Request decoded in place into a generated view type, e.g.
+ * request_view<fetch_request_data_view>. Owns the request buffer the views
+ * point into.
+ */
+template<typename T>
+class request_view {
+public:
+    request_view(iobuf buf, api_version version)
+      : _state(std::make_unique<state>(std::move(buf))) {
+        view_reader reader(_state->buf, _state->spill);
+        _data.decode(reader, version);
+    }
+
+    const T& data() const { return _data; }
+    const T* operator->() const { return &_data; }
+
+private:
+    // heap allocated, the views keep pointers to the buffer
+    struct state {
+        explicit state(iobuf b)
+          : buf(std::move(b)) {}
+        iobuf buf;
+        view_reader::spill_t spill;
+    };
+
+    std::unique_ptr<state> _state;
+    T _data;
+};
+
+} // namespace kafka
@@ -19,6 +19,7 @@
 #include "model/fundamental.h"
 #include "model/timestamp.h"
 #include "seastarx.h"
+#include "units.h"
 #include "utils/concepts-enabled.h"
 #include "utils/vint.h"
 
@@ -34,6 +35,13 @@ namespace kafka {
 
 class response_writer;
 void writer_serialize_batch(response_writer& w, model::record_batch&& batch);
+void writer_serialize_batch_header(
+  response_writer& w, const model::record_batch& batch);
+
+/// Payloads of at least this size are linked into the response by sharing
+/// their fragments instead of being copied. Smaller payloads are cheaper to
+/// copy than to track as separate fragments.
+inline constexpr size_t zero_copy_min_bytes = 16_KiB;
 
 class response_writer {
     template<typename ExplicitIntegerType, typename IntegerType>
@@ -117,7 +125,13 @@ public:
         }
         auto size = serialize_int<int32_t>(data->size_bytes())
                     + data->size_bytes();
-        _out->append(std::move(*data));
+        if (data->size_bytes() >= zero_copy_min_bytes) {
+            // record sets are shares of the batch cache memory, avoid
+            // copying them into the response
+            _out->append_fragments(std::move(*data));
+        } else {
+            _out->append(std::move(*data));
+        }
         return size;
     }
 
@@ -237,8 +251,8 @@ private:
     iobuf* _out;
 };
 
-inline void
-writer_serialize_batch(response_writer& w, model::record_batch&& batch) {
+inline void writer_serialize_batch_header(
+  response_writer& w, const model::record_batch& batch) {
     /*
      * calculate batch size expected by kafka client.
      *
@@ -260,9 +274,9 @@ writer_serialize_batch(response_writer& w, model::record_batch&& batch) {
                 - sizeof(int32_t);
 
     w.write(int64_t(batch.base_offset()));
-    w.write(int32_t(size)); // batch length
-    w.write(int32_t(0));    // partition leader epoch
-    w.write(int8_t(2));     // magic
+    w.write(int32_t(size));           // batch length
+    w.write(int32_t(batch.term()())); // partition leader epoch
+    w.write(int8_t(2));               // magic
     w.write(batch.header().crc);
     w.write(int16_t(batch.header().attrs.value()));
     w.write(int32_t(batch.header().last_offset_delta));
@@ -272,6 +286,11 @@ writer_serialize_batch(response_writer& w, model::record_batch&& batch) {
     w.write(int16_t(batch.header().producer_epoch));
     w.write(int32_t(batch.header().base_sequence));
     w.write(int32_t(batch.record_count()));
+}
+
+inline void
+writer_serialize_batch(response_writer& w, model::record_batch&& batch) {
+    writer_serialize_batch_header(w, batch);
     w.write_direct(std::move(batch).release_data());
 }
 
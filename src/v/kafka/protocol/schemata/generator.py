@@ -241,10 +241,26 @@ path_type_map = {
                 "HighWatermark": ("model::offset", "int64"),
                 "LastStableOffset": ("model::offset", "int64"),
                 "LogStartOffset": ("model::offset", "int64"),
+                "PreferredReadReplica": ("model::node_id", "int32"),
                 "Records": ("kafka::batch_reader", "fetch_record_set"),
             },
         },
     },
+    "OffsetForLeaderEpochRequestData": {
+        "Topics": {
+            "Partitions": {
+                "Partition": ("model::partition_id", "int32"),
+            },
+        },
+    },
+    "OffsetForLeaderEpochResponseData": {
+        "Topics": {
+            "Partitions": {
+                "Partition": ("model::partition_id", "int32"),
+                "EndOffset": ("model::offset", "int64"),
+            },
+        },
+    },
     "InitProducerIdRequestData": {
         "TransactionTimeoutMs": ("std::chrono::milliseconds", "int32")
     },
@@ -300,6 +316,17 @@ struct_renames = {
 # yapf: enable
 
 
+# requests of the hot paths for which view types decoding the request in place
+# are generated next to the owned structs. see kafka/protocol/request_view.h
+VIEW_MESSAGES = [
+    "ProduceRequest",
+    "FetchRequest",
+    "MetadataRequest",
+    "HeartbeatRequest",
+    "OffsetCommitRequest",
+]
+
+
 def make_context_field(path):
     """
     For a given path return a special field to be added to a generated
@@ -670,6 +697,64 @@ class Field:
         assert plain_decoder[1]
         return plain_decoder[1], named_type
 
+    def _view_scalar(self):
+        """
+        Resolve the type and decoder of a scalar in a view. Strings and
+        buffers are not wrapped in named types, they point into the request.
+        """
+        plain_decoder, named_type = self._redpanda_decoder()
+        native = plain_decoder[0]
+        if native == "ss::sstring":
+            return "std::string_view", plain_decoder, None
+        if native == "iobuf":
+            return "iobuf", plain_decoder, None
+        if native in ("bytes", "batch_reader"):
+            raise Exception(f"No view decoder for {self._path}")
+        if named_type is None:
+            return native, plain_decoder, None
+        return named_type, plain_decoder, named_type
+
+    @property
+    def view_type_name(self):
+        """
+        The type of the field in a view: strings are std::string_view, arrays
+        are array_view and nullable fields are optional.
+        """
+        if self.is_array:
+            value_type = self._type.value_type()
+            if value_type.is_struct:
+                name = f"array_view<{value_type.name}_view>"
+            else:
+                t, decoder, _ = self._view_scalar()
+                # method name of the decoder, e.g. read_int32() -> read_int32
+                read = decoder[1][:-len("()")]
+                name = f"array_view<{t}, view_scalar_parser<{t}, &view_reader::{read}>>"
+        else:
+            name = self._view_scalar()[0]
+        if self.nullable():
+            return f"std::optional<{name}>"
+        return name
+
+    @property
+    def view_decoder(self):
+        assert not self.is_array
+        _, plain_decoder, named_type = self._view_scalar()
+        if self.nullable():
+            # only strings and buffers are nullable
+            assert named_type is None
+            assert plain_decoder[2]
+            return plain_decoder[2], None
+        assert plain_decoder[1]
+        return plain_decoder[1], named_type
+
+    @property
+    def view_array_type(self):
+        assert self.is_array
+        name = self.view_type_name
+        if self.nullable():
+            return name[len("std::optional<"):-len(">")]
+        return name
+
     @property
     def is_array(self):
         return isinstance(self._type, ArrayType)
@@ -702,6 +787,9 @@ HEADER_TEMPLATE = """
 #include "model/metadata.h"
 #include "kafka/protocol/batch_reader.h"
 #include "kafka/protocol/errors.h"
+{%- if views %}
+#include "kafka/protocol/request_view.h"
+{%- endif %}
 #include "model/timestamp.h"
 #include "seastarx.h"
 
@@ -710,6 +798,9 @@ HEADER_TEMPLATE = """
 #include <chrono>
 #include <cstdint>
 #include <optional>
+{%- if views %}
+#include <string_view>
+{%- endif %}
 #include <vector>
 
 {% macro render_struct(struct) %}
@@ -731,6 +822,25 @@ struct {{ struct.name }} {
 {%- endif %}
 {% endmacro %}
 
+{% macro render_view_struct(struct) %}
+/*
+ * View of the {{ struct.name }} message decoded in place from the request
+ * buffer, see kafka/protocol/request_view.h
+ */
+struct {{ struct.name }}_view {
+{%- for field in struct.fields %}
+    {%- set info = field.type_name %}
+    {%- if info[1] != None %}
+    {{ field.view_type_name }} {{ field.name }}{{'{'}}{{info[1]}}{{'}'}};
+    {%- else %}
+    {{ field.view_type_name }} {{ field.name }}{ {{- field.default_value() -}} };
+    {%- endif %}
+{%- endfor %}
+
+    void decode(view_reader&, api_version);
+};
+{% endmacro %}
+
 namespace kafka {
 
 class request_reader;
@@ -755,6 +865,12 @@ class response;
     friend std::ostream& operator<<(std::ostream&, const {{ struct.name }}&);
 };
 
+{%- if views %}
+{% for struct in struct.structs() + [struct] %}
+{{ render_view_struct(struct) }}
+{% endfor %}
+{%- endif %}
+
 }
 """
 
@@ -857,6 +973,28 @@ writer.write({{ fname }});
 {%- endif %}
 {%- endmacro %}
 
+{% macro view_field_decoder(field, obj) %}
+{%- if obj %}
+{%- set fname = obj + "." + field.name %}
+{%- else %}
+{%- set fname = field.name %}
+{%- endif %}
+{%- if field.is_array %}
+{%- if field.nullable() %}
+{{ fname }} = {{ field.view_array_type }}::read_nullable(reader, version);
+{%- else %}
+{{ fname }} = {{ field.view_array_type }}::read(reader, version);
+{%- endif %}
+{%- else %}
+{%- set decoder, named_type = field.view_decoder %}
+{%- if named_type == None %}
+{{ fname }} = reader.{{ decoder }};
+{%- else %}
+{{ fname }} = {{ named_type }}(reader.{{ decoder }});
+{%- endif %}
+{%- endif %}
+{%- endmacro %}
+
 {% macro struct_serde(struct, field_serde, obj = "") %}
 {%- for field in struct.fields %}
 {%- call version_guard(field) %}
@@ -893,6 +1031,18 @@ void {{ struct.name }}::decode(iobuf, api_version) {}
 {%- endif %}
 {%- endif %}
 
+{%- if views %}
+{% for struct in struct.structs() + [struct] %}
+{%- if struct.fields %}
+void {{ struct.name }}_view::decode(view_reader& reader, [[maybe_unused]] api_version version) {
+{{- struct_serde(struct, view_field_decoder) | indent }}
+}
+{%- else %}
+void {{ struct.name }}_view::decode(view_reader&, api_version) {}
+{%- endif %}
+{% endfor %}
+{%- endif %}
+
 {% set structs = struct.structs() + [struct] %}
 {% for struct in structs %}
 {%- if struct.fields %}
@@ -1077,15 +1227,20 @@ if __name__ == "__main__":
     # request or response
     op_type = msg["type"]
 
+    # generate the in place decoding views
+    views = msg["name"] in VIEW_MESSAGES
+
     with open(hdr, 'w') as f:
         f.write(
             jinja2.Template(HEADER_TEMPLATE).render(
                 struct=struct,
                 render_struct_comment=render_struct_comment,
-                op_type=op_type))
+                op_type=op_type,
+                views=views))
 
     with open(src, 'w') as f:
         f.write(
             jinja2.Template(SOURCE_TEMPLATE).render(struct=struct,
                                                     header=hdr.name,
-                                                    op_type=op_type))
+                                                    op_type=op_type,
+                                                    views=views))
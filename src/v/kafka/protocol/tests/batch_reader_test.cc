@@ -14,7 +14,9 @@
 #include "kafka/protocol/exceptions.h"
 #include "kafka/protocol/kafka_batch_adapter.h"
 #include "model/fundamental.h"
+#include "random/generators.h"
 #include "redpanda/tests/fixture.h"
+#include "storage/record_batch_builder.h"
 #include "storage/tests/utils/random_batch.h"
 
 #include <seastar/core/circular_buffer.hh>
@@ -221,3 +223,45 @@ SEASTAR_THREAD_TEST_CASE(batch_reader_record_batch_reader_impl_fail_magic) {
           return e.error == kafka::error_code::corrupt_message;
       });
 }
+
+SEASTAR_THREAD_TEST_CASE(batch_reader_large_batches_zero_copy) {
+    auto input = storage::test::make_random_batches(base_offset, few_batches);
+    auto next = input.back().last_offset() + model::offset(1);
+    // batches above the zero-copy threshold are linked into the result
+    // while the small ones are copied, both must read back intact
+    for (int i = 0; i < 3; ++i) {
+        storage::record_batch_builder builder(
+          model::record_batch_type::raft_data, next);
+        auto value = random_generators::gen_alphanum_string(
+          kafka::zero_copy_min_bytes * 2);
+        iobuf v;
+        v.append(value.data(), value.size());
+        builder.add_raw_kv(std::nullopt, std::move(v));
+        input.push_back(std::move(builder).build());
+        input.push_back(storage::test::make_random_batch(
+          input.back().last_offset() + model::offset(1), 1, false));
+        next = input.back().last_offset() + model::offset(1);
+    }
+    const auto last_offset = input.back().last_offset();
+    size_t num_batches = input.size();
+
+    auto res = model::make_memory_record_batch_reader(std::move(input))
+                 .consume(kafka::kafka_batch_serializer{}, model::no_timeout)
+                 .get();
+    BOOST_REQUIRE_EQUAL(res.base_offset, base_offset);
+    BOOST_REQUIRE_EQUAL(res.last_offset, last_offset);
+
+    auto crs = kafka::batch_reader(std::move(res.data));
+    size_t consumed = 0;
+    model::offset consumed_last{};
+    while (!crs.empty()) {
+        auto kba = crs.consume_batch();
+        BOOST_REQUIRE(kba.v2_format);
+        BOOST_REQUIRE(kba.valid_crc);
+        BOOST_REQUIRE(kba.batch);
+        consumed_last = kba.batch->last_offset();
+        ++consumed;
+    }
+    BOOST_REQUIRE_EQUAL(consumed, num_batches);
+    BOOST_REQUIRE_EQUAL(consumed_last, last_offset);
+}
@@ -0,0 +1,87 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf.h"
+#include "kafka/protocol/metadata.h"
+#include "kafka/protocol/response_writer.h"
+#include "model/fundamental.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace {
+
+kafka::metadata_response::topic make_topic(ss::sstring name, int partitions) {
+    kafka::metadata_response::topic t;
+    t.error_code = kafka::error_code::none;
+    t.name = model::topic(std::move(name));
+    t.is_internal = false;
+    t.topic_authorized_operations = 12;
+    for (int i = 0; i < partitions; ++i) {
+        kafka::metadata_response::partition p;
+        p.error_code = kafka::error_code::none;
+        p.partition_index = model::partition_id(i);
+        p.leader_id = model::node_id(i % 3);
+        p.leader_epoch = 0;
+        p.replica_nodes = {
+          model::node_id(0), model::node_id(1), model::node_id(2)};
+        p.isr_nodes = p.replica_nodes;
+        t.partitions.push_back(std::move(p));
+    }
+    return t;
+}
+
+kafka::metadata_response make_response() {
+    kafka::metadata_response r;
+    r.data.brokers.push_back(kafka::metadata_response::broker{
+      .node_id = model::node_id(0),
+      .host = "localhost",
+      .port = 9092,
+      .rack = "rack-a"});
+    r.data.brokers.push_back(kafka::metadata_response::broker{
+      .node_id = model::node_id(1), .host = "localhost", .port = 9093});
+    r.data.cluster_id = "cluster";
+    r.data.controller_id = model::node_id(1);
+    r.data.cluster_authorized_operations = 7;
+    return r;
+}
+
+iobuf encode(kafka::metadata_response& r, kafka::api_version v) {
+    iobuf buf;
+    kafka::response_writer writer(buf);
+    r.encode(writer, v);
+    return buf;
+}
+
+} // namespace
+
+// the response with encoded topics has to be identical to the one encoded
+// entirely by the generated code
+BOOST_AUTO_TEST_CASE(metadata_response_with_encoded_topics) {
+    for (int16_t v = 0; v <= 8; ++v) {
+        auto version = kafka::api_version(v);
+        std::vector<kafka::metadata_response::topic> topics{
+          make_topic("a", 3), make_topic("b", 0), make_topic("c", 10)};
+
+        auto expected_response = make_response();
+        expected_response.data.topics = topics;
+        auto expected = encode(expected_response, version);
+
+        auto response = make_response();
+        response.data.topics.push_back(topics[0]);
+        response.encoded_topics.push_back(
+          kafka::metadata_response::encode_topic(topics[1], version));
+        response.encoded_topics.push_back(
+          kafka::metadata_response::encode_topic(topics[2], version));
+        auto encoded = encode(response, version);
+
+        BOOST_REQUIRE_EQUAL(encoded, expected);
+    }
+}
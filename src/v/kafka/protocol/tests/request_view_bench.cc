@@ -0,0 +1,162 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf.h"
+#include "kafka/protocol/fetch.h"
+#include "kafka/protocol/heartbeat.h"
+#include "kafka/protocol/offset_commit.h"
+#include "kafka/protocol/request_reader.h"
+#include "kafka/protocol/request_view.h"
+#include "kafka/protocol/response_writer.h"
+#include "model/fundamental.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+#include <fmt/format.h>
+
+namespace {
+
+template<typename T>
+iobuf encode(T& data, kafka::api_version v) {
+    iobuf buf;
+    kafka::response_writer writer(buf);
+    data.encode(writer, v);
+    return buf;
+}
+
+// a consumer fetching from many partitions of a few topics
+iobuf fetch_request(kafka::api_version v) {
+    kafka::fetch_request_data data;
+    data.max_wait_ms = std::chrono::milliseconds(500);
+    data.isolation_level = model::isolation_level::read_uncommitted;
+    for (int t = 0; t < 10; ++t) {
+        kafka::fetch_topic topic{
+          .name = model::topic(fmt::format("benchmark-topic-{}", t))};
+        for (int p = 0; p < 32; ++p) {
+            topic.fetch_partitions.push_back(kafka::fetch_partition{
+              .partition_index = model::partition_id(p),
+              .fetch_offset = model::offset(p * 1000),
+              .max_bytes = 1048576,
+            });
+        }
+        data.topics.push_back(std::move(topic));
+    }
+    return encode(data, v);
+}
+
+iobuf offset_commit_request(kafka::api_version v) {
+    kafka::offset_commit_request_data data{
+      .group_id = kafka::group_id("benchmark-consumer-group"),
+      .generation_id = 10,
+      .member_id = kafka::member_id(
+        "consumer-1-4b8b0c36-4ed8-4f0b-8d3f-6ef90c0c3e5f")};
+    for (int t = 0; t < 4; ++t) {
+        kafka::offset_commit_request_topic topic{
+          .name = model::topic(fmt::format("benchmark-topic-{}", t))};
+        for (int p = 0; p < 16; ++p) {
+            topic.partitions.push_back(kafka::offset_commit_request_partition{
+              .partition_index = model::partition_id(p),
+              .committed_offset = model::offset(p * 1000),
+              .committed_metadata = "",
+            });
+        }
+        data.topics.push_back(std::move(topic));
+    }
+    return encode(data, v);
+}
+
+iobuf heartbeat_request(kafka::api_version v) {
+    kafka::heartbeat_request_data data{
+      .group_id = kafka::group_id("benchmark-consumer-group"),
+      .generation_id = kafka::generation_id(10),
+      .member_id = kafka::member_id(
+        "consumer-1-4b8b0c36-4ed8-4f0b-8d3f-6ef90c0c3e5f")};
+    return encode(data, v);
+}
+
+template<typename Owned>
+void bench_owned(iobuf& request, kafka::api_version v) {
+    auto buf = request.share(0, request.size_bytes());
+    perf_tests::start_measuring_time();
+    Owned data;
+    kafka::request_reader reader(std::move(buf));
+    data.decode(reader, v);
+    perf_tests::do_not_optimize(data);
+    perf_tests::stop_measuring_time();
+}
+
+// the views are iterated to compare the same amount of decoding work
+template<typename View, typename Visitor>
+void bench_view(iobuf& request, kafka::api_version v, Visitor&& visit) {
+    auto buf = request.share(0, request.size_bytes());
+    perf_tests::start_measuring_time();
+    kafka::request_view<View> view(std::move(buf), v);
+    visit(view.data());
+    perf_tests::do_not_optimize(view);
+    perf_tests::stop_measuring_time();
+}
+
+} // namespace
+
+PERF_TEST(fetch_request, decode_owned) {
+    static const kafka::api_version v(11);
+    static auto request = fetch_request(v);
+    bench_owned<kafka::fetch_request_data>(request, v);
+}
+
+PERF_TEST(fetch_request, decode_view) {
+    static const kafka::api_version v(11);
+    static auto request = fetch_request(v);
+    bench_view<kafka::fetch_request_data_view>(
+      request, v, [](const kafka::fetch_request_data_view& data) {
+          int64_t sum = 0;
+          for (const auto& t : data.topics) {
+              for (const auto& p : t.fetch_partitions) {
+                  sum += p.fetch_offset();
+              }
+          }
+          perf_tests::do_not_optimize(sum);
+      });
+}
+
+PERF_TEST(offset_commit_request, decode_owned) {
+    static const kafka::api_version v(7);
+    static auto request = offset_commit_request(v);
+    bench_owned<kafka::offset_commit_request_data>(request, v);
+}
+
+PERF_TEST(offset_commit_request, decode_view) {
+    static const kafka::api_version v(7);
+    static auto request = offset_commit_request(v);
+    bench_view<kafka::offset_commit_request_data_view>(
+      request, v, [](const kafka::offset_commit_request_data_view& data) {
+          int64_t sum = 0;
+          for (const auto& t : data.topics) {
+              for (const auto& p : t.partitions) {
+                  sum += p.committed_offset();
+              }
+          }
+          perf_tests::do_not_optimize(sum);
+      });
+}
+
+PERF_TEST(heartbeat_request, decode_owned) {
+    static const kafka::api_version v(3);
+    static auto request = heartbeat_request(v);
+    bench_owned<kafka::heartbeat_request_data>(request, v);
+}
+
+PERF_TEST(heartbeat_request, decode_view) {
+    static const kafka::api_version v(3);
+    static auto request = heartbeat_request(v);
+    bench_view<kafka::heartbeat_request_data_view>(
+      request, v, [](const kafka::heartbeat_request_data_view& data) {
+          perf_tests::do_not_optimize(data.member_id);
+      });
+}
@@ -0,0 +1,240 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf.h"
+#include "bytes/iobuf_parser.h"
+#include "kafka/protocol/fetch.h"
+#include "kafka/protocol/heartbeat.h"
+#include "kafka/protocol/metadata.h"
+#include "kafka/protocol/offset_commit.h"
+#include "kafka/protocol/request_reader.h"
+#include "kafka/protocol/request_view.h"
+#include "kafka/protocol/response_writer.h"
+#include "model/fundamental.h"
+
+#include <boost/test/unit_test.hpp>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+template<typename T>
+iobuf encode(T& data, kafka::api_version v) {
+    iobuf buf;
+    kafka::response_writer writer(buf);
+    data.encode(writer, v);
+    return buf;
+}
+
+// copy of the buffer split into fragments of given size, strings crossing the
+// fragments are spilled by the views
+iobuf fragmented(const iobuf& buf, size_t fragment_size) {
+    iobuf_const_parser parser(buf);
+    auto data = parser.read_bytes(buf.size_bytes());
+    iobuf ret;
+    for (size_t i = 0; i < data.size(); i += fragment_size) {
+        iobuf frag;
+        frag.append(
+          data.data() + i, std::min(fragment_size, data.size() - i));
+        ret.append_fragments(std::move(frag));
+    }
+    return ret;
+}
+
+kafka::fetch_request_data make_fetch_request() {
+    kafka::fetch_request_data data;
+    data.replica_id = -1;
+    data.max_wait_ms = std::chrono::milliseconds(500);
+    data.min_bytes = 1;
+    data.max_bytes = 52428800;
+    data.isolation_level = model::isolation_level::read_committed;
+    data.session_id = 12;
+    data.session_epoch = 3;
+    for (int t = 0; t < 3; ++t) {
+        kafka::fetch_topic topic{
+          .name = model::topic(fmt::format("a-longer-topic-name-{}", t))};
+        for (int p = 0; p < 4; ++p) {
+            topic.fetch_partitions.push_back(kafka::fetch_partition{
+              .partition_index = model::partition_id(p),
+              .current_leader_epoch = 2,
+              .fetch_offset = model::offset(p * 100),
+              .log_start_offset = 0,
+              .max_bytes = 1048576,
+            });
+        }
+        data.topics.push_back(std::move(topic));
+    }
+    data.forgotten.push_back(kafka::forgotten_topic{
+      .name = model::topic("forgotten"),
+      .forgotten_partition_indexes = {1, 3, 5}});
+    data.rack_id = "rack-a";
+    return data;
+}
+
+void check_fetch_request(
+  const kafka::fetch_request_data& expected,
+  const kafka::fetch_request_data_view& view) {
+    BOOST_REQUIRE_EQUAL(view.replica_id, expected.replica_id);
+    BOOST_REQUIRE(view.max_wait_ms == expected.max_wait_ms);
+    BOOST_REQUIRE_EQUAL(view.min_bytes, expected.min_bytes);
+    BOOST_REQUIRE_EQUAL(view.max_bytes, expected.max_bytes);
+    BOOST_REQUIRE(view.isolation_level == expected.isolation_level);
+    BOOST_REQUIRE_EQUAL(view.session_id, expected.session_id);
+    BOOST_REQUIRE_EQUAL(view.session_epoch, expected.session_epoch);
+    BOOST_REQUIRE_EQUAL(view.rack_id, std::string_view(expected.rack_id));
+
+    BOOST_REQUIRE_EQUAL(view.topics.size(), expected.topics.size());
+    auto t_it = expected.topics.begin();
+    for (const auto& topic : view.topics) {
+        BOOST_REQUIRE_EQUAL(topic.name, std::string_view(t_it->name()));
+        BOOST_REQUIRE_EQUAL(
+          topic.fetch_partitions.size(), t_it->fetch_partitions.size());
+        auto p_it = t_it->fetch_partitions.begin();
+        for (const auto& p : topic.fetch_partitions) {
+            BOOST_REQUIRE_EQUAL(p.partition_index, p_it->partition_index);
+            BOOST_REQUIRE_EQUAL(
+              p.current_leader_epoch, p_it->current_leader_epoch);
+            BOOST_REQUIRE_EQUAL(p.fetch_offset, p_it->fetch_offset);
+            BOOST_REQUIRE_EQUAL(p.log_start_offset, p_it->log_start_offset);
+            BOOST_REQUIRE_EQUAL(p.max_bytes, p_it->max_bytes);
+            ++p_it;
+        }
+        ++t_it;
+    }
+    BOOST_REQUIRE(t_it == expected.topics.end());
+
+    BOOST_REQUIRE_EQUAL(view.forgotten.size(), expected.forgotten.size());
+    auto f_it = expected.forgotten.begin();
+    for (const auto& forgotten : view.forgotten) {
+        BOOST_REQUIRE_EQUAL(forgotten.name, std::string_view(f_it->name()));
+        std::vector<int32_t> indexes(
+          forgotten.forgotten_partition_indexes.begin(),
+          forgotten.forgotten_partition_indexes.end());
+        BOOST_REQUIRE(indexes == f_it->forgotten_partition_indexes);
+        ++f_it;
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(fetch_request_view_matches_owned_decoding) {
+    auto data = make_fetch_request();
+    for (auto v : {4, 7, 11}) {
+        kafka::api_version version(v);
+        auto buf = encode(data, version);
+
+        kafka::fetch_request_data owned;
+        kafka::request_reader reader(buf.copy());
+        owned.decode(reader, version);
+
+        kafka::request_view<kafka::fetch_request_data_view> view(
+          std::move(buf), version);
+        check_fetch_request(owned, view.data());
+        // arrays can be iterated more than once
+        check_fetch_request(owned, view.data());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fragmented_request_view) {
+    auto data = make_fetch_request();
+    kafka::api_version version(11);
+    auto buf = encode(data, version);
+    for (size_t fragment_size : {1, 3, 7, 64}) {
+        kafka::request_view<kafka::fetch_request_data_view> view(
+          fragmented(buf, fragment_size), version);
+        check_fetch_request(data, view.data());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(heartbeat_request_view) {
+    kafka::heartbeat_request_data data{
+      .group_id = kafka::group_id("group"),
+      .generation_id = kafka::generation_id(10),
+      .member_id = kafka::member_id("member-1"),
+      .group_instance_id = kafka::group_instance_id("instance")};
+    kafka::api_version version(3);
+    kafka::request_view<kafka::heartbeat_request_data_view> view(
+      encode(data, version), version);
+
+    BOOST_REQUIRE_EQUAL(view->group_id, "group");
+    BOOST_REQUIRE_EQUAL(view->generation_id, data.generation_id);
+    BOOST_REQUIRE_EQUAL(view->member_id, "member-1");
+    BOOST_REQUIRE(view->group_instance_id);
+    BOOST_REQUIRE_EQUAL(*view->group_instance_id, "instance");
+
+    data.group_instance_id = std::nullopt;
+    kafka::request_view<kafka::heartbeat_request_data_view> no_instance(
+      encode(data, version), version);
+    BOOST_REQUIRE(!no_instance->group_instance_id);
+}
+
+BOOST_AUTO_TEST_CASE(metadata_request_view_nullable_topics) {
+    kafka::metadata_request_data data;
+    data.allow_auto_topic_creation = false;
+    kafka::api_version version(4);
+    {
+        data.topics = std::nullopt;
+        kafka::request_view<kafka::metadata_request_data_view> view(
+          encode(data, version), version);
+        BOOST_REQUIRE(!view->topics);
+        BOOST_REQUIRE(!view->allow_auto_topic_creation);
+    }
+    {
+        data.topics = {
+          kafka::metadata_request_topic{.name = model::topic("a")},
+          kafka::metadata_request_topic{.name = model::topic("b")}};
+        kafka::request_view<kafka::metadata_request_data_view> view(
+          encode(data, version), version);
+        BOOST_REQUIRE(view->topics);
+        std::vector<std::string_view> names;
+        for (const auto& t : *view->topics) {
+            names.push_back(t.name);
+        }
+        BOOST_REQUIRE(names == std::vector<std::string_view>({"a", "b"}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(offset_commit_request_view) {
+    kafka::offset_commit_request_data data{
+      .group_id = kafka::group_id("group"),
+      .generation_id = 4,
+      .member_id = kafka::member_id("member")};
+    kafka::offset_commit_request_topic topic{.name = model::topic("topic")};
+    topic.partitions.push_back(kafka::offset_commit_request_partition{
+      .partition_index = model::partition_id(2),
+      .committed_offset = model::offset(42),
+      .committed_leader_epoch = 1,
+      .committed_metadata = "meta"});
+    topic.partitions.push_back(kafka::offset_commit_request_partition{
+      .partition_index = model::partition_id(3),
+      .committed_offset = model::offset(43)});
+    data.topics.push_back(std::move(topic));
+
+    kafka::api_version version(7);
+    kafka::request_view<kafka::offset_commit_request_data_view> view(
+      encode(data, version), version);
+
+    BOOST_REQUIRE_EQUAL(view->group_id, "group");
+    BOOST_REQUIRE_EQUAL(view->generation_id, 4);
+    BOOST_REQUIRE_EQUAL(view->member_id, "member");
+    BOOST_REQUIRE_EQUAL(view->topics.size(), 1);
+    const auto& t = *view->topics.begin();
+    BOOST_REQUIRE_EQUAL(t.name, "topic");
+    std::vector<kafka::offset_commit_request_partition_view> partitions(
+      t.partitions.begin(), t.partitions.end());
+    BOOST_REQUIRE_EQUAL(partitions.size(), 2);
+    BOOST_REQUIRE_EQUAL(partitions[0].partition_index, model::partition_id(2));
+    BOOST_REQUIRE_EQUAL(partitions[0].committed_offset, model::offset(42));
+    BOOST_REQUIRE_EQUAL(partitions[0].committed_leader_epoch, 1);
+    BOOST_REQUIRE_EQUAL(*partitions[0].committed_metadata, "meta");
+    BOOST_REQUIRE_EQUAL(partitions[1].committed_offset, model::offset(43));
+    BOOST_REQUIRE(!partitions[1].committed_metadata);
+}
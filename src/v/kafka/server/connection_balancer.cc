@@ -0,0 +1,115 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/connection_balancer.h"
+
+#include "config/configuration.h"
+#include "kafka/server/logger.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/smp.hh>
+
+#include <fmt/ranges.h>
+
+#include <numeric>
+
+namespace kafka {
+
+connection_balancer::connection_balancer(
+  std::optional<std::chrono::milliseconds> interval, uint32_t tolerance)
+  : _interval(interval)
+  , _tolerance(tolerance) {
+    _timer.set_callback([this] {
+        (void)ss::with_gate(_gate, [this] { return balance(); });
+    });
+}
+
+ss::future<> connection_balancer::start() {
+    setup_metrics();
+    // with a single shard there is nowhere to move the connections to
+    if (_interval && ss::smp::count > 1 && ss::this_shard_id() == 0) {
+        _timer.arm(*_interval);
+    }
+    return ss::now();
+}
+
+ss::future<> connection_balancer::stop() {
+    _timer.cancel();
+    return _gate.close();
+}
+
+std::vector<uint32_t> connection_balancer::plan(
+  const std::vector<uint32_t>& connections, uint32_t tolerance) {
+    std::vector<uint32_t> ret(connections.size(), 0);
+    if (connections.empty()) {
+        return ret;
+    }
+    const uint64_t total = std::accumulate(
+      connections.begin(), connections.end(), uint64_t(0));
+    // rounded up, the shards at the mean have nothing to give away
+    const uint64_t mean = (total + connections.size() - 1)
+                          / connections.size();
+    for (size_t i = 0; i < connections.size(); ++i) {
+        if (connections[i] > mean + tolerance) {
+            ret[i] = connections[i] - mean;
+        }
+    }
+    return ret;
+}
+
+ss::future<> connection_balancer::balance() {
+    try {
+        auto connections = co_await container().map(
+          [](connection_balancer& b) { return b.connections(); });
+        auto budgets = plan(connections, _tolerance);
+        vlog(
+          klog.trace,
+          "kafka connections per shard: {}, shedding: {}",
+          connections,
+          budgets);
+        // the budget of the previous round is replaced, a shard that didn't
+        // manage to shed its connections is re-evaluated with fresh counts
+        co_await container().invoke_on_all([&budgets](connection_balancer& b) {
+            b._shed_budget = budgets[ss::this_shard_id()];
+        });
+    } catch (...) {
+        vlog(
+          klog.debug,
+          "Unable to balance kafka connections: {}",
+          std::current_exception());
+    }
+    if (!_gate.is_closed()) {
+        _timer.arm(*_interval);
+    }
+}
+
+void connection_balancer::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("kafka:connection_balancer"),
+      {
+        sm::make_gauge(
+          "connections",
+          [this] { return _connections; },
+          sm::description("Number of kafka connections of the shard")),
+        sm::make_derive(
+          "shed_connections",
+          [this] { return _shed_connections; },
+          sm::description("Number of kafka connections closed to move them "
+                          "to a less loaded shard")),
+      });
+}
+
+} // namespace kafka
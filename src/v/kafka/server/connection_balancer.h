@@ -0,0 +1,98 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "likely.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace kafka {
+
+/**
+ * Evens out the kafka connections between the shards.
+ *
+ * The listeners hand new connections to the shard with the fewest connections
+ * but a connection stays on the shard that accepted it, so the shards drift
+ * apart as clients come and go. A connected socket can't be moved to another
+ * shard: instead shard 0 periodically collects the connection counts and lets
+ * the shards above the mean by more than the tolerance close their surplus.
+ * The connections are closed at a request boundary, once their responses are
+ * sent, the clients reconnect and land on the least loaded shards.
+ *
+ * Only connections sending requests check the shedding budget, so the busiest
+ * connections are the ones moved. Idle connections are not worth moving.
+ */
+class connection_balancer
+  : public ss::peering_sharded_service<connection_balancer> {
+public:
+    using clock = ss::lowres_clock;
+
+    connection_balancer(
+      std::optional<std::chrono::milliseconds> interval, uint32_t tolerance);
+
+    connection_balancer(const connection_balancer&) = delete;
+    connection_balancer& operator=(const connection_balancer&) = delete;
+    connection_balancer(connection_balancer&&) = delete;
+    connection_balancer& operator=(connection_balancer&&) = delete;
+    ~connection_balancer() noexcept = default;
+
+    ss::future<> start();
+    ss::future<> stop();
+
+    void connection_opened() { ++_connections; }
+    void connection_closed() { --_connections; }
+    uint32_t connections() const { return _connections; }
+
+    /// Returns true if the caller must close its connection to move it to
+    /// another shard, consuming one unit of the shedding budget
+    bool should_shed() {
+        if (likely(_shed_budget == 0)) {
+            return false;
+        }
+        --_shed_budget;
+        ++_shed_connections;
+        return true;
+    }
+
+    /// Number of connections each shard has to close, given the connection
+    /// counts of all shards indexed by shard id
+    static std::vector<uint32_t>
+    plan(const std::vector<uint32_t>& connections, uint32_t tolerance);
+
+private:
+    // collects the connection counts and assigns the shedding budgets, only
+    // runs on shard 0
+    ss::future<> balance();
+    void setup_metrics();
+
+    std::optional<std::chrono::milliseconds> _interval;
+    uint32_t _tolerance;
+    uint32_t _connections{0};
+    // connections left to close before the next balance round
+    uint32_t _shed_budget{0};
+    uint64_t _shed_connections{0};
+    ss::timer<clock> _timer;
+    ss::gate _gate;
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace kafka
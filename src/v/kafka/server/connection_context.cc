@@ -24,6 +24,7 @@
 #include <seastar/core/sleep.hh>
 
 #include <chrono>
+#include <ctime>
 using namespace std::chrono_literals;
 
 namespace kafka {
@@ -142,7 +143,11 @@ ss::future<> connection_context::handle_auth_v0(const size_t size) {
 }
 
 bool connection_context::is_finished_parsing() const {
-    return _rs.conn->input().eof() || _rs.abort_requested();
+    return _rs.conn->input().eof() || _rs.abort_requested() || _shedding;
+}
+
+ss::future<> connection_context::wait_for_responses() {
+    return _pending_responses.close();
 }
 
 ss::future<connection_context::session_resources>
@@ -163,16 +168,20 @@ connection_context::throttle_request(
       hdr.client_id, request_size);
 
     auto fut = ss::now();
+    ss::lowres_clock::duration throttled{0};
     if (!delay.first_violation) {
         fut = ss::sleep_abortable(delay.duration, _rs.abort_source());
+        throttled = delay.duration;
     }
     auto track = track_latency(hdr.key);
     return fut
-      .then(
-        [this, request_size] { return reserve_request_units(request_size); })
-      .then([this, delay, track](ss::semaphore_units<> units) {
+      .then([this, key = hdr.key, request_size] {
+          return reserve_request_units(key, request_size);
+      })
+      .then([this, delay, throttled, track, key = hdr.key](
+              ss::semaphore_units<> units) {
           return server().get_request_unit().then(
-            [this, delay, mem_units = std::move(units), track](
+            [this, delay, throttled, mem_units = std::move(units), track, key](
               ss::semaphore_units<> qd_units) mutable {
                 session_resources r{
                   .backpressure_delay = delay.duration,
@@ -182,15 +191,17 @@ connection_context::throttle_request(
                 if (track) {
                     r.method_latency = _rs.hist().auto_measure();
                 }
+                r.summary_latency = measure_summary_latency(key);
+                r.throttled = throttled;
+                r.admitted = slow_request_log::clock_type::now();
                 return r;
             });
       });
 }
 
 ss::future<ss::semaphore_units<>>
-connection_context::reserve_request_units(size_t size) {
-    // Allow for extra copies and bookkeeping
-    auto mem_estimate = size * 2 + 8000; // NOLINT
+connection_context::reserve_request_units(api_key key, size_t size) {
+    auto mem_estimate = memory_estimate(key, size, *this);
     if (mem_estimate >= (size_t)std::numeric_limits<int32_t>::max()) {
         // TODO: Create error response using the specific API?
         throw std::runtime_error(fmt::format(
@@ -205,24 +216,51 @@ connection_context::reserve_request_units(size_t size) {
     return fut;
 }
 
+static std::chrono::nanoseconds thread_cpu_time() {
+    ::timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec)
+           + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
 ss::future<>
 connection_context::dispatch_method_once(request_header hdr, size_t size) {
-    return throttle_request(hdr, size).then([this, hdr = std::move(hdr), size](
+    std::optional<request_trace> trace;
+    if (config::shard_local_cfg().kafka_slow_request_log_size() > 0) {
+        trace = request_trace{
+          .key = hdr.key,
+          .version = hdr.version,
+          .client_id = hdr.client_id_buffer.share(),
+          .request_bytes = size,
+          .started = slow_request_log::clock_type::now()};
+    }
+    return throttle_request(hdr, size).then([this,
+                                             hdr = std::move(hdr),
+                                             size,
+                                             trace = std::move(trace)](
                                               session_resources sres) mutable {
         if (_rs.abort_requested()) {
             // protect against shutdown behavior
             return ss::make_ready_future<>();
         }
+        if (trace) {
+            trace->throttled = sres.throttled;
+            trace->admitted = sres.admitted;
+        }
         auto remaining = size - sizeof(raw_request_header)
                          - hdr.client_id_buffer.size();
         return read_iobuf_exactly(_rs.conn->input(), remaining)
-          .then([this, hdr = std::move(hdr), sres = std::move(sres)](
-                  iobuf buf) mutable {
+          .then([this,
+                 hdr = std::move(hdr),
+                 sres = std::move(sres),
+                 trace = std::move(trace)](iobuf buf) mutable {
               if (_rs.abort_requested()) {
                   // _proto._cntrl etc might not be alive
                   return ss::now();
               }
               auto self = shared_from_this();
+              _request_partitions.clear();
+              _request_partition_count = 0;
               auto rctx = request_context(
                 self, std::move(hdr), std::move(buf), sres.backpressure_delay);
               /*
@@ -246,10 +284,26 @@ connection_context::dispatch_method_once(request_header hdr, size_t size) {
                */
 
               const auto correlation = rctx.header().correlation;
+              const auto key = rctx.header().key;
+              // the view of the client id doesn't outlive the request
+              std::optional<ss::sstring> client_id;
+              if (rctx.header().client_id) {
+                  client_id = ss::sstring(*rctx.header().client_id);
+              }
               const sequence_id seq = _seq_idx;
               _seq_idx = _seq_idx + sequence_id(1);
+              /*
+               * the cpu time of the request is the time spent in the
+               * dispatch of the request, it covers the decoding and the part
+               * of the handler that runs before its first suspension.
+               */
+              const auto cpu_start = thread_cpu_time();
               auto res = kafka::process_request(
                 std::move(rctx), _proto.smp_group());
+              const auto cpu = std::chrono::duration_cast<
+                std::chrono::microseconds>(thread_cpu_time() - cpu_start);
+              _proto.record_request_cpu(key, cpu);
+              _proto.quota_mgr().record_cpu(client_id, cpu);
               /**
                * first stage processed in a foreground.
                */
@@ -259,18 +313,58 @@ connection_context::dispatch_method_once(request_header hdr, size_t size) {
                        seq,
                        correlation,
                        self,
-                       s = std::move(sres)]() mutable {
+                       s = std::move(sres),
+                       trace = std::move(trace)]() mutable {
+                    if (trace) {
+                        trace->dispatched = slow_request_log::clock_type::now();
+                        trace->partitions = std::exchange(
+                          _request_partitions, {});
+                        trace->partition_count = std::exchange(
+                          _request_partition_count, 0);
+                    }
+                    /**
+                     * the connection balancer closes busy connections of an
+                     * overloaded shard at a request boundary, the client
+                     * reconnects to a less loaded one. not during the auth
+                     * phase, the client would have to authenticate again.
+                     */
+                    _shedding = sasl().state()
+                                  == security::sasl_server::sasl_state::complete
+                                && _proto.conn_balancer().should_shed();
                     /**
                      * second stage processed in background.
                      */
                     (void)ss::try_with_gate(
                       _rs.conn_gate(),
-                      [this, f = std::move(f), seq, correlation]() mutable {
-                          return f.then(
-                            [this, seq, correlation](response_ptr r) mutable {
-                                r->set_correlation(correlation);
-                                _responses.insert({seq, std::move(r)});
-                                return process_next_response();
+                      [this,
+                       f = std::move(f),
+                       seq,
+                       correlation,
+                       trace = std::move(trace)]() mutable {
+                          return ss::with_gate(
+                            _pending_responses,
+                            [this,
+                             f = std::move(f),
+                             seq,
+                             correlation,
+                             trace = std::move(trace)]() mutable {
+                                return f.then([this,
+                                               seq,
+                                               correlation,
+                                               trace = std::move(trace)](
+                                                response_ptr r) mutable {
+                                    r->set_correlation(correlation);
+                                    if (trace) {
+                                        trace->ready = slow_request_log::
+                                          clock_type::now();
+                                    }
+                                    _responses.insert(
+                                      {seq,
+                                       pending_response{
+                                         .response = std::move(r),
+                                         .trace = std::move(trace)}});
+                                    return process_next_response();
+                                });
                             });
                       })
                       .handle_exception([self](std::exception_ptr e) {
@@ -300,22 +394,42 @@ ss::future<> connection_context::process_next_response() {
         // found one; increment counter
         _next_response = _next_response + sequence_id(1);
 
-        auto r = std::move(it->second);
+        auto r = std::move(it->second.response);
+        auto trace = std::move(it->second.trace);
         _responses.erase(it);
         _rs.probe().request_completed();
 
         if (r->is_noop()) {
+            if (trace) {
+                record_slow_request(*trace, 0);
+            }
             return ss::make_ready_future<ss::stop_iteration>(
               ss::stop_iteration::no);
         }
 
+        auto memory = r->release_memory();
+        auto sections = r->release_sections();
+        const auto sections_size = r->sections_size();
         auto msg = response_as_scattered(std::move(r));
-        _rs.probe().add_bytes_sent(msg.size());
+        const auto size = msg.size() + sections_size;
+        _rs.probe().add_bytes_sent(size);
         try {
-            return _rs.conn->write(std::move(msg)).then([] {
-                return ss::make_ready_future<ss::stop_iteration>(
-                  ss::stop_iteration::no);
-            });
+            return _rs.conn->write(std::move(msg))
+              .then([this,
+                     sections = std::move(sections),
+                     sections_size]() mutable {
+                  if (!sections) {
+                      return ss::now();
+                  }
+                  return write_sections(std::move(*sections), sections_size);
+              })
+              .then([trace = std::move(trace), size, m = std::move(memory)] {
+                  if (trace) {
+                      record_slow_request(*trace, size);
+                  }
+                  return ss::make_ready_future<ss::stop_iteration>(
+                    ss::stop_iteration::no);
+              });
         } catch (...) {
             vlog(
               klog.debug,
@@ -327,4 +441,68 @@ ss::future<> connection_context::process_next_response() {
     });
 }
 
+ss::future<> connection_context::write_sections(
+  response::section_encoder next, size_t size) {
+    return ss::do_with(
+      std::move(next),
+      size_t(0),
+      [this, size](response::section_encoder& next, size_t& written) {
+          return ss::repeat([this, &next, &written, size] {
+              auto section = next();
+              if (!section) {
+                  vassert(
+                    written == size,
+                    "Response sections of {} bytes don't match the {} bytes "
+                    "of the frame",
+                    written,
+                    size);
+                  return ss::make_ready_future<ss::stop_iteration>(
+                    ss::stop_iteration::yes);
+              }
+              written += section->size_bytes();
+              return _rs.conn->write(iobuf_as_scattered(std::move(*section)))
+                .then([] { return ss::stop_iteration::no; });
+          });
+      });
+}
+
+void connection_context::record_slow_request(
+  const request_trace& t, size_t response_bytes) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    const auto throttled = duration_cast<microseconds>(t.throttled);
+    // the throttling delay is measured by the quota manager, the remaining
+    // time until the units were acquired is queueing
+    const auto queued = std::max(
+      duration_cast<microseconds>(t.admitted - t.started) - throttled,
+      microseconds(0));
+    const auto dispatched = duration_cast<microseconds>(
+      t.dispatched - t.admitted);
+    const auto processed = duration_cast<microseconds>(t.ready - t.dispatched);
+    const auto written = duration_cast<microseconds>(
+      slow_request_log::clock_type::now() - t.ready);
+    const auto total = throttled + queued + dispatched + processed + written;
+    if (!slow_request_log::admits(total)) {
+        return;
+    }
+    slow_request_log::entry e{
+      .key = t.key,
+      .version = t.version,
+      .client_id = ss::sstring(t.client_id.get(), t.client_id.size()),
+      .received = model::timestamp(
+        model::timestamp::now().value()
+        - duration_cast<std::chrono::milliseconds>(total).count()),
+      .request_bytes = t.request_bytes,
+      .response_bytes = response_bytes,
+      .partition_count = t.partition_count,
+      .partitions = t.partitions,
+      .throttle = throttled,
+      .queue = queued,
+      .dispatch = dispatched,
+      .process = processed,
+      .write = written,
+    };
+    slow_request_log::record(std::move(e));
+}
+
 } // namespace kafka
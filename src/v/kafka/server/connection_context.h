@@ -11,6 +11,7 @@
 #pragma once
 #include "kafka/server/protocol.h"
 #include "kafka/server/response.h"
+#include "kafka/server/slow_request_log.h"
 #include "rpc/server.h"
 #include "seastarx.h"
 #include "security/acl.h"
@@ -19,6 +20,7 @@
 #include "utils/named_type.h"
 
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/lowres_clock.hh>
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/shared_ptr.hh>
@@ -26,6 +28,8 @@
 #include <absl/container/flat_hash_map.h>
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace kafka {
 
@@ -62,20 +66,70 @@ public:
         if (!_enable_authorizer) {
             return true;
         }
-        auto user = sasl().principal();
+        auto& authorizer = _proto.authorizer();
+        const auto& user = sasl().principal();
+        if (
+          _authz_generation != authorizer.generation()
+          || _authz_principal != user
+          || _authz_cache.size() >= max_authz_cache_entries) {
+            _authz_cache.clear();
+            _authz_generation = authorizer.generation();
+            _authz_principal = user;
+        }
+        authz_key key{
+          .type = security::get_resource_type<T>(),
+          .name = name(),
+          .operation = operation};
+        if (auto it = _authz_cache.find(key); it != _authz_cache.end()) {
+            return it->second;
+        }
         security::acl_principal principal(
-          security::principal_type::user, std::move(user));
-        return _proto.authorizer().authorized(
+          security::principal_type::user, user);
+        const bool allowed = authorizer.authorized(
           name,
           operation,
           std::move(principal),
           security::acl_host(_client_addr));
+        _authz_cache.emplace(std::move(key), allowed);
+        return allowed;
     }
 
     ss::future<> process_one_request();
     bool is_finished_parsing() const;
+
+    /// Set when the connection is closed to move it to another shard
+    bool is_shedding() const { return _shedding; }
+    /// Waits until the responses of the requests read so far are sent
+    ss::future<> wait_for_responses();
     ss::net::inet_address client_host() const { return _client_addr; }
 
+    /// \brief takes memory for the response of a request already admitted as
+    /// the response is filled, without waiting for it. the requests admitted
+    /// next wait for the memory instead
+    ss::semaphore_units<> consume_memory(size_t bytes) {
+        return ss::consume_units(_rs.memory(), bytes);
+    }
+    /// \brief memory of the shard not reserved by the requests
+    ssize_t available_memory() { return _rs.memory().available_units(); }
+
+    /// the SASL handshake limiter units, from the handshake to the end of
+    /// the authentication
+    bool in_sasl_handshake() const { return _sasl_handshake_units.count(); }
+    void hold_sasl_handshake(ss::semaphore_units<> units) {
+        _sasl_handshake_units = std::move(units);
+    }
+    void release_sasl_handshake() { _sasl_handshake_units.return_all(); }
+
+    /// \brief the request being dispatched touches the partition, for the
+    /// slow request log. called by the handlers before their dispatch stage
+    /// completes, the next request isn't dispatched before
+    void add_request_partition(const model::topic& t, model::partition_id p) {
+        if (_request_partitions.size() < slow_request_log::max_partitions) {
+            _request_partitions.emplace_back(t, p);
+        }
+        ++_request_partition_count;
+    }
+
 private:
     // used to pass around some internal state
     struct session_resources {
@@ -83,10 +137,42 @@ private:
         ss::semaphore_units<> memlocks;
         ss::semaphore_units<> queue_units;
         std::unique_ptr<hdr_hist::measurement> method_latency;
+        std::unique_ptr<hdr_hist::measurement> summary_latency;
+        /// quota throttling delay the request waited for
+        ss::lowres_clock::duration throttled{0};
+        /// when the memory and the queue depth units were acquired
+        slow_request_log::clock_type::time_point admitted;
     };
 
+    /// stages of a request, for the slow request log
+    struct request_trace {
+        api_key key;
+        api_version version;
+        // shares the buffer of the request header
+        ss::temporary_buffer<char> client_id;
+        size_t request_bytes{0};
+        size_t partition_count{0};
+        std::vector<model::topic_partition> partitions;
+        slow_request_log::clock_type::time_point started;
+        ss::lowres_clock::duration throttled{0};
+        slow_request_log::clock_type::time_point admitted;
+        slow_request_log::clock_type::time_point dispatched;
+        slow_request_log::clock_type::time_point ready;
+    };
+
+    struct pending_response {
+        response_ptr response;
+        // empty when the slow request log is disabled
+        std::optional<request_trace> trace;
+    };
+
+    /// records the request if it is one of the slowest
+    static void
+    record_slow_request(const request_trace&, size_t response_bytes);
+
     /// called by throttle_request
-    ss::future<ss::semaphore_units<>> reserve_request_units(size_t size);
+    ss::future<ss::semaphore_units<>>
+    reserve_request_units(api_key, size_t size);
 
     /// apply correct backpressure sequence
     ss::future<session_resources>
@@ -94,13 +180,31 @@ private:
 
     ss::future<> dispatch_method_once(request_header, size_t sz);
     ss::future<> process_next_response();
+    /// writes the deferred sections of a response after its head
+    ss::future<> write_sections(response::section_encoder, size_t size);
     ss::future<> do_process(request_context);
 
     ss::future<> handle_auth_v0(size_t);
 
 private:
+    /// decisions of the authorizer for the principal and the host of the
+    /// connection, for the generation of the authorizer they were made in
+    struct authz_key {
+        security::resource_type type;
+        ss::sstring name;
+        security::acl_operation operation;
+
+        bool operator==(const authz_key&) const = default;
+
+        template<typename H>
+        friend H AbslHashValue(H h, const authz_key& k) {
+            return H::combine(std::move(h), k.type, k.name, k.operation);
+        }
+    };
+    static constexpr size_t max_authz_cache_entries = 1024;
+
     using sequence_id = named_type<uint64_t, struct kafka_protocol_sequence>;
-    using map_t = absl::flat_hash_map<sequence_id, response_ptr>;
+    using map_t = absl::flat_hash_map<sequence_id, pending_response>;
 
     protocol& _proto;
     rpc::server::resources _rs;
@@ -108,8 +212,16 @@ private:
     sequence_id _seq_idx;
     map_t _responses;
     security::sasl_server _sasl;
+    ss::semaphore_units<> _sasl_handshake_units;
     const ss::net::inet_address _client_addr;
     const bool _enable_authorizer;
+    absl::flat_hash_map<authz_key, bool> _authz_cache;
+    uint64_t _authz_generation{0};
+    ss::sstring _authz_principal;
+    bool _shedding{false};
+    std::vector<model::topic_partition> _request_partitions;
+    size_t _request_partition_count{0};
+    ss::gate _pending_responses;
 };
 
 } // namespace kafka
@@ -75,6 +75,19 @@ public:
                  : std::nullopt;
     }
 
+    /// \brief the metadata of the partition if it was cached less than
+    /// max_age ago
+    std::optional<partition_metadata>
+    get(const model::ntp& ntp, ss::lowres_clock::duration max_age) {
+        auto it = _cache.find(ntp);
+        if (
+          it == _cache.end()
+          || it->second.timestamp + max_age < ss::lowres_clock::now()) {
+            return std::nullopt;
+        }
+        return it->second.md;
+    }
+
 private:
     struct entry {
         entry(model::offset start_offset, model::offset hw, model::offset lso)
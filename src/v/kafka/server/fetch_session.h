@@ -222,6 +222,8 @@ private:
     model::timeout_clock::time_point _last_used;
     fetch_session_epoch _epoch;
     bool _locked;
+    // memory usage accounted by the cache
+    size_t _tracked_mem_usage{0};
 };
 
 using fetch_session_ptr = ss::lw_shared_ptr<fetch_session>;
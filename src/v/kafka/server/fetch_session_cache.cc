@@ -50,11 +50,14 @@ void update_fetch_session(fetch_session& session, const fetch_request& req) {
 }
 
 fetch_session_cache::fetch_session_cache(
-  std::chrono::milliseconds eviction_timeout)
-  : _min_session_id(max_sessions_per_core() * seastar::this_shard_id())
+  std::chrono::milliseconds eviction_timeout, size_t max_mem_usage)
+  : _max_mem_usage(max_mem_usage)
+  , _min_session_id(max_sessions_per_core() * seastar::this_shard_id())
   , _max_session_id(max_sessions_per_core() + _min_session_id - 1)
   , _last_session_id(_min_session_id)
-  , _session_eviction_duration(eviction_timeout) {
+  , _session_eviction_duration(eviction_timeout)
+  , _eviction_timeout_binding(
+      config::shard_local_cfg().fetch_session_eviction_timeout_ms.bind()) {
     register_metrics();
     _session_eviction_timer.set_callback([this] {
         gc_sessions();
@@ -64,6 +67,11 @@ fetch_session_cache::fetch_session_cache(
     });
 
     _session_eviction_timer.arm(_session_eviction_duration);
+    _eviction_timeout_binding.watch([this] {
+        _session_eviction_duration = _eviction_timeout_binding();
+        _session_eviction_timer.rearm(
+          ss::timer<>::clock::now() + _session_eviction_duration);
+    });
 }
 
 fetch_session_ctx
@@ -76,8 +84,7 @@ fetch_session_cache::maybe_get_session(const fetch_request& req) {
         if (session_id != invalid_fetch_session_id) {
             if (auto it = _sessions.find(session_id); it != _sessions.end()) {
                 vlog(klog.info, "removing fetch session {}", session_id);
-                _sessions_mem_usage -= it->second->mem_usage();
-                _sessions.erase(it);
+                erase(it);
             }
         }
         if (epoch == final_fetch_session_epoch) {
@@ -96,6 +103,14 @@ fetch_session_cache::maybe_get_session(const fetch_request& req) {
         auto new_session = ss::make_lw_shared<fetch_session>(*new_id);
         // initialize fetch session partitions
         update_fetch_session(*new_session, req);
+        if (!make_room(new_session->mem_usage())) {
+            vlog(
+              klog.debug,
+              "fetch sessions cache is full, falling back to sessionless "
+              "fetch");
+            ++_rejected_sessions;
+            return fetch_session_ctx();
+        }
 
         auto [it, success] = _sessions.emplace(*new_id, std::move(new_session));
         vassert(
@@ -104,7 +119,7 @@ fetch_session_cache::maybe_get_session(const fetch_request& req) {
           *new_id);
 
         vlog(klog.info, "fetch session created: {}", *new_id);
-        _sessions_mem_usage += it->second->mem_usage();
+        track(*it->second);
         return fetch_session_ctx(it->second, true);
     }
     auto it = _sessions.find(session_id);
@@ -123,7 +138,7 @@ fetch_session_cache::maybe_get_session(const fetch_request& req) {
           epoch);
         return fetch_session_ctx(error_code::invalid_fetch_session_epoch);
     }
-    _sessions_mem_usage -= session->mem_usage();
+    untrack(*session);
     update_fetch_session(*session, req);
     if (session->empty()) {
         vlog(
@@ -138,15 +153,14 @@ fetch_session_cache::maybe_get_session(const fetch_request& req) {
     }
 
     session->advance_epoch();
-    _sessions_mem_usage += session->mem_usage();
+    track(*session);
     return fetch_session_ctx(session, false);
 }
 
 // we split whole range from 1 to max int32_t betewen all shards
 std::optional<fetch_session_id> fetch_session_cache::new_session_id() {
-    if (unlikely(
-          mem_usage() > max_mem_usage
-          || _sessions.size() > max_sessions_per_core())) {
+    // the memory budget is enforced when the session is added
+    if (unlikely(_sessions.size() > max_sessions_per_core())) {
         return std::nullopt;
     }
 
@@ -171,12 +185,62 @@ void fetch_session_cache::gc_sessions() {
             ++it;
         } else {
             vlog(klog.debug, "evicting session {}", it->second->id());
-            _sessions_mem_usage -= it->second->mem_usage();
+            untrack(*it->second);
             _sessions.erase(it++);
         }
     }
 }
 
+void fetch_session_cache::track(fetch_session& session) {
+    session._tracked_mem_usage = session.mem_usage();
+    _sessions_mem_usage += session._tracked_mem_usage;
+    _eviction_index.emplace(session._tracked_mem_usage, session.id());
+}
+
+void fetch_session_cache::untrack(fetch_session& session) {
+    _eviction_index.erase(
+      std::make_pair(session._tracked_mem_usage, session.id()));
+    _sessions_mem_usage -= session._tracked_mem_usage;
+    session._tracked_mem_usage = 0;
+}
+
+void fetch_session_cache::erase(underlying_t::iterator it) {
+    untrack(*it->second);
+    _sessions.erase(it);
+}
+
+bool fetch_session_cache::make_room(size_t new_mem_usage) {
+    auto now = model::timeout_clock::now();
+    while (mem_usage() + new_mem_usage > _max_mem_usage) {
+        auto victim = _sessions.end();
+        for (const auto& [session_mem_usage, id] : _eviction_index) {
+            auto it = _sessions.find(id);
+            const auto& session = *it->second;
+            if (session.is_locked()) {
+                continue;
+            }
+            auto idle = now - session._last_used >= _session_eviction_duration;
+            auto smaller = session_mem_usage < new_mem_usage
+                           && now - session._created
+                                >= _session_eviction_duration;
+            if (idle || smaller) {
+                victim = it;
+                break;
+            }
+        }
+        if (victim == _sessions.end()) {
+            return false;
+        }
+        vlog(
+          klog.debug,
+          "evicting session {} to make room for a new session",
+          victim->first);
+        erase(victim);
+        ++_evicted_sessions;
+    }
+    return true;
+}
+
 void fetch_session_cache::register_metrics() {
     if (config::shard_local_cfg().disable_metrics()) {
         return;
@@ -192,7 +256,17 @@ void fetch_session_cache::register_metrics() {
        sm::make_gauge(
          "sessions_count",
          [this] { return _sessions.size(); },
-         sm::description("Total number of fetch sessions"))});
+         sm::description("Total number of fetch sessions")),
+       sm::make_derive(
+         "evicted_sessions",
+         [this] { return _evicted_sessions; },
+         sm::description("Number of fetch sessions evicted to make room for "
+                         "new sessions")),
+       sm::make_derive(
+         "rejected_sessions",
+         [this] { return _rejected_sessions; },
+         sm::description("Number of fetch sessions that were not created "
+                         "because the cache was full"))});
 }
 
 } // namespace kafka
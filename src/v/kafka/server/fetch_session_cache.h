@@ -10,15 +10,18 @@
  */
 #pragma once
 
+#include "config/property.h"
 #include "kafka/server/fetch_session.h"
 #include "kafka/types.h"
 #include "units.h"
 
 #include <seastar/core/metrics_registration.hh>
 
+#include <absl/container/btree_set.h>
 #include <absl/container/flat_hash_map.h>
 
 #include <chrono>
+#include <utility>
 
 namespace kafka {
 
@@ -29,21 +32,28 @@ struct fetch_request;
  * for the node (non overlapping ranges of ids are assigned to each core).
  *
  * The cache evicts not used sessions after configurable period of inactivity.
- * Fetch session cache will stop adding new sessions after its max memory usage
- * is reached.
+ * When the memory budget of the cache is exhausted a new session evicts the
+ * existing ones following KIP-227: a session is evictable if it was idle for
+ * the eviction timeout or if it is older than the eviction timeout and smaller
+ * than the new session. The smallest evictable sessions are evicted first so
+ * large active sessions are protected. When no session can be evicted the
+ * client falls back to sessionless full fetches.
  **/
 class fetch_session_cache {
 public:
-    explicit fetch_session_cache(std::chrono::milliseconds);
+    static constexpr size_t default_max_mem_usage = 10_MiB;
+
+    explicit fetch_session_cache(
+      std::chrono::milliseconds,
+      size_t max_mem_usage = default_max_mem_usage);
     fetch_session_ctx maybe_get_session(const fetch_request& req);
     size_t size() const { return _sessions.size(); }
+    bool contains(fetch_session_id id) const { return _sessions.contains(id); }
 
 private:
     using underlying_t
       = absl::flat_hash_map<fetch_session_id, fetch_session_ptr>;
 
-    static constexpr size_t max_mem_usage = 10_MiB;
-
     // used to split range of possible session ids to limit memory size we use
     // max_mem_used, this is theoretical limit, the actual number of session
     // held in a cache on single core is limitted by the memory usage.
@@ -56,6 +66,13 @@ private:
     std::optional<fetch_session_id> new_session_id();
     void gc_sessions();
 
+    void track(fetch_session&);
+    void untrack(fetch_session&);
+    void erase(underlying_t::iterator);
+    // evict sessions until a new session of given size fits in the budget,
+    // returns false if it does not
+    bool make_room(size_t mem_usage);
+
     size_t mem_usage() const {
         using debug = absl::container_internal::hashtable_debug_internal::
           HashtableDebugAccess<underlying_t>;
@@ -65,6 +82,9 @@ private:
     void register_metrics();
 
     underlying_t _sessions;
+    // sessions ordered by their memory usage, smallest first
+    absl::btree_set<std::pair<size_t, fetch_session_id>> _eviction_index;
+    const size_t _max_mem_usage;
     const fetch_session_id _min_session_id;
     const fetch_session_id _max_session_id;
     fetch_session_id _last_session_id;
@@ -72,8 +92,12 @@ private:
     // min time that will elapse since the session was last used before it is
     // going to be evicted
     std::chrono::milliseconds _session_eviction_duration;
+    // the timeout set at runtime replaces the one of the constructor
+    config::binding<std::chrono::milliseconds> _eviction_timeout_binding;
 
     size_t _sessions_mem_usage = 0;
+    uint64_t _evicted_sessions = 0;
+    uint64_t _rejected_sessions = 0;
 
     ss::metrics::metric_groups _metrics;
 };
@@ -13,6 +13,7 @@
 
 namespace kafka {
 
+class connection_balancer;
 class coordinator_ntp_mapper;
 class fetch_session_cache;
 class group_manager;
@@ -55,7 +55,8 @@ group::group(
   kafka::group_id id,
   group_state s,
   config::configuration& conf,
-  ss::lw_shared_ptr<cluster::partition> partition)
+  ss::lw_shared_ptr<cluster::partition> partition,
+  ss::lw_shared_ptr<offset_commit_batcher> commit_batcher)
   : _id(std::move(id))
   , _state(s)
   , _state_timestamp(clock_type::now())
@@ -64,6 +65,7 @@ group::group(
   , _new_member_added(false)
   , _conf(conf)
   , _partition(std::move(partition))
+  , _commit_batcher(std::move(commit_batcher))
   , _recovery_policy(
       config::shard_local_cfg().rm_violation_recovery_policy.value())
   , _ctxlog(*this) {}
@@ -72,12 +74,14 @@ group::group(
   kafka::group_id id,
   group_log_group_metadata& md,
   config::configuration& conf,
-  ss::lw_shared_ptr<cluster::partition> partition)
+  ss::lw_shared_ptr<cluster::partition> partition,
+  ss::lw_shared_ptr<offset_commit_batcher> commit_batcher)
   : _id(std::move(id))
   , _num_members_joining(0)
   , _new_member_added(false)
   , _conf(conf)
   , _partition(std::move(partition))
+  , _commit_batcher(std::move(commit_batcher))
   , _recovery_policy(
       config::shard_local_cfg().rm_violation_recovery_policy.value())
   , _ctxlog(*this) {
@@ -203,6 +207,10 @@ void group::add_member_no_join(member_ptr member) {
     for (auto& p : member->protocols()) {
         _supported_protocols[p.name]++;
     }
+
+    if (member->group_instance_id()) {
+        _static_members[*member->group_instance_id()] = member->id();
+    }
 }
 
 ss::future<join_group_response> group::add_member(member_ptr member) {
@@ -493,6 +501,14 @@ group::join_group_unknown_member(join_group_request&& r) {
           unknown_member_id, error_code::inconsistent_group_protocol);
     }
 
+    if (r.data.group_instance_id) {
+        auto it = _static_members.find(*r.data.group_instance_id);
+        if (it != _static_members.end()) {
+            return join_group_static_member(
+              get_member(it->second), std::move(r));
+        }
+    }
+
     auto new_member_id = group::generate_member_id(r);
 
     // <kafka>Only return MEMBER_ID_REQUIRED error if joinGroupRequest version
@@ -668,15 +684,9 @@ ss::future<join_group_response> group::add_member_and_rebalance(
     // to a lot of defunct members in the rebalance. To prevent this going on
     // indefinitely, we timeout JoinGroup requests for new members. If the new
     // member is still there, we expect it to retry.</kafka>
-    member->expire_timer().cancel();
     auto now = clock_type::now();
     member->set_latest_heartbeat(now);
-    auto deadline = now + _conf.group_new_member_join_timeout();
-    member->expire_timer().set_callback(
-      [this, deadline, member_id = member->id()]() {
-          heartbeat_expire(member_id, deadline);
-      });
-    member->expire_timer().arm(deadline);
+    set_member_expiration(member, now + _conf.group_new_member_join_timeout());
 
     vlog(
       _ctxlog.trace,
@@ -697,6 +707,77 @@ group::update_member_and_rebalance(member_ptr member, join_group_request&& r) {
     return response;
 }
 
+ss::future<join_group_response>
+group::join_group_static_member(member_ptr member, join_group_request&& r) {
+    auto new_member_id = group::generate_member_id(r);
+    vlog(
+      _ctxlog.trace,
+      "Static member {} of instance {} rejoins as {}",
+      member->id(),
+      *r.data.group_instance_id,
+      new_member_id);
+
+    const bool same_protocols = r.data.protocols == member->protocols();
+    replace_static_member(member, new_member_id);
+
+    if (in_state(group_state::stable) && same_protocols) {
+        /*
+         * a restarted instance with the same metadata keeps its assignment
+         * and the group keeps its generation. the member fetches the
+         * assignment with the next sync, the other members are not touched.
+         * the leader gets no member metadata, so it doesn't compute a new
+         * assignment.
+         */
+        schedule_next_heartbeat_expiration(member);
+        join_group_response response(
+          error_code::none,
+          generation(),
+          protocol().value_or(protocol_name("")),
+          leader().value_or(member_id("")),
+          std::move(new_member_id));
+
+        vlog(_ctxlog.trace, "Handling static member rejoin {}", response);
+
+        return ss::make_ready_future<join_group_response>(
+          std::move(response));
+    }
+
+    // a change of metadata or a rejoin while the group is rebalancing takes
+    // the generic path
+    return update_member_and_rebalance(member, std::move(r));
+}
+
+void group::replace_static_member(
+  member_ptr member, kafka::member_id new_id) {
+    // the instance restarted, the requests still waiting under its previous
+    // member id are fenced
+    try_finish_joining_member(
+      member, _make_join_error(member->id(), error_code::fenced_instance_id));
+    if (member->is_syncing()) {
+        member->set_sync_response(
+          sync_group_response(error_code::fenced_instance_id));
+    }
+
+    const bool leader = is_leader(member->id());
+    _members.erase(member->id());
+    member->set_id(std::move(new_id));
+    _members.emplace(member->id(), member);
+    if (leader) {
+        _leader = member->id();
+    }
+    _static_members[*member->group_instance_id()] = member->id();
+}
+
+void group::erase_static_member(const group_member& member) {
+    if (!member.group_instance_id()) {
+        return;
+    }
+    auto it = _static_members.find(*member.group_instance_id());
+    if (it != _static_members.end() && it->second == member.id()) {
+        _static_members.erase(it);
+    }
+}
+
 void group::try_prepare_rebalance() {
     if (!valid_previous_state(group_state::preparing_rebalance)) {
         vlog(_ctxlog.trace, "Cannot prepare rebalance in state {}", _state);
@@ -797,6 +878,7 @@ void group::complete_join() {
             }
 
             auto leader = is_leader(it->second->id());
+            erase_static_member(*it->second);
             _members.erase(it++);
 
             if (leader) {
@@ -940,20 +1022,38 @@ void group::try_finish_joining_member(
 }
 
 void group::schedule_next_heartbeat_expiration(member_ptr member) {
-    member->expire_timer().cancel();
     auto now = clock_type::now();
     member->set_latest_heartbeat(now);
-    auto deadline = now + member->session_timeout();
-    member->expire_timer().set_callback(
-      [this, deadline, member_id = member->id()]() {
-          heartbeat_expire(member_id, deadline);
-      });
     vlog(
       _ctxlog.trace,
       "Scheduling heartbeat expiration {} ms for {}",
       member->session_timeout(),
       member->id());
-    member->expire_timer().arm(deadline);
+    set_member_expiration(member, now + member->session_timeout());
+}
+
+void group::set_member_expiration(
+  member_ptr member, clock_type::time_point deadline) {
+    member->set_expire_deadline(deadline);
+    auto& timer = member->expire_timer();
+    /*
+     * heartbeats only push the deadline of an armed timer forward, which
+     * avoids re-arming the timer and allocating its callback on every
+     * heartbeat. the timer is re-armed when the deadline moves back.
+     */
+    if (timer.armed() && timer.get_timeout() <= deadline) {
+        return;
+    }
+    timer.cancel();
+    // the timer is owned by the member, it doesn't outlive it
+    timer.set_callback([this, m = member.get()] {
+        if (clock_type::now() < m->expire_deadline()) {
+            m->expire_timer().arm(m->expire_deadline());
+            return;
+        }
+        heartbeat_expire(m->id(), m->expire_deadline());
+    });
+    timer.arm(deadline);
 }
 
 void group::remove_pending_member(const kafka::member_id& member_id) {
@@ -991,6 +1091,7 @@ void group::remove_member(member_ptr member) {
                 vassert(_num_members_joining >= 0, "negative members joining");
             }
         }
+        erase_static_member(*member);
         _members.erase(it);
     }
 
@@ -1730,8 +1831,7 @@ group::store_txn_offsets(txn_offset_commit_request r) {
 }
 
 group::offset_commit_stages group::store_offsets(offset_commit_request&& r) {
-    cluster::simple_batch_builder builder(
-      model::record_batch_type::raft_data, model::offset(0));
+    offset_commit_batcher::records_t records;
 
     std::vector<std::pair<model::topic_partition, offset_metadata>>
       offset_commits;
@@ -1751,7 +1851,9 @@ group::offset_commit_stages group::store_offsets(offset_commit_request&& r) {
               p.committed_leader_epoch,
               p.committed_metadata,
             };
-            builder.add_kv(std::move(key), std::move(val));
+            records.emplace_back(
+              reflection::to_iobuf(std::move(key)),
+              reflection::to_iobuf(std::move(val)));
 
             model::topic_partition tp(t.name, p.partition_index);
             offset_metadata md{
@@ -1767,12 +1869,7 @@ group::offset_commit_stages group::store_offsets(offset_commit_request&& r) {
         }
     }
 
-    auto batch = std::move(builder).build();
-    auto reader = model::make_memory_record_batch_reader(std::move(batch));
-
-    auto replicate_stages = _partition->replicate_in_stages(
-      std::move(reader),
-      raft::replicate_options(raft::consistency_level::quorum_ack));
+    auto replicate_stages = replicate_offset_commits(std::move(records));
 
     auto f = replicate_stages.replicate_finished.then(
       [this, req = std::move(r), commits = std::move(offset_commits)](
@@ -1799,6 +1896,29 @@ group::offset_commit_stages group::store_offsets(offset_commit_request&& r) {
       std::move(replicate_stages.request_enqueued), std::move(f));
 }
 
+raft::replicate_stages
+group::replicate_offset_commits(offset_commit_batcher::records_t records) {
+    if (_commit_batcher) {
+        // commits of the groups sharing the partition are coalesced
+        return _commit_batcher->replicate(std::move(records));
+    }
+    cluster::simple_batch_builder builder(
+      model::record_batch_type::raft_data, model::offset(0));
+    size_t bytes = 0;
+    for (const auto& [k, v] : records) {
+        bytes += k.size_bytes() + v.size_bytes();
+    }
+    builder.reserve(records.size(), bytes);
+    for (auto& [k, v] : records) {
+        builder.add_raw_kv(std::move(k), std::move(v));
+    }
+    auto reader = model::make_memory_record_batch_reader(
+      std::move(builder).build());
+    return _partition->replicate_in_stages(
+      std::move(reader),
+      raft::replicate_options(raft::consistency_level::quorum_ack));
+}
+
 ss::future<cluster::commit_group_tx_reply>
 group::handle_commit_tx(cluster::commit_group_tx_request r) {
     if (in_state(group_state::dead)) {
@@ -17,6 +17,7 @@
 #include "kafka/protocol/offset_commit.h"
 #include "kafka/server/logger.h"
 #include "kafka/server/member.h"
+#include "kafka/server/offset_commit_batcher.h"
 #include "kafka/types.h"
 #include "model/fundamental.h"
 #include "model/record.h"
@@ -148,14 +149,16 @@ public:
       kafka::group_id id,
       group_state s,
       config::configuration& conf,
-      ss::lw_shared_ptr<cluster::partition> partition);
+      ss::lw_shared_ptr<cluster::partition> partition,
+      ss::lw_shared_ptr<offset_commit_batcher> commit_batcher = nullptr);
 
     // constructor used when loading state from log
     group(
       kafka::group_id id,
       group_log_group_metadata& md,
       config::configuration& conf,
-      ss::lw_shared_ptr<cluster::partition> partition);
+      ss::lw_shared_ptr<cluster::partition> partition,
+      ss::lw_shared_ptr<offset_commit_batcher> commit_batcher = nullptr);
 
     /// Get the group id.
     const kafka::group_id& id() const { return _id; }
@@ -378,6 +381,17 @@ public:
     ss::future<join_group_response> update_member_and_rebalance(
       member_ptr member, join_group_request&& request);
 
+    /// Handle the join of a static member whose instance is in the group.
+    ss::future<join_group_response>
+    join_group_static_member(member_ptr member, join_group_request&& request);
+
+    /// The member of the instance takes the new id, the requests of the
+    /// previous id are fenced.
+    void replace_static_member(member_ptr member, kafka::member_id new_id);
+
+    /// The member is no longer the member of its instance.
+    void erase_static_member(const group_member& member);
+
     /// Transition to preparing rebalance if possible.
     void try_prepare_rebalance();
 
@@ -395,6 +409,10 @@ public:
     /// Restart the member heartbeat timer.
     void schedule_next_heartbeat_expiration(member_ptr member);
 
+    /// Move the expiration of the member to the deadline. A later deadline
+    /// doesn't re-arm the timer, it re-arms itself when it fires.
+    void set_member_expiration(member_ptr member, clock_type::time_point);
+
     /// Removes a full member and may rebalance.
     void remove_member(member_ptr member);
 
@@ -448,6 +466,9 @@ public:
 
     offset_commit_stages store_offsets(offset_commit_request&& r);
 
+    raft::replicate_stages
+      replicate_offset_commits(offset_commit_batcher::records_t);
+
     ss::future<txn_offset_commit_response>
     handle_txn_offset_commit(txn_offset_commit_request r);
 
@@ -562,6 +583,9 @@ private:
     member_map _members;
     int _num_members_joining;
     absl::node_hash_set<kafka::member_id> _pending_members;
+    // the members with a group instance id, by their instance id
+    absl::node_hash_map<kafka::group_instance_id, kafka::member_id>
+      _static_members;
     std::optional<kafka::protocol_type> _protocol_type;
     std::optional<kafka::protocol_name> _protocol;
     std::optional<kafka::member_id> _leader;
@@ -569,6 +593,8 @@ private:
     bool _new_member_added;
     config::configuration& _conf;
     ss::lw_shared_ptr<cluster::partition> _partition;
+    // shared by the groups of the partition, may be null in tests
+    ss::lw_shared_ptr<offset_commit_batcher> _commit_batcher;
     absl::node_hash_map<model::topic_partition, offset_metadata> _offsets;
     model::violation_recovery_policy _recovery_policy;
     ctx_log _ctxlog;
@@ -19,6 +19,7 @@
 #include "kafka/protocol/offset_commit.h"
 #include "kafka/protocol/offset_fetch.h"
 #include "kafka/protocol/request_reader.h"
+#include "kafka/server/group_recovery_checkpoint.h"
 #include "model/fundamental.h"
 #include "model/namespace.h"
 #include "model/record.h"
@@ -79,10 +80,51 @@ ss::future<> group_manager::start() {
             handle_topic_delta(deltas);
         });
 
+    /*
+     * every replica checkpoints the state of the groups of its partitions so
+     * that a new coordinator only replays the tail of the log.
+     */
+    _checkpoint_timer.set_callback([this] {
+        (void)ss::with_gate(_gate, [this] {
+            return checkpoint_partitions().finally([this] {
+                if (!_gate.is_closed()) {
+                    _checkpoint_timer.arm(
+                      _conf.kafka_group_recovery_checkpoint_interval_ms());
+                }
+            });
+        });
+    });
+    _checkpoint_timer.arm(_conf.kafka_group_recovery_checkpoint_interval_ms());
+
     return ss::make_ready_future<>();
 }
 
+ss::future<> group_manager::checkpoint_partitions() {
+    // copy the pointers, partitions may be attached in the meantime
+    std::vector<ss::lw_shared_ptr<attached_partition>> partitions;
+    partitions.reserve(_partitions.size());
+    for (auto& [_, p] : _partitions) {
+        partitions.push_back(p);
+    }
+    for (auto& p : partitions) {
+        if (p->as.abort_requested()) {
+            continue;
+        }
+        try {
+            group_recovery_checkpoint cp(p->partition);
+            co_await cp.checkpoint(p->as);
+        } catch (...) {
+            vlog(
+              klog.warn,
+              "failed to checkpoint groups of {} - {}",
+              p->partition->ntp(),
+              std::current_exception());
+        }
+    }
+}
+
 ss::future<> group_manager::stop() {
+    _checkpoint_timer.cancel();
     _pm.local().unregister_manage_notification(_manage_notify_handle);
     _gm.local().unregister_leadership_notification(_leader_notify_handle);
     _topic_table.local().unregister_delta_notification(
@@ -236,26 +278,16 @@ ss::future<> group_manager::handle_partition_leader_change(
           return inject_noop(p->partition, timeout)
             .then([this, term, timeout, p] {
                 /*
-                 * the full log is read and deduplicated. the dedupe
-                 * processing is based on the record keys, so this code
-                 * should be ready to transparently take advantage of
-                 * key-based compaction in the future.
+                 * the log is read and deduplicated on top of the last
+                 * checkpoint of the partition (or from the start if there is
+                 * none). the dedupe processing is based on the record keys,
+                 * so this code should be ready to transparently take
+                 * advantage of key-based compaction in the future.
                  */
-                storage::log_reader_config reader_config(
-                  p->partition->start_offset(),
-                  model::model_limits<model::offset>::max(),
-                  0,
-                  std::numeric_limits<size_t>::max(),
-                  kafka_read_priority(),
-                  std::nullopt,
-                  std::nullopt,
-                  std::nullopt);
-
-                return p->partition->make_reader(reader_config)
-                  .then([this, term, p, timeout](
-                          model::record_batch_reader reader) {
-                      return std::move(reader)
-                        .consume(recovery_batch_consumer(p->as), timeout)
+                return ss::do_with(
+                  group_recovery_checkpoint(p->partition),
+                  [this, term, timeout, p](group_recovery_checkpoint& cp) {
+                      return cp.recover(p->as, timeout)
                         .then([this, term, p](
                                 recovery_batch_consumer_state state) {
                             // avoid trying to recover if we stopped the
@@ -293,7 +325,11 @@ ss::future<> group_manager::recover_partition(
             auto group = get_group(group_id);
             if (!group) {
                 group = ss::make_lw_shared<kafka::group>(
-                  group_id, group_state::empty, _conf, p->partition);
+                  group_id,
+                  group_state::empty,
+                  _conf,
+                  p->partition,
+                  p->commit_batcher);
                 group->reset_tx_state(term);
                 _groups.emplace(group_id, group);
                 group->reschedule_all_member_heartbeats();
@@ -322,7 +358,11 @@ ss::future<> group_manager::recover_partition(
         auto group = get_group(group_id);
         if (!group) {
             group = ss::make_lw_shared<kafka::group>(
-              group_id, group_state::empty, _conf, p->partition);
+              group_id,
+              group_state::empty,
+              _conf,
+              p->partition,
+              p->commit_batcher);
             _groups.emplace(group_id, group);
         }
         for (const auto& [_, tx] : group_stm.prepared_txs()) {
@@ -357,10 +397,9 @@ template<typename T>
 static group_tx_cmd<T>
 parse_tx_batch(const model::record_batch& batch, int8_t version) {
     vassert(batch.record_count() == 1, "tx batch must contain a single record");
-    auto r = batch.copy_records();
-    auto& record = *r.begin();
-    auto key_buf = record.release_key();
-    auto val_buf = record.release_value();
+    auto record = batch.first_record_view();
+    auto key_buf = record.copy_key();
+    auto val_buf = record.copy_value();
 
     iobuf_parser val_reader(std::move(val_buf));
     auto tx_version = reflection::adl<int8_t>{}.from(val_reader);
@@ -397,15 +436,16 @@ recovery_batch_consumer::operator()(model::record_batch batch) {
         return ss::make_ready_future<ss::stop_iteration>(
           ss::stop_iteration::yes);
     }
+    st.last_offset = batch.last_offset();
 
     if (batch.header().type == model::record_batch_type::raft_data) {
         batch_base_offset = batch.base_offset();
         return ss::do_with(
                  std::move(batch),
                  [this](model::record_batch& batch) {
-                     return model::for_each_record(
-                       batch, [this](model::record& r) {
-                           return handle_record(std::move(r));
+                     return model::for_each_record_view(
+                       batch, [this](const model::record_view& r) {
+                           return handle_record(r);
                        });
                  })
           .then([] { return ss::stop_iteration::no; });
@@ -455,9 +495,10 @@ recovery_batch_consumer::operator()(model::record_batch batch) {
     }
 }
 
-ss::future<> recovery_batch_consumer::handle_record(model::record r) {
-    auto key = reflection::adl<group_log_record_key>{}.from(r.share_key());
-    auto value = r.has_value() ? r.release_value() : std::optional<iobuf>();
+ss::future<>
+recovery_batch_consumer::handle_record(const model::record_view& r) {
+    auto key = reflection::adl<group_log_record_key>{}.from(r.copy_key());
+    auto value = r.has_value() ? r.copy_value() : std::optional<iobuf>();
 
     switch (key.record_type) {
     case group_log_record_key::type::group_metadata:
@@ -583,9 +624,13 @@ group_manager::join_group(join_group_request&& r) {
             return make_join_error(
               r.data.member_id, error_code::not_coordinator);
         }
-        auto p = it->second->partition;
+        auto& p = it->second;
         group = ss::make_lw_shared<kafka::group>(
-          r.data.group_id, group_state::empty, _conf, p);
+          r.data.group_id,
+          group_state::empty,
+          _conf,
+          p->partition,
+          p->commit_batcher);
         _groups.emplace(r.data.group_id, group);
         _groups.rehash(0);
         is_new_group = true;
@@ -708,7 +753,11 @@ group_manager::txn_offset_commit(txn_offset_commit_request&& r) {
               // so allow the commit</kafka>
 
               group = ss::make_lw_shared<kafka::group>(
-                r.data.group_id, group_state::empty, _conf, p->partition);
+                r.data.group_id,
+                group_state::empty,
+                _conf,
+                p->partition,
+                p->commit_batcher);
               _groups.emplace(r.data.group_id, group);
               _groups.rehash(0);
           }
@@ -782,7 +831,11 @@ group_manager::begin_tx(cluster::begin_group_tx_request&& r) {
           auto group = get_group(r.group_id);
           if (!group) {
               group = ss::make_lw_shared<kafka::group>(
-                r.group_id, group_state::empty, _conf, p->partition);
+                r.group_id,
+                group_state::empty,
+                _conf,
+                p->partition,
+                p->commit_batcher);
               group->reset_tx_state(p->term);
               _groups.emplace(r.group_id, group);
               _groups.rehash(0);
@@ -877,9 +930,13 @@ group_manager::offset_commit(offset_commit_request&& r) {
         if (r.data.generation_id < 0) {
             // <kafka>the group is not relying on Kafka for group management, so
             // allow the commit</kafka>
-            auto p = _partitions.find(r.ntp)->second->partition;
+            auto& p = _partitions.find(r.ntp)->second;
             group = ss::make_lw_shared<kafka::group>(
-              r.data.group_id, group_state::empty, _conf, p);
+              r.data.group_id,
+              group_state::empty,
+              _conf,
+              p->partition,
+              p->commit_batcher);
             _groups.emplace(r.data.group_id, group);
             _groups.rehash(0);
         } else {
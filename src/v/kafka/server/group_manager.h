@@ -33,6 +33,7 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
 
 #include <absl/container/node_hash_map.h>
 #include <cluster/partition_manager.h>
@@ -181,6 +182,7 @@ private:
 
     cluster::notification_id_type _manage_notify_handle;
     ss::gate _gate;
+    ss::timer<ss::lowres_clock> _checkpoint_timer;
 
     void attach_partition(ss::lw_shared_ptr<cluster::partition>);
 
@@ -192,9 +194,14 @@ private:
         ss::basic_rwlock<> catchup_lock;
         model::term_id term{-1};
 
+        // offset commits of the groups coordinated by the partition
+        ss::lw_shared_ptr<offset_commit_batcher> commit_batcher;
+
         explicit attached_partition(ss::lw_shared_ptr<cluster::partition> p)
           : loading(true)
-          , partition(std::move(p)) {}
+          , partition(std::move(p))
+          , commit_batcher(
+              ss::make_lw_shared<offset_commit_batcher>(partition)) {}
     };
 
     cluster::notification_id_type _leader_notify_handle;
@@ -220,6 +227,8 @@ private:
       ss::lw_shared_ptr<attached_partition>,
       recovery_batch_consumer_state);
 
+    ss::future<> checkpoint_partitions();
+
     ss::future<> inject_noop(
       ss::lw_shared_ptr<cluster::partition> p,
       ss::lowres_clock::time_point timeout);
@@ -274,15 +283,23 @@ struct group_log_record_key {
  */
 struct recovery_batch_consumer_state {
     absl::node_hash_map<kafka::group_id, group_stm> groups;
+    // last offset of the log applied to the state
+    model::offset last_offset;
 };
 
 struct recovery_batch_consumer {
     explicit recovery_batch_consumer(ss::abort_source& as)
       : as(as) {}
 
+    /// continue the recovery of a previously recovered state
+    recovery_batch_consumer(
+      ss::abort_source& as, recovery_batch_consumer_state st)
+      : st(std::move(st))
+      , as(as) {}
+
     ss::future<ss::stop_iteration> operator()(model::record_batch batch);
 
-    ss::future<> handle_record(model::record);
+    ss::future<> handle_record(const model::record_view&);
     ss::future<> handle_group_metadata(iobuf, std::optional<iobuf>);
     ss::future<> handle_offset_metadata(iobuf, std::optional<iobuf>);
 
@@ -0,0 +1,201 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/group_recovery_checkpoint.h"
+
+#include "bytes/iobuf.h"
+#include "bytes/iobuf_parser.h"
+#include "cluster/partition.h"
+#include "kafka/server/logger.h"
+#include "reflection/adl.h"
+#include "resource_mgmt/io_priority.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+namespace kafka {
+
+group_recovery_checkpoint::group_recovery_checkpoint(
+  ss::lw_shared_ptr<cluster::partition> p)
+  : _partition(std::move(p))
+  , _snapshot_mgr(
+      std::filesystem::path(
+        _partition->raft()->log_config().work_directory()),
+      filename,
+      ss::default_priority_class()) {}
+
+ss::future<recovery_batch_consumer_state> group_recovery_checkpoint::recover(
+  ss::abort_source& as, model::timeout_clock::time_point timeout) {
+    auto st = co_await load();
+    vlog(
+      klog.debug,
+      "recovering groups of {} from checkpoint at offset {}",
+      _partition->ntp(),
+      st.last_offset);
+    co_return co_await replay(
+      std::move(st), model::model_limits<model::offset>::max(), as, timeout);
+}
+
+ss::future<> group_recovery_checkpoint::checkpoint(ss::abort_source& as) {
+    auto committed = _partition->committed_offset();
+    if (committed < _partition->start_offset()) {
+        co_return;
+    }
+    auto last = co_await checkpointed_offset();
+    if (last >= committed) {
+        co_return;
+    }
+    auto st = co_await replay(
+      co_await load(), committed, as, model::no_timeout);
+    if (as.abort_requested()) {
+        co_return;
+    }
+    co_await _snapshot_mgr.remove_partial_snapshots();
+    co_await persist(st);
+    vlog(
+      klog.debug,
+      "checkpointed groups of {} at offset {}",
+      _partition->ntp(),
+      st.last_offset);
+}
+
+ss::future<model::offset> group_recovery_checkpoint::checkpointed_offset() {
+    auto reader = co_await _snapshot_mgr.open_snapshot();
+    if (!reader) {
+        co_return model::offset{};
+    }
+    model::offset ret;
+    std::exception_ptr ex;
+    try {
+        iobuf_parser meta(co_await reader->read_metadata());
+        auto v = reflection::adl<int8_t>{}.from(meta);
+        if (v == version) {
+            ret = reflection::adl<model::offset>{}.from(meta);
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await reader->close();
+    if (ex) {
+        vlog(
+          klog.warn,
+          "unable to read group recovery checkpoint {} - {}",
+          _snapshot_mgr.snapshot_path(),
+          ex);
+    }
+    co_return ret;
+}
+
+ss::future<recovery_batch_consumer_state> group_recovery_checkpoint::load() {
+    recovery_batch_consumer_state st;
+    auto reader = co_await _snapshot_mgr.open_snapshot();
+    if (!reader) {
+        co_return st;
+    }
+    std::exception_ptr ex;
+    try {
+        iobuf_parser meta(co_await reader->read_metadata());
+        auto v = reflection::adl<int8_t>{}.from(meta);
+        if (v != version) {
+            throw std::runtime_error(
+              fmt::format("unsupported checkpoint version {}", v));
+        }
+        auto last_offset = reflection::adl<model::offset>{}.from(meta);
+        auto size = reflection::adl<uint64_t>{}.from(meta);
+        auto buf = co_await read_iobuf_exactly(reader->input(), size);
+        if (buf.size_bytes() != size) {
+            throw std::runtime_error(fmt::format(
+              "truncated checkpoint, expected {} bytes, got {}",
+              size,
+              buf.size_bytes()));
+        }
+        iobuf_parser data(std::move(buf));
+        auto groups = reflection::adl<std::vector<group_stm_snapshot>>{}.from(
+          data);
+        for (auto& g : groups) {
+            auto id = g.id;
+            st.groups.emplace(std::move(id), group_stm(std::move(g)));
+        }
+        st.last_offset = last_offset;
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await reader->close();
+    if (ex) {
+        vlog(
+          klog.warn,
+          "ignoring group recovery checkpoint {} - {}",
+          _snapshot_mgr.snapshot_path(),
+          ex);
+        co_return recovery_batch_consumer_state{};
+    }
+    co_return st;
+}
+
+ss::future<>
+group_recovery_checkpoint::persist(const recovery_batch_consumer_state& st) {
+    std::vector<group_stm_snapshot> groups;
+    groups.reserve(st.groups.size());
+    for (const auto& [id, stm] : st.groups) {
+        groups.push_back(stm.make_snapshot(id));
+    }
+    iobuf data;
+    reflection::serialize(data, std::move(groups));
+    iobuf meta;
+    reflection::serialize(
+      meta, version, st.last_offset, uint64_t(data.size_bytes()));
+
+    auto writer = co_await _snapshot_mgr.start_snapshot();
+    std::exception_ptr ex;
+    try {
+        co_await writer.write_metadata(std::move(meta));
+        co_await write_iobuf_to_output_stream(std::move(data), writer.output());
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await writer.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_await _snapshot_mgr.finish_snapshot(writer);
+}
+
+ss::future<recovery_batch_consumer_state> group_recovery_checkpoint::replay(
+  recovery_batch_consumer_state st,
+  model::offset max_offset,
+  ss::abort_source& as,
+  model::timeout_clock::time_point timeout) {
+    auto start = _partition->start_offset();
+    if (st.last_offset >= start) {
+        start = model::offset(st.last_offset() + 1);
+    }
+    if (start > max_offset) {
+        co_return st;
+    }
+    storage::log_reader_config reader_config(
+      start,
+      max_offset,
+      0,
+      std::numeric_limits<size_t>::max(),
+      kafka_read_priority(),
+      std::nullopt,
+      std::nullopt,
+      std::nullopt);
+    auto reader = co_await _partition->make_reader(reader_config);
+    co_return co_await std::move(reader).consume(
+      recovery_batch_consumer(as, std::move(st)), timeout);
+}
+
+} // namespace kafka
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "cluster/fwd.h"
+#include "kafka/server/group_manager.h"
+#include "model/fundamental.h"
+#include "model/timeout_clock.h"
+#include "seastarx.h"
+#include "storage/snapshot.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/shared_ptr.hh>
+
+namespace kafka {
+
+/**
+ * Checkpoints of the group coordinator state of a partition.
+ *
+ * A new coordinator used to recover the groups by replaying the whole
+ * partition. Every replica periodically replays the committed records
+ * appended since the last checkpoint on top of it and persists the result
+ * next to the partition log. Recovery loads the checkpoint and only replays
+ * the tail of the log, the outcome is the same as the one of the full replay
+ * since the recovery of the records is deterministic.
+ *
+ * The checkpoint is a local file, it is never replicated. A missing or
+ * unreadable checkpoint falls back to the full replay.
+ */
+class group_recovery_checkpoint {
+public:
+    static constexpr const char* filename = "group_recovery.snapshot";
+
+    explicit group_recovery_checkpoint(ss::lw_shared_ptr<cluster::partition>);
+
+    /// State of the groups including every record of the log
+    ss::future<recovery_batch_consumer_state>
+    recover(ss::abort_source&, model::timeout_clock::time_point timeout);
+
+    /// Persist a new checkpoint if records were committed since the last one
+    ss::future<> checkpoint(ss::abort_source&);
+
+private:
+    ss::future<model::offset> checkpointed_offset();
+    ss::future<recovery_batch_consumer_state> load();
+    ss::future<> persist(const recovery_batch_consumer_state&);
+    ss::future<recovery_batch_consumer_state> replay(
+      recovery_batch_consumer_state,
+      model::offset max_offset,
+      ss::abort_source&,
+      model::timeout_clock::time_point timeout);
+
+    static constexpr int8_t version = 0;
+
+    ss::lw_shared_ptr<cluster::partition> _partition;
+    storage::snapshot_manager _snapshot_mgr;
+};
+
+} // namespace kafka
@@ -2,6 +2,81 @@
 
 namespace kafka {
 
+group_stm::group_stm(group_stm_snapshot&& snap)
+  : _metadata(std::move(snap.metadata))
+  , _is_loaded(snap.is_loaded)
+  , _is_removed(snap.is_removed) {
+    for (auto& o : snap.offsets) {
+        _offsets.emplace(
+          std::move(o.tp),
+          logged_metadata{
+            .log_offset = o.log_offset, .metadata = std::move(o.metadata)});
+    }
+    for (auto& tx : snap.prepared_txs) {
+        auto& prepared = _prepared_txs[tx.pid.get_id()];
+        prepared.pid = tx.pid;
+        prepared.tx_seq = tx.tx_seq;
+        for (auto& o : tx.offsets) {
+            prepared.offsets.emplace(
+              std::move(o.tp),
+              group::offset_metadata{
+                .log_offset = o.log_offset,
+                .offset = o.offset,
+                .metadata = std::move(o.metadata),
+              });
+        }
+    }
+    for (const auto& f : snap.fences) {
+        _fence_pid_epoch.emplace(f.id, f.epoch);
+    }
+}
+
+group_stm_snapshot group_stm::make_snapshot(kafka::group_id id) const {
+    group_stm_snapshot snap{
+      .id = std::move(id),
+      .metadata = group_log_group_metadata{
+        .protocol_type = _metadata.protocol_type,
+        .generation = _metadata.generation,
+        .protocol = _metadata.protocol,
+        .leader = _metadata.leader,
+        .state_timestamp = _metadata.state_timestamp,
+      },
+      .is_loaded = _is_loaded,
+      .is_removed = _is_removed,
+    };
+    // members hold iobufs and are not copyable
+    snap.metadata.members.reserve(_metadata.members.size());
+    for (const auto& m : _metadata.members) {
+        snap.metadata.members.push_back(m.copy());
+    }
+    snap.offsets.reserve(_offsets.size());
+    for (const auto& [tp, md] : _offsets) {
+        snap.offsets.push_back(group_stm_snapshot::offset{
+          .tp = tp, .log_offset = md.log_offset, .metadata = md.metadata});
+    }
+    snap.prepared_txs.reserve(_prepared_txs.size());
+    for (const auto& [_, tx] : _prepared_txs) {
+        group_stm_snapshot::prepared_tx prepared{
+          .pid = tx.pid, .tx_seq = tx.tx_seq};
+        prepared.offsets.reserve(tx.offsets.size());
+        for (const auto& [tp, md] : tx.offsets) {
+            prepared.offsets.push_back(group_stm_snapshot::prepared_offset{
+              .tp = tp,
+              .log_offset = md.log_offset,
+              .offset = md.offset,
+              .metadata = md.metadata,
+            });
+        }
+        snap.prepared_txs.push_back(std::move(prepared));
+    }
+    snap.fences.reserve(_fence_pid_epoch.size());
+    for (const auto& [pid, epoch] : _fence_pid_epoch) {
+        snap.fences.push_back(
+          group_stm_snapshot::fence{.id = pid, .epoch = epoch});
+    }
+    return snap;
+}
+
 void group_stm::overwrite_metadata(group_log_group_metadata&& metadata) {
     _metadata = std::move(metadata);
     _is_loaded = true;
@@ -106,6 +106,43 @@ struct hash<kafka::group_log_offset_key> {
 
 namespace kafka {
 
+/**
+ * serializable state of a group_stm, see group_recovery_checkpoint.
+ */
+struct group_stm_snapshot {
+    struct offset {
+        model::topic_partition tp;
+        model::offset log_offset;
+        group_log_offset_metadata metadata;
+    };
+
+    struct prepared_offset {
+        model::topic_partition tp;
+        model::offset log_offset;
+        model::offset offset;
+        ss::sstring metadata;
+    };
+
+    struct prepared_tx {
+        model::producer_identity pid;
+        model::tx_seq tx_seq;
+        std::vector<prepared_offset> offsets;
+    };
+
+    struct fence {
+        model::producer_id id;
+        model::producer_epoch epoch;
+    };
+
+    kafka::group_id id;
+    group_log_group_metadata metadata;
+    bool is_loaded;
+    bool is_removed;
+    std::vector<offset> offsets;
+    std::vector<prepared_tx> prepared_txs;
+    std::vector<fence> fences;
+};
+
 class group_stm {
 public:
     struct logged_metadata {
@@ -113,6 +150,11 @@ public:
         group_log_offset_metadata metadata;
     };
 
+    group_stm() = default;
+    explicit group_stm(group_stm_snapshot&&);
+
+    group_stm_snapshot make_snapshot(kafka::group_id) const;
+
     void overwrite_metadata(group_log_group_metadata&&);
     void remove() {
         _offsets.clear();
@@ -32,14 +32,19 @@
 
 namespace kafka {
 
-static constexpr std::array<std::string_view, 7> supported_configs{
+static constexpr std::array<std::string_view, 12> supported_configs{
   {"compression.type",
    "cleanup.policy",
    "message.timestamp.type",
    "segment.bytes",
    "compaction.strategy",
    "retention.bytes",
-   "retention.ms"}};
+   "retention.ms",
+   "redpanda.storage.engine",
+   "flush.ms",
+   "flush.bytes",
+   "redpanda.remote.recovery",
+   "redpanda.remote.readreplica"}};
 
 bool is_supported(std::string_view name) {
     return std::any_of(
@@ -53,7 +58,8 @@ using validators = make_validator_types<
   no_custom_partition_assignment,
   partition_count_must_be_positive,
   replication_factor_must_be_positive,
-  replication_factor_must_be_odd>;
+  replication_factor_must_be_odd,
+  memory_storage_engine_is_not_compacted>;
 
 template<>
 ss::future<response_ptr> create_topics_handler::handle(
@@ -31,6 +31,8 @@
 #include <fmt/ranges.h>
 
 #include <charconv>
+#include <chrono>
+#include <limits>
 #include <string_view>
 
 namespace kafka {
@@ -419,6 +421,57 @@ ss::future<response_ptr> describe_configs_handler::handle(
               request.data.include_synonyms,
               &describe_as_string<model::timestamp_type>);
 
+            // the engine of the partitions has no broker default
+            add_topic_config(
+              result,
+              topic_property_storage_engine,
+              model::storage_engine::disk,
+              topic_property_storage_engine,
+              topic_config->properties.storage_engine,
+              request.data.include_synonyms,
+              &describe_as_string<model::storage_engine>);
+
+            // without a flush policy the writes acknowledged by the leader
+            // alone are flushed along the other writes, kafka reports it as
+            // the max value
+            add_topic_config(
+              result,
+              topic_property_flush_ms,
+              std::chrono::milliseconds(std::numeric_limits<int64_t>::max()),
+              topic_property_flush_ms,
+              topic_config->properties.flush_ms,
+              request.data.include_synonyms,
+              [](std::chrono::milliseconds ms) {
+                  return ssx::sformat("{}", ms.count());
+              });
+
+            add_topic_config(
+              result,
+              topic_property_flush_bytes,
+              size_t(std::numeric_limits<int64_t>::max()),
+              topic_property_flush_bytes,
+              topic_config->properties.flush_bytes,
+              request.data.include_synonyms,
+              &describe_as_string<size_t>);
+
+            add_topic_config(
+              result,
+              topic_property_recovery,
+              false,
+              topic_property_recovery,
+              topic_config->properties.recovery,
+              request.data.include_synonyms,
+              &describe_as_string<bool>);
+
+            add_topic_config(
+              result,
+              topic_property_read_replica,
+              ss::sstring{},
+              topic_property_read_replica,
+              topic_config->properties.read_replica_bucket,
+              request.data.include_synonyms,
+              [](const ss::sstring& s) { return s; });
+
             break;
         }
 
@@ -23,11 +23,16 @@
 
 #include <fmt/ostream.h>
 
+#include <iterator>
+
 namespace kafka {
 
 using partition_dir_set
   = absl::flat_hash_map<model::topic, std::vector<describe_log_dirs_partition>>;
 
+// the partitions of each data directory
+using log_dir_set = absl::flat_hash_map<ss::sstring, partition_dir_set>;
+
 static describe_log_dirs_partition describe_partition(cluster::partition& p) {
     return describe_log_dirs_partition{
       .partition_index = p.ntp().tp.partition(),
@@ -38,10 +43,15 @@ static describe_log_dirs_partition describe_partition(cluster::partition& p) {
     };
 }
 
-static partition_dir_set collect_mapper(
+static void add_partition(log_dir_set& ret, cluster::partition& p) {
+    ret[p.log_config().base_directory()][p.ntp().tp.topic].push_back(
+      describe_partition(p));
+}
+
+static log_dir_set collect_mapper(
   cluster::partition_manager& pm,
   const std::optional<std::vector<describable_log_dir_topic>>& topics) {
-    partition_dir_set ret;
+    log_dir_set ret;
 
     /*
      * return all partitions
@@ -51,8 +61,7 @@ static partition_dir_set collect_mapper(
             if (partition.first.ns != model::kafka_namespace) {
                 continue;
             }
-            ret[partition.first.tp.topic].push_back(
-              describe_partition(*partition.second));
+            add_partition(ret, *partition.second);
         }
         return ret;
     }
@@ -64,7 +73,7 @@ static partition_dir_set collect_mapper(
         for (auto p_id : topic.partition_index) {
             model::ntp ntp(model::kafka_namespace, topic.topic, p_id);
             if (auto p = pm.get(ntp); p) {
-                ret[topic.topic].push_back(describe_partition(*p));
+                add_partition(ret, *p);
             }
         }
     }
@@ -74,18 +83,27 @@ static partition_dir_set collect_mapper(
 /*
  * collect log directory information for partitions
  */
-static ss::future<partition_dir_set> collect(
+static ss::future<log_dir_set> collect(
   request_context& ctx,
   std::optional<std::vector<describable_log_dir_topic>> filter) {
     return ctx.partition_manager().map_reduce0(
       [filter = std::move(filter)](cluster::partition_manager& pm) {
           return collect_mapper(pm, filter);
       },
-      partition_dir_set{},
-      [](partition_dir_set acc, const partition_dir_set& update) {
-          for (auto& topic : update) {
-              for (auto partition : topic.second) {
-                  acc[topic.first].push_back(partition);
+      log_dir_set{},
+      [](log_dir_set acc, log_dir_set update) {
+          for (auto& [dir, topics] : update) {
+              auto& dir_topics = acc[dir];
+              for (auto& [topic, partitions] : topics) {
+                  auto& dst = dir_topics[topic];
+                  if (dst.empty()) {
+                      dst = std::move(partitions);
+                      continue;
+                  }
+                  dst.insert(
+                    dst.end(),
+                    std::make_move_iterator(partitions.begin()),
+                    std::make_move_iterator(partitions.end()));
               }
           }
           return acc;
@@ -101,11 +119,18 @@ ss::future<response_ptr> describe_log_dirs_handler::handle(
 
     describe_log_dirs_response response;
 
-    // redpanda only supports a single data directory right now
+    // a result per data directory, the partitions are placed in any of them
     response.data.results.push_back(describe_log_dirs_result{
       .error_code = error_code::none,
       .log_dir = config::shard_local_cfg().data_directory().as_sstring(),
     });
+    for (const auto& dir :
+         config::shard_local_cfg().additional_data_directories()) {
+        response.data.results.push_back(describe_log_dirs_result{
+          .error_code = error_code::none,
+          .log_dir = dir,
+        });
+    }
 
     if (!ctx.authorized(
           security::acl_operation::describe, security::default_cluster_name)) {
@@ -113,14 +138,21 @@ ss::future<response_ptr> describe_log_dirs_handler::handle(
         co_return co_await ctx.respond(std::move(response));
     }
 
-    auto partitions = co_await collect(ctx, std::move(request.data.topics));
+    auto dirs = co_await collect(ctx, std::move(request.data.topics));
 
-    while (!partitions.empty()) {
-        auto node = partitions.extract(partitions.begin());
-        response.data.results.back().topics.push_back(describe_log_dirs_topic{
-          .name = std::move(node.key()),
-          .partitions = std::move(node.mapped()),
-        });
+    for (auto& result : response.data.results) {
+        auto it = dirs.find(result.log_dir);
+        if (it == dirs.end()) {
+            continue;
+        }
+        auto& partitions = it->second;
+        while (!partitions.empty()) {
+            auto node = partitions.extract(partitions.begin());
+            result.topics.push_back(describe_log_dirs_topic{
+              .name = std::move(node.key()),
+              .partitions = std::move(node.mapped()),
+            });
+        }
     }
 
     co_return co_await ctx.respond(std::move(response));
@@ -9,6 +9,7 @@
 
 #include "kafka/server/handlers/fetch.h"
 
+#include "archival/service.h"
 #include "cluster/partition_manager.h"
 #include "cluster/shard_table.h"
 #include "config/configuration.h"
@@ -28,14 +29,19 @@
 #include "model/timeout_clock.h"
 #include "random/generators.h"
 #include "resource_mgmt/io_priority.h"
+#include "ssx/future-util.h"
 #include "storage/parser_utils.h"
 #include "utils/to_string.h"
 
+#include <seastar/core/abort_source.hh>
 #include <seastar/core/do_with.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/sharded.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/util/log.hh>
 
+#include <absl/container/flat_hash_map.h>
 #include <boost/range/irange.hpp>
 #include <fmt/ostream.h>
 
@@ -97,7 +103,7 @@ model::record_batch adapt_fetch_batch(model::record_batch&& batch) {
     batch.header().attrs.set_control_type();
     iobuf records;
 
-    batch.for_each_record([&records](model::record r) {
+    batch.for_each_record_view([&records](const model::record_view& r) {
         auto key = make_control_record_batch_key();
         auto key_size = key.size_bytes();
         auto r_size = control_record_size(
@@ -121,22 +127,74 @@ model::record_batch adapt_fetch_batch(model::record_batch&& batch) {
       header, std::move(records), model::record_batch::tag_ctor_ng{});
 }
 
+namespace {
+
+/// \brief the data of a read of a partition range
+struct partition_range_read {
+    iobuf data;
+    size_t record_count{0};
+    std::vector<cluster::rm_stm::tx_range> aborted_transactions;
+};
+
+using partition_range_read_ptr = ss::lw_shared_ptr<partition_range_read>;
+
+struct partition_range_key {
+    model::ntp ntp;
+    model::offset start_offset;
+    model::offset max_offset;
+    size_t max_bytes;
+    bool strict_max_bytes;
+    // the state of the partition the fetch saw, a fetch doesn't join a read
+    // of a partition that changed since, e.g. was truncated or recreated
+    model::offset log_start_offset;
+    model::offset high_watermark;
+
+    bool operator==(const partition_range_key&) const = default;
+
+    template<typename H>
+    friend H AbslHashValue(H h, const partition_range_key& k) {
+        return H::combine(
+          std::move(h),
+          k.ntp,
+          k.start_offset,
+          k.max_offset,
+          k.max_bytes,
+          k.strict_max_bytes,
+          k.log_start_offset,
+          k.high_watermark);
+    }
+};
+
+struct shared_read {
+    ss::shared_future<partition_range_read_ptr> read;
+    std::optional<model::timeout_clock::time_point> deadline;
+
+    /// a fetch only joins a read that doesn't time out before it would
+    bool can_join(std::optional<model::timeout_clock::time_point> d) const {
+        return !deadline || (d && *d >= *deadline);
+    }
+};
+
+using shared_reads_t = absl::flat_hash_map<partition_range_key, shared_read>;
+
 /**
- * Low-level handler for reading from an ntp. Runs on ntp's home core.
+ * The reads of the partition ranges in progress on the shard. The fetches of
+ * a range that is being read, e.g. by the consumer groups tailing the same
+ * topic, wait for the read and get a share of its data instead of reading
+ * and serializing the range again. The isolation level is part of the range
+ * as its max offset. A read is only shared while it is in progress.
  */
-static ss::future<read_result> read_from_partition(
-  kafka::partition_proxy part,
-  fetch_config config,
-  bool foreign_read,
-  std::optional<model::timeout_clock::time_point> deadline) {
-    auto hw = part.high_watermark();
-    auto lso = part.last_stable_offset();
-    auto start_o = part.start_offset();
-    // if we have no data read, return fast
-    if (hw < config.start_offset || config.skip_read) {
-        co_return read_result(start_o, hw, lso);
-    }
+shared_reads_t& shared_reads() {
+    static thread_local shared_reads_t reads;
+    return reads;
+}
+
+} // namespace
 
+static ss::future<partition_range_read_ptr> do_read_partition_range(
+  kafka::partition_proxy& part,
+  const fetch_config& config,
+  std::optional<model::timeout_clock::time_point> deadline) {
     storage::log_reader_config reader_config(
       config.start_offset,
       config.max_offset,
@@ -151,13 +209,76 @@ static ss::future<read_result> read_from_partition(
     auto rdr = co_await part.make_reader(reader_config);
     auto result = co_await std::move(rdr).consume(
       kafka_batch_serializer(), deadline ? *deadline : model::no_timeout);
-    auto data = std::make_unique<iobuf>(std::move(result.data));
-    std::vector<cluster::rm_stm::tx_range> aborted_transactions;
-    part.probe().add_records_fetched(result.record_count);
+    auto read = ss::make_lw_shared<partition_range_read>();
+    read->data = std::move(result.data);
+    read->record_count = result.record_count;
     if (result.record_count > 0) {
-        aborted_transactions = co_await part.aborted_transactions(
+        read->aborted_transactions = co_await part.aborted_transactions(
           result.base_offset, result.last_offset);
     }
+    co_return read;
+}
+
+static ss::future<partition_range_read_ptr> read_partition_range(
+  kafka::partition_proxy& part,
+  const fetch_config& config,
+  model::offset log_start_offset,
+  model::offset high_watermark,
+  std::optional<model::timeout_clock::time_point> deadline) {
+    partition_range_key key{
+      .ntp = part.ntp(),
+      .start_offset = config.start_offset,
+      .max_offset = config.max_offset,
+      .max_bytes = config.max_bytes,
+      .strict_max_bytes = config.strict_max_bytes,
+      .log_start_offset = log_start_offset,
+      .high_watermark = high_watermark,
+    };
+    auto& reads = shared_reads();
+    auto it = reads.find(key);
+    const bool in_progress = it != reads.end();
+    if (in_progress && it->second.can_join(deadline)) {
+        // the shared future outlives the read of the first fetch
+        auto read = it->second.read;
+        co_return co_await read.get_future();
+    }
+    auto f = do_read_partition_range(part, config, deadline);
+    if (f.available() || in_progress) {
+        // a fetch with an earlier deadline reads on its own
+        co_return co_await std::move(f);
+    }
+    // the first fetch keeps the partition alive until the read completes
+    ss::shared_future<partition_range_read_ptr> read(
+      std::move(f).finally([key] { shared_reads().erase(key); }));
+    reads.emplace(
+      std::move(key), shared_read{.read = read, .deadline = deadline});
+    co_return co_await read.get_future();
+}
+
+/**
+ * Low-level handler for reading from an ntp. Runs on ntp's home core.
+ */
+ss::future<read_result> read_from_partition(
+  kafka::partition_proxy part,
+  fetch_config config,
+  bool foreign_read,
+  std::optional<model::timeout_clock::time_point> deadline) {
+    auto hw = part.high_watermark();
+    auto lso = part.last_stable_offset();
+    auto start_o = part.start_offset();
+    // if we have no data read, return fast
+    if (hw < config.start_offset || config.skip_read) {
+        co_return read_result(start_o, hw, lso);
+    }
+
+    auto read = co_await read_partition_range(
+      part, config, start_o, hw, deadline);
+    part.probe().add_records_fetched(read->record_count);
+    part.probe().add_bytes_fetched(read->data.size_bytes());
+    // every fetch of the range gets its own share of the buffers
+    auto data = std::make_unique<iobuf>(
+      read->data.share(0, read->data.size_bytes()));
+    auto aborted_transactions = read->aborted_transactions;
 
     if (foreign_read) {
         co_return read_result(
@@ -171,12 +292,46 @@ static ss::future<read_result> read_from_partition(
       std::move(data), start_o, hw, lso, std::move(aborted_transactions));
 }
 
+/**
+ * Picks the follower in the rack of the consumer the fetch should be
+ * redirected to. Only healthy followers are considered, the choice is spread
+ * across them by the partition id. Returns nullopt if the leader is in the
+ * rack of the consumer or there is no such follower.
+ */
+static std::optional<model::node_id>
+select_preferred_replica(cluster::partition& p, const fetch_config& cfg) {
+    if (cfg.rack_replicas.empty()) {
+        return std::nullopt;
+    }
+    auto in_rack = [&cfg](model::node_id id) {
+        return std::find(
+                 cfg.rack_replicas.begin(), cfg.rack_replicas.end(), id)
+               != cfg.rack_replicas.end();
+    };
+    if (in_rack(p.raft()->self().id())) {
+        return std::nullopt;
+    }
+    std::vector<model::node_id> candidates;
+    for (const auto& f : p.raft()->get_follower_metrics()) {
+        if (
+          in_rack(f.id) && f.is_live && !f.under_replicated && !f.is_learner) {
+            candidates.push_back(f.id);
+        }
+    }
+    if (candidates.empty()) {
+        return std::nullopt;
+    }
+    std::sort(candidates.begin(), candidates.end());
+    return candidates[p.ntp().tp.partition() % candidates.size()];
+}
+
 /**
  * Entry point for reading from an ntp. This is executed on NTP home core and
  * build error responses if anything goes wrong.
  */
 static ss::future<read_result> do_read_from_ntp(
   cluster::partition_manager& mgr,
+  archival::scheduler_service* archival,
   ntp_fetch_config ntp_config,
   bool foreign_read,
   std::optional<model::timeout_clock::time_point> deadline) {
@@ -188,13 +343,43 @@ static ss::future<read_result> do_read_from_ntp(
         return ss::make_ready_future<read_result>(
           error_code::unknown_topic_or_partition);
     }
-    if (unlikely(!partition->is_leader())) {
+    const bool is_leader = partition->is_leader();
+    /*
+     * the partitions of a read replica topic have no local data, the leader
+     * serves all reads from the bucket of the source cluster
+     */
+    const bool is_read_replica
+      = partition->get_ntp_config().is_read_replica()
+        && !ntp_config.materialized_ntp.is_materialized();
+    if (
+      unlikely(!is_leader)
+      && (is_read_replica
+          || !config::shard_local_cfg().enable_follower_fetching())) {
         return ss::make_ready_future<read_result>(
           error_code::not_leader_for_partition);
     }
 
+    /*
+     * reads below the local start offset are served from the cloud storage
+     */
+    ss::lw_shared_ptr<cloud_storage::remote_partition> remote;
+    if (is_read_replica) {
+        if (archival) {
+            remote = archival->get_read_replica(ntp_config.ntp());
+        }
+        if (!remote) {
+            // the manifest of the source partition is not downloaded yet
+            return ss::make_ready_future<read_result>(
+              error_code::leader_not_available);
+        }
+    } else if (
+      archival && is_leader
+      && !ntp_config.materialized_ntp.is_materialized()) {
+        remote = archival->get_remote_partition(ntp_config.ntp());
+    }
+
     auto kafka_partition = make_partition_proxy(
-      ntp_config.materialized_ntp, partition, mgr);
+      ntp_config.materialized_ntp, partition, mgr, std::move(remote));
     if (!kafka_partition) {
         return ss::make_ready_future<read_result>(
           error_code::unknown_topic_or_partition);
@@ -213,6 +398,30 @@ static ss::future<read_result> do_read_from_ntp(
           error_code::offset_out_of_range);
     }
 
+    if (is_leader && !is_read_replica) {
+        /*
+         * consumer in a different rack than the leader, let it know which
+         * replica it should fetch from, the data is not read
+         */
+        auto preferred = select_preferred_replica(*partition, ntp_config.cfg);
+        if (preferred) {
+            read_result res(
+              kafka_partition->start_offset(),
+              kafka_partition->high_watermark(),
+              kafka_partition->last_stable_offset());
+            res.preferred_replica = preferred;
+            return ss::make_ready_future<read_result>(std::move(res));
+        }
+    } else {
+        /*
+         * followers only serve data that is known to be committed, the proxy
+         * reports the follower high watermark in this case
+         */
+        ntp_config.cfg.max_offset = std::min(
+          ntp_config.cfg.max_offset,
+          raft::details::prev_offset(kafka_partition->high_watermark()));
+    }
+
     return read_from_partition(
       std::move(*kafka_partition), ntp_config.cfg, foreign_read, deadline);
 }
@@ -229,7 +438,21 @@ ss::future<read_result> read_from_ntp(
   bool foreign_read,
   std::optional<model::timeout_clock::time_point> deadline) {
     return do_read_from_ntp(
-      pm, make_ntp_fetch_config(ntp, config), foreign_read, deadline);
+      pm, nullptr, make_ntp_fetch_config(ntp, config), foreign_read, deadline);
+}
+
+/**
+ * Returns shard local archival service if the reads from the cloud storage
+ * are enabled.
+ */
+static archival::scheduler_service*
+remote_read_service(ss::sharded<archival::scheduler_service>& svc) {
+    if (
+      !config::shard_local_cfg().cloud_storage_enable_remote_read()
+      || !svc.local_is_initialized()) {
+        return nullptr;
+    }
+    return &svc.local();
 }
 
 static void fill_fetch_responses(
@@ -270,6 +493,9 @@ static void fill_fetch_responses(
         resp.log_start_offset = res.start_offset;
         resp.high_watermark = res.high_watermark;
         resp.last_stable_offset = res.last_stable_offset;
+        if (res.preferred_replica) {
+            resp.preferred_read_replica = *res.preferred_replica;
+        }
 
         /**
          * According to KIP-74 we have to return first batch even if it would
@@ -307,14 +533,17 @@ static void fill_fetch_responses(
 
 static ss::future<std::vector<read_result>> fetch_ntps_in_parallel(
   cluster::partition_manager& mgr,
+  archival::scheduler_service* archival,
   std::vector<ntp_fetch_config> ntp_fetch_configs,
   bool foreign_read,
   std::optional<model::timeout_clock::time_point> deadline) {
     return ssx::parallel_transform(
       std::move(ntp_fetch_configs),
-      [&mgr, deadline, foreign_read](const ntp_fetch_config& ntp_cfg) {
+      [&mgr, archival, deadline, foreign_read](
+        const ntp_fetch_config& ntp_cfg) {
           auto p_id = ntp_cfg.ntp().tp.partition;
-          return do_read_from_ntp(mgr, ntp_cfg, foreign_read, deadline)
+          return do_read_from_ntp(
+                   mgr, archival, ntp_cfg, foreign_read, deadline)
             .then([p_id](read_result res) {
                 res.partition = p_id;
                 return res;
@@ -349,10 +578,15 @@ handle_shard_fetch(ss::shard_id shard, op_context& octx, shard_fetch fetch) {
         octx.ssg,
         [foreign_read,
          deadline = octx.deadline,
+         archival = &octx.rctx.archival_service(),
          configs = std::move(fetch.requests)](
           cluster::partition_manager& mgr) mutable {
             return fetch_ntps_in_parallel(
-              mgr, std::move(configs), foreign_read, deadline);
+              mgr,
+              remote_read_service(*archival),
+              std::move(configs),
+              foreign_read,
+              deadline);
         })
       .then([responses = std::move(fetch.responses),
              &octx](std::vector<read_result> results) mutable {
@@ -380,16 +614,72 @@ class parallel_fetch_plan_executor final : public fetch_plan_executor::impl {
     }
 };
 
-class simple_fetch_planner final : public fetch_planner::impl {
+void allocate_fetch_budget(
+  std::vector<partition_fetch_budget>& budgets, size_t budget) {
+    size_t shards = 0;
+    for (auto& b : budgets) {
+        b.estimated_bytes = std::min(b.estimated_bytes, b.max_bytes);
+        b.allocated_bytes = 0;
+        shards = std::max<size_t>(shards, b.shard + 1);
+    }
+    std::vector<size_t> shard_budget(shards, 0);
+    size_t total_estimate = 0;
+    for (const auto& b : budgets) {
+        shard_budget[b.shard] += b.estimated_bytes;
+        total_estimate += b.estimated_bytes;
+    }
+    if (total_estimate > budget) {
+        // not everything fits, split the budget proportionally
+        auto ratio = static_cast<double>(budget)
+                     / static_cast<double>(total_estimate);
+        for (auto& sb : shard_budget) {
+            sb = static_cast<size_t>(static_cast<double>(sb) * ratio);
+        }
+    }
+
+    auto left = budget;
+    for (auto& b : budgets) {
+        auto& sb = shard_budget[b.shard];
+        auto bytes = std::min({b.estimated_bytes, sb, left});
+        b.allocated_bytes = bytes;
+        sb -= bytes;
+        left -= bytes;
+    }
+    // leftovers (rounding and unused shard budgets) are given away in
+    // priority order
+    for (auto& b : budgets) {
+        if (left == 0) {
+            break;
+        }
+        auto bytes = std::min(b.max_bytes - b.allocated_bytes, left);
+        b.allocated_bytes += bytes;
+        left -= bytes;
+    }
+}
+
+/**
+ * Planner that splits the response budget between the partition reads
+ * before they are dispatched, so the reads can run in parallel on all
+ * shards without exceeding the budget by much. The bytes available in a
+ * partition are estimated using the cached high watermark.
+ */
+class budget_aware_fetch_planner final : public fetch_planner::impl {
+    struct planned_read {
+        model::materialized_ntp ntp;
+        model::offset fetch_offset;
+        op_context::response_iterator response;
+    };
+
     fetch_plan create_plan(op_context& octx) final {
         fetch_plan plan(ss::smp::count);
+        std::vector<planned_read> reads;
+        std::vector<partition_fetch_budget> budgets;
         auto resp_it = octx.response_begin();
-        auto bytes_left_in_plan = octx.bytes_left;
         /**
          * group fetch requests by shard
          */
         octx.for_each_fetch_partition(
-          [&resp_it, &octx, &plan, &bytes_left_in_plan](
+          [&resp_it, &octx, &reads, &budgets](
             const fetch_session_partition& fp) {
               // if this is not an initial fetch we are allowed to skip
               // partions that aleready have an error or we have enough data
@@ -431,62 +721,289 @@ class simple_fetch_planner final : public fetch_planner::impl {
                   return;
               }
 
-              auto fetch_md = octx.rctx.get_fetch_metadata_cache().get(ntp);
-              auto max_bytes = std::min(
-                bytes_left_in_plan, size_t(fp.max_bytes));
+              auto max_bytes = size_t(std::max(fp.max_bytes, int32_t(0)));
               /**
-               * If offset is greater, assume that fetch will read max_bytes
+               * Partitions that are known to be caught up are not expected
+               * to return any data, the ones without cached metadata may
+               * return up to max_bytes
                */
-              if (fetch_md && fetch_md->high_watermark > fp.fetch_offset) {
-                  bytes_left_in_plan -= max_bytes;
+              auto estimated_bytes = max_bytes;
+              auto fetch_md = octx.rctx.get_fetch_metadata_cache().get(ntp);
+              if (fetch_md && fetch_md->high_watermark <= fp.fetch_offset) {
+                  estimated_bytes = 0;
               }
 
-              fetch_config config{
-                .start_offset = fp.fetch_offset,
-                .max_offset = model::model_limits<model::offset>::max(),
-                .isolation_level = octx.request.data.isolation_level,
+              budgets.push_back(partition_fetch_budget{
+                .shard = *shard,
                 .max_bytes = max_bytes,
-                .timeout = octx.deadline.value_or(model::no_timeout),
-                .strict_max_bytes = octx.response_size > 0,
-                .skip_read = bytes_left_in_plan == 0 && max_bytes == 0,
-              };
-
-              plan.fetches_per_shard[*shard].push_back(
-                make_ntp_fetch_config(materialized_ntp, config), resp_it++);
+                .estimated_bytes = estimated_bytes,
+              });
+              reads.push_back(planned_read{
+                .ntp = std::move(materialized_ntp),
+                .fetch_offset = fp.fetch_offset,
+                .response = resp_it++,
+              });
           });
 
+        allocate_fetch_budget(budgets, octx.bytes_left);
+
+        /**
+         * Brokers in the rack of the consumer, the leaders redirect the
+         * consumer to a replica in its rack (KIP-392)
+         */
+        std::vector<model::node_id> rack_replicas;
+        if (
+          config::shard_local_cfg().enable_follower_fetching()
+          && !octx.request.data.rack_id.empty()) {
+            for (const auto& b : octx.rctx.metadata_cache().all_brokers()) {
+                if (b->rack() == octx.request.data.rack_id) {
+                    rack_replicas.push_back(b->id());
+                }
+            }
+        }
+
+        for (size_t i = 0; i < reads.size(); ++i) {
+            fetch_config config{
+              .start_offset = reads[i].fetch_offset,
+              .max_offset = model::model_limits<model::offset>::max(),
+              .isolation_level = octx.request.data.isolation_level,
+              .max_bytes = budgets[i].allocated_bytes,
+              .timeout = octx.deadline.value_or(model::no_timeout),
+              .strict_max_bytes = octx.response_size > 0,
+              .skip_read = budgets[i].allocated_bytes == 0,
+              .rack_replicas = rack_replicas,
+            };
+
+            plan.fetches_per_shard[budgets[i].shard].push_back(
+              make_ntp_fetch_config(reads[i].ntp, config), reads[i].response);
+        }
+
         return plan;
     }
 };
 
+/**
+ * Shard local waiter for new data in a set of partitions. It is completed
+ * when any of the partitions has data readable past the offset the fetch
+ * has already seen, when all the partition waits time out or when aborted.
+ */
+struct data_waiter {
+    ss::abort_source as;
+    ss::promise<> done;
+    size_t pending{0};
+    bool completed{false};
+    // a partition is gone or moved, there is nothing to wait for
+    bool replan{false};
+
+    void complete() {
+        if (completed) {
+            return;
+        }
+        completed = true;
+        done.set_value();
+        // release the waits registered for the other partitions
+        if (!as.abort_requested()) {
+            as.request_abort();
+        }
+    }
+};
+
+static bool use_last_stable_offset(model::isolation_level l) {
+    return config::shard_local_cfg().enable_transactions()
+           && l == model::isolation_level::read_committed;
+}
+
+/**
+ * Register waits on the visible offset of the partitions. Executed on the
+ * home shard of the partitions.
+ */
+static ss::lw_shared_ptr<data_waiter> register_data_waiter(
+  cluster::partition_manager& mgr,
+  std::vector<ntp_fetch_config> configs,
+  model::timeout_clock::time_point deadline) {
+    auto w = ss::make_lw_shared<data_waiter>();
+    for (auto& cfg : configs) {
+        auto partition = mgr.get(cfg.ntp());
+        if (
+          !partition
+          || (!partition->is_leader()
+              && !config::shard_local_cfg().enable_follower_fetching())) {
+            // the partition moved, the fetch has to be replanned
+            w->replan = true;
+            w->complete();
+            break;
+        }
+        if (
+          cfg.materialized_ntp.is_materialized()
+          || !partition->get_ntp_config().is_read_replica()) {
+            auto proxy = make_partition_proxy(
+              cfg.materialized_ntp, partition, mgr);
+            if (!proxy) {
+                w->replan = true;
+                w->complete();
+                break;
+            }
+            auto readable = use_last_stable_offset(cfg.cfg.isolation_level)
+                              ? proxy->last_stable_offset()
+                              : proxy->high_watermark();
+            // data was appended after the partition was read
+            if (readable > cfg.cfg.start_offset) {
+                w->complete();
+                break;
+            }
+        }
+        // the local log of a read replica never advances, the segments
+        // uploaded by the source cluster are found by the next fetch after
+        // the deadline
+        // the wait holds the gate of the consensus, it is aborted when the
+        // partition shuts down
+        auto raft = partition->raft();
+        ++w->pending;
+        (void)raft->wait_for_next_visible_offset(deadline, w->as)
+          .then_wrapped([w, raft](ss::future<> f) {
+              auto notified = !f.failed();
+              f.ignore_ready_future();
+              --w->pending;
+              if (notified || w->pending == 0) {
+                  w->complete();
+              }
+          });
+    }
+    if (w->pending == 0) {
+        w->complete();
+    }
+    return w;
+}
+
+// partitions to wait for, grouped by shard
+using data_waits_t = std::vector<std::vector<ntp_fetch_config>>;
+
+/**
+ * Collect the partitions that were read by the plan. The fetch waits for
+ * data past the high watermark (or the last stable offset) returned in the
+ * response.
+ */
+static data_waits_t make_data_waits(std::vector<shard_fetch>& fetches) {
+    data_waits_t waits(fetches.size());
+    for (size_t shard = 0; shard < fetches.size(); ++shard) {
+        auto& fetch = fetches[shard];
+        for (size_t i = 0; i < fetch.requests.size(); ++i) {
+            auto& resp = fetch.responses[i]->partition_response;
+            auto& cfg = fetch.requests[i];
+            if (cfg.cfg.skip_read || resp->error_code != error_code::none) {
+                continue;
+            }
+            auto seen = use_last_stable_offset(cfg.cfg.isolation_level)
+                          ? resp->last_stable_offset
+                          : resp->high_watermark;
+            cfg.cfg.start_offset = std::max(cfg.cfg.start_offset, seen);
+            waits[shard].push_back(std::move(cfg));
+        }
+    }
+    return waits;
+}
+
+/**
+ * Wait until any of the partitions receives new data or the deadline is
+ * reached. The waits are registered on all the shards in parallel, when the
+ * first one completes the remaining ones are aborted. Returns true if a
+ * partition couldn't be waited for, it moved or is gone, in which case the
+ * fetch is retried after the debounce delay.
+ */
+static ss::future<bool> wait_for_data(
+  op_context& octx,
+  data_waits_t waits,
+  model::timeout_clock::time_point deadline) {
+    using waiter_ptr = ss::foreign_ptr<ss::lw_shared_ptr<data_waiter>>;
+    struct shard_waiter {
+        ss::shard_id shard;
+        waiter_ptr waiter;
+    };
+    struct first_completed {
+        ss::promise<> done;
+        bool completed{false};
+    };
+
+    std::vector<ss::shard_id> shards;
+    for (ss::shard_id shard = 0; shard < waits.size(); ++shard) {
+        if (!waits[shard].empty()) {
+            shards.push_back(shard);
+        }
+    }
+    auto& pm = octx.rctx.partition_manager();
+    auto waiters = co_await ssx::parallel_transform(
+      std::move(shards), [&pm, &octx, &waits, deadline](ss::shard_id shard) {
+          return pm
+            .invoke_on(
+              shard,
+              octx.ssg,
+              [configs = std::move(waits[shard]),
+               deadline](cluster::partition_manager& mgr) mutable {
+                  return ss::make_foreign(
+                    register_data_waiter(mgr, std::move(configs), deadline));
+              })
+            .then([shard](waiter_ptr w) {
+                return shard_waiter{.shard = shard, .waiter = std::move(w)};
+            });
+      });
+
+    auto first = ss::make_lw_shared<first_completed>();
+    std::vector<ss::future<>> shard_waits;
+    shard_waits.reserve(waiters.size());
+    for (auto& sw : waiters) {
+        shard_waits.push_back(
+          pm.invoke_on(
+              sw.shard,
+              octx.ssg,
+              [w = sw.waiter.get()](cluster::partition_manager&) {
+                  return w->done.get_future();
+              })
+            .then([first] {
+                if (!first->completed) {
+                    first->completed = true;
+                    first->done.set_value();
+                }
+            }));
+    }
+    if (!shard_waits.empty()) {
+        co_await first->done.get_future();
+    }
+    // abort the waits on the other shards
+    bool replan = false;
+    co_await ss::parallel_for_each(
+      waiters, [&pm, &octx, &replan](shard_waiter& sw) {
+          return pm
+            .invoke_on(
+              sw.shard,
+              octx.ssg,
+              [w = sw.waiter.get()](cluster::partition_manager&) {
+                  w->complete();
+                  return w->replan;
+              })
+            .then([&replan](bool r) { replan |= r; });
+      });
+    co_await ss::when_all_succeed(shard_waits.begin(), shard_waits.end());
+    co_return replan;
+}
+
 /**
  * Process partition fetch requests.
  *
- * Each request is handled serially in the order they appear in the request.
- * There are a couple reasons why we are not **yet** processing these in
- * parallel. First, Kafka expects to some extent that the order of the
- * partitions in the request is an implicit priority on which partitions to
- * read from. This is closely related to the request budget limits specified
- * in terms of maximum bytes and maximum time delay.
- *
- * Once we start processing requests in parallel we'll have to work through
- * various challenges. First, once we dispatch in parallel, we'll need to
- * develop heuristics for dealing with the implicit priority order. We'll
- * also need to develop techniques and heuristics for dealing with budgets
- * since global budgets aren't trivially divisible onto each core when
- * partition requests may produce non-uniform amounts of data.
- *
- * w.r.t. what is needed to parallelize this, there are no data dependencies
- * between partition requests within the fetch request, and so they can be
- * run fully in parallel. The only dependency that exists is that the
- * response must be reassembled such that the responses appear in these
- * order as the partitions in the request.
+ * Kafka expects to some extent that the order of the partitions in the
+ * request is an implicit priority on which partitions to read from. The
+ * planner splits the response budget between the shards and the partitions
+ * up front respecting this order, the reads are then dispatched to all the
+ * shards in parallel. There are no data dependencies between partition
+ * requests within the fetch request, the only requirement is that the
+ * response is reassembled in the order of the partitions in the request.
  */
-
 static ss::future<> fetch_topic_partitions(op_context& octx) {
-    auto planner = make_fetch_planner<simple_fetch_planner>();
+    auto planner = make_fetch_planner<budget_aware_fetch_planner>();
 
     auto fetch_plan = planner.create_plan(octx);
+    // kept to know which partitions to wait for if the fetch doesn't
+    // return enough data
+    auto planned = fetch_plan.fetches_per_shard;
 
     fetch_plan_executor executor
       = make_fetch_plan_executor<parallel_fetch_plan_executor>();
@@ -497,6 +1014,18 @@ static ss::future<> fetch_topic_partitions(op_context& octx) {
     }
 
     octx.reset_context();
+    auto waits = make_data_waits(planned);
+    bool has_waits = std::any_of(
+      waits.begin(), waits.end(), [](const auto& w) { return !w.empty(); });
+    if (has_waits && octx.deadline) {
+        // the next read is triggered by new data becoming visible in any of
+        // the partitions
+        auto replan = co_await wait_for_data(
+          octx, std::move(waits), *octx.deadline);
+        if (!replan) {
+            co_return;
+        }
+    }
     // debounce next read retry
     co_await ss::sleep(std::min(
       config::shard_local_cfg().fetch_reads_debounce_timeout(),
@@ -513,6 +1042,7 @@ fetch_handler::handle(request_context rctx, ss::smp_service_group ssg) {
             return std::move(octx).send_response();
         }
         octx.response.data.error_code = error_code::none;
+        octx.reserve_response_memory();
         // first fetch, do not wait
         return fetch_topic_partitions(octx)
           .then([&octx] {
@@ -526,6 +1056,18 @@ fetch_handler::handle(request_context rctx, ss::smp_service_group ssg) {
 
 void op_context::reset_context() { initial_fetch = false; }
 
+void op_context::reserve_response_memory() {
+    /*
+     * the request is admitted with the memory of a small response, the memory
+     * of the records is taken as they are read. the reads don't go past the
+     * memory left, but return at least a batch.
+     */
+    response_memory = rctx.connection()->consume_memory(0);
+    bytes_left = std::min(
+      bytes_left,
+      size_t(std::max<ssize_t>(rctx.connection()->available_memory(), 1)));
+}
+
 // decode request and initialize budgets
 op_context::op_context(request_context&& ctx, ss::smp_service_group ssg)
   : rctx(std::move(ctx))
@@ -583,6 +1125,8 @@ void op_context::create_response_placeholders() {
                   start_response_topic(*v.topic);
               }
               start_response_partition(*v.partition);
+              rctx.connection()->add_request_partition(
+                v.topic->name, v.partition->partition_index);
           });
     } else {
         model::topic last_topic;
@@ -603,6 +1147,8 @@ void op_context::create_response_placeholders() {
                 .records = batch_reader()};
 
               response.data.topics.back().partitions.push_back(std::move(p));
+              rctx.connection()->add_request_partition(
+                fp.topic, fp.partition);
           });
     }
 }
@@ -637,16 +1183,139 @@ bool update_fetch_partition(
     return include;
 }
 
+fetch_response_sections::fetch_response_sections(
+  fetch_response r, api_version version)
+  : _response(std::move(r))
+  , _version(version) {}
+
+void fetch_response_sections::encode_head(response_writer& writer) const {
+    if (_version >= api_version(1)) {
+        writer.write(_response.data.throttle_time_ms);
+    }
+    if (_version >= api_version(7)) {
+        writer.write(_response.data.error_code);
+        writer.write(_response.data.session_id);
+    }
+    writer.write(int32_t(_response.data.topics.size()));
+}
+
+size_t fetch_response_sections::size_bytes() const {
+    size_t size = 0;
+    for (const auto& topic : _response.data.topics) {
+        size += sizeof(int16_t) + topic.name().size() + sizeof(int32_t);
+        for (const auto& p : topic.partitions) {
+            size += partition_size(p);
+        }
+    }
+    return size;
+}
+
+size_t fetch_response_sections::partition_size(
+  const fetch_response::partition_response& p) const {
+    // partition index, error code and high watermark
+    size_t size = sizeof(int32_t) + sizeof(int16_t) + sizeof(int64_t);
+    if (_version >= api_version(4)) {
+        // last stable offset and the aborted transactions
+        size += sizeof(int64_t) + sizeof(int32_t);
+        if (p.aborted) {
+            size += p.aborted->size() * 2 * sizeof(int64_t);
+        }
+    }
+    if (_version >= api_version(5)) {
+        size += sizeof(int64_t);
+    }
+    if (_version >= api_version(11)) {
+        size += sizeof(int32_t);
+    }
+    size += sizeof(int32_t);
+    if (p.records) {
+        size += p.records->size_bytes();
+    }
+    return size;
+}
+
+void fetch_response_sections::encode_partition(
+  response_writer& writer, fetch_response::partition_response& p) const {
+    writer.write(p.partition_index);
+    writer.write(p.error_code);
+    writer.write(p.high_watermark);
+    if (_version >= api_version(4)) {
+        writer.write(p.last_stable_offset);
+    }
+    if (_version >= api_version(5)) {
+        writer.write(p.log_start_offset);
+    }
+    if (_version >= api_version(4)) {
+        writer.write_nullable_array(
+          p.aborted,
+          [](fetch_response::aborted_transaction& t, response_writer& w) {
+              w.write(t.producer_id);
+              w.write(t.first_offset);
+          });
+    }
+    if (_version >= api_version(11)) {
+        writer.write(p.preferred_read_replica);
+    }
+    writer.write(std::move(p.records));
+}
+
+std::optional<iobuf> fetch_response_sections::next() {
+    auto& topics = _response.data.topics;
+    if (_topic == topics.size()) {
+        return std::nullopt;
+    }
+    iobuf section;
+    response_writer writer(section);
+    auto& topic = topics[_topic];
+    if (_partition == 0) {
+        writer.write(topic.name);
+        writer.write(int32_t(topic.partitions.size()));
+    }
+    if (_partition < topic.partitions.size()) {
+        encode_partition(writer, topic.partitions[_partition++]);
+    }
+    if (_partition == topic.partitions.size()) {
+        ++_topic;
+        _partition = 0;
+    }
+    return section;
+}
+
+/*
+ * Only the head of the response is encoded here, the partitions are encoded
+ * in order, one section each, as the connection writes them. Their records
+ * are appended to the sections as shared fragments.
+ */
+ss::future<response_ptr> op_context::respond_holding(fetch_response r) {
+    vlog(
+      klog.trace,
+      "sending {}:{} response {}",
+      fetch_api::key,
+      fetch_api::name,
+      r);
+    auto resp = std::make_unique<response>();
+    fetch_response_sections sections(std::move(r), rctx.header().version);
+    sections.encode_head(resp->writer());
+    const auto size = sections.size_bytes();
+    resp->defer_sections(size, [sections = std::move(sections)]() mutable {
+        return sections.next();
+    });
+    if (response_memory) {
+        resp->hold_memory(std::move(*response_memory));
+    }
+    return ss::make_ready_future<response_ptr>(std::move(resp));
+}
+
 ss::future<response_ptr> op_context::send_response() && {
     // Sessionless fetch
     if (session_ctx.is_sessionless()) {
         response.data.session_id = invalid_fetch_session_id;
-        return rctx.respond(std::move(response));
+        return respond_holding(std::move(response));
     }
     // bellow we handle incremental fetches, set response session id
     response.data.session_id = session_ctx.session()->id();
     if (session_ctx.is_full_fetch()) {
-        return rctx.respond(std::move(response));
+        return respond_holding(std::move(response));
     }
 
     fetch_response final_response;
@@ -674,7 +1343,7 @@ ss::future<response_ptr> op_context::send_response() && {
         final_response.data.topics.back().partitions.push_back(std::move(r));
     }
 
-    return rctx.respond(std::move(final_response));
+    return respond_holding(std::move(final_response));
 }
 
 op_context::response_iterator::response_iterator(
@@ -699,12 +1368,19 @@ void op_context::response_iterator::set(
         auto sz = current_resp_data->size_bytes();
         _ctx->response_size -= sz;
         _ctx->bytes_left += sz;
+        if (_ctx->response_memory) {
+            _ctx->response_memory->return_units(sz);
+        }
     }
 
     if (response.records) {
         auto sz = response.records->size_bytes();
         _ctx->response_size += sz;
         _ctx->bytes_left -= std::min(_ctx->bytes_left, sz);
+        if (_ctx->response_memory) {
+            _ctx->response_memory->adopt(
+              _ctx->rctx.connection()->consume_memory(sz));
+        }
     }
     *_it->partition_response = std::move(response);
 
@@ -16,6 +16,34 @@ namespace kafka {
 
 using fetch_handler = handler<fetch_api, 4, 11>;
 
+/*
+ * Encoding of a fetch response as its head, the top level fields and the
+ * topic count, and a section per partition. A section starts with the name
+ * and the partition count of its topic when it holds the first partition of
+ * the topic, so that the head followed by all the sections in order is the
+ * encoding of the whole response.
+ */
+class fetch_response_sections {
+public:
+    fetch_response_sections(fetch_response, api_version);
+
+    void encode_head(response_writer&) const;
+    // size of all the sections, known before any of them is encoded
+    size_t size_bytes() const;
+    // encodes the next section, std::nullopt once all of them are encoded
+    std::optional<iobuf> next();
+
+private:
+    size_t partition_size(const fetch_response::partition_response&) const;
+    void encode_partition(
+      response_writer&, fetch_response::partition_response&) const;
+
+    fetch_response _response;
+    api_version _version;
+    size_t _topic{0};
+    size_t _partition{0};
+};
+
 /*
  * Fetch operation context
  */
@@ -50,6 +78,10 @@ struct op_context {
 
     void reset_context();
 
+    // take the memory of the records of the response as they are read, and
+    // limit the reads to the memory left
+    void reserve_response_memory();
+
     // decode request and initialize budgets
     op_context(request_context&& ctx, ss::smp_service_group ssg);
 
@@ -90,6 +122,9 @@ struct op_context {
 
     ss::future<response_ptr> send_response() &&;
 
+    // the response holds the memory of its records until it is written
+    ss::future<response_ptr> respond_holding(fetch_response);
+
     response_iterator response_begin(bool enable_filtering = false) {
         return response_iterator(response.begin(enable_filtering), this);
     }
@@ -131,6 +166,9 @@ struct op_context {
 
     // size of response
     size_t response_size;
+    // memory of the connection taken for the records of the response, as
+    // they are read
+    std::optional<ss::semaphore_units<>> response_memory;
     // does the response contain an error
     bool response_error;
 
@@ -146,6 +184,9 @@ struct fetch_config {
     model::timeout_clock::time_point timeout;
     bool strict_max_bytes{false};
     bool skip_read{false};
+    /// brokers in the rack of the consumer, only set when follower fetching
+    /// is enabled and the consumer sent its rack id
+    std::vector<model::node_id> rack_replicas;
 
     friend std::ostream& operator<<(std::ostream& o, const fetch_config& cfg) {
         fmt::print(
@@ -247,6 +288,8 @@ struct read_result {
     error_code error;
     model::partition_id partition;
     std::vector<cluster::rm_stm::tx_range> aborted_transactions;
+    /// replica in the rack of the consumer it should fetch from instead
+    std::optional<model::node_id> preferred_replica;
 };
 // struct aggregating fetch requests and corresponding response iterators for
 // the same shard
@@ -302,11 +345,47 @@ struct fetch_plan {
     }
 };
 
+/**
+ * Byte budget of a single partition read in the fetch plan
+ */
+struct partition_fetch_budget {
+    ss::shard_id shard;
+    // max_bytes requested for the partition
+    size_t max_bytes;
+    // bytes that we expect to read from the partition
+    size_t estimated_bytes;
+    // bytes allocated to the partition read
+    size_t allocated_bytes{0};
+};
+
+/**
+ * Split the fetch budget between the partition reads. The budgets are
+ * expected to be ordered by the partition priority (the order of the
+ * partitions in the request).
+ *
+ * In the first round each shard receives part of the budget proportional
+ * to the bytes expected to be read from its partitions, which is then
+ * assigned to the partitions of the shard in priority order. In the second
+ * round the budget that is left is given to the partitions, again in
+ * priority order, up to their max_bytes, so the partitions with
+ * underestimated or unknown amount of data can still fill the response.
+ */
+void allocate_fetch_budget(std::vector<partition_fetch_budget>&, size_t);
+
 std::optional<partition_proxy> make_partition_proxy(
   const model::materialized_ntp&,
   ss::lw_shared_ptr<cluster::partition>,
   cluster::partition_manager& pm);
 
+/// Reads the range of the partition. The concurrent reads of the same range
+/// of the same partition state are shared, each fetch gets its own share of
+/// the data
+ss::future<read_result> read_from_partition(
+  partition_proxy,
+  fetch_config,
+  bool foreign_read,
+  std::optional<model::timeout_clock::time_point>);
+
 ss::future<read_result> read_from_ntp(
   cluster::partition_manager&,
   const model::materialized_ntp&,
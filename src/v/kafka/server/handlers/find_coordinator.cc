@@ -81,8 +81,9 @@ ss::future<response_ptr> find_coordinator_handler::handle(
         return ss::do_with(
           std::move(ctx),
           [request = std::move(request)](request_context& ctx) mutable {
-              return ctx.tx_gateway_frontend().get_tx_broker().then(
-                [&ctx](std::optional<model::node_id> tx_id) {
+              return ctx.tx_gateway_frontend()
+                .get_tx_broker(transactional_id(request.data.key))
+                .then([&ctx](std::optional<model::node_id> tx_id) {
                     if (tx_id) {
                         return handle_leader(ctx, *tx_id);
                     }
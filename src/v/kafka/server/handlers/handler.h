@@ -19,16 +19,32 @@
 
 namespace kafka {
 
+/// \brief memory of the connection reserved for a request of the api before
+/// it is read, from the size of the request
+using memory_estimate_fn = size_t(size_t request_size, connection_context&);
+
+/// \brief estimate of the apis with small responses: the request, its decoded
+/// copy and bookkeeping
+inline size_t
+default_memory_estimate(size_t request_size, connection_context&) {
+    // Allow for extra copies and bookkeeping
+    return request_size * 2 + 8000; // NOLINT
+}
+
 template<
   typename RequestApi,
   api_version::type MinSupported,
-  api_version::type MaxSupported>
+  api_version::type MaxSupported,
+  memory_estimate_fn* MemEstimator = default_memory_estimate>
 struct handler {
     using api = RequestApi;
     static constexpr api_version min_supported = api_version(MinSupported);
     static constexpr api_version max_supported = api_version(MaxSupported);
     static ss::future<response_ptr>
       handle(request_context, ss::smp_service_group);
+    static size_t memory_estimate(size_t request_size, connection_context& c) {
+        return MemEstimator(request_size, c);
+    }
 };
 
 // clang-format off
@@ -9,10 +9,13 @@
 
 #include "kafka/server/handlers/list_offsets.h"
 
+#include "archival/service.h"
 #include "cluster/metadata_cache.h"
 #include "cluster/partition_manager.h"
 #include "cluster/shard_table.h"
+#include "config/configuration.h"
 #include "kafka/protocol/errors.h"
+#include "kafka/server/fetch_metadata_cache.hh"
 #include "kafka/server/materialized_partition.h"
 #include "kafka/server/partition_proxy.h"
 #include "kafka/server/replicated_partition.h"
@@ -59,144 +62,287 @@ struct list_offsets_ctx {
       , unauthorized_topics(std::move(unauthorized_topics)) {}
 };
 
-static ss::future<list_offset_partition_response> list_offsets_partition(
-  list_offsets_ctx& octx,
-  model::timestamp timestamp,
-  list_offset_topic& topic,
-  list_offset_partition& part) {
-    auto ntp = model::materialized_ntp(
-      model::ntp(model::kafka_namespace, topic.name, part.partition_index));
+// a partition to look up on the shard owning it
+struct partition_list_offsets {
+    model::materialized_ntp ntp;
+    model::timestamp timestamp;
+};
 
-    auto shard = octx.rctx.shards().shard_for(ntp.source_ntp());
-    if (!shard) {
-        return ss::make_ready_future<list_offset_partition_response>(
-          list_offsets_response::make_partition(
-            ntp.input_ntp().tp.partition,
-            error_code::unknown_topic_or_partition));
+// the response of a lookup and, for the earliest and latest timestamp
+// queries, the offsets of the partition to cache on the shard handling the
+// request
+struct partition_list_offsets_result {
+    list_offset_partition_response response;
+    std::optional<partition_metadata> offsets;
+};
+
+// struct aggregating the lookups and corresponding responses for the same
+// shard, the lookups are dispatched with a single cross shard message
+struct shard_list_offsets {
+    void
+    push_back(partition_list_offsets p, list_offset_partition_response* r) {
+        ntps.push_back(p.ntp.input_ntp());
+        requests.push_back(std::move(p));
+        responses.push_back(r);
     }
 
-    return octx.rctx.partition_manager().invoke_on(
-      *shard,
-      octx.ssg,
-      [timestamp,
-       ntp = std::move(ntp),
-       isolation_lvl = model::isolation_level(
-         octx.request.data.isolation_level)](cluster::partition_manager& mgr) {
-          auto partition = mgr.get(ntp.source_ntp());
-          if (!partition) {
-              return ss::make_ready_future<list_offset_partition_response>(
-                list_offsets_response::make_partition(
-                  ntp.input_ntp().tp.partition,
-                  error_code::unknown_topic_or_partition));
-          }
+    bool empty() const { return requests.empty(); }
 
-          if (!partition->is_leader()) {
-              return ss::make_ready_future<list_offset_partition_response>(
-                list_offsets_response::make_partition(
-                  ntp.input_ntp().tp.partition,
-                  error_code::not_leader_for_partition));
-          }
-          auto k_partition = make_partition_proxy(ntp, partition, mgr);
+    std::vector<partition_list_offsets> requests;
+    // the ntps and responses stay on the shard handling the request
+    std::vector<model::ntp> ntps;
+    std::vector<list_offset_partition_response*> responses;
+};
 
-          if (!k_partition) {
-              return ss::make_ready_future<list_offset_partition_response>(
-                list_offsets_response::make_partition(
-                  ntp.input_ntp().tp.partition,
-                  error_code::unknown_topic_or_partition));
-          }
-          /*
-           * the responses for earliest/latest timestamp queries do not require
-           * that the actual timestamp be returned. only the offset is required.
-           */
-          if (timestamp == list_offsets_request::earliest_timestamp) {
-              return ss::make_ready_future<list_offset_partition_response>(
-                list_offsets_response::make_partition(
-                  ntp.input_ntp().tp.partition,
-                  model::timestamp(-1),
-                  k_partition->start_offset()));
-
-          } else if (timestamp == list_offsets_request::latest_timestamp) {
-              const auto offset = isolation_lvl
-                                      == model::isolation_level::read_committed
-                                    ? k_partition->last_stable_offset()
-                                    : k_partition->high_watermark();
-
-              return ss::make_ready_future<list_offset_partition_response>(
-                list_offsets_response::make_partition(
-                  ntp.input_ntp().tp.partition, model::timestamp(-1), offset));
-          }
+static bool is_offsets_query(model::timestamp timestamp) {
+    return timestamp == list_offsets_request::earliest_timestamp
+           || timestamp == list_offsets_request::latest_timestamp;
+}
+
+/*
+ * the responses for earliest/latest timestamp queries do not require that the
+ * actual timestamp be returned. only the offset is required.
+ */
+static list_offset_partition_response offsets_query_response(
+  model::partition_id id,
+  model::timestamp timestamp,
+  const partition_metadata& offsets,
+  model::isolation_level isolation_lvl) {
+    model::offset offset = offsets.start_offset;
+    if (timestamp == list_offsets_request::latest_timestamp) {
+        offset = isolation_lvl == model::isolation_level::read_committed
+                   ? offsets.last_stable_offset
+                   : offsets.high_watermark;
+    }
+    return list_offsets_response::make_partition(
+      id, model::timestamp(-1), offset);
+}
 
-          return k_partition->timequery(timestamp, kafka_read_priority())
-            .then([partition,
-                   id = ntp.input_ntp().tp.partition,
-                   k_partition = std::move(k_partition)](
-                    std::optional<storage::timequery_result> res) {
-                if (res) {
-                    return ss::make_ready_future<
-                      list_offset_partition_response>(
-                      list_offsets_response::make_partition(
-                        id, res->time, res->offset));
-                }
-                return ss::make_ready_future<list_offset_partition_response>(
-                  list_offsets_response::make_partition(
-                    id,
-                    model::timestamp(-1),
-                    k_partition->last_stable_offset()));
-            });
+static ss::future<partition_list_offsets_result>
+make_error_result(model::partition_id id, error_code ec) {
+    return ss::make_ready_future<partition_list_offsets_result>(
+      partition_list_offsets_result{
+        .response = list_offsets_response::make_partition(id, ec),
       });
 }
 
-static ss::future<list_offset_topic_response>
-list_offsets_topic(list_offsets_ctx& octx, list_offset_topic& topic) {
-    std::vector<ss::future<list_offset_partition_response>> partitions;
-    partitions.reserve(topic.partitions.size());
-
-    for (auto& part : topic.partitions) {
-        if (octx.request.duplicate_tp(topic.name, part.partition_index)) {
-            partitions.push_back(
-              ss::make_ready_future<list_offset_partition_response>(
-                list_offsets_response::make_partition(
-                  part.partition_index, error_code::invalid_request)));
-            continue;
-        }
+static ss::future<partition_list_offsets_result> list_offsets_partition(
+  cluster::partition_manager& mgr,
+  archival::scheduler_service* archival,
+  partition_list_offsets req,
+  model::isolation_level isolation_lvl) {
+    const auto& ntp = req.ntp;
+    const auto timestamp = req.timestamp;
+    const auto id = ntp.input_ntp().tp.partition;
+    auto partition = mgr.get(ntp.source_ntp());
+    if (!partition) {
+        return make_error_result(id, error_code::unknown_topic_or_partition);
+    }
 
-        if (!octx.rctx.metadata_cache().contains(
-              model::topic_namespace_view(
-                model::kafka_namespace, model::get_source_topic(topic.name)),
-              part.partition_index)) {
-            partitions.push_back(
-              ss::make_ready_future<list_offset_partition_response>(
-                list_offsets_response::make_partition(
-                  part.partition_index,
-                  error_code::unknown_topic_or_partition)));
-            continue;
+    if (!partition->is_leader()) {
+        return make_error_result(id, error_code::not_leader_for_partition);
+    }
+    // the offsets of a read replica are the ones of the source partition
+    ss::lw_shared_ptr<cloud_storage::remote_partition> remote;
+    if (
+      !ntp.is_materialized()
+      && partition->get_ntp_config().is_read_replica()) {
+        if (archival) {
+            remote = archival->get_read_replica(ntp.source_ntp());
+        }
+        if (!remote) {
+            return make_error_result(id, error_code::leader_not_available);
         }
+    }
+    auto k_partition = make_partition_proxy(
+      ntp, partition, mgr, std::move(remote));
+
+    if (!k_partition) {
+        return make_error_result(id, error_code::unknown_topic_or_partition);
+    }
 
-        auto pr = list_offsets_partition(octx, part.timestamp, topic, part);
-        partitions.push_back(std::move(pr));
+    if (is_offsets_query(timestamp)) {
+        partition_metadata offsets(
+          k_partition->start_offset(),
+          k_partition->high_watermark(),
+          k_partition->last_stable_offset());
+        return ss::make_ready_future<partition_list_offsets_result>(
+          partition_list_offsets_result{
+            .response = offsets_query_response(
+              id, timestamp, offsets, isolation_lvl),
+            .offsets = offsets,
+          });
     }
 
-    return when_all_succeed(partitions.begin(), partitions.end())
-      .then([name = std::move(topic.name)](
-              std::vector<list_offset_partition_response> parts) mutable {
-          return list_offset_topic_response{
-            .name = std::move(name),
-            .partitions = std::move(parts),
+    return k_partition->timequery(timestamp, kafka_read_priority())
+      .then([partition, id, k_partition = std::move(k_partition)](
+              std::optional<storage::timequery_result> res) {
+          if (res) {
+              return partition_list_offsets_result{
+                .response = list_offsets_response::make_partition(
+                  id, res->time, res->offset),
+              };
+          }
+          return partition_list_offsets_result{
+            .response = list_offsets_response::make_partition(
+              id, model::timestamp(-1), k_partition->last_stable_offset()),
           };
       });
 }
 
-static std::vector<ss::future<list_offset_topic_response>>
-list_offsets_topics(list_offsets_ctx& octx) {
-    std::vector<ss::future<list_offset_topic_response>> topics;
-    topics.reserve(octx.request.data.topics.size());
+static ss::future<std::vector<partition_list_offsets_result>>
+list_offsets_on_shard(
+  cluster::partition_manager& mgr,
+  archival::scheduler_service* archival,
+  std::vector<partition_list_offsets> requests,
+  model::isolation_level isolation_lvl) {
+    std::vector<ss::future<partition_list_offsets_result>> partitions;
+    partitions.reserve(requests.size());
+    for (auto& req : requests) {
+        partitions.push_back(list_offsets_partition(
+          mgr, archival, std::move(req), isolation_lvl));
+    }
+    return when_all_succeed(partitions.begin(), partitions.end());
+}
+
+static ss::future<> list_offsets_shard(
+  list_offsets_ctx& octx, ss::shard_id shard, shard_list_offsets sl) {
+    return octx.rctx.partition_manager()
+      .invoke_on(
+        shard,
+        octx.ssg,
+        [&archival = octx.rctx.archival_service(),
+         requests = std::move(sl.requests),
+         isolation_lvl = model::isolation_level(
+           octx.request.data.isolation_level)](
+          cluster::partition_manager& mgr) mutable {
+            return list_offsets_on_shard(
+              mgr,
+              archival.local_is_initialized() ? &archival.local() : nullptr,
+              std::move(requests),
+              isolation_lvl);
+        })
+      .then([&octx,
+             ntps = std::move(sl.ntps),
+             responses = std::move(sl.responses)](
+              std::vector<partition_list_offsets_result> results) mutable {
+          auto& cache = octx.rctx.get_fetch_metadata_cache();
+          for (size_t i = 0; i < results.size(); ++i) {
+              if (const auto& offsets = results[i].offsets; offsets) {
+                  cache.insert_or_assign(
+                    std::move(ntps[i]),
+                    offsets->start_offset,
+                    offsets->high_watermark,
+                    offsets->last_stable_offset);
+              }
+              *responses[i] = std::move(results[i].response);
+          }
+      });
+}
+
+/**
+ * \brief offsets of the partition cached on the shard handling the request
+ * with which an earliest or latest timestamp query is answered.
+ *
+ * The cache is filled by the fetches and the list offsets lookups of the
+ * shard. While an entry is younger than list_offsets_cache_max_age_ms it is
+ * used regardless of the leadership of the partition, the answers are as stale
+ * as the max age allows.
+ */
+static std::optional<partition_metadata> cached_offsets(
+  list_offsets_ctx& octx, const model::ntp& ntp, model::timestamp timestamp) {
+    const auto max_age
+      = config::shard_local_cfg().list_offsets_cache_max_age_ms();
+    if (
+      max_age == std::chrono::milliseconds(0)
+      || !is_offsets_query(timestamp)) {
+        return std::nullopt;
+    }
+    return octx.rctx.get_fetch_metadata_cache().get(ntp, max_age);
+}
 
+/**
+ * \brief validate a topic partition and add its lookup to the plan.
+ *
+ * Returns the error of the partition if it can't be looked up.
+ */
+static std::optional<error_code> plan_topic_partition(
+  list_offsets_ctx& octx,
+  std::vector<shard_list_offsets>& plan,
+  list_offset_topic& topic,
+  list_offset_partition& part,
+  list_offset_partition_response* response) {
+    if (octx.request.duplicate_tp(topic.name, part.partition_index)) {
+        return error_code::invalid_request;
+    }
+
+    if (!octx.rctx.metadata_cache().contains(
+          model::topic_namespace_view(
+            model::kafka_namespace, model::get_source_topic(topic.name)),
+          part.partition_index)) {
+        return error_code::unknown_topic_or_partition;
+    }
+
+    auto ntp = model::materialized_ntp(
+      model::ntp(model::kafka_namespace, topic.name, part.partition_index));
+    auto shard = octx.rctx.shards().shard_for(ntp.source_ntp());
+    if (!shard) {
+        return error_code::unknown_topic_or_partition;
+    }
+    if (auto offsets = cached_offsets(octx, ntp.input_ntp(), part.timestamp)) {
+        *response = offsets_query_response(
+          part.partition_index,
+          part.timestamp,
+          *offsets,
+          model::isolation_level(octx.request.data.isolation_level));
+        return std::nullopt;
+    }
+    plan[*shard].push_back(
+      partition_list_offsets{
+        .ntp = std::move(ntp),
+        .timestamp = part.timestamp,
+      },
+      response);
+    return std::nullopt;
+}
+
+/**
+ * \brief group the partitions of the request by the shard owning them and
+ * look them up with one cross shard message per shard.
+ *
+ * The response is laid out in the order of the request and the errors of the
+ * partitions that can't be looked up, as well as the cached offsets, are filled
+ * in right away.
+ */
+static ss::future<> list_offsets_topics(list_offsets_ctx& octx) {
+    std::vector<shard_list_offsets> plan(ss::smp::count);
+    auto& responses = octx.response.data.topics;
+    responses.reserve(octx.request.data.topics.size());
     for (auto& topic : octx.request.data.topics) {
-        auto tr = list_offsets_topic(octx, topic);
-        topics.push_back(std::move(tr));
+        auto& t = responses.emplace_back(
+          list_offset_topic_response{.name = topic.name});
+        // the planned partitions keep pointers to their responses
+        t.partitions.reserve(topic.partitions.size());
+        for (auto& part : topic.partitions) {
+            auto& p = t.partitions.emplace_back(
+              list_offsets_response::make_partition(
+                part.partition_index, error_code::none));
+            if (auto ec = plan_topic_partition(octx, plan, topic, part, &p)) {
+                p = list_offsets_response::make_partition(
+                  part.partition_index, *ec);
+            }
+        }
     }
 
-    return topics;
+    std::vector<ss::future<>> shards;
+    for (ss::shard_id shard = 0; shard < plan.size(); ++shard) {
+        if (plan[shard].empty()) {
+            continue;
+        }
+        shards.push_back(
+          list_offsets_shard(octx, shard, std::move(plan[shard])));
+    }
+    return ss::when_all_succeed(shards.begin(), shards.end());
 }
 
 /*
@@ -246,13 +392,10 @@ list_offsets_handler::handle(request_context ctx, ss::smp_service_group ssg) {
       std::move(ctx), std::move(request), ssg, std::move(unauthorized_topics));
 
     return ss::do_with(std::move(octx), [](list_offsets_ctx& octx) {
-        auto topics = list_offsets_topics(octx);
-        return when_all_succeed(topics.begin(), topics.end())
-          .then([&octx](std::vector<list_offset_topic_response> topics) {
-              octx.response.data.topics = std::move(topics);
-              handle_unauthorized(octx);
-              return octx.rctx.respond(std::move(octx.response));
-          });
+        return list_offsets_topics(octx).then([&octx] {
+            handle_unauthorized(octx);
+            return octx.rctx.respond(std::move(octx.response));
+        });
     });
 }
 
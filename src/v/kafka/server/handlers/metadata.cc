@@ -29,17 +29,16 @@
 
 namespace kafka {
 
-metadata_response::topic
-make_topic_response_from_topic_metadata(model::topic_metadata&& tp_md) {
+metadata_response::topic make_topic_response_from_topic_metadata(
+  const cluster::metadata_cache& md_cache, model::topic_metadata&& tp_md) {
     metadata_response::topic tp;
     tp.error_code = error_code::none;
-    tp.name = std::move(tp_md.tp_ns.tp);
     tp.is_internal = false; // no internal topics yet
     std::transform(
       tp_md.partitions.begin(),
       tp_md.partitions.end(),
       std::back_inserter(tp.partitions),
-      [](model::partition_metadata& p_md) {
+      [&md_cache, &tp_md](model::partition_metadata& p_md) {
           std::vector<model::node_id> replicas{};
           replicas.reserve(p_md.replicas.size());
           std::transform(
@@ -51,12 +50,17 @@ make_topic_response_from_topic_metadata(model::topic_metadata&& tp_md) {
           p.error_code = error_code::none;
           p.partition_index = p_md.id;
           p.leader_id = p_md.leader_node.value_or(model::node_id(-1));
-          p.leader_epoch = 0;
+          // the leader epoch is the raft term of the leader, as the
+          // partition leader epoch of the fetched batches
+          p.leader_epoch = static_cast<int32_t>(
+            md_cache.get_leader_term(tp_md.tp_ns, p_md.id)
+              .value_or(model::term_id(0))());
           p.replica_nodes = std::move(replicas);
           p.isr_nodes = p.replica_nodes;
           p.offline_replicas = {};
           return p;
       });
+    tp.name = std::move(tp_md.tp_ns.tp);
     return tp;
 }
 
@@ -96,9 +100,9 @@ create_topic(request_context& ctx, model::topic&& topic) {
                    res,
                    ctx.controller_api(),
                    tout + model::timeout_clock::now())
-            .then([tp_md = std::move(tp_md)]() mutable {
+            .then([&md_cache, tp_md = std::move(tp_md)]() mutable {
                 return make_topic_response_from_topic_metadata(
-                  std::move(tp_md.value()));
+                  md_cache, std::move(tp_md.value()));
             });
       })
       .handle_exception([topic = std::move(topic)](
@@ -126,39 +130,74 @@ static metadata_response::topic make_topic_response(
           details::authorized_operations(ctx, md.tp_ns.tp));
     }
 
-    auto res = make_topic_response_from_topic_metadata(std::move(md));
+    auto res = make_topic_response_from_topic_metadata(
+      ctx.metadata_cache(), std::move(md));
     res.topic_authorized_operations = auth_operations;
     return res;
 }
 
-static ss::future<std::vector<metadata_response::topic>>
-get_topic_metadata(request_context& ctx, metadata_request& request) {
-    std::vector<metadata_response::topic> res;
+/**
+ * The encoded topic does not depend on the request unless the topic
+ * authorized operations (v8+) are requested.
+ */
+static bool can_use_response_cache(request_context& ctx, metadata_request& rq) {
+    return !rq.data.include_topic_authorized_operations
+           || ctx.header().version < api_version(8);
+}
+
+/**
+ * Appends the metadata of an existing topic to the response, the encoded
+ * topic is shared from the response cache when possible. Returns false if the
+ * topic does not exist.
+ */
+static bool append_topic_response(
+  request_context& ctx,
+  metadata_request& rq,
+  model::topic_namespace_view tp_ns,
+  metadata_response& reply) {
+    auto version = ctx.header().version;
+    auto& cache = ctx.get_metadata_response_cache();
+    const bool use_cache = can_use_response_cache(ctx, rq);
+    if (use_cache) {
+        if (auto cached = cache.get(tp_ns.tp, version); cached) {
+            reply.encoded_topics.push_back(std::move(*cached));
+            return true;
+        }
+    }
+    auto md = ctx.metadata_cache().get_topic_metadata(tp_ns);
+    if (!md) {
+        return false;
+    }
+    auto res = make_topic_response(ctx, rq, std::move(*md));
+    if (!use_cache) {
+        reply.data.topics.push_back(std::move(res));
+        return true;
+    }
+    auto encoded = metadata_response::encode_topic(res, version);
+    cache.put(tp_ns.tp, version, encoded);
+    reply.encoded_topics.push_back(std::move(encoded));
+    return true;
+}
+
+static ss::future<> get_topic_metadata(
+  request_context& ctx, metadata_request& request, metadata_response& reply) {
+    auto& res = reply.data.topics;
 
     // request can be served from whatever happens to be in the cache
     if (request.list_all_topics) {
-        auto topics = ctx.metadata_cache().all_topics_metadata();
-        // only serve topics from the kafka namespace
-        std::erase_if(topics, [](model::topic_metadata& t_md) {
-            return t_md.tp_ns.ns != model::kafka_namespace;
-        });
-
-        auto unauthorized_it = std::partition(
-          topics.begin(),
-          topics.end(),
-          [&ctx](const model::topic_metadata& t_md) {
-              return ctx.authorized(
-                security::acl_operation::describe, t_md.tp_ns.tp);
-          });
-        std::transform(
-          topics.begin(),
-          unauthorized_it,
-          std::back_inserter(res),
-          [&ctx, &request](model::topic_metadata& t_md) {
-              return make_topic_response(ctx, request, std::move(t_md));
-          });
-        return ss::make_ready_future<std::vector<metadata_response::topic>>(
-          std::move(res));
+        auto topics = ctx.metadata_cache().all_topics();
+        for (const auto& tp_ns : topics) {
+            // only serve topics from the kafka namespace
+            if (tp_ns.ns != model::kafka_namespace) {
+                continue;
+            }
+            if (!ctx.authorized(security::acl_operation::describe, tp_ns.tp)) {
+                continue;
+            }
+            append_topic_response(
+              ctx, request, model::topic_namespace_view(tp_ns), reply);
+        }
+        return ss::now();
     }
 
     std::vector<ss::future<metadata_response::topic>> new_topics;
@@ -174,16 +213,18 @@ get_topic_metadata(request_context& ctx, metadata_request& request) {
               std::move(topic.name), error_code::topic_authorization_failed));
             continue;
         }
-        if (auto md = ctx.metadata_cache().get_topic_metadata(
-              model::topic_namespace_view(
-                model::kafka_namespace, source_topic));
-            md) {
-            auto src_topic_response = make_topic_response(
-              ctx, request, std::move(*md));
-            if (model::is_materialized_topic(topic.name)) {
+        auto tp_ns = model::topic_namespace_view(
+          model::kafka_namespace, source_topic);
+        if (model::is_materialized_topic(topic.name)) {
+            // the response carries the materialized name, never cached
+            if (auto md = ctx.metadata_cache().get_topic_metadata(tp_ns); md) {
+                auto src_topic_response = make_topic_response(
+                  ctx, request, std::move(*md));
                 src_topic_response.name = std::move(topic.name);
+                res.push_back(std::move(src_topic_response));
+                continue;
             }
-            res.push_back(std::move(src_topic_response));
+        } else if (append_topic_response(ctx, request, tp_ns, reply)) {
             continue;
         }
 
@@ -206,14 +247,29 @@ get_topic_metadata(request_context& ctx, metadata_request& request) {
     }
 
     return ss::when_all_succeed(new_topics.begin(), new_topics.end())
-      .then([res = std::move(res)](
-              std::vector<metadata_response::topic> topics) mutable {
+      .then([&res](std::vector<metadata_response::topic> topics) mutable {
           res.insert(res.end(), topics.begin(), topics.end());
-          return res;
       });
 }
 
 template<>
+size_t metadata_memory_estimate(
+  size_t request_size, connection_context& conn_ctx) {
+    /*
+     * The response is of all of the topics unless the request lists some, the
+     * estimate is of the response of all, the decoded response and its
+     * encoded copy.
+     */
+    using topic = metadata_response::topic;
+    using partition = metadata_response::partition;
+    const auto s = conn_ctx.server().metadata_cache().summarize_topics();
+    const size_t response = s.topics * sizeof(topic) + s.name_bytes
+                            + s.partitions * sizeof(partition)
+                            // replica and isr nodes
+                            + 2 * s.replicas * sizeof(model::node_id);
+    return default_memory_estimate(request_size, conn_ctx) + 2 * response;
+}
+
 ss::future<response_ptr> metadata_handler::handle(
   request_context ctx, [[maybe_unused]] ss::smp_service_group g) {
     metadata_response reply;
@@ -240,7 +296,7 @@ ss::future<response_ptr> metadata_handler::handle(
     metadata_request request;
     request.decode(ctx.reader(), ctx.header().version);
 
-    reply.data.topics = co_await get_topic_metadata(ctx, request);
+    co_await get_topic_metadata(ctx, request, reply);
 
     if (
       request.data.include_cluster_authorized_operations
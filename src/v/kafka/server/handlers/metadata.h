@@ -14,6 +14,10 @@
 
 namespace kafka {
 
-using metadata_handler = handler<metadata_api, 0, 7>;
+/// \brief the response is of the topics of the cluster rather than of the
+/// request, it is estimated from the size of the topic metadata
+size_t metadata_memory_estimate(size_t request_size, connection_context&);
+
+using metadata_handler = handler<metadata_api, 0, 7, metadata_memory_estimate>;
 
 }
@@ -22,5 +22,8 @@ struct offset_commit_handler {
     static constexpr api_version min_supported = api_version(1);
     static constexpr api_version max_supported = api_version(7);
     static process_result_stages handle(request_context, ss::smp_service_group);
+    static size_t memory_estimate(size_t request_size, connection_context& c) {
+        return default_memory_estimate(request_size, c);
+    }
 };
 } // namespace kafka
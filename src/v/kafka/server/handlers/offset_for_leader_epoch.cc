@@ -0,0 +1,202 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/handlers/offset_for_leader_epoch.h"
+
+#include "cluster/partition_manager.h"
+#include "cluster/shard_table.h"
+#include "kafka/protocol/errors.h"
+#include "kafka/server/partition_proxy.h"
+#include "kafka/server/request_context.h"
+#include "kafka/server/response.h"
+#include "model/namespace.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/smp.hh>
+
+namespace kafka {
+
+// a partition to look up on the shard owning it
+struct partition_epoch_lookup {
+    model::materialized_ntp ntp;
+    int32_t current_leader_epoch;
+    int32_t leader_epoch;
+};
+
+// the lookups and corresponding responses for the same shard, the lookups are
+// dispatched with a single cross shard message
+struct shard_epoch_lookups {
+    void push_back(partition_epoch_lookup l, epoch_end_offset* r) {
+        requests.push_back(std::move(l));
+        responses.push_back(r);
+    }
+
+    bool empty() const { return requests.empty(); }
+
+    std::vector<partition_epoch_lookup> requests;
+    // the responses stay on the shard handling the request
+    std::vector<epoch_end_offset*> responses;
+};
+
+/**
+ * \brief the end offset of the latest leader epoch of the partition up to the
+ * requested one.
+ *
+ * The leader epochs are the raft terms of the partition. The end of an epoch
+ * is the base offset of the next term of the log, or the end of the log for
+ * the current term, found in the terms of the segments of the log.
+ */
+static epoch_end_offset find_epoch_end_offset(
+  cluster::partition_manager& mgr, const partition_epoch_lookup& req) {
+    const auto id = req.ntp.input_ntp().tp.partition;
+    auto make_error = [id](error_code ec) {
+        return epoch_end_offset{.error_code = ec, .partition = id};
+    };
+    auto partition = mgr.get(req.ntp.source_ntp());
+    if (!partition) {
+        return make_error(error_code::unknown_topic_or_partition);
+    }
+    if (!partition->is_leader()) {
+        return make_error(error_code::not_leader_for_partition);
+    }
+
+    const auto term = partition->term();
+    if (req.current_leader_epoch >= 0) {
+        const model::term_id current(req.current_leader_epoch);
+        if (current < term) {
+            return make_error(error_code::fenced_leader_epoch);
+        }
+        if (current > term) {
+            return make_error(error_code::unknown_leader_epoch);
+        }
+    }
+
+    auto k_partition = make_partition_proxy(req.ntp, partition, mgr);
+    if (!k_partition) {
+        return make_error(error_code::unknown_topic_or_partition);
+    }
+
+    const model::term_id requested(req.leader_epoch);
+    // an undefined epoch or an epoch the partition didn't reach
+    if (requested < model::term_id(0) || requested > term) {
+        return make_error(error_code::none);
+    }
+    auto end = k_partition->term_end(requested);
+    if (!end) {
+        return make_error(error_code::none);
+    }
+    // the current term is the latest one before the log has batches of it
+    const auto epoch = requested == term ? requested : end->term;
+    return epoch_end_offset{
+      .error_code = error_code::none,
+      .partition = id,
+      .leader_epoch = static_cast<int32_t>(epoch()),
+      .end_offset = end->end_offset,
+    };
+}
+
+static ss::future<> find_epoch_end_offsets_on_shard(
+  request_context& ctx,
+  ss::smp_service_group ssg,
+  ss::shard_id shard,
+  shard_epoch_lookups lookups) {
+    return ctx.partition_manager()
+      .invoke_on(
+        shard,
+        ssg,
+        [requests = std::move(lookups.requests)](
+          cluster::partition_manager& mgr) {
+            std::vector<epoch_end_offset> results;
+            results.reserve(requests.size());
+            for (const auto& req : requests) {
+                results.push_back(find_epoch_end_offset(mgr, req));
+            }
+            return results;
+        })
+      .then([responses = std::move(lookups.responses)](
+              std::vector<epoch_end_offset> results) {
+          for (size_t i = 0; i < results.size(); ++i) {
+              *responses[i] = results[i];
+          }
+      });
+}
+
+/**
+ * \brief validate a topic partition and add its lookup to the plan.
+ *
+ * Returns the error of the partition if it can't be looked up.
+ */
+static std::optional<error_code> plan_partition(
+  request_context& ctx,
+  std::vector<shard_epoch_lookups>& plan,
+  const model::topic& topic,
+  const offset_for_leader_partition& part,
+  epoch_end_offset* response) {
+    auto ntp = model::materialized_ntp(
+      model::ntp(model::kafka_namespace, topic, part.partition));
+    auto shard = ctx.shards().shard_for(ntp.source_ntp());
+    if (!shard) {
+        return error_code::unknown_topic_or_partition;
+    }
+    plan[*shard].push_back(
+      partition_epoch_lookup{
+        .ntp = std::move(ntp),
+        .current_leader_epoch = part.current_leader_epoch,
+        .leader_epoch = part.leader_epoch,
+      },
+      response);
+    return std::nullopt;
+}
+
+template<>
+ss::future<response_ptr> offset_for_leader_epoch_handler::handle(
+  request_context ctx, ss::smp_service_group ssg) {
+    offset_for_leader_epoch_request request;
+    request.decode(ctx.reader(), ctx.header().version);
+    klog.trace("Handling request {}", request);
+
+    offset_for_leader_epoch_response response;
+    std::vector<shard_epoch_lookups> plan(ss::smp::count);
+    auto& topics = response.data.topics;
+    topics.reserve(request.data.topics.size());
+    for (const auto& topic : request.data.topics) {
+        const bool authorized = ctx.authorized(
+          security::acl_operation::describe, topic.topic);
+        auto& t = topics.emplace_back(
+          offset_for_leader_topic_result{.topic = topic.topic});
+        // the planned partitions keep pointers to their responses
+        t.partitions.reserve(topic.partitions.size());
+        for (const auto& part : topic.partitions) {
+            auto& p = t.partitions.emplace_back(epoch_end_offset{
+              .error_code = error_code::topic_authorization_failed,
+              .partition = part.partition,
+            });
+            if (!authorized) {
+                continue;
+            }
+            p.error_code = error_code::none;
+            if (auto ec = plan_partition(ctx, plan, topic.topic, part, &p)) {
+                p.error_code = *ec;
+            }
+        }
+    }
+
+    std::vector<ss::future<>> shards;
+    for (ss::shard_id shard = 0; shard < plan.size(); ++shard) {
+        if (plan[shard].empty()) {
+            continue;
+        }
+        shards.push_back(find_epoch_end_offsets_on_shard(
+          ctx, ssg, shard, std::move(plan[shard])));
+    }
+    co_await ss::when_all_succeed(shards.begin(), shards.end());
+    co_return co_await ctx.respond(std::move(response));
+}
+
+} // namespace kafka
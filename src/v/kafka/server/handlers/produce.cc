@@ -17,14 +17,17 @@
 #include "kafka/protocol/errors.h"
 #include "kafka/protocol/kafka_batch_adapter.h"
 #include "kafka/server/replicated_partition.h"
+#include "kafka/server/topic_config_cache.h"
 #include "likely.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
 #include "model/namespace.h"
+#include "model/ntp_interner.h"
 #include "model/record_batch_reader.h"
 #include "model/timestamp.h"
 #include "raft/types.h"
 #include "storage/shard_assignment.h"
+#include "utils/event_trace.h"
 #include "utils/remote.h"
 #include "utils/to_string.h"
 #include "vlog.h"
@@ -83,18 +86,41 @@ struct partition_produce_stages {
     ss::future<produce_response::partition> produced;
 };
 
-struct topic_produce_stages {
-    ss::future<> dispatched;
-    ss::future<produce_response::topic> produced;
+/// batch produced to a partition, sent to the shard owning the partition
+struct partition_produce {
+    model::ntp ntp;
+    model::batch_identity bid;
+    model::record_batch_reader reader;
+    int32_t num_records;
+    size_t size_bytes;
 };
 
-partition_produce_stages make_ready_stage(produce_response::partition p) {
-    return partition_produce_stages{
-      .dispatched = ss::now(),
-      .produced = ss::make_ready_future<produce_response::partition>(
-        std::move(p)),
-    };
-}
+// struct aggregating the produce requests and corresponding responses for the
+// same shard, the requests are dispatched with a single cross shard message
+struct shard_produce {
+    void push_back(partition_produce p, produce_response::partition* r) {
+        requests.push_back(std::move(p));
+        responses.push_back(r);
+    }
+
+    bool empty() const { return requests.empty(); }
+
+    std::vector<partition_produce> requests;
+    // the responses stay on the shard handling the request
+    std::vector<produce_response::partition*> responses;
+};
+
+struct produce_plan {
+    explicit produce_plan(size_t shards)
+      : produces_per_shard(shards) {}
+
+    std::vector<shard_produce> produces_per_shard;
+};
+
+struct shard_produce_stages {
+    ss::future<> dispatched;
+    ss::future<> produced;
+};
 
 static raft::replicate_options acks_to_replicate_options(int16_t acks) {
     switch (acks) {
@@ -160,13 +186,14 @@ static partition_produce_stages partition_append(
   model::batch_identity bid,
   model::record_batch_reader reader,
   int16_t acks,
-  int32_t num_records) {
+  int32_t num_records,
+  size_t size_bytes) {
     auto stages = partition->replicate(
       bid, std::move(reader), acks_to_replicate_options(acks));
     return partition_produce_stages{
       .dispatched = std::move(stages.request_enqueued),
       .produced = stages.replicate_finished.then_wrapped(
-        [partition, id, num_records = num_records](
+        [partition, id, num_records = num_records, size_bytes](
           ss::future<result<raft::replicate_result>> f) {
             produce_response::partition p{.partition_index = id};
             try {
@@ -178,6 +205,7 @@ static partition_produce_stages partition_append(
                       r.value().last_offset - (num_records - 1));
                     p.error_code = error_code::none;
                     partition->probe().add_records_produced(num_records);
+                    partition->probe().add_bytes_produced(size_bytes);
                 } else {
                     p.error_code = map_produce_error_code(r.error());
                 }
@@ -189,13 +217,182 @@ static partition_produce_stages partition_append(
     };
 }
 
+static partition_produce_stages produce_partition_on_shard(
+  cluster::partition_manager& mgr, partition_produce& p, int16_t acks) {
+    auto error_stage = [&p](error_code ec) {
+        return partition_produce_stages{
+          .dispatched = ss::now(),
+          .produced = ss::make_ready_future<produce_response::partition>(
+            produce_response::partition{
+              .partition_index = p.ntp.tp.partition, .error_code = ec}),
+        };
+    };
+    auto partition = mgr.get(p.ntp);
+    if (!partition) {
+        return error_stage(error_code::unknown_topic_or_partition);
+    }
+    if (unlikely(!partition->is_leader())) {
+        return error_stage(error_code::not_leader_for_partition);
+    }
+    if (unlikely(partition->get_ntp_config().is_read_replica())) {
+        // the data of a read replica is produced to the source cluster
+        return error_stage(error_code::invalid_topic_exception);
+    }
+    try {
+        return partition_append(
+          p.ntp.tp.partition,
+          ss::make_lw_shared<replicated_partition>(std::move(partition)),
+          p.bid,
+          std::move(p.reader),
+          acks,
+          p.num_records,
+          p.size_bytes);
+    } catch (...) {
+        auto stage = error_stage(error_code::unknown_server_error);
+        stage.dispatched = ss::make_exception_future<>(
+          std::current_exception());
+        return stage;
+    }
+}
+
+/**
+ * \brief append the batches of a shard_produce on the shard owning them.
+ *
+ * The partitions are enqueued in the order of the request and the source
+ * shard is notified once all of them are enqueued.
+ */
+static ss::future<std::vector<produce_response::partition>> produce_on_shard(
+  cluster::partition_manager& mgr,
+  std::vector<partition_produce> requests,
+  int16_t acks,
+  ss::shard_id source_shard,
+  std::unique_ptr<ss::promise<>> dispatch) {
+    std::vector<ss::future<>> dispatched;
+    std::vector<ss::future<produce_response::partition>> produced;
+    dispatched.reserve(requests.size());
+    produced.reserve(requests.size());
+    for (auto& p : requests) {
+        auto stages = produce_partition_on_shard(mgr, p, acks);
+        dispatched.push_back(std::move(stages.dispatched));
+        produced.push_back(std::move(stages.produced));
+    }
+    return ss::when_all_succeed(dispatched.begin(), dispatched.end())
+      .then_wrapped(
+        [source_shard, dispatch = std::move(dispatch)](ss::future<> f) mutable {
+            // a single message back to the source shard for all partitions
+            std::exception_ptr e;
+            if (f.failed()) {
+                e = f.get_exception();
+            }
+            (void)ss::smp::submit_to(
+              source_shard, [dispatch = std::move(dispatch), e]() mutable {
+                  if (e) {
+                      dispatch->set_exception(e);
+                  } else {
+                      dispatch->set_value();
+                  }
+                  dispatch.reset();
+              });
+        })
+      .then([produced = std::move(produced)]() mutable {
+          return ss::when_all_succeed(produced.begin(), produced.end());
+      });
+}
+
+/**
+ * \brief handle writing to the partitions owned by a single shard.
+ */
+static shard_produce_stages
+produce_shard(produce_ctx& octx, ss::shard_id shard, shard_produce sp) {
+    auto start = std::chrono::steady_clock::now();
+    event_trace::record(
+      event_trace::type::produce_dispatched,
+      octx.rctx.header().correlation(),
+      shard);
+    auto dispatch = std::make_unique<ss::promise<>>();
+    auto dispatch_f = dispatch->get_future();
+    auto f = octx.rctx.partition_manager()
+               .invoke_on(
+                 shard,
+                 octx.ssg,
+                 [requests = std::move(sp.requests),
+                  dispatch = std::move(dispatch),
+                  acks = octx.request.data.acks,
+                  source_shard = ss::this_shard_id()](
+                   cluster::partition_manager& mgr) mutable {
+                     return produce_on_shard(
+                       mgr,
+                       std::move(requests),
+                       acks,
+                       source_shard,
+                       std::move(dispatch));
+                 })
+               .then([&octx, start, responses = std::move(sp.responses)](
+                       std::vector<produce_response::partition> results) {
+                   auto dur = std::chrono::steady_clock::now() - start;
+                   for (size_t i = 0; i < results.size(); ++i) {
+                       if (results[i].error_code == error_code::none) {
+                           octx.rctx.connection()
+                             ->server()
+                             .update_produce_latency(dur);
+                       }
+                       *responses[i] = std::move(results[i]);
+                   }
+               });
+    return shard_produce_stages{
+      .dispatched = std::move(dispatch_f),
+      .produced = std::move(f),
+    };
+}
+
 /**
- * \brief handle writing to a single topic partition.
+ * \brief validate a topic partition and add its batch to the plan.
+ *
+ * Returns the error of the partition if it can't be produced to.
  */
-static partition_produce_stages produce_topic_partition(
+static std::optional<error_code> plan_topic_partition(
   produce_ctx& octx,
+  produce_plan& plan,
   produce_request::topic& topic,
-  produce_request::partition& part) {
+  std::optional<model::topic_id> topic_id,
+  produce_request::partition& part,
+  produce_response::partition* response) {
+    if (!octx.rctx.authorized(security::acl_operation::write, topic.name)) {
+        return error_code::topic_authorization_failed;
+    }
+
+    const auto* topic_cfg = octx.rctx.get_topic_config_cache().get(
+      model::topic_namespace_view(model::kafka_namespace, topic.name));
+    if (!topic_cfg || !topic_cfg->contains(part.partition_index)) {
+        return error_code::unknown_topic_or_partition;
+    }
+
+    // the record data on the wire was null value
+    if (unlikely(!part.records)) {
+        return error_code::invalid_record;
+    }
+
+    // an error occured handling legacy messages (magic 0 or 1)
+    if (unlikely(part.records->adapter.legacy_error)) {
+        return error_code::invalid_record;
+    }
+
+    if (unlikely(!part.records->adapter.valid_crc)) {
+        return error_code::corrupt_message;
+    }
+
+    // produce version >= 3 (enforced for all produce requests)
+    // requires exactly one record batch per request and it must use
+    // the v2 format.
+    //
+    // NOTE: for produce version 0 and 1 the adapter transparently converts
+    // the batch into an v2 batch and sets the v2_format flag. conversion
+    // also produces a single record batch by accumulating legacy messages.
+    if (unlikely(
+          !part.records->adapter.v2_format || !part.records->adapter.batch)) {
+        return error_code::invalid_record;
+    }
+
     auto ntp = model::ntp(
       model::kafka_namespace, topic.name, part.partition_index);
 
@@ -203,243 +400,87 @@ static partition_produce_stages produce_topic_partition(
      * A single produce request may contain record batches for many
      * different partitions that are managed different cores.
      */
-    auto shard = octx.rctx.shards().shard_for(ntp);
-
+    if (!topic_id) {
+        return error_code::unknown_topic_or_partition;
+    }
+    auto shard = octx.rctx.shards().shard_for(
+      model::ntp_id{.topic = *topic_id, .partition = part.partition_index});
     if (!shard) {
-        return make_ready_stage(produce_response::partition{
-          .partition_index = ntp.tp.partition,
-          .error_code = error_code::unknown_topic_or_partition});
+        return error_code::unknown_topic_or_partition;
     }
 
     // steal the batch from the adapter
     auto batch = std::move(part.records->adapter.batch.value());
 
     /*
-     * grab timestamp type topic configuration option out of the
-     * metadata cache. For append time setting we have to recalculate
-     * the CRC.
+     * For append time setting we have to recalculate the CRC.
      */
-    auto timestamp_type
-      = octx.rctx.metadata_cache()
-          .get_topic_timestamp_type(
-            model::topic_namespace_view(model::kafka_namespace, topic.name))
-          .value_or(octx.rctx.metadata_cache().get_default_timestamp_type());
-
-    if (timestamp_type == model::timestamp_type::append_time) {
+    if (topic_cfg->timestamp_type == model::timestamp_type::append_time) {
         batch.set_max_timestamp(
           model::timestamp_type::append_time, model::timestamp::now());
     }
 
-    const auto& hdr = batch.header();
-    auto bid = model::batch_identity::from(hdr);
-
+    auto bid = model::batch_identity::from(batch.header());
     auto num_records = batch.record_count();
-    auto reader = reader_from_lcore_batch(std::move(batch));
-    auto start = std::chrono::steady_clock::now();
-
-    auto dispatch = std::make_unique<ss::promise<>>();
-    auto dispatch_f = dispatch->get_future();
-    auto f
-      = octx.rctx.partition_manager()
-          .invoke_on(
-            *shard,
-            octx.ssg,
-            [reader = std::move(reader),
-             ntp = std::move(ntp),
-             dispatch = std::move(dispatch),
-             num_records,
-             bid,
-             acks = octx.request.data.acks,
-             source_shard = ss::this_shard_id()](
-              cluster::partition_manager& mgr) mutable {
-                auto partition = mgr.get(ntp);
-                if (!partition) {
-                    // submit back to promise source shard
-                    (void)ss::smp::submit_to(
-                      source_shard, [dispatch = std::move(dispatch)]() mutable {
-                          dispatch->set_value();
-                          dispatch.reset();
-                      });
-                    return ss::make_ready_future<produce_response::partition>(
-                      produce_response::partition{
-                        .partition_index = ntp.tp.partition,
-                        .error_code = error_code::unknown_topic_or_partition});
-                }
-                if (unlikely(!partition->is_leader())) {
-                    // submit back to promise source shard
-                    (void)ss::smp::submit_to(
-                      source_shard, [dispatch = std::move(dispatch)]() mutable {
-                          dispatch->set_value();
-                          dispatch.reset();
-                      });
-                    return ss::make_ready_future<produce_response::partition>(
-                      produce_response::partition{
-                        .partition_index = ntp.tp.partition,
-                        .error_code = error_code::not_leader_for_partition});
-                }
-                auto stages = partition_append(
-                  ntp.tp.partition,
-                  ss::make_lw_shared<replicated_partition>(
-                    std::move(partition)),
-                  bid,
-                  std::move(reader),
-                  acks,
-                  num_records);
-                return stages.dispatched
-                  .then_wrapped([source_shard, dispatch = std::move(dispatch)](
-                                  ss::future<> f) mutable {
-                      if (f.failed()) {
-                          (void)ss::smp::submit_to(
-                            source_shard,
-                            [dispatch = std::move(dispatch),
-                             e = f.get_exception()]() mutable {
-                                dispatch->set_exception(e);
-                                dispatch.reset();
-                            });
-                          return;
-                      }
-                      (void)ss::smp::submit_to(
-                        source_shard,
-                        [dispatch = std::move(dispatch)]() mutable {
-                            dispatch->set_value();
-                            dispatch.reset();
-                        });
-                  })
-                  .then([f = std::move(stages.produced)]() mutable {
-                      return std::move(f);
-                  });
-            })
-          .then([&octx, start](produce_response::partition p) {
-              if (p.error_code == error_code::none) {
-                  auto dur = std::chrono::steady_clock::now() - start;
-                  octx.rctx.connection()->server().update_produce_latency(dur);
-              }
-              return p;
-          });
-    return partition_produce_stages{
-      .dispatched = std::move(dispatch_f),
-      .produced = std::move(f),
-    };
+    auto size_bytes = batch.size_bytes();
+    plan.produces_per_shard[*shard].push_back(
+      partition_produce{
+        .ntp = std::move(ntp),
+        .bid = bid,
+        .reader = reader_from_lcore_batch(std::move(batch)),
+        .num_records = num_records,
+        .size_bytes = size_bytes,
+      },
+      response);
+    return std::nullopt;
 }
 
 /**
- * \brief Dispatch and collect topic partition produce responses
+ * \brief group the partitions of the request by the shard owning them.
+ *
+ * The response is laid out in the order of the request and the errors of the
+ * partitions that can't be produced to are filled in right away, the
+ * responses of the planned partitions are filled in once produced.
  */
-static topic_produce_stages
-produce_topic(produce_ctx& octx, produce_request::topic& topic) {
-    std::vector<ss::future<produce_response::partition>> partitions_produced;
-    std::vector<ss::future<>> partitions_dispatched;
-    partitions_produced.reserve(topic.partitions.size());
-    partitions_dispatched.reserve(topic.partitions.size());
-
-    for (auto& part : topic.partitions) {
-        if (!octx.rctx.authorized(security::acl_operation::write, topic.name)) {
-            partitions_dispatched.push_back(ss::now());
-            partitions_produced.push_back(
-              ss::make_ready_future<produce_response::partition>(
-                produce_response::partition{
-                  .partition_index = part.partition_index,
-                  .error_code = error_code::topic_authorization_failed}));
-            continue;
-        }
-
-        if (!octx.rctx.metadata_cache().contains(
-              model::topic_namespace_view(model::kafka_namespace, topic.name),
-              part.partition_index)) {
-            partitions_dispatched.push_back(ss::now());
-            partitions_produced.push_back(
-              ss::make_ready_future<produce_response::partition>(
-                produce_response::partition{
-                  .partition_index = part.partition_index,
-                  .error_code = error_code::unknown_topic_or_partition}));
-            continue;
-        }
-
-        // the record data on the wire was null value
-        if (unlikely(!part.records)) {
-            partitions_dispatched.push_back(ss::now());
-            partitions_produced.push_back(
-              ss::make_ready_future<produce_response::partition>(
-                produce_response::partition{
-                  .partition_index = part.partition_index,
-                  .error_code = error_code::invalid_record}));
-            continue;
-        }
-
-        // an error occured handling legacy messages (magic 0 or 1)
-        if (unlikely(part.records->adapter.legacy_error)) {
-            partitions_dispatched.push_back(ss::now());
-            partitions_produced.push_back(
-              ss::make_ready_future<produce_response::partition>(
-                produce_response::partition{
-                  .partition_index = part.partition_index,
-                  .error_code = error_code::invalid_record}));
-            continue;
-        }
-
-        if (unlikely(!part.records->adapter.valid_crc)) {
-            partitions_dispatched.push_back(ss::now());
-            partitions_produced.push_back(
-              ss::make_ready_future<produce_response::partition>(
-                produce_response::partition{
-                  .partition_index = part.partition_index,
-                  .error_code = error_code::corrupt_message}));
-            continue;
-        }
-
-        // produce version >= 3 (enforced for all produce requests)
-        // requires exactly one record batch per request and it must use
-        // the v2 format.
-        //
-        // NOTE: for produce version 0 and 1 the adapter transparently converts
-        // the batch into an v2 batch and sets the v2_format flag. conversion
-        // also produces a single record batch by accumulating legacy messages.
-        if (unlikely(
-              !part.records->adapter.v2_format
-              || !part.records->adapter.batch)) {
-            partitions_dispatched.push_back(ss::now());
-            partitions_produced.push_back(
-              ss::make_ready_future<produce_response::partition>(
-                produce_response::partition{
-                  .partition_index = part.partition_index,
-                  .error_code = error_code::invalid_record}));
-            continue;
+static produce_plan plan_produce(produce_ctx& octx) {
+    produce_plan plan(ss::smp::count);
+    auto& responses = octx.response.data.responses;
+    responses.reserve(octx.request.data.topics.size());
+    for (auto& topic : octx.request.data.topics) {
+        auto& t = responses.emplace_back(
+          produce_response::topic{.name = topic.name});
+        // the planned partitions keep pointers to their responses
+        t.partitions.reserve(topic.partitions.size());
+        // the topic name is hashed once, the partitions are looked up by id
+        const auto topic_id = model::ntp_interner::local().find(
+          model::topic_namespace_view(model::kafka_namespace, topic.name));
+        for (auto& part : topic.partitions) {
+            auto& p = t.partitions.emplace_back(produce_response::partition{
+              .partition_index = part.partition_index});
+            if (auto ec = plan_topic_partition(
+                  octx, plan, topic, topic_id, part, &p)) {
+                p.error_code = *ec;
+            }
         }
-
-        auto pr = produce_topic_partition(octx, topic, part);
-        partitions_produced.push_back(std::move(pr.produced));
-        partitions_dispatched.push_back(std::move(pr.dispatched));
     }
-
-    // collect partition responses and build the topic response
-    return topic_produce_stages{
-      .dispatched = ss::when_all_succeed(
-        partitions_dispatched.begin(), partitions_dispatched.end()),
-      .produced
-      = ss::when_all_succeed(
-          partitions_produced.begin(), partitions_produced.end())
-          .then([name = std::move(topic.name)](
-                  std::vector<produce_response::partition> parts) mutable {
-              return produce_response::topic{
-                .name = std::move(name),
-                .partitions = std::move(parts),
-              };
-          }),
-    };
+    return plan;
 }
 
 /**
- * \brief Dispatch and collect topic produce responses
+ * \brief Dispatch the produce requests of every shard
  */
-static std::vector<topic_produce_stages> produce_topics(produce_ctx& octx) {
-    std::vector<topic_produce_stages> topics;
-    topics.reserve(octx.request.data.topics.size());
-
-    for (auto& topic : octx.request.data.topics) {
-        topics.push_back(produce_topic(octx, topic));
+static std::vector<shard_produce_stages> produce_shards(produce_ctx& octx) {
+    auto plan = plan_produce(octx);
+    std::vector<shard_produce_stages> shards;
+    for (ss::shard_id shard = 0; shard < plan.produces_per_shard.size();
+         ++shard) {
+        auto& sp = plan.produces_per_shard[shard];
+        if (sp.empty()) {
+            continue;
+        }
+        shards.push_back(produce_shard(octx, shard, std::move(sp)));
     }
-
-    return topics;
+    return shards;
 }
 
 process_result_stages
@@ -448,8 +489,12 @@ produce_handler::handle(request_context ctx, ss::smp_service_group ssg) {
     request.decode(ctx.reader(), ctx.header().version);
 
     // determine if the request has transactional / idemponent batches
+    uint64_t partitions = 0;
     for (auto& topic : request.data.topics) {
+        partitions += topic.partitions.size();
         for (auto& part : topic.partitions) {
+            ctx.connection()->add_request_partition(
+              topic.name, part.partition_index);
             if (part.records) {
                 if (part.records->adapter.batch) {
                     const auto& hdr = part.records->adapter.batch->header();
@@ -462,6 +507,11 @@ produce_handler::handle(request_context ctx, ss::smp_service_group ssg) {
         }
     }
 
+    event_trace::record(
+      event_trace::type::produce_received,
+      ctx.header().correlation(),
+      partitions);
+
     /*
      * Authorization
      *
@@ -525,10 +575,10 @@ produce_handler::handle(request_context ctx, ss::smp_service_group ssg) {
         produce_ctx& octx) mutable {
           vlog(klog.trace, "handling produce request {}", octx.request);
 
-          // dispatch produce requests for each topic
-          auto stages = produce_topics(octx);
+          // dispatch produce requests for each shard
+          auto stages = produce_shards(octx);
           std::vector<ss::future<>> dispatched;
-          std::vector<ss::future<produce_response::topic>> produced;
+          std::vector<ss::future<>> produced;
           dispatched.reserve(stages.size());
           produced.reserve(stages.size());
 
@@ -544,13 +594,13 @@ produce_handler::handle(request_context ctx, ss::smp_service_group ssg) {
                 try {
                     f.get();
                     dispatched_promise.set_value();
-                    // collect topic responses
+                    // collect the partition responses of every shard
                     return when_all_succeed(produced.begin(), produced.end())
-                      .then(
-                        [&octx](std::vector<produce_response::topic> topics) {
-                            octx.response.data.responses = std::move(topics);
-                        })
                       .then([&octx] {
+                          event_trace::record(
+                            event_trace::type::produce_acked,
+                            octx.rctx.header().correlation(),
+                            0);
                           // send response immediately
                           if (octx.request.data.acks != 0) {
                               return octx.rctx.respond(
@@ -19,6 +19,11 @@ struct produce_handler {
     static constexpr api_version min_supported = api_version(0);
     static constexpr api_version max_supported = api_version(7);
     static process_result_stages handle(request_context, ss::smp_service_group);
+    static size_t memory_estimate(size_t request_size, connection_context&) {
+        // the batches share the buffer of the request rather than being
+        // copied, and the response is small
+        return request_size + 8000; // NOLINT
+    }
 };
 
 } // namespace kafka
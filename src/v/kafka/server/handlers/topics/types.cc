@@ -18,6 +18,7 @@
 
 #include <bits/stdint-intn.h>
 #include <bits/stdint-uintn.h>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include <chrono>
 #include <cstddef>
@@ -72,6 +73,34 @@ get_tristate_value(const config_map_t& config, std::string_view key) {
     return tristate<T>(std::make_optional<T>(*v));
 }
 
+// Flush policies are only set by positive values
+template<typename T>
+static std::optional<T>
+get_positive_value(const config_map_t& config, std::string_view key) {
+    auto v = get_config_value<int64_t>(config, key);
+    if (!v || *v <= 0) {
+        return std::nullopt;
+    }
+    return T(*v);
+}
+
+// Boolean properties are enabled by "true"
+static std::optional<bool>
+get_bool_value(const config_map_t& config, std::string_view key) {
+    if (auto it = config.find(key); it != config.end()) {
+        return boost::iequals(it->second, "true");
+    }
+    return std::nullopt;
+}
+
+static std::optional<ss::sstring>
+get_string_value(const config_map_t& config, std::string_view key) {
+    if (auto it = config.find(key); it != config.end()) {
+        return ss::sstring(it->second);
+    }
+    return std::nullopt;
+}
+
 cluster::topic_configuration to_cluster_type(const creatable_topic& t) {
     auto cfg = cluster::topic_configuration(
       model::kafka_namespace, t.name, t.num_partitions, t.replication_factor);
@@ -95,6 +124,16 @@ cluster::topic_configuration to_cluster_type(const creatable_topic& t) {
     cfg.properties.retention_duration
       = get_tristate_value<std::chrono::milliseconds>(
         config_entries, topic_property_retention_duration);
+    cfg.properties.storage_engine = get_config_value<model::storage_engine>(
+      config_entries, topic_property_storage_engine);
+    cfg.properties.flush_ms = get_positive_value<std::chrono::milliseconds>(
+      config_entries, topic_property_flush_ms);
+    cfg.properties.flush_bytes = get_positive_value<size_t>(
+      config_entries, topic_property_flush_bytes);
+    cfg.properties.recovery = get_bool_value(
+      config_entries, topic_property_recovery);
+    cfg.properties.read_replica_bucket = get_string_value(
+      config_entries, topic_property_read_replica);
 
     return cfg;
 }
@@ -45,6 +45,14 @@ static constexpr std::string_view topic_property_retention_bytes
   = "retention.bytes";
 static constexpr std::string_view topic_property_retention_duration
   = "retention.ms";
+static constexpr std::string_view topic_property_storage_engine
+  = "redpanda.storage.engine";
+static constexpr std::string_view topic_property_flush_ms = "flush.ms";
+static constexpr std::string_view topic_property_flush_bytes = "flush.bytes";
+static constexpr std::string_view topic_property_recovery
+  = "redpanda.remote.recovery";
+static constexpr std::string_view topic_property_read_replica
+  = "redpanda.remote.readreplica";
 
 /// \brief Type representing Kafka protocol response from
 /// CreateTopics, DeleteTopics and CreatePartitions requests
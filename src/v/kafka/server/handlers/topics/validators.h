@@ -81,8 +81,24 @@ struct unsupported_configuration_entries {
         auto config_entries = config_map(c.configs);
         auto end = config_entries.end();
         return end == config_entries.find("min.insync.replicas")
-               && end == config_entries.find("flush.messages")
-               && end == config_entries.find("flush.ms");
+               && end == config_entries.find("flush.messages");
+    }
+};
+
+struct memory_storage_engine_is_not_compacted {
+    static constexpr error_code ec = error_code::invalid_config;
+    static constexpr const char* error_message
+      = "Topics in memory don't support compaction";
+
+    static bool is_valid(const creatable_topic& c) {
+        auto config_entries = config_map(c.configs);
+        auto engine = config_entries.find(topic_property_storage_engine);
+        if (engine == config_entries.end() || engine->second != "memory") {
+            return true;
+        }
+        auto policy = config_entries.find(topic_property_cleanup_policy);
+        return policy == config_entries.end()
+               || policy->second.find("compact") == ss::sstring::npos;
     }
 };
 
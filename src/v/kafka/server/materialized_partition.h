@@ -52,6 +52,11 @@ public:
           std::vector<cluster::rm_stm::tx_range>());
     }
 
+    std::optional<storage::term_end_result>
+    term_end(model::term_id t) const final {
+        return _log.term_end(t);
+    }
+
     cluster::partition_probe& probe() final { return _probe; }
 
 private:
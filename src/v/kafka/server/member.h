@@ -112,6 +112,9 @@ public:
     /// Get the member id.
     const kafka::member_id& id() const { return _state.id; }
 
+    /// Set the member id, a static member rejoining takes a new id.
+    void set_id(kafka::member_id id) { _state.id = std::move(id); }
+
     /// Get the id of the member's group.
     const kafka::group_id& group_id() const { return _group_id; }
 
@@ -224,6 +227,11 @@ public:
 
     ss::timer<clock_type>& expire_timer() { return _expire_timer; }
 
+    /// \brief when the member expires, the expire timer may be armed for
+    /// an earlier time and re-armed to it
+    clock_type::time_point expire_deadline() const { return _expire_deadline; }
+    void set_expire_deadline(clock_type::time_point t) { _expire_deadline = t; }
+
     // helper for kafka api: describe groups
     described_group_member describe(const kafka::protocol_name&) const;
     described_group_member describe_without_metadata() const;
@@ -240,6 +248,7 @@ private:
     bool _is_new;
     clock_type::time_point _latest_heartbeat;
     ss::timer<clock_type> _expire_timer;
+    clock_type::time_point _expire_deadline;
 
     // external shutdown synchronization
     std::unique_ptr<sync_promise> _sync_promise;
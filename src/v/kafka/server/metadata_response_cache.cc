@@ -0,0 +1,58 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/metadata_response_cache.h"
+
+#include "model/namespace.h"
+
+#include <algorithm>
+
+namespace kafka {
+
+metadata_response_cache::metadata_response_cache(
+  cluster::metadata_cache& md_cache)
+  : _md_cache(md_cache)
+  , _notification(_md_cache.register_topic_change_notification(
+      [this](model::topic_namespace_view tp_ns) {
+          if (tp_ns.ns == model::kafka_namespace) {
+              invalidate(tp_ns.tp);
+          }
+      })) {}
+
+metadata_response_cache::~metadata_response_cache() noexcept {
+    _md_cache.unregister_topic_change_notification(_notification);
+}
+
+std::optional<iobuf>
+metadata_response_cache::get(const model::topic& tp, api_version version) {
+    if (auto it = _topics.find(tp); it != _topics.end()) {
+        auto v = std::find_if(
+          it->second.begin(), it->second.end(), [version](const auto& e) {
+              return e.first == version;
+          });
+        if (v != it->second.end()) {
+            return v->second.share(0, v->second.size_bytes());
+        }
+    }
+    return std::nullopt;
+}
+
+void metadata_response_cache::put(
+  const model::topic& tp, api_version version, const iobuf& encoded) {
+    auto& versions = _topics[tp];
+    std::erase_if(
+      versions, [version](const auto& e) { return e.first == version; });
+    versions.emplace_back(version, encoded.copy());
+}
+
+void metadata_response_cache::invalidate(const model::topic& tp) {
+    _topics.erase(tp);
+}
+
+} // namespace kafka
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/iobuf.h"
+#include "cluster/metadata_cache.h"
+#include "kafka/types.h"
+#include "model/fundamental.h"
+#include "seastarx.h"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace kafka {
+
+/**
+ * Encoded topics of the metadata responses of this shard.
+ *
+ * Clients refresh the metadata of every topic periodically and with many
+ * partitions building and encoding the topics dominates the cost of the
+ * request. The encoded topic only depends on the topic table and on the
+ * partition leaders, so it is cached per api version and dropped whenever the
+ * partitions, the replicas or the leaders of the topic change. Responses
+ * share the cached buffers instead of encoding the topics again.
+ *
+ * Only topics of the kafka namespace without errors are cached, the
+ * authorized operations depend on the principal and are not cached.
+ */
+class metadata_response_cache {
+public:
+    explicit metadata_response_cache(cluster::metadata_cache&);
+    metadata_response_cache(const metadata_response_cache&) = delete;
+    metadata_response_cache& operator=(const metadata_response_cache&)
+      = delete;
+    metadata_response_cache(metadata_response_cache&&) = delete;
+    metadata_response_cache& operator=(metadata_response_cache&&) = delete;
+    ~metadata_response_cache() noexcept;
+
+    /// Returns a share of the encoded topic
+    std::optional<iobuf> get(const model::topic&, api_version);
+
+    void put(const model::topic&, api_version, const iobuf&);
+
+    void invalidate(const model::topic&);
+
+    size_t size() const { return _topics.size(); }
+
+private:
+    using versions_t = std::vector<std::pair<api_version, iobuf>>;
+
+    cluster::metadata_cache& _md_cache;
+    cluster::metadata_cache::topic_change_notification_id _notification;
+    absl::flat_hash_map<model::topic, versions_t> _topics;
+};
+
+} // namespace kafka
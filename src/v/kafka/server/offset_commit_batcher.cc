@@ -0,0 +1,152 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/offset_commit_batcher.h"
+
+#include "cluster/partition.h"
+#include "kafka/server/logger.h"
+#include "model/record_batch_reader.h"
+#include "storage/record_batch_builder.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+
+#include <iterator>
+#include <optional>
+
+namespace kafka {
+
+offset_commit_batcher::offset_commit_batcher(
+  ss::lw_shared_ptr<cluster::partition> p)
+  : _partition(std::move(p)) {}
+
+raft::replicate_stages offset_commit_batcher::replicate(records_t records) {
+    size_t size = 0;
+    for (const auto& [k, v] : records) {
+        size += k.size_bytes() + v.size_bytes();
+    }
+    auto& it = _pending.emplace_back(item{
+      .records = std::move(records),
+      .size_bytes = size,
+    });
+    raft::replicate_stages stages(
+      it.enqueued.get_future(), it.finished.get_future());
+    maybe_flush();
+    return stages;
+}
+
+void offset_commit_batcher::maybe_flush() {
+    if (_flushing || _pending.empty()) {
+        return;
+    }
+    _flushing = true;
+    (void)flush(next_batch())
+      .then_wrapped([self = shared_from_this()](ss::future<> f) {
+          if (f.failed()) {
+              vlog(
+                klog.warn,
+                "failed to replicate offset commits on {} - {}",
+                self->_partition->ntp(),
+                f.get_exception());
+          }
+          self->_flushing = false;
+          self->maybe_flush();
+      });
+}
+
+std::vector<offset_commit_batcher::item> offset_commit_batcher::next_batch() {
+    size_t size = 0;
+    auto end = _pending.begin();
+    // at least one commit is taken, even if it exceeds the limit on its own
+    do {
+        size += end->size_bytes;
+        ++end;
+    } while (end != _pending.end()
+             && size + end->size_bytes <= max_batch_bytes);
+
+    std::vector<item> batch(
+      std::make_move_iterator(_pending.begin()), std::make_move_iterator(end));
+    _pending.erase(_pending.begin(), end);
+    return batch;
+}
+
+ss::future<> offset_commit_batcher::flush(std::vector<item> items) {
+    storage::record_batch_builder builder(
+      model::record_batch_type::raft_data, model::offset(0));
+    size_t records = 0;
+    size_t bytes = 0;
+    for (const auto& i : items) {
+        records += i.records.size();
+        bytes += i.size_bytes;
+    }
+    builder.reserve(records, bytes);
+    std::vector<ss::promise<result<raft::replicate_result>>> finished;
+    finished.reserve(items.size());
+    for (auto& i : items) {
+        for (auto& [k, v] : i.records) {
+            builder.add_raw_kv(std::move(k), std::move(v));
+        }
+        finished.push_back(std::move(i.finished));
+    }
+    auto reader = model::make_memory_record_batch_reader(
+      std::move(builder).build());
+
+    std::optional<raft::replicate_stages> stages;
+    try {
+        stages.emplace(_partition->replicate_in_stages(
+          std::move(reader),
+          raft::replicate_options(raft::consistency_level::quorum_ack)));
+    } catch (...) {
+        auto e = std::current_exception();
+        for (auto& i : items) {
+            i.enqueued.set_exception(e);
+        }
+        for (auto& f : finished) {
+            f.set_exception(e);
+        }
+        throw;
+    }
+
+    // every commit of the batch shares the acknowledgement, it is delivered in
+    // the background as the next batch only waits for this one to be enqueued
+    (void)stages->replicate_finished.then_wrapped(
+      [finished = std::move(finished)](
+        ss::future<result<raft::replicate_result>> f) mutable {
+          if (f.failed()) {
+              auto e = f.get_exception();
+              for (auto& p : finished) {
+                  p.set_exception(e);
+              }
+              return;
+          }
+          auto r = f.get0();
+          for (auto& p : finished) {
+              p.set_value(r);
+          }
+      });
+
+    std::exception_ptr ex;
+    try {
+        co_await std::move(stages->request_enqueued);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    for (auto& i : items) {
+        if (ex) {
+            i.enqueued.set_exception(ex);
+        } else {
+            i.enqueued.set_value();
+        }
+    }
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+}
+
+} // namespace kafka
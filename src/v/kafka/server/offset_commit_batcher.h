@@ -0,0 +1,70 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/iobuf.h"
+#include "cluster/fwd.h"
+#include "raft/types.h"
+#include "seastarx.h"
+#include "units.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include <utility>
+#include <vector>
+
+namespace kafka {
+
+/**
+ * Coalesces the offset commits of the groups coordinated by the same
+ * partition into shared record batches.
+ *
+ * A batch is replicated as soon as the previous one was enqueued in raft,
+ * the commits that arrive in the meantime are appended to the next batch.
+ * There is no added latency when the coordinator is idle while under load
+ * many groups share a single batch, append and acknowledgement. The records
+ * of a single commit are never split across batches.
+ */
+class offset_commit_batcher
+  : public ss::enable_lw_shared_from_this<offset_commit_batcher> {
+public:
+    /// key and value of the records of a single offset commit
+    using records_t = std::vector<std::pair<iobuf, iobuf>>;
+
+    /// Batches are cut at this size unless a single commit is larger
+    static constexpr size_t max_batch_bytes = 512_KiB;
+
+    explicit offset_commit_batcher(ss::lw_shared_ptr<cluster::partition>);
+
+    /// Replicate the records with quorum consistency, the stages have the
+    /// same meaning as the ones of cluster::partition::replicate_in_stages
+    raft::replicate_stages replicate(records_t);
+
+private:
+    struct item {
+        records_t records;
+        size_t size_bytes;
+        ss::promise<> enqueued;
+        ss::promise<result<raft::replicate_result>> finished;
+    };
+
+    void maybe_flush();
+    std::vector<item> next_batch();
+    ss::future<> flush(std::vector<item>);
+
+    ss::lw_shared_ptr<cluster::partition> _partition;
+    std::vector<item> _pending;
+    bool _flushing{false};
+};
+
+} // namespace kafka
@@ -3,6 +3,8 @@
 #include "model/fundamental.h"
 #include "raft/configuration_manager.h"
 
+#include <algorithm>
+
 namespace kafka {
 /**
  * Offset translator performs conversion between kafka offsets, which doesn't
@@ -14,8 +16,7 @@ public:
       : _cfg_mgr(config_mgr) {}
 
     model::offset to_kafka_offset(model::offset o) const {
-        auto d = delta(o);
-        return model::offset(o - d);
+        return o - delta(o);
     }
 
     model::offset from_kafka_offset(
@@ -23,43 +24,63 @@ public:
         if (kafka_offset == model::offset::max()) {
             return kafka_offset;
         }
-
-        auto next_cfg_it = _cfg_mgr.lower_bound(std::max(hint, kafka_offset));
-        // fast exit, current offset is larger than last config batch
-        // offset, just add delta
-        if (next_cfg_it == _cfg_mgr.end()) {
-            --next_cfg_it;
-            return kafka_offset + next_cfg_it->second.idx();
-        }
-
-        auto delta = model::offset(next_cfg_it->second.idx() - 1);
-        // largest kafka offset that is achievable before reaching next
-        // control batch
-        auto max_cfg_ko = next_cfg_it->first - delta;
-        while (max_cfg_ko <= kafka_offset) {
-            // skip to the next configuration batch
-            ++next_cfg_it;
-            // since we jumped over to next config batch we can just increment
-            // delta
-            ++delta;
-            if (next_cfg_it == _cfg_mgr.end()) {
-                break;
+        const auto& index = _cfg_mgr.get_offset_index();
+        const auto& offsets = index.offsets;
+        // the largest kafka offset achievable before reaching the
+        // configuration at position i doesn't decrease with i, the delta is
+        // the one of the first configuration that can't be reached
+        auto max_cfg_ko = [&index, &offsets](size_t i) {
+            return offsets[i] - index_delta(index, i) + model::offset(1);
+        };
+        size_t lo = std::distance(
+          offsets.begin(),
+          std::lower_bound(
+            offsets.begin(), offsets.end(), std::max(hint, kafka_offset)));
+        size_t hi = offsets.size();
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo) / 2;
+            if (max_cfg_ko(mid) <= kafka_offset) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
             }
-            max_cfg_ko = next_cfg_it->first - delta;
         }
-        return kafka_offset + delta;
+        return kafka_offset + index_delta(index, lo) - model::offset(1);
     }
 
 private:
-    int64_t delta(model::offset o) const {
-        auto it = _cfg_mgr.lower_bound(o);
-        if (it != _cfg_mgr.begin()) {
+    model::offset delta(model::offset o) const {
+        const auto& index = _cfg_mgr.get_offset_index();
+        const auto& offsets = index.offsets;
+        // the configuration preceding the offset, readers translate
+        // increasing offsets so it is usually the one of the last lookup
+        auto precedes = [&offsets, o](size_t i) {
+            return offsets[i] < o
+                   && (i + 1 == offsets.size() || offsets[i + 1] >= o);
+        };
+        if (_cursor < offsets.size() && precedes(_cursor)) {
+            return index_delta(index, _cursor);
+        }
+        if (_cursor + 1 < offsets.size() && precedes(_cursor + 1)) {
+            return index_delta(index, ++_cursor);
+        }
+        auto it = std::lower_bound(offsets.begin(), offsets.end(), o);
+        if (it != offsets.begin()) {
             --it;
         }
-        return it->second.idx();
+        _cursor = std::distance(offsets.begin(), it);
+        return index_delta(index, _cursor);
+    }
+
+    // configuration batches up to and including the one at position i
+    static model::offset index_delta(
+      const raft::configuration_manager::offset_index& index, size_t i) {
+        return model::offset(index.first_index() + static_cast<int64_t>(i));
     }
 
     const raft::configuration_manager& _cfg_mgr;
+    // position of the configuration of the last translation
+    mutable size_t _cursor{0};
 };
 
 } // namespace kafka
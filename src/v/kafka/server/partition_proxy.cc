@@ -13,6 +13,7 @@
 
 #include "cluster/partition_manager.h"
 #include "kafka/server/materialized_partition.h"
+#include "kafka/server/read_replica_partition.h"
 #include "kafka/server/replicated_partition.h"
 
 namespace kafka {
@@ -21,8 +22,25 @@ std::optional<partition_proxy> make_partition_proxy(
   const model::materialized_ntp& mntp,
   ss::lw_shared_ptr<cluster::partition> partition,
   cluster::partition_manager& pm) {
+    return make_partition_proxy(mntp, std::move(partition), pm, nullptr);
+}
+
+std::optional<partition_proxy> make_partition_proxy(
+  const model::materialized_ntp& mntp,
+  ss::lw_shared_ptr<cluster::partition> partition,
+  cluster::partition_manager& pm,
+  ss::lw_shared_ptr<cloud_storage::remote_partition> remote) {
     if (!mntp.is_materialized()) {
-        return make_partition_proxy<replicated_partition>(partition);
+        if (partition->get_ntp_config().is_read_replica()) {
+            // the read replica has no local data to serve
+            if (!remote) {
+                return std::nullopt;
+            }
+            return make_partition_proxy<read_replica_partition>(
+              partition, std::move(remote));
+        }
+        return make_partition_proxy<replicated_partition>(
+          partition, std::move(remote));
     }
     if (auto log = pm.log(mntp.input_ntp()); log) {
         return make_partition_proxy<materialized_partition>(*log);
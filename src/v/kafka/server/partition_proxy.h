@@ -10,6 +10,7 @@
  */
 #pragma once
 
+#include "cloud_storage/remote_partition.h"
 #include "cluster/partition.h"
 #include "model/fundamental.h"
 #include "storage/types.h"
@@ -37,6 +38,8 @@ public:
           timequery(model::timestamp, ss::io_priority_class) = 0;
         virtual ss::future<std::vector<cluster::rm_stm::tx_range>>
           aborted_transactions(model::offset, model::offset) = 0;
+        virtual std::optional<storage::term_end_result>
+          term_end(model::term_id) const = 0;
         virtual cluster::partition_probe& probe() = 0;
         virtual ~impl() noexcept = default;
     };
@@ -70,6 +73,12 @@ public:
         return _impl->timequery(ts, io_pc);
     }
 
+    /// \brief the latest term up to the given one and the offset following
+    /// it, as a kafka offset
+    std::optional<storage::term_end_result> term_end(model::term_id t) const {
+        return _impl->term_end(t);
+    }
+
     cluster::partition_probe& probe() { return _impl->probe(); }
 
 private:
@@ -86,4 +95,14 @@ std::optional<partition_proxy> make_partition_proxy(
   ss::lw_shared_ptr<cluster::partition>,
   cluster::partition_manager&);
 
+/// Same as above but the proxy of the replicated partition will serve reads
+/// below the local start offset from the remote (S3) partition if it's set.
+/// The partitions of a read replica topic are served only from the remote
+/// partition, nullopt is returned if it's not set.
+std::optional<partition_proxy> make_partition_proxy(
+  const model::materialized_ntp&,
+  ss::lw_shared_ptr<cluster::partition>,
+  cluster::partition_manager&,
+  ss::lw_shared_ptr<cloud_storage::remote_partition>);
+
 } // namespace kafka
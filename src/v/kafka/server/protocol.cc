@@ -11,10 +11,12 @@
 
 #include "cluster/topics_frontend.h"
 #include "config/configuration.h"
+#include "kafka/server/connection_balancer.h"
 #include "kafka/server/connection_context.h"
 #include "kafka/server/logger.h"
 #include "kafka/server/request_context.h"
 #include "kafka/server/response.h"
+#include "prometheus/prometheus_sanitize.h"
 #include "security/scram_algorithm.h"
 #include "utils/utf8.h"
 #include "vlog.h"
@@ -43,12 +45,14 @@ protocol::protocol(
   ss::sharded<cluster::partition_manager>& pm,
   ss::sharded<coordinator_ntp_mapper>& coordinator_mapper,
   ss::sharded<fetch_session_cache>& session_cache,
+  ss::sharded<connection_balancer>& conn_balancer,
   ss::sharded<cluster::id_allocator_frontend>& id_allocator_frontend,
   ss::sharded<security::credential_store>& credentials,
   ss::sharded<security::authorizer>& authorizer,
   ss::sharded<cluster::security_frontend>& sec_fe,
   ss::sharded<cluster::controller_api>& controller_api,
   ss::sharded<cluster::tx_gateway_frontend>& tx_gateway_frontend,
+  ss::sharded<archival::scheduler_service>& archival_service,
   std::optional<qdc_monitor::config> qdc_config) noexcept
   : _smp_group(smp)
   , _topics_frontend(tf)
@@ -59,6 +63,7 @@ protocol::protocol(
   , _partition_manager(pm)
   , _coordinator_mapper(coordinator_mapper)
   , _fetch_session_cache(session_cache)
+  , _connection_balancer(conn_balancer)
   , _id_allocator_frontend(id_allocator_frontend)
   , _is_idempotence_enabled(
       config::shard_local_cfg().enable_idempotence.value())
@@ -68,10 +73,95 @@ protocol::protocol(
   , _authorizer(authorizer)
   , _security_frontend(sec_fe)
   , _controller_api(controller_api)
-  , _tx_gateway_frontend(tx_gateway_frontend) {
+  , _tx_gateway_frontend(tx_gateway_frontend)
+  , _archival_service(archival_service)
+  , _metadata_response_cache(
+      std::make_unique<kafka::metadata_response_cache>(meta.local()))
+  , _topic_config_cache(
+      std::make_unique<kafka::topic_config_cache>(meta.local()))
+  , _max_sasl_handshakes(
+      config::shard_local_cfg().sasl_max_concurrent_handshakes())
+  , _sasl_handshakes(_max_sasl_handshakes) {
     if (qdc_config) {
         _qdc_mon.emplace(*qdc_config);
     }
+    setup_metrics();
+}
+
+ss::future<ss::semaphore_units<>> protocol::admit_sasl_handshake() {
+    if (_sasl_handshakes.available_units() <= 0) {
+        ++_sasl_handshakes_queued;
+    }
+    return ss::get_units(_sasl_handshakes, 1)
+      .then([this](ss::semaphore_units<> units) {
+          ++_sasl_handshakes_admitted;
+          return units;
+      });
+}
+
+void protocol::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("kafka:sasl"),
+      {
+        sm::make_gauge(
+          "handshakes_in_progress",
+          [this] {
+              return _max_sasl_handshakes - _sasl_handshakes.available_units();
+          },
+          sm::description("Number of connections between their SASL "
+                          "handshake and the end of their authentication")),
+        sm::make_gauge(
+          "handshakes_waiting",
+          [this] { return _sasl_handshakes.waiters(); },
+          sm::description("Number of connections waiting for their turn to "
+                          "start a SASL handshake")),
+        sm::make_derive(
+          "handshakes",
+          [this] { return _sasl_handshakes_admitted; },
+          sm::description("Number of SASL handshakes started")),
+        sm::make_derive(
+          "handshakes_queued",
+          [this] { return _sasl_handshakes_queued; },
+          sm::description("Number of SASL handshakes that waited for their "
+                          "turn")),
+      });
+}
+
+void protocol::record_request_cpu(api_key key, std::chrono::microseconds cpu) {
+    auto [it, inserted] = _api_cpu.try_emplace(key);
+    if (inserted) {
+        setup_api_cpu_metrics(key, it->second);
+    }
+    it->second.requests += 1;
+    it->second.cpu_us += cpu.count();
+}
+
+void protocol::setup_api_cpu_metrics(api_key key, api_cpu_usage& usage) {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    std::vector<sm::label_instance> labels{sm::label("api_key")(key())};
+    usage.metrics.add_group(
+      prometheus_sanitize::metrics_name("kafka:request_cpu"),
+      {
+        sm::make_derive(
+          "requests",
+          [&usage] { return usage.requests; },
+          sm::description("Number of requests of the API"),
+          labels),
+        sm::make_derive(
+          "time_us",
+          [&usage] { return usage.cpu_us; },
+          sm::description(
+            "CPU time spent dispatching the requests of the API, in "
+            "microseconds"),
+          labels),
+      });
 }
 
 ss::future<> protocol::apply(rpc::server::resources rs) {
@@ -94,10 +184,19 @@ ss::future<> protocol::apply(rpc::server::resources rs) {
       std::move(sasl),
       config::shard_local_cfg().enable_sasl());
 
+    conn_balancer().connection_opened();
     return ss::do_until(
              [ctx] { return ctx->is_finished_parsing(); },
              [ctx] { return ctx->process_one_request(); })
-      .finally([ctx] {});
+      .then([ctx] {
+          // the client is still there, let it have the responses of the
+          // requests it sent before the connection is closed
+          if (ctx->is_shedding()) {
+              return ctx->wait_for_responses();
+          }
+          return ss::now();
+      })
+      .finally([this, ctx] { conn_balancer().connection_closed(); });
 }
 
 } // namespace kafka
@@ -11,20 +11,32 @@
 
 #pragma once
 
+#include "archival/fwd.h"
 #include "cluster/fwd.h"
 #include "config/configuration.h"
 #include "kafka/server/fetch_metadata_cache.hh"
 #include "kafka/server/fwd.h"
+#include "kafka/server/metadata_response_cache.h"
 #include "kafka/server/queue_depth_monitor.h"
+#include "kafka/server/topic_config_cache.h"
+#include "kafka/types.h"
 #include "rpc/server.h"
 #include "security/authorizer.h"
 #include "security/credential_store.h"
 #include "utils/ema.h"
 
 #include <seastar/core/future.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
 #include <seastar/core/smp.hh>
 
+#include <absl/container/node_hash_map.h>
+
+#include <chrono>
+
+#include <memory>
+
 namespace kafka {
 
 class protocol final : public rpc::server::protocol {
@@ -39,12 +51,14 @@ public:
       ss::sharded<cluster::partition_manager>&,
       ss::sharded<coordinator_ntp_mapper>& coordinator_mapper,
       ss::sharded<fetch_session_cache>&,
+      ss::sharded<connection_balancer>&,
       ss::sharded<cluster::id_allocator_frontend>&,
       ss::sharded<security::credential_store>&,
       ss::sharded<security::authorizer>&,
       ss::sharded<cluster::security_frontend>&,
       ss::sharded<cluster::controller_api>&,
       ss::sharded<cluster::tx_gateway_frontend>&,
+      ss::sharded<archival::scheduler_service>&,
       std::optional<qdc_monitor::config>) noexcept;
 
     ~protocol() noexcept override = default;
@@ -83,6 +97,9 @@ public:
         return _fetch_session_cache.local();
     }
     quota_manager& quota_mgr() { return _quota_mgr.local(); }
+    connection_balancer& conn_balancer() {
+        return _connection_balancer.local();
+    }
     bool is_idempotence_enabled() const { return _is_idempotence_enabled; }
     bool are_transactions_enabled() const { return _are_transactions_enabled; }
 
@@ -116,7 +133,39 @@ public:
         return _fetch_metadata_cache;
     }
 
+    kafka::metadata_response_cache& get_metadata_response_cache() {
+        return *_metadata_response_cache;
+    }
+
+    kafka::topic_config_cache& get_topic_config_cache() {
+        return *_topic_config_cache;
+    }
+
+    /// \brief admits a connection to the SASL handshake, the units are held
+    /// until its authentication completes or fails
+    ///
+    /// a storm of reconnections authenticates a bounded number of
+    /// connections at a time instead of interleaving all the handshakes
+    ss::future<ss::semaphore_units<>> admit_sasl_handshake();
+
+    /// Accounts the cpu time spent dispatching a request of the API
+    void record_request_cpu(api_key, std::chrono::microseconds);
+
+    /// Archival service is only started if cloud storage is enabled
+    ss::sharded<archival::scheduler_service>& archival_service() {
+        return _archival_service;
+    }
+
 private:
+    struct api_cpu_usage {
+        uint64_t requests{0};
+        uint64_t cpu_us{0};
+        ss::metrics::metric_groups metrics;
+    };
+
+    void setup_metrics();
+    void setup_api_cpu_metrics(api_key, api_cpu_usage&);
+
     ss::smp_service_group _smp_group;
     ss::sharded<cluster::topics_frontend>& _topics_frontend;
     ss::sharded<cluster::metadata_cache>& _metadata_cache;
@@ -126,6 +175,7 @@ private:
     ss::sharded<cluster::partition_manager>& _partition_manager;
     ss::sharded<kafka::coordinator_ntp_mapper>& _coordinator_mapper;
     ss::sharded<kafka::fetch_session_cache>& _fetch_session_cache;
+    ss::sharded<kafka::connection_balancer>& _connection_balancer;
     ss::sharded<cluster::id_allocator_frontend>& _id_allocator_frontend;
     bool _is_idempotence_enabled{false};
     bool _are_transactions_enabled{false};
@@ -134,8 +184,19 @@ private:
     ss::sharded<cluster::security_frontend>& _security_frontend;
     ss::sharded<cluster::controller_api>& _controller_api;
     ss::sharded<cluster::tx_gateway_frontend>& _tx_gateway_frontend;
+    ss::sharded<archival::scheduler_service>& _archival_service;
     std::optional<qdc_monitor> _qdc_mon;
     kafka::fetch_metadata_cache _fetch_metadata_cache;
+    // not movable, it is registered for the topic change notifications
+    std::unique_ptr<kafka::metadata_response_cache> _metadata_response_cache;
+    std::unique_ptr<kafka::topic_config_cache> _topic_config_cache;
+    size_t _max_sasl_handshakes;
+    ss::semaphore _sasl_handshakes;
+    uint64_t _sasl_handshakes_admitted{0};
+    uint64_t _sasl_handshakes_queued{0};
+    // registered on the first request of each api
+    absl::node_hash_map<api_key, api_cpu_usage> _api_cpu;
+    ss::metrics::metric_groups _metrics;
 };
 
 } // namespace kafka
@@ -95,7 +95,9 @@ ss::scattered_message<char> response_as_scattered(response_ptr response) {
     // NOLINTNEXTLINE
     auto* raw_header = reinterpret_cast<raw_response_header*>(
       header.get_write());
-    auto size = int32_t(sizeof(correlation) + response->buf().size_bytes());
+    auto size = int32_t(
+      sizeof(correlation) + response->buf().size_bytes()
+      + response->sections_size());
     raw_header->size = ss::cpu_to_be(size);
     raw_header->correlation = ss::cpu_to_be(correlation());
     auto& buf = response->buf();
@@ -29,6 +29,8 @@ ss::future<std::optional<request_header>> parse_header(ss::input_stream<char>&);
 size_t parse_size_buffer(ss::temporary_buffer<char>&);
 ss::future<std::optional<size_t>> parse_size(ss::input_stream<char>&);
 
+/// the frame size of the message includes the deferred sections of the
+/// response, which are written after it
 ss::scattered_message<char> response_as_scattered(response_ptr response);
 
 } // namespace kafka
@@ -10,9 +10,14 @@
 #include "kafka/server/quota_manager.h"
 
 #include "config/configuration.h"
+#include "hashing/jump_consistent_hash.h"
+#include "hashing/xx.h"
 #include "kafka/server/logger.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+
 namespace kafka {
 using clock = quota_manager::clock;
 using throttle_delay = quota_manager::throttle_delay;
@@ -21,25 +26,39 @@ quota_manager::~quota_manager() { _gc_timer.cancel(); }
 
 ss::future<> quota_manager::stop() {
     _gc_timer.cancel();
-    return ss::make_ready_future<>();
+    _balance_timer.cancel();
+    return _gate.close();
 }
 
 ss::future<> quota_manager::start() {
     _gc_timer.arm_periodic(_gc_freq);
+    // with a single shard the local rates are the node wide rates
+    if (ss::smp::count > 1) {
+        _balance_timer.arm(_balance_interval);
+    }
     return ss::make_ready_future<>();
 }
 
-// record a new observation and return <previous delay, new delay>
-throttle_delay quota_manager::record_tp_and_throttle(
-  std::optional<std::string_view> client_id,
-  uint64_t bytes,
-  clock::time_point now) {
-    // requests without a client id are grouped into an anonymous group that
-    // shares a default quota. the anonymous group is keyed on empty string.
-    auto cid = client_id ? *client_id : "";
+ss::shard_id quota_manager::home_shard(std::string_view client_id) {
+    auto hash = xxhash_64(client_id.data(), client_id.size());
+    return jump_consistent_hash(hash, ss::smp::count);
+}
 
-    // find or create the throughput tracker for this client
-    //
+uint64_t quota_manager::compute_delay_ms(
+  double rate, uint32_t target, clock::duration window) {
+    if (target == 0 || rate <= target) {
+        return 0;
+    }
+    auto diff = rate - target;
+    double delay
+      = (diff / target)
+        * (double)std::chrono::duration_cast<std::chrono::milliseconds>(window)
+            .count();
+    return static_cast<uint64_t>(delay);
+}
+
+quota_manager::quota&
+quota_manager::get_quota(std::string_view cid, clock::time_point now) {
     // c++20: heterogeneous lookup for unordered_map can avoid creation of
     // an sstring here but std::unordered_map::find isn't using an
     // equal_to<> overload. this is a general issue we'll be looking at. for
@@ -50,45 +69,81 @@ throttle_delay quota_manager::record_tp_and_throttle(
       quota{
         now,
         clock::duration(0),
+        {_default_num_windows, _default_window_width},
+        {_default_num_windows, _default_window_width},
         {_default_num_windows, _default_window_width}});
 
     // bump to prevent gc
     if (!inserted) {
         it->second.last_seen = now;
     }
+    return it->second;
+}
 
-    auto rate = it->second.tp_rate.record_and_measure(bytes, now);
-
-    uint64_t delay_ms = 0;
-    if (rate > _target_tp_rate) {
-        auto diff = rate - _target_tp_rate;
-        double delay
-          = (diff / _target_tp_rate)
-            * (double)std::chrono::duration_cast<std::chrono::milliseconds>(
-                it->second.tp_rate.window_size())
-                .count();
-        delay_ms = static_cast<uint64_t>(delay);
+// record a new observation and return <previous delay, new delay>
+throttle_delay quota_manager::record_tp_and_throttle(
+  std::optional<std::string_view> client_id,
+  uint64_t bytes,
+  clock::time_point now) {
+    // requests without a client id are grouped into an anonymous group that
+    // shares a default quota. the anonymous group is keyed on empty string.
+    auto cid = client_id ? *client_id : "";
+    auto& q = get_quota(cid, now);
+
+    // node wide rates, the rates of the other shards are as of the last
+    // balance. every call accounts for a single request, the cpu time of
+    // the request is recorded once it is handled so the cpu quota throttles
+    // the following requests.
+    auto rate = q.tp_rate.record_and_measure(bytes, now) + q.remote.tp;
+    auto req_rate = q.req_rate.record_and_measure(1, now) + q.remote.req;
+
+    uint64_t delay_ms = compute_delay_ms(
+      rate, _target_tp_rate, q.tp_rate.window_size());
+    if (_target_req_rate) {
+        delay_ms = std::max(
+          delay_ms,
+          compute_delay_ms(
+            req_rate, *_target_req_rate, q.req_rate.window_size()));
+    }
+    double cpu_rate = 0;
+    if (_target_cpu_rate) {
+        cpu_rate = q.cpu_rate.record_and_measure(0, now) + q.remote.cpu;
+        delay_ms = std::max(
+          delay_ms,
+          compute_delay_ms(
+            cpu_rate, *_target_cpu_rate, q.cpu_rate.window_size()));
     }
     if (delay_ms > (uint64_t)_max_delay.count()) {
         vlog(
           klog.info,
-          "Found data rate for window of: {} bytes. Client:{}, Estimated "
-          "backpressure delay of {}ms. Limiting to {}ms backpressure delay",
+          "Found data rate for window of: {} bytes, {} requests, {}us cpu. "
+          "Client:{}, Estimated backpressure delay of {}ms. Limiting to {}ms "
+          "backpressure delay",
           rate,
+          req_rate,
+          cpu_rate,
           cid,
           delay_ms,
           _max_delay.count());
         delay_ms = _max_delay.count();
     }
 
-    auto prev = it->second.delay;
-    it->second.delay = std::chrono::milliseconds(delay_ms);
+    auto prev = q.delay;
+    q.delay = std::chrono::milliseconds(delay_ms);
 
     throttle_delay res{};
     res.first_violation = prev.count() == 0;
-    res.duration = it->second.delay;
+    res.duration = q.delay;
     return res;
 }
+
+void quota_manager::record_cpu(
+  std::optional<std::string_view> client_id,
+  std::chrono::microseconds cpu,
+  clock::time_point now) {
+    auto& q = get_quota(client_id ? *client_id : "", now);
+    q.cpu_rate.record_and_measure(static_cast<double>(cpu.count()), now);
+}
 // erase inactive tracked quotas. windows are considered inactive if they
 // have not received any updates in ten window's worth of time.
 void quota_manager::gc(clock::duration full_window) {
@@ -99,6 +154,78 @@ void quota_manager::gc(clock::duration full_window) {
       _quotas, [now, expire_age](const std::pair<ss::sstring, quota>& q) {
           return (now - q.second.last_seen) > expire_age;
       });
+    absl::erase_if(
+      _home_quotas,
+      [now, expire_age](const std::pair<ss::sstring, home_quota>& q) {
+          return (now - q.second.last_seen) > expire_age;
+      });
+}
+
+std::vector<quota_manager::rates> quota_manager::exchange_usage(
+  ss::shard_id from,
+  const std::vector<usage>& reports,
+  clock::time_point now) {
+    std::vector<rates> ret;
+    ret.reserve(reports.size());
+    for (const auto& u : reports) {
+        auto& hq = _home_quotas[u.client_id];
+        hq.last_seen = now;
+        hq.shards.resize(ss::smp::count);
+        hq.shards[from] = u.local;
+        rates remote;
+        for (ss::shard_id s = 0; s < hq.shards.size(); ++s) {
+            if (s != from) {
+                remote.tp += hq.shards[s].tp;
+                remote.req += hq.shards[s].req;
+                remote.cpu += hq.shards[s].cpu;
+            }
+        }
+        ret.push_back(remote);
+    }
+    return ret;
+}
+
+ss::future<> quota_manager::balance() {
+    auto now = clock::now();
+    absl::flat_hash_map<ss::shard_id, std::vector<usage>> reports;
+    for (auto& [cid, q] : _quotas) {
+        reports[home_shard(cid)].push_back(usage{
+          .client_id = cid,
+          .local = rates{
+            .tp = q.tp_rate.record_and_measure(0, now),
+            .req = q.req_rate.record_and_measure(0, now),
+            .cpu = q.cpu_rate.record_and_measure(0, now),
+          }});
+    }
+    try {
+        co_await ss::parallel_for_each(reports, [this](const auto& e) {
+            // the reports outlive the call, the home shard only reads them
+            return container()
+              .invoke_on(
+                e.first,
+                [from = ss::this_shard_id(), &reports = e.second](
+                  quota_manager& qm) {
+                    return qm.exchange_usage(from, reports);
+                })
+              .then([this, &reports = e.second](std::vector<rates> remote) {
+                  for (size_t i = 0; i < remote.size(); ++i) {
+                      // the client might have been gc'ed in the meantime
+                      auto it = _quotas.find(reports[i].client_id);
+                      if (it != _quotas.end()) {
+                          it->second.remote = remote[i];
+                      }
+                  }
+              });
+        });
+    } catch (...) {
+        vlog(
+          klog.debug,
+          "Unable to exchange quota usage with other shards: {}",
+          std::current_exception());
+    }
+    if (!_gate.is_closed()) {
+        _balance_timer.arm(_balance_interval);
+    }
 }
 
 } // namespace kafka
@@ -15,7 +15,9 @@
 #include "seastarx.h"
 
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/lowres_clock.hh>
+#include <seastar/core/sharded.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/core/timer.hh>
 
@@ -24,27 +26,35 @@
 #include <chrono>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 namespace kafka {
 
 // quota_manager tracks quota usage
 //
+// the byte rate, request rate and cpu rate quotas are node wide limits of a
+// client id.
+// the connections of a client land on different shards so every shard tracks
+// the local usage of the client and periodically exchanges it with the home
+// shard of the client (chosen by hashing the client id). the home shard keeps
+// the latest rates reported by every shard and replies with the sum of the
+// rates of the other shards, the throttling delay is computed from the local
+// rate plus that remote rate. the remote rate lags behind by at most one
+// balance interval.
+//
 // TODO:
 //   - we will want to eventually add support for configuring the quotas and
 //   quota settings as runtime through the kafka api and other mechanisms.
 //
-//   - currently only total throughput per client_id is tracked. in the future
-//   we will want to support additional quotas and accouting granularities to be
-//   at parity with kafka. for example:
+//   - currently only the total throughput, requests and request cpu time
+//   per client_id are tracked. in the future we will want to support
+//   additional quotas and accouting granularities to be at parity with
+//   kafka. for example:
 //
 //      - splitting out rates separately for produce and fetch
 //      - accounting per user vs per client (these are separate in kafka)
 //
-//   - it may eventually be beneficial to periodically reduce stats across
-//   shards or track stats globally to produce a more accurate per-node
-//   representation of a statistic (e.g. bandwidth).
-//
-class quota_manager {
+class quota_manager : public ss::peering_sharded_service<quota_manager> {
 public:
     using clock = ss::lowres_clock;
 
@@ -53,14 +63,36 @@ public:
         clock::duration duration;
     };
 
+    /// Throughput (bytes per second), request rate and cpu rate (cpu
+    /// microseconds per second) of a client
+    struct rates {
+        double tp{0};
+        double req{0};
+        double cpu{0};
+    };
+
+    /// Rates of a client measured by a single shard
+    struct usage {
+        ss::sstring client_id;
+        rates local;
+    };
+
     quota_manager()
       : _default_num_windows(config::shard_local_cfg().default_num_windows())
       , _default_window_width(config::shard_local_cfg().default_window_sec())
       , _target_tp_rate(config::shard_local_cfg().target_quota_byte_rate())
+      , _target_req_rate(
+          config::shard_local_cfg().target_quota_request_rate())
+      , _target_cpu_rate(config::shard_local_cfg().target_quota_cpu_rate())
       , _gc_freq(config::shard_local_cfg().quota_manager_gc_sec())
+      , _balance_interval(
+          config::shard_local_cfg().quota_manager_balance_interval_ms())
       , _max_delay(config::shard_local_cfg().max_kafka_throttle_delay_ms()) {
         auto full_window = _default_num_windows * _default_window_width;
         _gc_timer.set_callback([this, full_window] { gc(full_window); });
+        _balance_timer.set_callback([this] {
+            (void)ss::with_gate(_gate, [this] { return balance(); });
+        });
     }
 
     quota_manager(const quota_manager&) = delete;
@@ -80,30 +112,78 @@ public:
       uint64_t bytes,
       clock::time_point now = clock::now());
 
+    /// Record the cpu time spent handling a request of the client, it
+    /// throttles the next requests of the client when the cpu quota is
+    /// exceeded
+    void record_cpu(
+      std::optional<std::string_view> client_id,
+      std::chrono::microseconds cpu,
+      clock::time_point now = clock::now());
+
+    /// Called on the home shard of the clients, stores the rates measured by
+    /// the shard and returns the sum of the rates measured by the other
+    /// shards, in the same order as the reports
+    std::vector<rates> exchange_usage(
+      ss::shard_id,
+      const std::vector<usage>&,
+      clock::time_point now = clock::now());
+
+    /// Shard that aggregates the rates of the client
+    static ss::shard_id home_shard(std::string_view client_id);
+
 private:
+    // find or create the quota of the client
+    quota& get_quota(std::string_view client_id, clock::time_point now);
+
     // erase inactive tracked quotas. windows are considered inactive if they
     // have not received any updates in ten window's worth of time.
     void gc(clock::duration full_window);
 
+    // exchange the local rates of the tracked clients with their home shards
+    // and re-arm the balance timer
+    ss::future<> balance();
+
+    // delay bringing the rate back to the target over the window
+    static uint64_t
+    compute_delay_ms(double rate, uint32_t target, clock::duration window);
+
 private:
     // last_seen: used for gc keepalive
     // delay: last calculated delay
     // tp_rate: throughput tracking
+    // req_rate: requests tracking
+    // cpu_rate: request cpu time tracking, in microseconds
+    // remote_*: rates of the other shards as of the last balance
     struct quota {
         clock::time_point last_seen;
         clock::duration delay;
         rate_tracker tp_rate;
+        rate_tracker req_rate;
+        rate_tracker cpu_rate;
+        rates remote;
+    };
+
+    // rates of a client reported by every shard, kept by its home shard
+    struct home_quota {
+        clock::time_point last_seen;
+        std::vector<rates> shards;
     };
 
     const std::size_t _default_num_windows;
     const clock::duration _default_window_width;
 
     const uint32_t _target_tp_rate;
+    const std::optional<uint32_t> _target_req_rate;
+    const std::optional<uint32_t> _target_cpu_rate;
     absl::flat_hash_map<ss::sstring, quota> _quotas;
+    absl::flat_hash_map<ss::sstring, home_quota> _home_quotas;
 
     ss::timer<> _gc_timer;
     const clock::duration _gc_freq;
+    ss::timer<> _balance_timer;
+    const clock::duration _balance_interval;
     const clock::duration _max_delay;
+    ss::gate _gate;
 };
 
 } // namespace kafka
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#include "kafka/server/read_replica_partition.h"
+
+#include "model/record_batch_reader.h"
+#include "storage/types.h"
+
+#include <seastar/core/coroutine.hh>
+
+namespace kafka {
+
+ss::future<std::optional<storage::timequery_result>>
+read_replica_partition::timequery(
+  model::timestamp ts, ss::io_priority_class io_pc) {
+    if (!_remote_partition->last_uploaded_offset()) {
+        co_return std::nullopt;
+    }
+    // the first data batch that is not older than the timestamp
+    storage::log_reader_config cfg(
+      start_offset(),
+      *_remote_partition->last_uploaded_offset(),
+      0,
+      2048,
+      io_pc,
+      model::record_batch_type::raft_data,
+      ts,
+      std::nullopt);
+    auto reader = co_await _remote_partition->make_reader(cfg);
+    auto batches = co_await model::consume_reader_to_memory(
+      std::move(reader), model::no_timeout);
+    if (batches.empty() || batches.front().header().first_timestamp < ts) {
+        co_return std::nullopt;
+    }
+    co_return storage::timequery_result(
+      batches.front().base_offset(), batches.front().header().first_timestamp);
+}
+
+} // namespace kafka
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#pragma once
+
+#include "cloud_storage/remote_partition.h"
+#include "cluster/partition.h"
+#include "cluster/partition_probe.h"
+#include "kafka/server/partition_proxy.h"
+#include "model/fundamental.h"
+#include "raft/types.h"
+
+namespace kafka {
+
+/**
+ * Partition of a read replica topic. The local log has no data, the reads
+ * are served from the bucket of the cluster that produces the topic. The
+ * offsets of the source log are exposed as they are: the configuration
+ * batches of the source log are not known to the replica, they are skipped
+ * by the reader and leave gaps in the offsets.
+ */
+class read_replica_partition final : public kafka::partition_proxy::impl {
+public:
+    read_replica_partition(
+      ss::lw_shared_ptr<cluster::partition> p,
+      ss::lw_shared_ptr<cloud_storage::remote_partition> remote) noexcept
+      : _partition(std::move(p))
+      , _remote_partition(std::move(remote)) {}
+
+    const model::ntp& ntp() const final { return _partition->ntp(); }
+
+    model::offset start_offset() const final {
+        return _remote_partition->first_uploaded_offset().value_or(
+          model::offset(0));
+    }
+
+    model::offset high_watermark() const final {
+        auto last = _remote_partition->last_uploaded_offset();
+        return last ? raft::details::next_offset(*last) : model::offset(0);
+    }
+
+    // the source cluster uploads the segments below its last stable offset
+    model::offset last_stable_offset() const final { return high_watermark(); }
+
+    ss::future<model::record_batch_reader> make_reader(
+      storage::log_reader_config cfg,
+      std::optional<model::timeout_clock::time_point>) final {
+        cfg.type_filter = {model::record_batch_type::raft_data};
+        return _remote_partition->make_reader(cfg);
+    }
+
+    ss::future<std::optional<storage::timequery_result>>
+    timequery(model::timestamp ts, ss::io_priority_class io_pc) final;
+
+    ss::future<std::vector<cluster::rm_stm::tx_range>>
+    aborted_transactions(model::offset, model::offset) final {
+        return ss::make_ready_future<std::vector<cluster::rm_stm::tx_range>>(
+          std::vector<cluster::rm_stm::tx_range>());
+    }
+
+    // the terms of the source log are not known
+    std::optional<storage::term_end_result>
+    term_end(model::term_id) const final {
+        return std::nullopt;
+    }
+
+    cluster::partition_probe& probe() final { return _partition->probe(); }
+
+private:
+    ss::lw_shared_ptr<cluster::partition> _partition;
+    ss::lw_shared_ptr<cloud_storage::remote_partition> _remote_partition;
+};
+
+} // namespace kafka
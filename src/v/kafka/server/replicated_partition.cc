@@ -21,12 +21,18 @@
 
 namespace kafka {
 replicated_partition::replicated_partition(
-  ss::lw_shared_ptr<cluster::partition> p) noexcept
+  ss::lw_shared_ptr<cluster::partition> p,
+  ss::lw_shared_ptr<cloud_storage::remote_partition> remote) noexcept
   : _partition(p)
   , _translator(
-      ss::make_lw_shared<offset_translator>(_partition->get_cfg_manager())){
+      ss::make_lw_shared<offset_translator>(_partition->get_cfg_manager()))
+  , _remote_partition(std::move(remote)) {}
+
+bool replicated_partition::is_remote_read(model::offset o) const {
+    return _remote_partition && o < _partition->start_offset()
+           && _remote_partition->is_data_available(o);
+}
 
-    };
 // TODO: use previous translation speed up lookup
 ss::future<model::record_batch_reader> replicated_partition::make_reader(
   storage::log_reader_config cfg,
@@ -81,7 +87,10 @@ ss::future<model::record_batch_reader> replicated_partition::make_reader(
         ss::lw_shared_ptr<offset_translator> _translator;
     };
     auto tr = _translator;
-    auto rdr = co_await _partition->make_reader(cfg, deadline);
+    auto f = is_remote_read(cfg.start_offset)
+               ? _remote_partition->make_reader(cfg)
+               : _partition->make_reader(cfg, deadline);
+    auto rdr = co_await std::move(f);
     co_return model::make_record_batch_reader<reader>(
       std::move(rdr).release(), std::move(tr));
 }
@@ -10,6 +10,7 @@
  */
 #pragma once
 
+#include "cloud_storage/remote_partition.h"
 #include "cluster/partition.h"
 #include "cluster/partition_probe.h"
 #include "kafka/server/offset_translator.h"
@@ -27,19 +28,38 @@ namespace kafka {
 class replicated_partition final : public kafka::partition_proxy::impl {
 public:
     explicit replicated_partition(
-      ss::lw_shared_ptr<cluster::partition> p) noexcept;
+      ss::lw_shared_ptr<cluster::partition> p,
+      ss::lw_shared_ptr<cloud_storage::remote_partition> remote
+      = nullptr) noexcept;
 
     const model::ntp& ntp() const final { return _partition->ntp(); }
 
     model::offset start_offset() const final {
-        return _translator->to_kafka_offset(_partition->start_offset());
+        auto local = _partition->start_offset();
+        if (_remote_partition) {
+            // data below the local start offset can be served from S3
+            if (auto remote = _remote_partition->first_uploaded_offset();
+                remote && *remote < local) {
+                local = *remote;
+            }
+        }
+        return _translator->to_kafka_offset(local);
     }
 
     model::offset high_watermark() const final {
+        if (!_partition->is_leader()) {
+            return _translator->to_kafka_offset(
+              _partition->follower_high_watermark());
+        }
         return _translator->to_kafka_offset(_partition->high_watermark());
     }
 
     model::offset last_stable_offset() const final {
+        if (!_partition->is_leader()) {
+            return _translator->to_kafka_offset(std::min(
+              _partition->last_stable_offset(),
+              _partition->follower_high_watermark()));
+        }
         return _translator->to_kafka_offset(_partition->last_stable_offset());
     }
 
@@ -76,11 +96,25 @@ public:
         co_return target;
     }
 
+    std::optional<storage::term_end_result>
+    term_end(model::term_id t) const final {
+        auto ret = _partition->term_end(t);
+        if (ret) {
+            ret->end_offset = _translator->to_kafka_offset(ret->end_offset);
+        }
+        return ret;
+    }
+
     cluster::partition_probe& probe() final { return _partition->probe(); }
 
 private:
+    /// Return true if the read that starts from the log offset should be
+    /// served from the remote partition
+    bool is_remote_read(model::offset) const;
+
     ss::lw_shared_ptr<cluster::partition> _partition;
     ss::lw_shared_ptr<offset_translator> _translator;
+    ss::lw_shared_ptr<cloud_storage::remote_partition> _remote_partition;
 };
 
 } // namespace kafka
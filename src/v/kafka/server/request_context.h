@@ -124,6 +124,10 @@ public:
         return _conn->server().partition_manager();
     }
 
+    ss::sharded<archival::scheduler_service>& archival_service() {
+        return _conn->server().archival_service();
+    }
+
     fetch_session_cache& fetch_sessions() {
         return _conn->server().fetch_sessions_cache();
     }
@@ -132,6 +136,14 @@ public:
         return _conn->server().get_fetch_metadata_cache();
     }
 
+    metadata_response_cache& get_metadata_response_cache() {
+        return _conn->server().get_metadata_response_cache();
+    }
+
+    topic_config_cache& get_topic_config_cache() {
+        return _conn->server().get_topic_config_cache();
+    }
+
     // clang-format off
     template<typename ResponseType>
     CONCEPT(requires requires (
@@ -186,6 +198,13 @@ private:
 // Executes the API call identified by the specified request_context.
 process_result_stages process_request(request_context&&, ss::smp_service_group);
 
+/// \brief memory reserved for a request of the API before it is read
+size_t memory_estimate(api_key, size_t request_size, connection_context&);
+
 bool track_latency(api_key);
 
+/// \brief measurement of the request in the node wide latency summary, null
+/// if the request isn't part of it
+std::unique_ptr<hdr_hist::measurement> measure_summary_latency(api_key);
+
 } // namespace kafka
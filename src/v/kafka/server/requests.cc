@@ -11,6 +11,7 @@
 #include "kafka/server/handlers/produce.h"
 #include "kafka/server/request_context.h"
 #include "kafka/types.h"
+#include "utils/latency_summary.h"
 #include "utils/to_string.h"
 #include "vlog.h"
 
@@ -92,6 +93,9 @@ process_result_stages
 /*
  * process a handshake request. if it doesn't result in a sasl mechanism being
  * selected then client negotiation failed. otherwise, move to authentication.
+ *
+ * the handshake waits for its turn in the sasl handshake limiter of the shard,
+ * the connection holds its unit until the authentication completes or fails.
  */
 static ss::future<response_ptr>
 handle_auth_handshake(request_context&& ctx, ss::smp_service_group g) {
@@ -104,13 +108,24 @@ handle_auth_handshake(request_context&& ctx, ss::smp_service_group g) {
          */
         conn->sasl().set_handshake_v0();
     }
-    return do_process<sasl_handshake_handler>(std::move(ctx), g)
-      .response.then([conn = std::move(conn)](response_ptr r) {
+    auto admitted = conn->in_sasl_handshake()
+                      ? ss::now()
+                      : conn->server().admit_sasl_handshake().then(
+                        [conn](ss::semaphore_units<> units) {
+                            conn->hold_sasl_handshake(std::move(units));
+                        });
+    return admitted
+      .then([ctx = std::move(ctx), g]() mutable {
+          return do_process<sasl_handshake_handler>(std::move(ctx), g)
+            .response;
+      })
+      .then([conn = std::move(conn)](response_ptr r) {
           if (conn->sasl().has_mechanism()) {
               conn->sasl().set_state(
                 security::sasl_server::sasl_state::authenticate);
           } else {
               conn->sasl().set_state(security::sasl_server::sasl_state::failed);
+              conn->release_sasl_handshake();
           }
           return r;
       });
@@ -174,9 +189,11 @@ handle_auth(request_context&& ctx, ss::smp_service_group g) {
               if (conn->sasl().mechanism().complete()) {
                   conn->sasl().set_state(
                     security::sasl_server::sasl_state::complete);
+                  conn->release_sasl_handshake();
               } else if (conn->sasl().mechanism().failed()) {
                   conn->sasl().set_state(
                     security::sasl_server::sasl_state::failed);
+                  conn->release_sasl_handshake();
               }
               return ss::make_ready_future<response_ptr>(std::move(r));
           });
@@ -225,6 +242,32 @@ bool track_latency(api_key key) {
     }
 }
 
+std::unique_ptr<hdr_hist::measurement> measure_summary_latency(api_key key) {
+    using op = latency_summary::op;
+    switch (key) {
+    case produce_handler::api::key:
+        return latency_summary::histogram(op::produce).auto_measure();
+    case fetch_handler::api::key:
+        return latency_summary::histogram(op::fetch).auto_measure();
+    default:
+        return nullptr;
+    }
+}
+
+size_t
+memory_estimate(api_key key, size_t request_size, connection_context& conn) {
+    switch (key) {
+    case produce_handler::api::key:
+        return produce_handler::memory_estimate(request_size, conn);
+    case fetch_handler::api::key:
+        return fetch_handler::memory_estimate(request_size, conn);
+    case metadata_handler::api::key:
+        return metadata_handler::memory_estimate(request_size, conn);
+    default:
+        return default_memory_estimate(request_size, conn);
+    }
+}
+
 process_result_stages
 process_request(request_context&& ctx, ss::smp_service_group g) {
     /*
@@ -314,6 +357,8 @@ process_request(request_context&& ctx, ss::smp_service_group g) {
         return do_process<add_offsets_to_txn_handler>(std::move(ctx), g);
     case end_txn_handler::api::key:
         return do_process<end_txn_handler>(std::move(ctx), g);
+    case offset_for_leader_epoch_handler::api::key:
+        return do_process<offset_for_leader_epoch_handler>(std::move(ctx), g);
     };
     throw std::runtime_error(
       fmt::format("Unsupported API {}", ctx.header().key));
@@ -17,9 +17,13 @@
 #include "seastarx.h"
 
 #include <seastar/core/future.hh>
+#include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 #include <memory>
+#include <optional>
+#include <utility>
 
 namespace kafka {
 
@@ -46,8 +50,39 @@ public:
     bool is_noop() const { return _noop; }
     void mark_noop() { _noop = true; }
 
+    /*
+     * Memory of the connection reserved for the response by its handler, on
+     * top of the reservation of the request. It is held until the response
+     * is written.
+     */
+    void hold_memory(ss::semaphore_units<> units) {
+        _memory_units = std::move(units);
+    }
+    ss::semaphore_units<> release_memory() { return std::move(_memory_units); }
+
+    /*
+     * Sections of the response that follow the buffer on the wire. They are
+     * encoded one at a time, each one when the connection is ready to write
+     * it, so only their total size, which is part of the frame size, has to
+     * be known up front. The encoder returns std::nullopt once all sections
+     * are encoded.
+     */
+    using section_encoder = ss::noncopyable_function<std::optional<iobuf>()>;
+
+    void defer_sections(size_t size, section_encoder next) {
+        _sections_size = size;
+        _next_section = std::move(next);
+    }
+    size_t sections_size() const { return _sections_size; }
+    std::optional<section_encoder> release_sections() {
+        return std::exchange(_next_section, std::nullopt);
+    }
+
 private:
     bool _noop{false};
+    size_t _sections_size{0};
+    std::optional<section_encoder> _next_section;
+    ss::semaphore_units<> _memory_units;
     correlation_id _correlation;
     iobuf _buf;
     response_writer _writer;
@@ -0,0 +1,113 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/slow_request_log.h"
+
+#include "config/configuration.h"
+
+#include <seastar/core/future-util.hh>
+#include <seastar/core/smp.hh>
+
+#include <boost/range/irange.hpp>
+
+#include <algorithm>
+
+namespace kafka {
+
+namespace {
+bool slower(
+  const slow_request_log::entry& a, const slow_request_log::entry& b) {
+    return a.total() > b.total();
+}
+
+struct windows {
+    // min heaps on the total, the fastest kept entry first
+    std::vector<slow_request_log::entry> current;
+    std::vector<slow_request_log::entry> previous;
+    slow_request_log::clock_type::time_point started;
+
+    void roll() {
+        const auto now = slow_request_log::clock_type::now();
+        const auto window
+          = config::shard_local_cfg().kafka_slow_request_log_window_ms();
+        if (now - started < window) {
+            return;
+        }
+        // a window without a request in between drops both
+        previous = now - started < 2 * window ? std::move(current)
+                                              : decltype(current){};
+        current.clear();
+        started = now;
+    }
+};
+
+windows& shard_windows() {
+    static thread_local windows w;
+    return w;
+}
+} // namespace
+
+bool slow_request_log::admits(std::chrono::microseconds total) {
+    const auto size = config::shard_local_cfg().kafka_slow_request_log_size();
+    if (size == 0) {
+        return false;
+    }
+    auto& w = shard_windows();
+    w.roll();
+    return w.current.size() < size || w.current.front().total() < total;
+}
+
+void slow_request_log::record(entry e) {
+    if (!admits(e.total())) {
+        return;
+    }
+    const auto size = config::shard_local_cfg().kafka_slow_request_log_size();
+    auto& current = shard_windows().current;
+    e.shard = ss::this_shard_id();
+    // the size may have been lowered since the last entry
+    while (current.size() >= size) {
+        std::pop_heap(current.begin(), current.end(), slower);
+        current.pop_back();
+    }
+    current.push_back(std::move(e));
+    std::push_heap(current.begin(), current.end(), slower);
+}
+
+std::vector<slow_request_log::entry> slow_request_log::entries() {
+    auto& w = shard_windows();
+    w.roll();
+    std::vector<entry> ret;
+    ret.reserve(w.current.size() + w.previous.size());
+    ret.insert(ret.end(), w.current.begin(), w.current.end());
+    ret.insert(ret.end(), w.previous.begin(), w.previous.end());
+    std::sort(ret.begin(), ret.end(), slower);
+    return ret;
+}
+
+ss::future<std::vector<slow_request_log::entry>> slow_request_log::collect() {
+    return ss::map_reduce(
+             boost::irange<ss::shard_id>(0, ss::smp::count),
+             [](ss::shard_id shard) {
+                 return ss::smp::submit_to(shard, [] { return entries(); });
+             },
+             std::vector<entry>{},
+             [](std::vector<entry> acc, std::vector<entry> entries) {
+                 std::move(
+                   entries.begin(), entries.end(), std::back_inserter(acc));
+                 return acc;
+             })
+      .then([](std::vector<entry> ret) {
+          std::sort(ret.begin(), ret.end(), slower);
+          return ret;
+      });
+}
+
+void slow_request_log::reset() { shard_windows() = windows{}; }
+
+} // namespace kafka
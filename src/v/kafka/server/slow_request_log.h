@@ -0,0 +1,91 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "kafka/types.h"
+#include "model/fundamental.h"
+#include "model/timestamp.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sstring.hh>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace kafka {
+
+/**
+ * Per shard log of the slowest kafka requests, for the admin API.
+ *
+ * Each shard keeps the kafka_slow_request_log_size slowest requests of the
+ * current window and of the previous one, with the time spent in each stage
+ * of the request: a latency outlier is attributed to a client, to the
+ * partitions of the request and to the stage that was slow, without enabling
+ * the trace logs.
+ *
+ * Most requests are faster than the slowest ones kept: admits() is checked
+ * before an entry is built, the requests that don't make it in cost a
+ * comparison.
+ */
+class slow_request_log {
+public:
+    using clock_type = ss::steady_clock_type;
+    /// partitions named in an entry, the others are only counted
+    static constexpr size_t max_partitions = 8;
+
+    struct entry {
+        api_key key;
+        api_version version;
+        ss::sstring client_id;
+        /// when the request was read
+        model::timestamp received;
+        size_t request_bytes{0};
+        size_t response_bytes{0};
+        size_t partition_count{0};
+        std::vector<model::topic_partition> partitions;
+        /// quota throttling delay applied before the request is read
+        std::chrono::microseconds throttle{0};
+        /// wait for the memory and the queue depth units
+        std::chrono::microseconds queue{0};
+        /// read of the request body and first stage of the handler
+        std::chrono::microseconds dispatch{0};
+        /// until the response is ready, the storage and raft work
+        std::chrono::microseconds process{0};
+        /// wait for the responses of the previous requests and write
+        std::chrono::microseconds write{0};
+        ss::shard_id shard{0};
+
+        std::chrono::microseconds total() const {
+            return throttle + queue + dispatch + process + write;
+        }
+    };
+
+    /// \brief whether a request of this duration is one of the slowest of
+    /// the window of the shard
+    static bool admits(std::chrono::microseconds total);
+
+    /// \brief keeps the entry if it is one of the slowest of the window
+    static void record(entry);
+
+    /// \brief entries of the shard, slowest first
+    static std::vector<entry> entries();
+
+    /// \brief entries of all the shards, slowest first
+    static ss::future<std::vector<entry>> collect();
+
+    /// \brief empties the log of the shard
+    static void reset();
+};
+
+} // namespace kafka
@@ -0,0 +1,45 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/connection_balancer.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using counts = std::vector<uint32_t>;
+
+BOOST_AUTO_TEST_CASE(balanced_shards_keep_their_connections) {
+    using kafka::connection_balancer;
+    BOOST_REQUIRE(connection_balancer::plan({}, 0).empty());
+    BOOST_REQUIRE(
+      connection_balancer::plan(counts{10, 10, 10, 10}, 0)
+      == counts({0, 0, 0, 0}));
+    // uneven totals can't be balanced any better
+    BOOST_REQUIRE(
+      connection_balancer::plan(counts{11, 10, 10, 10}, 0)
+      == counts({0, 0, 0, 0}));
+    // within the tolerance
+    BOOST_REQUIRE(
+      connection_balancer::plan(counts{12, 8, 10, 10}, 2)
+      == counts({0, 0, 0, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(overloaded_shards_shed_down_to_the_mean) {
+    using kafka::connection_balancer;
+    BOOST_REQUIRE(
+      connection_balancer::plan(counts{20, 4, 6, 10}, 2)
+      == counts({10, 0, 0, 0}));
+    // the mean is rounded up
+    BOOST_REQUIRE(
+      connection_balancer::plan(counts{9, 0, 0}, 0) == counts({6, 0, 0}));
+    BOOST_REQUIRE(
+      connection_balancer::plan(counts{7, 7, 0, 0}, 1)
+      == counts({3, 3, 0, 0}));
+}
@@ -221,3 +221,79 @@ FIXTURE_TEST(test_session_operations, fixture) {
         BOOST_REQUIRE(cache.size() == 0);
     }
 }
+
+namespace {
+
+kafka::fetch_request make_full_fetch_request(int partitions) {
+    kafka::fetch_request req;
+    req.data.session_epoch = kafka::initial_fetch_session_epoch;
+    req.data.session_id = kafka::invalid_fetch_session_id;
+    req.data.topics = {
+      fixture::make_fetch_request_topic(model::topic("test"), partitions)};
+    return req;
+}
+
+// budget of the cache that fits a single session with given number of
+// partitions
+size_t single_session_budget(int partitions) {
+    kafka::fetch_session session(kafka::fetch_session_id(1));
+    for (int i = 0; i < partitions; ++i) {
+        session.partitions().emplace(fixture::make_fetch_partition(
+          model::topic("test"), model::partition_id(i), model::offset(0)));
+    }
+    return session.mem_usage() * 3 / 2;
+}
+
+} // namespace
+
+FIXTURE_TEST(test_session_cache_evicts_idle_sessions, fixture) {
+    // every session is idle right away
+    kafka::fetch_session_cache cache(0ms, single_session_budget(20));
+    auto req = make_full_fetch_request(20);
+
+    kafka::fetch_session_id first;
+    {
+        auto ctx = cache.maybe_get_session(req);
+        BOOST_REQUIRE(!ctx.is_sessionless());
+        first = ctx.session()->id();
+    }
+    {
+        auto ctx = cache.maybe_get_session(req);
+        BOOST_REQUIRE(!ctx.is_sessionless());
+        BOOST_REQUIRE_NE(ctx.session()->id(), first);
+        BOOST_REQUIRE(cache.contains(ctx.session()->id()));
+    }
+    BOOST_REQUIRE_EQUAL(cache.size(), 1);
+    BOOST_REQUIRE(!cache.contains(first));
+}
+
+FIXTURE_TEST(test_session_cache_protects_active_sessions, fixture) {
+    kafka::fetch_session_cache cache(120s, single_session_budget(20));
+    auto req = make_full_fetch_request(20);
+
+    kafka::fetch_session_id first;
+    {
+        auto ctx = cache.maybe_get_session(req);
+        BOOST_REQUIRE(!ctx.is_sessionless());
+        first = ctx.session()->id();
+    }
+    // recently created session is not evicted, the new one is sessionless
+    auto ctx = cache.maybe_get_session(req);
+    BOOST_REQUIRE(ctx.is_sessionless());
+    BOOST_REQUIRE(!ctx.has_error());
+    BOOST_REQUIRE_EQUAL(cache.size(), 1);
+    BOOST_REQUIRE(cache.contains(first));
+}
+
+FIXTURE_TEST(test_session_cache_does_not_evict_sessions_in_use, fixture) {
+    kafka::fetch_session_cache cache(0ms, single_session_budget(20));
+    auto req = make_full_fetch_request(20);
+
+    auto in_use = cache.maybe_get_session(req);
+    BOOST_REQUIRE(!in_use.is_sessionless());
+
+    auto ctx = cache.maybe_get_session(req);
+    BOOST_REQUIRE(ctx.is_sessionless());
+    BOOST_REQUIRE_EQUAL(cache.size(), 1);
+    BOOST_REQUIRE(cache.contains(in_use.session()->id()));
+}
@@ -9,12 +9,16 @@
 
 #include "kafka/protocol/batch_consumer.h"
 #include "kafka/server/handlers/fetch.h"
+#include "kafka/server/partition_proxy.h"
 #include "kafka/types.h"
 #include "model/fundamental.h"
+#include "model/limits.h"
 #include "redpanda/tests/fixture.h"
 #include "resource_mgmt/io_priority.h"
+#include "storage/tests/utils/random_batch.h"
 #include "test_utils/async.h"
 
+#include <seastar/core/shared_future.hh>
 #include <seastar/core/smp.hh>
 
 #include <chrono>
@@ -504,6 +508,102 @@ FIXTURE_TEST(fetch_one_debounce, redpanda_thread_fixture) {
     BOOST_REQUIRE(resp.data.topics[0].partitions[0].records->size_bytes() > 0);
 }
 
+FIXTURE_TEST(fetch_long_poll_wakes_up_on_produce, redpanda_thread_fixture) {
+    model::topic topic("foo");
+    model::partition_id pid(0);
+    auto ntp = make_default_ntp(topic, pid);
+
+    wait_for_controller_leadership().get0();
+    add_topic(model::topic_namespace_view(ntp)).get();
+    wait_for_partition_offset(ntp, model::offset(0)).get0();
+
+    kafka::fetch_request req;
+    req.data.max_bytes = std::numeric_limits<int32_t>::max();
+    req.data.min_bytes = 1;
+    req.data.max_wait_ms = 30s;
+    req.data.session_id = kafka::invalid_fetch_session_id;
+    req.data.topics = {{
+      .name = topic,
+      .fetch_partitions = {{
+        .partition_index = pid,
+        .fetch_offset = model::offset(0),
+      }},
+    }};
+
+    auto client = make_kafka_client().get0();
+    client.connect().get();
+    const auto start = ss::lowres_clock::now();
+    auto fresp = client.dispatch(req, kafka::api_version(4));
+    // the fetch is parked waiting for data
+    ss::sleep(500ms).get();
+    BOOST_REQUIRE(!fresp.available());
+
+    auto shard = app.shard_table.local().shard_for(ntp);
+    app.partition_manager
+      .invoke_on(
+        *shard,
+        [ntp](cluster::partition_manager& mgr) {
+            auto batches = storage::test::make_random_batches(
+              model::offset(0), 5);
+            return mgr.get(ntp)->replicate(
+              model::make_memory_record_batch_reader(std::move(batches)),
+              raft::replicate_options(raft::consistency_level::quorum_ack));
+        })
+      .get();
+
+    auto resp = fresp.get0();
+    const auto elapsed = ss::lowres_clock::now() - start;
+    client.stop().then([&client] { client.shutdown(); }).get();
+
+    // woken up by the produce, way before max_wait
+    BOOST_REQUIRE(elapsed < 10s);
+    BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+    BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+    const auto& p = resp.data.topics[0].partitions[0];
+    BOOST_REQUIRE(p.error_code == kafka::error_code::none);
+    BOOST_REQUIRE(p.records);
+    BOOST_REQUIRE_GT(p.records->size_bytes(), 0);
+}
+
+FIXTURE_TEST(fetch_long_poll_respects_max_wait, redpanda_thread_fixture) {
+    model::topic topic("foo");
+    model::partition_id pid(0);
+    auto ntp = make_default_ntp(topic, pid);
+
+    wait_for_controller_leadership().get0();
+    add_topic(model::topic_namespace_view(ntp)).get();
+    wait_for_partition_offset(ntp, model::offset(0)).get0();
+
+    kafka::fetch_request req;
+    req.data.max_bytes = std::numeric_limits<int32_t>::max();
+    req.data.min_bytes = 1;
+    req.data.max_wait_ms = 1s;
+    req.data.session_id = kafka::invalid_fetch_session_id;
+    req.data.topics = {{
+      .name = topic,
+      .fetch_partitions = {{
+        .partition_index = pid,
+        .fetch_offset = model::offset(0),
+      }},
+    }};
+
+    auto client = make_kafka_client().get0();
+    client.connect().get();
+    const auto start = ss::lowres_clock::now();
+    auto resp = client.dispatch(req, kafka::api_version(4)).get0();
+    const auto elapsed = ss::lowres_clock::now() - start;
+    client.stop().then([&client] { client.shutdown(); }).get();
+
+    // nothing was produced, the fetch returns empty at the deadline
+    BOOST_REQUIRE(elapsed >= 900ms);
+    BOOST_REQUIRE(elapsed < 10s);
+    BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+    BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+    const auto& p = resp.data.topics[0].partitions[0];
+    BOOST_REQUIRE(p.error_code == kafka::error_code::none);
+    BOOST_REQUIRE(!p.records || p.records->size_bytes() == 0);
+}
+
 FIXTURE_TEST(fetch_multi_topics, redpanda_thread_fixture) {
     // create a topic partition with some data
     model::topic topic_1("foo");
@@ -660,3 +760,279 @@ FIXTURE_TEST(fetch_request_max_bytes, redpanda_thread_fixture) {
     BOOST_REQUIRE(
       fetch_one_byte.data.topics[0].partitions[0].records->size_bytes() > 0);
 }
+
+SEASTAR_THREAD_TEST_CASE(fetch_budget_allocation) {
+    using budget = kafka::partition_fetch_budget;
+    {
+        // everything fits, every partition gets what it asked for
+        std::vector<budget> b{
+          {.shard = 0, .max_bytes = 100, .estimated_bytes = 100},
+          {.shard = 1, .max_bytes = 100, .estimated_bytes = 100},
+        };
+        kafka::allocate_fetch_budget(b, 1000);
+        BOOST_REQUIRE_EQUAL(b[0].allocated_bytes, 100);
+        BOOST_REQUIRE_EQUAL(b[1].allocated_bytes, 100);
+    }
+    {
+        // shards receive budget proportional to the expected data
+        std::vector<budget> b{
+          {.shard = 0, .max_bytes = 300, .estimated_bytes = 300},
+          {.shard = 1, .max_bytes = 100, .estimated_bytes = 100},
+        };
+        kafka::allocate_fetch_budget(b, 200);
+        BOOST_REQUIRE_EQUAL(b[0].allocated_bytes, 150);
+        BOOST_REQUIRE_EQUAL(b[1].allocated_bytes, 50);
+    }
+    {
+        // inside of the shard budget the request order is preserved
+        std::vector<budget> b{
+          {.shard = 0, .max_bytes = 100, .estimated_bytes = 100},
+          {.shard = 0, .max_bytes = 100, .estimated_bytes = 100},
+        };
+        kafka::allocate_fetch_budget(b, 150);
+        BOOST_REQUIRE_EQUAL(b[0].allocated_bytes, 100);
+        BOOST_REQUIRE_EQUAL(b[1].allocated_bytes, 50);
+    }
+    {
+        // caught up partitions receive the leftovers in priority order
+        std::vector<budget> b{
+          {.shard = 0, .max_bytes = 100, .estimated_bytes = 0},
+          {.shard = 1, .max_bytes = 100, .estimated_bytes = 50},
+          {.shard = 0, .max_bytes = 100, .estimated_bytes = 0},
+        };
+        kafka::allocate_fetch_budget(b, 200);
+        BOOST_REQUIRE_EQUAL(b[0].allocated_bytes, 100);
+        BOOST_REQUIRE_EQUAL(b[1].allocated_bytes, 100);
+        BOOST_REQUIRE_EQUAL(b[2].allocated_bytes, 0);
+    }
+    {
+        // no budget, all the reads are skipped
+        std::vector<budget> b{
+          {.shard = 0, .max_bytes = 100, .estimated_bytes = 100},
+        };
+        kafka::allocate_fetch_budget(b, 0);
+        BOOST_REQUIRE_EQUAL(b[0].allocated_bytes, 0);
+    }
+}
+
+namespace {
+
+struct noop_probe final : cluster::partition_probe::impl {
+    void add_records_produced(uint64_t) final {}
+    void add_records_fetched(uint64_t) final {}
+    void add_bytes_produced(uint64_t) final {}
+    void add_bytes_fetched(uint64_t) final {}
+    cluster::partition_load load() const final { return {}; }
+    void setup_metrics(const model::ntp&) final {}
+};
+
+/// The reads of the partition wait until they are released, so that the
+/// fetches of a test run concurrently
+struct gated_partition_state {
+    model::ntp ntp{model::kafka_namespace, model::topic("t"), 0};
+    ss::circular_buffer<model::record_batch> batches
+      = storage::test::make_random_batches(model::offset(0), 5, false);
+    ss::shared_promise<> release;
+    size_t reads{0};
+    bool fail{false};
+    cluster::partition_probe probe{std::make_unique<noop_probe>()};
+};
+
+struct gated_partition final : kafka::partition_proxy::impl {
+    explicit gated_partition(ss::lw_shared_ptr<gated_partition_state> st)
+      : _st(std::move(st)) {}
+
+    const model::ntp& ntp() const final { return _st->ntp; }
+    model::offset start_offset() const final { return model::offset(0); }
+    model::offset high_watermark() const final {
+        return _st->batches.back().last_offset() + model::offset(1);
+    }
+    model::offset last_stable_offset() const final {
+        return high_watermark();
+    }
+    ss::future<model::record_batch_reader> make_reader(
+      storage::log_reader_config,
+      std::optional<model::timeout_clock::time_point>) final {
+        ++_st->reads;
+        return _st->release.get_shared_future().then([st = _st] {
+            if (st->fail) {
+                return ss::make_exception_future<model::record_batch_reader>(
+                  std::runtime_error("read failed"));
+            }
+            ss::circular_buffer<model::record_batch> copy;
+            for (const auto& b : st->batches) {
+                copy.push_back(b.copy());
+            }
+            return ss::make_ready_future<model::record_batch_reader>(
+              model::make_memory_record_batch_reader(std::move(copy)));
+        });
+    }
+    ss::future<std::optional<storage::timequery_result>>
+    timequery(model::timestamp, ss::io_priority_class) final {
+        return ss::make_ready_future<std::optional<storage::timequery_result>>(
+          std::nullopt);
+    }
+    ss::future<std::vector<cluster::rm_stm::tx_range>>
+    aborted_transactions(model::offset, model::offset) final {
+        return ss::make_ready_future<std::vector<cluster::rm_stm::tx_range>>();
+    }
+    std::optional<storage::term_end_result>
+    term_end(model::term_id) const final {
+        return std::nullopt;
+    }
+    cluster::partition_probe& probe() final { return _st->probe; }
+
+private:
+    ss::lw_shared_ptr<gated_partition_state> _st;
+};
+
+kafka::fetch_config range_fetch_config() {
+    return kafka::fetch_config{
+      .start_offset = model::offset(0),
+      .max_offset = model::model_limits<model::offset>::max(),
+      .isolation_level = model::isolation_level::read_uncommitted,
+      .max_bytes = std::numeric_limits<int32_t>::max(),
+      .timeout = model::no_timeout,
+    };
+}
+
+std::vector<ss::future<kafka::read_result>> read_concurrently(
+  const ss::lw_shared_ptr<gated_partition_state>& st,
+  std::vector<std::optional<model::timeout_clock::time_point>> deadlines) {
+    std::vector<ss::future<kafka::read_result>> reads;
+    for (auto d : deadlines) {
+        reads.push_back(kafka::read_from_partition(
+          kafka::make_partition_proxy<gated_partition>(st),
+          range_fetch_config(),
+          false,
+          d));
+    }
+    return reads;
+}
+
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(concurrent_fetches_share_one_read) {
+    auto st = ss::make_lw_shared<gated_partition_state>();
+    auto reads = read_concurrently(st, {std::nullopt, std::nullopt});
+    st->release.set_value();
+    auto results = ss::when_all_succeed(reads.begin(), reads.end()).get0();
+
+    BOOST_REQUIRE_EQUAL(st->reads, 1);
+    BOOST_REQUIRE_EQUAL(results.size(), 2);
+    BOOST_REQUIRE(results[0].error == kafka::error_code::none);
+    BOOST_REQUIRE(results[1].error == kafka::error_code::none);
+    BOOST_REQUIRE_GT(results[0].data_size_bytes(), 0);
+    BOOST_REQUIRE_EQUAL(results[0].get_data(), results[1].get_data());
+
+    // each fetch owns its result, releasing one leaves the other intact
+    auto expected = results[1].get_data().copy();
+    auto first = std::move(results[0]).release_data();
+    first.trim_front(first.size_bytes() / 2);
+    BOOST_REQUIRE_EQUAL(results[1].get_data(), expected);
+}
+
+SEASTAR_THREAD_TEST_CASE(fetch_with_earlier_deadline_reads_on_its_own) {
+    auto st = ss::make_lw_shared<gated_partition_state>();
+    const auto now = model::timeout_clock::now();
+    auto reads = read_concurrently(st, {now + 10min, now + 1min, now + 20min});
+    st->release.set_value();
+    auto results = ss::when_all_succeed(reads.begin(), reads.end()).get0();
+
+    // the fetch with the earlier deadline doesn't join the first read, the
+    // one with the later deadline does
+    BOOST_REQUIRE_EQUAL(st->reads, 2);
+    for (auto& r : results) {
+        BOOST_REQUIRE_EQUAL(r.get_data(), results[0].get_data());
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(shared_read_error_reaches_every_fetch) {
+    auto st = ss::make_lw_shared<gated_partition_state>();
+    st->fail = true;
+    auto reads = read_concurrently(st, {std::nullopt, std::nullopt});
+    st->release.set_value();
+    for (auto& r : reads) {
+        BOOST_REQUIRE_THROW(r.get(), std::runtime_error);
+    }
+    BOOST_REQUIRE_EQUAL(st->reads, 1);
+
+    // the failed read isn't shared anymore
+    st->fail = false;
+    auto retry = read_concurrently(st, {std::nullopt});
+    auto r = retry[0].get0();
+    BOOST_REQUIRE_GT(r.data_size_bytes(), 0);
+    BOOST_REQUIRE_EQUAL(st->reads, 2);
+}
+
+namespace {
+
+kafka::fetch_response make_sectioned_response() {
+    kafka::fetch_response response;
+    response.data.throttle_time_ms = std::chrono::milliseconds(10);
+    response.data.session_id = 7;
+
+    auto records = [](size_t size) {
+        iobuf buf;
+        buf.append(ss::sstring(size, 'r').data(), size);
+        return kafka::batch_reader(std::move(buf));
+    };
+
+    kafka::fetchable_topic_response tp{.name = model::topic("tp-1")};
+    tp.partitions.push_back(kafka::fetch_response::partition_response{
+      .partition_index = model::partition_id(0),
+      .high_watermark = model::offset(100),
+      .last_stable_offset = model::offset(90),
+      .log_start_offset = model::offset(5),
+      .aborted = std::vector<kafka::fetch_response::aborted_transaction>{
+        {.producer_id = kafka::producer_id(1), .first_offset = 91},
+        {.producer_id = kafka::producer_id(2), .first_offset = 95}},
+      .preferred_read_replica = model::node_id(2),
+      .records = records(64 * 1024)});
+    tp.partitions.push_back(kafka::fetch_response::partition_response{
+      .partition_index = model::partition_id(3),
+      .error_code = kafka::error_code::not_leader_for_partition});
+    response.data.topics.push_back(std::move(tp));
+    // a topic without partitions is encoded as a section of its own
+    response.data.topics.push_back(
+      kafka::fetchable_topic_response{.name = model::topic("tp-2")});
+    kafka::fetchable_topic_response other{.name = model::topic("tp-3")};
+    other.partitions.push_back(kafka::fetch_response::partition_response{
+      .partition_index = model::partition_id(1),
+      .high_watermark = model::offset(1),
+      .records = records(10)});
+    response.data.topics.push_back(std::move(other));
+    return response;
+}
+
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(fetch_response_sections_match_response_encoding) {
+    for (auto v : {0, 1, 4, 5, 7, 11}) {
+        const auto version = kafka::api_version(v);
+        iobuf expected;
+        kafka::response_writer expected_writer(expected);
+        make_sectioned_response().encode(expected_writer, version);
+
+        kafka::fetch_response_sections sections(
+          make_sectioned_response(), version);
+        iobuf head;
+        kafka::response_writer head_writer(head);
+        sections.encode_head(head_writer);
+        const auto sections_size = sections.size_bytes();
+
+        iobuf encoded;
+        size_t count = 0;
+        while (auto section = sections.next()) {
+            encoded.append(std::move(*section));
+            ++count;
+        }
+        // a section for each partition and one for the empty topic
+        BOOST_REQUIRE_EQUAL(count, 4);
+        BOOST_REQUIRE_EQUAL(encoded.size_bytes(), sections_size);
+
+        head.append(std::move(encoded));
+        BOOST_REQUIRE_EQUAL(head.size_bytes(), expected.size_bytes());
+        BOOST_REQUIRE(head == expected);
+    }
+}
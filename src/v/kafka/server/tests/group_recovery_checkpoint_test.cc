@@ -0,0 +1,364 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/bytes.h"
+#include "kafka/server/group.h"
+#include "kafka/server/group_manager.h"
+#include "kafka/server/group_stm.h"
+#include "model/record_batch_reader.h"
+#include "model/timeout_clock.h"
+#include "reflection/adl.h"
+#include "storage/record_batch_builder.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/circular_buffer.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace kafka {
+
+/**
+ * Builds the records that the group coordinator appends to its partition,
+ * every batch holds a single record and gets the next offset of the log.
+ */
+struct group_log {
+    void metadata(
+      const ss::sstring& group,
+      std::optional<group_log_group_metadata> md) {
+        group_log_record_key key{
+          .record_type = group_log_record_key::type::group_metadata,
+          .key = reflection::to_iobuf(kafka::group_id(group)),
+        };
+        std::optional<iobuf> value;
+        if (md) {
+            value = reflection::to_iobuf(std::move(*md));
+        }
+        add(
+          model::record_batch_type::raft_data,
+          std::move(key),
+          std::move(value));
+    }
+
+    void offset(
+      const ss::sstring& group,
+      const model::topic_partition& tp,
+      std::optional<model::offset> o) {
+        group_log_record_key key{
+          .record_type = group_log_record_key::type::offset_commit,
+          .key = reflection::to_iobuf(group_log_offset_key{
+            kafka::group_id(group), tp.topic, tp.partition}),
+        };
+        std::optional<iobuf> value;
+        if (o) {
+            value = reflection::to_iobuf(group_log_offset_metadata{
+              .offset = *o, .leader_epoch = 1, .metadata = "md"});
+        }
+        add(
+          model::record_batch_type::raft_data,
+          std::move(key),
+          std::move(value));
+    }
+
+    void prepare(
+      const ss::sstring& group,
+      model::producer_identity pid,
+      model::tx_seq seq,
+      const model::topic_partition& tp,
+      model::offset o) {
+        group_log_prepared_tx tx{
+          .group_id = kafka::group_id(group),
+          .pid = pid,
+          .tx_seq = seq,
+          .offsets = {group_log_prepared_tx_offset{
+            .tp = tp, .offset = o, .leader_epoch = 1, .metadata = "tx"}},
+        };
+        add_tx(
+          model::record_batch_type::group_prepare_tx,
+          group::prepared_tx_record_version,
+          pid,
+          std::move(tx));
+    }
+
+    void commit(const ss::sstring& group, model::producer_identity pid) {
+        add_tx(
+          model::record_batch_type::group_commit_tx,
+          group::commit_tx_record_version,
+          pid,
+          group_log_commit_tx{.group_id = kafka::group_id(group)});
+    }
+
+    void abort(
+      const ss::sstring& group,
+      model::producer_identity pid,
+      model::tx_seq seq) {
+        add_tx(
+          model::record_batch_type::group_abort_tx,
+          group::aborted_tx_record_version,
+          pid,
+          group_log_aborted_tx{
+            .group_id = kafka::group_id(group), .tx_seq = seq});
+    }
+
+    void fence(const ss::sstring& group, model::producer_identity pid) {
+        add_tx(
+          model::record_batch_type::tx_fence,
+          group::fence_control_record_version,
+          pid,
+          group_log_fencing{.group_id = kafka::group_id(group)});
+    }
+
+    void add(
+      model::record_batch_type type,
+      group_log_record_key key,
+      std::optional<iobuf> value) {
+        storage::record_batch_builder builder(type, next_offset());
+        builder.add_raw_kv(
+          reflection::to_iobuf(std::move(key)), std::move(value));
+        batches.push_back(std::move(builder).build());
+    }
+
+    template<typename T>
+    void add_tx(
+      model::record_batch_type type,
+      int8_t version,
+      model::producer_identity pid,
+      T cmd) {
+        iobuf key;
+        reflection::serialize(key, type, pid.id);
+        iobuf value;
+        reflection::serialize(value, version, std::move(cmd));
+
+        storage::record_batch_builder builder(type, next_offset());
+        builder.set_producer_identity(pid.id, pid.epoch);
+        builder.set_control_type();
+        builder.add_raw_kv(std::move(key), std::move(value));
+        batches.push_back(std::move(builder).build());
+    }
+
+    model::offset next_offset() const {
+        return model::offset(static_cast<int64_t>(batches.size()));
+    }
+
+    std::vector<model::record_batch> batches;
+};
+
+static group_log_group_metadata
+make_metadata(kafka::generation_id generation, const ss::sstring& member) {
+    group_log_group_metadata md{
+      .protocol_type = kafka::protocol_type("consumer"),
+      .generation = generation,
+      .protocol = kafka::protocol_name("range"),
+      .leader = kafka::member_id(member),
+      .state_timestamp = 10,
+    };
+    md.members.push_back(member_state{
+      .id = kafka::member_id(member),
+      .session_timeout = std::chrono::milliseconds(1000),
+      .rebalance_timeout = std::chrono::milliseconds(2000),
+      .instance_id = std::nullopt,
+      .protocol_type = kafka::protocol_type("consumer"),
+      .protocols = {{kafka::protocol_name("range"), bytes("md")}},
+      .assignment = bytes_to_iobuf(bytes("assignment")),
+      .client_id = kafka::client_id("client"),
+      .client_host = kafka::client_host("host"),
+    });
+    return md;
+}
+
+/// Replays the batches in [from, to) of the log on top of the given state
+static recovery_batch_consumer_state replay(
+  recovery_batch_consumer_state st,
+  const group_log& log,
+  size_t from,
+  size_t to) {
+    ss::circular_buffer<model::record_batch> batches;
+    for (size_t i = from; i < to; ++i) {
+        batches.push_back(log.batches[i].copy());
+    }
+    ss::abort_source as;
+    return model::make_memory_record_batch_reader(std::move(batches))
+      .consume(recovery_batch_consumer(as, std::move(st)), model::no_timeout)
+      .get0();
+}
+
+/// Serializes the state the way the checkpoint persists it and loads it back
+static recovery_batch_consumer_state
+checkpoint(const recovery_batch_consumer_state& st) {
+    std::vector<group_stm_snapshot> groups;
+    for (const auto& [id, stm] : st.groups) {
+        groups.push_back(stm.make_snapshot(id));
+    }
+    auto restored = reflection::from_iobuf<std::vector<group_stm_snapshot>>(
+      reflection::to_iobuf(std::move(groups)));
+
+    recovery_batch_consumer_state ret;
+    ret.last_offset = st.last_offset;
+    for (auto& g : restored) {
+        auto id = g.id;
+        ret.groups.emplace(std::move(id), group_stm(std::move(g)));
+    }
+    return ret;
+}
+
+static void require_equal(const group_stm& a, const group_stm& b) {
+    BOOST_REQUIRE_EQUAL(a.is_removed(), b.is_removed());
+    BOOST_REQUIRE_EQUAL(a.has_data(), b.has_data());
+
+    auto a_snap = a.make_snapshot(kafka::group_id{});
+    auto b_snap = b.make_snapshot(kafka::group_id{});
+    BOOST_REQUIRE_EQUAL(a_snap.is_loaded, b_snap.is_loaded);
+    const auto& a_md = a_snap.metadata;
+    const auto& b_md = b_snap.metadata;
+    BOOST_REQUIRE_EQUAL(a_md.protocol_type, b_md.protocol_type);
+    BOOST_REQUIRE_EQUAL(a_md.generation, b_md.generation);
+    BOOST_REQUIRE(a_md.protocol == b_md.protocol);
+    BOOST_REQUIRE(a_md.leader == b_md.leader);
+    BOOST_REQUIRE_EQUAL(a_md.state_timestamp, b_md.state_timestamp);
+    BOOST_REQUIRE_EQUAL(a_md.members.size(), b_md.members.size());
+    for (size_t i = 0; i < a_md.members.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(a_md.members[i].id, b_md.members[i].id);
+        BOOST_REQUIRE_EQUAL(
+          a_md.members[i].assignment, b_md.members[i].assignment);
+    }
+
+    BOOST_REQUIRE_EQUAL(a.offsets().size(), b.offsets().size());
+    for (const auto& [tp, md] : a.offsets()) {
+        auto it = b.offsets().find(tp);
+        BOOST_REQUIRE(it != b.offsets().end());
+        BOOST_REQUIRE_EQUAL(md.log_offset, it->second.log_offset);
+        BOOST_REQUIRE_EQUAL(md.metadata.offset, it->second.metadata.offset);
+        BOOST_REQUIRE_EQUAL(
+          md.metadata.leader_epoch, it->second.metadata.leader_epoch);
+        BOOST_REQUIRE(md.metadata.metadata == it->second.metadata.metadata);
+    }
+
+    BOOST_REQUIRE_EQUAL(a.prepared_txs().size(), b.prepared_txs().size());
+    for (const auto& [id, tx] : a.prepared_txs()) {
+        auto it = b.prepared_txs().find(id);
+        BOOST_REQUIRE(it != b.prepared_txs().end());
+        BOOST_REQUIRE_EQUAL(tx.pid, it->second.pid);
+        BOOST_REQUIRE_EQUAL(tx.tx_seq, it->second.tx_seq);
+        BOOST_REQUIRE_EQUAL(tx.offsets.size(), it->second.offsets.size());
+        for (const auto& [tp, md] : tx.offsets) {
+            auto o_it = it->second.offsets.find(tp);
+            BOOST_REQUIRE(o_it != it->second.offsets.end());
+            BOOST_REQUIRE_EQUAL(md.log_offset, o_it->second.log_offset);
+            BOOST_REQUIRE_EQUAL(md.offset, o_it->second.offset);
+            BOOST_REQUIRE_EQUAL(md.metadata, o_it->second.metadata);
+        }
+    }
+
+    BOOST_REQUIRE(a.fences() == b.fences());
+}
+
+static void require_equal(
+  const recovery_batch_consumer_state& a,
+  const recovery_batch_consumer_state& b) {
+    BOOST_REQUIRE_EQUAL(a.last_offset, b.last_offset);
+    BOOST_REQUIRE_EQUAL(a.groups.size(), b.groups.size());
+    for (const auto& [id, stm] : a.groups) {
+        auto it = b.groups.find(id);
+        BOOST_REQUIRE(it != b.groups.end());
+        require_equal(stm, it->second);
+    }
+}
+
+static const model::topic_partition
+  tp_0(model::topic("t"), model::partition_id(0));
+static const model::topic_partition
+  tp_1(model::topic("t"), model::partition_id(1));
+
+/**
+ * Log covering every kind of group state: committed offsets and their
+ * tombstones, prepared transactions that are committed, aborted or still
+ * pending, producer fences bumped by newer epochs and removed groups.
+ */
+static group_log make_group_log() {
+    model::producer_identity pid_1{.id = 1, .epoch = 0};
+    model::producer_identity pid_2{.id = 2, .epoch = 0};
+    model::producer_identity pid_3{.id = 3, .epoch = 0};
+    model::producer_identity pid_3_bumped{.id = 3, .epoch = 1};
+
+    group_log log;
+    log.metadata("g1", make_metadata(kafka::generation_id(1), "m1"));
+    log.offset("g1", tp_0, model::offset(10));
+    log.offset("g1", tp_1, model::offset(20));
+    log.fence("g1", pid_1);
+    log.prepare("g1", pid_1, model::tx_seq(1), tp_0, model::offset(30));
+    log.metadata("g2", make_metadata(kafka::generation_id(1), "m2"));
+    log.offset("g2", tp_0, model::offset(5));
+    log.fence("g2", pid_2);
+    log.prepare("g2", pid_2, model::tx_seq(1), tp_1, model::offset(7));
+    log.metadata("g1", make_metadata(kafka::generation_id(2), "m3"));
+    log.commit("g1", pid_1);
+    log.offset("g1", tp_1, std::nullopt);
+    log.abort("g2", pid_2, model::tx_seq(1));
+    log.fence("g3", pid_3);
+    log.prepare("g3", pid_3, model::tx_seq(1), tp_0, model::offset(3));
+    log.fence("g3", pid_3_bumped);
+    log.prepare("g3", pid_3_bumped, model::tx_seq(2), tp_1, model::offset(4));
+    log.metadata("g2", std::nullopt);
+    log.offset("g2", tp_0, std::nullopt);
+    log.metadata("g4", make_metadata(kafka::generation_id(1), "m4"));
+    log.offset("g4", tp_0, model::offset(1));
+    log.metadata("g4", std::nullopt);
+    log.metadata("g4", make_metadata(kafka::generation_id(2), "m4"));
+    return log;
+}
+
+SEASTAR_THREAD_TEST_CASE(group_stm_snapshot_roundtrip) {
+    auto log = make_group_log();
+    auto st = replay({}, log, 0, log.batches.size());
+
+    // make sure the log produces every kind of state the snapshot carries
+    BOOST_REQUIRE(st.groups.at(kafka::group_id("g1")).fences().size() == 1);
+    BOOST_REQUIRE(
+      st.groups.at(kafka::group_id("g3")).prepared_txs().size() == 1);
+    BOOST_REQUIRE(st.groups.at(kafka::group_id("g2")).is_removed());
+    BOOST_REQUIRE(st.groups.at(kafka::group_id("g4")).is_removed());
+
+    require_equal(st, checkpoint(st));
+}
+
+SEASTAR_THREAD_TEST_CASE(group_stm_snapshot_roundtrip_empty) {
+    recovery_batch_consumer_state st;
+    st.groups.emplace(kafka::group_id("g"), group_stm());
+    require_equal(st, checkpoint(st));
+}
+
+SEASTAR_THREAD_TEST_CASE(checkpoint_and_tail_replay_match_full_replay) {
+    auto log = make_group_log();
+    auto full = replay({}, log, 0, log.batches.size());
+
+    for (size_t split = 0; split <= log.batches.size(); ++split) {
+        BOOST_TEST_INFO("checkpoint after " << split << " batches");
+        auto head = checkpoint(replay({}, log, 0, split));
+        auto st = replay(std::move(head), log, split, log.batches.size());
+        require_equal(full, st);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(checkpoint_of_checkpoints_match_full_replay) {
+    auto log = make_group_log();
+    auto full = replay({}, log, 0, log.batches.size());
+
+    // the checkpoints are taken periodically, each one is replayed on top
+    // of the previous one
+    recovery_batch_consumer_state st;
+    for (size_t i = 0; i < log.batches.size(); i += 3) {
+        auto to = std::min(i + 3, log.batches.size());
+        st = checkpoint(replay(std::move(st), log, i, to));
+    }
+    require_equal(full, st);
+}
+
+} // namespace kafka
@@ -438,6 +438,80 @@ SEASTAR_THREAD_TEST_CASE(leader_rejoined) {
     BOOST_TEST(g.leader() == "n");
 }
 
+static member_ptr get_static_member(ss::sstring id, ss::sstring instance) {
+    return ss::make_lw_shared<group_member>(
+      kafka::member_id(std::move(id)),
+      kafka::group_id("g"),
+      kafka::group_instance_id(std::move(instance)),
+      kafka::client_id("client-id"),
+      kafka::client_host("client-host"),
+      std::chrono::seconds(1),
+      std::chrono::milliseconds(2),
+      kafka::protocol_type("p"),
+      test_group_protos);
+}
+
+static join_group_request static_join_request(ss::sstring instance) {
+    join_group_request r;
+    r.version = api_version(5);
+    r.data.member_id = unknown_member_id;
+    r.data.group_instance_id = kafka::group_instance_id(std::move(instance));
+    r.data.protocol_type = kafka::protocol_type("p");
+    r.data.protocols = std::vector<join_group_request_protocol>{
+      {kafka::protocol_name("n0"), bytes("d0")},
+      {kafka::protocol_name("n1"), bytes("d1")}};
+    return r;
+}
+
+static group get_stable_group() {
+    auto g = get();
+    g.add_member_no_join(get_static_member("m0", "i0"));
+    g.add_member_no_join(get_static_member("m1", "i1"));
+    g.set_state(group_state::preparing_rebalance);
+    g.set_state(group_state::completing_rebalance);
+    g.set_state(group_state::stable);
+    return g;
+}
+
+SEASTAR_THREAD_TEST_CASE(static_member_rejoin_keeps_generation) {
+    auto g = get_stable_group();
+    auto generation = g.generation();
+    g.get_member(kafka::member_id("m1"))->set_assignment(bytes("a1"));
+
+    auto resp = g.handle_join_group(static_join_request("i1"), false).get0();
+    BOOST_TEST(resp.data.error_code == error_code::none);
+    BOOST_TEST(resp.data.generation_id == generation);
+    BOOST_TEST(resp.data.leader == kafka::member_id("m0"));
+    BOOST_TEST(resp.data.members.empty());
+
+    // the instance is the same member under its new id
+    const auto& new_id = resp.data.member_id;
+    BOOST_TEST(new_id != kafka::member_id("m1"));
+    BOOST_TEST(!g.contains_member(kafka::member_id("m1")));
+    BOOST_TEST(g.contains_member(new_id));
+    BOOST_TEST(g.get_member(new_id)->assignment() == bytes("a1"));
+    BOOST_TEST(g.in_state(group_state::stable));
+    BOOST_TEST(g.generation() == generation);
+
+    // the leader keeps the group leadership
+    resp = g.handle_join_group(static_join_request("i0"), false).get0();
+    BOOST_TEST(resp.data.error_code == error_code::none);
+    BOOST_TEST(resp.data.leader == resp.data.member_id);
+    BOOST_TEST(g.leader() == resp.data.member_id);
+    BOOST_TEST(g.in_state(group_state::stable));
+}
+
+SEASTAR_THREAD_TEST_CASE(static_member_rejoin_with_new_metadata_rebalances) {
+    auto g = get_stable_group();
+
+    auto r = static_join_request("i1");
+    r.data.protocols.front().metadata = bytes("d2");
+    auto f = g.handle_join_group(std::move(r), false);
+
+    BOOST_TEST(!g.contains_member(kafka::member_id("m1")));
+    BOOST_TEST(g.in_state(group_state::preparing_rebalance));
+}
+
 SEASTAR_THREAD_TEST_CASE(generate_member_id) {
     join_group_request r;
 
@@ -132,3 +132,68 @@ FIXTURE_TEST(list_offsets_latest, redpanda_thread_fixture) {
       resp.data.topics[0].partitions[0].timestamp == model::timestamp(-1));
     BOOST_CHECK(resp.data.topics[0].partitions[0].offset > model::offset(0));
 }
+
+FIXTURE_TEST(list_offsets_latest_cached, redpanda_thread_fixture) {
+    wait_for_controller_leadership().get0();
+    auto ntp = make_data(model::revision_id(2));
+    auto shard = app.shard_table.local().shard_for(ntp);
+    tests::cooperative_spin_wait_with_timeout(10s, [this, shard, ntp = ntp] {
+        return app.partition_manager.invoke_on(
+          *shard, [ntp](cluster::partition_manager& mgr) {
+              auto partition = mgr.get(ntp);
+              return partition
+                     && partition->committed_offset() >= model::offset(1);
+          });
+    }).get();
+
+    auto set_max_age = [](std::chrono::milliseconds max_age) {
+        ss::smp::invoke_on_all([max_age] {
+            config::shard_local_cfg()
+              .get("list_offsets_cache_max_age_ms")
+              .set_value(max_age);
+        }).get();
+    };
+    set_max_age(1h);
+
+    auto client = make_kafka_client().get0();
+    client.connect().get();
+
+    auto latest = [&client, &ntp] {
+        kafka::list_offsets_request req;
+        req.data.topics = {{
+          .name = ntp.tp.topic,
+          .partitions = {{
+            .partition_index = ntp.tp.partition,
+            .timestamp = kafka::list_offsets_request::latest_timestamp,
+          }},
+        }};
+        auto resp = client.dispatch(req, kafka::api_version(1)).get0();
+        BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+        BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+        return resp.data.topics[0].partitions[0].offset;
+    };
+    auto before = latest();
+
+    app.partition_manager
+      .invoke_on(
+        *shard,
+        [ntp](cluster::partition_manager& mgr) {
+            auto partition = mgr.get(ntp);
+            auto batches = storage::test::make_random_batches(
+              model::offset(0), 5);
+            auto rdr = model::make_memory_record_batch_reader(
+              std::move(batches));
+            return partition->replicate(
+              std::move(rdr),
+              raft::replicate_options(raft::consistency_level::quorum_ack));
+        })
+      .get();
+
+    // answered with the offsets cached by the first lookup
+    BOOST_CHECK_EQUAL(latest(), before);
+
+    set_max_age(0ms);
+    BOOST_CHECK(latest() > before);
+
+    client.stop().then([&client] { client.shutdown(); }).get();
+}
@@ -8,11 +8,14 @@
 // by the Apache License, Version 2.0
 
 #include "kafka/protocol/errors.h"
+#include "kafka/server/handlers/metadata.h"
+#include "kafka/server/handlers/produce.h"
 #include "librdkafka/rdkafkacpp.h"
 #include "model/fundamental.h"
 #include "model/namespace.h"
 #include "redpanda/tests/fixture.h"
 #include "test_utils/fixture.h"
+#include "units.h"
 
 #include <seastar/core/when_all.hh>
 
@@ -159,3 +162,25 @@ FIXTURE_TEST(test_topic_namespaces, redpanda_thread_fixture) {
     BOOST_REQUIRE_EQUAL(resp.data.topics[0].name, test_topic.tp);
     client.stop().then([&client] { client.shutdown(); }).get();
 };
+
+FIXTURE_TEST(metadata_memory_estimate, redpanda_thread_fixture) {
+    wait_for_controller_leadership().get();
+    auto rctx = make_request_context();
+    auto& conn = *rctx.connection();
+    const size_t request_size = 100;
+    const auto before = kafka::metadata_memory_estimate(request_size, conn);
+    BOOST_REQUIRE_GE(
+      before, kafka::default_memory_estimate(request_size, conn));
+
+    const model::topic_namespace tp_ns(
+      model::kafka_namespace, model::topic("estimated-topic"));
+    add_topic(tp_ns, 10).get();
+    // the response grows with the partitions of the cluster
+    BOOST_REQUIRE_GT(
+      kafka::metadata_memory_estimate(request_size, conn), before);
+
+    // the records of a produce request are not copied
+    BOOST_REQUIRE_LT(
+      kafka::produce_handler::memory_estimate(1_MiB, conn),
+      kafka::default_memory_estimate(1_MiB, conn));
+}
@@ -0,0 +1,195 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/partition.h"
+#include "cluster/partition_manager.h"
+#include "kafka/server/offset_commit_batcher.h"
+#include "model/namespace.h"
+#include "model/record_batch_reader.h"
+#include "redpanda/tests/fixture.h"
+#include "test_utils/async.h"
+#include "test_utils/fixture.h"
+
+#include <seastar/core/when_all.hh>
+
+#include <absl/container/flat_hash_set.h>
+
+#include <vector>
+
+using namespace std::chrono_literals; // NOLINT
+
+/*
+ * Replicates offset commits through a batcher attached to a partition of a
+ * single node cluster. The tests run on a single core so the partition is
+ * owned by the current shard.
+ */
+struct offset_commit_batcher_fixture : public redpanda_thread_fixture {
+    using results_t = std::vector<result<raft::replicate_result>>;
+
+    offset_commit_batcher_fixture() {
+        wait_for_controller_leadership().get0();
+        add_topic(model::topic_namespace_view(ntp)).get0();
+        tests::cooperative_spin_wait_with_timeout(2s, [this] {
+            auto p = app.partition_manager.local().get(ntp);
+            return p && p->is_leader();
+        }).get0();
+        batcher = ss::make_lw_shared<kafka::offset_commit_batcher>(
+          app.partition_manager.local().get(ntp));
+    }
+
+    static iobuf make_iobuf(std::string_view s) {
+        iobuf b;
+        b.append(s.data(), s.size());
+        return b;
+    }
+
+    static iobuf key(int commit, int record) {
+        return make_iobuf(ssx::sformat("commit-{}-{}", commit, record));
+    }
+
+    static kafka::offset_commit_batcher::records_t
+    make_commit(int commit, int records, size_t value_size) {
+        kafka::offset_commit_batcher::records_t ret;
+        for (int i = 0; i < records; ++i) {
+            ret.emplace_back(
+              key(commit, i), make_iobuf(ss::sstring(value_size, 'v')));
+        }
+        return ret;
+    }
+
+    /// Issues all the commits before any of them is replicated, as the
+    /// commits of concurrent requests to the coordinator
+    results_t replicate_concurrently(
+      int commits, int records_per_commit, size_t value_size) {
+        std::vector<ss::future<>> enqueued;
+        std::vector<ss::future<result<raft::replicate_result>>> finished;
+        for (int i = 0; i < commits; ++i) {
+            auto stages = batcher->replicate(
+              make_commit(i, records_per_commit, value_size));
+            enqueued.push_back(std::move(stages.request_enqueued));
+            finished.push_back(std::move(stages.replicate_finished));
+        }
+        ss::when_all_succeed(enqueued.begin(), enqueued.end()).get();
+        return ss::when_all_succeed(finished.begin(), finished.end()).get0();
+    }
+
+    /// The batches of offset commits in the log of the partition
+    std::vector<model::record_batch> read_commit_batches() {
+        auto p = app.partition_manager.local().get(ntp);
+        auto reader = p->make_reader(storage::log_reader_config(
+                                       model::offset(0),
+                                       p->committed_offset(),
+                                       ss::default_priority_class()))
+                        .get0();
+        auto batches = model::consume_reader_to_memory(
+                         std::move(reader), model::no_timeout)
+                         .get0();
+        std::vector<model::record_batch> ret;
+        for (auto& b : batches) {
+            if (b.header().type == model::record_batch_type::raft_data) {
+                ret.push_back(std::move(b));
+            }
+        }
+        return ret;
+    }
+
+    /// Every commit is replicated once, in order, and never split across
+    /// batches
+    static void require_commits_in_order(
+      const std::vector<model::record_batch>& batches,
+      int commits,
+      int records_per_commit) {
+        int commit = 0;
+        int record = 0;
+        for (const auto& b : batches) {
+            BOOST_REQUIRE_EQUAL(b.record_count() % records_per_commit, 0);
+            b.for_each_record([&](model::record r) {
+                BOOST_REQUIRE(r.key() == key(commit, record));
+                if (++record == records_per_commit) {
+                    record = 0;
+                    ++commit;
+                }
+            });
+        }
+        BOOST_REQUIRE_EQUAL(commit, commits);
+    }
+
+    const model::ntp ntp = model::ntp(
+      model::kafka_namespace,
+      model::topic("offset-commits"),
+      model::partition_id(0));
+    ss::lw_shared_ptr<kafka::offset_commit_batcher> batcher;
+};
+
+FIXTURE_TEST(
+  test_concurrent_commits_are_coalesced, offset_commit_batcher_fixture) {
+    static constexpr int commits = 64;
+    static constexpr int records_per_commit = 3;
+
+    auto results = replicate_concurrently(commits, records_per_commit, 16);
+
+    // every commit gets the result of the batch it was replicated in
+    absl::flat_hash_set<model::offset> last_offsets;
+    for (const auto& r : results) {
+        BOOST_REQUIRE(r.has_value());
+        last_offsets.insert(r.value().last_offset);
+    }
+
+    auto batches = read_commit_batches();
+    require_commits_in_order(batches, commits, records_per_commit);
+
+    // the first commit is replicated right away, the others wait for it to
+    // be enqueued and share the next batch
+    BOOST_REQUIRE_EQUAL(batches.size(), 2);
+    BOOST_REQUIRE_EQUAL(last_offsets.size(), batches.size());
+    for (const auto& b : batches) {
+        BOOST_REQUIRE(last_offsets.contains(b.last_offset()));
+    }
+
+    // an idle coordinator replicates a single commit without waiting
+    auto single = replicate_concurrently(1, records_per_commit, 16);
+    BOOST_REQUIRE(single[0].has_value());
+    batches = read_commit_batches();
+    BOOST_REQUIRE_EQUAL(batches.size(), 3);
+    BOOST_REQUIRE_EQUAL(
+      batches.back().last_offset(), single[0].value().last_offset);
+}
+
+FIXTURE_TEST(
+  test_coalesced_batches_are_size_limited, offset_commit_batcher_fixture) {
+    static constexpr int commits = 9;
+    static constexpr int records_per_commit = 2;
+    // two commits fit in a batch, a third one would exceed the limit
+    static constexpr size_t value_size
+      = kafka::offset_commit_batcher::max_batch_bytes / 5;
+
+    auto results = replicate_concurrently(
+      commits, records_per_commit, value_size);
+    for (const auto& r : results) {
+        BOOST_REQUIRE(r.has_value());
+    }
+
+    auto batches = read_commit_batches();
+    require_commits_in_order(batches, commits, records_per_commit);
+
+    // the first commit alone and then pairs of commits
+    BOOST_REQUIRE_EQUAL(batches.size(), 5);
+    BOOST_REQUIRE_EQUAL(batches[0].record_count(), records_per_commit);
+    for (size_t i = 1; i < batches.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(batches[i].record_count(), 2 * records_per_commit);
+    }
+
+    // a single commit over the limit is replicated as is
+    auto large = replicate_concurrently(
+      1, 3, kafka::offset_commit_batcher::max_batch_bytes / 2);
+    BOOST_REQUIRE(large[0].has_value());
+    batches = read_commit_batches();
+    BOOST_REQUIRE_EQUAL(batches.size(), 6);
+    BOOST_REQUIRE_EQUAL(batches.back().record_count(), 3);
+}
@@ -0,0 +1,85 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/protocol/offset_for_leader_epoch.h"
+#include "redpanda/tests/fixture.h"
+#include "test_utils/async.h"
+
+#include <seastar/core/smp.hh>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+FIXTURE_TEST(offset_for_leader_epoch, redpanda_thread_fixture) {
+    wait_for_controller_leadership().get0();
+    auto ntp = make_data(model::revision_id(2));
+    auto shard = app.shard_table.local().shard_for(ntp);
+    tests::cooperative_spin_wait_with_timeout(10s, [this, shard, ntp = ntp] {
+        return app.partition_manager.invoke_on(
+          *shard, [ntp](cluster::partition_manager& mgr) {
+              auto partition = mgr.get(ntp);
+              return partition && partition->is_leader()
+                     && partition->committed_offset() >= model::offset(1);
+          });
+    }).get();
+
+    auto term = app.partition_manager
+                  .invoke_on(
+                    *shard,
+                    [ntp](cluster::partition_manager& mgr) {
+                        return mgr.get(ntp)->term();
+                    })
+                  .get0();
+    const auto epoch = static_cast<int32_t>(term());
+
+    auto client = make_kafka_client().get0();
+    client.connect().get();
+
+    auto lookup = [&client, &ntp](int32_t current, int32_t leader_epoch) {
+        kafka::offset_for_leader_epoch_request req;
+        req.data.topics = {{
+          .topic = ntp.tp.topic,
+          .partitions = {{
+            .partition = ntp.tp.partition,
+            .current_leader_epoch = current,
+            .leader_epoch = leader_epoch,
+          }},
+        }};
+        auto resp = client.dispatch(req, kafka::api_version(3)).get0();
+        BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+        BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+        return resp.data.topics[0].partitions[0];
+    };
+
+    // the current epoch ends at the end of the log
+    auto current = lookup(epoch, epoch);
+    BOOST_REQUIRE_EQUAL(current.error_code, kafka::error_code::none);
+    BOOST_REQUIRE_EQUAL(current.leader_epoch, epoch);
+    BOOST_REQUIRE(current.end_offset > model::offset(0));
+
+    // the data written before the partition had a leader is of an older term
+    auto older = lookup(-1, 0);
+    BOOST_REQUIRE_EQUAL(older.error_code, kafka::error_code::none);
+    BOOST_REQUIRE(older.leader_epoch < epoch);
+    BOOST_REQUIRE(older.end_offset > model::offset(0));
+    BOOST_REQUIRE(older.end_offset <= current.end_offset);
+
+    // an epoch the partition didn't reach is undefined
+    auto later = lookup(-1, epoch + 1);
+    BOOST_REQUIRE_EQUAL(later.error_code, kafka::error_code::none);
+    BOOST_REQUIRE_EQUAL(later.leader_epoch, -1);
+    BOOST_REQUIRE_EQUAL(later.end_offset, model::offset(-1));
+
+    auto unknown = lookup(epoch + 1, epoch);
+    BOOST_REQUIRE_EQUAL(
+      unknown.error_code, kafka::error_code::unknown_leader_epoch);
+
+    client.stop().then([&client] { client.shutdown(); }).get();
+}
@@ -0,0 +1,288 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/client/transport.h"
+#include "kafka/protocol/fetch.h"
+#include "kafka/protocol/produce.h"
+#include "model/fundamental.h"
+#include "random/generators.h"
+#include "redpanda/tests/fixture.h"
+#include "storage/record_batch_builder.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <ctime>
+
+using namespace std::chrono_literals;
+
+/**
+ * End to end produce and fetch through the kafka API of an in process
+ * broker, run with -c 1: the CPU time of the shard covers the whole path.
+ *
+ * An iteration produces a batch to each partition of the topic in a single
+ * request, then each consumer fetches the batches. The time of an iteration
+ * is the time of the produce and of the fetches, the fixture reports the
+ * throughput, the produce and fetch latency percentiles and the CPU time per
+ * produced byte of the test.
+ */
+struct workload {
+    int partitions;
+    size_t batch_bytes;
+    size_t records_per_batch;
+    // -1 or 1, acks=0 produce requests have no response to measure
+    int16_t acks;
+    size_t consumers;
+};
+
+class produce_fetch_fixture : public redpanda_thread_fixture {
+public:
+    ~produce_fetch_fixture() {
+        if (_produced_bytes == 0) {
+            return;
+        }
+        fmt::print(
+          "partitions: {}, batch: {} bytes, acks: {}, consumers: {}\n"
+          "  produced: {:.2f} MiB/s, fetched: {:.2f} MiB/s, cpu: {:.2f} "
+          "ns/byte\n"
+          "  produce latency us: p50 {} p99 {} p999 {}\n"
+          "  fetch latency us: p50 {} p99 {} p999 {}\n",
+          _workload.partitions,
+          _workload.batch_bytes,
+          _workload.acks,
+          _workload.consumers,
+          mib_per_sec(_produced_bytes),
+          mib_per_sec(_fetched_bytes),
+          static_cast<double>(_cpu.count()) / _produced_bytes,
+          _produce_latency.get_value_at(50),
+          _produce_latency.get_value_at(99),
+          _produce_latency.get_value_at(99.9),
+          _fetch_latency.get_value_at(50),
+          _fetch_latency.get_value_at(99),
+          _fetch_latency.get_value_at(99.9));
+    }
+
+    size_t run(const workload& w) {
+        if (!_producer) {
+            start(w);
+        }
+        auto req = make_produce_request();
+        perf_tests::start_measuring_time();
+        const auto start = clock_type::now();
+        const auto cpu_start = thread_cpu_time();
+
+        auto resp = _producer->dispatch(std::move(req)).get0();
+        _produce_latency.record(micros_since(start));
+        for (auto& c : _consumers) {
+            const auto fetch_start = clock_type::now();
+            fetch(c);
+            _fetch_latency.record(micros_since(fetch_start));
+        }
+
+        _cpu += thread_cpu_time() - cpu_start;
+        _elapsed += clock_type::now() - start;
+        perf_tests::stop_measuring_time();
+        perf_tests::do_not_optimize(resp);
+        return 1;
+    }
+
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    struct consumer {
+        std::unique_ptr<kafka::client::transport> transport;
+        std::vector<model::offset> offsets;
+    };
+
+    void start(const workload& w) {
+        _workload = w;
+        wait_for_controller_leadership().get();
+        add_topic(
+          model::topic_namespace_view(model::kafka_namespace, _topic),
+          w.partitions)
+          .get();
+        for (int p = 0; p < w.partitions; ++p) {
+            wait_for_leader(model::ntp(
+              model::kafka_namespace, _topic, model::partition_id(p)));
+        }
+        _producer = std::make_unique<kafka::client::transport>(
+          make_kafka_client().get0());
+        _producer->connect().get();
+        for (size_t i = 0; i < w.consumers; ++i) {
+            consumer c{
+              .transport = std::make_unique<kafka::client::transport>(
+                make_kafka_client().get0()),
+              .offsets = std::vector<model::offset>(w.partitions)};
+            c.transport->connect().get();
+            _consumers.push_back(std::move(c));
+        }
+        const auto value_size = std::max<size_t>(
+          w.batch_bytes / w.records_per_batch, 1);
+        _value = random_generators::gen_alphanum_string(value_size);
+    }
+
+    void wait_for_leader(model::ntp ntp) {
+        tests::cooperative_spin_wait_with_timeout(10s, [this, ntp] {
+            auto shard = app.shard_table.local().shard_for(ntp);
+            if (!shard) {
+                return ss::make_ready_future<bool>(false);
+            }
+            return app.partition_manager.invoke_on(
+              *shard, [ntp](cluster::partition_manager& pm) {
+                  auto p = pm.get(ntp);
+                  return p && p->is_leader();
+              });
+        }).get();
+    }
+
+    kafka::produce_request make_produce_request() {
+        kafka::produce_request::topic tp;
+        tp.name = _topic;
+        for (int p = 0; p < _workload.partitions; ++p) {
+            storage::record_batch_builder builder(
+              model::record_batch_type::raft_data, model::offset(0));
+            for (size_t r = 0; r < _workload.records_per_batch; ++r) {
+                iobuf value;
+                value.append(_value.data(), _value.size());
+                builder.add_raw_kv(iobuf{}, std::move(value));
+            }
+            kafka::produce_request::partition partition;
+            partition.partition_index = model::partition_id(p);
+            auto batch = std::move(builder).build();
+            _produced_bytes += batch.size_bytes();
+            partition.records.emplace(std::move(batch));
+            tp.partitions.push_back(std::move(partition));
+        }
+        std::vector<kafka::produce_request::topic> topics;
+        topics.push_back(std::move(tp));
+        kafka::produce_request req(
+          std::nullopt, _workload.acks, std::move(topics));
+        req.data.timeout_ms = 10s;
+        req.has_idempotent = false;
+        req.has_transactional = false;
+        return req;
+    }
+
+    void fetch(consumer& c) {
+        kafka::fetch_request::topic topic;
+        topic.name = _topic;
+        for (int p = 0; p < _workload.partitions; ++p) {
+            kafka::fetch_request::partition partition;
+            partition.partition_index = model::partition_id(p);
+            partition.fetch_offset = c.offsets[p];
+            partition.log_start_offset = model::offset(0);
+            partition.max_bytes = 1_MiB;
+            topic.fetch_partitions.push_back(partition);
+        }
+        kafka::fetch_request req;
+        req.data.min_bytes = 1;
+        req.data.max_bytes = 64_MiB;
+        req.data.max_wait_ms = 1s;
+        req.data.topics.push_back(std::move(topic));
+
+        auto resp = c.transport->dispatch(std::move(req), kafka::api_version(4))
+                      .get0();
+        for (auto& t : resp.data.topics) {
+            for (auto& p : t.partitions) {
+                if (p.records && !p.records->empty()) {
+                    _fetched_bytes += p.records->size_bytes();
+                    c.offsets[p.partition_index()] = p.records->last_offset()
+                                                     + model::offset(1);
+                }
+            }
+        }
+    }
+
+    static std::chrono::nanoseconds thread_cpu_time() {
+        timespec ts{};
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return std::chrono::seconds(ts.tv_sec)
+               + std::chrono::nanoseconds(ts.tv_nsec);
+    }
+
+    static uint64_t micros_since(clock_type::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                 clock_type::now() - start)
+          .count();
+    }
+
+    double mib_per_sec(size_t bytes) const {
+        const auto secs = std::chrono::duration<double>(_elapsed).count();
+        return secs > 0 ? static_cast<double>(bytes) / (1_MiB * secs) : 0;
+    }
+
+    const model::topic _topic{"bench"};
+    workload _workload{};
+    ss::sstring _value;
+    std::unique_ptr<kafka::client::transport> _producer;
+    std::vector<consumer> _consumers;
+    hdr_hist _produce_latency;
+    hdr_hist _fetch_latency;
+    size_t _produced_bytes{0};
+    size_t _fetched_bytes{0};
+    clock_type::duration _elapsed{0};
+    std::chrono::nanoseconds _cpu{0};
+};
+
+PERF_TEST_F(produce_fetch_fixture, produce_1_partition_1kib_acks_1) {
+    return run(workload{
+      .partitions = 1,
+      .batch_bytes = 1_KiB,
+      .records_per_batch = 10,
+      .acks = 1,
+      .consumers = 0});
+}
+
+PERF_TEST_F(produce_fetch_fixture, produce_1_partition_1kib_acks_all) {
+    return run(workload{
+      .partitions = 1,
+      .batch_bytes = 1_KiB,
+      .records_per_batch = 10,
+      .acks = -1,
+      .consumers = 0});
+}
+
+PERF_TEST_F(produce_fetch_fixture, produce_16_partitions_16kib_acks_all) {
+    return run(workload{
+      .partitions = 16,
+      .batch_bytes = 16_KiB,
+      .records_per_batch = 16,
+      .acks = -1,
+      .consumers = 0});
+}
+
+PERF_TEST_F(produce_fetch_fixture, produce_fetch_1_partition_16kib) {
+    return run(workload{
+      .partitions = 1,
+      .batch_bytes = 16_KiB,
+      .records_per_batch = 16,
+      .acks = -1,
+      .consumers = 1});
+}
+
+PERF_TEST_F(produce_fetch_fixture, produce_fetch_16_partitions_16kib) {
+    return run(workload{
+      .partitions = 16,
+      .batch_bytes = 16_KiB,
+      .records_per_batch = 16,
+      .acks = -1,
+      .consumers = 1});
+}
+
+PERF_TEST_F(produce_fetch_fixture, produce_fetch_16kib_fan_out_4) {
+    return run(workload{
+      .partitions = 4,
+      .batch_bytes = 16_KiB,
+      .records_per_batch = 16,
+      .acks = -1,
+      .consumers = 4});
+}
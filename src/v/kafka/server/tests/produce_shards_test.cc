@@ -0,0 +1,196 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/client/transport.h"
+#include "kafka/protocol/errors.h"
+#include "kafka/protocol/produce.h"
+#include "model/fundamental.h"
+#include "model/namespace.h"
+#include "redpanda/tests/fixture.h"
+#include "storage/record_batch_builder.h"
+#include "test_utils/async.h"
+#include "test_utils/fixture.h"
+
+#include <absl/container/flat_hash_set.h>
+#include <boost/test/tools/old/interface.hpp>
+
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/*
+ * The produce handler groups the partitions of a request by the shard that
+ * owns them. These tests run on several cores so that a single request is
+ * dispatched to more than one shard.
+ */
+struct produce_shards_fixture : public redpanda_thread_fixture {
+    static constexpr int partitions = 8;
+
+    void start() {
+        wait_for_controller_leadership().get0();
+        client = std::make_unique<kafka::client::transport>(
+          make_kafka_client().get0());
+        client->connect().get0();
+        add_topic(
+          model::topic_namespace_view(model::kafka_namespace, topic),
+          partitions)
+          .get0();
+        for (int i = 0; i < partitions; ++i) {
+            model::ntp ntp(
+              model::kafka_namespace, topic, model::partition_id(i));
+            tests::cooperative_spin_wait_with_timeout(2s, [ntp, this] {
+                auto shard = app.shard_table.local().shard_for(ntp);
+                if (!shard) {
+                    return ss::make_ready_future<bool>(false);
+                }
+                return app.partition_manager.invoke_on(
+                  *shard, [ntp](cluster::partition_manager& pm) {
+                      return pm.get(ntp)->is_leader();
+                  });
+            }).get0();
+        }
+    }
+
+    absl::flat_hash_set<ss::shard_id> topic_shards() {
+        absl::flat_hash_set<ss::shard_id> shards;
+        for (int i = 0; i < partitions; ++i) {
+            auto shard = app.shard_table.local().shard_for(model::ntp(
+              model::kafka_namespace, topic, model::partition_id(i)));
+            BOOST_REQUIRE(shard.has_value());
+            shards.insert(*shard);
+        }
+        return shards;
+    }
+
+    static kafka::produce_request::partition
+    make_partition(model::partition_id id, int records) {
+        storage::record_batch_builder builder(
+          model::record_batch_type::raft_data, model::offset(0));
+        for (int i = 0; i < records; ++i) {
+            iobuf v;
+            v.append("v", 1);
+            builder.add_raw_kv(iobuf{}, std::move(v));
+        }
+        kafka::produce_request::partition p;
+        p.partition_index = id;
+        p.records.emplace(std::move(builder).build());
+        return p;
+    }
+
+    /// number of records produced to a partition, distinct for every
+    /// partition so that the responses can't be mixed up
+    static int records_count(model::partition_id id) { return id() + 1; }
+
+    kafka::produce_response
+    produce(std::vector<kafka::produce_request::topic> topics) {
+        kafka::produce_request req(std::nullopt, -1, std::move(topics));
+        req.data.timeout_ms = 2s;
+        req.has_idempotent = false;
+        req.has_transactional = false;
+        return client->dispatch(std::move(req)).get0();
+    }
+
+    /// the partitions of the topic in an order unrelated to their shards,
+    /// with a partition that doesn't exist and one without records
+    std::vector<kafka::produce_request::topic> make_request() {
+        std::vector<kafka::produce_request::topic> topics;
+
+        kafka::produce_request::topic t;
+        t.name = topic;
+        for (int id : partition_order) {
+            model::partition_id p_id(id);
+            if (id == null_records) {
+                kafka::produce_request::partition p;
+                p.partition_index = p_id;
+                t.partitions.push_back(std::move(p));
+                continue;
+            }
+            t.partitions.push_back(make_partition(p_id, records_count(p_id)));
+        }
+        topics.push_back(std::move(t));
+
+        kafka::produce_request::topic missing;
+        missing.name = model::topic("missing");
+        missing.partitions.push_back(
+          make_partition(model::partition_id(0), 1));
+        topics.push_back(std::move(missing));
+        return topics;
+    }
+
+    static constexpr int missing_partition = 99;
+    static constexpr int null_records = 6;
+    const std::vector<int> partition_order{
+      5, 2, 7, 0, missing_partition, 3, null_records, 1, 4};
+    const model::topic topic = model::topic("produce-shards");
+    std::unique_ptr<kafka::client::transport> client;
+};
+
+FIXTURE_TEST(test_produce_to_several_shards, produce_shards_fixture) {
+    start();
+    if (ss::smp::count > 1) {
+        BOOST_REQUIRE_GT(topic_shards().size(), 1);
+    }
+
+    auto first = produce(make_request());
+    auto second = produce(make_request());
+
+    for (auto* resp : {&first, &second}) {
+        // topics and partitions are listed in the order of the request
+        BOOST_REQUIRE_EQUAL(resp->data.responses.size(), 2);
+        BOOST_REQUIRE_EQUAL(resp->data.responses[0].name, topic);
+        BOOST_REQUIRE_EQUAL(
+          resp->data.responses[1].name, model::topic("missing"));
+
+        const auto& parts = resp->data.responses[0].partitions;
+        BOOST_REQUIRE_EQUAL(parts.size(), partition_order.size());
+        for (size_t i = 0; i < partition_order.size(); ++i) {
+            BOOST_REQUIRE_EQUAL(
+              parts[i].partition_index,
+              model::partition_id(partition_order[i]));
+        }
+
+        const auto& missing = resp->data.responses[1].partitions;
+        BOOST_REQUIRE_EQUAL(missing.size(), 1);
+        BOOST_REQUIRE_EQUAL(
+          missing[0].error_code,
+          kafka::error_code::unknown_topic_or_partition);
+    }
+
+    // every partition reports its own result
+    const auto& first_parts = first.data.responses[0].partitions;
+    const auto& second_parts = second.data.responses[0].partitions;
+    for (size_t i = 0; i < partition_order.size(); ++i) {
+        auto id = model::partition_id(partition_order[i]);
+        BOOST_TEST_INFO("partition " << id);
+        if (partition_order[i] == missing_partition) {
+            BOOST_REQUIRE_EQUAL(
+              first_parts[i].error_code,
+              kafka::error_code::unknown_topic_or_partition);
+            BOOST_REQUIRE_EQUAL(
+              second_parts[i].error_code,
+              kafka::error_code::unknown_topic_or_partition);
+            continue;
+        }
+        if (partition_order[i] == null_records) {
+            BOOST_REQUIRE_EQUAL(
+              first_parts[i].error_code, kafka::error_code::invalid_record);
+            BOOST_REQUIRE_EQUAL(
+              second_parts[i].error_code, kafka::error_code::invalid_record);
+            continue;
+        }
+        BOOST_REQUIRE_EQUAL(
+          first_parts[i].error_code, kafka::error_code::none);
+        BOOST_REQUIRE_EQUAL(
+          second_parts[i].error_code, kafka::error_code::none);
+        // the second batch of the partition follows its first one
+        BOOST_REQUIRE_EQUAL(
+          second_parts[i].base_offset,
+          first_parts[i].base_offset + model::offset(records_count(id)));
+    }
+}
@@ -0,0 +1,77 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/configuration.h"
+#include "kafka/server/slow_request_log.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+using kafka::slow_request_log;
+
+namespace {
+slow_request_log::entry make_entry(std::chrono::microseconds process) {
+    return slow_request_log::entry{
+      .key = kafka::api_key(0),
+      .client_id = "client",
+      .dispatch = 10us,
+      .process = process,
+    };
+}
+
+void set_size(size_t size) {
+    config::shard_local_cfg()
+      .get("kafka_slow_request_log_size")
+      .set_value(size);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(keeps_the_slowest_requests) {
+    slow_request_log::reset();
+    set_size(3);
+    for (auto us : {50, 10, 40, 20, 30}) {
+        slow_request_log::record(make_entry(std::chrono::microseconds(us)));
+    }
+    auto entries = slow_request_log::entries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 3);
+    BOOST_REQUIRE(entries[0].total() == 60us);
+    BOOST_REQUIRE(entries[1].total() == 50us);
+    BOOST_REQUIRE(entries[2].total() == 40us);
+
+    // faster than the slowest kept ones
+    BOOST_REQUIRE(!slow_request_log::admits(40us));
+    BOOST_REQUIRE(slow_request_log::admits(41us));
+    set_size(10);
+}
+
+BOOST_AUTO_TEST_CASE(disabled_when_size_is_zero) {
+    slow_request_log::reset();
+    set_size(0);
+    BOOST_REQUIRE(!slow_request_log::admits(1s));
+    slow_request_log::record(make_entry(1s));
+    BOOST_REQUIRE(slow_request_log::entries().empty());
+    set_size(10);
+}
+
+BOOST_AUTO_TEST_CASE(lowered_size_drops_the_fastest) {
+    slow_request_log::reset();
+    set_size(4);
+    for (auto us : {10, 20, 30, 40}) {
+        slow_request_log::record(make_entry(std::chrono::microseconds(us)));
+    }
+    set_size(2);
+    slow_request_log::record(make_entry(100us));
+    auto entries = slow_request_log::entries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 2);
+    BOOST_REQUIRE(entries[0].total() == 110us);
+    BOOST_REQUIRE(entries[1].total() == 50us);
+    set_size(10);
+}
@@ -183,3 +183,41 @@ FIXTURE_TEST(random_translation_test_with_hint, offset_translator_fixture) {
         BOOST_REQUIRE_EQUAL(log_offset, reverse_log_offset);
     }
 }
+
+FIXTURE_TEST(translation_in_any_order, offset_translator_fixture) {
+    std::vector<raft::offset_configuration> cfgs;
+    // a configuration batch every 10 offsets
+    for (auto o = 0; o < 1000; o += 10) {
+        cfgs.emplace_back(
+          model::offset(o),
+          raft::group_configuration({}, model::revision_id(0)));
+    }
+    config_manager.add(std::move(cfgs)).get();
+
+    auto expected_kafka_offset = [](int o) {
+        return model::offset(o - std::min(o / 10 + 1, 100));
+    };
+    // backward, then jumping around the offset space
+    for (auto o = 1099; o > 0; --o) {
+        if (o % 10 != 0 || o >= 1000) {
+            validate_offset_translation(
+              model::offset(o), expected_kafka_offset(o));
+        }
+    }
+    for (auto i = 0; i < 1000; ++i) {
+        auto o = random_generators::get_int(1, 1099);
+        if (o % 10 != 0 || o >= 1000) {
+            validate_offset_translation(
+              model::offset(o), expected_kafka_offset(o));
+        }
+    }
+
+    // the configurations dropped by a prefix truncation keep counting
+    config_manager.prefix_truncate(model::offset(500)).get();
+    for (auto o = 501; o < 1100; ++o) {
+        if (o % 10 != 0 || o >= 1000) {
+            validate_offset_translation(
+              model::offset(o), expected_kafka_offset(o));
+        }
+    }
+}
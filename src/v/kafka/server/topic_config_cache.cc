@@ -0,0 +1,53 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/topic_config_cache.h"
+
+namespace kafka {
+
+topic_config_cache::topic_config_cache(cluster::metadata_cache& md_cache)
+  : _md_cache(md_cache)
+  , _notification(_md_cache.register_topic_change_notification(
+      [this](model::topic_namespace_view tp_ns) { invalidate(tp_ns); })) {}
+
+topic_config_cache::~topic_config_cache() noexcept {
+    _md_cache.unregister_topic_change_notification(_notification);
+}
+
+const effective_topic_config*
+topic_config_cache::get(model::topic_namespace_view tp_ns) {
+    if (auto it = _topics.find(tp_ns); it != _topics.end()) {
+        return &it->second;
+    }
+    auto cfg = _md_cache.get_topic_cfg(tp_ns);
+    if (!cfg) {
+        return nullptr;
+    }
+    const auto& p = cfg->properties;
+    auto [it, _] = _topics.emplace(
+      model::topic_namespace(tp_ns),
+      effective_topic_config{
+        .partition_count = cfg->partition_count,
+        .compression = p.compression.value_or(
+          _md_cache.get_default_compression()),
+        .timestamp_type = p.timestamp_type.value_or(
+          _md_cache.get_default_timestamp_type()),
+        .cleanup_policy_bitflags = p.cleanup_policy_bitflags.value_or(
+          _md_cache.get_default_cleanup_policy_bitflags()),
+      });
+    return &it->second;
+}
+
+void topic_config_cache::invalidate(model::topic_namespace_view tp_ns) {
+    if (auto it = _topics.find(tp_ns); it != _topics.end()) {
+        _topics.erase(it);
+    }
+}
+
+} // namespace kafka
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "cluster/metadata_cache.h"
+#include "model/compression.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "model/timestamp.h"
+#include "seastarx.h"
+
+#include <absl/container/node_hash_map.h>
+
+namespace kafka {
+
+/// Properties of a topic resolved against the cluster defaults
+struct effective_topic_config {
+    int32_t partition_count;
+    model::compression compression;
+    model::timestamp_type timestamp_type;
+    model::cleanup_policy_bitflags cleanup_policy_bitflags;
+
+    bool contains(model::partition_id p) const {
+        return p() >= 0 && p() < partition_count;
+    }
+};
+
+/**
+ * Effective configurations of the topics used by the requests of this shard.
+ *
+ * The produce and fetch paths need a few properties of every topic they
+ * touch, each of them an optional of the topic table merged with the
+ * configuration default. The merged record is built the first time a topic
+ * is used and dropped together with the topic deltas, so the requests pay a
+ * single lookup per topic.
+ */
+class topic_config_cache {
+public:
+    explicit topic_config_cache(cluster::metadata_cache&);
+    topic_config_cache(const topic_config_cache&) = delete;
+    topic_config_cache& operator=(const topic_config_cache&) = delete;
+    topic_config_cache(topic_config_cache&&) = delete;
+    topic_config_cache& operator=(topic_config_cache&&) = delete;
+    ~topic_config_cache() noexcept;
+
+    /// Returns the configuration of the topic or nullptr if it doesn't
+    /// exist. The pointer is valid until the next scheduling point.
+    const effective_topic_config* get(model::topic_namespace_view);
+
+    void invalidate(model::topic_namespace_view);
+
+    size_t size() const { return _topics.size(); }
+
+private:
+    cluster::metadata_cache& _md_cache;
+    cluster::metadata_cache::topic_change_notification_id _notification;
+    absl::node_hash_map<
+      model::topic_namespace,
+      effective_topic_config,
+      model::topic_namespace_hash,
+      model::topic_namespace_eq>
+      _topics;
+};
+
+} // namespace kafka
@@ -72,6 +72,17 @@ enum class compaction_strategy : int8_t {
 std::ostream& operator<<(std::ostream&, compaction_strategy);
 std::istream& operator>>(std::istream&, compaction_strategy&);
 
+// Named after redpanda.storage.engine topic property
+enum class storage_engine : int8_t {
+    /// \brief segments on disk
+    disk,
+    /// \brief batches kept in memory only, retained up to a number of bytes.
+    /// the data is as durable as its replicas
+    memory,
+};
+std::ostream& operator<<(std::ostream&, storage_engine);
+std::istream& operator>>(std::istream&, storage_engine&);
+
 using term_id = named_type<int64_t, struct model_raft_term_id_type>;
 
 using run_id = named_type<int64_t, struct model_raft_run_id_type>;
@@ -354,6 +354,25 @@ std::istream& operator>>(std::istream& i, cleanup_policy_bitflags& cp) {
     return i;
 }
 
+std::ostream& operator<<(std::ostream& o, storage_engine e) {
+    switch (e) {
+    case storage_engine::disk:
+        return o << "disk";
+    case storage_engine::memory:
+        return o << "memory";
+    }
+    return o << "{unknown model::storage_engine}";
+}
+
+std::istream& operator>>(std::istream& i, storage_engine& e) {
+    ss::sstring s;
+    i >> s;
+    e = string_switch<storage_engine>(s)
+          .match("disk", storage_engine::disk)
+          .match("memory", storage_engine::memory);
+    return i;
+}
+
 std::ostream& operator<<(std::ostream& os, const model::broker_endpoint& ep) {
     fmt::print(os, "{{{}:{}}}", ep.name, ep.address);
     return os;
@@ -45,10 +45,6 @@ inline const model::topic_partition coprocessor_internal_tp{
 inline const model::topic tx_manager_topic("tx");
 inline const model::topic_namespace
   tx_manager_nt(model::kafka_internal_namespace, tx_manager_topic);
-inline const model::ntp tx_manager_ntp(
-  model::kafka_internal_namespace,
-  model::tx_manager_topic,
-  model::partition_id(0));
 
 inline const model::topic id_allocator_topic("id_allocator");
 inline const model::ntp id_allocator_ntp(
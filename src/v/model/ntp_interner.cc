@@ -0,0 +1,97 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/ntp_interner.h"
+
+#include "vassert.h"
+
+#include <fmt/ostream.h>
+
+#include <iostream>
+
+namespace model {
+
+std::ostream& operator<<(std::ostream& o, const ntp_id& id) {
+    fmt::print(o, "{{topic: {}, partition: {}}}", id.topic, id.partition);
+    return o;
+}
+
+ntp_interner& ntp_interner::local() {
+    static thread_local ntp_interner interner;
+    return interner;
+}
+
+topic_id ntp_interner::intern(topic_namespace_view tp_ns) {
+    if (auto it = _ids.find(tp_ns); it != _ids.end()) {
+        ++_topics[it->second()]->references;
+        return it->second;
+    }
+    topic_id id;
+    if (!_free.empty()) {
+        id = _free.back();
+        _free.pop_back();
+    } else {
+        id = topic_id(_topics.size());
+        _topics.emplace_back();
+    }
+    _topics[id()] = entry{.tp_ns = topic_namespace(tp_ns), .references = 1};
+    _ids.emplace(topic_namespace(tp_ns), id);
+    return id;
+}
+
+ntp_id ntp_interner::intern(const ntp& ntp) {
+    return ntp_id{
+      .topic = intern(topic_namespace_view(ntp)),
+      .partition = ntp.tp.partition,
+    };
+}
+
+void ntp_interner::release(topic_id id) {
+    vassert(
+      id() < _topics.size() && _topics[id()],
+      "Releasing the unassigned topic id {}",
+      id);
+    auto& e = *_topics[id()];
+    if (--e.references > 0) {
+        return;
+    }
+    _ids.erase(e.tp_ns);
+    _topics[id()] = std::nullopt;
+    _free.push_back(id);
+}
+
+std::optional<topic_id> ntp_interner::find(topic_namespace_view tp_ns) const {
+    if (auto it = _ids.find(tp_ns); it != _ids.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+std::optional<ntp_id> ntp_interner::find(const ntp& ntp) const {
+    if (auto id = find(topic_namespace_view(ntp)); id) {
+        return ntp_id{.topic = *id, .partition = ntp.tp.partition};
+    }
+    return std::nullopt;
+}
+
+const topic_namespace* ntp_interner::topic_of(topic_id id) const {
+    if (id() >= _topics.size() || !_topics[id()]) {
+        return nullptr;
+    }
+    return &_topics[id()]->tp_ns;
+}
+
+std::optional<ntp> ntp_interner::ntp_of(ntp_id id) const {
+    if (const auto* tp_ns = topic_of(id.topic); tp_ns) {
+        return ntp(tp_ns->ns, tp_ns->tp, id.partition);
+    }
+    return std::nullopt;
+}
+
+} // namespace model
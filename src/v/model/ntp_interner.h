@@ -0,0 +1,92 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "utils/named_type.h"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+namespace model {
+
+/// \brief dense id of a topic, see ntp_interner
+using topic_id = named_type<uint32_t, struct model_topic_id_type>;
+
+/// \brief compact identifier of a partition, hashed and compared as two
+/// integers instead of the strings of the ntp
+struct ntp_id {
+    topic_id topic;
+    partition_id partition;
+
+    bool operator==(const ntp_id&) const = default;
+
+    template<typename H>
+    friend H AbslHashValue(H h, const ntp_id& id) {
+        return H::combine(std::move(h), id.topic(), id.partition());
+    }
+
+    friend std::ostream& operator<<(std::ostream&, const ntp_id&);
+};
+
+/**
+ * Shard local interning of the topics, the topic of an ntp is replaced by a
+ * dense integer with a reverse lookup.
+ *
+ * The topic table interns the topics when they are created, so the requests
+ * hash the topic name once and the maps of the hot paths are keyed by the
+ * ntp_id of their partitions. The ids are reference counted, a holder
+ * releases its id once it doesn't use it anymore and the id is reused once
+ * released by all its holders. The ids are not meant to cross shards.
+ */
+class ntp_interner {
+public:
+    static ntp_interner& local();
+
+    /// the id of the topic, assigned on the first reference
+    topic_id intern(topic_namespace_view);
+    ntp_id intern(const ntp&);
+    /// drops a reference taken by intern()
+    void release(topic_id);
+
+    std::optional<topic_id> find(topic_namespace_view) const;
+    std::optional<ntp_id> find(const ntp&) const;
+
+    /// reverse lookup, nullptr if the id is not assigned
+    const topic_namespace* topic_of(topic_id) const;
+    std::optional<ntp> ntp_of(ntp_id) const;
+
+    /// number of assigned ids
+    size_t size() const { return _ids.size(); }
+
+private:
+    struct entry {
+        topic_namespace tp_ns;
+        size_t references{0};
+    };
+
+    absl::flat_hash_map<
+      topic_namespace,
+      topic_id,
+      topic_namespace_hash,
+      topic_namespace_eq>
+      _ids;
+    /// indexed by the ids, the released ids are empty
+    std::vector<std::optional<entry>> _topics;
+    std::vector<topic_id> _free;
+};
+
+} // namespace model
@@ -252,6 +252,139 @@ private:
     std::vector<record_header> _headers{};
 };
 
+/// \brief the bytes of a key, value or header of a record in the records of
+/// a batch, possibly spanning fragments. Nothing is copied unless requested,
+/// the view is valid as long as the records
+class record_field_view {
+public:
+    record_field_view(iobuf::iterator_consumer begin, size_t size) noexcept
+      : _begin(begin)
+      , _size(size) {}
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    /// the bytes when they are in one fragment, nullopt otherwise
+    std::optional<bytes_view> contiguous() const;
+
+    /// invokes f(const char*, size_t) on the fragments of the field, in order
+    template<typename Func>
+    void for_each_fragment(Func&& f) const {
+        auto in = _begin;
+        in.consume(_size, [&f](const char* src, size_t n) {
+            f(src, n);
+            return ss::stop_iteration::no;
+        });
+    }
+
+    iobuf copy() const;
+    bytes linearize() const;
+
+    /// compares the bytes without copying them
+    bool operator==(bytes_view) const;
+    bool operator!=(bytes_view other) const { return !(*this == other); }
+
+private:
+    iobuf::iterator_consumer _begin;
+    size_t _size;
+};
+
+/// \brief a record parsed in place from the records of a batch, see
+/// record_batch::for_each_record_view(). The offsets, timestamp, key and
+/// value are decoded without allocating, the headers are decoded on access
+/// and copy() materializes the record. Valid as long as the records
+class record_view {
+public:
+    record_view(
+      iobuf::iterator_consumer begin,
+      int32_t size_bytes,
+      record_attributes attributes,
+      int64_t timestamp_delta,
+      int32_t offset_delta,
+      int32_t key_size,
+      record_field_view key,
+      int32_t val_size,
+      record_field_view value,
+      int32_t headers_count,
+      iobuf::iterator_consumer headers) noexcept
+      : _begin(begin)
+      , _size_bytes(size_bytes)
+      , _attributes(attributes)
+      , _timestamp_delta(timestamp_delta)
+      , _offset_delta(offset_delta)
+      , _key_size(key_size)
+      , _key(key)
+      , _val_size(val_size)
+      , _value(value)
+      , _headers_count(headers_count)
+      , _headers(headers) {}
+
+    int32_t size_bytes() const { return _size_bytes; }
+    record_attributes attributes() const { return _attributes; }
+    int64_t timestamp_delta() const { return _timestamp_delta; }
+    int32_t offset_delta() const { return _offset_delta; }
+
+    /// -1 for a null key
+    int32_t key_size() const { return _key_size; }
+    std::optional<record_field_view> key() const {
+        return field(_key_size, _key);
+    }
+
+    /// -1 for a null value
+    int32_t value_size() const { return _val_size; }
+    bool has_value() const { return _val_size >= 0; }
+    std::optional<record_field_view> value() const {
+        return field(_val_size, _value);
+    }
+
+    int32_t headers_count() const { return _headers_count; }
+
+    /// invokes f(std::optional<record_field_view> key,
+    /// std::optional<record_field_view> value) on the headers, in order
+    template<typename Func>
+    void for_each_header(Func&& f) const {
+        auto in = _headers;
+        for (int32_t i = 0; i < _headers_count; ++i) {
+            auto key = read_field(in);
+            auto value = read_field(in);
+            f(std::move(key), std::move(value));
+        }
+    }
+
+    /// copies of the key and value, empty when null
+    iobuf copy_key() const { return _key.copy(); }
+    iobuf copy_value() const { return _value.copy(); }
+
+    /// appends the encoded record to the buffer, as is
+    void append_to(iobuf&) const;
+
+    record copy() const;
+
+private:
+    static std::optional<record_field_view>
+    field(int32_t size, const record_field_view& v) {
+        if (size < 0) {
+            return std::nullopt;
+        }
+        return v;
+    }
+    static std::optional<record_field_view>
+    read_field(iobuf::iterator_consumer&);
+
+    /// the attributes, the size varint is not included
+    iobuf::iterator_consumer _begin;
+    int32_t _size_bytes;
+    record_attributes _attributes;
+    int64_t _timestamp_delta;
+    int32_t _offset_delta;
+    int32_t _key_size;
+    record_field_view _key;
+    int32_t _val_size;
+    record_field_view _value;
+    int32_t _headers_count;
+    iobuf::iterator_consumer _headers;
+};
+
 class record_batch_attributes final {
 public:
     static constexpr uint16_t compression_mask = 0x7;
@@ -626,6 +759,36 @@ public:
         }
     }
 
+    /**
+     * Iterate over views of the records, parsed in place.
+     *
+     * Prefer it to `for_each_record(..)` when only some fields are accessed,
+     * nothing is allocated unless the view is copied.
+     */
+    template<typename Func>
+    void for_each_record_view(Func f) const {
+        verify_iterable();
+        iobuf_const_parser parser(_records);
+        for (auto i = 0; i < _header.record_count; i++) {
+            f(model::parse_one_record_view(parser));
+        }
+        if (unlikely(parser.bytes_left())) {
+            throw std::out_of_range(fmt::format(
+              "Record iteration stopped with {} bytes remaining",
+              parser.bytes_left()));
+        }
+    }
+
+    /**
+     * View of the first record, for the batches that hold a single record.
+     */
+    record_view first_record_view() const {
+        verify_iterable();
+        vassert(_header.record_count > 0, "No records in {}", _header);
+        iobuf_const_parser parser(_records);
+        return model::parse_one_record_view(parser);
+    }
+
     /**
      * Materialize records.
      *
@@ -672,6 +835,10 @@ private:
     template<typename Func>
     friend ss::future<>
     for_each_record(const model::record_batch& batch, Func&& f);
+
+    template<typename Func>
+    friend ss::future<>
+    for_each_record_view(const model::record_batch& batch, Func&& f);
 };
 
 /**
@@ -696,6 +863,26 @@ for_each_record(const model::record_batch& batch, Func&& f) {
       });
 }
 
+/**
+ * Iterate over the views of the records, the batch must outlive the future.
+ */
+template<typename Func>
+inline ss::future<>
+for_each_record_view(const model::record_batch& batch, Func&& f) {
+    batch.verify_iterable();
+    return ss::do_with(
+      iobuf_const_parser(batch.data()),
+      [record_count = batch.record_count(),
+       f = std::forward<Func>(f)](iobuf_const_parser& parser) mutable {
+          return ss::do_for_each(
+            boost::counting_iterator<int32_t>(0),
+            boost::counting_iterator<int32_t>(record_count),
+            [&parser, f = std::forward<Func>(f)](int32_t) {
+                return f(model::parse_one_record_view(parser));
+            });
+      });
+}
+
 class record_batch_crc_checker {
 public:
     explicit record_batch_crc_checker(bool verify_internal_header = true)
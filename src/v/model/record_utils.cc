@@ -10,23 +10,49 @@
 #include "model/record_utils.h"
 
 #include "bytes/utils.h"
+#include "likely.h"
 #include "model/record.h"
 #include "reflection/adl.h"
 #include "utils/vint.h"
+#include "vassert.h"
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
 #include <type_traits>
 
 namespace model {
 
-template<typename T, typename = std::enable_if_t<std::is_integral_v<T>, T>>
-void crc_extend_cpu_to_le(crc::crc32c& crc, T i) {
-    auto j = ss::cpu_to_le(i);
-    crc.extend(j);
-}
+/// Fixed size buffer used to hash all fields of the header at once. A single
+/// call to crc32c is much cheaper than a call per field because the
+/// hardware accelerated implementation has a fixed per-call overhead.
+template<size_t N>
+class crc_field_buffer {
+public:
+    template<
+      typename T,
+      typename = std::enable_if_t<std::is_integral_v<T>, T>>
+    void append(T i) noexcept {
+        // NOLINTNEXTLINE
+        std::memcpy(_buf.data() + _pos, &i, sizeof(T));
+        _pos += sizeof(T);
+    }
+
+    void extend(crc::crc32c& crc) const { crc.extend(_buf.data(), _pos); }
+
+private:
+    std::array<uint8_t, N> _buf;
+    size_t _pos{0};
+};
 
 template<typename... T>
 void crc_extend_all_cpu_to_le(crc::crc32c& crc, T... t) {
-    ((crc_extend_cpu_to_le(crc, t)), ...);
+    crc_field_buffer<(sizeof(T) + ...)> buf;
+    ((buf.append(ss::cpu_to_le(t))), ...);
+    buf.extend(crc);
 }
 
 /// \brief uint32_t because that's what crc32c uses
@@ -54,15 +80,11 @@ uint32_t internal_header_only_crc(const record_batch_header& header) {
     return c.value();
 }
 
-template<typename T, typename = std::enable_if_t<std::is_integral_v<T>, T>>
-void crc_extend_cpu_to_be(crc::crc32c& crc, T i) {
-    auto j = ss::cpu_to_be(i);
-    crc.extend(j);
-}
-
 template<typename... T>
 void crc_extend_all_cpu_to_be(crc::crc32c& crc, T... t) {
-    ((crc_extend_cpu_to_be(crc, t)), ...);
+    crc_field_buffer<(sizeof(T) + ...)> buf;
+    ((buf.append(ss::cpu_to_be(t))), ...);
+    buf.extend(crc);
 }
 
 void crc_record_batch_header(
@@ -175,6 +197,181 @@ model::record parse_one_record_copy_from_buffer(iobuf_const_parser& parser) {
       });
 }
 
+/// \brief view of a key or value of the record, a null field is empty
+static record_field_view
+consume_record_field(iobuf_const_parser& parser, int64_t length) {
+    const auto size = length > 0 ? static_cast<size_t>(length) : 0;
+    if (unlikely(size > parser.bytes_left())) {
+        throw std::out_of_range(fmt::format(
+          "record field of {} bytes exceeds the {} bytes left",
+          size,
+          parser.bytes_left()));
+    }
+    record_field_view view(parser.position(), size);
+    parser.skip(size);
+    return view;
+}
+
+model::record_view parse_one_record_view(iobuf_const_parser& parser) {
+    auto [record_size, rv] = parser.read_varlong();
+    auto begin = parser.position();
+    const auto start = parser.bytes_consumed();
+    auto attr = parser.consume_type<model::record_attributes::type>();
+    auto [timestamp_delta, tv] = parser.read_varlong();
+    auto [offset_delta, ov] = parser.read_varlong();
+    auto [key_length, kv] = parser.read_varlong();
+    auto key = consume_record_field(parser, key_length);
+    auto [value_length, vv] = parser.read_varlong();
+    auto value = consume_record_field(parser, value_length);
+    auto [headers_count, hv] = parser.read_varlong();
+    auto headers = parser.position();
+    // the headers are skipped with the size of the record
+    const auto parsed = parser.bytes_consumed() - start;
+    if (unlikely(
+          record_size < 0 || static_cast<size_t>(record_size) < parsed
+          || record_size - parsed > parser.bytes_left())) {
+        throw std::out_of_range(fmt::format(
+          "record of {} bytes exceeds the {} bytes left",
+          record_size,
+          parser.bytes_left() + parsed));
+    }
+    parser.skip(record_size - parsed);
+    return model::record_view(
+      begin,
+      static_cast<int32_t>(record_size),
+      model::record_attributes(attr),
+      timestamp_delta,
+      static_cast<int32_t>(offset_delta),
+      static_cast<int32_t>(key_length),
+      key,
+      static_cast<int32_t>(value_length),
+      value,
+      static_cast<int32_t>(headers_count),
+      headers);
+}
+
+static void skip_record_field(iobuf_const_parser& parser) {
+    auto [length, lv] = parser.read_varlong();
+    // -1 is a null key, value or header
+    if (length > 0) {
+        if (unlikely(static_cast<size_t>(length) > parser.bytes_left())) {
+            throw std::out_of_range(fmt::format(
+              "record field of {} bytes exceeds the {} bytes left",
+              length,
+              parser.bytes_left()));
+        }
+        parser.skip(length);
+    }
+}
+
+/// \brief checks the framing of the records, on_key is invoked with the
+/// timestamp and offset deltas of each record to consume its key
+template<typename OnKey>
+static void parse_records_framing(
+  const iobuf& records, int32_t record_count, OnKey&& on_key) {
+    iobuf_const_parser parser(records);
+    for (int32_t i = 0; i < record_count; ++i) {
+        auto [record_size, attr] = parse_record_meta_from_buffer(parser);
+        // the size doesn't include the size varint itself but the attributes
+        const auto start = parser.bytes_consumed()
+                           - sizeof(model::record_attributes::type);
+        auto [timestamp_delta, tv] = parser.read_varlong();
+        auto [offset_delta, ov] = parser.read_varlong();
+        on_key(parser, timestamp_delta, static_cast<int32_t>(offset_delta));
+        skip_record_field(parser); // value
+        auto [headers, hv] = parser.read_varlong();
+        for (int64_t h = 0; h < headers; ++h) {
+            skip_record_field(parser); // header key
+            skip_record_field(parser); // header value
+        }
+        const auto consumed = parser.bytes_consumed() - start;
+        if (unlikely(record_size < 0 || consumed != size_t(record_size))) {
+            throw std::out_of_range(fmt::format(
+              "record {} of {}: expected {} bytes, parsed {}",
+              i,
+              record_count,
+              record_size,
+              consumed));
+        }
+    }
+    if (unlikely(parser.bytes_left() != 0)) {
+        throw std::out_of_range(fmt::format(
+          "{} bytes left after parsing {} records",
+          parser.bytes_left(),
+          record_count));
+    }
+}
+
+void validate_records_framing(const iobuf& records, int32_t record_count) {
+    parse_records_framing(
+      records, record_count, [](iobuf_const_parser& parser, int64_t, int32_t) {
+          skip_record_field(parser);
+      });
+}
+
+/// \brief view of the key in the records, copied to the spilled keys when it
+/// spans fragments
+static bytes_view consume_key(
+  iobuf_const_parser& parser, size_t len, std::deque<bytes>& spilled) {
+    if (unlikely(len > parser.bytes_left())) {
+        throw std::out_of_range(fmt::format(
+          "record key of {} bytes exceeds the {} bytes left",
+          len,
+          parser.bytes_left()));
+    }
+    if (len == 0) {
+        return bytes_view();
+    }
+    bytes_view view;
+    bytes* copy = nullptr;
+    size_t pos = 0;
+    parser.consume(len, [&](const char* src, size_t n) {
+        if (n == len) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            view = bytes_view(reinterpret_cast<const uint8_t*>(src), n);
+            return ss::stop_iteration::no;
+        }
+        if (!copy) {
+            copy = &spilled.emplace_back(bytes::initialized_later{}, len);
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::copy_n(src, n, copy->data() + pos);
+        pos += n;
+        return ss::stop_iteration::no;
+    });
+    return copy ? bytes_view(*copy) : view;
+}
+
+record_scan scan_records(const iobuf& records, int32_t record_count) {
+    record_scan ret;
+    ret.records.reserve(record_count);
+    parse_records_framing(
+      records,
+      record_count,
+      [&ret](
+        iobuf_const_parser& parser,
+        int64_t timestamp_delta,
+        int32_t offset_delta) {
+          auto [key_length, kv] = parser.read_varlong();
+          std::optional<bytes_view> key;
+          // -1 is a null key
+          if (key_length >= 0) {
+              key = consume_key(parser, key_length, ret.spilled_keys);
+          }
+          ret.records.push_back(record_key_view{
+            .timestamp_delta = timestamp_delta,
+            .offset_delta = offset_delta,
+            .key = key,
+          });
+      });
+    return ret;
+}
+
+record_scan scan_records(const record_batch& b) {
+    vassert(!b.compressed(), "Cannot scan the records of {}", b.header());
+    return scan_records(b.data(), b.record_count());
+}
+
 static inline void append_vint_to_iobuf(iobuf& b, int64_t v) {
     auto vb = vint::to_bytes(v);
     b.append(vb.data(), vb.size());
@@ -224,4 +421,94 @@ void append_record_to_buffer(iobuf& a, const model::record& r) {
     }
 }
 
+std::optional<bytes_view> record_field_view::contiguous() const {
+    if (_size == 0) {
+        return bytes_view();
+    }
+    const char* p = _begin.peek_contiguous(_size);
+    if (!p) {
+        return std::nullopt;
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return bytes_view(reinterpret_cast<const uint8_t*>(p), _size);
+}
+
+iobuf record_field_view::copy() const {
+    auto in = _begin;
+    return iobuf_copy(in, _size);
+}
+
+bytes record_field_view::linearize() const {
+    bytes ret(bytes::initialized_later{}, _size);
+    size_t pos = 0;
+    for_each_fragment([&ret, &pos](const char* src, size_t n) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::copy_n(src, n, ret.data() + pos);
+        pos += n;
+    });
+    return ret;
+}
+
+bool record_field_view::operator==(bytes_view other) const {
+    if (other.size() != _size) {
+        return false;
+    }
+    bool equal = true;
+    size_t pos = 0;
+    auto in = _begin;
+    in.consume(_size, [&equal, &pos, other](const char* src, size_t n) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        equal = std::memcmp(src, other.data() + pos, n) == 0;
+        pos += n;
+        return equal ? ss::stop_iteration::no : ss::stop_iteration::yes;
+    });
+    return equal;
+}
+
+std::optional<record_field_view>
+record_view::read_field(iobuf::iterator_consumer& in) {
+    auto [length, length_size] = vint::deserialize(in);
+    in.skip(length_size);
+    if (length < 0) {
+        return std::nullopt;
+    }
+    record_field_view view(in, length);
+    in.skip(length);
+    return view;
+}
+
+void record_view::append_to(iobuf& out) const {
+    out.reserve_memory(vint::max_length + _size_bytes);
+    append_vint_to_iobuf(out, _size_bytes);
+    auto in = _begin;
+    in.consume(_size_bytes, [&out](const char* src, size_t n) {
+        out.append(src, n);
+        return ss::stop_iteration::no;
+    });
+}
+
+record record_view::copy() const {
+    std::vector<record_header> headers;
+    headers.reserve(_headers_count);
+    for_each_header([&headers](
+                      std::optional<record_field_view> key,
+                      std::optional<record_field_view> value) {
+        headers.emplace_back(
+          key ? static_cast<int32_t>(key->size()) : -1,
+          key ? key->copy() : iobuf{},
+          value ? static_cast<int32_t>(value->size()) : -1,
+          value ? value->copy() : iobuf{});
+    });
+    return record(
+      _size_bytes,
+      _attributes,
+      _timestamp_delta,
+      _offset_delta,
+      _key_size,
+      _key.copy(),
+      _val_size,
+      _value.copy(),
+      std::move(headers));
+}
+
 } // namespace model
@@ -11,14 +11,20 @@
 
 #pragma once
 
+#include "bytes/bytes.h"
 #include "bytes/iobuf_parser.h"
 #include "hashing/crc32c.h"
 
+#include <deque>
+#include <optional>
+#include <vector>
+
 namespace model {
 
 struct record_batch_header;
 class record_batch;
 class record;
+class record_view;
 
 void crc_record_batch_header(crc::crc32c&, const record_batch_header&);
 
@@ -32,6 +38,39 @@ uint32_t internal_header_only_crc(const record_batch_header&);
 
 model::record parse_one_record_from_buffer(iobuf_parser& parser);
 model::record parse_one_record_copy_from_buffer(iobuf_const_parser& parser);
+/// \brief a view of the next record, only its fixed fields and lengths are
+/// decoded. Throws std::out_of_range if the record exceeds the buffer
+model::record_view parse_one_record_view(iobuf_const_parser& parser);
 void append_record_to_buffer(iobuf& a, const model::record& r);
 
+/// \brief checks the framing of `record_count` records without materializing
+/// them, nothing is copied out of the buffer. Throws std::out_of_range if a
+/// record doesn't match its size or the buffer doesn't hold exactly the
+/// records
+void validate_records_framing(const iobuf& records, int32_t record_count);
+
+/// \brief offsets, timestamp and key of a record, parsed without
+/// materializing it
+struct record_key_view {
+    int64_t timestamp_delta;
+    int32_t offset_delta;
+    /// nullopt for a null key. points into the records, or into the spilled
+    /// keys of the scan when the key spans fragments
+    std::optional<bytes_view> key;
+};
+
+/// \brief the views of the records of a batch, the records must outlive it
+struct record_scan {
+    std::vector<record_key_view> records;
+    std::deque<bytes> spilled_keys;
+};
+
+/// \brief parses the offsets, timestamps and keys of `record_count` records
+/// in one pass, the values and headers are skipped and only the keys that
+/// span fragments are copied. Throws std::out_of_range like
+/// validate_records_framing
+record_scan scan_records(const iobuf& records, int32_t record_count);
+/// \brief scan_records() of an uncompressed batch
+record_scan scan_records(const record_batch&);
+
 } // namespace model
@@ -0,0 +1,57 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/ntp_interner.h"
+
+#include <boost/test/unit_test.hpp>
+
+static model::ntp make_ntp(const char* topic, int32_t partition) {
+    return model::ntp(
+      model::ns("kafka"), model::topic(topic), model::partition_id(partition));
+}
+
+BOOST_AUTO_TEST_CASE(ntp_interner_assigns_dense_ids) {
+    model::ntp_interner interner;
+    auto a = interner.intern(make_ntp("a", 0));
+    auto b = interner.intern(make_ntp("b", 3));
+    BOOST_CHECK_EQUAL(a.topic, model::topic_id(0));
+    BOOST_CHECK_EQUAL(b.topic, model::topic_id(1));
+    BOOST_CHECK_EQUAL(b.partition, model::partition_id(3));
+
+    // the partitions of a topic share its id
+    BOOST_CHECK_EQUAL(interner.intern(make_ntp("a", 7)).topic, a.topic);
+    BOOST_CHECK_EQUAL(interner.size(), 2);
+
+    auto found = interner.find(make_ntp("b", 5));
+    BOOST_REQUIRE(found);
+    BOOST_CHECK_EQUAL(found->topic, b.topic);
+    BOOST_CHECK_EQUAL(found->partition, model::partition_id(5));
+    BOOST_CHECK(!interner.find(make_ntp("c", 0)));
+    BOOST_CHECK_EQUAL(*interner.ntp_of(b), make_ntp("b", 3));
+}
+
+BOOST_AUTO_TEST_CASE(ntp_interner_reuses_released_ids) {
+    model::ntp_interner interner;
+    auto a = interner.intern(make_ntp("a", 0));
+    interner.intern(make_ntp("a", 1));
+    auto b = interner.intern(make_ntp("b", 0));
+
+    // released by one of its two holders
+    interner.release(a.topic);
+    BOOST_CHECK(interner.find(make_ntp("a", 0)));
+
+    interner.release(a.topic);
+    BOOST_CHECK(!interner.find(make_ntp("a", 0)));
+    BOOST_CHECK(!interner.ntp_of(a));
+    BOOST_CHECK(interner.topic_of(b.topic));
+
+    auto c = interner.intern(make_ntp("c", 0));
+    BOOST_CHECK_EQUAL(c.topic, a.topic);
+    BOOST_CHECK_EQUAL(*interner.ntp_of(c), make_ntp("c", 0));
+}
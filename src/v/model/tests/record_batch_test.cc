@@ -78,3 +78,146 @@ SEASTAR_THREAD_TEST_CASE(set_max_timestamp) {
     BOOST_TEST(crc == batch.header().crc);
     BOOST_TEST(hdr_crc == batch.header().header_crc);
 }
+
+SEASTAR_THREAD_TEST_CASE(validate_records_framing) {
+    auto batch = storage::test::make_random_batch(model::offset(0), 10, false);
+    BOOST_REQUIRE(!batch.compressed());
+    model::validate_records_framing(batch.data(), batch.record_count());
+
+    // records missing or trailing bytes
+    BOOST_CHECK_THROW(
+      model::validate_records_framing(
+        batch.data(), batch.record_count() + 1),
+      std::out_of_range);
+    BOOST_CHECK_THROW(
+      model::validate_records_framing(
+        batch.data(), batch.record_count() - 1),
+      std::out_of_range);
+
+    // truncated last record
+    auto truncated = batch.data().copy();
+    truncated.trim_back(1);
+    BOOST_CHECK_THROW(
+      model::validate_records_framing(truncated, batch.record_count()),
+      std::out_of_range);
+
+    // garbage after a re-encoded record
+    auto records = batch.copy_records();
+    iobuf buf;
+    model::append_record_to_buffer(buf, records.front());
+    model::validate_records_framing(buf, 1);
+    buf.append("x", 1);
+    BOOST_CHECK_THROW(
+      model::validate_records_framing(buf, 1), std::out_of_range);
+}
+
+/// scans the records and compares them with the materialized ones
+static void check_scan(const iobuf& data, const model::record_batch& batch) {
+    const auto scan = model::scan_records(data, batch.record_count());
+    BOOST_REQUIRE_EQUAL(scan.records.size(), batch.record_count());
+    size_t i = 0;
+    batch.for_each_record([&scan, &i](const model::record& r) {
+        const auto& v = scan.records[i++];
+        BOOST_CHECK_EQUAL(v.offset_delta, r.offset_delta());
+        BOOST_CHECK_EQUAL(v.timestamp_delta, r.timestamp_delta());
+        BOOST_REQUIRE_EQUAL(v.key.has_value(), r.key_size() >= 0);
+        if (v.key) {
+            BOOST_CHECK_EQUAL(bytes(*v.key), iobuf_to_bytes(r.key()));
+        }
+    });
+}
+
+SEASTAR_THREAD_TEST_CASE(scan_records) {
+    auto batch = storage::test::make_random_batch(model::offset(0), 10, false);
+    check_scan(batch.data(), batch);
+
+    // the keys spanning fragments are copied out
+    iobuf fragmented;
+    const auto data = iobuf_to_bytes(batch.data());
+    for (size_t pos = 0; pos < data.size(); pos += 7) {
+        iobuf frag;
+        frag.append(
+          data.data() + pos, std::min<size_t>(7, data.size() - pos));
+        fragmented.append_fragments(std::move(frag));
+    }
+    check_scan(fragmented, batch);
+
+    BOOST_CHECK_THROW(
+      model::scan_records(batch.data(), batch.record_count() + 1),
+      std::out_of_range);
+}
+
+/// parses the views of the records and compares them with the materialized
+/// ones
+static void check_views(const iobuf& data, const model::record_batch& batch) {
+    iobuf_const_parser parser(data);
+    batch.for_each_record([&parser](const model::record& r) {
+        const auto v = model::parse_one_record_view(parser);
+        BOOST_CHECK_EQUAL(v.size_bytes(), r.size_bytes());
+        BOOST_CHECK_EQUAL(v.offset_delta(), r.offset_delta());
+        BOOST_CHECK_EQUAL(v.timestamp_delta(), r.timestamp_delta());
+        BOOST_REQUIRE_EQUAL(v.key_size(), r.key_size());
+        BOOST_REQUIRE_EQUAL(v.key().has_value(), r.key_size() >= 0);
+        if (v.key()) {
+            const auto key = iobuf_to_bytes(r.key());
+            BOOST_CHECK_EQUAL(v.key()->linearize(), key);
+            BOOST_CHECK(*v.key() == bytes_view(key));
+        }
+        BOOST_REQUIRE_EQUAL(v.value_size(), r.value_size());
+        BOOST_CHECK_EQUAL(v.copy_value(), r.value());
+        BOOST_REQUIRE_EQUAL(v.headers_count(), r.headers().size());
+        size_t h = 0;
+        v.for_each_header([&r, &h](
+                            std::optional<model::record_field_view> key,
+                            std::optional<model::record_field_view> value) {
+            const auto& expected = r.headers()[h++];
+            BOOST_CHECK_EQUAL(key.has_value(), expected.key_size() >= 0);
+            BOOST_CHECK_EQUAL(value.has_value(), expected.value_size() >= 0);
+            if (key) {
+                BOOST_CHECK_EQUAL(key->copy(), expected.key());
+            }
+            if (value) {
+                BOOST_CHECK_EQUAL(value->copy(), expected.value());
+            }
+        });
+        BOOST_CHECK(v.copy() == r);
+
+        iobuf expected;
+        model::append_record_to_buffer(expected, r);
+        iobuf copied;
+        v.append_to(copied);
+        BOOST_CHECK_EQUAL(copied, expected);
+    });
+    BOOST_CHECK_EQUAL(parser.bytes_left(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(record_views) {
+    auto batch = storage::test::make_random_batch(model::offset(0), 10, false);
+    check_views(batch.data(), batch);
+
+    iobuf fragmented;
+    const auto data = iobuf_to_bytes(batch.data());
+    for (size_t pos = 0; pos < data.size(); pos += 7) {
+        iobuf frag;
+        frag.append(
+          data.data() + pos, std::min<size_t>(7, data.size() - pos));
+        fragmented.append_fragments(std::move(frag));
+    }
+    check_views(fragmented, batch);
+
+    size_t count = 0;
+    batch.for_each_record_view(
+      [&count](const model::record_view&) { ++count; });
+    BOOST_CHECK_EQUAL(count, batch.record_count());
+
+    // a record larger than the buffer
+    auto truncated = batch.data().share(0, batch.data().size_bytes() - 1);
+    iobuf_const_parser parser(truncated);
+    BOOST_CHECK_THROW(
+      {
+          for (int32_t i = 0; i < batch.record_count(); ++i) {
+              model::parse_one_record_view(parser);
+          }
+      },
+      std::out_of_range);
+}
@@ -0,0 +1,89 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf_parser.h"
+#include "model/record.h"
+#include "model/record_utils.h"
+#include "random/generators.h"
+#include "storage/tests/utils/random_batch.h"
+#include "utils/vint.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+static constexpr size_t varints = 1000;
+
+static iobuf make_varints() {
+    iobuf ret;
+    for (size_t i = 0; i < varints; ++i) {
+        const auto b = vint::to_bytes(
+          random_generators::get_int<int64_t>(-100000, 100000));
+        ret.append(b.data(), b.size());
+    }
+    return ret;
+}
+
+PERF_TEST(varint, byte_by_byte) {
+    const auto buf = make_varints();
+    perf_tests::start_measuring_time();
+    auto in = iobuf::iterator_consumer(buf.cbegin(), buf.cend());
+    int64_t sum = 0;
+    for (size_t i = 0; i < varints; ++i) {
+        auto [v, len] = vint::deserialize(in);
+        in.skip(len);
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(varint, parser) {
+    const auto buf = make_varints();
+    perf_tests::start_measuring_time();
+    iobuf_const_parser parser(buf);
+    int64_t sum = 0;
+    for (size_t i = 0; i < varints; ++i) {
+        sum += parser.read_varlong().first;
+    }
+    perf_tests::do_not_optimize(sum);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(records, for_each_record) {
+    auto batch = storage::test::make_random_batch(model::offset(0), 100, false);
+    perf_tests::start_measuring_time();
+    int64_t sum = 0;
+    batch.for_each_record([&sum](const model::record& r) {
+        sum += r.offset_delta() + r.key_size();
+    });
+    perf_tests::do_not_optimize(sum);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(records, scan_records) {
+    auto batch = storage::test::make_random_batch(model::offset(0), 100, false);
+    perf_tests::start_measuring_time();
+    int64_t sum = 0;
+    const auto scan = model::scan_records(batch);
+    for (const auto& r : scan.records) {
+        sum += r.offset_delta + (r.key ? r.key->size() : 0);
+    }
+    perf_tests::do_not_optimize(sum);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(records, for_each_record_view) {
+    auto batch = storage::test::make_random_batch(model::offset(0), 100, false);
+    perf_tests::start_measuring_time();
+    int64_t sum = 0;
+    batch.for_each_record_view([&sum](const model::record_view& r) {
+        sum += r.offset_delta() + r.key_size();
+    });
+    perf_tests::do_not_optimize(sum);
+    perf_tests::stop_measuring_time();
+}
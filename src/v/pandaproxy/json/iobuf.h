@@ -14,15 +14,50 @@
 #include "bytes/iobuf.h"
 #include "bytes/iobuf_parser.h"
 #include "json/json.h"
+#include "pandaproxy/json/rjson_util.h"
 #include "pandaproxy/json/types.h"
 #include "utils/base64.h"
 
 #include <seastar/core/loop.hh>
 
+#include <rapidjson/writer.h>
+
+#include <array>
 #include <optional>
 
 namespace pandaproxy::json {
 
+/// \brief rapidjson output stream that appends to an iobuf.
+///
+/// The output is staged in a small buffer that is appended to the iobuf
+/// fragments when full, the document is never contiguous in memory.
+class rjson_iobuf_stream {
+public:
+    using Ch = char;
+
+    void Put(Ch c) {
+        if (_pos == _stage.size()) {
+            Flush();
+        }
+        _stage[_pos++] = c;
+    }
+
+    void Flush() {
+        _buf.append(_stage.data(), _pos);
+        _pos = 0;
+    }
+
+    iobuf release() && {
+        Flush();
+        return std::move(_buf);
+    }
+
+private:
+    iobuf _buf;
+    std::array<Ch, 512> _stage;
+    size_t _pos{0};
+};
+
 template<>
 class rjson_parse_impl<iobuf> {
 public:
@@ -62,7 +97,8 @@ public:
     explicit rjson_serialize_impl(serialization_format fmt)
       : _fmt(fmt) {}
 
-    bool operator()(rapidjson::Writer<rapidjson::StringBuffer>& w, iobuf buf) {
+    template<typename Buffer>
+    bool operator()(rapidjson::Writer<Buffer>& w, iobuf buf) {
         switch (_fmt) {
         case serialization_format::none:
             [[fallthrough]];
@@ -77,8 +113,8 @@ public:
         }
     }
 
-    bool
-    encode_base64(rapidjson::Writer<rapidjson::StringBuffer>& w, iobuf buf) {
+    template<typename Buffer>
+    bool encode_base64(rapidjson::Writer<Buffer>& w, iobuf buf) {
         if (buf.empty()) {
             return w.Null();
         }
@@ -86,7 +122,8 @@ public:
         return w.String(iobuf_to_base64(buf));
     };
 
-    bool encode_json(rapidjson::Writer<rapidjson::StringBuffer>& w, iobuf buf) {
+    template<typename Buffer>
+    bool encode_json(rapidjson::Writer<Buffer>& w, iobuf buf) {
         if (buf.empty()) {
             return w.Null();
         }
@@ -102,4 +139,14 @@ private:
     serialization_format _fmt;
 };
 
+/// \brief serializes straight into iobuf fragments, for the documents that
+/// are too large to be linearized, like the fetch responses
+template<typename T>
+iobuf rjson_serialize_iobuf(serialization_format fmt, T&& v) {
+    rjson_iobuf_stream os;
+    rapidjson::Writer<rjson_iobuf_stream> w(os);
+    rjson_serialize_fmt(fmt)(w, std::forward<T>(v));
+    return std::move(os).release();
+}
+
 } // namespace pandaproxy::json
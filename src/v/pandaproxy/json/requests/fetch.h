@@ -45,19 +45,20 @@ public:
       , _tpv(tpv)
       , _base_offset(base_offset) {}
 
-    void operator()(
-      rapidjson::Writer<rapidjson::StringBuffer>& w, model::record record) {
+    template<typename Buffer>
+    void operator()(rapidjson::Writer<Buffer>& w, model::record record) {
+        // the ::json overloads only take StringBuffer writers
         w.StartObject();
         w.Key("topic");
-        ::json::rjson_serialize(w, _tpv.topic);
+        w.String(_tpv.topic().data(), _tpv.topic().size());
         w.Key("key");
         rjson_serialize_fmt(_fmt)(w, record.release_key());
         w.Key("value");
         rjson_serialize_fmt(_fmt)(w, record.release_value());
         w.Key("partition");
-        ::json::rjson_serialize(w, _tpv.partition);
+        w.Int(_tpv.partition());
         w.Key("offset");
-        ::json::rjson_serialize(w, _base_offset() + record.offset_delta());
+        w.Int64(_base_offset() + record.offset_delta());
         w.EndObject();
     }
 
@@ -73,9 +74,8 @@ public:
     explicit rjson_serialize_impl(serialization_format fmt)
       : _fmt(fmt) {}
 
-    void operator()(
-      rapidjson::Writer<rapidjson::StringBuffer>& w,
-      kafka::fetch_response&& res) {
+    template<typename Buffer>
+    void operator()(rapidjson::Writer<Buffer>& w, kafka::fetch_response&& res) {
         // Eager check for errors
         for (auto& v : res) {
             if (v.partition_response->error_code != kafka::error_code::none) {
@@ -9,6 +9,7 @@
 
 #include "pandaproxy/json/requests/fetch.h"
 
+#include "bytes/iobuf_parser.h"
 #include "kafka/client/test/utils.h"
 #include "kafka/protocol/errors.h"
 #include "kafka/protocol/fetch.h"
@@ -17,6 +18,7 @@
 #include "model/fundamental.h"
 #include "model/record.h"
 #include "model/timestamp.h"
+#include "pandaproxy/json/iobuf.h"
 #include "pandaproxy/json/requests/fetch.h"
 #include "pandaproxy/json/rjson_util.h"
 #include "pandaproxy/json/types.h"
@@ -98,3 +100,26 @@ SEASTAR_THREAD_TEST_CASE(test_produce_fetch_one) {
 
     BOOST_REQUIRE_EQUAL(str_buf.GetString(), expected);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_produce_fetch_iobuf) {
+    std::vector<model::topic_partition> tps = {
+      {model::topic{"topic1"}, model::partition_id{1}},
+      {model::topic{"topic2"}, model::partition_id{2}},
+    };
+    auto fmt = ppj::serialization_format::binary_v2;
+
+    rapidjson::StringBuffer str_buf;
+    rapidjson::Writer<rapidjson::StringBuffer> w(str_buf);
+    ppj::rjson_serialize_fmt(fmt)(
+      w, make_fetch_response(tps, model::offset{42}, 200));
+
+    auto buf = ppj::rjson_serialize_iobuf(
+      fmt, make_fetch_response(tps, model::offset{42}, 200));
+    BOOST_REQUIRE_EQUAL(buf.size_bytes(), str_buf.GetSize());
+    BOOST_REQUIRE_GT(std::distance(buf.begin(), buf.end()), 1);
+
+    iobuf_parser p(std::move(buf));
+    BOOST_REQUIRE_EQUAL(
+      p.read_string(p.bytes_left()),
+      ss::sstring(str_buf.GetString(), str_buf.GetSize()));
+}
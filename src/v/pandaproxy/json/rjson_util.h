@@ -50,8 +50,8 @@ struct rjson_serialize_fmt_impl {
         rjson_serialize_impl<std::remove_reference_t<T>>{fmt}(
           std::forward<T>(t));
     }
-    template<typename T>
-    void operator()(rapidjson::Writer<rapidjson::StringBuffer>& w, T&& t) {
+    template<typename Buffer, typename T>
+    void operator()(rapidjson::Writer<Buffer>& w, T&& t) {
         rjson_serialize_impl<std::remove_reference_t<T>>{fmt}(
           w, std::forward<T>(t));
     }
@@ -25,6 +25,7 @@ enum class serialization_format : uint8_t {
     schema_registry_json,
     application_json,
     application_octet,
+    avro_octet_v2,
     unsupported
 };
 
@@ -46,6 +47,8 @@ inline std::string_view name(serialization_format fmt) {
         return "application/json";
     case pandaproxy::json::serialization_format::application_octet:
         return "application/octet-stream";
+    case pandaproxy::json::serialization_format::avro_octet_v2:
+        return "application/vnd.kafka.avro.v2+octet-stream";
     case pandaproxy::json::serialization_format::unsupported:
         return "unsupported";
     }
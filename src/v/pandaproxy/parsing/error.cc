@@ -25,6 +25,8 @@ struct error_category final : std::error_category {
             return "empty_param";
         case error_code::invalid_param:
             return "invalid_param";
+        case error_code::invalid_body:
+            return "invalid_body";
         case error_code::not_acceptable:
             return "not_acceptable";
         case error_code::unsupported_media_type:
@@ -38,6 +40,7 @@ struct error_category final : std::error_category {
         switch (static_cast<error_code>(ec)) {
         case error_code::empty_param:
         case error_code::invalid_param:
+        case error_code::invalid_body:
             return reply_error_code::kafka_bad_request;
         case error_code::not_acceptable:
             return reply_error_code::not_acceptable;
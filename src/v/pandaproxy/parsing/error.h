@@ -20,6 +20,7 @@ enum class error_code : uint16_t {
     // ok = 0
     empty_param = 100,
     invalid_param = 101,
+    invalid_body = 102,
     not_acceptable = 406,
     unsupported_media_type = 415,
 };
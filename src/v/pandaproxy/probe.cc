@@ -28,10 +28,32 @@ probe::probe(ss::httpd::path_description& path_desc)
     _metrics.add_group(
       "pandaproxy",
       {sm::make_histogram(
-        "request_latency",
-        sm::description("Request latency"),
-        std::move(labels),
-        [this] { return _request_hist.seastar_histogram_logform(); })});
+         "request_latency",
+         sm::description("Request latency"),
+         labels,
+         [this] { return _request_hist.seastar_histogram_logform(); }),
+       sm::make_gauge(
+         "requests_inflight",
+         [this] { return _requests_inflight; },
+         sm::description("Number of requests being handled"),
+         labels),
+       sm::make_derive(
+         "client_errors",
+         [this] { return _client_errors; },
+         sm::description("Number of requests replied with a 4xx status"),
+         labels),
+       sm::make_derive(
+         "server_errors",
+         [this] { return _server_errors; },
+         sm::description("Number of requests replied with a 5xx status"),
+         labels),
+       sm::make_derive(
+         "errors_raised",
+         [this] { return _errors_raised; },
+         sm::description(
+           "Number of requests that failed with an error, they are replied "
+           "by the error handler of the server"),
+         labels)});
 }
 
 } // namespace pandaproxy
\ No newline at end of file
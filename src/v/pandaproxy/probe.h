@@ -15,16 +15,36 @@
 
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/http/json_path.hh>
+#include <seastar/http/reply.hh>
 
 namespace pandaproxy {
 
+/// Per route metrics of the server
 class probe {
 public:
     probe(ss::httpd::path_description& path_desc);
     hdr_hist& hist() { return _request_hist; }
 
+    void request_started() { ++_requests_inflight; }
+    void request_finished() { --_requests_inflight; }
+    /// Count the reply by its status class
+    void reply(ss::httpd::reply::status_type status) {
+        auto code = static_cast<int>(status);
+        if (code >= 500) {
+            ++_server_errors;
+        } else if (code >= 400) {
+            ++_client_errors;
+        }
+    }
+    /// The exceptions are turned into error replies by the server
+    void request_failed() { ++_errors_raised; }
+
 private:
     hdr_hist _request_hist;
+    uint64_t _requests_inflight{0};
+    uint64_t _client_errors{0};
+    uint64_t _server_errors{0};
+    uint64_t _errors_raised{0};
     ss::metrics::metric_groups _metrics;
 };
 
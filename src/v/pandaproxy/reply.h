@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "bytes/iobuf.h"
 #include "kafka/client/exceptions.h"
 #include "kafka/protocol/exceptions.h"
 #include "pandaproxy/error.h"
@@ -22,7 +23,9 @@
 #include "pandaproxy/schema_registry/exceptions.h"
 #include "seastarx.h"
 
+#include <seastar/core/future-util.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/iostream.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/http/exception.hh>
 #include <seastar/http/reply.hh>
@@ -81,6 +84,21 @@ errored_body(std::error_code ec, ss::sstring msg) {
     return errored_body(ec.default_error_condition(), std::move(msg));
 }
 
+/// \brief streams the json body from the iobuf fragments, without
+/// linearizing it
+inline void write_body(ss::httpd::reply& rep, iobuf body) {
+    rep.write_body(
+      "json",
+      [body = std::move(body)](ss::output_stream<char>&& out) mutable {
+          return ss::do_with(
+            std::move(out),
+            [body = std::move(body)](ss::output_stream<char>& out) mutable {
+                return write_iobuf_to_output_stream(std::move(body), out)
+                  .finally([&out] { return out.close(); });
+            });
+      });
+}
+
 inline std::unique_ptr<ss::httpd::reply> unprocessable_entity(ss::sstring msg) {
     return errored_body(
       make_error_condition(reply_error_code::kafka_bad_request),
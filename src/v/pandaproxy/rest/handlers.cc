@@ -9,6 +9,8 @@
 
 #include "handlers.h"
 
+#include "hashing/jump_consistent_hash.h"
+#include "hashing/xx.h"
 #include "kafka/client/exceptions.h"
 #include "kafka/protocol/errors.h"
 #include "kafka/protocol/fetch.h"
@@ -31,7 +33,9 @@
 #include "pandaproxy/parsing/httpd.h"
 #include "pandaproxy/reply.h"
 #include "pandaproxy/rest/configuration.h"
+#include "pandaproxy/rest/produce_binary.h"
 #include "raft/types.h"
+#include "random/generators.h"
 #include "ssx/future-util.h"
 #include "ssx/sformat.h"
 #include "storage/record_batch_builder.h"
@@ -56,9 +60,26 @@ namespace {
 
 using server = ctx_server<proxy>;
 
-ss::shard_id consumer_shard(const kafka::group_id& g_id) {
-    auto hash = xxhash_64(g_id().data(), g_id().length());
-    return jump_consistent_hash(hash, ss::smp::count);
+iobuf content_to_iobuf(const ss::httpd::request& req) {
+    iobuf buf;
+    buf.append(req.content.data(), req.content.size());
+    return buf;
+}
+
+/// Consumer instances are spread across the shards by the hash of their
+/// group and name, so that the fetches and the encoding of a busy group are
+/// not served by a single core. Each shard has its own kafka client.
+ss::shard_id
+consumer_shard(const kafka::group_id& g_id, const kafka::member_id& name) {
+    incremental_xxhash64 inc;
+    inc.update_all(g_id, name);
+    return jump_consistent_hash(inc.digest(), ss::smp::count);
+}
+
+/// The instance must be named before it is created to know its shard
+kafka::member_id make_consumer_name() {
+    return kafka::member_id(ssx::sformat(
+      "rest-consumer-{}", random_generators::gen_alphanum_string(16)));
 }
 
 } // namespace
@@ -123,14 +144,8 @@ get_topics_records(server::request_t rq, server::reply_t rp) {
       .local()
       .fetch_partition(std::move(tp), offset, max_bytes, timeout)
       .then([res_fmt, rp = std::move(rp)](kafka::fetch_response res) mutable {
-          rapidjson::StringBuffer str_buf;
-          rapidjson::Writer<rapidjson::StringBuffer> w(str_buf);
-
-          ppj::rjson_serialize_fmt(res_fmt)(w, std::move(res));
-
-          // TODO Ben: Prevent this linearization
-          ss::sstring json_rslt = str_buf.GetString();
-          rp.rep->write_body("json", json_rslt);
+          write_body(
+            *rp.rep, ppj::rjson_serialize_iobuf(res_fmt, std::move(res)));
           rp.mime_type = res_fmt;
           return std::move(rp);
       });
@@ -141,15 +156,33 @@ post_topics_name(server::request_t rq, server::reply_t rp) {
     auto req_fmt = parse::content_type_header(
       *rq.req,
       {json::serialization_format::binary_v2,
-       json::serialization_format::json_v2});
+       json::serialization_format::json_v2,
+       json::serialization_format::application_octet,
+       json::serialization_format::avro_octet_v2});
     auto res_fmt = parse::accept_header(
       *rq.req,
       {json::serialization_format::v2, json::serialization_format::none});
 
     auto topic = parse::request_param<model::topic>(*rq.req, "topic_name");
 
-    auto records = ppj::rjson_parse(
-      rq.req->content.data(), ppj::produce_request_handler(req_fmt));
+    std::vector<kafka::client::record_essence> records;
+    switch (req_fmt) {
+    case json::serialization_format::application_octet:
+        records = parse_binary_records(content_to_iobuf(*rq.req));
+        break;
+    case json::serialization_format::avro_octet_v2: {
+        auto key_schema_id = parse::query_param<std::optional<int32_t>>(
+          *rq.req, "key_schema_id");
+        auto value_schema_id = parse::query_param<int32_t>(
+          *rq.req, "value_schema_id");
+        records = parse_binary_records(
+          content_to_iobuf(*rq.req), key_schema_id, value_schema_id);
+        break;
+    }
+    default:
+        records = ppj::rjson_parse(
+          rq.req->content.data(), ppj::produce_request_handler(req_fmt));
+    }
 
     auto res = co_await rq.service().client().local().produce_records(
       topic, std::move(records));
@@ -201,6 +234,11 @@ create_consumer(server::request_t rq, server::reply_t rp) {
           parse::error_code::invalid_param, "auto.commit must be false");
     }
 
+    if (req_data.name == kafka::no_member) {
+        req_data.name = make_consumer_name();
+    }
+    auto shard = consumer_shard(group_id, req_data.name);
+
     auto handler =
       [group_id,
        res_fmt,
@@ -219,7 +257,7 @@ create_consumer(server::request_t rq, server::reply_t rp) {
     };
 
     co_return co_await rq.service().client().invoke_on(
-      consumer_shard(group_id), rq.context().smp_sg, std::move(handler));
+      shard, rq.context().smp_sg, std::move(handler));
 }
 
 ss::future<server::reply_t>
@@ -243,7 +281,9 @@ remove_consumer(server::request_t rq, server::reply_t rp) {
     };
 
     co_return co_await rq.service().client().invoke_on(
-      consumer_shard(group_id), rq.context().smp_sg, std::move(handler));
+      consumer_shard(group_id, member_id),
+      rq.context().smp_sg,
+      std::move(handler));
 }
 
 ss::future<server::reply_t>
@@ -277,7 +317,9 @@ subscribe_consumer(server::request_t rq, server::reply_t rp) {
     };
 
     co_return co_await rq.service().client().invoke_on(
-      consumer_shard(group_id), rq.context().smp_sg, std::move(handler));
+      consumer_shard(group_id, member_id),
+      rq.context().smp_sg,
+      std::move(handler));
 }
 
 ss::future<server::reply_t>
@@ -308,20 +350,16 @@ consumer_fetch(server::request_t rq, server::reply_t rp) {
         kafka::client::client& client) mutable -> ss::future<server::reply_t> {
         auto res = co_await client.consumer_fetch(
           group_id, name, timeout, max_bytes);
-        rapidjson::StringBuffer str_buf;
-        rapidjson::Writer<rapidjson::StringBuffer> w(str_buf);
-
-        ppj::rjson_serialize_fmt(res_fmt)(w, std::move(res));
-
-        // TODO Ben: Prevent this linearization
-        ss::sstring json_rslt = str_buf.GetString();
-        rp.rep->write_body("json", json_rslt);
+        write_body(
+          *rp.rep, ppj::rjson_serialize_iobuf(res_fmt, std::move(res)));
         rp.mime_type = res_fmt;
         co_return std::move(rp);
     };
 
     co_return co_await rq.service().client().invoke_on(
-      consumer_shard(group_id), rq.context().smp_sg, std::move(handler));
+      consumer_shard(group_id, name),
+      rq.context().smp_sg,
+      std::move(handler));
 }
 
 ss::future<server::reply_t>
@@ -357,7 +395,9 @@ get_consumer_offsets(server::request_t rq, server::reply_t rp) {
     };
 
     co_return co_await rq.service().client().invoke_on(
-      consumer_shard(group_id), rq.context().smp_sg, std::move(handler));
+      consumer_shard(group_id, member_id),
+      rq.context().smp_sg,
+      std::move(handler));
 }
 
 ss::future<server::reply_t>
@@ -392,7 +432,9 @@ post_consumer_offsets(server::request_t rq, server::reply_t rp) {
     };
 
     co_return co_await rq.service().client().invoke_on(
-      consumer_shard(group_id), rq.context().smp_sg, std::move(handler));
+      consumer_shard(group_id, member_id),
+      rq.context().smp_sg,
+      std::move(handler));
 }
 
 } // namespace pandaproxy::rest
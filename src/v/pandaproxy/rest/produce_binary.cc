@@ -0,0 +1,101 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "pandaproxy/rest/produce_binary.h"
+
+#include "bytes/iobuf_parser.h"
+#include "pandaproxy/parsing/exceptions.h"
+
+#include <seastar/net/byteorder.hh>
+
+#include <fmt/format.h>
+
+#include <array>
+
+namespace pandaproxy::rest {
+
+namespace {
+
+constexpr char schema_registry_magic = 0;
+
+iobuf schema_registry_framed(int32_t schema_id, iobuf payload) {
+    std::array<char, sizeof(schema_registry_magic) + sizeof(int32_t)> hdr{
+      schema_registry_magic};
+    ss::write_be<int32_t>(hdr.data() + 1, schema_id);
+    iobuf framed;
+    framed.append(hdr.data(), hdr.size());
+    framed.append(std::move(payload));
+    return framed;
+}
+
+class record_parser {
+public:
+    explicit record_parser(iobuf body)
+      : _in(std::move(body)) {}
+
+    bool done() const { return _in.bytes_left() == 0; }
+
+    int32_t consume_int32(std::string_view field) {
+        if (_in.bytes_left() < sizeof(int32_t)) {
+            throw_truncated(field);
+        }
+        return _in.consume_be_type<int32_t>();
+    }
+
+    std::optional<iobuf>
+    consume_bytes(std::string_view field, std::optional<int32_t> schema_id) {
+        const auto len = consume_int32(field);
+        if (len < 0) {
+            return std::nullopt;
+        }
+        if (_in.bytes_left() < static_cast<size_t>(len)) {
+            throw_truncated(field);
+        }
+        auto buf = _in.share(len);
+        if (schema_id) {
+            return schema_registry_framed(*schema_id, std::move(buf));
+        }
+        return buf;
+    }
+
+private:
+    [[noreturn]] void throw_truncated(std::string_view field) const {
+        throw parse::error(
+          parse::error_code::invalid_body,
+          fmt::format(
+            "Truncated record {} at offset {}", field, _in.bytes_consumed()));
+    }
+
+    iobuf_parser _in;
+};
+
+} // namespace
+
+std::vector<kafka::client::record_essence> parse_binary_records(
+  iobuf body,
+  std::optional<int32_t> key_schema_id,
+  std::optional<int32_t> value_schema_id) {
+    std::vector<kafka::client::record_essence> records;
+    record_parser in(std::move(body));
+    while (!in.done()) {
+        auto& r = records.emplace_back();
+        if (auto p = in.consume_int32("partition"); p >= 0) {
+            r.partition_id = model::partition_id(p);
+        }
+        r.key = in.consume_bytes("key", key_schema_id);
+        r.value = in.consume_bytes("value", value_schema_id);
+    }
+    if (records.empty()) {
+        throw parse::error(
+          parse::error_code::invalid_body, "Expected at least one record");
+    }
+    return records;
+}
+
+} // namespace pandaproxy::rest
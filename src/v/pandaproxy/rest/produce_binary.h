@@ -0,0 +1,48 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/iobuf.h"
+#include "kafka/client/types.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace pandaproxy::rest {
+
+/**
+ * Parses the body of an octet-stream produce request.
+ *
+ * The body is a sequence of records, each framed as, big endian:
+ *
+ *   int32 partition  | -1 for the default partitioning
+ *   int32 key_len    | -1 for a null key
+ *   key_len bytes
+ *   int32 value_len  | -1 for a null value
+ *   value_len bytes
+ *
+ * The keys and values share the fragments of the body, nothing is copied
+ * per record.
+ *
+ * When a schema id is given, the keys (resp. values) are already Avro
+ * encoded and are prefixed with the schema registry wire header, the magic
+ * byte 0 and the big endian schema id.
+ *
+ * Throws parse::error(invalid_body) on a truncated or malformed body.
+ */
+std::vector<kafka::client::record_essence> parse_binary_records(
+  iobuf body,
+  std::optional<int32_t> key_schema_id = std::nullopt,
+  std::optional<int32_t> value_schema_id = std::nullopt);
+
+} // namespace pandaproxy::rest
@@ -12,13 +12,47 @@
 #include "pandaproxy/test/pandaproxy_fixture.h"
 #include "pandaproxy/test/utils.h"
 
+#include <seastar/net/byteorder.hh>
+
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
 #include <boost/test/tools/old/interface.hpp>
 
+#include <array>
+#include <optional>
+
 namespace ppj = pandaproxy::json;
 
+namespace {
+
+void append_int32(iobuf& buf, int32_t v) {
+    std::array<char, sizeof(int32_t)> be{};
+    ss::write_be<int32_t>(be.data(), v);
+    buf.append(be.data(), be.size());
+}
+
+void append_bytes(iobuf& buf, std::optional<std::string_view> v) {
+    if (!v) {
+        append_int32(buf, -1);
+        return;
+    }
+    append_int32(buf, static_cast<int32_t>(v->size()));
+    buf.append(v->data(), v->size());
+}
+
+void append_record(
+  iobuf& buf,
+  int32_t partition,
+  std::optional<std::string_view> key,
+  std::optional<std::string_view> value) {
+    append_int32(buf, partition);
+    append_bytes(buf, key);
+    append_bytes(buf, value);
+}
+
+} // namespace
+
 FIXTURE_TEST(pandaproxy_produce, pandaproxy_test_fixture) {
     using namespace std::chrono_literals;
 
@@ -133,3 +167,118 @@ FIXTURE_TEST(pandaproxy_produce, pandaproxy_test_fixture) {
           res.body, R"({"offsets":[{"partition":0,"offset":3}]})");
     }
 }
+
+FIXTURE_TEST(pandaproxy_produce_octet, pandaproxy_test_fixture) {
+    using namespace std::chrono_literals;
+
+    set_client_config("retry_base_backoff_ms", 10ms);
+    set_client_config("produce_batch_delay_ms", 0ms);
+
+    info("Waiting for leadership");
+    wait_for_controller_leadership().get();
+
+    info("Connecting client");
+    auto client = make_proxy_client();
+
+    info("Adding known topic");
+    auto tp = model::topic_partition(model::topic("t"), model::partition_id(0));
+    auto ntp = make_default_ntp(tp.topic, tp.partition);
+    add_topic(model::topic_namespace_view(ntp)).get();
+
+    {
+        info("Produce octet-stream to known topic");
+        set_client_config("retries", size_t(5));
+        iobuf body;
+        append_record(body, 0, "k", "vectorized");
+        append_record(body, 0, std::nullopt, "pandaproxy");
+        auto res = http_request(
+          client,
+          "/topics/t",
+          std::move(body),
+          boost::beast::http::verb::post,
+          ppj::serialization_format::application_octet,
+          ppj::serialization_format::v2);
+
+        BOOST_REQUIRE_EQUAL(
+          res.headers.result(), boost::beast::http::status::ok);
+        BOOST_REQUIRE_EQUAL(
+          res.body, R"({"offsets":[{"partition":0,"offset":0}]})");
+    }
+
+    {
+        info("Produce avro without value_schema_id");
+        set_client_config("retries", size_t(0));
+        iobuf body;
+        append_record(body, 0, std::nullopt, "vectorized");
+        auto res = http_request(
+          client,
+          "/topics/t",
+          std::move(body),
+          boost::beast::http::verb::post,
+          ppj::serialization_format::avro_octet_v2,
+          ppj::serialization_format::v2);
+
+        BOOST_REQUIRE_EQUAL(
+          res.headers.result(), boost::beast::http::status::bad_request);
+        BOOST_REQUIRE_EQUAL(
+          res.body,
+          R"({"error_code":40002,"message":"Missing mandatory parameter 'value_schema_id'"})");
+    }
+
+    {
+        info("Produce avro with value_schema_id");
+        iobuf body;
+        append_record(body, 0, std::nullopt, "vectorized");
+        auto res = http_request(
+          client,
+          "/topics/t?value_schema_id=1",
+          std::move(body),
+          boost::beast::http::verb::post,
+          ppj::serialization_format::avro_octet_v2,
+          ppj::serialization_format::v2);
+
+        BOOST_REQUIRE_EQUAL(
+          res.headers.result(), boost::beast::http::status::ok);
+        BOOST_REQUIRE_EQUAL(
+          res.body, R"({"offsets":[{"partition":0,"offset":2}]})");
+    }
+
+    {
+        info("Produce truncated octet-stream");
+        iobuf body;
+        append_int32(body, 0);
+        append_int32(body, -1);
+        append_int32(body, 10);
+        body.append("abc", 3);
+        auto res = http_request(
+          client,
+          "/topics/t",
+          std::move(body),
+          boost::beast::http::verb::post,
+          ppj::serialization_format::application_octet,
+          ppj::serialization_format::v2);
+
+        BOOST_REQUIRE_EQUAL(
+          res.headers.result(), boost::beast::http::status::bad_request);
+        BOOST_REQUIRE_EQUAL(
+          res.body,
+          R"({"error_code":40002,"message":"Truncated record value at offset 12"})");
+    }
+
+    {
+        info("Fetch offset 0 - expect offsets 0-2");
+        auto res = http_request(
+          client,
+          "/topics/t/partitions/0/"
+          "records?offset=0&max_bytes=1024&timeout=5000",
+          boost::beast::http::verb::get,
+          ppj::serialization_format::v2,
+          ppj::serialization_format::binary_v2);
+
+        BOOST_REQUIRE_EQUAL(
+          res.headers.result(), boost::beast::http::status::ok);
+        BOOST_REQUIRE_EQUAL(
+          res.body,
+          R"([{"topic":"t","key":"aw==","value":"dmVjdG9yaXplZA==","partition":0,"offset":0},{"topic":"t","key":null,"value":"cGFuZGFwcm94eQ==","partition":0,"offset":1},{"topic":"t","key":null,"value":"AAAAAAF2ZWN0b3JpemVk","partition":0,"offset":2}])");
+    }
+}
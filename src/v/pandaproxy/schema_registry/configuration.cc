@@ -35,6 +35,13 @@ configuration::configuration()
       "api_doc_dir",
       "API doc directory",
       config::required::no,
-      "/usr/share/redpanda/proxy-api-doc") {}
+      "/usr/share/redpanda/proxy-api-doc")
+  , store_snapshot(
+      *this,
+      "store_snapshot",
+      "Save the schemas to a local snapshot after replaying the _schemas "
+      "topic, the next start only replays the records written since",
+      config::required::no,
+      true) {}
 
 } // namespace pandaproxy::schema_registry
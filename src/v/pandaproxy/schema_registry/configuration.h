@@ -27,6 +27,7 @@ struct configuration final : public config::config_store {
     config::one_or_many_property<config::endpoint_tls_config>
       schema_registry_api_tls;
     config::property<ss::sstring> api_doc_dir;
+    config::property<bool> store_snapshot;
 };
 
 } // namespace pandaproxy::schema_registry
@@ -9,6 +9,8 @@
 
 #include "pandaproxy/schema_registry/service.h"
 
+#include "bytes/iobuf_parser.h"
+#include "config/configuration.h"
 #include "kafka/protocol/create_topics.h"
 #include "kafka/protocol/errors.h"
 #include "kafka/protocol/list_offsets.h"
@@ -21,6 +23,8 @@
 #include "pandaproxy/schema_registry/configuration.h"
 #include "pandaproxy/schema_registry/handlers.h"
 #include "pandaproxy/schema_registry/storage.h"
+#include "pandaproxy/schema_registry/store.h"
+#include "reflection/adl.h"
 #include "utils/gate_guard.h"
 
 #include <seastar/core/coroutine.hh>
@@ -31,6 +35,13 @@
 
 namespace pandaproxy::schema_registry {
 
+/// Name of the snapshot of the store in the data directory
+static constexpr std::string_view snapshot_filename
+  = "schema_registry.snapshot";
+static constexpr int8_t snapshot_version = 1;
+/// Min number of the replayed writes applied to the store at once
+static constexpr size_t replay_batch_writes = 1024;
+
 using server = ctx_server<service>;
 
 template<typename Handler>
@@ -167,12 +178,126 @@ ss::future<> service::fetch_internal_topic() {
     auto max_offset = partition.offset;
     vlog(plog.debug, "Schema registry: _schemas max_offset: {}", max_offset);
 
-    co_await make_client_fetch_batch_reader(
+    auto start_offset = co_await restore_snapshot(max_offset);
+    if (start_offset >= max_offset) {
+        co_return;
+    }
+    auto reader = make_client_fetch_batch_reader(
       _client.local(),
       model::schema_registry_internal_tp,
-      model::offset{0},
-      max_offset)
-      .consume(consume_to_store{_store}, model::no_timeout);
+      start_offset,
+      max_offset);
+    auto records = co_await std::move(reader).consume(
+      consume_to_store{_store, replay_batch_writes, start_offset},
+      model::no_timeout);
+    vlog(
+      plog.info,
+      "Schema registry: replayed {} records of _schemas from offset {}",
+      records,
+      start_offset);
+    co_await write_snapshot(max_offset);
+}
+
+ss::future<model::offset>
+service::restore_snapshot(model::offset max_offset) {
+    if (!_config.store_snapshot()) {
+        co_return model::offset{0};
+    }
+    auto reader = co_await _snapshot.open_snapshot();
+    if (!reader) {
+        co_return model::offset{0};
+    }
+    std::optional<model::offset> next_offset;
+    std::exception_ptr ex;
+    try {
+        next_offset = co_await read_snapshot(*reader, max_offset);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await reader->close();
+    co_await _snapshot.remove_partial_snapshots();
+    if (ex) {
+        vlog(
+          plog.warn,
+          "Schema registry: unable to read snapshot {}, replaying _schemas "
+          "from the start - {}",
+          _snapshot.snapshot_path(),
+          ex);
+    }
+    co_return next_offset.value_or(model::offset{0});
+}
+
+ss::future<std::optional<model::offset>> service::read_snapshot(
+  storage::snapshot_reader& reader, model::offset max_offset) {
+    iobuf_parser meta(co_await reader.read_metadata());
+    auto version = reflection::adl<int8_t>{}.from(meta);
+    if (version != snapshot_version) {
+        vlog(
+          plog.warn,
+          "Schema registry: ignoring snapshot with unsupported version {}",
+          version);
+        co_return std::nullopt;
+    }
+    auto next_offset = reflection::adl<model::offset>{}.from(meta);
+    auto size = reflection::adl<uint64_t>{}.from(meta);
+    if (next_offset > max_offset) {
+        // the topic was recreated since the snapshot
+        vlog(
+          plog.info,
+          "Schema registry: ignoring snapshot at offset {}, _schemas ends at "
+          "{}",
+          next_offset,
+          max_offset);
+        co_return std::nullopt;
+    }
+    auto snap = reflection::adl<store_snapshot>{}.from(
+      co_await read_iobuf_exactly(reader.input(), size));
+    co_await _store.restore(snap);
+    vlog(
+      plog.info,
+      "Schema registry: restored {} schemas and {} subjects from snapshot at "
+      "offset {}",
+      snap.schemas.size(),
+      snap.subjects.size(),
+      next_offset);
+    co_return next_offset;
+}
+
+ss::future<> service::write_snapshot(model::offset next_offset) {
+    if (!_config.store_snapshot()) {
+        co_return;
+    }
+    std::exception_ptr ex;
+    try {
+        iobuf data;
+        reflection::adl<store_snapshot>{}.to(
+          data, co_await _store.make_snapshot());
+        iobuf meta;
+        reflection::serialize(
+          meta, snapshot_version, next_offset, uint64_t(data.size_bytes()));
+
+        auto writer = co_await _snapshot.start_snapshot();
+        try {
+            co_await writer.write_metadata(std::move(meta));
+            co_await write_iobuf_to_output_stream(
+              std::move(data), writer.output());
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await writer.close();
+        if (!ex) {
+            co_await _snapshot.finish_snapshot(writer);
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        vlog(
+          plog.warn,
+          "Schema registry: unable to write snapshot {} - {}",
+          _snapshot.snapshot_path(),
+          ex);
+    }
 }
 
 service::service(
@@ -192,6 +317,10 @@ service::service(
       "/schema_registry_definitions",
       _ctx)
   , _store(store)
+  , _snapshot(
+      config::shard_local_cfg().data_directory().path,
+      ss::sstring(snapshot_filename),
+      ss::default_priority_class())
   , _ensure_started{[this]() { return do_start(); }} {}
 
 ss::future<> service::start() {
@@ -17,6 +17,7 @@
 #include "pandaproxy/schema_registry/util.h"
 #include "pandaproxy/server.h"
 #include "seastarx.h"
+#include "storage/snapshot.h"
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
@@ -48,6 +49,10 @@ private:
     ss::future<> do_start();
     ss::future<> create_internal_topic();
     ss::future<> fetch_internal_topic();
+    ss::future<model::offset> restore_snapshot(model::offset max_offset);
+    ss::future<std::optional<model::offset>>
+    read_snapshot(storage::snapshot_reader& reader, model::offset max_offset);
+    ss::future<> write_snapshot(model::offset next_offset);
     configuration _config;
     ss::semaphore _mem_sem;
     ss::gate _gate;
@@ -55,6 +60,7 @@ private:
     ctx_server<service>::context_t _ctx;
     ctx_server<service> _server;
     sharded_store& _store;
+    storage::snapshot_manager _snapshot;
     one_shot _ensure_started;
 };
 
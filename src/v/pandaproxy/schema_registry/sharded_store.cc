@@ -18,12 +18,15 @@
 #include "pandaproxy/schema_registry/errors.h"
 #include "pandaproxy/schema_registry/store.h"
 #include "pandaproxy/schema_registry/types.h"
+#include "vlog.h"
 
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/smp.hh>
 #include <seastar/core/std-coroutine.hh>
 
+#include <algorithm>
+
 namespace pandaproxy::schema_registry {
 
 namespace {
@@ -37,20 +40,267 @@ ss::shard_id shard_for(schema_id id) {
     return jump_consistent_hash(id(), ss::smp::count);
 }
 
+template<typename T>
+void ignore_failed(const result<T>& res) {
+    if (res.has_error()) {
+        vlog(plog.debug, "Ignoring: {}", res.error().message());
+    }
+}
+
 } // namespace
 
+std::optional<schema>
+sharded_store::read_cache::get_schema(const schema_id& id) const {
+    auto it = _schemas.find(id);
+    if (it == _schemas.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void sharded_store::read_cache::put_schema(
+  const schema& s, uint64_t generation) {
+    if (generation == _generation) {
+        _schemas.insert_or_assign(s.id, s);
+    }
+}
+
+std::optional<subject_version_id> sharded_store::read_cache::get_version_id(
+  const subject& sub, schema_version version) const {
+    auto sub_it = _versions.find(sub);
+    if (sub_it == _versions.end()) {
+        return std::nullopt;
+    }
+    auto v_it = sub_it->second.find(version);
+    if (v_it == sub_it->second.end()) {
+        return std::nullopt;
+    }
+    return v_it->second;
+}
+
+void sharded_store::read_cache::put_version_id(
+  const subject& sub, subject_version_id v_id, uint64_t generation) {
+    if (generation == _generation) {
+        _versions[sub].insert_or_assign(v_id.version, v_id);
+    }
+}
+
+std::optional<avro_schema_definition>
+sharded_store::read_cache::get_avro(const schema_id& id) const {
+    auto it = _avro.find(id);
+    if (it == _avro.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void sharded_store::read_cache::put_avro(
+  const schema_id& id, avro_schema_definition def, uint64_t generation) {
+    if (generation == _generation) {
+        _avro.insert_or_assign(id, std::move(def));
+    }
+}
+
+std::optional<bool> sharded_store::read_cache::get_compatible(
+  const schema_definition& new_def,
+  const schema_id& old_id,
+  bool new_is_reader) const {
+    auto it = _compat.find(compat_key{new_def, old_id, new_is_reader});
+    if (it == _compat.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void sharded_store::read_cache::put_compatible(
+  const schema_definition& new_def,
+  const schema_id& old_id,
+  bool new_is_reader,
+  bool compatible,
+  uint64_t generation) {
+    if (generation != _generation) {
+        return;
+    }
+    if (_compat.size() >= max_compat_entries) {
+        _compat.clear();
+    }
+    _compat.insert_or_assign(
+      compat_key{new_def, old_id, new_is_reader}, compatible);
+}
+
+void sharded_store::read_cache::invalidate(const schema_id& id) {
+    ++_generation;
+    _schemas.erase(id);
+    _avro.erase(id);
+    absl::erase_if(
+      _compat, [&id](const auto& e) { return e.first.old_id == id; });
+}
+
+void sharded_store::read_cache::invalidate(const subject& sub) {
+    ++_generation;
+    _versions.erase(sub);
+}
+
+void sharded_store::read_cache::clear() {
+    ++_generation;
+    _schemas.clear();
+    _avro.clear();
+    _compat.clear();
+    _versions.clear();
+}
+
+sharded_store::replay_batch::replay_batch()
+  : _writes(ss::smp::count) {}
+
+void sharded_store::replay_batch::add(ss::shard_id shard, write w) {
+    _writes[shard].push_back(std::move(w));
+    ++_size;
+}
+
+void sharded_store::replay_batch::upsert(
+  subject sub,
+  schema_definition def,
+  schema_type type,
+  schema_id id,
+  schema_version version,
+  is_deleted deleted) {
+    _max_id = std::max(_max_id.value_or(id), id);
+    add(shard_for(id), [id, def = std::move(def), type](store& s) {
+        s.upsert_schema(id, def, type);
+    });
+    add(shard_for(sub), [sub, version, id, deleted](store& s) {
+        s.upsert_subject(sub, version, id, deleted);
+    });
+}
+
+void sharded_store::replay_batch::delete_subject_version(
+  subject sub, schema_version version) {
+    add(shard_for(sub), [sub, version](store& s) {
+        ignore_failed(s.delete_subject_version(
+          sub, version, permanent_delete::yes, include_deleted::yes));
+    });
+}
+
+void sharded_store::replay_batch::delete_subject(subject sub) {
+    add(shard_for(sub), [sub](store& s) {
+        ignore_failed(s.delete_subject(sub, permanent_delete::no));
+    });
+}
+
+void sharded_store::replay_batch::set_compatibility(
+  compatibility_level compatibility) {
+    for (ss::shard_id shard = 0; shard < ss::smp::count; ++shard) {
+        add(shard, [compatibility](store& s) {
+            ignore_failed(s.set_compatibility(compatibility));
+        });
+    }
+}
+
+void sharded_store::replay_batch::set_compatibility(
+  subject sub, compatibility_level compatibility) {
+    add(shard_for(sub), [sub, compatibility](store& s) {
+        ignore_failed(s.set_compatibility(sub, compatibility));
+    });
+}
+
+void sharded_store::replay_batch::clear_compatibility(subject sub) {
+    add(shard_for(sub), [sub](store& s) {
+        ignore_failed(s.clear_compatibility(sub));
+    });
+}
+
 ss::future<> sharded_store::start(ss::smp_service_group sg) {
     _smp_opts = ss::smp_submit_to_options{sg};
-    return _store.start();
+    co_await _store.start();
+    co_await _cache.start();
+}
+
+ss::future<> sharded_store::stop() {
+    co_await _cache.stop();
+    co_await _store.stop();
+}
+
+ss::future<> sharded_store::invalidate(schema_id id) {
+    return _cache.invoke_on_all(
+      _smp_opts, [id](read_cache& c) { c.invalidate(id); });
+}
+
+ss::future<> sharded_store::invalidate(const subject& sub) {
+    return _cache.invoke_on_all(
+      _smp_opts, [&sub](read_cache& c) { c.invalidate(sub); });
+}
+
+ss::future<> sharded_store::clear_cache() {
+    return _cache.invoke_on_all(_smp_opts, [](read_cache& c) { c.clear(); });
+}
+
+ss::future<> sharded_store::replay(const replay_batch& batch) {
+    if (batch._max_id) {
+        co_await maybe_update_max_schema_id(*batch._max_id);
+    }
+    co_await _store.invoke_on_all(_smp_opts, [&batch](store& s) {
+        for (const auto& w : batch._writes[ss::this_shard_id()]) {
+            w(s);
+        }
+    });
+    co_await clear_cache();
+}
+
+ss::future<store_snapshot> sharded_store::make_snapshot() {
+    auto map = [](store& s) {
+        store_snapshot snap;
+        s.add_to_snapshot(snap);
+        return snap;
+    };
+    auto reduce = [](store_snapshot acc, store_snapshot snap) {
+        // the global compatibility is the same on every shard
+        acc.compatibility = snap.compatibility;
+        acc.schemas.insert(
+          acc.schemas.end(),
+          std::make_move_iterator(snap.schemas.begin()),
+          std::make_move_iterator(snap.schemas.end()));
+        acc.subjects.insert(
+          acc.subjects.end(),
+          std::make_move_iterator(snap.subjects.begin()),
+          std::make_move_iterator(snap.subjects.end()));
+        return acc;
+    };
+    co_return co_await _store.map_reduce0(map, store_snapshot{}, reduce);
 }
 
-ss::future<> sharded_store::stop() { return _store.stop(); }
+ss::future<> sharded_store::restore(const store_snapshot& snap) {
+    if (!snap.schemas.empty()) {
+        auto max_id = std::max_element(
+          snap.schemas.begin(),
+          snap.schemas.end(),
+          [](const auto& lhs, const auto& rhs) { return lhs.id < rhs.id; });
+        co_await maybe_update_max_schema_id(max_id->id);
+    }
+    co_await _store.invoke_on_all(_smp_opts, [&snap](store& s) {
+        const auto shard = ss::this_shard_id();
+        ignore_failed(s.set_compatibility(snap.compatibility));
+        for (const auto& e : snap.schemas) {
+            if (shard_for(e.id) == shard) {
+                s.restore(e);
+            }
+        }
+        for (const auto& e : snap.subjects) {
+            if (shard_for(e.sub) == shard) {
+                s.restore(e);
+            }
+        }
+    });
+    co_await clear_cache();
+}
 
 ss::future<sharded_store::insert_result>
 sharded_store::insert(subject sub, schema_definition def, schema_type type) {
     auto id = (co_await insert_schema(std::move(def), type)).id;
     auto [version, inserted] = co_await _store.invoke_on(
       shard_for(sub), &store::insert_subject, sub, id);
+    if (inserted) {
+        co_await invalidate(sub);
+    }
     co_return insert_result{version, id, inserted};
 }
 
@@ -66,20 +316,38 @@ ss::future<bool> sharded_store::upsert(
 }
 
 ss::future<schema> sharded_store::get_schema(const schema_id& id) {
-    auto schema = co_await _store.invoke_on(
-      shard_for(id), &store::get_schema, id);
-    co_return std::move(schema).value();
+    auto& cache = _cache.local();
+    if (auto s = cache.get_schema(id); s) {
+        co_return std::move(*s);
+    }
+    const auto generation = cache.generation();
+    auto s = (co_await _store.invoke_on(
+                shard_for(id), &store::get_schema, id))
+               .value();
+    cache.put_schema(s, generation);
+    co_return s;
 }
 
 ss::future<subject_schema> sharded_store::get_subject_schema(
   const subject& sub, schema_version version, include_deleted inc_del) {
-    auto v_id = (co_await _store.invoke_on(
-                   shard_for(sub),
-                   &store::get_subject_version_id,
-                   sub,
-                   version,
-                   inc_del))
-                  .value();
+    auto& cache = _cache.local();
+    auto cached = cache.get_version_id(sub, version);
+    if (!cached) {
+        const auto generation = cache.generation();
+        cached = (co_await _store.invoke_on(
+                    shard_for(sub),
+                    &store::get_subject_version_id,
+                    sub,
+                    version,
+                    inc_del))
+                   .value();
+        // Only the live versions are cached: the subject of a deleted one
+        // may be soft deleted too, which the entry doesn't track
+        if (!inc_del) {
+            cache.put_version_id(sub, *cached, generation);
+        }
+    }
+    auto v_id = std::move(*cached);
     auto s = co_await get_schema(v_id.id);
 
     co_return subject_schema{
@@ -115,6 +383,7 @@ ss::future<std::vector<schema_version>>
 sharded_store::delete_subject(const subject& sub, permanent_delete permanent) {
     auto versions = co_await _store.invoke_on(
       shard_for(sub), &store::delete_subject, sub, permanent);
+    co_await invalidate(sub);
     co_return std::move(versions).value();
 }
 
@@ -130,6 +399,7 @@ ss::future<bool> sharded_store::delete_subject_version(
       version,
       permanent,
       inc_del);
+    co_await invalidate(sub);
     co_return deleted.value();
 }
 
@@ -193,21 +463,28 @@ sharded_store::insert_schema(schema_definition def, schema_type type) {
 ss::future<bool> sharded_store::upsert_schema(
   schema_id id, schema_definition def, schema_type type) {
     co_await maybe_update_max_schema_id(id);
-    co_return co_await _store.invoke_on(
+    auto inserted = co_await _store.invoke_on(
       shard_for(id), &store::upsert_schema, id, std::move(def), type);
+    co_await invalidate(id);
+    co_return inserted;
 }
 
 ss::future<sharded_store::insert_subject_result>
 sharded_store::insert_subject(subject sub, schema_id id) {
     auto [version, inserted] = co_await _store.invoke_on(
       shard_for(sub), &store::insert_subject, sub, id);
+    if (inserted) {
+        co_await invalidate(sub);
+    }
     co_return insert_subject_result{version, inserted};
 }
 
 ss::future<bool> sharded_store::upsert_subject(
   subject sub, schema_version version, schema_id id, is_deleted deleted) {
-    co_return co_await _store.invoke_on(
+    auto inserted = co_await _store.invoke_on(
       shard_for(sub), &store::upsert_subject, sub, version, id, deleted);
+    co_await invalidate(sub);
+    co_return inserted;
 }
 
 ss::future<schema_id> sharded_store::allocate_schema_id() {
@@ -281,31 +558,65 @@ ss::future<bool> sharded_store::is_compatible(
         ver_it = versions.begin();
     }
 
-    auto new_avro = make_avro_schema_definition(new_schema()).value();
+    // Parsed on the first check that isn't memoized
+    std::optional<avro_schema_definition> new_avro;
     auto is_compat = true;
     for (; is_compat && ver_it != versions.end(); ++ver_it) {
         if (ver_it->deleted) {
             continue;
         }
 
-        auto old_schema = co_await get_schema(ver_it->id);
-        auto old_avro
-          = make_avro_schema_definition(old_schema.definition()).value();
-
         if (
           compat == compatibility_level::backward
           || compat == compatibility_level::backward_transitive
           || compat == compatibility_level::full) {
-            is_compat = is_compat && check_compatible(new_avro, old_avro);
+            is_compat = is_compat
+                        && co_await memoized_compatible(
+                          new_schema, new_avro, ver_it->id, true);
         }
         if (
           compat == compatibility_level::forward
           || compat == compatibility_level::forward_transitive
           || compat == compatibility_level::full) {
-            is_compat = is_compat && check_compatible(old_avro, new_avro);
+            is_compat = is_compat
+                        && co_await memoized_compatible(
+                          new_schema, new_avro, ver_it->id, false);
         }
     }
     co_return is_compat;
 }
 
+ss::future<avro_schema_definition>
+sharded_store::get_avro_schema(schema_id id) {
+    auto& cache = _cache.local();
+    if (auto def = cache.get_avro(id); def) {
+        co_return std::move(*def);
+    }
+    const auto generation = cache.generation();
+    auto s = co_await get_schema(id);
+    auto def = make_avro_schema_definition(s.definition()).value();
+    cache.put_avro(id, def, generation);
+    co_return def;
+}
+
+ss::future<bool> sharded_store::memoized_compatible(
+  const schema_definition& new_def,
+  std::optional<avro_schema_definition>& new_avro,
+  schema_id old_id,
+  bool new_is_reader) {
+    auto& cache = _cache.local();
+    if (auto r = cache.get_compatible(new_def, old_id, new_is_reader); r) {
+        co_return *r;
+    }
+    const auto generation = cache.generation();
+    auto old_avro = co_await get_avro_schema(old_id);
+    if (!new_avro) {
+        new_avro = make_avro_schema_definition(new_def()).value();
+    }
+    const bool r = new_is_reader ? check_compatible(*new_avro, old_avro)
+                                 : check_compatible(old_avro, *new_avro);
+    cache.put_compatible(new_def, old_id, new_is_reader, r, generation);
+    co_return r;
+}
+
 } // namespace pandaproxy::schema_registry
@@ -11,13 +11,22 @@
 
 #pragma once
 
+#include "pandaproxy/schema_registry/avro.h"
 #include "pandaproxy/schema_registry/types.h"
 
 #include <seastar/core/sharded.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include <absl/container/btree_map.h>
+#include <absl/container/node_hash_map.h>
+
+#include <optional>
+#include <vector>
 
 namespace pandaproxy::schema_registry {
 
 class store;
+struct store_snapshot;
 
 ///\brief Dispatch requests to shards based on a a hash of the
 /// subject or schema_id
@@ -94,7 +103,136 @@ public:
       const schema_definition& new_schema,
       schema_type new_schema_type);
 
+    ///\brief Writes replayed from the _schemas topic.
+    ///
+    /// The writes are grouped by the shard that owns the written state. Each
+    /// shard applies its writes in order, the shards apply them in parallel.
+    /// Writes that fail are ignored, as when they are applied one by one.
+    class replay_batch {
+    public:
+        replay_batch();
+
+        void upsert(
+          subject sub,
+          schema_definition def,
+          schema_type type,
+          schema_id id,
+          schema_version version,
+          is_deleted deleted);
+        void delete_subject_version(subject sub, schema_version version);
+        void delete_subject(subject sub);
+        void set_compatibility(compatibility_level compatibility);
+        void set_compatibility(subject sub, compatibility_level compatibility);
+        void clear_compatibility(subject sub);
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+    private:
+        friend class sharded_store;
+        using write = ss::noncopyable_function<void(store&)>;
+
+        void add(ss::shard_id shard, write w);
+
+        std::vector<std::vector<write>> _writes;
+        std::optional<schema_id> _max_id;
+        size_t _size{0};
+    };
+
+    ///\brief Apply the writes of the batch.
+    ss::future<> replay(const replay_batch& batch);
+
+    ///\brief Return the schemas and subjects of all the shards.
+    ss::future<store_snapshot> make_snapshot();
+
+    ///\brief Restore the schemas and subjects saved by make_snapshot() into
+    /// an empty store.
+    ss::future<> restore(const store_snapshot& snap);
+
 private:
+    ///\brief Per shard read through cache of the lookups of schemas by id
+    /// and of subject versions, which are immutable until deleted. Also
+    /// holds the parsed avro schemas and the results of the compatibility
+    /// checks against them.
+    ///
+    /// The writes invalidate the entries on every shard once applied. The
+    /// generation is bumped by each invalidation, a lookup that missed only
+    /// fills the cache if no invalidation happened meanwhile.
+    class read_cache {
+    public:
+        std::optional<schema> get_schema(const schema_id& id) const;
+        void put_schema(const schema& s, uint64_t generation);
+
+        std::optional<subject_version_id>
+        get_version_id(const subject& sub, schema_version version) const;
+        void put_version_id(
+          const subject& sub, subject_version_id v_id, uint64_t generation);
+
+        std::optional<avro_schema_definition>
+        get_avro(const schema_id& id) const;
+        void put_avro(
+          const schema_id& id, avro_schema_definition def, uint64_t generation);
+
+        ///\brief Memoized check_compatible() of a new schema, as the reader
+        /// or the writer, against an existing one
+        std::optional<bool> get_compatible(
+          const schema_definition& new_def,
+          const schema_id& old_id,
+          bool new_is_reader) const;
+        void put_compatible(
+          const schema_definition& new_def,
+          const schema_id& old_id,
+          bool new_is_reader,
+          bool compatible,
+          uint64_t generation);
+
+        void invalidate(const schema_id& id);
+        void invalidate(const subject& sub);
+        void clear();
+
+        uint64_t generation() const { return _generation; }
+
+        ss::future<> stop() { return ss::now(); }
+
+    private:
+        struct compat_key {
+            schema_definition new_def;
+            schema_id old_id;
+            bool new_is_reader;
+
+            bool operator==(const compat_key&) const = default;
+
+            template<typename H>
+            friend H AbslHashValue(H h, const compat_key& k) {
+                return H::combine(
+                  std::move(h), k.new_def, k.old_id, k.new_is_reader);
+            }
+        };
+        ///\brief Bound of the memoized checks, the new schemas are
+        /// arbitrary
+        static constexpr size_t max_compat_entries = 10000;
+
+        absl::btree_map<schema_id, schema> _schemas;
+        absl::btree_map<schema_id, avro_schema_definition> _avro;
+        absl::node_hash_map<compat_key, bool> _compat;
+        absl::node_hash_map<
+          subject,
+          absl::btree_map<schema_version, subject_version_id>>
+          _versions;
+        uint64_t _generation{0};
+    };
+
+    ss::future<avro_schema_definition> get_avro_schema(schema_id id);
+    ss::future<bool> memoized_compatible(
+      const schema_definition& new_def,
+      std::optional<avro_schema_definition>& new_avro,
+      schema_id old_id,
+      bool new_is_reader);
+
+    ss::future<> invalidate(schema_id id);
+    ss::future<> invalidate(const subject& sub);
+    ss::future<> clear_cache();
+
     struct insert_schema_result {
         schema_id id;
         bool inserted;
@@ -119,6 +257,7 @@ private:
 
     ss::smp_submit_to_options _smp_opts;
     ss::sharded<store> _store;
+    ss::sharded<read_cache> _cache;
     ///\brief Access must occur only on shard 0.
     schema_id _next_schema_id{1};
 };
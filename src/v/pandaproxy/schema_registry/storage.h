@@ -924,20 +924,43 @@ inline model::record_batch make_delete_subject_version_permanently_batch(
     return std::move(rb).build();
 }
 
+///\brief Replay the records of the _schemas topic into the store.
+///
+/// The decoded writes are applied in batches of at least max_writes writes,
+/// the records below start_offset are skipped. end_of_stream() applies the
+/// remaining writes and returns the number of replayed records.
 struct consume_to_store {
-    explicit consume_to_store(sharded_store& s)
-      : _store{s} {}
+    explicit consume_to_store(
+      sharded_store& s,
+      size_t max_writes = 1,
+      model::offset start_offset = model::offset{0})
+      : _store{s}
+      , _max_writes{max_writes}
+      , _start_offset{start_offset} {}
 
     ss::future<ss::stop_iteration> operator()(model::record_batch b) {
-        if (!b.header().attrs.is_control()) {
-            co_await model::for_each_record(b, [this](model::record& rec) {
-                return (*this)(std::move(rec));
+        if (
+          !b.header().attrs.is_control()
+          && b.last_offset() >= _start_offset) {
+            b.for_each_record([this, base = b.base_offset()](model::record r) {
+                if (base + r.offset_delta() >= _start_offset) {
+                    add(std::move(r));
+                }
             });
         }
+        if (_batch.size() >= _max_writes) {
+            co_await flush();
+        }
         co_return ss::stop_iteration::no;
     }
 
-    ss::future<> operator()(model::record record) {
+    ss::future<size_t> end_of_stream() {
+        co_await flush();
+        co_return _records;
+    }
+
+private:
+    void add(model::record record) {
         auto key = record.release_key();
         auto key_type_str = from_json_iobuf<topic_key_type_handler<>>(
           key.share(0, key.size_bytes()));
@@ -945,19 +968,20 @@ struct consume_to_store {
         auto key_type = from_string_view<topic_key_type>(key_type_str);
         if (!key_type.has_value()) {
             vlog(plog.error, "Ignoring keytype: {}", key_type_str);
-            co_return;
+            return;
         }
 
+        ++_records;
         switch (*key_type) {
         case topic_key_type::noop:
-            co_return;
+            return;
         case topic_key_type::schema: {
             std::optional<schema_value> val;
             if (!record.value().empty()) {
                 val.emplace(from_json_iobuf<schema_value_handler<>>(
                   record.release_value()));
             }
-            co_return co_await apply(
+            return add(
               from_json_iobuf<schema_key_handler<>>(std::move(key)),
               std::move(val));
         }
@@ -967,81 +991,78 @@ struct consume_to_store {
                 val.emplace(from_json_iobuf<config_value_handler<>>(
                   record.release_value()));
             }
-            co_return co_await apply(
+            return add(
               from_json_iobuf<config_key_handler<>>(std::move(key)), val);
         }
         case topic_key_type::delete_subject:
-            co_return co_await apply(
+            return add(
               from_json_iobuf<delete_subject_key_handler<>>(std::move(key)),
               from_json_iobuf<delete_subject_value_handler<>>(
                 record.release_value()));
         }
     }
 
-    ss::future<> apply(schema_key key, std::optional<schema_value> val) {
+    void add(schema_key key, std::optional<schema_value> val) {
         if (key.magic != 0 && key.magic != 1) {
             throw exception(
               error_code::topic_parse_error,
               fmt::format("Unexpected magic: {}", key));
         }
-        try {
-            vlog(plog.debug, "Applying: {}", key);
-            if (!val) {
-                co_await _store.delete_subject_version(
-                  key.sub,
-                  key.version,
-                  permanent_delete::yes,
-                  include_deleted::yes);
-            } else {
-                co_await _store.upsert(
-                  std::move(key.sub),
-                  std::move(val->schema),
-                  val->type,
-                  val->id,
-                  val->version,
-                  val->deleted);
-            }
-        } catch (const exception& e) {
-            vlog(plog.debug, "Ignoring: {}: {}", key, e.what());
+        vlog(plog.debug, "Applying: {}", key);
+        if (!val) {
+            _batch.delete_subject_version(std::move(key.sub), key.version);
+        } else {
+            _batch.upsert(
+              std::move(key.sub),
+              std::move(val->schema),
+              val->type,
+              val->id,
+              val->version,
+              val->deleted);
         }
     }
 
-    ss::future<> apply(config_key key, std::optional<config_value> val) {
+    void add(config_key key, std::optional<config_value> val) {
         if (key.magic != 0) {
             throw exception(
               error_code::topic_parse_error,
               fmt::format("Unexpected magic: {}", key));
         }
-        try {
-            vlog(plog.debug, "Applying: {}", key);
-            if (!val) {
-                co_await _store.clear_compatibility(*key.sub);
-            } else if (key.sub) {
-                co_await _store.set_compatibility(*key.sub, val->compat);
-            } else {
-                co_await _store.set_compatibility(val->compat);
+        vlog(plog.debug, "Applying: {}", key);
+        if (!val) {
+            if (key.sub) {
+                _batch.clear_compatibility(std::move(*key.sub));
             }
-        } catch (const exception& e) {
-            vlog(plog.debug, "Ignoring: {}: {}", key, e.what());
+        } else if (key.sub) {
+            _batch.set_compatibility(std::move(*key.sub), val->compat);
+        } else {
+            _batch.set_compatibility(val->compat);
         }
     }
 
-    ss::future<> apply(delete_subject_key key, delete_subject_value val) {
+    void add(delete_subject_key key, delete_subject_value val) {
         if (key.magic != 0) {
             throw exception(
               error_code::topic_parse_error,
               fmt::format("Unexpected magic: {}", key));
         }
-        try {
-            vlog(plog.debug, "Applying: {}", key);
-            co_await _store.delete_subject(val.sub, permanent_delete::no);
-        } catch (const exception& e) {
-            vlog(plog.debug, "Ignoring: {}: {}", key, e);
+        vlog(plog.debug, "Applying: {}", key);
+        _batch.delete_subject(std::move(val.sub));
+    }
+
+    ss::future<> flush() {
+        if (_batch.empty()) {
+            co_return;
         }
+        auto batch = std::exchange(_batch, sharded_store::replay_batch{});
+        co_await _store.replay(batch);
     }
 
-    void end_of_stream() {}
     sharded_store& _store;
+    size_t _max_writes;
+    model::offset _start_offset;
+    sharded_store::replay_batch _batch;
+    size_t _records{0};
 };
 
 } // namespace pandaproxy::schema_registry
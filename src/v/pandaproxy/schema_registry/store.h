@@ -17,6 +17,9 @@
 #include <absl/container/btree_map.h>
 #include <absl/container/node_hash_map.h>
 
+#include <optional>
+#include <vector>
+
 namespace pandaproxy::schema_registry {
 
 namespace detail {
@@ -36,6 +39,31 @@ make_non_const_iterator(T& container, result<typename T::const_iterator> it) {
 
 } // namespace detail
 
+///\brief Contents of a store, saved in the local snapshot of the schema
+/// registry.
+struct store_snapshot {
+    struct schema_entry {
+        schema_id id;
+        schema_type type{schema_type::avro};
+        schema_definition definition;
+    };
+    struct version_entry {
+        schema_version version;
+        schema_id id;
+        is_deleted deleted{is_deleted::no};
+    };
+    struct subject_entry {
+        subject sub;
+        std::optional<compatibility_level> compatibility;
+        std::vector<version_entry> versions;
+        is_deleted deleted{is_deleted::no};
+    };
+
+    std::vector<schema_entry> schemas;
+    std::vector<subject_entry> subjects;
+    compatibility_level compatibility{compatibility_level::none};
+};
+
 class store {
 public:
     struct insert_result {
@@ -320,6 +348,47 @@ public:
         return true;
     }
 
+    ///\brief Add the schemas and subjects of the store to the snapshot.
+    void add_to_snapshot(store_snapshot& snap) const {
+        snap.compatibility = _compatibility;
+        snap.schemas.reserve(snap.schemas.size() + _schemas.size());
+        for (const auto& [id, entry] : _schemas) {
+            snap.schemas.push_back(store_snapshot::schema_entry{
+              .id = id, .type = entry.type, .definition = entry.definition});
+        }
+        snap.subjects.reserve(snap.subjects.size() + _subjects.size());
+        for (const auto& [sub, entry] : _subjects) {
+            std::vector<store_snapshot::version_entry> versions;
+            versions.reserve(entry.versions.size());
+            for (const auto& v : entry.versions) {
+                versions.push_back(store_snapshot::version_entry{
+                  .version = v.version, .id = v.id, .deleted = v.deleted});
+            }
+            snap.subjects.push_back(store_snapshot::subject_entry{
+              .sub = sub,
+              .compatibility = entry.compatibility,
+              .versions = std::move(versions),
+              .deleted = entry.deleted});
+        }
+    }
+
+    ///\brief Restore a schema saved in a snapshot.
+    void restore(const store_snapshot::schema_entry& e) {
+        _schemas.insert_or_assign(e.id, schema_entry(e.type, e.definition));
+    }
+
+    ///\brief Restore a subject saved in a snapshot.
+    void restore(const store_snapshot::subject_entry& e) {
+        auto& entry = _subjects[e.sub];
+        entry.compatibility = e.compatibility;
+        entry.deleted = e.deleted;
+        entry.versions.clear();
+        entry.versions.reserve(e.versions.size());
+        for (const auto& v : e.versions) {
+            entry.versions.emplace_back(v.version, v.id, v.deleted);
+        }
+    }
+
 private:
     struct schema_entry {
         schema_entry(schema_type type, schema_definition definition)
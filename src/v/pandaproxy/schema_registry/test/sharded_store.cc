@@ -0,0 +1,178 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "pandaproxy/schema_registry/sharded_store.h"
+
+#include "pandaproxy/schema_registry/exceptions.h"
+#include "pandaproxy/schema_registry/store.h"
+#include "pandaproxy/schema_registry/test/compatibility_avro.h"
+#include "pandaproxy/schema_registry/types.h"
+
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/defer.hh>
+
+#include <boost/test/tools/old/interface.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace pp = pandaproxy;
+namespace pps = pp::schema_registry;
+
+SEASTAR_THREAD_TEST_CASE(test_sharded_store_cached_lookups) {
+    pps::sharded_store s;
+    s.start(ss::default_smp_service_group()).get();
+    auto stop_store = ss::defer([&s]() { s.stop().get(); });
+
+    const auto sub = pps::subject{"sub"};
+    const auto avro = pps::schema_type::avro;
+    const auto v1 = pps::schema_version{1};
+    auto res = s.insert(sub, pps::schema_definition{schema1}, avro).get();
+
+    // twice, the second lookups are served by the cache
+    for (int i = 0; i < 2; ++i) {
+        auto schema = s.get_schema(res.id).get();
+        BOOST_REQUIRE_EQUAL(schema.definition, pps::schema_definition{schema1});
+        auto sub_schema
+          = s.get_subject_schema(sub, v1, pps::include_deleted::no).get();
+        BOOST_REQUIRE_EQUAL(sub_schema.id, res.id);
+        BOOST_REQUIRE(!sub_schema.deleted);
+    }
+
+    // a soft deleted version is no longer served as live
+    BOOST_REQUIRE(
+      s.delete_subject_version(
+         sub, v1, pps::permanent_delete::no, pps::include_deleted::no)
+        .get());
+    BOOST_REQUIRE_THROW(
+      s.get_subject_schema(sub, v1, pps::include_deleted::no).get(),
+      pps::exception);
+    auto deleted
+      = s.get_subject_schema(sub, v1, pps::include_deleted::yes).get();
+    BOOST_REQUIRE(deleted.deleted);
+
+    // the version is reinserted with a new schema
+    s.upsert(
+       sub,
+       pps::schema_definition{schema2},
+       avro,
+       pps::schema_id{res.id() + 1},
+       v1,
+       pps::is_deleted::no)
+      .get();
+    auto upserted
+      = s.get_subject_schema(sub, v1, pps::include_deleted::no).get();
+    BOOST_REQUIRE_EQUAL(upserted.id, pps::schema_id{res.id() + 1});
+    BOOST_REQUIRE_EQUAL(upserted.definition, pps::schema_definition{schema2});
+}
+
+SEASTAR_THREAD_TEST_CASE(test_sharded_store_memoized_compatibility) {
+    pps::sharded_store s;
+    s.start(ss::default_smp_service_group()).get();
+    auto stop_store = ss::defer([&s]() { s.stop().get(); });
+
+    s.set_compatibility(pps::compatibility_level::backward).get();
+    const auto sub = pps::subject{"sub"};
+    const auto avro = pps::schema_type::avro;
+    const auto v1 = pps::schema_version{1};
+    auto res = s.insert(sub, pps::schema_definition{schema1}, avro).get();
+
+    // twice, the second checks are memoized
+    for (int i = 0; i < 2; ++i) {
+        BOOST_REQUIRE(
+          s.is_compatible(sub, v1, pps::schema_definition{schema2}, avro)
+            .get());
+        BOOST_REQUIRE(
+          !s.is_compatible(sub, v1, pps::schema_definition{schema3}, avro)
+             .get());
+    }
+
+    // the memoized results follow the schema of the id
+    s.upsert(
+       sub,
+       pps::schema_definition{schema2},
+       avro,
+       res.id,
+       v1,
+       pps::is_deleted::no)
+      .get();
+    BOOST_REQUIRE(
+      s.is_compatible(sub, v1, pps::schema_definition{schema3}, avro).get());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_sharded_store_replay_and_snapshot) {
+    pps::sharded_store s;
+    s.start(ss::default_smp_service_group()).get();
+    auto stop_store = ss::defer([&s]() { s.stop().get(); });
+
+    const auto sub1 = pps::subject{"sub1"};
+    const auto sub2 = pps::subject{"sub2"};
+    const auto avro = pps::schema_type::avro;
+    const auto v1 = pps::schema_version{1};
+    const auto v2 = pps::schema_version{2};
+    const auto id1 = pps::schema_id{1};
+    const auto id2 = pps::schema_id{2};
+
+    pps::sharded_store::replay_batch batch;
+    batch.upsert(
+      sub1,
+      pps::schema_definition{schema1},
+      avro,
+      id1,
+      v1,
+      pps::is_deleted::no);
+    batch.upsert(
+      sub1,
+      pps::schema_definition{schema2},
+      avro,
+      id2,
+      v2,
+      pps::is_deleted::no);
+    batch.upsert(
+      sub2,
+      pps::schema_definition{schema1},
+      avro,
+      id1,
+      v1,
+      pps::is_deleted::no);
+    batch.set_compatibility(sub1, pps::compatibility_level::full);
+    batch.set_compatibility(pps::compatibility_level::backward);
+    batch.delete_subject_version(sub1, v2);
+    batch.delete_subject(sub2);
+    // fails and is ignored: the subject is already soft deleted
+    batch.delete_subject(sub2);
+    s.replay(batch).get();
+
+    auto check = [&](pps::sharded_store& st) {
+        BOOST_REQUIRE(
+          st.get_compatibility().get() == pps::compatibility_level::backward);
+        BOOST_REQUIRE(
+          st.get_compatibility(sub1).get() == pps::compatibility_level::full);
+        auto versions = st.get_versions(sub1, pps::include_deleted::yes).get();
+        BOOST_REQUIRE_EQUAL(versions.size(), 1);
+        BOOST_REQUIRE_EQUAL(versions.front(), v1);
+        BOOST_REQUIRE_EQUAL(
+          st.get_subjects(pps::include_deleted::no).get().size(), 1);
+        BOOST_REQUIRE_EQUAL(
+          st.get_subjects(pps::include_deleted::yes).get().size(), 2);
+        BOOST_REQUIRE_EQUAL(
+          st.get_schema(id2).get().definition,
+          pps::schema_definition{schema2});
+        // the restored ids are not allocated again
+        auto res = st.insert(sub1, pps::schema_definition{schema3}, avro).get();
+        BOOST_REQUIRE_EQUAL(res.id, pps::schema_id{3});
+    };
+
+    auto snap = s.make_snapshot().get();
+    check(s);
+
+    pps::sharded_store restored;
+    restored.start(ss::default_smp_service_group()).get();
+    auto stop_restored = ss::defer([&restored]() { restored.stop().get(); });
+    restored.restore(snap).get();
+    check(restored);
+}
@@ -85,6 +85,7 @@ struct handler_adaptor : ss::httpd::handler_base {
            req{std::move(req)},
            rep{std::move(rep)},
            m = _probe.hist().auto_measure()]() mutable {
+              _probe.request_started();
               server::request_t rq{std::move(req), this->_ctx};
               server::reply_t rp{std::move(rep)};
               auto req_size = get_request_size(*rq.req);
@@ -95,16 +96,25 @@ struct handler_adaptor : ss::httpd::handler_base {
                        [this, rq{std::move(rq)}, rp{std::move(rp)}]() mutable {
                            if (_ctx.as.abort_requested()) {
                                set_reply_unavailable(*rp.rep);
+                               _probe.reply(rp.rep->_status);
                                return ss::make_ready_future<
                                  std::unique_ptr<ss::reply>>(std::move(rp.rep));
                            }
                            return _handler(std::move(rq), std::move(rp))
-                             .then([](server::reply_t rp) {
+                             .then([this](server::reply_t rp) {
+                                 _probe.reply(rp.rep->_status);
                                  set_mime_type(*rp.rep, rp.mime_type);
                                  return std::move(rp.rep);
                              });
                        })
-                .finally([m{std::move(m)}]() {});
+                .handle_exception([this](std::exception_ptr e) {
+                    _probe.request_failed();
+                    return ss::make_exception_future<
+                      std::unique_ptr<ss::reply>>(e);
+                })
+                .finally([this, m{std::move(m)}]() {
+                    _probe.request_finished();
+                });
           });
     }
 
@@ -111,7 +111,14 @@ ss::future<> append_entries_buffer::do_flush(
                 replies.emplace_back(std::current_exception());
             }
         }
-        if (needs_flush) {
+        /**
+         * The flushes of the logs of all the groups on the shard are
+         * coalesced by the storage flush_scheduler, the replies of the groups
+         * that were flushed together are released at the same time. Skip
+         * the flush when nothing was appended since the previous one (e.g.
+         * the requests were duplicates or carried no batches).
+         */
+        if (needs_flush && _consensus._has_pending_flushes) {
             f = _consensus.flush_log();
         }
     }
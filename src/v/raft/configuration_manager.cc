@@ -34,6 +34,7 @@ configuration_manager::configuration_manager(
     auto [it, _] = _configurations.emplace(
       model::offset{},
       indexed_configuration(std::move(initial_cfg), _next_index++));
+    rebuild_offset_index();
     vlog(
       _ctxlog.trace,
       "Initial configuration: {}, idx: {}",
@@ -52,14 +53,19 @@ ss::future<> configuration_manager::truncate(model::offset offset) {
 
     return _lock.with([this, offset] {
         auto it = _configurations.lower_bound(offset);
+        if (it == _configurations.end() && offset >= _highest_known_offset) {
+            // nothing changes, i.e. when the group starts with the log and
+            // the persisted state in sync
+            return ss::now();
+        }
         if (it != _configurations.end()) {
             _next_index = it->second.idx;
         }
         _configurations.erase(it, _configurations.end());
+        rebuild_offset_index();
 
         _highest_known_offset = std::min(offset, _highest_known_offset);
-        return store_highest_known_offset().then(
-          [this] { return store_configurations(); });
+        return store_configurations();
     });
 }
 
@@ -77,22 +83,9 @@ ss::future<> configuration_manager::prefix_truncate(model::offset offset) {
                 get_latest_offset())));
         }
         _configurations.erase(_configurations.begin(), it);
+        rebuild_offset_index();
         _highest_known_offset = std::max(offset, _highest_known_offset);
-        /**
-         * store index of first configuration to recover indexing
-         */
-        configuration_idx next_index{0};
-        if (!_configurations.empty()) {
-            next_index = _configurations.begin()->second.idx;
-        }
-        return store_highest_known_offset()
-          .then([this, next_index] {
-              return _storage.kvs().put(
-                storage::kvstore::key_space::consensus,
-                next_configuration_idx_key(),
-                reflection::to_iobuf(next_index));
-          })
-          .then([this] { return store_configurations(); });
+        return store_configurations();
     });
 }
 
@@ -113,6 +106,25 @@ void configuration_manager::add_configuration(
           "already exists",
           offset));
     }
+    auto& offsets = _offset_index.offsets;
+    if (!offsets.empty() && offsets.back() < offset) {
+        offsets.push_back(offset);
+    } else {
+        rebuild_offset_index();
+    }
+}
+
+void configuration_manager::rebuild_offset_index() {
+    _offset_index.offsets.clear();
+    _offset_index.first_index = configuration_idx(0);
+    if (_configurations.empty()) {
+        return;
+    }
+    _offset_index.first_index = _configurations.begin()->second.idx;
+    _offset_index.offsets.reserve(_configurations.size());
+    for (const auto& [offset, _] : _configurations) {
+        _offset_index.offsets.push_back(offset);
+    }
 }
 
 ss::future<>
@@ -127,8 +139,7 @@ configuration_manager::add(std::vector<offset_configuration> configurations) {
             _highest_known_offset = std::max(_highest_known_offset, co.offset);
         }
         _config_changed.broadcast();
-        return store_configurations().then(
-          [this] { return store_highest_known_offset(); });
+        return store_configurations();
     });
 }
 
@@ -148,8 +159,7 @@ configuration_manager::add(model::offset offset, group_configuration cfg) {
         add_configuration(offset, std::move(cfg));
         _highest_known_offset = std::max(offset, _highest_known_offset);
         _config_changed.broadcast();
-        return store_configurations().then(
-          [this] { return store_highest_known_offset(); });
+        return store_configurations();
     });
 }
 
@@ -189,20 +199,6 @@ configuration_manager::get(model::offset offset) const {
     return std::nullopt;
 }
 
-ss::future<iobuf>
-serialize_configurations(const configuration_manager::underlying_t& cfgs) {
-    return ss::do_with(iobuf(), [&cfgs](iobuf& ret) {
-        reflection::adl<uint64_t>{}.to(ret, cfgs.size());
-        return ss::do_for_each(
-                 cfgs.cbegin(),
-                 cfgs.cend(),
-                 [&ret](const auto& p) mutable {
-                     reflection::serialize(ret, p.first, p.second.cfg);
-                 })
-          .then([&ret] { return std::move(ret); });
-    });
-}
-
 ss::future<configuration_manager::underlying_t> deserialize_configurations(
   configuration_manager::configuration_idx initial, iobuf&& buf) {
     using ret_t = configuration_manager::underlying_t;
@@ -240,12 +236,96 @@ ss::future<configuration_manager::underlying_t> deserialize_configurations(
 }
 
 ss::future<> configuration_manager::store_configurations() {
-    return serialize_configurations(_configurations).then([this](iobuf buf) {
-        return _storage.kvs().put(
-          storage::kvstore::key_space::consensus,
-          configurations_map_key(),
-          std::move(buf));
-    });
+    const auto ks = storage::kvstore::key_space::consensus;
+    std::vector<std::pair<bytes, iobuf>> kvs;
+    std::vector<model::offset> offsets;
+    offsets.reserve(_configurations.size());
+    for (const auto& [o, icfg] : _configurations) {
+        offsets.push_back(o);
+        if (!_stored_offsets.contains(o)) {
+            iobuf buf;
+            reflection::serialize(buf, icfg.cfg);
+            kvs.emplace_back(configuration_key(o), std::move(buf));
+        }
+    }
+    std::vector<bytes> removed;
+    for (auto o : _stored_offsets) {
+        if (!_configurations.contains(o)) {
+            removed.push_back(configuration_key(o));
+        }
+    }
+    /**
+     * store index of first configuration to recover indexing
+     */
+    configuration_idx first_index{0};
+    if (!_configurations.empty()) {
+        first_index = _configurations.begin()->second.idx;
+    }
+    _stored_offsets = absl::btree_set<model::offset>(
+      offsets.begin(), offsets.end());
+    kvs.emplace_back(
+      configuration_offsets_key(), reflection::to_iobuf(std::move(offsets)));
+    kvs.emplace_back(
+      next_configuration_idx_key(), reflection::to_iobuf(first_index));
+    kvs.emplace_back(
+      highest_known_offset_key(), reflection::to_iobuf(_highest_known_offset));
+    /**
+     * the removed configurations are no longer referenced by the stored
+     * offsets when they are removed, a failure in between only leaves
+     * unreferenced keys
+     */
+    return _storage.kvs()
+      .put(ks, std::move(kvs))
+      .then([this, ks, removed = std::move(removed)]() mutable {
+          if (removed.empty()) {
+              return ss::now();
+          }
+          return _storage.kvs().remove(ks, std::move(removed));
+      });
+}
+
+configuration_manager::underlying_t configuration_manager::load_configurations(
+  configuration_idx initial, const std::vector<model::offset>& offsets) const {
+    underlying_t ret;
+    auto idx = initial;
+    for (auto o : offsets) {
+        auto buf = _storage.kvs().get(
+          storage::kvstore::key_space::consensus, configuration_key(o));
+        vassert(buf, "Missing configuration at offset {} in kv-store", o);
+        auto [_, success] = ret.try_emplace(
+          o,
+          indexed_configuration(
+            reflection::from_iobuf<group_configuration>(std::move(*buf)),
+            idx++));
+        vassert(success, "Duplicated configuration key at offset {}", o);
+    }
+    return ret;
+}
+
+std::vector<model::offset>
+configuration_manager::stored_configuration_offsets() const {
+    auto buf = _storage.kvs().get(
+      storage::kvstore::key_space::consensus, configuration_offsets_key());
+    if (!buf) {
+        return {};
+    }
+    return reflection::from_iobuf<std::vector<model::offset>>(std::move(*buf));
+}
+
+ss::future<> configuration_manager::remove_configurations() {
+    std::vector<bytes> keys;
+    auto offsets = stored_configuration_offsets();
+    keys.reserve(offsets.size() + 4);
+    for (auto o : offsets) {
+        keys.push_back(configuration_key(o));
+    }
+    keys.push_back(configuration_offsets_key());
+    keys.push_back(configurations_map_key());
+    keys.push_back(highest_known_offset_key());
+    keys.push_back(next_configuration_idx_key());
+    _stored_offsets.clear();
+    return _storage.kvs().remove(
+      storage::kvstore::key_space::consensus, std::move(keys));
 }
 
 ss::future<> configuration_manager::store_highest_known_offset() {
@@ -264,58 +344,69 @@ ss::future<>
 configuration_manager::start(bool reset, model::revision_id initial_revision) {
     _initial_revision = initial_revision;
     if (reset) {
-        return _storage.kvs()
-          .remove(
-            storage::kvstore::key_space::consensus, configurations_map_key())
-          .then([this] {
-              return _storage.kvs().remove(
-                storage::kvstore::key_space::consensus,
-                highest_known_offset_key());
-          });
+        return remove_configurations();
     }
 
-    auto map_buf = _storage.kvs().get(
-      storage::kvstore::key_space::consensus, configurations_map_key());
-    auto idx_buf = _storage.kvs().get(
-      storage::kvstore::key_space::consensus, next_configuration_idx_key());
-    return _lock.with([this,
-                       map_buf = std::move(map_buf),
-                       idx_buf = std::move(idx_buf)]() mutable {
-        auto f = ss::now();
+    return _lock.with([this] {
+        const auto ks = storage::kvstore::key_space::consensus;
+        auto offsets_buf = _storage.kvs().get(ks, configuration_offsets_key());
+        auto map_buf = _storage.kvs().get(ks, configurations_map_key());
+        auto idx_buf = _storage.kvs().get(ks, next_configuration_idx_key());
+        auto offset_buf = _storage.kvs().get(ks, highest_known_offset_key());
 
-        if (map_buf) {
+        if (offsets_buf || map_buf) {
             _next_index = configuration_idx(0);
             if (idx_buf) {
                 _next_index = reflection::from_iobuf<configuration_idx>(
                   std::move(*idx_buf));
             }
+        }
+
+        auto f = ss::make_ready_future<std::optional<underlying_t>>();
+        if (offsets_buf) {
+            auto offsets = reflection::from_iobuf<std::vector<model::offset>>(
+              std::move(*offsets_buf));
+            _stored_offsets = absl::btree_set<model::offset>(
+              offsets.begin(), offsets.end());
+            f = ss::make_ready_future<std::optional<underlying_t>>(
+              load_configurations(_next_index, offsets));
+        } else if (map_buf) {
             f = deserialize_configurations(_next_index, std::move(*map_buf))
-                  .then([this](underlying_t cfgs) {
-                      _configurations = std::move(cfgs);
-                      if (!_configurations.empty()) {
-                          _highest_known_offset
-                            = _configurations.rbegin()->first;
-                          _next_index = _configurations.rbegin()->second.idx
-                                        + configuration_idx(1);
-                      }
+                  .then([](underlying_t cfgs) {
+                      return std::optional<underlying_t>(std::move(cfgs));
                   });
         }
 
-        auto offset_buf = _storage.kvs().get(
-          storage::kvstore::key_space::consensus, highest_known_offset_key());
-        if (offset_buf) {
-            f = f.then([this, buf = std::move(*offset_buf)]() mutable {
+        return f.then([this,
+                       offset_buf = std::move(offset_buf),
+                       migrate = map_buf.has_value()](
+                        std::optional<underlying_t> cfgs) mutable {
+            if (cfgs) {
+                _configurations = std::move(*cfgs);
+                rebuild_offset_index();
+                if (!_configurations.empty()) {
+                    _highest_known_offset = _configurations.rbegin()->first;
+                    _next_index = _configurations.rbegin()->second.idx
+                                  + configuration_idx(1);
+                }
+            }
+            if (offset_buf) {
                 auto offset = reflection::from_iobuf<model::offset>(
-                  std::move(buf));
-
+                  std::move(*offset_buf));
                 _highest_known_offset = std::max(_highest_known_offset, offset);
-            });
-        }
-
-        return f.then([this] {
+            }
             for (auto& [o, icfg] : _configurations) {
                 icfg.cfg.maybe_set_initial_revision(_initial_revision);
             }
+            if (!migrate) {
+                return ss::now();
+            }
+            // configurations stored as a single map by older versions
+            return store_configurations().then([this] {
+                return _storage.kvs().remove(
+                  storage::kvstore::key_space::consensus,
+                  configurations_map_key());
+            });
         });
     });
 }
@@ -367,17 +458,7 @@ ss::future<offset_configuration> configuration_manager::wait_for_change(
 }
 
 ss::future<> configuration_manager::remove_persistent_state() {
-    return _storage.kvs()
-      .remove(storage::kvstore::key_space::consensus, configurations_map_key())
-      .then([this] {
-          return _storage.kvs().remove(
-            storage::kvstore::key_space::consensus, highest_known_offset_key());
-      })
-      .then([this] {
-          return _storage.kvs().remove(
-            storage::kvstore::key_space::consensus,
-            next_configuration_idx_key());
-      });
+    return _lock.with([this] { return remove_configurations(); });
 }
 
 model::revision_id configuration_manager::get_latest_revision() const {
@@ -26,6 +26,7 @@
 #include <seastar/core/future.hh>
 
 #include <absl/container/btree_map.h>
+#include <absl/container/btree_set.h>
 
 #include <utility>
 #include <vector>
@@ -45,6 +46,13 @@ namespace raft {
  * The highest known offset is not group_configuration offset, it is an offset
  * up to which all configuration are guranted to be present in configuration
  * manager.
+ *
+ * Every configuration is stored under its own key, next to the list of the
+ * offsets of the stored configurations. A change only writes the added
+ * configurations and removes the truncated ones, together with the offsets
+ * list and the highest known offset in a single batch of kv-store updates.
+ * The configurations stored as a single map by older versions are migrated
+ * when the manager starts.
  */
 class configuration_manager {
 public:
@@ -161,17 +169,44 @@ public:
         return _configurations.lower_bound(o);
     }
 
+    /**
+     * Offsets of the configurations in a flat sorted array. The indexes of
+     * the configurations are consecutive, the configuration at position i
+     * has index `first_index + i`: translating offsets binary searches the
+     * array instead of walking the nodes of the map.
+     */
+    struct offset_index {
+        configuration_idx first_index{0};
+        std::vector<model::offset> offsets;
+    };
+    const offset_index& get_offset_index() const { return _offset_index; }
+
     friend std::ostream&
     operator<<(std::ostream&, const configuration_manager&);
 
 private:
     ss::future<> store_configurations();
     ss::future<> store_highest_known_offset();
+    underlying_t load_configurations(
+      configuration_idx, const std::vector<model::offset>&) const;
+    std::vector<model::offset> stored_configuration_offsets() const;
+    ss::future<> remove_configurations();
+
     bytes configurations_map_key() const {
         return raft::details::serialize_group_key(
           _group, metadata_key::config_map);
     }
 
+    bytes configuration_offsets_key() const {
+        return raft::details::serialize_group_key(
+          _group, metadata_key::config_offsets);
+    }
+
+    bytes configuration_key(model::offset o) const {
+        return raft::details::serialize_group_key(
+          _group, metadata_key::config_entry, o);
+    }
+
     bytes highest_known_offset_key() const {
         return raft::details::serialize_group_key(
           _group, metadata_key::config_latest_known_offset);
@@ -183,9 +218,13 @@ private:
     }
 
     void add_configuration(model::offset, group_configuration);
+    void rebuild_offset_index();
 
     raft::group_id _group;
     underlying_t _configurations;
+    // offsets of the configurations stored in the kv-store
+    absl::btree_set<model::offset> _stored_offsets;
+    offset_index _offset_index;
     /**
      * The highest know offset is latest offset for which configuration manager
      * has all configurations. In other words, some configuration may be in the
@@ -19,18 +19,22 @@
 #include "raft/group_configuration.h"
 #include "raft/logger.h"
 #include "raft/prevote_stm.h"
+#include "raft/range_recovery_stm.h"
 #include "raft/recovery_stm.h"
 #include "raft/rpc_client_protocol.h"
 #include "raft/types.h"
 #include "raft/vote_stm.h"
 #include "reflection/adl.h"
 #include "storage/api.h"
+#include "utils/event_trace.h"
+#include "utils/latency_summary.h"
 #include "vlog.h"
 
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/fstream.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/with_scheduling_group.hh>
 
 #include <fmt/ostream.h>
 
@@ -48,7 +52,8 @@ consensus::consensus(
   consensus_client_protocol client,
   consensus::leader_cb_t cb,
   storage::api& storage,
-  std::optional<std::reference_wrapper<recovery_throttle>> recovery_throttle)
+  std::optional<std::reference_wrapper<recovery_throttle>> recovery_throttle,
+  std::optional<std::reference_wrapper<election_throttle>> election_throttle)
   : _self(nid, initial_cfg.revision_id())
   , _group(group)
   , _jit(std::move(jit))
@@ -59,6 +64,8 @@ consensus::consensus(
   , _leader_notification(std::move(cb))
   , _fstats(_self)
   , _batcher(this, config::shard_local_cfg().raft_replicate_batch_window_size())
+  , _replicate_batch_window_size(
+      config::shard_local_cfg().raft_replicate_batch_window_size.bind())
   , _event_manager(this)
   , _ctxlog(group, _log.config().ntp())
   , _replicate_append_timeout(
@@ -67,6 +74,7 @@ consensus::consensus(
       config::shard_local_cfg().recovery_append_timeout_ms())
   , _storage(storage)
   , _recovery_throttle(recovery_throttle)
+  , _election_throttle(election_throttle)
   , _snapshot_mgr(
       std::filesystem::path(_log.config().work_directory()),
       storage::snapshot_manager::default_snapshot_filename,
@@ -79,6 +87,10 @@ consensus::consensus(
         maybe_step_down();
         dispatch_vote(false);
     });
+    _relaxed_flush_timer.set_callback([this] { dispatch_flush_with_lock(); });
+    _replicate_batch_window_size.watch([this] {
+        _batcher.set_max_batch_size(_replicate_batch_window_size());
+    });
 }
 
 void consensus::setup_metrics() {
@@ -86,17 +98,22 @@ void consensus::setup_metrics() {
         return;
     }
 
-    _probe.setup_metrics(_log.config().ntp());
-    auto labels = probe::create_metric_labels(_log.config().ntp());
-    namespace sm = ss::metrics;
+    const auto& ntp = _log.config().ntp();
+    _probe.setup_metrics(ntp);
+    auto labels = probe::create_metric_labels(ntp);
+    auto group = prometheus_sanitize::metrics_name("raft");
+    std::vector<metric_spec> metrics = {
+      {.name = "leader_for",
+       .kind = metric_spec::type::gauge,
+       .description = "Number of groups for which node is a leader",
+       .value = [this] { return is_leader() ? 1 : 0; }}};
 
-    _metrics.add_group(
-      prometheus_sanitize::metrics_name("raft"),
-      {sm::make_gauge(
-        "leader_for",
-        [this] { return is_leader(); },
-        sm::description("Number of groups for which node is a leader"),
-        labels)});
+    if (config::shard_local_cfg().aggregate_partition_metrics(ntp.tp.topic)) {
+        _aggregate_metrics = aggregate_metrics::local().add(
+          group, {labels[0], labels[1]}, std::move(metrics));
+        return;
+    }
+    _metrics.add_group(group, make_metric_definitions(metrics, labels));
 }
 
 void consensus::do_step_down() {
@@ -137,9 +154,49 @@ clock_type::time_point consensus::majority_heartbeat() const {
     });
 }
 
+clock_type::time_point consensus::majority_lease_ack() const {
+    return config().quorum_match([this](vnode rni) {
+        if (rni == _self) {
+            return clock_type::time_point::max();
+        }
+        if (auto it = _fstats.find(rni); it != _fstats.end()) {
+            return it->second.last_ack_sent_at;
+        }
+        return clock_type::time_point::min();
+    });
+}
+
+bool consensus::has_leader_lease() const {
+    if (
+      !config::shard_local_cfg().raft_enable_leader_leases()
+      || _vstate != vote_state::leader || _transferring_leadership) {
+        return false;
+    }
+    // the commit index is only known to be up to date once an entry of the
+    // current term is committed
+    if (_commit_index < model::offset(0)) {
+        return false;
+    }
+    if (_log.get_term(_commit_index).value_or(model::term_id{}) != _term) {
+        return false;
+    }
+    auto lease_start = majority_lease_ack();
+    if (
+      lease_start < _became_leader_at || lease_start < _lease_fenced_until) {
+        return false;
+    }
+    auto drift
+      = config::shard_local_cfg().raft_leader_lease_clock_drift_ms();
+    if (drift >= _jit.base_duration()) {
+        return false;
+    }
+    return clock_type::now() < lease_start + _jit.base_duration() - drift;
+}
+
 void consensus::shutdown_input() {
     if (likely(!_as.abort_requested())) {
         _vote_timeout.cancel();
+        _relaxed_flush_timer.cancel();
         _as.request_abort();
         _commit_index_updated.broken();
         _disk_append.broken();
@@ -274,6 +331,12 @@ consensus::success_reply consensus::update_follower_index(
         return success_reply::no;
     }
 
+    if (
+      reply.result == append_entries_reply::status::success
+      && reply.term == _term) {
+        update_lease(idx, seq);
+    }
+
     // If recovery is in progress the recovery STM will handle follower index
     // updates
     if (!idx.is_recovering) {
@@ -341,8 +404,15 @@ void consensus::maybe_promote_to_voter(vnode id) {
             return ss::now();
         }
 
-        // do not promote to voter, learner is not up to date
-        if (it->second.match_index < _log.offsets().committed_offset) {
+        // do not promote to voter, learner is not up to date. A learner
+        // within raft_learner_promotion_max_lag is promoted, a learner
+        // following a leader under constant writes may never be fully
+        // caught up
+        auto max_lag = model::offset(static_cast<model::offset::type>(
+          config::shard_local_cfg().raft_learner_promotion_max_lag()));
+        if (
+          it->second.match_index + max_lag
+          < _log.offsets().committed_offset) {
             return ss::now();
         }
 
@@ -441,6 +511,10 @@ ss::future<result<model::offset>> consensus::linearizable_barrier() {
     if (_vstate != vote_state::leader) {
         co_return result<model::offset>(make_error_code(errc::not_leader));
     }
+    if (has_leader_lease()) {
+        _probe.leader_lease_read();
+        co_return ret_t(_commit_index);
+    }
     // store current commit index
     auto cfg = config();
     auto dirty_offset = _log.offsets().dirty_offset;
@@ -548,17 +622,30 @@ replicate_stages consensus::replicate_in_stages(
     return do_replicate(expected_term, std::move(rdr), opts);
 }
 
-replicate_stages
-wrap_stages_with_gate(ss::gate& gate, replicate_stages stages) {
+replicate_stages wrap_stages_with_gate(
+  ss::gate& gate, group_id group, replicate_stages stages) {
+    auto m = latency_summary::histogram(latency_summary::op::raft_replicate)
+               .auto_measure();
     return replicate_stages(
       ss::with_gate(
         gate,
         [f = std::move(stages.request_enqueued)]() mutable {
             return std::move(f);
         }),
-      ss::with_gate(gate, [f = std::move(stages.replicate_finished)]() mutable {
-          return std::move(f);
-      }));
+      ss::with_gate(
+        gate,
+        [f = std::move(stages.replicate_finished),
+         group,
+         m = std::move(m)]() mutable {
+            return std::move(f).then(
+              [group, m = std::move(m)](result<replicate_result> r) {
+                  event_trace::record(
+                    event_trace::type::replicate_finished,
+                    group(),
+                    r ? r.value().last_offset() : -1);
+                  return r;
+              });
+        }));
 }
 replicate_stages consensus::do_replicate(
   std::optional<model::term_id> expected_term,
@@ -574,11 +661,16 @@ replicate_stages consensus::do_replicate(
         return replicate_stages(errc::not_leader);
     }
 
+    event_trace::record(
+      event_trace::type::replicate_started,
+      _group(),
+      static_cast<uint64_t>(opts.consistency));
+
     if (opts.consistency == consistency_level::quorum_ack) {
         _probe.replicate_requests_ack_all();
 
         return wrap_stages_with_gate(
-          _bg, _batcher.replicate(expected_term, std::move(rdr)));
+          _bg, _group, _batcher.replicate(expected_term, std::move(rdr)));
     }
 
     if (opts.consistency == consistency_level::leader_ack) {
@@ -609,7 +701,9 @@ replicate_stages consensus::do_replicate(
       });
 
     return wrap_stages_with_gate(
-      _bg, replicate_stages(std::move(enqueued_f), std::move(replicated)));
+      _bg,
+      _group,
+      replicate_stages(std::move(enqueued_f), std::move(replicated)));
 }
 
 ss::future<result<replicate_result>> consensus::do_append_replicate_relaxed(
@@ -631,6 +725,7 @@ ss::future<result<replicate_result>> consensus::do_append_replicate_relaxed(
                std::move(rdr), model::term_id(_term)),
              update_last_quorum_index::no)
       .then([this](storage::append_result res) {
+          maybe_schedule_relaxed_flush(res.byte_size);
           // only update visibility upper bound if all quorum
           // replicated entries are committed already
           if (_commit_index >= _last_quorum_replicated_index) {
@@ -645,6 +740,33 @@ ss::future<result<replicate_result>> consensus::do_append_replicate_relaxed(
       .finally([this, u = std::move(u)] { _probe.replicate_done(); });
 }
 
+/**
+ * The relaxed consistency writes are acknowledged once they are appended to
+ * the leader log, they never wait for a flush. Without a flush policy they
+ * become durable along the next quorum write, flush requested by a follower
+ * or segment roll. With one, the leader flushes them in the background once
+ * flush_bytes were appended or the first of them is flush_ms old. The
+ * flushes of all the logs of the shard are coalesced by the
+ * storage::flush_scheduler.
+ */
+void consensus::maybe_schedule_relaxed_flush(size_t appended_bytes) {
+    _relaxed_unflushed_bytes += appended_bytes;
+    if (unlikely(_as.abort_requested())) {
+        return;
+    }
+    const auto& cfg = _log.config();
+    if (auto limit = cfg.flush_bytes();
+        limit && _relaxed_unflushed_bytes >= *limit) {
+        _relaxed_flush_timer.cancel();
+        dispatch_flush_with_lock();
+        return;
+    }
+    if (auto interval = cfg.flush_ms();
+        interval && !_relaxed_flush_timer.armed()) {
+        _relaxed_flush_timer.arm(*interval);
+    }
+}
+
 void consensus::dispatch_flush_with_lock() {
     if (!_has_pending_flushes) {
         return;
@@ -666,6 +788,25 @@ consensus::do_make_reader(storage::log_reader_config config) {
     return _log.make_reader(config);
 }
 
+ss::future<> consensus::wait_for_next_visible_offset(
+  model::timeout_clock::time_point deadline, ss::abort_source& as) {
+    return ss::with_gate(_bg, [this, deadline, &as] {
+        // the shutdown of the consensus aborts the wait of the caller
+        auto sub = _as.subscribe([&as]() noexcept {
+            if (!as.abort_requested()) {
+                as.request_abort();
+            }
+        });
+        if (!sub) {
+            return ss::make_exception_future<>(
+              offset_monitor::wait_aborted());
+        }
+        return _consumable_offset_monitor
+          .wait(last_visible_index() + model::offset(1), deadline, as)
+          .finally([sub = std::move(sub)] {});
+    });
+}
+
 ss::future<model::record_batch_reader> consensus::make_reader(
   storage::log_reader_config config,
   std::optional<clock_type::time_point> debounce_timeout) {
@@ -758,40 +899,22 @@ void consensus::dispatch_vote(bool leadership_transfer) {
     }
     // background, acquire lock, transition state
     (void)with_gate(_bg, [this, leadership_transfer] {
-        return dispatch_prevote(leadership_transfer)
-          .then([this, leadership_transfer](bool ready) mutable {
-              if (!ready) {
-                  return ss::make_ready_future<>();
+        return election_units(leadership_transfer)
+          .then([this, leadership_transfer](
+                  std::optional<ss::semaphore_units<>> u) {
+              // a new leader may have been heard from while the election
+              // waited for its turn
+              if (should_skip_vote(leadership_transfer)) {
+                  return ss::now();
               }
-              auto vstm = std::make_unique<vote_stm>(this);
-              auto p = vstm.get();
-
-              // CRITICAL: vote performs locking on behalf of consensus
-              return p->vote(leadership_transfer)
-                .then_wrapped([this, p, vstm = std::move(vstm)](
-                                ss::future<> vote_f) mutable {
-                    try {
-                        vote_f.get();
-                    } catch (...) {
-                        vlog(
-                          _ctxlog.warn,
-                          "Error returned from voting process {}",
-                          std::current_exception());
-                    }
-                    auto f = p->wait().finally([vstm = std::move(vstm)] {});
-                    // make sure we wait for all futures when gate is closed
-                    if (_bg.is_closed()) {
-                        return f;
-                    }
-                    // background
-                    (void)with_gate(
-                      _bg,
-                      [vstm = std::move(vstm), f = std::move(f)]() mutable {
-                          return std::move(f);
-                      });
-
-                    return ss::make_ready_future<>();
-                });
+              return do_dispatch_vote(leadership_transfer)
+                .finally([u = std::move(u)] {});
+          })
+          .handle_exception_type([this](const ss::semaphore_timed_out&) {
+              vlog(_ctxlog.trace, "Election throttled, retrying later");
+          })
+          .handle_exception_type([](const ss::broken_semaphore&) {
+              // shutting down
           })
           .handle_exception([this](const std::exception_ptr& e) {
               vlog(_ctxlog.warn, "Exception thrown while voting - {}", e);
@@ -799,6 +922,59 @@ void consensus::dispatch_vote(bool leadership_transfer) {
           .finally([this] { arm_vote_timeout(); });
     });
 }
+
+ss::future<std::optional<ss::semaphore_units<>>>
+consensus::election_units(bool leadership_transfer) {
+    if (!_election_throttle || leadership_transfer) {
+        return ss::make_ready_future<std::optional<ss::semaphore_units<>>>();
+    }
+    // an election that doesn't get its turn within the election timeout is
+    // retried after the next one
+    auto timeout = election_throttle::clock_type::now()
+                   + _jit.base_duration();
+    return _election_throttle->get().units(timeout).then(
+      [](ss::semaphore_units<> u) {
+          return std::optional<ss::semaphore_units<>>(std::move(u));
+      });
+}
+
+ss::future<> consensus::do_dispatch_vote(bool leadership_transfer) {
+    return dispatch_prevote(leadership_transfer)
+      .then([this, leadership_transfer](bool ready) mutable {
+          if (!ready) {
+              return ss::make_ready_future<>();
+          }
+          auto vstm = std::make_unique<vote_stm>(this);
+          auto p = vstm.get();
+
+          // CRITICAL: vote performs locking on behalf of consensus
+          return p->vote(leadership_transfer)
+            .then_wrapped([this, p, vstm = std::move(vstm)](
+                            ss::future<> vote_f) mutable {
+                try {
+                    vote_f.get();
+                } catch (...) {
+                    vlog(
+                      _ctxlog.warn,
+                      "Error returned from voting process {}",
+                      std::current_exception());
+                }
+                auto f = p->wait().finally([vstm = std::move(vstm)] {});
+                // make sure we wait for all futures when gate is closed
+                if (_bg.is_closed()) {
+                    return f;
+                }
+                // background
+                (void)with_gate(
+                  _bg, [vstm = std::move(vstm), f = std::move(f)]() mutable {
+                      return std::move(f);
+                  });
+
+                return ss::make_ready_future<>();
+            });
+      });
+}
+
 void consensus::arm_vote_timeout() {
     if (!_bg.is_closed()) {
         _vote_timeout.rearm(_jit());
@@ -960,6 +1136,9 @@ ss::future<> consensus::start() {
               // set last heartbeat timestamp to prevent skipping first
               // election
               _hbeat = clock_type::time_point::min();
+              if (config::shard_local_cfg().raft_enable_leader_leases()) {
+                  _votes_fenced_until = next_election + _jit.base_duration();
+              }
               auto conf = _configuration_manager.get_latest().brokers();
               if (!conf.empty() && _self.id() == conf.begin()->id()) {
                   // for single node scenarios arm immediate election,
@@ -1214,7 +1393,7 @@ ss::future<vote_reply> consensus::do_vote(vote_request&& r) {
     auto prev_election = clock_type::now() - _jit.base_duration();
     if (
       _hbeat > prev_election && !r.leadership_transfer
-      && r.node_id != _voted_for) {
+      && (r.node_id != _voted_for || r.term > _term)) {
         vlog(
           _ctxlog.trace,
           "Already heard from the leader, not granting vote to node {}",
@@ -1222,6 +1401,14 @@ ss::future<vote_reply> consensus::do_vote(vote_request&& r) {
         reply.granted = false;
         return ss::make_ready_future<vote_reply>(std::move(reply));
     }
+    if (clock_type::now() < _votes_fenced_until && !r.leadership_transfer) {
+        vlog(
+          _ctxlog.trace,
+          "Recently started with leader leases, not granting vote to node {}",
+          r.node_id);
+        reply.granted = false;
+        return ss::make_ready_future<vote_reply>(std::move(reply));
+    }
 
     if (r.term > _term) {
         vlog(
@@ -1603,29 +1790,47 @@ consensus::do_install_snapshot(install_snapshot_request&& r) {
             f = _snapshot_writer->close().then(
               [this] { return _snapshot_mgr.remove_partial_snapshots(); });
         }
-        f = f.then([this] {
+        f = f.then([this, index = r.last_included_index] {
             return _snapshot_mgr.start_snapshot().then(
-              [this](storage::snapshot_writer w) {
+              [this, index](storage::snapshot_writer w) {
                   _snapshot_writer.emplace(std::move(w));
+                  _received_snapshot_index = index;
+                  _received_snapshot_bytes = 0;
               });
         });
+    } else if (
+      !_snapshot_writer || r.last_included_index != _received_snapshot_index
+      || r.file_offset != _received_snapshot_bytes) {
+        // chunk doesn't continue the stored part of the snapshot (i.e. this
+        // node restarted or a previous chunk was lost), leader resumes the
+        // transfer from the bytes we report as stored
+        reply.bytes_stored = _snapshot_writer && r.last_included_index
+                                                   == _received_snapshot_index
+                               ? _received_snapshot_bytes
+                               : 0;
+        reply.success = true;
+        return ss::make_ready_future<install_snapshot_reply>(reply);
     }
 
     // Write data into snapshot file at given offset (§7.3)
     f = f.then([this, chunk = std::move(r.chunk)]() mutable {
+        auto chunk_size = chunk.size_bytes();
         return write_iobuf_to_output_stream(
-          std::move(chunk), _snapshot_writer->output());
+                 std::move(chunk), _snapshot_writer->output())
+          .then([this, chunk_size] { _received_snapshot_bytes += chunk_size; });
     });
 
     // Reply and wait for more data chunks if done is false (§7.4)
     if (!is_done) {
-        return f.then([reply]() mutable {
+        return f.then([this, reply]() mutable {
+            reply.bytes_stored = _received_snapshot_bytes;
             reply.success = true;
             return reply;
         });
     }
     // Last chunk, finish storing snapshot
     return f.then([this, r = std::move(r), reply]() mutable {
+        reply.bytes_stored = _received_snapshot_bytes;
         return finish_snapshot(std::move(r), reply);
     });
 }
@@ -1793,7 +1998,24 @@ append_entries_reply consensus::make_append_entries_reply(
 
 ss::future<> consensus::flush_log() {
     _probe.log_flushed();
-    return _log.flush().then([this] { _has_pending_flushes = false; });
+    auto stage = is_leader() ? replicate_stage::leader_flush
+                             : replicate_stage::follower_flush;
+    return _log.flush().then(
+      [this, stage, start = probe::stage_clock_type::now()] {
+          _probe.record_stage_latency(
+            stage, probe::stage_clock_type::now() - start);
+          // appends that happened while the flush was in progress may not be
+          // covered by it
+          auto lstats = _log.offsets();
+          _has_pending_flushes = lstats.committed_offset < lstats.dirty_offset;
+          if (!_has_pending_flushes) {
+              _relaxed_unflushed_bytes = 0;
+              _relaxed_flush_timer.cancel();
+          } else if (_relaxed_unflushed_bytes > 0) {
+              // the appends not covered by the flush are flushed by the next
+              maybe_schedule_relaxed_flush(0);
+          }
+      });
 }
 
 ss::future<storage::append_result> consensus::disk_append(
@@ -1878,9 +2100,49 @@ void consensus::update_node_hbeat_timestamp(vnode id) {
     _fstats.get(id).last_hbeat_timestamp = clock_type::now();
 }
 
+void consensus::update_lease(
+  follower_index_metadata& idx, follower_req_seq seq) {
+    const auto& [sent_seq, sent_at]
+      = idx.request_sent_at[seq() % idx.request_sent_at.size()];
+    // the slot was reused by a later request, the send time is unknown
+    if (sent_seq == seq) {
+        idx.last_ack_sent_at = std::max(idx.last_ack_sent_at, sent_at);
+    }
+}
+
+rpc::client_opts consensus::append_entries_client_opts(
+  vnode target,
+  clock_type::time_point timeout,
+  size_t compressible_bytes) const {
+    const auto& cfg = config::shard_local_cfg();
+    const auto min_bytes = cfg.raft_cross_rack_compression_min_bytes();
+    if (
+      cfg.raft_cross_rack_compression() && compressible_bytes >= min_bytes
+      && is_cross_rack(target.id())) {
+        return rpc::client_opts(
+          timeout, rpc::compression_type::zstd, min_bytes);
+    }
+    return rpc::client_opts(timeout);
+}
+
+bool consensus::is_cross_rack(model::node_id id) const {
+    const auto& cfg = _configuration_manager.get_latest();
+    auto self = cfg.find_broker(_self.id());
+    auto peer = cfg.find_broker(id);
+    // nodes without a rack are considered to be local
+    if (!self || !peer || !self->rack() || !peer->rack()) {
+        return false;
+    }
+    return *self->rack() != *peer->rack();
+}
+
 follower_req_seq consensus::next_follower_sequence(vnode id) {
     if (auto it = _fstats.find(id); it != _fstats.end()) {
-        return it->second.last_sent_seq++;
+        auto& idx = it->second;
+        auto seq = idx.last_sent_seq++;
+        idx.request_sent_at[seq() % idx.request_sent_at.size()] = {
+          seq, clock_type::now()};
+        return seq;
     }
 
     return follower_req_seq{};
@@ -2081,6 +2343,58 @@ operator<<(std::ostream& os, const consensus::vote_state& state) {
     std::terminate(); // make gcc happy
 }
 
+ss::future<recover_range_reply>
+consensus::recover_range(recover_range_request&& r) {
+    if (unlikely(is_request_target_node_invalid("recover_range", r))) {
+        return ss::make_ready_future<recover_range_reply>(
+          recover_range_reply{});
+    }
+    recover_range_reply failed{.target_node_id = r.node_id};
+    if (
+      r.term != _term || _vstate != vote_state::follower
+      || _leader_id != r.node_id) {
+        vlog(
+          _ctxlog.debug,
+          "Ignoring recover range request from node {} at term {}, current "
+          "term: {}",
+          r.node_id,
+          r.term,
+          _term);
+        return ss::make_ready_future<recover_range_reply>(failed);
+    }
+    // only the committed entries are replicated on behalf of the leader,
+    // they are in the log of every future leader
+    auto lstats = _log.offsets();
+    if (
+      r.last_offset > _commit_index || r.start_offset > r.last_offset
+      || r.start_offset < lstats.start_offset) {
+        vlog(
+          _ctxlog.debug,
+          "Ignoring recover range request [{},{}], log start offset: {}, "
+          "commit index: {}",
+          r.start_offset,
+          r.last_offset,
+          lstats.start_offset,
+          _commit_index);
+        return ss::make_ready_future<recover_range_reply>(failed);
+    }
+
+    return ss::with_gate(_bg, [this, r = std::move(r), failed]() mutable {
+        return ss::with_scheduling_group(
+          _scheduling.learner_recovery_sg, [this, r = std::move(r), failed] {
+              auto stm = std::make_unique<range_recovery_stm>(this, r);
+              auto ptr = stm.get();
+              return ptr->apply()
+                .handle_exception(
+                  [this, failed](const std::exception_ptr& e) {
+                      vlog(_ctxlog.info, "Range recovery failed - {}", e);
+                      return failed;
+                  })
+                .finally([stm = std::move(stm)] {});
+          });
+    });
+}
+
 ss::future<timeout_now_reply> consensus::timeout_now(timeout_now_request&& r) {
     if (unlikely(is_request_target_node_invalid("timeout_now", r))) {
         return ss::make_ready_future<timeout_now_reply>(timeout_now_reply{
@@ -2330,7 +2644,13 @@ consensus::transfer_leadership(std::optional<model::node_id> target) {
         });
     });
 
-    return f.finally([this] { _transferring_leadership = false; });
+    return f.finally([this] {
+        _transferring_leadership = false;
+        // the target may be elected without the stable leadership check
+        // during its next election timeout, its voters acknowledged the
+        // requests sent until then
+        _lease_fenced_until = clock_type::now() + _jit.base_duration();
+    });
 }
 
 ss::future<> consensus::remove_persistent_state() {
@@ -2389,6 +2709,64 @@ void consensus::update_suppress_heartbeats(
     }
 }
 
+bool consensus::is_quiesced() {
+    if (
+      !config::shard_local_cfg().raft_enable_quiescence()
+      || _vstate != vote_state::leader) {
+        return false;
+    }
+    auto m = meta();
+    auto now = clock_type::now();
+    if (
+      m.term != _quiesce_meta.term
+      || m.prev_log_index != _quiesce_meta.prev_log_index
+      || m.commit_index != _quiesce_meta.commit_index
+      || m.last_visible_index != _quiesce_meta.last_visible_index) {
+        _quiesce_meta = m;
+        _quiesce_meta_since = now;
+        return false;
+    }
+    if (
+      now - _quiesce_meta_since
+      < config::shard_local_cfg().raft_quiesce_delay_ms()) {
+        return false;
+    }
+    // followers must have acknowledged the current state, otherwise they
+    // wouldn't learn about it without the heartbeats
+    bool up_to_date = true;
+    config().for_each_broker_id([this, &m, &up_to_date](vnode id) {
+        if (id == _self) {
+            return;
+        }
+        auto it = _fstats.find(id);
+        up_to_date = up_to_date && it != _fstats.end()
+                     && !it->second.is_recovering
+                     && it->second.match_index == m.prev_log_index
+                     && it->second.last_committed_log_index == m.commit_index;
+    });
+    return up_to_date;
+}
+
+void consensus::wake_from_quiescence() {
+    _quiesce_meta_since = clock_type::now();
+}
+
+void consensus::process_quiesced_heartbeat_reply(vnode id) {
+    if (auto it = _fstats.find(id); it != _fstats.end()) {
+        it->second.last_hbeat_timestamp = clock_type::now();
+    }
+}
+
+bool consensus::process_quiesced_heartbeat(model::node_id leader) {
+    if (
+      _vstate != vote_state::follower || !_leader_id
+      || _leader_id->id() != leader) {
+        return false;
+    }
+    _hbeat = clock_type::now();
+    return true;
+}
+
 voter_priority consensus::next_target_priority() {
     return voter_priority(std::max<voter_priority::type>(
       (_target_priority / 5) * 4, min_voter_priority));
@@ -11,12 +11,14 @@
 
 #pragma once
 
+#include "config/property.h"
 #include "hashing/crc32c.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
 #include "raft/append_entries_buffer.h"
 #include "raft/configuration_manager.h"
 #include "raft/consensus_client_protocol.h"
+#include "raft/election_throttle.h"
 #include "raft/event_manager.h"
 #include "raft/follower_stats.h"
 #include "raft/group_configuration.h"
@@ -33,6 +35,7 @@
 #include "storage/fwd.h"
 #include "storage/log.h"
 #include "storage/snapshot.h"
+#include "utils/aggregate_metrics.h"
 #include "utils/mutex.h"
 
 #include <seastar/core/abort_source.hh>
@@ -41,11 +44,13 @@
 
 #include <optional>
 
+struct consensus_flush_fixture;
 namespace raft {
 class replicate_entries_stm;
 class vote_stm;
 class prevote_stm;
 class recovery_stm;
+class range_recovery_stm;
 /// consensus for one raft group
 class consensus {
 public:
@@ -90,7 +95,8 @@ public:
       consensus_client_protocol,
       leader_cb_t,
       storage::api&,
-      std::optional<std::reference_wrapper<recovery_throttle>>);
+      std::optional<std::reference_wrapper<recovery_throttle>>,
+      std::optional<std::reference_wrapper<election_throttle>> = std::nullopt);
 
     /// Initial call. Allow for internal state recovery
     ss::future<> start();
@@ -108,6 +114,10 @@ public:
 
     ss::future<timeout_now_reply> timeout_now(timeout_now_request&& r);
 
+    /// Replicates a range of committed entries to a lagging follower on
+    /// behalf of the leader, see range_recovery_stm
+    ss::future<recover_range_reply> recover_range(recover_range_request&& r);
+
     /// This method adds multiple members to the group and performs
     /// configuration update
     ss::future<std::error_code>
@@ -132,8 +142,24 @@ public:
      * to returned offsets are linearizable. (i.e. majority of followers have
      * updated their commit indices to at least reaturned offset). For more
      * details see paragraph 6.4 of Raft protocol dissertation.
+     *
+     * When raft_enable_leader_leases is set and the leader holds a valid
+     * lease the commit index is returned without the round of heartbeats.
      */
     ss::future<result<model::offset>> linearizable_barrier();
+    /**
+     * Leader lease, see paragraph 6.4.1 of Raft protocol dissertation.
+     *
+     * A follower doesn't grant votes for an election timeout after it
+     * accepted a request of the leader. The lease lasts until an election
+     * timeout, less raft_leader_lease_clock_drift_ms, after the send time of
+     * the last request acknowledged by the majority. A lease is only valid
+     * once the leader committed an entry of its term and is dropped for an
+     * election timeout after a leadership transfer, the target is elected
+     * without the check. Quiesced heartbeats carry no term and don't extend
+     * the lease.
+     */
+    bool has_leader_lease() const;
 
     vnode self() const { return _self; }
     protocol_metadata meta() const {
@@ -302,24 +328,48 @@ public:
     void update_suppress_heartbeats(
       vnode, follower_req_seq, heartbeats_suppressed);
 
+    /**
+     * Quiescence of idle groups, used by the heartbeat manager.
+     *
+     * A leader whose log, commit and visible offsets didn't change for
+     * raft_quiesce_delay_ms and whose followers are up to date is quiesced.
+     * The heartbeats of a quiesced group are replaced by its group id in the
+     * per node heartbeat request, which only refreshes the leader liveness on
+     * the followers and the followers liveness on the leader. The next
+     * append, term or configuration change makes the group leave quiescence
+     * since they change the tracked offsets.
+     */
+    bool is_quiesced();
+    /// Resume regular heartbeats, used when a follower doesn't recognize
+    /// this node as the leader of a quiesced group
+    void wake_from_quiescence();
+    /// Leader side, the follower acknowledged the quiesced group heartbeat
+    void process_quiesced_heartbeat_reply(vnode);
+    /// Follower side, returns false if the node isn't the current leader
+    bool process_quiesced_heartbeat(model::node_id);
+
     std::vector<follower_metrics> get_follower_metrics() const;
 
     const configuration_manager& get_configuration_manager() const {
         return _configuration_manager;
     }
 
-    offset_monitor& visible_offset_monitor() {
-        return _consumable_offset_monitor;
-    }
+    /// Waits until an offset past the last visible one becomes visible.
+    /// The wait holds the background gate and is aborted when the consensus
+    /// stops, when \p as is aborted or at the deadline
+    ss::future<> wait_for_next_visible_offset(
+      model::timeout_clock::time_point deadline, ss::abort_source& as);
 
 private:
     friend replicate_entries_stm;
     friend vote_stm;
     friend prevote_stm;
     friend recovery_stm;
+    friend range_recovery_stm;
     friend replicate_batcher;
     friend event_manager;
     friend append_entries_buffer;
+    friend consensus_flush_fixture;
     using update_last_quorum_index
       = ss::bool_class<struct update_last_quorum_index>;
     // all these private functions assume that we are under exclusive operations
@@ -384,6 +434,10 @@ private:
      * requests stable leadership optimization to be ignored.
      */
     void dispatch_vote(bool leadership_transfer);
+    /// waits for the turn of the election in the shard election throttle
+    ss::future<std::optional<ss::semaphore_units<>>>
+      election_units(bool leadership_transfer);
+    ss::future<> do_dispatch_vote(bool leadership_transfer);
     ss::future<bool> dispatch_prevote(bool leadership_transfer);
     bool should_skip_vote(bool ignore_heartbeat);
 
@@ -397,6 +451,17 @@ private:
     void arm_vote_timeout();
     void update_node_append_timestamp(vnode);
     void update_node_hbeat_timestamp(vnode);
+    /// extends the lease with the send time of the acknowledged request
+    void update_lease(follower_index_metadata&, follower_req_seq);
+    clock_type::time_point majority_lease_ack() const;
+
+    /// Client options of an append entries request to the follower. Requests
+    /// to followers in a different rack are compressed if they carry at
+    /// least raft_cross_rack_compression_min_bytes of batches that are not
+    /// already compressed.
+    rpc::client_opts append_entries_client_opts(
+      vnode, clock_type::time_point timeout, size_t compressible_bytes) const;
+    bool is_cross_rack(model::node_id) const;
 
     void update_follower_stats(const group_configuration&);
     void trigger_leadership_notification();
@@ -406,6 +471,9 @@ private:
     /// \brief called by the vote timer, to dispatch a write under
     /// the ops semaphore
     void dispatch_flush_with_lock();
+    /// \brief applies the flush policy of the log to the bytes appended by
+    /// a write with relaxed consistency
+    void maybe_schedule_relaxed_flush(size_t appended_bytes);
 
     void maybe_step_down();
 
@@ -524,6 +592,12 @@ private:
     /// useful for when we are not the leader
     clock_type::time_point _hbeat = clock_type::now();
     clock_type::time_point _became_leader_at = clock_type::now();
+    /// with leader leases a restarted node, which doesn't remember the
+    /// leader it heard from, grants no votes for an election timeout
+    clock_type::time_point _votes_fenced_until = clock_type::time_point::min();
+    /// the lease only counts the requests sent an election timeout after a
+    /// leadership transfer
+    clock_type::time_point _lease_fenced_until = clock_type::time_point::min();
     /// used to keep track if we are a leader, or transitioning
     vote_state _vstate = vote_state::follower;
     /// used for votes only. heartbeats are done by heartbeat_manager
@@ -532,8 +606,17 @@ private:
     /// used for keepint tally on followers
     follower_stats _fstats;
 
+    /// leader metadata last seen by is_quiesced() and since when
+    protocol_metadata _quiesce_meta;
+    clock_type::time_point _quiesce_meta_since = clock_type::now();
+
     replicate_batcher _batcher;
+    config::binding<size_t> _replicate_batch_window_size;
     bool _has_pending_flushes{false};
+    /// flushes the writes appended with relaxed consistency once they are
+    /// storage::ntp_config::flush_ms old
+    timer_type _relaxed_flush_timer;
+    size_t _relaxed_unflushed_bytes{0};
 
     /// used to wait for background ops before shutting down
     ss::gate _bg;
@@ -550,11 +633,16 @@ private:
     std::chrono::milliseconds _replicate_append_timeout;
     std::chrono::milliseconds _recovery_append_timeout;
     ss::metrics::metric_groups _metrics;
+    aggregate_metrics::registration _aggregate_metrics;
     ss::abort_source _as;
     storage::api& _storage;
     std::optional<std::reference_wrapper<recovery_throttle>> _recovery_throttle;
+    std::optional<std::reference_wrapper<election_throttle>> _election_throttle;
     storage::snapshot_manager _snapshot_mgr;
     std::optional<storage::snapshot_writer> _snapshot_writer;
+    // snapshot being received from the leader and the bytes already stored
+    model::offset _received_snapshot_index;
+    size_t _received_snapshot_bytes = 0;
     model::offset _last_snapshot_index;
     model::term_id _last_snapshot_term;
     configuration_manager _configuration_manager;
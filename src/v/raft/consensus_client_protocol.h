@@ -45,6 +45,10 @@ public:
         timeout_now(model::node_id, timeout_now_request&&, rpc::client_opts)
           = 0;
 
+        virtual ss::future<result<recover_range_reply>> recover_range(
+          model::node_id, recover_range_request&&, rpc::client_opts)
+          = 0;
+
         virtual ~impl() noexcept = default;
     };
 
@@ -86,6 +90,14 @@ public:
         return _impl->timeout_now(target_node, std::move(r), std::move(opts));
     }
 
+    ss::future<result<recover_range_reply>> recover_range(
+      model::node_id target_node,
+      recover_range_request&& r,
+      rpc::client_opts opts) {
+        return _impl->recover_range(
+          target_node, std::move(r), std::move(opts));
+    }
+
 private:
     ss::shared_ptr<impl> _impl;
 };
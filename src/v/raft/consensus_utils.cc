@@ -13,6 +13,7 @@
 #include "model/fundamental.h"
 #include "model/record.h"
 #include "model/timestamp.h"
+#include "raft/configuration_manager.h"
 #include "raft/group_configuration.h"
 #include "raft/logger.h"
 #include "raft/types.h"
@@ -319,6 +320,13 @@ bytes serialize_group_key(raft::group_id group, metadata_key key_type) {
     return iobuf_to_bytes(buf);
 }
 
+bytes serialize_group_key(
+  raft::group_id group, metadata_key key_type, model::offset offset) {
+    iobuf buf;
+    reflection::serialize(buf, key_type, group, offset);
+    return iobuf_to_bytes(buf);
+}
+
 ss::future<> move_persistent_state(
   raft::group_id group,
   ss::shard_id source_shard,
@@ -331,6 +339,8 @@ ss::future<> move_persistent_state(
         std::optional<iobuf> configuration_map;
         std::optional<iobuf> highest_known_offset;
         std::optional<iobuf> next_cfg_idx;
+        std::optional<iobuf> configuration_offsets;
+        std::vector<std::pair<model::offset, iobuf>> configurations;
     };
     using state_ptr = std::unique_ptr<persistent_state>;
     using state_fptr = ss::foreign_ptr<std::unique_ptr<persistent_state>>;
@@ -352,11 +362,29 @@ ss::future<> move_persistent_state(
               serialize_group_key(
                 gr, metadata_key::config_latest_known_offset)),
             .next_cfg_idx = api.kvs().get(
-              ks, serialize_group_key(gr, metadata_key::config_next_cfg_idx))};
+              ks, serialize_group_key(gr, metadata_key::config_next_cfg_idx)),
+            .configuration_offsets = api.kvs().get(
+              ks, serialize_group_key(gr, metadata_key::config_offsets))};
+          if (state.configuration_offsets) {
+              for (auto o : reflection::from_iobuf<std::vector<model::offset>>(
+                     state.configuration_offsets->copy())) {
+                  auto cfg = api.kvs().get(
+                    ks, serialize_group_key(gr, metadata_key::config_entry, o));
+                  if (cfg) {
+                      state.configurations.emplace_back(o, std::move(*cfg));
+                  }
+              }
+          }
           return ss::make_foreign<state_ptr>(
             std::make_unique<persistent_state>(std::move(state)));
       });
 
+    std::vector<model::offset> cfg_offsets;
+    cfg_offsets.reserve(state->configurations.size());
+    for (const auto& [o, _] : state->configurations) {
+        cfg_offsets.push_back(o);
+    }
+
     co_await api.invoke_on(
       target_shard, [gr = group, state = std::move(state)](storage::api& api) {
           const auto ks = storage::kvstore::key_space::consensus;
@@ -399,31 +427,76 @@ ss::future<> move_persistent_state(
                 serialize_group_key(gr, metadata_key::config_next_cfg_idx),
                 state->next_cfg_idx->copy()));
           }
+          if (state->configuration_offsets) {
+              std::vector<std::pair<bytes, iobuf>> kvs;
+              kvs.reserve(state->configurations.size() + 1);
+              for (const auto& [o, cfg] : state->configurations) {
+                  kvs.emplace_back(
+                    serialize_group_key(gr, metadata_key::config_entry, o),
+                    cfg.copy());
+              }
+              kvs.emplace_back(
+                serialize_group_key(gr, metadata_key::config_offsets),
+                state->configuration_offsets->copy());
+              write_futures.push_back(api.kvs().put(ks, std::move(kvs)));
+          }
           return ss::when_all_succeed(
             write_futures.begin(), write_futures.end());
       });
 
     // remove on source shard
-    co_await api.invoke_on(source_shard, [gr = group](storage::api& api) {
-        const auto ks = storage::kvstore::key_space::consensus;
-        std::vector<ss::future<>> remove_futures;
-        remove_futures.reserve(6);
-        remove_futures.push_back(api.kvs().remove(
-          ks, serialize_group_key(gr, metadata_key::voted_for)));
-        remove_futures.push_back(api.kvs().remove(
-          ks, serialize_group_key(gr, metadata_key::last_applied_offset)));
-        remove_futures.push_back(api.kvs().remove(
-          ks, serialize_group_key(gr, metadata_key::unique_local_id)));
-        remove_futures.push_back(api.kvs().remove(
-          ks, serialize_group_key(gr, metadata_key::config_map)));
-        remove_futures.push_back(api.kvs().remove(
-          ks,
-          serialize_group_key(gr, metadata_key::config_latest_known_offset)));
-        remove_futures.push_back(api.kvs().remove(
-          ks, serialize_group_key(gr, metadata_key::config_next_cfg_idx)));
-        return ss::when_all_succeed(
-          remove_futures.begin(), remove_futures.end());
-    });
+    co_await api.invoke_on(
+      source_shard,
+      [gr = group, cfg_offsets = std::move(cfg_offsets)](storage::api& api) {
+          const auto ks = storage::kvstore::key_space::consensus;
+          std::vector<ss::future<>> remove_futures;
+          remove_futures.reserve(8);
+          remove_futures.push_back(api.kvs().remove(
+            ks, serialize_group_key(gr, metadata_key::voted_for)));
+          remove_futures.push_back(api.kvs().remove(
+            ks, serialize_group_key(gr, metadata_key::last_applied_offset)));
+          remove_futures.push_back(api.kvs().remove(
+            ks, serialize_group_key(gr, metadata_key::unique_local_id)));
+          remove_futures.push_back(api.kvs().remove(
+            ks, serialize_group_key(gr, metadata_key::config_map)));
+          remove_futures.push_back(api.kvs().remove(
+            ks,
+            serialize_group_key(gr, metadata_key::config_latest_known_offset)));
+          remove_futures.push_back(api.kvs().remove(
+            ks, serialize_group_key(gr, metadata_key::config_next_cfg_idx)));
+          remove_futures.push_back(api.kvs().remove(
+            ks, serialize_group_key(gr, metadata_key::config_offsets)));
+          std::vector<bytes> cfg_keys;
+          cfg_keys.reserve(cfg_offsets.size());
+          for (auto o : cfg_offsets) {
+              cfg_keys.push_back(
+                serialize_group_key(gr, metadata_key::config_entry, o));
+          }
+          remove_futures.push_back(api.kvs().remove(ks, std::move(cfg_keys)));
+          return ss::when_all_succeed(
+            remove_futures.begin(), remove_futures.end());
+      });
+}
+
+ss::future<> bootstrap_restored_state(
+  storage::api& api,
+  raft::group_id group,
+  const model::ntp& ntp,
+  group_configuration cfg,
+  model::offset last_offset) {
+    ctx_log log(group, ntp);
+    auto revision = cfg.revision_id();
+    configuration_manager cfg_mgr(cfg, group, api, log);
+    // drops the state left by an earlier incarnation of the group
+    co_await cfg_mgr.start(true, revision);
+    // the highest known offset is moved to the last restored offset, the
+    // restored log is not searched for configurations
+    co_await cfg_mgr.add(last_offset, std::move(cfg));
+    co_await cfg_mgr.stop();
+    co_await api.kvs().put(
+      storage::kvstore::key_space::consensus,
+      serialize_group_key(group, metadata_key::last_applied_offset),
+      reflection::to_iobuf(last_offset));
 }
 
 } // namespace raft::details
@@ -179,6 +179,8 @@ auto for_each_ref_extract_configuration(
 }
 
 bytes serialize_group_key(raft::group_id, metadata_key);
+/// key of an entry of the group stored per offset, i.e. a configuration
+bytes serialize_group_key(raft::group_id, metadata_key, model::offset);
 /**
  * moves raft persistent state from KV store on source shard to the one on
  * target shard.
@@ -189,4 +191,19 @@ ss::future<> move_persistent_state(
   ss::shard_id target_shard,
   ss::sharded<storage::api>&);
 
+/**
+ * Bootstraps the raft persistent state of a group whose log was restored
+ * with the entries of another group, i.e. downloaded from the cloud storage,
+ * before the group is created. The group starts with the given configuration
+ * at the last restored offset and all the restored entries committed, the
+ * configurations found in the restored log belong to the other group and
+ * are never read.
+ */
+ss::future<> bootstrap_restored_state(
+  storage::api&,
+  raft::group_id,
+  const model::ntp&,
+  group_configuration,
+  model::offset last_offset);
+
 } // namespace raft::details
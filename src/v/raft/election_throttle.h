@@ -0,0 +1,51 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#pragma once
+#include "seastarx.h"
+
+#include <seastar/core/semaphore.hh>
+
+#include <algorithm>
+
+namespace raft {
+
+/*
+ * Bounds the number of raft groups of the shard that run an election at the
+ * same time.
+ *
+ * When a node fails all the groups it led start their elections within the
+ * same election timeout, the vote requests of thousands of groups flood the
+ * surviving nodes. With the throttle the elections of the shard run in waves,
+ * a group that waited for its turn skips the election if it heard from a new
+ * leader in the meantime. The leadership transfers are not throttled.
+ */
+class election_throttle {
+public:
+    using clock_type = ss::semaphore::clock;
+
+    explicit election_throttle(size_t max_concurrent_elections)
+      : _elections(std::max<size_t>(max_concurrent_elections, 1)) {}
+
+    /// Units of the shard budget of concurrent elections, held until the
+    /// election is decided
+    ss::future<ss::semaphore_units<>> units(clock_type::time_point timeout) {
+        return ss::get_units(_elections, 1, timeout);
+    }
+
+    size_t waiters() const { return _elections.waiters(); }
+
+    void stop() { _elections.broken(); }
+
+private:
+    ss::semaphore _elections;
+};
+
+} // namespace raft
@@ -12,9 +12,18 @@
 #include "config/configuration.h"
 #include "model/metadata.h"
 #include "prometheus/prometheus_sanitize.h"
+#include "raft/consensus_utils.h"
+#include "raft/probe.h"
+#include "raft/replicate_batcher.h"
 #include "resource_mgmt/io_priority.h"
+#include "vlog.h"
 
+#include <seastar/core/loop.hh>
 #include <seastar/core/scheduling.hh>
+#include <seastar/core/with_timeout.hh>
+#include <seastar/util/later.hh>
+
+#include <boost/range/irange.hpp>
 
 namespace raft {
 
@@ -32,14 +41,33 @@ group_manager::group_manager(
   , _raft_sg(raft_sg)
   , _client(make_rpc_client_protocol(self, clients))
   , _heartbeats(heartbeat_interval, _client, _self, heartbeat_timeout)
+  , _heartbeat_interval(heartbeat_interval)
+  , _heartbeat_timeout(heartbeat_timeout)
+  , _aggregate_heartbeats(
+      config::shard_local_cfg().raft_enable_heartbeat_aggregation()
+      && ss::smp::count > 1)
   , _storage(storage.local())
-  , _recovery_throttle(recovery_throttle.local()) {
+  , _recovery_throttle(recovery_throttle.local())
+  , _election_throttle(
+      config::shard_local_cfg().raft_max_concurrent_elections()) {
+    _aggregation_timer.set_callback(
+      [this] { dispatch_aggregated_heartbeats(); });
     setup_metrics();
 }
 
-ss::future<> group_manager::start() { return _heartbeats.start(); }
+ss::future<> group_manager::start() {
+    if (!_aggregate_heartbeats) {
+        return _heartbeats.start();
+    }
+    if (ss::this_shard_id() == heartbeat_aggregator_shard) {
+        dispatch_aggregated_heartbeats();
+    }
+    return ss::now();
+}
 
 ss::future<> group_manager::stop() {
+    _election_throttle.stop();
+    _aggregation_timer.cancel();
     return _gate.close()
       .then([this] { return _heartbeats.stop(); })
       .then([this] {
@@ -49,16 +77,16 @@ ss::future<> group_manager::stop() {
       });
 }
 
-ss::future<ss::lw_shared_ptr<raft::consensus>> group_manager::create_group(
-  raft::group_id id, std::vector<model::broker> nodes, storage::log log) {
-    auto revision = log.config().get_revision();
-    auto raft = ss::make_lw_shared<raft::consensus>(
+ss::lw_shared_ptr<raft::consensus>
+group_manager::make_group(group_request req) {
+    auto revision = req.log.config().get_revision();
+    return ss::make_lw_shared<raft::consensus>(
       _self,
-      id,
-      raft::group_configuration(std::move(nodes), revision),
+      req.id,
+      raft::group_configuration(std::move(req.nodes), revision),
       raft::timeout_jitter(
         config::shard_local_cfg().raft_election_timeout_ms()),
-      log,
+      req.log,
       scheduling_config(_raft_sg, raft_priority()),
       _disk_timeout,
       _client,
@@ -66,16 +94,101 @@ ss::future<ss::lw_shared_ptr<raft::consensus>> group_manager::create_group(
           trigger_leadership_notification(std::move(st));
       },
       _storage,
-      _recovery_throttle);
+      _recovery_throttle,
+      _election_throttle);
+}
 
-    return ss::with_gate(_gate, [this, raft] {
-        return _heartbeats.register_group(raft).then([this, raft] {
-            _groups.push_back(raft);
-            return raft;
-        });
+ss::future<std::vector<ss::lw_shared_ptr<raft::consensus>>>
+group_manager::create_groups(std::vector<group_request> requests) {
+    using ret_t = std::vector<ss::lw_shared_ptr<raft::consensus>>;
+    if (_gate.is_closed()) {
+        return ss::make_exception_future<ret_t>(ss::gate_closed_exception());
+    }
+    std::vector<ss::lw_shared_ptr<raft::consensus>> groups;
+    groups.reserve(requests.size());
+    for (auto& req : requests) {
+        groups.push_back(make_group(std::move(req)));
+    }
+
+    return ss::with_gate(_gate, [this, groups = std::move(groups)]() mutable {
+        return _heartbeats.register_groups(groups).then(
+          [this, groups = std::move(groups)]() mutable {
+              _groups.insert(_groups.end(), groups.begin(), groups.end());
+              return std::move(groups);
+          });
+    });
+}
+
+ss::future<ss::lw_shared_ptr<raft::consensus>> group_manager::create_group(
+  raft::group_id id, std::vector<model::broker> nodes, storage::log log) {
+    if (_gate.is_closed()) {
+        return ss::make_exception_future<ss::lw_shared_ptr<raft::consensus>>(
+          ss::gate_closed_exception());
+    }
+    // the group is created with the ones requested before the next
+    // scheduling point
+    _pending_groups.push_back(pending_group{
+      .request = group_request{
+        .id = id, .nodes = std::move(nodes), .log = std::move(log)}});
+    auto f = _pending_groups.back().created.get_future();
+    if (!_creating_groups) {
+        _creating_groups = true;
+        (void)ss::with_gate(_gate, [this] { return create_pending_groups(); });
+    }
+    return f;
+}
+
+ss::future<> group_manager::bootstrap_restored_group(
+  raft::group_id id, std::vector<model::broker> nodes, storage::log log) {
+    return details::bootstrap_restored_state(
+      _storage,
+      id,
+      log.config().ntp(),
+      raft::group_configuration(std::move(nodes), log.config().get_revision()),
+      log.offsets().dirty_offset);
+}
+
+ss::future<> group_manager::create_pending_groups() {
+    return ss::later().then([this] {
+        return ss::do_until(
+          [this] {
+              // reset in the same task that observes no pending groups, the
+              // next request starts a new round
+              if (_pending_groups.empty()) {
+                  _creating_groups = false;
+                  return true;
+              }
+              return false;
+          },
+          [this] { return create_pending_batch(); });
     });
 }
 
+ss::future<> group_manager::create_pending_batch() {
+    auto pending = std::exchange(_pending_groups, {});
+    std::vector<group_request> requests;
+    requests.reserve(pending.size());
+    for (auto& p : pending) {
+        requests.push_back(std::move(p.request));
+    }
+    using groups_t = std::vector<ss::lw_shared_ptr<raft::consensus>>;
+    return create_groups(std::move(requests))
+      .then_wrapped(
+        [pending = std::move(pending)](ss::future<groups_t> f) mutable {
+            if (f.failed()) {
+                auto e = f.get_exception();
+                for (auto& p : pending) {
+                    p.created.set_exception(e);
+                }
+                return;
+            }
+            auto groups = f.get0();
+            for (size_t i = 0; i < pending.size(); ++i) {
+                pending[i].created.set_value(std::move(groups[i]));
+            }
+        });
+}
+
 ss::future<> group_manager::remove(ss::lw_shared_ptr<raft::consensus> c) {
     return c->stop()
       .then([c] { return c->remove_persistent_state(); })
@@ -97,6 +210,118 @@ ss::future<> group_manager::shutdown(ss::lw_shared_ptr<raft::consensus> c) {
       });
 }
 
+void group_manager::dispatch_aggregated_heartbeats() {
+    (void)ss::with_gate(_gate, [this] {
+        return do_dispatch_aggregated_heartbeats().finally([this] {
+            if (!_gate.is_closed()) {
+                _aggregation_timer.arm(clock_type::now() + _heartbeat_interval);
+            }
+        });
+    }).handle_exception([](const std::exception_ptr& e) {
+        vlog(hbeatlog.warn, "Error dispatching aggregated heartbeats - {}", e);
+    });
+}
+
+ss::future<> group_manager::do_dispatch_aggregated_heartbeats() {
+    using shard_heartbeats_t = std::vector<heartbeat_manager::node_heartbeat>;
+    return container()
+      .map([](group_manager& m) {
+          if (m._gate.is_closed()) {
+              return shard_heartbeats_t{};
+          }
+          return m._heartbeats.collect_heartbeats();
+      })
+      .then([this](std::vector<shard_heartbeats_t> shards) {
+          return ss::do_with(
+            heartbeat_manager::aggregate(std::move(shards)),
+            [this](std::vector<heartbeat_manager::aggregated_heartbeat>& reqs) {
+                _aggregated_requests += reqs.size();
+                return ss::parallel_for_each(
+                  reqs, [this](heartbeat_manager::aggregated_heartbeat& r) {
+                      return send_aggregated_heartbeat(std::move(r));
+                  });
+            });
+      });
+}
+
+ss::future<> group_manager::send_aggregated_heartbeat(
+  heartbeat_manager::aggregated_heartbeat hb) {
+    // the requests to different nodes are encoded and sent by different
+    // shards
+    auto shard = ss::shard_id(hb.target() % ss::smp::count);
+    auto target = hb.target;
+    auto f = ss::try_with_gate(
+      _gate, [this, shard, hb = std::move(hb)]() mutable {
+          return container()
+            .invoke_on(
+              shard,
+              [target = hb.target,
+               req = std::move(hb.request)](group_manager& m) mutable {
+                  return m._client.heartbeat(
+                    target,
+                    std::move(req),
+                    rpc::client_opts(
+                      clock_type::now() + m._heartbeat_timeout,
+                      rpc::compression_type::zstd,
+                      512));
+              })
+            .then([this, target = hb.target, shards = std::move(hb.shards)](
+                    result<heartbeat_reply> r) mutable {
+                return dispatch_aggregated_reply(
+                  target, std::move(shards), std::move(r));
+            });
+      });
+    // fail fast to make sure that not lagging nodes will be able to receive
+    // heartbeats, the reply is still processed when it arrives
+    return ss::with_timeout(
+             clock_type::now() + _heartbeat_interval, std::move(f))
+      .handle_exception_type([target](const ss::timed_out_error&) {
+          vlog(
+            hbeatlog.trace, "Aggregated heartbeat to {} timed out", target);
+      })
+      .handle_exception_type([](const ss::gate_closed_exception&) {});
+}
+
+ss::future<> group_manager::dispatch_aggregated_reply(
+  model::node_id target,
+  std::vector<heartbeat_manager::shard_heartbeat> shards,
+  result<heartbeat_reply> r) {
+    std::vector<result<heartbeat_reply>> parts;
+    parts.reserve(shards.size());
+    if (r) {
+        for (auto& p :
+             heartbeat_manager::split_reply(shards, std::move(r.value()))) {
+            parts.emplace_back(std::move(p));
+        }
+    } else {
+        for (size_t i = 0; i < shards.size(); ++i) {
+            parts.emplace_back(r.error());
+        }
+    }
+    return ss::do_with(
+      std::move(shards),
+      std::move(parts),
+      [this, target](
+        std::vector<heartbeat_manager::shard_heartbeat>& shards,
+        std::vector<result<heartbeat_reply>>& parts) {
+          return ss::parallel_for_each(
+            boost::irange<size_t>(0, shards.size()),
+            [this, target, &shards, &parts](size_t i) {
+                return container().invoke_on(
+                  shards[i].shard,
+                  [target,
+                   hb = std::move(shards[i]),
+                   r = std::move(parts[i])](group_manager& m) mutable {
+                      if (m._gate.is_closed()) {
+                          return;
+                      }
+                      m._heartbeats.process_aggregated_reply(
+                        target, std::move(hb), std::move(r));
+                  });
+            });
+      });
+}
+
 void group_manager::trigger_leadership_notification(
   raft::leadership_status st) {
     for (auto& cb : _notifications) {
@@ -114,9 +339,52 @@ void group_manager::setup_metrics() {
     _metrics.add_group(
       prometheus_sanitize::metrics_name("raft"),
       {sm::make_gauge(
-        "group_count",
-        [this] { return _groups.size(); },
-        sm::description("Number of raft groups"))});
+         "group_count",
+         [this] { return _groups.size(); },
+         sm::description("Number of raft groups")),
+       sm::make_derive(
+         "aggregated_heartbeat_requests",
+         [this] { return _aggregated_requests; },
+         sm::description("Number of heartbeat requests carrying the "
+                         "heartbeats of all of the shards of the node")),
+       sm::make_gauge(
+         "throttled_elections",
+         [this] { return _election_throttle.waiters(); },
+         sm::description("Number of elections waiting for their turn")),
+       sm::make_histogram(
+         "replicate_batch_size",
+         [] {
+             return replicate_batcher_stats::local()
+               .batch_size.seastar_histogram_logform();
+         },
+         sm::description(
+           "Size in bytes of the batches flushed by the replicate batchers")),
+       sm::make_histogram(
+         "replicate_linger_us",
+         [] {
+             return replicate_batcher_stats::local()
+               .linger.seastar_histogram_logform();
+         },
+         sm::description("Time in microseconds the replicate batchers held "
+                         "the writes to merge them"))});
+
+    auto stage_hist = [](replicate_stage stage) {
+        return sm::make_histogram(
+          stage_latency_metric_name(stage),
+          [stage] {
+              return probe::shard_stage_latency()[static_cast<size_t>(stage)]
+                .seastar_histogram_logform();
+          },
+          sm::description(stage_latency_description(stage)));
+    };
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("raft"),
+      {stage_hist(replicate_stage::batcher_queue),
+       stage_hist(replicate_stage::leader_append),
+       stage_hist(replicate_stage::leader_flush),
+       stage_hist(replicate_stage::follower_rpc),
+       stage_hist(replicate_stage::follower_flush),
+       stage_hist(replicate_stage::commit_index_update)});
 }
 
 } // namespace raft
@@ -13,6 +13,7 @@
 #include "cluster/types.h"
 #include "model/metadata.h"
 #include "raft/consensus_client_protocol.h"
+#include "raft/election_throttle.h"
 #include "raft/heartbeat_manager.h"
 #include "raft/rpc_client_protocol.h"
 #include "raft/types.h"
@@ -20,6 +21,7 @@
 
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/scheduling.hh>
+#include <seastar/core/sharded.hh>
 
 #include <absl/container/flat_hash_map.h>
 
@@ -29,9 +31,16 @@ namespace raft {
 
 /*
  * Owns and manages all raft groups.
+ *
+ * When the heartbeats are aggregated the group manager of the aggregator
+ * shard dispatches the heartbeats of all of the shards every heartbeat
+ * interval, a node receives a single heartbeat request from its peer instead
+ * of one per shard.
  */
-class group_manager {
+class group_manager : public ss::peering_sharded_service<group_manager> {
 public:
+    static constexpr ss::shard_id heartbeat_aggregator_shard = 0;
+
     using leader_cb_t = ss::noncopyable_function<void(
       raft::group_id, model::term_id, std::optional<model::node_id>)>;
 
@@ -48,9 +57,37 @@ public:
     ss::future<> start();
     ss::future<> stop();
 
+    struct group_request {
+        raft::group_id id;
+        std::vector<model::broker> nodes;
+        storage::log log;
+    };
+
+    /**
+     * Creates the groups at once, they are registered with the heartbeat
+     * manager in a single batch.
+     */
+    ss::future<std::vector<ss::lw_shared_ptr<raft::consensus>>>
+      create_groups(std::vector<group_request>);
+
+    /**
+     * Creates a single group. The groups requested while the previous ones
+     * are being created, i.e. by the concurrent reconciliations of the
+     * partitions during startup or of a large topic, are created together
+     * with create_groups.
+     */
     ss::future<ss::lw_shared_ptr<raft::consensus>> create_group(
       raft::group_id id, std::vector<model::broker> nodes, storage::log log);
 
+    /**
+     * Bootstraps the persistent state of a group whose log was restored
+     * from the entries of another group, i.e. from the cloud storage. Called
+     * before the group is created, it starts with the nodes as its
+     * configuration and the restored entries committed.
+     */
+    ss::future<> bootstrap_restored_group(
+      raft::group_id id, std::vector<model::broker> nodes, storage::log log);
+
     ss::future<> shutdown(ss::lw_shared_ptr<raft::consensus>);
 
     ss::future<> remove(ss::lw_shared_ptr<raft::consensus>);
@@ -79,22 +116,46 @@ public:
     }
 
 private:
+    struct pending_group {
+        group_request request;
+        ss::promise<ss::lw_shared_ptr<raft::consensus>> created;
+    };
+
     void trigger_leadership_notification(raft::leadership_status);
     void setup_metrics();
+    void dispatch_aggregated_heartbeats();
+    ss::future<> do_dispatch_aggregated_heartbeats();
+    ss::future<>
+      send_aggregated_heartbeat(heartbeat_manager::aggregated_heartbeat);
+    ss::future<> dispatch_aggregated_reply(
+      model::node_id,
+      std::vector<heartbeat_manager::shard_heartbeat>,
+      result<heartbeat_reply>);
+    ss::lw_shared_ptr<raft::consensus> make_group(group_request);
+    ss::future<> create_pending_groups();
+    ss::future<> create_pending_batch();
 
     model::node_id _self;
     model::timeout_clock::duration _disk_timeout;
     ss::scheduling_group _raft_sg;
     raft::consensus_client_protocol _client;
     raft::heartbeat_manager _heartbeats;
+    std::chrono::milliseconds _heartbeat_interval;
+    std::chrono::milliseconds _heartbeat_timeout;
+    bool _aggregate_heartbeats;
+    timer_type _aggregation_timer;
+    uint64_t _aggregated_requests{0};
     ss::gate _gate;
     std::vector<ss::lw_shared_ptr<raft::consensus>> _groups;
+    std::vector<pending_group> _pending_groups;
+    bool _creating_groups{false};
     cluster::notification_id_type _notification_id{0};
     std::vector<std::pair<cluster::notification_id_type, leader_cb_t>>
       _notifications;
     ss::metrics::metric_groups _metrics;
     storage::api& _storage;
     recovery_throttle& _recovery_throttle;
+    election_throttle _election_throttle;
 };
 
 } // namespace raft
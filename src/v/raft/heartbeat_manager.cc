@@ -36,11 +36,17 @@ using consensus_ptr = heartbeat_manager::consensus_ptr;
 using consensus_set = heartbeat_manager::consensus_set;
 
 static std::vector<heartbeat_manager::node_heartbeat> requests_for_range(
-  const consensus_set& c, clock_type::duration heartbeat_interval) {
+  const consensus_set& c,
+  clock_type::duration heartbeat_interval,
+  model::node_id self) {
     absl::flat_hash_map<
       model::node_id,
       std::vector<std::pair<heartbeat_metadata, follower_req_seq>>>
       pending_beats;
+    absl::flat_hash_map<
+      model::node_id,
+      absl::flat_hash_map<raft::group_id, vnode>>
+      pending_quiesced;
     if (c.empty()) {
         return {};
     }
@@ -50,6 +56,17 @@ static std::vector<heartbeat_manager::node_heartbeat> requests_for_range(
             continue;
         }
 
+        if (ptr->is_quiesced()) {
+            // only refresh the liveness of the leader and its followers
+            ptr->config().for_each_broker_id(
+              [ptr, &pending_quiesced](const vnode& rni) {
+                  if (rni != ptr->self()) {
+                      pending_quiesced[rni.id()].emplace(ptr->group(), rni);
+                  }
+              });
+            continue;
+        }
+
         auto maybe_create_follower_request = [ptr,
                                               last_heartbeat,
                                               &pending_beats](
@@ -94,7 +111,7 @@ static std::vector<heartbeat_manager::node_heartbeat> requests_for_range(
     }
 
     std::vector<heartbeat_manager::node_heartbeat> reqs;
-    reqs.reserve(pending_beats.size());
+    reqs.reserve(pending_beats.size() + pending_quiesced.size());
     for (auto& p : pending_beats) {
         std::vector<heartbeat_metadata> requests;
         absl::flat_hash_map<
@@ -110,8 +127,37 @@ static std::vector<heartbeat_manager::node_heartbeat> requests_for_range(
                 seq, hb.meta.prev_log_index, hb.target_node_id});
             requests.push_back(std::move(hb));
         }
+        heartbeat_request req{
+          .heartbeats = std::move(requests),
+          .node_id = self,
+          .target_node_id = p.first};
+        if (auto it = pending_quiesced.find(p.first);
+            it != pending_quiesced.end()) {
+            req.quiesced_groups.reserve(it->second.size());
+            for (auto& [g, _] : it->second) {
+                req.quiesced_groups.push_back(g);
+            }
+            reqs.emplace_back(p.first, std::move(req), std::move(meta_map));
+            reqs.back().quiesced_map = std::move(it->second);
+            pending_quiesced.erase(it);
+            continue;
+        }
+        reqs.emplace_back(p.first, std::move(req), std::move(meta_map));
+    }
+    // nodes that only host followers of quiesced groups
+    for (auto& [target, groups] : pending_quiesced) {
+        heartbeat_request req{.node_id = self, .target_node_id = target};
+        req.quiesced_groups.reserve(groups.size());
+        for (auto& [g, _] : groups) {
+            req.quiesced_groups.push_back(g);
+        }
         reqs.emplace_back(
-          p.first, heartbeat_request{std::move(requests)}, std::move(meta_map));
+          target,
+          std::move(req),
+          absl::flat_hash_map<
+            raft::group_id,
+            heartbeat_manager::follower_request_meta>{});
+        reqs.back().quiesced_map = std::move(groups);
     }
 
     return reqs;
@@ -149,7 +195,8 @@ heartbeat_manager::send_heartbeats(std::vector<node_heartbeat> reqs) {
 }
 
 ss::future<> heartbeat_manager::do_dispatch_heartbeats() {
-    auto reqs = requests_for_range(_consensus_groups, _heartbeat_interval);
+    auto reqs = requests_for_range(
+      _consensus_groups, _heartbeat_interval, _self);
     return send_heartbeats(std::move(reqs));
 }
 
@@ -180,10 +227,16 @@ ss::future<> heartbeat_manager::do_heartbeat(node_heartbeat&& r) {
                    clock_type::now() + _heartbeat_timeout,
                    rpc::compression_type::zstd,
                    512))
-               .then([node = r.target, groups = std::move(r.meta_map), this](
-                       result<heartbeat_reply> ret) mutable {
+               .then([node = r.target,
+                      groups = std::move(r.meta_map),
+                      quiesced = std::move(r.quiesced_map),
+                      this](result<heartbeat_reply> ret) mutable {
                    // this will happen after RPC client will return and resume
                    // sending heartbeats to follower
+                   if (ret) {
+                       process_quiesced_reply(
+                         std::move(quiesced), ret.value().woken_groups);
+                   }
                    process_reply(node, std::move(groups), std::move(ret));
                });
     // fail fast to make sure that not lagging nodes will be able to receive
@@ -196,6 +249,86 @@ ss::future<> heartbeat_manager::do_heartbeat(node_heartbeat&& r) {
       .handle_exception_type([](const ss::gate_closed_exception&) {});
 }
 
+std::vector<heartbeat_manager::node_heartbeat>
+heartbeat_manager::collect_heartbeats() {
+    auto reqs = requests_for_range(
+      _consensus_groups, _heartbeat_interval, _self);
+    auto it = std::find_if(
+      reqs.begin(), reqs.end(), [this](const node_heartbeat& r) {
+          return r.target == _self;
+      });
+    if (it != reqs.end()) {
+        // the self heartbeat is processed synchronously
+        (void)do_self_heartbeat(std::move(*it));
+        reqs.erase(it);
+    }
+    return reqs;
+}
+
+void heartbeat_manager::process_aggregated_reply(
+  model::node_id n, shard_heartbeat hb, result<heartbeat_reply> r) {
+    if (r) {
+        process_quiesced_reply(
+          std::move(hb.quiesced_map), r.value().woken_groups);
+    }
+    process_reply(n, std::move(hb.meta_map), std::move(r));
+}
+
+std::vector<heartbeat_manager::aggregated_heartbeat>
+heartbeat_manager::aggregate(std::vector<std::vector<node_heartbeat>> shards) {
+    std::vector<aggregated_heartbeat> ret;
+    absl::flat_hash_map<model::node_id, size_t> idx;
+    for (ss::shard_id s = 0; s < shards.size(); ++s) {
+        for (auto& hb : shards[s]) {
+            auto [it, inserted] = idx.try_emplace(hb.target, ret.size());
+            if (inserted) {
+                ret.push_back(aggregated_heartbeat{
+                  .target = hb.target,
+                  .request = heartbeat_request{
+                    .node_id = hb.request.node_id,
+                    .target_node_id = hb.request.target_node_id}});
+            }
+            auto& agg = ret[it->second];
+            std::move(
+              hb.request.heartbeats.begin(),
+              hb.request.heartbeats.end(),
+              std::back_inserter(agg.request.heartbeats));
+            std::move(
+              hb.request.quiesced_groups.begin(),
+              hb.request.quiesced_groups.end(),
+              std::back_inserter(agg.request.quiesced_groups));
+            agg.shards.push_back(shard_heartbeat{
+              .shard = s,
+              .meta_map = std::move(hb.meta_map),
+              .quiesced_map = std::move(hb.quiesced_map)});
+        }
+    }
+    return ret;
+}
+
+std::vector<heartbeat_reply> heartbeat_manager::split_reply(
+  const std::vector<shard_heartbeat>& shards, heartbeat_reply reply) {
+    std::vector<heartbeat_reply> ret(shards.size());
+    // a group is led by a single shard, the number of shards is small
+    for (auto& m : reply.meta) {
+        for (size_t i = 0; i < shards.size(); ++i) {
+            if (shards[i].meta_map.contains(m.group)) {
+                ret[i].meta.push_back(std::move(m));
+                break;
+            }
+        }
+    }
+    for (auto g : reply.woken_groups) {
+        for (size_t i = 0; i < shards.size(); ++i) {
+            if (shards[i].quiesced_map.contains(g)) {
+                ret[i].woken_groups.push_back(g);
+                break;
+            }
+        }
+    }
+    return ret;
+}
+
 void heartbeat_manager::process_reply(
   model::node_id n,
   absl::flat_hash_map<raft::group_id, follower_request_meta> groups,
@@ -243,6 +376,25 @@ void heartbeat_manager::process_reply(
     }
 }
 
+void heartbeat_manager::process_quiesced_reply(
+  absl::flat_hash_map<raft::group_id, vnode> groups,
+  const std::vector<raft::group_id>& woken) {
+    for (auto g : woken) {
+        auto it = _consensus_groups.find(g);
+        if (it != _consensus_groups.end()) {
+            vlog(hbeatlog.trace, "Waking up quiesced group:{}", g);
+            (*it)->wake_from_quiescence();
+        }
+        groups.erase(g);
+    }
+    for (auto& [g, follower] : groups) {
+        auto it = _consensus_groups.find(g);
+        if (it != _consensus_groups.end()) {
+            (*it)->process_quiesced_heartbeat_reply(follower);
+        }
+    }
+}
+
 void heartbeat_manager::dispatch_heartbeats() {
     (void)with_gate(_bghbeats, [this] {
         return _lock.with([this] {
@@ -279,6 +431,21 @@ heartbeat_manager::register_group(ss::lw_shared_ptr<consensus> ptr) {
     });
 }
 
+ss::future<> heartbeat_manager::register_groups(
+  std::vector<ss::lw_shared_ptr<consensus>> groups) {
+    return _lock.with([this, groups = std::move(groups)] {
+        // a range insert into the flat set sorts and merges the groups once,
+        // instead of shifting the elements for every group
+        auto size = _consensus_groups.size();
+        _consensus_groups.insert(groups.begin(), groups.end());
+        vassert(
+          _consensus_groups.size() == size + groups.size(),
+          "double registration of groups, registered: {}, added: {}",
+          _consensus_groups.size() - size,
+          groups.size());
+    });
+}
+
 ss::future<> heartbeat_manager::start() {
     dispatch_heartbeats();
     return ss::make_ready_future<>();
@@ -82,6 +82,20 @@ extern ss::logger hbeatlog;
  *
  *    heartbeat({L0, L1}) -> {F0, F1}(node-b)
  *    heartbeat({L0, L1}) -> {F0, F1}(node-c)
+ *
+ * When quiescence is enabled the heartbeats of idle groups (see
+ * consensus::is_quiesced()) are replaced by their group ids, the target node
+ * only refreshes the leader liveness of these groups without dispatching an
+ * append entries request and replies with the groups for which the source node
+ * isn't the leader anymore. Nodes hosting only quiesced followers still get
+ * one request per heartbeat interval.
+ *
+ * Every shard has its own heartbeat manager. When the heartbeats are
+ * aggregated (see group_manager) the managers don't dispatch the heartbeats
+ * themselves, a single shard collects the heartbeats of all of the shards
+ * with collect_heartbeats(), merges the ones addressed to the same node into
+ * one request with aggregate() and hands the parts of the reply back to the
+ * shards of the groups with process_aggregated_reply().
  */
 class heartbeat_manager {
 public:
@@ -109,6 +123,22 @@ public:
         // each raft group has its own follower metadata hence we need map to
         // track a sequence per group
         absl::flat_hash_map<raft::group_id, follower_request_meta> meta_map;
+        // followers of the quiesced groups of the request
+        absl::flat_hash_map<raft::group_id, vnode> quiesced_map;
+    };
+
+    // The follower metadata of the heartbeats of a single shard that are
+    // part of an aggregated request
+    struct shard_heartbeat {
+        ss::shard_id shard;
+        absl::flat_hash_map<raft::group_id, follower_request_meta> meta_map;
+        absl::flat_hash_map<raft::group_id, vnode> quiesced_map;
+    };
+    // Heartbeats from all shards for single node
+    struct aggregated_heartbeat {
+        model::node_id target;
+        heartbeat_request request;
+        std::vector<shard_heartbeat> shards;
     };
 
     heartbeat_manager(
@@ -118,11 +148,33 @@ public:
       duration_type);
 
     ss::future<> register_group(ss::lw_shared_ptr<consensus>);
+    /// registers all of the groups at once, under a single acquisition of
+    /// the lock
+    ss::future<> register_groups(std::vector<ss::lw_shared_ptr<consensus>>);
     ss::future<> deregister_group(raft::group_id);
 
     ss::future<> start();
     ss::future<> stop();
 
+    /// \brief builds the heartbeats of the groups of this shard without
+    /// dispatching them, the self heartbeats are handled in place
+    std::vector<node_heartbeat> collect_heartbeats();
+
+    /// \brief processes the part of the reply to an aggregated request that
+    /// belongs to the groups of this shard
+    void process_aggregated_reply(
+      model::node_id, shard_heartbeat, result<heartbeat_reply>);
+
+    /// \brief merges the heartbeats of the shards, indexed by the shard,
+    /// into a single request per target node
+    static std::vector<aggregated_heartbeat>
+      aggregate(std::vector<std::vector<node_heartbeat>>);
+
+    /// \brief splits the reply to an aggregated request, the parts are in
+    /// the order of the shards of the request
+    static std::vector<heartbeat_reply>
+    split_reply(const std::vector<shard_heartbeat>&, heartbeat_reply);
+
 private:
     void dispatch_heartbeats();
 
@@ -147,6 +199,12 @@ private:
       absl::flat_hash_map<raft::group_id, follower_request_meta> groups,
       result<heartbeat_reply> result);
 
+    /// \brief refreshes the followers liveness of the quiesced groups and
+    /// wakes up the ones that the follower didn't recognize
+    void process_quiesced_reply(
+      absl::flat_hash_map<raft::group_id, vnode> groups,
+      const std::vector<raft::group_id>& woken);
+
     // private members
 
     mutex _lock;
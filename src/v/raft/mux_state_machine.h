@@ -120,6 +120,17 @@ public:
       model::timeout_clock::time_point timeout,
       ss::abort_source& as);
 
+protected:
+    /// Applies the batch to the state that accepts it, without notifying the
+    /// replicate callers. Batches that no state accepts are ignored.
+    ss::future<std::error_code> apply_to_state(model::record_batch);
+
+    /// Invoked after each batch is applied, the next batch is applied once
+    /// the returned future resolves
+    virtual ss::future<> on_applied(model::offset) { return ss::now(); }
+
+    consensus* _c;
+
 private:
     using promise_t = expiring_promise<std::error_code>;
     // promises used to wait for result of state applies, keyed by offser
@@ -168,7 +179,6 @@ private:
      *
      */
     mutex _mutex;
-    consensus* _c;
     const persistent_last_applied _persist_last_applied;
     // we keep states in a tuple to automatically dispatch updates to correct
     // state
@@ -249,50 +259,57 @@ is_batch_applicable(State& s, const model::record_batch& batch) {
 
 template<typename... T>
 CONCEPT(requires(State<T>, ...))
-ss::future<> mux_state_machine<T...>::apply(model::record_batch b) {
-    return ss::with_gate(_gate, [this, b = std::move(b)]() mutable {
-        // lookup for the state to apply the update
-        auto state = std::apply(
-          [&b](T&... st) {
-              using variant_t = std::variant<T*...>;
-              std::optional<variant_t> res;
-              (void)((res = is_batch_applicable(st, b), res) || ...);
-              return res;
-          },
-          _state);
+ss::future<std::error_code>
+mux_state_machine<T...>::apply_to_state(model::record_batch b) {
+    // lookup for the state to apply the update
+    auto state = std::apply(
+      [&b](T&... st) {
+          using variant_t = std::variant<T*...>;
+          std::optional<variant_t> res;
+          (void)((res = is_batch_applicable(st, b), res) || ...);
+          return res;
+      },
+      _state);
 
-        // applicable state not found
-        if (!state) {
-            vassert(
-              b.header().type == model::record_batch_type::checkpoint
-                || b.header().type
-                     == model::record_batch_type::raft_configuration,
-              "State handler for batch of type: {} not found",
-              b.header().type);
-            return ss::now();
-        }
+    // applicable state not found
+    if (!state) {
+        vassert(
+          b.header().type == model::record_batch_type::checkpoint
+            || b.header().type == model::record_batch_type::raft_configuration,
+          "State handler for batch of type: {} not found",
+          b.header().type);
+        return ss::make_ready_future<std::error_code>(errc::success);
+    }
 
-        auto last_offset = b.last_offset();
-        // apply update
-        auto result_f = std::visit(
-          [b = std::move(b)](auto& state) mutable {
-              return state->apply_update(std::move(b));
-          },
-          *state);
+    // apply update
+    return std::visit(
+      [b = std::move(b)](auto& state) mutable {
+          return state->apply_update(std::move(b));
+      },
+      *state);
+}
 
-        return result_f.then([this, last_offset](std::error_code ec) {
-            auto f = _mutex.with([this, last_offset, ec] {
-                if (auto it = _promises.find(last_offset);
-                    it != _promises.end()) {
-                    it->second.set_value(ec);
-                }
-            });
-            if (!_persist_last_applied) {
-                return f;
-            }
-            return f.then(
-              [this, last_offset] { return write_last_applied(last_offset); });
-        });
+template<typename... T>
+CONCEPT(requires(State<T>, ...))
+ss::future<> mux_state_machine<T...>::apply(model::record_batch b) {
+    return ss::with_gate(_gate, [this, b = std::move(b)]() mutable {
+        auto last_offset = b.last_offset();
+        return apply_to_state(std::move(b))
+          .then([this, last_offset](std::error_code ec) {
+              auto f = _mutex.with([this, last_offset, ec] {
+                  if (auto it = _promises.find(last_offset);
+                      it != _promises.end()) {
+                      it->second.set_value(ec);
+                  }
+              });
+              if (!_persist_last_applied) {
+                  return f;
+              }
+              return f.then([this, last_offset] {
+                  return write_last_applied(last_offset);
+              });
+          })
+          .then([this, last_offset] { return on_applied(last_offset); });
     });
 }
 
@@ -12,6 +12,7 @@
 #include "config/configuration.h"
 #include "model/fundamental.h"
 #include "prometheus/prometheus_sanitize.h"
+#include "utils/aggregate_metrics.h"
 
 #include <seastar/core/metrics.hh>
 
@@ -30,80 +31,167 @@ probe::create_metric_labels(const model::ntp& ntp) {
     };
 }
 
+const char* stage_latency_metric_name(replicate_stage stage) {
+    switch (stage) {
+    case replicate_stage::batcher_queue:
+        return "replicate_batcher_queue_latency_us";
+    case replicate_stage::leader_append:
+        return "replicate_leader_append_latency_us";
+    case replicate_stage::leader_flush:
+        return "replicate_leader_flush_latency_us";
+    case replicate_stage::follower_rpc:
+        return "replicate_follower_rpc_latency_us";
+    case replicate_stage::follower_flush:
+        return "replicate_follower_flush_latency_us";
+    case replicate_stage::commit_index_update:
+        return "replicate_commit_index_update_latency_us";
+    }
+    __builtin_unreachable();
+}
+
+const char* stage_latency_description(replicate_stage stage) {
+    switch (stage) {
+    case replicate_stage::batcher_queue:
+        return "Time in microseconds the replicate requests waited in the "
+               "replicate batcher";
+    case replicate_stage::leader_append:
+        return "Time in microseconds of the leader log appends";
+    case replicate_stage::leader_flush:
+        return "Time in microseconds of the leader log flushes";
+    case replicate_stage::follower_rpc:
+        return "Round trip time in microseconds of the append entries "
+               "requests sent to the followers";
+    case replicate_stage::follower_flush:
+        return "Time in microseconds of the follower log flushes";
+    case replicate_stage::commit_index_update:
+        return "Time in microseconds from the leader log append to the "
+               "commit index update that includes the appended entries";
+    }
+    __builtin_unreachable();
+}
+
+replicate_stage_histograms& probe::shard_stage_latency() {
+    static thread_local replicate_stage_histograms hists;
+    return hists;
+}
+
+void probe::record_stage_latency(
+  replicate_stage stage, stage_clock_type::duration d) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    shard_stage_latency()[static_cast<size_t>(stage)].record(us);
+    if (_stage_latency) {
+        (*_stage_latency)[static_cast<size_t>(stage)].record(us);
+    }
+}
+
 void probe::setup_metrics(const model::ntp& ntp) {
     namespace sm = ss::metrics;
+    using type = metric_spec::type;
     auto labels = create_metric_labels(ntp);
+    auto group = prometheus_sanitize::metrics_name("raft");
+
+    std::vector<metric_spec> metrics = {
+      {.name = "received_vote_requests",
+       .kind = type::counter,
+       .description = "Number of vote requests received",
+       .value = [this] { return _vote_requests; }},
+      {.name = "received_append_requests",
+       .kind = type::counter,
+       .description = "Number of append requests received",
+       .value = [this] { return _append_requests; }},
+      {.name = "sent_vote_requests",
+       .kind = type::counter,
+       .description = "Number of vote requests sent",
+       .value = [this] { return _vote_requests_sent; }},
+      {.name = "replicate_ack_all_requests",
+       .kind = type::counter,
+       .description = "Number of replicate requests with quorum ack "
+                      "consistency",
+       .value = [this] { return _replicate_requests_ack_all; }},
+      {.name = "replicate_ack_leader_requests",
+       .kind = type::counter,
+       .description = "Number of replicate requests with leader ack "
+                      "consistency",
+       .value = [this] { return _replicate_requests_ack_leader; }},
+      {.name = "replicate_ack_none_requests",
+       .kind = type::counter,
+       .description = "Number of replicate requests with no ack consistency",
+       .value = [this] { return _replicate_requests_ack_none; }},
+      {.name = "done_replicate_requests",
+       .kind = type::counter,
+       .description = "Number of finished replicate requests",
+       .value = [this] { return _replicate_requests_done; }},
+      {.name = "log_flushes",
+       .kind = type::counter,
+       .description = "Number of log flushes",
+       .value = [this] { return _log_flushes; }},
+      {.name = "log_truncations",
+       .kind = type::counter,
+       .description = "Number of log truncations",
+       .value = [this] { return _log_truncations; }},
+      {.name = "leadership_changes",
+       .kind = type::counter,
+       .description = "Number of leadership changes",
+       .value = [this] { return _leadership_changes; }},
+      {.name = "replicate_request_errors",
+       .kind = type::counter,
+       .description = "Number of failed replicate requests",
+       .value = [this] { return _replicate_request_error; }},
+      {.name = "heartbeat_requests_errors",
+       .kind = type::counter,
+       .description = "Number of failed heartbeat requests",
+       .value = [this] { return _heartbeat_request_error; }},
+      {.name = "recovery_requests_errors",
+       .kind = type::counter,
+       .description = "Number of failed recovery requests",
+       .value = [this] { return _recovery_request_error; }},
+      {.name = "append_window_full",
+       .kind = type::counter,
+       .description = "Number of append entries requests that waited for "
+                      "the follower window of in flight requests",
+       .value = [this] { return _append_window_full; }},
+      {.name = "follower_busy",
+       .kind = type::counter,
+       .description = "Number of requests rejected by the followers that "
+                      "were out of memory",
+       .value = [this] { return _follower_busy; }},
+      {.name = "leader_lease_reads",
+       .kind = type::counter,
+       .description = "Number of linearizable barriers served by the "
+                      "leader lease without a round of heartbeats",
+       .value = [this] { return _leader_lease_reads; }}};
 
+    if (config::shard_local_cfg().aggregate_partition_metrics(ntp.tp.topic)) {
+        // the per partition histograms are not summed
+        _aggregate = aggregate_metrics::local().add(
+          group, {labels[0], labels[1]}, std::move(metrics));
+        return;
+    }
+    _metrics.add_group(group, make_metric_definitions(metrics, labels));
+
+    if (!config::shard_local_cfg().raft_enable_partition_latency_histograms()) {
+        return;
+    }
+    _stage_latency = std::make_unique<replicate_stage_histograms>();
+    auto stage_hist = [this, &labels](replicate_stage stage) {
+        return sm::make_histogram(
+          stage_latency_metric_name(stage),
+          [this, stage] {
+              return (*_stage_latency)[static_cast<size_t>(stage)]
+                .seastar_histogram_logform();
+          },
+          sm::description(stage_latency_description(stage)),
+          labels);
+    };
+    // shard wide histograms with the same names are exported under "raft"
     _metrics.add_group(
-      prometheus_sanitize::metrics_name("raft"),
-      {sm::make_derive(
-         "received_vote_requests",
-         [this] { return _vote_requests; },
-         sm::description("Number of vote requests received"),
-         labels),
-       sm::make_derive(
-         "received_append_requests",
-         [this] { return _append_requests; },
-         sm::description("Number of append requests received"),
-         labels),
-       sm::make_derive(
-         "sent_vote_requests",
-         [this] { return _vote_requests_sent; },
-         sm::description("Number of vote requests sent"),
-         labels),
-       sm::make_derive(
-         "replicate_ack_all_requests",
-         [this] { return _replicate_requests_ack_all; },
-         sm::description(
-           "Number of replicate requests with quorum ack consistency"),
-         labels),
-       sm::make_derive(
-         "replicate_ack_leader_requests",
-         [this] { return _replicate_requests_ack_leader; },
-         sm::description(
-           "Number of replicate requests with leader ack consistency"),
-         labels),
-       sm::make_derive(
-         "replicate_ack_none_requests",
-         [this] { return _replicate_requests_ack_none; },
-         sm::description(
-           "Number of replicate requests with no ack consistency"),
-         labels),
-       sm::make_derive(
-         "done_replicate_requests",
-         [this] { return _replicate_requests_done; },
-         sm::description("Number of finished replicate requests"),
-         labels),
-       sm::make_derive(
-         "log_flushes",
-         [this] { return _log_flushes; },
-         sm::description("Number of log flushes"),
-         labels),
-       sm::make_derive(
-         "log_truncations",
-         [this] { return _log_truncations; },
-         sm::description("Number of log truncations"),
-         labels),
-       sm::make_derive(
-         "leadership_changes",
-         [this] { return _leadership_changes; },
-         sm::description("Number of leadership changes"),
-         labels),
-       sm::make_derive(
-         "replicate_request_errors",
-         [this] { return _replicate_request_error; },
-         sm::description("Number of failed replicate requests"),
-         labels),
-       sm::make_derive(
-         "heartbeat_requests_errors",
-         [this] { return _heartbeat_request_error; },
-         sm::description("Number of failed heartbeat requests"),
-         labels),
-       sm::make_derive(
-         "recovery_requests_errors",
-         [this] { return _recovery_request_error; },
-         sm::description("Number of failed recovery requests"),
-         labels)});
+      prometheus_sanitize::metrics_name("raft:partition"),
+      {stage_hist(replicate_stage::batcher_queue),
+       stage_hist(replicate_stage::leader_append),
+       stage_hist(replicate_stage::leader_flush),
+       stage_hist(replicate_stage::follower_rpc),
+       stage_hist(replicate_stage::follower_flush),
+       stage_hist(replicate_stage::commit_index_update)});
 }
 
 } // namespace raft
@@ -11,14 +11,46 @@
 
 #pragma once
 #include "model/fundamental.h"
+#include "utils/aggregate_metrics.h"
+#include "utils/hdr_hist.h"
 
 #include <seastar/core/metrics.hh>
 #include <seastar/core/metrics_registration.hh>
+#include <seastar/core/timer.hh>
 
+#include <array>
 #include <cstdint>
+#include <memory>
 namespace raft {
+
+/// Stages of the leader replicate path (and of the follower flush) which
+/// latency is tracked by the probe
+enum class replicate_stage : uint8_t {
+    /// request waits in the replicate batcher until it is flushed
+    batcher_queue = 0,
+    /// append of the batch to the leader log
+    leader_append,
+    /// flush of the leader log
+    leader_flush,
+    /// append entries round trip to a follower
+    follower_rpc,
+    /// flush of the follower log
+    follower_flush,
+    /// wait for the leader commit index to include the appended batch
+    commit_index_update,
+};
+inline constexpr size_t replicate_stages_count = 6;
+
+/// latency histograms in microseconds, one for each replicate stage
+using replicate_stage_histograms = std::array<hdr_hist, replicate_stages_count>;
+
+const char* stage_latency_metric_name(replicate_stage);
+const char* stage_latency_description(replicate_stage);
+
 class probe {
 public:
+    using stage_clock_type = ss::steady_clock_type;
+
     void vote_request() { ++_vote_requests; }
     void append_request() { ++_append_requests; }
 
@@ -46,6 +78,16 @@ public:
     void heartbeat_request_error() { ++_heartbeat_request_error; };
     void replicate_request_error() { ++_replicate_request_error; };
     void recovery_request_error() { ++_recovery_request_error; };
+    void append_window_full() { ++_append_window_full; };
+    void follower_busy() { ++_follower_busy; };
+    void leader_lease_read() { ++_leader_lease_reads; };
+
+    /// Records the latency of the stage in the shard wide histogram and, if
+    /// raft_enable_partition_latency_histograms is set, in the partition one
+    void record_stage_latency(replicate_stage, stage_clock_type::duration);
+
+    /// Shard wide histograms, exported by the group_manager
+    static replicate_stage_histograms& shard_stage_latency();
 
 private:
     uint64_t _vote_requests = 0;
@@ -64,7 +106,14 @@ private:
     uint64_t _heartbeat_request_error = 0;
     uint64_t _replicate_request_error = 0;
     uint64_t _recovery_request_error = 0;
+    uint64_t _append_window_full = 0;
+    uint64_t _follower_busy = 0;
+    uint64_t _leader_lease_reads = 0;
+    // each histogram is large, only allocated when partition level detail
+    // is requested
+    std::unique_ptr<replicate_stage_histograms> _stage_latency;
 
     ss::metrics::metric_groups _metrics;
+    aggregate_metrics::registration _aggregate;
 };
 } // namespace raft
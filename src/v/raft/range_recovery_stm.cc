@@ -0,0 +1,171 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/range_recovery_stm.h"
+
+#include "model/record_batch_reader.h"
+#include "raft/consensus.h"
+#include "raft/consensus_utils.h"
+
+#include <seastar/core/coroutine.hh>
+
+namespace raft {
+
+range_recovery_stm::range_recovery_stm(
+  consensus* p, recover_range_request req)
+  : _ptr(p)
+  , _req(req)
+  , _next_offset(req.start_offset)
+  , _ctxlog(_ptr->_ctxlog) {}
+
+bool range_recovery_stm::is_stale() const {
+    return _ptr->_bg.is_closed() || _ptr->_term != _req.term
+           || _ptr->_vstate != consensus::vote_state::follower
+           || _ptr->_leader_id != _req.node_id;
+}
+
+ss::future<recover_range_reply> range_recovery_stm::apply() {
+    vlog(
+      _ctxlog.debug,
+      "Recovering range [{},{}] of node {} on behalf of the leader {}",
+      _req.start_offset,
+      _req.last_offset,
+      _req.follower,
+      _req.node_id);
+    recover_range_reply reply{.target_node_id = _req.node_id};
+    while (_next_offset <= _req.last_offset && _sent_bytes < _req.max_bytes
+           && !is_stale()) {
+        auto r = co_await replicate_next();
+        if (!r) {
+            break;
+        }
+        reply.success = true;
+        reply.follower_reply = std::move(*r);
+        if (
+          reply.follower_reply.result
+          != append_entries_reply::status::success) {
+            break;
+        }
+    }
+    vlog(
+      _ctxlog.debug,
+      "Recovered range [{},{}) of node {}, reply: {}",
+      _req.start_offset,
+      _next_offset,
+      _req.follower,
+      reply.follower_reply);
+    co_return reply;
+}
+
+ss::future<std::optional<append_entries_reply>>
+range_recovery_stm::replicate_next() {
+    std::optional<ss::semaphore_units<>> read_units;
+    if (_ptr->_recovery_throttle) {
+        // shares the shard wide budget of recovery reads with the recoveries
+        // of the leaders of this shard
+        read_units = co_await _ptr->_recovery_throttle->get().read_units();
+    }
+    storage::log_reader_config cfg(
+      _next_offset,
+      _req.last_offset,
+      1,
+      recovery_read_max_bytes,
+      _ptr->_scheduling.learner_recovery_iopc,
+      std::nullopt,
+      std::nullopt,
+      _ptr->_as);
+    cfg.skip_batch_cache = true;
+    cfg.read_ahead = recovery_read_ahead;
+
+    auto reader = co_await _ptr->_log.make_reader(cfg);
+    auto batches = co_await model::consume_reader_to_memory(
+      std::move(reader), model::no_timeout);
+    if (batches.empty()) {
+        co_return std::nullopt;
+    }
+    auto gap_filled_batches = details::make_ghost_batches_in_gaps(
+      _next_offset, std::move(batches));
+    auto base_offset = gap_filled_batches.begin()->base_offset();
+    auto last_offset = gap_filled_batches.back().last_offset();
+
+    auto prev_log_idx = details::prev_offset(base_offset);
+    model::term_id prev_log_term;
+    auto lstats = _ptr->_log.offsets();
+    if (prev_log_idx >= lstats.start_offset) {
+        auto term = _ptr->_log.get_term(prev_log_idx);
+        if (!term) {
+            co_return std::nullopt;
+        }
+        prev_log_term = *term;
+    } else if (prev_log_idx == _ptr->_last_snapshot_index) {
+        prev_log_term = _ptr->_last_snapshot_term;
+    } else if (prev_log_idx >= model::offset(0)) {
+        // the entry was evicted, the leader installs a snapshot
+        co_return std::nullopt;
+    }
+
+    size_t size = 0;
+    size_t compressible_bytes = 0;
+    for (const auto& b : gap_filled_batches) {
+        size += b.size_bytes();
+        if (!b.compressed()) {
+            compressible_bytes += b.size_bytes();
+        }
+    }
+    if (_ptr->_recovery_throttle) {
+        co_await _ptr->_recovery_throttle->get().throttle(size);
+    }
+    // the source might have lost the leader while reading
+    if (is_stale()) {
+        co_return std::nullopt;
+    }
+    _sent_bytes += size;
+
+    append_entries_request r(
+      _req.node_id,
+      _req.follower,
+      protocol_metadata{
+        .group = _ptr->group(),
+        .commit_index = last_offset,
+        .term = _req.term,
+        .prev_log_index = prev_log_idx,
+        .prev_log_term = prev_log_term,
+        .last_visible_index = last_offset},
+      model::make_foreign_memory_record_batch_reader(
+        std::move(gap_filled_batches)),
+      append_entries_request::flush_after_append(
+        last_offset >= _req.last_offset || _sent_bytes >= _req.max_bytes));
+
+    _ptr->_probe.recovery_append_request();
+    auto opts = _ptr->append_entries_client_opts(
+      _req.follower,
+      clock_type::now() + _ptr->_recovery_append_timeout,
+      compressible_bytes);
+    opts.conn_class = rpc::connection_class::bulk;
+    auto reply = co_await _ptr->_client_protocol.append_entries(
+      _req.follower.id(), std::move(r), std::move(opts));
+    read_units.reset();
+
+    if (!reply) {
+        vlog(
+          _ctxlog.debug,
+          "Unable to recover range of node {} - {}",
+          _req.follower,
+          reply.error().message());
+        co_return std::nullopt;
+    }
+    // the follower replies to the leader
+    if (reply.value().target_node_id != _req.node_id) {
+        co_return std::nullopt;
+    }
+    _next_offset = details::next_offset(last_offset);
+    co_return std::move(reply.value());
+}
+
+} // namespace raft
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "raft/fwd.h"
+#include "raft/logger.h"
+#include "raft/types.h"
+#include "units.h"
+
+#include <optional>
+
+namespace raft {
+
+/**
+ * Replicates a range of committed entries of the log of a follower to a
+ * lagging follower on behalf of the leader (see recover_range_request).
+ *
+ * The leader delegates the recovery of the followers that are far behind to
+ * its up to date followers, the reads and the transfers of the recoveries are
+ * spread over the replicas of the groups instead of being served by the
+ * leaders only. The range is replicated in order with append entries requests
+ * of the leader's term. The source stops after max_bytes, at the first
+ * request the follower rejects or when it isn't a follower of the leader's
+ * term anymore, the leader continues the recovery from the reply of the
+ * follower to the last request.
+ */
+class range_recovery_stm {
+    static constexpr size_t recovery_read_max_bytes = 256_KiB;
+    static constexpr uint32_t recovery_read_ahead = 16;
+
+public:
+    range_recovery_stm(consensus*, recover_range_request);
+    ss::future<recover_range_reply> apply();
+
+private:
+    bool is_stale() const;
+    /// replicates the next batches of the range, returns the reply of the
+    /// follower or std::nullopt if they weren't sent
+    ss::future<std::optional<append_entries_reply>> replicate_next();
+
+    consensus* _ptr;
+    recover_range_request _req;
+    model::offset _next_offset;
+    uint64_t _sent_bytes{0};
+    ctx_log _ctxlog;
+};
+
+} // namespace raft
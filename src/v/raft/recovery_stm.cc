@@ -9,6 +9,7 @@
 
 #include "raft/recovery_stm.h"
 
+#include "config/configuration.h"
 #include "model/fundamental.h"
 #include "model/record_batch_reader.h"
 #include "outcome_future_utils.h"
@@ -17,9 +18,12 @@
 #include "raft/errc.h"
 #include "raft/logger.h"
 #include "raft/raftgen_service.h"
+#include "rpc/errc.h"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/io_priority_class.hh>
+#include <seastar/core/sleep.hh>
 #include <seastar/core/with_scheduling_group.hh>
 
 #include <chrono>
@@ -102,6 +106,12 @@ ss::future<> recovery_stm::do_recover(ss::io_priority_class iopc) {
 
     auto follower_next_offset = meta.value()->next_index;
     auto follower_committed_match_index = meta.value()->match_committed_index();
+
+    if (auto source = pick_recovery_source(*meta.value()); source) {
+        return delegate_recovery(
+          source->first, follower_next_offset, source->second);
+    }
+
     auto f = ss::now();
 
     // we do not have next entry for the follower yet, wait for next disk append
@@ -147,6 +157,118 @@ ss::future<> recovery_stm::do_recover(ss::io_priority_class iopc) {
       });
 }
 
+std::optional<std::pair<vnode, model::offset>>
+recovery_stm::pick_recovery_source(const follower_index_metadata& meta) const {
+    if (
+      _delegation_failed
+      || !config::shard_local_cfg().raft_enable_recovery_delegation()) {
+        return std::nullopt;
+    }
+    auto next = meta.next_index;
+    if (_committed_offset() - next() < delegation_min_lag) {
+        return std::nullopt;
+    }
+    // the sources are the leader and the live voters that committed enough
+    // of the entries the follower is missing
+    std::vector<std::pair<vnode, model::offset>> sources;
+    sources.emplace_back(_ptr->self(), _committed_offset);
+    auto now = clock_type::now();
+    for (const auto& [id, f] : _ptr->_fstats) {
+        if (
+          id == _node_id || f.is_learner || f.is_recovering
+          || f.last_hbeat_timestamp + _ptr->_jit.base_duration() < now) {
+            continue;
+        }
+        auto last = std::min(_committed_offset, f.match_committed_index());
+        if (last() - next() < delegation_min_lag) {
+            continue;
+        }
+        sources.emplace_back(id, last);
+    }
+    if (sources.size() == 1) {
+        return std::nullopt;
+    }
+    std::sort(
+      sources.begin(), sources.end(), [](const auto& a, const auto& b) {
+          return a.first.id() < b.first.id();
+      });
+    // the recoveries of the groups, e.g. of all of the partitions moved to a
+    // new node, are spread over their replicas
+    auto& source = sources[(size_t(_ptr->group()()) + size_t(_node_id.id()()))
+                           % sources.size()];
+    if (source.first == _ptr->self()) {
+        return std::nullopt;
+    }
+    return source;
+}
+
+ss::future<> recovery_stm::delegate_recovery(
+  vnode source, model::offset start_offset, model::offset last_offset) {
+    vlog(
+      _ctxlog.debug,
+      "Delegating recovery of node {} range [{},{}] to {}",
+      _node_id,
+      start_offset,
+      last_offset,
+      source);
+    recover_range_request req{
+      .target_node_id = source,
+      .node_id = _ptr->self(),
+      .group = _ptr->group(),
+      .term = _term,
+      .follower = _node_id,
+      .start_offset = start_offset,
+      .last_offset = last_offset,
+      .max_bytes
+      = config::shard_local_cfg().raft_recovery_delegation_max_bytes()};
+
+    auto dirty_offset = _ptr->_log.offsets().dirty_offset;
+    _ptr->update_node_append_timestamp(_node_id);
+    auto seq = _ptr->next_follower_sequence(_node_id);
+    _ptr->update_suppress_heartbeats(_node_id, seq, heartbeats_suppressed::yes);
+    auto timeout = clock_type::now()
+                   + config::shard_local_cfg()
+                       .raft_recovery_delegation_timeout_ms();
+    auto reply = co_await _ptr->_client_protocol
+                   .recover_range(
+                     source.id(), std::move(req), rpc::client_opts(timeout))
+                   .finally([this, seq] {
+                       _ptr->update_suppress_heartbeats(
+                         _node_id, seq, heartbeats_suppressed::no);
+                   });
+    reply = _ptr->validate_reply_target_node("recover_range", std::move(reply));
+    if (!reply || !reply.value().success) {
+        vlog(
+          _ctxlog.info,
+          "Recovery of node {} delegated to {} failed, recovering from the "
+          "leader",
+          _node_id,
+          source);
+        _delegation_failed = true;
+        co_return;
+    }
+
+    auto& follower_reply = reply.value().follower_reply;
+    auto status = follower_reply.result;
+    _ptr->process_append_entries_reply(
+      _node_id.id(),
+      result<append_entries_reply>(std::move(follower_reply)),
+      seq,
+      dirty_offset);
+    if (!_ptr->_fstats.contains(_node_id)) {
+        _stop_requested = true;
+        co_return;
+    }
+    if (seq < _ptr->_fstats.get(_node_id).last_received_seq) {
+        _stop_requested = true;
+        co_return;
+    }
+    if (status != append_entries_reply::status::success) {
+        // the logs diverge, the leader finds where they match
+        _delegation_failed = true;
+    }
+}
+
 bool recovery_stm::state_changed() {
     auto meta = get_follower_meta();
     if (!meta) {
@@ -190,25 +312,64 @@ ss::future<> recovery_stm::read_range_for_recovery(
   model::offset follower_committed_match_index,
   ss::io_priority_class iopc,
   bool is_learner) {
+    if (!_ptr->_recovery_throttle) {
+        return do_read_range_for_recovery(
+          start_offset,
+          end_offset,
+          follower_committed_match_index,
+          iopc,
+          is_learner,
+          std::nullopt);
+    }
+    // shard wide budget of concurrent recovery reads
+    return _ptr->_recovery_throttle->get()
+      .read_units()
+      .then([this,
+             start_offset,
+             end_offset,
+             follower_committed_match_index,
+             iopc,
+             is_learner](ss::semaphore_units<> u) {
+          return do_read_range_for_recovery(
+            start_offset,
+            end_offset,
+            follower_committed_match_index,
+            iopc,
+            is_learner,
+            std::move(u));
+      })
+      .handle_exception_type([this](const ss::broken_semaphore&) {
+          vlog(_ctxlog.info, "Recovery throttling has stopped");
+          _stop_requested = true;
+      });
+}
+
+ss::future<> recovery_stm::do_read_range_for_recovery(
+  model::offset start_offset,
+  model::offset end_offset,
+  model::offset follower_committed_match_index,
+  ss::io_priority_class iopc,
+  bool is_learner,
+  std::optional<ss::semaphore_units<>> read_units) {
     storage::log_reader_config cfg(
       start_offset,
       end_offset,
       1,
-      // 32KB is a modest estimate. It has good batching and it also prevents an
-      // OOM situation where we have a lot of raft groups recovering at the same
-      // time and all drawing from memory. If this setting proves difficult,
-      // we'll need to throttle with a core-local semaphore
-      32 * 1024,
+      // the batches stay in memory until they are replicated to the follower,
+      // the memory is bounded by the number of concurrent recovery reads per
+      // shard (see recovery_throttle)
+      recovery_read_max_bytes,
       iopc,
       std::nullopt,
       std::nullopt,
       _ptr->_as);
 
-    if (is_learner) {
-        // skip cache insertion on miss for learners which are throttled and
-        // often catching up from the beginning of the log (e.g. new nodes)
-        cfg.skip_batch_cache = true;
-    }
+    // recovery reads are sequential and often start far behind the tail of
+    // the log (e.g. a replaced node), skip cache insertion on miss so they
+    // don't evict the batches of the tail consumers. The batches that are
+    // already cached are still used.
+    cfg.skip_batch_cache = true;
+    cfg.read_ahead = recovery_read_ahead;
 
     vlog(
       _ctxlog.trace,
@@ -238,6 +399,13 @@ ss::future<> recovery_stm::read_range_for_recovery(
             start_offset, std::move(batches));
           _base_batch_offset = gap_filled_batches.begin()->base_offset();
           _last_batch_offset = gap_filled_batches.back().last_offset();
+          const auto compressible_bytes = std::accumulate(
+            gap_filled_batches.cbegin(),
+            gap_filled_batches.cend(),
+            size_t{0},
+            [](size_t acc, const model::record_batch& batch) {
+                return batch.compressed() ? acc : acc + batch.size_bytes();
+            });
 
           auto throttle_f = ss::now();
           if (is_learner && _ptr->_recovery_throttle) {
@@ -261,12 +429,15 @@ ss::future<> recovery_stm::read_range_for_recovery(
 
           return throttle_f.then([this,
                                   f_reader = std::move(f_reader),
-                                  follower_committed_match_index]() mutable {
+                                  follower_committed_match_index,
+                                  compressible_bytes]() mutable {
               return replicate(
                 std::move(f_reader),
-                should_flush(follower_committed_match_index));
+                should_flush(follower_committed_match_index),
+                compressible_bytes);
           });
-      });
+      })
+      .finally([u = std::move(read_units)] {});
 }
 
 ss::future<> recovery_stm::open_snapshot_reader() {
@@ -275,6 +446,7 @@ ss::future<> recovery_stm::open_snapshot_reader() {
           if (rdr) {
               _snapshot_reader = std::make_unique<storage::snapshot_reader>(
                 std::move(*rdr));
+              _snapshot_index = _ptr->_last_snapshot_index;
               return _snapshot_reader->get_snapshot_size().then(
                 [this](size_t sz) { _snapshot_size = sz; });
           }
@@ -283,36 +455,109 @@ ss::future<> recovery_stm::open_snapshot_reader() {
 }
 
 ss::future<> recovery_stm::send_install_snapshot_request() {
-    // send 32KB at a time
-    return read_iobuf_exactly(_snapshot_reader->input(), 32_KiB)
-      .then([this](iobuf chunk) mutable {
-          auto chunk_size = chunk.size_bytes();
-          install_snapshot_request req{
-            .target_node_id = _node_id,
-            .term = _ptr->term(),
-            .group = _ptr->group(),
-            .node_id = _ptr->_self,
-            .last_included_index = _ptr->_last_snapshot_index,
-            .file_offset = _sent_snapshot_bytes,
-            .chunk = std::move(chunk),
-            .done = (_sent_snapshot_bytes + chunk_size) == _snapshot_size};
+    static constexpr size_t chunk_size = 32_KiB;
+    const size_t window = std::max<size_t>(
+      1, config::shard_local_cfg().raft_max_inflight_snapshot_chunks());
+    /**
+     * Chunks of the window are dispatched without waiting for the previous
+     * ones to be acknowledged. Requests to the same follower are delivered in
+     * order, the follower rejects any chunk that doesn't continue the stored
+     * prefix of the snapshot so the transfer resumes from the bytes the
+     * follower reports as stored.
+     */
+    std::vector<install_snapshot_request> requests;
+    requests.reserve(window);
+    uint64_t offset = _sent_snapshot_bytes;
+    while (requests.size() < window && offset < _snapshot_size) {
+        auto chunk = co_await read_iobuf_exactly(
+          _snapshot_reader->input(), chunk_size);
+        if (chunk.empty()) {
+            break;
+        }
+        const auto sz = chunk.size_bytes();
+        requests.push_back(install_snapshot_request{
+          .target_node_id = _node_id,
+          .term = _ptr->term(),
+          .group = _ptr->group(),
+          .node_id = _ptr->_self,
+          .last_included_index = _snapshot_index,
+          .file_offset = offset,
+          .chunk = std::move(chunk),
+          .done = (offset + sz) == _snapshot_size});
+        offset += sz;
+    }
 
-          vlog(
-            _ctxlog.trace,
-            "Sending install snapshot request to {}, last included index: {}",
-            _node_id,
-            req.last_included_index);
-          return _ptr->_client_protocol
+    if (requests.empty()) {
+        // snapshot file is shorter than expected, start over
+        co_return co_await close_snapshot_reader();
+    }
+
+    std::vector<ss::future<result<install_snapshot_reply>>> replies;
+    std::vector<uint64_t> expected_bytes_stored;
+    replies.reserve(requests.size());
+    expected_bytes_stored.reserve(requests.size());
+    for (auto& req : requests) {
+        vlog(
+          _ctxlog.trace,
+          "Sending install snapshot request to {}, last included index: {}, "
+          "file offset: {}",
+          _node_id,
+          req.last_included_index,
+          req.file_offset);
+        expected_bytes_stored.push_back(
+          req.file_offset + req.chunk.size_bytes());
+        replies.push_back(
+          _ptr->_client_protocol
             .install_snapshot(
               _node_id.id(),
               std::move(req),
               rpc::client_opts(append_entries_timeout()))
             .then([this](result<install_snapshot_reply> reply) {
-                return handle_install_snapshot_reply(
-                  _ptr->validate_reply_target_node(
-                    "install_snapshot", std::move(reply)));
-            });
-      });
+                return _ptr->validate_reply_target_node(
+                  "install_snapshot", std::move(reply));
+            }));
+    }
+
+    auto results = co_await ss::when_all(replies.begin(), replies.end());
+    // failed futures that are not inspected still have to be consumed
+    auto discard_from = [&results](size_t idx) {
+        for (; idx < results.size(); ++idx) {
+            results[idx].ignore_ready_future();
+        }
+    };
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].failed()) {
+            discard_from(i);
+            co_return co_await close_snapshot_reader();
+        }
+        auto reply = results[i].get0();
+        if (reply.has_error() && reply.error() == rpc::errc::server_busy) {
+            // the follower is out of memory, the transfer resumes after the
+            // chunks it stored once the backoff elapses. Stopping the recovery
+            // would start the snapshot over
+            discard_from(i + 1);
+            _ptr->get_probe().follower_busy();
+            co_await seek_snapshot_reader(
+              i == 0 ? _sent_snapshot_bytes : expected_bytes_stored[i - 1]);
+            co_return co_await ss::sleep_abortable(busy_backoff, _ptr->_as)
+              .handle_exception_type([](const ss::sleep_aborted&) {});
+        }
+        if (
+          reply.has_error() || !reply.value().success
+          || reply.value().term > _ptr->_term) {
+            discard_from(i + 1);
+            co_return co_await handle_install_snapshot_reply(std::move(reply));
+        }
+        if (reply.value().bytes_stored != expected_bytes_stored[i]) {
+            discard_from(i + 1);
+            // follower lost or rejected a chunk, resume where it stopped
+            co_return co_await seek_snapshot_reader(
+              reply.value().bytes_stored);
+        }
+        if (i + 1 == results.size()) {
+            co_return co_await handle_install_snapshot_reply(std::move(reply));
+        }
+    }
 }
 
 ss::future<> recovery_stm::close_snapshot_reader() {
@@ -323,6 +568,29 @@ ss::future<> recovery_stm::close_snapshot_reader() {
     });
 }
 
+ss::future<> recovery_stm::seek_snapshot_reader(uint64_t offset) {
+    vlog(
+      _ctxlog.debug,
+      "Resuming snapshot transfer to {} at offset {}",
+      _node_id,
+      offset);
+    const auto index = _snapshot_index;
+    co_await close_snapshot_reader();
+    if (offset == 0) {
+        co_return;
+    }
+    co_await open_snapshot_reader();
+    if (!_snapshot_reader) {
+        co_return;
+    }
+    // the snapshot was replaced in the meantime, it is sent from the start
+    if (_snapshot_index != index || offset >= _snapshot_size) {
+        co_return;
+    }
+    co_await _snapshot_reader->input().skip(offset);
+    _sent_snapshot_bytes = offset;
+}
+
 ss::future<> recovery_stm::handle_install_snapshot_reply(
   result<install_snapshot_reply> reply) {
     // snapshot delivery failed
@@ -348,8 +616,8 @@ ss::future<> recovery_stm::handle_install_snapshot_reply(
     }
 
     // snapshot received by the follower, continue with recovery
-    (*meta)->match_index = _ptr->_last_snapshot_index;
-    (*meta)->next_index = details::next_offset(_ptr->_last_snapshot_index);
+    (*meta)->match_index = _snapshot_index;
+    (*meta)->next_index = details::next_offset(_snapshot_index);
     return close_snapshot_reader();
 }
 
@@ -371,7 +639,8 @@ ss::future<> recovery_stm::install_snapshot() {
 
 ss::future<> recovery_stm::replicate(
   model::record_batch_reader&& reader,
-  append_entries_request::flush_after_append flush) {
+  append_entries_request::flush_after_append flush,
+  size_t compressible_bytes) {
     // collect metadata for append entries request
     // last persisted offset is last_offset of batch before the first one in the
     // reader
@@ -413,12 +682,23 @@ ss::future<> recovery_stm::replicate(
 
     auto seq = _ptr->next_follower_sequence(_node_id);
     _ptr->update_suppress_heartbeats(_node_id, seq, heartbeats_suppressed::yes);
-    return dispatch_append_entries(std::move(r))
+    return dispatch_append_entries(std::move(r), compressible_bytes)
       .finally([this, seq] {
           _ptr->update_suppress_heartbeats(
             _node_id, seq, heartbeats_suppressed::no);
       })
       .then([this, seq, dirty_offset = lstats.dirty_offset](auto r) {
+          if (!r && r.error() == rpc::errc::server_busy) {
+              // the follower is out of memory, the recovery resumes with the
+              // next heartbeat instead of retrying right away
+              vlog(
+                _ctxlog.debug,
+                "recovery_stm: follower {} is busy, backing off",
+                _node_id);
+              _ptr->get_probe().follower_busy();
+              _stop_requested = true;
+              return;
+          }
           if (!r) {
               vlog(
                 _ctxlog.error,
@@ -471,12 +751,16 @@ clock_type::time_point recovery_stm::append_entries_timeout() {
 }
 
 ss::future<result<append_entries_reply>>
-recovery_stm::dispatch_append_entries(append_entries_request&& r) {
+recovery_stm::dispatch_append_entries(
+  append_entries_request&& r, size_t compressible_bytes) {
     _ptr->_probe.recovery_append_request();
 
+    auto opts = _ptr->append_entries_client_opts(
+      _node_id, append_entries_timeout(), compressible_bytes);
+    // keep the recovery off the connection of the replication traffic
+    opts.conn_class = rpc::connection_class::bulk;
     return _ptr->_client_protocol
-      .append_entries(
-        _node_id.id(), std::move(r), rpc::client_opts(append_entries_timeout()))
+      .append_entries(_node_id.id(), std::move(r), std::move(opts))
       .then([this](result<append_entries_reply> reply) {
           return _ptr->validate_reply_target_node(
             "append_entries_recovery", std::move(reply));
@@ -15,10 +15,23 @@
 #include "outcome.h"
 #include "raft/logger.h"
 #include "storage/snapshot.h"
+#include "units.h"
+
+#include <seastar/core/semaphore.hh>
+
+#include <chrono>
 
 namespace raft {
 
 class recovery_stm {
+    static constexpr size_t recovery_read_max_bytes = 256_KiB;
+    static constexpr uint32_t recovery_read_ahead = 16;
+    /// pause of the snapshot transfer to a follower that is out of memory
+    static constexpr std::chrono::milliseconds busy_backoff{100};
+    /// minimum number of committed entries the follower is missing for its
+    /// recovery to be delegated to another follower
+    static constexpr int64_t delegation_min_lag = 10000;
+
 public:
     recovery_stm(consensus*, vnode, scheduling_config);
     ss::future<> apply();
@@ -28,18 +41,35 @@ private:
     ss::future<> do_recover(ss::io_priority_class);
     ss::future<> read_range_for_recovery(
       model::offset, model::offset, model::offset, ss::io_priority_class, bool);
+    ss::future<> do_read_range_for_recovery(
+      model::offset,
+      model::offset,
+      model::offset,
+      ss::io_priority_class,
+      bool,
+      std::optional<ss::semaphore_units<>>);
     ss::future<> replicate(
-      model::record_batch_reader&&, append_entries_request::flush_after_append);
-    ss::future<result<append_entries_reply>>
-    dispatch_append_entries(append_entries_request&&);
+      model::record_batch_reader&&,
+      append_entries_request::flush_after_append,
+      size_t compressible_bytes);
+    ss::future<result<append_entries_reply>> dispatch_append_entries(
+      append_entries_request&&, size_t compressible_bytes);
     std::optional<follower_index_metadata*> get_follower_meta();
     clock_type::time_point append_entries_timeout();
 
+    /// \brief picks the replica that recovers the committed entries of the
+    /// follower and the last offset it recovers, std::nullopt if the leader
+    /// recovers the follower itself
+    std::optional<std::pair<vnode, model::offset>>
+    pick_recovery_source(const follower_index_metadata&) const;
+    ss::future<> delegate_recovery(vnode, model::offset, model::offset);
+
     ss::future<> install_snapshot();
     ss::future<> send_install_snapshot_request();
     ss::future<> handle_install_snapshot_reply(result<install_snapshot_reply>);
     ss::future<> open_snapshot_reader();
     ss::future<> close_snapshot_reader();
+    ss::future<> seek_snapshot_reader(uint64_t);
     bool state_changed();
     bool is_recovery_finished();
     append_entries_request::flush_after_append
@@ -54,10 +84,13 @@ private:
     ctx_log _ctxlog;
     // tracking follower snapshot delivery
     std::unique_ptr<storage::snapshot_reader> _snapshot_reader;
+    model::offset _snapshot_index;
     size_t _sent_snapshot_bytes = 0;
     size_t _snapshot_size = 0;
     // needed to early exit. (node down)
     bool _stop_requested = false;
+    // the rest of the recovery is served by the leader
+    bool _delegation_failed = false;
 };
 
 } // namespace raft
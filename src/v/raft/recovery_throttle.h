@@ -16,11 +16,17 @@
 #include <seastar/core/timer.hh>
 #include <seastar/util/later.hh>
 
+#include <algorithm>
+
 namespace raft {
 
 /*
  * Token bucket-based raft recovery throttling.
  *
+ * The throttle also bounds the number of recovery reads that the shard
+ * serves at the same time. The data read for a follower is kept in memory
+ * until it is replicated, the units are held for that whole time.
+ *
  * Improvements
  *
  *  - cross-core bandwidth sharing
@@ -35,9 +41,13 @@ class recovery_throttle {
     static constexpr std::chrono::milliseconds refresh_interval{50};
 
 public:
-    explicit recovery_throttle(size_t rate)
+    static constexpr size_t default_max_concurrent_reads = 8;
+
+    explicit recovery_throttle(
+      size_t rate, size_t max_concurrent_reads = default_max_concurrent_reads)
       : _rate(rate)
       , _sem{_rate}
+      , _reads(std::max<size_t>(max_concurrent_reads, 1))
       , _last_refresh(clock_type::now())
       , _refresh_timer([this] { handle_refresh(); }) {}
 
@@ -63,9 +73,15 @@ public:
         return _sem.wait(size);
     }
 
+    /// Units of the shard budget of concurrent recovery reads
+    ss::future<ss::semaphore_units<>> read_units() {
+        return ss::get_units(_reads, 1);
+    }
+
     ss::future<> stop() {
         _refresh_timer.cancel();
         _sem.broken();
+        _reads.broken();
         return ss::now();
     }
 
@@ -110,6 +126,7 @@ private:
 
     size_t _rate;
     ss::semaphore _sem;
+    ss::semaphore _reads;
     clock_type::time_point _last_refresh;
     ss::timer<> _refresh_timer;
 };
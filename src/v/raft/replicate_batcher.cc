@@ -9,6 +9,7 @@
 
 #include "raft/replicate_batcher.h"
 
+#include "config/configuration.h"
 #include "model/fundamental.h"
 #include "model/record.h"
 #include "model/record_batch_reader.h"
@@ -35,6 +36,15 @@ replicate_batcher::replicate_batcher(consensus* ptr, size_t cache_size)
   , _max_batch_size_sem(cache_size)
   , _max_batch_size(cache_size) {}
 
+void replicate_batcher::set_max_batch_size(size_t size) {
+    if (size > _max_batch_size) {
+        _max_batch_size_sem.signal(size - _max_batch_size);
+    } else {
+        _max_batch_size_sem.consume(_max_batch_size - size);
+    }
+    _max_batch_size = size;
+}
+
 replicate_stages replicate_batcher::replicate(
   std::optional<model::term_id> expected_term, model::record_batch_reader&& r) {
     ss::promise<> enqueued;
@@ -51,7 +61,10 @@ replicate_stages replicate_batcher::replicate(
                    enqueued.set_value();
                    return _lock.get_units()
                      .then([this](ss::semaphore_units<> u) {
-                         return flush(std::move(u));
+                         return maybe_linger().then(
+                           [this, u = std::move(u)]() mutable {
+                               return flush(std::move(u));
+                           });
                      })
                      .then([i = f.get()] { return i->_promise.get_future(); });
                })
@@ -60,7 +73,59 @@ replicate_stages replicate_batcher::replicate(
     return replicate_stages(std::move(enqueued_f), std::move(f));
 }
 
+replicate_batcher_stats& replicate_batcher_stats::local() {
+    static thread_local replicate_batcher_stats stats;
+    return stats;
+}
+
+void replicate_batcher::record_arrival() {
+    auto now = linger_clock_type::now();
+    _arrival_interval += (now - _last_arrival - _arrival_interval) / 8;
+    _last_arrival = now;
+}
+
+void replicate_batcher::record_flush_latency(
+  linger_clock_type::duration latency) {
+    _flush_latency += (latency - _flush_latency) / 8;
+}
+
+bool replicate_batcher::is_cache_full() const {
+    return _max_batch_size_sem.available_units() <= 0
+           || _max_batch_size_sem.waiters() > 0;
+}
+
+replicate_batcher::linger_clock_type::duration
+replicate_batcher::linger_window() const {
+    linger_clock_type::duration max_linger
+      = config::shard_local_cfg().raft_replicate_batcher_max_linger_ms();
+    // more than one request is expected while the batch is replicated
+    if (max_linger.count() <= 0 || _arrival_interval >= _flush_latency) {
+        return linger_clock_type::duration::zero();
+    }
+    return std::min(max_linger, _flush_latency / 2);
+}
+
+ss::future<> replicate_batcher::maybe_linger() {
+    auto window = linger_window();
+    if (
+      window == linger_clock_type::duration::zero() || _item_cache.empty()
+      || is_cache_full()) {
+        return ss::now();
+    }
+    auto start = linger_clock_type::now();
+    return _cache_full.wait(start + window, [this] { return is_cache_full(); })
+      .handle_exception_type([](const ss::condition_variable_timed_out&) {})
+      .handle_exception_type([](const ss::broken_condition_variable&) {})
+      .finally([start] {
+          replicate_batcher_stats::local().linger.record(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+              linger_clock_type::now() - start)
+              .count());
+      });
+}
+
 ss::future<> replicate_batcher::stop() {
+    _cache_full.broken();
     // we keep a lock here to make sure that all inflight requests have finished
     // already
     return _lock.with([this]() {
@@ -109,9 +174,16 @@ replicate_batcher::do_cache_with_backpressure(
      * them to be able to continue.
      */
 
-    return ss::get_units(_max_batch_size_sem, std::min(bytes, _max_batch_size))
-      .then([this, expected_term, batches = std::move(batches)](
-              ss::semaphore_units<> u) mutable {
+    record_arrival();
+    auto units = ss::get_units(
+      _max_batch_size_sem, std::min(bytes, _max_batch_size));
+    if (is_cache_full()) {
+        // stop lingering, no more requests fit in the cache
+        _cache_full.signal();
+    }
+    return std::move(units).then(
+      [this, expected_term, batches = std::move(batches)](
+        ss::semaphore_units<> u) mutable {
           size_t record_count = 0;
           auto i = ss::make_lw_shared<item>();
           for (auto& b : batches) {
@@ -126,6 +198,9 @@ replicate_batcher::do_cache_with_backpressure(
           i->record_count = record_count;
           i->units = std::move(u);
           _item_cache.emplace_back(i);
+          if (is_cache_full()) {
+              _cache_full.signal();
+          }
           return i;
       });
 }
@@ -165,13 +240,23 @@ ss::future<> replicate_batcher::flush(ss::semaphore_units<> u) {
                 ss::circular_buffer<model::record_batch> data;
                 std::vector<item_ptr> notifications;
                 ss::semaphore_units<> item_memory_units(_max_batch_size_sem, 0);
+                size_t batch_size = 0;
+                // size of the batches that can benefit from compression
+                size_t compressible_bytes = 0;
+                const auto now = probe::stage_clock_type::now();
                 for (auto& n : item_cache) {
+                    _ptr->_probe.record_stage_latency(
+                      replicate_stage::batcher_queue, now - n->enqueued_at);
                     item_memory_units.adopt(std::move(n->units));
                     if (
                       !n->expected_term.has_value()
                       || n->expected_term.value() == term) {
                         for (auto& b : n->data) {
                             b.set_term(term);
+                            batch_size += b.size_bytes();
+                            if (!b.compressed()) {
+                                compressible_bytes += b.size_bytes();
+                            }
                             data.push_back(std::move(b));
                         }
                         notifications.push_back(std::move(n));
@@ -183,6 +268,7 @@ ss::future<> replicate_batcher::flush(ss::semaphore_units<> u) {
                 if (notifications.empty()) {
                     return ss::now();
                 }
+                replicate_batcher_stats::local().batch_size.record(batch_size);
 
                 auto seqs = _ptr->next_followers_request_seq();
                 append_entries_request req(
@@ -199,7 +285,8 @@ ss::future<> replicate_batcher::flush(ss::semaphore_units<> u) {
                   std::move(notifications),
                   std::move(req),
                   std::move(units),
-                  std::move(seqs));
+                  std::move(seqs),
+                  compressible_bytes);
             });
       });
 }
@@ -236,13 +323,19 @@ ss::future<> replicate_batcher::do_flush(
   std::vector<replicate_batcher::item_ptr>&& notifications,
   append_entries_request&& req,
   std::vector<ss::semaphore_units<>> u,
-  absl::flat_hash_map<vnode, follower_req_seq> seqs) {
+  absl::flat_hash_map<vnode, follower_req_seq> seqs,
+  size_t compressible_bytes) {
     _ptr->_probe.replicate_batch_flushed();
+    auto start = linger_clock_type::now();
     auto stm = ss::make_lw_shared<replicate_entries_stm>(
-      _ptr, std::move(req), std::move(seqs));
+      _ptr, std::move(req), std::move(seqs), compressible_bytes);
     return stm->apply(std::move(u))
-      .then_wrapped([this, stm, notifications = std::move(notifications)](
+      .then_wrapped([this,
+                     stm,
+                     start,
+                     notifications = std::move(notifications)](
                       ss::future<result<replicate_result>> fut) mutable {
+          record_flush_latency(linger_clock_type::now() - start);
           try {
               auto ret = fut.get0();
               propagate_result(ret, notifications);
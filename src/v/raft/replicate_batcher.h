@@ -13,16 +13,41 @@
 
 #include "model/record_batch_reader.h"
 #include "outcome.h"
+#include "raft/probe.h"
 #include "raft/types.h"
 #include "units.h"
+#include "utils/hdr_hist.h"
 #include "utils/mutex.h"
 
+#include <seastar/core/condition-variable.hh>
 #include <seastar/core/semaphore.hh>
 
 #include <absl/container/flat_hash_map.h>
 namespace raft {
 class consensus;
 
+/// Shard wide histograms of the replicate batchers, exported by the
+/// group_manager to avoid per partition histograms
+struct replicate_batcher_stats {
+    /// bytes of the append entries requests created by the batchers
+    hdr_hist batch_size;
+    /// microseconds the batchers held the writes before flushing
+    hdr_hist linger;
+
+    static replicate_batcher_stats& local();
+};
+
+/**
+ * Accumulates the replicate requests until the previous batch is dispatched
+ * and flushes them as a single append entries request.
+ *
+ * In the adaptive linger mode (raft_replicate_batcher_max_linger_ms > 0) the
+ * batcher tracks the moving averages of the requests inter arrival time and
+ * of the replication latency. When requests arrive faster than a batch
+ * is replicated the flush is held for half of the replication latency (up to
+ * the max linger) or until the cache is full so that more requests are merged
+ * into the same batch. At low load no linger is applied.
+ */
 class replicate_batcher {
 public:
     struct item {
@@ -35,6 +60,8 @@ public:
          * processing the request.
          */
         ss::semaphore_units<> units;
+        probe::stage_clock_type::time_point enqueued_at
+          = probe::stage_clock_type::now();
     };
     using item_ptr = ss::lw_shared_ptr<item>;
     explicit replicate_batcher(consensus* ptr, size_t cache_size);
@@ -51,12 +78,17 @@ public:
     ss::future<> flush(ss::semaphore_units<> u);
     ss::future<> stop();
 
+    /// \brief changes the bytes cached before a flush. the bytes already
+    /// cached above a lower size are flushed before more are cached
+    void set_max_batch_size(size_t);
+
     // it will lock on behalf of caller to append entries to leader log.
     ss::future<> do_flush(
       std::vector<item_ptr>&&,
       append_entries_request&&,
       std::vector<ss::semaphore_units<>>,
-      absl::flat_hash_map<vnode, follower_req_seq>);
+      absl::flat_hash_map<vnode, follower_req_seq>,
+      size_t compressible_bytes = 0);
 
 private:
     ss::future<item_ptr>
@@ -66,11 +98,25 @@ private:
       ss::circular_buffer<model::record_batch>,
       size_t);
 
+    using linger_clock_type = ss::steady_clock_type;
+    /// holds the flush for a load dependent window, see class comment
+    ss::future<> maybe_linger();
+    linger_clock_type::duration linger_window() const;
+    bool is_cache_full() const;
+    void record_arrival();
+    void record_flush_latency(linger_clock_type::duration);
+
     consensus* _ptr;
     ss::semaphore _max_batch_size_sem;
     size_t _max_batch_size;
     std::vector<item_ptr> _item_cache;
     mutex _lock;
+
+    linger_clock_type::time_point _last_arrival = linger_clock_type::now();
+    // moving averages, start with an idle batcher
+    linger_clock_type::duration _arrival_interval = std::chrono::seconds(1);
+    linger_clock_type::duration _flush_latency{0};
+    ss::condition_variable _cache_full;
 };
 
 } // namespace raft
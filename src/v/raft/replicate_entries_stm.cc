@@ -9,6 +9,7 @@
 
 #include "raft/replicate_entries_stm.h"
 
+#include "config/configuration.h"
 #include "likely.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
@@ -20,6 +21,7 @@
 #include "raft/logger.h"
 #include "raft/raftgen_service.h"
 #include "raft/types.h"
+#include "rpc/errc.h"
 #include "rpc/types.h"
 
 #include <chrono>
@@ -78,19 +80,68 @@ clock_type::time_point replicate_entries_stm::append_entries_timeout() {
     return raft::clock_type::now() + _ptr->_replicate_append_timeout;
 }
 
+ss::future<bool> replicate_entries_stm::wait_for_append_window(vnode n) {
+    auto it = _ptr->_fstats.find(n);
+    if (it == _ptr->_fstats.end()) {
+        return ss::make_ready_future<bool>(true);
+    }
+    auto window = std::max<size_t>(
+      1,
+      config::shard_local_cfg().raft_max_inflight_follower_append_requests());
+    if (it->second.busy_until > clock_type::now()) {
+        window = 1;
+    }
+    if (it->second.inflight_append_requests < window) {
+        return ss::make_ready_future<bool>(true);
+    }
+    _ptr->get_probe().append_window_full();
+    return it->second.inflight_append_finished
+      .wait(
+        append_entries_timeout(),
+        [this, n, window] {
+            auto it = _ptr->_fstats.find(n);
+            return it == _ptr->_fstats.end()
+                   || it->second.inflight_append_requests < window;
+        })
+      .then([] { return true; })
+      .handle_exception([this, n](const std::exception_ptr& e) {
+          vlog(
+            _ctxlog.debug,
+            "Append entries window of {} didn't open - {}",
+            n,
+            e);
+          return false;
+      });
+}
+
+void replicate_entries_stm::mark_busy(vnode n) {
+    _ptr->get_probe().follower_busy();
+    if (auto it = _ptr->_fstats.find(n); it != _ptr->_fstats.end()) {
+        it->second.busy_until = clock_type::now() + busy_backoff;
+    }
+}
+
 ss::future<result<append_entries_reply>>
 replicate_entries_stm::send_append_entries_request(
   vnode n, append_entries_request req) {
     _ptr->update_node_append_timestamp(n);
+    if (auto it = _ptr->_fstats.find(n); it != _ptr->_fstats.end()) {
+        ++it->second.inflight_append_requests;
+    }
     vlog(_ctxlog.trace, "Sending append entries request {} to {}", req.meta, n);
 
     req.target_node_id = n;
+    const auto start = probe::stage_clock_type::now();
     auto f = _ptr->_client_protocol
                .append_entries(
                  n.id(),
                  std::move(req),
-                 rpc::client_opts(append_entries_timeout()))
-               .then([this](result<append_entries_reply> reply) {
+                 _ptr->append_entries_client_opts(
+                   n, append_entries_timeout(), _compressible_bytes))
+               .then([this, n](result<append_entries_reply> reply) {
+                   if (!reply && reply.error() == rpc::errc::server_busy) {
+                       mark_busy(n);
+                   }
                    return _ptr->validate_reply_target_node(
                      "append_entries_replicate", std::move(reply));
                });
@@ -101,9 +152,16 @@ replicate_entries_stm::send_append_entries_request(
           return result<append_entries_reply>(
             errc::append_entries_dispatch_error);
       })
-      .finally([this, n] {
+      .finally([this, n, start] {
+          _ptr->_probe.record_stage_latency(
+            replicate_stage::follower_rpc,
+            probe::stage_clock_type::now() - start);
           _ptr->update_suppress_heartbeats(
             n, _followers_seq[n], heartbeats_suppressed::no);
+          if (auto it = _ptr->_fstats.find(n); it != _ptr->_fstats.end()) {
+              --it->second.inflight_append_requests;
+              it->second.inflight_append_finished.signal();
+          }
       });
 }
 
@@ -140,10 +198,17 @@ replicate_entries_stm::dispatch_single_retry(vnode id) {
     if (id == _ptr->_self) {
         return flush_log();
     } else {
-        return share_request().then(
-          [this, id](append_entries_request r) mutable {
-              return send_append_entries_request(id, std::move(r));
-          });
+        return wait_for_append_window(id).then([this, id](bool has_room) {
+            if (!has_room) {
+                _dispatch_sem.signal();
+                return ss::make_ready_future<result<append_entries_reply>>(
+                  errc::append_entries_dispatch_error);
+            }
+            return share_request().then(
+              [this, id](append_entries_request r) mutable {
+                  return send_append_entries_request(id, std::move(r));
+              });
+        });
     }
 }
 
@@ -156,7 +221,11 @@ replicate_entries_stm::append_to_self() {
           return _ptr->disk_append(
             std::move(req.batches), consensus::update_last_quorum_index::yes);
       })
-      .then([](storage::append_result res) {
+      .then([this, start = probe::stage_clock_type::now()](
+              storage::append_result res) {
+          _ptr->_probe.record_stage_latency(
+            replicate_stage::leader_append,
+            probe::stage_clock_type::now() - start);
           return result<storage::append_result>(std::move(res));
       })
       .handle_exception([this](const std::exception_ptr& e) {
@@ -254,7 +323,13 @@ replicate_entries_stm::apply(std::vector<ss::semaphore_units<>> u) {
                      || _ptr->term() > appended_term;
           };
           return _ptr->_commit_index_updated.wait(stop_cond).then(
-            [this, appended_offset, appended_term] {
+            [this,
+             appended_offset,
+             appended_term,
+             start = probe::stage_clock_type::now()] {
+                _ptr->_probe.record_stage_latency(
+                  replicate_stage::commit_index_update,
+                  probe::stage_clock_type::now() - start);
                 return process_result(appended_offset, appended_term);
             });
       });
@@ -294,10 +369,12 @@ ss::future<> replicate_entries_stm::wait() { return _req_bg.close(); }
 replicate_entries_stm::replicate_entries_stm(
   consensus* p,
   append_entries_request r,
-  absl::flat_hash_map<vnode, follower_req_seq> seqs)
+  absl::flat_hash_map<vnode, follower_req_seq> seqs,
+  size_t compressible_bytes)
   : _ptr(p)
   , _req(std::move(r))
   , _followers_seq(std::move(seqs))
+  , _compressible_bytes(compressible_bytes)
   , _share_sem(1)
   , _ctxlog(_ptr->_ctxlog) {}
 
@@ -26,6 +26,8 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <chrono>
+
 namespace raft {
 
 /// A single-shot class. Utility method with state
@@ -78,13 +80,21 @@ namespace raft {
 ///                     |                         +
 ///                     v               Wait for (1) or (2)
 ///         Store entry offset & term
+///
+///   Requests are pipelined, the next replicate_entries_stm may dispatch its
+///   request before the follower replied to the previous ones. The number of
+///   requests in flight per follower is limited by the
+///   raft_max_inflight_follower_append_requests window, when the window is
+///   full the dispatch waits for one of the replies. Reordered replies and
+///   failures are handled by the follower_index_metadata sequences.
 
 class replicate_entries_stm {
 public:
     replicate_entries_stm(
       consensus*,
       append_entries_request,
-      absl::flat_hash_map<vnode, follower_req_seq>);
+      absl::flat_hash_map<vnode, follower_req_seq>,
+      size_t compressible_bytes = 0);
     ~replicate_entries_stm();
 
     /// caller have to pass semaphore units, the apply call will do the
@@ -96,11 +106,18 @@ public:
     ss::future<> wait();
 
 private:
+    static constexpr std::chrono::seconds busy_backoff{1};
+
     ss::future<append_entries_request> share_request();
 
     ss::future<> dispatch_one(vnode);
     ss::future<result<append_entries_reply>> dispatch_single_retry(vnode);
     ss::future<result<append_entries_reply>> flush_log();
+    /// waits until the follower has room in its window of in flight requests
+    /// \return false if the window didn't open before the append timeout
+    ss::future<bool> wait_for_append_window(vnode);
+    /// the follower replied busy, its window shrinks for the busy backoff
+    void mark_busy(vnode);
 
     ss::future<result<append_entries_reply>>
       send_append_entries_request(vnode, append_entries_request);
@@ -113,6 +130,8 @@ private:
     /// we keep a copy around until we finish the retries
     append_entries_request _req;
     absl::flat_hash_map<vnode, follower_req_seq> _followers_seq;
+    /// size of the request batches that are not compressed
+    size_t _compressible_bytes;
     ss::semaphore _share_sem;
     ss::semaphore _dispatch_sem{0};
     ss::gate _req_bg;
@@ -24,6 +24,8 @@ ss::future<result<vote_reply>> rpc_client_protocol::vote(
       _self,
       ss::this_shard_id(),
       n,
+      rpc::connection_class::control,
+      0,
       opts.timeout,
       [r = std::move(r),
        opts = std::move(opts)](raftgen_client_protocol client) mutable {
@@ -34,10 +36,15 @@ ss::future<result<vote_reply>> rpc_client_protocol::vote(
 
 ss::future<result<append_entries_reply>> rpc_client_protocol::append_entries(
   model::node_id n, append_entries_request&& r, rpc::client_opts opts) {
+    // the appends of a group are kept in order on a single connection
+    const auto conn_class = opts.conn_class;
+    const auto flow = static_cast<uint64_t>(r.meta.group());
     return _connection_cache.local().with_node_client<raftgen_client_protocol>(
       _self,
       ss::this_shard_id(),
       n,
+      conn_class,
+      flow,
       opts.timeout,
       [r = std::move(r),
        opts = std::move(opts)](raftgen_client_protocol client) mutable {
@@ -52,6 +59,8 @@ ss::future<result<heartbeat_reply>> rpc_client_protocol::heartbeat(
       _self,
       ss::this_shard_id(),
       n,
+      rpc::connection_class::control,
+      0,
       opts.timeout,
       [r = std::move(r),
        opts = std::move(opts)](raftgen_client_protocol client) mutable {
@@ -63,10 +72,13 @@ ss::future<result<heartbeat_reply>> rpc_client_protocol::heartbeat(
 ss::future<result<install_snapshot_reply>>
 rpc_client_protocol::install_snapshot(
   model::node_id n, install_snapshot_request&& r, rpc::client_opts opts) {
+    const auto flow = static_cast<uint64_t>(r.group());
     return _connection_cache.local().with_node_client<raftgen_client_protocol>(
       _self,
       ss::this_shard_id(),
       n,
+      rpc::connection_class::bulk,
+      flow,
       opts.timeout,
       [r = std::move(r),
        opts = std::move(opts)](raftgen_client_protocol client) mutable {
@@ -81,6 +93,8 @@ ss::future<result<timeout_now_reply>> rpc_client_protocol::timeout_now(
       _self,
       ss::this_shard_id(),
       n,
+      rpc::connection_class::control,
+      0,
       opts.timeout,
       [r = std::move(r),
        opts = std::move(opts)](raftgen_client_protocol client) mutable {
@@ -89,4 +103,20 @@ ss::future<result<timeout_now_reply>> rpc_client_protocol::timeout_now(
       });
 }
 
+ss::future<result<recover_range_reply>> rpc_client_protocol::recover_range(
+  model::node_id n, recover_range_request&& r, rpc::client_opts opts) {
+    return _connection_cache.local().with_node_client<raftgen_client_protocol>(
+      _self,
+      ss::this_shard_id(),
+      n,
+      rpc::connection_class::control,
+      0,
+      opts.timeout,
+      [r = std::move(r),
+       opts = std::move(opts)](raftgen_client_protocol client) mutable {
+          return client.recover_range(std::move(r), std::move(opts))
+            .then(&rpc::get_ctx_data<recover_range_reply>);
+      });
+}
+
 } // namespace raft
@@ -46,6 +46,9 @@ public:
     ss::future<result<timeout_now_reply>>
     timeout_now(model::node_id, timeout_now_request&&, rpc::client_opts) final;
 
+    ss::future<result<recover_range_reply>> recover_range(
+      model::node_id, recover_range_request&&, rpc::client_opts) final;
+
 private:
     model::node_id _self;
     ss::sharded<rpc::connection_cache>& _connection_cache;
@@ -116,6 +116,17 @@ public:
               std::move(
                 missing.begin(), missing.end(), std::back_inserter(ret));
               return heartbeat_reply{std::move(ret)};
+          })
+          .then([this,
+                 leader = r.node_id,
+                 quiesced = std::move(r.quiesced_groups)](
+                  heartbeat_reply reply) mutable {
+              return dispatch_quiesced_hbeats(leader, std::move(quiesced))
+                .then([reply = std::move(reply)](
+                        std::vector<group_id> woken) mutable {
+                    reply.woken_groups = std::move(woken);
+                    return std::move(reply);
+                });
           });
     }
 
@@ -170,6 +181,36 @@ public:
         });
     }
 
+    [[gnu::always_inline]] ss::future<recover_range_reply>
+    recover_range(recover_range_request&& r, rpc::streaming_context&) final {
+        return _probe.recover_range().then([this, r = std::move(r)]() mutable {
+            return dispatch_request(
+              std::move(r),
+              &service::make_failed_recover_range_reply,
+              [](recover_range_request&& r, consensus_ptr c) {
+                  return c->recover_range(std::move(r));
+              });
+        });
+    }
+
+    [[gnu::always_inline]] ss::future<transfer_leadership_reply>
+    transfer_leadership(
+      transfer_leadership_request&& r, rpc::streaming_context&) final {
+        return _probe.transfer_leadership().then([this,
+                                                  r = std::move(r)]() mutable {
+            return dispatch_request(
+              std::move(r),
+              &service::make_failed_transfer_leadership_reply,
+              [](transfer_leadership_request&& r, consensus_ptr c) {
+                  return c->transfer_leadership(r.target)
+                    .then([](std::error_code ec) {
+                        return transfer_leadership_reply{
+                          .result = to_raft_errc(ec)};
+                    });
+              });
+        });
+    }
+
 private:
     using consensus_ptr = seastar::lw_shared_ptr<consensus>;
     using hbeats_t = std::vector<append_entries_request>;
@@ -202,6 +243,28 @@ private:
         return ss::make_ready_future<timeout_now_reply>(timeout_now_reply{});
     }
 
+    static ss::future<recover_range_reply> make_failed_recover_range_reply() {
+        return ss::make_ready_future<recover_range_reply>(
+          recover_range_reply{});
+    }
+
+    static ss::future<transfer_leadership_reply>
+    make_failed_transfer_leadership_reply() {
+        return ss::make_ready_future<transfer_leadership_reply>(
+          transfer_leadership_reply{.result = errc::group_not_exists});
+    }
+
+    static errc to_raft_errc(std::error_code ec) {
+        if (!ec) {
+            return errc::success;
+        }
+        if (ec.category() == error_category()) {
+            return static_cast<errc>(ec.value());
+        }
+        // errors of the other categories are not meaningful to the caller
+        return errc::not_leader;
+    }
+
     template<typename Req, typename ErrorFactory, typename Func>
     auto dispatch_request(Req&& req, ErrorFactory&& ef, Func&& f) {
         auto group = req.target_group();
@@ -270,6 +333,51 @@ private:
         return ss::when_all_succeed(futures.begin(), futures.end());
     }
 
+    /// \brief refreshes the leader liveness of the quiesced groups
+    /// \return groups that don't recognize the node as their leader
+    ss::future<std::vector<group_id>> dispatch_quiesced_hbeats(
+      model::node_id leader, std::vector<group_id> groups) {
+        std::vector<group_id> woken;
+        if (groups.empty()) {
+            return ss::make_ready_future<std::vector<group_id>>(
+              std::move(woken));
+        }
+        absl::flat_hash_map<ss::shard_id, std::vector<group_id>> by_shard;
+        for (auto g : groups) {
+            if (unlikely(!_shard_table.contains(g))) {
+                woken.push_back(g);
+                continue;
+            }
+            by_shard[_shard_table.shard_for(g)].push_back(g);
+        }
+        std::vector<ss::future<std::vector<group_id>>> futures;
+        futures.reserve(by_shard.size());
+        for (auto& [shard, gs] : by_shard) {
+            futures.push_back(_group_manager.invoke_on(
+              shard,
+              get_smp_service_group(),
+              [leader, gs = std::move(gs)](ConsensusManager& m) {
+                  std::vector<group_id> woken;
+                  for (auto g : gs) {
+                      auto c = m.consensus_for(g);
+                      if (!c || !c->process_quiesced_heartbeat(leader)) {
+                          woken.push_back(g);
+                      }
+                  }
+                  return woken;
+              }));
+        }
+        return ss::when_all_succeed(futures.begin(), futures.end())
+          .then([woken = std::move(woken)](
+                  std::vector<std::vector<group_id>> parts) mutable {
+              for (auto& part : parts) {
+                  std::move(
+                    part.begin(), part.end(), std::back_inserter(woken));
+              }
+              return std::move(woken);
+          });
+    }
+
     shard_groupped_hbeat_requests group_hbeats_by_shard(hbeats_t reqs) {
         shard_groupped_hbeat_requests ret;
 
@@ -36,6 +36,11 @@ ss::future<> state_machine::start() {
 
 void state_machine::set_next(model::offset offset) { _next = offset; }
 
+void state_machine::set_applied(model::offset offset) {
+    _next = offset + model::offset(1);
+    _waiters.notify(offset);
+}
+
 ss::future<> state_machine::stop() {
     _waiters.stop();
     _as.request_abort();
@@ -101,6 +101,12 @@ public:
 
 protected:
     void set_next(model::offset offset);
+    /**
+     * Marks all the entries up to and including the offset as applied. Used by
+     * the state machines restoring their state from a snapshot, the batches
+     * are applied starting from the next offset.
+     */
+    void set_applied(model::offset offset);
     ss::gate _gate;
 
 private:
@@ -764,6 +764,33 @@ FIXTURE_TEST(test_linarizable_barrier_single_node, raft_test_fixture) {
     }
 };
 
+FIXTURE_TEST(test_linarizable_barrier_with_leader_lease, raft_test_fixture) {
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg().get("raft_enable_leader_leases").set_value(
+          true);
+    }).get();
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+
+    bool success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+
+    auto leader_raft = get_leader_raft(gr);
+    wait_for(
+      10s,
+      [&leader_raft] { return leader_raft->has_leader_lease(); },
+      "leader holds the lease");
+    auto r = leader_raft->linearizable_barrier().get();
+    BOOST_REQUIRE(r);
+    BOOST_REQUIRE_EQUAL(r.value(), leader_raft->committed_offset());
+
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg().get("raft_enable_leader_leases").set_value(
+          false);
+    }).get();
+    BOOST_REQUIRE(!leader_raft->has_leader_lease());
+};
+
 FIXTURE_TEST(test_big_batches_replication, raft_test_fixture) {
     raft_group gr = raft_group(raft::group_id(0), 1);
     gr.enable_all();
@@ -867,3 +894,51 @@ FIXTURE_TEST(test_leader_ack_write_ordering, request_ordering_test_fixture) {
 
     validate_batch_ordering(20, gr);
 }
+
+struct consensus_flush_fixture : raft_test_fixture {
+    static bool has_pending_flushes(raft::consensus& c) {
+        return c._has_pending_flushes;
+    }
+
+    static ss::future<> flush_log(raft::consensus& c) { return c.flush_log(); }
+};
+
+FIXTURE_TEST(
+  test_append_racing_with_flush_keeps_pending_flush,
+  consensus_flush_fixture) {
+    raft_group gr = raft_group(raft::group_id(0), 1);
+    gr.enable_all();
+    auto leader_raft = get_leader_raft(gr);
+    auto& log = gr.get_member(model::node_id(0)).log;
+
+    for (int i = 0; i < 10; ++i) {
+        auto res = leader_raft
+                     ->replicate(
+                       random_batches_reader(5),
+                       raft::replicate_options(
+                         raft::consistency_level::leader_ack))
+                     .get0();
+        BOOST_REQUIRE(res);
+        BOOST_REQUIRE(has_pending_flushes(*leader_raft));
+
+        // append while the flush is in flight, the flush may not cover the
+        // appended batches
+        auto flushed = flush_log(*leader_raft);
+        auto appended = leader_raft->replicate(
+          random_batches_reader(5),
+          raft::replicate_options(raft::consistency_level::leader_ack));
+        flushed.get();
+        BOOST_REQUIRE(appended.get0());
+
+        // unflushed appends must never be reported as flushed
+        auto lstats = log->offsets();
+        BOOST_REQUIRE(
+          has_pending_flushes(*leader_raft)
+          || lstats.committed_offset >= lstats.dirty_offset);
+
+        flush_log(*leader_raft).get();
+        lstats = log->offsets();
+        BOOST_REQUIRE_EQUAL(lstats.committed_offset, lstats.dirty_offset);
+        BOOST_REQUIRE(!has_pending_flushes(*leader_raft));
+    }
+};
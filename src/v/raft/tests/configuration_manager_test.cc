@@ -15,6 +15,7 @@
 #include "raft/logger.h"
 #include "raft/types.h"
 #include "random/generators.h"
+#include "reflection/adl.h"
 #include "storage/api.h"
 #include "storage/kvstore.h"
 #include "storage/log_manager.h"
@@ -279,3 +280,65 @@ FIXTURE_TEST(test_assigning_initial_revision, config_manager_fixture) {
     BOOST_REQUIRE(
       mgr.get_latest().contains(raft::vnode(model::node_id(1), new_revision)));
 }
+
+FIXTURE_TEST(test_migrating_configurations_map, config_manager_fixture) {
+    const auto ks = storage::kvstore::key_space::consensus;
+    auto map_key = raft::details::serialize_group_key(
+      raft::group_id(1), raft::metadata_key::config_map);
+    auto first = random_configuration();
+    auto second = random_configuration();
+    // single map of configurations stored by older versions
+    iobuf buf;
+    reflection::adl<uint64_t>{}.to(buf, 2);
+    reflection::serialize(
+      buf, model::offset(10), first, model::offset(20), second);
+    _storage.kvs().put(ks, map_key, std::move(buf)).get0();
+
+    _cfg_mgr.start(false, model::revision_id(0)).get0();
+    BOOST_REQUIRE_EQUAL(_cfg_mgr.get(model::offset(10)), first);
+    BOOST_REQUIRE_EQUAL(_cfg_mgr.get(model::offset(25)), second);
+    BOOST_REQUIRE_EQUAL(_cfg_mgr.get_latest_index()(), 1);
+    BOOST_REQUIRE(!_storage.kvs().get(ks, map_key).has_value());
+
+    raft::configuration_manager recovered(
+      raft::group_configuration({}, model::revision_id(0)),
+      raft::group_id(1),
+      _storage,
+      _logger);
+    recovered.start(false, model::revision_id(0)).get0();
+    BOOST_REQUIRE_EQUAL(recovered.get(model::offset(10)), first);
+    BOOST_REQUIRE_EQUAL(recovered.get(model::offset(25)), second);
+    BOOST_REQUIRE_EQUAL(recovered.get_latest_index()(), 1);
+}
+
+FIXTURE_TEST(test_truncations_remove_stored_entries, config_manager_fixture) {
+    const auto ks = storage::kvstore::key_space::consensus;
+    auto entry_key = [](int64_t o) {
+        return raft::details::serialize_group_key(
+          raft::group_id(1),
+          raft::metadata_key::config_entry,
+          model::offset(o));
+    };
+    auto configurations = test_configurations();
+    BOOST_REQUIRE(_storage.kvs().get(ks, entry_key(0)).has_value());
+    BOOST_REQUIRE(_storage.kvs().get(ks, entry_key(1254)).has_value());
+
+    _cfg_mgr.prefix_truncate(model::offset(33)).get0();
+    _cfg_mgr.truncate(model::offset(60)).get0();
+    BOOST_REQUIRE(!_storage.kvs().get(ks, entry_key(0)).has_value());
+    BOOST_REQUIRE(!_storage.kvs().get(ks, entry_key(20)).has_value());
+    BOOST_REQUIRE(_storage.kvs().get(ks, entry_key(33)).has_value());
+    BOOST_REQUIRE(_storage.kvs().get(ks, entry_key(34)).has_value());
+    BOOST_REQUIRE(!_storage.kvs().get(ks, entry_key(60)).has_value());
+    BOOST_REQUIRE(!_storage.kvs().get(ks, entry_key(1254)).has_value());
+
+    raft::configuration_manager recovered(
+      raft::group_configuration({}, model::revision_id(0)),
+      raft::group_id(1),
+      _storage,
+      _logger);
+    recovered.start(false, model::revision_id(0)).get0();
+    BOOST_REQUIRE_EQUAL(recovered.get(model::offset(33)), configurations[2]);
+    BOOST_REQUIRE_EQUAL(recovered.get_latest(), configurations[3]);
+    BOOST_REQUIRE_EQUAL(recovered.get_latest_index()(), 4);
+}
@@ -0,0 +1,103 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/heartbeat_manager.h"
+#include "seastarx.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+using hbeat_manager = raft::heartbeat_manager;
+
+static hbeat_manager::node_heartbeat make_node_heartbeat(
+  model::node_id target,
+  std::vector<raft::group_id> groups,
+  std::vector<raft::group_id> quiesced) {
+    raft::vnode self(model::node_id(0), model::revision_id(0));
+    raft::vnode follower(target, model::revision_id(0));
+    raft::heartbeat_request req{
+      .node_id = self.id(), .target_node_id = target};
+    absl::flat_hash_map<raft::group_id, hbeat_manager::follower_request_meta>
+      meta_map;
+    for (auto g : groups) {
+        req.heartbeats.push_back(raft::heartbeat_metadata{
+          .meta = raft::protocol_metadata{.group = g},
+          .node_id = self,
+          .target_node_id = follower});
+        meta_map.emplace(
+          g,
+          hbeat_manager::follower_request_meta{
+            raft::follower_req_seq(0), model::offset(0), follower});
+    }
+    hbeat_manager::node_heartbeat hb(
+      target, std::move(req), std::move(meta_map));
+    for (auto g : quiesced) {
+        hb.request.quiesced_groups.push_back(g);
+        hb.quiesced_map.emplace(g, follower);
+    }
+    return hb;
+}
+
+SEASTAR_THREAD_TEST_CASE(aggregate_merges_heartbeats_by_target) {
+    std::vector<std::vector<hbeat_manager::node_heartbeat>> shards(2);
+    shards[0].push_back(make_node_heartbeat(
+      model::node_id(1), {raft::group_id(1), raft::group_id(2)}, {}));
+    shards[0].push_back(
+      make_node_heartbeat(model::node_id(2), {raft::group_id(1)}, {}));
+    shards[1].push_back(make_node_heartbeat(
+      model::node_id(1), {raft::group_id(3)}, {raft::group_id(4)}));
+
+    auto reqs = hbeat_manager::aggregate(std::move(shards));
+    BOOST_REQUIRE_EQUAL(reqs.size(), 2);
+
+    auto& to_1 = reqs[0];
+    BOOST_REQUIRE_EQUAL(to_1.target, model::node_id(1));
+    BOOST_REQUIRE_EQUAL(to_1.request.target_node_id, model::node_id(1));
+    BOOST_REQUIRE_EQUAL(to_1.request.heartbeats.size(), 3);
+    BOOST_REQUIRE_EQUAL(to_1.request.quiesced_groups.size(), 1);
+    BOOST_REQUIRE_EQUAL(to_1.shards.size(), 2);
+    BOOST_REQUIRE_EQUAL(to_1.shards[0].shard, 0);
+    BOOST_REQUIRE_EQUAL(to_1.shards[0].meta_map.size(), 2);
+    BOOST_REQUIRE_EQUAL(to_1.shards[1].shard, 1);
+    BOOST_REQUIRE_EQUAL(to_1.shards[1].meta_map.size(), 1);
+    BOOST_REQUIRE(to_1.shards[1].quiesced_map.contains(raft::group_id(4)));
+
+    auto& to_2 = reqs[1];
+    BOOST_REQUIRE_EQUAL(to_2.target, model::node_id(2));
+    BOOST_REQUIRE_EQUAL(to_2.request.heartbeats.size(), 1);
+    BOOST_REQUIRE_EQUAL(to_2.shards.size(), 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(split_reply_returns_replies_to_their_shards) {
+    std::vector<std::vector<hbeat_manager::node_heartbeat>> shards(2);
+    shards[0].push_back(make_node_heartbeat(
+      model::node_id(1), {raft::group_id(1), raft::group_id(2)}, {}));
+    shards[1].push_back(make_node_heartbeat(
+      model::node_id(1), {raft::group_id(3)}, {raft::group_id(4)}));
+    auto reqs = hbeat_manager::aggregate(std::move(shards));
+    BOOST_REQUIRE_EQUAL(reqs.size(), 1);
+
+    raft::heartbeat_reply reply;
+    for (auto g : {3, 1, 2}) {
+        reply.meta.push_back(raft::append_entries_reply{
+          .group = raft::group_id(g),
+          .result = raft::append_entries_reply::status::success});
+    }
+    reply.woken_groups.push_back(raft::group_id(4));
+
+    auto parts = hbeat_manager::split_reply(reqs[0].shards, std::move(reply));
+    BOOST_REQUIRE_EQUAL(parts.size(), 2);
+    BOOST_REQUIRE_EQUAL(parts[0].meta.size(), 2);
+    BOOST_REQUIRE_EQUAL(parts[0].meta[0].group, raft::group_id(1));
+    BOOST_REQUIRE_EQUAL(parts[0].meta[1].group, raft::group_id(2));
+    BOOST_REQUIRE(parts[0].woken_groups.empty());
+    BOOST_REQUIRE_EQUAL(parts[1].meta.size(), 1);
+    BOOST_REQUIRE_EQUAL(parts[1].meta[0].group, raft::group_id(3));
+    BOOST_REQUIRE_EQUAL(parts[1].woken_groups.size(), 1);
+    BOOST_REQUIRE_EQUAL(parts[1].woken_groups[0], raft::group_id(4));
+}
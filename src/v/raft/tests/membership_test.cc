@@ -269,3 +269,42 @@ FIXTURE_TEST(replace_whole_group, raft_test_fixture) {
         BOOST_REQUIRE_EQUAL(new_leader.consensus->config().brokers().size(), 1);
     }
 }
+
+FIXTURE_TEST(promote_learner_within_max_lag, raft_test_fixture) {
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg()
+          .get("raft_learner_promotion_max_lag")
+          .set_value(size_t(1000));
+    }).get();
+    raft_group gr = raft_group(raft::group_id(0), 1);
+    gr.enable_all();
+    auto res = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(res);
+    auto new_node = gr.create_new_node(model::node_id(2));
+    res = retry_with_leader(gr, 5, 1s, [new_node](raft_node& leader) {
+              return leader.consensus
+                ->add_group_members({new_node}, model::revision_id(0))
+                .then([](std::error_code ec) { return !ec; });
+          }).get0();
+    BOOST_REQUIRE(res);
+
+    tests::cooperative_spin_wait_with_timeout(10s, [&gr] {
+        auto leader_id = gr.get_leader_id();
+        if (!leader_id) {
+            return false;
+        }
+        auto cfg = gr.get_member(*leader_id).consensus->config();
+        const auto& voters = cfg.current_config().voters;
+        return std::any_of(
+          voters.begin(), voters.end(), [](const raft::vnode& v) {
+              return v.id() == model::node_id(2);
+          });
+    }).get0();
+    validate_logs_replication(gr);
+
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg()
+          .get("raft_learner_promotion_max_lag")
+          .set_value(size_t(0));
+    }).get();
+};
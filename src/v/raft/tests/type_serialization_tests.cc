@@ -202,6 +202,40 @@ SEASTAR_THREAD_TEST_CASE(heartbeat_request_roundtrip_with_negative) {
           raft::vnode(model::node_id(0), model::revision_id{}));
     }
 }
+SEASTAR_THREAD_TEST_CASE(heartbeat_quiesced_groups_roundtrip) {
+    raft::heartbeat_request req;
+    req.node_id = model::node_id(1);
+    req.target_node_id = model::node_id(2);
+    req.quiesced_groups = {
+      raft::group_id(7), raft::group_id(3), raft::group_id(1000)};
+    iobuf buf;
+    reflection::async_adl<raft::heartbeat_request>{}
+      .to(buf, std::move(req))
+      .get();
+    auto parser = iobuf_parser(std::move(buf));
+    auto res
+      = reflection::async_adl<raft::heartbeat_request>{}.from(parser).get0();
+    BOOST_REQUIRE(res.heartbeats.empty());
+    BOOST_REQUIRE_EQUAL(res.node_id, model::node_id(1));
+    BOOST_REQUIRE_EQUAL(res.target_node_id, model::node_id(2));
+    std::vector<raft::group_id> expected = {
+      raft::group_id(3), raft::group_id(7), raft::group_id(1000)};
+    BOOST_REQUIRE(res.quiesced_groups == expected);
+
+    raft::heartbeat_reply reply;
+    reply.woken_groups = {raft::group_id(7)};
+    iobuf reply_buf;
+    reflection::async_adl<raft::heartbeat_reply>{}
+      .to(reply_buf, std::move(reply))
+      .get();
+    auto reply_parser = iobuf_parser(std::move(reply_buf));
+    auto reply_res = reflection::async_adl<raft::heartbeat_reply>{}
+                       .from(reply_parser)
+                       .get0();
+    BOOST_REQUIRE(reply_res.meta.empty());
+    BOOST_REQUIRE(
+      reply_res.woken_groups == std::vector<raft::group_id>{raft::group_id(7)});
+}
 SEASTAR_THREAD_TEST_CASE(heartbeat_response_roundtrip) {
     static constexpr int64_t group_count = 10000;
     raft::heartbeat_reply reply;
@@ -284,3 +318,46 @@ SEASTAR_THREAD_TEST_CASE(snapshot_metadata_roundtrip) {
     BOOST_REQUIRE(d.cluster_time == ct);
     BOOST_REQUIRE_EQUAL(d.latest_configuration, cfg);
 }
+
+SEASTAR_THREAD_TEST_CASE(recover_range_roundtrip) {
+    raft::recover_range_request req{
+      .target_node_id = raft::vnode(model::node_id(2), model::revision_id(1)),
+      .node_id = raft::vnode(model::node_id(1), model::revision_id(1)),
+      .group = raft::group_id(10),
+      .term = model::term_id(3),
+      .follower = raft::vnode(model::node_id(4), model::revision_id(2)),
+      .start_offset = model::offset(100),
+      .last_offset = model::offset(20000),
+      .max_bytes = 1024};
+    auto d = serialize_roundtrip_rpc(raft::recover_range_request(req));
+    BOOST_REQUIRE_EQUAL(d.target_node_id, req.target_node_id);
+    BOOST_REQUIRE_EQUAL(d.node_id, req.node_id);
+    BOOST_REQUIRE_EQUAL(d.group, req.group);
+    BOOST_REQUIRE_EQUAL(d.term, req.term);
+    BOOST_REQUIRE_EQUAL(d.follower, req.follower);
+    BOOST_REQUIRE_EQUAL(d.start_offset, req.start_offset);
+    BOOST_REQUIRE_EQUAL(d.last_offset, req.last_offset);
+    BOOST_REQUIRE_EQUAL(d.max_bytes, req.max_bytes);
+
+    raft::recover_range_reply reply{
+      .target_node_id = req.node_id,
+      .success = true,
+      .follower_reply = raft::append_entries_reply{
+        .target_node_id = req.node_id,
+        .node_id = req.follower,
+        .group = req.group,
+        .term = req.term,
+        .last_committed_log_index = model::offset(1000),
+        .last_dirty_log_index = model::offset(1100),
+        .result = raft::append_entries_reply::status::success}};
+    auto r = serialize_roundtrip_rpc(raft::recover_range_reply(reply));
+    BOOST_REQUIRE_EQUAL(r.target_node_id, reply.target_node_id);
+    BOOST_REQUIRE(r.success);
+    BOOST_REQUIRE_EQUAL(r.follower_reply.node_id, req.follower);
+    BOOST_REQUIRE_EQUAL(
+      r.follower_reply.last_committed_log_index, model::offset(1000));
+    BOOST_REQUIRE_EQUAL(
+      r.follower_reply.last_dirty_log_index, model::offset(1100));
+    BOOST_REQUIRE_EQUAL(
+      r.follower_reply.result, raft::append_entries_reply::status::success);
+}
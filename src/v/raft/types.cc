@@ -73,14 +73,14 @@ std::ostream& operator<<(std::ostream& o, const heartbeat_request& r) {
           << "node_id: " << m.node_id << ","
           << "target_node_id: " << m.target_node_id << ",";
     }
-    return o << "]}";
+    return o << "], quiesced_groups: " << r.quiesced_groups.size() << "}";
 }
 std::ostream& operator<<(std::ostream& o, const heartbeat_reply& r) {
     o << "{meta:[";
     for (auto& m : r.meta) {
         o << m << ",";
     }
-    return o << "]}";
+    return o << "], woken_groups: " << r.woken_groups.size() << "}";
 }
 
 std::ostream& operator<<(std::ostream& o, const consistency_level& l) {
@@ -330,6 +330,33 @@ T read_one_varint_delta(iobuf_parser& in, const T& prev) {
     auto dst = varlong_reader<T>(in);
     return prev + dst;
 }
+
+/// Optional trailing list of groups, nothing is written when the list is
+/// empty so that the encoding stays the same for the nodes that are not
+/// aware of it
+void encode_trailing_groups(iobuf& out, std::vector<raft::group_id> groups) {
+    if (groups.empty()) {
+        return;
+    }
+    std::sort(groups.begin(), groups.end());
+    adl<uint32_t>{}.to(out, groups.size());
+    encode_one_delta_array<raft::group_id>(out, groups);
+}
+
+std::vector<raft::group_id> decode_trailing_groups(iobuf_parser& in) {
+    if (in.bytes_left() == 0) {
+        return {};
+    }
+    std::vector<raft::group_id> groups(adl<uint32_t>{}.from(in));
+    if (groups.empty()) {
+        return groups;
+    }
+    groups[0] = varlong_reader<raft::group_id>(in);
+    for (size_t i = 1; i < groups.size(); ++i) {
+        groups[i] = read_one_varint_delta<raft::group_id>(in, groups[i - 1]);
+    }
+    return groups;
+}
 } // namespace internal
 
 ss::future<> async_adl<raft::heartbeat_request>::to(
@@ -344,7 +371,7 @@ ss::future<> async_adl<raft::heartbeat_request>::to(
     std::sort(
       request.heartbeats.begin(), request.heartbeats.end(), sorter_fn{});
     return ss::make_ready_future<>()
-      .then([&out, request = std::move(request)] {
+      .then([&out, request = std::move(request)]() mutable {
           internal::hbeat_soa encodee(request.heartbeats.size());
           // target physical node id is always the same it differs only by
           // revision
@@ -376,15 +403,22 @@ ss::future<> async_adl<raft::heartbeat_request>::to(
           // request.meta = {}; // release memory
 
           // physical node ids are the same for all requests
-          adl<model::node_id>{}.to(
-            out, request.heartbeats.front().node_id.id());
-          adl<model::node_id>{}.to(
-            out, request.heartbeats.front().target_node_id.id());
+          if (request.heartbeats.empty()) {
+              adl<model::node_id>{}.to(out, request.node_id);
+              adl<model::node_id>{}.to(out, request.target_node_id);
+          } else {
+              adl<model::node_id>{}.to(
+                out, request.heartbeats.front().node_id.id());
+              adl<model::node_id>{}.to(
+                out, request.heartbeats.front().target_node_id.id());
+          }
           adl<uint32_t>{}.to(out, size);
 
-          return encodee;
+          return std::make_pair(
+            std::move(encodee), std::move(request.quiesced_groups));
       })
-      .then([&out](internal::hbeat_soa encodee) {
+      .then([&out](auto p) {
+          auto& [encodee, quiesced] = p;
           internal::encode_one_delta_array<raft::group_id>(out, encodee.groups);
           internal::encode_one_delta_array<model::offset>(
             out, encodee.commit_indices);
@@ -399,6 +433,7 @@ ss::future<> async_adl<raft::heartbeat_request>::to(
             out, encodee.revisions);
           internal::encode_one_delta_array<model::revision_id>(
             out, encodee.target_revisions);
+          internal::encode_trailing_groups(out, std::move(quiesced));
       });
 }
 
@@ -412,9 +447,12 @@ async_adl<raft::heartbeat_request>::from(iobuf_parser& in) {
     raft::heartbeat_request req;
     auto node_id = adl<model::node_id>{}.from(in);
     auto target_node = adl<model::node_id>{}.from(in);
+    req.node_id = node_id;
+    req.target_node_id = target_node;
     req.heartbeats = std::vector<raft::heartbeat_metadata>(
       adl<uint32_t>{}.from(in));
     if (req.heartbeats.empty()) {
+        req.quiesced_groups = internal::decode_trailing_groups(in);
         return ss::make_ready_future<raft::heartbeat_request>(std::move(req));
     }
     const size_t max = req.heartbeats.size();
@@ -484,6 +522,7 @@ async_adl<raft::heartbeat_request>::from(iobuf_parser& in) {
         hb.target_node_id = raft::vnode(
           hb.target_node_id.id(), decode_signed(hb.target_node_id.revision()));
     }
+    req.quiesced_groups = internal::decode_trailing_groups(in);
     return ss::make_ready_future<raft::heartbeat_request>(std::move(req));
 }
 
@@ -499,6 +538,7 @@ ss::future<> async_adl<raft::heartbeat_reply>::to(
     adl<uint32_t>{}.to(out, reply.meta.size());
     // no requests
     if (reply.meta.empty()) {
+        internal::encode_trailing_groups(out, std::move(reply.woken_groups));
         return ss::make_ready_future<>();
     }
 
@@ -540,6 +580,7 @@ ss::future<> async_adl<raft::heartbeat_reply>::to(
     for (auto& m : reply.meta) {
         adl<raft::append_entries_reply::status>{}.to(out, m.result);
     }
+    internal::encode_trailing_groups(out, std::move(reply.woken_groups));
     return ss::make_ready_future<>();
 }
 
@@ -551,6 +592,7 @@ async_adl<raft::heartbeat_reply>::from(iobuf_parser& in) {
 
     // empty reply
     if (reply.meta.empty()) {
+        reply.woken_groups = internal::decode_trailing_groups(in);
         return ss::make_ready_future<raft::heartbeat_reply>(std::move(reply));
     }
 
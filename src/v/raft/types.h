@@ -33,6 +33,7 @@
 #include <boost/range/irange.hpp>
 #include <boost/range/join.hpp>
 
+#include <array>
 #include <cstdint>
 #include <exception>
 
@@ -152,6 +153,22 @@ struct follower_index_metadata {
      * `last_sent_seq` value for version control.
      */
     heartbeats_suppressed suppress_heartbeats = heartbeats_suppressed::no;
+    /// append entries requests dispatched by the replicate_entries_stm that
+    /// didn't finish yet, limited by the in flight requests window
+    size_t inflight_append_requests = 0;
+    /// signaled every time one of the in flight requests finishes
+    ss::condition_variable inflight_append_finished;
+    /// the follower rejected a request because it was out of memory, until
+    /// then a single append entries request is in flight to it and the
+    /// writes accumulate in fewer, larger requests
+    clock_type::time_point busy_until;
+    /// send times of the last requests, the slot of a request is its sequence
+    /// modulo the number of slots. The follower doesn't grant votes for an
+    /// election timeout after it accepted a request, the send time of the
+    /// last request it acknowledged bounds the leader lease
+    std::array<std::pair<follower_req_seq, clock_type::time_point>, 16>
+      request_sent_at;
+    clock_type::time_point last_ack_sent_at = clock_type::time_point::min();
 };
 /**
  * class containing follower statistics, this may be helpful for debugging,
@@ -258,9 +275,20 @@ struct heartbeat_metadata {
 /// log at some offset
 struct heartbeat_request {
     std::vector<heartbeat_metadata> heartbeats;
+    /// Groups led by the source node that are quiesced, sent instead of their
+    /// heartbeats to refresh the leader liveness on the target node. Encoded
+    /// after the heartbeats so that older nodes ignore them.
+    std::vector<group_id> quiesced_groups;
+    /// physical node ids, used when the request carries no heartbeats
+    model::node_id node_id;
+    model::node_id target_node_id;
 };
 struct heartbeat_reply {
     std::vector<append_entries_reply> meta;
+    /// Quiesced groups of the request for which the target node doesn't
+    /// recognize the source node as the leader, the leader has to resume
+    /// sending their heartbeats.
+    std::vector<group_id> woken_groups;
 };
 
 struct vote_request {
@@ -459,6 +487,62 @@ struct timeout_now_reply {
     status result;
 };
 
+/**
+ * Asks the current leader of the group to hand its leadership over. Unlike
+ * timeout_now, which is sent by the leader itself, the request can be sent by
+ * any node (e.g. the leader balancer), the leader makes sure that the target
+ * is caught up before issuing timeout_now.
+ */
+struct transfer_leadership_request {
+    group_id group;
+    // when not set the leader picks the most up to date follower
+    std::optional<model::node_id> target;
+
+    raft::group_id target_group() const { return group; }
+};
+
+struct transfer_leadership_reply {
+    raft::errc result{raft::errc::success};
+};
+
+/**
+ * Sent by the leader to an up to date follower, the source, to replicate a
+ * range of committed entries of its log to a lagging follower on behalf of
+ * the leader. The source sends the entries as append entries requests of the
+ * leader, the lagging follower replies to them as if they were sent by the
+ * leader.
+ */
+struct recover_range_request {
+    // node id to validate on receiver
+    vnode target_node_id;
+
+    // the leader
+    vnode node_id;
+    group_id group;
+    model::term_id term;
+    // the follower to recover
+    vnode follower;
+    // the range of committed entries to replicate
+    model::offset start_offset;
+    model::offset last_offset;
+    // upper bound of the bytes replicated by the source
+    uint64_t max_bytes{0};
+
+    raft::group_id target_group() const { return group; }
+    vnode target_node() const { return target_node_id; }
+};
+
+struct recover_range_reply {
+    // node id to validate on receiver
+    vnode target_node_id;
+
+    // false if the source didn't replicate any entries, e.g. the range isn't
+    // in its log or the source isn't a follower of the leader's term
+    bool success{false};
+    // the reply of the follower to the last request sent by the source
+    append_entries_reply follower_reply;
+};
+
 // key types used to store data in key-value store
 enum class metadata_key : int8_t {
     voted_for = 0,
@@ -467,6 +551,8 @@ enum class metadata_key : int8_t {
     last_applied_offset = 3,
     unique_local_id = 4,
     config_next_cfg_idx = 5,
+    config_offsets = 6,
+    config_entry = 7,
     last
 };
 
@@ -16,6 +16,10 @@
 #include "cluster/controller_api.h"
 #include "cluster/errc.h"
 #include "cluster/fwd.h"
+#include "cluster/health_monitor.h"
+#include "cluster/hot_partitions.h"
+#include "cluster/leader_balancer.h"
+#include "cluster/members_backend.h"
 #include "cluster/members_frontend.h"
 #include "cluster/metadata_cache.h"
 #include "cluster/partition_manager.h"
@@ -26,24 +30,38 @@
 #include "config/configuration.h"
 #include "config/endpoint_tls_config.h"
 #include "finjector/hbadger.h"
+#include "kafka/server/slow_request_log.h"
 #include "model/metadata.h"
 #include "model/namespace.h"
 #include "raft/types.h"
 #include "redpanda/admin/api-doc/broker.json.h"
+#include "redpanda/admin/api-doc/cluster.json.h"
 #include "redpanda/admin/api-doc/config.json.h"
 #include "redpanda/admin/api-doc/hbadger.json.h"
 #include "redpanda/admin/api-doc/kafka.json.h"
+#include "redpanda/admin/api-doc/latency.json.h"
 #include "redpanda/admin/api-doc/partition.json.h"
 #include "redpanda/admin/api-doc/raft.json.h"
 #include "redpanda/admin/api-doc/security.json.h"
 #include "redpanda/admin/api-doc/status.json.h"
+#include "redpanda/admin/api-doc/trace.json.h"
+#include "redpanda/scheduling_probe.h"
 #include "rpc/dns.h"
 #include "security/scram_algorithm.h"
 #include "security/scram_authenticator.h"
+#include "storage/disk_usage.h"
+#include "storage/io_latency_probe.h"
+#include "utils/base64.h"
+#include "utils/cpu_profiler.h"
+#include "utils/event_trace.h"
+#include "utils/file_io.h"
+#include "utils/latency_summary.h"
 #include "vlog.h"
 
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/future-util.hh>
 #include <seastar/core/prometheus.hh>
+#include <seastar/core/seastar.hh>
 #include <seastar/core/sharded.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/core/with_scheduling_group.hh>
@@ -52,18 +70,22 @@
 #include <seastar/http/httpd.hh>
 #include <seastar/http/json_path.hh>
 
+#include <absl/container/flat_hash_map.h>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/lexical_cast/bad_lexical_cast.hpp>
+#include <boost/range/irange.hpp>
 #include <fmt/core.h>
 #include <rapidjson/document.h>
 #include <rapidjson/schema.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
 #include <stdexcept>
 #include <system_error>
+#include <tuple>
 #include <unordered_map>
 
 using namespace std::chrono_literals;
@@ -123,6 +145,12 @@ void admin_server::configure_admin_routes() {
     rb->register_api_file(_server._routes, "hbadger");
     rb->register_function(_server._routes, insert_comma);
     rb->register_api_file(_server._routes, "broker");
+    rb->register_function(_server._routes, insert_comma);
+    rb->register_api_file(_server._routes, "cluster");
+    rb->register_function(_server._routes, insert_comma);
+    rb->register_api_file(_server._routes, "latency");
+    rb->register_function(_server._routes, insert_comma);
+    rb->register_api_file(_server._routes, "trace");
 
     register_config_routes();
     register_raft_routes();
@@ -132,6 +160,9 @@ void admin_server::configure_admin_routes() {
     register_broker_routes();
     register_partition_routes();
     register_hbadger_routes();
+    register_cluster_routes();
+    register_latency_routes();
+    register_trace_routes();
 }
 
 void admin_server::configure_dashboard() {
@@ -224,6 +255,38 @@ void admin_server::register_config_routes() {
           return ss::json::json_return_type(buf.GetString());
       });
 
+    ss::httpd::config_json::set_config_property.set(
+      _server._routes,
+      [](std::unique_ptr<ss::httpd::request> req)
+        -> ss::future<ss::json::json_return_type> {
+          auto name = req->param["name"];
+          auto value = req->get_query_param("value");
+          try {
+              // the value is json, a yaml subset, as in get_config
+              auto& property = config::shard_local_cfg().get(name);
+              if (auto err = property.validate(YAML::Load(value)); err) {
+                  throw ss::httpd::bad_param_exception(fmt::format(
+                    "Invalid value {{{}}} for {{{}}}: {}",
+                    value,
+                    name,
+                    err->error_message()));
+              }
+          } catch (const std::out_of_range&) {
+              throw ss::httpd::bad_param_exception(
+                fmt::format("Unknown property {{{}}}", name));
+          } catch (const YAML::Exception& e) {
+              throw ss::httpd::bad_param_exception(fmt::format(
+                "Invalid value {{{}}} for {{{}}}: {}", value, name, e.what()));
+          }
+          vlog(logger.info, "Set property {{{}}}: {}", name, value);
+          // the properties copied into the state of the services apply the
+          // new value through their bindings
+          co_await ss::smp::invoke_on_all([name, value] {
+              config::shard_local_cfg().get(name).set_value(YAML::Load(value));
+          });
+          co_return ss::json::json_void();
+      });
+
     ss::httpd::config_json::set_log_level.set(
       _server._routes, [this](ss::const_req req) {
           auto name = req.param["name"];
@@ -698,36 +761,256 @@ static json_validator make_set_replicas_validator() {
     return json_validator(schema);
 }
 
+/*
+ * Page of a partition listing: the partitions that match the filters and
+ * follow the cursor, in the order of namespace, topic and partition.
+ */
+struct partition_listing {
+    std::optional<model::ntp> cursor;
+    std::optional<size_t> limit;
+    ss::sstring topic_prefix;
+    std::optional<model::node_id> leader;
+    bool under_replicated{false};
+
+    static bool less(const model::ntp& a, const model::ntp& b) {
+        return std::tie(a.ns, a.tp) < std::tie(b.ns, b.tp);
+    }
+
+    bool matches(const model::ntp& ntp, const cluster::partition& p) const {
+        if (cursor && !less(*cursor, ntp)) {
+            return false;
+        }
+        if (!std::string_view(ntp.tp.topic()).starts_with(topic_prefix)) {
+            return false;
+        }
+        if (leader && p.get_leader_id() != leader) {
+            return false;
+        }
+        return !under_replicated || p.is_under_replicated();
+    }
+
+    /// Sort the entries and keep the first page
+    template<typename T, typename Key>
+    void trim(std::vector<T>& entries, Key key) const {
+        auto cmp = [&key](const T& a, const T& b) {
+            return less(key(a), key(b));
+        };
+        if (limit && *limit < entries.size()) {
+            std::partial_sort(
+              entries.begin(), entries.begin() + *limit, entries.end(), cmp);
+            entries.resize(*limit);
+        } else {
+            std::sort(entries.begin(), entries.end(), cmp);
+        }
+    }
+};
+
+static partition_listing
+parse_partition_listing(const ss::httpd::request& req) {
+    partition_listing listing;
+    if (auto cursor = req.get_query_param("cursor"); !cursor.empty()) {
+        // ns/topic/partition of the last partition of the previous page
+        std::vector<ss::sstring> parts;
+        boost::split(parts, cursor, boost::is_any_of("/"));
+        std::optional<model::partition_id> partition;
+        if (parts.size() == 3) {
+            try {
+                partition = model::partition_id(std::stoi(parts[2]));
+            } catch (...) {
+            }
+        }
+        if (!partition) {
+            throw ss::httpd::bad_param_exception(fmt::format(
+              "Cursor must be namespace/topic/partition: {}", cursor));
+        }
+        listing.cursor = model::ntp(
+          model::ns(parts[0]), model::topic(parts[1]), *partition);
+    }
+    if (auto limit = req.get_query_param("limit"); !limit.empty()) {
+        try {
+            listing.limit = boost::lexical_cast<size_t>(limit);
+        } catch (const boost::bad_lexical_cast&) {
+            throw ss::httpd::bad_param_exception(
+              fmt::format("Limit must be a positive integer: {}", limit));
+        }
+        if (*listing.limit == 0) {
+            throw ss::httpd::bad_param_exception(
+              fmt::format("Limit must be a positive integer: {}", limit));
+        }
+    }
+    listing.topic_prefix = req.get_query_param("topic_prefix");
+    if (auto leader = req.get_query_param("leader"); !leader.empty()) {
+        try {
+            listing.leader = model::node_id(std::stoi(leader));
+        } catch (...) {
+            throw ss::httpd::bad_param_exception(
+              fmt::format("Leader node id must be an integer: {}", leader));
+        }
+    }
+    listing.under_replicated = req.get_query_param("under_replicated")
+                               == "true";
+    return listing;
+}
+
 void admin_server::register_partition_routes() {
     /*
-     * Get a list of partition summaries.
+     * Get a page of the partition summaries. The page is streamed, the
+     * response yields between the entries.
      */
     ss::httpd::partition_json::get_partitions.set(
-      _server._routes, [this](std::unique_ptr<ss::httpd::request>) {
+      _server._routes, [this](std::unique_ptr<ss::httpd::request> req) {
           using summary = ss::httpd::partition_json::partition_summary;
+          using entry = std::pair<model::ntp, ss::shard_id>;
+          auto key = [](const entry& e) -> const model::ntp& {
+              return e.first;
+          };
+          auto listing = parse_partition_listing(*req);
           return _partition_manager
             .map_reduce0(
-              [](cluster::partition_manager& pm) {
-                  std::vector<summary> partitions;
-                  partitions.reserve(pm.partitions().size());
-                  for (const auto& it : pm.partitions()) {
-                      summary p;
-                      p.ns = it.first.ns;
-                      p.topic = it.first.tp.topic;
-                      p.partition_id = it.first.tp.partition;
-                      p.core = ss::this_shard_id();
-                      partitions.push_back(std::move(p));
+              [listing, key](cluster::partition_manager& pm) {
+                  std::vector<entry> partitions;
+                  for (const auto& [ntp, p] : pm.partitions()) {
+                      if (listing.matches(ntp, *p)) {
+                          partitions.emplace_back(ntp, ss::this_shard_id());
+                      }
                   }
+                  listing.trim(partitions, key);
                   return partitions;
               },
-              std::vector<summary>{},
-              [](std::vector<summary> acc, std::vector<summary> update) {
-                  acc.insert(acc.end(), update.begin(), update.end());
+              std::vector<entry>{},
+              [](std::vector<entry> acc, std::vector<entry> update) {
+                  acc.insert(
+                    acc.end(),
+                    std::make_move_iterator(update.begin()),
+                    std::make_move_iterator(update.end()));
                   return acc;
               })
-            .then([](std::vector<summary> partitions) {
+            .then([listing, key](std::vector<entry> partitions) {
+                listing.trim(partitions, key);
                 return ss::make_ready_future<ss::json::json_return_type>(
-                  std::move(partitions));
+                  ss::json::stream_range_as_array(
+                    std::move(partitions), [](const entry& e) {
+                        summary p;
+                        p.ns = e.first.ns;
+                        p.topic = e.first.tp.topic;
+                        p.partition_id = e.first.tp.partition;
+                        p.core = e.second;
+                        return p;
+                    }));
+            });
+      });
+
+    /*
+     * Get the size of the partitions of each topic, from the usage the
+     * shards keep up to date instead of a walk over the partitions.
+     */
+    ss::httpd::partition_json::get_partitions_usage.set(
+      _server._routes, [this](std::unique_ptr<ss::httpd::request>) {
+          using usage_map = absl::flat_hash_map<
+            model::topic_namespace,
+            storage::disk_usage::usage,
+            model::topic_namespace_hash,
+            model::topic_namespace_eq>;
+          return _partition_manager
+            .map_reduce0(
+              [](cluster::partition_manager& pm) {
+                  const auto& topics = pm.disk_usage().topics();
+                  return usage_map(topics.begin(), topics.end());
+              },
+              usage_map{},
+              [](usage_map acc, const usage_map& update) {
+                  for (const auto& [tp_ns, u] : update) {
+                      auto& total = acc[tp_ns];
+                      total.size_bytes += u.size_bytes;
+                      total.partitions += u.partitions;
+                  }
+                  return acc;
+              })
+            .then([](usage_map topics) {
+                using topic_usage = ss::httpd::partition_json::topic_usage;
+                std::vector<topic_usage> ret;
+                ret.reserve(topics.size());
+                for (const auto& [tp_ns, u] : topics) {
+                    topic_usage t;
+                    t.ns = tp_ns.ns;
+                    t.topic = tp_ns.tp;
+                    t.size_bytes = u.size_bytes;
+                    t.partitions = u.partitions;
+                    ret.push_back(std::move(t));
+                }
+                return ss::make_ready_future<ss::json::json_return_type>(
+                  std::move(ret));
+            });
+      });
+
+    /*
+     * Get the partitions of this node with the highest recent produce or
+     * fetch rates. A partition lives on a single shard so the tops of the
+     * shards are merged without a join.
+     */
+    ss::httpd::partition_json::get_hot_partitions.set(
+      _server._routes, [this](std::unique_ptr<ss::httpd::request> req) {
+          using sample = cluster::hot_partitions::sample;
+          auto metric = cluster::hot_partitions::metric::bytes_in;
+          if (auto m = req->get_query_param("metric"); !m.empty()) {
+              auto parsed = cluster::hot_partition_metric_from_string(m);
+              if (!parsed) {
+                  throw ss::httpd::bad_param_exception(fmt::format(
+                    "Metric must be bytes_in, bytes_out or requests: {}", m));
+              }
+              metric = *parsed;
+          }
+          size_t limit = 10;
+          if (auto l = req->get_query_param("limit"); !l.empty()) {
+              try {
+                  limit = boost::lexical_cast<size_t>(l);
+              } catch (const boost::bad_lexical_cast&) {
+                  limit = 0;
+              }
+              if (limit == 0 || limit > cluster::hot_partitions::capacity) {
+                  throw ss::httpd::bad_param_exception(fmt::format(
+                    "Limit must be between 1 and {}: {}",
+                    cluster::hot_partitions::capacity,
+                    l));
+              }
+          }
+          return _partition_manager
+            .map_reduce0(
+              [metric, limit](cluster::partition_manager&) {
+                  return cluster::hot_partitions::local().top(metric, limit);
+              },
+              std::vector<sample>{},
+              [](std::vector<sample> acc, std::vector<sample> update) {
+                  acc.insert(
+                    acc.end(),
+                    std::make_move_iterator(update.begin()),
+                    std::make_move_iterator(update.end()));
+                  return acc;
+              })
+            .then([limit](std::vector<sample> samples) {
+                std::sort(
+                  samples.begin(),
+                  samples.end(),
+                  [](const sample& a, const sample& b) {
+                      return a.rate > b.rate;
+                  });
+                if (samples.size() > limit) {
+                    samples.resize(limit);
+                }
+                using hot_partition = ss::httpd::partition_json::hot_partition;
+                std::vector<hot_partition> ret;
+                ret.reserve(samples.size());
+                for (const auto& s : samples) {
+                    hot_partition p;
+                    p.ns = s.ntp.ns;
+                    p.topic = s.ntp.tp.topic;
+                    p.partition_id = s.ntp.tp.partition;
+                    p.rate = s.rate;
+                    p.error = s.error;
+                    ret.push_back(std::move(p));
+                }
+                return ss::make_ready_future<ss::json::json_return_type>(
+                  std::move(ret));
             });
       });
 
@@ -870,9 +1153,315 @@ void admin_server::register_partition_routes() {
 
           co_return ss::json::json_void();
       });
+
+    /*
+     * Get the latest committed record of a key of a compacted partition.
+     */
+    ss::httpd::partition_json::get_partition_key.set(
+      _server._routes,
+      [this](std::unique_ptr<ss::httpd::request> req)
+        -> ss::future<ss::json::json_return_type> {
+          auto ns = model::ns(req->param["namespace"]);
+          auto topic = model::topic(req->param["topic"]);
+
+          model::partition_id partition;
+          try {
+              partition = model::partition_id(
+                std::stoi(req->param["partition"]));
+          } catch (...) {
+              throw ss::httpd::bad_param_exception(fmt::format(
+                "Partition id must be an integer: {}",
+                req->param["partition"]));
+          }
+
+          if (partition() < 0) {
+              throw ss::httpd::bad_param_exception(
+                fmt::format("Invalid partition id {}", partition));
+          }
+
+          bytes key;
+          try {
+              key = base64_to_bytes(req->get_query_param("key"));
+          } catch (const base64_decoder_exception&) {
+              throw ss::httpd::bad_param_exception(
+                "Key must be base64 encoded");
+          }
+          if (key.empty()) {
+              throw ss::httpd::bad_param_exception("Key must not be empty");
+          }
+
+          model::ntp ntp(std::move(ns), std::move(topic), partition);
+
+          auto shard = _shard_table.local().shard_for(ntp);
+          if (!shard) {
+              throw ss::httpd::not_found_exception(
+                fmt::format("Could not find ntp: {}", ntp));
+          }
+
+          using record = ss::httpd::partition_json::key_record;
+          auto ret = co_await _partition_manager.invoke_on(
+            *shard,
+            [ntp, key = std::move(key)](cluster::partition_manager& pm) mutable
+            -> ss::future<std::optional<record>> {
+                auto partition = pm.get(ntp);
+                if (!partition) {
+                    throw ss::httpd::not_found_exception(
+                      fmt::format("Could not find ntp: {}", ntp));
+                }
+                if (!partition->get_ntp_config().is_compacted()) {
+                    throw ss::httpd::bad_request_exception(
+                      fmt::format("Partition {} is not compacted", ntp));
+                }
+                return partition
+                  ->key_query(std::move(key), ss::default_priority_class())
+                  .then([](std::optional<storage::key_query_result> r) {
+                      if (!r) {
+                          return std::optional<record>();
+                      }
+                      record rec;
+                      rec.offset = r->offset();
+                      rec.timestamp = r->time.value();
+                      rec.tombstone = !r->value.has_value();
+                      if (r->value) {
+                          rec.value = iobuf_to_base64(*r->value);
+                      }
+                      return std::optional<record>(std::move(rec));
+                  });
+            });
+
+          if (!ret) {
+              throw ss::httpd::not_found_exception(
+                fmt::format("Could not find the key in ntp: {}", ntp));
+          }
+          co_return std::move(*ret);
+      });
+}
+
+void admin_server::register_cluster_routes() {
+    ss::httpd::cluster_json::get_leader_balancer_status.set(
+      _server._routes,
+      [this](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          auto st = co_await _controller->get_leader_balancer().invoke_on(
+            cluster::leader_balancer::shard,
+            [](cluster::leader_balancer& lb) { return lb.get_status(); });
+          ss::httpd::cluster_json::leader_balancer_status ret;
+          ret.enabled = st.enabled;
+          ret.paused = st.paused;
+          ret.active = st.active;
+          ret.transfers = st.transfers;
+          ret.transfer_errors = st.transfer_errors;
+          co_return ret;
+      });
+
+    ss::httpd::cluster_json::pause_leader_balancer.set(
+      _server._routes,
+      [this](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          vlog(logger.info, "Pausing the leader balancer");
+          co_await _controller->get_leader_balancer().invoke_on(
+            cluster::leader_balancer::shard,
+            [](cluster::leader_balancer& lb) { lb.pause(); });
+          co_return ss::json::json_void();
+      });
+
+    ss::httpd::cluster_json::resume_leader_balancer.set(
+      _server._routes,
+      [this](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          vlog(logger.info, "Resuming the leader balancer");
+          co_await _controller->get_leader_balancer().invoke_on(
+            cluster::leader_balancer::shard,
+            [](cluster::leader_balancer& lb) { lb.resume(); });
+          co_return ss::json::json_void();
+      });
+
+    ss::httpd::cluster_json::get_reallocations_status.set(
+      _server._routes,
+      [this](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          auto st = co_await _controller->get_members_backend().invoke_on(
+            cluster::members_manager::shard,
+            [](cluster::members_backend& b) { return b.get_status(); });
+          ss::httpd::cluster_json::reallocations_status ret;
+          ret.active = st.active;
+          for (const auto& u : st.updates) {
+              ss::httpd::cluster_json::node_reallocations n;
+              n.node_id = u.id;
+              n.type = fmt::format("{}", u.type);
+              n.partitions_total = u.partitions_total;
+              n.partitions_finished = u.partitions_finished;
+              n.partitions_moving = u.partitions_moving;
+              n.elapsed_ms = u.elapsed.count();
+              n.eta_ms = u.eta ? u.eta->count() : -1;
+              for (const auto& p : u.partitions) {
+                  ss::httpd::cluster_json::partition_reallocation pr;
+                  pr.ns = p.ntp.ns;
+                  pr.topic = p.ntp.tp.topic;
+                  pr.partition_id = p.ntp.tp.partition;
+                  pr.state = fmt::format("{}", p.state);
+                  for (const auto& r : p.replicas) {
+                      ss::httpd::cluster_json::reallocation_replica a;
+                      a.node_id = r.node_id;
+                      a.core = r.shard;
+                      pr.replicas.push(a);
+                  }
+                  pr.moving_for_ms = p.moving_for ? p.moving_for->count() : -1;
+                  n.partitions.push(pr);
+              }
+              ret.updates.push(n);
+          }
+          co_return ret;
+      });
+
+    /*
+     * The reports are summarized per topic on the monitor shard, a report
+     * holds an entry per partition led by the node.
+     */
+    ss::httpd::cluster_json::get_cluster_health.set(
+      _server._routes,
+      [this](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          co_return co_await _controller->get_health_monitor().invoke_on(
+            cluster::health_monitor::shard, [](cluster::health_monitor& hm) {
+                ss::httpd::cluster_json::cluster_health ret;
+                ret.active = hm.is_active();
+                auto now = cluster::health_monitor::clock_type::now();
+                for (const auto& [id, h] : hm.reports()) {
+                    ss::httpd::cluster_json::node_health n;
+                    n.node_id = id;
+                    n.report_age_ms
+                      = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          now - h.updated_at)
+                          .count();
+                    n.disk_total_bytes = h.report.disk_total_bytes;
+                    n.disk_free_bytes = h.report.disk_free_bytes;
+                    n.bytes_rate = h.report.bytes_rate;
+                    for (const auto& t : h.report.topics) {
+                        ss::httpd::cluster_json::topic_health th;
+                        th.ns = t.tp_ns.ns;
+                        th.topic = t.tp_ns.tp;
+                        th.size_bytes = t.size_bytes;
+                        th.replicas = t.replicas;
+                        th.leaders = t.leaders.size();
+                        uint64_t under_replicated = 0;
+                        uint64_t bytes_rate = 0;
+                        for (const auto& p : t.leaders) {
+                            under_replicated += p.under_replicated ? 1 : 0;
+                            bytes_rate += p.bytes_rate;
+                        }
+                        th.under_replicated = under_replicated;
+                        th.bytes_rate = bytes_rate;
+                        n.topics.push(th);
+                    }
+                    ret.nodes.push(n);
+                }
+                return ss::json::json_return_type(std::move(ret));
+            });
+      });
+}
+
+template<typename T>
+static T
+parse_io_fault_param(const ss::httpd::request& req, const char* name, T def) {
+    auto value = req.get_query_param(name);
+    if (value.empty()) {
+        return def;
+    }
+    try {
+        auto v = boost::lexical_cast<T>(value);
+        if (v >= T(0)) {
+            return v;
+        }
+    } catch (const boost::bad_lexical_cast&) {
+    }
+    throw ss::httpd::bad_param_exception(
+      fmt::format("{} must be a non negative number: {}", name, value));
+}
+
+static finjector::io_point parse_io_point(const ss::httpd::request& req) {
+    auto point = finjector::io_point_from_string(req.param["point"]);
+    if (!point) {
+        throw ss::httpd::bad_param_exception(
+          fmt::format("Unknown I/O point: {}", req.param["point"]));
+    }
+    return *point;
+}
+
+/**
+ * The latency and bandwidth faults are registered in all builds, they are
+ * used for the performance tests of the release builds. The faults can only
+ * be set when the io_fault_injection_enabled is set.
+ */
+void admin_server::register_io_fault_routes() {
+    ss::httpd::hbadger_json::get_io_faults.set(
+      _server._routes, [](std::unique_ptr<ss::httpd::request>) {
+          std::vector<ss::httpd::hbadger_json::io_fault> res;
+          for (size_t i = 0; i < finjector::io_points_count; ++i) {
+              auto point = static_cast<finjector::io_point>(i);
+              const auto& f
+                = finjector::shard_local_badger().io(point).fault();
+              ss::httpd::hbadger_json::io_fault r;
+              r.point = ss::sstring(finjector::to_string_view(point));
+              r.probability = f.probability;
+              r.delay_ms = f.delay.count();
+              r.jitter_ms = f.jitter.count();
+              r.bandwidth = f.bandwidth;
+              res.push_back(std::move(r));
+          }
+          return ss::make_ready_future<ss::json::json_return_type>(
+            std::move(res));
+      });
+
+    ss::httpd::hbadger_json::set_io_fault.set(
+      _server._routes, [](std::unique_ptr<ss::httpd::request> req) {
+          if (!config::shard_local_cfg().io_fault_injection_enabled()) {
+              throw ss::httpd::bad_request_exception(
+                "I/O fault injection is disabled, set "
+                "io_fault_injection_enabled to enable it");
+          }
+          auto point = parse_io_point(*req);
+          finjector::io_fault f{
+            .probability = parse_io_fault_param(*req, "probability", 1.0),
+            .delay = std::chrono::milliseconds(
+              parse_io_fault_param<int64_t>(*req, "delay_ms", 0)),
+            .jitter = std::chrono::milliseconds(
+              parse_io_fault_param<int64_t>(*req, "jitter_ms", 0)),
+            .bandwidth = parse_io_fault_param<uint64_t>(*req, "bandwidth", 0),
+          };
+          if (f.probability > 1.0) {
+              throw ss::httpd::bad_param_exception(fmt::format(
+                "probability must be in [0, 1]: {}", f.probability));
+          }
+          vlog(
+            logger.info,
+            "Request to set I/O fault {} at point '{}'",
+            f,
+            finjector::to_string_view(point));
+          return ss::smp::invoke_on_all([point, f] {
+                     finjector::shard_local_badger().set_io_fault(point, f);
+                 })
+            .then(
+              [] { return ss::json::json_return_type(ss::json::json_void()); });
+      });
+
+    ss::httpd::hbadger_json::delete_io_fault.set(
+      _server._routes, [](std::unique_ptr<ss::httpd::request> req) {
+          auto point = parse_io_point(*req);
+          vlog(
+            logger.info,
+            "Request to unset I/O fault at point '{}'",
+            finjector::to_string_view(point));
+          return ss::smp::invoke_on_all([point] {
+                     finjector::shard_local_badger().unset_io_fault(point);
+                 })
+            .then(
+              [] { return ss::json::json_return_type(ss::json::json_void()); });
+      });
 }
 
 void admin_server::register_hbadger_routes() {
+    register_io_fault_routes();
     /**
      * we always register `v1/failure-probes` route. It will ALWAYS return empty
      * list of probes in production mode, and flag indicating that honey badger
@@ -968,3 +1557,190 @@ void admin_server::register_hbadger_routes() {
               [] { return ss::json::json_return_type(ss::json::json_void()); });
       });
 }
+
+void admin_server::register_latency_routes() {
+    ss::httpd::latency_json::get_latency_summary.set(
+      _server._routes,
+      [](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          auto hists = co_await latency_summary::merge();
+          std::vector<ss::httpd::latency_json::operation_latency> res;
+          for (size_t i = 0; i < latency_summary::ops_count; ++i) {
+              const auto& h = hists[i];
+              ss::httpd::latency_json::operation_latency l;
+              l.operation = latency_summary::name(
+                static_cast<latency_summary::op>(i));
+              l.samples = h.sample_count();
+              l.mean_us = static_cast<int64_t>(h.mean());
+              l.p50_us = h.get_value_at(50.0);
+              l.p90_us = h.get_value_at(90.0);
+              l.p99_us = h.get_value_at(99.0);
+              l.p999_us = h.get_value_at(99.9);
+              l.p9999_us = h.get_value_at(99.99);
+              l.max_us = h.get_value_at(100.0);
+              res.push_back(std::move(l));
+          }
+          co_return res;
+      });
+
+    ss::httpd::latency_json::get_scheduling_groups_latency.set(
+      _server._routes,
+      [](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          auto groups = co_await scheduling_probe::merge();
+          std::vector<ss::httpd::latency_json::scheduling_group_latency> res;
+          for (const auto& g : groups) {
+              ss::httpd::latency_json::scheduling_group_latency l;
+              l.group = g.name;
+              l.samples = g.queue_delay.sample_count();
+              l.p50_us = g.queue_delay.get_value_at(50.0);
+              l.p99_us = g.queue_delay.get_value_at(99.0);
+              l.p999_us = g.queue_delay.get_value_at(99.9);
+              l.max_us = g.queue_delay.get_value_at(100.0);
+              l.stalls = g.stalls;
+              res.push_back(std::move(l));
+          }
+          co_return res;
+      });
+
+    ss::httpd::latency_json::get_slow_requests.set(
+      _server._routes,
+      [](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          auto entries = co_await kafka::slow_request_log::collect();
+          std::vector<ss::httpd::latency_json::slow_request> res;
+          res.reserve(entries.size());
+          for (const auto& e : entries) {
+              ss::httpd::latency_json::slow_request r;
+              r.shard = e.shard;
+              r.api_key = e.key();
+              r.api_version = e.version();
+              r.client_id = e.client_id;
+              r.received_ms = e.received.value();
+              r.request_bytes = e.request_bytes;
+              r.response_bytes = e.response_bytes;
+              r.partition_count = e.partition_count;
+              for (const auto& tp : e.partitions) {
+                  r.partitions.push(
+                    fmt::format("{}/{}", tp.topic, tp.partition));
+              }
+              r.total_us = e.total().count();
+              r.throttle_us = e.throttle.count();
+              r.queue_us = e.queue.count();
+              r.dispatch_us = e.dispatch.count();
+              r.process_us = e.process.count();
+              r.write_us = e.write.count();
+              res.push_back(std::move(r));
+          }
+          co_return res;
+      });
+
+    ss::httpd::latency_json::get_storage_io_latency.set(
+      _server._routes,
+      [](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          using storage::io_latency_probe;
+          auto classes = co_await io_latency_probe::merge();
+          std::vector<ss::httpd::latency_json::storage_io_latency> res;
+          for (const auto& c : classes) {
+              for (size_t o = 0; o < io_latency_probe::ops_count; ++o) {
+                  const auto& h = c.hists[o];
+                  if (h.sample_count() == 0) {
+                      continue;
+                  }
+                  ss::httpd::latency_json::storage_io_latency l;
+                  l.priority_class = c.priority_class;
+                  l.op = io_latency_probe::name(
+                    static_cast<io_latency_probe::op>(o));
+                  l.samples = h.sample_count();
+                  l.p50_us = h.get_value_at(50.0);
+                  l.p99_us = h.get_value_at(99.0);
+                  l.p999_us = h.get_value_at(99.9);
+                  l.max_us = h.get_value_at(100.0);
+                  res.push_back(std::move(l));
+              }
+          }
+          co_return res;
+      });
+}
+
+void admin_server::register_trace_routes() {
+    ss::httpd::trace_json::dump_event_trace.set(
+      _server._routes,
+      [](std::unique_ptr<ss::httpd::request>)
+        -> ss::future<ss::json::json_return_type> {
+          auto dir = config::shard_local_cfg().data_directory().path
+                     / "event_trace";
+          co_await ss::recursive_touch_directory(dir.string());
+          auto paths = co_await ss::map_reduce(
+            boost::irange<ss::shard_id>(0, ss::smp::count),
+            [dir](ss::shard_id shard) {
+                return ss::smp::submit_to(
+                  shard, [dir]() -> ss::future<std::vector<ss::sstring>> {
+                      auto buf = event_trace::dump();
+                      if (buf.empty()) {
+                          return ss::make_ready_future<
+                            std::vector<ss::sstring>>();
+                      }
+                      auto path = dir
+                                  / fmt::format(
+                                    "shard-{}.bin", ss::this_shard_id());
+                      return write_fully(path, std::move(buf))
+                        .then([path] {
+                            return std::vector<ss::sstring>{path.string()};
+                        });
+                  });
+            },
+            std::vector<ss::sstring>{},
+            [](std::vector<ss::sstring> acc, std::vector<ss::sstring> p) {
+                acc.insert(acc.end(), p.begin(), p.end());
+                return acc;
+            });
+          if (paths.empty()) {
+              throw ss::httpd::bad_request_exception(
+                "Event tracing is disabled, see event_trace_buffer_events");
+          }
+          co_return paths;
+      });
+
+    ss::httpd::trace_json::cpu_profile.set(
+      _server._routes,
+      [](std::unique_ptr<ss::httpd::request> req)
+        -> ss::future<ss::json::json_return_type> {
+          auto param = [&req](const char* name, uint32_t def, uint32_t max) {
+              auto v = req->get_query_param(name);
+              if (v.empty()) {
+                  return def;
+              }
+              try {
+                  return std::min(boost::lexical_cast<uint32_t>(v), max);
+              } catch (const boost::bad_lexical_cast&) {
+                  throw ss::httpd::bad_param_exception(
+                    fmt::format("{} must be a positive integer: {}", name, v));
+              }
+          };
+          const auto duration = std::chrono::milliseconds(
+            param("duration_ms", 5000, 60000));
+          const auto frequency = param("frequency", 99, 1000);
+          try {
+              co_return co_await ss::map_reduce(
+                boost::irange<ss::shard_id>(0, ss::smp::count),
+                [duration, frequency](ss::shard_id shard) {
+                    return ss::smp::submit_to(shard, [duration, frequency] {
+                        return cpu_profiler::profile(duration, frequency);
+                    });
+                },
+                std::vector<ss::sstring>{},
+                [](std::vector<ss::sstring> acc, std::vector<ss::sstring> s) {
+                    acc.insert(
+                      acc.end(),
+                      std::make_move_iterator(s.begin()),
+                      std::make_move_iterator(s.end()));
+                    return acc;
+                });
+          } catch (const std::runtime_error& e) {
+              throw ss::httpd::bad_request_exception(
+                fmt::format("CPU profile failed: {}", e.what()));
+          }
+      });
+}
@@ -11,6 +11,7 @@
 
 #include "archival/ntp_archiver_service.h"
 #include "archival/service.h"
+#include "bytes/details/io_fragment_pool.h"
 #include "cluster/cluster_utils.h"
 #include "cluster/id_allocator.h"
 #include "cluster/id_allocator_frontend.h"
@@ -22,10 +23,12 @@
 #include "cluster/topics_frontend.h"
 #include "cluster/tx_gateway.h"
 #include "cluster/tx_gateway_frontend.h"
+#include "compression/async_compressor.h"
 #include "config/configuration.h"
 #include "config/endpoint_tls_config.h"
 #include "config/seed_server.h"
 #include "kafka/client/configuration.h"
+#include "kafka/server/connection_balancer.h"
 #include "kafka/server/coordinator_ntp_mapper.h"
 #include "kafka/server/group_manager.h"
 #include "kafka/server/group_router.h"
@@ -45,8 +48,11 @@
 #include "storage/chunk_cache.h"
 #include "storage/compaction_controller.h"
 #include "storage/directories.h"
+#include "storage/disk_tuning.h"
+#include "syschecks/disk_benchmark.h"
 #include "syschecks/syschecks.h"
 #include "test_utils/logs.h"
+#include "utils/event_trace.h"
 #include "utils/file_io.h"
 #include "utils/human.h"
 #include "version.h"
@@ -178,6 +184,27 @@ void application::initialize(
           config::shard_local_cfg().zstd_decompress_workspace_bytes());
     }).get0();
 
+    if (auto bytes = config::shard_local_cfg().iobuf_fragment_pool_bytes();
+        bytes > 0) {
+        ss::smp::invoke_on_all([bytes] {
+            details::io_fragment_pool::enable(bytes);
+        }).get();
+        _deferred.emplace_back([] {
+            ss::smp::invoke_on_all([] {
+                details::io_fragment_pool::disable();
+            }).get();
+        });
+    }
+
+    if (auto events = config::shard_local_cfg().event_trace_buffer_events();
+        events > 0) {
+        ss::smp::invoke_on_all([events] { event_trace::enable(events); })
+          .get();
+        _deferred.emplace_back([] {
+            ss::smp::invoke_on_all([] { event_trace::disable(); }).get();
+        });
+    }
+
     if (config::shard_local_cfg().enable_pid_file()) {
         syschecks::pidfile_create(config::shard_local_cfg().pidfile_path());
     }
@@ -328,7 +355,34 @@ void application::check_environment() {
         storage::directories::initialize(
           config::shard_local_cfg().data_directory().as_sstring())
           .get();
+        for (const auto& dir :
+             config::shard_local_cfg().additional_data_directories()) {
+            storage::directories::initialize(dir).get();
+        }
+        if (config::shard_local_cfg().disk_benchmark()) {
+            tune_disk();
+        }
+    }
+}
+
+/**
+ * Derive the I/O parameters of the log from the slowest data directory, it
+ * runs before any log is opened
+ */
+void application::tune_disk() {
+    auto profile = syschecks::disk_profile_of(
+                     config::shard_local_cfg().data_directory().path)
+                     .get0();
+    for (const auto& dir :
+         config::shard_local_cfg().additional_data_directories()) {
+        profile = profile.slowest(
+          syschecks::disk_profile_of(std::filesystem::path(dir)).get0());
     }
+    auto tuning = storage::disk_tuning::for_profile(profile);
+    vlog(_log.info, "Disk profile {}, tuning {}", profile, tuning);
+    ss::smp::invoke_on_all([tuning] {
+        storage::disk_tuning::local() = tuning;
+    }).get();
 }
 
 static admin_server_cfg
@@ -379,7 +433,7 @@ static storage::kvstore_config kvstore_config_from_global_config() {
 
 static storage::log_config
 manager_config_from_global_config(scheduling_groups& sgs) {
-    return storage::log_config(
+    auto cfg = storage::log_config(
       storage::log_config::storage_type::disk,
       config::shard_local_cfg().data_directory().as_sstring(),
       config::shard_local_cfg().log_segment_size(),
@@ -396,9 +450,55 @@ manager_config_from_global_config(scheduling_groups& sgs) {
         .stable_window = config::shard_local_cfg().reclaim_stable_window(),
         .min_size = config::shard_local_cfg().reclaim_min_size(),
         .max_size = config::shard_local_cfg().reclaim_max_size(),
+        .protected_ratio
+        = config::shard_local_cfg().batch_cache_protected_ratio(),
       },
       config::shard_local_cfg().readers_cache_eviction_timeout_ms(),
       sgs.compaction_sg());
+    cfg.additional_dirs
+      = config::shard_local_cfg().additional_data_directories();
+    cfg.recompression_min_age
+      = config::shard_local_cfg().log_recompression_min_age_ms();
+    cfg.housekeeping_budget
+      = config::shard_local_cfg().log_housekeeping_budget_ms();
+    cfg.housekeeping_concurrency
+      = config::shard_local_cfg().log_housekeeping_concurrency();
+    return cfg;
+}
+
+static storage::background_controller_config background_controller_config() {
+    return storage::background_controller_config{
+      .target_latency = std::max(
+        config::shard_local_cfg().background_ctrl_target_ms(),
+        storage::disk_tuning::local().flush_latency_target),
+      .proportional_coeff = config::shard_local_cfg().background_ctrl_p_coeff(),
+      .integral_coeff = config::shard_local_cfg().background_ctrl_i_coeff(),
+      .sampling_interval
+      = config::shard_local_cfg().background_ctrl_update_interval_ms(),
+    };
+}
+
+/**
+ * Background work that is scaled down when the foreground latency is high.
+ * Only learner recovery has a scheduling group of its own, recovery of the
+ * followers runs in the raft group.
+ */
+static std::vector<storage::background_controller::managed_class>
+background_controller_classes(scheduling_groups& sgs) {
+    int min_shares = config::shard_local_cfg().background_ctrl_min_shares();
+    int max_shares = config::shard_local_cfg().background_ctrl_max_shares();
+    return {
+      {.name = "raft_learner_recovery",
+       .scheduling_group = sgs.raft_learner_recovery_sg(),
+       .io_priority = priority_manager::local().raft_learner_recovery_priority(),
+       .min_shares = min_shares,
+       .max_shares = max_shares},
+      {.name = "archival",
+       .scheduling_group = std::nullopt,
+       .io_priority = priority_manager::local().archival_priority(),
+       .min_shares = min_shares,
+       .max_shares = max_shares},
+    };
 }
 
 static storage::backlog_controller_config compaction_controller_config(
@@ -491,10 +591,27 @@ void application::wire_up_redpanda_services() {
 
     // cluster
     syschecks::systemd_message("Adding raft client cache").get();
-    construct_service(_raft_connection_cache).get();
+    construct_service(
+      _raft_connection_cache,
+      static_cast<size_t>(std::max<int16_t>(
+        config::shard_local_cfg().rpc_client_connections_per_peer(), 1)))
+      .get();
     syschecks::systemd_message("Building shard-lookup tables").get();
     construct_service(shard_table).get();
 
+    syschecks::systemd_message("Starting compression offload").get();
+    ss::smp::invoke_on_all([sg = _scheduling_groups.compression_sg()] {
+        compression::async_compressor::start(
+          sg,
+          config::shard_local_cfg().compression_offload_threshold_bytes(),
+          config::shard_local_cfg().disable_metrics());
+    }).get();
+    _deferred.emplace_back([] {
+        ss::smp::invoke_on_all([] {
+            return compression::async_compressor::stop();
+        }).get();
+    });
+
     syschecks::systemd_message("Intializing storage services").get();
     auto log_cfg = manager_config_from_global_config(_scheduling_groups);
     log_cfg.reclaim_opts.background_reclaimer_sg
@@ -514,7 +631,9 @@ void application::wire_up_redpanda_services() {
     syschecks::systemd_message("Intializing raft recovery throttle").get();
     recovery_throttle
       .start(
-        config::shard_local_cfg().raft_learner_recovery_rate() / ss::smp::count)
+        config::shard_local_cfg().raft_learner_recovery_rate() / ss::smp::count,
+        config::shard_local_cfg().raft_recovery_max_concurrent_reads()
+          / ss::smp::count)
       .get();
 
     syschecks::systemd_message("Intializing raft group manager").get();
@@ -598,6 +717,24 @@ void application::wire_up_redpanda_services() {
           std::ref(configs))
           .get();
         configs.stop().get();
+        // the partitions of the topics with recovery enabled are restored
+        // from the bucket of the archival service
+        partition_manager
+          .invoke_on_all([this](cluster::partition_manager& pm) {
+              pm.set_log_recovery(
+                [&svc = archival_scheduler.local()](
+                  const storage::ntp_config& cfg) {
+                    return svc.download_log(cfg);
+                });
+          })
+          .get();
+        _deferred.emplace_back([this] {
+            partition_manager
+              .invoke_on_all([](cluster::partition_manager& pm) {
+                  pm.set_log_recovery({});
+              })
+              .get();
+        });
     }
     // group membership
     syschecks::systemd_message("Creating partition manager").get();
@@ -623,6 +760,23 @@ void application::wire_up_redpanda_services() {
     // metrics and quota management
     syschecks::systemd_message("Adding kafka quota manager").get();
     construct_service(quota_mgr).get();
+    syschecks::systemd_message("Adding kafka connection balancer").get();
+    std::optional<std::chrono::milliseconds> conn_balance_interval;
+    if (config::shard_local_cfg().enable_kafka_connection_balancer()) {
+        conn_balance_interval
+          = config::shard_local_cfg().kafka_connection_balance_interval_ms();
+    }
+    construct_service(
+      connection_balancer,
+      conn_balance_interval,
+      config::shard_local_cfg().kafka_connection_balance_tolerance())
+      .get();
+    syschecks::systemd_message("Adding scheduling probe").get();
+    construct_service(
+      sched_probe,
+      _scheduling_groups.all_scheduling_groups(),
+      config::shard_local_cfg().scheduling_probe_interval_ms())
+      .get();
     // rpc
     ss::sharded<rpc::server_configuration> rpc_cfg;
     rpc_cfg.start(ss::sstring("internal_rpc")).get();
@@ -637,6 +791,9 @@ void application::wire_up_redpanda_services() {
               c.max_service_memory_per_core = memory_groups::rpc_total_memory();
               c.disable_metrics = rpc::metrics_disabled(
                 config::shard_local_cfg().disable_metrics());
+              if (auto d = config::shard_local_cfg().rpc_cork_delay_us(); d) {
+                  c.cork_delay = std::chrono::microseconds(*d);
+              }
               auto rpc_builder = config::shard_local_cfg()
                                    .rpc_server_tls()
                                    .get_credentials_builder()
@@ -778,13 +935,28 @@ void application::wire_up_redpanda_services() {
       .get();
     construct_service(_kafka_server, &kafka_cfg).get();
     kafka_cfg.stop().get();
+    syschecks::systemd_message("Adding memory balancer").get();
+    construct_service(
+      mem_balancer,
+      std::ref(_kafka_server),
+      std::ref(_rpc),
+      config::shard_local_cfg().memory_balance_interval_ms())
+      .get();
     construct_service(
       fetch_session_cache,
-      config::shard_local_cfg().fetch_session_eviction_timeout_ms())
+      config::shard_local_cfg().fetch_session_eviction_timeout_ms(),
+      config::shard_local_cfg().fetch_session_cache_max_memory())
+      .get();
+    construct_service(
+      _background_controller,
+      std::ref(storage),
+      background_controller_config(),
+      background_controller_classes(_scheduling_groups))
       .get();
     construct_service(
       _compaction_controller,
       std::ref(storage),
+      std::ref(_background_controller),
       compaction_controller_config(
         _scheduling_groups.compaction_sg(),
         priority_manager::local().compaction_priority()))
@@ -843,6 +1015,9 @@ void application::start() {
 void application::start_redpanda() {
     syschecks::systemd_message("Staring storage services").get();
     storage.invoke_on_all(&storage::api::start).get();
+    storage
+      .invoke_on_all([](storage::api& api) { api.log_mgr().setup_metrics(); })
+      .get();
 
     syschecks::systemd_message("Starting the partition manager").get();
     partition_manager.invoke_on_all(&cluster::partition_manager::start).get();
@@ -903,7 +1078,8 @@ void application::start_redpanda() {
             std::ref(metadata_cache),
             std::ref(controller->get_security_frontend()),
             std::ref(controller->get_api()),
-            std::ref(controller->get_members_frontend()));
+            std::ref(controller->get_members_frontend()),
+            std::ref(controller->get_health_monitor()));
           proto->register_service<cluster::metadata_dissemination_handler>(
             _scheduling_groups.cluster_sg(),
             smp_service_groups.cluster_smp_sg(),
@@ -924,6 +1100,9 @@ void application::start_redpanda() {
     }
 
     quota_mgr.invoke_on_all(&kafka::quota_manager::start).get();
+    connection_balancer.invoke_on_all(&kafka::connection_balancer::start)
+      .get();
+    sched_probe.invoke_on_all(&scheduling_probe::start).get();
 
     std::optional<kafka::qdc_monitor::config> qdc_config;
     if (config::shard_local_cfg().kafka_qdc_enable()) {
@@ -954,17 +1133,20 @@ void application::start_redpanda() {
             partition_manager,
             coordinator_ntp_mapper,
             fetch_session_cache,
+            connection_balancer,
             id_allocator_frontend,
             controller->get_credential_store(),
             controller->get_authorizer(),
             controller->get_security_frontend(),
             controller->get_api(),
             tx_gateway_frontend,
+            archival_scheduler,
             qdc_config);
           s.set_protocol(std::move(proto));
       })
       .get();
     _kafka_server.invoke_on_all(&rpc::server::start).get();
+    mem_balancer.invoke_on_all(&memory_balancer::start).get();
     vlog(
       _log.info, "Started Kafka API server listening at {}", conf.kafka_api());
 
@@ -977,6 +1159,8 @@ void application::start_redpanda() {
         _admin.invoke_on_all(&admin_server::start).get0();
     }
 
+    _background_controller.invoke_on_all(&storage::background_controller::start)
+      .get();
     _compaction_controller.invoke_on_all(&storage::compaction_controller::start)
       .get();
 }
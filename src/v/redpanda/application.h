@@ -27,12 +27,15 @@
 #include "raft/group_manager.h"
 #include "raft/recovery_throttle.h"
 #include "redpanda/admin_server.h"
+#include "redpanda/memory_balancer.h"
+#include "redpanda/scheduling_probe.h"
 #include "resource_mgmt/cpu_scheduling.h"
 #include "resource_mgmt/memory_groups.h"
 #include "resource_mgmt/smp_groups.h"
 #include "rpc/server.h"
 #include "seastarx.h"
 #include "security/credential_store.h"
+#include "storage/background_controller.h"
 #include "storage/compaction_controller.h"
 #include "storage/fwd.h"
 
@@ -54,6 +57,7 @@ public:
       std::optional<YAML::Node> schema_reg_client_cfg = std::nullopt,
       std::optional<scheduling_groups> = std::nullopt);
     void check_environment();
+    void tune_disk();
     void configure_admin_server();
     void wire_up_services();
     void wire_up_redpanda_services();
@@ -86,6 +90,9 @@ public:
     ss::sharded<kafka::fetch_session_cache> fetch_session_cache;
     smp_groups smp_service_groups;
     ss::sharded<kafka::quota_manager> quota_mgr;
+    ss::sharded<kafka::connection_balancer> connection_balancer;
+    ss::sharded<scheduling_probe> sched_probe;
+    ss::sharded<memory_balancer> mem_balancer;
     ss::sharded<cluster::id_allocator_frontend> id_allocator_frontend;
     ss::sharded<archival::scheduler_service> archival_scheduler;
     ss::sharded<kafka::rm_group_frontend> rm_group_frontend;
@@ -143,6 +150,7 @@ private:
     ss::sharded<kafka::client::client> _schema_registry_client;
     pandaproxy::schema_registry::sharded_store _schema_registry_store;
     ss::sharded<pandaproxy::schema_registry::service> _schema_registry;
+    ss::sharded<storage::background_controller> _background_controller;
     ss::sharded<storage::compaction_controller> _compaction_controller;
 
     ss::metrics::metric_groups _metrics;
@@ -0,0 +1,231 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "redpanda/memory_balancer.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "resource_mgmt/memory_groups.h"
+#include "storage/chunk_cache.h"
+#include "vlog.h"
+
+#include <seastar/core/memory.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/util/log.hh>
+
+#include <algorithm>
+
+static ss::logger mlog{"memory_balancer"};
+
+const char* memory_balancer::name(budget b) {
+    switch (b) {
+    case budget::kafka:
+        return "kafka";
+    case budget::rpc:
+        return "rpc";
+    case budget::chunk_cache:
+        return "chunk_cache";
+    }
+    return "unknown";
+}
+
+std::vector<size_t>
+memory_balancer::plan(const std::vector<group>& groups, size_t step) {
+    std::vector<size_t> sizes;
+    sizes.reserve(groups.size());
+    for (const auto& g : groups) {
+        sizes.push_back(g.size);
+    }
+    // an idle group keeps its minimum and twice the memory it uses
+    auto slack = [&groups, &sizes](size_t i) -> size_t {
+        const auto& g = groups[i];
+        const auto keep = std::max(g.min, 2 * g.used);
+        return g.pressure || sizes[i] <= keep ? 0 : sizes[i] - keep;
+    };
+    // moves up to want bytes to the group, from the groups that can give
+    // the most first
+    auto move_to = [&sizes](size_t to, size_t want, auto&& can_give) {
+        while (want > 0) {
+            size_t from = sizes.size();
+            size_t most = 0;
+            for (size_t i = 0; i < sizes.size(); ++i) {
+                if (i != to && can_give(i) > most) {
+                    from = i;
+                    most = can_give(i);
+                }
+            }
+            if (from == sizes.size()) {
+                return;
+            }
+            const auto moved = std::min(want, most);
+            sizes[from] -= moved;
+            sizes[to] += moved;
+            want -= moved;
+        }
+    };
+
+    const bool pressure = std::any_of(
+      groups.begin(), groups.end(), [](const group& g) { return g.pressure; });
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const auto& g = groups[i];
+        if (pressure) {
+            if (g.pressure && sizes[i] < g.max) {
+                move_to(i, std::min(step, g.max - sizes[i]), slack);
+            }
+        } else if (sizes[i] < g.target) {
+            // back to the target, from the groups above theirs
+            move_to(
+              i,
+              std::min(step, g.target - sizes[i]),
+              [&groups, &sizes, &slack](size_t d) {
+                  const auto above = sizes[d] > groups[d].target
+                                       ? sizes[d] - groups[d].target
+                                       : 0;
+                  return std::min(slack(d), above);
+              });
+        }
+    }
+    return sizes;
+}
+
+memory_balancer::memory_balancer(
+  ss::sharded<rpc::server>& kafka,
+  ss::sharded<rpc::server>& rpc,
+  std::chrono::milliseconds interval)
+  : _kafka(kafka)
+  , _rpc(rpc)
+  , _interval(interval) {
+    _targets[static_cast<size_t>(budget::kafka)]
+      = memory_groups::kafka_total_memory();
+    _targets[static_cast<size_t>(budget::rpc)]
+      = memory_groups::rpc_total_memory();
+    _targets[static_cast<size_t>(budget::chunk_cache)]
+      = memory_groups::chunk_cache_max_memory();
+    _timer.set_callback([this] { balance(); });
+}
+
+ss::future<> memory_balancer::start() {
+    setup_metrics();
+    _kafka_blocked = _kafka.local().probe().requests_blocked_memory();
+    _rpc_blocked = _rpc.local().probe().requests_blocked_memory();
+    if (_interval != std::chrono::milliseconds::zero()) {
+        _timer.arm_periodic(_interval);
+    }
+    return ss::now();
+}
+
+ss::future<> memory_balancer::stop() {
+    _timer.cancel();
+    return ss::now();
+}
+
+std::array<memory_balancer::group, memory_balancer::budgets_count>
+memory_balancer::sample() {
+    std::array<group, budgets_count> groups;
+    for (size_t i = 0; i < budgets_count; ++i) {
+        groups[i].target = _targets[i];
+        groups[i].min = _targets[i] / 2;
+        groups[i].max = _targets[i] * 2;
+    }
+    auto server = [](group& g, rpc::server& s, uint32_t& blocked) {
+        auto& admission = s.admission();
+        const auto available = std::max<ssize_t>(
+          admission.memory().available_units(), 0);
+        g.size = admission.capacity();
+        g.used = g.size - std::min<size_t>(available, g.size);
+        const auto now_blocked = s.probe().requests_blocked_memory();
+        g.pressure = now_blocked != blocked || admission.waiters() > 0
+                     || admission.memory().waiters() > 0;
+        blocked = now_blocked;
+    };
+    server(
+      groups[static_cast<size_t>(budget::kafka)],
+      _kafka.local(),
+      _kafka_blocked);
+    server(
+      groups[static_cast<size_t>(budget::rpc)], _rpc.local(), _rpc_blocked);
+
+    const auto& chunks = storage::internal::chunks();
+    auto& c = groups[static_cast<size_t>(budget::chunk_cache)];
+    c.size = chunks.size_limit();
+    c.used = chunks.size_total();
+    c.pressure = chunks.waiters() > 0;
+    return groups;
+}
+
+void memory_balancer::resize(budget b, size_t size) {
+    switch (b) {
+    case budget::kafka:
+        _kafka.local().admission().resize(size);
+        return;
+    case budget::rpc:
+        _rpc.local().admission().resize(size);
+        return;
+    case budget::chunk_cache:
+        storage::internal::chunks().set_size_limit(size);
+        return;
+    }
+}
+
+void memory_balancer::balance() {
+    const auto groups = sample();
+    // a hundredth of the memory of the shard per round
+    const size_t step = ss::memory::stats().total_memory() / 100;
+    const auto sizes = plan({groups.begin(), groups.end()}, step);
+    for (size_t i = 0; i < budgets_count; ++i) {
+        if (sizes[i] == groups[i].size) {
+            continue;
+        }
+        vlog(
+          mlog.debug,
+          "{} memory: {} -> {} bytes (used: {}, pressure: {})",
+          name(static_cast<budget>(i)),
+          groups[i].size,
+          sizes[i],
+          groups[i].used,
+          groups[i].pressure);
+        if (sizes[i] > groups[i].size) {
+            _moved_bytes += sizes[i] - groups[i].size;
+        }
+        resize(static_cast<budget>(i), sizes[i]);
+    }
+}
+
+void memory_balancer::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    const auto budget_label = sm::label("budget");
+    std::vector<sm::metric_definition> defs;
+    for (size_t i = 0; i < budgets_count; ++i) {
+        const auto b = static_cast<budget>(i);
+        defs.push_back(sm::make_gauge(
+          "budget_bytes",
+          [this, b] {
+              switch (b) {
+              case budget::kafka:
+                  return _kafka.local().admission().capacity();
+              case budget::rpc:
+                  return _rpc.local().admission().capacity();
+              case budget::chunk_cache:
+                  return storage::internal::chunks().size_limit();
+              }
+              return size_t(0);
+          },
+          sm::description("Memory of the budget on the shard"),
+          {budget_label(name(b))}));
+    }
+    defs.push_back(sm::make_derive(
+      "moved_bytes",
+      [this] { return _moved_bytes; },
+      sm::description("Memory moved between the budgets of the shard")));
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("memory_balancer"), std::move(defs));
+}
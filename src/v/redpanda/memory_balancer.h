@@ -0,0 +1,101 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "rpc/server.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Moves memory between the budgets of the shard at runtime.
+ *
+ * memory_groups sizes the kafka request memory, the internal rpc request
+ * memory and the limit of the segment appender chunks as fixed fractions of
+ * the shard memory: a fetch heavy node leaves the rpc budget unused while
+ * its kafka requests wait for memory, a replication heavy node the other
+ * way around. Every interval the balancer moves a step of memory from an
+ * idle budget to a budget under pressure, a budget that some reservation
+ * waited for since the previous round. When no budget is under pressure the
+ * budgets move back towards their memory_groups size, their soft target.
+ *
+ * The sum of the budgets never changes, it stays within the global cap of
+ * the memory_groups sizes, and each budget stays between half and twice its
+ * target. The batch cache has no budget: it grows into the free memory and
+ * is reclaimed by seastar under pressure, request budgets kept low by an
+ * idle workload leave it more memory.
+ */
+class memory_balancer {
+public:
+    enum class budget : uint8_t {
+        kafka = 0,
+        rpc,
+        chunk_cache,
+    };
+    static constexpr size_t budgets_count = 3;
+
+    struct group {
+        size_t size{0};
+        size_t target{0};
+        size_t min{0};
+        size_t max{0};
+        /// memory reserved when the round started
+        size_t used{0};
+        /// a reservation waited for memory since the previous round
+        bool pressure{false};
+    };
+
+    static const char* name(budget);
+
+    /// \brief the sizes of the groups after a round moving at most step
+    /// bytes to each group, their sum is unchanged
+    static std::vector<size_t> plan(const std::vector<group>&, size_t step);
+
+    /// \brief balances every interval, 0 disables it
+    memory_balancer(
+      ss::sharded<rpc::server>& kafka,
+      ss::sharded<rpc::server>& rpc,
+      std::chrono::milliseconds interval);
+    memory_balancer(const memory_balancer&) = delete;
+    memory_balancer& operator=(const memory_balancer&) = delete;
+    memory_balancer(memory_balancer&&) = delete;
+    memory_balancer& operator=(memory_balancer&&) = delete;
+    ~memory_balancer() noexcept = default;
+
+    ss::future<> start();
+    ss::future<> stop();
+
+private:
+    void balance();
+    std::array<group, budgets_count> sample();
+    void resize(budget, size_t);
+    void setup_metrics();
+
+    ss::sharded<rpc::server>& _kafka;
+    ss::sharded<rpc::server>& _rpc;
+    std::chrono::milliseconds _interval;
+    std::array<size_t, budgets_count> _targets{};
+    // the blocked reservations counted by the servers at the last round
+    uint32_t _kafka_blocked{0};
+    uint32_t _rpc_blocked{0};
+    uint64_t _moved_bytes{0};
+    ss::timer<> _timer;
+    ss::metrics::metric_groups _metrics;
+};
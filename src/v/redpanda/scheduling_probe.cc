@@ -0,0 +1,155 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "redpanda/scheduling_probe.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+
+#include <seastar/core/do_with.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/core/with_scheduling_group.hh>
+
+#include <boost/range/irange.hpp>
+
+scheduling_probe::scheduling_probe(
+  std::vector<ss::scheduling_group> groups, std::chrono::milliseconds interval)
+  : _interval(interval) {
+    _groups.reserve(groups.size());
+    for (auto sg : groups) {
+        _groups.push_back(group{.sg = sg});
+    }
+    _timer.set_callback([this] { probe(); });
+}
+
+ss::future<> scheduling_probe::start() {
+    _local = this;
+    setup_metrics();
+    // runs in the signal handler of the stall detector: counts and calls the
+    // report of seastar, which logs the backtrace
+    _stall_report = ss::engine().get_stall_detector_report_function();
+    ss::engine().set_stall_detector_report_function([this] {
+        on_stall();
+        if (_stall_report) {
+            _stall_report();
+        }
+    });
+    if (_interval != std::chrono::milliseconds::zero()) {
+        _timer.arm_periodic(_interval);
+    }
+    return ss::now();
+}
+
+ss::future<> scheduling_probe::stop() {
+    _timer.cancel();
+    ss::engine().set_stall_detector_report_function(_stall_report);
+    _local = nullptr;
+    return _gate.close();
+}
+
+void scheduling_probe::probe() {
+    for (auto& g : _groups) {
+        // a group waiting for longer than the interval has one probe queued
+        if (g.probing) {
+            continue;
+        }
+        g.probing = true;
+        (void)ss::with_gate(_gate, [&g] {
+            const auto queued = ss::steady_clock_type::now();
+            return ss::with_scheduling_group(g.sg, [&g, queued] {
+                const auto delay = ss::steady_clock_type::now() - queued;
+                g.queue_delay.record(
+                  std::chrono::duration_cast<std::chrono::microseconds>(delay)
+                    .count());
+                g.probing = false;
+            });
+        });
+    }
+}
+
+void scheduling_probe::on_stall() {
+    const auto current = ss::current_scheduling_group();
+    for (auto& g : _groups) {
+        if (g.sg == current) {
+            ++g.stalls;
+            return;
+        }
+    }
+    ++_other_stalls;
+}
+
+void scheduling_probe::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    const auto group_label = sm::label("group");
+    std::vector<sm::metric_definition> defs;
+    for (auto& g : _groups) {
+        const std::vector<sm::label_instance> labels{
+          group_label(g.sg.name())};
+        defs.push_back(sm::make_histogram(
+          "queue_delay_us",
+          [&g] { return g.queue_delay.seastar_histogram_logform(); },
+          sm::description("Delay until a task submitted to the scheduling "
+                          "group runs, in microseconds"),
+          labels));
+        defs.push_back(sm::make_derive(
+          "stalls",
+          [&g] { return g.stalls; },
+          sm::description("Number of reactor stalls of the tasks of the "
+                          "scheduling group"),
+          labels));
+    }
+    defs.push_back(sm::make_derive(
+      "stalls",
+      [this] { return _other_stalls; },
+      sm::description("Number of reactor stalls of the tasks of the "
+                      "scheduling group"),
+      {group_label("other")}));
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("scheduling"), std::move(defs));
+}
+
+ss::future<std::vector<scheduling_probe::group_summary>>
+scheduling_probe::merge() {
+    std::vector<group_summary> ret;
+    if (!_local) {
+        return ss::make_ready_future<std::vector<group_summary>>(
+          std::move(ret));
+    }
+    for (const auto& g : _local->_groups) {
+        ret.push_back(group_summary{.name = g.sg.name()});
+    }
+    ret.push_back(group_summary{.name = "other"});
+    return ss::do_with(std::move(ret), [](std::vector<group_summary>& ret) {
+        // one shard at a time: the shards add to the histograms of the
+        // caller, adding doesn't allocate
+        return ss::do_for_each(
+                 boost::irange<ss::shard_id>(0, ss::smp::count),
+                 [&ret](ss::shard_id shard) {
+                     return ss::smp::submit_to(shard, [&ret] {
+                         const auto* local = _local;
+                         if (!local) {
+                             return;
+                         }
+                         const auto& groups = local->_groups;
+                         for (size_t i = 0; i < groups.size(); ++i) {
+                             ret[i].queue_delay += groups[i].queue_delay;
+                             ret[i].stalls += groups[i].stalls;
+                         }
+                         ret.back().stalls += local->_other_stalls;
+                     });
+                 })
+          .then([&ret] { return std::move(ret); });
+    });
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/timer.hh>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Queueing delay and stalls of the scheduling groups of the shard.
+ *
+ * Every interval a no-op task is submitted to each group, the time until it
+ * runs is the delay a task of the group waits behind the other groups and
+ * the earlier tasks of its own: a kafka group starved by compaction shows
+ * up as the delay of the kafka group. Seastar already reports the runtime,
+ * the wait and the starve times of the groups, as the scheduler metrics.
+ *
+ * The reactor stalls are attributed to the group of the task that stalled,
+ * from the stall detector report, and the backtraces are still logged by
+ * the report of seastar.
+ */
+class scheduling_probe {
+public:
+    struct group_summary {
+        ss::sstring name;
+        /// microseconds
+        hdr_hist queue_delay;
+        uint64_t stalls{0};
+    };
+
+    /// \brief probes the groups every interval, 0 only counts the stalls
+    scheduling_probe(
+      std::vector<ss::scheduling_group>, std::chrono::milliseconds interval);
+    scheduling_probe(const scheduling_probe&) = delete;
+    scheduling_probe& operator=(const scheduling_probe&) = delete;
+    scheduling_probe(scheduling_probe&&) = delete;
+    scheduling_probe& operator=(scheduling_probe&&) = delete;
+    ~scheduling_probe() noexcept = default;
+
+    ss::future<> start();
+    ss::future<> stop();
+
+    /// \brief the probes of all the shards summed per group, empty when the
+    /// probe isn't running
+    static ss::future<std::vector<group_summary>> merge();
+
+private:
+    struct group {
+        ss::scheduling_group sg;
+        hdr_hist queue_delay;
+        uint64_t stalls{0};
+        bool probing{false};
+    };
+
+    void probe();
+    void on_stall();
+    void setup_metrics();
+
+    std::vector<group> _groups;
+    uint64_t _other_stalls{0};
+    std::chrono::milliseconds _interval;
+    std::function<void()> _stall_report;
+    ss::timer<> _timer;
+    ss::gate _gate;
+    ss::metrics::metric_groups _metrics;
+
+    // the probe of the shard, for the stall report and merge()
+    static inline thread_local scheduling_probe* _local = nullptr;
+};
@@ -88,12 +88,14 @@ public:
           app.partition_manager,
           app.coordinator_ntp_mapper,
           app.fetch_session_cache,
+          app.connection_balancer,
           app.id_allocator_frontend,
           app.controller->get_credential_store(),
           app.controller->get_authorizer(),
           app.controller->get_security_frontend(),
           app.controller->get_api(),
           app.tx_gateway_frontend,
+          app.archival_scheduler,
           std::nullopt);
     }
 
@@ -112,6 +114,9 @@ public:
         true) {}
 
     ~redpanda_thread_fixture() {
+        // the protocol is subscribed to the notifications of the application
+        // services
+        proto.reset();
         app.shutdown();
         if (remove_on_shutdown) {
             std::filesystem::remove_all(data_dir);
@@ -17,6 +17,8 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/scheduling.hh>
 
+#include <vector>
+
 // manage cpu scheduling groups. scheduling groups are global, so one instance
 // of this class can be created at the top level and passed down into any server
 // and any shard that needs to schedule continuations into a given group.
@@ -34,6 +36,8 @@ public:
           "log_compaction", 100);
         _raft_learner_recovery = co_await ss::create_scheduling_group(
           "raft_learner_recovery", 50);
+        _compression = co_await ss::create_scheduling_group(
+          "compression", 100);
     }
 
     ss::future<> destroy_groups() {
@@ -45,6 +49,7 @@ public:
         co_await destroy_scheduling_group(_cache_background_reclaim);
         co_await destroy_scheduling_group(_compaction);
         co_await destroy_scheduling_group(_raft_learner_recovery);
+        co_await destroy_scheduling_group(_compression);
         co_return;
     }
 
@@ -60,6 +65,20 @@ public:
     ss::scheduling_group raft_learner_recovery_sg() {
         return _raft_learner_recovery;
     }
+    ss::scheduling_group compression_sg() { return _compression; }
+
+    std::vector<ss::scheduling_group> all_scheduling_groups() const {
+        return {
+          _admin,
+          _raft,
+          _kafka,
+          _cluster,
+          _coproc,
+          _cache_background_reclaim,
+          _compaction,
+          _raft_learner_recovery,
+          _compression};
+    }
 
 private:
     ss::scheduling_group _admin;
@@ -70,4 +89,5 @@ private:
     ss::scheduling_group _cache_background_reclaim;
     ss::scheduling_group _compaction;
     ss::scheduling_group _raft_learner_recovery;
+    ss::scheduling_group _compression;
 };
@@ -26,6 +26,7 @@ public:
     ss::io_priority_class raft_learner_recovery_priority() {
         return _raft_learner_recovery_priority;
     }
+    ss::io_priority_class archival_priority() { return _archival_priority; }
 
     static priority_manager& local() {
         static thread_local priority_manager pm = priority_manager();
@@ -43,13 +44,16 @@ private:
           ss::engine().register_one_priority_class("compaction", 200))
       , _raft_learner_recovery_priority(
           ss::engine().register_one_priority_class(
-            "raft-learner-recovery", 100)) {}
+            "raft-learner-recovery", 100))
+      , _archival_priority(
+          ss::engine().register_one_priority_class("archival", 100)) {}
 
     ss::io_priority_class _raft_priority;
     ss::io_priority_class _controller_priority;
     ss::io_priority_class _kafka_read_priority;
     ss::io_priority_class _compaction_priority;
     ss::io_priority_class _raft_learner_recovery_priority;
+    ss::io_priority_class _archival_priority;
 };
 
 inline ss::io_priority_class raft_priority() {
@@ -71,3 +75,7 @@ inline ss::io_priority_class compaction_priority() {
 inline ss::io_priority_class raft_learner_recovery_priority() {
     return priority_manager::local().raft_learner_recovery_priority();
 }
+
+inline ss::io_priority_class archival_priority() {
+    return priority_manager::local().archival_priority();
+}
@@ -18,10 +18,19 @@
 
 namespace rpc {
 batched_output_stream::batched_output_stream(
-  ss::output_stream<char> o, size_t cache)
+  ss::output_stream<char> o,
+  size_t cache,
+  std::optional<std::chrono::microseconds> cork_delay)
   : _out(std::move(o))
   , _cache_size(cache)
-  , _write_sem(std::make_unique<ss::semaphore>(1)) {}
+  , _write_sem(std::make_unique<ss::semaphore>(1))
+  , _cork_delay(cork_delay) {
+    if (_cork_delay) {
+        _cork_timer = std::make_unique<ss::timer<>>(
+          [this] { flush_corked(); });
+        _cork_gate = std::make_unique<ss::gate>();
+    }
+}
 
 [[gnu::cold]] static ss::future<>
 already_closed_error(ss::scattered_message<char>& msg) {
@@ -34,6 +43,9 @@ ss::future<> batched_output_stream::write(ss::scattered_message<char> msg) {
     if (unlikely(_closed)) {
         return already_closed_error(msg);
     }
+    if (unlikely(_cork_error)) {
+        return ss::make_exception_future<>(_cork_error);
+    }
     return ss::with_semaphore(
       *_write_sem, 1, [this, v = std::move(msg)]() mutable {
           if (unlikely(_closed)) {
@@ -42,11 +54,20 @@ ss::future<> batched_output_stream::write(ss::scattered_message<char> msg) {
           const size_t vbytes = v.size();
           return _out.write(std::move(v)).then([this, vbytes] {
               _unflushed_bytes += vbytes;
-              if (
-                _write_sem->waiters() == 0 || _unflushed_bytes >= _cache_size) {
+              if (_unflushed_bytes >= _cache_size) {
                   return do_flush();
               }
-              return ss::make_ready_future<>();
+              if (_write_sem->waiters() > 0) {
+                  // the last of the waiting writers flushes
+                  return ss::make_ready_future<>();
+              }
+              if (_cork_timer) {
+                  if (!_cork_timer->armed()) {
+                      _cork_timer->arm(*_cork_delay);
+                  }
+                  return ss::make_ready_future<>();
+              }
+              return do_flush();
           });
       });
 }
@@ -54,9 +75,25 @@ ss::future<> batched_output_stream::do_flush() {
     if (_unflushed_bytes == 0) {
         return ss::make_ready_future<>();
     }
+    if (_cork_timer) {
+        _cork_timer->cancel();
+    }
+    if (_flush_observer) {
+        _flush_observer(_unflushed_bytes);
+    }
     _unflushed_bytes = 0;
     return _out.flush();
 }
+void batched_output_stream::flush_corked() {
+    if (_closed) {
+        return;
+    }
+    (void)ss::with_gate(*_cork_gate, [this] {
+        return flush().handle_exception([this](std::exception_ptr e) {
+            _cork_error = std::move(e);
+        });
+    });
+}
 ss::future<> batched_output_stream::flush() {
     return ss::with_semaphore(*_write_sem, 1, [this] { return do_flush(); });
 }
@@ -65,8 +102,15 @@ ss::future<> batched_output_stream::stop() {
         return ss::make_ready_future<>();
     }
     _closed = true;
-    return ss::with_semaphore(*_write_sem, 1, [this] {
-        return do_flush().then([this] { return _out.close(); });
+    auto f = ss::now();
+    if (_cork_timer) {
+        _cork_timer->cancel();
+        f = _cork_gate->close();
+    }
+    return f.then([this] {
+        return ss::with_semaphore(*_write_sem, 1, [this] {
+            return do_flush().then([this] { return _out.close(); });
+        });
     });
 }
 
@@ -13,21 +13,40 @@
 
 #include "seastarx.h"
 
+#include <seastar/core/gate.hh>
 #include <seastar/core/iostream.hh>
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/util/noncopyable_function.hh>
 
+#include <chrono>
 #include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
 
 namespace rpc {
 
 /// \brief batch operations for zero copy interface of an output_stream<char>
+///
+/// Writes are flushed as soon as there are no other writes waiting. With
+/// corking enabled, the flush of an idle stream is instead deferred by the
+/// cork delay, the writes issued in the meantime, i.e. the responses of all
+/// the requests processed in the same reactor poll, are sent with a single
+/// vectored write. The stream is flushed right away when the unflushed bytes
+/// exceed the cache size.
 class batched_output_stream {
 public:
     static constexpr size_t default_max_unflushed_bytes = 1024 * 1024;
 
+    /// called with the number of bytes sent by every flush
+    using flush_observer = ss::noncopyable_function<void(size_t)>;
+
     batched_output_stream() = default;
     explicit batched_output_stream(
-      ss::output_stream<char>, size_t cache = default_max_unflushed_bytes);
+      ss::output_stream<char>,
+      size_t cache = default_max_unflushed_bytes,
+      std::optional<std::chrono::microseconds> cork_delay = std::nullopt);
     ~batched_output_stream() noexcept = default;
     // NOTE: explicitly defined for a gcc
     batched_output_stream(batched_output_stream&& o) noexcept
@@ -35,7 +54,16 @@ public:
       , _cache_size(o._cache_size)
       , _write_sem(std::move(o._write_sem))
       , _unflushed_bytes(o._unflushed_bytes)
-      , _closed(o._closed) {}
+      , _closed(o._closed)
+      , _cork_delay(o._cork_delay)
+      , _cork_timer(std::move(o._cork_timer))
+      , _cork_gate(std::move(o._cork_gate))
+      , _cork_error(std::move(o._cork_error))
+      , _flush_observer(std::move(o._flush_observer)) {
+        if (_cork_timer) {
+            _cork_timer->set_callback([this] { flush_corked(); });
+        }
+    }
     batched_output_stream& operator=(batched_output_stream&& o) noexcept {
         if (this != &o) {
             this->~batched_output_stream();
@@ -49,17 +77,30 @@ public:
     ss::future<> write(ss::scattered_message<char> msg);
     ss::future<> flush();
 
+    void set_flush_observer(flush_observer o) {
+        _flush_observer = std::move(o);
+    }
+
     /// \brief calls output_stream<char>::close()
     /// do not use `_fd.shutdown_output();` on connected_sockets
     ss::future<> stop();
 
 private:
     ss::future<> do_flush();
+    void flush_corked();
 
     ss::output_stream<char> _out;
     size_t _cache_size{0};
     std::unique_ptr<ss::semaphore> _write_sem;
     size_t _unflushed_bytes{0};
     bool _closed = false;
+    std::optional<std::chrono::microseconds> _cork_delay;
+    // the timer and the gate are not movable, they are heap allocated like
+    // the semaphore
+    std::unique_ptr<ss::timer<>> _cork_timer;
+    std::unique_ptr<ss::gate> _cork_gate;
+    // failure of a deferred flush, returned by the following writes
+    std::exception_ptr _cork_error;
+    flush_observer _flush_observer;
 };
 } // namespace rpc
@@ -15,7 +15,9 @@
 
 #include <seastar/core/metrics_registration.hh>
 
+#include <chrono>
 #include <iosfwd>
+#include <optional>
 
 namespace rpc {
 class client_probe {
@@ -44,6 +46,19 @@ public:
 
     void add_bytes_received(size_t recv) { _in_bytes += recv; }
 
+    void add_flush(size_t bytes) {
+        ++_flushes;
+        _flushed_bytes += bytes;
+    }
+
+    void add_compression(
+      size_t uncompressed, size_t compressed, std::chrono::microseconds took) {
+        ++_compressed_requests;
+        _compression_in_bytes += uncompressed;
+        _compression_out_bytes += compressed;
+        _compression_time_us += took.count();
+    }
+
     void connection_established() {
         ++_connects;
         ++_connections;
@@ -72,7 +87,8 @@ public:
     void setup_metrics(
       ss::metrics::metric_groups& mgs,
       const std::optional<ss::sstring>& service_name,
-      const unresolved_address& target_addr);
+      const unresolved_address& target_addr,
+      std::optional<uint16_t> connection_index = std::nullopt);
 
 private:
     uint64_t _requests = 0;
@@ -82,6 +98,8 @@ private:
     uint64_t _requests_completed = 0;
     uint64_t _in_bytes = 0;
     uint64_t _out_bytes = 0;
+    uint64_t _flushes = 0;
+    uint64_t _flushed_bytes = 0;
     uint64_t _connects = 0;
     uint32_t _connections = 0;
     uint32_t _connection_errors = 0;
@@ -90,6 +108,10 @@ private:
     uint32_t _server_correlation_errors = 0;
     uint32_t _client_correlation_errors = 0;
     uint32_t _requests_blocked_memory = 0;
+    uint64_t _compressed_requests = 0;
+    uint64_t _compression_in_bytes = 0;
+    uint64_t _compression_out_bytes = 0;
+    uint64_t _compression_time_us = 0;
     ss::metrics::metric_groups _metrics;
 
     friend std::ostream& operator<<(std::ostream& o, const client_probe& p);
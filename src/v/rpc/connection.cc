@@ -17,14 +17,19 @@ connection::connection(
   ss::sstring name,
   ss::connected_socket f,
   ss::socket_address a,
-  server_probe& p)
+  server_probe& p,
+  std::optional<std::chrono::microseconds> cork_delay)
   : addr(std::move(a))
   , _hook(hook)
   , _name(std::move(name))
   , _fd(std::move(f))
   , _in(_fd.input())
-  , _out(_fd.output())
+  , _out(
+      _fd.output(),
+      batched_output_stream::default_max_unflushed_bytes,
+      cork_delay)
   , _probe(p) {
+    _out.set_flush_observer([&p](size_t bytes) { p.add_flush(bytes); });
     _hook.push_back(*this);
     _probe.connection_established();
 }
@@ -30,7 +30,8 @@ public:
       ss::sstring name,
       ss::connected_socket f,
       ss::socket_address a,
-      server_probe& p);
+      server_probe& p,
+      std::optional<std::chrono::microseconds> cork_delay = std::nullopt);
     ~connection() noexcept;
     connection(const connection&) = delete;
     connection& operator=(const connection&) = delete;
@@ -30,28 +30,35 @@ ss::future<> connection_cache::emplace(
         if (_cache.find(n) != _cache.end()) {
             return;
         }
-        _cache.emplace(
-          n,
-          ss::make_lw_shared<rpc::reconnect_transport>(
-            std::move(c), std::move(backoff_policy)));
+        transports t;
+        t.reserve(_connections_per_node);
+        for (size_t i = 0; i < _connections_per_node; ++i) {
+            auto cfg = c;
+            if (_connections_per_node > 1) {
+                cfg.connection_index = static_cast<uint16_t>(i);
+            }
+            t.push_back(ss::make_lw_shared<rpc::reconnect_transport>(
+              std::move(cfg), backoff_policy.clone()));
+        }
+        _cache.emplace(n, std::move(t));
     });
 }
 ss::future<> connection_cache::remove(model::node_id n) {
     return _mutex
-      .with([this, n]() -> transport_ptr {
+      .with([this, n]() -> transports {
           auto it = _cache.find(n);
           if (it == _cache.end()) {
-              return nullptr;
+              return {};
           }
-          auto ptr = it->second;
+          auto t = std::move(it->second);
           _cache.erase(it);
-          return ptr;
+          return t;
       })
-      .then([](transport_ptr ptr) {
-          if (!ptr) {
-              return ss::now();
-          }
-          return ptr->stop().finally([ptr] {});
+      .then([](transports t) {
+          return ss::do_with(std::move(t), [](transports& t) {
+              return ss::parallel_for_each(
+                t, [](transport_ptr& ptr) { return ptr->stop(); });
+          });
       });
 }
 
@@ -59,8 +66,9 @@ ss::future<> connection_cache::remove(model::node_id n) {
 ss::future<> connection_cache::stop() {
     return _mutex.with([this]() {
         return parallel_for_each(_cache, [](auto& it) {
-            auto& [_, cli] = it;
-            return cli->stop();
+            auto& [_, t] = it;
+            return parallel_for_each(
+              t, [](transport_ptr& cli) { return cli->stop(); });
         });
         _cache.clear();
         // mark mutex as broken to prevent new connections from being created
@@ -24,15 +24,31 @@
 #include <seastar/core/sharded.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <algorithm>
 #include <chrono>
 #include <unordered_map>
+#include <vector>
 
 namespace rpc {
+/**
+ * Client connections to the other nodes of the cluster.
+ *
+ * Each peer node is owned by a single shard, picked with `shard_for`, that
+ * holds the connections to it. A single connection serializes all of the
+ * requests to the node in one TCP stream, a large recovery transfer delays
+ * the heartbeats and small appends sent after it. The cache can keep several
+ * connections per node instead, the requests are spread over them by their
+ * connection_class: the first connection carries the control requests, the
+ * last one the bulk transfers and the data flows are striped over the
+ * connections in between, each flow sticking to one of them to preserve the
+ * order of its requests.
+ */
 class connection_cache final
   : public ss::peering_sharded_service<connection_cache> {
 public:
     using transport_ptr = ss::lw_shared_ptr<rpc::reconnect_transport>;
-    using underlying = std::unordered_map<model::node_id, transport_ptr>;
+    using transports = std::vector<transport_ptr>;
+    using underlying = std::unordered_map<model::node_id, transports>;
     using iterator = typename underlying::iterator;
 
     static inline ss::shard_id shard_for(
@@ -41,11 +57,28 @@ public:
       model::node_id node,
       ss::shard_id max_shards = ss::smp::count);
 
-    connection_cache() = default;
+    /// Index of the connection, out of `connections` to the same node, that
+    /// the requests of the class are sent over
+    static inline size_t
+    connection_for(connection_class, uint64_t flow, size_t connections);
+
+    explicit connection_cache(size_t connections_per_node = 1)
+      : _connections_per_node(std::max<size_t>(connections_per_node, 1)) {}
+
     bool contains(model::node_id n) const {
         return _cache.find(n) != _cache.end();
     }
-    transport_ptr get(model::node_id n) const { return _cache.find(n)->second; }
+    /// the first connection to the node
+    transport_ptr get(model::node_id n) const {
+        return _cache.find(n)->second.front();
+    }
+    transport_ptr
+    get(model::node_id n, connection_class c, uint64_t flow) const {
+        const auto& t = _cache.find(n)->second;
+        return t[connection_for(c, flow, t.size())];
+    }
+
+    size_t connections_per_node() const { return _connections_per_node; }
 
     /// \brief needs to be a future, because mutations may come from different
     /// fibers and they need to be synchronized
@@ -68,6 +101,8 @@ public:
         model::node_id self,
         ss::shard_id src_shard,
         model::node_id node_id,
+        connection_class conn_class,
+        uint64_t flow,
         clock_type::time_point connection_timeout,
         Func&& f) {
         using ret_t = result_wrap_t<std::invoke_result_t<Func, Protocol>>;
@@ -75,14 +110,17 @@ public:
 
         return container().invoke_on(
           shard,
-          [node_id, f = std::forward<Func>(f), connection_timeout](
-            rpc::connection_cache& cache) mutable {
+          [node_id,
+           conn_class,
+           flow,
+           f = std::forward<Func>(f),
+           connection_timeout](rpc::connection_cache& cache) mutable {
               if (!cache.contains(node_id)) {
                   // No client available
                   return ss::futurize<ret_t>::convert(
                     rpc::make_error_code(errc::missing_node_rpc_client));
               }
-              return cache.get(node_id)
+              return cache.get(node_id, conn_class, flow)
                 ->get_connected(connection_timeout)
                 .then([f = std::forward<Func>(f)](
                         result<rpc::transport*> transport) mutable {
@@ -96,6 +134,52 @@ public:
           });
     }
 
+    template<typename Protocol, typename Func>
+    // clang-format off
+    CONCEPT(requires requires(Func&& f, Protocol proto) {
+        f(proto);
+    })
+      // clang-format on
+      auto with_node_client(
+        model::node_id self,
+        ss::shard_id src_shard,
+        model::node_id node_id,
+        connection_class conn_class,
+        uint64_t flow,
+        clock_type::duration connection_timeout,
+        Func&& f) {
+        return with_node_client<Protocol, Func>(
+          self,
+          src_shard,
+          node_id,
+          conn_class,
+          flow,
+          connection_timeout + clock_type::now(),
+          std::forward<Func>(f));
+    }
+
+    template<typename Protocol, typename Func>
+    // clang-format off
+    CONCEPT(requires requires(Func&& f, Protocol proto) {
+        f(proto);
+    })
+      // clang-format on
+      auto with_node_client(
+        model::node_id self,
+        ss::shard_id src_shard,
+        model::node_id node_id,
+        clock_type::time_point connection_timeout,
+        Func&& f) {
+        return with_node_client<Protocol, Func>(
+          self,
+          src_shard,
+          node_id,
+          connection_class::data,
+          0,
+          connection_timeout,
+          std::forward<Func>(f));
+    }
+
     template<typename Protocol, typename Func>
     // clang-format off
     CONCEPT(requires requires(Func&& f, Protocol proto) {
@@ -117,6 +201,7 @@ public:
     }
 
 private:
+    size_t _connections_per_node;
     mutex _mutex; // to add/remove nodes
     underlying _cache;
 };
@@ -149,4 +234,16 @@ inline ss::shard_id connection_cache::shard_for(
     return jump_consistent_hash(h, total_shards);
 }
 
+inline size_t connection_cache::connection_for(
+  connection_class c, uint64_t flow, size_t connections) {
+    if (connections <= 1 || c == connection_class::control) {
+        return 0;
+    }
+    // with two connections the data flows share the bulk one
+    if (c == connection_class::bulk || connections == 2) {
+        return connections - 1;
+    }
+    return 1 + jump_consistent_hash(flow, connections - 2);
+}
+
 } // namespace rpc
@@ -46,7 +46,14 @@ void cli_opts(boost::program_options::options_description_easy_init o) {
       "number of TCP connections per core");
     o("test-case",
       po::value<std::size_t>()->default_value(1),
-      "1: large payload, 2: complex struct, 3: interspersed");
+      "1: large payload, 2: complex struct, 3: interspersed, 4: heartbeats, "
+      "5: serde heartbeats, 6: append entries");
+    o("groups",
+      po::value<std::size_t>()->default_value(1000),
+      "number of raft groups per heartbeat request");
+    o("compression",
+      po::value<std::string>()->default_value("none"),
+      "compression of the request payloads: none or zstd");
     o("ca-cert",
       po::value<std::string>()->default_value(""),
       "CA root certificate");
@@ -71,6 +78,8 @@ struct load_gen_cfg {
     std::size_t concurrency;
     std::size_t parallelism;
     std::size_t test_case;
+    std::size_t groups;
+    rpc::compression_type compression;
     rpc::transport_configuration client_cfg;
     ss::sharded<hdr_hist>* hist;
 };
@@ -82,6 +91,8 @@ inline std::ostream& operator<<(std::ostream& o, const load_gen_cfg& cfg) {
              << ", 'concurrency':" << cfg.concurrency
              << ", 'parallelism':" << cfg.parallelism
              << ", 'test_case':" << cfg.test_case
+             << ", 'groups':" << cfg.groups
+             << ", 'compression':" << static_cast<int>(cfg.compression)
              << ", 'max_queued_bytes_per_tcp':"
              << cfg.client_cfg.max_queued_bytes
              << ", 'global_test_1_data_size':" << cfg.global_size_test1()
@@ -128,44 +139,61 @@ public:
     }
 
 private:
+    rpc::client_opts opts() const {
+        return rpc::client_opts(rpc::no_timeout, _cfg.compression, 1024);
+    }
+
+    template<typename Func>
+    ss::future<> measure(size_t bytes, Func&& f) {
+        return get_units(_mem, bytes).then(
+          [this, f = std::forward<Func>(f)](ss::semaphore_units<> u) mutable {
+              return f().then([m = _cfg.hist->local().auto_measure(),
+                               u = std::move(u)](auto) {});
+          });
+    }
+
     ss::future<> execute_one(cli* const c) {
-        if (_cfg.test_case < 1 && _cfg.test_case > 3) {
-            throw std::runtime_error(fmt::format(
-              "Unknown test:{}, bad config:{}", _cfg.test_case, _cfg));
-        }
-        if (_cfg.test_case == 1) {
-            return get_units(_mem, _cfg.data_size)
-              .then([this, c](ss::semaphore_units<> u) {
-                  return c
-                    ->put(
-                      demo::gen_simple_request(_cfg.data_size, _cfg.chunk_size),
-                      rpc::client_opts(rpc::no_timeout))
-                    .then([m = _cfg.hist->local().auto_measure(),
-                           u = std::move(u)](auto _) {});
+        switch (_cfg.test_case) {
+        case 1:
+            return measure(_cfg.data_size, [this, c] {
+                return c->put(
+                  demo::gen_simple_request(_cfg.data_size, _cfg.chunk_size),
+                  opts());
+            });
+        case 2:
+            return measure(sizeof(demo::complex_request), [this, c] {
+                return c->put_complex(demo::complex_request{}, opts());
+            });
+        case 3:
+            return measure(_cfg.data_size, [this, c] {
+                return c->put_interspersed(
+                  demo::gen_interspersed_request(
+                    _cfg.data_size, _cfg.chunk_size),
+                  opts());
+            });
+        case 4:
+            return measure(
+              _cfg.groups * sizeof(demo::heartbeat_meta), [this, c] {
+                  return c->heartbeat(
+                    demo::gen_heartbeat_request(_cfg.groups), opts());
               });
-        } else if (_cfg.test_case == 2) {
-            return get_units(_mem, sizeof(demo::complex_request{}))
-              .then([this, &c](ss::semaphore_units<> u) {
-                  return c
-                    ->put_complex(
-                      demo::complex_request{},
-                      rpc::client_opts(rpc::no_timeout))
-                    .then([m = _cfg.hist->local().auto_measure(),
-                           u = std::move(u)](auto _) {});
-              });
-        } else if (_cfg.test_case == 3) {
-            return get_units(_mem, _cfg.data_size)
-              .then([this, &c](ss::semaphore_units<> u) {
-                  auto r = demo::gen_interspersed_request(
-                    _cfg.data_size, _cfg.chunk_size);
-                  return c
-                    ->put_interspersed(
-                      std::move(r), rpc::client_opts(rpc::no_timeout))
-                    .then([m = _cfg.hist->local().auto_measure(),
-                           u = std::move(u)](auto _) {});
+        case 5:
+            return measure(
+              _cfg.groups * sizeof(demo::heartbeat_meta), [this, c] {
+                  return c->heartbeat_serde(
+                    demo::gen_heartbeat_serde_request(_cfg.groups), opts());
               });
+        case 6:
+            return measure(_cfg.data_size, [this, c] {
+                return c->append_entries(
+                  demo::gen_append_entries_request(
+                    _cfg.data_size, _cfg.chunk_size),
+                  opts());
+            });
+        default:
+            throw std::runtime_error(fmt::format(
+              "Unknown test:{}, bad config:{}", _cfg.test_case, _cfg));
         }
-        __builtin_unreachable();
     }
 
     load_gen_cfg _cfg;
@@ -190,12 +218,20 @@ cfg_from(boost::program_options::variables_map& m, ss::sharded<hdr_hist>* h) {
           = builder.build_reloadable_certificate_credentials().get0();
     }
     client_cfg.max_queued_bytes = ss::memory::stats().total_memory() * .8;
+    auto compression = m["compression"].as<std::string>();
+    if (compression != "none" && compression != "zstd") {
+        throw std::invalid_argument(
+          fmt::format("Unknown compression: {}", compression));
+    }
     return load_gen_cfg{
       .data_size = m["data-size"].as<std::size_t>(),
       .chunk_size = m["chunk-size"].as<std::size_t>(),
       .concurrency = m["concurrency"].as<std::size_t>(),
       .parallelism = m["parallelism"].as<std::size_t>(),
       .test_case = m["test-case"].as<std::size_t>(),
+      .groups = m["groups"].as<std::size_t>(),
+      .compression = compression == "zstd" ? rpc::compression_type::zstd
+                                           : rpc::compression_type::none,
       .client_cfg = std::move(client_cfg),
       .hist = h};
 }
@@ -244,16 +280,34 @@ inline hdr_hist aggregate_in_thread(ss::sharded<hdr_hist>& h) {
     return retval;
 }
 
+struct latency {
+    explicit latency(const hdr_hist& h)
+      : p50(h.get_value_at(50.0))
+      , p99(h.get_value_at(99.0))
+      , p999(h.get_value_at(99.9))
+      , mean(h.mean()) {}
+
+    int64_t p50;
+    int64_t p99;
+    int64_t p999;
+    double mean;
+};
+
+inline std::ostream& operator<<(std::ostream& o, const latency& l) {
+    return o << "{'p50_us':" << l.p50 << ", 'p99_us':" << l.p99
+             << ", 'p999_us':" << l.p999 << ", 'mean_us':" << l.mean << "}";
+}
+
 void write_configuration_in_thread(
-  const throughput& tp, const load_gen_cfg& cfg) {
+  const throughput& tp, const latency& lat, const load_gen_cfg& cfg) {
     std::ostringstream to;
-    to << "{'throughput':" << tp << ", 'config':" << cfg << "}";
+    to << "{'throughput':" << tp << ", 'latency':" << lat
+       << ", 'config':" << cfg << "}";
     const ss::sstring s = to.str();
     force_write_ptr("test_config.json", s.data(), s.size()).get();
 }
 
-void write_latency_in_thread(ss::sharded<hdr_hist>& hist) {
-    auto h = aggregate_in_thread(hist);
+void write_latency_in_thread(const hdr_hist& h) {
     write_histogram("clients.hdr", h).get();
 }
 
@@ -282,9 +336,12 @@ int main(int args, char** argv, char** env) {
             client.invoke_on_all(&client_loadgen::execute_loadgen).get();
             tp.stop();
             vlog(lgr.info, "{}", tp);
+            auto h = aggregate_in_thread(hist);
+            auto lat = latency(h);
+            vlog(lgr.info, "{}", lat);
             vlog(lgr.info, "writing results");
-            write_configuration_in_thread(tp, lcfg);
-            write_latency_in_thread(hist);
+            write_configuration_in_thread(tp, lat, lcfg);
+            write_latency_in_thread(h);
             vlog(lgr.info, "stopping");
         });
     });
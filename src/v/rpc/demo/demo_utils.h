@@ -18,6 +18,9 @@
 #include <seastar/core/fstream.hh>
 #include <seastar/core/reactor.hh>
 
+#include <algorithm>
+#include <string_view>
+
 inline ss::future<>
 force_write_ptr(ss::sstring filename, const char* ptr, std::size_t len) {
     auto flags = ss::open_flags::rw | ss::open_flags::create
@@ -79,4 +82,80 @@ gen_interspersed_request(size_t data_size, size_t chunk_size) {
     // clang-format on
 }
 
+inline heartbeat_request gen_heartbeat_request(size_t groups) {
+    heartbeat_request ret{.node_id = 1};
+    ret.meta.reserve(groups);
+    for (size_t i = 0; i < groups; ++i) {
+        auto g = static_cast<int64_t>(i);
+        ret.meta.push_back(heartbeat_meta{
+          .group = g,
+          .commit_index = 1000 + g,
+          .term = 3,
+          .prev_log_index = 1000 + g,
+          .prev_log_term = 3,
+          .last_visible_index = 1000 + g});
+    }
+    return ret;
+}
+
+inline heartbeat_reply reply_to(const heartbeat_request& r) {
+    heartbeat_reply ret;
+    ret.meta.reserve(r.meta.size());
+    for (const auto& m : r.meta) {
+        ret.meta.push_back(heartbeat_reply_meta{
+          .group = m.group,
+          .term = m.term,
+          .last_flushed_log_index = m.prev_log_index,
+          .last_dirty_log_index = m.prev_log_index,
+          .last_term_base_offset = 0});
+    }
+    return ret;
+}
+
+inline heartbeat_serde_request gen_heartbeat_serde_request(size_t groups) {
+    heartbeat_serde_request ret;
+    ret.node_id = 1;
+    for (size_t i = 0; i < groups; ++i) {
+        auto g = static_cast<int64_t>(i);
+        ret.groups.push_back(g);
+        ret.commit_indices.push_back(1000 + g);
+        ret.terms.push_back(3);
+        ret.prev_log_indices.push_back(1000 + g);
+        ret.prev_log_terms.push_back(3);
+        ret.last_visible_indices.push_back(1000 + g);
+    }
+    return ret;
+}
+
+inline heartbeat_serde_reply reply_to(const heartbeat_serde_request& r) {
+    heartbeat_serde_reply ret;
+    ret.groups = r.groups;
+    ret.terms = r.terms;
+    ret.last_flushed_log_indices = r.prev_log_indices;
+    ret.last_dirty_log_indices = r.prev_log_indices;
+    ret.last_term_base_offsets.resize(r.groups.size(), 0);
+    ret.results.resize(r.groups.size(), 0);
+    return ret;
+}
+
+/// the batches are filled with text so that they compress like the records
+/// of a typical workload rather than like random bytes
+inline append_entries_request
+gen_append_entries_request(size_t data_size, size_t chunk_size) {
+    static constexpr std::string_view text
+      = "{\"key\": \"user-0042\", \"event\": \"page_view\", \"ts\": "
+        "1633036800}\n";
+    append_entries_request ret{.node_id = 1, .group = 1, .term = 3};
+    const size_t chunks = data_size / chunk_size;
+    for (size_t i = 0; i < chunks; ++i) {
+        ss::temporary_buffer<char> buf(chunk_size);
+        for (size_t pos = 0; pos < chunk_size; pos += text.size()) {
+            auto n = std::min(text.size(), chunk_size - pos);
+            std::copy_n(text.data(), n, buf.get_write() + pos);
+        }
+        ret.batches.append(std::move(buf));
+    }
+    return ret;
+}
+
 } // namespace demo
@@ -41,6 +41,25 @@ struct service final : demo::simple_service {
         return ss::make_ready_future<demo::interspersed_reply>(
           demo::interspersed_reply{{}});
     }
+    ss::future<demo::heartbeat_reply>
+    heartbeat(demo::heartbeat_request&& r, rpc::streaming_context&) final {
+        return ss::make_ready_future<demo::heartbeat_reply>(demo::reply_to(r));
+    }
+    ss::future<demo::heartbeat_serde_reply> heartbeat_serde(
+      demo::heartbeat_serde_request&& r, rpc::streaming_context&) final {
+        return ss::make_ready_future<demo::heartbeat_serde_reply>(
+          demo::reply_to(r));
+    }
+    ss::future<demo::append_entries_reply> append_entries(
+      demo::append_entries_request&& r, rpc::streaming_context&) final {
+        return ss::make_ready_future<demo::append_entries_reply>(
+          demo::append_entries_reply{
+            .node_id = r.node_id,
+            .group = r.group,
+            .term = r.term,
+            .last_flushed_log_index = r.prev_log_index + 1,
+            .last_dirty_log_index = r.prev_log_index + 1});
+    }
 };
 
 void cli_opts(boost::program_options::options_description_easy_init o) {
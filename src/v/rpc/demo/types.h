@@ -12,6 +12,9 @@
 #pragma once
 
 #include "bytes/iobuf.h"
+#include "serde/envelope.h"
+
+#include <vector>
 
 namespace demo {
 struct simple_request {
@@ -83,4 +86,71 @@ struct interspersed_reply {
     int32_t x{-1};
 };
 
+// raft shaped payloads, see raft/types.h
+
+struct heartbeat_meta {
+    int64_t group{0};
+    int64_t commit_index{0};
+    int64_t term{0};
+    int64_t prev_log_index{0};
+    int64_t prev_log_term{0};
+    int64_t last_visible_index{0};
+};
+struct heartbeat_request {
+    int32_t node_id{0};
+    std::vector<heartbeat_meta> meta;
+};
+struct heartbeat_reply_meta {
+    int64_t group{0};
+    int64_t term{0};
+    int64_t last_flushed_log_index{0};
+    int64_t last_dirty_log_index{0};
+    int64_t last_term_base_offset{0};
+    int8_t result{0};
+};
+struct heartbeat_reply {
+    std::vector<heartbeat_reply_meta> meta;
+};
+
+/// heartbeats of the groups in the structure of arrays layout that the serde
+/// codec copies in bulk
+struct heartbeat_serde_request
+  : serde::envelope<heartbeat_serde_request, serde::version<0>> {
+    int32_t node_id{0};
+    std::vector<int64_t> groups;
+    std::vector<int64_t> commit_indices;
+    std::vector<int64_t> terms;
+    std::vector<int64_t> prev_log_indices;
+    std::vector<int64_t> prev_log_terms;
+    std::vector<int64_t> last_visible_indices;
+};
+struct heartbeat_serde_reply
+  : serde::envelope<heartbeat_serde_reply, serde::version<0>> {
+    std::vector<int64_t> groups;
+    std::vector<int64_t> terms;
+    std::vector<int64_t> last_flushed_log_indices;
+    std::vector<int64_t> last_dirty_log_indices;
+    std::vector<int64_t> last_term_base_offsets;
+    std::vector<int8_t> results;
+};
+
+struct append_entries_request {
+    int32_t node_id{0};
+    int64_t group{0};
+    int64_t commit_index{0};
+    int64_t term{0};
+    int64_t prev_log_index{0};
+    int64_t prev_log_term{0};
+    iobuf batches;
+    int8_t flush{0};
+};
+struct append_entries_reply {
+    int32_t node_id{0};
+    int64_t group{0};
+    int64_t term{0};
+    int64_t last_flushed_log_index{0};
+    int64_t last_dirty_log_index{0};
+    int8_t result{0};
+};
+
 } // namespace demo
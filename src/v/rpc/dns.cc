@@ -10,21 +10,114 @@
  */
 #include "rpc/dns.h"
 
+#include "rpc/logger.h"
 #include "utils/mutex.h"
 #include "utils/unresolved_address.h"
+#include "vlog.h"
 
 #include <seastar/core/coroutine.hh>
 #include <seastar/net/dns.hh>
 
 namespace rpc {
-ss::future<ss::socket_address> resolve_dns(unresolved_address address) {
+
+dns_cache::dns_cache(resolve_fn f, clock_type::duration ttl)
+  : _resolve(std::move(f))
+  , _ttl(ttl) {}
+
+dns_cache::key_t dns_cache::key_of(const unresolved_address& a) {
+    return {a.host(), a.family() ? static_cast<int>(*a.family()) : -1};
+}
+
+ss::future<ss::socket_address>
+dns_cache::resolve(const unresolved_address& address) {
+    auto key = key_of(address);
+    if (auto it = _entries.find(key);
+        it != _entries.end() && !it->second.addrs.empty()) {
+        if (
+          it->second.expires_at <= clock_type::now()
+          && !it->second.pending) {
+            (void)resolution(address).handle_exception(
+              [address](const std::exception_ptr& e) {
+                  vlog(
+                    rpclog.warn,
+                    "unable to refresh the addresses of {} - {}",
+                    address,
+                    e);
+              });
+        }
+        co_return pick(it->second, address.port());
+    }
+    co_await resolution(address);
+    auto it = _entries.find(key);
+    if (it == _entries.end() || it->second.addrs.empty()) {
+        throw std::runtime_error(
+          fmt::format("no addresses resolved for {}", address));
+    }
+    co_return pick(it->second, address.port());
+}
+
+ss::future<> dns_cache::resolution(const unresolved_address& address) {
+    auto key = key_of(address);
+    if (auto& e = _entries[key]; e.pending) {
+        return e.pending->get_future();
+    }
+    auto f = do_resolve(address);
+    if (f.available()) {
+        // resolved without suspending, the entry is already updated
+        return f;
+    }
+    auto& e = _entries[key];
+    e.pending = ss::shared_future<>(std::move(f));
+    return e.pending->get_future();
+}
+
+ss::future<> dns_cache::do_resolve(unresolved_address address) {
+    std::exception_ptr err;
+    std::vector<ss::net::inet_address> addrs;
+    try {
+        addrs = co_await _resolve(address.host(), address.family());
+    } catch (...) {
+        err = std::current_exception();
+    }
+    auto key = key_of(address);
+    auto& e = _entries[key];
+    e.pending.reset();
+    if (!err && !addrs.empty()) {
+        e.addrs = std::move(addrs);
+        e.expires_at = clock_type::now() + _ttl;
+        co_return;
+    }
+    if (e.addrs.empty()) {
+        _entries.erase(key);
+    } else {
+        // keep returning the addresses we know about
+        e.expires_at = clock_type::now() + retry_interval;
+    }
+    if (err) {
+        std::rethrow_exception(err);
+    }
+}
+
+ss::socket_address dns_cache::pick(entry& e, uint16_t port) {
+    return ss::socket_address(e.addrs[e.next++ % e.addrs.size()], port);
+}
+
+static ss::future<std::vector<ss::net::inet_address>>
+resolve_all(const ss::sstring& host, unresolved_address::inet_family family) {
     static thread_local ss::net::dns_resolver resolver;
     static thread_local mutex m;
     // lock
     auto units = co_await m.get_units();
     // resolve
-    auto i_a = co_await resolver.resolve_name(address.host(), address.family());
+    auto h = co_await resolver.get_host_by_name(host, family);
+    co_return std::move(h.addr_list);
+}
 
-    co_return ss::socket_address(i_a, address.port());
+ss::future<ss::socket_address> resolve_dns(unresolved_address address) {
+    static thread_local dns_cache cache(
+      [](const ss::sstring& host, unresolved_address::inet_family family) {
+          return resolve_all(host, family);
+      });
+    return cache.resolve(address);
 };
 } // namespace rpc
@@ -10,12 +10,78 @@
  */
 
 #pragma once
+#include "seastarx.h"
 #include "utils/unresolved_address.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/net/inet_address.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
 namespace rpc {
+
+/**
+ * Per shard cache of resolved host names.
+ *
+ * Hosts are resolved once per TTL instead of on every connect, a burst of
+ * reconnects to the same host is served by a single resolution. Expired
+ * addresses are still returned while they are refreshed in the background,
+ * and kept when the refresh fails. A host that resolves to multiple addresses
+ * is handed out round-robin, spreading the connections between them.
+ *
+ * The seastar resolver doesn't expose the TTL of the records, the cache uses
+ * a fixed one.
+ */
+class dns_cache {
+public:
+    using clock_type = ss::lowres_clock;
+    using resolve_fn
+      = ss::noncopyable_function<ss::future<std::vector<ss::net::inet_address>>(
+        const ss::sstring&, unresolved_address::inet_family)>;
+
+    static constexpr clock_type::duration default_ttl = std::chrono::seconds(
+      30);
+    /// Time to the next refresh of the expired addresses if the refresh
+    /// failed
+    static constexpr clock_type::duration retry_interval
+      = std::chrono::seconds(1);
+
+    explicit dns_cache(resolve_fn, clock_type::duration ttl = default_ttl);
+
+    ss::future<ss::socket_address> resolve(const unresolved_address&);
+
+private:
+    using key_t = std::pair<ss::sstring, int>;
+    struct entry {
+        std::vector<ss::net::inet_address> addrs;
+        clock_type::time_point expires_at;
+        // round-robin position
+        size_t next{0};
+        // resolution in flight
+        std::optional<ss::shared_future<>> pending;
+    };
+
+    static key_t key_of(const unresolved_address&);
+    ss::future<> resolution(const unresolved_address&);
+    ss::future<> do_resolve(unresolved_address);
+    ss::socket_address pick(entry&, uint16_t port);
+
+    resolve_fn _resolve;
+    clock_type::duration _ttl;
+    absl::flat_hash_map<key_t, entry> _entries;
+};
+
 /**
- * Resolves addresses using seastar DNS resolver. It uses mutex to workaround
- * seastar bug causing segmentation fault when udp channel is being accessed by
- * different fibers.
+ * Resolves addresses using seastar DNS resolver through the per shard
+ * dns_cache. It uses mutex to workaround seastar bug causing segmentation
+ * fault when udp channel is being accessed by different fibers.
  */
 ss::future<ss::socket_address> resolve_dns(unresolved_address);
 } // namespace rpc
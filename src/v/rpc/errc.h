@@ -22,7 +22,8 @@ enum class errc {
     missing_node_rpc_client,
     client_request_timeout,
     service_error,
-    method_not_found
+    method_not_found,
+    server_busy
 };
 struct errc_category final : public std::error_category {
     const char* name() const noexcept final { return "rpc::errc"; }
@@ -39,6 +40,8 @@ struct errc_category final : public std::error_category {
             return "rpc::errc::missing_node_rpc_client";
         case errc::client_request_timeout:
             return "rpc::errc::client_request_timeout";
+        case errc::server_busy:
+            return "rpc::errc::server_busy(out of memory, retry later)";
         default:
             return "rpc::errc::unknown";
         }
@@ -16,6 +16,10 @@
 #include "rpc/types.h"
 #include "vassert.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
 namespace rpc {
 iobuf header_as_iobuf(const header& h) {
     iobuf b;
@@ -34,9 +38,7 @@ ss::scattered_message<char> netbuf::as_scattered() && {
           "cannot compose scattered view with incomplete header. missing "
           "correlation_id or remote method id");
     }
-    if (
-      _out.size_bytes() >= _min_compression_bytes
-      && rpc::compression_type::zstd == _hdr.compression) {
+    if (should_compress()) {
         compression::stream_zstd fn;
         _out = fn.compress(std::move(_out));
     } else {
@@ -51,7 +53,21 @@ ss::scattered_message<char> netbuf::as_scattered() && {
     });
     _hdr.payload_checksum = h.digest();
     _hdr.payload_size = _out.size_bytes();
-    _hdr.header_checksum = rpc::checksum_header_only(_hdr);
+    if (_deadline) {
+        // the time left is measured when the request is written out, after
+        // it waited in the queue of the transport
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+          *_deadline - clock_type::now());
+        auto timeout_ms = static_cast<uint32_t>(std::clamp<int64_t>(
+          left.count(), 0, std::numeric_limits<uint32_t>::max()));
+        rpc::set_flag(_hdr, header_flags::timeout);
+        _hdr.header_checksum = rpc::checksum_header_only(_hdr, timeout_ms);
+        iobuf timeout;
+        reflection::adl<uint32_t>{}.to(timeout, timeout_ms);
+        _out.prepend(std::move(timeout));
+    } else {
+        _hdr.header_checksum = rpc::checksum_header_only(_hdr);
+    }
     _out.prepend(header_as_iobuf(_hdr));
 
     // prepare for output
@@ -17,6 +17,8 @@
 
 #include <seastar/core/scattered_message.hh>
 
+#include <optional>
+
 namespace rpc {
 class netbuf {
 public:
@@ -29,10 +31,17 @@ public:
     void set_compression(rpc::compression_type c);
     void set_service_method_id(uint32_t);
     void set_min_compression_bytes(size_t);
+    void set_flag(header_flags);
+    /// \brief the remaining time until the deadline is sent with the header
+    void set_deadline(clock_type::time_point);
     iobuf& buffer();
 
+    /// true if the payload is going to be compressed by as_scattered()
+    bool should_compress() const;
+
 private:
     size_t _min_compression_bytes{1024};
+    std::optional<clock_type::time_point> _deadline;
     header _hdr;
     iobuf _out;
 };
@@ -50,8 +59,16 @@ inline void netbuf::set_status(rpc::status st) {
 }
 inline void netbuf::set_correlation_id(uint32_t x) { _hdr.correlation_id = x; }
 inline void netbuf::set_service_method_id(uint32_t x) { _hdr.meta = x; }
+inline void netbuf::set_flag(header_flags f) { rpc::set_flag(_hdr, f); }
+inline void netbuf::set_deadline(clock_type::time_point deadline) {
+    _deadline = deadline;
+}
 inline void netbuf::set_min_compression_bytes(size_t min) {
     _min_compression_bytes = min;
 }
+inline bool netbuf::should_compress() const {
+    return _out.size_bytes() >= _min_compression_bytes
+           && rpc::compression_type::zstd == _hdr.compression;
+}
 
 } // namespace rpc
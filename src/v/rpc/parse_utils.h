@@ -18,6 +18,7 @@
 #include "rpc/logger.h"
 #include "rpc/types.h"
 #include "seastarx.h"
+#include "serde/serde.h"
 #include "vlog.h"
 
 #include <seastar/core/do_with.hh>
@@ -63,6 +64,49 @@ parse_header(ss::input_stream<char>& in) {
     });
 }
 
+/// \brief parses the header of a request and the client timeout that
+/// follows it when the header is flagged with header_flags::timeout
+inline ss::future<std::optional<request_header>>
+parse_request_header(ss::input_stream<char>& in) {
+    using ret_t = std::optional<request_header>;
+    auto validate = [](header h, std::optional<uint32_t> timeout_ms) {
+        if (auto got = checksum_header_only(h, timeout_ms);
+            unlikely(h.header_checksum != got)) {
+            vlog(
+              rpclog.info,
+              "rpc header missmatching checksums. expected:{}, got:{} - {}",
+              h.header_checksum,
+              got,
+              h);
+            return ret_t();
+        }
+        request_header ret{.hdr = h};
+        if (timeout_ms) {
+            ret.timeout = std::chrono::milliseconds(*timeout_ms);
+        }
+        return ret_t(ret);
+    };
+    return read_iobuf_exactly(in, size_of_rpc_header)
+      .then([&in, validate](iobuf b) {
+          if (b.size_bytes() != size_of_rpc_header) {
+              return ss::make_ready_future<ret_t>();
+          }
+          iobuf_parser parser(std::move(b));
+          auto h = reflection::adl<header>{}.from(parser);
+          if (!has_flag(h, header_flags::timeout)) {
+              return ss::make_ready_future<ret_t>(validate(h, std::nullopt));
+          }
+          return read_iobuf_exactly(in, size_of_rpc_header_timeout)
+            .then([h, validate](iobuf b) {
+                if (b.size_bytes() != size_of_rpc_header_timeout) {
+                    return ret_t();
+                }
+                iobuf_parser parser(std::move(b));
+                return validate(h, reflection::adl<uint32_t>{}.from(parser));
+            });
+      });
+}
+
 inline void validate_payload_and_header(const iobuf& io, const header& h) {
     detail::check_out_of_range(io.size_bytes(), h.payload_size);
     auto in = iobuf::iterator_consumer(io.cbegin(), io.cend());
@@ -82,11 +126,34 @@ inline void validate_payload_and_header(const iobuf& io, const header& h) {
     }
 }
 
+/// \brief the payloads of serde envelopes are encoded with serde, the
+/// payloads of all the other types with adl
+template<typename T>
+ss::future<> write_payload(iobuf& out, T t) {
+    if constexpr (serde::is_envelope_v<T>) {
+        if constexpr (serde::has_serde_async_write<T>) {
+            return ss::do_with(std::move(t), [&out](const T& t) {
+                return serde::write_async(out, t);
+            });
+        } else {
+            serde::write(out, std::move(t));
+            return ss::now();
+        }
+    } else {
+        return reflection::async_adl<T>{}.to(out, std::move(t));
+    }
+}
+
 template<typename T>
 ss::future<T> parse_type_wihout_compression(iobuf io) {
     auto p = std::make_unique<iobuf_parser>(std::move(io));
     auto raw = p.get();
-    return reflection::async_adl<T>{}.from(*raw).finally([p = std::move(p)] {});
+    if constexpr (serde::is_envelope_v<T>) {
+        return serde::read_async<T>(*raw).finally([p = std::move(p)] {});
+    } else {
+        return reflection::async_adl<T>{}.from(*raw).finally(
+          [p = std::move(p)] {});
+    }
 }
 
 template<typename T>
@@ -0,0 +1,88 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "rpc/priority_admission.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace rpc {
+
+bool priority_admission::can_reserve(method_priority p, size_t bytes) const {
+    const auto idx = static_cast<size_t>(p);
+    const bool overtakes = std::all_of(
+      _waiters.begin(),
+      _waiters.begin() + idx + 1,
+      [](const std::deque<waiter>& w) { return w.empty(); });
+    // the semaphore may have a lower priority reservation waiting, that
+    // the reservation goes ahead of if the memory is available
+    return overtakes
+           && _memory.available_units() >= static_cast<ssize_t>(bytes);
+}
+
+ss::future<ss::semaphore_units<>>
+priority_admission::reserve(method_priority p, size_t bytes) {
+    if (can_reserve(p, bytes)) {
+        return ss::make_ready_future<ss::semaphore_units<>>(
+          ss::consume_units(_memory, bytes));
+    }
+    const auto idx = static_cast<size_t>(p);
+    auto& w = _waiters[idx].emplace_back(waiter{.bytes = bytes});
+    auto f = w.units.get_future();
+    admit();
+    return f;
+}
+
+void priority_admission::resize(size_t memory) {
+    if (memory > _capacity) {
+        _memory.signal(memory - _capacity);
+    } else {
+        _memory.consume(_capacity - memory);
+    }
+    _capacity = memory;
+}
+
+size_t priority_admission::waiters() const {
+    return std::accumulate(
+      _waiters.begin(),
+      _waiters.end(),
+      size_t(0),
+      [](size_t acc, const std::deque<waiter>& w) { return acc + w.size(); });
+}
+
+void priority_admission::admit() {
+    if (_admitting) {
+        return;
+    }
+    auto it = std::find_if(
+      _waiters.begin(), _waiters.end(), [](const std::deque<waiter>& w) {
+          return !w.empty();
+      });
+    if (it == _waiters.end()) {
+        return;
+    }
+    _admitting = true;
+    // the waiter stays at the front of its queue until it is granted, the
+    // reservations of its priority can't overtake it
+    (void)ss::get_units(_memory, it->front().bytes)
+      .then_wrapped([this, &queue = *it](
+                      ss::future<ss::semaphore_units<>> f) {
+          auto w = std::move(queue.front());
+          queue.pop_front();
+          _admitting = false;
+          if (f.failed()) {
+              w.units.set_exception(f.get_exception());
+          } else {
+              w.units.set_value(f.get0());
+          }
+          admit();
+      });
+}
+
+} // namespace rpc
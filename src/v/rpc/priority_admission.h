@@ -0,0 +1,77 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "rpc/types.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/semaphore.hh>
+
+#include <array>
+#include <deque>
+
+namespace rpc {
+
+/**
+ * Admits the memory reservations of the requests in the order of their
+ * priority.
+ *
+ * The waiters of a semaphore are served in arrival order, an overloaded
+ * server would make the heartbeats wait for the memory of the appends that
+ * arrived before them and the groups would start elections. The reservations
+ * that can't be granted right away are queued by the priority of their
+ * method instead and granted highest priority first, in arrival order within
+ * a priority. A reservation is granted right away only if no reservation of
+ * the same or a higher priority is waiting.
+ *
+ * A single reservation waits on the semaphore at a time. A reservation of a
+ * higher priority arriving while it waits is granted ahead of it when the
+ * memory it needs is available, otherwise it is granted after it.
+ */
+class priority_admission {
+public:
+    explicit priority_admission(size_t memory)
+      : _memory(memory)
+      , _capacity(memory) {}
+
+    ss::future<ss::semaphore_units<>> reserve(method_priority, size_t bytes);
+
+    /// true if the reservation would be granted right away
+    bool can_reserve(method_priority, size_t bytes) const;
+
+    ss::semaphore& memory() { return _memory; }
+
+    size_t waiters() const;
+
+    size_t capacity() const { return _capacity; }
+
+    /// \brief changes the memory that can be reserved. the memory already
+    /// reserved above a lower capacity is returned before new reservations
+    /// are granted
+    void resize(size_t memory);
+
+private:
+    struct waiter {
+        size_t bytes;
+        ss::promise<ss::semaphore_units<>> units;
+    };
+
+    void admit();
+
+    ss::semaphore _memory;
+    size_t _capacity;
+    std::array<std::deque<waiter>, method_priorities> _waiters;
+    bool _admitting{false};
+};
+
+} // namespace rpc
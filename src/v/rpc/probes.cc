@@ -55,6 +55,16 @@ void server_probe::setup_metrics(
           [this] { return _out_bytes; },
           sm::description(
             ssx::sformat("{}: Number of bytes sent to clients", proto))),
+        sm::make_derive(
+          "flushes",
+          [this] { return _flushes; },
+          sm::description(ssx::sformat(
+            "{}: Number of writes to the client sockets", proto))),
+        sm::make_total_bytes(
+          "flushed_bytes",
+          [this] { return _flushed_bytes; },
+          sm::description(ssx::sformat(
+            "{}: Number of bytes written to the client sockets", proto))),
         sm::make_derive(
           "method_not_found_errors",
           [this] { return _method_not_found_errors; },
@@ -74,6 +84,19 @@ void server_probe::setup_metrics(
           [this] { return _requests_blocked_memory; },
           sm::description(ssx::sformat(
             "{}: Number of requests blocked in memory backpressure", proto))),
+        sm::make_derive(
+          "requests_expired",
+          [this] { return _requests_expired; },
+          sm::description(ssx::sformat(
+            "{}: Number of requests dropped because the client timed out",
+            proto))),
+        sm::make_derive(
+          "requests_rejected_busy",
+          [this] { return _requests_rejected_busy; },
+          sm::description(ssx::sformat(
+            "{}: Number of requests rejected because the server was out of "
+            "memory",
+            proto))),
         sm::make_gauge(
           "requests_pending",
           [this] { return _requests_received - _requests_completed; },
@@ -92,14 +115,17 @@ std::ostream& operator<<(std::ostream& o, const server_probe& p) {
       << "sent bytes: " << p._out_bytes << ", "
       << "corrupted headers: " << p._corrupted_headers << ", "
       << "method not found errors: " << p._method_not_found_errors << ", "
-      << "requests blocked by memory: " << p._requests_blocked_memory << "}";
+      << "requests blocked by memory: " << p._requests_blocked_memory << ", "
+      << "requests expired: " << p._requests_expired << ", "
+      << "requests rejected busy: " << p._requests_rejected_busy << "}";
     return o;
 }
 
 void client_probe::setup_metrics(
   ss::metrics::metric_groups& mgs,
   const std::optional<ss::sstring>& service_name,
-  const unresolved_address& target_addr) {
+  const unresolved_address& target_addr,
+  std::optional<uint16_t> connection_index) {
     namespace sm = ss::metrics;
     auto target = sm::label("target");
     std::vector<sm::label_instance> labels = {
@@ -107,6 +133,9 @@ void client_probe::setup_metrics(
     if (service_name) {
         labels.push_back(sm::label("service_name")(*service_name));
     }
+    if (connection_index) {
+        labels.push_back(sm::label("connection")(*connection_index));
+    }
     mgs.add_group(
       prometheus_sanitize::metrics_name("rpc_client"),
       {
@@ -150,6 +179,16 @@ void client_probe::setup_metrics(
           [this] { return _in_bytes; },
           sm::description("Total number of bytes received"),
           labels),
+        sm::make_derive(
+          "flushes",
+          [this] { return _flushes; },
+          sm::description("Number of writes to the socket"),
+          labels),
+        sm::make_total_bytes(
+          "flushed_bytes",
+          [this] { return _flushed_bytes; },
+          sm::description("Number of bytes written to the socket"),
+          labels),
         sm::make_derive(
           "connection_errors",
           [this] { return _connection_errors; },
@@ -181,6 +220,26 @@ void client_probe::setup_metrics(
           sm::description("Number of requests that are blocked beacause"
                           " of insufficient memory"),
           labels),
+        sm::make_derive(
+          "compressed_requests",
+          [this] { return _compressed_requests; },
+          sm::description("Number of requests sent with compressed payload"),
+          labels),
+        sm::make_total_bytes(
+          "compression_in_bytes",
+          [this] { return _compression_in_bytes; },
+          sm::description("Total size of the payloads before compression"),
+          labels),
+        sm::make_total_bytes(
+          "compression_out_bytes",
+          [this] { return _compression_out_bytes; },
+          sm::description("Total size of the payloads after compression"),
+          labels),
+        sm::make_derive(
+          "compression_time_us",
+          [this] { return _compression_time_us; },
+          sm::description("Total time spent compressing the payloads"),
+          labels),
       });
 }
 
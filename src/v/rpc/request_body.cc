@@ -0,0 +1,121 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "rpc/request_body.h"
+
+#include "bytes/iobuf.h"
+#include "compression/stream_zstd.h"
+#include "rpc/parse_utils.h"
+
+#include <seastar/core/loop.hh>
+
+#include <fmt/format.h>
+
+namespace rpc {
+
+/// reads the payload from the connection, at most up to the end of the body
+class request_body::source final : public ss::data_source_impl {
+public:
+    explicit source(ss::lw_shared_ptr<state> st)
+      : _state(std::move(st)) {}
+
+    ss::future<ss::temporary_buffer<char>> get() final {
+        if (_state->error) {
+            return ss::make_exception_future<ss::temporary_buffer<char>>(
+              _state->error);
+        }
+        if (_state->remaining == 0) {
+            return ss::make_ready_future<ss::temporary_buffer<char>>();
+        }
+        return _state->in.read_up_to(_state->remaining)
+          .then([st = _state](ss::temporary_buffer<char> buf) {
+              if (buf.empty()) {
+                  return fail(
+                    *st,
+                    std::runtime_error(fmt::format(
+                      "connection closed with {} bytes of the rpc request "
+                      "body remaining",
+                      st->remaining)));
+              }
+              st->hasher.update(buf.get(), buf.size());
+              st->remaining -= buf.size();
+              if (st->remaining == 0) {
+                  const auto got = st->hasher.digest();
+                  const auto expected = st->ctx.get_header().payload_checksum;
+                  if (got != expected) {
+                      return fail(
+                        *st,
+                        std::runtime_error(fmt::format(
+                          "invalid rpc checksum. got:{}, expected:{}",
+                          got,
+                          expected)));
+                  }
+                  // the connection can parse the next request
+                  st->ctx.signal_body_parse();
+              }
+              return ss::make_ready_future<ss::temporary_buffer<char>>(
+                std::move(buf));
+          });
+    }
+
+private:
+    static ss::future<ss::temporary_buffer<char>>
+    fail(state& st, const std::runtime_error& e) {
+        st.error = std::make_exception_ptr(e);
+        return ss::make_exception_future<ss::temporary_buffer<char>>(
+          st.error);
+    }
+
+    ss::lw_shared_ptr<state> _state;
+};
+
+request_body::request_body(
+  ss::input_stream<char> input, ss::lw_shared_ptr<state> st)
+  : _input(std::move(input))
+  , _state(std::move(st)) {}
+
+ss::future<request_body>
+request_body::open(ss::input_stream<char>& in, streaming_context& ctx) {
+    auto st = ss::make_lw_shared<state>(in, ctx);
+    const auto& h = ctx.get_header();
+    if (h.compression == compression_type::none) {
+        ss::input_stream<char> input(
+          ss::data_source(std::make_unique<source>(st)));
+        return ss::make_ready_future<request_body>(
+          request_body(std::move(input), std::move(st)));
+    }
+    // the frames of the compressed payload can't be decompressed as they
+    // arrive, the body is received whole
+    return ctx.permanent_memory_reservation(h.payload_size)
+      .then([&in, h] { return read_iobuf_exactly(in, h.payload_size); })
+      .then([st = std::move(st), h](iobuf io) mutable {
+          st->remaining = 0;
+          validate_payload_and_header(io, h);
+          if (h.compression != compression_type::zstd) {
+              throw std::runtime_error(
+                fmt::format("no compression supported. header: {}", h));
+          }
+          compression::stream_zstd fn;
+          auto input = make_iobuf_input_stream(fn.uncompress(std::move(io)));
+          st->ctx.signal_body_parse();
+          return request_body(std::move(input), std::move(st));
+      });
+}
+
+ss::future<> request_body::finish() {
+    // through the stream of the handler, it may hold buffered bytes
+    return ss::repeat([this] {
+        return _input.read().then([](ss::temporary_buffer<char> buf) {
+            return buf.empty() ? ss::stop_iteration::yes
+                               : ss::stop_iteration::no;
+        });
+    });
+}
+
+} // namespace rpc
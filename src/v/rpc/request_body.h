@@ -0,0 +1,79 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "hashing/xx.h"
+#include "rpc/types.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include <exception>
+
+namespace rpc {
+
+/**
+ * Body of a request handed to a streaming method while it is received.
+ *
+ * The methods of the services parse the whole request before their handler
+ * is invoked. The handler of a streaming method is invoked as soon as the
+ * header is received instead and reads the payload from the connection as
+ * it consumes it, the handlers that write the bytes through to storage
+ * don't hold the whole request in memory.
+ *
+ * - the memory of the payload is not reserved up front, the handler
+ *   reserves the memory of what it keeps with the streaming_context
+ * - the connection doesn't parse the next request until the body is read
+ *   to the end, the remaining bytes are skipped when the handler finishes
+ * - the payload checksum is verified when the last byte is read, the read
+ *   that reaches the end of a corrupted body fails. Handlers must not make
+ *   what they read visible before reaching the end of the body
+ * - compressed payloads are received and decompressed whole before the
+ *   handler is invoked
+ */
+class request_body {
+public:
+    /// \brief starts reading the body of the request from the connection
+    static ss::future<request_body>
+    open(ss::input_stream<char>&, streaming_context&);
+
+    /// \brief the bytes of the body, the stream ends with the payload
+    ss::input_stream<char>& input() { return _input; }
+
+    /// \brief reads the bytes the handler didn't, fails if the payload was
+    /// corrupted or the connection closed before the end of the body
+    ss::future<> finish();
+
+private:
+    struct state {
+        state(ss::input_stream<char>& in, streaming_context& ctx)
+          : in(in)
+          , ctx(ctx)
+          , remaining(ctx.get_header().payload_size) {}
+
+        ss::input_stream<char>& in;
+        streaming_context& ctx;
+        size_t remaining;
+        incremental_xxhash64 hasher;
+        std::exception_ptr error;
+    };
+    class source;
+
+    request_body(ss::input_stream<char>, ss::lw_shared_ptr<state>);
+
+    ss::input_stream<char> _input;
+    ss::lw_shared_ptr<state> _state;
+};
+
+} // namespace rpc
@@ -112,7 +112,8 @@ ss::future<> server::accept(listener& s) {
                 s.name,
                 std::move(ar.connection),
                 ar.remote_address,
-                _probe);
+                _probe,
+                cfg.cork_delay);
               vlog(
                 rpclog.trace,
                 "Incoming connection from {} on \"{}\"",
@@ -170,7 +171,10 @@ void server::setup_metrics() {
            ssx::sformat("{}: Maximum memory allowed for RPC", cfg.name))),
        sm::make_total_bytes(
          "consumed_mem_bytes",
-         [this] { return cfg.max_service_memory_per_core - _memory.current(); },
+         [this] {
+             return cfg.max_service_memory_per_core
+                    - _memory.memory().current();
+         },
          sm::description(ssx::sformat(
            "{}: Memory consumed by request processing", cfg.name))),
        sm::make_histogram(
@@ -178,4 +182,36 @@ void server::setup_metrics() {
          [this] { return _hist.seastar_histogram_logform(); },
          sm::description(ssx::sformat("{}: Latency ", cfg.name)))});
 }
+
+server::method_usage&
+server::usage_of(uint32_t method_id, const method& m) {
+    auto [it, inserted] = _method_usage.try_emplace(method_id);
+    auto& usage = it->second;
+    if (!inserted || cfg.disable_metrics) {
+        return usage;
+    }
+    // registered on the first request, most servers only see a few of the
+    // methods of their services
+    namespace sm = ss::metrics;
+    auto method_label = sm::label("method");
+    std::vector<sm::label_instance> labels{method_label(
+      m.name.empty() ? ssx::sformat("{}", method_id) : ss::sstring(m.name))};
+    usage.metrics.add_group(
+      prometheus_sanitize::metrics_name(cfg.name),
+      {sm::make_gauge(
+         "method_consumed_mem_bytes",
+         [&usage] { return usage.reserved_bytes; },
+         sm::description(ssx::sformat(
+           "{}: Memory consumed by the requests of the method", cfg.name)),
+         labels),
+       sm::make_derive(
+         "method_requests_rejected_busy",
+         [&usage] { return usage.rejected_requests; },
+         sm::description(ssx::sformat(
+           "{}: Number of requests of the method rejected because the "
+           "server was out of memory",
+           cfg.name)),
+         labels)});
+    return usage;
+}
 } // namespace rpc
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "rpc/connection.h"
+#include "rpc/priority_admission.h"
 #include "rpc/types.h"
 #include "utils/hdr_hist.h"
 
@@ -20,6 +21,7 @@
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/semaphore.hh>
 
+#include <absl/container/node_hash_map.h>
 #include <boost/intrusive/list.hpp>
 
 #include <list>
@@ -30,6 +32,13 @@ namespace rpc {
 
 class server {
 public:
+    /// memory held by the requests of a method
+    struct method_usage {
+        size_t reserved_bytes{0};
+        uint64_t rejected_requests{0};
+        ss::metrics::metric_groups metrics;
+    };
+
     // always guaranteed non-null
     class resources final {
     public:
@@ -41,8 +50,12 @@ public:
         ss::lw_shared_ptr<connection> conn;
 
         server_probe& probe() { return _s->_probe; }
-        ss::semaphore& memory() { return _s->_memory; }
+        ss::semaphore& memory() { return _s->_memory.memory(); }
+        priority_admission& admission() { return _s->_memory; }
         hdr_hist& hist() { return _s->_hist; }
+        method_usage& usage(uint32_t method_id, const method& m) {
+            return _s->usage_of(method_id, m);
+        }
         ss::gate& conn_gate() { return _s->_conn_gate; }
         ss::abort_source& abort_source() { return _s->_as; }
         bool abort_requested() const { return _s->_as.abort_requested(); }
@@ -80,6 +93,9 @@ public:
 
     const server_configuration cfg; // NOLINT
     const hdr_hist& histogram() const { return _hist; }
+    /// memory of the requests, resized by the memory balancer
+    priority_admission& admission() { return _memory; }
+    const server_probe& probe() const { return _probe; }
 
 private:
     struct listener {
@@ -94,9 +110,10 @@ private:
     friend resources;
     ss::future<> accept(listener&);
     void setup_metrics();
+    method_usage& usage_of(uint32_t method_id, const method&);
 
     std::unique_ptr<protocol> _proto;
-    ss::semaphore _memory;
+    priority_admission _memory;
     std::vector<std::unique_ptr<listener>> _listeners;
     boost::intrusive::list<connection> _connections;
     ss::abort_source _as;
@@ -104,6 +121,8 @@ private:
     hdr_hist _hist;
     server_probe _probe;
     ss::metrics::metric_groups _metrics;
+    // node map, the metrics refer to the usage
+    absl::node_hash_map<uint32_t, method_usage> _method_usage;
 };
 
 } // namespace rpc
@@ -34,6 +34,11 @@ public:
 
     void add_bytes_received(size_t recv) { _in_bytes += recv; }
 
+    void add_flush(size_t bytes) {
+        ++_flushes;
+        _flushed_bytes += bytes;
+    }
+
     void request_received() { ++_requests_received; }
 
     void request_completed() { ++_requests_completed; }
@@ -45,6 +50,13 @@ public:
     void service_error() { ++_service_errors; }
 
     void waiting_for_available_memory() { ++_requests_blocked_memory; }
+    uint32_t requests_blocked_memory() const {
+        return _requests_blocked_memory;
+    }
+
+    void request_expired() { ++_requests_expired; }
+
+    void request_rejected_busy() { ++_requests_rejected_busy; }
 
     void setup_metrics(ss::metrics::metric_groups& mgs, const char* name);
 
@@ -52,6 +64,8 @@ private:
     uint64_t _requests_completed = 0;
     uint64_t _in_bytes = 0;
     uint64_t _out_bytes = 0;
+    uint64_t _flushes = 0;
+    uint64_t _flushed_bytes = 0;
     uint64_t _connects = 0;
     uint64_t _requests_received = 0;
     uint64_t _service_errors = 0;
@@ -60,6 +74,8 @@ private:
     uint32_t _corrupted_headers = 0;
     uint32_t _method_not_found_errors = 0;
     uint32_t _requests_blocked_memory = 0;
+    uint64_t _requests_expired = 0;
+    uint64_t _requests_rejected_busy = 0;
     friend std::ostream& operator<<(std::ostream& o, const server_probe& p);
 };
 
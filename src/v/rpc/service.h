@@ -14,12 +14,14 @@
 #include "reflection/async_adl.h"
 #include "rpc/netbuf.h"
 #include "rpc/parse_utils.h"
+#include "rpc/request_body.h"
 #include "rpc/types.h"
 #include "seastarx.h"
 #include "ssx/sformat.h"
 
 #include <seastar/core/reactor.hh>
 #include <seastar/core/scheduling.hh>
+#include <seastar/core/timed_out_error.hh>
 
 #include <cstdint>
 
@@ -29,6 +31,8 @@ namespace rpc {
 struct service {
     template<typename Input, typename Output>
     struct execution_helper;
+    template<typename Output>
+    struct streaming_execution_helper;
 
     service() = default;
     virtual ~service() noexcept = default;
@@ -72,17 +76,76 @@ struct service::execution_helper {
                     }
                     ctx.signal_body_parse();
                     auto input = input_f.get0();
+                    // the client gave up while the request was waiting for
+                    // memory, don't waste the handler on it
+                    if (auto d = ctx.deadline(); d && *d <= clock_type::now()) {
+                        return ss::make_exception_future<Output>(
+                          ss::timed_out_error());
+                    }
                     return f(std::move(input), ctx);
                 })
                 .then([method_id](Output out) mutable {
                     auto b = std::make_unique<netbuf>();
                     auto raw_b = b.get();
                     raw_b->set_service_method_id(method_id);
-                    return reflection::async_adl<Output>{}
-                      .to(raw_b->buffer(), std::move(out))
+                    return write_payload(raw_b->buffer(), std::move(out))
                       .then([b = std::move(b)] { return std::move(*b); });
                 });
           });
     }
 };
+
+/// \brief invokes the handler of a streaming method while the body of the
+/// request is received, see request_body
+template<typename Output>
+struct service::streaming_execution_helper {
+    using output = Output;
+
+    template<typename Func>
+    static ss::future<netbuf> exec(
+      ss::input_stream<char>& in,
+      streaming_context& ctx,
+      uint32_t method_id,
+      Func&& f) {
+        return request_body::open(in, ctx)
+          .handle_exception([](std::exception_ptr e) -> request_body {
+              throw rpc_internal_body_parsing_exception(e);
+          })
+          .then([f = std::forward<Func>(f), &ctx](request_body body) mutable {
+              return ss::do_with(
+                std::move(body),
+                [f = std::move(f), &ctx](request_body& body) mutable {
+                    auto out = ss::futurize_invoke([&f, &body, &ctx] {
+                        if (auto d = ctx.deadline();
+                            d && *d <= clock_type::now()) {
+                            return ss::make_exception_future<Output>(
+                              ss::timed_out_error());
+                        }
+                        return f(body, ctx);
+                    });
+                    return out.then_wrapped(
+                      [&body](ss::future<Output> out) mutable {
+                          // the connection is unusable if the rest of the
+                          // body can't be read, whatever the handler returned
+                          return body.finish().then_wrapped(
+                            [out = std::move(out)](ss::future<> f) mutable {
+                                if (f.failed()) {
+                                    out.ignore_ready_future();
+                                    throw rpc_internal_body_parsing_exception(
+                                      f.get_exception());
+                                }
+                                return std::move(out);
+                            });
+                      });
+                });
+          })
+          .then([method_id](Output out) mutable {
+              auto b = std::make_unique<netbuf>();
+              auto raw_b = b.get();
+              raw_b->set_service_method_id(method_id);
+              return write_payload(raw_b->buffer(), std::move(out))
+                .then([b = std::move(b)] { return std::move(*b); });
+          });
+    }
+};
 } // namespace rpc
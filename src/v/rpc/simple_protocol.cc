@@ -11,6 +11,7 @@
 
 #include "rpc/logger.h"
 #include "rpc/types.h"
+#include "utils/latency_summary.h"
 
 #include <seastar/core/future-util.hh>
 
@@ -18,20 +19,55 @@
 
 namespace rpc {
 struct server_context_impl final : streaming_context {
-    server_context_impl(server::resources s, header h)
+    server_context_impl(server::resources s, request_header h)
       : res(std::move(s))
-      , hdr(h) {}
+      , hdr(h.hdr) {
+        if (h.timeout) {
+            expires_at = clock_type::now() + *h.timeout;
+        }
+    }
+    ~server_context_impl() noexcept override {
+        if (usage) {
+            usage->reserved_bytes -= reserved_bytes;
+        }
+    }
     ss::future<ss::semaphore_units<>> reserve_memory(size_t ask) final {
-        auto fut = get_units(res.memory(), ask);
-        if (res.memory().waiters()) {
+        auto fut = res.admission().reserve(priority, ask);
+        if (!fut.available()) {
             res.probe().waiting_for_available_memory();
         }
-        return fut;
+        // accounted to the method until the request completes
+        return fut.then([this, ask](ss::semaphore_units<> units) {
+            if (usage) {
+                usage->reserved_bytes += ask;
+                reserved_bytes += ask;
+            }
+            return units;
+        });
     }
     const header& get_header() const final { return hdr; }
+    std::optional<clock_type::time_point> deadline() const final {
+        return expires_at;
+    }
+    bool expired() const {
+        return expires_at && *expires_at <= clock_type::now();
+    }
+    /// the clients that handle the busy replies are told to come back
+    /// later instead of queueing behind the memory of the other requests.
+    /// Heartbeats and elections always wait, rejecting them would cost the
+    /// groups their leaders
+    bool reject_busy() {
+        return has_flag(hdr, header_flags::busy)
+               && priority >= method_priority::normal
+               && !res.admission().can_reserve(priority, hdr.payload_size);
+    }
     void signal_body_parse() final { pr.set_value(); }
     server::resources res;
     header hdr;
+    std::optional<clock_type::time_point> expires_at;
+    method_priority priority{method_priority::normal};
+    server::method_usage* usage{nullptr};
+    size_t reserved_bytes{0};
     ss::promise<> pr;
 };
 
@@ -39,8 +75,8 @@ ss::future<> simple_protocol::apply(server::resources rs) {
     return ss::do_until(
       [rs] { return rs.conn->input().eof() || rs.abort_requested(); },
       [this, rs]() mutable {
-          return parse_header(rs.conn->input())
-            .then([this, rs](std::optional<header> h) mutable {
+          return parse_request_header(rs.conn->input())
+            .then([this, rs](std::optional<request_header> h) mutable {
                 rs.probe().request_received();
                 if (!h) {
                     rpclog.debug(
@@ -61,6 +97,8 @@ send_reply(ss::lw_shared_ptr<server_context_impl> ctx, netbuf buf) {
     buf.set_min_compression_bytes(1024);
     buf.set_compression(rpc::compression_type::zstd);
     buf.set_correlation_id(ctx->get_header().correlation_id);
+    // tells the client it can send its timeout
+    buf.set_flag(header_flags::timeout);
 
     auto view = std::move(buf).as_scattered();
     if (ctx->res.conn_gate().is_closed()) {
@@ -77,10 +115,29 @@ send_reply(ss::lw_shared_ptr<server_context_impl> ctx, netbuf buf) {
       .finally([ctx] { ctx->res.probe().request_completed(); });
 }
 
-ss::future<>
-simple_protocol::dispatch_method_once(header h, server::resources rs) {
+/// drops the payload of the request that is not handled and replies with
+/// the status
+static ss::future<>
+skip_request(ss::lw_shared_ptr<server_context_impl> ctx, status st) {
+    return ctx->res.conn->input()
+      .skip(ctx->hdr.payload_size)
+      .then_wrapped([ctx, st](ss::future<> f) mutable {
+          if (f.failed()) {
+              ctx->pr.set_exception(f.get_exception());
+              return ss::now();
+          }
+          ctx->signal_body_parse();
+          netbuf reply_buf;
+          reply_buf.set_status(st);
+          return send_reply(ctx, std::move(reply_buf));
+      });
+}
+
+ss::future<> simple_protocol::dispatch_method_once(
+  request_header rh, server::resources rs) {
+    const auto& h = rh.hdr;
     const auto method_id = h.meta;
-    auto ctx = ss::make_lw_shared<server_context_impl>(rs, h);
+    auto ctx = ss::make_lw_shared<server_context_impl>(rs, rh);
     rs.probe().add_bytes_received(size_of_rpc_header + h.payload_size);
     if (rs.conn_gate().is_closed()) {
         return ss::make_exception_future<>(ss::gate_closed_exception());
@@ -106,10 +163,31 @@ simple_protocol::dispatch_method_once(header h, server::resources rs) {
         }
 
         method* m = it->get()->method_from_id(method_id);
+        ctx->priority = has_flag(ctx->hdr, header_flags::bulk)
+                          ? method_priority::low
+                          : m->priority;
+        ctx->usage = &rs.usage(method_id, *m);
+
+        if (ctx->expired()) {
+            // the client is no longer waiting for the reply, drop the request
+            // without reserving memory for it
+            rs.probe().request_expired();
+            return skip_request(ctx, rpc::status::request_timeout);
+        }
+
+        if (ctx->reject_busy()) {
+            rs.probe().request_rejected_busy();
+            ++ctx->usage->rejected_requests;
+            return skip_request(ctx, rpc::status::service_unavailable);
+        }
 
         return (*m)(ctx->res.conn->input(), *ctx)
-          .then_wrapped([ctx, m = ctx->res.hist().auto_measure(), rs](
-                          ss::future<netbuf> fut) mutable {
+          .then_wrapped([ctx,
+                         m = ctx->res.hist().auto_measure(),
+                         l = latency_summary::histogram(
+                               latency_summary::op::rpc)
+                               .auto_measure(),
+                         rs](ss::future<netbuf> fut) mutable {
               netbuf reply_buf;
               try {
                   reply_buf = fut.get0();
@@ -28,7 +28,7 @@ public:
     ss::future<> apply(server::resources) final;
 
 private:
-    ss::future<> dispatch_method_once(header, server::resources);
+    ss::future<> dispatch_method_once(request_header, server::resources);
 
     std::vector<std::unique_ptr<service>> _services;
 };
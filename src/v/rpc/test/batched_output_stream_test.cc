@@ -0,0 +1,108 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "rpc/batched_output_stream.h"
+
+#include <seastar/core/future-util.hh>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/scattered_message.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono_literals; // NOLINT
+
+namespace {
+/// counts the writes that reach the socket
+struct counting_sink final : ss::data_sink_impl {
+    explicit counting_sink(std::vector<size_t>& p)
+      : puts(p) {}
+    ss::future<> put(ss::net::packet data) final {
+        puts.push_back(data.len());
+        return ss::make_ready_future<>();
+    }
+    ss::future<> put(std::vector<ss::temporary_buffer<char>> all) final {
+        size_t len = 0;
+        for (auto& b : all) {
+            len += b.size();
+        }
+        puts.push_back(len);
+        return ss::make_ready_future<>();
+    }
+    ss::future<> put(ss::temporary_buffer<char> buf) final {
+        puts.push_back(buf.size());
+        return ss::make_ready_future<>();
+    }
+    ss::future<> flush() final { return ss::make_ready_future<>(); }
+    ss::future<> close() final { return ss::make_ready_future<>(); }
+    std::vector<size_t>& puts;
+};
+
+ss::output_stream<char> make_stream(std::vector<size_t>& puts) {
+    return ss::output_stream<char>(
+      ss::data_sink(std::make_unique<counting_sink>(puts)), 8192);
+}
+
+ss::scattered_message<char> message(size_t size) {
+    ss::scattered_message<char> msg;
+    msg.append(ss::sstring(size, 'x'));
+    return msg;
+}
+
+ss::future<> write_all(rpc::batched_output_stream& out, size_t n) {
+    std::vector<ss::future<>> writes;
+    writes.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        writes.push_back(out.write(message(100)));
+    }
+    return ss::when_all_succeed(writes.begin(), writes.end());
+}
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(corked_writes_are_coalesced) {
+    std::vector<size_t> puts;
+    size_t flushed = 0;
+    rpc::batched_output_stream out(make_stream(puts), 1024 * 1024, 100us);
+    out.set_flush_observer([&flushed](size_t b) { flushed += b; });
+
+    write_all(out, 10).get();
+    // nothing is sent until the cork delay expires
+    BOOST_REQUIRE_EQUAL(flushed, 0);
+    ss::sleep(10ms).get();
+    BOOST_REQUIRE_EQUAL(flushed, 1000);
+    BOOST_REQUIRE_EQUAL(puts.size(), 1);
+    BOOST_REQUIRE_EQUAL(puts.front(), 1000);
+    out.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(corked_writes_are_capped_by_bytes) {
+    std::vector<size_t> puts;
+    rpc::batched_output_stream out(make_stream(puts), 250, 1h);
+
+    write_all(out, 3).get();
+    // the third write crossed the cap and flushed
+    BOOST_REQUIRE_EQUAL(puts.size(), 1);
+    BOOST_REQUIRE_EQUAL(puts.front(), 300);
+    out.write(message(100)).get();
+    // the remaining bytes are sent when the stream is stopped
+    out.stop().get();
+    BOOST_REQUIRE_EQUAL(puts.size(), 2);
+    BOOST_REQUIRE_EQUAL(puts.back(), 100);
+}
+
+SEASTAR_THREAD_TEST_CASE(uncorked_idle_write_is_flushed) {
+    std::vector<size_t> puts;
+    rpc::batched_output_stream out(make_stream(puts));
+
+    out.write(message(100)).get();
+    BOOST_REQUIRE_EQUAL(puts.size(), 1);
+    out.stop().get();
+}
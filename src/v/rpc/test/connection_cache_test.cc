@@ -0,0 +1,62 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#define BOOST_TEST_MODULE rpc
+#include "rpc/connection_cache.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+
+using rpc::connection_cache;
+using rpc::connection_class;
+
+BOOST_AUTO_TEST_CASE(single_connection) {
+    for (auto c :
+         {connection_class::control,
+          connection_class::data,
+          connection_class::bulk}) {
+        BOOST_REQUIRE_EQUAL(connection_cache::connection_for(c, 42, 1), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(two_connections) {
+    BOOST_REQUIRE_EQUAL(
+      connection_cache::connection_for(connection_class::control, 42, 2), 0);
+    BOOST_REQUIRE_EQUAL(
+      connection_cache::connection_for(connection_class::data, 42, 2), 1);
+    BOOST_REQUIRE_EQUAL(
+      connection_cache::connection_for(connection_class::bulk, 42, 2), 1);
+}
+
+BOOST_AUTO_TEST_CASE(data_flows_are_striped) {
+    static constexpr size_t connections = 6;
+    BOOST_REQUIRE_EQUAL(
+      connection_cache::connection_for(
+        connection_class::control, 42, connections),
+      0);
+    BOOST_REQUIRE_EQUAL(
+      connection_cache::connection_for(connection_class::bulk, 42, connections),
+      connections - 1);
+
+    std::set<size_t> used;
+    for (uint64_t flow = 0; flow < 1000; ++flow) {
+        auto idx = connection_cache::connection_for(
+          connection_class::data, flow, connections);
+        // a flow always maps to the same connection
+        BOOST_REQUIRE_EQUAL(
+          idx,
+          connection_cache::connection_for(
+            connection_class::data, flow, connections));
+        BOOST_REQUIRE_GT(idx, 0);
+        BOOST_REQUIRE_LT(idx, connections - 1);
+        used.insert(idx);
+    }
+    BOOST_REQUIRE_EQUAL(used.size(), connections - 2);
+}
@@ -0,0 +1,119 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "rpc/dns.h"
+
+#include <seastar/core/future-util.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::chrono_literals; // NOLINT
+
+namespace {
+struct fake_resolver {
+    std::vector<ss::net::inet_address> addrs;
+    size_t calls{0};
+    bool fail{false};
+
+    rpc::dns_cache::resolve_fn fn() {
+        return [this](const ss::sstring&, unresolved_address::inet_family) {
+            ++calls;
+            if (fail) {
+                return ss::make_exception_future<
+                  std::vector<ss::net::inet_address>>(
+                  std::runtime_error("resolution failed"));
+            }
+            // resolve in the next task, as the real resolver does
+            return ss::yield().then([this] { return addrs; });
+        };
+    }
+};
+
+const unresolved_address host("s3.example.com", 443);
+const ss::net::inet_address ip1("10.0.0.1");
+const ss::net::inet_address ip2("10.0.0.2");
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(cached_until_ttl) {
+    fake_resolver r{.addrs = {ip1}};
+    rpc::dns_cache cache(r.fn(), 1h);
+
+    auto a = cache.resolve(host).get0();
+    BOOST_REQUIRE_EQUAL(a, ss::socket_address(ip1, 443));
+    cache.resolve(host).get();
+    BOOST_REQUIRE_EQUAL(r.calls, 1);
+    // the port is not part of the key
+    auto b = cache.resolve(unresolved_address("s3.example.com", 80)).get0();
+    BOOST_REQUIRE_EQUAL(b, ss::socket_address(ip1, 80));
+    BOOST_REQUIRE_EQUAL(r.calls, 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(concurrent_misses_resolve_once) {
+    fake_resolver r{.addrs = {ip1}};
+    rpc::dns_cache cache(r.fn(), 1h);
+
+    std::vector<ss::future<ss::socket_address>> fs;
+    for (int i = 0; i < 100; ++i) {
+        fs.push_back(cache.resolve(host));
+    }
+    for (auto& f : fs) {
+        BOOST_REQUIRE_EQUAL(f.get0(), ss::socket_address(ip1, 443));
+    }
+    BOOST_REQUIRE_EQUAL(r.calls, 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(round_robin) {
+    fake_resolver r{.addrs = {ip1, ip2}};
+    rpc::dns_cache cache(r.fn(), 1h);
+
+    BOOST_REQUIRE_EQUAL(cache.resolve(host).get0().addr(), ip1);
+    BOOST_REQUIRE_EQUAL(cache.resolve(host).get0().addr(), ip2);
+    BOOST_REQUIRE_EQUAL(cache.resolve(host).get0().addr(), ip1);
+}
+
+SEASTAR_THREAD_TEST_CASE(expired_refreshed_in_background) {
+    fake_resolver r{.addrs = {ip1}};
+    rpc::dns_cache cache(r.fn(), 0ms);
+
+    cache.resolve(host).get();
+    r.addrs = {ip2};
+    // the stale address is returned while the new one is resolved
+    BOOST_REQUIRE_EQUAL(cache.resolve(host).get0().addr(), ip1);
+    BOOST_REQUIRE_EQUAL(r.calls, 2);
+    ss::sleep(10ms).get();
+    BOOST_REQUIRE_EQUAL(cache.resolve(host).get0().addr(), ip2);
+}
+
+SEASTAR_THREAD_TEST_CASE(failed_refresh_keeps_addresses) {
+    fake_resolver r{.addrs = {ip1}};
+    rpc::dns_cache cache(r.fn(), 0ms);
+
+    cache.resolve(host).get();
+    r.fail = true;
+    BOOST_REQUIRE_EQUAL(cache.resolve(host).get0().addr(), ip1);
+    ss::sleep(10ms).get();
+    // the next refresh waits for the retry interval
+    BOOST_REQUIRE_EQUAL(cache.resolve(host).get0().addr(), ip1);
+    BOOST_REQUIRE_EQUAL(r.calls, 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(failed_resolution) {
+    fake_resolver r{.fail = true};
+    rpc::dns_cache cache(r.fn(), 1h);
+
+    BOOST_REQUIRE_THROW(cache.resolve(host).get(), std::runtime_error);
+    r.fail = false;
+    r.addrs = {ip1};
+    BOOST_REQUIRE_EQUAL(cache.resolve(host).get0().addr(), ip1);
+    BOOST_REQUIRE_EQUAL(r.calls, 2);
+}
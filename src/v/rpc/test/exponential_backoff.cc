@@ -49,4 +49,17 @@ BOOST_AUTO_TEST_CASE(exponential_backoff_policy_test) {
     BOOST_CHECK(p.current_backoff_duration() == 1s);
     p.next_backoff();
     BOOST_CHECK(p.current_backoff_duration() == 2s);
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(exponential_backoff_policy_clone_test) {
+    using namespace std::chrono_literals;
+    rpc::backoff_policy p
+      = rpc::make_exponential_backoff_policy<ss::lowres_clock>(1s, 120s);
+    p.next_backoff();
+    p.next_backoff();
+
+    auto c = p.clone();
+    BOOST_CHECK(c.current_backoff_duration() == 0s);
+    c.next_backoff();
+    BOOST_CHECK(c.current_backoff_duration() == 1s);
+    BOOST_CHECK(p.current_backoff_duration() == 2s);
+}
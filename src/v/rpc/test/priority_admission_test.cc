@@ -0,0 +1,110 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "rpc/priority_admission.h"
+
+#include <seastar/core/thread.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <vector>
+
+using rpc::method_priority;
+
+SEASTAR_THREAD_TEST_CASE(reservation_granted_when_memory_available) {
+    rpc::priority_admission admission(100);
+    auto f = admission.reserve(method_priority::normal, 60);
+    BOOST_REQUIRE(f.available());
+    auto units = f.get0();
+    BOOST_REQUIRE_EQUAL(admission.memory().available_units(), 40);
+}
+
+SEASTAR_THREAD_TEST_CASE(waiters_granted_in_priority_order) {
+    rpc::priority_admission admission(100);
+    auto all = admission.reserve(method_priority::normal, 100).get0();
+
+    std::vector<method_priority> granted;
+    auto reserve = [&](method_priority p, size_t bytes) {
+        return admission.reserve(p, bytes).then(
+          [&granted, p](ss::semaphore_units<> u) {
+              granted.push_back(p);
+              return u;
+          });
+    };
+    // the first waiter waits on the semaphore, the others are queued
+    auto low = reserve(method_priority::low, 100);
+    auto normal = reserve(method_priority::normal, 100);
+    auto critical = reserve(method_priority::critical, 100);
+    BOOST_REQUIRE_EQUAL(admission.waiters(), 3);
+
+    all.return_all();
+    low.get0().return_all();
+    critical.get0().return_all();
+    normal.get0().return_all();
+    const std::vector<method_priority> expected{
+      method_priority::low, method_priority::critical, method_priority::normal};
+    BOOST_REQUIRE(granted == expected);
+}
+
+SEASTAR_THREAD_TEST_CASE(higher_priority_takes_available_memory) {
+    rpc::priority_admission admission(100);
+    auto some = admission.reserve(method_priority::normal, 50).get0();
+    // waits for more memory than available
+    auto low = admission.reserve(method_priority::low, 100);
+    BOOST_REQUIRE(!low.available());
+
+    // the heartbeat doesn't wait behind the lower priority reservation
+    auto critical = admission.reserve(method_priority::critical, 10);
+    BOOST_REQUIRE(critical.available());
+    // a reservation of the same priority waits for its turn
+    auto other_low = admission.reserve(method_priority::low, 10);
+    BOOST_REQUIRE(!other_low.available());
+
+    critical.get0().return_all();
+    some.return_all();
+    low.get0().return_all();
+    other_low.get0();
+}
+
+SEASTAR_THREAD_TEST_CASE(can_reserve_reports_waiting) {
+    rpc::priority_admission admission(100);
+    BOOST_REQUIRE(admission.can_reserve(method_priority::low, 100));
+    BOOST_REQUIRE(!admission.can_reserve(method_priority::low, 101));
+
+    auto some = admission.reserve(method_priority::normal, 50).get0();
+    auto normal = admission.reserve(method_priority::normal, 100);
+    BOOST_REQUIRE(!normal.available());
+    // the memory is available but the normal reservation is queued first
+    BOOST_REQUIRE(!admission.can_reserve(method_priority::low, 10));
+    BOOST_REQUIRE(!admission.can_reserve(method_priority::normal, 10));
+    BOOST_REQUIRE(admission.can_reserve(method_priority::critical, 10));
+
+    some.return_all();
+    normal.get0();
+}
+
+SEASTAR_THREAD_TEST_CASE(resize_changes_the_available_memory) {
+    rpc::priority_admission admission(100);
+    auto some = admission.reserve(method_priority::normal, 80).get0();
+    auto waiting = admission.reserve(method_priority::normal, 40);
+    BOOST_REQUIRE(!waiting.available());
+
+    // a larger capacity grants the waiting reservation
+    admission.resize(130);
+    BOOST_REQUIRE_EQUAL(admission.capacity(), 130);
+    auto more = waiting.get0();
+    BOOST_REQUIRE(!admission.can_reserve(method_priority::low, 20));
+
+    // below the reserved memory nothing is granted until it is returned
+    admission.resize(50);
+    some.return_all();
+    BOOST_REQUIRE(!admission.can_reserve(method_priority::low, 20));
+    more.return_all();
+    BOOST_REQUIRE(admission.can_reserve(method_priority::low, 50));
+    BOOST_REQUIRE(!admission.can_reserve(method_priority::low, 51));
+}
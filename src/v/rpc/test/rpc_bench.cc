@@ -8,6 +8,8 @@
 // by the Apache License, Version 2.0
 
 #include "reflection/adl.h"
+#include "serde/envelope.h"
+#include "serde/serde.h"
 
 #include <seastar/core/reactor.hh>
 #include <seastar/core/sharded.hh>
@@ -85,3 +87,81 @@ PERF_TEST(big_10mb, serialize) {
 PERF_TEST(big_10mb, deserialize) {
     return deserialize_big(10 << 20 /*10MB*/, 1 << 15 /*32KB*/);
 }
+
+// heartbeats of 1000 raft groups, as an array of structures encoded with adl
+// and as a structure of arrays encoded with serde
+
+struct heartbeat_meta {
+    int64_t group;
+    int64_t commit_index;
+    int64_t term;
+    int64_t prev_log_index;
+    int64_t prev_log_term;
+};
+
+struct heartbeats_adl {
+    std::vector<heartbeat_meta> meta;
+};
+
+struct heartbeats_serde
+  : serde::envelope<heartbeats_serde, serde::version<0>> {
+    std::vector<int64_t> groups;
+    std::vector<int64_t> commit_indices;
+    std::vector<int64_t> terms;
+    std::vector<int64_t> prev_log_indices;
+    std::vector<int64_t> prev_log_terms;
+};
+
+static constexpr int64_t heartbeat_groups = 1000;
+
+inline heartbeats_adl gen_heartbeats_adl() {
+    heartbeats_adl ret;
+    for (int64_t g = 0; g < heartbeat_groups; ++g) {
+        ret.meta.push_back(heartbeat_meta{g, 1000 + g, 3, 1000 + g, 3});
+    }
+    return ret;
+}
+
+inline heartbeats_serde gen_heartbeats_serde() {
+    heartbeats_serde ret;
+    for (int64_t g = 0; g < heartbeat_groups; ++g) {
+        ret.groups.push_back(g);
+        ret.commit_indices.push_back(1000 + g);
+        ret.terms.push_back(3);
+        ret.prev_log_indices.push_back(1000 + g);
+        ret.prev_log_terms.push_back(3);
+    }
+    return ret;
+}
+
+PERF_TEST(heartbeats_adl, serialize) {
+    auto hb = gen_heartbeats_adl();
+    perf_tests::start_measuring_time();
+    auto o = reflection::to_iobuf(std::move(hb));
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(heartbeats_adl, deserialize) {
+    auto b = reflection::to_iobuf(gen_heartbeats_adl());
+    perf_tests::start_measuring_time();
+    auto result = reflection::adl<heartbeats_adl>().from(std::move(b));
+    perf_tests::do_not_optimize(result);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(heartbeats_serde, serialize) {
+    auto hb = gen_heartbeats_serde();
+    perf_tests::start_measuring_time();
+    auto o = serde::to_iobuf(std::move(hb));
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(heartbeats_serde, deserialize) {
+    auto b = serde::to_iobuf(gen_heartbeats_serde());
+    perf_tests::start_measuring_time();
+    auto result = serde::from_iobuf<heartbeats_serde>(std::move(b));
+    perf_tests::do_not_optimize(result);
+    perf_tests::stop_measuring_time();
+}
@@ -14,6 +14,7 @@
 #include "rpc/test/rpc_integration_fixture.h"
 #include "rpc/types.h"
 #include "test_utils/fixture.h"
+#include "units.h"
 
 #include <seastar/core/condition-variable.hh>
 #include <seastar/core/seastar.hh>
@@ -201,6 +202,25 @@ FIXTURE_TEST(rpcgen_reload_credentials_integration, rpc_integration_fixture) {
     cli.stop().get0();
 }
 
+FIXTURE_TEST(echo_serde, rpc_integration_fixture) {
+    configure_server();
+    register_services();
+    start_server();
+
+    rpc::client<echo::echo_client_protocol> cli(client_config());
+    cli.connect(model::no_timeout).get();
+    std::vector<int64_t> offsets{0, 1, 1 << 20, -1};
+    auto ret = cli.echo_serde(
+                    echo::echo_req_serde{.str = "serde", .offsets = offsets},
+                    rpc::client_opts(rpc::no_timeout))
+                 .get0();
+    cli.stop().get();
+
+    BOOST_REQUIRE(ret.has_value());
+    BOOST_REQUIRE_EQUAL(ret.value().data.str, "serde");
+    BOOST_REQUIRE(ret.value().data.offsets == offsets);
+}
+
 FIXTURE_TEST(client_muxing, rpc_integration_fixture) {
     configure_server();
     // Two services @ single server
@@ -244,6 +264,73 @@ FIXTURE_TEST(timeout_test, rpc_integration_fixture) {
     client.stop().get();
 }
 
+FIXTURE_TEST(streaming_method, rpc_integration_fixture) {
+    configure_server();
+    register_services();
+    start_server();
+
+    rpc::client<echo::echo_client_protocol> client(client_config());
+    client.connect(model::no_timeout).get();
+    const auto data = random_generators::gen_alphanum_string(256_KiB);
+    // the handler reads only the prefix, the rest of the body is skipped
+    for (auto compression :
+         {rpc::compression_type::none, rpc::compression_type::zstd}) {
+        auto ret = client
+                     .streaming_prefix(
+                       echo::echo_req{.str = data},
+                       rpc::client_opts(rpc::no_timeout, compression, 0))
+                     .get0();
+        BOOST_REQUIRE_EQUAL(ret.value().data.str, data.substr(0, 16));
+    }
+    auto short_str = client
+                       .streaming_prefix(
+                         echo::echo_req{.str = "short"},
+                         rpc::client_opts(rpc::no_timeout))
+                       .get0();
+    BOOST_REQUIRE_EQUAL(short_str.value().data.str, "short");
+    // the connection parses the requests that follow the streamed body
+    auto echo_resp = client
+                       .echo(
+                         echo::echo_req{.str = "after"},
+                         rpc::client_opts(rpc::no_timeout))
+                       .get0();
+    BOOST_REQUIRE_EQUAL(echo_resp.value().data.str, "after");
+    client.stop().get();
+}
+
+FIXTURE_TEST(busy_server_rejects_request, rpc_integration_fixture) {
+    _max_service_memory = 1024;
+    configure_server();
+    register_services();
+    start_server();
+
+    rpc::client<echo::echo_client_protocol> client(client_config());
+    client.connect(model::no_timeout).get();
+    // the client learns that the server handles the busy flag
+    auto small = client
+                   .echo(
+                     echo::echo_req{.str = "small"},
+                     rpc::client_opts(rpc::no_timeout))
+                   .get0();
+    BOOST_REQUIRE(small.has_value());
+    // the request needs more memory than the server has
+    auto large = client
+                   .echo(
+                     echo::echo_req{.str = ss::sstring(2048, 'x')},
+                     rpc::client_opts(rpc::no_timeout))
+                   .get0();
+    BOOST_REQUIRE(large.has_error());
+    BOOST_REQUIRE_EQUAL(large.error(), rpc::errc::server_busy);
+    // the connection stays usable
+    small = client
+              .echo(
+                echo::echo_req{.str = "small"},
+                rpc::client_opts(rpc::no_timeout))
+              .get0();
+    BOOST_REQUIRE_EQUAL(small.value().data.str, "small");
+    client.stop().get();
+}
+
 FIXTURE_TEST(rpc_mixed_compression, rpc_integration_fixture) {
     const auto data = random_generators::gen_alphanum_string(1024);
     configure_server();
@@ -12,10 +12,12 @@
 #pragma once
 
 #include "seastarx.h"
+#include "serde/envelope.h"
 
 #include <seastar/core/sstring.hh>
 
 #include <cstdint>
+#include <vector>
 
 namespace cycling {
 struct ultimate_cf_slx {
@@ -41,6 +43,18 @@ struct echo_resp {
     ss::sstring str;
 };
 
+struct echo_req_serde
+  : serde::envelope<echo_req_serde, serde::version<1>> {
+    ss::sstring str;
+    std::vector<int64_t> offsets;
+};
+
+struct echo_resp_serde
+  : serde::envelope<echo_resp_serde, serde::version<1>> {
+    ss::sstring str;
+    std::vector<int64_t> offsets;
+};
+
 struct cnt_req {
     uint64_t expected;
 };
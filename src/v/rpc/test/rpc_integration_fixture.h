@@ -22,6 +22,7 @@
 #include "rpc/types.h"
 #include "seastarx.h"
 
+#include <seastar/core/byteorder.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/core/smp.hh>
@@ -52,6 +53,12 @@ struct echo_impl final : echo::echo_service {
         return ss::make_ready_future<echo::echo_resp>(
           echo::echo_resp{.str = req.str});
     }
+    ss::future<echo::echo_resp_serde>
+    echo_serde(echo::echo_req_serde&& req, rpc::streaming_context&) final {
+        return ss::make_ready_future<echo::echo_resp_serde>(
+          echo::echo_resp_serde{
+            .str = req.str, .offsets = std::move(req.offsets)});
+    }
     ss::future<echo::echo_resp>
     prefix_echo(echo::echo_req&& req, rpc::streaming_context&) final {
         return ss::make_ready_future<echo::echo_resp>(
@@ -70,6 +77,22 @@ struct echo_impl final : echo::echo_service {
           []() { return echo::echo_resp{.str = "Zzz..."}; });
     }
 
+    /// replies with the first bytes of the string, without reading the rest
+    ss::future<echo::echo_resp>
+    streaming_prefix(rpc::request_body& body, rpc::streaming_context&) final {
+        static constexpr int32_t max_prefix = 16;
+        return body.input()
+          .read_exactly(sizeof(int32_t))
+          .then([&body](ss::temporary_buffer<char> len) {
+              auto n = std::min(ss::read_le<int32_t>(len.get()), max_prefix);
+              return body.input().read_exactly(n);
+          })
+          .then([](ss::temporary_buffer<char> prefix) {
+              return echo::echo_resp{
+                .str = ss::sstring(prefix.get(), prefix.size())};
+          });
+    }
+
     ss::future<echo::cnt_resp>
     counter(echo::cnt_req&& req, rpc::streaming_context&) final {
         return ss::make_ready_future<echo::cnt_resp>(
@@ -125,9 +148,16 @@ public:
     }
 
 protected:
+    int64_t max_service_memory() const {
+        return _max_service_memory.value_or(
+          static_cast<int64_t>(ss::memory::stats().total_memory() / 10));
+    }
+
     unresolved_address _listen_address;
     ss::smp_service_group _ssg;
     ss::scheduling_group _sg;
+    /// memory of the requests, a tenth of the shard memory if not set
+    std::optional<int64_t> _max_service_memory;
 
 private:
     virtual void check_server() = 0;
@@ -163,8 +193,7 @@ public:
             ? credentials->build_reloadable_server_credentials(std::move(cb))
                 .get0()
             : nullptr);
-        scfg.max_service_memory_per_core = static_cast<int64_t>(
-          ss::memory::stats().total_memory() / 10);
+        scfg.max_service_memory_per_core = max_service_memory();
         _server = std::make_unique<rpc::server>(std::move(scfg));
         _proto = std::make_unique<rpc::simple_protocol>();
     }
@@ -210,8 +239,7 @@ public:
             ? credentials->build_reloadable_server_credentials(std::move(cb))
                 .get0()
             : nullptr);
-        scfg.max_service_memory_per_core = static_cast<int64_t>(
-          ss::memory::stats().total_memory() / 10);
+        scfg.max_service_memory_per_core = max_service_memory();
         _server.start(std::move(scfg)).get();
     }
 
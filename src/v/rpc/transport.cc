@@ -9,6 +9,7 @@
 
 #include "rpc/transport.h"
 
+#include "finjector/hbadger.h"
 #include "likely.h"
 #include "rpc/dns.h"
 #include "rpc/logger.h"
@@ -50,7 +51,8 @@ struct client_context_impl final : streaming_context {
 base_transport::base_transport(configuration c)
   : _server_addr(c.server_addr)
   , _creds(c.credentials)
-  , _tls_sni_hostname(c.tls_sni_hostname) {}
+  , _tls_sni_hostname(c.tls_sni_hostname)
+  , _cork_delay(c.cork_delay) {}
 
 transport::transport(
   transport_configuration c,
@@ -58,10 +60,11 @@ transport::transport(
   : base_transport(base_transport::configuration{
     .server_addr = std::move(c.server_addr),
     .credentials = std::move(c.credentials),
+    .cork_delay = c.cork_delay,
   })
   , _memory(c.max_queued_bytes) {
     if (!c.disable_metrics) {
-        setup_metrics(service_name);
+        setup_metrics(service_name, c.connection_index);
     }
 }
 
@@ -99,7 +102,12 @@ ss::future<> base_transport::do_connect(clock_type::time_point timeout) {
         _fd = std::make_unique<ss::connected_socket>(std::move(fd));
         _probe.connection_established();
         _in = _fd->input();
-        _out = batched_output_stream(_fd->output());
+        _out = batched_output_stream(
+          _fd->output(),
+          batched_output_stream::default_max_unflushed_bytes,
+          _cork_delay);
+        _out.set_flush_observer(
+          [this](size_t bytes) { _probe.add_flush(bytes); });
     } catch (...) {
         auto e = std::current_exception();
         _probe.connection_error(e);
@@ -162,6 +170,8 @@ transport::connect(rpc::clock_type::time_point connection_timeout) {
         _correlation_idx = 0;
         _last_seq = sequence_t{0};
         _seq = sequence_t{0};
+        // the server may have been replaced by one of an older version
+        _server_accepts_timeout = false;
         // background
         (void)ss::with_gate(_dispatch_gate, [this] {
             return do_reads().then_wrapped([this](ss::future<> f) {
@@ -223,6 +233,14 @@ transport::do_send(sequence_t seq, netbuf b, rpc::client_opts opts) {
         _last_seq = std::max(_last_seq, seq);
         return ss::make_ready_future<ret_t>(errc::disconnected_endpoint);
     }
+    if (_server_accepts_timeout) {
+        b.set_deadline(opts.timeout);
+        if (opts.conn_class == connection_class::bulk) {
+            b.set_flag(header_flags::bulk);
+        }
+        // the server that accepts the timeout knows how to reply busy
+        b.set_flag(header_flags::busy);
+    }
     return ss::with_gate(
       _dispatch_gate,
       [this, b = std::move(b), opts = std::move(opts), seq]() mutable {
@@ -259,12 +277,26 @@ void transport::dispatch_send() {
               auto it = _requests_queue.begin();
               _last_seq = it->first;
               auto buffer = std::move(it->second).get();
+              const bool compress = buffer->should_compress();
+              const auto uncompressed = buffer->buffer().size_bytes();
+              const auto start = ss::steady_clock_type::now();
               auto v = std::move(*buffer).as_scattered();
               auto msg_size = v.size();
+              if (compress) {
+                  _probe.add_compression(
+                    uncompressed,
+                    msg_size - size_of_rpc_header,
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                      ss::steady_clock_type::now() - start));
+              }
               _requests_queue.erase(it->first);
-              return _out.write(std::move(v)).finally([this, msg_size] {
-                  _probe.add_bytes_sent(msg_size);
-              });
+              return finjector::inject_io_fault(
+                       finjector::io_point::rpc_send, msg_size)
+                .then([this, v = std::move(v)]() mutable {
+                    return _out.write(std::move(v));
+                })
+                .finally(
+                  [this, msg_size] { _probe.add_bytes_sent(msg_size); });
           });
     }).handle_exception([this](std::exception_ptr e) {
         vlog(rpclog.info, "Error dispatching socket write:{}", e);
@@ -295,6 +327,9 @@ ss::future<> transport::do_reads() {
 /// - this needs a streaming_context.
 ///
 ss::future<> transport::dispatch(header h) {
+    if (has_flag(h, header_flags::timeout)) {
+        _server_accepts_timeout = true;
+    }
     auto it = _correlations.find(h.correlation_id);
     if (it == _correlations.end()) {
         // We removed correlation already
@@ -318,8 +353,11 @@ ss::future<> transport::dispatch(header h) {
     return fut;
 }
 
-void transport::setup_metrics(const std::optional<ss::sstring>& service_name) {
-    _probe.setup_metrics(_metrics, service_name, server_address());
+void transport::setup_metrics(
+  const std::optional<ss::sstring>& service_name,
+  std::optional<uint16_t> connection_index) {
+    _probe.setup_metrics(
+      _metrics, service_name, server_address(), connection_index);
 }
 
 transport::~transport() {
@@ -50,6 +50,8 @@ public:
         rpc::metrics_disabled disable_metrics = rpc::metrics_disabled::no;
         /// Optional server name indication (SNI) for TLS connection
         std::optional<ss::sstring> tls_sni_hostname;
+        /// delay of the corked flushes, see batched_output_stream
+        std::optional<std::chrono::microseconds> cork_delay;
     };
 
     explicit base_transport(configuration c);
@@ -83,6 +85,7 @@ private:
     unresolved_address _server_addr;
     ss::shared_ptr<ss::tls::certificate_credentials> _creds;
     std::optional<ss::sstring> _tls_sni_hostname;
+    std::optional<std::chrono::microseconds> _cork_delay;
 };
 
 class transport final : public base_transport {
@@ -114,7 +117,8 @@ private:
     ss::future<> do_reads();
     ss::future<> dispatch(header);
     void fail_outstanding_futures() noexcept final;
-    void setup_metrics(const std::optional<ss::sstring>&);
+    void setup_metrics(
+      const std::optional<ss::sstring>&, std::optional<uint16_t>);
 
     ss::future<result<std::unique_ptr<streaming_context>>>
       do_send(sequence_t, netbuf, rpc::client_opts);
@@ -127,6 +131,9 @@ private:
     absl::flat_hash_map<uint32_t, std::unique_ptr<internal::response_handler>>
       _correlations;
     uint32_t _correlation_idx{0};
+    // set once the server marks its replies with header_flags::timeout, only
+    // then the requests carry the client timeout and the header flags
+    bool _server_accepts_timeout{false};
     ss::metrics::metric_groups _metrics;
     /**
      * ordered map containing in-flight requests. The map preserves order of
@@ -140,6 +147,27 @@ private:
 };
 
 namespace internal {
+/// error of a reply that didn't succeed
+inline errc map_status(status st) {
+    if (st == status::request_timeout) {
+        return errc::client_request_timeout;
+    }
+
+    if (st == status::server_error) {
+        return errc::service_error;
+    }
+
+    if (st == status::method_not_found) {
+        return errc::method_not_found;
+    }
+
+    if (st == status::service_unavailable) {
+        return errc::server_busy;
+    }
+
+    return errc::service_error;
+}
+
 template<typename T>
 result<rpc::client_context<T>> map_result(const header& hdr, T data) {
     using ret_t = result<rpc::client_context<T>>;
@@ -151,19 +179,7 @@ result<rpc::client_context<T>> map_result(const header& hdr, T data) {
         return ret_t(std::move(ctx));
     }
 
-    if (st == status::request_timeout) {
-        return ret_t(errc::client_request_timeout);
-    }
-
-    if (st == status::server_error) {
-        return ret_t(errc::service_error);
-    }
-
-    if (st == status::method_not_found) {
-        return ret_t(errc::method_not_found);
-    }
-
-    return ret_t(errc::service_error);
+    return ret_t(map_status(st));
 }
 } // namespace internal
 
@@ -181,8 +197,7 @@ transport::send_typed(Input r, uint32_t method_id, rpc::client_opts opts) {
 
     auto& target_buffer = raw_b->buffer();
     auto seq = ++_seq;
-    return reflection::async_adl<Input>{}
-      .to(target_buffer, std::move(r))
+    return write_payload(target_buffer, std::move(r))
       .then([this, b = std::move(b), seq, opts = std::move(opts)]() mutable {
           return do_send(seq, std::move(*b.get()), std::move(opts));
       })
@@ -190,6 +205,16 @@ transport::send_typed(Input r, uint32_t method_id, rpc::client_opts opts) {
           if (!sctx) {
               return ss::make_ready_future<ret_t>(sctx.error());
           }
+          const auto st = static_cast<status>(
+            sctx.value()->get_header().meta);
+          if (st != status::success) {
+              // the replies of the failed requests carry no payload
+              return _in.skip(sctx.value()->get_header().payload_size)
+                .then([sctx = std::move(sctx), st] {
+                    sctx.value()->signal_body_parse();
+                    return ret_t(internal::map_status(st));
+                });
+          }
           return parse_type<Output>(_in, sctx.value()->get_header())
             .then([sctx = std::move(sctx)](Output o) {
                 sctx.value()->signal_body_parse();
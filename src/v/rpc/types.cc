@@ -26,7 +26,8 @@ void crc_one(crc::crc32c& crc, T t) {
     crc.extend(args_le);
 }
 
-uint32_t checksum_header_only(const header& h) {
+uint32_t
+checksum_header_only(const header& h, std::optional<uint32_t> timeout_ms) {
     auto crc = crc::crc32c();
     crc_one(
       crc,
@@ -35,6 +36,9 @@ uint32_t checksum_header_only(const header& h) {
     crc_one(crc, h.meta);
     crc_one(crc, h.correlation_id);
     crc_one(crc, h.payload_checksum);
+    if (timeout_ms) {
+        crc_one(crc, *timeout_ms);
+    }
     return crc.value();
 }
 
@@ -84,9 +88,23 @@ std::ostream& operator<<(std::ostream& o, const status& s) {
         return o << "rpc::status::request_timeout";
     case status::server_error:
         return o << "rpc::status::server_error";
+    case status::service_unavailable:
+        return o << "rpc::status::service_unavailable";
     default:
         return o << "rpc::status::unknown";
     }
 }
 
+std::ostream& operator<<(std::ostream& o, connection_class c) {
+    switch (c) {
+    case connection_class::control:
+        return o << "control";
+    case connection_class::data:
+        return o << "data";
+    case connection_class::bulk:
+        return o << "bulk";
+    }
+    return o << "unknown";
+}
+
 } // namespace rpc
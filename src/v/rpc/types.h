@@ -31,6 +31,8 @@
 #include <chrono>
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -63,11 +65,13 @@ enum class status : uint32_t {
     method_not_found = 404,
     request_timeout = 408,
     server_error = 500,
+    /// the server is out of memory for the requests, retry later
+    service_unavailable = 503,
 };
 
 /// \brief core struct for communications. sent with _each_ payload
 struct header {
-    /// \brief version is unused. always 0. can be used for bitflags as well
+    /// \brief version is unused. carries the header_flags bits
     uint8_t version{0};
     /// \brief everything below the checksum is hashed with crc32
     uint32_t header_checksum{0};
@@ -97,7 +101,74 @@ static constexpr size_t size_of_rpc_header
 static_assert(
   size_of_rpc_header == 26, "Be gentil when extending this header. expensive");
 
-uint32_t checksum_header_only(const header& h);
+/// \brief bit flags carried in the version field of the header
+///
+/// The servers that don't know the flags ignore them, but they can't parse
+/// the header timeout. Clients only send the timeout, and the flags of the
+/// requests, once the server marked its replies with header_flags::timeout.
+enum class header_flags : uint8_t {
+    none = 0,
+    /// on a request: the client timeout follows the header. On a reply: the
+    /// server accepts the requests with a timeout
+    timeout = 1,
+    /// the request is a bulk transfer, admitted after all the other requests
+    bulk = 1 << 1,
+    /// the client handles status::service_unavailable, the server may reject
+    /// the request instead of queueing it when it is out of memory
+    busy = 1 << 2,
+};
+
+inline bool has_flag(const header& h, header_flags f) {
+    return (h.version & static_cast<uint8_t>(f)) != 0;
+}
+
+inline void set_flag(header& h, header_flags f) {
+    h.version |= static_cast<uint8_t>(f);
+}
+
+/// \brief the remaining client timeout in milliseconds, sent after the
+/// header of the requests flagged with header_flags::timeout
+static constexpr size_t size_of_rpc_header_timeout = sizeof(uint32_t);
+
+/// \brief header of a received request
+struct request_header {
+    header hdr;
+    /// the time the client is going to wait for the reply, counted from the
+    /// moment the request was sent
+    std::optional<std::chrono::milliseconds> timeout;
+};
+
+/// \brief order in which the server admits the requests waiting for memory
+enum class method_priority : uint8_t {
+    /// heartbeats, keep the leadership of the groups
+    critical = 0,
+    /// elections
+    high,
+    normal,
+    /// recovery and other bulk transfers
+    low,
+};
+
+static constexpr size_t method_priorities = 4;
+
+/// \brief checksum of the header, that covers the header timeout as well when
+/// the request carries one
+uint32_t checksum_header_only(
+  const header& h, std::optional<uint32_t> timeout_ms = std::nullopt);
+
+/// Class of the traffic a client request belongs to. The connection cache
+/// sends the classes over separate connections to the same node, so that the
+/// latency critical requests don't queue behind bulk transfers.
+enum class connection_class : uint8_t {
+    /// heartbeats, votes and other small latency critical requests
+    control,
+    /// requests of one flow are kept on one connection, in order
+    data,
+    /// recovery transfers
+    bulk,
+};
+
+std::ostream& operator<<(std::ostream&, connection_class);
 
 struct client_opts {
     client_opts(
@@ -121,6 +192,7 @@ struct client_opts {
     clock_type::time_point timeout;
     compression_type compression;
     size_t min_compression_bytes;
+    connection_class conn_class{connection_class::data};
 };
 
 /// \brief used to pass environment context to the class
@@ -136,6 +208,11 @@ public:
     virtual ~streaming_context() noexcept = default;
     virtual ss::future<ss::semaphore_units<>> reserve_memory(size_t) = 0;
     virtual const header& get_header() const = 0;
+    /// \brief time after which the client is no longer waiting for the reply,
+    /// if the client sent its timeout
+    virtual std::optional<clock_type::time_point> deadline() const {
+        return std::nullopt;
+    }
     /// \brief because we parse the input as a _stream_ we need to signal
     /// to the dispatching thread that it can resume parsing for a new RPC
     virtual void signal_body_parse() = 0;
@@ -156,8 +233,28 @@ private:
 
 /// \brief most method implementations will be codegenerated
 /// by $root/tools/rpcgen.py
-using method = ss::noncopyable_function<ss::future<netbuf>(
-  ss::input_stream<char>&, streaming_context&)>;
+struct method {
+    using handler = ss::noncopyable_function<ss::future<netbuf>(
+      ss::input_stream<char>&, streaming_context&)>;
+
+    explicit method(
+      handler h,
+      method_priority p = method_priority::normal,
+      std::string_view n = {})
+      : handle(std::move(h))
+      , priority(p)
+      , name(n) {}
+
+    ss::future<netbuf>
+    operator()(ss::input_stream<char>& in, streaming_context& ctx) {
+        return handle(in, ctx);
+    }
+
+    handler handle;
+    method_priority priority;
+    /// fully qualified name of the method, labels its metrics
+    std::string_view name;
+};
 
 /// \brief used in returned types for client::send_typed() calls
 template<typename T>
@@ -212,6 +309,8 @@ struct server_configuration {
     // we use the same default as seastar for load balancing algorithm
     ss::server_socket::load_balancing_algorithm load_balancing_algo
       = ss::server_socket::load_balancing_algorithm::connection_distribution;
+    /// when set the writes are corked, see batched_output_stream
+    std::optional<std::chrono::microseconds> cork_delay;
 
     explicit server_configuration(ss::sstring n)
       : name(std::move(n)) {}
@@ -226,6 +325,11 @@ struct transport_configuration {
     uint32_t max_queued_bytes = std::numeric_limits<uint32_t>::max();
     ss::shared_ptr<ss::tls::certificate_credentials> credentials;
     metrics_disabled disable_metrics = metrics_disabled::no;
+    /// set when multiple connections are opened to the same server, tells
+    /// their metrics apart
+    std::optional<uint16_t> connection_index;
+    /// when set the writes are corked, see batched_output_stream
+    std::optional<std::chrono::microseconds> cork_delay;
 };
 
 std::ostream& operator<<(std::ostream&, const header&);
@@ -12,12 +12,14 @@
 
 #include "bytes/iobuf.h"
 #include "bytes/iobuf_istreambuf.h"
+#include "finjector/hbadger.h"
 #include "hashing/secure.h"
 #include "rpc/types.h"
 #include "s3/error.h"
 #include "s3/logger.h"
 #include "s3/signature.h"
 #include "ssx/sformat.h"
+#include "utils/base64.h"
 
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/condition-variable.hh>
@@ -54,8 +56,19 @@ struct aws_header_values {
     static constexpr boost::beast::string_view user_agent
       = "redpanda.vectorized.io";
     static constexpr boost::beast::string_view text_plain = "text/plain";
+    static constexpr boost::beast::string_view application_xml
+      = "application/xml";
 };
 
+/// Format object tags in the form expected by the x-amz-tagging header
+static std::string format_tags(const std::vector<object_tag>& tags) {
+    std::stringstream tstr;
+    for (const auto& [key, val] : tags) {
+        tstr << fmt::format("&{}={}", key, val);
+    }
+    return tstr.str().substr(1);
+}
+
 // configuration //
 
 static ss::sstring make_endpoint_url(
@@ -126,13 +139,18 @@ request_creator::request_creator(const configuration& conf)
   , _sign(conf.region, conf.access_key, conf.secret_key) {}
 
 result<http::client::request_header> request_creator::make_get_object_request(
-  bucket_name const& name, object_key const& key) {
+  bucket_name const& name,
+  object_key const& key,
+  std::optional<byte_range> range,
+  std::optional<ss::sstring> if_none_match) {
     http::client::request_header header{};
     // GET /{object-id} HTTP/1.1
     // Host: {bucket-name}.s3.amazonaws.com
     // x-amz-date:{req-datetime}
     // Authorization:{signature}
     // x-amz-content-sha256:e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855
+    // Range: bytes={first}-{last} (optional)
+    // If-None-Match: {etag} (optional)
     auto host = fmt::format("{}.{}", name(), _ap());
     auto target = fmt::format("/{}", key().string());
     std::string emptysig
@@ -144,6 +162,14 @@ result<http::client::request_header> request_creator::make_get_object_request(
     header.insert(boost::beast::http::field::host, host);
     header.insert(boost::beast::http::field::content_length, "0");
     header.insert(aws_header_names::x_amz_content_sha256, emptysig);
+    if (range) {
+        header.insert(
+          boost::beast::http::field::range,
+          fmt::format("bytes={}-{}", range->first, range->last));
+    }
+    if (if_none_match) {
+        header.insert(boost::beast::http::field::if_none_match, *if_none_match);
+    }
     _sign.update_credentials_if_outdated();
     auto ec = _sign.sign_header(header, emptysig);
     if (ec) {
@@ -183,12 +209,118 @@ request_creator::make_unsigned_put_object_request(
       std::to_string(payload_size_bytes));
     header.insert(aws_header_names::x_amz_content_sha256, sig);
     if (!tags.empty()) {
-        std::stringstream tstr;
-        for (const auto& [key, val] : tags) {
-            tstr << fmt::format("&{}={}", key, val);
-        }
-        header.insert(aws_header_names::x_amz_tagging, tstr.str().substr(1));
+        header.insert(aws_header_names::x_amz_tagging, format_tags(tags));
+    }
+    _sign.update_credentials_if_outdated();
+    auto ec = _sign.sign_header(header, sig);
+    if (ec) {
+        return ec;
+    }
+    return header;
+}
+
+result<http::client::request_header>
+request_creator::make_create_multipart_upload_request(
+  bucket_name const& name,
+  object_key const& key,
+  const std::vector<object_tag>& tags) {
+    // POST /{object-id}?uploads HTTP/1.1
+    // Host: {bucket-name}.s3.amazonaws.com
+    // x-amz-date:{req-datetime}
+    // Authorization:{signature}
+    // x-amz-tagging: {tags}
+    http::client::request_header header{};
+    auto host = fmt::format("{}.{}", name(), _ap());
+    auto target = fmt::format("/{}?uploads", key().string());
+    std::string emptysig
+      = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+    header.method(boost::beast::http::verb::post);
+    header.target(target);
+    header.insert(
+      boost::beast::http::field::user_agent, aws_header_values::user_agent);
+    header.insert(boost::beast::http::field::host, host);
+    header.insert(
+      boost::beast::http::field::content_type, aws_header_values::text_plain);
+    header.insert(boost::beast::http::field::content_length, "0");
+    header.insert(aws_header_names::x_amz_content_sha256, emptysig);
+    if (!tags.empty()) {
+        header.insert(aws_header_names::x_amz_tagging, format_tags(tags));
+    }
+    _sign.update_credentials_if_outdated();
+    auto ec = _sign.sign_header(header, emptysig);
+    if (ec) {
+        return ec;
+    }
+    return header;
+}
+
+result<http::client::request_header>
+request_creator::make_unsigned_upload_part_request(
+  bucket_name const& name,
+  object_key const& key,
+  const multipart_upload_id& upload_id,
+  size_t part_number,
+  size_t payload_size_bytes) {
+    // PUT /{object-id}?partNumber={N}&uploadId={id} HTTP/1.1
+    // Host: {bucket-name}.s3.amazonaws.com
+    // x-amz-date:{req-datetime}
+    // Authorization:{signature}
+    // Content-Length: {size}
+    // [{size} bytes of part data]
+    http::client::request_header header{};
+    auto host = fmt::format("{}.{}", name(), _ap());
+    auto target = fmt::format(
+      "/{}?partNumber={}&uploadId={}",
+      key().string(),
+      part_number,
+      upload_id());
+    std::string sig = "UNSIGNED-PAYLOAD";
+    header.method(boost::beast::http::verb::put);
+    header.target(target);
+    header.insert(
+      boost::beast::http::field::user_agent, aws_header_values::user_agent);
+    header.insert(boost::beast::http::field::host, host);
+    header.insert(
+      boost::beast::http::field::content_length,
+      std::to_string(payload_size_bytes));
+    header.insert(aws_header_names::x_amz_content_sha256, sig);
+    _sign.update_credentials_if_outdated();
+    auto ec = _sign.sign_header(header, sig);
+    if (ec) {
+        return ec;
     }
+    return header;
+}
+
+result<http::client::request_header>
+request_creator::make_unsigned_complete_multipart_upload_request(
+  bucket_name const& name,
+  object_key const& key,
+  const multipart_upload_id& upload_id,
+  size_t payload_size_bytes) {
+    // POST /{object-id}?uploadId={id} HTTP/1.1
+    // Host: {bucket-name}.s3.amazonaws.com
+    // x-amz-date:{req-datetime}
+    // Authorization:{signature}
+    // Content-Type: application/xml
+    // Content-Length: {size}
+    // <CompleteMultipartUpload>...</CompleteMultipartUpload>
+    http::client::request_header header{};
+    auto host = fmt::format("{}.{}", name(), _ap());
+    auto target = fmt::format("/{}?uploadId={}", key().string(), upload_id());
+    std::string sig = "UNSIGNED-PAYLOAD";
+    header.method(boost::beast::http::verb::post);
+    header.target(target);
+    header.insert(
+      boost::beast::http::field::user_agent, aws_header_values::user_agent);
+    header.insert(boost::beast::http::field::host, host);
+    header.insert(
+      boost::beast::http::field::content_type,
+      aws_header_values::application_xml);
+    header.insert(
+      boost::beast::http::field::content_length,
+      std::to_string(payload_size_bytes));
+    header.insert(aws_header_names::x_amz_content_sha256, sig);
     _sign.update_credentials_if_outdated();
     auto ec = _sign.sign_header(header, sig);
     if (ec) {
@@ -197,6 +329,35 @@ request_creator::make_unsigned_put_object_request(
     return header;
 }
 
+result<http::client::request_header>
+request_creator::make_abort_multipart_upload_request(
+  bucket_name const& name,
+  object_key const& key,
+  const multipart_upload_id& upload_id) {
+    // DELETE /{object-id}?uploadId={id} HTTP/1.1
+    // Host: {bucket-name}.s3.amazonaws.com
+    // x-amz-date:{req-datetime}
+    // Authorization:{signature}
+    http::client::request_header header{};
+    auto host = fmt::format("{}.{}", name(), _ap());
+    auto target = fmt::format("/{}?uploadId={}", key().string(), upload_id());
+    std::string emptysig
+      = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+    header.method(boost::beast::http::verb::delete_);
+    header.target(target);
+    header.insert(
+      boost::beast::http::field::user_agent, aws_header_values::user_agent);
+    header.insert(boost::beast::http::field::host, host);
+    header.insert(boost::beast::http::field::content_length, "0");
+    header.insert(aws_header_names::x_amz_content_sha256, emptysig);
+    _sign.update_credentials_if_outdated();
+    auto ec = _sign.sign_header(header, emptysig);
+    if (ec) {
+        return ec;
+    }
+    return header;
+}
+
 result<http::client::request_header>
 request_creator::make_list_objects_v2_request(
   const bucket_name& name,
@@ -267,6 +428,48 @@ request_creator::make_delete_object_request(
     return header;
 }
 
+result<http::client::request_header>
+request_creator::make_delete_objects_request(
+  bucket_name const& name, std::string_view payload) {
+    // POST /?delete HTTP/1.1
+    // Host: {bucket-name}.s3.amazonaws.com
+    // x-amz-date:{req-datetime}
+    // Authorization:{signature}
+    // Content-MD5:{base64 encoded md5 of the payload}
+    // Content-Type: application/xml
+    // Content-Length: {size}
+    // <Delete>...</Delete>
+    //
+    // NOTE: Content-MD5 is mandatory for this request
+    http::client::request_header header{};
+    auto host = fmt::format("{}.{}", name(), _ap());
+    hash_md5 md5;
+    md5.update(payload);
+    auto digest = md5.reset();
+    auto content_md5 = bytes_to_base64(bytes_view(
+      reinterpret_cast<const uint8_t*>(digest.data()), digest.size()));
+    auto sig = signature_v4::sha256_hexdigest(payload);
+    header.method(boost::beast::http::verb::post);
+    header.target("/?delete");
+    header.insert(
+      boost::beast::http::field::user_agent, aws_header_values::user_agent);
+    header.insert(boost::beast::http::field::host, host);
+    header.insert(
+      boost::beast::http::field::content_type,
+      aws_header_values::application_xml);
+    header.insert(
+      boost::beast::http::field::content_length,
+      std::to_string(payload.size()));
+    header.insert(boost::beast::http::field::content_md5, content_md5);
+    header.insert(aws_header_names::x_amz_content_sha256, sig);
+    _sign.update_credentials_if_outdated();
+    auto ec = _sign.sign_header(header, sig);
+    if (ec) {
+        return ec;
+    }
+    return header;
+}
+
 // client //
 
 /// Convert iobuf that contains xml data to boost::property_tree
@@ -368,15 +571,24 @@ drain_response_stream(http::client::response_stream_ref resp) {
 client::client(const configuration& conf)
   : _requestor(conf)
   , _client(conf)
-  , _probe(conf._probe) {}
+  , _probe(conf._probe) {
+    _client.set_max_idle_time(conf.max_idle_time);
+}
 
 client::client(const configuration& conf, const ss::abort_source& as)
   : _requestor(conf)
   , _client(conf, &as, conf._probe)
-  , _probe(conf._probe) {}
+  , _probe(conf._probe) {
+    _client.set_max_idle_time(conf.max_idle_time);
+}
 
 ss::future<> client::stop() { return _client.stop(); }
 
+std::unique_ptr<hdr_hist::measurement>
+client::measure(client_probe::op_type op) {
+    return _probe ? _probe->measure(op) : nullptr;
+}
+
 ss::future<> client::shutdown() {
     _client.shutdown();
     return ss::now();
@@ -385,37 +597,54 @@ ss::future<> client::shutdown() {
 ss::future<http::client::response_stream_ref> client::get_object(
   bucket_name const& name,
   object_key const& key,
-  const ss::lowres_clock::duration& timeout) {
-    auto header = _requestor.make_get_object_request(name, key);
+  const ss::lowres_clock::duration& timeout,
+  std::optional<byte_range> range,
+  std::optional<ss::sstring> if_none_match) {
+    auto header = _requestor.make_get_object_request(
+      name, key, range, std::move(if_none_match));
     if (!header) {
         return ss::make_exception_future<http::client::response_stream_ref>(
           std::system_error(header.error()));
     }
     vlog(s3_log.trace, "send https request:\n{}", header);
-    return _client.request(std::move(header.value()), timeout)
-      .then([](http::client::response_stream_ref&& ref) {
+    // the latency is the time to first byte, the body is read by the caller
+    auto m = measure(client_probe::op_type::get_object);
+    const size_t expected = range ? range->last - range->first + 1 : 0;
+    return finjector::inject_io_fault(
+             finjector::io_point::s3_request, expected)
+      .then([this, header = std::move(header), timeout]() mutable {
+          return _client.request(std::move(header.value()), timeout);
+      })
+      .then([m = std::move(m)](
+              http::client::response_stream_ref&& ref) mutable {
           // here we didn't receive any bytes from the socket and
           // ref->is_header_done() is 'false', we need to prefetch
           // the header first
-          return ref->prefetch_headers().then([ref = std::move(ref)]() mutable {
-              vassert(ref->is_header_done(), "Header is not received");
-              if (
-                ref->get_headers().result() != boost::beast::http::status::ok) {
-                  // Got error response, consume the response body and produce
-                  // rest api error
-                  return drain_response_stream(std::move(ref))
-                    .then([](iobuf&& res) {
-                        return parse_rest_error_response<
-                          http::client::response_stream_ref>(std::move(res));
-                    });
-              }
-              return ss::make_ready_future<http::client::response_stream_ref>(
-                std::move(ref));
-          });
+          return ref->prefetch_headers().then(
+            [ref = std::move(ref), m = std::move(m)]() mutable {
+                m.reset();
+                vassert(ref->is_header_done(), "Header is not received");
+                auto status = ref->get_headers().result();
+                if (
+                  status != boost::beast::http::status::ok
+                  && status != boost::beast::http::status::partial_content
+                  && status != boost::beast::http::status::not_modified) {
+                    // Got error response, consume the response body and
+                    // produce rest api error
+                    return drain_response_stream(std::move(ref))
+                      .then([](iobuf&& res) {
+                          return parse_rest_error_response<
+                            http::client::response_stream_ref>(
+                            std::move(res));
+                      });
+                }
+                return ss::make_ready_future<
+                  http::client::response_stream_ref>(std::move(ref));
+            });
       });
 }
 
-ss::future<> client::put_object(
+ss::future<ss::sstring> client::put_object(
   bucket_name const& name,
   object_key const& id,
   size_t payload_size,
@@ -425,33 +654,192 @@ ss::future<> client::put_object(
     auto header = _requestor.make_unsigned_put_object_request(
       name, id, payload_size, tags);
     if (!header) {
-        return ss::make_exception_future<>(std::system_error(header.error()));
+        return ss::make_exception_future<ss::sstring>(
+          std::system_error(header.error()));
     }
     vlog(s3_log.trace, "send https request:\n{}", header);
     return ss::do_with(
       std::move(body),
-      [this, timeout, header = std::move(header)](
-        ss::input_stream<char>& body) mutable {
-          return _client.request(std::move(header.value()), body, timeout)
+      measure(client_probe::op_type::put_object),
+      [this, timeout, payload_size, header = std::move(header)](
+        ss::input_stream<char>& body,
+        std::unique_ptr<hdr_hist::measurement>&) mutable {
+          return finjector::inject_io_fault(
+                   finjector::io_point::s3_request, payload_size)
+            .then([this, &body, timeout, header = std::move(header)]() mutable {
+                return _client.request(
+                  std::move(header.value()), body, timeout);
+            })
             .then([](const http::client::response_stream_ref& ref) {
                 return drain_response_stream(ref).then([ref](iobuf&& res) {
-                    auto status = ref->get_headers().result();
-                    if (status != boost::beast::http::status::ok) {
-                        return parse_rest_error_response<>(std::move(res));
+                    const auto& headers = ref->get_headers();
+                    if (headers.result() != boost::beast::http::status::ok) {
+                        return parse_rest_error_response<ss::sstring>(
+                          std::move(res));
                     }
-                    return ss::now();
+                    ss::sstring etag;
+                    auto it = headers.find(boost::beast::http::field::etag);
+                    if (it != headers.end()) {
+                        etag = ss::sstring(
+                          it->value().data(), it->value().size());
+                    }
+                    return ss::make_ready_future<ss::sstring>(
+                      std::move(etag));
                 });
             })
-            .handle_exception_type(
-              [](const ss::abort_requested_exception&) { return ss::now(); })
+            .handle_exception_type([](const ss::abort_requested_exception&) {
+                return ss::make_ready_future<ss::sstring>();
+            })
             .handle_exception_type([this](const rest_error_response& err) {
                 _probe->register_failure(err.code());
-                return ss::make_exception_future<>(err);
+                return ss::make_exception_future<ss::sstring>(err);
             })
             .finally([&body]() { return body.close(); });
       });
 }
 
+ss::future<multipart_upload_id> client::create_multipart_upload(
+  bucket_name const& name,
+  object_key const& key,
+  const std::vector<object_tag>& tags,
+  const ss::lowres_clock::duration& timeout) {
+    auto header = _requestor.make_create_multipart_upload_request(
+      name, key, tags);
+    if (!header) {
+        throw std::system_error(header.error());
+    }
+    vlog(s3_log.trace, "send https request:\n{}", header);
+    auto ref = co_await _client.request(std::move(header.value()), timeout);
+    auto buf = co_await drain_response_stream(ref);
+    if (ref->get_headers().result() != boost::beast::http::status::ok) {
+        co_return co_await parse_rest_error_response<multipart_upload_id>(
+          std::move(buf));
+    }
+    auto root = iobuf_to_ptree(std::move(buf));
+    co_return multipart_upload_id(
+      root.get<ss::sstring>("InitiateMultipartUploadResult.UploadId"));
+}
+
+ss::future<client::upload_part_result> client::upload_part(
+  bucket_name const& name,
+  object_key const& key,
+  const multipart_upload_id& upload_id,
+  size_t part_number,
+  size_t payload_size,
+  ss::input_stream<char>&& body,
+  const ss::lowres_clock::duration& timeout) {
+    auto header = _requestor.make_unsigned_upload_part_request(
+      name, key, upload_id, part_number, payload_size);
+    if (!header) {
+        co_await body.close();
+        throw std::system_error(header.error());
+    }
+    vlog(s3_log.trace, "send https request:\n{}", header);
+    auto m = measure(client_probe::op_type::upload_part);
+    auto stream = std::move(body);
+    std::exception_ptr err;
+    upload_part_result result{.part_number = part_number};
+    try {
+        co_await finjector::inject_io_fault(
+          finjector::io_point::s3_request, payload_size);
+        auto ref = co_await _client.request(
+          std::move(header.value()), stream, timeout);
+        auto buf = co_await drain_response_stream(ref);
+        const auto& headers = ref->get_headers();
+        if (headers.result() != boost::beast::http::status::ok) {
+            co_await parse_rest_error_response<>(std::move(buf));
+        }
+        auto etag = headers.find(boost::beast::http::field::etag);
+        if (etag == headers.end()) {
+            throw std::runtime_error(fmt::format(
+              "ETag is missing in UploadPart response, part {} of {}",
+              part_number,
+              key()));
+        }
+        result.etag = ss::sstring(etag->value().data(), etag->value().size());
+    } catch (const rest_error_response& e) {
+        _probe->register_failure(e.code());
+        err = std::current_exception();
+    } catch (...) {
+        err = std::current_exception();
+    }
+    co_await stream.close();
+    if (err) {
+        std::rethrow_exception(err);
+    }
+    co_return result;
+}
+
+ss::future<> client::complete_multipart_upload(
+  bucket_name const& name,
+  object_key const& key,
+  const multipart_upload_id& upload_id,
+  std::vector<upload_part_result> parts,
+  const ss::lowres_clock::duration& timeout) {
+    std::sort(parts.begin(), parts.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.part_number < rhs.part_number;
+    });
+    std::stringstream xml;
+    xml << "<CompleteMultipartUpload>";
+    for (const auto& part : parts) {
+        xml << fmt::format(
+          "<Part><PartNumber>{}</PartNumber><ETag>{}</ETag></Part>",
+          part.part_number,
+          part.etag);
+    }
+    xml << "</CompleteMultipartUpload>";
+    auto xml_str = xml.str();
+    iobuf payload;
+    payload.append(xml_str.data(), xml_str.size());
+    auto header = _requestor.make_unsigned_complete_multipart_upload_request(
+      name, key, upload_id, payload.size_bytes());
+    if (!header) {
+        throw std::system_error(header.error());
+    }
+    vlog(s3_log.trace, "send https request:\n{}", header);
+    auto body = make_iobuf_input_stream(std::move(payload));
+    auto ref = co_await _client.request(
+      std::move(header.value()), body, timeout);
+    auto buf = co_await drain_response_stream(ref);
+    if (ref->get_headers().result() != boost::beast::http::status::ok) {
+        co_await parse_rest_error_response<>(std::move(buf));
+    }
+    // The request can fail after the 200 OK response was sent, in this
+    // case the body contains an error instead of the result
+    auto root = iobuf_to_ptree(std::move(buf));
+    if (root.get_child_optional("Error")) {
+        constexpr const char* empty = "";
+        rest_error_response err(
+          root.get<ss::sstring>("Error.Code", empty),
+          root.get<ss::sstring>("Error.Message", empty),
+          root.get<ss::sstring>("Error.RequestId", empty),
+          root.get<ss::sstring>("Error.Resource", empty));
+        _probe->register_failure(err.code());
+        throw err;
+    }
+}
+
+ss::future<> client::abort_multipart_upload(
+  bucket_name const& name,
+  object_key const& key,
+  const multipart_upload_id& upload_id,
+  const ss::lowres_clock::duration& timeout) {
+    auto header = _requestor.make_abort_multipart_upload_request(
+      name, key, upload_id);
+    if (!header) {
+        throw std::system_error(header.error());
+    }
+    vlog(s3_log.trace, "send https request:\n{}", header);
+    auto ref = co_await _client.request(std::move(header.value()), timeout);
+    auto buf = co_await drain_response_stream(ref);
+    auto status = ref->get_headers().result();
+    if (
+      status != boost::beast::http::status::ok
+      && status != boost::beast::http::status::no_content) { // expect 204
+        co_await parse_rest_error_response<>(std::move(buf));
+    }
+}
+
 ss::future<client::list_bucket_result> client::list_objects_v2(
   const bucket_name& name,
   std::optional<object_key> prefix,
@@ -465,6 +853,7 @@ ss::future<client::list_bucket_result> client::list_objects_v2(
           std::system_error(header.error()));
     }
     vlog(s3_log.trace, "send https request:\n{}", header);
+    auto m = measure(client_probe::op_type::list_objects);
     return _client.request(std::move(header.value()), timeout)
       .then([](const http::client::response_stream_ref& resp) mutable {
           // chunked encoding is used so we don't know output size in
@@ -494,7 +883,8 @@ ss::future<client::list_bucket_result> client::list_objects_v2(
                         std::move(res));
                   });
             });
-      });
+      })
+      .finally([m = std::move(m)] {});
 }
 
 ss::future<> client::delete_object(
@@ -506,6 +896,7 @@ ss::future<> client::delete_object(
         return ss::make_exception_future<>(std::system_error(header.error()));
     }
     vlog(s3_log.trace, "send https request:\n{}", header);
+    auto m = measure(client_probe::op_type::delete_object);
     return _client.request(std::move(header.value()), timeout)
       .then([](const http::client::response_stream_ref& ref) {
           return drain_response_stream(ref).then([ref](iobuf&& res) {
@@ -518,7 +909,100 @@ ss::future<> client::delete_object(
               }
               return ss::now();
           });
-      });
+      })
+      .finally([m = std::move(m)] {});
+}
+
+/// Escape the characters that can't be used in the xml text
+static ss::sstring xml_escape(std::string_view s) {
+    ss::sstring res;
+    for (auto c : s) {
+        switch (c) {
+        case '&':
+            res += "&amp;";
+            break;
+        case '<':
+            res += "&lt;";
+            break;
+        case '>':
+            res += "&gt;";
+            break;
+        default:
+            res += c;
+        }
+    }
+    return res;
+}
+
+ss::future<client::delete_objects_result> client::delete_objects(
+  const bucket_name& bucket,
+  std::vector<object_key> keys,
+  const ss::lowres_clock::duration& timeout) {
+    vassert(
+      keys.size() <= max_delete_objects_keys,
+      "Too many keys in DeleteObjects request: {}",
+      keys.size());
+    delete_objects_result result;
+    if (keys.empty()) {
+        co_return result;
+    }
+    // Quiet mode, only the errors are returned
+    std::stringstream xml;
+    xml << "<Delete><Quiet>true</Quiet>";
+    for (const auto& key : keys) {
+        xml << "<Object><Key>" << xml_escape(key().string())
+            << "</Key></Object>";
+    }
+    xml << "</Delete>";
+    auto xml_str = xml.str();
+    auto header = _requestor.make_delete_objects_request(bucket, xml_str);
+    if (!header) {
+        throw std::system_error(header.error());
+    }
+    vlog(s3_log.trace, "send https request:\n{}", header);
+    auto m = measure(client_probe::op_type::delete_objects);
+    iobuf payload;
+    payload.append(xml_str.data(), xml_str.size());
+    auto body = make_iobuf_input_stream(std::move(payload));
+    std::exception_ptr err;
+    try {
+        auto ref = co_await _client.request(
+          std::move(header.value()), body, timeout);
+        auto buf = co_await drain_response_stream(ref);
+        if (ref->get_headers().result() != boost::beast::http::status::ok) {
+            co_await parse_rest_error_response<>(std::move(buf));
+        }
+        auto root = iobuf_to_ptree(std::move(buf));
+        auto res = root.get_child_optional("DeleteResult");
+        if (!res) {
+            throw std::runtime_error(
+              "DeleteResult is missing in DeleteObjects response");
+        }
+        for (const auto& [tag, value] : *res) {
+            if (tag != "Error") {
+                continue;
+            }
+            auto code = value.get<ss::sstring>("Code", "");
+            if (code == "NoSuchKey") {
+                continue;
+            }
+            result.errors.push_back(delete_objects_error{
+              .key = object_key(value.get<ss::sstring>("Key", "")),
+              .code = std::move(code),
+              .message = value.get<ss::sstring>("Message", ""),
+            });
+        }
+    } catch (const rest_error_response& e) {
+        _probe->register_failure(e.code());
+        err = std::current_exception();
+    } catch (...) {
+        err = std::current_exception();
+    }
+    co_await body.close();
+    if (err) {
+        std::rethrow_exception(err);
+    }
+    co_return result;
 }
 
 client_pool::client_pool(
@@ -545,6 +1029,7 @@ ss::future<> client_pool::stop() {
 ///         are in use)
 ss::future<client_pool::client_lease> client_pool::acquire() {
     gate_guard guard(_gate);
+    auto start = std::chrono::steady_clock::now();
     try {
         while (_pool.empty() && !_gate.is_closed()) {
             if (_policy == client_pool_overdraft_policy::wait_if_empty) {
@@ -559,6 +1044,11 @@ ss::future<client_pool::client_lease> client_pool::acquire() {
     if (_gate.is_closed() || _as.abort_requested()) {
         throw ss::gate_closed_exception();
     }
+    if (_config._probe) {
+        _config._probe->register_pool_wait(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start));
+    }
     vassert(!_pool.empty(), "'acquire' invariant is broken");
     auto client = _pool.back();
     _pool.pop_back();
@@ -37,6 +37,14 @@ using object_key = named_type<std::filesystem::path, struct s3_object_key>;
 using endpoint_url = named_type<ss::sstring, struct s3_endpoint_url>;
 using ca_trust_file
   = named_type<std::filesystem::path, struct s3_ca_trust_file>;
+using multipart_upload_id
+  = named_type<ss::sstring, struct s3_multipart_upload_id>;
+
+/// Inclusive range of bytes of the object
+struct byte_range {
+    uint64_t first;
+    uint64_t last;
+};
 
 struct object_tag {
     ss::sstring key;
@@ -66,6 +74,8 @@ struct configuration : rpc::base_transport::configuration {
     aws_region_name region;
     /// Metrics probe (should be created for every aws account on every shard)
     ss::shared_ptr<client_probe> _probe;
+    /// Connections idle for longer are not reused
+    ss::lowres_clock::duration max_idle_time = http::default_max_idle_time;
 
     /// \brief opinionated configuraiton initialization
     /// Generates uri field from region, initializes credentials for the
@@ -113,9 +123,15 @@ public:
     ///
     /// \param name is a bucket that has the object
     /// \param key is an object name
+    /// \param range is an optional range of bytes to fetch
+    /// \param if_none_match is an optional ETag, the object is not sent if
+    ///        it has the same ETag
     /// \return initialized and signed http header or error
-    result<http::client::request_header>
-    make_get_object_request(bucket_name const& name, object_key const& key);
+    result<http::client::request_header> make_get_object_request(
+      bucket_name const& name,
+      object_key const& key,
+      std::optional<byte_range> range = std::nullopt,
+      std::optional<ss::sstring> if_none_match = std::nullopt);
 
     /// \brief Create a 'DeleteObject' request header
     ///
@@ -125,6 +141,66 @@ public:
     result<http::client::request_header>
     make_delete_object_request(bucket_name const& name, object_key const& key);
 
+    /// \brief Create a 'DeleteObjects' request header
+    ///
+    /// \param name is a bucket that has the objects
+    /// \param payload is the xml list of the deleted keys, the request
+    ///        is signed with its hash
+    /// \return initialized and signed http header or error
+    result<http::client::request_header> make_delete_objects_request(
+      bucket_name const& name, std::string_view payload);
+
+    /// \brief Create 'CreateMultipartUpload' request header
+    ///
+    /// \param name is a bucket that should be used to store new object
+    /// \param key is an object name
+    /// \param tags are object tags
+    /// \return initialized and signed http header or error
+    result<http::client::request_header> make_create_multipart_upload_request(
+      bucket_name const& name,
+      object_key const& key,
+      const std::vector<object_tag>& tags);
+
+    /// \brief Create unsigned 'UploadPart' request header
+    ///
+    /// \param name is a bucket name
+    /// \param key is an object name
+    /// \param upload_id is an id returned by 'CreateMultipartUpload'
+    /// \param part_number is a part number (starts from 1)
+    /// \param payload_size_bytes is a size of the part in bytes
+    /// \return initialized and signed http header or error
+    result<http::client::request_header> make_unsigned_upload_part_request(
+      bucket_name const& name,
+      object_key const& key,
+      const multipart_upload_id& upload_id,
+      size_t part_number,
+      size_t payload_size_bytes);
+
+    /// \brief Create unsigned 'CompleteMultipartUpload' request header
+    ///
+    /// \param name is a bucket name
+    /// \param key is an object name
+    /// \param upload_id is an id returned by 'CreateMultipartUpload'
+    /// \param payload_size_bytes is a size of the xml payload in bytes
+    /// \return initialized and signed http header or error
+    result<http::client::request_header>
+    make_unsigned_complete_multipart_upload_request(
+      bucket_name const& name,
+      object_key const& key,
+      const multipart_upload_id& upload_id,
+      size_t payload_size_bytes);
+
+    /// \brief Create 'AbortMultipartUpload' request header
+    ///
+    /// \param name is a bucket name
+    /// \param key is an object name
+    /// \param upload_id is an id returned by 'CreateMultipartUpload'
+    /// \return initialized and signed http header or error
+    result<http::client::request_header> make_abort_multipart_upload_request(
+      bucket_name const& name,
+      object_key const& key,
+      const multipart_upload_id& upload_id);
+
     /// \brief Initialize http header for 'ListObjectsV2' request
     ///
     /// \param name of the bucket
@@ -158,19 +234,26 @@ public:
     ///
     /// \param name is a bucket name
     /// \param key is an object key
+    /// \param range is an optional range of bytes to download, if it's set
+    ///        the response stream contains only the requested bytes
+    /// \param if_none_match is an optional ETag, if the object has the same
+    ///        ETag the response has status 304 (Not Modified) and no body
     /// \return future that gets ready after request was sent
     ss::future<http::client::response_stream_ref> get_object(
       bucket_name const& name,
       object_key const& key,
-      const ss::lowres_clock::duration& timeout);
+      const ss::lowres_clock::duration& timeout,
+      std::optional<byte_range> range = std::nullopt,
+      std::optional<ss::sstring> if_none_match = std::nullopt);
 
     /// Put object to S3 bucket.
     /// \param name is a bucket name
     /// \param key is an id of the object
     /// \param payload_size is a size of the object in bytes
     /// \param body is an input_stream that can be used to read body
-    /// \return future that becomes ready when the upload is completed
-    ss::future<> put_object(
+    /// \return future that becomes ready when the upload is completed, it
+    ///         returns the ETag of the object (empty if not provided)
+    ss::future<ss::sstring> put_object(
       bucket_name const& name,
       object_key const& key,
       size_t payload_size,
@@ -178,6 +261,60 @@ public:
       const std::vector<object_tag>& tags,
       const ss::lowres_clock::duration& timeout);
 
+    /// Part of the multipart upload
+    struct upload_part_result {
+        /// Part number (starts from 1)
+        size_t part_number;
+        /// ETag returned by S3, used to complete the upload
+        ss::sstring etag;
+    };
+
+    /// Start multipart upload
+    ///
+    /// \param name is a bucket name
+    /// \param key is an id of the object
+    /// \return future that returns id of the multipart upload
+    ss::future<multipart_upload_id> create_multipart_upload(
+      bucket_name const& name,
+      object_key const& key,
+      const std::vector<object_tag>& tags,
+      const ss::lowres_clock::duration& timeout);
+
+    /// Upload part of the object
+    ///
+    /// \param upload_id is an id returned by 'create_multipart_upload'
+    /// \param part_number is a part number (starts from 1), parts can be
+    ///        uploaded in any order and concurrently
+    /// \param payload_size is a size of the part in bytes
+    /// \param body is an input_stream that can be used to read the part
+    /// \return future that returns the ETag of the part
+    ss::future<upload_part_result> upload_part(
+      bucket_name const& name,
+      object_key const& key,
+      const multipart_upload_id& upload_id,
+      size_t part_number,
+      size_t payload_size,
+      ss::input_stream<char>&& body,
+      const ss::lowres_clock::duration& timeout);
+
+    /// Complete multipart upload
+    ///
+    /// \param parts are all uploaded parts of the object
+    /// \return future that becomes ready when the object is assembled
+    ss::future<> complete_multipart_upload(
+      bucket_name const& name,
+      object_key const& key,
+      const multipart_upload_id& upload_id,
+      std::vector<upload_part_result> parts,
+      const ss::lowres_clock::duration& timeout);
+
+    /// Abort multipart upload and free the storage used by uploaded parts
+    ss::future<> abort_multipart_upload(
+      bucket_name const& name,
+      object_key const& key,
+      const multipart_upload_id& upload_id,
+      const ss::lowres_clock::duration& timeout);
+
     struct list_bucket_item {
         ss::sstring key;
         std::chrono::system_clock::time_point last_modified;
@@ -201,7 +338,34 @@ public:
       const object_key& key,
       const ss::lowres_clock::duration& timeout);
 
+    /// Max number of keys in one 'DeleteObjects' request
+    static constexpr size_t max_delete_objects_keys = 1000;
+
+    struct delete_objects_error {
+        object_key key;
+        ss::sstring code;
+        ss::sstring message;
+    };
+    struct delete_objects_result {
+        /// Keys that were not deleted, missing keys are reported as
+        /// deleted
+        std::vector<delete_objects_error> errors;
+    };
+    /// \brief Delete up to 'max_delete_objects_keys' objects with one
+    /// request
+    ///
+    /// The request is not atomic, the result contains the keys that were
+    /// not deleted. The exception is thrown if the whole request failed.
+    ss::future<delete_objects_result> delete_objects(
+      const bucket_name& bucket,
+      std::vector<object_key> keys,
+      const ss::lowres_clock::duration& timeout);
+
 private:
+    /// Start measuring the latency of the request (no-op if the client
+    /// has no probe)
+    std::unique_ptr<hdr_hist::measurement> measure(client_probe::op_type op);
+
     request_creator _requestor;
     http::client _client;
     ss::shared_ptr<client_probe> _probe;
@@ -93,6 +93,18 @@ client_probe::client_probe(
           [this] { return get_transport_errors(); },
           sm::description("Total number of transport errors (TCP and TLS)"),
           labels),
+        sm::make_counter(
+          "num_connects",
+          [this] { return get_connects(); },
+          sm::description("Total number of connections (TCP and TLS "
+                          "handshakes) made to the cloud storage provider"),
+          labels),
+        sm::make_counter(
+          "num_connection_reuses",
+          [this] { return get_connection_reuses(); },
+          sm::description("Total number of requests sent over a kept alive "
+                          "connection"),
+          labels),
         sm::make_counter(
           "num_slowdowns",
           [this] { return _total_slowdowns; },
@@ -106,9 +118,74 @@ client_probe::client_probe(
             "Total number of NoSuchKey errors received from cloud "
             "storage provider"),
           labels),
+        sm::make_histogram(
+          "get_object_latency_us",
+          [this] { return _get_object_latency.seastar_histogram_logform(); },
+          sm::description("Time to first byte of GET requests"),
+          labels),
+        sm::make_histogram(
+          "put_object_latency_us",
+          [this] { return _put_object_latency.seastar_histogram_logform(); },
+          sm::description("Latency of PUT requests"),
+          labels),
+        sm::make_histogram(
+          "upload_part_latency_us",
+          [this] { return _upload_part_latency.seastar_histogram_logform(); },
+          sm::description("Latency of multipart upload part requests"),
+          labels),
+        sm::make_histogram(
+          "list_objects_latency_us",
+          [this] { return _list_objects_latency.seastar_histogram_logform(); },
+          sm::description("Latency of ListObjectsV2 requests"),
+          labels),
+        sm::make_histogram(
+          "delete_object_latency_us",
+          [this] { return _delete_object_latency.seastar_histogram_logform(); },
+          sm::description("Latency of DELETE requests"),
+          labels),
+        sm::make_histogram(
+          "delete_objects_latency_us",
+          [this] {
+              return _delete_objects_latency.seastar_histogram_logform();
+          },
+          sm::description("Latency of multi-object delete requests"),
+          labels),
+        sm::make_histogram(
+          "pool_wait_us",
+          [this] { return _pool_wait.seastar_histogram_logform(); },
+          sm::description("Time spent waiting for a client connection in the "
+                          "connection pool"),
+          labels),
       });
 }
 
+std::unique_ptr<hdr_hist::measurement>
+client_probe::measure(client_probe::op_type op) {
+    return get_histogram(op).auto_measure();
+}
+
+void client_probe::register_pool_wait(std::chrono::microseconds wait) {
+    _pool_wait.record(wait.count());
+}
+
+hdr_hist& client_probe::get_histogram(client_probe::op_type op) {
+    switch (op) {
+    case op_type::get_object:
+        return _get_object_latency;
+    case op_type::put_object:
+        return _put_object_latency;
+    case op_type::upload_part:
+        return _upload_part_latency;
+    case op_type::list_objects:
+        return _list_objects_latency;
+    case op_type::delete_object:
+        return _delete_object_latency;
+    case op_type::delete_objects:
+        return _delete_objects_latency;
+    }
+    __builtin_unreachable();
+}
+
 void client_probe::register_failure(s3_error_code err) {
     if (err == s3_error_code::slow_down) {
         _total_slowdowns += 1;
@@ -14,10 +14,13 @@
 #include "model/fundamental.h"
 #include "rpc/types.h"
 #include "s3/error.h"
+#include "utils/hdr_hist.h"
 
 #include <seastar/core/metrics_registration.hh>
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
 
 namespace s3 {
 
@@ -36,6 +39,17 @@ namespace s3 {
 ///       time-series.
 class client_probe : public http::client_probe {
 public:
+    /// Type of the request measured by the latency histograms
+    enum class op_type {
+        /// Time to first byte of GetObject (status and headers received)
+        get_object,
+        put_object,
+        upload_part,
+        list_objects,
+        delete_object,
+        delete_objects,
+    };
+
     /// \brief Probe c-tor
     ///
     /// \param disable is used to switch the monitoring off
@@ -47,7 +61,23 @@ public:
     /// Register S3 rpc error
     void register_failure(s3_error_code err);
 
+    /// Start measuring the latency of the request, the latency is recorded
+    /// when the returned object is destroyed
+    std::unique_ptr<hdr_hist::measurement> measure(op_type op);
+
+    /// Register the time the request waited for a client in the pool
+    void register_pool_wait(std::chrono::microseconds wait);
+
 private:
+    hdr_hist& get_histogram(op_type op);
+
+    hdr_hist _get_object_latency;
+    hdr_hist _put_object_latency;
+    hdr_hist _upload_part_latency;
+    hdr_hist _list_objects_latency;
+    hdr_hist _delete_object_latency;
+    hdr_hist _delete_objects_latency;
+    hdr_hist _pool_wait;
     /// Total number of rpc errors
     uint64_t _total_rpc_errors;
     /// Total number of SlowDown responses
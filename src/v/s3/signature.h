@@ -103,10 +103,6 @@ public:
     /// Checks if credentials are too old and updates them if this is the case
     void update_credentials_if_outdated();
 
-private:
-    /// Re-generate credentials used to sign headers
-    void update_credentials();
-
     /// \brief Calculate SHA256 digest
     ///
     /// \param payload is ref to payload of the query
@@ -114,6 +110,10 @@ private:
     /// requirements)
     static ss::sstring sha256_hexdigest(std::string_view payload);
 
+private:
+    /// Re-generate credentials used to sign headers
+    void update_credentials();
+
     /// Time of the signing key
     time_source _sig_time;
     /// AWS region
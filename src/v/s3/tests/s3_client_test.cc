@@ -17,6 +17,7 @@
 #include "s3/error.h"
 #include "s3/signature.h"
 #include "seastarx.h"
+#include "ssx/sformat.h"
 #include "utils/unresolved_address.h"
 
 #include <seastar/core/future.hh>
@@ -88,6 +89,33 @@ static constexpr const char* list_objects_payload = R"xml(
   </CommonPrefixes>
 </ListBucketResult>)xml";
 
+static constexpr const char* create_multipart_upload_payload = R"xml(
+<InitiateMultipartUploadResult>
+  <Bucket>test-bucket</Bucket>
+  <Key>test-multipart</Key>
+  <UploadId>test-upload-id</UploadId>
+</InitiateMultipartUploadResult>)xml";
+static constexpr const char* complete_multipart_upload_payload = R"xml(
+<CompleteMultipartUploadResult>
+  <Bucket>test-bucket</Bucket>
+  <Key>test-multipart</Key>
+  <ETag>"test-etag"</ETag>
+</CompleteMultipartUploadResult>)xml";
+
+static constexpr const char* delete_objects_payload = R"xml(
+<DeleteResult>
+  <Error>
+    <Key>test-error</Key>
+    <Code>AccessDenied</Code>
+    <Message>Access Denied</Message>
+  </Error>
+  <Error>
+    <Key>test-missing</Key>
+    <Code>NoSuchKey</Code>
+    <Message>The specified key does not exist.</Message>
+  </Error>
+</DeleteResult>)xml";
+
 void set_routes(ss::httpd::routes& r) {
     using namespace ss::httpd;
     auto empty_put_response = new function_handler(
@@ -143,6 +171,39 @@ void set_routes(ss::httpd::routes& r) {
           return "";
       },
       "txt");
+    auto multipart_post_response = new function_handler(
+      [](const_req req, reply&) {
+          BOOST_REQUIRE(!req.get_header("x-amz-content-sha256").empty());
+          if (req.query_parameters.contains("uploads")) {
+              return ss::sstring(create_multipart_upload_payload);
+          }
+          BOOST_REQUIRE_EQUAL(
+            req.get_query_param("uploadId"), "test-upload-id");
+          // parts are sent in order with the etags returned by the PUT
+          BOOST_REQUIRE(
+            req.content.find("<PartNumber>1</PartNumber><ETag>etag-1</ETag>")
+            < req.content.find(
+              "<PartNumber>2</PartNumber><ETag>etag-2</ETag>"));
+          return ss::sstring(complete_multipart_upload_payload);
+      },
+      "txt");
+    auto multipart_put_response = new function_handler(
+      [](const_req req, reply& reply) {
+          BOOST_REQUIRE_EQUAL(
+            req.get_query_param("uploadId"), "test-upload-id");
+          auto part = req.get_query_param("partNumber");
+          reply.add_header("ETag", ssx::sformat("etag-{}", part));
+          return "";
+      },
+      "txt");
+    auto multipart_delete_response = new function_handler(
+      [](const_req req, reply& reply) {
+          BOOST_REQUIRE_EQUAL(
+            req.get_query_param("uploadId"), "test-upload-id");
+          reply.set_status(reply::status_type::no_content);
+          return "";
+      },
+      "txt");
     r.add(operation_type::PUT, url("/test"), empty_put_response);
     r.add(operation_type::PUT, url("/test-error"), erroneous_put_response);
     r.add(operation_type::GET, url("/test"), get_response);
@@ -150,7 +211,25 @@ void set_routes(ss::httpd::routes& r) {
     r.add(operation_type::DELETE, url("/test"), empty_delete_response);
     r.add(
       operation_type::DELETE, url("/test-error"), erroneous_delete_response);
+    auto delete_objects_response = new function_handler(
+      [](const_req req, reply&) {
+          BOOST_REQUIRE(!req.get_header("x-amz-content-sha256").empty());
+          BOOST_REQUIRE(!req.get_header("Content-MD5").empty());
+          BOOST_REQUIRE(
+            req.content.find("<Object><Key>test</Key></Object>")
+            != ss::sstring::npos);
+          return ss::sstring(delete_objects_payload);
+      },
+      "txt");
     r.add(operation_type::GET, url("/"), list_objects_response);
+    r.add(operation_type::POST, url("/"), delete_objects_response);
+    r.add(
+      operation_type::POST, url("/test-multipart"), multipart_post_response);
+    r.add(operation_type::PUT, url("/test-multipart"), multipart_put_response);
+    r.add(
+      operation_type::DELETE,
+      url("/test-multipart"),
+      multipart_delete_response);
 }
 
 /// Http server and client
@@ -241,6 +320,44 @@ SEASTAR_TEST_CASE(test_put_object_failure) {
     });
 }
 
+SEASTAR_TEST_CASE(test_multipart_upload_success) {
+    return ss::async([] {
+        auto conf = transport_configuration();
+        auto [server, client] = started_client_and_server(conf);
+        auto bucket = s3::bucket_name("test-bucket");
+        auto key = s3::object_key("test-multipart");
+        auto upload_id
+          = client->create_multipart_upload(bucket, key, {}, 100ms).get0();
+        BOOST_REQUIRE_EQUAL(upload_id(), "test-upload-id");
+        std::vector<s3::client::upload_part_result> parts;
+        // upload parts out of order, the client should sort them
+        for (size_t part : {2, 1}) {
+            iobuf payload;
+            payload.append(expected_payload, expected_payload_size);
+            auto res = client
+                         ->upload_part(
+                           bucket,
+                           key,
+                           upload_id,
+                           part,
+                           expected_payload_size,
+                           make_iobuf_input_stream(std::move(payload)),
+                           100ms)
+                         .get0();
+            BOOST_REQUIRE_EQUAL(res.part_number, part);
+            BOOST_REQUIRE_EQUAL(res.etag, ssx::sformat("etag-{}", part));
+            parts.push_back(res);
+        }
+        client
+          ->complete_multipart_upload(
+            bucket, key, upload_id, std::move(parts), 100ms)
+          .get();
+        client->abort_multipart_upload(bucket, key, upload_id, 100ms).get();
+        client->shutdown().get();
+        server->stop().get();
+    });
+}
+
 SEASTAR_TEST_CASE(test_get_object_success) {
     return ss::async([] {
         auto conf = transport_configuration();
@@ -322,6 +439,26 @@ SEASTAR_TEST_CASE(test_delete_object_failure) {
     });
 }
 
+SEASTAR_TEST_CASE(test_delete_objects) {
+    return ss::async([] {
+        auto conf = transport_configuration();
+        auto [server, client] = started_client_and_server(conf);
+        auto res = client
+                     ->delete_objects(
+                       s3::bucket_name("test-bucket"),
+                       {s3::object_key("test"),
+                        s3::object_key("test-error"),
+                        s3::object_key("test-missing")},
+                       100ms)
+                     .get0();
+        // missing keys are not reported
+        BOOST_REQUIRE_EQUAL(res.errors.size(), 1);
+        BOOST_REQUIRE_EQUAL(res.errors[0].key().string(), "test-error");
+        BOOST_REQUIRE_EQUAL(res.errors[0].code, "AccessDenied");
+        server->stop().get();
+    });
+}
+
 static ss::sstring strtime(const std::chrono::system_clock::time_point& ts) {
     auto tt = std::chrono::system_clock::to_time_t(ts);
     auto tm = *std::gmtime(&tt);
@@ -12,8 +12,6 @@
 
 #include "security/logger.h"
 
-#include <absl/container/flat_hash_map.h>
-
 namespace security {
 
 std::optional<std::reference_wrapper<const acl_entry>> acl_entry_set::find(
@@ -101,20 +99,19 @@ acl_store::find(resource_type resource, const ss::sstring& name) const {
     }
 
     /*
-     * the acls are sorted within (resource-type, pattern-type) bounds by name
-     * in reverse order so longer names (prefixes) appear first.
+     * the prefixes of the name, longer first, for the lengths of the prefixed
+     * patterns of the resource type.
      */
     std::vector<acl_matches::entry_set_ref> prefixes;
-    {
-        auto it = _acls.lower_bound(
-          resource_pattern(resource, name, pattern_type::prefixed));
-
-        auto end = _acls.upper_bound(resource_pattern(
-          resource, name.substr(0, 1), pattern_type::prefixed));
-
-        for (; it != end; ++it) {
-            if (std::string_view(name).starts_with(it->first.name())) {
-                prefixes.emplace_back(it->second);
+    if (auto lengths = _prefix_lengths.find(resource);
+        lengths != _prefix_lengths.end()) {
+        for (auto it = lengths->second.lower_bound(name.size());
+             it != lengths->second.end() && it->first > 0;
+             ++it) {
+            const auto match = _acls.find(resource_pattern(
+              resource, name.substr(0, it->first), pattern_type::prefixed));
+            if (match != _acls.end()) {
+                prefixes.emplace_back(match->second);
             }
         }
     }
@@ -185,6 +182,10 @@ std::vector<std::vector<acl_binding>> acl_store::remove_bindings(
               }
               return false;
           });
+        if (!dry_run && it->second.empty()) {
+            unindex_pattern(resource);
+            _acls.erase(it);
+        }
     }
 
     std::vector<std::vector<acl_binding>> res;
@@ -197,6 +198,29 @@ std::vector<std::vector<acl_binding>> acl_store::remove_bindings(
     return res;
 }
 
+void acl_store::index_pattern(const resource_pattern& pattern) {
+    if (pattern.pattern() == pattern_type::prefixed) {
+        ++_prefix_lengths[pattern.resource()][pattern.name().size()];
+    }
+}
+
+void acl_store::unindex_pattern(const resource_pattern& pattern) {
+    if (pattern.pattern() != pattern_type::prefixed) {
+        return;
+    }
+    auto lengths = _prefix_lengths.find(pattern.resource());
+    if (lengths == _prefix_lengths.end()) {
+        return;
+    }
+    auto it = lengths->second.find(pattern.name().size());
+    if (it != lengths->second.end() && --it->second == 0) {
+        lengths->second.erase(it);
+    }
+    if (lengths->second.empty()) {
+        _prefix_lengths.erase(lengths);
+    }
+}
+
 std::vector<acl_binding>
 acl_store::acls(const acl_binding_filter& filter) const {
     std::vector<acl_binding> result;
@@ -12,6 +12,7 @@
 #include "security/acl.h"
 
 #include <absl/container/btree_map.h>
+#include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
 
 namespace security {
@@ -117,9 +118,12 @@ public:
 
     void add_bindings(const std::vector<acl_binding>& bindings) {
         for (auto& binding : bindings) {
-            auto& entries = _acls[binding.pattern()];
-            entries.insert(binding.entry());
-            entries.rehash();
+            auto [it, inserted] = _acls.try_emplace(binding.pattern());
+            if (inserted) {
+                index_pattern(binding.pattern());
+            }
+            it->second.insert(binding.entry());
+            it->second.rehash();
         }
     }
 
@@ -153,8 +157,20 @@ private:
         }
     };
 
+    void index_pattern(const resource_pattern&);
+    void unindex_pattern(const resource_pattern&);
+
     absl::btree_map<resource_pattern, acl_entry_set, resource_pattern_compare>
       _acls;
+
+    /*
+     * the lengths of the prefixed patterns, longest first, with the number of
+     * patterns of each length. the prefixes of a name are looked up for these
+     * lengths only, rather than scanning the patterns sharing its first
+     * character.
+     */
+    using prefix_lengths = absl::btree_map<size_t, size_t, std::greater<>>;
+    absl::flat_hash_map<resource_type, prefix_lengths> _prefix_lengths;
 };
 
 } // namespace security
@@ -35,6 +35,13 @@ namespace security {
  * perform any operation. When authorization occurs if the assocaited principal
  * is found in the set of superusers then its request will be permitted. If the
  * principal is not a superuser then normal ACL authorization applies.
+ *
+ * generation
+ * ==========
+ *
+ * Every change to the ACLs or the superusers bumps the generation, the
+ * decisions cached by the connections are valid for the generation they were
+ * made in.
  */
 class authorizer final {
 public:
@@ -59,6 +66,7 @@ public:
             }
         }
         _store.add_bindings(bindings);
+        ++_generation;
     }
 
     /*
@@ -66,6 +74,9 @@ public:
      */
     std::vector<std::vector<acl_binding>> remove_bindings(
       const std::vector<acl_binding_filter>& filters, bool dry_run = false) {
+        if (!dry_run) {
+            ++_generation;
+        }
         return _store.remove_bindings(filters, dry_run);
     }
 
@@ -118,12 +129,16 @@ public:
             vlog(seclog.debug, "Adding superuser: {}", principal);
         }
         _superusers.emplace(std::move(principal));
+        ++_generation;
     }
 
+    uint64_t generation() const { return _generation; }
+
 private:
     acl_store _store;
     absl::flat_hash_set<acl_principal> _superusers;
     allow_empty_matches _allow_empty_matches;
+    uint64_t _generation{0};
 };
 
 } // namespace security
@@ -16,6 +16,10 @@
 #include "ssx/sformat.h"
 #include "utils/base64.h"
 
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/later.hh>
+
 #include <absl/container/node_hash_map.h>
 
 /**
@@ -286,6 +290,27 @@ public:
         return bytes(result.begin(), result.end());
     }
 
+    /// \brief hi() with preemption points between the iterations, the
+    /// thousands of iterations of a key derivation take milliseconds
+    static ss::future<bytes> hi_async(bytes str, bytes salt, int iterations) {
+        MacType mac(str);
+        mac.update(salt);
+        mac.update(std::array<char, 4>{0, 0, 0, 1});
+        auto u1 = mac.reset();
+        auto prev = u1;
+        auto result = u1;
+        for (int i = 2; i <= iterations; i++) {
+            mac.update(prev);
+            auto ui = mac.reset();
+            result = result ^ ui;
+            prev = ui;
+            if (ss::need_preempt()) {
+                co_await ss::yield();
+            }
+        }
+        co_return bytes(result.begin(), result.end());
+    }
+
     static bytes server_key(bytes_view salted_password) {
         MacType mac(salted_password);
         mac.update("Server Key");
@@ -502,6 +502,64 @@ BOOST_AUTO_TEST_CASE(remove_all_acl_prefixed_resource) {
     BOOST_REQUIRE(get_acls(auth, acl_binding_filter::any()).empty());
 }
 
+BOOST_AUTO_TEST_CASE(many_prefixed_resources) {
+    acl_principal user(principal_type::user, "alice");
+    acl_host host("192.168.3.1");
+
+    authorizer auth;
+
+    // tenants of varying name lengths, the resources of one are allowed by
+    // its own prefix only
+    std::vector<acl_binding> bindings;
+    for (int i = 0; i < 1000; ++i) {
+        bindings.emplace_back(
+          resource_pattern(
+            resource_type::topic,
+            fmt::format("tenant-{}.", i),
+            pattern_type::prefixed),
+          allow_read_acl);
+    }
+    bindings.emplace_back(
+      resource_pattern(
+        resource_type::topic, "tenant-1", pattern_type::prefixed),
+      deny_read_acl);
+    auth.add_bindings(bindings);
+
+    BOOST_REQUIRE(auth.authorized(
+      model::topic("tenant-42.orders"), acl_operation::read, user, host));
+    BOOST_REQUIRE(auth.authorized(
+      model::topic("tenant-999.orders"), acl_operation::read, user, host));
+    // the shorter prefix applies too
+    BOOST_REQUIRE(!auth.authorized(
+      model::topic("tenant-17.orders"), acl_operation::read, user, host));
+    BOOST_REQUIRE(!auth.authorized(
+      model::topic("tenant-42"), acl_operation::read, user, host));
+
+    {
+        std::vector<acl_binding_filter> filters;
+        filters.emplace_back(
+          resource_pattern(
+            resource_type::topic, "tenant-1", pattern_type::prefixed),
+          acl_entry_filter::any());
+        auth.remove_bindings(filters);
+    }
+    BOOST_REQUIRE(auth.authorized(
+      model::topic("tenant-17.orders"), acl_operation::read, user, host));
+
+    {
+        std::vector<acl_binding_filter> filters;
+        filters.emplace_back(
+          resource_pattern(
+            resource_type::topic, "tenant-17.", pattern_type::prefixed),
+          acl_entry_filter::any());
+        auth.remove_bindings(filters);
+    }
+    BOOST_REQUIRE(!auth.authorized(
+      model::topic("tenant-17.orders"), acl_operation::read, user, host));
+    BOOST_REQUIRE(auth.authorized(
+      model::topic("tenant-18.orders"), acl_operation::read, user, host));
+}
+
 BOOST_AUTO_TEST_CASE(acls_on_literal_resource) {
     authorizer auth;
 
@@ -874,4 +932,28 @@ BOOST_AUTO_TEST_CASE(topic_group_same_name) {
       kafka::group_id("topic-foo-xxx"), acl_operation::read, user, host));
 }
 
+BOOST_AUTO_TEST_CASE(generation_bumped_by_changes) {
+    authorizer auth;
+    auto generation = auth.generation();
+
+    std::vector<acl_binding> bindings;
+    bindings.emplace_back(default_resource, allow_read_acl);
+    auth.add_bindings(bindings);
+    BOOST_REQUIRE_GT(auth.generation(), generation);
+
+    // a dry run doesn't change the acls
+    generation = auth.generation();
+    std::vector<acl_binding_filter> filters;
+    filters.emplace_back(default_resource, allow_read_acl);
+    auth.remove_bindings(filters, true);
+    BOOST_REQUIRE_EQUAL(auth.generation(), generation);
+
+    auth.remove_bindings(filters);
+    BOOST_REQUIRE_GT(auth.generation(), generation);
+
+    generation = auth.generation();
+    auth.add_superuser(acl_principal(principal_type::user, "superuser"));
+    BOOST_REQUIRE_GT(auth.generation(), generation);
+}
+
 } // namespace security
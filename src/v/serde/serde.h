@@ -20,6 +20,7 @@
 #include "utils/named_type.h"
 #include "vlog.h"
 
+#include <bit>
 #include <iosfwd>
 #include <numeric>
 #include <string>
@@ -89,6 +90,58 @@ inline constexpr auto const is_serde_compatible_v
     || reflection::is_std_vector_v<
       T> || reflection::is_named_type_v<T> || reflection::is_ss_bool_v<T> || std::is_same_v<T, std::chrono::milliseconds> || std::is_same_v<T, iobuf> || std::is_same_v<T, ss::sstring> || reflection::is_std_optional_v<T>;
 
+/// \brief vectors of these types are written as their in-memory
+/// representation, with a single copy, instead of one write per element.
+/// The representation is the same as the one of the element-wise writes on
+/// little endian hosts only.
+template<typename T>
+inline constexpr bool is_trivially_encoded_v = [] {
+    if constexpr (std::endian::native != std::endian::little) {
+        return false;
+    } else if constexpr (reflection::is_named_type_v<T>) {
+        using U = typename T::type;
+        return std::is_scalar_v<U> && !std::is_enum_v<U>
+               && !std::is_same_v<U, bool> && sizeof(T) == sizeof(U)
+               && std::is_trivially_copyable_v<T>;
+    } else {
+        return std::is_scalar_v<T> && !std::is_enum_v<T>
+               && !std::is_same_v<T, bool> && !std::is_pointer_v<T>;
+    }
+}();
+
+namespace detail {
+
+template<typename Fields>
+struct trivially_encoded_fields;
+
+template<typename... F>
+struct trivially_encoded_fields<std::tuple<F&...>> {
+    static constexpr bool value = (is_trivially_encoded_v<F> && ...);
+    static constexpr size_t size = (size_t{0} + ... + sizeof(F));
+};
+
+} // namespace detail
+
+/// \brief envelopes whose fields are all trivially encoded and laid out
+/// back to back, without padding, are written after their header as their
+/// in-memory representation, with a single copy instead of one write per
+/// field.
+template<typename T>
+inline constexpr bool is_trivially_encoded_envelope_v = [] {
+    if constexpr (
+      !is_envelope_v<T> || has_serde_read<T> || has_serde_write<T>
+      || has_serde_async_read<T> || has_serde_async_write<T>) {
+        return false;
+    } else if constexpr (
+      !std::is_trivially_copyable_v<T> || !std::is_standard_layout_v<T>) {
+        return false;
+    } else {
+        using fields = detail::trivially_encoded_fields<
+          decltype(envelope_to_tuple(std::declval<T&>()))>;
+        return fields::value && fields::size == sizeof(T);
+    }
+}();
+
 using header_t = std::tuple<version_t, version_t, size_t>;
 
 #if defined(SERDE_TEST)
@@ -105,7 +158,12 @@ void write(iobuf& out, T t) {
     using Type = std::decay_t<T>;
     static_assert(has_serde_write<Type> || is_serde_compatible_v<Type>);
 
-    if constexpr (is_envelope_v<Type>) {
+    if constexpr (is_trivially_encoded_envelope_v<Type>) {
+        write(out, Type::redpanda_serde_version);
+        write(out, Type::redpanda_serde_compat_version);
+        write(out, static_cast<serde_size_t>(sizeof(Type)));
+        out.append(reinterpret_cast<char const*>(&t), sizeof(Type));
+    } else if constexpr (is_envelope_v<Type>) {
         write(out, Type::redpanda_serde_version);
         write(out, Type::redpanda_serde_compat_version);
 
@@ -145,8 +203,15 @@ void write(iobuf& out, T t) {
               t.size()));
         }
         write(out, static_cast<serde_size_t>(t.size()));
-        for (auto const& el : t) {
-            write(out, el);
+        using value_type = typename Type::value_type;
+        if constexpr (is_trivially_encoded_v<value_type>) {
+            out.append(
+              reinterpret_cast<char const*>(t.data()),
+              t.size() * sizeof(value_type));
+        } else {
+            for (auto const& el : t) {
+                write(out, el);
+            }
         }
     } else if constexpr (reflection::is_named_type_v<Type>) {
         return write(out, static_cast<typename Type::type>(t));
@@ -207,7 +272,13 @@ std::decay_t<T> read(iobuf_parser& in) {
     static_assert(has_serde_read<T> || is_serde_compatible_v<Type>);
 
     auto t = Type();
-    if constexpr (is_envelope_v<Type>) {
+    if constexpr (is_trivially_encoded_envelope_v<Type>) {
+        read_header<Type>(in);
+        if (unlikely(in.bytes_left() < sizeof(Type))) {
+            throw serde_exception{"message too short"};
+        }
+        in.consume_to(sizeof(Type), reinterpret_cast<char*>(&t));
+    } else if constexpr (is_envelope_v<Type>) {
         [[maybe_unused]] auto const [version, compat_version, size]
           = read_header<Type>(in);
         if constexpr (has_serde_read<Type>) {
@@ -230,9 +301,19 @@ std::decay_t<T> read(iobuf_parser& in) {
         }
     } else if constexpr (reflection::is_std_vector_v<Type>) {
         using value_type = typename Type::value_type;
-        t.resize(read<serde_size_t>(in));
-        for (auto i = 0U; i < t.size(); ++i) {
-            t[i] = read<value_type>(in);
+        if constexpr (is_trivially_encoded_v<value_type>) {
+            auto const size = static_cast<size_t>(read<serde_size_t>(in));
+            auto const bytes = size * sizeof(value_type);
+            if (unlikely(in.bytes_left() < bytes)) {
+                throw serde_exception{"message too short"};
+            }
+            t.resize(size);
+            in.consume_to(bytes, reinterpret_cast<char*>(t.data()));
+        } else {
+            t.resize(read<serde_size_t>(in));
+            for (auto i = 0U; i < t.size(); ++i) {
+                t[i] = read<value_type>(in);
+            }
         }
     } else if constexpr (reflection::is_named_type_v<Type>) {
         t = Type{read<typename Type::type>(in)};
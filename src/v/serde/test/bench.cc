@@ -38,6 +38,65 @@ PERF_TEST(small, deserialize) {
     perf_tests::stop_measuring_time();
 }
 
+// the fields of small_t, ordered to leave no padding: written with a
+// single copy instead of field by field
+struct small_packed_t
+  : public serde::
+      envelope<small_packed_t, serde::version<3>, serde::compat_version<2>> {
+    int64_t d = 4;
+    int32_t c = 3;
+    int16_t b = 2;
+    int8_t a = 1;
+    int8_t e = 0;
+};
+static_assert(serde::is_trivially_encoded_envelope_v<small_packed_t>);
+static_assert(!serde::is_trivially_encoded_envelope_v<small_t>);
+
+PERF_TEST(small_packed, serialize) {
+    perf_tests::start_measuring_time();
+    auto o = serde::to_iobuf(small_packed_t{});
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+PERF_TEST(small_packed, deserialize) {
+    auto b = serde::to_iobuf(small_packed_t{});
+    perf_tests::start_measuring_time();
+    auto result = serde::from_iobuf<small_packed_t>(std::move(b));
+    perf_tests::do_not_optimize(result);
+    perf_tests::stop_measuring_time();
+}
+
+template<typename T>
+void serialize_vector(size_t n) {
+    std::vector<T> v(n);
+    perf_tests::start_measuring_time();
+    auto o = serde::to_iobuf(std::move(v));
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+
+template<typename T>
+void deserialize_vector(size_t n) {
+    auto b = serde::to_iobuf(std::vector<T>(n));
+    perf_tests::start_measuring_time();
+    auto result = serde::from_iobuf<std::vector<T>>(std::move(b));
+    perf_tests::do_not_optimize(result);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(small_vector_1k, serialize) { serialize_vector<small_t>(1000); }
+PERF_TEST(small_vector_1k, deserialize) { deserialize_vector<small_t>(1000); }
+
+PERF_TEST(small_packed_vector_1k, serialize) {
+    serialize_vector<small_packed_t>(1000);
+}
+PERF_TEST(small_packed_vector_1k, deserialize) {
+    deserialize_vector<small_packed_t>(1000);
+}
+
+PERF_TEST(int64_vector_1k, serialize) { serialize_vector<int64_t>(1000); }
+PERF_TEST(int64_vector_1k, deserialize) { deserialize_vector<int64_t>(1000); }
+
 struct big_t
   : public serde::envelope<big_t, serde::version<3>, serde::compat_version<2>> {
     small_t s;
@@ -160,6 +160,110 @@ SEASTAR_THREAD_TEST_CASE(vector_test) {
     BOOST_CHECK((m == std::vector{1, 2, 3}));
 }
 
+SEASTAR_THREAD_TEST_CASE(trivially_encoded_vector_test) {
+    using offset = named_type<int64_t, struct offset_test_tag>;
+    static_assert(serde::is_trivially_encoded_v<offset>);
+    static_assert(!serde::is_trivially_encoded_v<bool>);
+    static_assert(!serde::is_trivially_encoded_v<ss::sstring>);
+
+    std::vector<offset> v;
+    for (int64_t i = 0; i < 1000; ++i) {
+        v.emplace_back(i * 0x0102030405);
+    }
+    auto b = iobuf();
+    serde::write(b, v);
+
+    // the bulk copy matches the element by element encoding
+    auto expected = iobuf();
+    serde::write(expected, static_cast<serde::serde_size_t>(v.size()));
+    for (auto o : v) {
+        serde::write(expected, o);
+    }
+    BOOST_REQUIRE(b == expected);
+
+    auto parser = iobuf_parser{std::move(b)};
+    BOOST_REQUIRE(serde::read<std::vector<offset>>(parser) == v);
+}
+
+SEASTAR_THREAD_TEST_CASE(trivially_encoded_vector_too_short_test) {
+    auto b = iobuf();
+    serde::write(b, std::vector<int32_t>{1, 2, 3});
+    b.trim_back(1);
+    auto parser = iobuf_parser{std::move(b)};
+    BOOST_REQUIRE_THROW(
+      serde::read<std::vector<int32_t>>(parser), serde::serde_exception);
+}
+
+struct trivial_msg
+  : serde::envelope<trivial_msg, serde::version<1>, serde::compat_version<0>> {
+    int64_t _a;
+    named_type<int64_t, struct trivial_msg_tag> _b;
+    int32_t _c;
+    int16_t _d;
+    int8_t _e, _f;
+};
+static_assert(serde::is_trivially_encoded_envelope_v<trivial_msg>);
+static_assert(serde::is_trivially_encoded_envelope_v<test_msg0>);
+// nested envelopes have their own header
+static_assert(!serde::is_trivially_encoded_envelope_v<test_msg1>);
+
+SEASTAR_THREAD_TEST_CASE(trivially_encoded_envelope_test) {
+    struct padded
+      : serde::envelope<padded, serde::version<1>, serde::compat_version<0>> {
+        int8_t _a;
+        int16_t _b;
+    };
+    struct with_bool
+      : serde::
+          envelope<with_bool, serde::version<1>, serde::compat_version<0>> {
+        bool _a;
+    };
+    static_assert(!serde::is_trivially_encoded_envelope_v<padded>);
+    static_assert(!serde::is_trivially_encoded_envelope_v<with_bool>);
+
+    auto const m = trivial_msg{
+      ._a = 0x0102030405060708,
+      ._b{-2},
+      ._c = 0x0a0b0c0d,
+      ._d = 0x0e0f,
+      ._e = 5,
+      ._f = -6};
+    auto b = iobuf();
+    serde::write(b, m);
+
+    // the single copy matches the field by field encoding
+    auto expected = iobuf();
+    serde::write(expected, trivial_msg::redpanda_serde_version);
+    serde::write(expected, trivial_msg::redpanda_serde_compat_version);
+    serde::write(expected, static_cast<serde::serde_size_t>(24));
+    serde::write(expected, m._a);
+    serde::write(expected, m._b);
+    serde::write(expected, m._c);
+    serde::write(expected, m._d);
+    serde::write(expected, m._e);
+    serde::write(expected, m._f);
+    BOOST_REQUIRE(b == expected);
+
+    auto parser = iobuf_parser{std::move(b)};
+    auto const r = serde::read<trivial_msg>(parser);
+    BOOST_CHECK(r._a == m._a);
+    BOOST_CHECK(r._b == m._b);
+    BOOST_CHECK(r._c == m._c);
+    BOOST_CHECK(r._d == m._d);
+    BOOST_CHECK(r._e == m._e);
+    BOOST_CHECK(r._f == m._f);
+    BOOST_CHECK(parser.bytes_left() == 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(trivially_encoded_envelope_too_short_test) {
+    auto b = iobuf();
+    serde::write(b, trivial_msg{});
+    b.trim_back(1);
+    auto parser = iobuf_parser{std::move(b)};
+    BOOST_REQUIRE_THROW(
+      serde::read<trivial_msg>(parser), serde::serde_exception);
+}
+
 // struct with differing sizes:
 // vector length may take different size (vint)
 // vector data may have different size (_ints.size() * sizeof(int))
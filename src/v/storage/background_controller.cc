@@ -0,0 +1,146 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#include "storage/background_controller.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "storage/api.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/reactor.hh>
+
+#include <algorithm>
+
+namespace storage {
+static ss::logger background_log{"background_ctrl"};
+
+namespace {
+/// Average latency of the segment flushes batches of the shard
+struct flush_latency_sampler final : public background_controller::sampler {
+    explicit flush_latency_sampler(ss::sharded<api>& api)
+      : _api(api) {}
+
+    ss::future<std::chrono::microseconds> sample_latency() final {
+        const auto& flusher = _api.local().log_mgr().flusher();
+        auto batches = flusher.batches() - _prev_batches;
+        auto latency = flusher.batches_latency() - _prev_latency;
+        _prev_batches = flusher.batches();
+        _prev_latency = flusher.batches_latency();
+        if (batches == 0) {
+            co_return std::chrono::microseconds(0);
+        }
+        co_return latency / static_cast<int64_t>(batches);
+    }
+
+    ss::sharded<api>& _api;
+    uint64_t _prev_batches{0};
+    std::chrono::microseconds _prev_latency{0};
+};
+} // namespace
+
+background_controller::background_controller(
+  std::unique_ptr<sampler> sampler,
+  background_controller_config cfg,
+  std::vector<managed_class> classes)
+  : _sampler(std::move(sampler))
+  , _cfg(cfg)
+  , _classes(std::move(classes)) {}
+
+background_controller::background_controller(
+  ss::sharded<api>& api,
+  background_controller_config cfg,
+  std::vector<managed_class> classes)
+  : background_controller(
+    std::make_unique<flush_latency_sampler>(api), cfg, std::move(classes)) {
+    setup_metrics();
+}
+
+ss::future<> background_controller::start() {
+    _sampling_timer.set_callback([this] {
+        (void)ss::with_gate(_gate, [this] {
+            return update().then([this] {
+                if (!_gate.is_closed()) {
+                    _sampling_timer.arm(_cfg.sampling_interval);
+                }
+            });
+        });
+    });
+    _sampling_timer.arm(_cfg.sampling_interval);
+    return set();
+}
+
+ss::future<> background_controller::stop() {
+    _sampling_timer.cancel();
+    return _gate.close();
+}
+
+ss::future<> background_controller::update() {
+    _latency = co_await _sampler->sample_latency();
+    const auto target = static_cast<double>(
+      std::max<int64_t>(_cfg.target_latency.count(), 1));
+    auto error = std::clamp(
+      (target - static_cast<double>(_latency.count())) / target, -1.0, 1.0);
+
+    _factor = std::clamp(
+      _factor + _cfg.proportional_coeff * (error - _prev_error)
+        + _cfg.integral_coeff * error,
+      0.0,
+      1.0);
+    vlog(
+      background_log.trace,
+      "state update: {{target_us: {}, latency_us: {}, error: {}, prev_error: "
+      "{}, factor: {}}}",
+      _cfg.target_latency.count(),
+      _latency.count(),
+      error,
+      _prev_error,
+      _factor);
+    _prev_error = error;
+
+    co_await set();
+}
+
+ss::future<> background_controller::set() {
+    for (auto& c : _classes) {
+        auto range = static_cast<double>(c.max_shares - c.min_shares);
+        auto shares = c.min_shares + static_cast<int>(_factor * range);
+        vlog(background_log.debug, "updating {} shares {}", c.name, shares);
+        if (c.scheduling_group) {
+            c.scheduling_group->set_shares(static_cast<float>(shares));
+        }
+        co_await ss::engine().update_shares_for_class(c.io_priority, shares);
+    }
+}
+
+void background_controller::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:background:controller"),
+      {
+        sm::make_gauge(
+          "latency_us",
+          [this] { return _latency.count(); },
+          sm::description("Foreground latency sampled by the controller")),
+        sm::make_gauge(
+          "factor",
+          [this] { return _factor; },
+          sm::description("Controller output, i.e. fraction of the maximum "
+                          "shares given to the background work")),
+      });
+}
+
+} // namespace storage
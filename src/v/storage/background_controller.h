@@ -0,0 +1,108 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+#include "storage/fwd.h"
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/io_priority_class.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace storage {
+
+struct background_controller_config {
+    std::chrono::microseconds target_latency;
+    double proportional_coeff;
+    double integral_coeff;
+    std::chrono::milliseconds sampling_interval;
+};
+
+/**
+ * Controller of the shares of the background work of a shard.
+ *
+ * The controller samples the latency of the foreground writes (the average
+ * latency of the segment flushes since the previous sample) and keeps it
+ * under the target latency by scaling the shares of the background classes.
+ * The output of the controller is a factor in [0, 1] updated with a PI
+ * controller in velocity form:
+ *
+ *   error = (target - latency) / target, clamped to [-1, 1]
+ *   factor += k_p * (error - prev_error) + k_i * error
+ *
+ * so the background work backs off while the foreground latency is over the
+ * target and catches up when the disk is idle (no flushes give an error of
+ * 1). The shares of every managed class are set to
+ *
+ *   min_shares + factor * (max_shares - min_shares)
+ *
+ * Classes controlled by their own backlog controller, like compaction, use
+ * the factor to limit their output instead, see backlog_controller.
+ */
+class background_controller {
+public:
+    struct sampler {
+        /// Foreground latency since the previous sample
+        virtual ss::future<std::chrono::microseconds> sample_latency() = 0;
+        virtual ~sampler() noexcept = default;
+    };
+
+    struct managed_class {
+        ss::sstring name;
+        std::optional<ss::scheduling_group> scheduling_group;
+        ss::io_priority_class io_priority;
+        int min_shares;
+        int max_shares;
+    };
+
+    background_controller(
+      std::unique_ptr<sampler>,
+      background_controller_config,
+      std::vector<managed_class>);
+
+    /// Controller of the log manager of the shard
+    background_controller(
+      ss::sharded<api>&,
+      background_controller_config,
+      std::vector<managed_class>);
+
+    ss::future<> start();
+    ss::future<> stop();
+
+    double factor() const { return _factor; }
+    std::chrono::microseconds latency() const { return _latency; }
+
+    void setup_metrics();
+
+private:
+    ss::future<> update();
+    ss::future<> set();
+
+    std::unique_ptr<sampler> _sampler;
+    background_controller_config _cfg;
+    std::vector<managed_class> _classes;
+    ss::timer<> _sampling_timer;
+    // state
+    std::chrono::microseconds _latency{0};
+    double _prev_error{0};
+    double _factor{1};
+    ss::gate _gate;
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
@@ -125,9 +125,15 @@ ss::future<> backlog_controller::update() {
 }
 
 ss::future<> backlog_controller::set() {
-    vlog(_log.debug, "updating shares {}", _current_shares);
-    _scheduling_group.set_shares(static_cast<float>(_current_shares));
-    return ss::engine().update_shares_for_class(_io_priority, _current_shares);
+    auto shares = _current_shares;
+    if (_shares_limiter) {
+        shares = std::max(
+          _min_shares,
+          static_cast<int>(static_cast<double>(shares) * _shares_limiter()));
+    }
+    vlog(_log.debug, "updating shares {}", shares);
+    _scheduling_group.set_shares(static_cast<float>(shares));
+    return ss::engine().update_shares_for_class(_io_priority, shares);
 }
 
 void backlog_controller::setup_metrics(const ss::sstring& controller_label) {
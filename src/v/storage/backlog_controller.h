@@ -15,6 +15,7 @@
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/timer.hh>
 #include <seastar/util/log.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 namespace storage {
 struct backlog_controller_config {
@@ -94,6 +95,12 @@ public:
       std::unique_ptr<sampler>, ss::logger&, backlog_controller_config);
 
     void update_setpoint(int64_t);
+    /// Limit the output shares to a fraction of the shares computed by the
+    /// controller, e.g. to back off when the foreground latency is high. The
+    /// output never goes below the minimum shares.
+    void set_shares_limiter(ss::noncopyable_function<double()> f) {
+        _shares_limiter = std::move(f);
+    }
     ss::future<> start();
     ss::future<> stop();
 
@@ -124,6 +131,7 @@ private:
     int _current_shares;
     int _min_shares;
     int _max_shares;
+    ss::noncopyable_function<double()> _shares_limiter;
     ss::gate _gate;
     ss::metrics::metric_groups _metrics;
 };
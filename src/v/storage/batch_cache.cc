@@ -152,6 +152,9 @@ batch_cache::put(batch_cache_index& index, const model::record_batch& input) {
     int64_t diff = (int64_t)index._small_batches_range->memory_size()
                    - initial_sz;
     _size_bytes += diff;
+    if (index._small_batches_range->_protected) {
+        _protected_size_bytes += diff;
+    }
     _background_reclaimer.notify();
     return entry(offset, index._small_batches_range->weak_from_this());
 }
@@ -159,7 +162,8 @@ batch_cache::put(batch_cache_index& index, const model::record_batch& input) {
 batch_cache::~batch_cache() noexcept {
     clear();
     vassert(
-      _size_bytes == 0 && _lru.empty(),
+      _size_bytes == 0 && _protected_size_bytes == 0 && _lru.empty()
+        && _protected.empty(),
       "Detected incorrect batch_cache accounting. {}",
       *this);
 }
@@ -170,12 +174,57 @@ void batch_cache::evict(range_ptr&& e) {
         // invalidates the caller's range_ptr. simply interacting with the
         // r-value reference `e` wouldn't do that.
         auto p = std::exchange(e, {});
-        _size_bytes -= p->memory_size();
-        _lru.erase_and_dispose(
-          _lru.iterator_to(*p), [](range* e) { delete e; });
+        auto size = p->memory_size();
+        _size_bytes -= size;
+        if (p->_protected) {
+            _protected_size_bytes -= size;
+        }
+        auto& list = p->_protected ? _protected : _lru;
+        list.erase_and_dispose(
+          list.iterator_to(*p), [](range* e) { delete e; });
+    }
+}
+
+void batch_cache::touch(range_ptr& e) {
+    if (!e) {
+        return;
+    }
+    auto p = e.get();
+    p->_hook.unlink();
+    if (_reclaim_opts.protected_ratio <= 0) {
+        // plain lru
+        _lru.push_back(*p);
+        return;
+    }
+    if (!p->_protected) {
+        p->_protected = true;
+        _protected_size_bytes += p->memory_size();
+        _probe.promotion();
+    }
+    _protected.push_back(*p);
+    rebalance();
+}
+
+void batch_cache::rebalance() {
+    const auto budget = static_cast<size_t>(
+      static_cast<double>(_size_bytes) * _reclaim_opts.protected_ratio);
+    while (_protected_size_bytes > budget && !_protected.empty()) {
+        auto& r = _protected.front();
+        r._hook.unlink();
+        r._protected = false;
+        _protected_size_bytes -= r.memory_size();
+        // demoted ranges get another chance to be promoted before they are
+        // reclaimed
+        _lru.push_back(r);
+        _probe.demotion();
     }
 }
 
+void batch_cache::setup_metrics() {
+    _probe.setup_metrics(
+      [this] { return _size_bytes; }, [this] { return _protected_size_bytes; });
+}
+
 size_t batch_cache::reclaim(size_t size) {
     if (is_memory_reclaiming()) {
         return 0;
@@ -211,8 +260,46 @@ size_t batch_cache::reclaim(size_t size) {
     size_t reclaimed = 0;
     intrusive_list<range, &range::_hook> reclaimed_ranges;
 
-    for (auto it = _lru.begin(); it != _lru.end();) {
-        if (reclaimed >= _reclaim_size) {
+    // ranges that were read only once are reclaimed first
+    reclaim_from(_lru, _reclaim_size, reclaimed, reclaimed_ranges);
+    reclaim_from(_protected, _reclaim_size, reclaimed, reclaimed_ranges);
+
+    /*
+     * final removal from the index is deferred because there is some chance
+     * that removal allocates, so waiting until the bulk of the reclaims have
+     * occurred reduces the probability of an allocation failure.
+     */
+
+    reclaimed_ranges.clear_and_dispose([](range* e) {
+        auto* index = &e->_index;
+        auto offsets = std::move(e->_offsets);
+        delete e; // NOLINT
+
+        /*
+         * since reclaim may be invoked at any moment and removals may be
+         * deferred if an index is locked, one can imagine races in which a
+         * batch is removed by offset here which is not the same batch that was
+         * reclaimed in a prior pass. at worst this would raise the miss ratio,
+         * but is still generally safe since all batch cache users are prepared
+         * to handle a miss.
+         */
+        for (auto& o : offsets) {
+            index->remove(o);
+        }
+    });
+
+    _last_reclaim = ss::lowres_clock::now();
+    _size_bytes -= reclaimed;
+    return reclaimed;
+}
+
+void batch_cache::reclaim_from(
+  intrusive_list<range, &range::_hook>& list,
+  size_t target,
+  size_t& reclaimed,
+  intrusive_list<range, &range::_hook>& reclaimed_ranges) {
+    for (auto it = list.begin(); it != list.end();) {
+        if (reclaimed >= target) {
             break;
         }
 
@@ -223,10 +310,15 @@ size_t batch_cache::reclaim(size_t size) {
         }
         // if entry is empty it will be disposed by other reclaim caller
         if (unlikely(it->empty())) {
+            ++it;
             continue;
         }
         // reclaim the batch's record data
-        reclaimed += it->memory_size();
+        auto size = it->memory_size();
+        reclaimed += size;
+        if (it->_protected) {
+            _protected_size_bytes -= size;
+        }
         it->_arena.clear();
 
         /*
@@ -241,38 +333,10 @@ size_t batch_cache::reclaim(size_t size) {
         }
 
         // collect the entries that will be fully removed
-        it = _lru.erase_and_dispose(it, [&reclaimed_ranges](range* e) {
+        it = list.erase_and_dispose(it, [&reclaimed_ranges](range* e) {
             reclaimed_ranges.push_back(*e);
         });
     }
-
-    /*
-     * final removal from the index is deferred because there is some chance
-     * that removal allocates, so waiting until the bulk of the reclaims have
-     * occurred reduces the probability of an allocation failure.
-     */
-
-    reclaimed_ranges.clear_and_dispose([](range* e) {
-        auto* index = &e->_index;
-        auto offsets = std::move(e->_offsets);
-        delete e; // NOLINT
-
-        /*
-         * since reclaim may be invoked at any moment and removals may be
-         * deferred if an index is locked, one can imagine races in which a
-         * batch is removed by offset here which is not the same batch that was
-         * reclaimed in a prior pass. at worst this would raise the miss ratio,
-         * but is still generally safe since all batch cache users are prepared
-         * to handle a miss.
-         */
-        for (auto& o : offsets) {
-            index->remove(o);
-        }
-    });
-
-    _last_reclaim = ss::lowres_clock::now();
-    _size_bytes -= reclaimed;
-    return reclaimed;
 }
 
 std::optional<model::record_batch>
@@ -280,9 +344,11 @@ batch_cache_index::get(model::offset offset) {
     lock_guard lk(*this);
     if (auto it = find_first_contains(offset); it != _index.end()) {
         batch_cache::range::lock_guard g(*it->second.range());
+        _cache->record_hit(*it->second.range());
         _cache->touch(it->second.range());
         return it->second.batch();
     }
+    _cache->_probe.cache_miss();
     return std::nullopt;
 }
 
@@ -307,6 +373,9 @@ batch_cache_index::read_result batch_cache_index::read(
         offset = batch.last_offset() + model::offset(1);
         if (take) {
             batch_cache::range::lock_guard g(*it->second.range());
+            if (ret.batches.empty()) {
+                _cache->record_hit(*it->second.range());
+            }
             ret.memory_usage += batch.memory_usage();
             ret.batches.emplace_back(std::move(batch));
             if (!skip_lru_promote) {
@@ -349,6 +418,9 @@ batch_cache_index::read_result batch_cache_index::read(
             break;
         }
     }
+    if (ret.batches.empty()) {
+        _cache->_probe.cache_miss();
+    }
     ret.next_batch = offset;
     return ret;
 }
@@ -420,7 +492,9 @@ std::ostream& operator<<(std::ostream& o, const batch_cache& b) {
     // Do _not_ print size of _lru
     return o << "{is_reclaiming:" << b.is_memory_reclaiming()
              << ", size_bytes: " << b._size_bytes
-             << ", lru_empty:" << b._lru.empty() << "}";
+             << ", protected_size_bytes: " << b._protected_size_bytes
+             << ", lru_empty:" << b._lru.empty()
+             << ", protected_empty:" << b._protected.empty() << "}";
 }
 std::ostream&
 operator<<(std::ostream& o, const batch_cache_index::read_result& c) {
@@ -11,6 +11,7 @@
 
 #pragma once
 #include "model/record.h"
+#include "storage/probe.h"
 #include "units.h"
 #include "utils/intrusive_list_helpers.h"
 #include "vassert.h"
@@ -55,6 +56,19 @@ class batch_cache_index;
  * example, a batch cache index is created for each log segment, all of which
  * share the same LRU cache.
  *
+ * Eviction policy
+ * ===============
+ *
+ * The cache is a segmented LRU. New ranges are admitted to the probationary
+ * segment and are promoted to the protected segment when they are read
+ * again. The protected segment is limited to a fraction of the cache size,
+ * the ranges that don't fit are demoted back to the tail of the
+ * probationary segment. Reclaim removes the probationary ranges first. This
+ * way batches read only once (e.g. by a consumer catching up from the
+ * beginning of a topic) don't evict the batches that are re-read by the
+ * consumers tailing the log. With the protected ratio set to 0 the cache
+ * behaves like a plain LRU.
+ *
  * The LRU cache serves as an entry point for the Seastar memory reclaimer.
  * During a low-memory event Seastar may make an upcall to the LRU cache to free
  * memory. When memory is reclaimed cache entries are invalidated. Since this
@@ -92,8 +106,6 @@ class batch_cache_index;
  * the future, consider other solutions like blocking the reclaimer or only
  * allowing asynchronous reclaims while executing within the batch catch.
  *
- * TODO:
- *  - add probes to track statistics
  */
 
 class batch_cache {
@@ -110,6 +122,9 @@ public:
         ss::lowres_clock::duration stable_window;
         size_t min_size;
         size_t max_size;
+        // fraction of the cache size that can be used by the protected
+        // segment of the lru
+        double protected_ratio = 0.8;
         // background reclaimer settings
         ss::scheduling_group background_reclaimer_sg;
         size_t min_free_memory = 64_MiB;
@@ -188,6 +203,8 @@ public:
         std::vector<model::offset> _offsets;
 
         bool _pinned{false};
+        // the range is in the protected segment of the lru
+        bool _protected{false};
         size_t _size = 0;
         intrusive_list_hook _hook;
         batch_cache_index& _index;
@@ -235,6 +252,19 @@ public:
         _background_reclaimer.start();
     }
 
+    /// \brief applies the reclaim sizes, windows and protected ratio of the
+    /// options, the background reclaimer keeps its settings
+    void update_reclaim_options(const reclaim_options& opts) {
+        _reclaim_opts.growth_window = opts.growth_window;
+        _reclaim_opts.stable_window = opts.stable_window;
+        _reclaim_opts.min_size = opts.min_size;
+        _reclaim_opts.max_size = opts.max_size;
+        _reclaim_opts.protected_ratio = opts.protected_ratio;
+        _reclaim_size = std::max(
+          std::min(_reclaim_size, _reclaim_opts.max_size),
+          _reclaim_opts.min_size);
+    }
+
     batch_cache(const batch_cache&) = delete;
     batch_cache& operator=(const batch_cache&) = delete;
     batch_cache& operator=(batch_cache&&) = delete;
@@ -252,8 +282,11 @@ public:
 
     ss::future<> stop() { return _background_reclaimer.stop(); }
 
+    /// Register the cache metrics, should be called for one cache per shard
+    void setup_metrics();
+
     /// Returns true if the cache is empty, and false otherwise.
-    bool empty() const { return _lru.empty(); }
+    bool empty() const { return _lru.empty() && _protected.empty(); }
 
     /// Removes all entries from the cache.
     void clear() { reclaim(std::numeric_limits<size_t>::max()); }
@@ -284,14 +317,13 @@ public:
 
     /**
      * Notify the cache that the specified range was recently used.
+     *
+     * Ranges from the probationary segment are promoted to the protected
+     * one, ranges from the protected segment move to its tail.
      */
-    void touch(range_ptr& e) {
-        if (e) {
-            auto p = e.get();
-            p->_hook.unlink();
-            _lru.push_back(*p);
-        }
-    }
+    void touch(range_ptr& e);
+
+    const batch_cache_probe& get_probe() const { return _probe; }
 
     /**
      * \brief Evict batches up to the accumulated size specified.
@@ -309,6 +341,7 @@ public:
 
 private:
     friend batch_cache_test_fixture;
+    friend batch_cache_index;
     struct batch_reclaiming_lock {
         explicit batch_reclaiming_lock(batch_cache& b) noexcept
           : ref(b)
@@ -369,7 +402,31 @@ private:
                               : reclaim_result::reclaimed_nothing;
     }
 
+    void record_hit(const range& r) {
+        if (r._protected) {
+            _probe.protected_hit();
+        } else {
+            _probe.probationary_hit();
+        }
+    }
+
+    /// Move the least recently used protected ranges to the probationary
+    /// segment until the protected segment fits into its budget
+    void rebalance();
+
+    /// Reclaim ranges from the list until the 'reclaimed' reaches 'target'
+    void reclaim_from(
+      intrusive_list<range, &range::_hook>& list,
+      size_t target,
+      size_t& reclaimed,
+      intrusive_list<range, &range::_hook>& reclaimed_ranges);
+
+    // probationary segment of the lru
     intrusive_list<range, &range::_hook> _lru;
+    // protected segment of the lru
+    intrusive_list<range, &range::_hook> _protected;
+    size_t _protected_size_bytes{0};
+    batch_cache_probe _probe;
     reclaimer _reclaimer;
     bool _is_reclaiming{false};
     size_t _size_bytes{0};
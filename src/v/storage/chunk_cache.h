@@ -3,6 +3,7 @@
 #include "seastarx.h"
 #include "storage/logger.h"
 #include "storage/segment_appender_chunk.h"
+#include "utils/intrusive_list_helpers.h"
 #include "vassert.h"
 #include "vlog.h"
 
@@ -11,9 +12,13 @@
 #include <seastar/core/loop.hh>
 #include <seastar/core/semaphore.hh>
 #include <seastar/util/later.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 #include <boost/iterator/counting_iterator.hpp>
 
+#include <algorithm>
+#include <memory>
+
 namespace storage::internal {
 
 class chunk_cache {
@@ -30,6 +35,70 @@ public:
      */
     static constexpr const size_t alignment = 4_KiB;
 
+    /// chunks an appender is entitled to whatever the number of appenders:
+    /// the head and one chunk being written
+    static constexpr const size_t min_chunks_per_account = 2;
+
+    /**
+     * The chunks held by an appender.
+     *
+     * The chunks are shared between the active accounts, those holding or
+     * waiting for chunks, in proportion of their weights. An account below
+     * its share is served before the accounts that borrow the capacity left
+     * idle by the others, and the idle accounts are asked to return their
+     * chunks when an account below its share waits. A few busy appenders
+     * can't starve the others.
+     */
+    class account {
+    public:
+        account(chunk_cache& cache, size_t weight)
+          : _state(
+            std::make_unique<state>(cache, std::max<size_t>(weight, 1))) {
+            cache._accounts.push_back(*_state);
+        }
+        account(account&&) noexcept = default;
+        account& operator=(account&&) noexcept = default;
+        account(const account&) = delete;
+        account& operator=(const account&) = delete;
+        ~account() noexcept {
+            if (_state) {
+                vassert(
+                  _state->waiting == 0,
+                  "account destroyed with {} waiters",
+                  _state->waiting);
+                // chunks still in flight are returned without the account
+                _state->cache.update(
+                  *_state, [](state& st) { st.held = 0; });
+            }
+        }
+
+        size_t held() const { return _state->held; }
+
+        /// \brief invoked when an account below its share waits, returns
+        /// the chunks of the account if it's idle
+        void on_reclaim(ss::noncopyable_function<void()> f) {
+            _state->reclaim = std::move(f);
+        }
+
+    private:
+        friend class chunk_cache;
+
+        struct state {
+            state(chunk_cache& c, size_t w)
+              : cache(c)
+              , weight(w) {}
+
+            chunk_cache& cache;
+            size_t weight;
+            size_t held{0};
+            size_t waiting{0};
+            ss::noncopyable_function<void()> reclaim;
+            intrusive_list_hook hook;
+        };
+
+        std::unique_ptr<state> _state;
+    };
+
     chunk_cache() noexcept
       : _size_target(memory_groups::chunk_cache_min_memory())
       , _size_limit(memory_groups::chunk_cache_max_memory()) {}
@@ -53,34 +122,134 @@ public:
           });
     }
 
+    /// \brief returns a chunk taken by the account
+    void add(account& a, const chunk_ptr& chunk) {
+        update(*a._state, [](account::state& st) { --st.held; });
+        add(chunk);
+    }
+
     void add(const chunk_ptr& chunk) {
         if (_size_available >= _size_target) {
             _size_total -= chunk::chunk_size;
-            return;
+        } else {
+            _chunks.push_back(chunk);
+            _size_available += chunk::chunk_size;
+        }
+        // the accounts below their share first
+        if (_entitled.waiters()) {
+            _entitled.signal();
+        } else if (_borrowers.waiters()) {
+            _borrowers.signal();
         }
-        _chunks.push_back(chunk);
-        _size_available += chunk::chunk_size;
-        if (_sem.waiters()) {
-            _sem.signal();
+    }
+
+    size_t size_total() const { return _size_total; }
+    size_t size_limit() const { return _size_limit; }
+    size_t waiters() const {
+        return _entitled.waiters() + _borrowers.waiters();
+    }
+
+    /// \brief changes the memory the chunks can use. above a lower limit no
+    /// chunk is allocated until enough are released
+    void set_size_limit(size_t limit) {
+        const auto raised = limit > _size_limit;
+        _size_limit = limit;
+        if (raised) {
+            // the waiters may allocate now
+            _entitled.signal(_entitled.waiters());
+            _borrowers.signal(_borrowers.waiters());
         }
     }
 
-    ss::future<chunk_ptr> get() {
-        // don't steal if there are waiters
-        if (!_sem.waiters()) {
-            return do_get();
+    /// \brief the number of chunks the account is entitled to
+    size_t share(const account& a) const { return share(*a._state); }
+
+    ss::future<chunk_ptr> get(account& a) {
+        auto& s = *a._state;
+        if (s.held < share(s)) {
+            // don't steal from the entitled waiters
+            if (!_entitled.waiters()) {
+                if (auto c = take(s); c) {
+                    return ss::make_ready_future<chunk_ptr>(c);
+                }
+                // the returned chunks go to the entitled waiters if any
+                reclaim_idle(s);
+                if (auto c = take(s); c) {
+                    return ss::make_ready_future<chunk_ptr>(c);
+                }
+            }
+            return wait(s, _entitled);
+        }
+        // the idle capacity is borrowed once nobody waits
+        if (!waiters()) {
+            if (auto c = take(s); c) {
+                return ss::make_ready_future<chunk_ptr>(c);
+            }
         }
-        return ss::get_units(_sem, 1).then(
-          [this](ss::semaphore_units<>) { return do_get(); });
+        return wait(s, _borrowers);
     }
 
 private:
-    ss::future<chunk_ptr> do_get() {
-        if (auto c = pop_or_allocate(); c) {
-            return ss::make_ready_future<chunk_ptr>(c);
+    static bool is_active(const account::state& s) {
+        return s.held + s.waiting > 0;
+    }
+
+    /// \brief applies f to the account, keeping the active weight up to date
+    template<typename Func>
+    void update(account::state& s, Func f) {
+        const bool was_active = is_active(s);
+        f(s);
+        const bool active = is_active(s);
+        if (active && !was_active) {
+            _active_weight += s.weight;
+        } else if (!active && was_active) {
+            _active_weight -= s.weight;
+        }
+    }
+
+    size_t share(const account::state& s) const {
+        const auto capacity = _size_limit / chunk::chunk_size;
+        // an inactive account is counted as if it was active
+        auto weight = _active_weight + (is_active(s) ? 0 : s.weight);
+        return std::max(min_chunks_per_account, capacity * s.weight / weight);
+    }
+
+    chunk_ptr take(account::state& s) {
+        auto c = pop_or_allocate();
+        if (c) {
+            update(s, [](account::state& st) { ++st.held; });
+        }
+        return c;
+    }
+
+    ss::future<chunk_ptr> wait(account::state& s, ss::semaphore& sem) {
+        update(s, [](account::state& st) { ++st.waiting; });
+        // the signal is consumed, a woken waiter that finds no chunk waits
+        // for the next one
+        return sem.wait(1).then_wrapped([this, &s](ss::future<> f) {
+            update(s, [](account::state& st) { --st.waiting; });
+            f.get();
+            auto& next = s.held < share(s) ? _entitled : _borrowers;
+            if (auto c = take(s); c) {
+                // a chunk may be left for the next waiter
+                if (_size_available > 0 && next.waiters()) {
+                    next.signal();
+                }
+                return ss::make_ready_future<chunk_ptr>(c);
+            }
+            return wait(s, next);
+        });
+    }
+
+    /// \brief asks the other accounts holding chunks without waiting to
+    /// return them if they are idle
+    void reclaim_idle(const account::state& requester) {
+        for (auto& s : _accounts) {
+            if (
+              &s != &requester && s.held > 0 && s.waiting == 0 && s.reclaim) {
+                s.reclaim();
+            }
         }
-        return ss::get_units(_sem, 1).then(
-          [this](ss::semaphore_units<>) { return do_get(); });
     }
 
     chunk_ptr pop_or_allocate() {
@@ -104,11 +273,14 @@ private:
     }
 
     ss::chunked_fifo<chunk_ptr> _chunks;
-    ss::semaphore _sem{0};
+    ss::semaphore _entitled{0};
+    ss::semaphore _borrowers{0};
+    intrusive_list<account::state, &account::state::hook> _accounts;
+    size_t _active_weight{0};
     size_t _size_available{0};
     size_t _size_total{0};
     const size_t _size_target;
-    const size_t _size_limit;
+    size_t _size_limit;
 };
 
 inline chunk_cache& chunks() {
@@ -11,8 +11,12 @@
 
 #pragma once
 #include "bytes/bytes.h"
+#include "hashing/xx.h"
 #include "model/fundamental.h"
 
+#include <seastar/core/byteorder.hh>
+#include <seastar/util/bool_class.hh>
+
 #include <cstddef>
 #include <cstdint>
 #include <ostream>
@@ -38,6 +42,10 @@ struct compacted_index {
         truncation = 1U,
         /// needed to determine if we should self compact first
         self_compaction = 1U << 1U,
+        /// keys are key_digest()s of the record keys
+        key_digests = 1U << 2U,
+        /// a key_filter of the keys is between the entries and the footer
+        key_filter = 1U << 3U,
     };
     struct footer {
         uint32_t size{0};
@@ -62,6 +70,35 @@ struct compacted_index {
                                           + sizeof(footer::flags)
                                           + sizeof(footer::crc)
                                           + sizeof(footer::version);
+
+    /// \brief index fixed size digests of the keys instead of the keys
+    ///
+    /// keys that share a digest are compacted as one key, the copy of the
+    /// segment data compares key_fingerprint()s of the records to not drop
+    /// a record whose key only collided with the key of a kept record
+    using key_digests_mode = ss::bool_class<struct key_digests_mode_tag>;
+    static constexpr size_t key_digest_size = 16;
+
+    /// \brief write a key_filter of the keys with the index, so that the
+    /// segments without the key are skipped by the key queries
+    using key_filter_mode = ss::bool_class<struct key_filter_mode_tag>;
+
+    static bytes key_digest(bytes_view key) {
+        // NOLINTNEXTLINE
+        const auto h = xxhash_128(
+          reinterpret_cast<const char*>(key.data()), key.size());
+        bytes ret(bytes::initialized_later{}, key_digest_size);
+        // NOLINTNEXTLINE
+        auto out = reinterpret_cast<char*>(ret.data());
+        ss::write_le(out, h.low64);
+        ss::write_le(out + sizeof(h.low64), h.high64);
+        return ret;
+    }
+    /// second hash of the key, uses a different algorithm than key_digest()
+    static uint64_t key_fingerprint(bytes_view key) {
+        return xxhash_64(key.data(), key.size());
+    }
+
     // for the readers and friends
     struct entry {
         entry(entry_type t, bytes k, model::offset o, int32_t d) noexcept
@@ -75,11 +75,9 @@ ss::future<> compacted_index_chunk_reader::verify_integrity() {
         return ss::do_with(
                  int32_t(_footer->size),
                  crc::crc32c{},
+                 // the key filter after the entries is not in the checksum
                  ss::make_file_input_stream(
-                   _handle,
-                   0,
-                   _file_size.value() - compacted_index::footer_size,
-                   std::move(options)),
+                   _handle, 0, _footer->size, std::move(options)),
                  [](
                    int32_t& max_bytes,
                    crc::crc32c& crc,
@@ -143,7 +143,16 @@ inline ss::future<> compacted_index_writer::append(compacted_index::entry e) {
 }
 inline ss::future<> compacted_index_writer::close() { return _impl->close(); }
 
+/// \param key_digests index a compacted_index::key_digest() of the keys
+/// \param key_filter write a key_filter of the keys with the index
 compacted_index_writer make_file_backed_compacted_index(
-  ss::sstring filename, ss::file, ss::io_priority_class p, size_t max_memory);
+  ss::sstring filename,
+  ss::file,
+  ss::io_priority_class p,
+  size_t max_memory,
+  compacted_index::key_digests_mode key_digests
+  = compacted_index::key_digests_mode::no,
+  compacted_index::key_filter_mode key_filter
+  = compacted_index::key_filter_mode::no);
 
 } // namespace storage
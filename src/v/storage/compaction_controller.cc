@@ -29,4 +29,13 @@ compaction_controller::compaction_controller(
     _ctrl.setup_metrics("storage:compaction");
 }
 
+compaction_controller::compaction_controller(
+  ss::sharded<api>& api,
+  ss::sharded<background_controller>& background,
+  backlog_controller_config cfg)
+  : compaction_controller(api, cfg) {
+    _ctrl.set_shares_limiter(
+      [&background] { return background.local().factor(); });
+}
+
 } // namespace storage
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "storage/background_controller.h"
 #include "storage/backlog_controller.h"
 #include "storage/fwd.h"
 
@@ -33,6 +34,11 @@ private:
 class compaction_controller {
 public:
     compaction_controller(ss::sharded<api>&, backlog_controller_config);
+    /// Compaction backs off with the background work of the shard
+    compaction_controller(
+      ss::sharded<api>&,
+      ss::sharded<background_controller>&,
+      backlog_controller_config);
 
     ss::future<> start() { return _ctrl.start(); }
     ss::future<> stop() { return _ctrl.stop(); }
@@ -82,6 +82,66 @@ Roaring compaction_key_reducer::end_of_stream() {
     return std::move(_inverted);
 }
 
+bool key_offset_map::put(bytes key, model::offset o) {
+    if (auto it = _map.find(key); it != _map.end()) {
+        it->second = std::max(it->second, o);
+        return true;
+    }
+    if (idx_mem_usage() + _keys_mem_usage + key.size() >= _max_mem) {
+        return false;
+    }
+    _keys_mem_usage += key.size();
+    _map.emplace(std::move(key), o);
+    return true;
+}
+
+std::optional<model::offset> key_offset_map::get(const bytes& key) const {
+    if (auto it = _map.find(key); it != _map.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+ss::future<ss::stop_iteration>
+key_offset_map_reducer::operator()(compacted_index::entry&& e) {
+    using stop_t = ss::stop_iteration;
+    if (e.type != compacted_index::entry_type::key) {
+        return ss::make_ready_future<stop_t>(stop_t::no);
+    }
+    const model::offset o = e.offset + model::offset(e.delta);
+    if (!_map->put(std::move(e.key), o)) {
+        _full = true;
+        return ss::make_ready_future<stop_t>(stop_t::yes);
+    }
+    return ss::make_ready_future<stop_t>(stop_t::no);
+}
+
+ss::future<ss::stop_iteration>
+key_offset_map_filter_reducer::operator()(compacted_index::entry&& e) {
+    using stop_t = ss::stop_iteration;
+    const model::offset o = e.offset + model::offset(e.delta);
+    bool keep = e.type != compacted_index::entry_type::key
+                || o == _last_offset;
+    if (!keep) {
+        // keys missing from the map are not superseded in the window
+        auto latest = _map->get(e.key);
+        keep = !latest || *latest <= o;
+    }
+    if (keep) {
+        _to_keep.add(_natural_index);
+    }
+    ++_natural_index;
+    return ss::make_ready_future<stop_t>(stop_t::no);
+}
+
+std::optional<Roaring> key_offset_map_filter_reducer::end_of_stream() {
+    if (_to_keep.cardinality() == _natural_index) {
+        return std::nullopt;
+    }
+    _to_keep.shrinkToFit();
+    return std::move(_to_keep);
+}
+
 ss::future<ss::stop_iteration>
 index_copy_reducer::operator()(compacted_index::entry&& e) {
     using stop_t = ss::stop_iteration;
@@ -113,17 +173,43 @@ compacted_offset_list_reducer::operator()(compacted_index::entry&& e) {
     return ss::make_ready_future<stop_t>(stop_t::no);
 }
 
+bool copy_data_segment_reducer::should_keep(
+  model::offset base, const model::record_key_view& r) const {
+    if (_list.contains(base + model::offset(r.offset_delta))) {
+        return true;
+    }
+    if (!_fingerprints) {
+        return false;
+    }
+    // the record is only superseded if the kept record has the same key and
+    // not just the same key digest. a missing digest is never superseded
+    const auto key = r.key.value_or(bytes_view());
+    auto it = _fingerprints->find(compacted_index::key_digest(key));
+    if (
+      it != _fingerprints->end()
+      && it->second == compacted_index::key_fingerprint(key)) {
+        return false;
+    }
+    vlog(
+      stlog.debug,
+      "keeping record at offset {} whose key digest collided",
+      base + model::offset(r.offset_delta));
+    return true;
+}
+
 std::optional<model::record_batch>
 copy_data_segment_reducer::filter(model::record_batch&& batch) {
     // 1. compute which records to keep
     const auto base = batch.base_offset();
     std::vector<int32_t> offset_deltas;
     offset_deltas.reserve(batch.record_count());
-    batch.for_each_record([this, base, &offset_deltas](const model::record& r) {
-        if (should_keep(base, r.offset_delta())) {
-            offset_deltas.push_back(r.offset_delta());
+    // the keys are compared without materializing the records
+    const auto scan = model::scan_records(batch);
+    for (const auto& r : scan.records) {
+        if (should_keep(base, r)) {
+            offset_deltas.push_back(r.offset_delta);
         }
-    });
+    }
 
     // 2. no record to keep
     if (offset_deltas.empty()) {
@@ -140,28 +226,20 @@ copy_data_segment_reducer::filter(model::record_batch&& batch) {
     int32_t rec_count = 0;
     std::optional<int64_t> first_timestamp_delta;
     int64_t last_timestamp_delta;
-    batch.for_each_record([&rec_count,
-                           &first_timestamp_delta,
-                           &last_timestamp_delta,
-                           &ret,
-                           &offset_deltas](model::record record) {
+    batch.for_each_record_view([&rec_count,
+                                &first_timestamp_delta,
+                                &last_timestamp_delta,
+                                &ret,
+                                &offset_deltas](const model::record_view& r) {
         // contains the key
         if (std::count(
-              offset_deltas.begin(),
-              offset_deltas.end(),
-              record.offset_delta())) {
-            /*
-             * TODO when we further optimize lazy record materialization ot
-             * make use of views we can avoid this re-encoding by copying or
-             * sharing the view. either way, we were building
-             * record batch with the uncompressed records so they were being
-             * re-encoded.
-             */
+              offset_deltas.begin(), offset_deltas.end(), r.offset_delta())) {
             if (!first_timestamp_delta) {
-                first_timestamp_delta = record.timestamp_delta();
+                first_timestamp_delta = r.timestamp_delta();
             }
-            last_timestamp_delta = record.timestamp_delta();
-            model::append_record_to_buffer(ret, record);
+            last_timestamp_delta = r.timestamp_delta();
+            // the kept records are copied as is, without re-encoding
+            r.append_to(ret);
             ++rec_count;
         }
     });
@@ -229,36 +307,60 @@ ss::future<ss::stop_iteration> copy_data_segment_reducer::do_compaction(
     }
     return compress_batch(original, std::move(to_copy.value()))
       .then([this](model::record_batch&& b) {
-          return ss::do_with(std::move(b), [this](model::record_batch& batch) {
-              auto const start_offset = _appender->file_byte_offset();
-              auto const header_size = batch.header().size_bytes;
-              _acc += header_size;
-              if (_idx.maybe_index(
-                    _acc,
-                    32_KiB,
-                    start_offset,
-                    batch.base_offset(),
-                    batch.last_offset(),
-                    batch.header().first_timestamp,
-                    batch.header().max_timestamp)) {
-                  _acc = 0;
-              }
-              return storage::write(*_appender, batch)
-                .then([this, start_offset, header_size] {
-                    vassert(
-                      _appender->file_byte_offset()
-                        == start_offset + header_size,
-                      "Size must be deterministic. Expected:{} == {}",
-                      _appender->file_byte_offset(),
-                      start_offset + header_size);
-                });
-          });
+          return write_batch(std::move(b));
+      });
+}
+
+ss::future<ss::stop_iteration>
+copy_data_segment_reducer::do_recompression(model::record_batch&& b) {
+    const auto codec = *_recompression;
+    if (!recompression_check_reducer::needs_recompression(b.header(), codec)) {
+        return write_batch(std::move(b));
+    }
+    return decompress_batch(std::move(b))
+      .then([codec](model::record_batch&& b) {
+          return compress_batch(codec, std::move(b));
       })
+      .then([this](model::record_batch&& b) {
+          return write_batch(std::move(b));
+      });
+}
+
+ss::future<ss::stop_iteration>
+copy_data_segment_reducer::write_batch(model::record_batch&& b) {
+    using stop_t = ss::stop_iteration;
+    return ss::do_with(std::move(b), [this](model::record_batch& batch) {
+               auto const start_offset = _appender->file_byte_offset();
+               auto const header_size = batch.header().size_bytes;
+               _acc += header_size;
+               if (_idx.maybe_index(
+                     _acc,
+                     32_KiB,
+                     start_offset,
+                     batch.base_offset(),
+                     batch.last_offset(),
+                     batch.header().first_timestamp,
+                     batch.header().max_timestamp)) {
+                   _acc = 0;
+               }
+               return storage::write(*_appender, batch)
+                 .then([this, start_offset, header_size] {
+                     vassert(
+                       _appender->file_byte_offset()
+                         == start_offset + header_size,
+                       "Size must be deterministic. Expected:{} == {}",
+                       _appender->file_byte_offset(),
+                       start_offset + header_size);
+                 });
+           })
       .then([] { return ss::make_ready_future<stop_t>(stop_t::no); });
 }
 
 ss::future<ss::stop_iteration>
 copy_data_segment_reducer::operator()(model::record_batch&& b) {
+    if (_recompression) {
+        return do_recompression(std::move(b));
+    }
     const auto comp = b.header().attrs.compression();
     if (!b.compressed()) {
         return do_compaction(comp, std::move(b));
@@ -269,6 +371,110 @@ copy_data_segment_reducer::operator()(model::record_batch&& b) {
       });
 }
 
+bool recompression_check_reducer::needs_recompression(
+  const model::record_batch_header& h, model::compression codec) {
+    return h.type == model::record_batch_type::raft_data
+           && !h.attrs.is_control() && h.attrs.compression() != codec;
+}
+
+ss::future<ss::stop_iteration>
+recompression_check_reducer::operator()(model::record_batch&& b) {
+    _found = needs_recompression(b.header(), _codec);
+    return ss::make_ready_future<ss::stop_iteration>(
+      ss::stop_iteration(_found));
+}
+
+ss::future<ss::stop_iteration>
+key_fingerprint_reducer::operator()(model::record_batch&& b) {
+    using stop_t = ss::stop_iteration;
+    if (!b.compressed()) {
+        collect(b);
+        return ss::make_ready_future<stop_t>(stop_t::no);
+    }
+    return decompress_batch(std::move(b)).then([this](model::record_batch&& b) {
+        collect(b);
+        return stop_t::no;
+    });
+}
+
+void key_fingerprint_reducer::collect(const model::record_batch& b) {
+    const auto base = b.base_offset();
+    const auto scan = model::scan_records(b);
+    for (const auto& r : scan.records) {
+        if (!_list->contains(base + model::offset(r.offset_delta))) {
+            continue;
+        }
+        const auto key = r.key.value_or(bytes_view());
+        // records kept for the same digest are usually the same key, when
+        // they are not only one of them is remembered, the copy then keeps
+        // the superseded records of the other keys too
+        _fingerprints.insert_or_assign(
+          compacted_index::key_digest(key),
+          compacted_index::key_fingerprint(key));
+    }
+}
+
+ss::future<ss::stop_iteration>
+key_query_reducer::operator()(model::record_batch&& b) {
+    using stop_t = ss::stop_iteration;
+    if (
+      b.header().type != model::record_batch_type::raft_data
+      || b.header().attrs.is_control()) {
+        return ss::make_ready_future<stop_t>(stop_t::no);
+    }
+    if (!b.compressed()) {
+        scan(std::move(b));
+        return ss::make_ready_future<stop_t>(stop_t::no);
+    }
+    return decompress_batch(std::move(b)).then([this](model::record_batch&& b) {
+        scan(std::move(b));
+        return stop_t::no;
+    });
+}
+
+void key_query_reducer::scan(model::record_batch&& b) {
+    std::optional<int32_t> latest;
+    {
+        const auto records = model::scan_records(b);
+        for (const auto& r : records.records) {
+            if (r.key && *r.key == bytes_view(_key)) {
+                latest = r.offset_delta;
+            }
+        }
+    }
+    if (latest) {
+        _batch = std::move(b);
+        _offset_delta = *latest;
+    }
+}
+
+std::optional<storage::key_query_result> key_query_reducer::end_of_stream() {
+    if (!_batch) {
+        return std::nullopt;
+    }
+    std::optional<storage::key_query_result> ret;
+    const auto& h = _batch->header();
+    _batch->for_each_record_view([this, &h, &ret](const model::record_view& r) {
+        if (r.offset_delta() != _offset_delta) {
+            return;
+        }
+        auto time = h.max_timestamp;
+        if (h.attrs.timestamp_type() == model::timestamp_type::create_time) {
+            time = model::timestamp(h.first_timestamp() + r.timestamp_delta());
+        }
+        std::optional<iobuf> value;
+        if (auto v = r.value(); v) {
+            value = v->copy();
+        }
+        ret = storage::key_query_result{
+          .offset = h.base_offset + model::offset(r.offset_delta()),
+          .time = time,
+          .value = std::move(value),
+        };
+    });
+    return ret;
+}
+
 ss::future<ss::stop_iteration>
 index_rebuilder_reducer::operator()(model::record_batch&& b) {
     using stop_t = ss::stop_iteration;
@@ -14,15 +14,18 @@
 #include "bytes/bytes.h"
 #include "hashing/xx.h"
 #include "model/record_batch_reader.h"
+#include "model/record_utils.h"
 #include "storage/compacted_index.h"
 #include "storage/compacted_index_writer.h"
 #include "storage/compacted_offset_list.h"
 #include "storage/index_state.h"
 #include "storage/logger.h"
 #include "storage/segment_appender.h"
+#include "storage/types.h"
 #include "units.h"
 
 #include <absl/container/btree_map.h>
+#include <absl/container/flat_hash_map.h>
 #include <absl/container/node_hash_map.h>
 #include <fmt/core.h>
 #include <roaring/roaring.hh>
@@ -66,6 +69,72 @@ private:
     uint32_t _natural_index{0};
 };
 
+/// Latest offset of the keys of a window of segments. Keys that would exceed
+/// the memory budget are not added
+class key_offset_map {
+public:
+    using underlying_t = absl::flat_hash_map<
+      bytes,
+      model::offset,
+      bytes_hasher<uint64_t, xxhash_64>,
+      bytes_type_eq>;
+
+    explicit key_offset_map(size_t max_mem)
+      : _max_mem(max_mem) {}
+
+    /// \return false if the key is new and there is no memory left for it
+    bool put(bytes key, model::offset);
+    std::optional<model::offset> get(const bytes& key) const;
+    size_t size() const { return _map.size(); }
+    size_t mem_usage() const { return idx_mem_usage() + _keys_mem_usage; }
+
+private:
+    size_t idx_mem_usage() const {
+        using debug = absl::container_internal::hashtable_debug_internal::
+          HashtableDebugAccess<underlying_t>;
+        return debug::AllocatedByteSize(_map);
+    }
+    underlying_t _map;
+    size_t _keys_mem_usage{0};
+    size_t _max_mem;
+};
+
+/// Adds the keys of a compacted index to the map, stops once the map is
+/// full. \return true if the whole index was added
+class key_offset_map_reducer : public compaction_reducer {
+public:
+    explicit key_offset_map_reducer(key_offset_map& m)
+      : _map(&m) {}
+
+    ss::future<ss::stop_iteration> operator()(compacted_index::entry&&);
+    bool end_of_stream() const { return !_full; }
+
+private:
+    key_offset_map* _map;
+    bool _full{false};
+};
+
+/// Natural index of the entries of a compacted index whose key is not
+/// superseded by a later offset in the map. The entry of the last offset of
+/// the segment is always kept so that the segment keeps its offset range.
+/// \return nullopt if no entry is superseded
+class key_offset_map_filter_reducer : public compaction_reducer {
+public:
+    key_offset_map_filter_reducer(
+      const key_offset_map& m, model::offset last_offset)
+      : _map(&m)
+      , _last_offset(last_offset) {}
+
+    ss::future<ss::stop_iteration> operator()(compacted_index::entry&&);
+    std::optional<Roaring> end_of_stream();
+
+private:
+    const key_offset_map* _map;
+    model::offset _last_offset;
+    Roaring _to_keep;
+    uint32_t _natural_index{0};
+};
+
 /// This class copies the input reader into the writer consulting the bitmap of
 /// wether ot keep the entry or not
 class index_filtered_copy_reducer : public compaction_reducer {
@@ -109,9 +178,30 @@ private:
 
 class copy_data_segment_reducer : public compaction_reducer {
 public:
-    copy_data_segment_reducer(compacted_offset_list l, segment_appender* a)
+    /// compacted_index::key_fingerprint() of the key of the kept records by
+    /// their compacted_index::key_digest()
+    using key_fingerprints = absl::flat_hash_map<
+      bytes,
+      uint64_t,
+      bytes_hasher<uint64_t, xxhash_64>,
+      bytes_type_eq>;
+
+    /// \param fps fingerprints of the kept records when the compacted list
+    ///        was generated from an index of key digests
+    copy_data_segment_reducer(
+      compacted_offset_list l,
+      segment_appender* a,
+      std::optional<key_fingerprints> fps = std::nullopt)
       : _list(std::move(l))
-      , _appender(a) {}
+      , _appender(a)
+      , _fingerprints(std::move(fps)) {}
+
+    /// \brief copies all the batches, the batches that need it are written
+    /// compressed with the codec instead, see recompression_check_reducer
+    copy_data_segment_reducer(segment_appender* a, model::compression codec)
+      : _list(model::offset{}, Roaring{})
+      , _appender(a)
+      , _recompression(codec) {}
 
     ss::future<ss::stop_iteration> operator()(model::record_batch&&);
     storage::index_state end_of_stream() { return std::move(_idx); }
@@ -119,19 +209,76 @@ public:
 private:
     ss::future<ss::stop_iteration>
     do_compaction(model::compression, model::record_batch&&);
+    ss::future<ss::stop_iteration> do_recompression(model::record_batch&&);
+    ss::future<ss::stop_iteration> write_batch(model::record_batch&&);
 
-    bool should_keep(model::offset base, int32_t delta) const {
-        const auto o = base + model::offset(delta);
-        return _list.contains(o);
-    }
+    bool should_keep(model::offset base, const model::record_key_view&) const;
     std::optional<model::record_batch> filter(model::record_batch&&);
 
     compacted_offset_list _list;
     segment_appender* _appender;
+    std::optional<key_fingerprints> _fingerprints;
+    std::optional<model::compression> _recompression;
     index_state _idx;
     size_t _acc{0};
 };
 
+/// Whether a segment has batches to recompress with the codec, stops at the
+/// first one. Only the batches of data are recompressed, the batches of the
+/// other types are read by redpanda as they were written.
+class recompression_check_reducer : public compaction_reducer {
+public:
+    explicit recompression_check_reducer(model::compression codec)
+      : _codec(codec) {}
+
+    static bool
+    needs_recompression(const model::record_batch_header&, model::compression);
+
+    ss::future<ss::stop_iteration> operator()(model::record_batch&&);
+    bool end_of_stream() const { return _found; }
+
+private:
+    model::compression _codec;
+    bool _found{false};
+};
+
+/// Collects the key fingerprints of the records in the compacted list, the
+/// first pass of the copy when the index has key digests
+class key_fingerprint_reducer : public compaction_reducer {
+public:
+    explicit key_fingerprint_reducer(const compacted_offset_list& l)
+      : _list(&l) {}
+
+    ss::future<ss::stop_iteration> operator()(model::record_batch&&);
+    copy_data_segment_reducer::key_fingerprints end_of_stream() {
+        return std::move(_fingerprints);
+    }
+
+private:
+    void collect(const model::record_batch&);
+
+    const compacted_offset_list* _list;
+    copy_data_segment_reducer::key_fingerprints _fingerprints;
+};
+
+/// The latest record of a key in the batches of data, the batch of the
+/// latest record seen is kept until the end of the stream
+class key_query_reducer : public compaction_reducer {
+public:
+    explicit key_query_reducer(bytes key)
+      : _key(std::move(key)) {}
+
+    ss::future<ss::stop_iteration> operator()(model::record_batch&&);
+    std::optional<storage::key_query_result> end_of_stream();
+
+private:
+    void scan(model::record_batch&&);
+
+    bytes _key;
+    std::optional<model::record_batch> _batch;
+    int32_t _offset_delta{0};
+};
+
 class index_rebuilder_reducer : public compaction_reducer {
 public:
     explicit index_rebuilder_reducer(compacted_index_writer* w) noexcept
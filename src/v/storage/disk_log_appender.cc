@@ -126,6 +126,7 @@ disk_log_appender::append_batch_to_segment(const model::record_batch& batch) {
         // substract the bytes from the append
         // take the min because _bytes_left_in_segment is optimistic
         _bytes_left_in_segment -= std::min(_bytes_left_in_segment, r.byte_size);
+        _log.maybe_stage_next_segment(_config.io_priority);
         return ss::stop_iteration::no;
     });
 }
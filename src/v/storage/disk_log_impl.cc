@@ -9,13 +9,16 @@
 
 #include "storage/disk_log_impl.h"
 
+#include "config/configuration.h"
 #include "model/adl_serde.h"
 #include "model/fundamental.h"
 #include "model/namespace.h"
 #include "model/timeout_clock.h"
 #include "reflection/adl.h"
+#include "storage/compaction_reducers.h"
 #include "storage/disk_log_appender.h"
 #include "storage/fwd.h"
+#include "storage/key_filter.h"
 #include "storage/kvstore.h"
 #include "storage/log_manager.h"
 #include "storage/logger.h"
@@ -24,6 +27,7 @@
 #include "storage/readers_cache.h"
 #include "storage/segment.h"
 #include "storage/segment_set.h"
+#include "storage/segment_summary.h"
 #include "storage/segment_utils.h"
 #include "storage/types.h"
 #include "storage/version.h"
@@ -42,6 +46,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <iterator>
 
 using namespace std::literals::chrono_literals;
@@ -68,6 +73,11 @@ disk_log_impl::disk_log_impl(
         }
     }
     _probe.initial_segments_count(_segs.size());
+    if (is_compaction_pending()) {
+        _probe.compaction_pending();
+    }
+    _probe.set_disk_usage(_manager.usage().add_log(
+      config().base_directory(), model::topic_namespace_view(config().ntp())));
     _probe.setup_metrics(this->config().ntp());
 }
 disk_log_impl::~disk_log_impl() {
@@ -77,6 +87,7 @@ disk_log_impl::~disk_log_impl() {
 ss::future<> disk_log_impl::remove() {
     vassert(!_closed, "Invalid double closing of log - {}", *this);
     _closed = true;
+    release_disk_usage();
     // gets all the futures started in the background
     std::vector<ss::future<>> permanent_delete;
     permanent_delete.reserve(_segs.size());
@@ -87,8 +98,9 @@ ss::future<> disk_log_impl::remove() {
           remove_segment_permanently(s, "disk_log_impl::remove()"));
     }
 
-    return _readers_cache->stop().then(
-      [this, permanent_delete = std::move(permanent_delete)]() mutable {
+    return discard_staged_segment()
+      .then([this] { return _readers_cache->stop(); })
+      .then([this, permanent_delete = std::move(permanent_delete)]() mutable {
           // wait for all futures
           return ss::when_all_succeed(
                    permanent_delete.begin(), permanent_delete.end())
@@ -99,24 +111,78 @@ ss::future<> disk_log_impl::remove() {
                 return _kvstore.remove(
                   kvstore::key_space::storage,
                   internal::start_offset_key(config().ntp()));
+            })
+            .then([this] {
+                return _kvstore.remove(
+                  kvstore::key_space::storage,
+                  internal::clean_segment_key(config().ntp()));
             });
       });
 }
 ss::future<> disk_log_impl::close() {
     vassert(!_closed, "Invalid double closing of log - {}", *this);
     _closed = true;
+    release_disk_usage();
     if (
       _eviction_monitor
       && !_eviction_monitor->promise.get_future().available()) {
         _eviction_monitor->promise.set_exception(segment_closed_exception());
     }
-    return _readers_cache->stop().then([this] {
-        return ss::parallel_for_each(_segs, [](ss::lw_shared_ptr<segment>& h) {
-            return h->close().handle_exception([h](std::exception_ptr e) {
-                vlog(stlog.error, "Error closing segment:{} - {}", e, h);
-            });
-        });
-    });
+    return discard_staged_segment()
+      .then([this] { return _readers_cache->stop(); })
+      .then([this] {
+          return ss::do_with(true, [this](bool& clean) {
+              return ss::parallel_for_each(
+                       _segs,
+                       [&clean](ss::lw_shared_ptr<segment>& h) {
+                           return h->close().handle_exception(
+                             [h, &clean](std::exception_ptr e) {
+                                 clean = false;
+                                 vlog(
+                                   stlog.error,
+                                   "Error closing segment:{} - {}",
+                                   e,
+                                   h);
+                             });
+                       })
+                .then([this, &clean] {
+                    return clean ? write_clean_segment_marker() : ss::now();
+                });
+          });
+      });
+}
+
+void disk_log_impl::release_disk_usage() {
+    _manager.usage().remove_log(
+      _probe.get_disk_usage(),
+      model::topic_namespace_view(config().ntp()),
+      _probe.partition_size());
+}
+
+ss::future<> disk_log_impl::write_clean_segment_marker() {
+    if (_segs.empty()) {
+        return ss::now();
+    }
+    // the index of the last segment was flushed when it was closed, record
+    // it so the segment doesn't have to be replayed on the next start
+    auto name = _segs.back()->reader().filename();
+    return ss::file_size(name)
+      .then([this, name](uint64_t size) {
+          auto marker = clean_segment_marker{
+            .segment_name = std::filesystem::path(name).filename().string(),
+            .size_bytes = size};
+          return _kvstore.put(
+            kvstore::key_space::storage,
+            internal::clean_segment_key(config().ntp()),
+            reflection::to_iobuf(std::move(marker)));
+      })
+      .handle_exception([this](std::exception_ptr e) {
+          vlog(
+            stlog.warn,
+            "Unable to mark log {} as cleanly closed: {}",
+            config().ntp(),
+            e);
+      });
 }
 
 model::offset disk_log_impl::size_based_gc_max_offset(size_t max_size) {
@@ -212,7 +278,38 @@ ss::future<> disk_log_impl::garbage_collect_segments(
     }
 
     max_offset = std::min(max_offset, _max_collectible_offset);
+    auto f = ss::make_ready_future<model::offset>(max_offset);
+    if (have_segments_to_evict) {
+        f = stm_snapshot_horizon(max_offset);
+    }
+    return f.then([this, as, ctx](model::offset max_offset) {
+        return do_garbage_collect_segments(max_offset, as, ctx);
+    });
+}
+
+ss::future<model::offset>
+disk_log_impl::stm_snapshot_horizon(model::offset max_offset) {
+    auto horizon = _stm_manager->snapshot_horizon();
+    if (!horizon || *horizon >= max_offset) {
+        return ss::make_ready_future<model::offset>(max_offset);
+    }
+    // the state machines snapshot their state ahead of the eviction, the log
+    // is evicted up to what they cover and the rest on the next iteration
+    vlog(
+      gclog.debug,
+      "[{}] snapshotting state machines ahead of eviction, horizon: {}, "
+      "eviction offset: {}",
+      config().ntp(),
+      *horizon,
+      max_offset);
+    return _stm_manager->make_snapshot().then([this, max_offset] {
+        auto horizon = _stm_manager->snapshot_horizon();
+        return horizon ? std::min(*horizon, max_offset) : max_offset;
+    });
+}
 
+ss::future<> disk_log_impl::do_garbage_collect_segments(
+  model::offset max_offset, ss::abort_source* as, std::string_view ctx) {
     return ss::do_until(
       [this, as, max_offset] {
           return _segs.size() <= 1 || as->abort_requested()
@@ -238,7 +335,7 @@ ss::future<> disk_log_impl::garbage_collect_segments(
                     return ss::now();
                 }
                 _segs.pop_front();
-                return remove_segment_permanently(ptr, ctx);
+                return remove_segment_in_background(ptr, ctx);
             })
             .then([this] {
                 // we have to update start offset with the most recent offset as
@@ -262,6 +359,16 @@ ss::future<> disk_log_impl::garbage_collect_oldest_segments(
     return garbage_collect_segments(max_offset, as, "gc[time_based_retention]");
 }
 
+bool disk_log_impl::is_compaction_pending() const {
+    if (!config().is_compacted()) {
+        return false;
+    }
+    return std::any_of(
+      _segs.begin(), _segs.end(), [](const ss::lw_shared_ptr<segment>& s) {
+          return !s->has_appender() && !s->finished_self_compaction();
+      });
+}
+
 ss::future<> disk_log_impl::do_compact(compaction_config cfg) {
     // find first not compacted segment
     auto segit = std::find_if(
@@ -295,6 +402,9 @@ ss::future<> disk_log_impl::do_compact(compaction_config cfg) {
         }
     }
 
+    // compact keys across segments and then merge the small outputs
+    co_await sliding_window_compact(cfg);
+
     if (auto range = find_compaction_range(); range) {
         auto r = co_await compact_adjacent_segments(std::move(*range), cfg);
         vlog(
@@ -306,6 +416,83 @@ ss::future<> disk_log_impl::do_compact(compaction_config cfg) {
     }
 }
 
+std::vector<ss::lw_shared_ptr<segment>>
+disk_log_impl::find_sliding_window() const {
+    // the oldest segments that are closed and self compacted
+    std::vector<ss::lw_shared_ptr<segment>> segments;
+    for (const auto& s : _segs) {
+        if (
+          s->has_appender() || !s->is_compacted_segment()
+          || !s->finished_self_compaction()) {
+            break;
+        }
+        segments.push_back(s);
+    }
+    // nothing was written to the window since it was compacted
+    if (
+      segments.size() < 2
+      || segments.back()->offsets().dirty_offset <= _sliding_window_end) {
+        return {};
+    }
+    return segments;
+}
+
+ss::future<> disk_log_impl::sliding_window_compact(compaction_config cfg) {
+    const auto max_mem = cfg.key_map_memory.value_or(
+      config::shard_local_cfg().compaction_key_map_memory());
+    if (max_mem == 0) {
+        co_return;
+    }
+    auto segments = find_sliding_window();
+    if (segments.empty()) {
+        co_return;
+    }
+    const auto window_end = segments.back()->offsets().dirty_offset;
+
+    /*
+     * the map is built from the newest segment backwards so the first offset
+     * seen for a key is its latest one in the window. when the map runs out of
+     * memory the keys of the older segments that are missing from the map are
+     * kept, they are compacted by a later pass once the newer records stop
+     * taking so much space.
+     */
+    internal::key_offset_map map(max_mem);
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        if (unlikely(cfg.asrc->abort_requested())) {
+            co_return;
+        }
+        if (!co_await internal::add_to_key_offset_map(*it, cfg, map)) {
+            break;
+        }
+    }
+    vlog(
+      stlog.debug,
+      "sliding window compaction of {} segments of {}, keys: {}, key map "
+      "memory: {}",
+      segments.size(),
+      config().ntp(),
+      map.size(),
+      map.mem_usage());
+
+    // the newest segment only has the latest records of its keys
+    segments.pop_back();
+    for (auto& seg : segments) {
+        if (unlikely(cfg.asrc->abort_requested())) {
+            co_return;
+        }
+        co_await _stm_manager->ensure_snapshot_exists(
+          seg->offsets().committed_offset);
+        auto r = co_await internal::window_compact_segment(
+          seg, cfg, _probe, *_readers_cache, map);
+        vlog(
+          stlog.debug,
+          "segment {} sliding window compaction result: {}",
+          seg->reader().filename(),
+          r);
+    }
+    _sliding_window_end = window_end;
+}
+
 std::optional<std::pair<segment_set::iterator, segment_set::iterator>>
 disk_log_impl::find_compaction_range() {
     /*
@@ -427,6 +614,7 @@ ss::future<compaction_result> disk_log_impl::compact_adjacent_segments(
     if (co_await ss::file_exists(compact_index.string())) {
         co_await ss::remove_file(compact_index.string());
     }
+    co_await segment_summary::remove(target->reader().filename().c_str());
 
     // lock the range. only metadata (e.g. open/rename/delete) i/o occurs with
     // these locks held so it is a relatively short duration. all of the data
@@ -511,12 +699,80 @@ ss::future<> disk_log_impl::compact(compaction_config cfg) {
         f = ss::now();
     }
     if (config().is_compacted() && !_segs.empty()) {
-        f = f.then([this, cfg] { return do_compact(cfg); });
+        f = f.then([this, cfg] { return do_compact(cfg); }).then([this] {
+            if (!is_compaction_pending()) {
+                _probe.compaction_caught_up();
+            }
+        });
+    }
+    if (recompression_codec()) {
+        f = f.then([this, cfg] { return recompress_cold_segments(cfg); });
     }
     return f.then(
       [this] { _probe.set_compaction_ration(_compaction_ratio.get()); });
 }
 
+std::optional<model::compression> disk_log_impl::recompression_codec() const {
+    if (
+      _manager.config().recompression_min_age
+        == std::chrono::milliseconds::zero()
+      || !config().has_overrides()
+      || !config().get_overrides().compression) {
+        return std::nullopt;
+    }
+    switch (*config().get_overrides().compression) {
+    case model::compression::gzip:
+    case model::compression::snappy:
+    case model::compression::lz4:
+    case model::compression::zstd:
+        return config().get_overrides().compression;
+    case model::compression::none:
+    case model::compression::producer:
+        // the batches are kept as the producers compressed them
+        return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+ss::future<> disk_log_impl::recompress_cold_segments(compaction_config cfg) {
+    const auto codec = *recompression_codec();
+    const auto max_timestamp = model::timestamp(
+      model::timestamp::now().value()
+      - _manager.config().recompression_min_age.count());
+    // the compacted segments are recompressed once self compacted, so that
+    // they are rewritten once
+    std::vector<ss::lw_shared_ptr<segment>> cold;
+    for (auto& s : _segs) {
+        if (
+          !s->has_appender() && !s->finished_recompression()
+          && s->index().max_timestamp() <= max_timestamp
+          && (!s->is_compacted_segment() || s->finished_self_compaction())) {
+            cold.push_back(s);
+        }
+    }
+    // one segment is rewritten per round, as for the self compaction
+    for (auto& seg : cold) {
+        if (cfg.asrc->abort_requested()) {
+            co_return;
+        }
+        if (seg->is_closed()) {
+            continue;
+        }
+        auto result = co_await storage::internal::recompress_segment(
+          seg, cfg, _probe, *_readers_cache, codec);
+        seg->mark_as_finished_recompression();
+        if (result.did_compact()) {
+            vlog(
+              stlog.debug,
+              "segment {} recompressed with {}, result: {}",
+              seg->reader().filename(),
+              codec,
+              result);
+            co_return;
+        }
+    }
+}
+
 ss::future<> disk_log_impl::gc(compaction_config cfg) {
     vassert(!_closed, "gc on closed log - {}", *this);
 
@@ -619,19 +875,91 @@ ss::future<> disk_log_impl::new_segment(
   model::offset o, model::term_id t, ss::io_priority_class pc) {
     vassert(
       o() >= 0 && t() >= 0, "offset:{} and term:{} must be initialized", o, t);
-    return _manager.make_log_segment(config(), o, t, pc)
-      .then([this](ss::lw_shared_ptr<segment> handles) mutable {
-          return remove_empty_segments().then(
-            [this, h = std::move(handles)]() mutable {
-                vassert(!_closed, "cannot add log segment to closed log");
-                if (config().is_compacted()) {
-                    h->mark_as_compacted_segment();
-                }
-                _segs.add(std::move(h));
-                _probe.segment_created();
-                return _stm_manager->make_snapshot();
-            });
-      });
+    const auto start = std::chrono::steady_clock::now();
+    const bool rolled = !_segs.empty();
+    const bool staged = _staged_segment.has_value();
+    auto f = ss::make_ready_future<ss::lw_shared_ptr<segment>>();
+    if (staged) {
+        auto files = std::move(*_staged_segment);
+        _staged_segment.reset();
+        f = _manager.make_log_segment(config(), o, t, pc, std::move(files))
+              .handle_exception([this, o, t, pc](std::exception_ptr e) {
+                  vlog(
+                    stlog.warn,
+                    "{} - could not use the staged segment files: {}",
+                    config().ntp(),
+                    e);
+                  return _manager.make_log_segment(config(), o, t, pc);
+              });
+    } else {
+        f = _manager.make_log_segment(config(), o, t, pc);
+    }
+    return f.then([this, start, rolled, staged](
+                    ss::lw_shared_ptr<segment> handles) mutable {
+        return remove_empty_segments().then(
+          [this, start, rolled, staged, h = std::move(handles)]() mutable {
+              vassert(!_closed, "cannot add log segment to closed log");
+              if (config().is_compacted()) {
+                  h->mark_as_compacted_segment();
+              }
+              _segs.add(std::move(h));
+              _probe.segment_created();
+              if (rolled) {
+                  _manager.roll_probe().roll(
+                    std::chrono::steady_clock::now() - start, staged);
+                  // the sealed segment may be collected or compacted
+                  if (config().is_compacted()) {
+                      _probe.compaction_pending();
+                  }
+                  _manager.request_housekeeping(config().ntp());
+              }
+              return _stm_manager->make_snapshot();
+          });
+    });
+}
+
+void disk_log_impl::maybe_stage_next_segment(ss::io_priority_class iopc) {
+    const auto threshold
+      = config::shard_local_cfg().segment_staging_threshold();
+    if (
+      _closed || threshold <= 0 || _staged_segment || _segs.empty()
+      || !_segs.back()->has_appender()
+      || _staged_for == _segs.back()->offsets().base_offset) {
+        return;
+    }
+    const auto written = _segs.back()->appender().file_byte_offset();
+    if (static_cast<double>(written) < threshold * _max_segment_size) {
+        return;
+    }
+    // a single attempt per active segment, the roll creates the files if it
+    // failed
+    _staged_for = _segs.back()->offsets().base_offset;
+    (void)ss::with_gate(_staging_gate, [this, iopc] {
+        return _manager.stage_log_segment(config(), iopc)
+          .then_wrapped([this](ss::future<staged_segment> f) {
+              if (f.failed()) {
+                  _manager.roll_probe().staging_failed();
+                  vlog(
+                    stlog.warn,
+                    "{} - could not stage the next segment: {}",
+                    config().ntp(),
+                    f.get_exception());
+                  return;
+              }
+              _staged_segment.emplace(f.get0());
+          });
+    });
+}
+
+ss::future<> disk_log_impl::discard_staged_segment() {
+    return _staging_gate.close().then([this] {
+        if (!_staged_segment) {
+            return ss::now();
+        }
+        auto files = std::move(*_staged_segment);
+        _staged_segment.reset();
+        return std::move(files).discard();
+    });
 }
 
 // config timeout is for the one calling reader consumer
@@ -816,6 +1144,39 @@ std::optional<model::term_id> disk_log_impl::get_term(model::offset o) const {
 
     return std::nullopt;
 }
+
+std::optional<term_end_result>
+disk_log_impl::term_end(model::term_id term) const {
+    if (_segs.empty()) {
+        return std::nullopt;
+    }
+    // a segment holds the batches of a single term, the terms of the segments
+    // don't decrease so the first segment of a later term is binary searched
+    auto it = std::upper_bound(
+      _segs.begin(),
+      _segs.end(),
+      term,
+      [](model::term_id t, const segment_set::type& s) {
+          return t < s->offsets().term;
+      });
+    if (it == _segs.end()) {
+        return term_end_result{
+          .term = _segs.back()->offsets().term,
+          .end_offset = offsets().dirty_offset + model::offset(1),
+        };
+    }
+    if (it == _segs.begin()) {
+        return term_end_result{
+          .term = term,
+          .end_offset = std::max(_start_offset, (*it)->offsets().base_offset),
+        };
+    }
+    return term_end_result{
+      .term = (*std::prev(it))->offsets().term,
+      .end_offset = (*it)->offsets().base_offset,
+    };
+}
+
 ss::future<std::optional<timequery_result>>
 disk_log_impl::timequery(timequery_config cfg) {
     vassert(!_closed, "timequery on closed log - {}", *this);
@@ -842,6 +1203,44 @@ disk_log_impl::timequery(timequery_config cfg) {
       });
 }
 
+ss::future<std::optional<key_query_result>>
+disk_log_impl::key_query(key_query_config cfg) {
+    vassert(!_closed, "key_query on closed log - {}", *this);
+    // the newest segments first, the copies keep them alive
+    std::vector<ss::lw_shared_ptr<segment>> segs(_segs.begin(), _segs.end());
+    for (auto it = segs.rbegin(); it != segs.rend(); ++it) {
+        auto& seg = *it;
+        if (seg->offsets().base_offset > cfg.max_offset) {
+            continue;
+        }
+        // the active segment is still indexed, its filter isn't written
+        if (!seg->has_appender()) {
+            std::optional<key_filter> filter;
+            try {
+                filter = co_await read_key_filter(
+                  internal::compacted_index_path(
+                    seg->reader().filename().c_str()),
+                  cfg.prio);
+            } catch (...) {
+                vlog(
+                  stlog.debug,
+                  "Reading segment {} for the key query, its key filter can't "
+                  "be read: {}",
+                  seg->reader().filename(),
+                  std::current_exception());
+            }
+            if (filter && !filter->maybe_contains_key(cfg.key)) {
+                continue;
+            }
+        }
+        auto ret = co_await internal::key_query_segment(seg, cfg, _probe);
+        if (ret) {
+            co_return ret;
+        }
+    }
+    co_return std::nullopt;
+}
+
 ss::future<> disk_log_impl::remove_segment_permanently(
   ss::lw_shared_ptr<segment> s, std::string_view ctx) {
     vlog(stlog.info, "{} - tombstone & delete segment: {}", ctx, s);
@@ -866,6 +1265,31 @@ ss::future<> disk_log_impl::remove_segment_permanently(
       .finally([this, s] { _probe.segment_removed(); });
 }
 
+ss::future<> disk_log_impl::remove_segment_in_background(
+  ss::lw_shared_ptr<segment> s, std::string_view ctx) {
+    vlog(stlog.info, "{} - close & queue removal of segment: {}", ctx, s);
+    // stats accounting must happen synchronously
+    _probe.delete_segment(*s);
+    if (s->has_outstanding_locks()) {
+        vlog(
+          stlog.info,
+          "Segment has outstanding locks. Might take a while to close:{}",
+          s->reader().filename());
+    }
+
+    // the start offset was persisted before the segment was dropped, so the
+    // files only have to be closed before the log moves on
+    return _readers_cache->evict_segment_readers(s)
+      .then([s](readers_cache::range_lock_holder cache_lock) {
+          return s->close().finally([cache_lock = std::move(cache_lock)] {});
+      })
+      .then([this, s] { _manager.deleter().remove(s); })
+      .handle_exception([s](std::exception_ptr e) {
+          vlog(stlog.error, "Cannot close segment: {} - {}", e, s);
+      })
+      .finally([this, s] { _probe.segment_removed(); });
+}
+
 ss::future<> disk_log_impl::remove_full_segments(model::offset o) {
     return ss::do_until(
       [this, o] {
@@ -889,7 +1313,8 @@ disk_log_impl::remove_prefix_full_segments(truncate_prefix_config cfg) {
       [this] {
           auto ptr = _segs.front();
           _segs.pop_front();
-          return remove_segment_permanently(ptr, "remove_prefix_full_segments");
+          return remove_segment_in_background(
+            ptr, "remove_prefix_full_segments");
       });
 }
 
@@ -1001,6 +1426,10 @@ ss::future<> disk_log_impl::do_truncate(truncate_config cfg) {
     if (cfg.base_offset > last.offsets().dirty_offset) {
         return ss::make_ready_future<>();
     }
+    if (!last.index().is_materialized()) {
+        return last.index().ensure_materialized().then(
+          [this, cfg] { return do_truncate(cfg); });
+    }
     auto pidx = last.index().find_nearest(cfg.base_offset);
     model::offset start = last.index().base_offset();
     size_t initial_size = 0;
@@ -1077,14 +1506,30 @@ model::offset disk_log_impl::read_start_offset() const {
     return model::offset{};
 }
 
+void disk_log_impl::update_max_segment_size() {
+    // the segment size of the topic is not a default
+    if (config().has_overrides() && config().get_overrides().segment_size) {
+        return;
+    }
+    _max_segment_size = internal::jitter_segment_size(
+      std::min(max_segment_size(), segment_size_hard_limit));
+}
+
 ss::future<>
 disk_log_impl::update_configuration(ntp_config::default_overrides o) {
     auto was_compacted = config().is_compacted();
+    auto was_recompression_codec = recompression_codec();
     mutable_config().set_overrides(o);
     /**
-     * For most of the settings we always query ntp config, only cleanup_policy
-     * and segment size need special treatment.
+     * For most of the settings we always query ntp config, only cleanup_policy,
+     * segment size and compression need special treatment.
      */
+    if (was_recompression_codec != recompression_codec()) {
+        // the segments are checked again for the new codec
+        for (auto& s : _segs) {
+            s->unmark_as_finished_recompression();
+        }
+    }
     if (config().has_overrides()) {
         if (config().get_overrides().segment_size) {
             _max_segment_size = *config().get_overrides().segment_size;
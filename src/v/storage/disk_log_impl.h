@@ -21,6 +21,7 @@
 #include "storage/readers_cache.h"
 #include "storage/segment_appender.h"
 #include "storage/segment_reader.h"
+#include "storage/staged_segment.h"
 #include "storage/types.h"
 #include "utils/moving_average.h"
 
@@ -76,9 +77,12 @@ public:
     /// timequery
     ss::future<std::optional<timequery_result>>
     timequery(timequery_config cfg) final;
+    ss::future<std::optional<key_query_result>>
+    key_query(key_query_config cfg) final;
     size_t segment_count() const final { return _segs.size(); }
     offset_stats offsets() const final;
     std::optional<model::term_id> get_term(model::offset) const final;
+    std::optional<term_end_result> term_end(model::term_id) const final;
     std::ostream& print(std::ostream&) const final;
 
     ss::future<> maybe_roll(
@@ -88,6 +92,11 @@ public:
     // maybe_call interface which enforces sizing policies.
     ss::future<> force_roll(ss::io_priority_class);
 
+    /// \brief creates the files of the next segment in the background once
+    /// the active segment is past the staging threshold, the next roll
+    /// renames them instead of creating them
+    void maybe_stage_next_segment(ss::io_priority_class);
+
     probe& get_probe() { return _probe; }
     model::term_id term() const;
     segment_set& segments() { return _segs; }
@@ -96,6 +105,9 @@ public:
 
     size_t size_bytes() const override { return _probe.partition_size(); }
     ss::future<> update_configuration(ntp_config::default_overrides) final;
+    /// \brief the segment sizes of the log manager changed, the next
+    /// segments of the log are rolled at the new size
+    void update_max_segment_size();
 
     int64_t compaction_backlog() const final;
 
@@ -113,6 +125,13 @@ private:
     model::offset read_start_offset() const;
 
     ss::future<> do_compact(compaction_config);
+    /// \brief closed segments of a compacted log wait for self compaction
+    bool is_compaction_pending() const;
+    ss::future<> sliding_window_compact(compaction_config);
+    /// \brief the codec the cold segments are recompressed with, if any
+    std::optional<model::compression> recompression_codec() const;
+    ss::future<> recompress_cold_segments(compaction_config);
+    std::vector<ss::lw_shared_ptr<segment>> find_sliding_window() const;
     ss::future<compaction_result> compact_adjacent_segments(
       std::pair<segment_set::iterator, segment_set::iterator>,
       storage::compaction_config cfg);
@@ -122,6 +141,9 @@ private:
 
     ss::future<> remove_empty_segments();
 
+    ss::future<> remove_segment_in_background(
+      ss::lw_shared_ptr<segment> segment_to_remove,
+      std::string_view logging_context_msg);
     ss::future<> remove_segment_permanently(
       ss::lw_shared_ptr<segment> segment_to_tombsone,
       std::string_view logging_context_msg);
@@ -130,6 +152,7 @@ private:
       model::offset starting_offset,
       model::term_id term_for_this_segment,
       ss::io_priority_class prio);
+    ss::future<> discard_staged_segment();
 
     ss::future<> do_truncate(truncate_config);
     ss::future<> remove_full_segments(model::offset o);
@@ -141,6 +164,9 @@ private:
     garbage_collect_max_partition_size(size_t max_bytes, ss::abort_source*);
     ss::future<>
     garbage_collect_oldest_segments(model::timestamp, ss::abort_source*);
+    ss::future<model::offset> stm_snapshot_horizon(model::offset);
+    ss::future<> do_garbage_collect_segments(
+      model::offset, ss::abort_source*, std::string_view);
     ss::future<> garbage_collect_segments(
       model::offset, ss::abort_source*, std::string_view);
     model::offset size_based_gc_max_offset(size_t);
@@ -150,6 +176,10 @@ private:
 
     compaction_config apply_overrides(compaction_config) const;
 
+    ss::future<> write_clean_segment_marker();
+    /// \brief the log is no longer accounted in the shard disk usage
+    void release_disk_usage();
+
 private:
     size_t max_segment_size() const;
     struct eviction_monitor {
@@ -170,6 +200,12 @@ private:
     std::unique_ptr<readers_cache> _readers_cache;
     // average ratio of segment sizes after segment size before compaction
     moving_average<double, 5> _compaction_ratio{1.0};
+    // last offset of the last sliding window compaction
+    model::offset _sliding_window_end;
+    // the files of the next segment, staged once per active segment
+    std::optional<staged_segment> _staged_segment;
+    std::optional<model::offset> _staged_for;
+    ss::gate _staging_gate;
 };
 
 } // namespace storage
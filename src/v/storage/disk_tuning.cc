@@ -0,0 +1,82 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/disk_tuning.h"
+
+#include "units.h"
+
+#include <fmt/ostream.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace storage {
+
+namespace {
+constexpr size_t chunk_size = 16_KiB;
+constexpr size_t min_write_behind_chunks = 32;
+constexpr size_t max_write_behind_chunks = 256;
+constexpr size_t min_fallocation_step = 16_MiB;
+constexpr size_t max_fallocation_step = 128_MiB;
+/// the segments are extended about four times a second at full bandwidth
+constexpr uint64_t fallocations_per_second = 4;
+constexpr size_t min_read_ahead_limit = 1_MiB;
+constexpr size_t max_read_ahead_limit = 16_MiB;
+/// the reads in flight while the benchmark measured the iops
+constexpr uint64_t benchmark_read_concurrency = 16;
+} // namespace
+
+disk_tuning& disk_tuning::local() {
+    static thread_local disk_tuning tuning;
+    return tuning;
+}
+
+disk_tuning disk_tuning::for_profile(const syschecks::disk_profile& p) {
+    disk_tuning t;
+    // enough data behind the writer to cover a flush at full bandwidth
+    auto flush_bytes = p.write_bandwidth * p.fsync_latency_us / 1000000;
+    t.write_behind_chunks = std::clamp(
+      flush_bytes / chunk_size,
+      min_write_behind_chunks,
+      max_write_behind_chunks);
+
+    t.fallocation_step = std::clamp(
+      std::bit_floor(
+        std::max<uint64_t>(p.write_bandwidth / fallocations_per_second, 1)),
+      min_fallocation_step,
+      max_fallocation_step);
+
+    // bandwidth delay product of the reads, with headroom for the bursts
+    uint64_t read_latency_us = 0;
+    if (p.read_iops > 0) {
+        read_latency_us = benchmark_read_concurrency * 1000000 / p.read_iops;
+    }
+    t.max_read_ahead_bytes = std::clamp<size_t>(
+      4 * p.write_bandwidth * read_latency_us / 1000000,
+      min_read_ahead_limit,
+      max_read_ahead_limit);
+
+    t.flush_latency_target = std::chrono::milliseconds(
+      4 * p.fsync_latency_us / 1000);
+    return t;
+}
+
+std::ostream& operator<<(std::ostream& o, const disk_tuning& t) {
+    fmt::print(
+      o,
+      "{{write_behind_chunks: {}, fallocation_step: {}, "
+      "max_read_ahead_bytes: {}, flush_latency_target: {}ms}}",
+      t.write_behind_chunks,
+      t.fallocation_step,
+      t.max_read_ahead_bytes,
+      t.flush_latency_target.count());
+    return o;
+}
+
+} // namespace storage
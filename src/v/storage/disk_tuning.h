@@ -0,0 +1,47 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "storage/read_ahead.h"
+#include "storage/segment_appender.h"
+#include "syschecks/disk_benchmark.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+
+namespace storage {
+
+/**
+ * Shard local I/O parameters of the log. The defaults are the static values
+ * the log was tuned with; when the disk benchmark is enabled they are
+ * derived from the measured profile of the slowest data directory at
+ * startup, before any log is opened.
+ */
+struct disk_tuning {
+    /// number of 16KiB chunks a segment appender writes behind
+    size_t write_behind_chunks{segment_appender::chunks_no_buffer};
+    /// size by which the segments are fallocated
+    size_t fallocation_step{segment_appender::fallocation_step};
+    /// upper bound of the read ahead of the sequential readers
+    size_t max_read_ahead_bytes{read_ahead::max_read_ahead_bytes};
+    /// lowest target latency of the background controllers
+    std::chrono::milliseconds flush_latency_target{0};
+
+    static disk_tuning& local();
+
+    static disk_tuning for_profile(const syschecks::disk_profile&);
+
+    friend std::ostream& operator<<(std::ostream&, const disk_tuning&);
+};
+
+} // namespace storage
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/metadata.h"
+#include "seastarx.h"
+
+#include <seastar/core/sstring.hh>
+
+#include <absl/container/node_hash_map.h>
+
+namespace storage {
+
+/**
+ * Shard wide size of the logs on disk, per data directory and per topic.
+ *
+ * Every disk log applies the changes of its size to the usage of its
+ * directory and of its topic as they happen: on append, segment roll and
+ * removal, truncation and compaction. Reading the usage costs the number of
+ * directories or topics, instead of a walk over all the logs.
+ *
+ * The entries are in node maps, a log keeps pointers to its entries until it
+ * is closed or removed.
+ */
+class disk_usage {
+public:
+    struct usage {
+        size_t size_bytes{0};
+        size_t partitions{0};
+    };
+
+    /// \brief the entries a log is accounted in
+    class log_usage {
+    public:
+        log_usage() noexcept = default;
+
+        bool attached() const { return _directory != nullptr; }
+
+        void add(size_t bytes) {
+            if (attached()) {
+                _directory->size_bytes += bytes;
+                _topic->size_bytes += bytes;
+            }
+        }
+
+        void remove(size_t bytes) {
+            if (attached()) {
+                _directory->size_bytes -= bytes;
+                _topic->size_bytes -= bytes;
+            }
+        }
+
+    private:
+        friend disk_usage;
+
+        log_usage(usage* directory, usage* topic) noexcept
+          : _directory(directory)
+          , _topic(topic) {}
+
+        usage* _directory{nullptr};
+        usage* _topic{nullptr};
+    };
+
+    using directories_t = absl::node_hash_map<ss::sstring, usage>;
+    using topics_t = absl::node_hash_map<
+      model::topic_namespace,
+      usage,
+      model::topic_namespace_hash,
+      model::topic_namespace_eq>;
+
+    /// \brief accounts an empty log of the topic in the directory
+    log_usage
+    add_log(const ss::sstring& directory, model::topic_namespace_view tp_ns) {
+        auto& dir = _directories[directory];
+        auto it = _topics.find(tp_ns);
+        if (it == _topics.end()) {
+            it = _topics.emplace(model::topic_namespace(tp_ns), usage{}).first;
+        }
+        ++dir.partitions;
+        ++it->second.partitions;
+        return log_usage(&dir, &it->second);
+    }
+
+    /// \brief removes the log and the bytes it still accounts, the topics
+    /// are dropped with their last log
+    void remove_log(
+      log_usage& u, model::topic_namespace_view tp_ns, size_t size_bytes) {
+        if (!u.attached()) {
+            return;
+        }
+        u.remove(size_bytes);
+        --u._directory->partitions;
+        if (--u._topic->partitions == 0) {
+            _topics.erase(tp_ns);
+        }
+        u = log_usage();
+    }
+
+    const directories_t& directories() const { return _directories; }
+    const topics_t& topics() const { return _topics; }
+
+    /// \brief the usage of the directory, empty if it has no logs
+    usage directory(const ss::sstring& directory) const {
+        auto it = _directories.find(directory);
+        return it == _directories.end() ? usage{} : it->second;
+    }
+
+private:
+    directories_t _directories;
+    topics_t _topics;
+};
+
+} // namespace storage
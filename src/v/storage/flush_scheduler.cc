@@ -0,0 +1,138 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/flush_scheduler.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/future-util.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/seastar.hh>
+
+namespace storage {
+
+ss::future<> flush_scheduler::flush(ss::file& f) {
+    if (_gate.is_closed()) {
+        return f.flush();
+    }
+    ++_requests;
+    auto& p = _pending[&f];
+    p.file = &f;
+    auto fut = p.waiters.emplace_back().get_future();
+    if (!_in_progress) {
+        dispatch();
+    }
+    return fut;
+}
+
+ss::future<> flush_scheduler::sync_directory(ss::sstring path) {
+    if (_gate.is_closed()) {
+        return ss::sync_directory(path);
+    }
+    auto fut = _pending_dirs[std::move(path)].emplace_back().get_future();
+    if (!_in_progress) {
+        dispatch();
+    }
+    return fut;
+}
+
+void flush_scheduler::dispatch() {
+    _in_progress = true;
+    ++_batches;
+    _flushes += _pending.size();
+    _directory_syncs += _pending_dirs.size();
+    batch b{
+      .flushes = std::exchange(_pending, {}),
+      .directories = std::exchange(_pending_dirs, {}),
+    };
+    auto start = ss::steady_clock_type::now();
+    (void)ss::with_gate(_gate, [this, start, b = std::move(b)]() mutable {
+        return ss::do_with(std::move(b), [](batch& b) { return do_flush(b); })
+          .finally([this, start] {
+              _batches_latency
+                += std::chrono::duration_cast<std::chrono::microseconds>(
+                  ss::steady_clock_type::now() - start);
+              _in_progress = false;
+              // requests collected while the batch was in progress
+              if (has_pending() && !_gate.is_closed()) {
+                  dispatch();
+              }
+          });
+    });
+}
+
+void flush_scheduler::complete(waiters_t& waiters, ss::future<> f) {
+    if (f.failed()) {
+        auto e = f.get_exception();
+        for (auto& w : waiters) {
+            w.set_exception(e);
+        }
+        return;
+    }
+    for (auto& w : waiters) {
+        w.set_value();
+    }
+}
+
+ss::future<> flush_scheduler::do_flush(batch& b) {
+    auto flushes = ss::parallel_for_each(
+      b.flushes, [](pending_t::value_type& e) {
+          return e.second.file->flush().then_wrapped(
+            [&e](ss::future<> f) { complete(e.second.waiters, std::move(f)); });
+      });
+    auto directories = ss::parallel_for_each(
+      b.directories, [](pending_dirs_t::value_type& e) {
+          return ss::sync_directory(e.first).then_wrapped(
+            [&e](ss::future<> f) { complete(e.second, std::move(f)); });
+      });
+    return ss::when_all_succeed(std::move(flushes), std::move(directories))
+      .discard_result();
+}
+
+ss::future<> flush_scheduler::stop() {
+    auto f = _gate.close();
+    // requests collected while the last batch was in progress
+    batch b{
+      .flushes = std::exchange(_pending, {}),
+      .directories = std::exchange(_pending_dirs, {}),
+    };
+    co_await std::move(f);
+    co_await do_flush(b);
+}
+
+void flush_scheduler::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:flush_scheduler"),
+      {
+        sm::make_derive(
+          "requests",
+          [this] { return _requests; },
+          sm::description("Number of requested segment flushes")),
+        sm::make_derive(
+          "flushes",
+          [this] { return _flushes; },
+          sm::description("Number of dispatched segment flushes")),
+        sm::make_derive(
+          "batches",
+          [this] { return _batches; },
+          sm::description("Number of dispatched batches of flushes")),
+        sm::make_derive(
+          "directory_syncs",
+          [this] { return _directory_syncs; },
+          sm::description("Number of dispatched directory syncs")),
+      });
+}
+
+} // namespace storage
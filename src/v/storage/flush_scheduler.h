@@ -0,0 +1,109 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sstring.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <chrono>
+#include <vector>
+
+namespace storage {
+
+/**
+ * Shard wide group commit of the segment flushes.
+ *
+ * When no flushes are in progress a flush is dispatched immediately. Flushes
+ * requested while a batch is in progress are collected and dispatched
+ * together as soon as the batch completes, so the collection window adapts
+ * to the latency of the device. All the requests for the same file that are
+ * collected in one window are served by a single fdatasync. Every request
+ * is completed by a flush dispatched after the request was made.
+ *
+ * The syncs of the directories done when the logs are created are batched
+ * the same way: creating many logs at once syncs their common parent
+ * directories once per batch.
+ */
+class flush_scheduler {
+public:
+    flush_scheduler() = default;
+    flush_scheduler(const flush_scheduler&) = delete;
+    flush_scheduler& operator=(const flush_scheduler&) = delete;
+    flush_scheduler(flush_scheduler&&) = delete;
+    flush_scheduler& operator=(flush_scheduler&&) = delete;
+    ~flush_scheduler() noexcept = default;
+
+    /// Flush the file. The file must stay open until the future resolves.
+    ss::future<> flush(ss::file& f);
+
+    /// Sync the directory, makes the entries created before the call
+    /// durable. Requests for the same directory are coalesced like flushes.
+    ss::future<> sync_directory(ss::sstring path);
+
+    /// Wait for the dispatched flushes. Flushes requested after the call
+    /// are dispatched directly.
+    ss::future<> stop();
+
+    /// Register the metrics, should be called for one scheduler per shard
+    void setup_metrics();
+
+    uint64_t requests() const { return _requests; }
+    uint64_t flushes() const { return _flushes; }
+    uint64_t batches() const { return _batches; }
+    uint64_t directory_syncs() const { return _directory_syncs; }
+    /// Sum of the time it took to complete the batches, the latency of the
+    /// flushes as seen by the writers
+    std::chrono::microseconds batches_latency() const {
+        return _batches_latency;
+    }
+
+private:
+    struct pending_flush {
+        ss::file* file;
+        std::vector<ss::promise<>> waiters;
+    };
+    using pending_t = absl::flat_hash_map<ss::file*, pending_flush>;
+    using waiters_t = std::vector<ss::promise<>>;
+    using pending_dirs_t = absl::flat_hash_map<ss::sstring, waiters_t>;
+
+    struct batch {
+        pending_t flushes;
+        pending_dirs_t directories;
+    };
+
+    bool has_pending() const {
+        return !_pending.empty() || !_pending_dirs.empty();
+    }
+    void dispatch();
+    static ss::future<> do_flush(batch&);
+    static void complete(waiters_t&, ss::future<>);
+
+    pending_t _pending;
+    pending_dirs_t _pending_dirs;
+    bool _in_progress{false};
+    ss::gate _gate;
+
+    uint64_t _requests{0};
+    uint64_t _flushes{0};
+    uint64_t _batches{0};
+    uint64_t _directory_syncs{0};
+    std::chrono::microseconds _batches_latency{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
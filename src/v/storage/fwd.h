@@ -21,5 +21,9 @@ class segment;
 class snapshot_manager;
 class readers_cache;
 class compaction_controller;
+class flush_scheduler;
+class background_controller;
+struct clean_segment_marker;
+struct segment_summary;
 
 } // namespace storage
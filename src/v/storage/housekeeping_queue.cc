@@ -0,0 +1,84 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/housekeeping_queue.h"
+
+#include <algorithm>
+
+namespace storage {
+
+void housekeeping_queue::schedule(
+  const model::ntp& ntp, clock_type::time_point due, double urgency) {
+    auto [it, inserted] = _entries.try_emplace(
+      ntp, entry{.due = due, .urgency = urgency});
+    const auto* key = &it->first;
+    auto& e = it->second;
+    if (!inserted) {
+        unlink(key, e);
+        e.due = std::min(e.due, due);
+        e.urgency = std::max(e.urgency, urgency);
+    }
+    if (e.ready) {
+        _ready.emplace(e.urgency, key);
+    } else {
+        _pending.emplace(e.due, key);
+    }
+}
+
+void housekeeping_queue::remove(const model::ntp& ntp) {
+    auto it = _entries.find(ntp);
+    if (it == _entries.end()) {
+        return;
+    }
+    unlink(&it->first, it->second);
+    _entries.erase(it);
+}
+
+std::optional<model::ntp>
+housekeeping_queue::pop(clock_type::time_point now) {
+    promote(now);
+    if (_ready.empty()) {
+        return std::nullopt;
+    }
+    auto ntp = *_ready.begin()->second;
+    _ready.erase(_ready.begin());
+    _entries.erase(ntp);
+    return ntp;
+}
+
+std::optional<housekeeping_queue::clock_type::time_point>
+housekeeping_queue::next_due() const {
+    if (!_ready.empty()) {
+        return clock_type::time_point::min();
+    }
+    if (_pending.empty()) {
+        return std::nullopt;
+    }
+    return _pending.begin()->first;
+}
+
+void housekeeping_queue::unlink(const model::ntp* key, const entry& e) {
+    if (e.ready) {
+        _ready.erase(by_urgency(e.urgency, key));
+    } else {
+        _pending.erase(by_due(e.due, key));
+    }
+}
+
+void housekeeping_queue::promote(clock_type::time_point now) {
+    while (!_pending.empty() && _pending.begin()->first <= now) {
+        const auto* key = _pending.begin()->second;
+        _pending.erase(_pending.begin());
+        auto& e = _entries.find(*key)->second;
+        e.ready = true;
+        _ready.emplace(e.urgency, key);
+    }
+}
+
+} // namespace storage
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/fundamental.h"
+#include "seastarx.h"
+
+#include <seastar/core/lowres_clock.hh>
+
+#include <absl/container/btree_set.h>
+#include <absl/container/node_hash_map.h>
+
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace storage {
+
+/**
+ * The logs of a shard ordered by the urgency of their housekeeping.
+ *
+ * Each log is due at a point in time, the logs that are due are handed out
+ * by decreasing urgency (e.g. the ratio of their size over their retention
+ * or their dirty ratio) so that the most pressing garbage collection and
+ * compaction happens first when a housekeeping round can't process all the
+ * due logs. A log is queued once, scheduling a queued log keeps its earliest
+ * due time and its highest urgency.
+ */
+class housekeeping_queue {
+public:
+    using clock_type = ss::lowres_clock;
+
+    void schedule(
+      const model::ntp& ntp, clock_type::time_point due, double urgency);
+
+    void remove(const model::ntp& ntp);
+
+    /// \brief dequeues the most urgent of the logs due at the time point
+    std::optional<model::ntp> pop(clock_type::time_point now);
+
+    /// \brief the earliest due time, time_point::min() if logs are already
+    /// due and nullopt when the queue is empty
+    std::optional<clock_type::time_point> next_due() const;
+
+    bool contains(const model::ntp& ntp) const {
+        return _entries.contains(ntp);
+    }
+    size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+private:
+    struct entry {
+        clock_type::time_point due;
+        double urgency{0};
+        bool ready{false};
+    };
+    using by_due = std::pair<clock_type::time_point, const model::ntp*>;
+    using by_urgency = std::pair<double, const model::ntp*>;
+
+    void unlink(const model::ntp*, const entry&);
+    void promote(clock_type::time_point now);
+
+    // node based, the sets point to its keys
+    absl::node_hash_map<model::ntp, entry> _entries;
+    absl::btree_set<by_due> _pending;
+    // the logs already due, the most urgent first
+    absl::btree_set<by_urgency, std::greater<>> _ready;
+};
+
+} // namespace storage
@@ -0,0 +1,91 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/index_cache.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "storage/logger.h"
+#include "vlog.h"
+
+#include <seastar/core/metrics.hh>
+
+namespace storage {
+
+index_cache::~index_cache() noexcept {
+    // indexes may outlive the cache, make sure they don't reference it
+    while (!_lru.empty()) {
+        auto& idx = _lru.front();
+        remove(idx);
+        idx._cache = nullptr;
+    }
+}
+
+void index_cache::touch(segment_index& idx) {
+    remove(idx);
+    if (!idx.can_unload()) {
+        return;
+    }
+    idx._tracked_bytes = idx.memory_usage();
+    _size_bytes += idx._tracked_bytes;
+    _lru.push_back(idx);
+    evict();
+}
+
+void index_cache::remove(segment_index& idx) {
+    if (!idx._hook.is_linked()) {
+        return;
+    }
+    idx._hook.unlink();
+    _size_bytes -= idx._tracked_bytes;
+    idx._tracked_bytes = 0;
+}
+
+void index_cache::evict() {
+    // the most recently used index is kept even if it exceeds the budget on
+    // its own
+    while (_size_bytes > _max_bytes && !_lru.empty()
+           && &_lru.front() != &_lru.back()) {
+        auto& idx = _lru.front();
+        remove(idx);
+        // indexes might have been dirtied since they were tracked
+        if (!idx.can_unload()) {
+            continue;
+        }
+        vlog(stlog.trace, "Unloading segment index {}", idx.filename());
+        idx.unload();
+        ++_evictions;
+    }
+}
+
+void index_cache::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:index_cache"),
+      {
+        sm::make_gauge(
+          "size_bytes",
+          [this] { return _size_bytes; },
+          sm::description("Memory used by the loaded indexes of the segments "
+                          "that are not written to")),
+        sm::make_derive(
+          "evictions",
+          [this] { return _evictions; },
+          sm::description("Number of unloaded segment indexes")),
+        sm::make_derive(
+          "materializations",
+          [this] { return _materializations; },
+          sm::description("Number of segment indexes loaded back from disk")),
+      });
+}
+
+} // namespace storage
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+#include "storage/segment_index.h"
+#include "utils/intrusive_list_helpers.h"
+
+#include <seastar/core/metrics_registration.hh>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace storage {
+
+/**
+ * Shard wide memory budget of the segment offset indexes.
+ *
+ * Only indexes that are fully persisted and not pinned (the index of a
+ * segment with an appender is pinned) are tracked. When the memory used by
+ * the tracked indexes exceeds the limit the entries of the least recently
+ * used ones are released. An unloaded index keeps its base and max
+ * offsets/timestamps and is materialized from disk again on the next lookup,
+ * see segment_index::ensure_materialized().
+ */
+class index_cache {
+public:
+    explicit index_cache(size_t max_bytes)
+      : _max_bytes(max_bytes) {}
+    index_cache(const index_cache&) = delete;
+    index_cache& operator=(const index_cache&) = delete;
+    index_cache(index_cache&&) = delete;
+    index_cache& operator=(index_cache&&) = delete;
+    ~index_cache() noexcept;
+
+    /// Track the index as the most recently used one, untracks it if the
+    /// index can't be unloaded. May unload other indexes.
+    void touch(segment_index&);
+
+    /// Stop tracking the index
+    void remove(segment_index&);
+
+    size_t size_bytes() const { return _size_bytes; }
+    size_t max_bytes() const { return _max_bytes; }
+    uint64_t evictions() const { return _evictions; }
+    uint64_t materializations() const { return _materializations; }
+
+    /// Register the metrics, should be called for one cache per shard
+    void setup_metrics();
+
+private:
+    friend class segment_index;
+
+    void evict();
+    void record_materialization() { ++_materializations; }
+
+    size_t _max_bytes;
+    size_t _size_bytes{0};
+    /// unloadable indexes ordered from least to most recently used
+    intrusive_list<segment_index, &segment_index::_hook> _lru;
+
+    uint64_t _evictions{0};
+    uint64_t _materializations{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
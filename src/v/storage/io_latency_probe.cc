@@ -0,0 +1,235 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/io_latency_probe.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "resource_mgmt/io_priority.h"
+
+#include <seastar/core/do_with.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/smp.hh>
+
+#include <boost/range/irange.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+namespace storage {
+
+namespace {
+struct priority_class_latency {
+    unsigned id;
+    const char* name;
+    io_latency_probe::histograms hists;
+};
+
+// the priority classes of resource_mgmt/io_priority.h, the last entry
+// collects the others
+std::vector<priority_class_latency> make_classes() {
+    std::vector<priority_class_latency> ret;
+    auto add = [&ret](ss::io_priority_class pc, const char* name) {
+        ret.push_back(priority_class_latency{.id = pc.id(), .name = name});
+    };
+    add(raft_priority(), "raft");
+    add(controller_priority(), "controller");
+    add(kafka_read_priority(), "kafka_read");
+    add(compaction_priority(), "compaction");
+    add(raft_learner_recovery_priority(), "raft_learner_recovery");
+    add(archival_priority(), "archival");
+    add(ss::default_priority_class(), "default");
+    ret.push_back(priority_class_latency{.id = 0, .name = "other"});
+    return ret;
+}
+
+std::vector<priority_class_latency>& shard_classes() {
+    static thread_local std::vector<priority_class_latency> classes
+      = make_classes();
+    return classes;
+}
+
+hdr_hist&
+histogram(const ss::io_priority_class& pc, io_latency_probe::op o) {
+    auto& classes = shard_classes();
+    auto it = std::find_if(
+      classes.begin(), std::prev(classes.end()), [&pc](const auto& c) {
+          return c.id == pc.id();
+      });
+    return it->hists[static_cast<size_t>(o)];
+}
+
+/// forwards to the file, measures the dma reads
+class read_latency_file final : public ss::file_impl {
+public:
+    explicit read_latency_file(ss::file f)
+      : _file(std::move(f)) {}
+
+    ss::future<size_t> write_dma(
+      uint64_t pos,
+      const void* buffer,
+      size_t len,
+      const ss::io_priority_class& pc) final {
+        return get_file_impl(_file)->write_dma(pos, buffer, len, pc);
+    }
+
+    ss::future<size_t> write_dma(
+      uint64_t pos,
+      std::vector<iovec> iov,
+      const ss::io_priority_class& pc) final {
+        return get_file_impl(_file)->write_dma(pos, std::move(iov), pc);
+    }
+
+    ss::future<size_t> read_dma(
+      uint64_t pos,
+      void* buffer,
+      size_t len,
+      const ss::io_priority_class& pc) final {
+        return measured(
+          pc, get_file_impl(_file)->read_dma(pos, buffer, len, pc));
+    }
+
+    ss::future<size_t> read_dma(
+      uint64_t pos,
+      std::vector<iovec> iov,
+      const ss::io_priority_class& pc) final {
+        return measured(
+          pc, get_file_impl(_file)->read_dma(pos, std::move(iov), pc));
+    }
+
+    ss::future<ss::temporary_buffer<uint8_t>> dma_read_bulk(
+      uint64_t offset,
+      size_t range_size,
+      const ss::io_priority_class& pc) final {
+        return measured(
+          pc, get_file_impl(_file)->dma_read_bulk(offset, range_size, pc));
+    }
+
+    ss::future<> flush() final { return get_file_impl(_file)->flush(); }
+
+    ss::future<struct stat> stat() final {
+        return get_file_impl(_file)->stat();
+    }
+
+    ss::future<> truncate(uint64_t length) final {
+        return get_file_impl(_file)->truncate(length);
+    }
+
+    ss::future<> discard(uint64_t offset, uint64_t length) final {
+        return get_file_impl(_file)->discard(offset, length);
+    }
+
+    ss::future<> allocate(uint64_t position, uint64_t length) final {
+        return get_file_impl(_file)->allocate(position, length);
+    }
+
+    ss::future<uint64_t> size() final { return get_file_impl(_file)->size(); }
+
+    ss::future<> close() final { return get_file_impl(_file)->close(); }
+
+    std::unique_ptr<ss::file_handle_impl> dup() final {
+        return get_file_impl(_file)->dup();
+    }
+
+    ss::subscription<ss::directory_entry> list_directory(
+      std::function<ss::future<>(ss::directory_entry de)> next) final {
+        return get_file_impl(_file)->list_directory(std::move(next));
+    }
+
+private:
+    template<typename T>
+    static ss::future<T>
+    measured(const ss::io_priority_class& pc, ss::future<T> f) {
+        return f.then([&hist = histogram(pc, io_latency_probe::op::read),
+                       start = io_latency_probe::clock_type::now()](T v) {
+            hist.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                          io_latency_probe::clock_type::now() - start)
+                          .count());
+            return v;
+        });
+    }
+
+    ss::file _file;
+};
+} // namespace
+
+const char* io_latency_probe::name(op o) {
+    switch (o) {
+    case op::write:
+        return "write";
+    case op::flush:
+        return "flush";
+    case op::read:
+        return "read";
+    }
+    return "unknown";
+}
+
+void io_latency_probe::record(
+  const ss::io_priority_class& pc, op o, clock_type::time_point start) {
+    histogram(pc, o).record(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        clock_type::now() - start)
+        .count());
+}
+
+ss::file io_latency_probe::measure_reads(ss::file f) {
+    return ss::file(ss::make_shared(read_latency_file(std::move(f))));
+}
+
+ss::future<std::vector<io_latency_probe::summary>> io_latency_probe::merge() {
+    std::vector<summary> ret;
+    for (const auto& c : shard_classes()) {
+        ret.push_back(summary{.priority_class = c.name});
+    }
+    return ss::do_with(std::move(ret), [](std::vector<summary>& ret) {
+        // one shard at a time: the shards add to the histograms of the
+        // caller, adding doesn't allocate
+        return ss::do_for_each(
+                 boost::irange<ss::shard_id>(0, ss::smp::count),
+                 [&ret](ss::shard_id shard) {
+                     return ss::smp::submit_to(shard, [&ret] {
+                         const auto& classes = shard_classes();
+                         for (size_t i = 0; i < classes.size(); ++i) {
+                             for (size_t o = 0; o < ops_count; ++o) {
+                                 ret[i].hists[o] += classes[i].hists[o];
+                             }
+                         }
+                     });
+                 })
+          .then([&ret] { return std::move(ret); });
+    });
+}
+
+void io_latency_probe::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    const auto class_label = sm::label("priority_class");
+    const auto op_label = sm::label("op");
+    std::vector<sm::metric_definition> defs;
+    for (auto& c : shard_classes()) {
+        for (size_t o = 0; o < ops_count; ++o) {
+            const auto& hist = c.hists[o];
+            defs.push_back(sm::make_histogram(
+              "latency_us",
+              [&hist] { return hist.seastar_histogram_logform(); },
+              sm::description("Latency of the disk operations of the log "
+                              "segments, in microseconds"),
+              {class_label(c.name), op_label(name(static_cast<op>(o)))}));
+        }
+    }
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:io"), std::move(defs));
+}
+
+} // namespace storage
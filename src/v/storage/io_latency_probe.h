@@ -0,0 +1,77 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sstring.hh>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace storage {
+
+/**
+ * Shard wide latency of the disk operations of the log segments, per io
+ * priority class, in microseconds.
+ *
+ * The appenders measure their dma writes and flushes, the files of the
+ * segment readers are wrapped to measure their dma reads: the priority
+ * class tells the reads of the consumers, of the raft recovery and of the
+ * compaction apart. The histograms are exported per shard and merge() sums
+ * them across the shards for the admin API.
+ */
+class io_latency_probe {
+public:
+    using clock_type = ss::steady_clock_type;
+
+    enum class op : uint8_t {
+        /// dma write of a chunk of an appender
+        write = 0,
+        /// fdatasync of a segment
+        flush,
+        /// dma read of a segment reader
+        read,
+    };
+    static constexpr size_t ops_count = 3;
+    using histograms = std::array<hdr_hist, ops_count>;
+
+    struct summary {
+        ss::sstring priority_class;
+        histograms hists;
+    };
+
+    static const char* name(op);
+
+    /// \brief records an operation of the priority class started at the
+    /// time point
+    static void
+    record(const ss::io_priority_class&, op, clock_type::time_point);
+
+    /// \brief wraps the file to measure its dma reads
+    static ss::file measure_reads(ss::file);
+
+    /// \brief sum of the histograms of all the shards, per priority class
+    static ss::future<std::vector<summary>> merge();
+
+    void setup_metrics();
+
+private:
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
@@ -0,0 +1,170 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/key_filter.h"
+
+#include "bytes/iobuf_parser.h"
+#include "bytes/utils.h"
+#include "hashing/crc32c.h"
+#include "hashing/xx.h"
+#include "reflection/adl.h"
+#include "storage/spill_key_index.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/file.hh>
+#include <seastar/core/seastar.hh>
+
+#include <algorithm>
+
+namespace storage {
+
+uint64_t key_filter::hash(bytes_view index_key) {
+    // NOLINTNEXTLINE
+    const auto data = reinterpret_cast<const char*>(index_key.data());
+    return xxhash_64(data, index_key.size());
+}
+
+bytes key_filter::index_key(
+  bytes_view record_key, compacted_index::key_digests_mode key_digests) {
+    if (key_digests) {
+        return compacted_index::key_digest(record_key);
+    }
+    return bytes(record_key.substr(
+      0, std::min(internal::spill_key_index::max_key_size, record_key.size())));
+}
+
+key_filter key_filter::build(const std::vector<uint64_t>& hashes) {
+    const size_t words = std::clamp<size_t>(
+      (hashes.size() * bits_per_key + 63) / 64, 1, max_words);
+    key_filter ret(
+      std::vector<uint64_t>(words, 0),
+      default_hashes,
+      compacted_index::key_digests_mode::no);
+    for (auto h : hashes) {
+        ret.add(h);
+    }
+    return ret;
+}
+
+// double hashing of the key hash, as in leveldb
+void key_filter::add(uint64_t h) {
+    const uint64_t bits = _words.size() * 64;
+    const uint64_t delta = (h >> 17U) | (h << 47U);
+    for (uint8_t i = 0; i < _hashes; ++i) {
+        const auto bit = h % bits;
+        _words[bit / 64] |= uint64_t(1) << (bit % 64);
+        h += delta;
+    }
+}
+
+bool key_filter::maybe_contains(uint64_t h) const {
+    const uint64_t bits = _words.size() * 64;
+    const uint64_t delta = (h >> 17U) | (h << 47U);
+    for (uint8_t i = 0; i < _hashes; ++i) {
+        const auto bit = h % bits;
+        if ((_words[bit / 64] & (uint64_t(1) << (bit % 64))) == 0) {
+            return false;
+        }
+        h += delta;
+    }
+    return true;
+}
+
+bool key_filter::maybe_contains_key(bytes_view record_key) const {
+    return maybe_contains(hash(index_key(record_key, _key_digests)));
+}
+
+iobuf key_filter::serialize() const {
+    iobuf fields;
+    reflection::serialize(
+      fields, _hashes, static_cast<uint32_t>(_words.size()));
+    for (auto w : _words) {
+        reflection::serialize(fields, w);
+    }
+    crc::crc32c crc;
+    crc_extend_iobuf(crc, fields);
+
+    iobuf out;
+    reflection::serialize(out, crc.value());
+    out.append(std::move(fields));
+    return out;
+}
+
+std::optional<key_filter> key_filter::deserialize(
+  iobuf b, compacted_index::key_digests_mode key_digests) {
+    constexpr size_t header_size = sizeof(uint32_t) + sizeof(uint8_t)
+                                   + sizeof(uint32_t);
+    if (b.size_bytes() < header_size) {
+        return std::nullopt;
+    }
+    iobuf_parser parser(std::move(b));
+    const auto expected_crc = reflection::adl<uint32_t>{}.from(parser);
+    auto fields = parser.share(parser.bytes_left());
+    crc::crc32c crc;
+    crc_extend_iobuf(crc, fields);
+    if (crc.value() != expected_crc) {
+        return std::nullopt;
+    }
+    iobuf_parser in(std::move(fields));
+    const auto hashes = reflection::adl<uint8_t>{}.from(in);
+    const auto count = reflection::adl<uint32_t>{}.from(in);
+    if (count == 0 || in.bytes_left() != count * sizeof(uint64_t)) {
+        return std::nullopt;
+    }
+    std::vector<uint64_t> words;
+    words.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        words.push_back(reflection::adl<uint64_t>{}.from(in));
+    }
+    return key_filter(std::move(words), hashes, key_digests);
+}
+
+ss::future<std::optional<key_filter>> read_key_filter(
+  std::filesystem::path compacted_index, ss::io_priority_class pc) {
+    using flags = compacted_index::footer_flags;
+    auto name = compacted_index.string();
+    if (!co_await ss::file_exists(name)) {
+        co_return std::nullopt;
+    }
+    auto f = co_await ss::open_file_dma(name, ss::open_flags::ro);
+    std::exception_ptr ex;
+    std::optional<key_filter> ret;
+    try {
+        const uint64_t size = co_await f.size();
+        if (size >= compacted_index::footer_size) {
+            const uint64_t filter_end = size - compacted_index::footer_size;
+            iobuf footer_buf;
+            footer_buf.append(co_await f.dma_read_bulk<char>(
+              filter_end, compacted_index::footer_size, pc));
+            iobuf_parser parser(std::move(footer_buf));
+            const auto footer
+              = reflection::adl<compacted_index::footer>{}.from(parser);
+            if (
+              bool(footer.flags & flags::key_filter)
+              && footer.size < filter_end) {
+                iobuf b;
+                b.append(co_await f.dma_read_bulk<char>(
+                  footer.size, filter_end - footer.size, pc));
+                ret = key_filter::deserialize(
+                  std::move(b),
+                  compacted_index::key_digests_mode(
+                    bool(footer.flags & flags::key_digests)));
+            }
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await f.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_return ret;
+}
+
+} // namespace storage
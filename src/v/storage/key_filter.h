@@ -0,0 +1,88 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/bytes.h"
+#include "bytes/iobuf.h"
+#include "seastarx.h"
+#include "storage/compacted_index.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/io_priority_class.hh>
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace storage {
+
+/**
+ * Bloom filter of the keys of a compaction index. It is written by the
+ * index between its entries and its footer, with the
+ * compacted_index::footer_flags::key_filter flag:
+ *
+ *   4 bytes - crc32c of the fields below
+ *   1 byte  - number of hashes
+ *   4 bytes - number of 64 bit words
+ *   8 bytes - each of the words
+ *
+ * The filter is of the keys as the index has them: key_digest()s when the
+ * index has key digests, and the keys cut at the max size of an entry
+ * otherwise.
+ */
+class key_filter {
+public:
+    static constexpr size_t bits_per_key = 10;
+    static constexpr uint8_t default_hashes = 7;
+    // the false positive rate of the indices with more keys is higher
+    static constexpr size_t max_words = 128 * 1024;
+
+    /// \brief hash of a key of the index
+    static uint64_t hash(bytes_view index_key);
+    /// \brief the key of a record, as an index in the mode has it
+    static bytes
+    index_key(bytes_view record_key, compacted_index::key_digests_mode);
+
+    /// \brief a filter sized for the hashes of the keys
+    static key_filter build(const std::vector<uint64_t>& hashes);
+
+    bool maybe_contains(uint64_t hash) const;
+    /// \brief whether the index of the filter may have the key of a record
+    bool maybe_contains_key(bytes_view record_key) const;
+
+    iobuf serialize() const;
+    /// \brief nullopt when the buffer is torn
+    static std::optional<key_filter>
+      deserialize(iobuf, compacted_index::key_digests_mode);
+
+private:
+    key_filter(
+      std::vector<uint64_t> words,
+      uint8_t hashes,
+      compacted_index::key_digests_mode key_digests) noexcept
+      : _words(std::move(words))
+      , _hashes(hashes)
+      , _key_digests(key_digests) {}
+
+    void add(uint64_t hash);
+
+    std::vector<uint64_t> _words;
+    uint8_t _hashes;
+    compacted_index::key_digests_mode _key_digests;
+};
+
+/// \brief the key filter of the compaction index, nullopt when the index
+/// doesn't exist or has no filter
+ss::future<std::optional<key_filter>>
+read_key_filter(std::filesystem::path compacted_index, ss::io_priority_class);
+
+} // namespace storage
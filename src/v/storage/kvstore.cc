@@ -19,8 +19,10 @@
 #include "storage/record_batch_builder.h"
 #include "storage/segment_set.h"
 #include "storage/types.h"
+#include "ssx/sformat.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/metrics.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/util/defer.hh>
@@ -30,6 +32,13 @@ static ss::logger lg("kvstore");
 
 namespace storage {
 
+/*
+ * Version of the main snapshot that only indexes the key space snapshots. The
+ * metadata of the original snapshot format that contains the whole database
+ * doesn't include a version.
+ */
+static constexpr int8_t key_space_index_version = 1;
+
 kvstore::kvstore(kvstore_config kv_conf)
   : _conf(std::move(kv_conf))
   , _ntpc(model::kvstore_ntp(ss::this_shard_id()), _conf.base_dir)
@@ -166,10 +175,39 @@ ss::future<> kvstore::remove(key_space ks, bytes key) {
     return put(ks, std::move(key), std::nullopt);
 }
 
+ss::future<>
+kvstore::put(key_space ks, std::vector<std::pair<bytes, iobuf>> kvs) {
+    vassert(_started, "kvstore has not been started");
+
+    std::vector<ss::future<>> fs;
+    fs.reserve(kvs.size());
+    for (auto& [key, value] : kvs) {
+        _probe.entry_written();
+        fs.push_back(enqueue(
+          make_spaced_key(ks, key),
+          std::make_optional<iobuf>(std::move(value))));
+    }
+    return ss::when_all_succeed(fs.begin(), fs.end()).discard_result();
+}
+
+ss::future<> kvstore::remove(key_space ks, std::vector<bytes> keys) {
+    vassert(_started, "kvstore has not been started");
+
+    std::vector<ss::future<>> fs;
+    fs.reserve(keys.size());
+    for (auto& key : keys) {
+        _probe.entry_removed();
+        fs.push_back(enqueue(make_spaced_key(ks, key), std::nullopt));
+    }
+    return ss::when_all_succeed(fs.begin(), fs.end()).discard_result();
+}
+
 ss::future<> kvstore::put(key_space ks, bytes key, std::optional<iobuf> value) {
     vassert(_started, "kvstore has not been started");
+    return enqueue(make_spaced_key(ks, key), std::move(value));
+}
 
-    key = make_spaced_key(ks, key);
+ss::future<> kvstore::enqueue(bytes key, std::optional<iobuf> value) {
     return ss::with_gate(
       _gate, [this, key = std::move(key), value = std::move(value)]() mutable {
           auto& w = _ops.emplace_back(std::move(key), std::move(value));
@@ -180,7 +218,19 @@ ss::future<> kvstore::put(key_space ks, bytes key, std::optional<iobuf> value) {
       });
 }
 
+/*
+ * Return the key-space of a key prefixed by make_spaced_key
+ */
+static inline kvstore::key_space key_space_of(bytes_view spaced_key) {
+    using underlying_t = std::underlying_type<kvstore::key_space>::type;
+    underlying_t ks_le;
+    std::copy_n(
+      spaced_key.begin(), sizeof(ks_le), reinterpret_cast<char*>(&ks_le));
+    return static_cast<kvstore::key_space>(ss::le_to_cpu(ks_le));
+}
+
 void kvstore::apply_op(bytes key, std::optional<iobuf> value) {
+    _dirty_key_spaces.insert(key_space_of(key));
     auto it = _db.find(key);
     bool found = it != _db.end();
     if (value) {
@@ -308,6 +358,74 @@ ss::future<> kvstore::roll() {
     return ss::now();
 }
 
+/*
+ * Serialize the snapshot data with a size prefix: size_prefix + data
+ */
+static iobuf make_size_prefixed(iobuf data) {
+    iobuf out;
+    auto size = ss::cpu_to_le(int32_t(data.size_bytes()));
+    out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.append(std::move(data));
+    return out;
+}
+
+static ss::future<>
+write_snapshot(snapshot_manager& mgr, iobuf meta, iobuf data) {
+    auto writer = co_await mgr.start_snapshot();
+    std::exception_ptr e;
+    try {
+        co_await writer.write_metadata(std::move(meta));
+        co_await write_iobuf_to_output_stream(std::move(data), writer.output());
+    } catch (...) {
+        e = std::current_exception();
+    }
+    co_await writer.close();
+    if (e) {
+        std::rethrow_exception(e);
+    }
+    co_await mgr.finish_snapshot(writer);
+}
+
+snapshot_manager kvstore::key_space_snapshot(key_space ks) const {
+    return snapshot_manager(
+      std::filesystem::path(_ntpc.work_directory()),
+      ssx::sformat(
+        "{}.key_space.{}",
+        snapshot_manager::default_snapshot_filename,
+        static_cast<std::underlying_type<key_space>::type>(ks)),
+      ss::default_priority_class());
+}
+
+ss::future<>
+kvstore::save_key_space_snapshot(key_space ks, model::offset last_offset) {
+    // package up the keys of the key space into a batch
+    storage::record_batch_builder builder(
+      model::record_batch_type::kvstore, model::offset(0));
+    bool empty = true;
+    for (auto& entry : _db) {
+        if (key_space_of(entry.first) != ks) {
+            continue;
+        }
+        builder.add_raw_kv(
+          bytes_to_iobuf(entry.first),
+          entry.second.share(0, entry.second.size_bytes()));
+        empty = false;
+    }
+    if (empty) {
+        // the stale snapshot file is removed once it's no longer indexed
+        _snapshot_key_spaces.erase(ks);
+        co_return;
+    }
+    auto batch = std::move(builder).build();
+
+    auto mgr = key_space_snapshot(ks);
+    co_await write_snapshot(
+      mgr,
+      reflection::to_iobuf(last_offset),
+      make_size_prefixed(reflection::to_iobuf(std::move(batch))));
+    _snapshot_key_spaces.insert(ks);
+}
+
 ss::future<> kvstore::save_snapshot() {
     vassert(
       _next_offset >= model::offset(0),
@@ -316,54 +434,43 @@ ss::future<> kvstore::save_snapshot() {
 
     // no operations have been applied to the db
     if (_next_offset == model::offset(0)) {
-        return ss::now();
+        co_return;
     }
 
+    // the last log offset represented in the snapshot
+    auto last_offset = _next_offset - model::offset(1);
     vlog(
       lg.debug,
-      "Creating snapshot at offset {}",
-      _next_offset - model::offset(1));
-
-    // package up the db into a batch
-    storage::record_batch_builder builder(
-      model::record_batch_type::kvstore, model::offset(0));
-    for (auto& entry : _db) {
-        builder.add_raw_kv(
-          bytes_to_iobuf(entry.first),
-          entry.second.share(0, entry.second.size_bytes()));
+      "Creating snapshot at offset {}, changed key spaces: {}",
+      last_offset,
+      _dirty_key_spaces.size());
+
+    std::vector<key_space> removed;
+    for (auto ks : _dirty_key_spaces) {
+        co_await save_key_space_snapshot(ks, last_offset);
+        if (!_snapshot_key_spaces.contains(ks)) {
+            removed.push_back(ks);
+        }
     }
-    auto batch = std::move(builder).build();
 
-    // serialize batch: size_prefix + batch
-    iobuf data;
-    auto ph = data.reserve(sizeof(int32_t));
-    reflection::serialize(data, std::move(batch));
-    auto size = ss::cpu_to_le(int32_t(data.size_bytes() - sizeof(int32_t)));
-    ph.write((const char*)&size, sizeof(size));
-
-    return _snap.start_snapshot().then(
-      [this, data = std::move(data)](snapshot_writer writer) mutable {
-          return ss::do_with(
-            std::move(writer),
-            [this, data = std::move(data)](snapshot_writer& wr) mutable {
-                // the last log offset represented in the snapshot
-                auto last_offset = _next_offset - model::offset(1);
-
-                iobuf meta;
-                reflection::serialize(meta, last_offset);
-
-                return wr.write_metadata(std::move(meta))
-                  .then([&wr, data = std::move(data)]() mutable {
-                      auto& os = wr.output(); // kept alive by do_with above
-                      return write_iobuf_to_output_stream(std::move(data), os);
-                  })
-                  .then([&wr] { return wr.close(); })
-                  .then([this, &wr]() {
-                      vlog(lg.debug, "Finishing snapshot creation");
-                      return _snap.finish_snapshot(wr);
-                  });
-            });
-      });
+    std::vector<std::underlying_type<key_space>::type> key_spaces;
+    key_spaces.reserve(_snapshot_key_spaces.size());
+    for (auto ks : _snapshot_key_spaces) {
+        key_spaces.push_back(
+          static_cast<std::underlying_type<key_space>::type>(ks));
+    }
+    iobuf meta;
+    reflection::serialize(meta, last_offset, key_space_index_version);
+    co_await write_snapshot(
+      _snap,
+      std::move(meta),
+      make_size_prefixed(reflection::to_iobuf(std::move(key_spaces))));
+    _dirty_key_spaces.clear();
+
+    for (auto ks : removed) {
+        co_await key_space_snapshot(ks).remove_snapshot();
+    }
+    vlog(lg.debug, "Finishing snapshot creation");
 }
 
 ss::future<> kvstore::recover() {
@@ -375,18 +482,44 @@ ss::future<> kvstore::recover() {
         load_snapshot_in_thread();
 
         auto dir = std::filesystem::path(_ntpc.work_directory());
+        ss::recursive_touch_directory(dir.string()).get();
+        ss::semaphore io_units{1};
         auto segments = recover_segments(
                           std::move(dir),
                           debug_sanitize_files::yes,
                           _ntpc.is_compacted(),
                           [] { return std::nullopt; },
-                          _as)
+                          _as,
+                          io_units)
                           .get0();
 
         replay_segments_in_thread(std::move(segments));
     });
 }
 
+/*
+ * Read the size prefixed data that follows the snapshot metadata
+ */
+static iobuf read_size_prefixed_in_thread(snapshot_reader& reader) {
+    auto buf = read_iobuf_exactly(reader.input(), sizeof(int32_t)).get0();
+    if (buf.size_bytes() != sizeof(int32_t)) {
+        throw std::runtime_error(fmt::format(
+          "Failed to read snapshot size. Wanted {} bytes != {}",
+          sizeof(int32_t),
+          buf.size_bytes()));
+    }
+    auto size = reflection::from_iobuf<int32_t>(std::move(buf));
+
+    buf = read_iobuf_exactly(reader.input(), size).get0();
+    if ((int32_t)buf.size_bytes() != size) {
+        throw std::runtime_error(fmt::format(
+          "Failed to read snapshot data. Wanted {} bytes != {}",
+          size,
+          buf.size_bytes()));
+    }
+    return buf;
+}
+
 void kvstore::load_snapshot_in_thread() {
     _gate.check(); // early out on shutdown
 
@@ -409,26 +542,62 @@ void kvstore::load_snapshot_in_thread() {
       "Load snapshot: loading snapshot with last offset {}",
       last_offset);
 
-    // read and restore db from snapshot
-    auto buf = read_iobuf_exactly(reader->input(), sizeof(int32_t)).get0();
-    if (buf.size_bytes() != sizeof(int32_t)) {
-        throw std::runtime_error(fmt::format(
-          "Failed to read snapshot size. Wanted {} bytes != {}",
-          sizeof(int32_t),
-          buf.size_bytes()));
+    auto buf = read_size_prefixed_in_thread(*reader);
+    if (parser.bytes_left() == 0) {
+        // snapshot of the whole database, it's split into key spaces by the
+        // next snapshot
+        restore_snapshot_batch(
+          reflection::from_iobuf<model::record_batch>(std::move(buf)));
+        for (auto& entry : _db) {
+            _dirty_key_spaces.insert(key_space_of(entry.first));
+        }
+    } else {
+        auto version = reflection::adl<int8_t>{}.from(parser);
+        if (version != key_space_index_version) {
+            throw std::runtime_error(
+              fmt::format("Unsupported snapshot version {}", version));
+        }
+        using underlying_t = std::underlying_type<key_space>::type;
+        auto key_spaces = reflection::from_iobuf<std::vector<underlying_t>>(
+          std::move(buf));
+        for (auto ks : key_spaces) {
+            load_key_space_snapshot_in_thread(static_cast<key_space>(ks));
+        }
     }
-    auto size = reflection::from_iobuf<int32_t>(std::move(buf));
 
-    buf = read_iobuf_exactly(reader->input(), size).get0();
-    if ((int32_t)buf.size_bytes() != size) {
+    _next_offset = last_offset + model::offset(1);
+}
+
+void kvstore::load_key_space_snapshot_in_thread(key_space ks) {
+    _gate.check(); // early out on shutdown
+
+    auto mgr = key_space_snapshot(ks);
+    auto reader = mgr.open_snapshot().get0();
+    if (!reader) {
         throw std::runtime_error(fmt::format(
-          "Failed to read snapshot data. Wanted {} bytes != {}",
-          size,
-          buf.size_bytes()));
+          "Snapshot of key space {} not found: {}",
+          static_cast<std::underlying_type<key_space>::type>(ks),
+          mgr.snapshot_path().string()));
     }
+    auto close_reader = ss::defer([&reader] { return reader->close().get(); });
+
+    // the key space snapshot may be newer than the main snapshot if the
+    // main one wasn't replaced after the key space snapshot was written
+    auto snap_meta = reader->read_metadata().get0();
+    auto last_offset = reflection::from_iobuf<model::offset>(
+      std::move(snap_meta));
+    vlog(
+      lg.debug,
+      "Load snapshot: loading key space {} snapshot with last offset {}",
+      static_cast<std::underlying_type<key_space>::type>(ks),
+      last_offset);
 
-    auto batch = reflection::from_iobuf<model::record_batch>(std::move(buf));
+    restore_snapshot_batch(reflection::from_iobuf<model::record_batch>(
+      read_size_prefixed_in_thread(*reader)));
+    _snapshot_key_spaces.insert(ks);
+}
 
+void kvstore::restore_snapshot_batch(model::record_batch batch) {
     auto batch_crc = model::crc_record_batch(batch);
     if (batch.header().crc != batch_crc) {
         throw std::runtime_error(fmt::format(
@@ -455,8 +624,6 @@ void kvstore::load_snapshot_in_thread() {
           res.first->first,
           res.first->second);
     });
-
-    _next_offset = last_offset + model::offset(1);
 }
 
 void kvstore::replay_segments_in_thread(segment_set segs) {
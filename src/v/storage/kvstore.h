@@ -26,6 +26,7 @@
 #include <seastar/core/timer.hh>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 
 namespace storage {
 
@@ -60,6 +61,17 @@ namespace storage {
  * in which access to the underlying file storing the metadata was already
  * controlled.
  *
+ * Snapshots
+ * =========
+ *
+ * When the segment is rolled the database is snapshotted one key space at a
+ * time and only the key spaces that changed since the previous snapshot are
+ * rewritten. The main snapshot only records the last offset that the snapshot
+ * represents and the list of the key spaces with a snapshot file. It is
+ * replaced after all of the key space snapshots are written, so a crash in
+ * between leaves a key space snapshot newer than the main one. That's safe
+ * as the operations replayed from the log set absolute values.
+ *
  * Limitations
  * ===========
  *
@@ -107,6 +119,11 @@ public:
     ss::future<> put(key_space ks, bytes key, iobuf value);
     ss::future<> remove(key_space ks, bytes key);
 
+    /// Batched versions of put and remove, all of the entries are written
+    /// with the same flush
+    ss::future<> put(key_space ks, std::vector<std::pair<bytes, iobuf>> kvs);
+    ss::future<> remove(key_space ks, std::vector<bytes> keys);
+
     bool empty() const {
         vassert(_started, "kvstore has not been started");
         return _db.empty();
@@ -145,12 +162,18 @@ private:
     ss::lw_shared_ptr<segment> _segment;
     model::offset _next_offset;
     absl::flat_hash_map<bytes, iobuf, bytes_type_hash, bytes_type_eq> _db;
+    // key spaces with a snapshot file and key spaces changed since then
+    absl::flat_hash_set<key_space> _snapshot_key_spaces;
+    absl::flat_hash_set<key_space> _dirty_key_spaces;
 
     ss::future<> put(key_space ks, bytes key, std::optional<iobuf> value);
+    ss::future<> enqueue(bytes key, std::optional<iobuf> value);
     void apply_op(bytes key, std::optional<iobuf> value);
     ss::future<> flush_and_apply_ops();
     ss::future<> roll();
     ss::future<> save_snapshot();
+    ss::future<> save_key_space_snapshot(key_space, model::offset);
+    snapshot_manager key_space_snapshot(key_space) const;
 
     /*
      * Recovery
@@ -160,6 +183,8 @@ private:
      */
     ss::future<> recover();
     void load_snapshot_in_thread();
+    void load_key_space_snapshot_in_thread(key_space);
+    void restore_snapshot_batch(model::record_batch);
     void replay_segments_in_thread(segment_set);
 
     /**
@@ -9,7 +9,6 @@
 
 #include "storage/lock_manager.h"
 
-#include <seastar/core/future-util.hh>
 #include <seastar/core/rwlock.hh>
 #include <seastar/core/shared_ptr.hh>
 
@@ -21,17 +20,16 @@ static ss::future<std::unique_ptr<lock_manager::lease>>
 range(segment_set::underlying_t segs) {
     auto ctx = std::make_unique<lock_manager::lease>(
       segment_set(std::move(segs)));
-    std::vector<ss::future<ss::rwlock::holder>> dispatch;
-    dispatch.reserve(ctx->range.size());
-    for (auto& s : ctx->range) {
-        dispatch.emplace_back(s->read_lock());
+    if (ctx->range.empty()) {
+        return ss::make_ready_future<std::unique_ptr<lock_manager::lease>>(
+          std::move(ctx));
     }
-    return ss::when_all_succeed(dispatch.begin(), dispatch.end())
-      .then(
-        [ctx = std::move(ctx)](std::vector<ss::rwlock::holder> lks) mutable {
-            ctx->locks = std::move(lks);
-            return std::move(ctx);
-        });
+    // the next segments are locked by the reader as it gets to them
+    auto f = ctx->range.front()->read_lock();
+    return f.then([ctx = std::move(ctx)](ss::rwlock::holder h) mutable {
+        ctx->locks.push_back(std::move(h));
+        return std::move(ctx);
+    });
 }
 
 ss::future<std::unique_ptr<lock_manager::lease>>
@@ -32,7 +32,14 @@ public:
         lease(const lease&) = delete;
         lease& operator=(const lease&) = delete;
 
+        /// \brief the segments of the read, a copy of the set of the log
+        /// taken when the lease is made
         segment_set range;
+        /// \brief read locks of the segments currently read. only the first
+        /// segment of the range is locked with the lease, the log_reader
+        /// locks each next segment when it gets to it and releases the
+        /// previous, so the destructive operations on other segments of the
+        /// range don't wait for the reader.
         std::vector<ss::rwlock::holder> locks;
 
         friend std::ostream& operator<<(std::ostream&, const lease&);
@@ -65,6 +65,8 @@ public:
 
         virtual ss::future<std::optional<timequery_result>>
           timequery(timequery_config) = 0;
+        virtual ss::future<std::optional<key_query_result>>
+          key_query(key_query_config) = 0;
 
         const ntp_config& config() const { return _config; }
 
@@ -72,6 +74,8 @@ public:
         virtual storage::offset_stats offsets() const = 0;
         virtual std::ostream& print(std::ostream& o) const = 0;
         virtual std::optional<model::term_id> get_term(model::offset) const = 0;
+        virtual std::optional<term_end_result>
+          term_end(model::term_id) const = 0;
 
         virtual ss::future<model::offset>
         monitor_eviction(ss::abort_source&) = 0;
@@ -146,11 +150,34 @@ public:
     std::optional<model::term_id> get_term(model::offset o) const {
         return _impl->get_term(o);
     }
+
+    /**
+     * \brief Returns the latest term of the log up to the given one and the
+     * base offset of the following term, or the end of the log if it is the
+     * last term. A term older than the log ends where the log starts.
+     *
+     * Nullopt when the log is empty.
+     */
+    std::optional<term_end_result> term_end(model::term_id t) const {
+        return _impl->term_end(t);
+    }
     ss::future<std::optional<timequery_result>>
     timequery(timequery_config cfg) {
         return _impl->timequery(cfg);
     }
 
+    /**
+     * \brief Returns the latest record of the key up to the max offset, or
+     * nullopt if there is none
+     *
+     * The segments are searched from the newest, the sealed segments whose key
+     * filter doesn't have the key are skipped without being read.
+     */
+    ss::future<std::optional<key_query_result>>
+    key_query(key_query_config cfg) {
+        return _impl->key_query(std::move(cfg));
+    }
+
     ss::future<> compact(compaction_config cfg) { return _impl->compact(cfg); }
 
     /**
@@ -12,10 +12,14 @@
 #include "config/configuration.h"
 #include "likely.h"
 #include "model/fundamental.h"
+#include "model/namespace.h"
 #include "model/timestamp.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "reflection/adl.h"
 #include "resource_mgmt/io_priority.h"
 #include "storage/batch_cache.h"
 #include "storage/compacted_index_writer.h"
+#include "storage/disk_log_impl.h"
 #include "storage/fs_utils.h"
 #include "storage/kvstore.h"
 #include "storage/log.h"
@@ -31,18 +35,22 @@
 #include "vlog.h"
 
 #include <seastar/core/abort_source.hh>
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/metrics.hh>
 #include <seastar/core/print.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/core/with_scheduling_group.hh>
 
+#include <boost/range/irange.hpp>
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <chrono>
 #include <exception>
 #include <filesystem>
@@ -55,26 +63,102 @@ log_manager::log_manager(log_config config, kvstore& kvstore) noexcept
   : _config(std::move(config))
   , _kvstore(kvstore)
   , _jitter(_config.compaction_interval)
-  , _batch_cache(config.reclaim_opts) {
+  , _index_cache(config::shard_local_cfg().segment_index_memory_limit())
+  , _recovery_units(config::shard_local_cfg().segment_recovery_concurrency())
+  , _batch_cache(config.reclaim_opts)
+  , _bindings(bind_config()) {
     _compaction_timer.set_callback([this] { trigger_housekeeping(); });
     _compaction_timer.rearm(_jitter());
+    watch_config();
+}
+
+log_manager::config_bindings log_manager::bind_config() {
+    auto& cfg = config::shard_local_cfg();
+    return config_bindings{
+      .segment_size = cfg.log_segment_size.bind(),
+      .compacted_segment_size = cfg.compacted_log_segment_size.bind(),
+      .max_compacted_segment_size = cfg.max_compacted_log_segment_size.bind(),
+      .compaction_interval = cfg.log_compaction_interval_ms.bind(),
+      .reclaim_min_size = cfg.reclaim_min_size.bind(),
+      .reclaim_max_size = cfg.reclaim_max_size.bind(),
+      .reclaim_growth_window = cfg.reclaim_growth_window.bind(),
+      .reclaim_stable_window = cfg.reclaim_stable_window.bind(),
+      .reclaim_protected_ratio = cfg.batch_cache_protected_ratio.bind(),
+    };
+}
+
+void log_manager::watch_config() {
+    _bindings.segment_size.watch([this] { update_segment_sizes(); });
+    _bindings.compacted_segment_size.watch([this] { update_segment_sizes(); });
+    _bindings.max_compacted_segment_size.watch([this] {
+        _config.max_compacted_segment_size
+          = _bindings.max_compacted_segment_size();
+    });
+    _bindings.compaction_interval.watch([this] {
+        _config.compaction_interval = _bindings.compaction_interval();
+        _jitter = simple_time_jitter<ss::lowres_clock>(
+          _config.compaction_interval);
+        // a running housekeeping rearms the timer when it is done
+        if (_compaction_timer.armed()) {
+            _compaction_timer.rearm(_jitter());
+        }
+    });
+    _bindings.reclaim_min_size.watch([this] { update_reclaim_options(); });
+    _bindings.reclaim_max_size.watch([this] { update_reclaim_options(); });
+    _bindings.reclaim_growth_window.watch(
+      [this] { update_reclaim_options(); });
+    _bindings.reclaim_stable_window.watch(
+      [this] { update_reclaim_options(); });
+    _bindings.reclaim_protected_ratio.watch(
+      [this] { update_reclaim_options(); });
+}
+
+void log_manager::update_segment_sizes() {
+    _config.max_segment_size = _bindings.segment_size();
+    _config.compacted_segment_size = _bindings.compacted_segment_size();
+    for (auto& [_, meta] : _logs) {
+        if (auto l = dynamic_cast<disk_log_impl*>(meta.handle.get_impl())) {
+            l->update_max_segment_size();
+        }
+    }
+}
+
+void log_manager::update_reclaim_options() {
+    auto& opts = _config.reclaim_opts;
+    opts.min_size = _bindings.reclaim_min_size();
+    opts.max_size = _bindings.reclaim_max_size();
+    opts.growth_window = _bindings.reclaim_growth_window();
+    opts.stable_window = _bindings.reclaim_stable_window();
+    opts.protected_ratio = _bindings.reclaim_protected_ratio();
+    _batch_cache.update_reclaim_options(opts);
 }
 void log_manager::trigger_housekeeping() {
     (void)ss::with_gate(_open_gate, [this] {
-        auto next_housekeeping = _jitter();
-        return housekeeping().finally([this, next_housekeeping] {
+        return housekeeping().finally([this] {
             // all of these *MUST* be in the finally
             if (_open_gate.is_closed()) {
                 return;
             }
-
-            _compaction_timer.rearm(next_housekeeping);
+            arm_housekeeping();
         });
     }).handle_exception([](std::exception_ptr e) {
         vlog(stlog.info, "Error processing housekeeping(): {}", e);
     });
 }
 
+void log_manager::arm_housekeeping() {
+    // the next round when the next log is due, a round that ran out of
+    // budget leaves the due logs to a round shortly after
+    const auto now = ss::lowres_clock::now();
+    const auto min_pause = std::min<ss::lowres_clock::duration>(
+      std::chrono::seconds(1), _config.compaction_interval);
+    auto next = _jitter();
+    if (auto due = _housekeeping_queue.next_due(); due) {
+        next = std::min(next, *due);
+    }
+    _compaction_timer.rearm(std::max(next, now + min_pause));
+}
+
 ss::future<> log_manager::stop() {
     _compaction_timer.cancel();
     _abort_source.request_abort();
@@ -84,66 +168,145 @@ ss::future<> log_manager::stop() {
               return entry.second.handle.close();
           });
       })
+      .then([this] { return _flush_scheduler.stop(); })
+      .then([this] { return _segment_deleter.stop(); })
       .then([this] { return _batch_cache.stop(); });
 }
 
-static inline logs_type::iterator find_next_non_compacted_log(logs_type& logs) {
-    using bflags = log_housekeeping_meta::bitflags;
-    return std::find_if(
-      logs.begin(), logs.end(), [](const logs_type::value_type& l) {
-          return bflags::none == (l.second.flags & bflags::compacted);
-      });
-}
-
 ss::future<> log_manager::housekeeping() {
     auto collection_threshold = model::timestamp(
       model::timestamp::now().value() - _config.delete_retention.count());
     /**
-     * Note that this loop does a double find - which is not fast. This solution
-     * is the tradeoff to *not* lock the segment during log_manager::remove(ntp)
-     * and to *not* use an ordered container.
-     *
-     * The issue with keeping an iterator and effectively doing a iterator++
-     * is that during a concurrent log_manager::remove() we invalidate all the
-     * iterators for the absl::flat_hash_map; - an alternative here would be to
-     * use a lock
+     * The logs are processed from the queue, the most urgent of the due logs
+     * first, instead of scanning all the logs of the shard every round. A
+     * processed log is due again after the compaction interval, or earlier if
+     * it rolls a segment meanwhile.
      *
-     * Note that we also do not use an ordered container like an absl::tree-set
-     * because finds are frequent on this datastructure and we want to serve
-     * them as fast as we can since the majority of the time they will be in the
-     * hotpath / (request-response)
+     * Several workers take the logs from the queue so that a dirty log
+     * doesn't wait behind a long compaction. They all run in the compaction
+     * scheduling group whose shares the compaction_controller adjusts to the
+     * backlog.
      */
-    using bflags = log_housekeeping_meta::bitflags;
-    return ss::do_until(
-             [this] {
-                 auto it = find_next_non_compacted_log(_logs);
-                 return it == _logs.end();
-             },
-             [this, collection_threshold] {
-                 return ss::with_scheduling_group(
-                   _config.compaction_sg, [this, collection_threshold] {
-                       auto it = find_next_non_compacted_log(_logs);
-                       if (it == _logs.end()) {
-                           // must check again because between the stop
-                           // condition and this continuation we might have
-                           // removed the log
-                           return ss::now();
-                       }
-                       it->second.flags |= bflags::compacted;
-                       it->second.last_compaction = ss::lowres_clock::now();
-                       return it->second.handle.compact(compaction_config(
-                         collection_threshold,
-                         _config.retention_bytes,
-                         _config.compaction_priority,
-                         _abort_source));
-                   });
-             })
-      .finally([this] {
-          for (auto& h : _logs) {
-              h.second.flags &= ~bflags::compacted;
-          }
+    const auto start = ss::lowres_clock::now();
+    const auto workers = std::max<size_t>(_config.housekeeping_concurrency, 1);
+    return ss::parallel_for_each(
+      boost::irange<size_t>(0, workers),
+      [this, collection_threshold, start](size_t) {
+          return housekeeping_worker(collection_threshold, start);
       });
 }
+
+ss::future<> log_manager::housekeeping_worker(
+  model::timestamp collection_threshold, ss::lowres_clock::time_point start) {
+    auto out_of_budget = [this, start] {
+        return _config.housekeeping_budget
+                 > std::chrono::milliseconds::zero()
+               && ss::lowres_clock::now() - start
+                    >= _config.housekeeping_budget;
+    };
+    return ss::repeat([this, collection_threshold, out_of_budget] {
+        if (out_of_budget() || _abort_source.abort_requested()) {
+            return ss::make_ready_future<ss::stop_iteration>(
+              ss::stop_iteration::yes);
+        }
+        auto ntp = _housekeeping_queue.pop(ss::lowres_clock::now());
+        if (!ntp) {
+            return ss::make_ready_future<ss::stop_iteration>(
+              ss::stop_iteration::yes);
+        }
+        /*
+         * the log is looked up again rather than holding an iterator since a
+         * concurrent log_manager::remove() invalidates the iterators of the
+         * absl::flat_hash_map
+         */
+        auto it = _logs.find(*ntp);
+        if (it == _logs.end() || it->second.in_housekeeping) {
+            // removed while queued, or queued again once done
+            return ss::make_ready_future<ss::stop_iteration>(
+              ss::stop_iteration::no);
+        }
+        it->second.in_housekeeping = true;
+        it->second.last_compaction = ss::lowres_clock::now();
+        return ss::with_scheduling_group(
+                 _config.compaction_sg,
+                 [this, l = it->second.handle, collection_threshold] {
+                     return housekeep(l, collection_threshold);
+                 })
+          .then([] { return ss::stop_iteration::no; });
+    });
+}
+
+ss::future<> log_manager::housekeep(
+  log l, model::timestamp collection_threshold) {
+    compaction_config cfg(
+      collection_threshold,
+      _config.retention_bytes,
+      _config.compaction_priority,
+      _abort_source);
+    // the key maps of the concurrent compactions share the shard memory
+    cfg.key_map_memory
+      = config::shard_local_cfg().compaction_key_map_memory()
+        / std::max<size_t>(_config.housekeeping_concurrency, 1);
+    return l.compact(cfg).finally([this, l] {
+        // unless removed meanwhile
+        auto it = _logs.find(l.config().ntp());
+        if (it == _logs.end()) {
+            return;
+        }
+        auto& meta = it->second;
+        meta.in_housekeeping = false;
+        schedule_housekeeping(
+          l,
+          std::exchange(meta.housekeeping_requested, false)
+            ? ss::lowres_clock::now()
+            : _jitter());
+    });
+}
+
+void log_manager::request_housekeeping(const model::ntp& ntp) {
+    auto it = _logs.find(ntp);
+    if (it == _logs.end()) {
+        return;
+    }
+    if (it->second.in_housekeeping) {
+        // queued again once done
+        it->second.housekeeping_requested = true;
+        return;
+    }
+    schedule_housekeeping(it->second.handle, ss::lowres_clock::now());
+}
+
+void log_manager::schedule_housekeeping(
+  const log& l, ss::lowres_clock::time_point due) {
+    _housekeeping_queue.schedule(
+      l.config().ntp(), due, housekeeping_urgency(l));
+}
+
+/// \brief how much the log needs housekeeping: the ratio of its size over
+/// its retention bytes plus the ratio of its bytes not yet compacted
+double log_manager::housekeeping_urgency(const log& l) const {
+    const auto size = l.size_bytes();
+    if (size == 0) {
+        return 0;
+    }
+    double urgency = static_cast<double>(l.compaction_backlog())
+                     / static_cast<double>(size);
+    auto retention = _config.retention_bytes;
+    if (l.config().has_overrides()) {
+        const auto& o = l.config().get_overrides().retention_bytes;
+        if (o.is_disabled()) {
+            retention = std::nullopt;
+        } else if (o.has_value()) {
+            retention = o.value();
+        }
+    }
+    if (retention && *retention > 0) {
+        urgency += static_cast<double>(size)
+                   / static_cast<double>(*retention);
+    }
+    return urgency;
+}
+
 ss::future<ss::lw_shared_ptr<segment>> log_manager::make_log_segment(
   const ntp_config& ntp,
   model::offset base_offset,
@@ -161,10 +324,61 @@ ss::future<ss::lw_shared_ptr<segment>> log_manager::make_log_segment(
             version,
             buf_size,
             _config.sanitize_fileops,
-            create_cache(ntp.cache_enabled()));
+            create_cache(ntp.cache_enabled()),
+            &_flush_scheduler)
+            .then([this](ss::lw_shared_ptr<segment> seg) {
+                seg->index().set_cache(&_index_cache);
+                return seg;
+            });
+      });
+}
+
+ss::future<ss::lw_shared_ptr<segment>> log_manager::make_log_segment(
+  const ntp_config& ntp,
+  model::offset base_offset,
+  model::term_id term,
+  ss::io_priority_class pc,
+  staged_segment staged,
+  record_version_type version,
+  size_t buf_size) {
+    return ss::with_gate(
+      _open_gate,
+      [this,
+       &ntp,
+       base_offset,
+       term,
+       pc,
+       version,
+       buf_size,
+       staged = std::move(staged)]() mutable {
+          return std::move(staged)
+            .commit(
+              ntp,
+              base_offset,
+              term,
+              pc,
+              version,
+              buf_size,
+              create_cache(ntp.cache_enabled()))
+            .then([this](ss::lw_shared_ptr<segment> seg) {
+                seg->index().set_cache(&_index_cache);
+                return seg;
+            });
       });
 }
 
+ss::future<staged_segment> log_manager::stage_log_segment(
+  const ntp_config& ntp, ss::io_priority_class pc) {
+    return ss::with_gate(_open_gate, [this, &ntp, pc] {
+        return staged_segment::create(
+          std::filesystem::path(ntp.work_directory()),
+          pc,
+          _config.sanitize_fileops,
+          internal::number_of_chunks_from_config(ntp),
+          &_flush_scheduler);
+    });
+}
+
 std::optional<batch_cache_index>
 log_manager::create_cache(with_cache ntp_cache_enabled) {
     if (unlikely(
@@ -178,23 +392,148 @@ log_manager::create_cache(with_cache ntp_cache_enabled) {
 
 ss::future<log> log_manager::manage(ntp_config cfg) {
     return ss::with_gate(_open_gate, [this, cfg = std::move(cfg)]() mutable {
-        return do_manage(std::move(cfg));
+        return place_log(std::move(cfg)).then([this](ntp_config cfg) {
+            auto ntp = cfg.ntp();
+            return do_manage(std::move(cfg)).finally(
+              [this, ntp = std::move(ntp)] { _placing.erase(ntp); });
+        });
     });
 }
 
+ss::future<ntp_config> log_manager::place_log(ntp_config cfg) {
+    if (
+      _config.stype != log_config::storage_type::disk
+      || _config.additional_dirs.empty() || cfg.ntp().ns == model::redpanda_ns
+      || cfg.is_memory_backed() || cfg.base_directory() != _config.base_dir) {
+        co_return cfg;
+    }
+    auto usage = data_directories_usage();
+    for (const auto& dir : usage) {
+        cfg.base_directory() = dir.path;
+        if (co_await ss::file_exists(cfg.work_directory())) {
+            co_return cfg;
+        }
+    }
+    // the logs managed while looking for the work directory are accounted
+    usage = data_directories_usage();
+    for (const auto& [_, dir] : _placing) {
+        auto it = std::find_if(
+          usage.begin(), usage.end(), [&dir](const data_directory_usage& u) {
+              return u.path == dir;
+          });
+        if (it != usage.end()) {
+            ++it->partitions;
+        }
+    }
+    auto load = [this](const data_directory_usage& u) {
+        return u.size_bytes + u.partitions * _config.max_segment_size;
+    };
+    auto it = std::min_element(
+      usage.begin(),
+      usage.end(),
+      [&load](const data_directory_usage& a, const data_directory_usage& b) {
+          return load(a) < load(b);
+      });
+    cfg.base_directory() = it->path;
+    _placing.emplace(cfg.ntp(), it->path);
+    vlog(stlog.info, "Placing {} in {}", cfg.ntp(), it->path);
+    co_return cfg;
+}
+
+std::vector<log_manager::data_directory_usage>
+log_manager::data_directories_usage() const {
+    std::vector<data_directory_usage> ret;
+    ret.reserve(_config.additional_dirs.size() + 1);
+    ret.push_back(data_directory_usage{.path = _config.base_dir});
+    for (const auto& dir : _config.additional_dirs) {
+        ret.push_back(data_directory_usage{.path = dir});
+    }
+    for (auto& dir : ret) {
+        auto u = _disk_usage.directory(dir.path);
+        dir.size_bytes = u.size_bytes;
+        dir.partitions = u.partitions;
+    }
+    return ret;
+}
+
+void log_manager::setup_data_directories_metrics() {
+    if (
+      config::shard_local_cfg().disable_metrics()
+      || _config.additional_dirs.empty()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    auto dir_label = sm::label("directory");
+    auto usage_of = [this](size_t i) { return data_directories_usage()[i]; };
+    std::vector<sm::metric_definition> defs;
+    for (size_t i = 0; i <= _config.additional_dirs.size(); ++i) {
+        const auto& dir = i == 0 ? _config.base_dir
+                                 : _config.additional_dirs[i - 1];
+        defs.push_back(sm::make_gauge(
+          "size_bytes",
+          [usage_of, i] { return usage_of(i).size_bytes; },
+          sm::description("Bytes of the logs of the shard in the directory"),
+          {dir_label(dir)}));
+        defs.push_back(sm::make_gauge(
+          "partitions",
+          [usage_of, i] { return usage_of(i).partitions; },
+          sm::description("Number of logs of the shard in the directory"),
+          {dir_label(dir)}));
+    }
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:data_directory"), defs);
+}
+
 ss::future<> log_manager::recover_log_state(const ntp_config& cfg) {
     return ss::file_exists(cfg.work_directory())
       .then(
-        [this, key = internal::start_offset_key(cfg.ntp())](bool dir_exists) {
+        [this, key = internal::start_offset_key(cfg.ntp()), ntp = cfg.ntp()](
+          bool dir_exists) {
             if (dir_exists) {
                 return ss::now();
             }
             // directory was deleted, make sure we do not have any state in KV
             // store.
-            return _kvstore.remove(kvstore::key_space::storage, key);
+            return _kvstore.remove(kvstore::key_space::storage, key)
+              .then([this, ntp] {
+                  return _kvstore.remove(
+                    kvstore::key_space::storage,
+                    internal::clean_segment_key(ntp));
+              });
         });
 }
 
+ss::future<> log_manager::create_log_directory(
+  ss::sstring base_dir, ss::sstring work_dir) {
+    if (co_await ss::file_exists(work_dir)) {
+        co_return;
+    }
+    if (!co_await ss::file_exists(base_dir)) {
+        co_await ss::recursive_touch_directory(base_dir);
+    }
+    std::filesystem::path dir(base_dir);
+    // every level is synced for the new entry to be durable, the syncs are
+    // shared with the logs created concurrently, e.g. the partitions of a new
+    // topic sync the topic directory once per flush batch
+    auto relative = std::filesystem::path(work_dir).lexically_relative(dir);
+    for (const auto& component : relative) {
+        auto parent = dir.string();
+        dir /= component;
+        co_await ss::touch_directory(dir.string());
+        co_await _flush_scheduler.sync_directory(std::move(parent));
+    }
+}
+
+std::optional<clean_segment_marker>
+log_manager::read_clean_segment_marker(const model::ntp& ntp) {
+    auto value = _kvstore.get(
+      kvstore::key_space::storage, internal::clean_segment_key(ntp));
+    if (!value) {
+        return std::nullopt;
+    }
+    return reflection::adl<clean_segment_marker>{}.from(std::move(*value));
+}
+
 ss::future<log> log_manager::do_manage(ntp_config cfg) {
     if (_config.base_dir.empty()) {
         return ss::make_exception_future<log>(std::runtime_error(
@@ -204,37 +543,67 @@ ss::future<log> log_manager::do_manage(ntp_config cfg) {
     vassert(
       _logs.find(cfg.ntp()) == _logs.end(), "cannot double register same ntp");
 
-    if (_config.stype == log_config::storage_type::memory) {
+    if (
+      _config.stype == log_config::storage_type::memory
+      || cfg.is_memory_backed()) {
         auto path = cfg.work_directory();
         auto l = storage::make_memory_backed_log(std::move(cfg));
         _logs.emplace(l.config().ntp(), l);
+        schedule_housekeeping(l, _jitter());
         // in-memory needs to write vote_for configuration
         return ss::recursive_touch_directory(path).then([l] { return l; });
     }
 
-    return recover_log_state(cfg).then([this, cfg = std::move(cfg)]() mutable {
-        ss::sstring path = cfg.work_directory();
-        with_cache cache_enabled = cfg.cache_enabled();
-        return recover_segments(
-                 std::filesystem::path(path),
-                 _config.sanitize_fileops,
-                 cfg.is_compacted(),
-                 [this, cache_enabled] { return create_cache(cache_enabled); },
-                 _abort_source)
-          .then([this, cfg = std::move(cfg)](segment_set segments) mutable {
-              auto l = storage::make_disk_backed_log(
-                std::move(cfg), *this, std::move(segments), _kvstore);
-              auto [_, success] = _logs.emplace(l.config().ntp(), l);
-              vassert(
-                success, "Could not keep track of:{} - concurrency issue", l);
-              return l;
-          });
-    });
+    return recover_log_state(cfg)
+      .then([this, base = cfg.base_directory(), dir = cfg.work_directory()] {
+          return create_log_directory(base, dir);
+      })
+      .then([this, cfg = std::move(cfg)]() mutable {
+          ss::sstring path = cfg.work_directory();
+          with_cache cache_enabled = cfg.cache_enabled();
+          auto clean_marker = read_clean_segment_marker(cfg.ntp());
+          const bool has_marker = clean_marker.has_value();
+          return recover_segments(
+                   std::filesystem::path(path),
+                   _config.sanitize_fileops,
+                   cfg.is_compacted(),
+                   [this, cache_enabled] {
+                       return create_cache(cache_enabled);
+                   },
+                   _abort_source,
+                   _recovery_units,
+                   std::move(clean_marker))
+            .then([this, has_marker, cfg = std::move(cfg)](
+                    segment_set segments) mutable {
+                for (auto& s : segments) {
+                    s->index().set_cache(&_index_cache);
+                }
+                auto l = storage::make_disk_backed_log(
+                  std::move(cfg), *this, std::move(segments), _kvstore);
+                auto [_, success] = _logs.emplace(l.config().ntp(), l);
+                vassert(
+                  success,
+                  "Could not keep track of:{} - concurrency issue",
+                  l);
+                schedule_housekeeping(l, _jitter());
+                if (!has_marker) {
+                    return ss::make_ready_future<log>(l);
+                }
+                // the log is going to be modified, the tail has to be
+                // recovered if we crash
+                return _kvstore
+                  .remove(
+                    kvstore::key_space::storage,
+                    internal::clean_segment_key(l.config().ntp()))
+                  .then([l] { return l; });
+            });
+      });
 }
 
 ss::future<> log_manager::shutdown(model::ntp ntp) {
     vlog(stlog.debug, "Asked to shutdown: {}", ntp);
     return ss::with_gate(_open_gate, [this, ntp = std::move(ntp)] {
+        _housekeeping_queue.remove(ntp);
         auto handle = _logs.extract(ntp);
         if (handle.empty()) {
             return ss::make_ready_future<>();
@@ -247,6 +616,7 @@ ss::future<> log_manager::shutdown(model::ntp ntp) {
 ss::future<> log_manager::remove(model::ntp ntp) {
     vlog(stlog.info, "Asked to remove: {}", ntp);
     return ss::with_gate(_open_gate, [this, ntp = std::move(ntp)] {
+        _housekeeping_queue.remove(ntp);
         auto handle = _logs.extract(ntp);
         if (handle.empty()) {
             return ss::make_ready_future<>();
@@ -332,6 +702,7 @@ std::ostream& operator<<(std::ostream& o, log_config::storage_type t) {
 
 std::ostream& operator<<(std::ostream& o, const log_config& c) {
     o << "{type:" << c.stype << ", base_dir:" << c.base_dir
+      << ", additional_dirs:" << c.additional_dirs.size()
       << ", max_segment.size:" << c.max_segment_size
       << ", debug_sanitize_fileops:" << c.sanitize_fileops
       << ", retention_bytes:";
@@ -342,13 +713,17 @@ std::ostream& operator<<(std::ostream& o, const log_config& c) {
     }
     return o << ", compaction_interval_ms:" << c.compaction_interval.count()
              << ", delete_reteion_ms:" << c.delete_retention.count()
-             << ", with_cache:" << c.cache
+             << ", with_cache:" << c.cache << ", recompression_min_age_ms:"
+             << c.recompression_min_age.count()
+             << ", housekeeping_budget_ms:" << c.housekeeping_budget.count()
+             << ", housekeeping_concurrency:" << c.housekeeping_concurrency
              << ", relcaim_opts:" << c.reclaim_opts << "}";
 }
 std::ostream& operator<<(std::ostream& o, const log_manager& m) {
     return o << "{config:" << m._config << ", logs.size:" << m._logs.size()
              << ", cache:" << m._batch_cache
              << ", compaction_timer.armed:" << m._compaction_timer.armed()
+             << ", housekeeping_queue.size:" << m._housekeeping_queue.size()
              << "}";
 }
 } // namespace storage
@@ -11,14 +11,23 @@
 
 #pragma once
 
+#include "config/property.h"
 #include "model/fundamental.h"
 #include "random/simple_time_jitter.h"
 #include "seastarx.h"
 #include "storage/batch_cache.h"
+#include "storage/disk_usage.h"
+#include "storage/flush_scheduler.h"
+#include "storage/index_cache.h"
+#include "storage/io_latency_probe.h"
 #include "storage/log.h"
+#include "storage/housekeeping_queue.h"
 #include "storage/log_housekeeping_meta.h"
 #include "storage/ntp_config.h"
+#include "storage/probe.h"
 #include "storage/segment.h"
+#include "storage/segment_deleter.h"
+#include "storage/staged_segment.h"
 #include "storage/types.h"
 #include "storage/version.h"
 #include "units.h"
@@ -29,7 +38,9 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
 #include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
 #include <seastar/core/scheduling.hh>
+#include <seastar/core/semaphore.hh>
 #include <seastar/core/sstring.hh>
 
 #include <absl/container/flat_hash_map.h>
@@ -38,6 +49,7 @@
 #include <array>
 #include <chrono>
 #include <optional>
+#include <vector>
 
 namespace storage {
 
@@ -109,6 +121,9 @@ struct log_config {
 
     storage_type stype;
     ss::sstring base_dir;
+    // directories on other disks where the logs of the kafka partitions are
+    // placed along with base_dir, see log_manager
+    std::vector<ss::sstring> additional_dirs;
     size_t max_segment_size;
 
     // compacted segment size
@@ -123,6 +138,15 @@ struct log_config {
     // same as delete.retention.ms in kafka - default 1 week
     std::chrono::milliseconds delete_retention = std::chrono::minutes(10080);
     with_cache cache = with_cache::yes;
+    // the sealed segments whose newest batch is older are rewritten with the
+    // compression codec of their topic, disabled when 0
+    std::chrono::milliseconds recompression_min_age{0};
+    // time a housekeeping round spends on the due logs before yielding to
+    // the next round, unbounded when 0
+    std::chrono::milliseconds housekeeping_budget{0};
+    // logs garbage collected and compacted concurrently, the most urgent
+    // first
+    size_t housekeeping_concurrency{1};
     batch_cache::reclaim_options reclaim_opts{
       .growth_window = std::chrono::seconds(3),
       .stable_window = std::chrono::seconds(10),
@@ -153,7 +177,12 @@ struct log_config {
  *    <base>/<namespace>/<topic>/<partition>/
  *
  * where <base> is configured for each server (e.g.
- * /var/lib/redpanda/data). Log segments are stored in the ntp directory
+ * /var/lib/redpanda/data). When additional data directories are configured,
+ * typically one per disk, a new kafka partition is placed in the directory
+ * with the least load: the bytes of the logs of the shard in the directory
+ * plus a segment per log, for the log to come and for its writes. A log that
+ * exists stays in the directory it was created in. Log segments are stored in
+ * the ntp directory
  * with the naming convention:
  *
  *   <base offset>-<raft term>-<format version>.log
@@ -189,14 +218,56 @@ public:
 
     ss::future<> stop();
 
+    /// Register the metrics of the shard wide components
+    void setup_metrics() {
+        _batch_cache.setup_metrics();
+        _flush_scheduler.setup_metrics();
+        _index_cache.setup_metrics();
+        _segment_deleter.setup_metrics();
+        _io_latency_probe.setup_metrics();
+        _roll_probe.setup_metrics();
+        setup_data_directories_metrics();
+    }
+
+    /// Background removal of the segments dropped by retention
+    segment_deleter& deleter() { return _segment_deleter; }
+
+    /// Shard wide flushes of the segments, the foreground write latency
+    const flush_scheduler& flusher() const { return _flush_scheduler; }
+
+    /// Size of the logs on disk of the shard per data directory and topic
+    const disk_usage& usage() const { return _disk_usage; }
+    disk_usage& usage() { return _disk_usage; }
+
+    ss::future<ss::lw_shared_ptr<segment>> make_log_segment(
+      const ntp_config&,
+      model::offset,
+      model::term_id,
+      ss::io_priority_class pc,
+      record_version_type = record_version_type::v1,
+      size_t buffer_size = default_segment_readahead_size);
+
+    /// \brief makes the segment out of the files staged for it
     ss::future<ss::lw_shared_ptr<segment>> make_log_segment(
       const ntp_config&,
       model::offset,
       model::term_id,
       ss::io_priority_class pc,
+      staged_segment,
       record_version_type = record_version_type::v1,
       size_t buffer_size = default_segment_readahead_size);
 
+    /// \brief creates the files of the next segment of a log before the log
+    /// rolls, see staged_segment
+    ss::future<staged_segment>
+    stage_log_segment(const ntp_config&, ss::io_priority_class pc);
+
+    segment_roll_probe& roll_probe() { return _roll_probe; }
+
+    /// \brief queues the log for the next housekeeping round, e.g. once it
+    /// rolled a segment that may be collected or compacted
+    void request_housekeeping(const model::ntp&);
+
     const log_config& config() const { return _config; }
 
     /// Returns the number of managed logs.
@@ -218,6 +289,15 @@ public:
 
     int64_t compaction_backlog() const;
 
+    struct data_directory_usage {
+        ss::sstring path;
+        size_t size_bytes{0};
+        size_t partitions{0};
+    };
+
+    /// \brief the logs of the shard in each data directory, base_dir first
+    std::vector<data_directory_usage> data_directories_usage() const;
+
 private:
     using logs_type = absl::flat_hash_map<model::ntp, log_housekeeping_meta>;
 
@@ -230,20 +310,71 @@ private:
     void trigger_housekeeping();
     void arm_housekeeping();
     ss::future<> housekeeping();
+    ss::future<> housekeeping_worker(
+      model::timestamp collection_threshold,
+      ss::lowres_clock::time_point start);
+    ss::future<> housekeep(log, model::timestamp collection_threshold);
+    void schedule_housekeeping(const log&, ss::lowres_clock::time_point due);
+    double housekeeping_urgency(const log&) const;
 
     std::optional<batch_cache_index> create_cache(with_cache);
 
+    /// \brief sets the base directory of a kafka partition to the data
+    /// directory of its existing work directory, or else to the data
+    /// directory with the least load
+    ss::future<ntp_config> place_log(ntp_config);
+    void setup_data_directories_metrics();
+
     ss::future<> dispatch_topic_dir_deletion(ss::sstring dir);
     ss::future<> recover_log_state(const ntp_config&);
+    /// Creates the directories of a new log, batching the syncs of the
+    /// parent directories with the flushes of the shard
+    ss::future<>
+    create_log_directory(ss::sstring base_dir, ss::sstring work_dir);
+    std::optional<clean_segment_marker>
+    read_clean_segment_marker(const model::ntp&);
+
+    /// the properties of the shard configuration copied into _config, their
+    /// values set at runtime apply to the live logs
+    struct config_bindings {
+        config::binding<uint64_t> segment_size;
+        config::binding<uint64_t> compacted_segment_size;
+        config::binding<size_t> max_compacted_segment_size;
+        config::binding<std::chrono::milliseconds> compaction_interval;
+        config::binding<size_t> reclaim_min_size;
+        config::binding<size_t> reclaim_max_size;
+        config::binding<std::chrono::milliseconds> reclaim_growth_window;
+        config::binding<std::chrono::milliseconds> reclaim_stable_window;
+        config::binding<double> reclaim_protected_ratio;
+    };
+    static config_bindings bind_config();
+    void watch_config();
+    void update_segment_sizes();
+    void update_reclaim_options();
 
     log_config _config;
     kvstore& _kvstore;
     simple_time_jitter<ss::lowres_clock> _jitter;
     ss::timer<ss::lowres_clock> _compaction_timer;
+    housekeeping_queue _housekeeping_queue;
+    // must outlive the segments of the logs
+    index_cache _index_cache;
+    // bounds the disk operations of the logs recovered concurrently
+    ss::semaphore _recovery_units;
+    // must outlive the logs
+    disk_usage _disk_usage;
     logs_type _logs;
     batch_cache _batch_cache;
+    flush_scheduler _flush_scheduler;
+    segment_deleter _segment_deleter;
+    io_latency_probe _io_latency_probe;
+    segment_roll_probe _roll_probe;
     ss::gate _open_gate;
     ss::abort_source _abort_source;
+    config_bindings _bindings;
+    // the data directories of the new logs placed and not yet managed
+    absl::flat_hash_map<model::ntp, ss::sstring> _placing;
+    ss::metrics::metric_groups _metrics;
 
     friend std::ostream& operator<<(std::ostream&, const log_manager&);
 };
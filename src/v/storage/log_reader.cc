@@ -125,25 +125,75 @@ void skipping_consumer::print(std::ostream& os) const {
 }
 
 log_segment_batch_reader::log_segment_batch_reader(
-  segment& seg, log_reader_config& config, probe& p) noexcept
+  segment& seg,
+  log_reader_config& config,
+  probe& p,
+  const size_t& sequential_bytes) noexcept
   : _seg(seg)
   , _config(config)
-  , _probe(p) {}
+  , _probe(p)
+  , _sequential_bytes(sequential_bytes) {}
 
 std::unique_ptr<continuous_batch_parser> log_segment_batch_reader::initialize(
   model::timeout_clock::time_point timeout,
   std::optional<model::offset> next_cached_batch) {
-    auto input = _seg.offset_data_stream(_config.start_offset, _config.prio);
+    if (
+      _prefetched
+      && _prefetched->position == stream_position(_config.start_offset)) {
+        // the read-ahead was sized when the stream was prefetched
+        auto input = std::move(_prefetched->input);
+        _prefetched.reset();
+        return std::make_unique<continuous_batch_parser>(
+          std::make_unique<skipping_consumer>(
+            *this, timeout, next_cached_batch),
+          std::move(input));
+    }
+    if (_config.read_ahead) {
+        _read_ahead = read_ahead::fixed(
+          _seg.reader().buffer_size(), *_config.read_ahead);
+    } else {
+        _read_ahead = read_ahead::adaptive(sequential_bytes());
+    }
+    auto input = _seg.offset_data_stream(
+      _config.start_offset,
+      _config.prio,
+      _read_ahead.opts().depth,
+      _read_ahead.opts().buffer_size);
     return std::make_unique<continuous_batch_parser>(
       std::make_unique<skipping_consumer>(*this, timeout, next_cached_batch),
       std::move(input));
 }
 
+size_t log_segment_batch_reader::stream_position(model::offset o) const {
+    auto nearest = _seg.index().find_nearest(o);
+    return nearest ? nearest->filepos : 0;
+}
+
+void log_segment_batch_reader::prefetch(model::offset o) {
+    _read_ahead = read_ahead::adaptive(sequential_bytes());
+    _prefetched = prefetched_stream{
+      .position = stream_position(o),
+      .input = make_prefetched_stream(_seg.offset_data_stream(
+        o,
+        _config.prio,
+        _read_ahead.opts().depth,
+        _read_ahead.opts().buffer_size)),
+    };
+}
+
 ss::future<> log_segment_batch_reader::close() {
-    if (_iterator) {
-        return _iterator->close();
+    auto f = ss::now();
+    if (_prefetched) {
+        // the reader started elsewhere or was never used
+        f = _prefetched->input.close().finally(
+          [this] { _prefetched.reset(); });
     }
-    return ss::make_ready_future<>();
+    return f.then([this] {
+        if (_iterator) {
+            return _iterator->close().then([this] { _read_ahead = {}; });
+        }
+        return ss::make_ready_future<>();
+    });
 }
 
 void log_segment_batch_reader::add_one(model::record_batch&& batch) {
@@ -160,6 +210,18 @@ void log_segment_batch_reader::add_one(model::record_batch&& batch) {
 }
 ss::future<result<records_t>>
 log_segment_batch_reader::read_some(model::timeout_clock::time_point timeout) {
+    if (_iterator && _read_ahead.should_grow(sequential_bytes())) {
+        // the reader turned out to read sequentially, reopen the stream at
+        // the current offset with a deeper read-ahead
+        auto it = std::move(_iterator);
+        auto raw = it.get();
+        return raw->close()
+          .finally([it = std::move(it)] {})
+          .then([this, timeout] {
+              _read_ahead = {};
+              return read_some(timeout);
+          });
+    }
     /*
      * fetch batches from the cache covering the range [_base, end] where
      * end is either the configured max offset or the end of the segment.
@@ -198,8 +260,20 @@ log_segment_batch_reader::read_some(model::timeout_clock::time_point timeout) {
     }
 
     if (!_iterator) {
+        if (!_seg.index().is_materialized()) {
+            // the index of a cold segment was unloaded to save memory
+            return _seg.index().ensure_materialized().then(
+              [this, timeout, next = cache_read.next_cached_batch] {
+                  _iterator = initialize(timeout, next);
+                  return read_iterator();
+              });
+        }
         _iterator = initialize(timeout, cache_read.next_cached_batch);
     }
+    return read_iterator();
+}
+
+ss::future<result<records_t>> log_segment_batch_reader::read_iterator() {
     auto ptr = _iterator.get();
     return ptr->consume().then(
       [this](result<size_t> bytes_consumed) -> result<records_t> {
@@ -233,7 +307,7 @@ log_reader::log_reader(
 
     if (_iterator.next_seg != _lease->range.end()) {
         _iterator.reader = std::make_unique<log_segment_batch_reader>(
-          **_iterator.next_seg, _config, _probe);
+          **_iterator.next_seg, _config, _probe, _sequential_bytes);
     }
 }
 
@@ -251,16 +325,44 @@ ss::future<> log_reader::find_next_valid_iterator() {
             break;
         }
     }
-    if (_iterator.next_seg != _lease->range.end()) {
-        _iterator.reader = std::make_unique<log_segment_batch_reader>(
-          **_iterator.next_seg, _config, _probe);
-        _iterator.current_reader_seg = _iterator.next_seg;
-    }
+    ss::future<> f = ss::make_ready_future<>();
     if (tmp_reader) {
         auto raw = tmp_reader.get();
-        return raw->close().finally([r = std::move(tmp_reader)] {});
+        f = raw->close().finally([r = std::move(tmp_reader)] {});
+    }
+    if (_iterator.next_seg == _lease->range.end()) {
+        return f.then([this] { return _iterator.close_prefetched(); });
     }
-    return ss::make_ready_future<>();
+    if (
+      _iterator.prefetched
+      && _iterator.prefetched_seg == _iterator.next_seg) {
+        // the next segment is already locked and its stream open
+        return f.then([this] {
+            _lease->locks.clear();
+            _lease->locks.push_back(std::move(*_iterator.prefetched_lock));
+            _iterator.prefetched_lock.reset();
+            _iterator.reader = std::move(_iterator.prefetched);
+            _iterator.current_reader_seg = _iterator.next_seg;
+        });
+    }
+    return f.then([this] { return _iterator.close_prefetched(); })
+      .then([this] {
+          // the previous segment is done with, only the next one is locked
+          _lease->locks.clear();
+          return (*_iterator.next_seg)->read_lock();
+      })
+      .then([this](ss::rwlock::holder h) {
+          if ((*_iterator.next_seg)->is_closed()) {
+              // removed or replaced after the lease was taken, the read stops
+              // short and the reader is not reused
+              set_end_of_stream();
+              return;
+          }
+          _lease->locks.push_back(std::move(h));
+          _iterator.reader = std::make_unique<log_segment_batch_reader>(
+            **_iterator.next_seg, _config, _probe, _sequential_bytes);
+          _iterator.current_reader_seg = _iterator.next_seg;
+      });
 }
 
 ss::future<log_reader::storage_t>
@@ -294,7 +396,13 @@ log_reader::do_load_slice(model::timeout_clock::time_point timeout) {
         return fut.then([] { return ss::make_ready_future<storage_t>(); });
     }
     return fut
-      .then([this, timeout] { return _iterator.reader->read_some(timeout); })
+      .then([this, timeout] {
+          if (is_end_of_stream()) {
+              // the next segment was closed while waiting for its lock
+              return ss::make_ready_future<result<records_t>>(records_t{});
+          }
+          return _iterator.reader->read_some(timeout);
+      })
       .then([this, timeout](result<records_t> recs) -> ss::future<storage_t> {
           if (!recs) {
               set_end_of_stream();
@@ -316,7 +424,10 @@ log_reader::do_load_slice(model::timeout_clock::time_point timeout) {
               return do_load_slice(timeout);
           }
           _probe.add_batches_read(recs.value().size());
-          return ss::make_ready_future<storage_t>(std::move(recs.value()));
+          return maybe_prefetch_next_segment().then(
+            [recs = std::move(recs.value())]() mutable {
+                return storage_t(std::move(recs));
+            });
       })
       .handle_exception([this](std::exception_ptr e) {
           set_end_of_stream();
@@ -326,6 +437,53 @@ log_reader::do_load_slice(model::timeout_clock::time_point timeout) {
       });
 }
 
+ss::future<> log_reader::maybe_prefetch_next_segment() {
+    if (
+      is_end_of_stream() || _iterator.prefetched || !_iterator.reader
+      || _config.read_ahead) {
+        return ss::now();
+    }
+    auto next = std::next(_iterator.next_seg);
+    if (next == _lease->range.end() || (*next)->has_appender()) {
+        // the readers tailing the log are served by the batch cache
+        return ss::now();
+    }
+    // only the readers that read ahead are sequential enough to prefetch
+    const auto window = read_ahead::for_progress(
+      _sequential_bytes + _config.bytes_consumed);
+    if (window.depth == 0) {
+        return ss::now();
+    }
+    auto& seg = **_iterator.next_seg;
+    auto nearest = seg.index().find_nearest(_config.start_offset);
+    const size_t position = nearest ? nearest->filepos : 0;
+    if (position + window.memory() < seg.size_bytes()) {
+        // not in the tail of the segment yet
+        return ss::now();
+    }
+    // a segment locked for a destructive operation is not waited for
+    return (*next)
+      ->read_lock(ss::semaphore::clock::now())
+      .then_wrapped([this, next](ss::future<ss::rwlock::holder> f) {
+          if (f.failed()) {
+              f.ignore_ready_future();
+              return;
+          }
+          auto h = f.get();
+          if (
+            (*next)->is_closed() || _iterator.prefetched
+            || !(*next)->index().is_materialized()) {
+              return;
+          }
+          _iterator.prefetched = std::make_unique<log_segment_batch_reader>(
+            **next, _config, _probe, _sequential_bytes);
+          _iterator.prefetched->prefetch((*next)->offsets().base_offset);
+          _iterator.prefetched_seg = next;
+          _iterator.prefetched_lock = std::move(h);
+          _probe.segment_prefetched();
+      });
+}
+
 static inline bool is_finished_offset(segment_set& s, model::offset o) {
     if (s.empty()) {
         return true;
@@ -17,6 +17,7 @@
 #include "storage/lock_manager.h"
 #include "storage/parser.h"
 #include "storage/probe.h"
+#include "storage/read_ahead.h"
 #include "storage/segment_reader.h"
 #include "storage/segment_set.h"
 #include "storage/types.h"
@@ -90,8 +91,13 @@ class log_segment_batch_reader {
 public:
     static constexpr size_t max_buffer_size = 32 * 1024; // 32KB
 
+    /// \param sequential_bytes the bytes the log reader read before its
+    /// current configuration, they size the read-ahead
     log_segment_batch_reader(
-      segment&, log_reader_config& config, probe& p) noexcept;
+      segment&,
+      log_reader_config& config,
+      probe& p,
+      const size_t& sequential_bytes) noexcept;
     log_segment_batch_reader(log_segment_batch_reader&&) noexcept = default;
     log_segment_batch_reader&
     operator=(log_segment_batch_reader&&) noexcept = delete;
@@ -103,6 +109,11 @@ public:
     ss::future<result<ss::circular_buffer<model::record_batch>>>
       read_some(model::timeout_clock::time_point);
 
+    /// \brief opens the data stream at the offset and issues its first read
+    /// before the reader is used. The stream is used if the reader starts at
+    /// the same position
+    void prefetch(model::offset);
+
     ss::future<> close();
 
 private:
@@ -110,7 +121,13 @@ private:
       model::timeout_clock::time_point,
       std::optional<model::offset> next_cached_batch);
 
+    ss::future<result<ss::circular_buffer<model::record_batch>>>
+    read_iterator();
+
     void add_one(model::record_batch&&);
+    size_t sequential_bytes() const {
+        return _sequential_bytes + _config.bytes_consumed;
+    }
 
 private:
     struct tmp_state {
@@ -119,10 +136,20 @@ private:
         bool is_full() const { return buffer_size >= max_buffer_size; }
     };
 
+    struct prefetched_stream {
+        size_t position;
+        ss::input_stream<char> input;
+    };
+
+    size_t stream_position(model::offset) const;
+
     segment& _seg;
     log_reader_config& _config;
     probe& _probe;
+    const size_t& _sequential_bytes;
 
+    read_ahead _read_ahead;
+    std::optional<prefetched_stream> _prefetched;
     std::unique_ptr<continuous_batch_parser> _iterator;
     tmp_state _state;
     friend class skipping_consumer;
@@ -139,6 +166,8 @@ public:
 
     ~log_reader() final {
         vassert(!_iterator.reader, "log reader destroyed with live reader");
+        vassert(
+          !_iterator.prefetched, "log reader destroyed with live prefetch");
     }
 
     bool is_end_of_stream() const final {
@@ -165,6 +194,8 @@ public:
      * 3. read next chunk of batches
      */
     void reset_config(log_reader_config cfg) {
+        // the reader is reused for the read that continues where it stopped
+        _sequential_bytes += _config.bytes_consumed;
         _config = cfg;
         _iterator.next_seg = _iterator.current_reader_seg;
     };
@@ -208,8 +239,9 @@ private:
     bool is_done();
     ss::future<> find_next_valid_iterator();
 
-    using reader_available = ss::bool_class<struct create_reader_tag>;
-    reader_available maybe_create_segment_reader();
+    /// \brief opens the reader of the next segment while the tail of the
+    /// current one is consumed, for the readers that read sequentially
+    ss::future<> maybe_prefetch_next_segment();
 
 private:
     struct iterator_pair {
@@ -219,11 +251,27 @@ private:
         segment_set::iterator next_seg;
         segment_set::iterator current_reader_seg;
         std::unique_ptr<log_segment_batch_reader> reader = nullptr;
+        /// the reader of the segment after next_seg, opened ahead with the
+        /// segment locked
+        std::unique_ptr<log_segment_batch_reader> prefetched = nullptr;
+        segment_set::iterator prefetched_seg;
+        std::optional<ss::rwlock::holder> prefetched_lock;
 
         explicit operator bool() { return bool(reader); }
         ss::future<> close() {
-            if (reader) {
-                return reader->close().then([this] { reader = nullptr; });
+            return close_prefetched().then([this] {
+                if (reader) {
+                    return reader->close().then([this] { reader = nullptr; });
+                }
+                return ss::make_ready_future<>();
+            });
+        }
+        ss::future<> close_prefetched() {
+            if (prefetched) {
+                return prefetched->close().then([this] {
+                    prefetched = nullptr;
+                    prefetched_lock.reset();
+                });
             }
             return ss::make_ready_future<>();
         }
@@ -234,6 +282,8 @@ private:
     std::unique_ptr<lock_manager::lease> _lease;
     iterator_pair _iterator;
     log_reader_config _config;
+    // bytes read before the current configuration
+    size_t _sequential_bytes{0};
     model::offset _last_base;
     probe& _probe;
     ss::abort_source::subscription _as_sub;
@@ -7,6 +7,7 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 
+#include "config/configuration.h"
 #include "likely.h"
 #include "model/fundamental.h"
 #include "model/record.h"
@@ -14,6 +15,7 @@
 #include "model/timeout_clock.h"
 #include "model/timestamp.h"
 #include "seastarx.h"
+#include "storage/compaction_reducers.h"
 #include "storage/log.h"
 #include "storage/logger.h"
 #include "storage/types.h"
@@ -21,6 +23,7 @@
 
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/circular_buffer.hh>
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/lowres_clock.hh>
@@ -55,7 +58,8 @@ struct mem_probe {
 };
 
 struct mem_log_impl;
-// makes a copy of every batch starting at some iterator
+// shares every batch starting at some offset. The position is an offset,
+// not an iterator: the batches are appended and evicted while it reads
 class mem_iter_reader final
   : public model::record_batch_reader::impl
   , public boost::intrusive::list_base_hook<> {
@@ -64,15 +68,14 @@ public:
     using foreign_data_t = model::record_batch_reader::foreign_data_t;
     using storage_t = model::record_batch_reader::storage_t;
     using underlying_t = std::deque<model::record_batch>;
-    using iterator = typename underlying_t::iterator;
     mem_iter_reader(
       boost::intrusive::list<mem_iter_reader>& hook,
-      iterator begin,
-      iterator end,
+      const underlying_t& data,
+      model::offset start,
       model::offset eof)
       : _hook(hook)
-      , _cur(begin)
-      , _end(end)
+      , _data(data)
+      , _next(start)
       , _endoffset(eof) {
         _hook.get().push_back(*this);
     }
@@ -85,16 +88,20 @@ public:
     }
 
     bool is_end_of_stream() const final {
-        return _end_of_stream || _cur == _end
-               || _cur->base_offset() > _endoffset;
+        if (_end_of_stream) {
+            return true;
+        }
+        auto it = next();
+        return it == _data.get().end() || it->base_offset() > _endoffset;
     }
 
     ss::future<storage_t>
     do_load_slice(model::timeout_clock::time_point) final {
         data_t ret;
         if (!is_end_of_stream()) {
-            ret.push_back(_cur->share());
-            _cur = std::next(_cur);
+            auto it = next();
+            ret.push_back(it->share());
+            _next = it->last_offset() + model::offset(1);
         } else {
             _end_of_stream = true;
         }
@@ -107,16 +114,18 @@ public:
 
     model::offset end_offset() { return _endoffset; }
 
-    iterator end() { return _end; }
-
     void invalidate() { _end_of_stream = true; }
 
 private:
+    underlying_t::const_iterator next() const {
+        return std::lower_bound(
+          _data.get().begin(), _data.get().end(), _next, entries_ordering{});
+    }
+
     bool _end_of_stream = false;
     std::reference_wrapper<boost::intrusive::list<mem_iter_reader>> _hook;
-    std::optional<model::record_batch> _data;
-    iterator _cur;
-    iterator _end;
+    std::reference_wrapper<const underlying_t> _data;
+    model::offset _next;
     model::offset _endoffset;
 };
 
@@ -183,6 +192,13 @@ struct mem_log_impl final : log::impl {
         }
         return ss::make_ready_future<ret_t>();
     }
+    ss::future<std::optional<key_query_result>>
+    key_query(key_query_config cfg) final {
+        auto reader = co_await make_reader(log_reader_config(
+          offsets().start_offset, cfg.max_offset, cfg.prio));
+        co_return co_await std::move(reader).consume(
+          internal::key_query_reducer(std::move(cfg.key)), model::no_timeout);
+    }
     ss::future<> truncate_prefix(truncate_prefix_config cfg) final {
         stlog.debug("PREFIX Truncating {} log at {}", config().ntp(), cfg);
         if (_data.empty()) {
@@ -280,6 +296,49 @@ struct mem_log_impl final : log::impl {
         return ss::now();
     }
 
+    /// \brief the bytes retained by the log of a memory backed topic, the
+    /// oldest batches are evicted past them
+    std::optional<size_t> capacity() const {
+        if (!config().is_memory_backed()) {
+            return std::nullopt;
+        }
+        const auto& retention = config().get_overrides().retention_bytes;
+        if (retention.has_value()) {
+            return retention.value();
+        }
+        return config::shard_local_cfg().memory_log_retention_bytes();
+    }
+
+    /// \brief evicts the oldest batches of a log over its capacity. Like the
+    /// retention of a log on disk, raft is notified of the eviction and the
+    /// batches are removed once they are collectible: the log is over its
+    /// capacity until then. The last batch is kept for the offsets of the log
+    void evict_over_capacity() {
+        const auto max = capacity();
+        if (!max || _probe.partition_bytes <= *max || _data.size() < 2) {
+            return;
+        }
+        size_t bytes = _probe.partition_bytes;
+        model::offset evicted;
+        for (auto it = _data.begin();
+             bytes > *max && std::next(it) != _data.end();
+             ++it) {
+            bytes -= it->size_bytes();
+            evicted = it->last_offset();
+        }
+        if (_eviction_monitor) {
+            _eviction_monitor->promise.set_value(evicted);
+            _eviction_monitor.reset();
+        }
+        const auto collectible = std::min(evicted, _max_collectible_offset);
+        auto it = _data.begin();
+        while (it != _data.end() && it->last_offset() <= collectible) {
+            _probe.remove_bytes_written(it->size_bytes());
+            ++it;
+        }
+        _data.erase(_data.begin(), it);
+    }
+
     ss::future<model::offset> monitor_eviction(ss::abort_source& as) final {
         if (_eviction_monitor) {
             throw std::logic_error("Eviction promise already registered. "
@@ -316,15 +375,9 @@ struct mem_log_impl final : log::impl {
 
     ss::future<model::record_batch_reader>
     make_reader(log_reader_config cfg) final {
-        auto it = std::lower_bound(
-          std::begin(_data),
-          std::end(_data),
-          cfg.start_offset,
-          entries_ordering{});
-
         auto reader = model::record_batch_reader(
           std::make_unique<mem_iter_reader>(
-            _readers, it, _data.end(), cfg.max_offset));
+            _readers, _data, cfg.start_offset, cfg.max_offset));
         return ss::make_ready_future<model::record_batch_reader>(
           std::move(reader));
     }
@@ -351,6 +404,31 @@ struct mem_log_impl final : log::impl {
         return std::nullopt;
     }
 
+    std::optional<term_end_result> term_end(model::term_id term) const final {
+        if (_data.empty()) {
+            return std::nullopt;
+        }
+        auto it = std::upper_bound(
+          std::cbegin(_data),
+          std::cend(_data),
+          term,
+          [](model::term_id t, const model::record_batch& b) {
+              return t < b.term();
+          });
+        if (it == _data.end()) {
+            return term_end_result{
+              .term = _data.back().term(),
+              .end_offset = _data.back().last_offset() + model::offset(1),
+            };
+        }
+        if (it == _data.begin()) {
+            return term_end_result{
+              .term = term, .end_offset = it->base_offset()};
+        }
+        return term_end_result{
+          .term = std::prev(it)->term(), .end_offset = it->base_offset()};
+    }
+
     size_t segment_count() const final { return 1; }
 
     storage::offset_stats offsets() const final {
@@ -420,6 +498,7 @@ ss::future<append_result> mem_log_appender::end_of_stream() {
       .last_offset = _cur_offset - model::offset(1),
       .byte_size = _byte_size,
       .last_term = _log._data.back().term()};
+    _log.evict_over_capacity();
     return ss::make_ready_future<append_result>(ret);
 }
 
@@ -10,6 +10,7 @@
  */
 
 #pragma once
+#include "model/compression.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
 #include "ssx/sformat.h"
@@ -38,6 +39,23 @@ public:
         tristate<std::chrono::milliseconds> retention_time{std::nullopt};
         // if set, log will not use batch cache
         with_cache cache_enabled = with_cache::yes;
+        // if not set the log is on disk, unless the log_manager's
+        // configuration is for memory
+        std::optional<model::storage_engine> storage_engine;
+        // codec the cold segments are recompressed with, if the log_manager's
+        // configuration enables it
+        std::optional<model::compression> compression;
+        // if set, the leader flushes the batches it appended without waiting
+        // for a quorum once they are this old or this many bytes. If not set
+        // they are flushed along the next quorum write or segment roll
+        std::optional<std::chrono::milliseconds> flush_ms;
+        std::optional<size_t> flush_bytes;
+        // if set, the log of a new partition is restored from the cloud
+        // storage before it is opened
+        bool recovery{false};
+        // if set, the partition is a read replica of the partition archived
+        // into this bucket by another cluster, its log holds no data
+        std::optional<ss::sstring> read_replica_bucket;
 
         friend std::ostream&
         operator<<(std::ostream&, const default_overrides&);
@@ -100,6 +118,12 @@ public:
                == model::cleanup_policy_bitflags::deletion;
     }
 
+    /// \brief the log is in memory, retained up to retention_bytes
+    bool is_memory_backed() const {
+        return _overrides && _overrides->storage_engine
+               && *_overrides->storage_engine == model::storage_engine::memory;
+    }
+
     ss::sstring work_directory() const {
         return ssx::sformat("{}/{}_{}", _base_dir, _ntp.path(), _revision_id);
     }
@@ -108,6 +132,26 @@ public:
         return std::filesystem::path(_base_dir) / _ntp.topic_path();
     }
 
+    std::optional<std::chrono::milliseconds> flush_ms() const {
+        return _overrides ? _overrides->flush_ms : std::nullopt;
+    }
+
+    std::optional<size_t> flush_bytes() const {
+        return _overrides ? _overrides->flush_bytes : std::nullopt;
+    }
+
+    bool is_recovery_enabled() const {
+        return _overrides && _overrides->recovery;
+    }
+
+    bool is_read_replica() const {
+        return _overrides && _overrides->read_replica_bucket.has_value();
+    }
+
+    std::optional<ss::sstring> get_read_replica_bucket() const {
+        return _overrides ? _overrides->read_replica_bucket : std::nullopt;
+    }
+
     with_cache cache_enabled() const {
         return with_cache(!has_overrides() || _overrides->cache_enabled);
     }
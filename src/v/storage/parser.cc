@@ -118,14 +118,12 @@ ss::future<result<stop_parser>> continuous_batch_parser::consume_header() {
             _consumer->skip_batch_start(
               *_header, _physical_base_offset, _header->size_bytes);
             _physical_base_offset += _header->size_bytes;
-            auto remaining = _header->size_bytes
-                             - model::packed_record_batch_header_size;
-            auto b = co_await verify_read_iobuf(
-              _input, remaining, "parser::skip_batch");
-
-            if (!b) {
-                co_return b.error();
-            }
+            // the body is never looked at, the stream is advanced past it
+            // without reading it to memory. the buffered bytes are dropped
+            // and the file stream doesn't read the skipped range unless it
+            // was already read ahead
+            co_await _input.skip(
+              _header->size_bytes - model::packed_record_batch_header_size);
             // start again
             add_bytes_and_reset();
             continue;
@@ -136,22 +134,25 @@ ss::future<result<stop_parser>> continuous_batch_parser::consume_header() {
 
 ss::future<result<model::record_batch_header>>
 continuous_batch_parser::read_header() {
-    auto b = co_await read_iobuf_exactly(
-      _input, model::packed_record_batch_header_size);
+    // shares the buffer of the stream unless the header straddles two
+    auto buf = co_await _input.read_exactly(
+      model::packed_record_batch_header_size);
 
-    if (b.empty()) {
+    if (buf.empty()) {
         // benign outcome. happens at end of file
         co_return parser_errc::end_of_stream;
     }
-    if (b.size_bytes() != model::packed_record_batch_header_size) {
+    if (buf.size() != model::packed_record_batch_header_size) {
         stlog.error(
           "Could not parse header. Expected:{}, but Got:{}. consumer:{}",
           model::packed_record_batch_header_size,
-          b.size_bytes(),
+          buf.size(),
           *_consumer);
         co_return parser_errc::input_stream_not_enough_bytes;
     }
 
+    iobuf b;
+    b.append(std::move(buf));
     auto header = header_from_iobuf(std::move(b));
 
     if (unlikely(header.header_crc == 0)) {
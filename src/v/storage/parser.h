@@ -36,7 +36,8 @@ public:
     using stop_parser = ss::bool_class<struct stop_parser_tag>;
     /**
      * Consume results informs parser what it the expected outcome of consume
-     * batch start decision
+     * batch start decision. The records of a skipped batch are not read to
+     * memory, the parser advances the input stream past them.
      */
     enum class consume_result : int8_t {
         accept_batch, // accept batch
@@ -9,7 +9,7 @@
 
 #include "storage/parser_utils.h"
 
-#include "compression/compression.h"
+#include "compression/async_compressor.h"
 #include "model/compression.h"
 #include "model/record.h"
 #include "model/record_utils.h"
@@ -37,7 +37,9 @@ ss::future<model::record_batch> decompress_batch(model::record_batch&& b) {
     if (!b.compressed()) {
         return ss::make_ready_future<model::record_batch>(std::move(b));
     }
-    return decompress_batch(b);
+    return ss::do_with(std::move(b), [](model::record_batch& b) {
+        return decompress_batch(b);
+    });
 }
 
 ss::future<model::record_batch> decompress_batch(const model::record_batch& b) {
@@ -48,15 +50,16 @@ ss::future<model::record_batch> decompress_batch(const model::record_batch& b) {
             "Asked to decompressed a non-compressed batch:{}",
             b.header())));
     }
-    iobuf body_buf = compression::compressor::uncompress(
-      b.data(), b.header().attrs.compression());
-    // must remove compression first!
-    auto h = b.header();
-    h.attrs.remove_compression();
-    reset_size_checksum_metadata(h, body_buf);
-    auto batch = model::record_batch(
-      h, std::move(body_buf), model::record_batch::tag_ctor_ng{});
-    return ss::make_ready_future<model::record_batch>(std::move(batch));
+    // large payloads are decompressed in the background
+    return compression::async_compressor::uncompress(
+             b.data(), b.header().attrs.compression())
+      .then([h = b.header()](iobuf body_buf) mutable {
+          // must remove compression first!
+          h.attrs.remove_compression();
+          reset_size_checksum_metadata(h, body_buf);
+          return model::record_batch(
+            h, std::move(body_buf), model::record_batch::tag_ctor_ng{});
+      });
 }
 
 compress_batch_consumer::compress_batch_consumer(
@@ -100,14 +103,15 @@ compress_batch(model::compression c, const model::record_batch& b) {
       "Asked to compress a batch with type `none`: {} - {}",
       c,
       b.header());
-    auto payload = compression::compressor::compress(b.data(), c);
-    auto h = b.header();
-    // compression bit must be set first!
-    h.attrs |= c;
-    reset_size_checksum_metadata(h, payload);
-    auto batch = model::record_batch(
-      h, std::move(payload), model::record_batch::tag_ctor_ng{});
-    return ss::make_ready_future<model::record_batch>(std::move(batch));
+    // large payloads are compressed in the background
+    return compression::async_compressor::compress(b.data(), c)
+      .then([c, h = b.header()](iobuf payload) mutable {
+          // compression bit must be set first!
+          h.attrs |= c;
+          reset_size_checksum_metadata(h, payload);
+          return model::record_batch(
+            h, std::move(payload), model::record_batch::tag_ctor_ng{});
+      });
 }
 
 /// \brief resets the size, header crc and payload crc
@@ -42,13 +42,13 @@ private:
 
 /// \brief batch decompression
 ss::future<model::record_batch> decompress_batch(model::record_batch&&);
-/// \brief batch decompression
+/// \brief batch decompression, the batch must outlive the future
 ss::future<model::record_batch> decompress_batch(const model::record_batch&);
 
 /// \brief batch compression
 ss::future<model::record_batch>
 compress_batch(model::compression, model::record_batch&&);
-/// \brief batch compression
+/// \brief batch compression, the batch must outlive the future
 ss::future<model::record_batch>
 compress_batch(model::compression, const model::record_batch&);
 
@@ -13,6 +13,7 @@
 #include "prometheus/prometheus_sanitize.h"
 #include "storage/readers_cache_probe.h"
 #include "storage/segment.h"
+#include "utils/aggregate_metrics.h"
 
 #include <seastar/core/metrics.hh>
 
@@ -23,102 +24,222 @@ void probe::setup_metrics(const model::ntp& ntp) {
     }
 
     namespace sm = ss::metrics;
+    using type = metric_spec::type;
     auto ns_label = sm::label("namespace");
     auto topic_label = sm::label("topic");
     auto partition_label = sm::label("partition");
+    auto group = prometheus_sanitize::metrics_name("storage:log");
+
+    std::vector<metric_spec> metrics = {
+      {.name = "written_bytes",
+       .kind = type::total_bytes,
+       .description = "Total number of bytes written",
+       .value = [this] { return _bytes_written; }},
+      {.name = "batches_written",
+       .kind = type::counter,
+       .description = "Total number of batches written",
+       .value = [this] { return _batches_written; }},
+      {.name = "read_bytes",
+       .kind = type::total_bytes,
+       .description = "Total number of bytes read",
+       .value = [this] { return _bytes_read; }},
+      {.name = "cached_read_bytes",
+       .kind = type::total_bytes,
+       .description = "Total number of cached bytes read",
+       .value = [this] { return _cached_bytes_read; }},
+      {.name = "batches_read",
+       .kind = type::counter,
+       .description = "Total number of batches read",
+       .value = [this] { return _batches_read; }},
+      {.name = "cached_batches_read",
+       .kind = type::counter,
+       .description = "Total number of cached batches read",
+       .value = [this] { return _cached_batches_read; }},
+      {.name = "segments_prefetched",
+       .kind = type::counter,
+       .description = "Number of segments opened by sequential readers "
+                      "before reaching them",
+       .value = [this] { return _segments_prefetched; }},
+      {.name = "log_segments_created",
+       .kind = type::counter,
+       .description = "Number of created log segments",
+       .value = [this] { return _log_segments_created; }},
+      {.name = "log_segments_removed",
+       .kind = type::counter,
+       .description = "Number of removed log segments",
+       .value = [this] { return _log_segments_removed; }},
+      {.name = "log_segments_active",
+       .kind = type::counter,
+       .description = "Number of active log segments",
+       .value = [this] { return _log_segments_active; }},
+      {.name = "batch_parse_errors",
+       .kind = type::counter,
+       .description = "Number of batch parsing (reading) errors",
+       .value = [this] { return _batch_parse_errors; }},
+      {.name = "batch_write_errors",
+       .kind = type::counter,
+       .description = "Number of batch write errors",
+       .value = [this] { return _batch_write_errors; }},
+      {.name = "corrupted_compaction_indices",
+       .kind = type::counter,
+       .description = "Number of times we had to re-construct the "
+                      ".compaction index on a segment",
+       .value = [this] { return _corrupted_compaction_index; }},
+      {.name = "compacted_segment",
+       .kind = type::counter,
+       .description = "Number of compacted segments",
+       .value = [this] { return _segment_compacted; }},
+      {.name = "recompressed_segment",
+       .kind = type::counter,
+       .description = "Number of segments rewritten with the compression "
+                      "codec of their topic",
+       .value = [this] { return _segment_recompressed; }},
+      {.name = "partition_size",
+       .kind = type::gauge,
+       .description = "Current size of partition in bytes",
+       .value = [this] { return _partition_bytes; }},
+    };
+
+    if (config::shard_local_cfg().aggregate_partition_metrics(ntp.tp.topic)) {
+        _aggregate = aggregate_metrics::local().add(
+          group,
+          {ns_label(ntp.ns()), topic_label(ntp.tp.topic())},
+          std::move(metrics));
+        return;
+    }
+
     const std::vector<sm::label_instance> labels = {
       ns_label(ntp.ns()),
       topic_label(ntp.tp.topic()),
       partition_label(ntp.tp.partition()),
     };
-
+    _metrics.add_group(group, make_metric_definitions(metrics, labels));
+    // the ratio and the lag can't be summed, they are exported only per
+    // partition
     _metrics.add_group(
-      prometheus_sanitize::metrics_name("storage:log"),
+      group,
       {
         sm::make_total_bytes(
-          "written_bytes",
-          [this] { return _bytes_written; },
-          sm::description("Total number of bytes written"),
-          labels),
-        sm::make_derive(
-          "batches_written",
-          [this] { return _batches_written; },
-          sm::description("Total number of batches written"),
-          labels),
-        sm::make_total_bytes(
-          "read_bytes",
-          [this] { return _bytes_read; },
-          sm::description("Total number of bytes read"),
-          labels),
-        sm::make_total_bytes(
-          "cached_read_bytes",
-          [this] { return _cached_bytes_read; },
-          sm::description("Total number of cached bytes read"),
-          labels),
-        sm::make_derive(
-          "batches_read",
-          [this] { return _batches_read; },
-          sm::description("Total number of batches read"),
-          labels),
-        sm::make_derive(
-          "cached_batches_read",
-          [this] { return _cached_batches_read; },
-          sm::description("Total number of cached batches read"),
-          labels),
-        sm::make_derive(
-          "log_segments_created",
-          [this] { return _log_segments_created; },
-          sm::description("Number of created log segments"),
+          "compaction_ratio",
+          [this] { return _compaction_ratio; },
+          sm::description("Average segment compaction ratio"),
           labels),
-        sm::make_derive(
-          "log_segments_removed",
-          [this] { return _log_segments_removed; },
-          sm::description("Number of removed log segments"),
+        sm::make_gauge(
+          "compaction_lag_ms",
+          [this] {
+              if (!_compaction_pending_since) {
+                  return int64_t(0);
+              }
+              return static_cast<int64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                  ss::lowres_clock::now() - *_compaction_pending_since)
+                  .count());
+          },
+          sm::description("Time the oldest sealed data not compacted yet has "
+                          "waited for compaction"),
           labels),
+      });
+}
+
+void probe::add_initial_segment(const segment& s) {
+    add_partition_bytes(s.reader().file_size());
+}
+void probe::delete_segment(const segment& s) {
+    remove_partition_bytes(s.reader().file_size());
+}
+
+void batch_cache_probe::setup_metrics(
+  size_fn size_bytes, size_fn protected_size_bytes) {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    auto segment_label = sm::label("segment");
+    const std::vector<sm::label_instance> probationary = {
+      segment_label("probationary")};
+    const std::vector<sm::label_instance> protected_segment = {
+      segment_label("protected")};
+
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:batch_cache"),
+      {
         sm::make_derive(
-          "log_segments_active",
-          [this] { return _log_segments_active; },
-          sm::description("Number of active log segments"),
-          labels),
+          "hits",
+          [this] { return _probationary_hits; },
+          sm::description("Number of batch cache hits"),
+          probationary),
         sm::make_derive(
-          "batch_parse_errors",
-          [this] { return _batch_parse_errors; },
-          sm::description("Number of batch parsing (reading) errors"),
-          labels),
+          "hits",
+          [this] { return _protected_hits; },
+          sm::description("Number of batch cache hits"),
+          protected_segment),
+        sm::make_gauge(
+          "hit_ratio",
+          [this] { return probationary_hit_ratio(); },
+          sm::description("Fraction of batch cache lookups served by the "
+                          "segment of the cache"),
+          probationary),
+        sm::make_gauge(
+          "hit_ratio",
+          [this] { return protected_hit_ratio(); },
+          sm::description("Fraction of batch cache lookups served by the "
+                          "segment of the cache"),
+          protected_segment),
         sm::make_derive(
-          "batch_write_errors",
-          [this] { return _batch_write_errors; },
-          sm::description("Number of batch write errors"),
-          labels),
+          "misses",
+          [this] { return _misses; },
+          sm::description("Number of batch cache misses")),
         sm::make_derive(
-          "corrupted_compaction_indices",
-          [this] { return _corrupted_compaction_index; },
-          sm::description("Number of times we had to re-construct the "
-                          ".compaction index on a segment"),
-          labels),
+          "promotions",
+          [this] { return _promotions; },
+          sm::description(
+            "Number of ranges promoted to the protected segment")),
         sm::make_derive(
-          "compacted_segment",
-          [this] { return _segment_compacted; },
-          sm::description("Number of compacted segments"),
-          labels),
+          "demotions",
+          [this] { return _demotions; },
+          sm::description(
+            "Number of ranges demoted to the probationary segment")),
         sm::make_gauge(
-          "partition_size",
-          [this] { return _partition_bytes; },
-          sm::description("Current size of partition in bytes"),
-          labels),
-        sm::make_total_bytes(
-          "compaction_ratio",
-          [this] { return _compaction_ratio; },
-          sm::description("Average segment compaction ratio"),
-          labels),
+          "size_bytes",
+          [fn = std::move(size_bytes)] { return fn(); },
+          sm::description("Memory used by the batch cache")),
+        sm::make_gauge(
+          "protected_size_bytes",
+          [fn = std::move(protected_size_bytes)] { return fn(); },
+          sm::description(
+            "Memory used by the protected segment of the batch cache")),
       });
 }
 
-void probe::add_initial_segment(const segment& s) {
-    _partition_bytes += s.reader().file_size();
-}
-void probe::delete_segment(const segment& s) {
-    _partition_bytes -= s.reader().file_size();
+void segment_roll_probe::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    auto staged_label = sm::label("staged");
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:segment_roll"),
+      {
+        sm::make_histogram(
+          "latency_us",
+          [this] { return _latency.seastar_histogram_logform(); },
+          sm::description("Latency of the segment rolls of the appends")),
+        sm::make_derive(
+          "rolls",
+          [this] { return _staged_rolls; },
+          sm::description("Number of segment rolls"),
+          {staged_label("true")}),
+        sm::make_derive(
+          "rolls",
+          [this] { return _unstaged_rolls; },
+          sm::description("Number of segment rolls"),
+          {staged_label("false")}),
+        sm::make_derive(
+          "staging_errors",
+          [this] { return _staging_errors; },
+          sm::description(
+            "Number of failures to stage the files of the next segment")),
+      });
 }
 
 void readers_cache_probe::setup_metrics(const model::ntp& ntp) {
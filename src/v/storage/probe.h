@@ -11,19 +11,26 @@
 
 #pragma once
 #include "model/fundamental.h"
+#include "storage/disk_usage.h"
 #include "storage/fwd.h"
 #include "storage/logger.h"
+#include "utils/aggregate_metrics.h"
+#include "utils/hdr_hist.h"
 
+#include <seastar/core/lowres_clock.hh>
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <optional>
 
 namespace storage {
 class probe {
 public:
     void add_bytes_written(uint64_t written) {
-        _partition_bytes += written;
+        add_partition_bytes(written);
         _bytes_written += written;
     }
 
@@ -48,6 +55,8 @@ public:
 
     void segment_compacted() { ++_segment_compacted; }
 
+    void segment_recompressed() { ++_segment_recompressed; }
+
     void batch_write_error(const std::exception_ptr& e) {
         stlog.error("Error writing record batch {}", e);
         ++_batch_write_errors;
@@ -60,16 +69,44 @@ public:
 
     void batch_parse_error() { ++_batch_parse_errors; }
 
+    void segment_prefetched() { ++_segments_prefetched; }
+
     void setup_metrics(const model::ntp&);
 
     void delete_segment(const segment&);
 
     size_t partition_size() const { return _partition_bytes; }
     void add_initial_segment(const segment&);
-    void remove_partition_bytes(size_t remove) { _partition_bytes -= remove; }
+    void remove_partition_bytes(size_t remove) {
+        _partition_bytes -= remove;
+        _disk_usage.remove(remove);
+    }
     void set_compaction_ration(double r) { _compaction_ratio = r; }
 
+    /// \brief sealed data waits for compaction from now on, unless it
+    /// already did
+    void compaction_pending() {
+        if (!_compaction_pending_since) {
+            _compaction_pending_since = ss::lowres_clock::now();
+        }
+    }
+    /// \brief all the sealed data is compacted
+    void compaction_caught_up() { _compaction_pending_since.reset(); }
+
+    /// \brief the size of the partition is accounted in the usage from now on
+    void set_disk_usage(disk_usage::log_usage u) {
+        _disk_usage = u;
+        _disk_usage.add(_partition_bytes);
+    }
+    disk_usage::log_usage& get_disk_usage() { return _disk_usage; }
+
 private:
+    void add_partition_bytes(size_t add) {
+        _partition_bytes += add;
+        _disk_usage.add(add);
+    }
+
+
     uint64_t _partition_bytes = 0;
     uint64_t _bytes_written = 0;
     uint64_t _bytes_read = 0;
@@ -78,8 +115,10 @@ private:
     uint64_t _batches_written = 0;
     uint64_t _batches_read = 0;
     uint64_t _cached_batches_read = 0;
+    uint64_t _segments_prefetched = 0;
 
     uint32_t _segment_compacted = 0;
+    uint32_t _segment_recompressed = 0;
     uint32_t _corrupted_compaction_index = 0;
     uint32_t _log_segments_created = 0;
     uint32_t _log_segments_removed = 0;
@@ -87,6 +126,78 @@ private:
     uint32_t _batch_parse_errors = 0;
     uint32_t _batch_write_errors = 0;
     double _compaction_ratio = 1.0;
+    std::optional<ss::lowres_clock::time_point> _compaction_pending_since;
+    disk_usage::log_usage _disk_usage;
+    ss::metrics::metric_groups _metrics;
+    aggregate_metrics::registration _aggregate;
+};
+
+/**
+ * Shard wide batch cache statistics. Hits are tracked separately for the
+ * probationary and protected segments of the cache.
+ */
+class batch_cache_probe {
+public:
+    using size_fn = std::function<size_t()>;
+
+    void probationary_hit() { ++_probationary_hits; }
+    void protected_hit() { ++_protected_hits; }
+    void cache_miss() { ++_misses; }
+    void promotion() { ++_promotions; }
+    void demotion() { ++_demotions; }
+
+    uint64_t get_probationary_hits() const { return _probationary_hits; }
+    uint64_t get_protected_hits() const { return _protected_hits; }
+    uint64_t get_misses() const { return _misses; }
+    uint64_t get_promotions() const { return _promotions; }
+    uint64_t get_demotions() const { return _demotions; }
+
+    /// Fraction of the lookups served by the segment
+    double probationary_hit_ratio() const {
+        return ratio(_probationary_hits);
+    }
+    double protected_hit_ratio() const { return ratio(_protected_hits); }
+
+    void setup_metrics(size_fn size_bytes, size_fn protected_size_bytes);
+
+private:
+    double ratio(uint64_t hits) const {
+        auto total = _probationary_hits + _protected_hits + _misses;
+        return total == 0 ? 0.0 : double(hits) / double(total);
+    }
+
+    uint64_t _probationary_hits = 0;
+    uint64_t _protected_hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _promotions = 0;
+    uint64_t _demotions = 0;
+    ss::metrics::metric_groups _metrics;
+};
+
+/**
+ * Shard wide latency of the segment rolls on the append path, split by
+ * whether the files of the next segment were staged before the roll.
+ */
+class segment_roll_probe {
+public:
+    void roll(std::chrono::steady_clock::duration d, bool staged) {
+        _latency.record(
+          std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+        ++(staged ? _staged_rolls : _unstaged_rolls);
+    }
+
+    void staging_failed() { ++_staging_errors; }
+
+    uint64_t get_staged_rolls() const { return _staged_rolls; }
+    uint64_t get_unstaged_rolls() const { return _unstaged_rolls; }
+
+    void setup_metrics();
+
+private:
+    hdr_hist _latency;
+    uint64_t _staged_rolls = 0;
+    uint64_t _unstaged_rolls = 0;
+    uint64_t _staging_errors = 0;
     ss::metrics::metric_groups _metrics;
 };
 } // namespace storage
@@ -0,0 +1,142 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/read_ahead.h"
+
+#include "config/configuration.h"
+#include "storage/disk_tuning.h"
+
+#include <fmt/ostream.h>
+
+#include <algorithm>
+#include <bit>
+#include <optional>
+#include <ostream>
+#include <utility>
+
+namespace storage {
+
+namespace {
+size_t& shard_used() {
+    static thread_local size_t used{0};
+    return used;
+}
+
+class prefetched_source final : public ss::data_source_impl {
+public:
+    explicit prefetched_source(ss::input_stream<char> in)
+      : _in(std::move(in))
+      , _first(_in.read()) {}
+
+    ss::future<ss::temporary_buffer<char>> get() final {
+        if (_first) {
+            auto f = std::move(*_first);
+            _first.reset();
+            return f;
+        }
+        return _in.read();
+    }
+
+    ss::future<> close() final {
+        auto f = ss::now();
+        if (_first) {
+            // the first buffer was never consumed
+            f = std::move(*_first).then_wrapped(
+              [](ss::future<ss::temporary_buffer<char>> f) {
+                  f.ignore_ready_future();
+              });
+            _first.reset();
+        }
+        return f.then([this] { return _in.close(); });
+    }
+
+private:
+    ss::input_stream<char> _in;
+    std::optional<ss::future<ss::temporary_buffer<char>>> _first;
+};
+} // namespace
+
+read_ahead::options read_ahead::for_progress(size_t sequential_bytes) {
+    const auto target = std::min(
+      sequential_bytes / 8, disk_tuning::local().max_read_ahead_bytes);
+    if (target < min_buffer_size) {
+        return options{};
+    }
+    const auto buffer_size = std::clamp(
+      std::bit_floor(target / 4), min_buffer_size, max_buffer_size);
+    return options{
+      .buffer_size = buffer_size,
+      .depth = static_cast<uint32_t>(target / buffer_size),
+    };
+}
+
+read_ahead read_ahead::adaptive(size_t sequential_bytes) {
+    auto o = for_progress(sequential_bytes);
+    const size_t limit
+      = config::shard_local_cfg().segment_read_ahead_memory();
+    const auto used = shard_used();
+    const auto left = used < limit ? limit - used : 0;
+    if (o.memory() > left) {
+        // fewer buffers of the same size, the last buffer is the minimum
+        const auto buffers = left / o.buffer_size;
+        o = buffers > 0 ? options{o.buffer_size, uint32_t(buffers - 1)}
+                        : options{};
+    }
+    auto ret = read_ahead(o, o.memory());
+    ret._adaptive = true;
+    return ret;
+}
+
+read_ahead read_ahead::fixed(size_t buffer_size, uint32_t depth) {
+    const options o{.buffer_size = buffer_size, .depth = depth};
+    return read_ahead(o, o.memory());
+}
+
+size_t read_ahead::shard_memory() { return shard_used(); }
+
+read_ahead::read_ahead(options o, size_t reserved) noexcept
+  : _opts(o)
+  , _reserved(reserved) {
+    shard_used() += _reserved;
+}
+
+read_ahead::read_ahead(read_ahead&& o) noexcept
+  : _opts(o._opts)
+  , _adaptive(o._adaptive)
+  , _reserved(std::exchange(o._reserved, 0)) {}
+
+read_ahead& read_ahead::operator=(read_ahead&& o) noexcept {
+    if (this != &o) {
+        shard_used() -= _reserved;
+        _opts = o._opts;
+        _adaptive = o._adaptive;
+        _reserved = std::exchange(o._reserved, 0);
+    }
+    return *this;
+}
+
+read_ahead::~read_ahead() noexcept { shard_used() -= _reserved; }
+
+bool read_ahead::should_grow(size_t sequential_bytes) const {
+    return _adaptive
+           && for_progress(sequential_bytes).memory() >= 4 * _opts.memory();
+}
+
+std::ostream& operator<<(std::ostream& o, const read_ahead::options& opts) {
+    fmt::print(
+      o, "{{buffer_size: {}, depth: {}}}", opts.buffer_size, opts.depth);
+    return o;
+}
+
+ss::input_stream<char> make_prefetched_stream(ss::input_stream<char> in) {
+    return ss::input_stream<char>(ss::data_source(
+      std::make_unique<prefetched_source>(std::move(in))));
+}
+
+} // namespace storage
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+#include "units.h"
+
+#include <seastar/core/iostream.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace storage {
+
+/**
+ * Buffers of the data stream of a segment reader.
+ *
+ * A log reader that tails the log reads a few KB per fetch, a log reader that
+ * catches up or recovers a follower reads GBs sequentially. The read-ahead of
+ * a stream follows the bytes its log reader read sequentially before opening
+ * it: about an eighth of them are read ahead, in buffers of a quarter of the
+ * read-ahead, between a 32KiB buffer without read-ahead and 4MiB. Because the
+ * readers cache reuses a log reader only for the read that continues from
+ * where it stopped, the progress of a reader is carried through the cache.
+ *
+ * The memory of the buffers of the open streams is bounded per shard by
+ * segment_read_ahead_memory: a stream opened past it gets a single buffer of
+ * the minimum size. The memory is returned when the stream is closed.
+ */
+class read_ahead {
+public:
+    static constexpr size_t min_buffer_size = 32_KiB;
+    static constexpr size_t max_buffer_size = 1_MiB;
+    static constexpr size_t max_read_ahead_bytes = 4_MiB;
+
+    struct options {
+        size_t buffer_size{min_buffer_size};
+        /// buffers read ahead of the one being consumed
+        uint32_t depth{0};
+
+        size_t memory() const { return buffer_size * (depth + 1); }
+        friend std::ostream& operator<<(std::ostream&, const options&);
+    };
+
+    /// \brief options of a stream opened after the reader read the
+    /// sequential bytes
+    static options for_progress(size_t sequential_bytes);
+
+    /// \brief the options for the progress within the budget of the shard
+    static read_ahead adaptive(size_t sequential_bytes);
+
+    /// \brief the options requested by the reader, counted in the budget of
+    /// the shard without being limited by it
+    static read_ahead fixed(size_t buffer_size, uint32_t depth);
+
+    /// \brief memory of the open streams of the shard
+    static size_t shard_memory();
+
+    read_ahead() noexcept = default;
+    read_ahead(read_ahead&&) noexcept;
+    read_ahead& operator=(read_ahead&&) noexcept;
+    read_ahead(const read_ahead&) = delete;
+    read_ahead& operator=(const read_ahead&) = delete;
+    ~read_ahead() noexcept;
+
+    const options& opts() const { return _opts; }
+
+    /// \brief whether a stream opened after the sequential bytes would read
+    /// ahead at least 4 times more, worth reopening the stream at the
+    /// current position
+    bool should_grow(size_t sequential_bytes) const;
+
+private:
+    read_ahead(options, size_t reserved) noexcept;
+
+    options _opts;
+    bool _adaptive{false};
+    size_t _reserved{0};
+};
+
+/// \brief a stream over the input that issues its first read right away,
+/// the latency of the read overlaps with the work done before the stream is
+/// consumed. The stream must be closed
+ss::input_stream<char> make_prefetched_stream(ss::input_stream<char>);
+
+} // namespace storage
@@ -14,9 +14,13 @@
 #include "model/record_utils.h"
 #include "model/timeout_clock.h"
 #include "storage/parser_utils.h"
+#include "utils/vint.h"
 
 #include <seastar/core/smp.hh>
 
+#include <algorithm>
+#include <array>
+
 namespace storage {
 
 record_batch_builder::record_batch_builder(
@@ -26,8 +30,86 @@ record_batch_builder::record_batch_builder(
 
 record_batch_builder::~record_batch_builder() {}
 
+void record_batch_builder::reserve(size_t records, size_t payload_bytes) {
+    // the vints of a record are bounded by the ones of the whole payload
+    const auto sizes = vint::vint_size(static_cast<int64_t>(payload_bytes));
+    const auto per_record = sizeof(model::record_attributes::type)
+                            + 2 * zero_vint_size // ts delta, header count
+                            + 3 * sizes          // record, key, value size
+                            + vint::vint_size(_record_count + records);
+    _records.reserve_memory(payload_bytes + records * per_record);
+}
+
+void record_batch_builder::append_scalars(const uint8_t* data, size_t size) {
+    // NOLINTNEXTLINE
+    _records.append(reinterpret_cast<const char*>(data), size);
+    _records_crc.extend(data, size);
+}
+
+void record_batch_builder::append_fragments(const iobuf& buf) {
+    for (auto& f : buf) {
+        _records.append(f.get(), f.size());
+        _records_crc.extend(f.get(), f.size());
+    }
+}
+
+void record_batch_builder::append_record(
+  const std::optional<iobuf>& key,
+  const std::optional<iobuf>& value,
+  const std::vector<model::record_header>& headers) {
+    const int32_t offset_delta = _record_count++;
+    const int32_t key_size = key ? key->size_bytes() : -1;
+    const int32_t value_size = likely(value) ? value->size_bytes() : -1;
+
+    int64_t size = sizeof(model::record_attributes::type) // attributes
+                   + zero_vint_size                       // timestamp delta
+                   + vint::vint_size(offset_delta)        // offset_delta
+                   + vint::vint_size(key_size)            // key size
+                   + std::max(key_size, 0)                // key
+                   + vint::vint_size(value_size)          // value size
+                   + std::max(value_size, 0)              // value
+                   + vint::vint_size(headers.size());     // headers size
+    for (const auto& h : headers) {
+        size += vint::vint_size(h.key_size()) + h.key().size_bytes()
+                + vint::vint_size(h.value_size()) + h.value().size_bytes();
+    }
+    _records.reserve_memory(size + vint::vint_size(size));
+
+    // size, attributes, timestamp delta, offset delta and key size
+    std::array<uint8_t, 4 * vint::max_length + 1> scratch; // NOLINT
+    size_t n = vint::serialize(size, scratch.data());
+    scratch[n++] = 0; // attributes
+    n += vint::serialize(0, scratch.data() + n);
+    n += vint::serialize(offset_delta, scratch.data() + n);
+    n += vint::serialize(key_size, scratch.data() + n);
+    append_scalars(scratch.data(), n);
+    if (key) {
+        append_fragments(*key);
+    }
+
+    n = vint::serialize(value_size, scratch.data());
+    append_scalars(scratch.data(), n);
+    if (value) {
+        append_fragments(*value);
+    }
+
+    n = vint::serialize(static_cast<int64_t>(headers.size()), scratch.data());
+    append_scalars(scratch.data(), n);
+    for (const auto& h : headers) {
+        n = vint::serialize(h.key_size(), scratch.data());
+        append_scalars(scratch.data(), n);
+        if (h.key_size() > 0) {
+            append_fragments(h.key());
+        }
+        n = vint::serialize(h.value_size(), scratch.data());
+        append_scalars(scratch.data(), n);
+        if (h.value_size() > 0) {
+            append_fragments(h.value());
+        }
+    }
+}
+
 model::record_batch record_batch_builder::build() && {
-    int32_t offset_delta = 0;
     if (!_timestamp) {
         _timestamp = model::timestamp::now();
     }
@@ -38,13 +120,13 @@ model::record_batch record_batch_builder::build() && {
       .type = _batch_type,
       .crc = 0, // crc computed later
       .attrs = model::record_batch_attributes{} |= _compression,
-      .last_offset_delta = static_cast<int32_t>(_records.size() - 1),
+      .last_offset_delta = _record_count - 1,
       .first_timestamp = *_timestamp,
       .max_timestamp = *_timestamp,
       .producer_id = _producer_id,
       .producer_epoch = _producer_epoch,
       .base_sequence = -1,
-      .record_count = static_cast<int32_t>(_records.size()),
+      .record_count = _record_count,
       .ctx = model::record_batch_header::context(
         model::term_id(0), ss::this_shard_id())};
 
@@ -56,49 +138,25 @@ model::record_batch record_batch_builder::build() && {
         header.attrs.set_transactional_type();
     }
 
-    iobuf records;
-    for (auto& sr : _records) {
-        auto rec_sz = record_size(offset_delta, sr);
-        auto kz = sr.encoded_key_size;
-        auto vz = sr.encoded_value_size;
-        auto r = model::record(
-          rec_sz,
-          model::record_attributes{},
-          0,
-          offset_delta,
-          kz,
-          std::move(sr.key),
-          vz,
-          std::move(sr.value),
-          std::move(sr.headers));
-        ++offset_delta;
-        model::append_record_to_buffer(records, r);
-    }
-
     if (_compression != model::compression::none) {
-        records = compression::compressor::compress(records, _compression);
+        auto records = compression::compressor::compress(
+          _records, _compression);
+        internal::reset_size_checksum_metadata(header, records);
+        return model::record_batch(
+          header, std::move(records), model::record_batch::tag_ctor_ng{});
     }
 
-    internal::reset_size_checksum_metadata(header, records);
+    // the records were checksummed while they were written, only the header
+    // is left and the two checksums are combined
+    header.size_bytes = model::packed_record_batch_header_size
+                        + _records.size_bytes();
+    crc::crc32c crc;
+    model::crc_record_batch_header(crc, header);
+    header.crc = static_cast<int32_t>(crc::crc32c_combine(
+      crc.value(), _records_crc.value(), _records.size_bytes()));
+    header.header_crc = model::internal_header_only_crc(header);
     return model::record_batch(
-      header, std::move(records), model::record_batch::tag_ctor_ng{});
-}
-
-uint32_t record_batch_builder::record_size(
-  int32_t offset_delta, const serialized_record& r) {
-    uint32_t size = sizeof(model::record_attributes::type)  // attributes
-                    + zero_vint_size                        // timestamp delta
-                    + vint::vint_size(offset_delta)         // offset_delta
-                    + vint::vint_size(r.encoded_key_size)   // key size
-                    + r.key.size_bytes()                    // key
-                    + vint::vint_size(r.encoded_value_size) // value size
-                    + r.value.size_bytes()                  // value
-                    + vint::vint_size(r.headers.size());    // headers size
-    for (const auto& h : r.headers) {
-        size += vint::vint_size(h.key_size()) + h.key().size_bytes()
-                + vint::vint_size(h.value_size()) + h.value().size_bytes();
-    }
-    return size;
+      header, std::move(_records), model::record_batch::tag_ctor_ng{});
 }
 
 } // namespace storage
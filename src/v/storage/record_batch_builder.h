@@ -11,6 +11,7 @@
 
 #pragma once
 #include "bytes/iobuf.h"
+#include "hashing/crc32c.h"
 #include "model/record.h"
 #include "seastarx.h"
 #include "utils/vint.h"
@@ -26,17 +27,22 @@ public:
 
     virtual record_batch_builder&
     add_raw_kv(std::optional<iobuf>&& key, std::optional<iobuf>&& value) {
-        _records.emplace_back(std::move(key), std::move(value));
+        append_record(key, value, {});
         return *this;
     }
     virtual record_batch_builder& add_raw_kw(
       std::optional<iobuf>&& key,
       std::optional<iobuf>&& value,
       std::vector<model::record_header> headers) {
-        _records.emplace_back(
-          std::move(key), std::move(value), std::move(headers));
+        append_record(key, value, headers);
         return *this;
     }
+
+    /// \brief pre-sizes the records buffer for the given number of records
+    /// holding payload_bytes of keys, values and headers in total, so the
+    /// records are written to one contiguous region without reallocations
+    void reserve(size_t records, size_t payload_bytes);
+
     virtual model::record_batch build() &&;
     virtual ~record_batch_builder();
 
@@ -55,35 +61,15 @@ public:
 
 private:
     static constexpr int64_t zero_vint_size = vint::vint_size(0);
-    struct serialized_record {
-        serialized_record(
-          std::optional<iobuf> k,
-          std::optional<iobuf> v,
-          std::vector<model::record_header> hdrs
-          = std::vector<model::record_header>())
-          : headers(std::move(hdrs)) {
-            if (k) {
-                key = std::move(*k);
-                encoded_key_size = key.size_bytes();
-            } else {
-                encoded_key_size = -1;
-            }
-            if (likely(v)) {
-                value = std::move(*v);
-                encoded_value_size = value.size_bytes();
-            } else {
-                encoded_value_size = -1;
-            }
-        }
-
-        iobuf key;
-        int32_t encoded_key_size;
-        iobuf value;
-        int32_t encoded_value_size;
-        std::vector<model::record_header> headers;
-    };
 
-    uint32_t record_size(int32_t offset_delta, const serialized_record& r);
+    /// Serializes the record to the records buffer and extends the
+    /// checksum of the records with the written bytes
+    void append_record(
+      const std::optional<iobuf>& key,
+      const std::optional<iobuf>& value,
+      const std::vector<model::record_header>& headers);
+    void append_scalars(const uint8_t* data, size_t size);
+    void append_fragments(const iobuf& buf);
 
     model::record_batch_type _batch_type;
     model::offset _base_offset;
@@ -91,7 +77,9 @@ private:
     int16_t _producer_epoch{-1};
     bool _is_control_type{false};
     bool _transactional_type{false};
-    std::vector<serialized_record> _records;
+    int32_t _record_count{0};
+    iobuf _records;
+    crc::crc32c _records_crc;
     model::compression _compression{model::compression::none};
     std::optional<model::timestamp> _timestamp;
 };
@@ -11,6 +11,7 @@
 
 #include "compression/compression.h"
 #include "config/configuration.h"
+#include "model/record_utils.h"
 #include "storage/compacted_index_writer.h"
 #include "storage/fs_utils.h"
 #include "storage/fwd.h"
@@ -19,10 +20,12 @@
 #include "storage/readers_cache.h"
 #include "storage/segment_appender_utils.h"
 #include "storage/segment_set.h"
+#include "storage/segment_summary.h"
 #include "storage/segment_utils.h"
 #include "storage/types.h"
 #include "storage/version.h"
 #include "utils/file_sanitizer.h"
+#include "utils/latency_summary.h"
 #include "vassert.h"
 #include "vlog.h"
 
@@ -57,6 +60,8 @@ segment::segment(
   , _cache(std::move(c)) {
     if (_appender) {
         _appender->set_callbacks(&_appender_callbacks);
+        // the index of the segment that is written to is never unloaded
+        _idx.pin();
     }
 }
 
@@ -94,9 +99,10 @@ ss::future<> segment::remove_persistent_state() {
     vassert(is_closed(), "Cannot clear state from unclosed segment");
 
     std::vector<std::filesystem::path> rm;
-    rm.reserve(3);
+    rm.reserve(4);
     rm.emplace_back(reader().filename().c_str());
     rm.emplace_back(index().filename().c_str());
+    rm.push_back(segment_summary::path(reader().filename().c_str()));
     if (is_compacted_segment()) {
         rm.push_back(
           internal::compacted_index_path(reader().filename().c_str()));
@@ -155,6 +161,8 @@ ss::future<> segment::do_release_appender(
         std::optional<compacted_index_writer>& compacted_index) {
           return appender->close()
             .then([this] { return _idx.flush(); })
+            .then([this] { _idx.unpin(); })
+            .then([this] { return write_summary(); })
             .then([&compacted_index] {
                 if (compacted_index) {
                     return compacted_index->close();
@@ -164,6 +172,19 @@ ss::future<> segment::do_release_appender(
       });
 }
 
+ss::future<> segment::write_summary() {
+    // the summary only spares the replay of the segment on recovery
+    auto summary = segment_summary::of(*this);
+    return summary.write(_reader.filename().c_str())
+      .handle_exception([this](const std::exception_ptr& e) {
+          vlog(
+            stlog.warn,
+            "error writing summary of {} - {}",
+            _reader.filename(),
+            e);
+      });
+}
+
 ss::future<> segment::release_appender(readers_cache* readers_cache) {
     vassert(_appender, "cannot release a null appender");
     /*
@@ -282,7 +303,8 @@ segment::do_truncate(model::offset prev_last_offset, size_t physical) {
     _tracker.dirty_offset = prev_last_offset;
     _reader.set_file_size(physical);
     cache_truncate(prev_last_offset + model::offset(1));
-    auto f = ss::now();
+    // the summary is of the data before the truncation
+    auto f = segment_summary::remove(_reader.filename().c_str());
     if (is_compacted_segment()) {
         // if compaction index is opened close it
         if (_compaction_index) {
@@ -335,6 +357,21 @@ ss::future<bool> segment::materialize_index() {
     });
 }
 
+ss::future<> segment::materialize_from_summary(const segment_summary& sm) {
+    index_state state;
+    state.base_offset = sm.base_offset;
+    state.max_offset = sm.max_offset;
+    state.base_timestamp = sm.base_timestamp;
+    state.max_timestamp = sm.max_timestamp;
+    _idx.swap_index_state(std::move(state));
+    _tracker.committed_offset = sm.max_offset;
+    _tracker.stable_offset = sm.max_offset;
+    _tracker.dirty_offset = sm.max_offset;
+    // the index without entries replaces the one that failed, the summary is
+    // then of that index
+    return _idx.flush().then([this] { return write_summary(); });
+}
+
 void segment::cache_truncate(model::offset offset) {
     check_segment_not_closed("cache_truncate()");
     if (likely(bool(_cache))) {
@@ -344,9 +381,18 @@ void segment::cache_truncate(model::offset offset) {
 ss::future<> segment::do_compaction_index_batch(const model::record_batch& b) {
     vassert(!b.compressed(), "wrong method. Call compact_index_batch. {}", b);
     auto& w = compaction_index();
-    return model::for_each_record(
-      b, [o = b.base_offset(), &w](const model::record& r) {
-          return w.index(r.key(), o, r.offset_delta());
+    // only the keys are indexed, the records aren't materialized. the keys
+    // are views of the batch, the index copies the ones it doesn't hold yet
+    return ss::futurize_invoke([&b] { return model::scan_records(b); })
+      .then([o = b.base_offset(), &w](model::record_scan s) {
+          return ss::do_with(
+            std::move(s), [o, &w](const model::record_scan& scan) {
+                return ss::do_for_each(
+                  scan.records, [o, &w](const model::record_key_view& r) {
+                      return w.index(
+                        r.key.value_or(bytes_view()), o, r.offset_delta);
+                  });
+            });
       });
 }
 ss::future<> segment::compaction_index_batch(const model::record_batch& b) {
@@ -385,6 +431,8 @@ ss::future<append_result> segment::append(const model::record_batch& b) {
           "record batch marked as compressed, but has no valid compression:{}",
           b.header())));
     }
+    auto m = latency_summary::histogram(latency_summary::op::storage_append)
+               .auto_measure();
     const auto start_physical_offset = _appender->file_byte_offset();
     // proxy serialization to segment_appender_utils
     auto write_fut
@@ -415,7 +463,8 @@ ss::future<append_result> segment::append(const model::record_batch& b) {
         });
     auto index_fut = compaction_index_batch(b);
     return ss::when_all(std::move(write_fut), std::move(index_fut))
-      .then([](std::tuple<ss::future<append_result>, ss::future<>> p) {
+      .then([m = std::move(m)](
+              std::tuple<ss::future<append_result>, ss::future<>> p) {
           auto& [append_fut, index_fut] = p;
           const bool has_error = append_fut.failed() || index_fut.failed();
           if (!has_error) {
@@ -447,15 +496,23 @@ ss::future<append_result> segment::append(model::record_batch&& b) {
     });
 }
 
-ss::input_stream<char>
-segment::offset_data_stream(model::offset o, ss::io_priority_class iopc) {
+ss::input_stream<char> segment::offset_data_stream(
+  model::offset o, ss::io_priority_class iopc, uint32_t read_ahead) {
+    return offset_data_stream(o, iopc, read_ahead, _reader.buffer_size());
+}
+
+ss::input_stream<char> segment::offset_data_stream(
+  model::offset o,
+  ss::io_priority_class iopc,
+  uint32_t read_ahead,
+  size_t buffer_size) {
     check_segment_not_closed("offset_data_stream()");
     auto nearest = _idx.find_nearest(o);
     size_t position = 0;
     if (nearest) {
         position = nearest->filepos;
     }
-    return _reader.data_stream(position, iopc);
+    return _reader.data_stream(position, iopc, read_ahead, buffer_size);
 }
 
 void segment::advance_stable_offset(size_t offset) {
@@ -623,23 +680,25 @@ ss::future<ss::lw_shared_ptr<segment>> make_segment(
   record_version_type version,
   size_t buf_size,
   debug_sanitize_files sanitize_fileops,
-  std::optional<batch_cache_index> batch_cache) {
+  std::optional<batch_cache_index> batch_cache,
+  flush_scheduler* flusher) {
     auto path = segment_path::make_segment_path(
       ntpc, base_offset, term, version);
     vlog(stlog.info, "Creating new segment {}", path.string());
     return open_segment(
              path, sanitize_fileops, std::move(batch_cache), buf_size)
-      .then([path, &ntpc, sanitize_fileops, pc](
+      .then([path, &ntpc, sanitize_fileops, pc, flusher](
               ss::lw_shared_ptr<segment> seg) {
           return with_segment(
             std::move(seg),
-            [path, &ntpc, sanitize_fileops, pc](
+            [path, &ntpc, sanitize_fileops, pc, flusher](
               const ss::lw_shared_ptr<segment>& seg) {
                 return internal::make_segment_appender(
                          path,
                          sanitize_fileops,
                          internal::number_of_chunks_from_config(ntpc),
-                         pc)
+                         pc,
+                         flusher)
                   .then([seg](segment_appender_ptr a) {
                       return ss::make_ready_future<ss::lw_shared_ptr<segment>>(
                         ss::make_lw_shared<segment>(
@@ -665,7 +724,11 @@ ss::future<ss::lw_shared_ptr<segment>> make_segment(
               const ss::lw_shared_ptr<segment>& seg) {
                 auto compacted_path = internal::compacted_index_path(path);
                 return internal::make_compacted_index_writer(
-                         compacted_path, sanitize_fileops, pc)
+                         compacted_path,
+                         sanitize_fileops,
+                         pc,
+                         compacted_index::key_digests_mode(
+                           config::shard_local_cfg().compaction_key_digests()))
                   .then([seg](compacted_index_writer compact) {
                       return ss::make_ready_future<ss::lw_shared_ptr<segment>>(
                         ss::make_lw_shared<segment>(
@@ -62,6 +62,8 @@ public:
         finished_self_compaction = 1U << 1U,
         mark_tombstone = 1U << 2U,
         closed = 1U << 3U,
+        // checked for batches to recompress with the codec of the topic
+        finished_recompression = 1U << 4U,
     };
 
 public:
@@ -91,10 +93,20 @@ public:
     ss::future<append_result> append(model::record_batch&&);
     ss::future<append_result> append(const model::record_batch&);
     ss::future<bool> materialize_index();
+    /// \brief the bounds of a sealed segment whose index can't be used,
+    /// taken from its summary. The index is rewritten without entries
+    ss::future<> materialize_from_summary(const segment_summary&);
 
     /// main read interface
-    ss::input_stream<char>
-      offset_data_stream(model::offset, ss::io_priority_class);
+    ss::input_stream<char> offset_data_stream(
+      model::offset,
+      ss::io_priority_class,
+      uint32_t read_ahead = segment_reader::default_read_ahead);
+    ss::input_stream<char> offset_data_stream(
+      model::offset,
+      ss::io_priority_class,
+      uint32_t read_ahead,
+      size_t buffer_size);
 
     const offset_tracker& offsets() const { return _tracker; }
     bool empty() const;
@@ -109,6 +121,9 @@ public:
     bool is_compacted_segment() const;
     void mark_as_finished_self_compaction();
     bool finished_self_compaction() const;
+    void mark_as_finished_recompression();
+    void unmark_as_finished_recompression();
+    bool finished_recompression() const;
     /// \brief used for compaction, to reset the tracker from index
     void force_set_commit_offset_from_index();
     // low level api's are discouraged and might be deprecated
@@ -158,6 +173,8 @@ private:
       segment_appender_ptr,
       std::optional<batch_cache_index>,
       std::optional<compacted_index_writer>);
+    /// \brief writes the segment_summary of the sealed segment
+    ss::future<> write_summary();
     ss::future<> remove_tombstones();
     ss::future<> compaction_index_batch(const model::record_batch&);
     ss::future<> do_compaction_index_batch(const model::record_batch&);
@@ -222,7 +239,8 @@ ss::future<ss::lw_shared_ptr<segment>> make_segment(
   record_version_type version,
   size_t buf_size,
   debug_sanitize_files sanitize_fileops,
-  std::optional<batch_cache_index> batch_cache);
+  std::optional<batch_cache_index> batch_cache,
+  flush_scheduler* flusher = nullptr);
 
 // bitflags operators
 [[gnu::always_inline]] inline segment::bitflags
@@ -285,6 +303,16 @@ inline bool segment::finished_self_compaction() const {
     return (_flags & bitflags::finished_self_compaction)
            == bitflags::finished_self_compaction;
 }
+inline void segment::mark_as_finished_recompression() {
+    _flags |= bitflags::finished_recompression;
+}
+inline void segment::unmark_as_finished_recompression() {
+    _flags &= ~bitflags::finished_recompression;
+}
+inline bool segment::finished_recompression() const {
+    return (_flags & bitflags::finished_recompression)
+           == bitflags::finished_recompression;
+}
 inline std::optional<std::reference_wrapper<batch_cache_index>>
 segment::cache() {
     using ret_t = std::optional<std::reference_wrapper<batch_cache_index>>;
@@ -10,9 +10,13 @@
 #include "storage/segment_appender.h"
 
 #include "config/configuration.h"
+#include "finjector/hbadger.h"
 #include "likely.h"
 #include "storage/chunk_cache.h"
+#include "storage/flush_scheduler.h"
+#include "storage/io_latency_probe.h"
 #include "storage/logger.h"
+#include "utils/event_trace.h"
 #include "vassert.h"
 #include "vlog.h"
 
@@ -37,10 +41,10 @@ namespace storage {
  * option for avoiding this is to do more aligned appends or add a special
  * padding batch that is read and then fully ignored by the parser.
  *
- * 2. flush operations are completed asynchronously when writes complete. there
- * is not reason to do this so aggresively. we could potentially reduce the
- * amount of flushing by using a bytes or time heuristic. we'd increase the
- * latency of each flush, but we'd dispatch less physical flush operations.
+ * 2. flush operations are completed asynchronously when writes complete. when
+ * the appender is created with a flush_scheduler the physical flushes of all
+ * the segments of the shard are batched and deduplicated per file, see
+ * storage/flush_scheduler.h.
  */
 
 [[gnu::cold]] static ss::future<>
@@ -53,8 +57,10 @@ segment_appender::segment_appender(ss::file f, options opts)
   : _out(std::move(f))
   , _opts(opts)
   , _concurrent_flushes(ss::semaphore::max_counter())
+  , _chunks(internal::chunks(), opts.number_of_chunks)
   , _prev_head_write(ss::make_lw_shared<ss::semaphore>(1))
   , _inactive_timer([this] { handle_inactive_timer(); }) {
+    _chunks.on_reclaim([this] { release_idle_head(); });
     const auto alignment = _out.disk_write_dma_alignment();
     vassert(
       internal::chunk_cache::alignment % alignment == 0,
@@ -80,7 +86,7 @@ segment_appender::~segment_appender() noexcept {
       "Active flush operations on appender destroy {}",
       *this);
     if (_head) {
-        internal::chunks().add(std::exchange(_head, nullptr));
+        internal::chunks().add(_chunks, std::exchange(_head, nullptr));
     }
 }
 
@@ -93,6 +99,7 @@ segment_appender::segment_appender(segment_appender&& o) noexcept
   , _bytes_flush_pending(o._bytes_flush_pending)
   , _concurrent_flushes(std::move(o._concurrent_flushes))
   , _head(std::move(o._head))
+  , _chunks(std::move(o._chunks))
   , _prev_head_write(std::move(o._prev_head_write))
   , _flush_ops(std::move(o._flush_ops))
   , _flushed_offset(o._flushed_offset)
@@ -100,6 +107,7 @@ segment_appender::segment_appender(segment_appender&& o) noexcept
   , _inflight(std::move(o._inflight))
   , _callbacks(std::exchange(o._callbacks, nullptr))
   , _inactive_timer([this] { handle_inactive_timer(); }) {
+    _chunks.on_reclaim([this] { release_idle_head(); });
     o._closed = true;
 }
 
@@ -109,10 +117,19 @@ ss::future<> segment_appender::append(bytes_view s) {
 }
 
 ss::future<> segment_appender::append(const iobuf& io) {
-    return ss::do_for_each(
+    auto f = ss::do_for_each(
       io.begin(), io.end(), [this](const iobuf::fragment& f) {
           return append(f.get(), f.size());
       });
+    if (!event_trace::enabled()) {
+        return f;
+    }
+    return f.then([this, n = io.size_bytes()] {
+        event_trace::record(
+          event_trace::type::segment_appended,
+          reinterpret_cast<uintptr_t>(this), // NOLINT
+          n);
+    });
 }
 
 ss::future<> segment_appender::append(const char* buf, const size_t n) {
@@ -138,7 +155,7 @@ ss::future<> segment_appender::do_append(const char* buf, const size_t n) {
      */
     if (unlikely(!_head && _committed_offset > 0)) {
         return internal::chunks()
-          .get()
+          .get(_chunks)
           .then([this](ss::lw_shared_ptr<chunk> chunk) {
               _head = std::move(chunk);
           })
@@ -170,7 +187,7 @@ ss::future<> segment_appender::do_append(const char* buf, const size_t n) {
       .then([this, next_buf = buf + written, next_sz = n - written](
               ss::semaphore_units<>) {
           // do not hold the units!
-          return internal::chunks().get().then(
+          return internal::chunks().get(_chunks).then(
             [this, next_buf, next_sz](ss::lw_shared_ptr<chunk> chunk) {
                 vassert(!_head, "cannot overwrite existing chunk");
                 _head = std::move(chunk);
@@ -198,19 +215,26 @@ void segment_appender::handle_inactive_timer() {
      * background write may take some time and it steals _head until it
      * completes. it may also return the chunk to the cache if it empty.
      */
-    if (_concurrent_flushes.try_wait(ss::semaphore::max_counter())) {
-        if (_head && !_head->bytes_pending()) {
-            internal::chunks().add(std::exchange(_head, nullptr));
-            vlog(
-              stlog.debug, "reclaiming inactive chunk from appender {}", *this);
-        }
-        _concurrent_flushes.signal(ss::semaphore::max_counter());
-    } else {
+    if (!release_idle_head()) {
         _inactive_timer.arm(
           config::shard_local_cfg().segment_appender_flush_timeout_ms());
     }
 }
 
+/// \brief returns the head to the chunk cache if it has no pending bytes and
+/// no write is in flight. returns false if writes are in flight
+bool segment_appender::release_idle_head() {
+    if (!_concurrent_flushes.try_wait(ss::semaphore::max_counter())) {
+        return false;
+    }
+    if (_head && !_head->bytes_pending()) {
+        internal::chunks().add(_chunks, std::exchange(_head, nullptr));
+        vlog(stlog.debug, "reclaiming inactive chunk from appender {}", *this);
+    }
+    _concurrent_flushes.signal(ss::semaphore::max_counter());
+    return true;
+}
+
 ss::future<> segment_appender::hydrate_last_half_page() {
     vassert(_head, "hydrate last half page expects active chunk");
     vassert(
@@ -292,7 +316,7 @@ ss::future<> segment_appender::truncate(size_t n) {
               _head->reset();
           } else {
               // https://github.com/vectorizedio/redpanda/issues/43
-              f = internal::chunks().get().then(
+              f = internal::chunks().get(_chunks).then(
                 [this](ss::lw_shared_ptr<chunk> chunk) {
                     _head = std::move(chunk);
                 });
@@ -309,6 +333,13 @@ ss::future<> segment_appender::close() {
       .then([this] { return _out.close(); });
 }
 
+ss::future<> segment_appender::preallocate() {
+    if (_fallocation_offset > 0) {
+        return ss::now();
+    }
+    return do_next_adaptive_fallocation();
+}
+
 ss::future<> segment_appender::do_next_adaptive_fallocation() {
     return ss::with_semaphore(
              _concurrent_flushes,
@@ -399,7 +430,7 @@ ss::future<> segment_appender::process_flush_ops(size_t committed) {
 
     _flush_ops.erase(flushable, _flush_ops.end());
 
-    return _out.flush().then([this, committed, ops = std::move(ops)]() mutable {
+    return flush_file().then([this, committed, ops = std::move(ops)]() mutable {
         _flushed_offset = committed;
         /*
          * TODO: as an optimization, add a little house keeping to determine if
@@ -468,9 +499,16 @@ void segment_appender::dispatch_background_head_write() {
           return units
             .then([this, h, w, start_offset, expected, src, full](
                     ss::semaphore_units<> u) mutable {
-                return _out
-                  .dma_write(start_offset, src, expected, _opts.priority)
-                  .then([this, h, w, expected, full](size_t got) {
+                const auto start = io_latency_probe::clock_type::now();
+                return finjector::inject_io_fault(
+                         finjector::io_point::segment_write, expected)
+                  .then([this, start_offset, src, expected] {
+                      return _out.dma_write(
+                        start_offset, src, expected, _opts.priority);
+                  })
+                  .then([this, h, w, expected, full, start](size_t got) {
+                      io_latency_probe::record(
+                        _opts.priority, io_latency_probe::op::write, start);
                       /*
                        * the continuation that captured full=true is the end of
                        * the dependency chain for this chunk. it can be returned
@@ -478,7 +516,7 @@ void segment_appender::dispatch_background_head_write() {
                        */
                       if (full) {
                           h->reset();
-                          internal::chunks().add(h);
+                          internal::chunks().add(_chunks, h);
                       }
                       if (unlikely(expected != got)) {
                           return size_missmatch_error(
@@ -505,6 +543,18 @@ void segment_appender::dispatch_background_head_write() {
 }
 
 ss::future<> segment_appender::flush() {
+    if (!event_trace::enabled()) {
+        return do_flush();
+    }
+    return do_flush().then([this, committed = file_byte_offset()] {
+        event_trace::record(
+          event_trace::type::segment_flushed,
+          reinterpret_cast<uintptr_t>(this), // NOLINT
+          committed);
+    });
+}
+
+ss::future<> segment_appender::do_flush() {
     _inactive_timer.cancel();
 
     // dispatched write will drive flush completion
@@ -534,11 +584,19 @@ ss::future<> segment_appender::flush() {
       _stable_offset,
       *this);
 
-    return _out.flush().handle_exception([this](std::exception_ptr e) {
+    return flush_file().handle_exception([this](std::exception_ptr e) {
         vassert(false, "Could not flush: {} - {}", e, *this);
     });
 }
 
+ss::future<> segment_appender::flush_file() {
+    auto f = _opts.flusher ? _opts.flusher->flush(_out) : _out.flush();
+    return f.then([this, start = io_latency_probe::clock_type::now()] {
+        io_latency_probe::record(
+          _opts.priority, io_latency_probe::op::flush, start);
+    });
+}
+
 ss::future<> segment_appender::hard_flush() {
     _inactive_timer.cancel();
     if (_head && _head->bytes_pending()) {
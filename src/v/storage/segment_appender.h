@@ -15,6 +15,8 @@
 #include "bytes/iobuf.h"
 #include "likely.h"
 #include "seastarx.h"
+#include "storage/chunk_cache.h"
+#include "storage/fwd.h"
 #include "storage/segment_appender_chunk.h"
 #include "utils/intrusive_list_helpers.h"
 
@@ -53,6 +55,8 @@ public:
         ss::io_priority_class priority;
         size_t number_of_chunks{chunks_no_buffer};
         size_t falloc_step{fallocation_step};
+        // optional shard wide scheduler coalescing the flushes
+        flush_scheduler* flusher{nullptr};
     };
 
     segment_appender(ss::file f, options opts);
@@ -73,6 +77,9 @@ public:
     ss::future<> truncate(size_t n);
     ss::future<> close();
     ss::future<> flush();
+    /// \brief allocates the first extent of the file ahead of the first
+    /// append, used when the file is created before it is written to
+    ss::future<> preallocate();
 
     struct callbacks {
         virtual void committed_physical_offset(size_t) = 0;
@@ -109,6 +116,8 @@ private:
     size_t _bytes_flush_pending{0};
     ss::semaphore _concurrent_flushes;
     ss::lw_shared_ptr<chunk> _head;
+    // the share of the chunk cache of the appender
+    internal::chunk_cache::account _chunks;
     ss::lw_shared_ptr<ss::semaphore> _prev_head_write;
 
     struct flush_op {
@@ -140,9 +149,12 @@ private:
     ss::future<>
     maybe_advance_stable_offset(const ss::lw_shared_ptr<inflight_write>&);
     ss::future<> process_flush_ops(size_t);
+    ss::future<> flush_file();
+    ss::future<> do_flush();
 
     ss::timer<ss::lowres_clock> _inactive_timer;
     void handle_inactive_timer();
+    bool release_idle_head();
 
     friend std::ostream& operator<<(std::ostream&, const segment_appender&);
 };
@@ -16,6 +16,9 @@
 
 namespace storage {
 
+/// Serialize the batch header using the on-disk format
+iobuf disk_header_to_iobuf(const model::record_batch_header& h);
+
 ss::future<>
 write(segment_appender& appender, const model::record_batch& batch);
 
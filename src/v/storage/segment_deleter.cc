@@ -0,0 +1,98 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/segment_deleter.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "storage/logger.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/sleep.hh>
+
+#include <chrono>
+
+namespace storage {
+
+void segment_deleter::remove(ss::lw_shared_ptr<segment> s) {
+    vassert(s->is_closed(), "Segment must be closed before removal: {}", *s);
+    if (_gate.is_closed()) {
+        vlog(
+          stlog.info,
+          "Segment deleter is stopped, not removing: {}",
+          s->reader().filename());
+        return;
+    }
+    s->tombstone();
+    auto size = s->size_bytes();
+    _pending_bytes += size;
+    _queue.push_back(pending_removal{std::move(s), size});
+    if (!_in_progress) {
+        _in_progress = true;
+        (void)ss::with_gate(_gate, [this] { return drain(); });
+    }
+}
+
+ss::future<> segment_deleter::drain() {
+    while (!_queue.empty()) {
+        auto p = std::move(_queue.front());
+        _queue.pop_front();
+        // errors are logged and ignored, removal is idempotent
+        co_await p.segment->remove_persistent_state();
+        _pending_bytes -= p.size_bytes;
+        ++_removed_segments;
+
+        const auto rate = config::shard_local_cfg().segment_deletion_rate();
+        if (rate == 0 || _as.abort_requested() || _queue.empty()) {
+            continue;
+        }
+        auto delay = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::duration<double>(double(p.size_bytes) / rate));
+        try {
+            co_await ss::sleep_abortable(delay, _as);
+        } catch (const ss::sleep_aborted&) {
+            // stopping, drain without the rate limit
+        }
+    }
+    _in_progress = false;
+}
+
+ss::future<> segment_deleter::stop() {
+    _as.request_abort();
+    return _gate.close();
+}
+
+void segment_deleter::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:segment_deleter"),
+      {
+        sm::make_gauge(
+          "pending_bytes",
+          [this] { return _pending_bytes; },
+          sm::description("Size of the removed segments waiting for their files "
+                          "to be deleted")),
+        sm::make_gauge(
+          "pending_segments",
+          [this] { return _queue.size(); },
+          sm::description("Number of removed segments waiting for their files "
+                          "to be deleted")),
+        sm::make_derive(
+          "removed_segments",
+          [this] { return _removed_segments; },
+          sm::description("Number of segments whose files were deleted")),
+      });
+}
+
+} // namespace storage
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+#include "storage/segment.h"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/circular_buffer.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace storage {
+
+/**
+ * Shard wide background removal of the files of closed segments.
+ *
+ * Retention and prefix truncation drop the segments from the segment set of
+ * the log, persisting the new start offset first, and hand the closed
+ * segments over to the deleter. The files are removed one segment at a time
+ * and the removals are spread out so that no more than
+ * `segment_deletion_rate` bytes per second are removed, unlinking many large
+ * fallocated files at once stalls the disk for the producers of the shard.
+ * Files left behind by a crash are below the start offset of the log and
+ * are collected again.
+ */
+class segment_deleter {
+public:
+    segment_deleter() = default;
+    segment_deleter(const segment_deleter&) = delete;
+    segment_deleter& operator=(const segment_deleter&) = delete;
+    segment_deleter(segment_deleter&&) = delete;
+    segment_deleter& operator=(segment_deleter&&) = delete;
+    ~segment_deleter() noexcept = default;
+
+    /// Queue the removal of the files of a closed segment
+    void remove(ss::lw_shared_ptr<segment>);
+
+    /// Remove the queued segments without the rate limit
+    ss::future<> stop();
+
+    /// Register the metrics, should be called for one deleter per shard
+    void setup_metrics();
+
+    size_t pending_bytes() const { return _pending_bytes; }
+    size_t pending_segments() const { return _queue.size(); }
+    uint64_t removed_segments() const { return _removed_segments; }
+
+private:
+    struct pending_removal {
+        ss::lw_shared_ptr<segment> segment;
+        size_t size_bytes;
+    };
+
+    ss::future<> drain();
+
+    ss::circular_buffer<pending_removal> _queue;
+    size_t _pending_bytes{0};
+    bool _in_progress{false};
+    ss::gate _gate;
+    ss::abort_source _as;
+
+    uint64_t _removed_segments{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
@@ -10,8 +10,10 @@
 #include "storage/segment_index.h"
 
 #include "model/timestamp.h"
+#include "storage/index_cache.h"
 #include "storage/logger.h"
 #include "vassert.h"
+#include "vlog.h"
 
 #include <seastar/core/fstream.hh>
 #include <seastar/core/iostream.hh>
@@ -42,21 +44,114 @@ segment_index::segment_index(
     _state.base_offset = base;
 }
 
+segment_index::~segment_index() noexcept {
+    if (_cache) {
+        _cache->remove(*this);
+    }
+}
+
+segment_index::segment_index(segment_index&& o) noexcept
+  : _name(std::move(o._name))
+  , _out(std::move(o._out))
+  , _step(o._step)
+  , _acc(o._acc)
+  , _needs_persistence(o._needs_persistence)
+  , _materialized(o._materialized)
+  , _pinned(o._pinned)
+  , _pending_flushes(o._pending_flushes)
+  , _state(std::move(o._state))
+  , _cache(std::exchange(o._cache, nullptr))
+  , _tracked_bytes(std::exchange(o._tracked_bytes, 0))
+  , _materializing(std::move(o._materializing)) {
+    // take over the position in the index cache
+    _hook.swap_nodes(o._hook);
+}
+
+segment_index& segment_index::operator=(segment_index&& o) noexcept {
+    if (this != &o) {
+        if (_cache) {
+            _cache->remove(*this);
+        }
+        _name = std::move(o._name);
+        _out = std::move(o._out);
+        _step = o._step;
+        _acc = o._acc;
+        _needs_persistence = o._needs_persistence;
+        _materialized = o._materialized;
+        _pinned = o._pinned;
+        _pending_flushes = o._pending_flushes;
+        _state = std::move(o._state);
+        _cache = std::exchange(o._cache, nullptr);
+        _tracked_bytes = std::exchange(o._tracked_bytes, 0);
+        _materializing = std::move(o._materializing);
+        _hook.swap_nodes(o._hook);
+    }
+    return *this;
+}
+
+void segment_index::set_cache(index_cache* c) {
+    if (_cache) {
+        _cache->remove(*this);
+    }
+    _cache = c;
+    touch();
+}
+
+void segment_index::pin() {
+    _pinned = true;
+    if (_cache) {
+        _cache->remove(*this);
+    }
+}
+
+void segment_index::unpin() {
+    _pinned = false;
+    touch();
+}
+
+size_t segment_index::memory_usage() const {
+    return _state.relative_offset_index.capacity() * sizeof(uint32_t)
+           + _state.relative_time_index.capacity() * sizeof(uint32_t)
+           + _state.position_index.capacity() * sizeof(uint64_t);
+}
+
+void segment_index::touch() {
+    if (_cache) {
+        _cache->touch(*this);
+    }
+}
+
+void segment_index::unload() {
+    vassert(can_unload(), "Attempted to unload a dirty index: {}", *this);
+    _materialized = false;
+    _materializing.reset();
+    // release the memory, only the header fields are kept
+    _state.relative_offset_index = {};
+    _state.relative_time_index = {};
+    _state.position_index = {};
+}
+
 void segment_index::reset() {
     auto base = _state.base_offset;
     _state = {};
     _state.base_offset = base;
     _acc = 0;
+    _materialized = true;
+    touch();
 }
 
 void segment_index::swap_index_state(index_state&& o) {
     _needs_persistence = true;
     _acc = 0;
+    _materialized = true;
     std::swap(_state, o);
+    touch();
 }
 
 void segment_index::maybe_track(
   const model::record_batch_header& hdr, size_t filepos) {
+    vassert(
+      _materialized, "Attempted to index a batch in an unloaded index {}", *this);
     _acc += hdr.size_bytes;
     if (_state.maybe_index(
           _acc,
@@ -73,6 +168,7 @@ void segment_index::maybe_track(
 
 std::optional<segment_index::entry>
 segment_index::find_nearest(model::timestamp t) {
+    touch();
     if (t < _state.base_timestamp) {
         return std::nullopt;
     }
@@ -94,6 +190,7 @@ segment_index::find_nearest(model::timestamp t) {
 
 std::optional<segment_index::entry>
 segment_index::find_nearest(model::offset o) {
+    touch();
     if (o < _state.base_offset || _state.empty()) {
         return std::nullopt;
     }
@@ -121,6 +218,10 @@ ss::future<> segment_index::truncate(model::offset o) {
     if (o < _state.base_offset) {
         return ss::now();
     }
+    return ensure_materialized().then([this, o] { return do_truncate(o); });
+}
+
+ss::future<> segment_index::do_truncate(model::offset o) {
     const uint32_t i = o() - _state.base_offset();
     auto it = std::lower_bound(
       std::begin(_state.relative_offset_index),
@@ -163,10 +264,42 @@ ss::future<bool> segment_index::materialize_index() {
               return false;
           }
           _state = std::move(hydrated.value());
+          _materialized = true;
           return true;
       });
 }
 
+ss::future<> segment_index::ensure_materialized() {
+    if (_materialized) {
+        touch();
+        return ss::now();
+    }
+    if (!_materializing) {
+        _materializing = ss::shared_future<>(
+          materialize_index().then_wrapped([this](ss::future<bool> f) {
+              try {
+                  if (!f.get0()) {
+                      vlog(stlog.warn, "Failed to materialize index {}", _name);
+                  }
+              } catch (...) {
+                  vlog(
+                    stlog.warn,
+                    "Failed to materialize index {}: {}",
+                    _name,
+                    std::current_exception());
+              }
+              // lookups fall back to reading the segment from its start if
+              // the index can't be loaded
+              _materialized = true;
+              if (_cache) {
+                  _cache->record_materialization();
+              }
+              touch();
+          }));
+    }
+    return _materializing->get_future();
+}
+
 ss::future<> segment_index::drop_all_data() {
     reset();
     return _out.truncate(0);
@@ -177,6 +310,7 @@ ss::future<> segment_index::flush() {
         return ss::make_ready_future<>();
     }
     _needs_persistence = false;
+    ++_pending_flushes;
     return _out.truncate(0)
       .then(
         [this] { return ss::make_file_output_stream(ss::file(_out.dup())); })
@@ -194,10 +328,20 @@ ss::future<> segment_index::flush() {
                   .then([&out] { return out.flush(); })
                   .then([&out] { return out.close(); });
             });
+      })
+      .finally([this] {
+          --_pending_flushes;
+          touch();
       });
 }
 ss::future<> segment_index::close() {
-    return flush().then([this] { return _out.close(); });
+    return flush().then([this] {
+        if (_cache) {
+            _cache->remove(*this);
+            _cache = nullptr;
+        }
+        return _out.close();
+    });
 }
 std::ostream& operator<<(std::ostream& o, const segment_index& i) {
     return o << "{file:" << i.filename() << ", offsets:" << i.base_offset()
@@ -14,8 +14,10 @@
 #include "model/record.h"
 #include "model/timestamp.h"
 #include "storage/index_state.h"
+#include "utils/intrusive_list_helpers.h"
 
 #include <seastar/core/file.hh>
+#include <seastar/core/shared_future.hh>
 #include <seastar/core/unaligned.hh>
 
 #include <memory>
@@ -24,6 +26,8 @@
 
 namespace storage {
 
+class index_cache;
+
 /**
  * file file format is: [ header ] [ payload ]
  * header  == segment_index::header
@@ -50,9 +54,9 @@ public:
 
     segment_index(
       ss::sstring filename, ss::file, model::offset base, size_t step);
-    ~segment_index() noexcept = default;
-    segment_index(segment_index&&) noexcept = default;
-    segment_index& operator=(segment_index&&) noexcept = default;
+    ~segment_index() noexcept;
+    segment_index(segment_index&&) noexcept;
+    segment_index& operator=(segment_index&&) noexcept;
     segment_index(const segment_index&) = delete;
     segment_index& operator=(const segment_index&) = delete;
 
@@ -64,9 +68,26 @@ public:
     model::offset max_offset() const { return _state.max_offset; }
     model::timestamp max_timestamp() const { return _state.max_timestamp; }
     model::timestamp base_timestamp() const { return _state.base_timestamp; }
+    /// \brief checksum of the state last flushed or materialized
+    uint64_t checksum() const { return _state.checksum; }
     const ss::sstring& filename() const { return _name; }
 
     ss::future<bool> materialize_index();
+
+    /// \brief loads the entries if they were unloaded by the index cache.
+    /// lookups on an unloaded index return no entry, which is correct but
+    /// makes readers scan the segment from its start
+    ss::future<> ensure_materialized();
+    bool is_materialized() const { return _materialized; }
+
+    /// \brief keep the memory of the index within the shard wide budget
+    void set_cache(index_cache*);
+    /// \brief pinned indexes are never unloaded, used while the segment is
+    /// written to
+    void pin();
+    void unpin();
+    /// \brief memory used by the entries of the index
+    size_t memory_usage() const;
     ss::future<> close();
     ss::future<> flush();
     ss::future<> truncate(model::offset);
@@ -84,13 +105,36 @@ public:
     index_state release_index_state() && { return std::move(_state); }
 
 private:
+    friend class index_cache;
+
+    bool can_unload() const {
+        return _materialized && !_pinned && !_needs_persistence
+               && _pending_flushes == 0;
+    }
+    /// \brief called whenever the index is accessed or mutated to update the
+    /// shard wide tracking
+    void touch();
+    /// \brief releases the entries, they are materialized from disk on the
+    /// next lookup
+    void unload();
+    ss::future<> do_truncate(model::offset);
+
     ss::sstring _name;
     ss::file _out;
     size_t _step;
     size_t _acc{0};
     bool _needs_persistence{false};
+    bool _materialized{true};
+    bool _pinned{false};
+    size_t _pending_flushes{0};
     index_state _state;
 
+    index_cache* _cache{nullptr};
+    // memory accounted in the index cache
+    size_t _tracked_bytes{0};
+    intrusive_list_hook _hook;
+    std::optional<ss::shared_future<>> _materializing;
+
     friend std::ostream& operator<<(std::ostream&, const segment_index&);
 };
 
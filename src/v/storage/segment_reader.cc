@@ -29,21 +29,54 @@ segment_reader::segment_reader(
   , _file_size(file_size)
   , _buffer_size(buffer_size) {}
 
-ss::input_stream<char>
-segment_reader::data_stream(size_t pos, const ss::io_priority_class& pc) {
+ss::input_stream<char> segment_reader::data_stream(
+  size_t pos, const ss::io_priority_class& pc, uint32_t read_ahead) {
+    return data_stream(pos, pc, read_ahead, _buffer_size);
+}
+
+ss::input_stream<char> segment_reader::data_stream(
+  size_t pos,
+  const ss::io_priority_class& pc,
+  uint32_t read_ahead,
+  size_t buffer_size) {
     vassert(
       pos <= _file_size,
       "cannot read negative bytes. Asked to read at position: '{}' - {}",
       pos,
       *this);
     ss::file_input_stream_options options;
-    options.buffer_size = _buffer_size;
+    options.buffer_size = buffer_size;
     options.io_priority_class = pc;
-    options.read_ahead = 10;
+    options.read_ahead = read_ahead;
     return make_file_input_stream(
       _data_file, pos, _file_size - pos, std::move(options));
 }
 
+ss::input_stream<char> segment_reader::data_stream(
+  size_t pos, size_t limit, const ss::io_priority_class& pc) {
+    return data_stream(pos, limit, pc, default_read_ahead, _buffer_size);
+}
+
+ss::input_stream<char> segment_reader::data_stream(
+  size_t pos,
+  size_t limit,
+  const ss::io_priority_class& pc,
+  uint32_t read_ahead,
+  size_t buffer_size) {
+    vassert(
+      pos <= limit && limit <= _file_size,
+      "cannot read range [{}, {}) - {}",
+      pos,
+      limit,
+      *this);
+    ss::file_input_stream_options options;
+    options.buffer_size = buffer_size;
+    options.io_priority_class = pc;
+    options.read_ahead = read_ahead;
+    return make_file_input_stream(
+      _data_file, pos, limit - pos, std::move(options));
+}
+
 ss::future<> segment_reader::truncate(size_t n) {
     _file_size = n;
     return ss::open_file_dma(_filename, ss::open_flags::rw)
@@ -46,6 +46,9 @@ public:
     /// file name
     const ss::sstring& filename() const { return _filename; }
 
+    /// size of the buffers of the data streams
+    size_t buffer_size() const { return _buffer_size; }
+
     bool empty() const { return _file_size == 0; }
 
     /// close the underlying file handle
@@ -60,10 +63,37 @@ public:
     /// flushes the file metadata
     ss::future<> flush() { return _data_file.flush(); }
 
+    /// number of buffers the data streams read ahead by default
+    static constexpr uint32_t default_read_ahead = 10;
+
     /// create an input stream _sharing_ the underlying file handle
     /// starting at position @pos
+    ss::input_stream<char> data_stream(
+      size_t pos,
+      const ss::io_priority_class&,
+      uint32_t read_ahead = default_read_ahead);
+
+    /// same with buffers of @buffer_size instead of the buffer size of the
+    /// reader
+    ss::input_stream<char> data_stream(
+      size_t pos,
+      const ss::io_priority_class&,
+      uint32_t read_ahead,
+      size_t buffer_size);
+
+    /// create an input stream _sharing_ the underlying file handle
+    /// that returns the data in the range [@pos, @limit)
     ss::input_stream<char>
-    data_stream(size_t pos, const ss::io_priority_class&);
+    data_stream(size_t pos, size_t limit, const ss::io_priority_class&);
+
+    /// same with @read_ahead buffers of @buffer_size, used for the long
+    /// sequential reads of the whole range
+    ss::input_stream<char> data_stream(
+      size_t pos,
+      size_t limit,
+      const ss::io_priority_class&,
+      uint32_t read_ahead,
+      size_t buffer_size);
 
 private:
     ss::sstring _filename;
@@ -12,18 +12,22 @@
 #include "storage/fs_utils.h"
 #include "storage/log_replayer.h"
 #include "storage/logger.h"
+#include "storage/segment_summary.h"
 #include "utils/directory_walker.h"
 #include "vassert.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/loop.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/thread.hh>
 
+#include <absl/container/flat_hash_set.h>
 #include <fmt/format.h>
 
 #include <exception>
+#include <filesystem>
 
 namespace storage {
 struct segment_ordering {
@@ -34,14 +38,12 @@ struct segment_ordering {
     bool operator()(const type& seg, model::offset value) const {
         return seg->offsets().dirty_offset < value;
     }
-    bool operator()(const type& seg, model::timestamp value) const {
-        return seg->index().max_timestamp() < value;
-    }
 };
 
 segment_set::segment_set(segment_set::underlying_t segs)
   : _handles(std::move(segs)) {
     std::sort(_handles.begin(), _handles.end(), segment_ordering{});
+    rebuild_timestamp_bounds();
 }
 
 void segment_set::add(ss::lw_shared_ptr<segment> h) {
@@ -54,14 +56,67 @@ void segment_set::add(ss::lw_shared_ptr<segment> h) {
           _handles.back()->offsets().dirty_offset,
           *h,
           *this);
+        // the previous segment was rolled, its bounds are final
+        push_timestamp_bounds(*_handles.back());
     }
     _handles.emplace_back(std::move(h));
 }
 
-void segment_set::pop_back() { _handles.pop_back(); }
-void segment_set::pop_front() { _handles.pop_front(); }
+void segment_set::pop_back() {
+    _handles.pop_back();
+    // the new last segment is read from its index
+    if (!_timestamp_bounds.empty()) {
+        _timestamp_bounds.pop_back();
+    }
+}
+void segment_set::pop_front() {
+    _handles.pop_front();
+    rebuild_timestamp_bounds();
+}
 void segment_set::erase(iterator begin, iterator end) {
     _handles.erase(begin, end);
+    // compacting adjacent segments extends the bounds of the one kept
+    rebuild_timestamp_bounds();
+}
+
+void segment_set::push_timestamp_bounds(const segment& s) {
+    auto max_timestamp = s.index().max_timestamp();
+    if (!_timestamp_bounds.empty()) {
+        max_timestamp = std::max(max_timestamp, _timestamp_bounds.back());
+    }
+    _timestamp_bounds.push_back(max_timestamp);
+}
+
+void segment_set::rebuild_timestamp_bounds() {
+    _timestamp_bounds.clear();
+    if (_handles.empty()) {
+        return;
+    }
+    _timestamp_bounds.reserve(_handles.size() - 1);
+    for (size_t i = 0; i + 1 < _handles.size(); ++i) {
+        push_timestamp_bounds(*_handles[i]);
+    }
+}
+
+size_t segment_set::timestamp_lower_bound(model::timestamp needle) const {
+    auto it = std::partition_point(
+      _timestamp_bounds.begin(),
+      _timestamp_bounds.end(),
+      [needle](model::timestamp max_timestamp) {
+          return max_timestamp < needle;
+      });
+    const auto i = static_cast<size_t>(
+      std::distance(_timestamp_bounds.begin(), it));
+    if (i < _timestamp_bounds.size()) {
+        return i;
+    }
+    // only the last segment may contain the needle
+    if (
+      !_handles.empty() && !_handles.back()->empty()
+      && _handles.back()->index().max_timestamp() >= needle) {
+        return _handles.size() - 1;
+    }
+    return _handles.size();
 }
 
 template<typename Iterator>
@@ -74,16 +129,6 @@ struct needle_in_range {
         // must use max_offset
         return o <= s.offsets().dirty_offset && o >= s.offsets().base_offset;
     }
-
-    bool operator()(Iterator ptr, model::timestamp t) {
-        auto& s = **ptr;
-        if (s.empty()) {
-            return false;
-        }
-        // must use max_offset
-        return t <= s.index().max_timestamp()
-               && t >= s.index().base_timestamp();
-    }
 };
 
 template<typename Iterator, typename Needle>
@@ -130,15 +175,16 @@ segment_set::lower_bound(model::offset offset) const {
 // entry is greater than the target timestamp, the broker will do binary search
 // on that time index to find the closest index entry and scan the log from
 // there. Otherwise it will move on to the next log segment.
+//
+// The running max timestamp of the bounds is monotonic, the first segment
+// whose running max reaches the needle is the first one that may contain it.
 segment_set::iterator segment_set::lower_bound(model::timestamp needle) {
-    return std::lower_bound(
-      std::begin(_handles), std::end(_handles), needle, segment_ordering{});
+    return std::next(_handles.begin(), timestamp_lower_bound(needle));
 }
 
 segment_set::const_iterator
 segment_set::lower_bound(model::timestamp needle) const {
-    return segments_lower_bound(
-      std::cbegin(_handles), std::cend(_handles), needle);
+    return std::next(_handles.cbegin(), timestamp_lower_bound(needle));
 }
 
 std::ostream& operator<<(std::ostream& o, const segment_set& s) {
@@ -149,37 +195,122 @@ std::ostream& operator<<(std::ostream& o, const segment_set& s) {
     return o << "]}";
 }
 
+static bool is_clean_tail(
+  const segment& s, const std::optional<clean_segment_marker>& marker) {
+    if (!marker || marker->size_bytes == 0) {
+        return false;
+    }
+    auto name = std::filesystem::path(s.reader().filename().c_str()).filename();
+    return name.string() == std::string_view(marker->segment_name)
+           && marker->size_bytes == s.reader().file_size();
+}
+
+/// \brief loads the index of a sealed segment. When the index fails to load,
+/// or when it isn't the index the segment was sealed with, the bounds of the
+/// segment are taken from its summary if the summary is of the data file.
+/// Returns false when the segment has to be replayed
+static ss::future<bool>
+materialize_sealed_segment(ss::lw_shared_ptr<segment> s) {
+    auto summary = co_await segment_summary::read(
+      s->reader().filename().c_str());
+    if (
+      summary
+      && (summary->size_bytes == 0
+          || summary->size_bytes != s->reader().file_size())) {
+        // the data file was truncated or rewritten since it was sealed, the
+        // empty segments are removed by the replay
+        summary = std::nullopt;
+    }
+    std::exception_ptr ex;
+    bool materialized = false;
+    try {
+        materialized = co_await s->materialize_index();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (
+      materialized
+      && (!summary || summary->index_checksum == s->index().checksum())) {
+        co_return true;
+    }
+    if (!summary) {
+        if (ex) {
+            std::rethrow_exception(ex);
+        }
+        co_return false;
+    }
+    vlog(
+      stlog.info,
+      "Index {} of sealed segment {} can't be used, recovering the segment "
+      "from its summary {}",
+      s->index().filename(),
+      s->reader().filename(),
+      *summary);
+    co_await s->materialize_from_summary(*summary);
+    co_return true;
+}
+
 // Recover the last segment. Whenever we close a segment, we will likely
 // open a new one to which we will direct new writes. That new segment
 // might be empty. To optimize log replay, implement #140.
-static ss::future<segment_set>
-unsafe_do_recover(segment_set&& segments, ss::abort_source& as) {
-    return ss::async([segments = std::move(segments), &as]() mutable {
+static ss::future<segment_set> unsafe_do_recover(
+  segment_set&& segments,
+  std::optional<clean_segment_marker> clean_marker,
+  ss::semaphore& io_units,
+  ss::abort_source& as) {
+    return ss::async([segments = std::move(segments),
+                      clean_marker = std::move(clean_marker),
+                      &io_units,
+                      &as]() mutable {
         if (segments.empty() || as.abort_requested()) {
             return std::move(segments);
         }
         segment_set::underlying_t good = std::move(segments).release();
         segment_set::underlying_t to_recover;
-        to_recover.push_back(std::move(good.back()));
-        good.pop_back(); // always recover last segment
+        // the tail of a cleanly closed log has a consistent index, otherwise
+        // always recover last segment
+        const bool clean_tail = is_clean_tail(*good.back(), clean_marker);
+        if (clean_tail) {
+            vlog(
+              stlog.debug,
+              "Skipping recovery of cleanly closed segment {}",
+              good.back());
+        } else {
+            to_recover.push_back(std::move(good.back()));
+            good.pop_back();
+        }
+        absl::flat_hash_set<segment*> failed;
+        ss::parallel_for_each(
+          good,
+          [&io_units, &failed](ss::lw_shared_ptr<segment>& s) {
+              // use the segment materialize instead of going through
+              // the index directly to hydrate the max_offset state
+              return ss::with_semaphore(
+                       io_units,
+                       1,
+                       [s] { return materialize_sealed_segment(s); })
+                .then_wrapped([s, &failed](ss::future<bool> f) {
+                    try {
+                        if (f.get0()) {
+                            return;
+                        }
+                    } catch (...) {
+                        vlog(
+                          stlog.info,
+                          "Error materializing index:{}. Recovering parent "
+                          "segment:{}. Details:{}",
+                          s->index().filename(),
+                          s->reader().filename(),
+                          std::current_exception());
+                    }
+                    failed.insert(s.get());
+                });
+          })
+          .get();
         // keep segments sorted
         auto good_end = std::stable_partition(
-          good.begin(), good.end(), [](ss::lw_shared_ptr<segment>& ss) {
-              auto& s = *ss;
-              try {
-                  // use the segment materialize instead of going through
-                  // the index directly to hydrate the max_offset state
-                  return s.materialize_index().get0();
-              } catch (...) {
-                  vlog(
-                    stlog.info,
-                    "Error materializing index:{}. Recovering parent "
-                    "segment:{}. Details:{}",
-                    s.index().filename(),
-                    s.reader().filename(),
-                    std::current_exception());
-              }
-              return false;
+          good.begin(), good.end(), [&failed](ss::lw_shared_ptr<segment>& s) {
+              return !failed.contains(s.get());
           });
         std::move(
           std::move_iterator(good_end),
@@ -202,13 +333,15 @@ unsafe_do_recover(segment_set&& segments, ss::abort_source& as) {
               segment->close().get();
               ss::remove_file(segment->reader().filename()).get();
               ss::remove_file(segment->index().filename()).get();
+              segment_summary::remove(segment->reader().filename().c_str())
+                .get();
               return false;
           });
         // remove empty from to recover set
         to_recover.erase(non_empty_end, to_recover.end());
         // we left with nothing to recover, take the last good segment if
         // available
-        if (to_recover.empty() && !good.empty()) {
+        if (to_recover.empty() && !good.empty() && !clean_tail) {
             to_recover.push_back(std::move(good.back()));
             good.pop_back();
         }
@@ -218,6 +351,7 @@ unsafe_do_recover(segment_set&& segments, ss::abort_source& as) {
             if (unlikely(as.abort_requested())) {
                 return segment_set(std::move(good));
             }
+            auto units = ss::get_units(io_units, 1).get0();
             auto replayer = log_replayer(*s);
             auto recovered = replayer.recover_in_thread(
               ss::default_priority_class());
@@ -243,8 +377,11 @@ unsafe_do_recover(segment_set&& segments, ss::abort_source& as) {
     });
 }
 
-static ss::future<segment_set>
-do_recover(segment_set&& segments, ss::abort_source& as) {
+static ss::future<segment_set> do_recover(
+  segment_set&& segments,
+  std::optional<clean_segment_marker> clean_marker,
+  ss::semaphore& io_units,
+  ss::abort_source& as) {
     // light-weight copy used for clean-up if recovery fails
     segment_set::underlying_t copy;
     copy.reserve(segments.size());
@@ -256,7 +393,8 @@ do_recover(segment_set&& segments, ss::abort_source& as) {
     // are any pending io operations on a file associated with the segment
     // at the time of destruction seastar will complain about the file handle
     // being destroyed with pending ops.
-    return unsafe_do_recover(std::move(segments), as)
+    return unsafe_do_recover(
+             std::move(segments), std::move(clean_marker), io_units, as)
       .handle_exception(
         [copy = std::move(copy)](const std::exception_ptr& ex) mutable {
             return ss::do_with(
@@ -280,22 +418,25 @@ do_recover(segment_set&& segments, ss::abort_source& as) {
  * \brief Open all segments in a directory.
  *
  * Returns an exceptional future if any error occured opening a
- * segment. Otherwise all open segment readers are returned.
+ * segment. Otherwise all open segment readers are returned. The segments are
+ * opened concurrently, each open holds one of the io units.
  */
 static ss::future<segment_set::underlying_t> open_segments(
   ss::sstring dir,
   debug_sanitize_files sanitize_fileops,
   std::function<std::optional<batch_cache_index>()> cache_factory,
+  ss::semaphore& io_units,
   ss::abort_source& as) {
     using segs_type = segment_set::underlying_t;
+    using paths_type = std::vector<std::filesystem::path>;
     return ss::do_with(
       segs_type{},
-      [&as, cache_factory, sanitize_fileops, dir = std::move(dir)](
-        segs_type& segs) {
+      paths_type{},
+      [&as, &io_units, cache_factory, sanitize_fileops, dir = std::move(dir)](
+        segs_type& segs, paths_type& paths) {
           auto f = directory_walker::walk(
             dir,
-            [&as, cache_factory, dir, sanitize_fileops, &segs](
-              ss::directory_entry seg) {
+            [&as, dir, &paths](ss::directory_entry seg) {
                 // abort if requested
                 if (as.abort_requested()) {
                     return ss::now();
@@ -319,11 +460,34 @@ static ss::future<segment_set::underlying_t> open_segments(
                     // not a reader filename
                     return ss::make_ready_future<>();
                 }
-                return open_segment(path, sanitize_fileops, cache_factory())
-                  .then([&segs](ss::lw_shared_ptr<segment> p) {
-                      segs.push_back(std::move(p));
-                  });
+                paths.push_back(std::move(path));
+                return ss::now();
             });
+          f = f.then([&as,
+                      &io_units,
+                      cache_factory,
+                      sanitize_fileops,
+                      &segs,
+                      &paths] {
+              return ss::parallel_for_each(
+                paths,
+                [&as, &io_units, cache_factory, sanitize_fileops, &segs](
+                  const std::filesystem::path& path) {
+                    return ss::with_semaphore(
+                      io_units,
+                      1,
+                      [&as, &path, cache_factory, sanitize_fileops, &segs] {
+                          if (as.abort_requested()) {
+                              return ss::now();
+                          }
+                          return open_segment(
+                                   path, sanitize_fileops, cache_factory())
+                            .then([&segs](ss::lw_shared_ptr<segment> p) {
+                                segs.push_back(std::move(p));
+                            });
+                      });
+                });
+          });
           /*
            * if the directory walker returns an exceptional future then all
            * the segment readers that were created are cleaned up by
@@ -340,13 +504,16 @@ ss::future<segment_set> recover_segments(
   debug_sanitize_files sanitize_fileops,
   bool is_compaction_enabled,
   std::function<std::optional<batch_cache_index>()> cache_factory,
-  ss::abort_source& as) {
-    return ss::recursive_touch_directory(path.string())
-      .then([&as, cache_factory, sanitize_fileops, path = std::move(path)] {
-          return open_segments(
-            path.string(), sanitize_fileops, cache_factory, as);
-      })
-      .then([&as, is_compaction_enabled](segment_set::underlying_t segs) {
+  ss::abort_source& as,
+  ss::semaphore& io_units,
+  std::optional<clean_segment_marker> clean_marker) {
+    return open_segments(
+             path.string(), sanitize_fileops, cache_factory, io_units, as)
+      .then([&as,
+             &io_units,
+             is_compaction_enabled,
+             clean_marker = std::move(clean_marker)](
+              segment_set::underlying_t segs) mutable {
           auto segments = segment_set(std::move(segs));
           // we have to mark compacted segments before recovery to allow reading
           // gaps introduced by compaction
@@ -355,7 +522,8 @@ ss::future<segment_set> recover_segments(
                   s->mark_as_compacted_segment();
               }
           }
-          return do_recover(std::move(segments), as);
+          return do_recover(
+            std::move(segments), std::move(clean_marker), io_units, as);
       });
 }
 
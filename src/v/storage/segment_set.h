@@ -14,6 +14,7 @@
 #include "storage/segment.h"
 
 #include <seastar/core/circular_buffer.hh>
+#include <seastar/core/semaphore.hh>
 
 #include <deque>
 
@@ -71,6 +72,9 @@ public:
 
     iterator lower_bound(model::offset o);
     const_iterator lower_bound(model::offset o) const;
+    /// \brief first segment that may contain a batch with a timestamp
+    /// greater than or equal to the needle, binary searched in the bounds of
+    /// the segments kept by the set
     iterator lower_bound(model::timestamp o);
     const_iterator lower_bound(model::timestamp o) const;
 
@@ -82,17 +86,42 @@ public:
     const_iterator end() const { return _handles.end(); }
 
 private:
+    size_t timestamp_lower_bound(model::timestamp) const;
+    void push_timestamp_bounds(const segment&);
+    void rebuild_timestamp_bounds();
+
     underlying_t _handles;
+    // the max timestamp of every segment but the last one, and of all the
+    // segments before it: the timestamps of the batches are set by the
+    // producers and don't have to increase from one segment to the next. The
+    // last segment is still appended to, its bounds are read from its index.
+    ss::circular_buffer<model::timestamp> _timestamp_bounds;
 
     friend std::ostream& operator<<(std::ostream&, const segment_set&);
 };
 
+/// \brief recorded when the log is closed cleanly. The index of the last
+/// segment is consistent with its data so the segment doesn't have to be
+/// replayed on the next start if it wasn't modified since.
+struct clean_segment_marker {
+    // file name of the segment, without the directory
+    ss::sstring segment_name;
+    uint64_t size_bytes{0};
+};
+
+/// \brief opens the segments in the directory and recovers the tail
+///
+/// segments are opened and their indexes loaded concurrently, every disk
+/// operation holds one of the `io_units` so the concurrency can be bounded
+/// across all the logs recovered at the same time. The directory must exist.
 ss::future<segment_set> recover_segments(
   std::filesystem::path path,
   debug_sanitize_files sanitize_fileops,
   bool is_compaction_enabled,
   std::function<std::optional<batch_cache_index>()> batch_cache_factory,
-  ss::abort_source& as);
+  ss::abort_source& as,
+  ss::semaphore& io_units,
+  std::optional<clean_segment_marker> clean_marker = std::nullopt);
 
 std::ostream& operator<<(std::ostream&, const segment_set&);
 
@@ -0,0 +1,158 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/segment_summary.h"
+
+#include "bytes/iobuf_parser.h"
+#include "bytes/utils.h"
+#include "hashing/crc32c.h"
+#include "reflection/adl.h"
+#include "storage/segment.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+
+#include <fmt/ostream.h>
+
+namespace storage {
+
+segment_summary segment_summary::of(const segment& s) {
+    return segment_summary{
+      .base_offset = s.offsets().base_offset,
+      .max_offset = s.offsets().dirty_offset,
+      .base_timestamp = s.index().base_timestamp(),
+      .max_timestamp = s.index().max_timestamp(),
+      .term = s.offsets().term,
+      .size_bytes = s.reader().file_size(),
+      .index_checksum = s.index().checksum(),
+    };
+}
+
+std::filesystem::path
+segment_summary::path(std::filesystem::path segment_path) {
+    return segment_path.replace_extension(".summary");
+}
+
+iobuf segment_summary::serialize() const {
+    iobuf fields;
+    reflection::serialize(
+      fields,
+      base_offset,
+      max_offset,
+      base_timestamp.value(),
+      max_timestamp.value(),
+      term,
+      size_bytes,
+      index_checksum);
+    crc::crc32c crc;
+    crc_extend_iobuf(crc, fields);
+
+    iobuf out;
+    reflection::serialize(out, current_version, crc.value());
+    out.append(std::move(fields));
+    return out;
+}
+
+std::optional<segment_summary> segment_summary::deserialize(iobuf b) {
+    constexpr size_t header_size = sizeof(int8_t) + sizeof(uint32_t);
+    constexpr size_t fields_size = 7 * sizeof(int64_t);
+    if (b.size_bytes() != header_size + fields_size) {
+        return std::nullopt;
+    }
+    iobuf_parser parser(std::move(b));
+    const auto version = reflection::adl<int8_t>{}.from(parser);
+    const auto expected_crc = reflection::adl<uint32_t>{}.from(parser);
+    if (version != current_version) {
+        return std::nullopt;
+    }
+    auto fields = parser.share(fields_size);
+    crc::crc32c crc;
+    crc_extend_iobuf(crc, fields);
+    if (crc.value() != expected_crc) {
+        return std::nullopt;
+    }
+    iobuf_parser in(std::move(fields));
+    segment_summary ret;
+    ret.base_offset = reflection::adl<model::offset>{}.from(in);
+    ret.max_offset = reflection::adl<model::offset>{}.from(in);
+    ret.base_timestamp = model::timestamp(reflection::adl<int64_t>{}.from(in));
+    ret.max_timestamp = model::timestamp(reflection::adl<int64_t>{}.from(in));
+    ret.term = reflection::adl<model::term_id>{}.from(in);
+    ret.size_bytes = reflection::adl<uint64_t>{}.from(in);
+    ret.index_checksum = reflection::adl<uint64_t>{}.from(in);
+    return ret;
+}
+
+ss::future<std::optional<segment_summary>>
+segment_summary::read(std::filesystem::path segment_path) {
+    auto name = path(std::move(segment_path)).string();
+    if (!co_await ss::file_exists(name)) {
+        co_return std::nullopt;
+    }
+    auto f = co_await ss::open_file_dma(name, ss::open_flags::ro);
+    std::exception_ptr ex;
+    iobuf b;
+    try {
+        const auto size = co_await f.size();
+        b.append(co_await f.dma_read_bulk<char>(0, size));
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await f.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_return deserialize(std::move(b));
+}
+
+ss::future<> segment_summary::write(std::filesystem::path segment_path) const {
+    // not synced: a summary lost or torn by a crash is ignored on recovery
+    auto f = co_await ss::open_file_dma(
+      path(std::move(segment_path)).string(),
+      ss::open_flags::wo | ss::open_flags::create | ss::open_flags::truncate);
+    auto out = co_await ss::make_file_output_stream(std::move(f));
+    std::exception_ptr ex;
+    try {
+        for (const auto& fragment : serialize()) {
+            co_await out.write(fragment.get(), fragment.size());
+        }
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+}
+
+ss::future<> segment_summary::remove(std::filesystem::path segment_path) {
+    auto name = path(std::move(segment_path)).string();
+    if (co_await ss::file_exists(name)) {
+        co_await ss::remove_file(name);
+    }
+}
+
+std::ostream& operator<<(std::ostream& o, const segment_summary& s) {
+    fmt::print(
+      o,
+      "{{base_offset: {}, max_offset: {}, base_timestamp: {}, max_timestamp: "
+      "{}, term: {}, size_bytes: {}, index_checksum: {}}}",
+      s.base_offset,
+      s.max_offset,
+      s.base_timestamp,
+      s.max_timestamp,
+      s.term,
+      s.size_bytes,
+      s.index_checksum);
+    return o;
+}
+
+} // namespace storage
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/iobuf.h"
+#include "model/fundamental.h"
+#include "model/timestamp.h"
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+
+namespace storage {
+
+class segment;
+
+/**
+ * Sidecar of a sealed segment, written next to it when the segment stops
+ * being appended to:
+ *
+ *     default/test/0/1-1-v1.summary
+ *
+ * The summary is valid for the data file of the size it records. When the
+ * index of a sealed segment can't be loaded on recovery, or it is not the
+ * index the summary was written with, the bounds of the segment are taken
+ * from the summary instead of replaying the segment. The segment reads then
+ * scan it from its start, as when an index fails to load at runtime.
+ *
+ *   1 byte  - version
+ *   4 bytes - crc32c of the fields below
+ *   8 bytes - base_offset
+ *   8 bytes - max_offset
+ *   8 bytes - base_timestamp
+ *   8 bytes - max_timestamp
+ *   8 bytes - term
+ *   8 bytes - size_bytes
+ *   8 bytes - index_checksum
+ */
+struct segment_summary {
+    static constexpr int8_t current_version = 0;
+
+    model::offset base_offset;
+    model::offset max_offset;
+    model::timestamp base_timestamp;
+    model::timestamp max_timestamp;
+    model::term_id term;
+    /// \brief size of the data file
+    uint64_t size_bytes{0};
+    /// \brief checksum of the index state flushed when the segment was sealed
+    uint64_t index_checksum{0};
+
+    /// \brief the summary of a sealed segment, its index flushed
+    static segment_summary of(const segment&);
+
+    static std::filesystem::path path(std::filesystem::path segment_path);
+
+    iobuf serialize() const;
+    /// \brief nullopt when the buffer is torn, or of a different version
+    static std::optional<segment_summary> deserialize(iobuf);
+
+    /// \brief the summary of the segment if it exists and is intact,
+    /// whether it matches the data file is checked by the caller
+    static ss::future<std::optional<segment_summary>>
+    read(std::filesystem::path segment_path);
+    ss::future<> write(std::filesystem::path segment_path) const;
+    static ss::future<> remove(std::filesystem::path segment_path);
+
+    friend bool operator==(const segment_summary&, const segment_summary&)
+      = default;
+    friend std::ostream& operator<<(std::ostream&, const segment_summary&);
+};
+
+} // namespace storage
@@ -10,6 +10,7 @@
 #include "storage/segment_utils.h"
 
 #include "bytes/iobuf_parser.h"
+#include "config/configuration.h"
 #include "likely.h"
 #include "model/adl_serde.h"
 #include "model/fundamental.h"
@@ -20,8 +21,10 @@
 #include "storage/compacted_index.h"
 #include "storage/compacted_index_writer.h"
 #include "storage/compaction_reducers.h"
+#include "storage/disk_tuning.h"
 #include "storage/fwd.h"
 #include "storage/index_state.h"
+#include "storage/io_latency_probe.h"
 #include "storage/lock_manager.h"
 #include "storage/log_reader.h"
 #include "storage/logger.h"
@@ -46,6 +49,7 @@
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/when_all.hh>
 #include <seastar/util/defer.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 #include <absl/container/btree_map.h>
 #include <absl/container/flat_hash_map.h>
@@ -93,22 +97,26 @@ ss::future<ss::file> make_writer_handle(
     return make_handle(
       path, ss::open_flags::rw | ss::open_flags::create, writer_opts(), debug);
 }
-/// make file handle with default opts
+/// make file handle with default opts, its reads are measured
 ss::future<ss::file> make_reader_handle(
   const std::filesystem::path& path, storage::debug_sanitize_files debug) {
     return make_handle(
-      path,
-      ss::open_flags::ro | ss::open_flags::create,
-      ss::file_open_options{},
-      debug);
+             path,
+             ss::open_flags::ro | ss::open_flags::create,
+             ss::file_open_options{},
+             debug)
+      .then([](ss::file f) {
+          return io_latency_probe::measure_reads(std::move(f));
+      });
 }
 
 ss::future<compacted_index_writer> make_compacted_index_writer(
   const std::filesystem::path& path,
   debug_sanitize_files debug,
-  ss::io_priority_class iopc) {
+  ss::io_priority_class iopc,
+  compacted_index::key_digests_mode key_digests) {
     return internal::make_writer_handle(path, debug)
-      .then([iopc, path](ss::file writer) {
+      .then([iopc, path, key_digests](ss::file writer) {
           try {
               // NOTE: This try-catch is needed to not uncover the real
               // exception during an OOM condition, since the appender allocates
@@ -118,7 +126,9 @@ ss::future<compacted_index_writer> make_compacted_index_writer(
                   path.string(),
                   writer,
                   iopc,
-                  segment_appender::write_behind_memory / 2));
+                  segment_appender::write_behind_memory / 2,
+                  key_digests,
+                  compacted_index::key_filter_mode::yes));
           } catch (...) {
               auto e = std::current_exception();
               vlog(stlog.error, "could not allocate compacted-index: {}", e);
@@ -133,16 +143,21 @@ ss::future<segment_appender_ptr> make_segment_appender(
   const std::filesystem::path& path,
   debug_sanitize_files debug,
   size_t number_of_chunks,
-  ss::io_priority_class iopc) {
+  ss::io_priority_class iopc,
+  flush_scheduler* flusher) {
     return internal::make_writer_handle(path, debug)
-      .then([number_of_chunks, iopc, path](ss::file writer) {
+      .then([number_of_chunks, iopc, path, flusher](ss::file writer) {
           try {
               // NOTE: This try-catch is needed to not uncover the real
               // exception during an OOM condition, since the appender allocates
               // 1MB of memory aligned buffers
+              auto opts = segment_appender::options(
+                iopc,
+                number_of_chunks,
+                disk_tuning::local().fallocation_step);
+              opts.flusher = flusher;
               return ss::make_ready_future<segment_appender_ptr>(
-                std::make_unique<segment_appender>(
-                  writer, segment_appender::options(iopc, number_of_chunks)));
+                std::make_unique<segment_appender>(writer, opts));
           } catch (...) {
               auto e = std::current_exception();
               vlog(stlog.error, "could not allocate appender: {}", e);
@@ -154,14 +169,15 @@ ss::future<segment_appender_ptr> make_segment_appender(
 }
 
 size_t number_of_chunks_from_config(const ntp_config& ntpc) {
+    const auto chunks = disk_tuning::local().write_behind_chunks;
     if (!ntpc.has_overrides()) {
-        return segment_appender::chunks_no_buffer;
+        return chunks;
     }
     auto& o = ntpc.get_overrides();
     if (o.compaction_strategy) {
-        return segment_appender::chunks_no_buffer / 2;
+        return chunks / 2;
     }
-    return segment_appender::chunks_no_buffer;
+    return chunks;
 }
 
 ss::future<Roaring>
@@ -179,10 +195,18 @@ ss::future<> copy_filtered_entries(
       [bm = std::move(to_copy_index),
        reader](compacted_index_writer& writer) mutable {
           reader.reset();
-          return reader
-            .consume(
-              index_filtered_copy_reducer(std::move(bm), writer),
-              model::no_timeout)
+          return reader.load_footer()
+            .then([reader, &writer, bm = std::move(bm)](
+                    compacted_index::footer footer) mutable {
+                // the keys are copied as they are, writer does not rehash them
+                using flags = compacted_index::footer_flags;
+                if (bool(footer.flags & flags::key_digests)) {
+                    writer.set_flag(flags::key_digests);
+                }
+                return reader.consume(
+                  index_filtered_copy_reducer(std::move(bm), writer),
+                  model::no_timeout);
+            })
             // must be last
             .finally([&writer] {
                 writer.set_flag(compacted_index::footer_flags::self_compaction);
@@ -192,36 +216,43 @@ ss::future<> copy_filtered_entries(
       });
 }
 
+static ss::future<> do_write_filtered_compacted_index(
+  compacted_index_reader reader, Roaring bitmap, compaction_config cfg) {
+    const auto tmpname = std::filesystem::path(
+      fmt::format("{}.staging", reader.filename()));
+    return make_handle(
+             tmpname,
+             ss::open_flags::rw | ss::open_flags::truncate
+               | ss::open_flags::create,
+             writer_opts(),
+             cfg.sanitize)
+      .then([tmpname, cfg, reader, bm = std::move(bitmap)](ss::file f) mutable {
+          auto writer = make_file_backed_compacted_index(
+            tmpname.string(),
+            std::move(f),
+            cfg.iopc,
+            // TODO: pass this memory from the cfg
+            segment_appender::write_behind_memory / 2,
+            compacted_index::key_digests_mode::no,
+            compacted_index::key_filter_mode::yes);
+          return copy_filtered_entries(
+            reader, std::move(bm), std::move(writer));
+      })
+      .then([old_name = tmpname.string(), new_name = reader.filename()] {
+          // from glibc: If oldname is not a directory, then any
+          // existing file named newname is removed during the
+          // renaming operation
+          return ss::rename_file(old_name, new_name);
+      });
+}
+
 static ss::future<> do_write_clean_compacted_index(
   compacted_index_reader reader, compaction_config cfg) {
-    return natural_index_of_entries_to_keep(reader).then([reader,
-                                                          cfg](Roaring bitmap) {
-        const auto tmpname = std::filesystem::path(
-          fmt::format("{}.staging", reader.filename()));
-        return make_handle(
-                 tmpname,
-                 ss::open_flags::rw | ss::open_flags::truncate
-                   | ss::open_flags::create,
-                 writer_opts(),
-                 cfg.sanitize)
-          .then(
-            [tmpname, cfg, reader, bm = std::move(bitmap)](ss::file f) mutable {
-                auto writer = make_file_backed_compacted_index(
-                  tmpname.string(),
-                  std::move(f),
-                  cfg.iopc,
-                  // TODO: pass this memory from the cfg
-                  segment_appender::write_behind_memory / 2);
-                return copy_filtered_entries(
-                  reader, std::move(bm), std::move(writer));
-            })
-          .then([old_name = tmpname.string(), new_name = reader.filename()] {
-              // from glibc: If oldname is not a directory, then any
-              // existing file named newname is removed during the
-              // renaming operation
-              return ss::rename_file(old_name, new_name);
-          });
-    });
+    return natural_index_of_entries_to_keep(reader).then(
+      [reader, cfg](Roaring bitmap) {
+          return do_write_filtered_compacted_index(
+            reader, std::move(bitmap), cfg);
+      });
 }
 
 ss::future<> write_clean_compacted_index(
@@ -292,6 +323,55 @@ do_compact_segment_index(ss::lw_shared_ptr<segment> s, compaction_config cfg) {
           return write_clean_compacted_index(reader, cfg);
       });
 }
+static model::record_batch_reader make_segment_reader(
+  ss::lw_shared_ptr<storage::segment> s,
+  log_reader_config reader_cfg,
+  storage::probe& pb,
+  std::optional<ss::rwlock::holder> h) {
+    segment_set::underlying_t set;
+    set.reserve(1);
+    set.push_back(s);
+    auto lease = std::make_unique<lock_manager::lease>(
+      segment_set(std::move(set)));
+    if (h) {
+        lease->locks.push_back(std::move(*h));
+    }
+    return model::make_record_batch_reader<log_reader>(
+      std::move(lease), reader_cfg, pb);
+}
+
+static model::record_batch_reader make_segment_full_reader(
+  ss::lw_shared_ptr<storage::segment> s,
+  storage::compaction_config cfg,
+  storage::probe& pb,
+  std::optional<ss::rwlock::holder> h) {
+    auto o = s->offsets();
+    auto reader_cfg = log_reader_config(
+      o.base_offset, o.dirty_offset, cfg.iopc);
+    reader_cfg.skip_batch_cache = true;
+    return make_segment_reader(std::move(s), reader_cfg, pb, std::move(h));
+}
+
+/// An index of key digests only knows which records share a digest. Collect
+/// the fingerprints of the keys of the records that are kept so that the copy
+/// keeps the records whose keys collided with a different key.
+///
+/// The caller holds the segment read lock for both the passes.
+static ss::future<std::optional<copy_data_segment_reducer::key_fingerprints>>
+maybe_collect_key_fingerprints(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  storage::probe& pb,
+  compacted_index::footer footer,
+  const compacted_offset_list& list) {
+    if (!bool(footer.flags & compacted_index::footer_flags::key_digests)) {
+        co_return std::nullopt;
+    }
+    auto r = make_segment_full_reader(s, cfg, pb, std::nullopt);
+    co_return co_await std::move(r).consume(
+      key_fingerprint_reducer(list), model::no_timeout);
+}
+
 ss::future<storage::index_state> do_copy_segment_data(
   ss::lw_shared_ptr<segment> s,
   compaction_config cfg,
@@ -304,37 +384,63 @@ ss::future<storage::index_state> do_copy_segment_data(
           auto reader = make_file_backed_compacted_reader(
             idx_path.string(), std::move(f), cfg.iopc, 64_KiB);
           return generate_compacted_list(s->offsets().base_offset, reader)
+            .then([reader](compacted_offset_list list) mutable {
+                // footer is already loaded by the consumer
+                return reader.load_footer().then(
+                  [list = std::move(list)](
+                    compacted_index::footer footer) mutable {
+                      return std::make_pair(std::move(list), footer);
+                  });
+            })
             .finally([reader]() mutable {
                 return reader.close().then_wrapped([](ss::future<>) {});
             });
       })
-      .then(
-        [cfg, s, &pb, h = std::move(h)](compacted_offset_list list) mutable {
-            const auto tmpname = data_segment_staging_name(s);
-            return make_segment_appender(
-                     tmpname,
-                     cfg.sanitize,
-                     segment_appender::chunks_no_buffer,
-                     cfg.iopc)
-              .then([l = std::move(list), &pb, h = std::move(h), cfg, s](
-                      segment_appender_ptr w) mutable {
-                  auto raw = w.get();
-                  auto red = copy_data_segment_reducer(std::move(l), raw);
-                  auto r = create_segment_full_reader(s, cfg, pb, std::move(h));
-                  return std::move(r)
-                    .consume(std::move(red), model::no_timeout)
-                    .finally([raw, w = std::move(w)]() mutable {
-                        return raw->close()
-                          .handle_exception([](std::exception_ptr e) {
-                              vlog(
-                                stlog.error,
-                                "Error copying index to new segment:{}",
-                                e);
-                          })
-                          .finally([w = std::move(w)] {});
+      .then([cfg, s, &pb](
+              std::pair<compacted_offset_list, compacted_index::footer> p) {
+          return ss::do_with(
+            std::move(p.first),
+            [cfg, s, &pb, footer = p.second](compacted_offset_list& list) {
+                return maybe_collect_key_fingerprints(s, cfg, pb, footer, list)
+                  .then(
+                    [&list](
+                      std::optional<copy_data_segment_reducer::key_fingerprints>
+                        fps) {
+                        return std::make_pair(std::move(list), std::move(fps));
                     });
-              });
-        });
+            });
+      })
+      .then([cfg, s, &pb, h = std::move(h)](
+              std::pair<
+                compacted_offset_list,
+                std::optional<copy_data_segment_reducer::key_fingerprints>>
+                p) mutable {
+          const auto tmpname = data_segment_staging_name(s);
+          return make_segment_appender(
+                   tmpname,
+                   cfg.sanitize,
+                   segment_appender::chunks_no_buffer,
+                   cfg.iopc)
+            .then([p = std::move(p), &pb, h = std::move(h), cfg, s](
+                    segment_appender_ptr w) mutable {
+                auto raw = w.get();
+                auto red = copy_data_segment_reducer(
+                  std::move(p.first), raw, std::move(p.second));
+                auto r = create_segment_full_reader(s, cfg, pb, std::move(h));
+                return std::move(r)
+                  .consume(std::move(red), model::no_timeout)
+                  .finally([raw, w = std::move(w)]() mutable {
+                      return raw->close()
+                        .handle_exception([](std::exception_ptr e) {
+                            vlog(
+                              stlog.error,
+                              "Error copying index to new segment:{}",
+                              e);
+                        })
+                        .finally([w = std::move(w)] {});
+                  });
+            });
+      });
 }
 
 model::record_batch_reader create_segment_full_reader(
@@ -342,18 +448,8 @@ model::record_batch_reader create_segment_full_reader(
   storage::compaction_config cfg,
   storage::probe& pb,
   ss::rwlock::holder h) {
-    auto o = s->offsets();
-    auto reader_cfg = log_reader_config(
-      o.base_offset, o.dirty_offset, cfg.iopc);
-    reader_cfg.skip_batch_cache = true;
-    segment_set::underlying_t set;
-    set.reserve(1);
-    set.push_back(s);
-    auto lease = std::make_unique<lock_manager::lease>(
-      segment_set(std::move(set)));
-    lease->locks.push_back(std::move(h));
-    return model::make_record_batch_reader<log_reader>(
-      std::move(lease), reader_cfg, pb);
+    return make_segment_full_reader(
+      std::move(s), cfg, pb, std::optional<ss::rwlock::holder>(std::move(h)));
 }
 
 ss::future<> do_swap_data_file_handles(
@@ -393,26 +489,25 @@ ss::future<> do_swap_data_file_handles(
 }
 
 /**
- * Executes segment compaction, returns size of compacted segment
+ * Copies the data of the segment to its staging file with `copy_data`, under
+ * the read lock, and then swaps the staging file for the data of the segment
+ * under the write lock. Returns the size of the rewritten segment
  */
-ss::future<size_t> do_self_compact_segment(
+static ss::future<size_t> do_rewrite_segment_data(
   ss::lw_shared_ptr<segment> s,
   compaction_config cfg,
   storage::probe& pb,
-  storage::readers_cache& readers_cache) {
+  storage::readers_cache& readers_cache,
+  ss::noncopyable_function<ss::future<index_state>(ss::rwlock::holder)>
+    copy_data) {
     return s->read_lock()
-      .then([cfg, s, &pb](ss::rwlock::holder h) {
+      .then([s, copy_data = std::move(copy_data)](
+              ss::rwlock::holder h) mutable {
           if (s->is_closed()) {
               return ss::make_exception_future<index_state>(
                 segment_closed_exception());
           }
-
-          return do_compact_segment_index(s, cfg)
-            // copy the bytes after segment is good - note that we
-            // need to do it with the READ-lock, not the write lock
-            .then([cfg, s, h = std::move(h), &pb]() mutable {
-                return do_copy_segment_data(s, cfg, pb, std::move(h));
-            });
+          return copy_data(std::move(h));
       })
       .then([s, &readers_cache](storage::index_state idx) {
           return readers_cache.evict_segment_readers(s).then(
@@ -450,11 +545,56 @@ ss::future<size_t> do_self_compact_segment(
       });
 }
 
+/**
+ * Rewrites the compaction index of the segment with `rewrite_index` and then
+ * the data of the segment keeping the records of the rewritten index, returns
+ * size of the rewritten segment
+ */
+static ss::future<size_t> do_rewrite_segment(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  storage::probe& pb,
+  storage::readers_cache& readers_cache,
+  ss::noncopyable_function<ss::future<>()> rewrite_index) {
+    return do_rewrite_segment_data(
+      s,
+      cfg,
+      pb,
+      readers_cache,
+      [s, cfg, &pb, rewrite_index = std::move(rewrite_index)](
+        ss::rwlock::holder h) mutable {
+          return rewrite_index()
+            // copy the bytes after segment is good - note that we
+            // need to do it with the READ-lock, not the write lock
+            .then([cfg, s, h = std::move(h), &pb]() mutable {
+                return do_copy_segment_data(s, cfg, pb, std::move(h));
+            });
+      });
+}
+
+/**
+ * Executes segment compaction, returns size of compacted segment
+ */
+ss::future<size_t> do_self_compact_segment(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  storage::probe& pb,
+  storage::readers_cache& readers_cache) {
+    return do_rewrite_segment(s, cfg, pb, readers_cache, [s, cfg] {
+        return do_compact_segment_index(s, cfg);
+    });
+}
+
 ss::future<> rebuild_compaction_index(
   model::record_batch_reader rdr,
   std::filesystem::path p,
   compaction_config cfg) {
-    return make_compacted_index_writer(p, cfg.sanitize, cfg.iopc)
+    return make_compacted_index_writer(
+             p,
+             cfg.sanitize,
+             cfg.iopc,
+             compacted_index::key_digests_mode(
+               config::shard_local_cfg().compaction_key_digests()))
       .then([r = std::move(rdr)](compacted_index_writer w) mutable {
           auto u = std::make_unique<compacted_index_writer>(std::move(w));
           auto ptr = u.get();
@@ -533,6 +673,201 @@ ss::future<compaction_result> self_compact_segment(
       });
 }
 
+ss::future<bool> add_to_key_offset_map(
+  ss::lw_shared_ptr<segment> s, compaction_config cfg, key_offset_map& map) {
+    auto h = co_await s->read_lock();
+    if (s->is_closed()) {
+        throw segment_closed_exception();
+    }
+    auto idx_path = compacted_index_path(s->reader().filename().c_str());
+    auto reader = make_file_backed_compacted_reader(
+      idx_path.string(),
+      co_await make_reader_handle(idx_path, cfg.sanitize),
+      cfg.iopc,
+      64_KiB);
+    std::exception_ptr e;
+    bool complete = false;
+    try {
+        auto footer = co_await reader.load_footer();
+        // the window would only compare digests of the keys, which might
+        // collide across the segments
+        using flags = compacted_index::footer_flags;
+        if (!bool(footer.flags & flags::key_digests)) {
+            reader.reset();
+            complete = co_await reader.consume(
+              key_offset_map_reducer(map), model::no_timeout);
+        }
+    } catch (...) {
+        e = std::current_exception();
+    }
+    co_await reader.close();
+    if (e) {
+        std::rethrow_exception(e);
+    }
+    co_return complete;
+}
+
+/// natural index of the entries of the compaction index to keep, nullopt if
+/// none of the records of the segment are superseded in the map
+static ss::future<std::optional<Roaring>> key_offset_map_filter(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  const key_offset_map& map) {
+    auto idx_path = compacted_index_path(s->reader().filename().c_str());
+    auto reader = make_file_backed_compacted_reader(
+      idx_path.string(),
+      co_await make_reader_handle(idx_path, cfg.sanitize),
+      cfg.iopc,
+      64_KiB);
+    std::exception_ptr e;
+    std::optional<Roaring> ret;
+    try {
+        reader.reset();
+        ret = co_await reader.consume(
+          key_offset_map_filter_reducer(map, s->offsets().dirty_offset),
+          model::no_timeout);
+    } catch (...) {
+        e = std::current_exception();
+    }
+    co_await reader.close();
+    if (e) {
+        std::rethrow_exception(e);
+    }
+    co_return ret;
+}
+
+static ss::future<> write_key_offset_map_filtered_index(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  const key_offset_map& map) {
+    auto bitmap = co_await key_offset_map_filter(s, cfg, map);
+    if (!bitmap) {
+        // the data is copied as it is
+        co_return;
+    }
+    auto idx_path = compacted_index_path(s->reader().filename().c_str());
+    auto reader = make_file_backed_compacted_reader(
+      idx_path.string(),
+      co_await make_reader_handle(idx_path, cfg.sanitize),
+      cfg.iopc,
+      64_KiB);
+    co_await do_write_filtered_compacted_index(reader, std::move(*bitmap), cfg)
+      .finally([reader]() mutable {
+          return reader.close().then_wrapped([](ss::future<>) {});
+      });
+}
+
+ss::future<compaction_result> window_compact_segment(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  storage::probe& pb,
+  storage::readers_cache& readers_cache,
+  const key_offset_map& map) {
+    if (s->has_appender() || !s->finished_self_compaction()) {
+        throw std::runtime_error(fmt::format(
+          "Cannot window compact a segment that is not self compacted. "
+          "cfg:{} - segment:{}",
+          cfg,
+          s));
+    }
+    const auto before = s->size_bytes();
+    // fast path, once the window was compacted most of the segments have no
+    // superseded records
+    {
+        auto h = co_await s->read_lock();
+        if (s->is_closed()) {
+            throw segment_closed_exception();
+        }
+        if (!co_await key_offset_map_filter(s, cfg, map)) {
+            co_return compaction_result(before);
+        }
+    }
+    auto after = co_await do_rewrite_segment(
+      s, cfg, pb, readers_cache, [s, cfg, &map] {
+          return write_key_offset_map_filtered_index(s, cfg, map);
+      });
+    pb.segment_compacted();
+    co_return compaction_result(before, after);
+}
+
+static ss::future<index_state> do_recompress_segment_data(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  storage::probe& pb,
+  model::compression codec,
+  ss::rwlock::holder h) {
+    auto w = co_await make_segment_appender(
+      data_segment_staging_name(s),
+      cfg.sanitize,
+      segment_appender::chunks_no_buffer,
+      cfg.iopc);
+    std::exception_ptr e;
+    index_state ret;
+    try {
+        ret = co_await create_segment_full_reader(s, cfg, pb, std::move(h))
+                .consume(
+                  copy_data_segment_reducer(w.get(), codec),
+                  model::no_timeout);
+    } catch (...) {
+        e = std::current_exception();
+    }
+    co_await w->close();
+    if (e) {
+        std::rethrow_exception(e);
+    }
+    co_return ret;
+}
+
+ss::future<compaction_result> recompress_segment(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  storage::probe& pb,
+  storage::readers_cache& readers_cache,
+  model::compression codec) {
+    if (s->has_appender()) {
+        throw std::runtime_error(fmt::format(
+          "Cannot recompress an active segment. cfg:{} - segment:{}", cfg, s));
+    }
+    const auto before = s->size_bytes();
+    {
+        auto h = co_await s->read_lock();
+        if (s->is_closed()) {
+            throw segment_closed_exception();
+        }
+        auto found = co_await make_segment_full_reader(s, cfg, pb, std::nullopt)
+                       .consume(
+                         recompression_check_reducer(codec), model::no_timeout);
+        if (!found) {
+            co_return compaction_result(before);
+        }
+    }
+    auto after = co_await do_rewrite_segment_data(
+      s, cfg, pb, readers_cache, [s, cfg, &pb, codec](ss::rwlock::holder h) {
+          return do_recompress_segment_data(s, cfg, pb, codec, std::move(h));
+      });
+    pb.segment_recompressed();
+    co_return compaction_result(before, after);
+}
+
+ss::future<std::optional<key_query_result>> key_query_segment(
+  ss::lw_shared_ptr<segment> s, key_query_config cfg, storage::probe& pb) {
+    auto h = co_await s->read_lock();
+    if (s->is_closed()) {
+        throw segment_closed_exception();
+    }
+    const auto o = s->offsets();
+    if (o.base_offset > cfg.max_offset || o.dirty_offset < o.base_offset) {
+        co_return std::nullopt;
+    }
+    auto reader_cfg = log_reader_config(
+      o.base_offset, std::min(o.dirty_offset, cfg.max_offset), cfg.prio);
+    reader_cfg.type_filter = model::record_batch_type::raft_data;
+    // the point reads don't evict the batches of the tailing readers
+    reader_cfg.skip_batch_cache = true;
+    co_return co_await make_segment_reader(s, reader_cfg, pb, std::move(h))
+      .consume(key_query_reducer(std::move(cfg.key)), model::no_timeout);
+}
+
 ss::future<ss::lw_shared_ptr<segment>> make_concatenated_segment(
   std::filesystem::path path,
   std::vector<ss::lw_shared_ptr<segment>> segments,
@@ -653,6 +988,23 @@ ss::future<> rewrite_concatenated_indicies(
       });
 }
 
+/// entries are concatenated as they are, all the indices have to either index
+/// the keys or the key digests
+static ss::future<std::optional<compacted_index::key_digests_mode>>
+shared_key_digests_mode(std::vector<compacted_index_reader>& readers) {
+    std::optional<compacted_index::key_digests_mode> ret;
+    for (auto& r : readers) {
+        auto footer = co_await r.load_footer();
+        auto mode = compacted_index::key_digests_mode(
+          bool(footer.flags & compacted_index::footer_flags::key_digests));
+        if (ret && *ret != mode) {
+            co_return std::nullopt;
+        }
+        ret = mode;
+    }
+    co_return ret.value_or(compacted_index::key_digests_mode::no);
+}
+
 ss::future<> do_write_concatenated_compacted_index(
   std::filesystem::path target_path,
   std::vector<ss::lw_shared_ptr<segment>>& segments,
@@ -685,12 +1037,26 @@ ss::future<> do_write_concatenated_compacted_index(
                       if (!verified_successfully) {
                           return ss::now();
                       }
-
-                      return make_compacted_index_writer(
-                               target_path, cfg.sanitize, cfg.iopc)
-                        .then([&readers](compacted_index_writer writer) {
-                            return rewrite_concatenated_indicies(
-                              std::move(writer), readers);
+                      return shared_key_digests_mode(readers).then(
+                        [cfg, target_path, &readers](
+                          std::optional<compacted_index::key_digests_mode>
+                            key_digests) {
+                            if (!key_digests) {
+                                vlog(
+                                  stlog.info,
+                                  "compacted indices use different key "
+                                  "formats, skipping concatenation");
+                                return ss::now();
+                            }
+                            return make_compacted_index_writer(
+                                     target_path,
+                                     cfg.sanitize,
+                                     cfg.iopc,
+                                     *key_digests)
+                              .then([&readers](compacted_index_writer writer) {
+                                  return rewrite_concatenated_indicies(
+                                    std::move(writer), readers);
+                              });
                         });
                   })
                   .finally([&readers] {
@@ -726,6 +1092,8 @@ ss::future<std::vector<ss::rwlock::holder>> transfer_segment(
   compaction_config cfg,
   probe& probe,
   std::vector<ss::rwlock::holder> locks) {
+    // the entries are moved to the target index below
+    co_await from->index().ensure_materialized();
     co_await from->close();
 
     co_await to->index().drop_all_data();
@@ -803,4 +1171,10 @@ bytes start_offset_key(model::ntp ntp) {
     return iobuf_to_bytes(buf);
 }
 
+bytes clean_segment_key(model::ntp ntp) {
+    iobuf buf;
+    reflection::serialize(buf, kvstore_key_type::clean_segment, std::move(ntp));
+    return iobuf_to_bytes(buf);
+}
+
 } // namespace storage::internal
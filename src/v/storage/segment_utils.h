@@ -29,6 +29,8 @@
 
 namespace storage::internal {
 
+class key_offset_map;
+
 /// \brief, this method will acquire it's own locks on the segment
 ///
 ss::future<compaction_result> self_compact_segment(
@@ -37,6 +39,43 @@ ss::future<compaction_result> self_compact_segment(
   storage::probe&,
   storage::readers_cache&);
 
+/// \brief adds the keys of the compaction index of a self compacted segment
+/// to the map, acquires a read lock on the segment
+///
+/// \return false if the map ran out of memory before all the keys were added
+/// or if the index has key digests and none were added
+ss::future<bool> add_to_key_offset_map(
+  ss::lw_shared_ptr<storage::segment>,
+  storage::compaction_config,
+  key_offset_map&);
+
+/// \brief removes the records of a self compacted segment that are superseded
+/// by a later offset of their key in the map. The record at the last offset
+/// of the segment is always kept. This method will acquire it's own locks on
+/// the segment
+ss::future<compaction_result> window_compact_segment(
+  ss::lw_shared_ptr<storage::segment>,
+  storage::compaction_config,
+  storage::probe&,
+  storage::readers_cache&,
+  const key_offset_map&);
+
+/// \brief rewrites a sealed segment with its batches of data compressed with
+/// the codec, when some are not. The offsets and the timestamps of the
+/// batches are unchanged. This method will acquire it's own locks on the
+/// segment
+ss::future<compaction_result> recompress_segment(
+  ss::lw_shared_ptr<storage::segment>,
+  storage::compaction_config,
+  storage::probe&,
+  storage::readers_cache&,
+  model::compression);
+
+/// \brief the latest record of the key in the segment up to the max offset
+/// of the query, reads the whole segment under its read lock
+ss::future<std::optional<key_query_result>> key_query_segment(
+  ss::lw_shared_ptr<storage::segment>, key_query_config, storage::probe&);
+
 /*
  * Concatentate segments into a minimal new segment.
  *
@@ -93,13 +132,15 @@ make_reader_handle(const std::filesystem::path&, storage::debug_sanitize_files);
 ss::future<compacted_index_writer> make_compacted_index_writer(
   const std::filesystem::path& path,
   storage::debug_sanitize_files debug,
-  ss::io_priority_class iopc);
+  ss::io_priority_class iopc,
+  compacted_index::key_digests_mode key_digests);
 
 ss::future<segment_appender_ptr> make_segment_appender(
   const std::filesystem::path& path,
   storage::debug_sanitize_files debug,
   size_t number_of_chunks,
-  ss::io_priority_class iopc);
+  ss::io_priority_class iopc,
+  flush_scheduler* flusher = nullptr);
 
 size_t number_of_chunks_from_config(const storage::ntp_config&);
 
@@ -162,8 +203,10 @@ size_t
 // key types used to store data in key-value store
 enum class kvstore_key_type : int8_t {
     start_offset = 0,
+    clean_segment = 1,
 };
 
 bytes start_offset_key(model::ntp ntp);
+bytes clean_segment_key(model::ntp ntp);
 
 } // namespace storage::internal
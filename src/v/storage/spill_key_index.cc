@@ -13,6 +13,7 @@
 #include "random/generators.h"
 #include "reflection/adl.h"
 #include "storage/compacted_index_writer.h"
+#include "storage/key_filter.h"
 #include "storage/logger.h"
 #include "utils/vint.h"
 #include "vassert.h"
@@ -33,10 +34,18 @@ spill_key_index::spill_key_index(
   ss::sstring name,
   ss::file index_file,
   ss::io_priority_class p,
-  size_t max_memory)
+  size_t max_memory,
+  compacted_index::key_digests_mode key_digests,
+  compacted_index::key_filter_mode key_filter)
   : compacted_index_writer::impl(std::move(name))
   , _appender(std::move(index_file), segment_appender::options(p, 1))
-  , _max_mem(max_memory) {}
+  , _max_mem(max_memory)
+  , _key_digests(key_digests)
+  , _key_filter(key_filter) {
+    if (_key_digests) {
+        set_flag(compacted_index::footer_flags::key_digests);
+    }
+}
 
 spill_key_index::~spill_key_index() {
     vassert(
@@ -47,6 +56,9 @@ spill_key_index::~spill_key_index() {
 
 ss::future<>
 spill_key_index::index(bytes_view v, model::offset base_offset, int32_t delta) {
+    if (_key_digests) {
+        return index_key(compacted_index::key_digest(v), base_offset, delta);
+    }
     if (auto it = _midx.find(v); it != _midx.end()) {
         auto& pair = it->second;
         if (base_offset > pair.base_offset) {
@@ -98,6 +110,14 @@ ss::future<> spill_key_index::add_key(bytes b, value_type v) {
 
 ss::future<>
 spill_key_index::index(bytes&& b, model::offset base_offset, int32_t delta) {
+    if (_key_digests) {
+        return index_key(compacted_index::key_digest(b), base_offset, delta);
+    }
+    return index_key(std::move(b), base_offset, delta);
+}
+
+ss::future<> spill_key_index::index_key(
+  bytes&& b, model::offset base_offset, int32_t delta) {
     if (auto it = _midx.find(b); it != _midx.end()) {
         auto& pair = it->second;
         // must use both base+delta, since we only want to keep the latest
@@ -148,6 +168,9 @@ ss::future<> spill_key_index::spill(
         size_t key_size = std::min(max_key_size, b.size());
 
         payload.append(b.data(), key_size);
+        if (_key_filter && type == compacted_index::entry_type::key) {
+            _key_hashes.push_back(key_filter::hash(b.substr(0, key_size)));
+        }
     }
     const size_t size = payload.size_bytes() - size_reservation;
     const size_t size_le = ss::cpu_to_le(size); // downcast
@@ -217,16 +240,28 @@ ss::future<> spill_key_index::close() {
           "Failed to drain all keys, {} bytes left",
           _keys_mem_usage);
         _footer.crc = _crc.value();
-        return ss::do_with(
-                 reflection::to_iobuf(_footer),
-                 [this](iobuf& b) {
-                     vassert(
-                       b.size_bytes() == compacted_index::footer_size,
-                       "Footer is bigger than expected: {}",
-                       b);
-                     return _appender.append(b);
-                 })
-          .then([this] { return _appender.close(); });
+        auto f = ss::now();
+        if (_key_filter) {
+            // not part of the entries, the size and crc of the footer are
+            // only of the entries
+            set_flag(compacted_index::footer_flags::key_filter);
+            f = ss::do_with(
+              key_filter::build(_key_hashes).serialize(),
+              [this](iobuf& b) { return _appender.append(b); });
+            _key_hashes = {};
+        }
+        return f.then([this] {
+            return ss::do_with(
+                     reflection::to_iobuf(_footer),
+                     [this](iobuf& b) {
+                         vassert(
+                           b.size_bytes() == compacted_index::footer_size,
+                           "Footer is bigger than expected: {}",
+                           b);
+                         return _appender.append(b);
+                     })
+              .then([this] { return _appender.close(); });
+        });
     });
 }
 
@@ -236,12 +271,13 @@ std::ostream& operator<<(std::ostream& o, const spill_key_index& k) {
     fmt::print(
       o,
       "{{name:{}, max_mem:{}, key_mem_usage:{}, persisted_entries:{}, "
-      "in_memory_entries:{}, file_appender:{}}}",
+      "in_memory_entries:{}, key_digests:{}, file_appender:{}}}",
       k.filename(),
       k._max_mem,
       k._keys_mem_usage,
       k._footer.keys,
       k._midx.size(),
+      k._key_digests,
       k._appender);
     return o;
 }
@@ -250,8 +286,13 @@ std::ostream& operator<<(std::ostream& o, const spill_key_index& k) {
 
 namespace storage {
 compacted_index_writer make_file_backed_compacted_index(
-  ss::sstring name, ss::file f, ss::io_priority_class p, size_t max_memory) {
+  ss::sstring name,
+  ss::file f,
+  ss::io_priority_class p,
+  size_t max_memory,
+  compacted_index::key_digests_mode key_digests,
+  compacted_index::key_filter_mode key_filter) {
     return compacted_index_writer(std::make_unique<internal::spill_key_index>(
-      std::move(name), std::move(f), p, max_memory));
+      std::move(name), std::move(f), p, max_memory, key_digests, key_filter));
 }
 } // namespace storage
@@ -45,7 +45,10 @@ public:
       ss::sstring filename,
       ss::file index_file,
       ss::io_priority_class,
-      size_t max_memory);
+      size_t max_memory,
+      compacted_index::key_digests_mode
+      = compacted_index::key_digests_mode::no,
+      compacted_index::key_filter_mode = compacted_index::key_filter_mode::no);
     spill_key_index(const spill_key_index&) = delete;
     spill_key_index& operator=(const spill_key_index&) = delete;
     spill_key_index(spill_key_index&&) noexcept = default;
@@ -75,6 +78,7 @@ private:
           HashtableDebugAccess<underlying_t>;
         return debug::AllocatedByteSize(_midx);
     }
+    ss::future<> index_key(bytes&&, model::offset, int32_t);
     ss::future<> drain_all_keys();
     ss::future<> add_key(bytes b, value_type);
     ss::future<> spill(compacted_index::entry_type, bytes_view, value_type);
@@ -83,6 +87,10 @@ private:
     underlying_t _midx;
     size_t _max_mem;
     size_t _keys_mem_usage{0};
+    compacted_index::key_digests_mode _key_digests;
+    compacted_index::key_filter_mode _key_filter;
+    // hashes of the spilled keys, the key_filter is sized for them on close
+    std::vector<uint64_t> _key_hashes;
     compacted_index::footer _footer;
     crc::crc32c _crc;
 
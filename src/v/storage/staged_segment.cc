@@ -0,0 +1,161 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/staged_segment.h"
+
+#include "config/configuration.h"
+#include "storage/compacted_index_writer.h"
+#include "storage/fs_utils.h"
+#include "storage/logger.h"
+#include "storage/segment_index.h"
+#include "storage/segment_reader.h"
+#include "storage/segment_utils.h"
+#include "utils/file_sanitizer.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/seastar.hh>
+
+namespace storage {
+
+static ss::future<> remove_if_exists(const std::filesystem::path& p) {
+    if (co_await ss::file_exists(p.string())) {
+        co_await ss::remove_file(p.string());
+    }
+}
+
+staged_segment::staged_segment(
+  std::filesystem::path data_path,
+  std::filesystem::path index_path,
+  ss::file reader,
+  ss::file index,
+  segment_appender_ptr appender,
+  debug_sanitize_files sanitize) noexcept
+  : _data_path(std::move(data_path))
+  , _index_path(std::move(index_path))
+  , _reader(std::move(reader))
+  , _index(std::move(index))
+  , _appender(std::move(appender))
+  , _sanitize(sanitize) {}
+
+ss::future<staged_segment> staged_segment::create(
+  std::filesystem::path work_directory,
+  ss::io_priority_class pc,
+  debug_sanitize_files sanitize,
+  size_t number_of_chunks,
+  flush_scheduler* flusher) {
+    auto data_path = work_directory / "next.log.staged";
+    auto index_path = work_directory / "next.base_index.staged";
+    // the files staged before a crash
+    co_await remove_if_exists(data_path);
+    co_await remove_if_exists(index_path);
+
+    auto appender = co_await internal::make_segment_appender(
+      data_path, sanitize, number_of_chunks, pc, flusher);
+    std::exception_ptr ex;
+    try {
+        co_await appender->preallocate();
+        auto reader = co_await internal::make_reader_handle(
+          data_path, sanitize);
+        auto index = co_await ss::open_file_dma(
+          index_path.string(), ss::open_flags::create | ss::open_flags::rw);
+        if (sanitize) {
+            index = ss::file(
+              ss::make_shared(file_io_sanitizer(std::move(index))));
+        }
+        co_return staged_segment(
+          std::move(data_path),
+          std::move(index_path),
+          std::move(reader),
+          std::move(index),
+          std::move(appender),
+          sanitize);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await appender->close();
+    co_await remove_if_exists(data_path);
+    co_await remove_if_exists(index_path);
+    std::rethrow_exception(ex);
+}
+
+ss::future<ss::lw_shared_ptr<segment>> staged_segment::commit(
+  const ntp_config& ntpc,
+  model::offset base_offset,
+  model::term_id term,
+  ss::io_priority_class pc,
+  record_version_type version,
+  size_t buf_size,
+  std::optional<batch_cache_index> batch_cache) && {
+    auto path = segment_path::make_segment_path(
+      ntpc, base_offset, term, version);
+    auto index_name = std::filesystem::path(path)
+                        .replace_extension("base_index")
+                        .string();
+    vlog(stlog.info, "Creating new segment {} from staged files", path);
+    std::optional<compacted_index_writer> compacted_index;
+    std::exception_ptr ex;
+    try {
+        co_await ss::rename_file(_data_path.string(), path.string());
+        _data_path = path;
+        co_await ss::rename_file(_index_path.string(), index_name);
+        _index_path = index_name;
+        if (ntpc.is_compacted()) {
+            compacted_index = co_await internal::make_compacted_index_writer(
+              internal::compacted_index_path(path),
+              _sanitize,
+              pc,
+              compacted_index::key_digests_mode(
+                config::shard_local_cfg().compaction_key_digests()));
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        co_await std::move(*this).discard();
+        std::rethrow_exception(ex);
+    }
+    co_return ss::make_lw_shared<segment>(
+      segment::offset_tracker(term, base_offset),
+      segment_reader(path.string(), std::move(_reader), 0, buf_size),
+      segment_index(
+        index_name,
+        std::move(_index),
+        base_offset,
+        segment_index::default_data_buffer_step),
+      std::move(_appender),
+      std::move(compacted_index),
+      std::move(batch_cache));
+}
+
+ss::future<> staged_segment::discard() && {
+    try {
+        co_await _appender->close();
+        co_await _reader.close();
+        co_await _index.close();
+    } catch (...) {
+        vlog(
+          stlog.warn,
+          "Error closing the staged segment {}: {}",
+          _data_path,
+          std::current_exception());
+    }
+    try {
+        co_await remove_if_exists(_data_path);
+        co_await remove_if_exists(_index_path);
+    } catch (...) {
+        vlog(
+          stlog.warn,
+          "Error removing the staged segment {}: {}",
+          _data_path,
+          std::current_exception());
+    }
+}
+
+} // namespace storage
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "model/fundamental.h"
+#include "seastarx.h"
+#include "storage/batch_cache.h"
+#include "storage/ntp_config.h"
+#include "storage/segment.h"
+#include "storage/segment_appender.h"
+#include "storage/types.h"
+#include "storage/version.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include <filesystem>
+
+namespace storage {
+
+class flush_scheduler;
+
+/**
+ * Files of the next segment of a log, created before the log rolls.
+ *
+ * The name of a segment holds its base offset and term, which are only known
+ * when the active segment is rolled. The files of the next segment are
+ * created, opened and preallocated under staging names while the active
+ * segment fills up, and renamed to the ones of the segment when the log rolls:
+ * the roll renames two files instead of creating and opening them, allocating
+ * the appender and the first extent of the file.
+ *
+ * The staging names don't parse as segment names: the files staged before a
+ * crash are ignored by the recovery and replaced by the next staging.
+ */
+class staged_segment {
+public:
+    static ss::future<staged_segment> create(
+      std::filesystem::path work_directory,
+      ss::io_priority_class,
+      debug_sanitize_files,
+      size_t number_of_chunks,
+      flush_scheduler*);
+
+    staged_segment(staged_segment&&) noexcept = default;
+    staged_segment& operator=(staged_segment&&) noexcept = default;
+    staged_segment(const staged_segment&) = delete;
+    staged_segment& operator=(const staged_segment&) = delete;
+    ~staged_segment() noexcept = default;
+
+    /// \brief renames the staged files to the ones of the segment and makes
+    /// the segment out of them. The staged files are removed on failure.
+    ss::future<ss::lw_shared_ptr<segment>> commit(
+      const ntp_config&,
+      model::offset base_offset,
+      model::term_id,
+      ss::io_priority_class,
+      record_version_type,
+      size_t buf_size,
+      std::optional<batch_cache_index>) &&;
+
+    /// \brief closes and removes the staged files
+    ss::future<> discard() &&;
+
+private:
+    staged_segment(
+      std::filesystem::path data_path,
+      std::filesystem::path index_path,
+      ss::file reader,
+      ss::file index,
+      segment_appender_ptr appender,
+      debug_sanitize_files sanitize) noexcept;
+
+    std::filesystem::path _data_path;
+    std::filesystem::path _index_path;
+    ss::file _reader;
+    ss::file _index;
+    segment_appender_ptr _appender;
+    debug_sanitize_files _sanitize;
+};
+
+} // namespace storage
@@ -0,0 +1,61 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "seastarx.h"
+#include "storage/background_controller.h"
+#include "test_utils/async.h"
+
+#include <seastar/core/reactor.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <chrono>
+
+using namespace std::chrono_literals; // NOLINT
+
+struct simple_latency_sampler : storage::background_controller::sampler {
+    explicit simple_latency_sampler(std::chrono::microseconds& l)
+      : latency(l) {}
+    ss::future<std::chrono::microseconds> sample_latency() final {
+        co_return latency;
+    }
+
+    std::chrono::microseconds& latency;
+};
+
+SEASTAR_THREAD_TEST_CASE(test_back_off_and_catch_up) {
+    auto iopc = ss::engine().register_one_priority_class("io_background", 100);
+    std::chrono::microseconds latency{0};
+    storage::background_controller ctrl(
+      std::make_unique<simple_latency_sampler>(latency),
+      storage::background_controller_config{
+        .target_latency = 1ms,
+        .proportional_coeff = 0.5,
+        .integral_coeff = 0.2,
+        .sampling_interval = 10ms},
+      {{.name = "test",
+        .scheduling_group = std::nullopt,
+        .io_priority = iopc,
+        .min_shares = 10,
+        .max_shares = 100}});
+    ctrl.start().get();
+    BOOST_REQUIRE_EQUAL(ctrl.factor(), 1.0);
+
+    // foreground latency over the target, background work backs off
+    latency = 10ms;
+    tests::cooperative_spin_wait_with_timeout(1500ms, [&ctrl] {
+        return ctrl.factor() == 0.0;
+    }).get();
+
+    // idle disk, background work catches up
+    latency = 0us;
+    tests::cooperative_spin_wait_with_timeout(1500ms, [&ctrl] {
+        return ctrl.factor() == 1.0;
+    }).get();
+    ctrl.stop().get();
+}
@@ -306,3 +306,68 @@ FIXTURE_TEST(test_random_batch_sizes, batch_cache_test_fixture) {
         BOOST_REQUIRE_LE(r.waste(), max_waste);
     }
 }
+
+FIXTURE_TEST(scan_resistance, batch_cache_test_fixture) {
+    storage::batch_cache_index hot(cache);
+    storage::batch_cache_index scan(cache);
+
+    // batches read once by a catch up reader
+    std::vector<storage::batch_cache::entry> scanned;
+    auto h = cache.put(hot, make_batch(10));
+    scanned.push_back(cache.put(scan, make_random_batch(40_KiB)));
+
+    // tailing consumer reads the batch again, it becomes protected
+    cache.touch(h.range());
+    BOOST_REQUIRE_EQUAL(cache.get_probe().get_promotions(), 1);
+    BOOST_REQUIRE_EQUAL(cache.get_probe().get_demotions(), 0);
+
+    for (int i = 0; i < 3; ++i) {
+        scanned.push_back(cache.put(scan, make_random_batch(40_KiB)));
+    }
+
+    // reclaim removes probationary ranges first
+    cache.reclaim(4 * storage::batch_cache::range::range_size);
+    BOOST_CHECK(h.range());
+    for (auto& e : scanned) {
+        BOOST_CHECK(!e.range());
+    }
+}
+
+FIXTURE_TEST(hit_ratio, batch_cache_test_fixture) {
+    storage::batch_cache_index index(cache);
+    storage::batch_cache_index other(cache);
+    index.put(make_batch(10, model::offset(0)));
+    other.put(make_random_batch(40_KiB));
+
+    BOOST_REQUIRE(!index.get(model::offset(100)));
+    BOOST_REQUIRE(index.get(model::offset(0)));
+    BOOST_REQUIRE(index.get(model::offset(0)));
+
+    auto& probe = cache.get_probe();
+    BOOST_REQUIRE_EQUAL(probe.get_misses(), 1);
+    BOOST_REQUIRE_EQUAL(probe.get_probationary_hits(), 1);
+    BOOST_REQUIRE_EQUAL(probe.get_protected_hits(), 1);
+    BOOST_REQUIRE_CLOSE(probe.protected_hit_ratio(), 1.0 / 3, 0.001);
+}
+
+SEASTAR_THREAD_TEST_CASE(plain_lru_policy) {
+    static storage::batch_cache::reclaim_options opts = {
+      .growth_window = std::chrono::milliseconds(3000),
+      .stable_window = std::chrono::milliseconds(10000),
+      .min_size = 1,
+      .max_size = 1,
+      .protected_ratio = 0,
+    };
+    storage::batch_cache cache(opts);
+    storage::batch_cache_index index_1(cache);
+    storage::batch_cache_index index_2(cache);
+    auto b0 = cache.put(index_1, make_batch(10));
+    auto b1 = cache.put(index_2, make_batch(10));
+
+    cache.touch(b0.range());
+    BOOST_REQUIRE_EQUAL(cache.get_probe().get_promotions(), 0);
+    cache.reclaim(1);
+    BOOST_CHECK(b0.range());
+    BOOST_CHECK(!b1.range());
+    cache.stop().get();
+}
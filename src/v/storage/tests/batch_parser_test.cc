@@ -0,0 +1,119 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf.h"
+#include "model/record.h"
+#include "storage/parser.h"
+#include "storage/segment_appender_utils.h"
+#include "storage/tests/utils/random_batch.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <vector>
+
+namespace {
+
+struct parsed {
+    std::vector<model::record_batch_header> accepted;
+    std::vector<iobuf> records;
+    std::vector<size_t> skipped_positions;
+};
+
+/// skips the batches below the start offset
+class skip_below : public storage::batch_consumer {
+public:
+    skip_below(model::offset start, parsed& out)
+      : _start(start)
+      , _out(out) {}
+
+    consume_result
+    accept_batch_start(const model::record_batch_header& h) const override {
+        return h.last_offset() < _start ? consume_result::skip_batch
+                                        : consume_result::accept_batch;
+    }
+    void consume_batch_start(
+      model::record_batch_header h, size_t, size_t) override {
+        _out.accepted.push_back(h);
+    }
+    void skip_batch_start(
+      model::record_batch_header, size_t position, size_t) override {
+        _out.skipped_positions.push_back(position);
+    }
+    void consume_records(iobuf&& records) override {
+        _out.records.push_back(std::move(records));
+    }
+    stop_parser consume_batch_end() override { return stop_parser::no; }
+    void print(std::ostream& os) const override { os << "skip_below"; }
+
+private:
+    model::offset _start;
+    parsed& _out;
+};
+
+iobuf to_disk_format(const ss::circular_buffer<model::record_batch>& bs) {
+    iobuf out;
+    for (const auto& b : bs) {
+        out.append(storage::disk_header_to_iobuf(b.header()));
+        out.append(b.data().copy());
+    }
+    return out;
+}
+
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(skipped_batches_are_not_consumed) {
+    auto batches = storage::test::make_random_batches(model::offset(0), 20);
+    const auto start = batches[batches.size() / 2].base_offset();
+    auto data = to_disk_format(batches);
+    const auto total = data.size_bytes();
+
+    parsed out;
+    storage::continuous_batch_parser parser(
+      std::make_unique<skip_below>(start, out),
+      make_iobuf_input_stream(std::move(data)));
+    auto consumed = parser.consume().get0();
+    parser.close().get();
+
+    BOOST_REQUIRE(consumed);
+    BOOST_CHECK_EQUAL(consumed.value(), total);
+    BOOST_REQUIRE_EQUAL(out.skipped_positions.size(), batches.size() / 2);
+    BOOST_REQUIRE_EQUAL(
+      out.accepted.size(), batches.size() - batches.size() / 2);
+
+    size_t position = 0;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        const auto& b = batches[i];
+        if (i < out.skipped_positions.size()) {
+            BOOST_CHECK_EQUAL(out.skipped_positions[i], position);
+        } else {
+            auto j = i - out.skipped_positions.size();
+            BOOST_CHECK_EQUAL(out.accepted[j], b.header());
+            BOOST_CHECK_EQUAL(out.records[j], b.data());
+        }
+        position += b.size_bytes();
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(skip_every_batch) {
+    auto batches = storage::test::make_random_batches(model::offset(0), 10);
+    auto data = to_disk_format(batches);
+    const auto total = data.size_bytes();
+
+    parsed out;
+    storage::continuous_batch_parser parser(
+      std::make_unique<skip_below>(model::offset::max(), out),
+      make_iobuf_input_stream(std::move(data)));
+    auto consumed = parser.consume().get0();
+    parser.close().get();
+
+    BOOST_REQUIRE(consumed);
+    BOOST_CHECK_EQUAL(consumed.value(), total);
+    BOOST_CHECK(out.accepted.empty());
+    BOOST_CHECK_EQUAL(out.skipped_positions.size(), batches.size());
+}
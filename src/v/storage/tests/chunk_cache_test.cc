@@ -0,0 +1,92 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "seastarx.h"
+#include "storage/chunk_cache.h"
+
+#include <seastar/core/future-util.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <vector>
+
+using storage::internal::chunk_cache;
+using chunk_ptr = ss::lw_shared_ptr<storage::segment_appender_chunk>;
+
+static constexpr size_t chunk_size
+  = storage::segment_appender_chunk::chunk_size;
+
+static std::vector<chunk_ptr>
+take(chunk_cache& c, chunk_cache::account& a, size_t n) {
+    std::vector<chunk_ptr> ret;
+    for (size_t i = 0; i < n; ++i) {
+        ret.push_back(c.get(a).get0());
+    }
+    return ret;
+}
+
+SEASTAR_THREAD_TEST_CASE(entitled_waiter_before_borrower) {
+    chunk_cache cache;
+    cache.set_size_limit(4 * chunk_size);
+    chunk_cache::account busy(cache, 1);
+    chunk_cache::account other(cache, 1);
+
+    // alone, the busy account may use the whole cache
+    BOOST_CHECK_EQUAL(cache.share(busy), 4);
+    auto chunks = take(cache, busy, 4);
+
+    // borrowing over its share waits
+    auto borrowed = cache.get(busy);
+    // the other account is entitled to half of the cache
+    BOOST_CHECK_EQUAL(cache.share(other), 2);
+    auto entitled = cache.get(other);
+    ss::yield().get();
+    BOOST_CHECK(!borrowed.available());
+    BOOST_CHECK(!entitled.available());
+    BOOST_CHECK_EQUAL(cache.waiters(), 2);
+
+    // the first returned chunk goes to the later, entitled, waiter
+    cache.add(busy, chunks.back());
+    chunks.pop_back();
+    ss::yield().get();
+    BOOST_REQUIRE(entitled.available());
+    BOOST_CHECK(!borrowed.available());
+    chunks.push_back(entitled.get0());
+
+    cache.add(busy, chunks.front());
+    chunks.erase(chunks.begin());
+    ss::yield().get();
+    BOOST_REQUIRE(borrowed.available());
+    borrowed.get();
+    BOOST_CHECK_EQUAL(busy.held(), 3);
+    BOOST_CHECK_EQUAL(other.held(), 1);
+    BOOST_CHECK_EQUAL(cache.waiters(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(idle_account_is_reclaimed) {
+    chunk_cache cache;
+    cache.set_size_limit(4 * chunk_size);
+    chunk_cache::account idle(cache, 1);
+    chunk_cache::account other(cache, 1);
+
+    auto chunks = take(cache, idle, 4);
+    size_t reclaimed = 0;
+    idle.on_reclaim([&] {
+        ++reclaimed;
+        cache.add(idle, chunks.back());
+        chunks.pop_back();
+    });
+
+    // the idle account returns a chunk right away
+    auto f = cache.get(other);
+    BOOST_CHECK_EQUAL(reclaimed, 1);
+    BOOST_REQUIRE(f.available());
+    f.get();
+    BOOST_CHECK_EQUAL(idle.held(), 3);
+    BOOST_CHECK_EQUAL(other.held(), 1);
+}
@@ -37,3 +37,32 @@ PERF_TEST_F(reducer_bench, compaction_key_reducer_test) {
         perf_tests::stop_measuring_time();
     });
 }
+
+PERF_TEST_F(reducer_bench, compaction_key_reducer_large_key_test) {
+    model::offset o{0};
+    auto key = random_generators::get_bytes(100);
+
+    storage::compacted_index::entry entry(
+      storage::compacted_index::entry_type::key, std::move(key), o, 0);
+
+    perf_tests::start_measuring_time();
+    return reducer(std::move(entry)).discard_result().finally([] {
+        perf_tests::stop_measuring_time();
+    });
+}
+
+PERF_TEST_F(reducer_bench, compaction_key_reducer_key_digest_test) {
+    model::offset o{0};
+    auto key = random_generators::get_bytes(100);
+
+    perf_tests::start_measuring_time();
+    // digest is computed while indexing, measure it too
+    storage::compacted_index::entry entry(
+      storage::compacted_index::entry_type::key,
+      storage::compacted_index::key_digest(key),
+      o,
+      0);
+    return reducer(std::move(entry)).discard_result().finally([] {
+        perf_tests::stop_measuring_time();
+    });
+}
@@ -15,6 +15,7 @@
 #include "storage/compacted_index_reader.h"
 #include "storage/compacted_index_writer.h"
 #include "storage/compaction_reducers.h"
+#include "storage/key_filter.h"
 #include "storage/segment_utils.h"
 #include "storage/spill_key_index.h"
 #include "test_utils/fixture.h"
@@ -262,6 +263,59 @@ FIXTURE_TEST(key_reducer_max_mem, compacted_topic_fixture) {
     BOOST_REQUIRE(exact_mem_bitmap.contains(98));
     BOOST_REQUIRE(exact_mem_bitmap.contains(99));
 }
+FIXTURE_TEST(key_digests_roundtrip, compacted_topic_fixture) {
+    tmpbuf_file::store_t index_data;
+    auto idx = storage::make_file_backed_compacted_index(
+      "dummy name",
+      ss::file(ss::make_shared(tmpbuf_file(index_data))),
+      ss::default_priority_class(),
+      1_MiB,
+      storage::compacted_index::key_digests_mode::yes);
+
+    const auto key1 = random_generators::get_bytes(100);
+    const auto key2 = random_generators::get_bytes(100);
+    for (auto i = 0; i < 100; ++i) {
+        bytes_view put_key;
+        if (i % 2) {
+            put_key = key1;
+        } else {
+            put_key = key2;
+        }
+        idx.index(put_key, model::offset(i), 0).get();
+    }
+    idx.close().get();
+    info("{}", idx);
+
+    auto rdr = storage::make_file_backed_compacted_reader(
+      "dummy name",
+      ss::file(ss::make_shared(tmpbuf_file(index_data))),
+      ss::default_priority_class(),
+      32_KiB);
+    rdr.verify_integrity().get();
+    auto footer = rdr.load_footer().get0();
+    BOOST_REQUIRE(bool(
+      footer.flags & storage::compacted_index::footer_flags::key_digests));
+    BOOST_REQUIRE_EQUAL(footer.keys, 2);
+
+    auto bitmap
+      = storage::internal::natural_index_of_entries_to_keep(rdr).get0();
+    BOOST_REQUIRE_EQUAL(bitmap.cardinality(), 2);
+
+    auto vec = compaction_index_reader_to_memory(rdr).get0();
+    BOOST_REQUIRE_EQUAL(vec.size(), 2);
+    for (auto& e : vec) {
+        BOOST_REQUIRE_EQUAL(
+          e.key.size(), storage::compacted_index::key_digest_size);
+        if (e.offset == model::offset(99)) {
+            BOOST_REQUIRE_EQUAL(
+              e.key, storage::compacted_index::key_digest(key1));
+        } else {
+            BOOST_REQUIRE_EQUAL(e.offset, model::offset(98));
+            BOOST_REQUIRE_EQUAL(
+              e.key, storage::compacted_index::key_digest(key2));
+        }
+    }
+}
 FIXTURE_TEST(index_filtered_copy_tests, compacted_topic_fixture) {
     tmpbuf_file::store_t index_data;
 
@@ -344,3 +398,89 @@ FIXTURE_TEST(index_filtered_copy_tests, compacted_topic_fixture) {
         }
     }
 }
+FIXTURE_TEST(key_filter_roundtrip, compacted_topic_fixture) {
+    std::vector<bytes> keys;
+    std::vector<uint64_t> hashes;
+    for (auto i = 0; i < 1000; ++i) {
+        keys.push_back(random_generators::get_bytes(20));
+        hashes.push_back(storage::key_filter::hash(keys.back()));
+    }
+    auto filter = storage::key_filter::build(hashes);
+    for (auto& k : keys) {
+        BOOST_REQUIRE(filter.maybe_contains_key(k));
+    }
+
+    auto copy = storage::key_filter::deserialize(
+      filter.serialize(), storage::compacted_index::key_digests_mode::no);
+    BOOST_REQUIRE(copy);
+    for (auto& k : keys) {
+        BOOST_REQUIRE(copy->maybe_contains_key(k));
+    }
+    size_t false_positives = 0;
+    for (auto i = 0; i < 1000; ++i) {
+        if (copy->maybe_contains_key(random_generators::get_bytes(21))) {
+            ++false_positives;
+        }
+    }
+    // ~1% with 10 bits per key
+    BOOST_REQUIRE_LT(false_positives, 50);
+
+    auto torn = filter.serialize();
+    torn.trim_back(1);
+    BOOST_REQUIRE(!storage::key_filter::deserialize(
+      std::move(torn), storage::compacted_index::key_digests_mode::no));
+}
+FIXTURE_TEST(index_with_key_filter_roundtrip, compacted_topic_fixture) {
+    tmpbuf_file::store_t index_data;
+    auto idx = storage::make_file_backed_compacted_index(
+      "dummy name",
+      ss::file(ss::make_shared(tmpbuf_file(index_data))),
+      ss::default_priority_class(),
+      // FORCE eviction with every key basically
+      1_KiB,
+      storage::compacted_index::key_digests_mode::no,
+      storage::compacted_index::key_filter_mode::yes);
+
+    std::vector<bytes> keys;
+    for (auto i = 0; i < 100; ++i) {
+        keys.push_back(random_generators::get_bytes(128));
+        idx.index(keys.back(), model::offset(i), 0).get();
+    }
+    const auto max_key = random_generators::get_bytes(128_KiB);
+    idx.index(max_key, model::offset(100), 0).get();
+    idx.close().get();
+    info("{}", idx);
+
+    auto rdr = storage::make_file_backed_compacted_reader(
+      "dummy name",
+      ss::file(ss::make_shared(tmpbuf_file(index_data))),
+      ss::default_priority_class(),
+      32_KiB);
+    rdr.verify_integrity().get();
+    auto footer = rdr.load_footer().get0();
+    BOOST_REQUIRE(bool(
+      footer.flags & storage::compacted_index::footer_flags::key_filter));
+    BOOST_REQUIRE_EQUAL(footer.keys, 101);
+
+    auto vec = compaction_index_reader_to_memory(rdr).get0();
+    BOOST_REQUIRE_EQUAL(vec.size(), 101);
+    for (auto& e : vec) {
+        if (e.offset < model::offset(100)) {
+            BOOST_REQUIRE_EQUAL(e.key, keys[e.offset()]);
+        }
+    }
+
+    // the filter sits between the entries and the footer
+    iobuf data = std::move(index_data).release_iobuf();
+    const auto filter_end = data.size_bytes()
+                            - storage::compacted_index::footer_size;
+    BOOST_REQUIRE_LT(footer.size, filter_end);
+    auto filter = storage::key_filter::deserialize(
+      data.share(footer.size, filter_end - footer.size),
+      storage::compacted_index::key_digests_mode::no);
+    BOOST_REQUIRE(filter);
+    for (auto& k : keys) {
+        BOOST_REQUIRE(filter->maybe_contains_key(k));
+    }
+    BOOST_REQUIRE(filter->maybe_contains_key(max_key));
+}
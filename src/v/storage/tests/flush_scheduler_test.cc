@@ -0,0 +1,82 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "seastarx.h"
+#include "storage/flush_scheduler.h"
+
+#include <seastar/core/reactor.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+using namespace storage; // NOLINT
+
+static ss::file open_test_file(const ss::sstring& name) {
+    return ss::open_file_dma(
+             name,
+             ss::open_flags::create | ss::open_flags::rw
+               | ss::open_flags::truncate)
+      .get0();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_flushes_are_coalesced) {
+    auto a = open_test_file("test.flush_scheduler_a.log");
+    auto b = open_test_file("test.flush_scheduler_b.log");
+    flush_scheduler scheduler;
+
+    // dispatched immediately
+    auto f1 = scheduler.flush(a);
+    // collected while the first batch is in progress
+    auto f2 = scheduler.flush(a);
+    auto f3 = scheduler.flush(a);
+    auto f4 = scheduler.flush(b);
+    f1.get();
+    f2.get();
+    f3.get();
+    f4.get();
+
+    BOOST_REQUIRE_EQUAL(scheduler.requests(), 4);
+    BOOST_REQUIRE_EQUAL(scheduler.batches(), 2);
+    BOOST_REQUIRE_EQUAL(scheduler.flushes(), 3);
+
+    scheduler.stop().get();
+    // flushes requested after stop are dispatched directly
+    scheduler.flush(a).get();
+    BOOST_REQUIRE_EQUAL(scheduler.requests(), 4);
+
+    a.close().get();
+    b.close().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_directory_syncs_are_coalesced) {
+    ss::recursive_touch_directory("test.flush_scheduler_dir/a").get();
+    auto f = open_test_file("test.flush_scheduler_c.log");
+    flush_scheduler scheduler;
+
+    // dispatched immediately
+    auto f1 = scheduler.flush(f);
+    // collected in the same batch
+    auto f2 = scheduler.sync_directory("test.flush_scheduler_dir");
+    auto f3 = scheduler.sync_directory("test.flush_scheduler_dir");
+    auto f4 = scheduler.sync_directory("test.flush_scheduler_dir/a");
+    f1.get();
+    f2.get();
+    f3.get();
+    f4.get();
+
+    BOOST_REQUIRE_EQUAL(scheduler.batches(), 2);
+    BOOST_REQUIRE_EQUAL(scheduler.flushes(), 1);
+    BOOST_REQUIRE_EQUAL(scheduler.directory_syncs(), 2);
+
+    // the error of a sync is propagated to its waiters
+    auto f5 = scheduler.sync_directory("test.flush_scheduler_dir/missing");
+    BOOST_REQUIRE_THROW(f5.get(), std::exception);
+
+    scheduler.stop().get();
+    f.close().get();
+}
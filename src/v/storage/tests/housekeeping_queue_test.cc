@@ -0,0 +1,68 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/fundamental.h"
+#include "storage/housekeeping_queue.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+using storage::housekeeping_queue;
+
+static model::ntp make_ntp(int p) {
+    return model::ntp(
+      model::kafka_namespace, model::topic("t"), model::partition_id(p));
+}
+
+SEASTAR_THREAD_TEST_CASE(due_logs_by_urgency) {
+    housekeeping_queue q;
+    const auto now = housekeeping_queue::clock_type::now();
+    q.schedule(make_ntp(0), now, 0.1);
+    q.schedule(make_ntp(1), now - 1s, 2.0);
+    q.schedule(make_ntp(2), now + 10s, 5.0);
+    q.schedule(make_ntp(3), now, 0.5);
+    BOOST_CHECK_EQUAL(q.size(), 4);
+
+    // the due logs, most urgent first, whatever their due time
+    BOOST_CHECK(q.pop(now) == make_ntp(1));
+    BOOST_CHECK(q.pop(now) == make_ntp(3));
+    BOOST_CHECK(q.pop(now) == make_ntp(0));
+    BOOST_CHECK(!q.pop(now));
+    BOOST_CHECK(q.next_due() == now + 10s);
+
+    BOOST_CHECK(q.pop(now + 10s) == make_ntp(2));
+    BOOST_CHECK(q.empty());
+    BOOST_CHECK(!q.next_due());
+}
+
+SEASTAR_THREAD_TEST_CASE(reschedule_keeps_earliest_and_most_urgent) {
+    housekeeping_queue q;
+    const auto now = housekeeping_queue::clock_type::now();
+    q.schedule(make_ntp(0), now + 10s, 0.1);
+    q.schedule(make_ntp(1), now + 5s, 1.0);
+    // rolled: due now
+    q.schedule(make_ntp(0), now, 0.2);
+    q.schedule(make_ntp(0), now + 20s, 0.0);
+    BOOST_CHECK_EQUAL(q.size(), 2);
+    BOOST_CHECK(q.next_due() == now);
+
+    BOOST_CHECK(q.pop(now + 5s) == make_ntp(1));
+    q.schedule(make_ntp(2), now, 0.5);
+    BOOST_CHECK(q.pop(now) == make_ntp(2));
+    // an already due log stays due, its urgency raised
+    q.schedule(make_ntp(0), now + 1s, 3.0);
+    q.schedule(make_ntp(2), now, 0.5);
+    BOOST_CHECK(q.pop(now) == make_ntp(0));
+
+    q.remove(make_ntp(2));
+    BOOST_CHECK(!q.pop(now + 1h));
+    BOOST_CHECK(q.empty());
+}
@@ -0,0 +1,68 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "resource_mgmt/io_priority.h"
+#include "seastarx.h"
+#include "storage/io_latency_probe.h"
+
+#include <seastar/core/reactor.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <algorithm>
+
+using namespace storage; // NOLINT
+
+static uint64_t
+samples(const ss::sstring& priority_class, io_latency_probe::op o) {
+    auto classes = io_latency_probe::merge().get0();
+    auto it = std::find_if(
+      classes.begin(), classes.end(), [&priority_class](const auto& c) {
+          return c.priority_class == priority_class;
+      });
+    BOOST_REQUIRE(it != classes.end());
+    return it->hists[static_cast<size_t>(o)].sample_count();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_records_per_priority_class) {
+    const auto raft = samples("raft", io_latency_probe::op::write);
+    const auto compaction = samples("compaction", io_latency_probe::op::write);
+    io_latency_probe::record(
+      raft_priority(),
+      io_latency_probe::op::write,
+      io_latency_probe::clock_type::now());
+    BOOST_REQUIRE_EQUAL(
+      samples("raft", io_latency_probe::op::write), raft + 1);
+    BOOST_REQUIRE_EQUAL(
+      samples("compaction", io_latency_probe::op::write), compaction);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_measures_the_reads) {
+    auto f = ss::open_file_dma(
+               "test.io_latency_probe.log",
+               ss::open_flags::create | ss::open_flags::rw
+                 | ss::open_flags::truncate)
+               .get0();
+    auto buf = ss::temporary_buffer<char>::aligned(
+      f.memory_dma_alignment(), f.disk_write_dma_alignment());
+    std::fill_n(buf.get_write(), buf.size(), 'x');
+    f.dma_write(0, buf.get(), buf.size()).get();
+    f.flush().get();
+
+    const auto reads = samples("kafka_read", io_latency_probe::op::read);
+    auto measured = io_latency_probe::measure_reads(f);
+    auto data = measured
+                  .dma_read_bulk<char>(0, buf.size(), kafka_read_priority())
+                  .get0();
+    BOOST_REQUIRE_EQUAL(data.size(), buf.size());
+    BOOST_REQUIRE_EQUAL(
+      samples("kafka_read", io_latency_probe::op::read), reads + 1);
+    measured.close().get();
+}
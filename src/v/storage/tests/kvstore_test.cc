@@ -205,3 +205,82 @@ SEASTAR_THREAD_TEST_CASE(kvstore) {
     }
     kvs->stop().get();
 }
+
+SEASTAR_THREAD_TEST_CASE(batched_ops_and_key_space_snapshots) {
+    set_configuration("disable_metrics", true);
+
+    auto dir = ssx::sformat(
+      "kvstore_test_{}", random_generators::get_int(4000));
+
+    auto conf = get_conf(dir);
+
+    std::unordered_map<bytes, iobuf> consensus;
+    std::unordered_map<bytes, iobuf> testing;
+
+    auto kvs = std::make_unique<storage::kvstore>(conf);
+    kvs->start().get();
+
+    std::vector<std::pair<bytes, iobuf>> kvs_batch;
+    for (int i = 0; i < 100; i++) {
+        auto key = random_generators::get_bytes(8);
+        auto value = bytes_to_iobuf(random_generators::get_bytes(100));
+        consensus[key] = value.copy();
+        kvs_batch.emplace_back(key, std::move(value));
+    }
+    kvs->put(storage::kvstore::key_space::consensus, std::move(kvs_batch))
+      .get();
+
+    // keep updating one of the key spaces so the segment rolls a few times
+    for (int round = 0; round < 3; round++) {
+        kvs_batch.clear();
+        for (int i = 0; i < 100; i++) {
+            auto key = random_generators::get_bytes(8);
+            auto value = bytes_to_iobuf(random_generators::get_bytes(100));
+            testing[key] = value.copy();
+            kvs_batch.emplace_back(key, std::move(value));
+        }
+        kvs->put(storage::kvstore::key_space::testing, std::move(kvs_batch))
+          .get();
+
+        std::vector<bytes> removed;
+        for (auto it = testing.begin(); removed.size() < 50;) {
+            removed.push_back(it->first);
+            it = testing.erase(it);
+        }
+        kvs->remove(storage::kvstore::key_space::testing, std::move(removed))
+          .get();
+
+        // restart and verify both key spaces
+        kvs->stop().get();
+        kvs = std::make_unique<storage::kvstore>(conf);
+        kvs->start().get();
+
+        for (auto& e : consensus) {
+            BOOST_REQUIRE(
+              kvs->get(storage::kvstore::key_space::consensus, e.first).value()
+              == e.second);
+        }
+        for (auto& e : testing) {
+            BOOST_REQUIRE(
+              kvs->get(storage::kvstore::key_space::testing, e.first).value()
+              == e.second);
+        }
+    }
+
+    // empty a key space, it shouldn't come back after restarts
+    std::vector<bytes> keys;
+    for (auto& e : consensus) {
+        keys.push_back(e.first);
+    }
+    kvs->remove(storage::kvstore::key_space::consensus, std::move(keys)).get();
+    for (int i = 0; i < 2; i++) {
+        kvs->stop().get();
+        kvs = std::make_unique<storage::kvstore>(conf);
+        kvs->start().get();
+        for (auto& e : consensus) {
+            BOOST_REQUIRE(
+              !kvs->get(storage::kvstore::key_space::consensus, e.first));
+        }
+    }
+    kvs->stop().get();
+}
@@ -8,11 +8,17 @@
 // by the Apache License, Version 2.0
 
 #include "storage/tests/utils/disk_log_builder.h"
+#include "test_utils/async.h"
 // fixture
 #include "test_utils/fixture.h"
 
+#include <seastar/core/seastar.hh>
+
+#include <chrono>
 #include <optional>
 
+using namespace std::chrono_literals; // NOLINT
+
 struct gc_fixture {
     storage::disk_log_builder builder;
 };
@@ -93,3 +99,26 @@ FIXTURE_TEST(retention_test_after_truncation, gc_fixture) {
     BOOST_CHECK_EQUAL(
       builder.get_disk_log_impl().get_probe().partition_size(), 0);
 }
+
+FIXTURE_TEST(retention_removes_files_in_background, gc_fixture) {
+    builder | storage::start() | storage::add_segment(0)
+      | storage::add_random_batch(0, 100, storage::maybe_compress_batches::yes)
+      | storage::add_segment(100)
+      | storage::add_random_batch(100, 2, storage::maybe_compress_batches::yes);
+    builder.get_log().set_collectible_offset(
+      builder.get_log().offsets().dirty_offset);
+    auto filename = builder.get_segment(0).reader().filename();
+
+    builder | storage::garbage_collect(model::timestamp::now(), std::nullopt);
+    BOOST_CHECK_EQUAL(builder.get_log().segment_count(), 1);
+
+    // the files were queued for removal and never reappear in the log
+    auto& deleter = builder.get_log_manager().deleter();
+    tests::cooperative_spin_wait_with_timeout(10s, [&deleter] {
+        return deleter.pending_segments() == 0;
+    }).get();
+    BOOST_CHECK_EQUAL(deleter.pending_bytes(), 0);
+    BOOST_CHECK_EQUAL(deleter.removed_segments(), 1);
+    BOOST_CHECK(!ss::file_exists(filename).get0());
+    builder | storage::stop();
+}
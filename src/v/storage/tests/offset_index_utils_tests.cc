@@ -7,6 +7,7 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 #include "random/generators.h"
+#include "storage/index_cache.h"
 #include "storage/segment_index.h"
 #include "test_utils/fixture.h"
 #include "utils/file_io.h"
@@ -126,3 +127,51 @@ FIXTURE_TEST(bucket_truncate, context) {
         BOOST_REQUIRE_EQUAL(p->filepos, 458048);
     }
 }
+
+FIXTURE_TEST(index_unload_and_materialize, context) {
+    constexpr auto step = storage::segment_index::default_data_buffer_step;
+    tmpbuf_file::store_t other_data;
+    storage::segment_index other(
+      "other in memory iobuf",
+      ss::file(ss::make_shared(tmpbuf_file(other_data))),
+      _base_offset,
+      step);
+    for (uint32_t i = 0; i < 64; ++i) {
+        auto hdr = modify_get(_base_offset + model::offset(i), step);
+        _idx->maybe_track(hdr, i * step);
+        other.maybe_track(hdr, i * step);
+    }
+    _idx->flush().get();
+    other.flush().get();
+
+    // room for one of the indexes only
+    storage::index_cache cache(_idx->memory_usage());
+    _idx->set_cache(&cache);
+    other.set_cache(&cache);
+    BOOST_REQUIRE(!_idx->is_materialized());
+    BOOST_REQUIRE(other.is_materialized());
+    BOOST_REQUIRE_EQUAL(cache.evictions(), 1);
+    BOOST_REQUIRE_EQUAL(cache.size_bytes(), other.memory_usage());
+    // the bounds of an unloaded index are kept
+    BOOST_REQUIRE_EQUAL(_idx->max_offset(), model::offset(63));
+    BOOST_REQUIRE(!_idx->find_nearest(model::offset(10)));
+
+    _idx->ensure_materialized().get();
+    BOOST_REQUIRE(_idx->is_materialized());
+    BOOST_REQUIRE(!other.is_materialized());
+    BOOST_REQUIRE_EQUAL(cache.materializations(), 1);
+    BOOST_REQUIRE_EQUAL(cache.evictions(), 2);
+    index_entry_expect(10, 10 * step);
+
+    // pinned indexes are never unloaded
+    _idx->pin();
+    other.ensure_materialized().get();
+    BOOST_REQUIRE(_idx->is_materialized());
+    BOOST_REQUIRE(other.is_materialized());
+    BOOST_REQUIRE_EQUAL(cache.evictions(), 2);
+    BOOST_REQUIRE_EQUAL(cache.size_bytes(), other.memory_usage());
+
+    _idx->set_cache(nullptr);
+    other.set_cache(nullptr);
+    other.close().get();
+}
@@ -0,0 +1,132 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/configuration.h"
+#include "seastarx.h"
+#include "storage/read_ahead.h"
+#include "units.h"
+
+#include <seastar/core/iostream.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+using storage::read_ahead;
+
+SEASTAR_THREAD_TEST_CASE(read_ahead_follows_progress) {
+    // a tailing reader reads a single minimum buffer
+    auto o = read_ahead::for_progress(0);
+    BOOST_CHECK_EQUAL(o.buffer_size, read_ahead::min_buffer_size);
+    BOOST_CHECK_EQUAL(o.depth, 0);
+    o = read_ahead::for_progress(128_KiB);
+    BOOST_CHECK_EQUAL(o.memory(), read_ahead::min_buffer_size);
+
+    // an eighth of the progress, in buffers of a quarter of it
+    o = read_ahead::for_progress(8_MiB);
+    BOOST_CHECK_EQUAL(o.buffer_size, 256_KiB);
+    BOOST_CHECK_EQUAL(o.memory(), 1_MiB + 256_KiB);
+
+    // bounded whatever the progress
+    o = read_ahead::for_progress(100_GiB);
+    BOOST_CHECK_EQUAL(o.buffer_size, read_ahead::max_buffer_size);
+    BOOST_CHECK_EQUAL(o.depth, 4);
+}
+
+SEASTAR_THREAD_TEST_CASE(read_ahead_is_bounded_per_shard) {
+    config::shard_local_cfg().segment_read_ahead_memory(6_MiB);
+    BOOST_REQUIRE_EQUAL(read_ahead::shard_memory(), 0);
+    {
+        auto first = read_ahead::adaptive(100_GiB);
+        BOOST_CHECK_EQUAL(first.opts().memory(), 5_MiB);
+        BOOST_CHECK_EQUAL(read_ahead::shard_memory(), 5_MiB);
+
+        // only a single 1MiB buffer is left
+        auto second = read_ahead::adaptive(100_GiB);
+        BOOST_CHECK_EQUAL(second.opts().memory(), 1_MiB);
+        BOOST_CHECK_EQUAL(second.opts().depth, 0);
+
+        // nothing left, the minimum buffer without read-ahead
+        auto third = read_ahead::adaptive(100_GiB);
+        BOOST_CHECK_EQUAL(third.opts().memory(), read_ahead::min_buffer_size);
+
+        // explicit read-ahead is counted without being limited
+        auto fixed = read_ahead::fixed(128_KiB, 10);
+        BOOST_CHECK_EQUAL(fixed.opts().memory(), 128_KiB * 11);
+
+        // moving a read-ahead keeps a single reservation
+        auto moved = std::move(first);
+        BOOST_CHECK_EQUAL(
+          read_ahead::shard_memory(),
+          6_MiB + read_ahead::min_buffer_size + 128_KiB * 11);
+        moved = {};
+        BOOST_CHECK_EQUAL(
+          read_ahead::shard_memory(),
+          1_MiB + read_ahead::min_buffer_size + 128_KiB * 11);
+    }
+    BOOST_CHECK_EQUAL(read_ahead::shard_memory(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(read_ahead_grows_with_progress) {
+    config::shard_local_cfg().segment_read_ahead_memory(64_MiB);
+    auto ra = read_ahead::adaptive(0);
+    BOOST_CHECK(!ra.should_grow(128_KiB));
+    BOOST_CHECK(ra.should_grow(4_MiB));
+    // explicit read-ahead never changes
+    auto fixed = read_ahead::fixed(32_KiB, 0);
+    BOOST_CHECK(!fixed.should_grow(100_GiB));
+}
+
+namespace {
+/// the chunks of the stream, counting the reads
+class counting_source final : public ss::data_source_impl {
+public:
+    counting_source(std::vector<ss::sstring> chunks, size_t& reads)
+      : _chunks(std::move(chunks))
+      , _reads(reads) {}
+
+    ss::future<ss::temporary_buffer<char>> get() final {
+        ++_reads;
+        if (_next == _chunks.size()) {
+            return ss::make_ready_future<ss::temporary_buffer<char>>();
+        }
+        const auto& c = _chunks[_next++];
+        return ss::make_ready_future<ss::temporary_buffer<char>>(
+          ss::temporary_buffer<char>(c.data(), c.size()));
+    }
+
+private:
+    std::vector<ss::sstring> _chunks;
+    size_t _next{0};
+    size_t& _reads;
+};
+
+ss::input_stream<char>
+make_counted_stream(std::vector<ss::sstring> chunks, size_t& reads) {
+    return ss::input_stream<char>(ss::data_source(
+      std::make_unique<counting_source>(std::move(chunks), reads)));
+}
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(prefetched_stream_reads_first_buffer) {
+    size_t reads = 0;
+    auto in = storage::make_prefetched_stream(
+      make_counted_stream({"abc", "def"}, reads));
+    // issued before the stream is consumed
+    BOOST_CHECK_EQUAL(reads, 1);
+
+    auto buf = in.read_exactly(6).get0();
+    BOOST_CHECK_EQUAL(ss::sstring(buf.get(), buf.size()), "abcdef");
+    BOOST_CHECK(in.read().get0().empty());
+    in.close().get();
+
+    // closed without being consumed
+    reads = 0;
+    auto unused = storage::make_prefetched_stream(
+      make_counted_stream({"abc"}, reads));
+    BOOST_CHECK_EQUAL(reads, 1);
+    unused.close().get();
+}
@@ -12,6 +12,7 @@
 #include "bytes/iobuf.h"
 #include "bytes/iobuf_parser.h"
 #include "model/record.h"
+#include "model/record_utils.h"
 #include "random/generators.h"
 #include "reflection/adl.h"
 #include "storage/record_batch_builder.h"
@@ -126,3 +127,30 @@ SEASTAR_THREAD_TEST_CASE(serialize_deserialize_then_cmp) {
     });
     BOOST_CHECK_EQUAL(sample_data, sample_output);
 }
+
+SEASTAR_THREAD_TEST_CASE(checksums_match_records) {
+    for (auto c : {model::compression::none, model::compression::zstd}) {
+        storage::record_batch_builder rbb(
+          model::record_batch_type::raft_data, model::offset(0));
+        rbb.set_compression(c);
+        rbb.reserve(100, 100 * 64);
+        for (auto i = 0; i < 100; ++i) {
+            detail::serialize_sample_type(
+              rbb,
+              detail::sample_type{
+                .key = random_generators::gen_alphanum_string(i % 32),
+                .value = random_generators::gen_alphanum_string(32),
+                .kv_pairs = {{"k", random_generators::gen_alphanum_string(i)}},
+              });
+        }
+        rbb.add_raw_kv(std::nullopt, std::nullopt);
+        auto rb = std::move(rbb).build();
+        BOOST_CHECK_EQUAL(rb.record_count(), 101);
+        BOOST_CHECK_EQUAL(
+          static_cast<size_t>(rb.size_bytes()),
+          model::packed_record_batch_header_size + rb.data().size_bytes());
+        BOOST_CHECK_EQUAL(rb.header().crc, model::crc_record_batch(rb));
+        BOOST_CHECK_EQUAL(
+          rb.header().header_crc, model::internal_header_only_crc(rb.header()));
+    }
+}
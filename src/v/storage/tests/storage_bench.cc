@@ -0,0 +1,354 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/configuration.h"
+#include "model/fundamental.h"
+#include "model/record_batch_reader.h"
+#include "random/generators.h"
+#include "storage/batch_cache.h"
+#include "storage/kvstore.h"
+#include "storage/log_manager.h"
+#include "storage/ntp_config.h"
+#include "storage/record_batch_builder.h"
+#include "storage/segment_appender.h"
+#include "units.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/testing/perf_tests.hh>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <optional>
+
+using namespace std::chrono_literals;
+
+/**
+ * Microbenchmarks of the storage write, read and cache paths, run with
+ * -c 1. Each test runs a workload, a batch size and a number of concurrent
+ * appenders, logs or readers, and the fixture reports the operations and
+ * bytes per second and the latency percentiles of an iteration when the
+ * test is done, next to the figures of perf_tests.
+ */
+struct workload {
+    size_t batch_bytes;
+    size_t concurrency;
+    storage::log_append_config::fsync fsync{
+      storage::log_append_config::fsync::no};
+};
+
+class storage_bench_fixture {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    storage_bench_fixture()
+      : _dir("storage_bench." + random_generators::gen_alphanum_string(8)) {
+        config::shard_local_cfg().get("disable_metrics").set_value(true);
+    }
+
+    ~storage_bench_fixture() {
+        if (_ops > 0) {
+            fmt::print(
+              "{}: batch: {} bytes, concurrency: {}\n"
+              "  {:.0f} ops/s, {:.2f} MiB/s\n"
+              "  latency us: p50 {} p99 {} p999 {}\n",
+              _name,
+              _workload.batch_bytes,
+              _workload.concurrency,
+              per_sec(_ops),
+              per_sec(_bytes) / 1_MiB,
+              _latency.get_value_at(50),
+              _latency.get_value_at(99),
+              _latency.get_value_at(99.9));
+        }
+        for (auto& a : _appenders) {
+            a->close().get();
+        }
+        if (_logs) {
+            _logs->stop().get();
+            _kvstore->stop().get();
+        }
+        _indexes.clear();
+        if (_cache) {
+            _cache->stop().get();
+        }
+    }
+
+    /// \brief concurrent appends of a batch to segment appenders, a flush
+    /// per append when fsync is set
+    size_t appender(const workload& w) {
+        if (_appenders.empty()) {
+            start("segment_appender", w);
+            for (size_t i = 0; i < w.concurrency; ++i) {
+                auto f = ss::open_file_dma(
+                           fmt::format("{}/appender.{}", _dir, i),
+                           ss::open_flags::create | ss::open_flags::rw
+                             | ss::open_flags::truncate)
+                           .get0();
+                _appenders.push_back(
+                  std::make_unique<storage::segment_appender>(
+                    std::move(f),
+                    storage::segment_appender::options(
+                      ss::default_priority_class(),
+                      storage::segment_appender::chunks_no_buffer)));
+            }
+        }
+        const auto data = random_generators::gen_alphanum_string(
+          w.batch_bytes);
+        return measure(w.concurrency * w.batch_bytes, [this, &data, &w] {
+            return ss::parallel_for_each(
+              _appenders, [&data, &w](auto& a) {
+                  auto f = a->append(data.data(), data.size());
+                  if (w.fsync == storage::log_append_config::fsync::yes) {
+                      return f.then([&a] { return a->flush(); });
+                  }
+                  return f;
+              });
+        });
+    }
+
+    /// \brief concurrent appends of a batch to disk logs
+    size_t log_append(const workload& w) {
+        if (!_logs) {
+            start("log_append", w);
+            start_logs(w.concurrency, storage::with_cache::yes);
+        }
+        return measure(w.concurrency * w.batch_bytes, [this, &w] {
+            return ss::parallel_for_each(
+              _handles, [this, &w](storage::log& l) {
+                  return append(l, w);
+              });
+        });
+    }
+
+    /// \brief concurrent scans of the whole log, from the batch cache or
+    /// from disk
+    size_t log_read(const workload& w, storage::with_cache cache) {
+        if (!_logs) {
+            start(
+              cache == storage::with_cache::yes ? "log_read_cached"
+                                                : "log_read_disk",
+              w);
+            start_logs(w.concurrency, cache);
+            // 16MiB per log
+            const auto batches = std::max<size_t>(16_MiB / w.batch_bytes, 1);
+            for (auto& l : _handles) {
+                for (size_t i = 0; i < batches; ++i) {
+                    append(l, w).get();
+                }
+                l.flush().get();
+                _log_bytes += l.size_bytes();
+            }
+        }
+        return measure(_log_bytes, [this] {
+            return ss::parallel_for_each(_handles, [](storage::log& l) {
+                storage::log_reader_config cfg(
+                  l.offsets().start_offset,
+                  l.offsets().committed_offset,
+                  ss::default_priority_class());
+                return l.make_reader(cfg).then(
+                  [](model::record_batch_reader r) {
+                      return model::consume_reader_to_memory(
+                               std::move(r), model::no_timeout)
+                        .then([](auto batches) {
+                            perf_tests::do_not_optimize(batches);
+                        });
+                  });
+            });
+        });
+    }
+
+    /// \brief puts and gets of batches in the batch cache, the cache holds
+    /// concurrency * 1024 batches
+    size_t cache_put_get(const workload& w) {
+        static constexpr size_t batches_per_index = 1024;
+        if (!_cache) {
+            start("batch_cache", w);
+            _cache = std::make_unique<storage::batch_cache>(
+              storage::batch_cache::reclaim_options{
+                .growth_window = 3s,
+                .stable_window = 10s,
+                .min_size = 128_KiB,
+                .max_size = 4_MiB,
+              });
+            for (size_t i = 0; i < w.concurrency; ++i) {
+                _indexes.emplace_back(*_cache);
+            }
+            _batch = make_batch(w.batch_bytes);
+        }
+        const auto offset = model::offset(
+          random_generators::get_int<int64_t>(0, batches_per_index - 1));
+        return measure(w.concurrency * w.batch_bytes, [this, offset] {
+            for (auto& index : _indexes) {
+                auto b = _batch->share();
+                b.header().base_offset = offset;
+                index.put(b);
+                perf_tests::do_not_optimize(index.get(offset));
+            }
+            return ss::now();
+        });
+    }
+
+private:
+    void start(ss::sstring name, const workload& w) {
+        _name = std::move(name);
+        _workload = w;
+        ss::recursive_touch_directory(_dir).get();
+    }
+
+    void start_logs(size_t n, storage::with_cache cache) {
+        _kvstore = std::make_unique<storage::kvstore>(storage::kvstore_config(
+          1_MiB, 10ms, _dir, storage::debug_sanitize_files::no));
+        _kvstore->start().get();
+        _logs = std::make_unique<storage::log_manager>(
+          storage::log_config(
+            storage::log_config::storage_type::disk,
+            _dir,
+            1_GiB,
+            storage::debug_sanitize_files::no,
+            ss::default_priority_class(),
+            cache),
+          *_kvstore);
+        for (size_t i = 0; i < n; ++i) {
+            auto ntp = model::ntp(
+              model::kafka_namespace,
+              model::topic("bench"),
+              model::partition_id(i));
+            _handles.push_back(
+              _logs->manage(storage::ntp_config(ntp, _dir)).get0());
+        }
+    }
+
+    ss::future<> append(storage::log& l, const workload& w) {
+        storage::log_append_config cfg{
+          w.fsync, ss::default_priority_class(), model::no_timeout};
+        ss::circular_buffer<model::record_batch> batches;
+        batches.push_back(make_batch(w.batch_bytes));
+        auto reader = model::make_memory_record_batch_reader(
+          std::move(batches));
+        return std::move(reader)
+          .for_each_ref(l.make_appender(cfg), cfg.timeout)
+          .discard_result();
+    }
+
+    static model::record_batch make_batch(size_t bytes) {
+        // a few records of a batch
+        static constexpr size_t records = 4;
+        storage::record_batch_builder builder(
+          model::record_batch_type::raft_data, model::offset(0));
+        const auto value = random_generators::gen_alphanum_string(
+          std::max<size_t>(bytes / records, 1));
+        for (size_t i = 0; i < records; ++i) {
+            iobuf v;
+            v.append(value.data(), value.size());
+            builder.add_raw_kv(iobuf{}, std::move(v));
+        }
+        return std::move(builder).build();
+    }
+
+    template<typename Func>
+    size_t measure(size_t bytes, Func f) {
+        perf_tests::start_measuring_time();
+        const auto start = clock_type::now();
+        f().get();
+        const auto elapsed = clock_type::now() - start;
+        perf_tests::stop_measuring_time();
+        _latency.record(
+          std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+            .count());
+        _elapsed += elapsed;
+        _ops += _workload.concurrency;
+        _bytes += bytes;
+        return _workload.concurrency;
+    }
+
+    double per_sec(size_t n) const {
+        const auto secs = std::chrono::duration<double>(_elapsed).count();
+        return secs > 0 ? static_cast<double>(n) / secs : 0;
+    }
+
+    ss::sstring _dir;
+    ss::sstring _name;
+    workload _workload{};
+    std::vector<std::unique_ptr<storage::segment_appender>> _appenders;
+    std::unique_ptr<storage::kvstore> _kvstore;
+    std::unique_ptr<storage::log_manager> _logs;
+    std::vector<storage::log> _handles;
+    size_t _log_bytes{0};
+    std::unique_ptr<storage::batch_cache> _cache;
+    std::vector<storage::batch_cache_index> _indexes;
+    std::optional<model::record_batch> _batch;
+    hdr_hist _latency;
+    size_t _ops{0};
+    size_t _bytes{0};
+    clock_type::duration _elapsed{0};
+};
+
+PERF_TEST_F(storage_bench_fixture, appender_4kib) {
+    return appender({.batch_bytes = 4_KiB, .concurrency = 1});
+}
+
+PERF_TEST_F(storage_bench_fixture, appender_1mib) {
+    return appender({.batch_bytes = 1_MiB, .concurrency = 1});
+}
+
+PERF_TEST_F(storage_bench_fixture, appender_16kib_8_segments) {
+    return appender({.batch_bytes = 16_KiB, .concurrency = 8});
+}
+
+PERF_TEST_F(storage_bench_fixture, appender_16kib_flush) {
+    return appender(
+      {.batch_bytes = 16_KiB,
+       .concurrency = 1,
+       .fsync = storage::log_append_config::fsync::yes});
+}
+
+PERF_TEST_F(storage_bench_fixture, log_append_16kib) {
+    return log_append({.batch_bytes = 16_KiB, .concurrency = 1});
+}
+
+PERF_TEST_F(storage_bench_fixture, log_append_16kib_fsync) {
+    return log_append(
+      {.batch_bytes = 16_KiB,
+       .concurrency = 1,
+       .fsync = storage::log_append_config::fsync::yes});
+}
+
+PERF_TEST_F(storage_bench_fixture, log_append_16kib_16_logs_fsync) {
+    return log_append(
+      {.batch_bytes = 16_KiB,
+       .concurrency = 16,
+       .fsync = storage::log_append_config::fsync::yes});
+}
+
+PERF_TEST_F(storage_bench_fixture, log_read_cached_16kib) {
+    return log_read(
+      {.batch_bytes = 16_KiB, .concurrency = 1}, storage::with_cache::yes);
+}
+
+PERF_TEST_F(storage_bench_fixture, log_read_disk_16kib) {
+    return log_read(
+      {.batch_bytes = 16_KiB, .concurrency = 1}, storage::with_cache::no);
+}
+
+PERF_TEST_F(storage_bench_fixture, log_read_disk_16kib_4_logs) {
+    return log_read(
+      {.batch_bytes = 16_KiB, .concurrency = 4}, storage::with_cache::no);
+}
+
+PERF_TEST_F(storage_bench_fixture, batch_cache_1kib) {
+    return cache_put_get({.batch_bytes = 1_KiB, .concurrency = 16});
+}
+
+PERF_TEST_F(storage_bench_fixture, batch_cache_64kib) {
+    return cache_put_get({.batch_bytes = 64_KiB, .concurrency = 16});
+}
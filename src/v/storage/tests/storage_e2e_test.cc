@@ -17,6 +17,7 @@
 #include "storage/batch_cache.h"
 #include "storage/log_manager.h"
 #include "storage/record_batch_builder.h"
+#include "storage/segment_summary.h"
 #include "storage/segment_utils.h"
 #include "storage/tests/storage_test_fixture.h"
 #include "storage/tests/utils/disk_log_builder.h"
@@ -33,6 +34,7 @@
 #include <boost/test/tools/old/interface.hpp>
 
 #include <algorithm>
+#include <filesystem>
 #include <iterator>
 #include <numeric>
 
@@ -241,6 +243,44 @@ FIXTURE_TEST(test_reading_range_from_a_log, storage_test_fixture) {
     BOOST_REQUIRE_EQUAL(range.back().header().crc, batches[7].header().crc);
 };
 
+FIXTURE_TEST(test_term_end, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto ntp = model::ntp("default", "test", 0);
+    auto log
+      = mgr.manage(storage::ntp_config(ntp, mgr.config().base_dir)).get0();
+    BOOST_REQUIRE(!log.term_end(model::term_id(1)));
+
+    // the base offsets of terms 1, 3 and 4
+    std::vector<model::offset> term_starts;
+    model::offset current_offset = model::offset{0};
+    for (auto t : {1, 3, 4}) {
+        term_starts.push_back(current_offset);
+        for (auto h : append_random_batches(log, 2, model::term_id(t))) {
+            current_offset += h.last_offset_delta + 1;
+        }
+    }
+    log.flush().get();
+    const auto log_end = log.offsets().dirty_offset + model::offset(1);
+
+    auto check = [&log](int requested, int term, model::offset end) {
+        auto res = log.term_end(model::term_id(requested));
+        BOOST_REQUIRE(res);
+        BOOST_REQUIRE_EQUAL(res->term, model::term_id(term));
+        BOOST_REQUIRE_EQUAL(res->end_offset, end);
+    };
+    // a term older than the log ends where the log starts
+    check(0, 0, term_starts[0]);
+    check(1, 1, term_starts[1]);
+    // terms without batches end as the latest term before them
+    check(2, 1, term_starts[1]);
+    check(3, 3, term_starts[2]);
+    check(4, 4, log_end);
+    check(5, 4, log_end);
+};
+
 FIXTURE_TEST(test_rolling_term, storage_test_fixture) {
     storage::log_manager mgr = make_log_manager();
     info("Configuration: {}", mgr.config());
@@ -516,6 +556,80 @@ FIXTURE_TEST(test_time_based_eviction, storage_test_fixture) {
       disk_log->segments().back()->offsets().dirty_offset, model::offset(59));
 };
 
+struct snapshot_stm final : storage::snapshotable_stm {
+    ss::future<> ensure_snapshot_exists(model::offset o) final {
+        snapshot_offset = std::max(snapshot_offset, o);
+        return ss::now();
+    }
+    ss::future<> make_snapshot() final {
+        snapshots++;
+        snapshot_offset = applied_offset;
+        return ss::now();
+    }
+    model::offset last_snapshot_offset() const final { return snapshot_offset; }
+
+    model::offset applied_offset;
+    model::offset snapshot_offset;
+    size_t snapshots{0};
+};
+
+FIXTURE_TEST(test_eviction_bounded_by_stm_snapshot, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    ss::abort_source as;
+    storage::log_manager mgr = make_log_manager(cfg);
+    info("Configuration: {}", mgr.config());
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto ntp = model::ntp("default", "test", 0);
+
+    storage::ntp_config ntp_cfg(ntp, mgr.config().base_dir);
+    auto log = mgr.manage(std::move(ntp_cfg)).get0();
+    auto disk_log = get_disk_log(log);
+    auto stm = ss::make_shared<snapshot_stm>();
+    log.stm_manager()->add_stm(stm);
+
+    /**
+     *  Log contains 3 segments with following timestamps:
+     *
+     * [100..110][200..230][231..261]
+     */
+    append_custom_timestamp_batches(
+      log, 10, model::term_id(0), model::timestamp(100));
+    disk_log->force_roll(ss::default_priority_class()).get0();
+    append_custom_timestamp_batches(
+      log, 30, model::term_id(0), model::timestamp(200));
+    disk_log->force_roll(ss::default_priority_class()).get0();
+    append_custom_timestamp_batches(
+      log, 20, model::term_id(0), model::timestamp(231));
+    log.set_collectible_offset(log.offsets().dirty_offset);
+
+    auto compaction_cfg = storage::compaction_config(
+      model::timestamp(240), std::nullopt, ss::default_priority_class(), as);
+
+    // the state machine snapshots ahead of the eviction, the log is only
+    // evicted up to the offset it has applied
+    stm->applied_offset = model::offset(15);
+    auto snapshots = stm->snapshots;
+    log.compact(compaction_cfg).get0();
+    BOOST_REQUIRE_GT(stm->snapshots, snapshots);
+    BOOST_REQUIRE_EQUAL(stm->snapshot_offset, model::offset(15));
+    BOOST_REQUIRE_EQUAL(disk_log->segments().size(), 2);
+    BOOST_REQUIRE_EQUAL(
+      disk_log->segments().front()->offsets().base_offset, model::offset(10));
+
+    // the rest is evicted once the state machine catches up
+    stm->applied_offset = model::offset(59);
+    log.compact(compaction_cfg).get0();
+    BOOST_REQUIRE_EQUAL(disk_log->segments().size(), 1);
+    BOOST_REQUIRE_EQUAL(
+      disk_log->segments().front()->offsets().base_offset, model::offset(40));
+
+    // nothing to snapshot when the snapshot already covers the eviction
+    snapshots = stm->snapshots;
+    log.compact(compaction_cfg).get0();
+    BOOST_REQUIRE_EQUAL(stm->snapshots, snapshots);
+};
+
 FIXTURE_TEST(test_size_based_eviction, storage_test_fixture) {
     auto cfg = default_log_config(test_dir);
     cfg.max_segment_size = 10;
@@ -1341,6 +1455,60 @@ FIXTURE_TEST(adjacent_segment_compaction_terms, storage_test_fixture) {
     }
 }
 
+FIXTURE_TEST(sliding_window_compaction, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    // do not merge the segments so the window compaction result is visible
+    cfg.max_compacted_segment_size = 1;
+    cfg.stype = storage::log_config::storage_type::disk;
+    cfg.cache = storage::with_cache::yes;
+    storage::ntp_config::default_overrides overrides;
+    overrides.cleanup_policy_bitflags
+      = model::cleanup_policy_bitflags::compaction;
+
+    ss::abort_source as;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto ntp = model::ntp("default", "test", 0);
+    auto log = mgr
+                 .manage(storage::ntp_config(
+                   ntp,
+                   mgr.config().base_dir,
+                   std::make_unique<storage::ntp_config::default_overrides>(
+                     overrides)))
+                 .get0();
+
+    // keys of the first segment are all updated in the second one
+    auto disk_log = get_disk_log(log);
+    append_exactly(log, 1, 128, bytes("a")).get0();
+    append_exactly(log, 1, 128, bytes("b")).get0();
+    disk_log->force_roll(ss::default_priority_class()).get();
+    append_exactly(log, 1, 128, bytes("a")).get0();
+    append_exactly(log, 1, 128, bytes("b")).get0();
+    disk_log->force_roll(ss::default_priority_class()).get();
+    append_exactly(log, 1, 128, bytes("c")).get0();
+    log.flush().get0();
+
+    BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 3);
+
+    storage::compaction_config c_cfg(
+      model::timestamp::min(), std::nullopt, ss::default_priority_class(), as);
+
+    // self compaction of the closed segments doesn't remove anything
+    log.compact(c_cfg).get0();
+    log.compact(c_cfg).get0();
+    BOOST_REQUIRE_EQUAL(read_and_validate_all_batches(log).size(), 5);
+
+    // the first record is superseded by the second segment, the last record
+    // of the segment is kept to preserve its offsets
+    log.compact(c_cfg).get0();
+    BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 3);
+    auto batches = read_and_validate_all_batches(log);
+    BOOST_REQUIRE_EQUAL(batches.size(), 4);
+    BOOST_REQUIRE_EQUAL(batches.front().base_offset(), model::offset(1));
+    BOOST_REQUIRE_EQUAL(
+      disk_log->segments().front()->offsets().base_offset, model::offset(0));
+}
+
 FIXTURE_TEST(max_adjacent_segment_compaction, storage_test_fixture) {
     auto cfg = default_log_config(test_dir);
     cfg.max_compacted_segment_size = 6_MiB;
@@ -1824,3 +1992,454 @@ FIXTURE_TEST(committed_offset_updates, storage_test_fixture) {
 
     ss::when_all_succeed(futures.begin(), futures.end()).get();
 }
+
+FIXTURE_TEST(clean_shutdown_skips_tail_recovery, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    auto ntp = model::ntp("default", "test", 0);
+    auto key = storage::internal::clean_segment_key(ntp);
+    model::offset dirty_offset;
+    {
+        storage::log_manager mgr = make_log_manager(cfg);
+        auto log
+          = mgr.manage(storage::ntp_config(ntp, mgr.config().base_dir)).get0();
+        append_random_batches(log, 10);
+        log.flush().get0();
+        dirty_offset = log.offsets().dirty_offset;
+        mgr.stop().get0();
+    }
+    // the log was closed cleanly
+    BOOST_REQUIRE(kvstore.get(storage::kvstore::key_space::storage, key));
+
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto log
+      = mgr.manage(storage::ntp_config(ntp, mgr.config().base_dir)).get0();
+    BOOST_REQUIRE_EQUAL(log.offsets().dirty_offset, dirty_offset);
+    // a crash from now on requires the tail to be recovered
+    BOOST_REQUIRE(!kvstore.get(storage::kvstore::key_space::storage, key));
+    auto batches = read_and_validate_all_batches(log);
+    BOOST_REQUIRE_EQUAL(batches.back().last_offset(), dirty_offset);
+}
+
+FIXTURE_TEST(segment_rolling_with_staged_segments, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    cfg.max_segment_size = 10_KiB;
+    auto ntp = model::ntp("default", "test", 0);
+    std::filesystem::path work_dir;
+    std::vector<model::record_batch_header> headers;
+    auto count_staged_files = [&work_dir] {
+        return std::count_if(
+          std::filesystem::directory_iterator(work_dir),
+          std::filesystem::directory_iterator{},
+          [](const std::filesystem::directory_entry& e) {
+              return e.path().extension() == ".staged";
+          });
+    };
+    {
+        storage::log_manager mgr = make_log_manager(cfg);
+        auto ntp_cfg = storage::ntp_config(ntp, mgr.config().base_dir);
+        work_dir = std::filesystem::path(ntp_cfg.work_directory());
+        auto log = mgr.manage(std::move(ntp_cfg)).get0();
+        // leave time to the staging between the appends
+        while (log.segment_count() < 5) {
+            auto appended = append_random_batches(log, 1);
+            headers.insert(headers.end(), appended.begin(), appended.end());
+            ss::sleep(std::chrono::milliseconds(1)).get();
+        }
+        BOOST_REQUIRE_GT(mgr.roll_probe().get_staged_rolls(), 0);
+        auto batches = read_and_validate_all_batches(log);
+        BOOST_REQUIRE_EQUAL(headers.size(), batches.size());
+        mgr.stop().get0();
+    }
+    // the files staged for the next segment are removed with the log
+    BOOST_REQUIRE_EQUAL(count_staged_files(), 0);
+
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto log
+      = mgr.manage(storage::ntp_config(ntp, mgr.config().base_dir)).get0();
+    auto batches = read_and_validate_all_batches(log);
+    BOOST_REQUIRE_EQUAL(headers.size(), batches.size());
+}
+
+FIXTURE_TEST(partitions_placed_in_data_directories, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    cfg.additional_dirs = {test_dir + "_1", test_dir + "_2"};
+    std::vector<model::ntp> ntps;
+    for (int i = 0; i < 6; ++i) {
+        ntps.emplace_back("kafka", "test", i);
+    }
+    absl::flat_hash_map<model::ntp, ss::sstring> placement;
+    {
+        storage::log_manager mgr = make_log_manager(cfg);
+        auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+        for (const auto& ntp : ntps) {
+            auto log = mgr.manage(storage::ntp_config(ntp, cfg.base_dir))
+                         .get0();
+            append_random_batches(log, 2);
+            placement.emplace(ntp, log.config().base_directory());
+        }
+        // least loaded first: every directory gets two of the partitions
+        for (const auto& usage : mgr.data_directories_usage()) {
+            BOOST_REQUIRE_EQUAL(usage.partitions, 2);
+        }
+    }
+    // the partitions are recovered from the directory they were placed in
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    for (const auto& ntp : ntps) {
+        auto log = mgr.manage(storage::ntp_config(ntp, cfg.base_dir)).get0();
+        BOOST_REQUIRE_EQUAL(log.config().base_directory(), placement[ntp]);
+        BOOST_REQUIRE_GT(log.size_bytes(), 0);
+    }
+}
+
+FIXTURE_TEST(disk_usage_follows_log_sizes, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    const model::topic_namespace tp_a(model::ns("kafka"), model::topic("a"));
+    const model::topic_namespace tp_b(model::ns("kafka"), model::topic("b"));
+    std::vector<storage::log> logs;
+    for (const auto& ntp :
+         {model::ntp("kafka", "a", 0),
+          model::ntp("kafka", "a", 1),
+          model::ntp("kafka", "b", 0)}) {
+        auto log = mgr.manage(storage::ntp_config(ntp, cfg.base_dir)).get0();
+        append_random_batches(log, 5);
+        logs.push_back(log);
+    }
+    auto topic_usage = [&mgr](const model::topic_namespace& tp_ns) {
+        const auto& topics = mgr.usage().topics();
+        auto it = topics.find(tp_ns);
+        return it == topics.end() ? storage::disk_usage::usage{} : it->second;
+    };
+    auto check = [&] {
+        auto a = topic_usage(tp_a);
+        BOOST_REQUIRE_EQUAL(
+          a.size_bytes, logs[0].size_bytes() + logs[1].size_bytes());
+        auto dir = mgr.data_directories_usage().front();
+        BOOST_REQUIRE_EQUAL(dir.partitions, a.partitions + 1);
+        BOOST_REQUIRE_EQUAL(
+          dir.size_bytes, a.size_bytes + topic_usage(tp_b).size_bytes);
+    };
+    BOOST_REQUIRE_EQUAL(topic_usage(tp_a).partitions, 2);
+    BOOST_REQUIRE_EQUAL(topic_usage(tp_b).size_bytes, logs[2].size_bytes());
+    check();
+
+    // rolled segments and truncations are accounted
+    get_disk_log(logs[0])->force_roll(ss::default_priority_class()).get0();
+    append_random_batches(logs[0], 2);
+    logs[1]
+      .truncate(storage::truncate_config(
+        logs[1].offsets().dirty_offset, ss::default_priority_class()))
+      .get0();
+    check();
+
+    // the topic is dropped with its last log
+    mgr.remove(logs[2].config().ntp()).get0();
+    logs.pop_back();
+    BOOST_REQUIRE_EQUAL(mgr.usage().topics().size(), 1);
+    check();
+}
+
+FIXTURE_TEST(memory_backed_log_ring_retention, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto overrides = std::make_unique<storage::ntp_config::default_overrides>();
+    overrides->storage_engine = model::storage_engine::memory;
+    overrides->retention_bytes = tristate<size_t>(64_KiB);
+    storage::ntp_config ntp_cfg(
+      model::ntp("default", "test", 0),
+      mgr.config().base_dir,
+      std::move(overrides));
+    const auto work_dir = std::filesystem::path(ntp_cfg.work_directory());
+    auto log = mgr.manage(std::move(ntp_cfg)).get0();
+    ss::abort_source as;
+    auto evicted = log.monitor_eviction(as);
+
+    // past the capacity the eviction is notified, nothing is removed before
+    // it's collectible
+    while (log.size_bytes() <= 64_KiB) {
+        append_random_batches(log, 1);
+    }
+    BOOST_REQUIRE(evicted.available());
+    BOOST_REQUIRE_GE(evicted.get0(), log.offsets().start_offset);
+    BOOST_REQUIRE_EQUAL(log.offsets().start_offset, model::offset(0));
+
+    log.set_collectible_offset(log.offsets().dirty_offset);
+    append_random_batches(log, 1);
+    auto batches = read_and_validate_all_batches(log);
+    BOOST_REQUIRE_GT(log.offsets().start_offset, model::offset(0));
+    BOOST_REQUIRE_EQUAL(
+      batches.front().base_offset(), log.offsets().start_offset);
+    BOOST_REQUIRE(log.size_bytes() <= 64_KiB || batches.size() == 1);
+
+    // the batches never reach the disk
+    BOOST_REQUIRE(std::none_of(
+      std::filesystem::directory_iterator(work_dir),
+      std::filesystem::directory_iterator{},
+      [](const std::filesystem::directory_entry& e) {
+          return e.path().extension() == ".log";
+      }));
+}
+
+FIXTURE_TEST(sealed_segments_recovered_from_summary, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    cfg.max_segment_size = 10_KiB;
+    auto ntp = model::ntp("default", "test", 0);
+    std::vector<model::record_batch_header> headers;
+    std::vector<storage::segment_summary> summaries;
+    {
+        storage::log_manager mgr = make_log_manager(cfg);
+        auto log
+          = mgr.manage(storage::ntp_config(ntp, mgr.config().base_dir)).get0();
+        while (log.segment_count() < 4) {
+            auto appended = append_random_batches(log, 1);
+            headers.insert(headers.end(), appended.begin(), appended.end());
+        }
+        auto& segs = get_disk_log(log)->segments();
+        for (size_t i = 0; i < segs.size() - 1; ++i) {
+            auto summary = storage::segment_summary::read(
+                             segs[i]->reader().filename().c_str())
+                             .get0();
+            BOOST_REQUIRE(summary);
+            BOOST_REQUIRE_EQUAL(
+              summary->base_offset, segs[i]->offsets().base_offset);
+            BOOST_REQUIRE_EQUAL(
+              summary->max_offset, segs[i]->offsets().dirty_offset);
+            // wipe the index the summary was sealed with
+            std::filesystem::resize_file(
+              std::filesystem::path(segs[i]->index().filename().c_str()), 0);
+            summaries.push_back(*summary);
+        }
+        mgr.stop().get0();
+    }
+
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto log
+      = mgr.manage(storage::ntp_config(ntp, mgr.config().base_dir)).get0();
+    auto& segs = get_disk_log(log)->segments();
+    BOOST_REQUIRE_EQUAL(segs.size(), summaries.size() + 1);
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(
+          segs[i]->offsets().base_offset, summaries[i].base_offset);
+        BOOST_REQUIRE_EQUAL(
+          segs[i]->offsets().dirty_offset, summaries[i].max_offset);
+    }
+    auto batches = read_and_validate_all_batches(log);
+    BOOST_REQUIRE_EQUAL(headers.size(), batches.size());
+    BOOST_REQUIRE_EQUAL(
+      batches.back().last_offset(), headers.back().last_offset());
+
+    // a torn summary is ignored
+    auto buf = summaries.front().serialize();
+    BOOST_REQUIRE(
+      storage::segment_summary::deserialize(buf.copy()) == summaries.front());
+    buf.trim_back(1);
+    BOOST_REQUIRE(!storage::segment_summary::deserialize(std::move(buf)));
+}
+
+FIXTURE_TEST(cold_segments_recompressed, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    cfg.recompression_min_age = std::chrono::milliseconds(1);
+    storage::ntp_config::default_overrides overrides;
+    overrides.compression = model::compression::zstd;
+
+    ss::abort_source as;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto ntp = model::ntp("default", "test", 0);
+    auto log = mgr
+                 .manage(storage::ntp_config(
+                   ntp,
+                   mgr.config().base_dir,
+                   std::make_unique<storage::ntp_config::default_overrides>(
+                     overrides)))
+                 .get0();
+
+    auto disk_log = get_disk_log(log);
+    auto headers = append_random_batches(log, 10);
+    disk_log->force_roll(ss::default_priority_class()).get();
+    auto appended = append_random_batches(log, 10);
+    headers.insert(headers.end(), appended.begin(), appended.end());
+    disk_log->force_roll(ss::default_priority_class()).get();
+    appended = append_random_batches(log, 10);
+    headers.insert(headers.end(), appended.begin(), appended.end());
+    log.flush().get0();
+    BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 3);
+    const auto sealed_end = disk_log->segments()[1]->offsets().dirty_offset;
+    ss::sleep(std::chrono::milliseconds(10)).get();
+
+    storage::compaction_config c_cfg(
+      model::timestamp::min(), std::nullopt, ss::default_priority_class(), as);
+    // one segment is recompressed per round
+    log.compact(c_cfg).get0();
+    log.compact(c_cfg).get0();
+    BOOST_REQUIRE(disk_log->segments()[0]->finished_recompression());
+    BOOST_REQUIRE(disk_log->segments()[1]->finished_recompression());
+    BOOST_REQUIRE(!disk_log->segments()[2]->finished_recompression());
+
+    auto batches = read_and_validate_all_batches(log);
+    BOOST_REQUIRE_EQUAL(headers.size(), batches.size());
+    for (size_t i = 0; i < batches.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(
+          batches[i].header().first_timestamp, headers[i].first_timestamp);
+        BOOST_REQUIRE_EQUAL(batches[i].record_count(), headers[i].record_count);
+        if (batches[i].last_offset() <= sealed_end) {
+            BOOST_REQUIRE_EQUAL(
+              batches[i].header().attrs.compression(),
+              model::compression::zstd);
+        } else {
+            // the active segment is kept as it was appended
+            BOOST_REQUIRE_EQUAL(
+              batches[i].header().attrs.compression(),
+              headers[i].attrs.compression());
+        }
+    }
+}
+
+static void
+append_kv_batch(storage::log log, const bytes& key, std::optional<bytes> v) {
+    storage::record_batch_builder builder(
+      model::record_batch_type::raft_data, model::offset(0));
+    std::optional<iobuf> value;
+    if (v) {
+        value = bytes_to_iobuf(*v);
+    }
+    builder.add_raw_kv(bytes_to_iobuf(key), std::move(value));
+    auto reader = model::make_memory_record_batch_reader(
+      std::move(builder).build());
+    storage::log_append_config cfg{
+      .should_fsync = storage::log_append_config::fsync::no,
+      .io_priority = ss::default_priority_class(),
+      .timeout = model::no_timeout,
+    };
+    std::move(reader).for_each_ref(log.make_appender(cfg), cfg.timeout).get0();
+}
+
+FIXTURE_TEST(key_query_across_segments, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    storage::ntp_config::default_overrides overrides;
+    overrides.cleanup_policy_bitflags
+      = model::cleanup_policy_bitflags::compaction;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto ntp = model::ntp("default", "test", 0);
+    auto log = mgr
+                 .manage(storage::ntp_config(
+                   ntp,
+                   mgr.config().base_dir,
+                   std::make_unique<storage::ntp_config::default_overrides>(
+                     overrides)))
+                 .get0();
+    auto disk_log = get_disk_log(log);
+
+    append_kv_batch(log, bytes("a"), bytes("a-0"));
+    append_kv_batch(log, bytes("b"), bytes("b-0"));
+    append_kv_batch(log, bytes("c"), bytes("c-0"));
+    disk_log->force_roll(ss::default_priority_class()).get();
+    append_kv_batch(log, bytes("a"), bytes("a-1"));
+    append_kv_batch(log, bytes("c"), std::nullopt);
+    disk_log->force_roll(ss::default_priority_class()).get();
+    append_kv_batch(log, bytes("d"), bytes("d-0"));
+    log.flush().get0();
+    BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 3);
+
+    auto query = [&log](const char* key, model::offset max_offset) {
+        return log
+          .key_query(storage::key_query_config(
+            bytes(key), max_offset, ss::default_priority_class()))
+          .get0();
+    };
+    auto value_of = [](const storage::key_query_result& r) {
+        return iobuf_to_bytes(r.value->copy());
+    };
+    const auto dirty = log.offsets().dirty_offset;
+
+    // the latest update of a key in an older segment
+    auto a = query("a", dirty);
+    BOOST_REQUIRE(a);
+    BOOST_REQUIRE_EQUAL(a->offset, model::offset(3));
+    BOOST_REQUIRE_EQUAL(value_of(*a), bytes("a-1"));
+    // not after the max offset
+    a = query("a", model::offset(2));
+    BOOST_REQUIRE(a);
+    BOOST_REQUIRE_EQUAL(a->offset, model::offset(0));
+    BOOST_REQUIRE_EQUAL(value_of(*a), bytes("a-0"));
+
+    auto b = query("b", dirty);
+    BOOST_REQUIRE(b);
+    BOOST_REQUIRE_EQUAL(b->offset, model::offset(1));
+
+    // a tombstone
+    auto c = query("c", dirty);
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(c->offset, model::offset(4));
+    BOOST_REQUIRE(!c->value);
+
+    // a key of the active segment
+    auto d = query("d", dirty);
+    BOOST_REQUIRE(d);
+    BOOST_REQUIRE_EQUAL(value_of(*d), bytes("d-0"));
+
+    BOOST_REQUIRE(!query("e", dirty));
+    BOOST_REQUIRE(!query("d", model::offset(4)));
+}
+
+FIXTURE_TEST(reader_locks_only_the_segment_it_reads, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto ntp = model::ntp("default", "test", 0);
+    auto log
+      = mgr.manage(storage::ntp_config(ntp, mgr.config().base_dir)).get0();
+    auto disk_log = get_disk_log(log);
+
+    auto headers = append_random_batches(log, 5);
+    for (int i = 0; i < 2; ++i) {
+        disk_log->force_roll(ss::default_priority_class()).get();
+        auto appended = append_random_batches(log, 5);
+        headers.insert(headers.end(), appended.begin(), appended.end());
+    }
+    log.flush().get0();
+    std::vector<ss::lw_shared_ptr<storage::segment>> segments;
+    std::copy(
+      disk_log->segments().begin(),
+      disk_log->segments().end(),
+      std::back_inserter(segments));
+    BOOST_REQUIRE_EQUAL(segments.size(), 3);
+
+    storage::log_reader_config reader_cfg(
+      model::offset(0),
+      log.offsets().dirty_offset,
+      ss::default_priority_class());
+    auto reader = log.make_reader(reader_cfg).get0();
+
+    auto lock_within = [](ss::lw_shared_ptr<storage::segment>& s) {
+        return s->write_lock(
+          ss::semaphore::clock::now() + std::chrono::milliseconds(10));
+    };
+    // the reader holds the segment it starts in, and none of the next
+    BOOST_REQUIRE_THROW(
+      lock_within(segments[0]).get0(), ss::semaphore_timed_out);
+    lock_within(segments[1]).get0();
+    lock_within(segments[2]).get0();
+
+    auto batches = model::consume_reader_to_memory(
+                     std::move(reader), model::no_timeout)
+                     .get0();
+    BOOST_REQUIRE_EQUAL(batches.size(), headers.size());
+    BOOST_REQUIRE_EQUAL(
+      batches.back().last_offset(), headers.back().last_offset());
+}
@@ -114,3 +114,52 @@ FIXTURE_TEST(timequery_single_value, log_builder_fixture) {
     BOOST_TEST(res->offset == model::offset(0));
     b | stop();
 }
+
+FIXTURE_TEST(timequery_segments_out_of_time_order, log_builder_fixture) {
+    using namespace storage; // NOLINT
+
+    b | start();
+
+    // the timestamps are set by the producers, the max timestamps of the
+    // segments are 99, 19, 209, 29 and 309
+    auto add_segment_with_timestamps = [this](int base_offset, int base_ts) {
+        b | add_segment(base_offset);
+        for (auto i = 0; i < 10; ++i) {
+            auto batch = test::make_random_batch(
+              model::offset(base_offset + i), 1, false);
+            batch.header().first_timestamp = model::timestamp(base_ts + i);
+            batch.header().max_timestamp = model::timestamp(base_ts + i);
+            b | add_batch(std::move(batch));
+        }
+    };
+    add_segment_with_timestamps(0, 90);
+    add_segment_with_timestamps(10, 10);
+    add_segment_with_timestamps(20, 200);
+    add_segment_with_timestamps(30, 20);
+    add_segment_with_timestamps(40, 300);
+
+    auto query = [this](int ts) {
+        auto log = b.get_log();
+        storage::timequery_config config(
+          model::timestamp(ts),
+          log.offsets().dirty_offset,
+          ss::default_priority_class());
+        return log.timequery(config).get0();
+    };
+
+    // the first batch at or after the time, whatever the segments after it
+    for (auto [ts, offset] : {
+           std::pair{15, 0},
+           std::pair{95, 5},
+           std::pair{150, 20},
+           std::pair{205, 25},
+           std::pair{250, 40},
+           std::pair{309, 49},
+         }) {
+        auto res = query(ts);
+        BOOST_REQUIRE(res);
+        BOOST_TEST(res->offset == model::offset(offset));
+    }
+    BOOST_TEST(!query(310));
+    b | stop();
+}
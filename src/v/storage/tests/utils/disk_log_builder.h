@@ -320,6 +320,7 @@ public:
 
     // Configuration getters
     const log_config& get_log_config() const;
+    log_manager& get_log_manager() { return _storage.log_mgr(); }
 
     size_t bytes_written() const { return _bytes_written; }
 
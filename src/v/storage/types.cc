@@ -50,18 +50,39 @@ std::ostream& operator<<(std::ostream& o, const timequery_result& a) {
 std::ostream& operator<<(std::ostream& o, const timequery_config& a) {
     return o << "{max_offset:" << a.max_offset << ", time:" << a.time << "}";
 }
+std::ostream& operator<<(std::ostream& o, const key_query_config& a) {
+    return o << "{max_offset:" << a.max_offset
+             << ", key_size:" << a.key.size() << "}";
+}
+std::ostream& operator<<(std::ostream& o, const key_query_result& a) {
+    o << "{offset:" << a.offset << ", time:" << a.time << ", value_size:";
+    if (a.value) {
+        o << a.value->size_bytes();
+    } else {
+        o << "tombstone";
+    }
+    return o << "}";
+}
 
 std::ostream&
 operator<<(std::ostream& o, const ntp_config::default_overrides& v) {
     fmt::print(
       o,
       "{{compaction_strategy: {}, cleanup_policy_bitflags: {}, segment_size: "
-      "{}, retention_bytes: {}, retention_time_ms: {}}}",
+      "{}, retention_bytes: {}, retention_time_ms: {}, storage_engine: {}, "
+      "compression: {}, flush_ms: {}, flush_bytes: {}, recovery: {}, "
+      "read_replica_bucket: {}}}",
       v.compaction_strategy,
       v.cleanup_policy_bitflags,
       v.segment_size,
       v.retention_bytes,
-      v.retention_time);
+      v.retention_time,
+      v.storage_engine,
+      v.compression,
+      v.flush_ms,
+      v.flush_bytes,
+      v.recovery,
+      v.read_replica_bucket);
 
     return o;
 }
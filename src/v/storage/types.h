@@ -38,6 +38,9 @@ public:
     virtual ss::future<> ensure_snapshot_exists(model::offset) = 0;
     // hints stm_manager that now it's a good time to make a snapshot
     virtual ss::future<> make_snapshot() = 0;
+    // offset of the last snapshot, the state up to the offset doesn't need
+    // the log anymore
+    virtual model::offset last_snapshot_offset() const = 0;
 };
 
 /**
@@ -65,6 +68,11 @@ public:
  * make_snapshot lets log to hint when it's good time to make a snapshot e.g.
  * after a segment roll. It's up to a state machine to decide whether to make
  * it now or on its own pace.
+ *
+ * snapshot_horizon is the offset up to which the state of all the state
+ * machines is in their snapshots. The retention doesn't evict the log past
+ * the horizon, when it wants to it asks the state machines to snapshot first
+ * so their recovery stays bounded by the snapshot and a short tail of the log.
  */
 class stm_manager {
 public:
@@ -87,6 +95,17 @@ public:
         return f;
     }
 
+    /// lowest snapshot offset of the state machines, std::nullopt when the
+    /// log has no state machines
+    std::optional<model::offset> snapshot_horizon() const {
+        std::optional<model::offset> ret;
+        for (const auto& stm : _stms) {
+            auto o = stm->last_snapshot_offset();
+            ret = ret ? std::min(*ret, o) : o;
+        }
+        return ret;
+    }
+
 private:
     std::vector<ss::shared_ptr<snapshotable_stm>> _stms;
 };
@@ -156,6 +175,35 @@ struct timequery_result {
     friend std::ostream& operator<<(std::ostream& o, const timequery_result&);
 };
 
+/// \brief the last term of a log up to a term, and the offset following the
+/// batches of that term in the log
+struct term_end_result {
+    model::term_id term;
+    model::offset end_offset;
+};
+
+/// \brief query of the latest record of a key, up to the max offset
+struct key_query_config {
+    key_query_config(
+      bytes k, model::offset o, ss::io_priority_class iop) noexcept
+      : key(std::move(k))
+      , max_offset(o)
+      , prio(iop) {}
+    bytes key;
+    model::offset max_offset;
+    ss::io_priority_class prio;
+
+    friend std::ostream& operator<<(std::ostream& o, const key_query_config&);
+};
+struct key_query_result {
+    model::offset offset;
+    model::timestamp time;
+    /// \brief nullopt for a tombstone
+    std::optional<iobuf> value;
+
+    friend std::ostream& operator<<(std::ostream& o, const key_query_result&);
+};
+
 struct truncate_config {
     truncate_config(model::offset o, ss::io_priority_class p)
       : base_offset(o)
@@ -230,6 +278,10 @@ struct log_reader_config {
     // historical read-once workloads like compaction).
     bool skip_batch_cache{false};
 
+    // number of buffers the segment data stream reads ahead, use a larger
+    // value for long sequential reads (e.g. follower recovery)
+    std::optional<uint32_t> read_ahead;
+
     log_reader_config(
       model::offset start_offset,
       model::offset max_offset,
@@ -292,6 +344,9 @@ struct compaction_config {
     debug_sanitize_files sanitize;
     // abort source for compaction task
     ss::abort_source* asrc;
+    // memory of the key map of the sliding window compaction, the shard
+    // configuration when unset
+    std::optional<size_t> key_map_memory;
 
     friend std::ostream& operator<<(std::ostream&, const compaction_config&);
 };
@@ -0,0 +1,210 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "syschecks/disk_benchmark.h"
+
+#include "bytes/iobuf_parser.h"
+#include "reflection/adl.h"
+#include "syschecks/syschecks.h"
+#include "units.h"
+#include "utils/file_io.h"
+
+#include <seastar/core/aligned_buffer.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/file.hh>
+#include <seastar/core/future-util.hh>
+#include <seastar/core/seastar.hh>
+
+#include <boost/range/irange.hpp>
+#include <fmt/ostream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace syschecks {
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+constexpr const char* profile_filename = "disk_profile";
+constexpr const char* scratch_filename = "disk_benchmark.tmp";
+constexpr int8_t profile_version = 1;
+
+constexpr size_t alignment = 4_KiB;
+constexpr size_t write_size = 128_KiB;
+constexpr size_t write_bytes = 64_MiB;
+constexpr size_t write_streams = 4;
+constexpr size_t fsync_rounds = 32;
+constexpr size_t read_size = 4_KiB;
+constexpr size_t read_streams = 16;
+constexpr auto read_duration = std::chrono::milliseconds(500);
+
+using aligned_buffer = std::unique_ptr<char[], ss::free_deleter>;
+
+aligned_buffer make_buffer(size_t size) {
+    auto buf = ss::allocate_aligned_buffer<char>(size, alignment);
+    std::fill_n(buf.get(), size, 'x');
+    return buf;
+}
+
+uint64_t per_second(uint64_t n, bench_clock::duration d) {
+    auto us = std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(d).count(), 1);
+    return n * 1000000 / us;
+}
+
+/// write every stride-th block of the range, starting at the first one
+ss::future<> write_blocks(
+  ss::file& f, const char* buf, size_t first, size_t end, size_t stride) {
+    for (size_t pos = first; pos < end; pos += stride) {
+        co_await f.dma_write(pos, buf, write_size);
+    }
+}
+
+ss::future<uint64_t>
+read_blocks(ss::file& f, size_t blocks, bench_clock::time_point deadline) {
+    auto buf = make_buffer(read_size);
+    std::minstd_rand rng(std::random_device{}());
+    std::uniform_int_distribution<size_t> dist(0, blocks - 1);
+    uint64_t reads = 0;
+    while (bench_clock::now() < deadline) {
+        co_await f.dma_read(dist(rng) * read_size, buf.get(), read_size);
+        ++reads;
+    }
+    co_return reads;
+}
+
+ss::future<disk_profile> run_benchmark(ss::file& f) {
+    disk_profile p;
+
+    // sequential writes, a few in flight
+    auto wbuf = make_buffer(write_size);
+    auto start = bench_clock::now();
+    co_await ss::parallel_for_each(
+      boost::irange<size_t>(0, write_streams), [&f, &wbuf](size_t s) {
+          return write_blocks(
+            f,
+            wbuf.get(),
+            s * write_size,
+            write_bytes,
+            write_streams * write_size);
+      });
+    co_await f.flush();
+    p.write_bandwidth = per_second(write_bytes, bench_clock::now() - start);
+
+    // small writes past the written range, each followed by a flush
+    std::vector<bench_clock::duration> latencies;
+    latencies.reserve(fsync_rounds);
+    for (size_t i = 0; i < fsync_rounds; ++i) {
+        auto t = bench_clock::now();
+        co_await f.dma_write(
+          write_bytes + i * alignment, wbuf.get(), alignment);
+        co_await f.flush();
+        latencies.push_back(bench_clock::now() - t);
+    }
+    auto median = latencies.begin() + latencies.size() / 2;
+    std::nth_element(latencies.begin(), median, latencies.end());
+    p.fsync_latency_us
+      = std::chrono::duration_cast<std::chrono::microseconds>(*median).count();
+
+    // random reads of the written range, a few in flight
+    start = bench_clock::now();
+    auto deadline = start + read_duration;
+    auto reads = co_await ss::map_reduce(
+      boost::irange<size_t>(0, read_streams),
+      [&f, deadline](size_t) {
+          return read_blocks(f, write_bytes / read_size, deadline);
+      },
+      uint64_t(0),
+      std::plus<>());
+    p.read_iops = per_second(reads, bench_clock::now() - start);
+    co_return p;
+}
+
+} // namespace
+
+disk_profile disk_profile::slowest(const disk_profile& o) const {
+    return disk_profile{
+      .write_bandwidth = std::min(write_bandwidth, o.write_bandwidth),
+      .fsync_latency_us = std::max(fsync_latency_us, o.fsync_latency_us),
+      .read_iops = std::min(read_iops, o.read_iops)};
+}
+
+std::ostream& operator<<(std::ostream& o, const disk_profile& p) {
+    fmt::print(
+      o,
+      "{{write_bandwidth: {}, fsync_latency_us: {}, read_iops: {}}}",
+      p.write_bandwidth,
+      p.fsync_latency_us,
+      p.read_iops);
+    return o;
+}
+
+ss::future<disk_profile> measure_disk(std::filesystem::path dir) {
+    auto path = (dir / scratch_filename).string();
+    auto f = co_await ss::open_file_dma(
+      path,
+      ss::open_flags::rw | ss::open_flags::create | ss::open_flags::truncate);
+    std::exception_ptr ex;
+    disk_profile p;
+    try {
+        p = co_await run_benchmark(f);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await f.close();
+    co_await ss::remove_file(path);
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_return p;
+}
+
+ss::future<std::optional<disk_profile>>
+read_disk_profile(std::filesystem::path dir) {
+    auto path = dir / profile_filename;
+    if (!co_await ss::file_exists(path.string())) {
+        co_return std::nullopt;
+    }
+    try {
+        iobuf_parser in(co_await read_fully(path));
+        if (reflection::adl<int8_t>{}.from(in) != profile_version) {
+            co_return std::nullopt;
+        }
+        co_return reflection::adl<disk_profile>{}.from(in);
+    } catch (...) {
+        checklog.warn(
+          "Unable to read disk profile {}: {}", path, std::current_exception());
+    }
+    co_return std::nullopt;
+}
+
+ss::future<> write_disk_profile(std::filesystem::path dir, disk_profile p) {
+    iobuf buf;
+    reflection::serialize(buf, profile_version, p);
+    return write_fully(dir / profile_filename, std::move(buf));
+}
+
+ss::future<disk_profile> disk_profile_of(std::filesystem::path dir) {
+    if (auto p = co_await read_disk_profile(dir); p) {
+        checklog.info("Using saved disk profile of {}: {}", dir, *p);
+        co_return *p;
+    }
+    co_await systemd_message(
+      "measuring disk performance of {}", dir.string());
+    auto p = co_await measure_disk(dir);
+    checklog.info("Measured disk profile of {}: {}", dir, p);
+    co_await write_disk_profile(dir, p);
+    co_return p;
+}
+
+} // namespace syschecks
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+
+namespace syschecks {
+
+/// Measured performance of the device of a data directory
+struct disk_profile {
+    /// sequential write bandwidth in bytes per second
+    uint64_t write_bandwidth{0};
+    /// median latency of a small write followed by a flush
+    uint64_t fsync_latency_us{0};
+    /// random 4KiB reads per second
+    uint64_t read_iops{0};
+
+    /// the slowest of the two profiles in each dimension
+    disk_profile slowest(const disk_profile& o) const;
+
+    friend std::ostream& operator<<(std::ostream&, const disk_profile&);
+};
+
+/// Run the micro benchmark in a scratch file of the directory. It writes
+/// and reads about 64MiB and takes about a second.
+ss::future<disk_profile> measure_disk(std::filesystem::path dir);
+
+/// Return the profile saved in the directory, or nullopt if there is none
+/// or it can't be read.
+ss::future<std::optional<disk_profile>>
+read_disk_profile(std::filesystem::path dir);
+
+ss::future<> write_disk_profile(std::filesystem::path dir, disk_profile p);
+
+/// Return the saved profile of the directory, measure and save it if there
+/// is none. Remove the saved profile to measure the directory again.
+ss::future<disk_profile> disk_profile_of(std::filesystem::path dir);
+
+} // namespace syschecks
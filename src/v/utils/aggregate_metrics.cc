@@ -0,0 +1,144 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#include "utils/aggregate_metrics.h"
+
+#include <utility>
+
+namespace sm = ss::metrics;
+
+static sm::metric_definition make_definition(
+  const metric_spec& spec,
+  std::function<int64_t()> fn,
+  const std::vector<sm::label_instance>& labels) {
+    switch (spec.kind) {
+    case metric_spec::type::counter:
+        return sm::make_derive(
+          spec.name, std::move(fn), sm::description(spec.description), labels);
+    case metric_spec::type::gauge:
+        return sm::make_gauge(
+          spec.name, std::move(fn), sm::description(spec.description), labels);
+    case metric_spec::type::total_bytes:
+        return sm::make_total_bytes(
+          spec.name, std::move(fn), sm::description(spec.description), labels);
+    }
+    __builtin_unreachable();
+}
+
+std::vector<sm::metric_definition> make_metric_definitions(
+  const std::vector<metric_spec>& specs,
+  const std::vector<sm::label_instance>& labels) {
+    std::vector<sm::metric_definition> result;
+    result.reserve(specs.size());
+    for (const auto& spec : specs) {
+        result.push_back(make_definition(spec, spec.value, labels));
+    }
+    return result;
+}
+
+aggregate_metrics::registration::registration(registration&& o) noexcept
+  : _owner(std::exchange(o._owner, nullptr))
+  , _values(std::move(o._values)) {}
+
+aggregate_metrics::registration&
+aggregate_metrics::registration::operator=(registration&& o) noexcept {
+    if (this != &o) {
+        reset();
+        _owner = std::exchange(o._owner, nullptr);
+        _values = std::move(o._values);
+    }
+    return *this;
+}
+
+aggregate_metrics::registration::~registration() noexcept { reset(); }
+
+void aggregate_metrics::registration::reset() noexcept {
+    if (_owner) {
+        for (auto& [key, value] : _values) {
+            _owner->remove(key, value);
+        }
+        _values.clear();
+        _owner = nullptr;
+    }
+}
+
+aggregate_metrics& aggregate_metrics::local() {
+    static thread_local aggregate_metrics registry;
+    return registry;
+}
+
+ss::sstring aggregate_metrics::make_key(
+  const ss::sstring& group,
+  const std::vector<sm::label_instance>& labels,
+  const ss::sstring& name) {
+    ss::sstring key = group;
+    key += "_";
+    key += name;
+    for (const auto& l : labels) {
+        key += "\n";
+        key += l.key();
+        key += "=";
+        key += l.value();
+    }
+    return key;
+}
+
+int64_t aggregate_metrics::sum(const aggregate& a) {
+    int64_t result = 0;
+    for (const auto& v : a.values) {
+        result += v();
+    }
+    return result;
+}
+
+aggregate_metrics::registration aggregate_metrics::add(
+  const ss::sstring& group,
+  const std::vector<sm::label_instance>& labels,
+  std::vector<metric_spec> metrics) {
+    registration r(this);
+    r._values.reserve(metrics.size());
+    for (auto& m : metrics) {
+        auto key = make_key(group, labels, m.name);
+        auto [it, inserted] = _aggregates.try_emplace(key);
+        auto& a = it->second;
+        if (inserted) {
+            a.metrics.add_group(
+              group, {make_definition(m, [&a] { return sum(a); }, labels)});
+        }
+        a.values.push_back(std::move(m.value));
+        r._values.emplace_back(std::move(key), std::prev(a.values.end()));
+    }
+    return r;
+}
+
+std::optional<int64_t> aggregate_metrics::get(
+  const ss::sstring& group,
+  const std::vector<sm::label_instance>& labels,
+  const ss::sstring& name) const {
+    auto it = _aggregates.find(make_key(group, labels, name));
+    if (it == _aggregates.end()) {
+        return std::nullopt;
+    }
+    return sum(it->second);
+}
+
+void aggregate_metrics::remove(
+  const ss::sstring& key, value_list::iterator value) noexcept {
+    auto it = _aggregates.find(key);
+    if (it == _aggregates.end()) {
+        return;
+    }
+    it->second.values.erase(value);
+    if (it->second.values.empty()) {
+        // removes the series
+        _aggregates.erase(it);
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "seastarx.h"
+
+#include <seastar/core/metrics.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sstring.hh>
+
+#include <absl/container/node_hash_map.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/// Metric of an object that can be exported as is or summed with the same
+/// metric of other objects
+struct metric_spec {
+    enum class type { counter, gauge, total_bytes };
+
+    ss::sstring name;
+    type kind;
+    ss::sstring description;
+    std::function<int64_t()> value;
+};
+
+/// Convert the specs to the metric definitions of the object
+std::vector<ss::metrics::metric_definition> make_metric_definitions(
+  const std::vector<metric_spec>& specs,
+  const std::vector<ss::metrics::label_instance>& labels);
+
+/// \brief Shard local registry of the metrics exported as sums over the
+/// objects that share the same labels
+///
+/// The objects (e.g. the partitions of a topic) register their metrics
+/// under the same group and labels. The first registration of a metric
+/// adds the series which reports the sum of the values of all the objects
+/// that registered it. The series is removed with the last registration, so
+/// the number of the exported series doesn't depend on the number of
+/// objects.
+class aggregate_metrics {
+    using value_list = std::list<std::function<int64_t()>>;
+
+    struct aggregate {
+        value_list values;
+        ss::metrics::metric_groups metrics;
+    };
+
+public:
+    /// Registration of an object, the object is removed from the sums when
+    /// the registration is destroyed
+    class registration {
+    public:
+        registration() noexcept = default;
+        registration(registration&&) noexcept;
+        registration& operator=(registration&&) noexcept;
+        registration(const registration&) = delete;
+        registration& operator=(const registration&) = delete;
+        ~registration() noexcept;
+
+    private:
+        friend class aggregate_metrics;
+
+        explicit registration(aggregate_metrics* owner) noexcept
+          : _owner(owner) {}
+
+        void reset() noexcept;
+
+        aggregate_metrics* _owner{nullptr};
+        std::vector<std::pair<ss::sstring, value_list::iterator>> _values;
+    };
+
+    aggregate_metrics() = default;
+    aggregate_metrics(const aggregate_metrics&) = delete;
+    aggregate_metrics& operator=(const aggregate_metrics&) = delete;
+
+    /// Registry of the shard
+    static aggregate_metrics& local();
+
+    /// Add the metrics of an object to the sums of the group and labels
+    [[nodiscard]] registration
+    add(const ss::sstring& group,
+        const std::vector<ss::metrics::label_instance>& labels,
+        std::vector<metric_spec> metrics);
+
+    /// Return current sum of the metric or nullopt if no object registered
+    /// it
+    std::optional<int64_t> get(
+      const ss::sstring& group,
+      const std::vector<ss::metrics::label_instance>& labels,
+      const ss::sstring& name) const;
+
+    /// Return number of the exported series
+    size_t size() const { return _aggregates.size(); }
+
+private:
+    static ss::sstring make_key(
+      const ss::sstring& group,
+      const std::vector<ss::metrics::label_instance>& labels,
+      const ss::sstring& name);
+
+    static int64_t sum(const aggregate& a);
+
+    void remove(const ss::sstring& key, value_list::iterator value) noexcept;
+
+    /// node map keeps the aggregates in place, the metric functions refer
+    /// to them
+    absl::node_hash_map<ss::sstring, aggregate> _aggregates;
+};
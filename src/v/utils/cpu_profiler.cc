@@ -0,0 +1,159 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "utils/cpu_profiler.h"
+
+#include "ssx/sformat.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/smp.hh>
+
+#include <absl/container/flat_hash_map.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <execinfo.h>
+#include <mutex>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+// the frames of the signal handler and of the signal trampoline
+constexpr int skipped_frames = 2;
+
+timespec to_timespec(std::chrono::nanoseconds d) {
+    return timespec{
+      .tv_sec = static_cast<time_t>(d.count() / 1'000'000'000),
+      .tv_nsec = static_cast<long>(d.count() % 1'000'000'000)};
+}
+
+sigset_t profiling_signal() {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPROF);
+    return set;
+}
+} // namespace
+
+void cpu_profiler::on_signal(int) {
+    auto* s = _samples;
+    if (!s) {
+        return;
+    }
+    if (s->count == s->capacity) {
+        ++s->dropped;
+        return;
+    }
+    const int saved_errno = errno;
+    std::array<void*, max_depth + skipped_frames> frames;
+    const int n = ::backtrace(frames.data(), frames.size());
+    const int depth = std::max(n - skipped_frames, 0);
+    auto* out = &s->frames[s->count * max_depth];
+    for (int i = 0; i < depth; ++i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        out[i] = reinterpret_cast<uintptr_t>(frames[i + skipped_frames]);
+    }
+    s->depths[s->count++] = static_cast<uint8_t>(depth);
+    errno = saved_errno;
+}
+
+void cpu_profiler::install_handler() {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        struct sigaction sa {};
+        sa.sa_handler = &cpu_profiler::on_signal;
+        sa.sa_flags = SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (::sigaction(SIGPROF, &sa, nullptr) != 0) {
+            throw std::system_error(
+              errno, std::system_category(), "sigaction(SIGPROF)");
+        }
+        // the first call of backtrace() loads libgcc, which allocates
+        std::array<void*, 1> warmup;
+        ::backtrace(warmup.data(), warmup.size());
+    });
+}
+
+ss::future<std::vector<ss::sstring>> cpu_profiler::profile(
+  std::chrono::milliseconds duration, uint32_t frequency) {
+    if (_samples) {
+        throw std::runtime_error("A CPU profile is already running");
+    }
+    frequency = std::clamp<uint32_t>(frequency, 1, 1000);
+    const size_t capacity = std::clamp<size_t>(
+      duration.count() * frequency / 1000, 1, max_samples);
+    auto s = std::make_unique<samples>(samples{
+      .frames = std::make_unique<uintptr_t[]>(capacity * max_depth),
+      .depths = std::make_unique<uint8_t[]>(capacity),
+      .capacity = capacity});
+    install_handler();
+
+    sigevent sev{};
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGPROF;
+    sev._sigev_un._tid = static_cast<pid_t>(::syscall(SYS_gettid));
+    timer_t timer;
+    if (::timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &timer) != 0) {
+        throw std::system_error(errno, std::system_category(), "timer_create");
+    }
+    // the reactor threads block the signals they don't handle
+    const auto set = profiling_signal();
+    ::pthread_sigmask(SIG_UNBLOCK, &set, nullptr);
+    _samples = s.get();
+    const auto period = to_timespec(
+      std::chrono::nanoseconds(std::chrono::seconds(1)) / frequency);
+    const itimerspec its{.it_interval = period, .it_value = period};
+    ::timer_settime(timer, 0, &its, nullptr);
+
+    co_await ss::sleep(duration);
+
+    ::timer_delete(timer);
+    _samples = nullptr;
+    ::pthread_sigmask(SIG_BLOCK, &set, nullptr);
+
+    std::vector<std::vector<uintptr_t>> stacks;
+    stacks.reserve(s->count);
+    for (size_t i = 0; i < s->count; ++i) {
+        const auto* frames = &s->frames[i * max_depth];
+        stacks.emplace_back(frames, frames + s->depths[i]);
+    }
+    auto folded = fold(ssx::sformat("shard-{}", ss::this_shard_id()), stacks);
+    if (s->dropped != 0) {
+        folded.push_back(ssx::sformat(
+          "shard-{};dropped_samples {}", ss::this_shard_id(), s->dropped));
+    }
+    co_return folded;
+}
+
+std::vector<ss::sstring> cpu_profiler::fold(
+  std::string_view root, const std::vector<std::vector<uintptr_t>>& samples) {
+    absl::flat_hash_map<ss::sstring, size_t> stacks;
+    for (const auto& frames : samples) {
+        fmt::memory_buffer buf;
+        fmt::format_to(buf, "{}", root);
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+            fmt::format_to(buf, ";{:#x}", *it);
+        }
+        ++stacks[ss::sstring(buf.data(), buf.size())];
+    }
+    std::vector<ss::sstring> folded;
+    folded.reserve(stacks.size());
+    for (const auto& [stack, count] : stacks) {
+        folded.push_back(ssx::sformat("{} {}", stack, count));
+    }
+    std::sort(folded.begin(), folded.end());
+    return folded;
+}
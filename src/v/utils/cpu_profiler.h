@@ -0,0 +1,69 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/sstring.hh>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Per shard sampling profiler of the reactor thread, for the admin API.
+ *
+ * A timer on the CPU time of the thread signals it at the sampling
+ * frequency, the signal handler saves the backtrace of the interrupted code
+ * into buffers allocated before the profile starts: it neither allocates nor
+ * locks. Once the profile ends the samples are folded per stack, in the
+ * format of the flame graph tools:
+ *
+ *   shard-0;0x4f2a10;0x4f3b22;0x8a0c31 42
+ *
+ * from the root frame, followed by the number of samples. The addresses are
+ * not symbolized, addr2line resolves them against the redpanda binary.
+ */
+class cpu_profiler {
+public:
+    static constexpr size_t max_depth = 64;
+    static constexpr size_t max_samples = 10000;
+
+    /// \brief samples the shard for the duration and returns the folded
+    /// stacks. throws if a profile is already running on the shard
+    static ss::future<std::vector<ss::sstring>>
+    profile(std::chrono::milliseconds duration, uint32_t frequency);
+
+    /// \brief folds the samples, the frames of a sample are from the
+    /// innermost, as saved by backtrace()
+    static std::vector<ss::sstring> fold(
+      std::string_view root, const std::vector<std::vector<uintptr_t>>&);
+
+private:
+    struct samples {
+        std::unique_ptr<uintptr_t[]> frames;
+        std::unique_ptr<uint8_t[]> depths;
+        size_t capacity;
+        size_t count{0};
+        size_t dropped{0};
+    };
+
+    static void on_signal(int);
+    static void install_handler();
+
+    // not a unique_ptr: without a destructor the thread local is accessed
+    // directly, not through its initialization wrapper, the signal handler
+    // relies on it
+    static inline thread_local samples* _samples = nullptr;
+};
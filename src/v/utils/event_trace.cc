@@ -0,0 +1,58 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "utils/event_trace.h"
+
+#include <seastar/core/smp.hh>
+
+#include <algorithm>
+#include <bit>
+
+void event_trace::enable(size_t events) {
+    disable();
+    const size_t capacity = std::bit_ceil(std::max<size_t>(events, 1));
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    _ring = new ring{
+      .events = std::make_unique<event[]>(capacity), .mask = capacity - 1};
+}
+
+void event_trace::disable() {
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete _ring;
+    _ring = nullptr;
+}
+
+iobuf event_trace::dump() {
+    iobuf out;
+    if (!_ring) {
+        return out;
+    }
+    const uint64_t capacity = _ring->mask + 1;
+    const uint64_t count = std::min(_ring->next, capacity);
+    const dump_header hdr{
+      .magic = dump_header::magic_value,
+      .version = 1,
+      .shard = static_cast<uint16_t>(ss::this_shard_id()),
+      .events = count,
+    };
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    out.append(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    // from the oldest event, which is overwritten next once the ring wrapped
+    const uint64_t first = _ring->next - count;
+    for (uint64_t i = 0; i < count;) {
+        const uint64_t pos = (first + i) & _ring->mask;
+        const uint64_t n = std::min(count - i, capacity - pos);
+        out.append(
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+          reinterpret_cast<const char*>(&_ring->events[pos]),
+          n * sizeof(event));
+        i += n;
+    }
+    return out;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "bytes/iobuf.h"
+#include "likely.h"
+#include "seastarx.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Per shard ring buffer of typed binary events of the hot request paths,
+ * to follow the latency of individual requests in production, where trace
+ * logging is far too slow.
+ *
+ * The shard is the only producer of its ring: recording an event is a clock
+ * read and a few stores, without synchronization. The oldest events are
+ * overwritten. Until enable() is called on the shard recording is a single
+ * branch. dump() snapshots the ring in the format decoded by
+ * tools/event_trace.py.
+ */
+class event_trace {
+public:
+    enum class type : uint32_t {
+        /// id: kafka correlation id, arg: number of partitions
+        produce_received = 0,
+        /// id: kafka correlation id, arg: shard of the partition
+        produce_dispatched,
+        /// id: kafka correlation id, arg: 0
+        produce_acked,
+        /// id: raft group, arg: consistency level
+        replicate_started,
+        /// id: raft group, arg: last offset, -1 on errors
+        replicate_finished,
+        /// id: segment appender, arg: appended bytes
+        segment_appended,
+        /// id: segment appender, arg: flushed file size
+        segment_flushed,
+    };
+
+    /// the on disk format of the events, little endian
+    struct event {
+        uint64_t timestamp_ns;
+        uint64_t id;
+        uint64_t arg;
+        type t;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(event) == 32);
+
+    /// header of the dumps, followed by the events from the oldest
+    struct dump_header {
+        static constexpr uint32_t magic_value = 0x54455052; // "RPET"
+        uint32_t magic;
+        uint16_t version;
+        uint16_t shard;
+        uint64_t events;
+    };
+    static_assert(sizeof(dump_header) == 16);
+
+    /// \brief starts recording on the shard, keeping the last events,
+    /// rounded up to a power of 2
+    static void enable(size_t events);
+    static void disable();
+    static bool enabled() { return _ring != nullptr; }
+
+    static void record(type t, uint64_t id, uint64_t arg) {
+        if (likely(!_ring)) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        auto& e = _ring->events[_ring->next++ & _ring->mask];
+        e.timestamp_ns = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+        e.id = id;
+        e.arg = arg;
+        e.t = t;
+        e.reserved = 0;
+    }
+
+    /// \brief snapshot of the ring of the shard, empty when it is disabled
+    static iobuf dump();
+
+private:
+    struct ring {
+        std::unique_ptr<event[]> events;
+        size_t mask;
+        uint64_t next{0};
+    };
+    // not a unique_ptr: without a destructor the thread local is accessed
+    // directly, not through its initialization wrapper
+    static inline thread_local ring* _ring = nullptr;
+};
@@ -36,6 +36,8 @@ void hdr_hist::record_corrected(uint64_t value, uint64_t interval) {
 
 hdr_hist& hdr_hist::operator+=(const hdr_hist& o) {
     ::hdr_add(_hist.get(), o._hist.get());
+    _sample_count += o._sample_count;
+    _sample_sum += o._sample_sum;
     return *this;
 }
 
@@ -135,6 +135,7 @@ public:
     int64_t get_value_at(double percentile) const;
     double stddev() const;
     double mean() const;
+    uint64_t sample_count() const { return _sample_count; }
     size_t memory_size() const;
     ss::metrics::histogram seastar_histogram_logform() const;
 
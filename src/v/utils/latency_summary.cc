@@ -0,0 +1,61 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "utils/latency_summary.h"
+
+#include <seastar/core/do_with.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/smp.hh>
+
+#include <boost/range/irange.hpp>
+
+namespace {
+latency_summary::histograms& shard_histograms() {
+    static thread_local latency_summary::histograms hists;
+    return hists;
+}
+} // namespace
+
+const char* latency_summary::name(op o) {
+    switch (o) {
+    case op::produce:
+        return "produce";
+    case op::fetch:
+        return "fetch";
+    case op::raft_replicate:
+        return "raft_replicate";
+    case op::storage_append:
+        return "storage_append";
+    case op::rpc:
+        return "rpc";
+    }
+    return "unknown";
+}
+
+hdr_hist& latency_summary::histogram(op o) {
+    return shard_histograms()[static_cast<size_t>(o)];
+}
+
+ss::future<latency_summary::histograms> latency_summary::merge() {
+    return ss::do_with(histograms{}, [](histograms& ret) {
+        // one shard at a time: the shards add to the histograms of the
+        // caller, adding doesn't allocate
+        return ss::do_for_each(
+                 boost::irange<ss::shard_id>(0, ss::smp::count),
+                 [&ret](ss::shard_id shard) {
+                     return ss::smp::submit_to(shard, [&ret] {
+                         const auto& local = shard_histograms();
+                         for (size_t i = 0; i < ops_count; ++i) {
+                             ret[i] += local[i];
+                         }
+                     });
+                 })
+          .then([&ret] { return std::move(ret); });
+    });
+}
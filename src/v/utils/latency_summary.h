@@ -0,0 +1,54 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+#include "seastarx.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/future.hh>
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Node wide latency histograms of the main request paths, in microseconds.
+ *
+ * Each shard records into its own histograms, merge() sums them across the
+ * shards on demand: the percentiles of the node are computed at the full
+ * resolution of the histograms, unlike the ones derived from the coarse
+ * buckets of the per shard metrics.
+ */
+class latency_summary {
+public:
+    enum class op : uint8_t {
+        /// kafka produce request, until the response is ready
+        produce = 0,
+        /// kafka fetch request, max wait included
+        fetch,
+        /// raft replicate, until the batches are replicated with the
+        /// requested consistency
+        raft_replicate,
+        /// append of a batch to a log segment
+        storage_append,
+        /// internal rpc request, handled by the server
+        rpc,
+    };
+    static constexpr size_t ops_count = 5;
+    using histograms = std::array<hdr_hist, ops_count>;
+
+    static const char* name(op);
+
+    /// \brief histogram of the shard
+    static hdr_hist& histogram(op);
+
+    /// \brief sum of the histograms of all the shards, indexed by op
+    static ss::future<histograms> merge();
+};
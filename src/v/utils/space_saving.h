@@ -0,0 +1,93 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/*
+ * Space-saving top-k tracker of weighted keys.
+ *
+ * Keeps at most `capacity` counters. A key that isn't tracked takes over the
+ * smallest counter when all of them are in use, inheriting its count as the
+ * error bound. Every key heavier than the total weight / capacity is
+ * tracked, and the count of a tracked key overestimates its weight by at
+ * most its error. The counts can be decayed to track recent weights.
+ */
+template<
+  typename Key,
+  typename Hash = typename absl::flat_hash_map<Key, size_t>::hasher,
+  typename Eq = typename absl::flat_hash_map<Key, size_t>::key_equal>
+class space_saving {
+public:
+    struct entry {
+        Key key;
+        double count;
+        double error;
+    };
+
+    explicit space_saving(size_t capacity)
+      : _capacity(capacity) {
+        _entries.reserve(capacity);
+    }
+
+    void add(const Key& key, double weight) {
+        if (auto it = _index.find(key); it != _index.end()) {
+            _entries[it->second].count += weight;
+            return;
+        }
+        if (_entries.size() < _capacity) {
+            _index.emplace(key, _entries.size());
+            _entries.push_back(entry{key, weight, 0});
+            return;
+        }
+        auto min = std::min_element(
+          _entries.begin(), _entries.end(), [](const entry& a, const entry& b) {
+              return a.count < b.count;
+          });
+        _index.erase(min->key);
+        _index.emplace(key, std::distance(_entries.begin(), min));
+        min->error = min->count;
+        min->count += weight;
+        min->key = key;
+    }
+
+    /// Multiply all the counts and errors by the factor
+    void decay(double factor) {
+        for (auto& e : _entries) {
+            e.count *= factor;
+            e.error *= factor;
+        }
+    }
+
+    /// The n heaviest tracked keys, heaviest first
+    std::vector<entry> top(size_t n) const {
+        std::vector<entry> ret(_entries.begin(), _entries.end());
+        auto cmp = [](const entry& a, const entry& b) {
+            return a.count > b.count;
+        };
+        n = std::min(n, ret.size());
+        std::partial_sort(ret.begin(), ret.begin() + n, ret.end(), cmp);
+        ret.resize(n);
+        return ret;
+    }
+
+    size_t size() const { return _entries.size(); }
+    size_t capacity() const { return _capacity; }
+
+private:
+    size_t _capacity;
+    std::vector<entry> _entries;
+    absl::flat_hash_map<Key, size_t, Hash, Eq> _index;
+};
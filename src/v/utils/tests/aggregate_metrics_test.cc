@@ -0,0 +1,59 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "utils/aggregate_metrics.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+namespace sm = ss::metrics;
+
+static std::vector<metric_spec> make_specs(int64_t& value) {
+    return {
+      {.name = "value",
+       .kind = metric_spec::type::gauge,
+       .description = "test value",
+       .value = [&value] { return value; }}};
+}
+
+SEASTAR_THREAD_TEST_CASE(aggregate_metrics_sums_objects) {
+    auto& registry = aggregate_metrics::local();
+    const ss::sstring group = "aggregate_metrics_test";
+    const std::vector<sm::label_instance> t1 = {sm::label("topic")("t1")};
+    const std::vector<sm::label_instance> t2 = {sm::label("topic")("t2")};
+    auto initial = registry.size();
+
+    int64_t a = 1, b = 2, c = 5;
+    auto ra = registry.add(group, t1, make_specs(a));
+    auto rb = registry.add(group, t1, make_specs(b));
+    auto rc = registry.add(group, t2, make_specs(c));
+    // one series per topic
+    BOOST_REQUIRE_EQUAL(registry.size(), initial + 2);
+    BOOST_REQUIRE_EQUAL(*registry.get(group, t1, "value"), 3);
+    BOOST_REQUIRE_EQUAL(*registry.get(group, t2, "value"), 5);
+
+    a = 10;
+    BOOST_REQUIRE_EQUAL(*registry.get(group, t1, "value"), 12);
+
+    // moved registration still owns the member
+    auto moved = std::move(ra);
+    ra = {};
+    BOOST_REQUIRE_EQUAL(*registry.get(group, t1, "value"), 12);
+
+    moved = {};
+    BOOST_REQUIRE_EQUAL(*registry.get(group, t1, "value"), 2);
+
+    // series removed with the last member
+    rb = {};
+    rc = {};
+    BOOST_REQUIRE(!registry.get(group, t1, "value"));
+    BOOST_REQUIRE(!registry.get(group, t2, "value"));
+    BOOST_REQUIRE_EQUAL(registry.size(), initial);
+}
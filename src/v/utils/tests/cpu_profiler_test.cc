@@ -0,0 +1,41 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "utils/cpu_profiler.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std::chrono_literals;
+
+SEASTAR_THREAD_TEST_CASE(cpu_profiler_folds_stacks_from_the_root) {
+    std::vector<std::vector<uintptr_t>> samples{
+      {0x30, 0x20, 0x10},
+      {0x40, 0x10},
+      {0x30, 0x20, 0x10},
+    };
+    auto folded = cpu_profiler::fold("shard-0", samples);
+    std::vector<ss::sstring> expected{
+      "shard-0;0x10;0x20;0x30 2",
+      "shard-0;0x10;0x40 1",
+    };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(
+      folded.begin(), folded.end(), expected.begin(), expected.end());
+}
+
+SEASTAR_THREAD_TEST_CASE(cpu_profiler_one_profile_per_shard) {
+    auto running = cpu_profiler::profile(50ms, 100);
+    BOOST_REQUIRE_THROW(
+      cpu_profiler::profile(50ms, 100).get(), std::runtime_error);
+    auto folded = running.get0();
+    for (const auto& stack : folded) {
+        BOOST_REQUIRE(stack.starts_with("shard-0"));
+    }
+}
@@ -0,0 +1,48 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf_parser.h"
+#include "utils/event_trace.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+SEASTAR_THREAD_TEST_CASE(event_trace_keeps_the_last_events) {
+    using type = event_trace::type;
+    // disabled: nothing recorded
+    event_trace::record(type::produce_received, 1, 1);
+    BOOST_REQUIRE(event_trace::dump().empty());
+
+    // rounded up to 4 events
+    event_trace::enable(3);
+    for (uint64_t i = 0; i < 6; ++i) {
+        event_trace::record(type::segment_appended, i, i * 10);
+    }
+
+    iobuf_parser p(event_trace::dump());
+    auto hdr = p.consume_type<event_trace::dump_header>();
+    BOOST_REQUIRE_EQUAL(hdr.magic, event_trace::dump_header::magic_value);
+    BOOST_REQUIRE_EQUAL(hdr.version, 1);
+    BOOST_REQUIRE_EQUAL(hdr.events, 4);
+    BOOST_REQUIRE_EQUAL(p.bytes_left(), 4 * sizeof(event_trace::event));
+    uint64_t prev_ts = 0;
+    for (uint64_t i = 2; i < 6; ++i) {
+        auto e = p.consume_type<event_trace::event>();
+        BOOST_REQUIRE(e.t == type::segment_appended);
+        BOOST_REQUIRE_EQUAL(e.id, i);
+        BOOST_REQUIRE_EQUAL(e.arg, i * 10);
+        BOOST_REQUIRE_GE(e.timestamp_ns, prev_ts);
+        prev_ts = e.timestamp_ns;
+    }
+
+    event_trace::disable();
+    event_trace::record(type::produce_received, 1, 1);
+    BOOST_REQUIRE(event_trace::dump().empty());
+}
@@ -0,0 +1,38 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "utils/latency_summary.h"
+
+#include <seastar/core/smp.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+SEASTAR_THREAD_TEST_CASE(merge_across_shards) {
+    using op = latency_summary::op;
+    // shard n records 1000 samples of (n + 1) * 1000us
+    ss::smp::invoke_on_all([] {
+        auto& h = latency_summary::histogram(op::storage_append);
+        h.record_multiple_times((ss::this_shard_id() + 1) * 1000, 1000);
+    }).get();
+
+    auto merged = latency_summary::merge().get0();
+    const auto& h = merged[static_cast<size_t>(op::storage_append)];
+    BOOST_REQUIRE_EQUAL(h.sample_count(), ss::smp::count * 1000);
+    // within the 3 significant figures of the histograms
+    BOOST_REQUIRE_LE(
+      std::abs(h.get_value_at(100.0) - int64_t(ss::smp::count) * 1000), 1);
+    BOOST_REQUIRE_LE(std::abs(h.get_value_at(1.0) - 1000), 1);
+    BOOST_REQUIRE_EQUAL(
+      merged[static_cast<size_t>(op::produce)].sample_count(), 0);
+
+    // the shard histograms are left untouched
+    BOOST_REQUIRE_EQUAL(
+      latency_summary::histogram(op::storage_append).sample_count(), 1000);
+}
@@ -0,0 +1,57 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "utils/space_saving.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_CASE(test_space_saving_exact_below_capacity) {
+    space_saving<std::string> s(4);
+    s.add("a", 1);
+    s.add("b", 5);
+    s.add("a", 2);
+    s.add("c", 4);
+    auto top = s.top(2);
+    BOOST_REQUIRE_EQUAL(top.size(), 2);
+    BOOST_REQUIRE_EQUAL(top[0].key, "b");
+    BOOST_REQUIRE_EQUAL(top[0].count, 5);
+    BOOST_REQUIRE_EQUAL(top[1].key, "c");
+    BOOST_REQUIRE_EQUAL(s.top(10).size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_space_saving_keeps_heavy_hitters) {
+    space_saving<int> s(8);
+    // two heavy keys among many light ones
+    for (int i = 0; i < 1000; ++i) {
+        s.add(-1, 10);
+        s.add(i, 1);
+        if (i % 2 == 0) {
+            s.add(-2, 5);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(s.size(), 8);
+    auto top = s.top(2);
+    BOOST_REQUIRE_EQUAL(top[0].key, -1);
+    BOOST_REQUIRE_EQUAL(top[1].key, -2);
+    // the count overestimates the weight by at most the error
+    BOOST_REQUIRE_GE(top[0].count, 10000);
+    BOOST_REQUIRE_LE(top[0].count - top[0].error, 10000);
+}
+
+BOOST_AUTO_TEST_CASE(test_space_saving_decay) {
+    space_saving<int> s(2);
+    s.add(1, 100);
+    s.decay(0.5);
+    s.add(2, 80);
+    auto top = s.top(2);
+    BOOST_REQUIRE_EQUAL(top[0].key, 2);
+    BOOST_REQUIRE_EQUAL(top[1].count, 50);
+}
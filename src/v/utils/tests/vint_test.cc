@@ -17,7 +17,9 @@
 #include <array>
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <vector>
 
 namespace {
 
@@ -36,3 +38,29 @@ void check_roundtrip_sweep(int64_t count) {
 SEASTAR_THREAD_TEST_CASE(sanity_signed_sweep_64) {
     check_roundtrip_sweep(100000000);
 }
+
+SEASTAR_THREAD_TEST_CASE(contiguous_decoding) {
+    // every encoded length, decoded from word sized and shorter buffers
+    std::vector<int64_t> values{0, -1, 1, 63, -64, 64};
+    for (int shift = 7; shift < 63; shift += 7) {
+        values.push_back(int64_t(1) << shift);
+        values.push_back(-(int64_t(1) << shift));
+        values.push_back((int64_t(1) << shift) - 1);
+    }
+    values.push_back(std::numeric_limits<int64_t>::max());
+    values.push_back(std::numeric_limits<int64_t>::min());
+    for (auto v : values) {
+        auto b = vint::to_bytes(v);
+        const auto size = b.size();
+        // trailing bytes with the continuation bit set are not read
+        b.append(bytes(vint::max_length, 0xff).data(), vint::max_length);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto* src = reinterpret_cast<const char*>(b.data());
+        const auto [padded, padded_len] = vint::deserialize(src, b.size());
+        BOOST_REQUIRE_EQUAL(padded, v);
+        BOOST_REQUIRE_EQUAL(padded_len, size);
+        const auto [exact, exact_len] = vint::deserialize(src, size);
+        BOOST_REQUIRE_EQUAL(exact, v);
+        BOOST_REQUIRE_EQUAL(exact_len, size);
+    }
+}
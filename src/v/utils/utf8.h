@@ -11,7 +11,7 @@
 
 #pragma once
 
-#include <boost/locale/encoding_utf.hpp>
+#include <boost/locale/utf.hpp>
 
 #include <string_view>
 
@@ -35,11 +35,17 @@ struct default_thrower {
 template<typename Thrower>
 CONCEPT(requires ExceptionThrower<Thrower>)
 inline void validate_utf8(std::string_view s, Thrower&& thrower) {
-    try {
-        boost::locale::conv::utf_to_utf<char>(
-          s.begin(), s.end(), boost::locale::conv::stop);
-    } catch (const boost::locale::conv::conversion_error& ex) {
-        thrower.conversion_error();
+    // decode the code points in place, converting the string would allocate
+    // a copy of it
+    using traits = boost::locale::utf::utf_traits<char>;
+    auto it = s.begin();
+    while (it != s.end()) {
+        auto c = traits::decode(it, s.end());
+        if (
+          c == boost::locale::utf::illegal
+          || c == boost::locale::utf::incomplete) {
+            thrower.conversion_error();
+        }
     }
 }
 
@@ -12,6 +12,9 @@
 #pragma once
 #include "bytes/bytes.h"
 
+#include <seastar/core/byteorder.hh>
+
+#include <bit>
 #include <cstdint>
 
 // class is actually zigzag vint; always signed ints
@@ -97,4 +100,39 @@ inline std::pair<int64_t, size_t> deserialize(Range&& r) noexcept {
     return {decode_zigzag(result), bytes_read};
 }
 
+namespace detail {
+/// \brief packs the 7 bit groups of the bytes of a little endian word, in
+/// three steps that double the width of the groups
+inline constexpr uint64_t pack_7bit_groups(uint64_t x) noexcept {
+    x &= 0x7f7f7f7f7f7f7f7fULL;
+    x = ((x & 0x7f007f007f007f00ULL) >> 1U) | (x & 0x007f007f007f007fULL);
+    x = ((x & 0x3fff00003fff0000ULL) >> 2U) | (x & 0x00003fff00003fffULL);
+    x = ((x & 0x0fffffff00000000ULL) >> 4U) | (x & 0x000000000fffffffULL);
+    return x;
+}
+} // namespace detail
+
+/// \brief decodes the varint at the start of the contiguous buffer
+///
+/// the encodings of up to 8 bytes, values up to 2^55, are decoded from a
+/// single word: the first byte without the continuation bit ends the varint
+/// and the 7 bit groups of the word are packed without branches. the others
+/// and the buffers shorter than a word are decoded byte by byte
+inline std::pair<int64_t, size_t>
+deserialize(const char* src, size_t len) noexcept {
+    if (likely(len >= sizeof(uint64_t))) {
+        const auto word = ss::read_le<uint64_t>(src);
+        const uint64_t ends = ~word & 0x8080808080808080ULL;
+        if (likely(ends != 0)) {
+            const size_t n = (std::countr_zero(ends) >> 3U) + 1;
+            const uint64_t mask = n == sizeof(uint64_t)
+                                    ? ~uint64_t(0)
+                                    : (uint64_t(1) << (n * 8)) - 1;
+            return {decode_zigzag(detail::pack_7bit_groups(word & mask)), n};
+        }
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return deserialize(bytes_view(reinterpret_cast<const uint8_t*>(src), len));
+}
+
 } // namespace vint
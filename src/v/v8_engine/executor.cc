@@ -0,0 +1,137 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "v8_engine/executor.h"
+
+#include "vassert.h"
+
+#include <seastar/core/alien.hh>
+#include <seastar/core/smp.hh>
+
+#include <memory>
+
+namespace v8_engine {
+
+executor::executor()
+  : _executor_thread([this] { executor_loop(); })
+  , _watchdog_thread([this] { watchdog_loop(); }) {}
+
+executor::~executor() {
+    vassert(
+      !_executor_thread.joinable() && !_watchdog_thread.joinable(),
+      "executor::stop() must be called before destruction");
+}
+
+ss::future<> executor::stop() {
+    std::deque<task> queued;
+    {
+        std::lock_guard lock(_mutex);
+        _stopped = true;
+        if (_running) {
+            _running->s->terminate();
+        }
+        queued.swap(_queue);
+    }
+    _cv.notify_all();
+    _executor_thread.join();
+    _watchdog_thread.join();
+    for (auto& t : queued) {
+        complete(
+          t,
+          std::make_exception_ptr(script_exception("Executor is stopped")));
+    }
+    return ss::now();
+}
+
+ss::future<> executor::run(
+  script& s,
+  ss::temporary_buffer<char>& data,
+  std::chrono::milliseconds budget) {
+    auto done = std::make_unique<ss::promise<>>();
+    auto f = done->get_future();
+    {
+        std::lock_guard lock(_mutex);
+        if (_stopped) {
+            return ss::make_exception_future<>(
+              script_exception("Executor is stopped"));
+        }
+        _queue.push_back(task{
+          .s = &s,
+          .data = &data,
+          .budget = budget,
+          .shard = ss::this_shard_id(),
+          .done = done.release()});
+    }
+    _cv.notify_all();
+    return f;
+}
+
+void executor::complete(const task& t, std::exception_ptr e) {
+    ss::alien::run_on(t.shard, [p = t.done, e = std::move(e)]() noexcept {
+        std::unique_ptr<ss::promise<>> done(p);
+        if (e) {
+            done->set_exception(e);
+        } else {
+            done->set_value();
+        }
+    });
+}
+
+void executor::executor_loop() {
+    while (true) {
+        task t{};
+        {
+            std::unique_lock lock(_mutex);
+            _cv.wait(lock, [this] { return _stopped || !_queue.empty(); });
+            if (_stopped) {
+                return;
+            }
+            t = _queue.front();
+            _queue.pop_front();
+            _running = t;
+            _deadline = clock_type::now() + t.budget;
+        }
+        _cv.notify_all();
+
+        std::exception_ptr e;
+        try {
+            t.s->run(*t.data);
+        } catch (...) {
+            e = std::current_exception();
+        }
+        {
+            std::lock_guard lock(_mutex);
+            _running.reset();
+        }
+        _cv.notify_all();
+        complete(t, std::move(e));
+    }
+}
+
+void executor::watchdog_loop() {
+    std::unique_lock lock(_mutex);
+    while (!_stopped) {
+        if (!_running) {
+            _cv.wait(lock);
+            continue;
+        }
+        const ss::promise<>* run = _running->done;
+        auto finished = [this, run] {
+            return _stopped || !_running || _running->done != run;
+        };
+        if (!_cv.wait_until(lock, _deadline, finished)) {
+            _running->s->terminate();
+            // the run unwinds and fails with script_exception
+            _cv.wait(lock, finished);
+        }
+    }
+}
+
+} // namespace v8_engine
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#pragma once
+
+#include "seastarx.h"
+#include "v8_engine/script.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace v8_engine {
+
+// This class runs js functions on a dedicated thread, off the reactor, so
+// that a script can't stall the shard that submitted it.
+// The runs are executed one at a time, in submission order, and each one
+// gets a CPU time budget: a watchdog terminates the js code running past
+// it and the run fails with script_exception. The memory of a script is
+// bounded by the heap size of its isolate.
+// The data is handed to the js code without a copy.
+class executor {
+public:
+    // Start the executor and watchdog threads.
+    executor();
+
+    executor(const executor& other) = delete;
+    executor& operator=(const executor& other) = delete;
+    executor(executor&& other) = delete;
+    executor& operator=(executor&& other) = delete;
+
+    // stop() must have been called.
+    ~executor();
+
+    // Terminate the running script, fail the queued runs and join the
+    // threads.
+    ss::future<> stop();
+
+    /// Run the function of the script on the data, on the executor thread.
+    /// The future resolves on the calling shard.
+    ///
+    /// \param script and data must outlive the future, the script must not
+    /// be used by the shard meanwhile
+    /// \param budget the time after which the run is terminated
+    ss::future<> run(
+      script& s,
+      ss::temporary_buffer<char>& data,
+      std::chrono::milliseconds budget);
+
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    struct task {
+        script* s;
+        ss::temporary_buffer<char>* data;
+        std::chrono::milliseconds budget;
+        ss::shard_id shard;
+        // owned by the task until it completes on the shard
+        ss::promise<>* done;
+    };
+
+    void executor_loop();
+    void watchdog_loop();
+
+    // Resolve the promise of the task on the shard that submitted it.
+    static void complete(const task&, std::exception_ptr);
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<task> _queue;
+    // the task being run and its deadline, watched by the watchdog
+    std::optional<task> _running;
+    clock_type::time_point _deadline;
+    bool _stopped{false};
+
+    std::thread _executor_thread;
+    std::thread _watchdog_thread;
+};
+
+} // namespace v8_engine
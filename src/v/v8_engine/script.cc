@@ -30,6 +30,9 @@ script::script(size_t max_heap_size_in_bytes) {
       0, max_heap_size_in_bytes);
     _isolate = std::unique_ptr<v8::Isolate, isolate_deleter>(
       v8::Isolate::New(isolate_params), isolate_deleter());
+    // the isolate, not this, as the script is movable
+    _isolate->AddNearHeapLimitCallback(
+      &script::near_heap_limit, _isolate.get());
 }
 
 script::~script() {
@@ -92,8 +95,7 @@ void script::set_function(std::string_view name) {
     _function.Reset(_isolate.get(), function_val.As<v8::Function>());
 }
 
-// It is the first version for run. In next updates I use alient_thread for run
-// v8.
+// Runs on the calling thread, see executor for running off the reactor
 void script::run(ss::temporary_buffer<char>& data) { run_internal(data); }
 
 void script::run_internal(ss::temporary_buffer<char>& data) {
@@ -121,8 +123,22 @@ void script::run_internal(ss::temporary_buffer<char>& data) {
     }
 }
 
+void script::terminate() { _isolate->TerminateExecution(); }
+
+size_t script::near_heap_limit(
+  void* data, size_t current_limit, size_t /*initial_limit*/) {
+    static_cast<v8::Isolate*>(data)->TerminateExecution();
+    return current_limit * 2;
+}
+
 void script::throw_exception_from_v8(
   const v8::TryCatch& try_catch, std::string_view msg) {
+    if (try_catch.HasTerminated()) {
+        // so that the isolate can run js again
+        _isolate->CancelTerminateExecution();
+        _isolate->RestoreOriginalHeapLimit();
+        throw script_exception(fmt::format("{}:terminated", msg));
+    }
     v8::String::Utf8Value error(_isolate.get(), try_catch.Exception());
     throw script_exception(
       fmt::format("{}:{}", msg, std::string(*error, error.length())));
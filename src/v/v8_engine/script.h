@@ -59,6 +59,11 @@ public:
     void init(std::string_view name, ss::temporary_buffer<char> js_code);
     void run(ss::temporary_buffer<char>& data);
 
+    /// Stop the js code running in the isolate, the run fails with a
+    /// script_exception. Thread safe, used by the executor to enforce the
+    /// CPU time budget of a run
+    void terminate();
+
 private:
     // Must be running in executor, because it runs js code
     // in first time for init global vars and e.t.c.
@@ -75,6 +80,12 @@ private:
     /// \param buffer with data, wich js code can read and edit.
     void run_internal(ss::temporary_buffer<char>& data);
 
+    // Called by v8 before it runs out of heap: terminates the running js
+    // code instead of aborting the process, and gives the isolate the
+    // headroom to unwind
+    static size_t
+    near_heap_limit(void* data, size_t current_limit, size_t initial_limit);
+
     // Throw c++ exception from v8::TryCatch
     void throw_exception_from_v8(
       const v8::TryCatch& try_catch, std::string_view msg);
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Licensed as a Redpanda Enterprise file under the Redpanda Community
+ * License (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * https://github.com/vectorizedio/redpanda/blob/master/licenses/rcl.md
+ */
+
+#include "seastarx.h"
+#include "utils/file_io.h"
+#include "v8_engine/environment.h"
+#include "v8_engine/executor.h"
+#include "v8_engine/script.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+using namespace std::chrono_literals;
+
+v8_engine::enviroment env;
+
+namespace {
+struct sum_data {
+    int32_t a;
+    int32_t b;
+    int32_t ans;
+};
+
+bool is_terminated(const v8_engine::script_exception& e) {
+    return boost::algorithm::ends_with(e.what(), ":terminated");
+}
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(executor_run_test) {
+    v8_engine::executor ex;
+    v8_engine::script script(100);
+    script.init("sum", read_fully_tmpbuf("sum.js").get());
+
+    for (int i = 0; i < 10; ++i) {
+        sum_data test_data = {.a = i, .b = i + 1, .ans = -1};
+        ss::temporary_buffer<char> data(
+          reinterpret_cast<char*>(&test_data), sizeof(test_data));
+        ex.run(script, data, 1s).get();
+        BOOST_REQUIRE_EQUAL(
+          test_data.a + test_data.b,
+          reinterpret_cast<const sum_data*>(data.get())->ans);
+    }
+    ex.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(executor_cpu_budget_test) {
+    v8_engine::executor ex;
+    v8_engine::script loop(100);
+    loop.init("loop", read_fully_tmpbuf("loop.js").get());
+    v8_engine::script sum(100);
+    sum.init("sum", read_fully_tmpbuf("sum.js").get());
+
+    int32_t counter = 0;
+    ss::temporary_buffer<char> loop_data(
+      reinterpret_cast<char*>(&counter), sizeof(counter));
+    BOOST_REQUIRE_EXCEPTION(
+      ex.run(loop, loop_data, 50ms).get(),
+      v8_engine::script_exception,
+      is_terminated);
+
+    // the executor and the terminated isolate keep running scripts
+    sum_data test_data = {.a = 1, .b = 2, .ans = -1};
+    ss::temporary_buffer<char> data(
+      reinterpret_cast<char*>(&test_data), sizeof(test_data));
+    ex.run(sum, data, 1s).get();
+    BOOST_REQUIRE_EQUAL(
+      reinterpret_cast<const sum_data*>(data.get())->ans, 3);
+    BOOST_REQUIRE_EXCEPTION(
+      ex.run(loop, loop_data, 10ms).get(),
+      v8_engine::script_exception,
+      is_terminated);
+    ex.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(executor_heap_limit_test) {
+    v8_engine::executor ex;
+    v8_engine::script script(16 * 1024 * 1024);
+    script.init("alloc", read_fully_tmpbuf("alloc.js").get());
+
+    ss::temporary_buffer<char> data(8);
+    BOOST_REQUIRE_EXCEPTION(
+      ex.run(script, data, 10s).get(),
+      v8_engine::script_exception,
+      is_terminated);
+    ex.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(executor_stopped_test) {
+    v8_engine::executor ex;
+    ex.stop().get();
+    v8_engine::script script(100);
+    script.init("sum", read_fully_tmpbuf("sum.js").get());
+    ss::temporary_buffer<char> data(sizeof(sum_data));
+    BOOST_REQUIRE_THROW(
+      ex.run(script, data, 1s).get(), v8_engine::script_exception);
+}
@@ -0,0 +1,6 @@
+function alloc(obj) {
+    let arrays = [];
+    while (true) {
+        arrays.push(new Array(1024).fill(obj.byteLength));
+    }
+}
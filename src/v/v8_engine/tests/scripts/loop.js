@@ -0,0 +1,6 @@
+function loop(obj) {
+    let array = new Int32Array(obj);
+    while (true) {
+        array[0] = array[0] + 1;
+    }
+}
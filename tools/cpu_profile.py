@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+#
+# Takes a CPU profile of a broker through the admin API
+# (POST /v1/trace/cpu_profile), see src/v/utils/cpu_profiler.h, and prints
+# the folded stacks with the frames symbolized against the redpanda binary:
+#
+#   tools/cpu_profile.py --binary /opt/redpanda/libexec/redpanda \
+#       --duration-ms 10000 | flamegraph.pl > profile.svg
+#
+# Without --binary the frames are left as addresses.
+import argparse
+import json
+import subprocess
+import sys
+import urllib.request
+
+
+def fetch(admin, duration_ms, frequency):
+    url = (f"{admin}/v1/trace/cpu_profile?duration_ms={duration_ms}"
+           f"&frequency={frequency}")
+    req = urllib.request.Request(url, method="POST")
+    timeout = duration_ms / 1000 + 30
+    with urllib.request.urlopen(req, timeout=timeout) as res:
+        return json.load(res)
+
+
+def parse(line):
+    stack, count = line.rsplit(" ", 1)
+    return stack.split(";"), int(count)
+
+
+def symbolize(binary, addresses):
+    if not addresses:
+        return {}
+    out = subprocess.run(["addr2line", "-f", "-C", "-e", binary] +
+                         addresses,
+                         check=True,
+                         capture_output=True,
+                         text=True).stdout.splitlines()
+    # a function name and a location per address
+    names = {}
+    for i, address in enumerate(addresses):
+        name = out[2 * i] if 2 * i < len(out) else "??"
+        names[address] = address if name == "??" else name
+    return names
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Take a CPU profile")
+    parser.add_argument("--admin",
+                        default="http://localhost:9644",
+                        help="admin API of the broker")
+    parser.add_argument("--binary", help="redpanda binary of the broker")
+    parser.add_argument("--duration-ms", type=int, default=5000)
+    parser.add_argument("--frequency", type=int, default=99)
+    args = parser.parse_args()
+
+    stacks = [
+        parse(line)
+        for line in fetch(args.admin, args.duration_ms, args.frequency)
+    ]
+    names = {}
+    if args.binary:
+        addresses = sorted({
+            f
+            for frames, _ in stacks for f in frames[1:]
+            if f.startswith("0x")
+        })
+        names = symbolize(args.binary, addresses)
+    for frames, count in stacks:
+        frames = [frames[0]] + [names.get(f, f) for f in frames[1:]]
+        print(f"{';'.join(frames)} {count}")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
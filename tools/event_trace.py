@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+#
+# Decodes the event trace dumps written by the admin API
+# (POST /v1/trace/dump) to <data_directory>/event_trace/shard-<n>.bin, see
+# src/v/utils/event_trace.h
+#
+#   tools/event_trace.py /var/lib/redpanda/data/event_trace/*.bin
+#
+# The events of all the dumps are printed in time order, with the time since
+# the first event and since the previous event of the same id on the shard.
+import argparse
+import collections
+import struct
+import sys
+
+# little endian: magic, version, shard, number of events
+HEADER_FMT = "<IHHQ"
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+MAGIC = 0x54455052
+
+# little endian: timestamp_ns, id, arg, type, reserved
+EVENT_FMT = "<QQQII"
+EVENT_SIZE = struct.calcsize(EVENT_FMT)
+
+# event_trace::type
+TYPES = [
+    "produce_received",
+    "produce_dispatched",
+    "produce_acked",
+    "replicate_started",
+    "replicate_finished",
+    "segment_appended",
+    "segment_flushed",
+]
+
+Event = collections.namedtuple('Event',
+                               ('timestamp_ns', 'shard', 'type', 'id', 'arg'))
+
+
+def type_name(t):
+    return TYPES[t] if t < len(TYPES) else f"unknown({t})"
+
+
+def read_dump(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER_SIZE:
+        raise ValueError(f"{path}: too short for a header")
+    magic, version, shard, count = struct.unpack_from(HEADER_FMT, data)
+    if magic != MAGIC:
+        raise ValueError(f"{path}: not an event trace dump")
+    if version != 1:
+        raise ValueError(f"{path}: unsupported version {version}")
+    if len(data) < HEADER_SIZE + count * EVENT_SIZE:
+        raise ValueError(f"{path}: truncated, expected {count} events")
+    events = []
+    for i in range(count):
+        ts, id, arg, t, _ = struct.unpack_from(EVENT_FMT, data,
+                                               HEADER_SIZE + i * EVENT_SIZE)
+        events.append(Event(ts, shard, t, id, arg))
+    return events
+
+
+def signed(v):
+    return v - (1 << 64) if v >= (1 << 63) else v
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode event trace dumps")
+    parser.add_argument("dumps", nargs="+", help="shard-<n>.bin files")
+    parser.add_argument("--id",
+                        type=lambda v: int(v, 0),
+                        help="only print the events of this id")
+    parser.add_argument("--type",
+                        choices=TYPES,
+                        action="append",
+                        help="only print the events of these types")
+    args = parser.parse_args()
+
+    events = []
+    for path in args.dumps:
+        events.extend(read_dump(path))
+    events.sort(key=lambda e: e.timestamp_ns)
+    if not events:
+        return
+
+    start = events[0].timestamp_ns
+    previous = {}
+    print(f"{'time_us':>14} {'delta_us':>10} shard {'type':<20} "
+          f"{'id':>18} arg")
+    for e in events:
+        key = (e.shard, e.id)
+        delta = e.timestamp_ns - previous.get(key, e.timestamp_ns)
+        previous[key] = e.timestamp_ns
+        if args.id is not None and signed(e.id) != args.id and e.id != args.id:
+            continue
+        if args.type and type_name(e.type) not in args.type:
+            continue
+        print(f"{(e.timestamp_ns - start) / 1000:>14.3f} "
+              f"{delta / 1000:>10.3f} {e.shard:>5} {type_name(e.type):<20} "
+              f"{e.id:>#18x} {signed(e.arg)}")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
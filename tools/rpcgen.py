@@ -30,6 +30,7 @@ RPC_TEMPLATE = """
 #include "rpc/parse_utils.h"
 #include "rpc/transport.h"
 #include "rpc/service.h"
+#include "serde/envelope.h"
 #include "finjector/hbadger.h"
 #include "utils/string_switch.h"
 #include "random/fast_prng.h"
@@ -89,6 +90,29 @@ public:
        }
     }
     {%- for method in methods %}
+    {%- if method.codec == "serde" %}
+    static_assert(serde::is_envelope_v<{{method.input_type}}>
+      && serde::is_envelope_v<{{method.output_type}}>,
+      "serde codec requires serde envelopes");
+    {%- endif %}
+    {%- if method.streaming %}
+    /// \\brief {{method.input_type}} -> {{method.output_type}}, the body is
+    /// handed to the handler while it is received
+    virtual ss::future<rpc::netbuf>
+    raw_{{method.name}}(ss::input_stream<char>& in, rpc::streaming_context& ctx) {
+      return streaming_execution_helper<{{method.output_type}}>::exec(
+        in, ctx, {{method.id}},
+        [this](rpc::request_body& body, rpc::streaming_context& ctx)
+          -> ss::future<{{method.output_type}}> {
+          return {{method.name}}(body, ctx);
+      });
+    }
+    /// \\brief the body holds an encoded {{method.input_type}}
+    virtual ss::future<{{method.output_type}}>
+    {{method.name}}(rpc::request_body&, rpc::streaming_context&) {
+       throw std::runtime_error("unimplemented method");
+    }
+    {%- else %}
     /// \\brief {{method.input_type}} -> {{method.output_type}}
     virtual ss::future<rpc::netbuf>
     raw_{{method.name}}(ss::input_stream<char>& in, rpc::streaming_context& ctx) {
@@ -103,6 +127,7 @@ public:
     {{method.name}}({{method.input_type}}&&, rpc::streaming_context&) {
        throw std::runtime_error("unimplemented method");
     }
+    {%- endif %}
     {%- endfor %}
 private:
     ss::scheduling_group _sc;
@@ -111,7 +136,8 @@ private:
       {%- for method in methods %}
       rpc::method([this] (ss::input_stream<char>& in, rpc::streaming_context& ctx) {
          return raw_{{method.name}}(in, ctx);
-      }){{ "," if not loop.last }}
+      }, rpc::method_priority::{{method.priority}},
+         "{{namespace}}::{{service_name}}::{{method.name}}"){{ "," if not loop.last }}
       {%- endfor %}
     {% raw %}}}{% endraw %};
 };
@@ -208,10 +234,22 @@ def _enrich_methods(service):
     def _xor_id(m):
         mid = ("%s:" % service["namespace"]).join(
             [m["name"], m["input_type"], m["output_type"]])
+        # the payload encoding is part of the method id, the peers that
+        # don't know the serde variant of a method reply method_not_found
+        if m["codec"] == "serde":
+            mid += ":serde"
         return service["id"] ^ zlib.crc32(bytes(mid, 'utf-8'))
 
     for m in service["methods"]:
+        # encoding of the payloads: adl, or serde for serde envelopes
+        m.setdefault("codec", "adl")
         m["id"] = _xor_id(m)
+        # order in which the server admits the requests waiting for memory:
+        # critical, high, normal or low
+        m.setdefault("priority", "normal")
+        # the handler reads the body of the request while it is received,
+        # the clients send the input type as any other method
+        m.setdefault("streaming", False)
 
     return service
 